@@ -0,0 +1,224 @@
+#include "backtest_analytics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+namespace hft {
+
+namespace {
+
+constexpr double TRADING_YEAR_MS = 252.0 * 6.5 * 3600.0 * 1000.0;
+
+} // namespace
+
+void BacktestAnalytics::reset() {
+    summary_ = AnalyticsSummary{};
+    curve_ = EquityCurve{};
+    symbols_.clear();
+    symbol_index_.clear();
+    cash_ = 0.0;
+    marked_positions_ = 0.0;
+    gross_exposure_ = 0.0;
+    total_commission_ = 0.0;
+    next_sample_ns_ = 0;
+    sampling_ = false;
+    last_sample_equity_ = 0.0;
+    returns_ = 0;
+    return_mean_ = 0.0;
+    return_m2_ = 0.0;
+    downside_sq_ = 0.0;
+    exposure_sum_ = 0.0;
+}
+
+BacktestAnalytics::SymbolState& BacktestAnalytics::state(const char* symbol) {
+    auto [it, inserted] = symbol_index_.try_emplace(symbol, symbols_.size());
+    if (inserted) {
+        symbols_.emplace_back().symbol = it->first;
+    }
+    return symbols_[it->second];
+}
+
+void BacktestAnalytics::on_order(uint64_t quantity) {
+    summary_.ordered_quantity += quantity;
+    summary_.fill_rate = static_cast<double>(summary_.filled_quantity) / summary_.ordered_quantity;
+}
+
+void BacktestAnalytics::on_fill(const char* symbol, int64_t signed_quantity, double price, double commission) {
+    SymbolState& s = state(symbol);
+    if (s.mark == 0.0) {
+        s.mark = price;     // Filled before its first two-sided quote
+    }
+
+    int64_t old_position = s.position;
+    int64_t quantity = std::abs(signed_quantity);
+    if (old_position == 0 || (old_position > 0) == (signed_quantity > 0)) {
+        s.average_cost = (s.average_cost * std::abs(old_position) + price * quantity) /
+                         static_cast<double>(std::abs(old_position) + quantity);
+    } else {
+        // Reduces (and maybe flips) the position: the closed part realizes
+        int64_t closed = std::min(quantity, std::abs(old_position));
+        s.realized_pnl += closed * (price - s.average_cost) * (old_position > 0 ? 1.0 : -1.0);
+        if (quantity > std::abs(old_position)) {
+            s.average_cost = price;
+        } else if (quantity == std::abs(old_position)) {
+            s.average_cost = 0.0;
+        }
+    }
+    s.position += signed_quantity;
+    s.commission += commission;
+    s.traded_notional += quantity * price;
+    s.fills++;
+
+    cash_ -= signed_quantity * price;
+    marked_positions_ += signed_quantity * s.mark;
+    gross_exposure_ += (std::abs(s.position) - std::abs(old_position)) * s.mark;
+    total_commission_ += commission;
+
+    summary_.traded_notional += quantity * price;
+    summary_.filled_quantity += quantity;
+    if (summary_.ordered_quantity > 0) {
+        summary_.fill_rate = static_cast<double>(summary_.filled_quantity) / summary_.ordered_quantity;
+    }
+    update_drawdown();
+}
+
+void BacktestAnalytics::on_mark(const char* symbol, double mid, int64_t time_ns) {
+    if (mid <= 0.0) return;
+
+    SymbolState& s = state(symbol);
+    if (s.position != 0) {
+        marked_positions_ += s.position * (mid - s.mark);
+        gross_exposure_ += std::abs(s.position) * (mid - s.mark);
+    }
+    s.mark = mid;
+    update_drawdown();
+
+    if (!sampling_) {
+        // The first mark opens the curve at the starting equity
+        sampling_ = true;
+        next_sample_ns_ = time_ns;
+    }
+    if (time_ns >= next_sample_ns_) {
+        take_sample(time_ns);
+        int64_t interval_ns = static_cast<int64_t>(std::max<uint64_t>(config_.sample_interval_ms, 1)) * 1000000;
+        next_sample_ns_ += ((time_ns - next_sample_ns_) / interval_ns + 1) * interval_ns;
+    }
+}
+
+void BacktestAnalytics::finish(int64_t time_ns) {
+    // Fills after the last sample (or no marks at all) still end up in it
+    if (!sampling_ || equity() != last_sample_equity_) {
+        sampling_ = true;
+        take_sample(time_ns);
+    }
+    update_drawdown();
+}
+
+void BacktestAnalytics::update_drawdown() {
+    double value = equity();
+    summary_.final_equity = value;
+    summary_.peak_equity = std::max(summary_.peak_equity, value);
+    summary_.max_drawdown = std::max(summary_.max_drawdown, summary_.peak_equity - value);
+}
+
+void BacktestAnalytics::take_sample(int64_t time_ns) {
+    double value = equity();
+    if (summary_.samples > 0) {
+        double r = value - last_sample_equity_;
+        returns_++;
+        double delta = r - return_mean_;
+        return_mean_ += delta / returns_;
+        return_m2_ += delta * (r - return_mean_);
+        downside_sq_ += std::min(r, 0.0) * std::min(r, 0.0);
+    }
+    last_sample_equity_ = value;
+    exposure_sum_ += gross_exposure_;
+    summary_.samples++;
+
+    if (config_.record_curve) {
+        curve_.time_ns.push_back(time_ns);
+        curve_.equity.push_back(value);
+        curve_.drawdown.push_back(summary_.peak_equity - value);
+        curve_.gross_exposure.push_back(gross_exposure_);
+    }
+    update_ratios();
+}
+
+void BacktestAnalytics::update_ratios() {
+    double periods_per_year = TRADING_YEAR_MS / std::max<uint64_t>(config_.sample_interval_ms, 1);
+    double scale = std::sqrt(periods_per_year);
+
+    double deviation = returns_ > 1 ? std::sqrt(return_m2_ / (returns_ - 1)) : 0.0;
+    summary_.sharpe = deviation > 0.0 ? return_mean_ / deviation * scale : 0.0;
+    double downside = returns_ > 0 ? std::sqrt(downside_sq_ / returns_) : 0.0;
+    summary_.sortino = downside > 0.0 ? return_mean_ / downside * scale : 0.0;
+
+    double mean_exposure = summary_.samples > 0 ? exposure_sum_ / summary_.samples : 0.0;
+    summary_.turnover = mean_exposure > 0.0 ? summary_.traded_notional / mean_exposure : 0.0;
+}
+
+SymbolAttribution BacktestAnalytics::attribution() const {
+    SymbolAttribution table;
+    for (const auto& s : symbols_) {
+        table.symbol.push_back(s.symbol);
+        table.position.push_back(s.position);
+        table.realized_pnl.push_back(s.realized_pnl);
+        table.unrealized_pnl.push_back(s.position * (s.mark - s.average_cost));
+        table.commission.push_back(s.commission);
+        table.traded_notional.push_back(s.traded_notional);
+        table.fills.push_back(s.fills);
+    }
+    return table;
+}
+
+void BacktestAnalytics::print_summary(std::ostream& out) const {
+    out << std::fixed << std::setprecision(2)
+        << "Net P&L: " << summary_.final_equity << " (peak " << summary_.peak_equity
+        << ", max drawdown " << summary_.max_drawdown << ")\n"
+        << std::setprecision(3)
+        << "Sharpe: " << summary_.sharpe << "  Sortino: " << summary_.sortino
+        << " (" << summary_.samples << " samples of " << config_.sample_interval_ms << "ms)\n"
+        << std::setprecision(2)
+        << "Traded notional: " << summary_.traded_notional << "  Turnover: " << summary_.turnover << "x\n"
+        << "Fill rate: " << summary_.fill_rate * 100.0 << "% (" << summary_.filled_quantity
+        << " of " << summary_.ordered_quantity << " shares)\n";
+
+    SymbolAttribution table = attribution();
+    for (size_t i = 0; i < table.size(); ++i) {
+        out << "  " << std::left << std::setw(10) << table.symbol[i] << std::right
+            << " position " << std::setw(8) << table.position[i]
+            << "  realized " << std::setw(12) << table.realized_pnl[i]
+            << "  unrealized " << std::setw(12) << table.unrealized_pnl[i]
+            << "  commission " << std::setw(10) << table.commission[i] << "\n";
+    }
+}
+
+bool BacktestAnalytics::write_curve_csv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << "time_ns,equity,drawdown,gross_exposure\n" << std::setprecision(10);
+    for (size_t i = 0; i < curve_.size(); ++i) {
+        file << curve_.time_ns[i] << "," << curve_.equity[i] << ","
+             << curve_.drawdown[i] << "," << curve_.gross_exposure[i] << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool BacktestAnalytics::write_attribution_csv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    SymbolAttribution table = attribution();
+    file << "symbol,position,realized_pnl,unrealized_pnl,commission,traded_notional,fills\n" << std::setprecision(10);
+    for (size_t i = 0; i < table.size(); ++i) {
+        file << table.symbol[i] << "," << table.position[i] << "," << table.realized_pnl[i] << ","
+             << table.unrealized_pnl[i] << "," << table.commission[i] << ","
+             << table.traded_notional[i] << "," << table.fills[i] << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace hft
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+struct AnalyticsConfig {
+    uint64_t sample_interval_ms = 1000;   // Equity curve and return resolution, in logical time
+    bool record_curve = true;             // Keep the equity curve columns; the summary is always kept
+};
+
+// Equity sampled once per interval, one column per field
+struct EquityCurve {
+    std::vector<int64_t> time_ns;         // Logical time of the tick that closed the sample
+    std::vector<double> equity;           // Net P&L marked at the last mids, after commission
+    std::vector<double> drawdown;         // Below the running peak, >= 0
+    std::vector<double> gross_exposure;   // Sum of |position| * mid over symbols
+
+    size_t size() const { return time_ns.size(); }
+};
+
+// P&L attribution, one row per symbol in first-seen order
+struct SymbolAttribution {
+    std::vector<std::string> symbol;
+    std::vector<int64_t> position;
+    std::vector<double> realized_pnl;     // Closed against the average cost, before commission
+    std::vector<double> unrealized_pnl;   // Open position marked at the last mid
+    std::vector<double> commission;
+    std::vector<double> traded_notional;
+    std::vector<uint64_t> fills;
+
+    size_t size() const { return symbol.size(); }
+};
+
+struct AnalyticsSummary {
+    double final_equity = 0.0;
+    double peak_equity = 0.0;
+    double max_drawdown = 0.0;
+    double sharpe = 0.0;                  // Annualized over a 252 x 6.5h trading year
+    double sortino = 0.0;
+    double traded_notional = 0.0;
+    double turnover = 0.0;                // Traded notional / mean gross exposure
+    uint64_t ordered_quantity = 0;
+    uint64_t filled_quantity = 0;
+    double fill_rate = 0.0;               // filled_quantity / ordered_quantity
+    size_t samples = 0;
+};
+
+// Backtest analytics computed online, in O(symbols) memory plus the
+// optional curve: the engine reports orders, fills and mids as they happen
+// and every metric is current after each call, so a sweep never holds
+// its fills or re-reads a log. Returns are equity changes between samples;
+// samples close on the first mark at or past each interval boundary.
+class BacktestAnalytics {
+public:
+    void configure(const AnalyticsConfig& config) { config_ = config; }
+    void reset();
+
+    void on_order(uint64_t quantity);
+    // signed_quantity > 0 buys
+    void on_fill(const char* symbol, int64_t signed_quantity, double price, double commission);
+    // Top of book mid for a symbol at a logical time; times never decrease
+    void on_mark(const char* symbol, double mid, int64_t time_ns);
+    // Closes the last sample; call once after the final fill
+    void finish(int64_t time_ns);
+
+    const AnalyticsSummary& summary() const { return summary_; }
+    const EquityCurve& curve() const { return curve_; }
+    SymbolAttribution attribution() const;
+
+    void print_summary(std::ostream& out) const;
+    bool write_curve_csv(const std::string& path) const;
+    bool write_attribution_csv(const std::string& path) const;
+
+private:
+    struct SymbolState {
+        std::string symbol;
+        int64_t position = 0;
+        double average_cost = 0.0;
+        double mark = 0.0;
+        double realized_pnl = 0.0;
+        double commission = 0.0;
+        double traded_notional = 0.0;
+        uint64_t fills = 0;
+    };
+
+    AnalyticsConfig config_;
+    AnalyticsSummary summary_;
+    EquityCurve curve_;
+    std::vector<SymbolState> symbols_;
+    std::unordered_map<std::string, size_t> symbol_index_;
+
+    // Equity = cash + marked positions - commission, kept incrementally
+    double cash_ = 0.0;
+    double marked_positions_ = 0.0;
+    double gross_exposure_ = 0.0;
+    double total_commission_ = 0.0;
+    int64_t next_sample_ns_ = 0;
+    bool sampling_ = false;
+
+    // Per-sample returns and exposure (Welford) for the ratios
+    double last_sample_equity_ = 0.0;
+    uint64_t returns_ = 0;
+    double return_mean_ = 0.0;
+    double return_m2_ = 0.0;
+    double downside_sq_ = 0.0;
+    double exposure_sum_ = 0.0;
+
+    SymbolState& state(const char* symbol);
+    double equity() const { return cash_ + marked_positions_ - total_commission_; }
+    void update_drawdown();
+    void take_sample(int64_t time_ns);
+    void update_ratios();
+};
+
+} // namespace hft
@@ -0,0 +1,246 @@
+#include "backtest_engine.h"
+#include "../common/static_config.h"
+#include <chrono>
+#include <cstring>
+
+namespace hft {
+
+BacktestEngine::BacktestEngine()
+    : logger_("BacktestEngine", StaticConfig::get_logger_endpoint())
+    , next_order_id_(1) {
+}
+
+bool BacktestEngine::initialize(const FillConfig& fill_config) {
+    fill_config_ = fill_config;
+    if (!fill_simulator_.initialize(fill_config)) {
+        logger_.error("Failed to initialize fill simulator");
+        return false;
+    }
+
+    fill_simulator_.set_clock(&clock_);
+    fill_simulator_.set_fill_callback([this](const OrderExecution& execution) { on_fill(execution); });
+    return true;
+}
+
+void BacktestEngine::add_strategy(std::unique_ptr<OrderBookStrategy> strategy) {
+    if (!strategy || !attach(strategy.get())) return;
+    strategies_.push_back(std::move(strategy));
+}
+
+bool BacktestEngine::attach(OrderBookStrategy* strategy) {
+    strategy->set_clock(&clock_);
+    strategy->set_shared_books(&order_books_);
+    strategy->set_signal_callback([this, strategy](const TradingSignal& signal) { on_signal(strategy, signal); });
+    if (!strategy->initialize()) {
+        logger_.error("Strategy " + strategy->get_name() + " failed to initialize");
+        return false;
+    }
+
+    logger_.info("Added strategy " + strategy->get_name() + " (ID " + std::to_string(strategy->get_strategy_id()) + ")");
+    return true;
+}
+
+BacktestStats BacktestEngine::run() {
+    begin_run();
+    auto wall_start = std::chrono::steady_clock::now();
+    player_.replay([this](const MarketData& data) { on_tick(data); });
+    finish_run(wall_start);
+    return stats_;
+}
+
+BacktestStats BacktestEngine::run(const TickSeries& ticks) {
+    begin_run();
+    auto wall_start = std::chrono::steady_clock::now();
+    for (const auto& data : ticks) {
+        on_tick(data);
+    }
+    finish_run(wall_start);
+    return stats_;
+}
+
+TickSeries BacktestEngine::decode_ticks() {
+    TickSeries ticks;
+    ticks.reserve(player_.get_total_data_points());
+    player_.replay([&ticks](const MarketData& data) { ticks.push_back(data); });
+    return ticks;
+}
+
+void BacktestEngine::begin_run() {
+    stats_ = BacktestStats{};
+    order_books_.clear();
+    books_.clear();
+    order_routes_.clear();
+    fill_simulator_.reset();
+    next_order_id_ = 1;
+    positions_.clear();
+    working_quotes_.clear();
+    analytics_.reset();
+    clock_.reset();
+    logger_.info("Starting event-driven backtest with " + std::to_string(strategies_.size()) + " strategies");
+}
+
+void BacktestEngine::finish_run(std::chrono::steady_clock::time_point wall_start) {
+    // Let fills still in flight at the last tick complete on logical time:
+    // schedule orders sent on the final tick, then jump past the max latency
+    fill_simulator_.process_pending_fills();
+    clock_.advance_to(clock_.now() + std::chrono::milliseconds(fill_config_.max_latency_ms));
+    fill_simulator_.process_pending_fills();
+
+    stats_.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    // Mark open positions at the last mid seen for the symbol
+    stats_.net_pnl = -stats_.commission;
+    for (const auto& [symbol, position] : positions_) {
+        double mark = 0.0;
+        auto book = books_.find(symbol);
+        if (book != books_.end()) {
+            mark = (to_double_price(book->second.bid_price) + to_double_price(book->second.ask_price)) / 2.0;
+        }
+        stats_.net_pnl += position.cash + position.quantity * mark;
+    }
+    analytics_.finish(clock_.now().count());
+
+    logger_.info("Backtest complete: " + std::to_string(stats_.ticks) + " ticks, " +
+                 std::to_string(stats_.signals) + " signals, " +
+                 std::to_string(stats_.fills) + " fills in " +
+                 std::to_string(stats_.wall_seconds) + "s (" +
+                 std::to_string(static_cast<uint64_t>(stats_.ticks_per_second())) + " ticks/s)");
+}
+
+void BacktestEngine::begin_tick(const MarketData& data) {
+    clock_.advance_to(data.header.timestamp);
+    if (stats_.ticks == 0) {
+        stats_.first_tick_time = clock_.now();
+    }
+    stats_.last_tick_time = clock_.now();
+    stats_.ticks++;
+
+    // Fills due by this tick's time are delivered before strategies see it
+    fill_simulator_.process_pending_fills();
+    fill_simulator_.update_market_state(data);
+    if (data.bid_price > 0 && data.ask_price > 0) {
+        analytics_.on_mark(data.symbol, to_double_price(data.bid_price + data.ask_price) / 2.0, clock_.now().count());
+    }
+}
+
+void BacktestEngine::on_tick(const MarketData& data) {
+    begin_tick(data);
+
+    BookUpdateBatch batch;
+    build_book_updates(data, batch);
+    for (size_t i = 0; i < batch.count; ++i) {
+        fill_simulator_.update_order_book(batch.updates[i]);
+        order_books_.process_update(batch.updates[i]);
+        for (auto& strategy : strategies_) {
+            strategy->on_order_book_update(batch.updates[i]);
+        }
+    }
+
+    for (auto& strategy : strategies_) {
+        strategy->on_market_data(data);
+    }
+}
+
+void BacktestEngine::on_signal(OrderBookStrategy* strategy, const TradingSignal& signal) {
+    stats_.signals++;
+    // New orders and quote modifies are simulated; cancels are not routed yet
+    SignalAction side = signal.action;
+    if (signal.action == SignalAction::MODIFY) {
+        side = signal.side;
+    } else if (signal.action != SignalAction::BUY && signal.action != SignalAction::SELL) {
+        return;
+    }
+    if ((side != SignalAction::BUY && side != SignalAction::SELL) || signal.quantity == 0) {
+        return;
+    }
+
+    uint64_t order_id = next_order_id_++;
+    if (signal.action == SignalAction::MODIFY) {
+        // Cancel and replace, as the gateway does at the broker; the old
+        // order's route stays so fills already in flight are still booked
+        uint64_t& working = working_quotes_[std::make_tuple(strategy, std::string(signal.symbol), side)];
+        if (working != 0) {
+            fill_simulator_.cancel_order(working);
+        }
+        working = order_id;
+    }
+    order_routes_[order_id] = OrderRoute{strategy, side};
+    stats_.orders++;
+    analytics_.on_order(signal.quantity);
+    fill_simulator_.submit_order(order_id, signal.symbol, side, signal.order_type,
+                                 to_double_price(signal.price), signal.quantity);
+}
+
+void BacktestEngine::on_fill(const OrderExecution& execution) {
+    stats_.fills++;
+
+    auto it = order_routes_.find(execution.order_id);
+    if (it == order_routes_.end()) return;
+
+    if (execution.fill_quantity > 0) {
+        int64_t signed_quantity = it->second.action == SignalAction::SELL
+                                      ? -static_cast<int64_t>(execution.fill_quantity)
+                                      : static_cast<int64_t>(execution.fill_quantity);
+        PositionState& position = positions_[execution.symbol];
+        position.quantity += signed_quantity;
+        position.cash -= signed_quantity * to_double_price(execution.fill_price);
+        stats_.filled_quantity += execution.fill_quantity;
+        stats_.commission += execution.commission;
+        analytics_.on_fill(execution.symbol, signed_quantity, to_double_price(execution.fill_price),
+                           execution.commission);
+    }
+
+    it->second.strategy->on_execution(execution);
+    if (execution.exec_type == ExecutionType::FILL) {
+        order_routes_.erase(it);
+    }
+}
+
+void BacktestEngine::build_book_updates(const MarketData& data, BookUpdateBatch& batch) {
+    BookState& book = books_[data.symbol];
+    batch.count = 0;
+
+    // Ticks carry top of book only: replace the previous level on each side
+    if (data.bid_price != book.bid_price) {
+        if (book.bid_price != 0) {
+            add_level(data, BookSide::BID, BookUpdateType::DELETE, book.bid_price, 0, book, batch);
+        }
+        book.bid_price = data.bid_price;
+        add_level(data, BookSide::BID, BookUpdateType::ADD, data.bid_price, data.bid_size, book, batch);
+    } else {
+        add_level(data, BookSide::BID, BookUpdateType::UPDATE, data.bid_price, data.bid_size, book, batch);
+    }
+
+    if (data.ask_price != book.ask_price) {
+        if (book.ask_price != 0) {
+            add_level(data, BookSide::ASK, BookUpdateType::DELETE, book.ask_price, 0, book, batch);
+        }
+        book.ask_price = data.ask_price;
+        add_level(data, BookSide::ASK, BookUpdateType::ADD, data.ask_price, data.ask_size, book, batch);
+    } else {
+        add_level(data, BookSide::ASK, BookUpdateType::UPDATE, data.ask_price, data.ask_size, book, batch);
+    }
+}
+
+void BacktestEngine::add_level(const MarketData& data, BookSide side, BookUpdateType type,
+                               price_t price, uint32_t size, BookState& book, BookUpdateBatch& batch) {
+    // Built in place rather than via OrderBookFactory: the tick already
+    // carries its symbol ID, and interning per update would serialize
+    // parallel engines on the SymbolTable lock
+    uint64_t sequence = ++book.sequence;
+    OrderBookUpdate& update = batch.updates[batch.count++];
+    update = OrderBookUpdate{};
+    update.header.type = MessageType::ORDER_BOOK_UPDATE;
+    update.header.sequence_number = static_cast<uint32_t>(sequence);
+    update.header.timestamp = clock_.now();
+    update.header.payload_size = sizeof(OrderBookUpdate) - sizeof(MessageHeader);
+    std::memcpy(update.symbol, data.symbol, sizeof(update.symbol));
+    update.symbol_id = data.symbol_id;
+    update.update_type = type;
+    update.side = side;
+    update.level = OrderBookLevel(price, size, 1);
+    update.sequence_number = sequence;
+    update.exchange_timestamp = static_cast<uint64_t>(clock_.now().count());
+}
+
+} // namespace hft
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "historical_data_player.h"
+#include "fill_simulator.h"
+#include "backtest_analytics.h"
+#include "../strategy_engine/enhanced_strategies.h"
+#include "../strategy_engine/static_strategy_set.h"
+#include "../common/simulation_clock.h"
+#include "../common/order_book.h"
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+struct BacktestStats {
+    uint64_t ticks = 0;
+    uint64_t signals = 0;
+    uint64_t orders = 0;
+    uint64_t fills = 0;
+    uint64_t filled_quantity = 0;
+    double commission = 0.0;
+    double net_pnl = 0.0;             // Cash plus open positions marked at the last mid, after commission
+    timestamp_t first_tick_time{0};   // Logical (exchange) time
+    timestamp_t last_tick_time{0};
+    double wall_seconds = 0.0;
+
+    double ticks_per_second() const { return wall_seconds > 0.0 ? ticks / wall_seconds : 0.0; }
+};
+
+// Ticks decoded once and replayed read-only by any number of engines
+using TickSeries = std::vector<MarketData>;
+
+// As-fast-as-possible, event-driven backtest. Ticks from a HistoricalDataPlayer
+// are dispatched by direct calls to OrderBookStrategy instances and the
+// FillSimulator on one thread; no ZMQ and no sleeping. Every component reads
+// the SimulationClock, which only advances with tick timestamps, so a run
+// with a fixed FillConfig::random_seed is reproducible.
+class BacktestEngine {
+public:
+    BacktestEngine();
+    ~BacktestEngine() = default;
+
+    bool initialize(const FillConfig& fill_config);
+    bool load_data_file(const std::string& file_path) { return player_.load_data_file(file_path); }
+    void set_time_range(uint64_t start_time, uint64_t end_time) { player_.set_time_range(start_time, end_time); }
+    bool set_symbol_filter(const std::string& symbol) { return player_.set_symbol_filter(symbol); }
+
+    // Engine takes ownership; signals and fills are routed back by strategy
+    void add_strategy(std::unique_ptr<OrderBookStrategy> strategy);
+
+    // Replays the whole window, then lets outstanding fills complete. Each
+    // run starts from empty books, positions and fill simulator state and
+    // renumbers orders from 1; strategies keep whatever state they hold.
+    BacktestStats run();
+    
+    // Same, over ticks already decoded by the caller instead of the loaded
+    // file; the series is only read, so parallel runs can share one copy
+    BacktestStats run(const TickSeries& ticks);
+    
+    // Decodes the loaded, filtered time window for run(const TickSeries&)
+    TickSeries decode_ticks();
+    
+    // Compile-time dispatch variant: replays ticks to a caller-owned strategy
+    // set with statically bound calls instead of the add_strategy() vector.
+    // Signals, fills and stats behave exactly as in run(const TickSeries&).
+    template <typename... Strategies>
+    BacktestStats run(StaticStrategySet<Strategies...>& strategies, const TickSeries& ticks);
+
+    const SimulationClock& clock() const { return clock_; }
+    const OrderBookManager& order_books() const { return order_books_; }
+    FillSimulator& fill_simulator() { return fill_simulator_; }
+    const BacktestStats& get_stats() const { return stats_; }
+    
+    // Equity curve, ratios and per-symbol attribution, updated as fills
+    // arrive; set before run()
+    void set_analytics_config(const AnalyticsConfig& config) { analytics_.configure(config); }
+    const BacktestAnalytics& analytics() const { return analytics_; }
+
+private:
+    // Top of book last sent to the strategies, to turn ticks into book updates
+    struct BookState {
+        price_t bid_price = 0;
+        price_t ask_price = 0;
+        uint64_t sequence = 0;
+    };
+    
+    // A tick replaces at most both levels on both sides
+    struct BookUpdateBatch {
+        std::array<OrderBookUpdate, 4> updates;
+        size_t count = 0;
+    };
+    
+    struct OrderRoute {
+        OrderBookStrategy* strategy;
+        SignalAction action;
+    };
+    
+    // Net position and cash per symbol, for the P&L in BacktestStats
+    struct PositionState {
+        int64_t quantity = 0;
+        double cash = 0.0;
+    };
+
+    HistoricalDataPlayer player_;
+    FillSimulator fill_simulator_;
+    SimulationClock clock_;
+    FillConfig fill_config_;
+    Logger logger_;
+
+    // One book per symbol for all strategies, updated before each dispatch
+    OrderBookManager order_books_;
+    std::vector<std::unique_ptr<OrderBookStrategy>> strategies_;
+    std::unordered_map<uint64_t, OrderRoute> order_routes_;
+    // Each strategy's latest quote order per symbol and side; a MODIFY cancels it
+    std::map<std::tuple<OrderBookStrategy*, std::string, SignalAction>, uint64_t> working_quotes_;
+    std::unordered_map<std::string, BookState> books_;
+    std::unordered_map<std::string, PositionState> positions_;
+    uint64_t next_order_id_;
+    BacktestStats stats_;
+    BacktestAnalytics analytics_;
+
+    void begin_run();
+    void finish_run(std::chrono::steady_clock::time_point wall_start);
+    bool attach(OrderBookStrategy* strategy);
+    void begin_tick(const MarketData& data);
+    void on_tick(const MarketData& data);
+    void on_signal(OrderBookStrategy* strategy, const TradingSignal& signal);
+    void on_fill(const OrderExecution& execution);
+    void build_book_updates(const MarketData& data, BookUpdateBatch& batch);
+    void add_level(const MarketData& data, BookSide side, BookUpdateType type,
+                   price_t price, uint32_t size, BookState& book, BookUpdateBatch& batch);
+};
+
+template <typename... Strategies>
+BacktestStats BacktestEngine::run(StaticStrategySet<Strategies...>& strategies, const TickSeries& ticks) {
+    static_assert((std::is_base_of_v<OrderBookStrategy, Strategies> && ...),
+                  "BacktestEngine strategies must derive from OrderBookStrategy");
+
+    bool attached = true;
+    strategies.for_each([this, &attached](OrderBookStrategy& strategy) { attached = attach(&strategy) && attached; });
+    if (!attached) {
+        return BacktestStats{};
+    }
+
+    begin_run();
+    auto wall_start = std::chrono::steady_clock::now();
+    BookUpdateBatch batch;
+    for (const auto& data : ticks) {
+        begin_tick(data);
+        build_book_updates(data, batch);
+        for (size_t i = 0; i < batch.count; ++i) {
+            fill_simulator_.update_order_book(batch.updates[i]);
+            order_books_.process_update(batch.updates[i]);
+            strategies.on_order_book_update(batch.updates[i]);
+        }
+        strategies.on_market_data(data);
+    }
+    finish_run(wall_start);
+    return stats_;
+}
+
+} // namespace hft
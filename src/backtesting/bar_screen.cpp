@@ -0,0 +1,416 @@
+#include "bar_screen.h"
+#include "../common/rolling_window.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+namespace hft {
+
+namespace {
+
+// A register of doubles and one of int64s (also the comparison masks), as
+// GCC/Clang vector extensions
+using Lanes = double __attribute__((vector_size(BarScreen::LANES * sizeof(double))));
+using Mask = int64_t __attribute__((vector_size(BarScreen::LANES * sizeof(int64_t))));
+
+constexpr size_t LANES = BarScreen::LANES;
+constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+inline Lanes splat(double value) {
+    return Lanes{} + value;
+}
+
+inline Mask splat_int(int64_t value) {
+    return Mask{} + value;
+}
+
+// Where mask is set, a; elsewhere b
+inline Lanes choose(Mask mask, Lanes a, Lanes b) {
+    return reinterpret_cast<Lanes>((mask & reinterpret_cast<Mask>(a)) | (~mask & reinterpret_cast<Mask>(b)));
+}
+
+inline Lanes max(Lanes a, Lanes b) {
+    return choose(a > b, a, b);
+}
+
+inline Lanes truncate(Lanes v) {
+    return __builtin_convertvector(__builtin_convertvector(v, Mask), Lanes);
+}
+
+// One top-of-book update the engine hands the strategies, as they see it
+struct BookPoint {
+    double mid;
+    double imbalance;
+    int64_t time_ns;            // From the symbol's first tick
+    uint32_t tick;              // The symbol's tick it came from
+};
+
+// A symbol's ticks as the engine turns them into book updates and fills
+struct SymbolBook {
+    std::vector<BookPoint> points;
+    // Per symbol tick: what a market order sent on it fills at
+    std::vector<double> buy_price;
+    std::vector<double> sell_price;
+    double mark = 0.0;          // Last mid, where open positions are marked
+};
+
+// The scalar inputs of one signal decision; a window's worth of points
+// before the first one is dropped
+struct Feature {
+    double a;                   // Momentum: summed returns; stat arb: price z-score
+    double b;                   // Momentum: mean flow; stat arb: imbalance z-score
+    int64_t time_ns;
+    uint32_t tick;
+};
+
+bool slips(FillModel model) {
+    return model == FillModel::REALISTIC_SLIPPAGE || model == FillModel::LATENCY_AWARE ||
+           model == FillModel::PARTIAL_FILLS;
+}
+
+// Replays build_book_updates() per symbol: a changed price is a DELETE of
+// the old level then an ADD, an unchanged one an UPDATE, bid side first,
+// and the strategies evaluate after each update the book accepts as valid
+std::vector<SymbolBook> build_books(const TickSeries& ticks, const FillConfig& fill_config) {
+    std::vector<SymbolBook> books;
+    std::unordered_map<std::string, size_t> index;
+    std::vector<std::vector<const MarketData*>> symbol_ticks;
+    for (const auto& tick : ticks) {
+        auto [it, inserted] = index.try_emplace(std::string(tick.symbol), symbol_ticks.size());
+        if (inserted) symbol_ticks.emplace_back();
+        symbol_ticks[it->second].push_back(&tick);
+    }
+
+    books.resize(symbol_ticks.size());
+    for (size_t s = 0; s < symbol_ticks.size(); ++s) {
+        const auto& series = symbol_ticks[s];
+        SymbolBook& book = books[s];
+        const int64_t first_ns = series.front()->header.timestamp.count();
+
+        price_t bid = 0, ask = 0;
+        uint32_t bid_size = 0, ask_size = 0;
+        auto evaluate = [&](uint32_t tick, int64_t time_ns) {
+            bool has_bid = bid > 0 && bid_size > 0;
+            bool has_ask = ask > 0 && ask_size > 0;
+            bool valid = has_bid && has_ask ? bid < ask : (has_bid || has_ask);
+            if (!valid) return;
+            double bid_depth = has_bid ? bid_size : 0.0;
+            double ask_depth = has_ask ? ask_size : 0.0;
+            double total = bid_depth + ask_depth;
+            book.points.push_back({has_bid && has_ask ? to_double_price(bid + ask) / 2.0 : 0.0,
+                                   total > 0.0 ? (bid_depth - ask_depth) / total : 0.0, time_ns, tick});
+        };
+
+        for (uint32_t t = 0; t < series.size(); ++t) {
+            const MarketData& data = *series[t];
+            int64_t time_ns = data.header.timestamp.count() - first_ns;
+            if (data.bid_price != bid) {
+                if (bid != 0) {
+                    bid_size = 0;
+                    evaluate(t, time_ns);
+                }
+                bid = data.bid_price;
+            }
+            bid_size = data.bid_size;
+            evaluate(t, time_ns);
+            if (data.ask_price != ask) {
+                if (ask != 0) {
+                    ask_size = 0;
+                    evaluate(t, time_ns);
+                }
+                ask = data.ask_price;
+            }
+            ask_size = data.ask_size;
+            evaluate(t, time_ns);
+        }
+
+        // Every model prices at the quote the order was sent on: IMMEDIATE
+        // at once, the others on the next tick's pending pass, which runs
+        // before that tick's quote is applied. finish_run() fills the orders
+        // sent on the last tick the same way.
+        book.buy_price.resize(series.size());
+        book.sell_price.resize(series.size());
+        for (size_t t = 0; t < series.size(); ++t) {
+            double quote_bid = to_double_price(series[t]->bid_price);
+            double quote_ask = to_double_price(series[t]->ask_price);
+            double slippage = 0.0;
+            if (slips(fill_config.model) && quote_bid > 0.0 && quote_ask > 0.0) {
+                double mid = (quote_bid + quote_ask) / 2.0;
+                slippage = fill_config.slippage_factor + (quote_ask - quote_bid) / mid * 0.5;
+            }
+            book.buy_price[t] = quote_ask * (1.0 + slippage);
+            book.sell_price[t] = quote_bid * (1.0 - slippage);
+        }
+        const MarketData& last = *series.back();
+        book.mark = (to_double_price(last.bid_price) + to_double_price(last.ask_price)) / 2.0;
+    }
+    return books;
+}
+
+// EnhancedMomentumStrategy::update_momentum_state / evaluate_momentum_signal
+void momentum_features(const SymbolBook& book, uint32_t window, std::vector<Feature>& out) {
+    RollingWindow changes(window), flows(window);
+    double last_mid = 0.0;
+    for (const BookPoint& point : book.points) {
+        if (last_mid > 0.0) {
+            changes.push((point.mid - last_mid) / last_mid);
+        }
+        flows.push(point.imbalance);
+        last_mid = point.mid;
+        if (changes.full()) {
+            out.push_back({changes.sum(), flows.mean(), point.time_ns, point.tick});
+        }
+    }
+}
+
+// StatArbStrategy::update_market_state / evaluate_stat_arb_signal
+void stat_arb_features(const SymbolBook& book, uint32_t window, std::vector<Feature>& out) {
+    RollingWindow mids(window), imbalances(window);
+    for (const BookPoint& point : book.points) {
+        mids.push(point.mid);
+        imbalances.push(point.imbalance);
+        if (mids.full()) {
+            out.push_back({mids.z_score(mids.back()), imbalances.z_score(imbalances.back()),
+                           point.time_ns, point.tick});
+        }
+    }
+}
+
+// Totals for LANES parameter sets, accumulated over symbols
+struct LaneTotals {
+    Lanes net_pnl{};
+    Lanes commission{};
+    Lanes orders{};
+    Lanes fills{};
+    Lanes filled_quantity{};
+};
+
+// One symbol's position and cash per lane, and the orders sent against it
+class LaneBook {
+public:
+    LaneBook(const SymbolBook& book, const FillConfig& fill_config, LaneTotals& totals)
+        : book_(book), fill_config_(fill_config), totals_(totals) {}
+
+    ~LaneBook() {
+        totals_.net_pnl += cash_ + position_ * book_.mark;
+    }
+
+    // A market order of size in each lane where hit is set; direction +1 buys
+    void trade(const Feature& feature, double direction, Mask hit, Lanes size) {
+        Lanes one = choose(hit, splat(1.0), Lanes{});
+        totals_.orders += one;
+        double raw = direction > 0 ? book_.buy_price[feature.tick] : book_.sell_price[feature.tick];
+        double price = to_double_price(to_fixed_price(raw));    // As the execution reports it
+        Lanes quantity = choose(hit, size, Lanes{});
+        position_ += direction * quantity;
+        cash_ -= direction * price * quantity;
+        totals_.fills += one;
+        totals_.filled_quantity += quantity;
+        Lanes fee = max(quantity * (fill_config_.commission_per_share + raw * fill_config_.commission_percentage),
+                        splat(fill_config_.minimum_commission));
+        totals_.commission += choose(hit, fee, Lanes{});
+        totals_.net_pnl -= choose(hit, fee, Lanes{});
+    }
+
+private:
+    const SymbolBook& book_;
+    const FillConfig& fill_config_;
+    LaneTotals& totals_;
+    Lanes position_{};
+    Lanes cash_{};
+};
+
+// Lanes past the last set never trade: their thresholds can't be exceeded
+template <typename Params, typename Get>
+Lanes gather(const Params* const* sets, size_t count, Get get, double padding) {
+    Lanes lanes = splat(padding);
+    for (size_t i = 0; i < count; ++i) lanes[i] = get(*sets[i]);
+    return lanes;
+}
+
+void run_lanes(const EnhancedMomentumStrategy::Parameters* const* sets, size_t count,
+               const std::vector<SymbolBook>& books, const std::vector<std::vector<Feature>>& features,
+               const FillConfig& fill_config, LaneTotals& totals) {
+    using P = EnhancedMomentumStrategy::Parameters;
+    const Lanes momentum_threshold = gather(sets, count, [](const P& p) { return p.momentum_threshold; }, NEVER);
+    const Lanes flow_threshold = gather(sets, count, [](const P& p) { return p.flow_threshold; }, NEVER);
+    const Lanes base_size = gather(sets, count, [](const P& p) { return double(p.base_signal_size); }, 0.0);
+    const Lanes multiplier_range = gather(sets, count, [](const P& p) { return p.max_signal_multiplier - 1.0; }, 0.0);
+
+    for (size_t s = 0; s < books.size(); ++s) {
+        LaneBook lanes(books[s], fill_config, totals);
+        for (const Feature& feature : features[s]) {
+            double momentum = std::abs(feature.a);
+            double flow = std::abs(feature.b);
+            Mask hit = (splat(momentum) > momentum_threshold) & (splat(flow) > flow_threshold);
+            double confidence = std::min(momentum + flow, 1.0);
+            Lanes size = truncate(base_size * (1.0 + confidence * multiplier_range));
+            lanes.trade(feature, feature.a > 0 ? 1.0 : -1.0, hit, size);
+        }
+    }
+}
+
+void run_lanes(const StatArbStrategy::Parameters* const* sets, size_t count,
+               const std::vector<SymbolBook>& books, const std::vector<std::vector<Feature>>& features,
+               const FillConfig& fill_config, LaneTotals& totals) {
+    using P = StatArbStrategy::Parameters;
+    const Lanes price_threshold = gather(sets, count, [](const P& p) { return p.price_threshold; }, NEVER);
+    const Lanes imbalance_threshold = gather(sets, count, [](const P& p) { return p.imbalance_threshold; }, NEVER);
+    const Lanes size = gather(sets, count, [](const P& p) { return double(p.signal_size); }, 0.0);
+    // Whole milliseconds elapsed >= interval, compared in nanoseconds
+    Mask interval_ns{};
+    for (size_t i = 0; i < count; ++i) interval_ns[i] = int64_t(sets[i]->min_signal_interval_ms) * 1000000;
+
+    for (size_t s = 0; s < books.size(); ++s) {
+        LaneBook lanes(books[s], fill_config, totals);
+        Mask last_signal_ns = splat_int(std::numeric_limits<int64_t>::min() / 2);
+        for (const Feature& feature : features[s]) {
+            Mask hit = (splat(std::abs(feature.a)) > price_threshold) &
+                       (splat(std::abs(feature.b)) > imbalance_threshold) &
+                       (splat_int(feature.time_ns) - last_signal_ns >= interval_ns);
+            last_signal_ns = (hit & splat_int(feature.time_ns)) | (~hit & last_signal_ns);
+            lanes.trade(feature, feature.a > 0 ? -1.0 : 1.0, hit, size);
+        }
+    }
+}
+
+uint32_t window_of(const EnhancedMomentumStrategy::Parameters& p) { return p.momentum_window; }
+uint32_t window_of(const StatArbStrategy::Parameters& p) { return p.lookback_periods; }
+
+void features_of(const EnhancedMomentumStrategy::Parameters&, const SymbolBook& book, uint32_t window,
+                 std::vector<Feature>& out) {
+    momentum_features(book, window, out);
+}
+void features_of(const StatArbStrategy::Parameters&, const SymbolBook& book, uint32_t window,
+                 std::vector<Feature>& out) {
+    stat_arb_features(book, window, out);
+}
+
+template <typename Strategy>
+std::vector<BarScreen::Result> score_sets(const TickSeries& ticks, const std::vector<ParameterValues>& sets,
+                                          const FillConfig& fill_config, size_t threads) {
+    using Params = typename Strategy::Parameters;
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<BarScreen::Result> results(sets.size());
+
+    // Sets through the strategy's own field table and validation
+    const auto& fields = Strategy::parameter_fields();
+    std::vector<Params> params(sets.size());
+    std::map<uint32_t, std::vector<size_t>> by_window;
+    for (size_t i = 0; i < sets.size(); ++i) {
+        bool known = true;
+        for (const auto& [name, value] : sets[i]) {
+            auto field = std::find_if(fields.begin(), fields.end(),
+                                      [&name](const auto& f) { return name == f.name; });
+            if (field == fields.end()) {
+                known = false;
+                break;
+            }
+            field->apply(params[i], value);
+        }
+        std::string error;
+        if (known && Strategy::validate_parameters(params[i], error)) {
+            by_window[window_of(params[i])].push_back(i);
+        }
+    }
+
+    std::vector<SymbolBook> books = build_books(ticks, fill_config);
+
+    // Work items: LANES sets of one window each
+    struct Block {
+        const std::vector<std::vector<Feature>>* features;
+        std::array<const Params*, LANES> sets;
+        std::array<size_t, LANES> ids;
+        size_t count;
+    };
+    std::vector<std::vector<std::vector<Feature>>> features;
+    features.reserve(by_window.size());
+    std::vector<Block> blocks;
+    for (const auto& [window, ids] : by_window) {
+        auto& symbol_features = features.emplace_back(books.size());
+        for (size_t s = 0; s < books.size(); ++s) {
+            features_of(params[ids.front()], books[s], window, symbol_features[s]);
+        }
+        for (size_t first = 0; first < ids.size(); first += LANES) {
+            Block block{&symbol_features, {}, {}, std::min(LANES, ids.size() - first)};
+            for (size_t i = 0; i < block.count; ++i) {
+                block.ids[i] = ids[first + i];
+                block.sets[i] = &params[ids[first + i]];
+            }
+            blocks.push_back(block);
+        }
+    }
+
+    auto run_block = [&](const Block& block) {
+        LaneTotals totals;
+        run_lanes(block.sets.data(), block.count, books, *block.features, fill_config, totals);
+        for (size_t i = 0; i < block.count; ++i) {
+            BacktestStats& stats = results[block.ids[i]].stats;
+            stats.orders = static_cast<uint64_t>(totals.orders[i]);
+            stats.signals = stats.orders;
+            stats.fills = static_cast<uint64_t>(totals.fills[i]);
+            stats.filled_quantity = static_cast<uint64_t>(totals.filled_quantity[i]);
+            stats.commission = totals.commission[i];
+            stats.net_pnl = totals.net_pnl[i];
+            results[block.ids[i]].completed = true;
+        }
+    };
+
+    size_t thread_count = threads != 0 ? threads : std::thread::hardware_concurrency();
+    thread_count = std::max<size_t>(1, std::min(thread_count, blocks.size()));
+    std::atomic<size_t> next_block{0};
+    auto worker = [&]() {
+        for (size_t i = next_block.fetch_add(1); i < blocks.size(); i = next_block.fetch_add(1)) {
+            run_block(blocks[i]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < thread_count; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    for (auto& result : results) {
+        result.stats.ticks = ticks.size();
+        result.stats.first_tick_time = ticks.front().header.timestamp;
+        result.stats.last_tick_time = ticks.back().header.timestamp;
+        result.stats.wall_seconds = wall_seconds;
+    }
+    return results;
+}
+
+} // namespace
+
+bool BarScreen::supports(StrategyType type) {
+    return type == StrategyType::STAT_ARB || type == StrategyType::ENHANCED_MOMENTUM;
+}
+
+std::vector<BarScreen::Result> BarScreen::score(StrategyType type, const std::vector<ParameterValues>& sets,
+                                                const FillConfig& fill_config, size_t threads) const {
+    if (!ticks_ || ticks_->empty() || sets.empty()) {
+        return std::vector<Result>(sets.size());
+    }
+    switch (type) {
+        case StrategyType::STAT_ARB:
+            return score_sets<StatArbStrategy>(*ticks_, sets, fill_config, threads);
+        case StrategyType::ENHANCED_MOMENTUM:
+            return score_sets<EnhancedMomentumStrategy>(*ticks_, sets, fill_config, threads);
+        default:
+            std::cerr << "[BarScreen] No vector model for "
+                      << StrategyFactory::strategy_type_to_string(type) << std::endl;
+            return std::vector<Result>(sets.size());
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "backtest_engine.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hft {
+
+using ParameterValues = std::vector<std::pair<std::string, double>>;
+
+// Coarse screen for a parameter sweep over bar data (DataDownloader's OHLCV
+// bars, replayed as ticks): scores thousands of parameter sets in the time
+// the event-driven engine takes for a few, so only the best go on to the
+// full simulation.
+//
+// The strategy logic is EnhancedMomentumStrategy's and StatArbStrategy's,
+// evaluated at the same points the engine evaluates them: every top-of-book
+// update BacktestEngine derives from a tick, one-sided books included. The
+// features (rolling sums, means, z-scores) depend only on the window
+// length, so they are computed once per distinct window and shared by every
+// set with it; what differs between sets (thresholds, sizes, the signal
+// interval) is applied in vector lanes, one set per lane, without branches.
+//
+// The result is BacktestStats as the engine reports it, with orders, fills
+// and filled quantity matching the engine's. Fills are deterministic: each
+// market order fills whole at the feed's touch of the tick it was sent on,
+// where the fill simulator prices it under every model, moved by
+// slippage_factor plus half the quoted spread for the slippage models. The
+// engine randomizes spreads, slippage and latency, so net P&L is an
+// estimate that ranks sets, not the number the full simulation will report.
+class BarScreen {
+public:
+#if defined(__AVX__)
+    static constexpr size_t LANES = 4;
+#else
+    static constexpr size_t LANES = 2;
+#endif
+
+    void set_ticks(std::shared_ptr<const TickSeries> ticks) { ticks_ = std::move(ticks); }
+
+    // Strategies with a vector model; MARKET_MAKING's quoting needs the
+    // engine's queue simulation
+    static bool supports(StrategyType type);
+
+    // One result per set, in order; false in completed for a set with an
+    // unknown name or values the strategy rejects. threads = 0 uses every
+    // core.
+    struct Result {
+        BacktestStats stats;
+        bool completed = false;
+    };
+    std::vector<Result> score(StrategyType type, const std::vector<ParameterValues>& sets,
+                              const FillConfig& fill_config, size_t threads = 0) const;
+
+private:
+    std::shared_ptr<const TickSeries> ticks_;
+};
+
+} // namespace hft
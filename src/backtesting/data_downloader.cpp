@@ -1,5 +1,7 @@
 #include "data_downloader.h"
+#include "tick_store.h"
 #include "../common/static_config.h"
+#include "../common/token_bucket.h"
 #include <curl/curl.h>
 #include <json/json.h>
 #include <fstream>
@@ -10,7 +12,12 @@
 #include <iomanip>
 #include <unordered_set>
 #include <random>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
+#include <deque>
+#include <filesystem>
 
 namespace hft {
 
@@ -21,6 +28,248 @@ size_t WriteDataCallback(void* contents, size_t size, size_t nmemb, std::string*
     return totalSize;
 }
 
+namespace {
+
+constexpr uint64_t DAY_MS = 24ULL * 60 * 60 * 1000;
+constexpr int ALPACA_PAGE_LIMIT = 10000;            // Most bars Alpaca returns per page
+
+uint64_t utc_date_ms(const std::string& date) {
+    std::tm tm = {};
+    std::istringstream ss(date);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    if (ss.fail()) return 0;
+    return static_cast<uint64_t>(timegm(&tm)) * 1000;
+}
+
+std::string format_utc(uint64_t timestamp_ms, const char* format) {
+    auto seconds = static_cast<time_t>(timestamp_ms / 1000);
+    std::tm tm = {};
+    gmtime_r(&seconds, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), format, &tm);
+    return buffer;
+}
+
+// RFC 3339, as Alpaca stamps bars: 2023-01-03T14:30:00Z
+uint64_t parse_rfc3339_ms(const std::string& text) {
+    std::tm tm = {};
+    if (std::sscanf(text.c_str(), "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+        return 0;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    return static_cast<uint64_t>(timegm(&tm)) * 1000;
+}
+
+const char* alpaca_timeframe(TimeInterval interval) {
+    switch (interval) {
+        case TimeInterval::MINUTE_1: return "1Min";
+        case TimeInterval::MINUTE_5: return "5Min";
+        case TimeInterval::MINUTE_15: return "15Min";
+        case TimeInterval::MINUTE_30: return "30Min";
+        case TimeInterval::HOUR_1: return "1Hour";
+        case TimeInterval::DAY_1: return "1Day";
+        case TimeInterval::WEEK_1: return "1Week";
+        case TimeInterval::MONTH_1: return "1Month";
+        default: return "1Day";
+    }
+}
+
+// About a page of extended-hours bars per chunk at minute resolution
+int default_chunk_days(TimeInterval interval) {
+    switch (interval) {
+        case TimeInterval::MINUTE_1: return 10;
+        case TimeInterval::MINUTE_5: return 30;
+        case TimeInterval::MINUTE_15: return 90;
+        case TimeInterval::MINUTE_30: return 180;
+        case TimeInterval::HOUR_1: return 365;
+        default: return 3650;
+    }
+}
+
+// A data CSV row: timestamp,symbol,open,high,low,close,volume[,bid,ask]
+bool parse_csv_row(const std::string& line, HistoricalDataPoint& point) {
+    point = HistoricalDataPoint{};
+    const char* p = line.c_str();
+    char* end = nullptr;
+    errno = 0;
+    point.timestamp = std::strtoull(p, &end, 10);
+    if (end == p || *end != ',' || errno != 0) return false;
+    p = end + 1;
+    const char* comma = std::strchr(p, ',');
+    if (!comma || comma == p) return false;
+    std::memcpy(point.symbol, p, std::min<size_t>(comma - p, sizeof(point.symbol) - 1));
+    p = comma + 1;
+
+    double* prices[] = {&point.open_price, &point.high_price, &point.low_price, &point.last_price};
+    for (double* price : prices) {
+        *price = std::strtod(p, &end);
+        if (end == p || *end != ',') return false;
+        p = end + 1;
+    }
+    point.total_volume = std::strtoull(p, &end, 10);
+    if (end == p) return false;
+    if (*end == '.') std::strtod(p, &end);     // Fractional volume: whole shares kept
+    if (*end == ',') {
+        p = end + 1;
+        point.bid_price = std::strtod(p, &end);
+        if (end == p) return false;
+        if (*end == ',') {
+            p = end + 1;
+            point.ask_price = std::strtod(p, &end);
+            if (end == p) return false;
+        }
+    }
+    while (*end == '\r' || *end == ' ') end++;
+    return *end == '\0';
+}
+
+// Streams a data CSV a row at a time, skipping the header and malformed rows
+class CsvRowReader {
+public:
+    explicit CsvRowReader(const std::string& file_path) : file_(file_path) {
+        std::getline(file_, line_);
+    }
+
+    bool is_open() const { return file_.is_open(); }
+
+    bool next(HistoricalDataPoint& point) {
+        while (std::getline(file_, line_)) {
+            if (line_.empty() || line_ == "\r") continue;
+            if (parse_csv_row(line_, point)) return true;
+            malformed_++;
+        }
+        return false;
+    }
+
+    size_t malformed() const { return malformed_; }
+
+private:
+    std::ifstream file_;
+    std::string line_;
+    size_t malformed_ = 0;
+};
+
+// One pass over a file's rows in file order; memory is per symbol, not per row
+class DataValidator {
+public:
+    void add(const HistoricalDataPoint& point) {
+        result_.total_points++;
+        first_ = std::min(first_, point.timestamp);
+        last_ = std::max(last_, point.timestamp);
+
+        if (point.high_price < point.low_price || point.open_price < 0 || point.last_price < 0) {
+            if (result_.inconsistent_points++ == 0) {
+                note(std::string("Inconsistent prices for ") + point.symbol + " at " + std::to_string(point.timestamp));
+            }
+        }
+        if (point.bid_price > 0 && point.ask_price > 0 && point.bid_price > point.ask_price) {
+            if (result_.crossed_quotes++ == 0) {
+                note(std::string("Crossed quote for ") + point.symbol + " at " + std::to_string(point.timestamp));
+            }
+        }
+
+        auto [it, added] = symbols_.try_emplace(point.symbol);
+        Track& track = it->second;
+        if (added) {
+            track.last = point.timestamp;
+        } else if (point.timestamp == track.last) {
+            result_.duplicate_points++;
+        } else if (point.timestamp < track.last) {
+            result_.out_of_order_points++;
+        } else {
+            uint64_t step = point.timestamp - track.last;
+            track.step = track.step == 0 ? step : std::min(track.step, step);
+            // Overnight and weekend gaps are not missing bars
+            if (point.timestamp / DAY_MS == track.last / DAY_MS) {
+                track.intraday_span += step;
+                track.intraday_steps++;
+            }
+            track.last = point.timestamp;
+        }
+    }
+
+    ValidationResult finish(size_t malformed_rows, const std::string& time_format) {
+        result_.malformed_rows = malformed_rows;
+        // Exact when timestamps sit on the symbol's bar grid
+        for (const auto& [symbol, track] : symbols_) {
+            if (track.step > 0) result_.missing_points += track.intraday_span / track.step - track.intraday_steps;
+        }
+        if (result_.total_points == 0) {
+            result_.error_message = "No data found in file";
+            return result_;
+        }
+        result_.time_range = format_utc(first_, time_format.c_str()) + " to " + format_utc(last_, time_format.c_str());
+        result_.valid = result_.inconsistent_points == 0 && result_.crossed_quotes == 0;
+        return result_;
+    }
+
+private:
+    struct Track {
+        uint64_t last = 0;
+        uint64_t step = 0;              // Smallest positive step seen
+        uint64_t intraday_span = 0;     // Time covered by steps within a day
+        uint64_t intraday_steps = 0;
+    };
+
+    ValidationResult result_{};
+    std::unordered_map<std::string, Track> symbols_;
+    uint64_t first_ = UINT64_MAX;
+    uint64_t last_ = 0;
+
+    void note(const std::string& message) {
+        if (result_.error_message.empty()) result_.error_message = message;
+    }
+};
+
+// Calls fn(i) for i in [0, count) on up to threads workers
+template <typename Fn>
+void for_each_parallel(size_t count, size_t threads, Fn&& fn) {
+    size_t thread_count = threads != 0 ? threads : std::thread::hardware_concurrency();
+    thread_count = std::max<size_t>(1, std::min(thread_count, count));
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+void write_csv_row(std::ostream& out, const HistoricalDataPoint& point) {
+    out << point.timestamp << ","
+        << point.symbol << ","
+        << std::fixed << std::setprecision(4)
+        << point.open_price << ","
+        << point.high_price << ","
+        << point.low_price << ","
+        << point.last_price << ","
+        << point.total_volume << ","
+        << point.bid_price << ","
+        << point.ask_price << "\n";
+}
+
+// A chunk being downloaded: its run stays open from its first page to its last
+struct ChunkTransfer {
+    const DownloadChunk* chunk = nullptr;
+    TickRunWriter run;
+    std::string page_token;
+    uint64_t start_ms = 0;          // After any records a previous attempt kept
+    int attempts = 0;
+    std::string body;
+    CURL* easy = nullptr;
+};
+
+} // namespace
+
 DataDownloader::DataDownloader() 
     : logger_("DataDownloader", StaticConfig::get_logger_endpoint()) {
     initialize_source_configs();
@@ -150,6 +399,13 @@ bool DataDownloader::download_symbol_list(const std::vector<std::string>& symbol
                                         const std::string& end_date,
                                         const std::string& output_dir) {
     
+    // Alpaca lists go to one tick store through the concurrent pipeline
+    if (source == DataSource::ALPACA) {
+        return download_to_tick_store(symbols, source, interval, start_date, end_date,
+                                      output_dir + "/" + interval_to_string(interval) + "_" +
+                                      start_date + "_to_" + end_date + tick_store::FILE_EXTENSION);
+    }
+    
     std::vector<DataRequest> requests;
     for (const auto& symbol : symbols) {
         DataRequest request;
@@ -167,51 +423,317 @@ bool DataDownloader::download_symbol_list(const std::vector<std::string>& symbol
     return download_multiple_symbols(requests);
 }
 
-ValidationResult DataDownloader::validate_data_file(const std::string& file_path) {
-    ValidationResult result{};
-    result.valid = false;
-    
-    try {
-        std::vector<HistoricalDataPoint> data = read_data_from_csv(file_path);
-        
-        if (data.empty()) {
-            result.error_message = "No data found in file";
-            return result;
+std::vector<DownloadChunk> DataDownloader::plan_chunks(const std::vector<std::string>& symbols,
+                                                       TimeInterval interval,
+                                                       uint64_t start_ms, uint64_t end_ms,
+                                                       int chunk_days,
+                                                       const std::string& work_dir) {
+    uint64_t chunk_ms = static_cast<uint64_t>(chunk_days > 0 ? chunk_days : default_chunk_days(interval)) * DAY_MS;
+    std::vector<DownloadChunk> chunks;
+    for (const auto& symbol : symbols) {
+        for (uint64_t start = start_ms; start < end_ms; start += chunk_ms) {
+            DownloadChunk chunk;
+            chunk.symbol = symbol;
+            chunk.start_ms = start;
+            chunk.end_ms = std::min(start + chunk_ms, end_ms);
+            chunk.run_path = work_dir + "/" + symbol + "_" + interval_to_string(interval) + "_" +
+                             format_utc(start, "%Y%m%d");
+            chunks.push_back(std::move(chunk));
         }
-        
-        result.total_points = data.size();
-        
-        // Check for duplicates
-        std::unordered_set<uint64_t> timestamps;
-        for (const auto& point : data) {
-            if (timestamps.find(point.timestamp) != timestamps.end()) {
-                result.duplicate_points++;
+    }
+    return chunks;
+}
+
+long DataDownloader::decode_alpaca_bars(const std::string& body, TickRunWriter& run, std::string& next_page_token) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value root;
+    std::string errors;
+    if (!reader->parse(body.data(), body.data() + body.size(), &root, &errors) ||
+        !root.isObject() || !root.isMember("bars")) {
+        return -1;
+    }
+
+    const Json::Value& token = root["next_page_token"];
+    next_page_token = token.isString() ? token.asString() : "";
+
+    const Json::Value& bars = root["bars"];
+    if (bars.isNull()) return 0;        // No bars in range (a holiday, say)
+    if (!bars.isArray()) return -1;
+
+    long appended = 0;
+    for (const auto& bar : bars) {
+        TickRecord record{};
+        record.timestamp = parse_rfc3339_ms(bar["t"].asString());
+        if (record.timestamp == 0) return -1;
+        double close = bar["c"].asDouble();
+        record.open_price = to_fixed_price(bar["o"].asDouble());
+        record.high_price = to_fixed_price(bar["h"].asDouble());
+        record.low_price = to_fixed_price(bar["l"].asDouble());
+        record.last_price = to_fixed_price(close);
+        // Same spread defaults the player applies to CSV rows without quotes
+        record.bid_price = to_fixed_price(close * 0.999);
+        record.ask_price = to_fixed_price(close * 1.001);
+        record.total_volume = static_cast<uint64_t>(bar["v"].asDouble());
+        if (!run.append(record)) return -1;
+        appended++;
+    }
+    return appended;
+}
+
+bool DataDownloader::download_to_tick_store(const std::vector<std::string>& symbols,
+                                            DataSource source,
+                                            TimeInterval interval,
+                                            const std::string& start_date,
+                                            const std::string& end_date,
+                                            const std::string& output_file,
+                                            const BulkDownloadOptions& options) {
+    if (source != DataSource::ALPACA) {
+        logger_.error("Bulk download not implemented for " + source_to_string(source));
+        return false;
+    }
+    if (!alpaca_client_) {
+        logger_.error("Alpaca data client not initialized (set ALPACA_API_KEY and ALPACA_API_SECRET)");
+        return false;
+    }
+    uint64_t start_ms = utc_date_ms(start_date);
+    uint64_t end_ms = utc_date_ms(end_date);
+    if (start_ms == 0 || end_ms == 0 || end_ms < start_ms) {
+        logger_.error("Invalid date range " + start_date + " to " + end_date);
+        return false;
+    }
+    end_ms += DAY_MS;       // end_date is inclusive
+
+    std::string work_dir = options.work_dir.empty() ? output_file + ".parts" : options.work_dir;
+    std::error_code error;
+    std::filesystem::create_directories(work_dir, error);
+    if (error) {
+        logger_.error("Could not create " + work_dir + ": " + error.message());
+        return false;
+    }
+
+    const std::vector<DownloadChunk> chunks = plan_chunks(symbols, interval, start_ms, end_ms,
+                                                          options.chunk_days, work_dir);
+    std::vector<std::string> run_paths;
+    run_paths.reserve(chunks.size());
+    std::vector<ChunkTransfer> transfers(chunks.size());
+    std::deque<size_t> ready;       // Chunks with a page to request
+    int total = static_cast<int>(chunks.size());
+    int completed = 0;
+    int failed = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        transfers[i].chunk = &chunks[i];
+        run_paths.push_back(chunks[i].run_path + ".run");
+        if (std::filesystem::exists(run_paths.back())) {
+            completed++;        // Finished by an earlier run
+        } else {
+            ready.push_back(i);
+        }
+    }
+    logger_.info("Downloading " + std::to_string(symbols.size()) + " symbols in " + std::to_string(total) +
+                 " chunks, " + std::to_string(completed) + " already complete");
+
+    const DataSourceConfig& config = source_configs_[source];
+    TokenBucket requests;
+    requests.configure(config.rate_limit_requests_per_minute / 60.0,
+                       static_cast<uint32_t>(std::max<size_t>(options.max_concurrency, 1)));
+    auto now_ns = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    };
+
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, ("APCA-API-KEY-ID: " + alpaca_client_->api_key()).c_str());
+    headers = curl_slist_append(headers, ("APCA-API-SECRET-KEY: " + alpaca_client_->api_secret()).c_str());
+    CURLM* multi = curl_multi_init();
+    size_t max_in_flight = std::max<size_t>(options.max_concurrency, 1);
+    size_t in_flight = 0;
+
+    auto start_transfer = [&](ChunkTransfer& transfer) {
+        const DownloadChunk& chunk = *transfer.chunk;
+        if (!transfer.run.is_open()) {
+            // A partial run from a killed download keeps its records
+            if (!transfer.run.open(chunk.run_path + ".tmp", chunk.symbol)) return false;
+            transfer.start_ms = transfer.run.records() > 0
+                ? (transfer.run.last_timestamp() / 1000 + 1) * 1000
+                : chunk.start_ms;
+        }
+        std::string url = config.base_url + "/v2/stocks/" + chunk.symbol + "/bars?timeframe=" +
+                          alpaca_timeframe(interval) +
+                          "&start=" + format_utc(transfer.start_ms, "%Y-%m-%dT%H:%M:%SZ") +
+                          "&end=" + format_utc(chunk.end_ms, "%Y-%m-%dT%H:%M:%SZ") +
+                          "&limit=" + std::to_string(ALPACA_PAGE_LIMIT) + "&adjustment=all";
+        if (!transfer.page_token.empty()) url += "&page_token=" + transfer.page_token;
+
+        transfer.body.clear();
+        transfer.easy = curl_easy_init();
+        curl_easy_setopt(transfer.easy, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(transfer.easy, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(transfer.easy, CURLOPT_WRITEFUNCTION, WriteDataCallback);
+        curl_easy_setopt(transfer.easy, CURLOPT_WRITEDATA, &transfer.body);
+        curl_easy_setopt(transfer.easy, CURLOPT_ACCEPT_ENCODING, "");
+        curl_easy_setopt(transfer.easy, CURLOPT_TIMEOUT, 60L);
+        curl_easy_setopt(transfer.easy, CURLOPT_PRIVATE, &transfer);
+        curl_multi_add_handle(multi, transfer.easy);
+        return true;
+    };
+
+    auto fail = [&](ChunkTransfer& transfer, const std::string& reason) {
+        logger_.error("Chunk " + transfer.chunk->run_path + " failed: " + reason);
+        transfer.run.close();       // The .tmp stays for the next attempt
+        failed++;
+    };
+
+    auto finish = [&](ChunkTransfer& transfer, CURLcode result) {
+        long status = 0;
+        curl_easy_getinfo(transfer.easy, CURLINFO_RESPONSE_CODE, &status);
+        curl_multi_remove_handle(multi, transfer.easy);
+        curl_easy_cleanup(transfer.easy);
+        transfer.easy = nullptr;
+        size_t index = &transfer - transfers.data();
+
+        if (status == 429) {
+            // Over the source's limit anyway (another client on the key): back off everyone
+            requests.defer(now_ns() + 5'000'000'000LL);
+            ready.push_front(index);
+            return;
+        }
+        if (result != CURLE_OK || status >= 500) {
+            if (++transfer.attempts > options.max_retries) {
+                fail(transfer, result != CURLE_OK ? curl_easy_strerror(result) : "HTTP " + std::to_string(status));
+                return;
+            }
+            requests.defer(now_ns() + transfer.attempts * 1'000'000'000LL);
+            ready.push_back(index);
+            return;
+        }
+        if (status != 200) {
+            fail(transfer, "HTTP " + std::to_string(status) + " " + transfer.body.substr(0, 200));
+            return;
+        }
+
+        std::string next_page_token;
+        if (decode_alpaca_bars(transfer.body, transfer.run, next_page_token) < 0) {
+            fail(transfer, "undecodable response");
+            return;
+        }
+        transfer.attempts = 0;
+        transfer.body = std::string();
+        if (!next_page_token.empty()) {
+            transfer.page_token = std::move(next_page_token);
+            ready.push_front(index);        // Depth first: few runs open at once
+            return;
+        }
+
+        const DownloadChunk& chunk = *transfer.chunk;
+        if (!transfer.run.close()) {
+            fail(transfer, "could not write run");
+            return;
+        }
+        std::error_code rename_error;
+        std::filesystem::rename(chunk.run_path + ".tmp", chunk.run_path + ".run", rename_error);
+        if (rename_error) {
+            fail(transfer, rename_error.message());
+            return;
+        }
+        completed++;
+        if (progress_callback_) {
+            progress_callback_(chunk.symbol, completed, total);
+        }
+    };
+
+    while (!ready.empty() || in_flight > 0) {
+        while (in_flight < max_in_flight && !ready.empty() && requests.try_acquire(now_ns())) {
+            size_t index = ready.front();
+            ready.pop_front();
+            if (start_transfer(transfers[index])) {
+                in_flight++;
             } else {
-                timestamps.insert(point.timestamp);
+                fail(transfers[index], "could not open run");
             }
         }
-        
-        // Check time range
-        auto min_time = std::min_element(data.begin(), data.end(),
-            [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
-        auto max_time = std::max_element(data.begin(), data.end(),
-            [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
-        
-        result.time_range = timestamp_to_date_string(min_time->timestamp) + " to " +
-                           timestamp_to_date_string(max_time->timestamp);
-        
-        // Basic data consistency checks
-        result.valid = validate_data_consistency(data);
-        
-        if (!result.valid && result.error_message.empty()) {
-            result.error_message = "Data consistency checks failed";
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+            if (message->msg != CURLMSG_DONE) continue;
+            ChunkTransfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+            in_flight--;
+            finish(*transfer, message->data.result);
         }
-        
-    } catch (const std::exception& e) {
-        result.error_message = "Exception validating file: " + std::string(e.what());
+
+        // Sleep until a socket is ready, or until the next request may go
+        int timeout_ms = 1000;
+        if (!ready.empty() && in_flight < max_in_flight) {
+            int64_t wait_ns = requests.ready_at_ns() - now_ns();
+            timeout_ms = static_cast<int>(std::clamp<int64_t>(wait_ns / 1'000'000, 0, 1000));
+        }
+        if (in_flight > 0 || timeout_ms > 0) {
+            curl_multi_poll(multi, nullptr, 0, timeout_ms, nullptr);
+        }
+    }
+
+    curl_multi_cleanup(multi);
+    curl_slist_free_all(headers);
+
+    if (failed > 0) {
+        logger_.error(std::to_string(failed) + " of " + std::to_string(total) +
+                      " chunks failed; rerun to resume from " + work_dir);
+        return false;
+    }
+    if (!TickStoreWriter::merge(output_file, run_paths)) {
+        logger_.error("Failed to merge runs into tick store: " + output_file);
+        return false;
     }
+    if (!options.keep_runs) {
+        std::filesystem::remove_all(work_dir, error);
+    }
+    logger_.info("Downloaded " + std::to_string(symbols.size()) + " symbols to tick store " + output_file);
+    return true;
+}
+
+ValidationResult DataDownloader::validate_data_file(const std::string& file_path) {
+    DataValidator validator;
+    HistoricalDataPoint point{};
     
-    return result;
+    if (TickStoreReader::is_tick_store(file_path)) {
+        TickStoreReader reader;
+        if (!reader.open(file_path)) {
+            ValidationResult result{};
+            result.error_message = "Could not open tick store";
+            return result;
+        }
+        for (size_t i = 0; i < reader.size(); ++i) {
+            validator.add(reader.to_data_point(reader.record(i)));
+        }
+        return validator.finish(0, "%Y-%m-%d");
+    }
+    
+    CsvRowReader reader(file_path);
+    if (!reader.is_open()) {
+        ValidationResult result{};
+        result.error_message = "Failed to open file";
+        return result;
+    }
+    while (reader.next(point)) {
+        validator.add(point);
+    }
+    return validator.finish(reader.malformed(), "%Y-%m-%d");
+}
+
+std::vector<ValidationResult> DataDownloader::validate_data_files(const std::vector<std::string>& file_paths,
+                                                                  size_t threads) {
+    std::vector<ValidationResult> results(file_paths.size());
+    for_each_parallel(file_paths.size(), threads, [&](size_t i) {
+        results[i] = validate_data_file(file_paths[i]);
+    });
+    
+    size_t invalid = std::count_if(results.begin(), results.end(), [](const auto& r) { return !r.valid; });
+    logger_.info("Validated " + std::to_string(file_paths.size()) + " files, " +
+                 std::to_string(invalid) + " invalid");
+    return results;
 }
 
 bool DataDownloader::download_from_yahoo(const DataRequest& request) {
@@ -313,16 +835,7 @@ bool DataDownloader::write_data_to_csv(const std::vector<HistoricalDataPoint>& d
     
     // Write data
     for (const auto& point : data) {
-        file << point.timestamp << ","
-             << point.symbol << ","
-             << std::fixed << std::setprecision(4)
-             << point.open_price << ","
-             << point.high_price << ","
-             << point.low_price << ","
-             << point.last_price << ","
-             << point.total_volume << ","
-             << point.bid_price << ","
-             << point.ask_price << "\n";
+        write_csv_row(file, point);
     }
     
     file.close();
@@ -505,12 +1018,19 @@ int DataDownloader::get_interval_minutes(TimeInterval interval) {
     }
 }
 
-// Stub implementations for data source methods
-bool DataDownloader::download_from_alpaca(const DataRequest&) {
-    logger_.warning("Alpaca download not implemented");
-    return false;
+// Alpaca writes tick stores, whatever output_file's extension; the player
+// recognises them by their magic
+bool DataDownloader::download_from_alpaca(const DataRequest& request) {
+    if (request.output_file.empty()) {
+        logger_.error("Alpaca download needs an output file");
+        return false;
+    }
+    return download_to_tick_store({request.symbol}, request.source, request.interval,
+                                  request.start_date, request.end_date, request.output_file);
 }
 
+// Stub implementations for data source methods
+
 bool DataDownloader::download_from_alphavantage(const DataRequest&) {
     logger_.warning("Alpha Vantage download not implemented");
     return false;
@@ -573,35 +1093,153 @@ std::vector<std::string> DataDownloader::get_supported_symbols(DataSource source
     return {};
 }
 
-bool DataDownloader::merge_data_files(const std::vector<std::string>& input_files,
-                                     const std::string& output_file) {
-    logger_.info("Merging " + std::to_string(input_files.size()) + " data files");
+bool DataDownloader::build_tick_store(const std::vector<std::string>& input_files,
+                                      const std::string& tick_file, size_t threads) {
+    std::string work_dir = tick_file + ".parts";
+    std::error_code error;
+    std::filesystem::remove_all(work_dir, error);
+    std::filesystem::create_directories(work_dir, error);
+    if (error) {
+        logger_.error("Could not create " + work_dir + ": " + error.message());
+        return false;
+    }
     
-    std::vector<HistoricalDataPoint> all_data;
+    // Each file splits into per-symbol runs in parallel; a symbol going back
+    // in time starts a new run, so unsorted input still merges in order
+    struct FileRuns {
+        std::vector<std::string> paths;
+        size_t rows = 0;
+        size_t malformed = 0;
+        std::string error;
+    };
+    std::vector<FileRuns> files(input_files.size());
+    for_each_parallel(input_files.size(), threads, [&](size_t i) {
+        FileRuns& out = files[i];
+        CsvRowReader reader(input_files[i]);
+        if (!reader.is_open()) {
+            out.error = "Failed to open " + input_files[i];
+            return;
+        }
+        std::unordered_map<std::string, std::unique_ptr<TickRunWriter>> runs;
+        HistoricalDataPoint point{};
+        while (reader.next(point)) {
+            // Same spread defaults the player applies to CSV rows without quotes
+            if (point.bid_price == 0.0) point.bid_price = point.last_price * 0.999;
+            if (point.ask_price == 0.0) point.ask_price = point.last_price * 1.001;
+            
+            auto& run = runs[point.symbol];
+            if (!run || point.timestamp < run->last_timestamp()) {
+                if (!run) run = std::make_unique<TickRunWriter>();
+                std::string path = work_dir + "/" + std::to_string(i) + "_" + std::to_string(out.paths.size()) + ".run";
+                if (!run->open(path, point.symbol)) {
+                    out.error = "Could not write run for " + std::string(point.symbol);
+                    return;
+                }
+                out.paths.push_back(path);
+            }
+            
+            TickRecord record{};
+            record.timestamp = point.timestamp;
+            record.open_price = to_fixed_price(point.open_price);
+            record.high_price = to_fixed_price(point.high_price);
+            record.low_price = to_fixed_price(point.low_price);
+            record.last_price = to_fixed_price(point.last_price);
+            record.bid_price = to_fixed_price(point.bid_price);
+            record.ask_price = to_fixed_price(point.ask_price);
+            record.total_volume = point.total_volume;
+            if (!run->append(record)) {
+                out.error = "Could not write run for " + std::string(point.symbol);
+                return;
+            }
+            out.rows++;
+        }
+        for (auto& [symbol, run] : runs) {
+            if (!run->close()) out.error = "Could not write run for " + symbol;
+        }
+        out.malformed = reader.malformed();
+    });
     
-    for (const auto& file : input_files) {
-        auto file_data = read_data_from_csv(file);
-        all_data.insert(all_data.end(), file_data.begin(), file_data.end());
+    std::vector<std::string> run_paths;
+    size_t rows = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!files[i].error.empty()) {
+            logger_.error(files[i].error);
+            std::filesystem::remove_all(work_dir, error);
+            return false;
+        }
+        if (files[i].malformed > 0) {
+            logger_.warning("Skipped " + std::to_string(files[i].malformed) + " invalid lines in " + input_files[i]);
+        }
+        rows += files[i].rows;
+        run_paths.insert(run_paths.end(), files[i].paths.begin(), files[i].paths.end());
+    }
+    if (rows == 0) {
+        logger_.error("No data loaded from " + std::to_string(input_files.size()) + " files");
+        std::filesystem::remove_all(work_dir, error);
+        return false;
     }
     
-    // Sort by timestamp
-    std::sort(all_data.begin(), all_data.end(),
-        [](const HistoricalDataPoint& a, const HistoricalDataPoint& b) {
-            return a.timestamp < b.timestamp;
-        });
+    bool merged = TickStoreWriter::merge(tick_file, run_paths);
+    std::filesystem::remove_all(work_dir, error);
+    if (!merged) {
+        logger_.error("Failed to write tick store: " + tick_file);
+        return false;
+    }
+    return true;
+}
+
+bool DataDownloader::merge_data_files(const std::vector<std::string>& input_files,
+                                     const std::string& output_file,
+                                     size_t threads) {
+    logger_.info("Merging " + std::to_string(input_files.size()) + " data files");
     
-    // Remove duplicates
-    remove_duplicates(all_data);
+    std::filesystem::path output(output_file);
+    if (output.extension() == tick_store::FILE_EXTENSION) {
+        return build_tick_store(input_files, output_file, threads);
+    }
     
-    return write_data_to_csv(all_data, output_file);
+    // CSV out: merge into a scratch tick store, then stream it back as rows
+    std::string tick_file = output_file + tick_store::FILE_EXTENSION;
+    if (!build_tick_store(input_files, tick_file, threads)) {
+        return false;
+    }
+    
+    TickStoreReader reader;
+    std::ofstream file(output_file);
+    bool ok = reader.open(tick_file) && file.is_open();
+    if (ok) {
+        file << "timestamp,symbol,open,high,low,close,volume,bid,ask\n";
+        for (size_t i = 0; i < reader.size(); ++i) {
+            write_csv_row(file, reader.to_data_point(reader.record(i)));
+        }
+        file.close();
+        ok = file.good();
+        logger_.info("Wrote " + std::to_string(reader.size()) + " data points to " + output_file);
+    }
+    reader.close();
+    std::error_code error;
+    std::filesystem::remove(tick_file, error);
+    if (!ok) {
+        logger_.error("Failed to create output file: " + output_file);
+    }
+    return ok;
 }
 
 bool DataDownloader::convert_data_format(const std::string& input_file,
                                         const std::string& output_file,
                                         const std::string& input_format,
                                         const std::string& output_format) {
-    logger_.warning("Data format conversion not implemented");
-    return false;
+    if (input_format != "csv" || output_format != "tick") {
+        logger_.warning("Data format conversion " + input_format + " -> " + output_format + " not implemented");
+        return false;
+    }
+    
+    if (!build_tick_store({input_file}, output_file, 1)) {
+        return false;
+    }
+    
+    logger_.info("Converted " + input_file + " to tick store " + output_file);
+    return true;
 }
 
 void DataDownloader::remove_duplicates(std::vector<HistoricalDataPoint>& data) {
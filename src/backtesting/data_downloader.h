@@ -3,6 +3,7 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "historical_data_player.h"
+#include "tick_store.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -48,6 +49,23 @@ struct DataRequest {
     bool extended_hours = false;
 };
 
+// Bulk download straight into a tick store
+struct BulkDownloadOptions {
+    size_t max_concurrency = 8;     // Transfers in flight at once
+    int chunk_days = 0;             // Days per chunk; 0 sizes chunks by interval
+    int max_retries = 5;            // Per page, for transport errors and 5xx
+    std::string work_dir;           // Run files kept for resumption; default <output_file>.parts
+    bool keep_runs = false;         // Leave the runs once the store is built
+};
+
+// One symbol's slice of the date range, fetched page by page into its own run
+struct DownloadChunk {
+    std::string symbol;
+    uint64_t start_ms;              // [start_ms, end_ms)
+    uint64_t end_ms;
+    std::string run_path;           // <run_path>.run when complete, .tmp while downloading
+};
+
 // Download progress callback
 using ProgressCallback = std::function<void(const std::string&, int, int)>; // symbol, current, total
 
@@ -56,9 +74,13 @@ struct ValidationResult {
     bool valid;
     std::string error_message;
     size_t total_points;
-    size_t duplicate_points;
-    size_t missing_points;
+    size_t duplicate_points;    // Same symbol, same timestamp
+    size_t missing_points;      // Bars absent within a trading day, at the symbol's bar step
     std::string time_range;
+    size_t out_of_order_points; // Earlier than the symbol's previous row
+    size_t crossed_quotes;      // bid > ask
+    size_t inconsistent_points; // high < low, or negative prices
+    size_t malformed_rows;      // Rows that did not parse; skipped
 };
 
 class DataDownloader {
@@ -81,11 +103,41 @@ public:
                             const std::string& start_date,
                             const std::string& end_date,
                             const std::string& output_dir);
+
+    // Every symbol's bars for the range into one tick store at output_file.
+    // Chunks are fetched concurrently under the source's rate limit and
+    // decoded straight into per-chunk runs, which are merged at the end. A
+    // rerun after a failure or a kill skips finished chunks and resumes
+    // partial ones from their last record. Alpaca only.
+    bool download_to_tick_store(const std::vector<std::string>& symbols,
+                                DataSource source,
+                                TimeInterval interval,
+                                const std::string& start_date,
+                                const std::string& end_date,
+                                const std::string& output_file,
+                                const BulkDownloadOptions& options = {});
+
+    static std::vector<DownloadChunk> plan_chunks(const std::vector<std::string>& symbols,
+                                                  TimeInterval interval,
+                                                  uint64_t start_ms, uint64_t end_ms,
+                                                  int chunk_days,
+                                                  const std::string& work_dir);
+
+    // Appends one page of an Alpaca bars response to run. Returns the bars
+    // appended, or -1 if the body is not a bars page; next_page_token is
+    // empty on the last page.
+    static long decode_alpaca_bars(const std::string& body, TickRunWriter& run, std::string& next_page_token);
     
-    // Data validation and processing
+    // Data validation and processing. All of these stream their inputs, so
+    // memory does not grow with file size. threads = 0 uses every core.
     ValidationResult validate_data_file(const std::string& file_path);
+    std::vector<ValidationResult> validate_data_files(const std::vector<std::string>& file_paths,
+                                                      size_t threads = 0);
+    // Time-ordered merge of CSV files; a .tick output_file gets a tick store,
+    // anything else CSV. Duplicate (symbol, timestamp) rows keep the first.
     bool merge_data_files(const std::vector<std::string>& input_files,
-                         const std::string& output_file);
+                         const std::string& output_file,
+                         size_t threads = 0);
     bool convert_data_format(const std::string& input_file,
                            const std::string& output_file,
                            const std::string& input_format,
@@ -106,6 +158,8 @@ public:
     public:
         AlpacaDataClient(const std::string& api_key, const std::string& api_secret) 
             : api_key_(api_key), api_secret_(api_secret) {}
+        const std::string& api_key() const { return api_key_; }
+        const std::string& api_secret() const { return api_secret_; }
         std::vector<HistoricalDataPoint> get_bars(const std::string&, TimeInterval, 
                                                   const std::string&, const std::string&) { 
             return {}; 
@@ -182,6 +236,8 @@ private:
     // Data processing helpers
     bool write_data_to_csv(const std::vector<HistoricalDataPoint>& data,
                           const std::string& file_path);
+    bool build_tick_store(const std::vector<std::string>& input_files,
+                          const std::string& tick_file, size_t threads);
     std::vector<HistoricalDataPoint> read_data_from_csv(const std::string& file_path);
     bool validate_data_consistency(const std::vector<HistoricalDataPoint>& data);
     void remove_duplicates(std::vector<HistoricalDataPoint>& data);
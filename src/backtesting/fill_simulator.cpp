@@ -7,16 +7,32 @@
 
 namespace hft {
 
+namespace {
+
+// CounterRng domains, so order and symbol streams never share a counter
+constexpr uint32_t ORDER_DRAWS = 0;
+constexpr uint32_t SPREAD_DRAWS = 1;
+
+} // namespace
+
 FillSimulator::FillSimulator()
-    : realistic_spreads_(true), total_fills_(0), partial_fills_(0)
-    , total_slippage_(0.0), total_commission_(0.0)
-    , logger_("FillSimulator", StaticConfig::get_logger_endpoint()) {
+    : logger_("FillSimulator", StaticConfig::get_logger_endpoint())
+    , clock_(nullptr)
+    , seed_(0)
+    , realistic_spreads_(true), total_fills_(0), partial_fills_(0)
+    , total_slippage_(0.0), total_commission_(0.0) {
 }
 
 FillSimulator::~FillSimulator() = default;
 
 bool FillSimulator::initialize(const FillConfig& config) {
     config_ = config;
+    if (config.random_seed != 0) {
+        seed_ = config.random_seed;
+    } else {
+        std::random_device device;
+        seed_ = (uint64_t{device()} << 32) | device();
+    }
     logger_.info("Initializing Fill Simulator with model: " + 
                 std::to_string(static_cast<int>(config.model)));
     
@@ -37,12 +53,12 @@ void FillSimulator::update_market_state(const MarketData& market_data) {
     double old_price = state.last_price;
     
     state.symbol = symbol;
-    state.bid_price = market_data.bid_price;
-    state.ask_price = market_data.ask_price;
-    state.last_price = market_data.last_price;
+    state.bid_price = to_double_price(market_data.bid_price);
+    state.ask_price = to_double_price(market_data.ask_price);
+    state.last_price = to_double_price(market_data.last_price);
     state.bid_volume = market_data.bid_size;
     state.ask_volume = market_data.ask_size;
-    state.spread = market_data.ask_price - market_data.bid_price;
+    state.spread = to_double_price(market_data.ask_price - market_data.bid_price);
     state.timestamp = market_data.header.timestamp;
     
     // Update volatility based on price changes
@@ -51,23 +67,82 @@ void FillSimulator::update_market_state(const MarketData& market_data) {
         update_volatility(symbol, price_change);
     }
     
-    // Generate realistic spread if enabled
-    if (realistic_spreads_) {
-        state.spread = generate_realistic_spread(symbol, state.last_price);
+    // Generate realistic spread if enabled. The queue model fills against the
+    // book as given, so it keeps the feed's quotes.
+    if (realistic_spreads_ && config_.model != FillModel::QUEUE_POSITION) {
+        state.spread = generate_realistic_spread(state, state.last_price);
         state.bid_price = state.last_price - state.spread / 2.0;
         state.ask_price = state.last_price + state.spread / 2.0;
     }
     
     state.volatility = symbol_volatilities_[symbol];
     
-    // Process any pending orders for this symbol
-    for (auto& [order_id, order] : pending_orders_) {
-        if (order.symbol == symbol) {
-            process_order_fill(order);
+    // Only this symbol's marketable orders need a look
+    auto orders_it = symbol_orders_.find(symbol);
+    if (orders_it == symbol_orders_.end()) {
+        return;
+    }
+    SymbolOrders& orders = orders_it->second;
+    schedule_marketable(orders, state);
+    
+    // The tick's last trade works through resting orders at or beyond its price
+    if (config_.model == FillModel::QUEUE_POSITION && market_data.last_size > 0 && market_data.last_price > 0) {
+        fill_from_trade(orders.bids, market_data.last_price, market_data.last_size);
+        fill_from_trade(orders.asks, market_data.last_price, market_data.last_size);
+    }
+}
+
+void FillSimulator::update_order_book(const OrderBookUpdate& update) {
+    if (update.update_type == BookUpdateType::SNAPSHOT) {
+        return;
+    }
+    
+    SymbolOrders& orders = symbol_orders_[update.symbol];
+    price_t price = update.level.price;
+    uint32_t size = update.update_type == BookUpdateType::DELETE ? 0 : update.level.size;
+    
+    auto& depth = update.side == BookSide::BID ? orders.bid_depth : orders.ask_depth;
+    if (size > 0) {
+        depth[price] = size;
+    } else {
+        depth.erase(price);
+    }
+    
+    // Without a print the shrink is cancels; assume they came from behind us
+    // unless the level no longer holds our queue position
+    auto clamp = [size](std::deque<QueueEntry>& queue) {
+        for (auto& entry : queue) {
+            entry.queue_ahead = std::min<uint64_t>(entry.queue_ahead, size);
         }
+    };
+    if (update.side == BookSide::BID) {
+        auto level = orders.bids.find(price);
+        if (level != orders.bids.end()) clamp(level->second);
+    } else {
+        auto level = orders.asks.find(price);
+        if (level != orders.asks.end()) clamp(level->second);
     }
 }
 
+uint64_t FillSimulator::get_queue_ahead(uint64_t order_id) const {
+    auto order_it = pending_orders_.find(order_id);
+    if (order_it == pending_orders_.end()) return 0;
+    const PendingOrder& order = order_it->second;
+    
+    auto orders_it = symbol_orders_.find(order.symbol);
+    if (orders_it == symbol_orders_.end()) return 0;
+    
+    auto find_in = [&order](const auto& levels) -> uint64_t {
+        auto level = levels.find(order.limit_price);
+        if (level == levels.end()) return 0;
+        for (const auto& entry : level->second) {
+            if (entry.order_id == order.order_id) return entry.queue_ahead;
+        }
+        return 0;
+    };
+    return order.action == SignalAction::BUY ? find_in(orders_it->second.bids) : find_in(orders_it->second.asks);
+}
+
 void FillSimulator::submit_order(uint64_t order_id, const std::string& symbol, 
                                 SignalAction action, OrderType type, 
                                 double price, uint32_t quantity) {
@@ -77,17 +152,26 @@ void FillSimulator::submit_order(uint64_t order_id, const std::string& symbol,
     order.action = action;
     order.type = type;
     order.price = price;
+    order.limit_price = to_fixed_price(price);
     order.quantity = quantity;
     order.filled_quantity = 0;
+    order.scheduled_quantity = 0;
+    order.draws = 0;
     order.submit_time = current_time();
     order.last_update = order.submit_time;
     
+    if (pending_orders_.count(order_id)) {
+        unindex_order(pending_orders_[order_id]);
+    }
     pending_orders_[order_id] = order;
+    index_order(order);
     
-    logger_.info("Order submitted: " + std::to_string(order_id) + 
-                " " + symbol + " " + 
-                (action == SignalAction::BUY ? "BUY" : "SELL") + 
-                " " + std::to_string(quantity) + "@" + std::to_string(price));
+    if (config_.log_orders) {
+        logger_.info("Order submitted: " + std::to_string(order_id) + 
+                    " " + symbol + " " + 
+                    (action == SignalAction::BUY ? "BUY" : "SELL") + 
+                    " " + std::to_string(quantity) + "@" + std::to_string(price));
+    }
     
     // Process immediately for some fill models
     if (config_.model == FillModel::IMMEDIATE) {
@@ -98,17 +182,140 @@ void FillSimulator::submit_order(uint64_t order_id, const std::string& symbol,
 void FillSimulator::cancel_order(uint64_t order_id) {
     auto it = pending_orders_.find(order_id);
     if (it != pending_orders_.end()) {
-        logger_.info("Order canceled: " + std::to_string(order_id));
+        if (config_.log_orders) {
+            logger_.info("Order canceled: " + std::to_string(order_id));
+        }
+        unindex_order(it->second);
         pending_orders_.erase(it);
     }
 }
 
+void FillSimulator::index_order(const PendingOrder& order) {
+    SymbolOrders& orders = symbol_orders_[order.symbol];
+    if (order.type == OrderType::MARKET) {
+        orders.market_orders.push_back(order.order_id);
+        return;
+    }
+    
+    // Joins the back of its level: everything displayed there is ahead of it
+    QueueEntry entry{order.order_id, 0};
+    if (order.action == SignalAction::BUY) {
+        auto depth = orders.bid_depth.find(order.limit_price);
+        if (depth != orders.bid_depth.end()) entry.queue_ahead = depth->second;
+        orders.bids[order.limit_price].push_back(entry);
+    } else {
+        auto depth = orders.ask_depth.find(order.limit_price);
+        if (depth != orders.ask_depth.end()) entry.queue_ahead = depth->second;
+        orders.asks[order.limit_price].push_back(entry);
+    }
+}
+
+void FillSimulator::unindex_order(const PendingOrder& order) {
+    auto orders_it = symbol_orders_.find(order.symbol);
+    if (orders_it == symbol_orders_.end()) return;
+    SymbolOrders& orders = orders_it->second;
+    
+    if (order.type == OrderType::MARKET) {
+        auto& ids = orders.market_orders;
+        ids.erase(std::remove(ids.begin(), ids.end(), order.order_id), ids.end());
+        return;
+    }
+    
+    auto remove_from = [&order](auto& levels) {
+        auto level = levels.find(order.limit_price);
+        if (level == levels.end()) return;
+        auto& queue = level->second;
+        queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                   [&order](const QueueEntry& e) { return e.order_id == order.order_id; }),
+                    queue.end());
+        if (queue.empty()) levels.erase(level);
+    };
+    if (order.action == SignalAction::BUY) {
+        remove_from(orders.bids);
+    } else {
+        remove_from(orders.asks);
+    }
+}
+
+void FillSimulator::schedule_marketable(SymbolOrders& orders, const MarketState& market) {
+    for (uint64_t order_id : orders.market_orders) {
+        process_order_fill(pending_orders_.at(order_id));
+    }
+    
+    // Walk in from the best price and stop at the first level that cannot
+    // cross; one unit of slack since quotes are doubles and keys fixed-point.
+    // process_order_fill repeats the exact check.
+    price_t ask = to_fixed_price(market.ask_price);
+    for (auto& [price, queue] : orders.bids) {
+        if (price < ask - 1) break;
+        for (const auto& entry : queue) {
+            process_order_fill(pending_orders_.at(entry.order_id));
+        }
+    }
+    
+    price_t bid = to_fixed_price(market.bid_price);
+    for (auto& [price, queue] : orders.asks) {
+        if (price > bid + 1) break;
+        for (const auto& entry : queue) {
+            process_order_fill(pending_orders_.at(entry.order_id));
+        }
+    }
+}
+
+template<typename Levels>
+void FillSimulator::fill_from_trade(Levels& levels, price_t trade_price, uint64_t volume) {
+    // Levels are best first. A print beyond a level trades through it and
+    // fills it completely; a print at the level consumes its queue in order.
+    for (auto& [price, queue] : levels) {
+        bool at_price = price == trade_price;
+        if (!at_price && !levels.key_comp()(price, trade_price)) break;
+        
+        uint64_t residual = at_price ? volume : UINT64_MAX;
+        uint64_t external_traded = 0;  // Displayed size ahead of us that traded
+        for (auto& entry : queue) {
+            uint64_t ahead = at_price && entry.queue_ahead > external_traded ? entry.queue_ahead - external_traded : 0;
+            uint64_t take = std::min(residual, ahead);
+            external_traded += take;
+            residual -= take;
+            entry.queue_ahead = ahead - take;
+            
+            if (entry.queue_ahead == 0 && residual > 0) {
+                PendingOrder& order = pending_orders_.at(entry.order_id);
+                uint32_t fill = static_cast<uint32_t>(std::min<uint64_t>(residual, order.open_quantity()));
+                if (fill > 0) {
+                    schedule_queue_fill(order, price, fill);
+                    if (at_price) residual -= fill;
+                }
+            }
+        }
+    }
+}
+
+void FillSimulator::schedule_queue_fill(PendingOrder& order, price_t price, uint32_t quantity) {
+    // Passive fill at the order's own level, reported on the next processing pass
+    FillEvent event{};
+    event.order_id = order.order_id;
+    event.fill_price = to_double_price(price);
+    event.fill_quantity = quantity;
+    event.fill_time = current_time();
+    order.scheduled_quantity += quantity;
+    event.exec_type = order.open_quantity() == 0 ? ExecutionType::FILL : ExecutionType::PARTIAL_FILL;
+    fill_queue_.push(event);
+    
+    if (config_.log_orders) {
+        logger_.info("Queue fill: " + std::to_string(order.order_id) + " " + std::to_string(quantity) +
+                     "@" + std::to_string(event.fill_price));
+    }
+}
+
 void FillSimulator::process_pending_fills() {
     timestamp_t now = current_time();
     
     // Process queued fill events
     while (!fill_queue_.empty() && fill_queue_.top().fill_time <= now) {
-        const FillEvent& event = fill_queue_.top();
+        // Copied out: the fill callback may queue new events
+        FillEvent event = fill_queue_.top();
+        fill_queue_.pop();
         
         auto it = pending_orders_.find(event.order_id);
         if (it != pending_orders_.end()) {
@@ -118,16 +325,19 @@ void FillSimulator::process_pending_fills() {
             OrderExecution execution{};
             execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION, 
                                                             sizeof(OrderExecution) - sizeof(MessageHeader));
+            execution.header.timestamp = event.fill_time;
             execution.order_id = event.order_id;
             std::strncpy(execution.symbol, order.symbol.c_str(), sizeof(execution.symbol) - 1);
+            execution.symbol_id = SymbolTable::instance().intern(execution.symbol);
             execution.exec_type = event.exec_type;
-            execution.fill_price = event.fill_price;
+            execution.fill_price = to_fixed_price(event.fill_price);
             execution.fill_quantity = event.fill_quantity;
             execution.remaining_quantity = order.quantity - order.filled_quantity - event.fill_quantity;
             execution.commission = calculate_commission(event.fill_price, event.fill_quantity);
             
             // Update order state
             order.filled_quantity += event.fill_quantity;
+            order.scheduled_quantity -= std::min(order.scheduled_quantity, event.fill_quantity);
             order.last_update = now;
             
             // Track statistics
@@ -141,27 +351,29 @@ void FillSimulator::process_pending_fills() {
             // Calculate and track slippage
             double expected_price = (order.action == SignalAction::BUY) ? 
                 order.price : order.price;
-            double slippage = std::abs(event.fill_price - expected_price) / expected_price;
-            total_slippage_ += slippage;
-            
-            // Send fill notification
-            if (fill_callback_) {
-                fill_callback_(execution);
+            if (expected_price > 0.0) {  // Market orders have no reference price
+                total_slippage_ += std::abs(event.fill_price - expected_price) / expected_price;
             }
             
-            // Remove order if fully filled
+            // Remove order if fully filled. Done before the callback, which
+            // may submit orders and invalidate the iterator.
             if (order.filled_quantity >= order.quantity) {
+                unindex_order(order);
                 pending_orders_.erase(it);
             }
+            
+            // Send fill notification
+            if (fill_callback_) {
+                fill_callback_(execution);
+            }
         }
-        
-        fill_queue_.pop();
     }
     
     // Process pending orders that need market data
-    for (auto& [order_id, order] : pending_orders_) {
-        if (market_states_.find(order.symbol) != market_states_.end()) {
-            process_order_fill(order);
+    for (auto& [symbol, orders] : symbol_orders_) {
+        auto market_it = market_states_.find(symbol);
+        if (market_it != market_states_.end()) {
+            schedule_marketable(orders, market_it->second);
         }
     }
 }
@@ -174,6 +386,12 @@ void FillSimulator::process_order_fill(PendingOrder& order) {
     
     const MarketState& market = market_it->second;
     
+    // One outstanding fill per order; otherwise every market update would
+    // queue another fill for the same remaining quantity
+    if (order.scheduled_quantity > 0 || order.open_quantity() == 0) {
+        return;
+    }
+    
     // Skip if market is closed and we respect market hours
     if (config_.respect_market_hours && !is_market_open(current_time())) {
         return;
@@ -200,15 +418,18 @@ void FillSimulator::process_order_fill(PendingOrder& order) {
     
     if (event.fill_quantity > 0) {
         fill_queue_.push(event);
+        order.scheduled_quantity += event.fill_quantity;
         
-        logger_.info("Fill scheduled: " + std::to_string(order.order_id) + 
-                    " " + std::to_string(event.fill_quantity) + 
-                    "@" + std::to_string(event.fill_price) + 
-                    " at " + std::to_string(event.fill_time.count()));
+        if (config_.log_orders) {
+            logger_.info("Fill scheduled: " + std::to_string(order.order_id) + 
+                        " " + std::to_string(event.fill_quantity) + 
+                        "@" + std::to_string(event.fill_price) + 
+                        " at " + std::to_string(event.fill_time.count()));
+        }
     }
 }
 
-FillEvent FillSimulator::calculate_fill_event(const PendingOrder& order, const MarketState& market) {
+FillEvent FillSimulator::calculate_fill_event(PendingOrder& order, const MarketState& market) {
     FillEvent event{};
     event.order_id = order.order_id;
     event.fill_time = current_time() + std::chrono::milliseconds(calculate_latency(order));
@@ -218,7 +439,7 @@ FillEvent FillSimulator::calculate_fill_event(const PendingOrder& order, const M
     event.fill_quantity = calculate_fill_quantity(order, market);
     
     // Determine execution type
-    uint32_t remaining = order.quantity - order.filled_quantity;
+    uint32_t remaining = order.open_quantity();
     if (event.fill_quantity >= remaining) {
         event.exec_type = ExecutionType::FILL;
         event.fill_quantity = remaining;
@@ -229,7 +450,7 @@ FillEvent FillSimulator::calculate_fill_event(const PendingOrder& order, const M
     return event;
 }
 
-double FillSimulator::calculate_fill_price(const PendingOrder& order, const MarketState& market) {
+double FillSimulator::calculate_fill_price(PendingOrder& order, const MarketState& market) {
     double base_price;
     
     // Start with market price
@@ -246,6 +467,11 @@ double FillSimulator::calculate_fill_price(const PendingOrder& order, const Mark
             // No slippage for immediate fills
             break;
             
+        case FillModel::QUEUE_POSITION:
+            // Crossing orders take the quote as given; passive fills are
+            // priced at their level in schedule_queue_fill
+            break;
+            
         case FillModel::REALISTIC_SLIPPAGE:
             slippage = calculate_slippage(order, market);
             break;
@@ -268,8 +494,8 @@ double FillSimulator::calculate_fill_price(const PendingOrder& order, const Mark
     }
 }
 
-uint32_t FillSimulator::calculate_fill_quantity(const PendingOrder& order, const MarketState& market) {
-    uint32_t remaining = order.quantity - order.filled_quantity;
+uint32_t FillSimulator::calculate_fill_quantity(PendingOrder& order, const MarketState& market) {
+    uint32_t remaining = order.open_quantity();
     
     // For immediate and simple models, fill completely
     if (config_.model == FillModel::IMMEDIATE || config_.model == FillModel::REALISTIC_SLIPPAGE) {
@@ -278,14 +504,9 @@ uint32_t FillSimulator::calculate_fill_quantity(const PendingOrder& order, const
     
     // For partial fills model, sometimes do partial fills
     if (config_.model == FillModel::PARTIAL_FILLS) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0.0, 1.0);
-        
-        if (dis(gen) < config_.partial_fill_probability) {
+        if (random_uniform(order, 0.0, 1.0) < config_.partial_fill_probability) {
             // Partial fill: 20-80% of remaining quantity
-            std::uniform_real_distribution<> fill_ratio(0.2, 0.8);
-            return static_cast<uint32_t>(remaining * fill_ratio(gen));
+            return static_cast<uint32_t>(remaining * random_uniform(order, 0.2, 0.8));
         }
     }
     
@@ -300,7 +521,7 @@ uint32_t FillSimulator::calculate_fill_quantity(const PendingOrder& order, const
     return remaining;
 }
 
-double FillSimulator::calculate_slippage(const PendingOrder& order, const MarketState& market) {
+double FillSimulator::calculate_slippage(PendingOrder& order, const MarketState& market) {
     double base_slippage = config_.slippage_factor;
     
     // Increase slippage based on volatility
@@ -311,7 +532,7 @@ double FillSimulator::calculate_slippage(const PendingOrder& order, const Market
     base_slippage += spread_impact * 0.5;
     
     // Add randomness
-    return base_slippage * random_uniform(0.5, 1.5);
+    return base_slippage * random_uniform(order, 0.5, 1.5);
 }
 
 double FillSimulator::calculate_market_impact(const PendingOrder& order, const MarketState& market) {
@@ -323,11 +544,10 @@ double FillSimulator::calculate_market_impact(const PendingOrder& order, const M
     return config_.market_impact_factor * size_ratio;
 }
 
-int FillSimulator::calculate_latency(const PendingOrder& order) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(config_.min_latency_ms, config_.max_latency_ms);
-    return dis(gen);
+int FillSimulator::calculate_latency(PendingOrder& order) {
+    CounterRng stream(seed_, ORDER_DRAWS, order.order_id);
+    return stream.uniform_int(order.draws++, config_.min_latency_ms,
+                              std::max(config_.min_latency_ms, config_.max_latency_ms));
 }
 
 double FillSimulator::calculate_commission(double fill_price, uint32_t fill_quantity) {
@@ -365,7 +585,7 @@ bool FillSimulator::is_market_open(timestamp_t timestamp) {
     return total_minutes >= market_open && total_minutes <= market_close;
 }
 
-double FillSimulator::generate_realistic_spread(const std::string& symbol, double price) {
+double FillSimulator::generate_realistic_spread(MarketState& state, double price) {
     // Generate spreads based on typical values for different price ranges
     double spread_bps;
     
@@ -380,7 +600,8 @@ double FillSimulator::generate_realistic_spread(const std::string& symbol, doubl
     }
     
     // Add randomness
-    spread_bps *= random_uniform(0.5, 2.0);
+    CounterRng stream(seed_, SPREAD_DRAWS, CounterRng::stream_id(state.symbol));
+    spread_bps *= stream.uniform(state.spread_draws++, 0.5, 2.0);
     
     return price * spread_bps / 10000.0;
 }
@@ -392,6 +613,17 @@ void FillSimulator::update_volatility(const std::string& symbol, double price_ch
     vol = alpha * price_change + (1.0 - alpha) * vol;
 }
 
+void FillSimulator::reset() {
+    pending_orders_.clear();
+    symbol_orders_.clear();
+    fill_queue_ = {};
+    market_states_.clear();
+    total_fills_ = 0;
+    partial_fills_ = 0;
+    total_slippage_ = 0.0;
+    total_commission_ = 0.0;
+}
+
 void FillSimulator::set_volatility_model(const std::string& symbol, double volatility) {
     symbol_volatilities_[symbol] = volatility;
     logger_.info("Set volatility for " + symbol + ": " + std::to_string(volatility));
@@ -403,22 +635,15 @@ double FillSimulator::get_average_slippage() const {
 }
 
 timestamp_t FillSimulator::current_time() {
+    if (clock_) {
+        return clock_->now();
+    }
     return std::chrono::duration_cast<timestamp_t>(
         std::chrono::high_resolution_clock::now().time_since_epoch());
 }
 
-double FillSimulator::random_normal(double mean, double stddev) {
-    static thread_local std::random_device rd;
-    static thread_local std::mt19937 gen(rd());
-    std::normal_distribution<> dis(mean, stddev);
-    return dis(gen);
-}
-
-double FillSimulator::random_uniform(double min, double max) {
-    static thread_local std::random_device rd;
-    static thread_local std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(min, max);
-    return dis(gen);
+double FillSimulator::random_uniform(PendingOrder& order, double min, double max) {
+    return CounterRng(seed_, ORDER_DRAWS, order.order_id).uniform(order.draws++, min, max);
 }
 
 } // namespace hft
\ No newline at end of file
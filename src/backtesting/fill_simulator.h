@@ -2,8 +2,14 @@
 
 #include "../common/message_types.h"
 #include "../common/logging.h"
+#include "../common/simulation_clock.h"
+#include "../common/order_book.h"
+#include "../common/counter_rng.h"
 #include <memory>
 #include <unordered_map>
+#include <map>
+#include <deque>
+#include <vector>
 #include <queue>
 #include <chrono>
 #include <functional>
@@ -17,7 +23,8 @@ enum class FillModel {
     REALISTIC_SLIPPAGE, // Fill with realistic market slippage
     MARKET_IMPACT,      // Fill considering market impact based on order size
     LATENCY_AWARE,      // Fill with simulated network/exchange latency
-    PARTIAL_FILLS       // Support partial fills over time
+    PARTIAL_FILLS,      // Support partial fills over time
+    QUEUE_POSITION      // Price-time priority: resting limits queue behind book depth, fill from traded volume
 };
 
 // Market state for realistic simulation
@@ -31,6 +38,7 @@ struct MarketState {
     double spread;
     double volatility;
     timestamp_t timestamp;
+    uint32_t spread_draws;      // Index of the symbol's next spread draw
     
     double mid_price() const { 
         return (bid_price + ask_price) / 2.0; 
@@ -49,8 +57,10 @@ struct FillEvent {
     timestamp_t fill_time;
     ExecutionType exec_type;
     
+    // Same-time fills go out in order ID order, not heap order
     bool operator>(const FillEvent& other) const {
-        return fill_time > other.fill_time;
+        if (fill_time != other.fill_time) return fill_time > other.fill_time;
+        return order_id > other.order_id;
     }
 };
 
@@ -74,6 +84,15 @@ struct FillConfig {
     bool respect_market_hours = false;
     std::string market_open_time = "09:30:00";
     std::string market_close_time = "16:00:00";
+    
+    // QUEUE_POSITION takes each MarketData last_price/last_size as a trade
+    // print and the depth ahead of a resting order from update_order_book()
+    
+    // Reproducibility: 0 seeds from std::random_device. Draws are keyed by
+    // seed and order ID (spreads by seed and symbol), so with a clock set a
+    // run is bit-identical however many simulators run alongside it
+    uint64_t random_seed = 0;
+    bool log_orders = true;              // Per-order/fill log lines (off for fast backtests)
 };
 
 // Callback for fill notifications
@@ -88,19 +107,33 @@ public:
     bool initialize(const FillConfig& config);
     void set_fill_callback(FillCallback callback) { fill_callback_ = callback; }
     
+    // Use logical time for latency, market hours and execution timestamps
+    void set_clock(const SimulationClock* clock) { clock_ = clock; }
+    
     // Market data updates
     void update_market_state(const MarketData& market_data);
     
+    // L2 depth for the QUEUE_POSITION model; shrinking a level moves
+    // resting orders at that price up the queue
+    void update_order_book(const OrderBookUpdate& update);
+    
     // Order processing
     void submit_order(uint64_t order_id, const std::string& symbol, 
                      SignalAction action, OrderType type, 
                      double price, uint32_t quantity);
     void cancel_order(uint64_t order_id);
     
+    // Drops every order, queued fill, market state and statistic, keeping
+    // the configuration, callback, clock and volatility models
+    void reset();
+    
     // Processing
     void process_pending_fills();
     bool has_pending_orders() const { return !pending_orders_.empty(); }
     
+    // Displayed size still ahead of a resting order (QUEUE_POSITION); 0 if unknown
+    uint64_t get_queue_ahead(uint64_t order_id) const;
+    
     // Statistics
     uint64_t get_total_fills() const { return total_fills_; }
     uint64_t get_partial_fills() const { return partial_fills_; }
@@ -118,18 +151,42 @@ private:
         SignalAction action;
         OrderType type;
         double price;
+        price_t limit_price;     // Index key in SymbolOrders
         uint32_t quantity;
         uint32_t filled_quantity;
+        uint32_t scheduled_quantity;  // Quantity in queued FillEvents
         timestamp_t submit_time;
         timestamp_t last_update;
+        uint32_t draws;          // Index of the order's next random draw
+        
+        uint32_t open_quantity() const { return quantity - filled_quantity - scheduled_quantity; }
+    };
+    
+    // An order in its price level's queue, in time priority
+    struct QueueEntry {
+        uint64_t order_id;
+        uint64_t queue_ahead;    // Displayed size ahead of this order
+    };
+    
+    // Pending orders of one symbol indexed by price, so market updates only
+    // visit marketable levels; plus the depth QUEUE_POSITION queues behind
+    struct SymbolOrders {
+        std::map<price_t, std::deque<QueueEntry>, std::greater<price_t>> bids;  // Best first
+        std::map<price_t, std::deque<QueueEntry>> asks;
+        std::vector<uint64_t> market_orders;
+        std::map<price_t, uint32_t> bid_depth;
+        std::map<price_t, uint32_t> ask_depth;
     };
     
     FillConfig config_;
     Logger logger_;
     FillCallback fill_callback_;
+    const SimulationClock* clock_;
+    uint64_t seed_;
     
     // Order management
     std::unordered_map<uint64_t, PendingOrder> pending_orders_;
+    std::unordered_map<std::string, SymbolOrders> symbol_orders_;
     std::priority_queue<FillEvent, std::vector<FillEvent>, std::greater<FillEvent>> fill_queue_;
     
     // Market state
@@ -143,25 +200,35 @@ private:
     double total_slippage_;
     double total_commission_;
     
+    // Order index
+    void index_order(const PendingOrder& order);
+    void unindex_order(const PendingOrder& order);
+    void schedule_marketable(SymbolOrders& orders, const MarketState& market);
+    
+    // Queue position model
+    template<typename Levels>
+    void fill_from_trade(Levels& levels, price_t trade_price, uint64_t volume);
+    void schedule_queue_fill(PendingOrder& order, price_t price, uint32_t quantity);
+    
     // Fill simulation methods
     void process_order_fill(PendingOrder& order);
-    FillEvent calculate_fill_event(const PendingOrder& order, const MarketState& market);
-    double calculate_fill_price(const PendingOrder& order, const MarketState& market);
-    uint32_t calculate_fill_quantity(const PendingOrder& order, const MarketState& market);
-    double calculate_slippage(const PendingOrder& order, const MarketState& market);
+    FillEvent calculate_fill_event(PendingOrder& order, const MarketState& market);
+    double calculate_fill_price(PendingOrder& order, const MarketState& market);
+    uint32_t calculate_fill_quantity(PendingOrder& order, const MarketState& market);
+    double calculate_slippage(PendingOrder& order, const MarketState& market);
     double calculate_market_impact(const PendingOrder& order, const MarketState& market);
-    int calculate_latency(const PendingOrder& order);
+    int calculate_latency(PendingOrder& order);
     double calculate_commission(double fill_price, uint32_t fill_quantity);
     
     // Market simulation helpers
     bool is_market_open(timestamp_t timestamp);
-    double generate_realistic_spread(const std::string& symbol, double price);
+    double generate_realistic_spread(MarketState& state, double price);
     void update_volatility(const std::string& symbol, double price_change);
     
     // Utility methods
     timestamp_t current_time();
-    double random_normal(double mean, double stddev);
-    double random_uniform(double min, double max);
+    // The order's next draw from its own stream
+    double random_uniform(PendingOrder& order, double min, double max);
 };
 
 } // namespace hft
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "historical_data_player.h"
+#include "tick_store.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -10,7 +11,11 @@ HistoricalDataPlayer::HistoricalDataPlayer()
     : playback_speed_(1.0)
     , start_time_(0)
     , end_time_(0)
+    , filter_symbol_(nullptr)
+    , begin_index_(0)
+    , end_index_(0)
     , current_index_(0)
+    , last_timestamp_(0)
     , running_(false)
     , messages_sent_(0)
     , logger_("HistoricalDataPlayer", StaticConfig::get_logger_endpoint()) {
@@ -24,28 +29,18 @@ bool HistoricalDataPlayer::initialize() {
     logger_.info("Initializing Historical Data Player");
     
     try {
-        // Initialize ZeroMQ context and publisher
-        context_ = std::make_unique<zmq::context_t>(1);
-        publisher_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
-        
-        // Set socket options for high performance
-        int sndhwm = 1000;
-        publisher_->setsockopt(ZMQ_SNDHWM, &sndhwm, sizeof(sndhwm));
-        int linger = 0;
-        publisher_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
-        
         // Bind to the same endpoint as market data handler
-        const char* endpoint = StaticConfig::get_market_data_endpoint();
-        publisher_->bind(endpoint);
+        publisher_ = TransportFactory::open_publisher(
+            zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
         
-        logger_.info("Historical Data Player bound to " + std::string(endpoint));
+        logger_.info("Historical Data Player bound to " + publisher_->get_endpoint());
         
-        if (historical_data_.empty()) {
+        if (get_total_data_points() == 0) {
             logger_.warning("No historical data loaded. Use load_data_file() first.");
             return false;
         }
         
-        logger_.info("Loaded " + std::to_string(historical_data_.size()) + " historical data points");
+        logger_.info("Loaded " + std::to_string(get_total_data_points()) + " historical data points");
         return true;
         
     } catch (const zmq::error_t& e) {
@@ -61,27 +56,55 @@ bool HistoricalDataPlayer::load_data_file(const std::string& file_path) {
     data_file_path_ = file_path;
     logger_.info("Loading historical data from: " + file_path);
     
-    if (!load_csv_file(file_path)) {
-        logger_.error("Failed to load data file: " + file_path);
-        return false;
+    historical_data_.clear();
+    tick_store_.reset();
+    filter_symbol_ = nullptr;
+    
+    if (TickStoreReader::is_tick_store(file_path)) {
+        if (!load_tick_store(file_path)) {
+            logger_.error("Failed to map tick store: " + file_path);
+            return false;
+        }
+    } else {
+        if (!load_csv_file(file_path)) {
+            logger_.error("Failed to load data file: " + file_path);
+            return false;
+        }
+        
+        // Sort data by timestamp to ensure chronological order
+        std::stable_sort(historical_data_.begin(), historical_data_.end(),
+                         [](const HistoricalDataPoint& a, const HistoricalDataPoint& b) {
+                             return a.timestamp < b.timestamp;
+                         });
     }
     
-    // Sort data by timestamp to ensure chronological order
-    std::sort(historical_data_.begin(), historical_data_.end(),
-              [](const HistoricalDataPoint& a, const HistoricalDataPoint& b) {
-                  return a.timestamp < b.timestamp;
-              });
+    if (!symbol_filter_.empty() && !set_symbol_filter(symbol_filter_)) {
+        return false;
+    }
+    seek_time_range();
     
-    logger_.info("Loaded " + std::to_string(historical_data_.size()) + " data points");
+    logger_.info("Loaded " + std::to_string(get_total_data_points()) + " data points");
     
-    if (!historical_data_.empty()) {
-        logger_.info("Time range: " + std::to_string(historical_data_.front().timestamp) + 
-                     " to " + std::to_string(historical_data_.back().timestamp));
+    if (get_total_data_points() > 0) {
+        logger_.info("Time range: " + std::to_string(data_point_at(0).timestamp) + 
+                     " to " + std::to_string(data_point_at(get_total_data_points() - 1).timestamp));
     }
     
     return true;
 }
 
+bool HistoricalDataPlayer::load_tick_store(const std::string& file_path) {
+    auto store = std::make_unique<TickStoreReader>();
+    if (!store->open(file_path)) {
+        return false;
+    }
+    
+    logger_.info("Memory-mapped tick store with " + std::to_string(store->size()) + " records, " +
+                 std::to_string(store->header()->symbol_count) + " symbols");
+    tick_store_ = std::move(store);
+    return tick_store_->size() > 0;
+}
+
 bool HistoricalDataPlayer::load_csv_file(const std::string& file_path) {
     std::ifstream file(file_path);
     if (!file.is_open()) {
@@ -171,7 +194,71 @@ void HistoricalDataPlayer::set_playback_speed(double speed_multiplier) {
 void HistoricalDataPlayer::set_time_range(uint64_t start_time, uint64_t end_time) {
     start_time_ = start_time;
     end_time_ = end_time;
-    logger_.info("Time range filter set: " + std::to_string(start_time) + " to " + std::to_string(end_time));
+    seek_time_range();
+    logger_.info("Time range filter set: " + std::to_string(start_time) + " to " + std::to_string(end_time) +
+                 " (" + std::to_string(end_index_ - begin_index_) + " data points)");
+}
+
+bool HistoricalDataPlayer::set_symbol_filter(const std::string& symbol) {
+    symbol_filter_ = symbol;
+    filter_symbol_ = nullptr;
+    
+    if (!symbol.empty() && tick_store_) {
+        filter_symbol_ = tick_store_->find_symbol(symbol);
+        if (!filter_symbol_) {
+            logger_.error("Symbol " + symbol + " not found in tick store " + data_file_path_);
+            return false;
+        }
+    } else if (!symbol.empty() && !historical_data_.empty()) {
+        // CSV data is already in memory; keep only the requested symbol
+        historical_data_.erase(std::remove_if(historical_data_.begin(), historical_data_.end(),
+                                              [&symbol](const HistoricalDataPoint& p) {
+                                                  return symbol != p.symbol;
+                                              }),
+                               historical_data_.end());
+    }
+    
+    seek_time_range();
+    return true;
+}
+
+uint64_t HistoricalDataPlayer::get_total_data_points() const {
+    if (filter_symbol_) return filter_symbol_->postings_count;
+    if (tick_store_) return tick_store_->size();
+    return historical_data_.size();
+}
+
+void HistoricalDataPlayer::seek_time_range() {
+    uint64_t last = end_time_ != 0 ? end_time_ : UINT64_MAX;
+    
+    if (filter_symbol_) {
+        begin_index_ = tick_store_->symbol_lower_bound(*filter_symbol_, start_time_);
+        end_index_ = tick_store_->symbol_upper_bound(*filter_symbol_, last);
+    } else if (tick_store_) {
+        begin_index_ = tick_store_->lower_bound(start_time_);
+        end_index_ = tick_store_->upper_bound(last);
+    } else {
+        auto by_time = [](const HistoricalDataPoint& p, uint64_t t) { return p.timestamp < t; };
+        auto after_time = [](uint64_t t, const HistoricalDataPoint& p) { return t < p.timestamp; };
+        begin_index_ = std::lower_bound(historical_data_.begin(), historical_data_.end(), start_time_, by_time)
+                       - historical_data_.begin();
+        end_index_ = std::upper_bound(historical_data_.begin(), historical_data_.end(), last, after_time)
+                     - historical_data_.begin();
+    }
+    
+    if (end_index_ < begin_index_) {
+        end_index_ = begin_index_;
+    }
+}
+
+HistoricalDataPoint HistoricalDataPlayer::data_point_at(size_t index) const {
+    if (filter_symbol_) {
+        return tick_store_->to_data_point(tick_store_->record(tick_store_->postings(*filter_symbol_)[index]));
+    }
+    if (tick_store_) {
+        return tick_store_->to_data_point(tick_store_->record(index));
+    }
+    return historical_data_[index];
 }
 
 void HistoricalDataPlayer::start() {
@@ -182,14 +269,16 @@ void HistoricalDataPlayer::start() {
     
     logger_.info("Starting Historical Data Player");
     running_.store(true);
-    current_index_ = 0;
+    seek_time_range();
+    current_index_ = begin_index_;
     messages_sent_.store(0);
     
     playback_start_time_ = std::chrono::high_resolution_clock::now();
     
-    if (!historical_data_.empty()) {
+    if (begin_index_ < end_index_) {
+        last_timestamp_ = data_point_at(begin_index_).timestamp;
         simulation_start_time_ = std::chrono::high_resolution_clock::time_point(
-            std::chrono::milliseconds(historical_data_[0].timestamp));
+            std::chrono::milliseconds(last_timestamp_));
     }
     
     // Start playback thread
@@ -219,22 +308,15 @@ void HistoricalDataPlayer::stop() {
 void HistoricalDataPlayer::playback_loop() {
     logger_.info("Historical data playback started");
     
-    auto last_timestamp = std::chrono::high_resolution_clock::time_point();
-    
-    while (running_.load() && current_index_ < historical_data_.size()) {
-        const auto& data_point = historical_data_[current_index_];
-        
-        // Apply time range filter if set
-        if ((start_time_ != 0 && data_point.timestamp < start_time_) ||
-            (end_time_ != 0 && data_point.timestamp > end_time_)) {
-            current_index_++;
-            continue;
-        }
+    // The window was resolved by index seek, so every point in it is in range
+    while (running_.load() && current_index_ < end_index_) {
+        const HistoricalDataPoint data_point = data_point_at(current_index_);
         
         // Calculate timing for realistic playback
-        if (playback_speed_ > 0.0 && current_index_ > 0) {
+        if (playback_speed_ > 0.0 && current_index_ > begin_index_) {
             calculate_sleep_time(data_point.timestamp);
         }
+        last_timestamp_ = data_point.timestamp;
         
         // Publish the market data
         publish_market_data(data_point);
@@ -257,11 +339,23 @@ void HistoricalDataPlayer::playback_loop() {
     }
 }
 
+uint64_t HistoricalDataPlayer::replay(const MarketDataHandler& handler) {
+    seek_time_range();
+    messages_sent_.store(0);
+    
+    for (current_index_ = begin_index_; current_index_ < end_index_; ++current_index_) {
+        handler(convert_to_market_data(data_point_at(current_index_)));
+    }
+    
+    messages_sent_.store(end_index_ - begin_index_);
+    return end_index_ - begin_index_;
+}
+
 void HistoricalDataPlayer::calculate_sleep_time(uint64_t data_timestamp) {
-    if (current_index_ == 0) return;
+    if (data_timestamp <= last_timestamp_) return;
     
     // Calculate time difference between data points
-    uint64_t time_diff = data_timestamp - historical_data_[current_index_ - 1].timestamp;
+    uint64_t time_diff = data_timestamp - last_timestamp_;
     
     // Scale by playback speed
     auto sleep_duration = std::chrono::milliseconds(static_cast<uint64_t>(time_diff / playback_speed_));
@@ -272,16 +366,9 @@ void HistoricalDataPlayer::calculate_sleep_time(uint64_t data_timestamp) {
 }
 
 void HistoricalDataPlayer::publish_market_data(const HistoricalDataPoint& data_point) {
-    try {
-        MarketData market_data = convert_to_market_data(data_point);
-        
-        zmq::message_t message(sizeof(MarketData));
-        std::memcpy(message.data(), &market_data, sizeof(MarketData));
-        
-        publisher_->send(message, zmq::send_flags::dontwait);
-        
-    } catch (const zmq::error_t& e) {
-        logger_.error("Failed to send market data: " + std::string(e.what()));
+    MarketData market_data = convert_to_market_data(data_point);
+    if (!publisher_->publish(&market_data, sizeof(MarketData))) {
+        logger_.error("Failed to send market data for " + std::string(market_data.symbol));
     }
 }
 
@@ -295,11 +382,12 @@ MarketData HistoricalDataPlayer::convert_to_market_data(const HistoricalDataPoin
     // Copy symbol
     std::strncpy(market_data.symbol, data_point.symbol, sizeof(market_data.symbol) - 1);
     market_data.symbol[sizeof(market_data.symbol) - 1] = '\0';
+    market_data.symbol_id = SymbolTable::instance().intern(market_data.symbol);
     
     // Set prices and volumes
-    market_data.bid_price = data_point.bid_price;
-    market_data.ask_price = data_point.ask_price;
-    market_data.last_price = data_point.last_price;
+    market_data.bid_price = to_fixed_price(data_point.bid_price);
+    market_data.ask_price = to_fixed_price(data_point.ask_price);
+    market_data.last_price = to_fixed_price(data_point.last_price);
     market_data.bid_size = static_cast<uint32_t>(data_point.total_volume / 2);
     market_data.ask_size = static_cast<uint32_t>(data_point.total_volume / 2);
     market_data.last_size = static_cast<uint32_t>(data_point.total_volume);
@@ -309,8 +397,8 @@ MarketData HistoricalDataPlayer::convert_to_market_data(const HistoricalDataPoin
 }
 
 double HistoricalDataPlayer::get_playback_progress() const {
-    if (historical_data_.empty()) return 0.0;
-    return static_cast<double>(current_index_) / historical_data_.size();
+    if (end_index_ <= begin_index_) return 0.0;
+    return static_cast<double>(current_index_ - begin_index_) / (end_index_ - begin_index_);
 }
 
 } // namespace hft
\ No newline at end of file
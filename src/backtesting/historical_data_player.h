@@ -3,7 +3,7 @@
 #include "../common/message_types.h"
 #include "../common/static_config.h"
 #include "../common/logging.h"
-#include <zmq.hpp>
+#include "../common/zmq_transport.h"
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -32,15 +32,23 @@ struct HistoricalDataPoint {
     uint64_t total_volume;
 };
 
+class TickStoreReader;
+struct TickStoreSymbol;
+
 class HistoricalDataPlayer {
 public:
+    using MarketDataHandler = std::function<void(const MarketData&)>;
+    
     HistoricalDataPlayer();
     ~HistoricalDataPlayer();
     
-    // Configuration
+    // Configuration. Tick store files (see tick_store.h) are mmapped and
+    // streamed lazily; anything else is parsed as CSV into memory.
     bool load_data_file(const std::string& file_path);
     void set_playback_speed(double speed_multiplier = 1.0); // 1.0 = real-time, 0 = no delay
     void set_time_range(uint64_t start_time, uint64_t end_time);
+    bool set_symbol_filter(const std::string& symbol);  // Tick store only; empty = all symbols
+    bool is_memory_mapped() const { return tick_store_ != nullptr; }
     
     // Control
     bool initialize();
@@ -48,9 +56,14 @@ public:
     void stop();
     bool is_running() const { return running_.load(); }
     
+    // In-process replay for event-driven backtests: hands every tick in the
+    // time window to handler on the calling thread, with no ZMQ socket and no
+    // sleeping. initialize() is not required. Returns ticks delivered.
+    uint64_t replay(const MarketDataHandler& handler);
+    
     // Statistics
     uint64_t get_messages_sent() const { return messages_sent_.load(); }
-    uint64_t get_total_data_points() const { return historical_data_.size(); }
+    uint64_t get_total_data_points() const;
     double get_playback_progress() const;
     
     // Event callbacks for backtesting framework
@@ -65,13 +78,21 @@ private:
     uint64_t start_time_;
     uint64_t end_time_;
     
-    // Data storage
+    // Data storage: either parsed CSV or an mmapped tick store
     std::vector<HistoricalDataPoint> historical_data_;
+    std::unique_ptr<TickStoreReader> tick_store_;
+    std::string symbol_filter_;
+    const TickStoreSymbol* filter_symbol_;
+    
+    // Playback window [begin_index_, end_index_), resolved by index seek.
+    // With a symbol filter the indices are into that symbol's postings.
+    size_t begin_index_;
+    size_t end_index_;
     size_t current_index_;
+    uint64_t last_timestamp_;
     
-    // ZeroMQ
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> publisher_;
+    // Market data transport, on the process ZeroMQ context
+    std::unique_ptr<IMessagePublisher> publisher_;
     
     // Threading
     std::atomic<bool> running_;
@@ -91,6 +112,9 @@ private:
     // Private methods
     void playback_loop();
     bool load_csv_file(const std::string& file_path);
+    bool load_tick_store(const std::string& file_path);
+    void seek_time_range();
+    HistoricalDataPoint data_point_at(size_t index) const;
     void publish_market_data(const HistoricalDataPoint& data_point);
     void calculate_sleep_time(uint64_t data_timestamp);
     MarketData convert_to_market_data(const HistoricalDataPoint& data_point);
@@ -1,11 +1,16 @@
 #include "historical_data_player.h"
 #include "data_downloader.h"
+#include "backtest_engine.h"
+#include "parameter_sweep.h"
 #include "../common/static_config.h"
 #include "../common/logging.h"
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <thread>
 #include <chrono>
+#include <iomanip>
 
 void print_usage() {
     std::cout << "Usage: hft_backtesting [OPTIONS]\n"
@@ -16,12 +21,28 @@ void print_usage() {
               << "  --speed <multiplier> Playback speed multiplier (default: 1.0, 0 = no delay)\n"
               << "  --start <timestamp>  Start timestamp (Unix milliseconds)\n"
               << "  --end <timestamp>    End timestamp (Unix milliseconds)\n"
+              << "  --replay-symbol <symbol> Only replay this symbol from a multi-symbol file\n"
+              << "  --convert <file>    Convert the CSV data to a binary tick store and replay from it\n"
+              << "  --engine <strategy> Run in-process as fast as possible (market_making, stat_arb, momentum)\n"
+              << "  --seed <n>          Fill simulator random seed for reproducible engine runs\n"
+              << "  --analytics <prefix> Write the engine run's equity curve and per-symbol P&L to\n"
+              << "                      <prefix>_equity.csv and <prefix>_symbols.csv\n"
+              << "  --sample-ms <n>     Equity curve and Sharpe/Sortino sample interval (default: 1000)\n"
+              << "  --sweep <strategy>  Parallel parameter sweep of an engine strategy over shared tick data\n"
+              << "  --param <name>=<min>:<max>[:<step>] Swept parameter (repeatable; a single value fixes it)\n"
+              << "  --samples <n>       Random samples instead of the full grid\n"
+              << "  --threads <n>       Sweep worker threads (default: hardware concurrency)\n"
+              << "  --top <n>           Only print the best n sweep results\n"
+              << "  --screen <n>        Score every sweep trial on the vectorized bar model first and\n"
+              << "                      simulate only the best n (stat_arb, momentum)\n"
               << "  --download          Download historical data first\n"
               << "  --source <source>   Data source for download (yahoo, alpaca, alphavantage, iex, polygon)\n"
               << "  --interval <interval> Time interval (1min, 5min, 15min, 30min, 1hour, 1day)\n"
               << "  --start-date <date>  Start date for download (YYYY-MM-DD)\n"
               << "  --end-date <date>    End date for download (YYYY-MM-DD)\n"
               << "  --output-dir <dir>   Output directory for downloaded data\n"
+              << "  --symbols <list>    Comma-separated symbols to download into one tick store (alpaca)\n"
+              << "  --concurrency <n>   Concurrent download requests (alpaca, default: 8)\n"
               << "  --help              Show this help message\n"
               << "\nExamples:\n"
               << "  # Basic backtesting with existing data\n"
@@ -31,9 +52,28 @@ void print_usage() {
               << "  ./hft_backtesting --download --symbol AAPL --source yahoo --interval 1day \\\n"
               << "    --start-date 2023-01-01 --end-date 2023-12-31 --output-dir data\n"
               << "\n"
+              << "  # A universe of minute bars, concurrently, into one tick store; rerun to resume\n"
+              << "  ./hft_backtesting --download --source alpaca --interval 1min --symbols AAPL,MSFT,NVDA \\\n"
+              << "    --start-date 2023-01-01 --end-date 2023-12-31 --output-dir data --engine stat_arb\n"
+              << "\n"
               << "  # Backtest specific time range at maximum speed\n"
               << "  ./hft_backtesting --data data/AAPL.csv --speed 0 \\\n"
-              << "    --start 1672531200000 --end 1704067200000\n";
+              << "    --start 1672531200000 --end 1704067200000\n"
+              << "\n"
+              << "  # Convert once, then replay the memory-mapped tick store\n"
+              << "  ./hft_backtesting --data data/AAPL.csv --convert data/AAPL.tick --speed 0\n"
+              << "  ./hft_backtesting --data data/AAPL.tick --speed 0\n"
+              << "\n"
+              << "  # Event-driven run without ZMQ, deterministic for a given seed\n"
+              << "  ./hft_backtesting --data data/AAPL.tick --engine stat_arb --seed 42\n"
+              << "\n"
+              << "  # Grid sweep across all cores, best 10 by net P&L\n"
+              << "  ./hft_backtesting --data data/AAPL.tick --sweep stat_arb --seed 42 --top 10 \\\n"
+              << "    --param imbalance_threshold=0.1:0.5:0.05 --param lookback_periods=10:50:10\n"
+              << "\n"
+              << "  # Screen 5000 random sets over minute bars, fully simulate the best 20\n"
+              << "  ./hft_backtesting --data data/AAPL_1min.tick --sweep momentum --samples 5000 --screen 20 \\\n"
+              << "    --param momentum_threshold=0.001:0.05 --param flow_threshold=0.05:0.6 --param momentum_window=5:60:5\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -49,6 +89,20 @@ int main(int argc, char* argv[]) {
     std::string start_date;
     std::string end_date;
     std::string output_dir = "data";
+    std::vector<std::string> download_symbols;
+    size_t download_concurrency = 0;
+    std::string replay_symbol;
+    std::string convert_file;
+    std::string engine_strategy;
+    uint64_t seed = 0;
+    std::string analytics_prefix;
+    uint64_t sample_ms = 1000;
+    std::string sweep_strategy;
+    std::vector<std::string> sweep_params;
+    size_t sweep_samples = 0;
+    size_t sweep_threads = 0;
+    size_t sweep_top = 0;
+    size_t sweep_screen = 0;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -69,6 +123,30 @@ int main(int argc, char* argv[]) {
             start_time = std::stoull(argv[++i]);
         } else if (arg == "--end" && i + 1 < argc) {
             end_time = std::stoull(argv[++i]);
+        } else if (arg == "--replay-symbol" && i + 1 < argc) {
+            replay_symbol = argv[++i];
+        } else if (arg == "--convert" && i + 1 < argc) {
+            convert_file = argv[++i];
+        } else if (arg == "--engine" && i + 1 < argc) {
+            engine_strategy = argv[++i];
+        } else if (arg == "--analytics" && i + 1 < argc) {
+            analytics_prefix = argv[++i];
+        } else if (arg == "--sample-ms" && i + 1 < argc) {
+            sample_ms = std::stoull(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            sweep_strategy = argv[++i];
+        } else if (arg == "--param" && i + 1 < argc) {
+            sweep_params.push_back(argv[++i]);
+        } else if (arg == "--samples" && i + 1 < argc) {
+            sweep_samples = std::stoull(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            sweep_threads = std::stoull(argv[++i]);
+        } else if (arg == "--top" && i + 1 < argc) {
+            sweep_top = std::stoull(argv[++i]);
+        } else if (arg == "--screen" && i + 1 < argc) {
+            sweep_screen = std::stoull(argv[++i]);
         } else if (arg == "--download") {
             download_data = true;
         } else if (arg == "--source" && i + 1 < argc) {
@@ -81,6 +159,14 @@ int main(int argc, char* argv[]) {
             end_date = argv[++i];
         } else if (arg == "--output-dir" && i + 1 < argc) {
             output_dir = argv[++i];
+        } else if (arg == "--symbols" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (!item.empty()) download_symbols.push_back(item);
+            }
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            download_concurrency = std::stoull(argv[++i]);
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             print_usage();
@@ -134,23 +220,39 @@ int main(int argc, char* argv[]) {
         else if (interval == "1week") time_interval = hft::TimeInterval::WEEK_1;
         else if (interval == "1month") time_interval = hft::TimeInterval::MONTH_1;
         
-        // Create download request
-        hft::DataRequest request;
-        request.symbol = symbol;
-        request.source = source;
-        request.interval = time_interval;
-        request.start_date = start_date;
-        request.end_date = end_date;
-        request.output_file = output_dir + "/" + symbol + "_" + interval + 
-                             "_" + start_date + "_to_" + end_date + ".csv";
-        
-        if (!downloader.download_symbol_data(request)) {
-            logger.error("Failed to download data for " + symbol);
-            return 1;
-        }
+        // Alpaca: every symbol concurrently into one tick store, resumable
+        if (source == hft::DataSource::ALPACA) {
+            if (download_symbols.empty()) download_symbols.push_back(symbol);
+            hft::BulkDownloadOptions options;
+            if (download_concurrency > 0) options.max_concurrency = download_concurrency;
+            std::string name = download_symbols.size() == 1 ? download_symbols[0] : "universe";
+            std::string output_file = output_dir + "/" + name + "_" + interval + "_" + start_date +
+                                      "_to_" + end_date + hft::tick_store::FILE_EXTENSION;
+            if (!downloader.download_to_tick_store(download_symbols, source, time_interval,
+                                                   start_date, end_date, output_file, options)) {
+                logger.error("Failed to download data to " + output_file);
+                return 1;
+            }
+            data_file = output_file;
+        } else {
+            // Create download request
+            hft::DataRequest request;
+            request.symbol = symbol;
+            request.source = source;
+            request.interval = time_interval;
+            request.start_date = start_date;
+            request.end_date = end_date;
+            request.output_file = output_dir + "/" + symbol + "_" + interval + 
+                                 "_" + start_date + "_to_" + end_date + ".csv";
         
-        // Use downloaded file for backtesting
-        data_file = request.output_file;
+            if (!downloader.download_symbol_data(request)) {
+                logger.error("Failed to download data for " + symbol);
+                return 1;
+            }
+        
+            // Use downloaded file for backtesting
+            data_file = request.output_file;
+        }
         logger.info("Data downloaded to: " + data_file);
     }
     
@@ -161,22 +263,130 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // Initialize Historical Data Player
-    logger.info("Initializing Historical Data Player");
-    hft::HistoricalDataPlayer player;
+    // Convert CSV to the binary tick store if requested
+    if (!convert_file.empty()) {
+        hft::DataDownloader converter;
+        if (!converter.convert_data_format(data_file, convert_file, "csv", "tick")) {
+            logger.error("Failed to convert " + data_file + " to tick store");
+            return 1;
+        }
+        data_file = convert_file;
+    }
     
-    if (!player.initialize()) {
-        logger.error("Failed to initialize Historical Data Player");
-        return 1;
+    // Event-driven mode: strategies and fill simulator called directly
+    if (!engine_strategy.empty() || !sweep_strategy.empty()) {
+        const std::string& strategy_name = sweep_strategy.empty() ? engine_strategy : sweep_strategy;
+        hft::StrategyType type;
+        if (strategy_name == "market_making") type = hft::StrategyType::MARKET_MAKING;
+        else if (strategy_name == "stat_arb") type = hft::StrategyType::STAT_ARB;
+        else if (strategy_name == "momentum") type = hft::StrategyType::ENHANCED_MOMENTUM;
+        else {
+            logger.error("Unknown engine strategy: " + strategy_name);
+            print_usage();
+            return 1;
+        }
+        
+        hft::FillConfig fill_config;
+        fill_config.random_seed = seed;
+        fill_config.log_orders = false;
+        
+        if (!sweep_strategy.empty()) {
+            hft::SweepConfig sweep_config;
+            sweep_config.strategy = type;
+            sweep_config.random_samples = sweep_samples;
+            sweep_config.sample_seed = seed != 0 ? seed : 1;
+            sweep_config.threads = sweep_threads;
+            sweep_config.screen_top = sweep_screen;
+            sweep_config.analytics.sample_interval_ms = sample_ms;
+            sweep_config.fill_config = fill_config;
+            for (const auto& spec : sweep_params) {
+                hft::ParameterRange range;
+                if (!hft::ParameterSweep::parse_range(spec, range)) {
+                    logger.error("Invalid --param (expected name=min:max[:step]): " + spec);
+                    return 1;
+                }
+                sweep_config.ranges.push_back(range);
+            }
+            
+            // Decode once; every trial replays the same read-only ticks
+            hft::ParameterSweep sweep;
+            if (!sweep.load_data_file(data_file, start_time, end_time, replay_symbol)) {
+                logger.error("Failed to load sweep data from " + data_file);
+                return 1;
+            }
+            
+            auto sweep_start = std::chrono::steady_clock::now();
+            std::vector<hft::SweepTrial> results = sweep.run(sweep_config);
+            if (results.empty()) {
+                logger.error("Parameter sweep produced no results");
+                return 1;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweep_start).count();
+            
+            hft::ParameterSweep::print_ranked(std::cout, results, sweep_top);
+            if (results.front().screened) {
+                std::cout << "Bar screen scored every trial in " << std::fixed << std::setprecision(3)
+                          << results.front().screen.wall_seconds << "s\n";
+            }
+            std::cout << results.size() << " trials over " << sweep.tick_count() << " ticks in "
+                      << std::fixed << std::setprecision(3) << elapsed << "s\n";
+            return 0;
+        }
+        
+        hft::BacktestEngine engine;
+        if (!engine.initialize(fill_config) || !engine.load_data_file(data_file)) {
+            logger.error("Failed to set up backtest engine for " + data_file);
+            return 1;
+        }
+        if (!replay_symbol.empty() && !engine.set_symbol_filter(replay_symbol)) {
+            return 1;
+        }
+        if (start_time != 0 || end_time != 0) {
+            engine.set_time_range(start_time, end_time);
+        }
+        engine.add_strategy(hft::StrategyFactory::create_strategy(type, 1));
+        hft::AnalyticsConfig analytics_config;
+        analytics_config.sample_interval_ms = sample_ms;
+        analytics_config.record_curve = !analytics_prefix.empty();
+        engine.set_analytics_config(analytics_config);
+        
+        hft::BacktestStats stats = engine.run();
+        std::cout << "Ticks: " << stats.ticks << "\n"
+                  << "Signals: " << stats.signals << "\n"
+                  << "Orders: " << stats.orders << "\n"
+                  << "Fills: " << stats.fills << "\n"
+                  << "Wall time: " << std::fixed << std::setprecision(3) << stats.wall_seconds << "s ("
+                  << static_cast<uint64_t>(stats.ticks_per_second()) << " ticks/s)\n";
+        engine.analytics().print_summary(std::cout);
+        if (!analytics_prefix.empty()) {
+            if (!engine.analytics().write_curve_csv(analytics_prefix + "_equity.csv") ||
+                !engine.analytics().write_attribution_csv(analytics_prefix + "_symbols.csv")) {
+                logger.error("Failed to write analytics to " + analytics_prefix + "_*.csv");
+                return 1;
+            }
+        }
+        return 0;
     }
     
-    // Load historical data
+    hft::HistoricalDataPlayer player;
+    if (!replay_symbol.empty()) {
+        player.set_symbol_filter(replay_symbol);
+    }
+    
+    // Load historical data (initialize() requires it to be present)
     logger.info("Loading historical data from: " + data_file);
     if (!player.load_data_file(data_file)) {
         logger.error("Failed to load data file: " + data_file);
         return 1;
     }
     
+    // Initialize Historical Data Player
+    logger.info("Initializing Historical Data Player");
+    if (!player.initialize()) {
+        logger.error("Failed to initialize Historical Data Player");
+        return 1;
+    }
+    
     // Configure playback parameters
     player.set_playback_speed(speed);
     
@@ -0,0 +1,311 @@
+#include "parameter_sweep.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace hft {
+
+namespace {
+
+// Field tables are the strategies' own, shared with runtime retuning
+template <typename Strategy>
+std::unique_ptr<OrderBookStrategy> make_configured(uint64_t strategy_id, const ParameterValues& values) {
+    const auto& fields = Strategy::parameter_fields();
+    typename Strategy::Parameters params;
+    for (const auto& [name, value] : values) {
+        auto field = std::find_if(fields.begin(), fields.end(),
+                                  [&name](const auto& f) { return name == f.name; });
+        if (field == fields.end()) {
+            std::cerr << "[ParameterSweep] Unknown parameter: " << name << std::endl;
+            return nullptr;
+        }
+        field->apply(params, value);
+    }
+
+    auto strategy = std::make_unique<Strategy>(strategy_id);
+    strategy->set_parameters(params);
+    return strategy;
+}
+
+template <typename Params>
+std::vector<std::string> field_names(const std::vector<ParameterField<Params>>& fields) {
+    std::vector<std::string> names;
+    for (const auto& field : fields) {
+        names.emplace_back(field.name);
+    }
+    return names;
+}
+
+} // namespace
+
+std::vector<double> ParameterRange::grid_values() const {
+    std::vector<double> values;
+    if (step <= 0.0 || max_value <= min_value) {
+        values.push_back(min_value);
+        return values;
+    }
+
+    // Index-based so accumulated floating point error can't drop the endpoint
+    size_t count = static_cast<size_t>(std::floor((max_value - min_value) / step + 1e-9)) + 1;
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(min_value + i * step);
+    }
+    return values;
+}
+
+bool ParameterSweep::load_data_file(const std::string& file_path, uint64_t start_time, uint64_t end_time,
+                                    const std::string& symbol) {
+    BacktestEngine loader;
+    if (!symbol.empty() && !loader.set_symbol_filter(symbol)) {
+        return false;
+    }
+    if (!loader.load_data_file(file_path)) {
+        return false;
+    }
+    if (start_time != 0 || end_time != 0) {
+        loader.set_time_range(start_time, end_time);
+    }
+
+    ticks_ = std::make_shared<const TickSeries>(loader.decode_ticks());
+    return !ticks_->empty();
+}
+
+bool ParameterSweep::parse_range(const std::string& spec, ParameterRange& range) {
+    size_t eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size()) {
+        return false;
+    }
+
+    range = ParameterRange{};
+    range.name = spec.substr(0, eq);
+
+    std::vector<double> parts;
+    size_t pos = eq + 1;
+    try {
+        while (pos <= spec.size()) {
+            size_t colon = spec.find(':', pos);
+            std::string token = spec.substr(pos, colon == std::string::npos ? std::string::npos : colon - pos);
+            size_t used = 0;
+            parts.push_back(std::stod(token, &used));
+            if (used != token.size()) return false;
+            if (colon == std::string::npos) break;
+            pos = colon + 1;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    if (parts.empty() || parts.size() > 3) return false;
+    range.min_value = parts[0];
+    range.max_value = parts.size() > 1 ? parts[1] : parts[0];
+    range.step = parts.size() > 2 ? parts[2] : 0.0;
+    return range.max_value >= range.min_value && range.step >= 0.0;
+}
+
+std::vector<std::string> ParameterSweep::parameter_names(StrategyType type) {
+    switch (type) {
+        case StrategyType::MARKET_MAKING: return field_names(MarketMakingStrategy::parameter_fields());
+        case StrategyType::STAT_ARB: return field_names(StatArbStrategy::parameter_fields());
+        case StrategyType::ENHANCED_MOMENTUM: return field_names(EnhancedMomentumStrategy::parameter_fields());
+        default: return {};
+    }
+}
+
+std::unique_ptr<OrderBookStrategy> ParameterSweep::create_strategy(StrategyType type, uint64_t strategy_id,
+                                                                   const ParameterValues& values) {
+    switch (type) {
+        case StrategyType::MARKET_MAKING:
+            return make_configured<MarketMakingStrategy>(strategy_id, values);
+        case StrategyType::STAT_ARB:
+            return make_configured<StatArbStrategy>(strategy_id, values);
+        case StrategyType::ENHANCED_MOMENTUM:
+            return make_configured<EnhancedMomentumStrategy>(strategy_id, values);
+        default:
+            return nullptr;
+    }
+}
+
+std::vector<ParameterValues> ParameterSweep::expand_trials(const SweepConfig& config) {
+    std::vector<ParameterValues> trials;
+
+    if (config.random_samples > 0) {
+        std::mt19937_64 rng(config.sample_seed);
+        for (size_t i = 0; i < config.random_samples; ++i) {
+            ParameterValues values;
+            for (const auto& range : config.ranges) {
+                std::uniform_real_distribution<double> dist(range.min_value, range.max_value);
+                double value = range.max_value > range.min_value ? dist(rng) : range.min_value;
+                if (range.step > 0.0) {
+                    value = range.min_value + std::round((value - range.min_value) / range.step) * range.step;
+                    value = std::min(value, range.max_value);
+                }
+                values.emplace_back(range.name, value);
+            }
+            trials.push_back(std::move(values));
+        }
+        return trials;
+    }
+
+    // Cartesian product, last range varying fastest
+    trials.emplace_back();
+    for (const auto& range : config.ranges) {
+        std::vector<double> grid = range.grid_values();
+        std::vector<ParameterValues> expanded;
+        expanded.reserve(trials.size() * grid.size());
+        for (const auto& partial : trials) {
+            for (double value : grid) {
+                ParameterValues values = partial;
+                values.emplace_back(range.name, value);
+                expanded.push_back(std::move(values));
+            }
+        }
+        trials = std::move(expanded);
+    }
+    return trials;
+}
+
+SweepTrial ParameterSweep::run_trial(const SweepConfig& config, size_t trial_id,
+                                     const ParameterValues& values) const {
+    SweepTrial trial;
+    trial.trial_id = trial_id;
+    trial.values = values;
+
+    auto strategy = create_strategy(config.strategy, 1, values);
+    if (!strategy) {
+        return trial;
+    }
+
+    BacktestEngine engine;
+    if (!engine.initialize(config.fill_config)) {
+        return trial;
+    }
+    AnalyticsConfig analytics = config.analytics;
+    analytics.record_curve = false;
+    engine.set_analytics_config(analytics);
+    engine.add_strategy(std::move(strategy));
+    trial.stats = engine.run(*ticks_);
+    trial.analytics = engine.analytics().summary();
+    trial.completed = true;
+    return trial;
+}
+
+std::vector<SweepTrial> ParameterSweep::run(const SweepConfig& config) const {
+    std::vector<SweepTrial> results;
+    if (!ticks_ || ticks_->empty()) {
+        std::cerr << "[ParameterSweep] No tick data loaded" << std::endl;
+        return results;
+    }
+
+    // Reject unknown names before spending any simulation time
+    std::vector<std::string> known = parameter_names(config.strategy);
+    for (const auto& range : config.ranges) {
+        if (std::find(known.begin(), known.end(), range.name) == known.end()) {
+            std::cerr << "[ParameterSweep] Unknown parameter for "
+                      << StrategyFactory::strategy_type_to_string(config.strategy) << ": " << range.name << std::endl;
+            return results;
+        }
+        if (config.random_samples == 0 && range.step <= 0.0 && range.max_value > range.min_value) {
+            std::cerr << "[ParameterSweep] Grid range " << range.name << " needs a step" << std::endl;
+            return results;
+        }
+    }
+
+    std::vector<ParameterValues> trials = expand_trials(config);
+    std::vector<size_t> selected(trials.size());
+    for (size_t i = 0; i < trials.size(); ++i) selected[i] = i;
+    
+    // Coarse pass first: the full simulation only for the screen's best
+    std::vector<BarScreen::Result> screened;
+    if (config.screen_top > 0 && config.screen_top < trials.size()) {
+        if (BarScreen::supports(config.strategy)) {
+            BarScreen screen;
+            screen.set_ticks(ticks_);
+            screened = screen.score(config.strategy, trials, config.fill_config, config.threads);
+            std::stable_sort(selected.begin(), selected.end(), [&screened](size_t a, size_t b) {
+                if (screened[a].completed != screened[b].completed) return screened[a].completed;
+                return screened[a].stats.net_pnl > screened[b].stats.net_pnl;
+            });
+            selected.resize(config.screen_top);
+        } else {
+            std::cerr << "[ParameterSweep] No bar screen for "
+                      << StrategyFactory::strategy_type_to_string(config.strategy)
+                      << "; running every trial" << std::endl;
+        }
+    }
+    results.resize(selected.size());
+
+    size_t thread_count = config.threads != 0 ? config.threads : std::thread::hardware_concurrency();
+    thread_count = std::max<size_t>(1, std::min(thread_count, selected.size()));
+
+    // Workers pull the next trial index; results land in their own slot
+    std::atomic<size_t> next_trial{0};
+    auto worker = [&]() {
+        for (size_t i = next_trial.fetch_add(1); i < selected.size(); i = next_trial.fetch_add(1)) {
+            results[i] = run_trial(config, selected[i], trials[selected[i]]);
+            if (!screened.empty()) {
+                results[i].screened = true;
+                results[i].screen = screened[selected[i]].stats;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepTrial& a, const SweepTrial& b) {
+        if (a.completed != b.completed) return a.completed;
+        return a.stats.net_pnl > b.stats.net_pnl;
+    });
+    return results;
+}
+
+void ParameterSweep::print_ranked(std::ostream& out, const std::vector<SweepTrial>& trials, size_t top_n) {
+    size_t rows = top_n != 0 ? std::min(top_n, trials.size()) : trials.size();
+
+    out << std::left << std::setw(6) << "Rank" << std::setw(7) << "Trial"
+        << std::right << std::setw(14) << "Net P&L" << std::setw(12) << "Commission"
+        << std::setw(10) << "Orders" << std::setw(10) << "Fills" << std::setw(12) << "Filled qty"
+        << std::setw(9) << "Sharpe" << std::setw(12) << "Max DD";
+    bool screened = !trials.empty() && trials.front().screened;
+    if (screened) {
+        out << std::setw(14) << "Screen P&L";
+    }
+    out << "  Parameters\n";
+
+    for (size_t rank = 0; rank < rows; ++rank) {
+        const SweepTrial& trial = trials[rank];
+        out << std::left << std::setw(6) << rank + 1 << std::setw(7) << trial.trial_id << std::right;
+        if (trial.completed) {
+            out << std::fixed << std::setprecision(2)
+                << std::setw(14) << trial.stats.net_pnl << std::setw(12) << trial.stats.commission
+                << std::setw(10) << trial.stats.orders << std::setw(10) << trial.stats.fills
+                << std::setw(12) << trial.stats.filled_quantity
+                << std::setw(9) << trial.analytics.sharpe << std::setw(12) << trial.analytics.max_drawdown;
+        } else {
+            out << std::setw(79) << "failed";
+        }
+        if (screened) {
+            out << std::fixed << std::setprecision(2) << std::setw(14) << trial.screen.net_pnl;
+        }
+
+        out << " ";
+        out.unsetf(std::ios::floatfield);
+        out << std::setprecision(6);
+        for (const auto& [name, value] : trial.values) {
+            out << " " << name << "=" << value;
+        }
+        out << "\n";
+    }
+}
+
+} // namespace hft
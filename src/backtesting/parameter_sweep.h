@@ -0,0 +1,84 @@
+#pragma once
+
+#include "backtest_engine.h"
+#include "bar_screen.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hft {
+
+// One swept strategy parameter. A grid visits min, min+step, ... max; random
+// sampling draws uniformly from [min, max], snapped to step when step > 0.
+struct ParameterRange {
+    std::string name;
+    double min_value = 0.0;
+    double max_value = 0.0;
+    double step = 0.0;
+
+    std::vector<double> grid_values() const;
+};
+
+struct SweepConfig {
+    StrategyType strategy = StrategyType::MARKET_MAKING;
+    std::vector<ParameterRange> ranges;
+    size_t random_samples = 0;        // 0 = full grid
+    uint64_t sample_seed = 1;         // For random sampling
+    size_t threads = 0;               // 0 = hardware concurrency
+    FillConfig fill_config;           // Shared by every trial (fixed seed = common random numbers)
+    size_t screen_top = 0;            // > 0: score every trial with BarScreen, simulate only the best this many
+    AnalyticsConfig analytics;        // Trials keep the summary only; record_curve is ignored
+};
+
+struct SweepTrial {
+    size_t trial_id = 0;
+    ParameterValues values;
+    BacktestStats stats;
+    AnalyticsSummary analytics;
+    bool completed = false;
+    bool screened = false;            // Chosen by the bar screen; screen holds its estimate
+    BacktestStats screen;
+};
+
+// Runs many independent BacktestEngine simulations over one decoded tick
+// series. The ticks are loaded once and shared read-only by all worker
+// threads; each trial owns its engine, strategy and fill simulator, so no
+// state is shared between trials.
+class ParameterSweep {
+public:
+    ParameterSweep() = default;
+
+    // Load and decode the replay window once (CSV or tick store)
+    bool load_data_file(const std::string& file_path, uint64_t start_time = 0, uint64_t end_time = 0,
+                        const std::string& symbol = "");
+    void set_ticks(std::shared_ptr<const TickSeries> ticks) { ticks_ = std::move(ticks); }
+    size_t tick_count() const { return ticks_ ? ticks_->size() : 0; }
+
+    // Parses "name=min:max:step", "name=min:max" (random sampling only) or "name=value"
+    static bool parse_range(const std::string& spec, ParameterRange& range);
+
+    // Parameter names accepted for a strategy type (the Parameters field names)
+    static std::vector<std::string> parameter_names(StrategyType type);
+
+    // Strategy with defaults overridden by values; nullptr if a name is unknown
+    static std::unique_ptr<OrderBookStrategy> create_strategy(StrategyType type, uint64_t strategy_id,
+                                                              const ParameterValues& values);
+
+    // Expands the grid (or draws the samples), runs every trial across the
+    // thread pool and returns them ranked by net P&L, best first. With
+    // screen_top set, only the trials the bar screen ranks best are run.
+    std::vector<SweepTrial> run(const SweepConfig& config) const;
+
+    static void print_ranked(std::ostream& out, const std::vector<SweepTrial>& trials, size_t top_n = 0);
+
+private:
+    std::shared_ptr<const TickSeries> ticks_;
+
+    static std::vector<ParameterValues> expand_trials(const SweepConfig& config);
+    SweepTrial run_trial(const SweepConfig& config, size_t trial_id, const ParameterValues& values) const;
+};
+
+} // namespace hft
@@ -0,0 +1,169 @@
+// Compares virtual strategy dispatch (vector of OrderBookStrategy pointers)
+// with compile-time dispatch through StaticStrategySet, on the same
+// synthetic tick stream: once calling the strategies directly, to isolate
+// the dispatch cost, and once through the full BacktestEngine.
+//
+// Usage: strategy_dispatch_bench [ticks] [iterations]
+
+#include "backtest_engine.h"
+#include "../strategy_engine/enhanced_strategies.h"
+#include "../strategy_engine/static_strategy_set.h"
+#include "../common/message_types.h"
+#include "../common/static_config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+using StaticSet = StaticStrategySet<MarketMakingStrategy, StatArbStrategy, EnhancedMomentumStrategy>;
+
+// Random walk across a few symbols with 1ms logical spacing
+TickSeries make_ticks(size_t count) {
+    const std::vector<std::string> symbols = {"AAPL", "MSFT", "GOOGL", "TSLA"};
+    std::vector<double> mids(symbols.size(), 100.0);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.02);
+    std::uniform_int_distribution<uint32_t> size(100, 2000);
+
+    TickSeries ticks;
+    ticks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t s = i % symbols.size();
+        mids[s] = std::max(1.0, mids[s] + step(rng));
+        MarketData data = MessageFactory::create_market_data(
+            symbols[s], mids[s] - 0.01, mids[s] + 0.01, size(rng), size(rng), mids[s], size(rng));
+        data.header.timestamp = timestamp_t(static_cast<int64_t>(i + 1) * 1000000);
+        ticks.push_back(data);
+    }
+    return ticks;
+}
+
+template <typename F>
+double best_seconds(size_t iterations, F&& run) {
+    double best = 0.0;
+    for (size_t i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+void report(const char* label, size_t ticks, double seconds) {
+    std::cout << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << seconds * 1e9 / ticks << " ns/tick"
+              << std::setprecision(0) << std::setw(14) << ticks / seconds << " ticks/s\n";
+}
+
+// Same strategies as StaticSet, behind base pointers
+std::vector<std::unique_ptr<OrderBookStrategy>> make_virtual_set() {
+    std::vector<std::unique_ptr<OrderBookStrategy>> strategies;
+    strategies.push_back(std::make_unique<MarketMakingStrategy>(1));
+    strategies.push_back(std::make_unique<StatArbStrategy>(2));
+    strategies.push_back(std::make_unique<EnhancedMomentumStrategy>(3));
+    for (auto& strategy : strategies) {
+        strategy->set_log_level(LogLevel::WARNING);
+    }
+    return strategies;
+}
+
+FillConfig bench_fill_config() {
+    FillConfig config;
+    config.model = FillModel::LATENCY_AWARE;
+    config.random_seed = 1;
+    config.log_orders = false;
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t tick_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if (tick_count == 0 || iterations == 0) {
+        std::cerr << "Usage: " << argv[0] << " [ticks] [iterations]" << std::endl;
+        return 1;
+    }
+
+    StaticConfig::load_from_file("config/hft_config.conf");
+    TickSeries ticks = make_ticks(tick_count);
+    std::cout << "Strategy dispatch benchmark: " << tick_count << " ticks, best of "
+              << iterations << " runs\n\n";
+
+    // Dispatch only: the same three strategies, signals counted and dropped
+    uint64_t virtual_signals = 0;
+    uint64_t static_signals = 0;
+    auto count_into = [](uint64_t& counter) { return [&counter](const TradingSignal&) { counter++; }; };
+
+    std::vector<std::unique_ptr<OrderBookStrategy>> strategies = make_virtual_set();
+    for (auto& strategy : strategies) {
+        strategy->set_signal_callback(count_into(virtual_signals));
+        strategy->initialize();
+    }
+    double virtual_seconds = best_seconds(iterations, [&]() {
+        for (const auto& data : ticks) {
+            for (auto& strategy : strategies) {
+                strategy->on_market_data(data);
+            }
+        }
+    });
+
+    StaticSet set(1, 2, 3);
+    set.for_each([&](OrderBookStrategy& strategy) {
+        strategy.set_signal_callback(count_into(static_signals));
+        strategy.set_log_level(LogLevel::WARNING);
+        strategy.initialize();
+    });
+    double static_seconds = best_seconds(iterations, [&]() {
+        for (const auto& data : ticks) {
+            set.on_market_data(data);
+        }
+    });
+
+    report("virtual dispatch", tick_count, virtual_seconds);
+    report("static dispatch", tick_count, static_seconds);
+    std::cout << "  speedup " << std::setprecision(2) << virtual_seconds / static_seconds
+              << "x, signals " << virtual_signals << " vs " << static_signals << "\n\n";
+
+    // Full engine: book updates, fills and P&L on top of dispatch
+    BacktestStats virtual_stats;
+    double virtual_engine_seconds = best_seconds(iterations, [&]() {
+        BacktestEngine engine;
+        engine.initialize(bench_fill_config());
+        for (auto& strategy : make_virtual_set()) {
+            engine.add_strategy(std::move(strategy));
+        }
+        virtual_stats = engine.run(ticks);
+    });
+
+    BacktestStats static_stats;
+    double static_engine_seconds = best_seconds(iterations, [&]() {
+        StaticSet engine_set(1, 2, 3);
+        engine_set.for_each([](OrderBookStrategy& strategy) { strategy.set_log_level(LogLevel::WARNING); });
+        BacktestEngine engine;
+        engine.initialize(bench_fill_config());
+        static_stats = engine.run(engine_set, ticks);
+    });
+
+    report("engine, virtual", tick_count, virtual_engine_seconds);
+    report("engine, static", tick_count, static_engine_seconds);
+    std::cout << "  speedup " << std::setprecision(2) << virtual_engine_seconds / static_engine_seconds
+              << "x, fills " << virtual_stats.fills << " vs " << static_stats.fills << "\n";
+
+    // Both paths must have simulated the same thing for the numbers to mean anything
+    if (virtual_stats.signals != static_stats.signals || virtual_stats.fills != static_stats.fills) {
+        std::cerr << "[StrategyDispatchBench] Virtual and static runs diverged" << std::endl;
+        return 1;
+    }
+    return 0;
+}
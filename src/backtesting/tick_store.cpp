@@ -0,0 +1,419 @@
+#include "tick_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+
+bool TickStoreWriter::write(const std::string& file_path, std::vector<HistoricalDataPoint> points) {
+    std::stable_sort(points.begin(), points.end(),
+                     [](const HistoricalDataPoint& a, const HistoricalDataPoint& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+
+    // Symbol directory in name order; postings are record indices per symbol
+    std::map<std::string, std::vector<uint64_t>> by_symbol;
+    for (size_t i = 0; i < points.size(); ++i) {
+        std::string symbol(points[i].symbol, strnlen(points[i].symbol, sizeof(points[i].symbol)));
+        by_symbol[symbol].push_back(i);
+    }
+    if (by_symbol.size() > UINT32_MAX) {
+        std::cerr << "[TickStore] Too many symbols for " << file_path << std::endl;
+        return false;
+    }
+
+    std::vector<TickStoreSymbol> symbols;
+    std::vector<uint32_t> symbol_of_record(points.size());
+    std::vector<uint64_t> postings;
+    postings.reserve(points.size());
+    for (const auto& [name, indices] : by_symbol) {
+        TickStoreSymbol entry{};
+        std::strncpy(entry.symbol, name.c_str(), sizeof(entry.symbol) - 1);
+        entry.postings_begin = postings.size();
+        entry.postings_count = indices.size();
+        entry.first_timestamp = points[indices.front()].timestamp;
+        entry.last_timestamp = points[indices.back()].timestamp;
+        for (uint64_t index : indices) {
+            symbol_of_record[index] = static_cast<uint32_t>(symbols.size());
+            postings.push_back(index);
+        }
+        symbols.push_back(entry);
+    }
+
+    TickStoreHeader header{};
+    std::memcpy(header.magic, tick_store::MAGIC, sizeof(header.magic));
+    header.version = tick_store::VERSION;
+    header.symbol_count = static_cast<uint32_t>(symbols.size());
+    header.record_count = points.size();
+    header.first_timestamp = points.empty() ? 0 : points.front().timestamp;
+    header.last_timestamp = points.empty() ? 0 : points.back().timestamp;
+    header.symbols_offset = sizeof(TickStoreHeader) + points.size() * sizeof(TickRecord);
+    header.postings_offset = header.symbols_offset + symbols.size() * sizeof(TickStoreSymbol);
+
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[TickStore] Could not open " << file_path << " for writing" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto& point = points[i];
+        TickRecord record{};
+        record.timestamp = point.timestamp;
+        record.symbol_index = symbol_of_record[i];
+        record.open_price = to_fixed_price(point.open_price);
+        record.high_price = to_fixed_price(point.high_price);
+        record.low_price = to_fixed_price(point.low_price);
+        record.last_price = to_fixed_price(point.last_price);
+        record.bid_price = to_fixed_price(point.bid_price);
+        record.ask_price = to_fixed_price(point.ask_price);
+        record.total_volume = point.total_volume;
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    file.write(reinterpret_cast<const char*>(symbols.data()), symbols.size() * sizeof(TickStoreSymbol));
+    file.write(reinterpret_cast<const char*>(postings.data()), postings.size() * sizeof(uint64_t));
+
+    if (!file.good()) {
+        std::cerr << "[TickStore] Write failed for " << file_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+// A run being merged: its file and the record at its head
+struct RunCursor {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{nullptr, std::fclose};
+    TickRecord record{};
+    uint32_t symbol = 0;
+
+    bool advance() { return std::fread(&record, sizeof(record), 1, file.get()) == 1; }
+};
+
+} // namespace
+
+bool TickStoreWriter::merge(const std::string& file_path, const std::vector<std::string>& run_paths) {
+    std::vector<RunCursor> runs(run_paths.size());
+    std::vector<std::string> names(run_paths.size());
+    for (size_t i = 0; i < run_paths.size(); ++i) {
+        runs[i].file.reset(std::fopen(run_paths[i].c_str(), "rb"));
+        TickRunHeader header{};
+        if (!runs[i].file || std::fread(&header, sizeof(header), 1, runs[i].file.get()) != 1 ||
+            std::memcmp(header.magic, tick_store::RUN_MAGIC, sizeof(header.magic)) != 0) {
+            std::cerr << "[TickStore] " << run_paths[i] << " is not a tick run" << std::endl;
+            return false;
+        }
+        names[i].assign(header.symbol, strnlen(header.symbol, sizeof(header.symbol)));
+        std::setvbuf(runs[i].file.get(), nullptr, _IOFBF, 1 << 16);
+    }
+
+    // Symbol directory in name order, as write() builds it
+    std::vector<std::string> directory = names;
+    std::sort(directory.begin(), directory.end());
+    directory.erase(std::unique(directory.begin(), directory.end()), directory.end());
+    if (directory.size() > UINT32_MAX) {
+        std::cerr << "[TickStore] Too many symbols for " << file_path << std::endl;
+        return false;
+    }
+    std::vector<TickStoreSymbol> symbols(directory.size());
+    for (size_t s = 0; s < directory.size(); ++s) {
+        std::strncpy(symbols[s].symbol, directory[s].c_str(), sizeof(symbols[s].symbol) - 1);
+    }
+
+    auto later = [&runs](size_t a, size_t b) {
+        const RunCursor& x = runs[a];
+        const RunCursor& y = runs[b];
+        if (x.record.timestamp != y.record.timestamp) return x.record.timestamp > y.record.timestamp;
+        if (x.symbol != y.symbol) return x.symbol > y.symbol;
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heads(later);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        runs[i].symbol = static_cast<uint32_t>(
+            std::lower_bound(directory.begin(), directory.end(), names[i]) - directory.begin());
+        if (runs[i].advance()) heads.push(i);
+    }
+
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[TickStore] Could not open " << file_path << " for writing" << std::endl;
+        return false;
+    }
+
+    TickStoreHeader header{};
+    std::memcpy(header.magic, tick_store::MAGIC, sizeof(header.magic));
+    header.version = tick_store::VERSION;
+    header.symbol_count = static_cast<uint32_t>(symbols.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    while (!heads.empty()) {
+        size_t i = heads.top();
+        heads.pop();
+        TickRecord record = runs[i].record;
+        TickStoreSymbol& symbol = symbols[runs[i].symbol];
+        if (symbol.postings_count == 0 || record.timestamp > symbol.last_timestamp) {
+            record.symbol_index = runs[i].symbol;
+            record.reserved = 0;
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            if (symbol.postings_count++ == 0) symbol.first_timestamp = record.timestamp;
+            symbol.last_timestamp = record.timestamp;
+            if (header.record_count++ == 0) header.first_timestamp = record.timestamp;
+            header.last_timestamp = record.timestamp;
+        }
+        if (runs[i].advance()) heads.push(i);
+    }
+
+    uint64_t begin = 0;
+    for (auto& symbol : symbols) {
+        symbol.postings_begin = begin;
+        begin += symbol.postings_count;
+    }
+    header.symbols_offset = sizeof(TickStoreHeader) + header.record_count * sizeof(TickRecord);
+    header.postings_offset = header.symbols_offset + symbols.size() * sizeof(TickStoreSymbol);
+    file.write(reinterpret_cast<const char*>(symbols.data()), symbols.size() * sizeof(TickStoreSymbol));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file.good()) {
+        std::cerr << "[TickStore] Write failed for " << file_path << std::endl;
+        return false;
+    }
+
+    // Postings need each symbol's count first; fill them from the records
+    // just written, through the page cache rather than the heap
+    size_t file_size = header.postings_offset + header.record_count * sizeof(uint64_t);
+    int fd = ::open(file_path.c_str(), O_RDWR);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        std::cerr << "[TickStore] Could not size " << file_path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) ::close(fd);
+        return false;
+    }
+    void* addr = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[TickStore] mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    char* bytes = static_cast<char*>(addr);
+    const auto* records = reinterpret_cast<const TickRecord*>(bytes + sizeof(TickStoreHeader));
+    auto* postings = reinterpret_cast<uint64_t*>(bytes + header.postings_offset);
+    std::vector<uint64_t> next(symbols.size());
+    for (size_t s = 0; s < symbols.size(); ++s) next[s] = symbols[s].postings_begin;
+    for (uint64_t i = 0; i < header.record_count; ++i) {
+        postings[next[records[i].symbol_index]++] = i;
+    }
+    ::munmap(addr, file_size);
+    return true;
+}
+
+TickRunWriter::~TickRunWriter() {
+    close();
+}
+
+bool TickRunWriter::open(const std::string& file_path, const std::string& symbol) {
+    close();
+    records_ = 0;
+    last_timestamp_ = 0;
+    if (symbol.empty() || symbol.size() >= tick_store::SYMBOL_LENGTH) {
+        std::cerr << "[TickStore] Symbol '" << symbol << "' does not fit a tick run" << std::endl;
+        return false;
+    }
+
+    TickRunHeader header{};
+    std::memcpy(header.magic, tick_store::RUN_MAGIC, sizeof(header.magic));
+    std::strncpy(header.symbol, symbol.c_str(), sizeof(header.symbol) - 1);
+
+    struct stat st {};
+    if (::stat(file_path.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(TickRunHeader)) {
+        // Resume: keep the whole records, drop a torn tail
+        std::FILE* file = std::fopen(file_path.c_str(), "r+b");
+        TickRunHeader existing{};
+        if (!file || std::fread(&existing, sizeof(existing), 1, file) != 1 ||
+            std::memcmp(&existing, &header, sizeof(header)) != 0) {
+            std::cerr << "[TickStore] " << file_path << " is not a tick run for " << symbol << std::endl;
+            if (file) std::fclose(file);
+            return false;
+        }
+        records_ = (static_cast<size_t>(st.st_size) - sizeof(TickRunHeader)) / sizeof(TickRecord);
+        off_t whole = static_cast<off_t>(sizeof(TickRunHeader) + records_ * sizeof(TickRecord));
+        if (whole != st.st_size && ::ftruncate(fileno(file), whole) != 0) {
+            std::cerr << "[TickStore] Could not truncate " << file_path << ": " << std::strerror(errno) << std::endl;
+            std::fclose(file);
+            return false;
+        }
+        if (records_ > 0) {
+            TickRecord last{};
+            std::fseek(file, whole - static_cast<off_t>(sizeof(TickRecord)), SEEK_SET);
+            if (std::fread(&last, sizeof(last), 1, file) == 1) last_timestamp_ = last.timestamp;
+        }
+        std::fseek(file, 0, SEEK_END);
+        file_ = file;
+    } else {
+        file_ = std::fopen(file_path.c_str(), "wb");
+        if (!file_ || std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            std::cerr << "[TickStore] Could not create " << file_path << std::endl;
+            close();
+            return false;
+        }
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, 1 << 16);
+    return true;
+}
+
+bool TickRunWriter::append(const TickRecord& record) {
+    if (!file_ || std::fwrite(&record, sizeof(record), 1, file_) != 1) return false;
+    records_++;
+    last_timestamp_ = record.timestamp;
+    return true;
+}
+
+bool TickRunWriter::close() {
+    if (!file_) return true;
+    bool ok = std::fflush(file_) == 0;
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+TickStoreReader::~TickStoreReader() {
+    close();
+}
+
+bool TickStoreReader::is_tick_store(const std::string& file_path) {
+    std::ifstream file(file_path, std::ios::binary);
+    char magic[sizeof(tick_store::MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) && std::memcmp(magic, tick_store::MAGIC, sizeof(magic)) == 0;
+}
+
+bool TickStoreReader::open(const std::string& file_path) {
+    close();
+
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[TickStore] Could not open " << file_path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TickStoreHeader)) {
+        std::cerr << "[TickStore] " << file_path << " is too small for a tick store" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[TickStore] mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Playback is a forward scan; let the kernel read ahead aggressively
+    ::madvise(addr, file_size, MADV_SEQUENTIAL);
+
+    base_ = addr;
+    mapped_size_ = file_size;
+
+    const auto* header = static_cast<const TickStoreHeader*>(addr);
+    bool valid = std::memcmp(header->magic, tick_store::MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == tick_store::VERSION &&
+                 header->symbols_offset == sizeof(TickStoreHeader) + header->record_count * sizeof(TickRecord) &&
+                 header->postings_offset == header->symbols_offset + header->symbol_count * sizeof(TickStoreSymbol) &&
+                 header->postings_offset + header->record_count * sizeof(uint64_t) <= file_size;
+    if (!valid) {
+        std::cerr << "[TickStore] " << file_path << " is not a valid tick store" << std::endl;
+        close();
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(addr);
+    header_ = header;
+    records_ = reinterpret_cast<const TickRecord*>(bytes + sizeof(TickStoreHeader));
+    symbols_ = reinterpret_cast<const TickStoreSymbol*>(bytes + header->symbols_offset);
+    postings_ = reinterpret_cast<const uint64_t*>(bytes + header->postings_offset);
+    return true;
+}
+
+void TickStoreReader::close() {
+    if (base_) {
+        ::munmap(base_, mapped_size_);
+    }
+    base_ = nullptr;
+    mapped_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+    symbols_ = nullptr;
+    postings_ = nullptr;
+}
+
+size_t TickStoreReader::lower_bound(uint64_t timestamp) const {
+    const TickRecord* end = records_ + size();
+    return std::lower_bound(records_, end, timestamp,
+                            [](const TickRecord& r, uint64_t t) { return r.timestamp < t; }) - records_;
+}
+
+size_t TickStoreReader::upper_bound(uint64_t timestamp) const {
+    const TickRecord* end = records_ + size();
+    return std::upper_bound(records_, end, timestamp,
+                            [](uint64_t t, const TickRecord& r) { return t < r.timestamp; }) - records_;
+}
+
+const TickStoreSymbol* TickStoreReader::find_symbol(const std::string& symbol) const {
+    if (!header_) return nullptr;
+    // Directory is written in name order
+    const TickStoreSymbol* end = symbols_ + header_->symbol_count;
+    const TickStoreSymbol* it = std::lower_bound(symbols_, end, symbol,
+        [](const TickStoreSymbol& s, const std::string& name) {
+            return std::strncmp(s.symbol, name.c_str(), sizeof(s.symbol)) < 0;
+        });
+    if (it == end || std::strncmp(it->symbol, symbol.c_str(), sizeof(it->symbol)) != 0) {
+        return nullptr;
+    }
+    return it;
+}
+
+size_t TickStoreReader::symbol_lower_bound(const TickStoreSymbol& symbol, uint64_t timestamp) const {
+    const uint64_t* begin = postings(symbol);
+    const uint64_t* end = begin + symbol.postings_count;
+    return std::lower_bound(begin, end, timestamp,
+                            [this](uint64_t index, uint64_t t) { return records_[index].timestamp < t; }) - begin;
+}
+
+size_t TickStoreReader::symbol_upper_bound(const TickStoreSymbol& symbol, uint64_t timestamp) const {
+    const uint64_t* begin = postings(symbol);
+    const uint64_t* end = begin + symbol.postings_count;
+    return std::upper_bound(begin, end, timestamp,
+                            [this](uint64_t t, uint64_t index) { return t < records_[index].timestamp; }) - begin;
+}
+
+HistoricalDataPoint TickStoreReader::to_data_point(const TickRecord& record) const {
+    HistoricalDataPoint point{};
+    point.timestamp = record.timestamp;
+    std::strncpy(point.symbol, symbols_[record.symbol_index].symbol, sizeof(point.symbol) - 1);
+    point.open_price = to_double_price(record.open_price);
+    point.high_price = to_double_price(record.high_price);
+    point.low_price = to_double_price(record.low_price);
+    point.last_price = to_double_price(record.last_price);
+    point.bid_price = to_double_price(record.bid_price);
+    point.ask_price = to_double_price(record.ask_price);
+    point.total_volume = record.total_volume;
+    point.last_volume = record.total_volume;
+    point.bid_volume = 1000;
+    point.ask_volume = 1000;
+    return point;
+}
+
+} // namespace hft
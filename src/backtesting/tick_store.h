@@ -0,0 +1,160 @@
+#pragma once
+
+#include "historical_data_player.h"
+#include "../common/fixed_price.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// Binary tick store: a fixed-record file that the HistoricalDataPlayer mmaps
+// and streams from instead of parsing CSV into memory.
+//
+// Layout (little endian, all sections 8-byte aligned):
+//   TickStoreHeader
+//   TickRecord[record_count]            sorted by timestamp (stable per symbol)
+//   TickStoreSymbol[symbol_count]       per-symbol directory
+//   uint64_t postings[record_count]     record indices grouped by symbol, in time order
+//
+// Records are globally time-sorted, so a time seek is a binary search over
+// the records; a per-symbol seek is a binary search over that symbol's postings.
+namespace tick_store {
+
+constexpr char MAGIC[8] = {'H', 'F', 'T', 'T', 'I', 'C', 'K', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t SYMBOL_LENGTH = 16;
+constexpr const char* FILE_EXTENSION = ".tick";
+
+constexpr char RUN_MAGIC[8] = {'H', 'F', 'T', 'R', 'U', 'N', '1', '\0'};
+
+} // namespace tick_store
+
+struct TickStoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t symbol_count;
+    uint64_t record_count;
+    uint64_t first_timestamp;    // Unix milliseconds
+    uint64_t last_timestamp;
+    uint64_t symbols_offset;     // Byte offset of the symbol directory
+    uint64_t postings_offset;    // Byte offset of the posting lists
+};
+
+struct TickRecord {
+    uint64_t timestamp;          // Unix milliseconds
+    uint32_t symbol_index;       // Into the file's symbol directory
+    uint32_t reserved;
+    price_t open_price;
+    price_t high_price;
+    price_t low_price;
+    price_t last_price;
+    price_t bid_price;
+    price_t ask_price;
+    uint64_t total_volume;
+};
+
+struct TickStoreSymbol {
+    char symbol[tick_store::SYMBOL_LENGTH];
+    uint64_t postings_begin;     // Index into the postings array
+    uint64_t postings_count;
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+};
+
+// A run: one symbol's records in time order, as a download appends them.
+// symbol_index is unused in runs; the header names the symbol.
+struct TickRunHeader {
+    char magic[8];
+    char symbol[tick_store::SYMBOL_LENGTH];
+};
+
+static_assert(sizeof(TickStoreHeader) == 56, "TickStoreHeader layout changed");
+static_assert(sizeof(TickRecord) == 72, "TickRecord layout changed");
+static_assert(sizeof(TickStoreSymbol) == 48, "TickStoreSymbol layout changed");
+static_assert(sizeof(TickRunHeader) == 24, "TickRunHeader layout changed");
+
+// Builds a tick store from in-memory points (the CSV converter path), or by
+// merging runs (the download path)
+class TickStoreWriter {
+public:
+    static bool write(const std::string& file_path, std::vector<HistoricalDataPoint> points);
+
+    // K-way merge of runs into a store, streaming: memory is a read buffer per
+    // run, whatever the runs' size. Records that do not move a symbol's time
+    // forward (overlapping runs) are dropped; equal timestamps across symbols
+    // are ordered by symbol name.
+    static bool merge(const std::string& file_path, const std::vector<std::string>& run_paths);
+};
+
+// Appends records to a run file. Opening an existing run keeps its whole
+// records and drops a torn tail, so a download killed mid-write resumes from
+// last_timestamp().
+class TickRunWriter {
+public:
+    TickRunWriter() = default;
+    ~TickRunWriter();
+
+    TickRunWriter(const TickRunWriter&) = delete;
+    TickRunWriter& operator=(const TickRunWriter&) = delete;
+
+    bool open(const std::string& file_path, const std::string& symbol);
+    bool append(const TickRecord& record);
+    bool close();
+    bool is_open() const { return file_ != nullptr; }
+
+    uint64_t records() const { return records_; }
+    uint64_t last_timestamp() const { return last_timestamp_; }     // 0 if empty
+
+private:
+    std::FILE* file_ = nullptr;
+    uint64_t records_ = 0;
+    uint64_t last_timestamp_ = 0;
+};
+
+// Read-only mmap view of a tick store. Pages are faulted in on demand, so
+// opening a multi-GB file is O(1) and memory is bounded by the page cache.
+class TickStoreReader {
+public:
+    TickStoreReader() = default;
+    ~TickStoreReader();
+
+    TickStoreReader(const TickStoreReader&) = delete;
+    TickStoreReader& operator=(const TickStoreReader&) = delete;
+
+    bool open(const std::string& file_path);
+    void close();
+    bool is_open() const { return base_ != nullptr; }
+
+    // True if the file starts with the tick store magic
+    static bool is_tick_store(const std::string& file_path);
+
+    size_t size() const { return header_ ? header_->record_count : 0; }
+    const TickStoreHeader* header() const { return header_; }
+    const TickRecord& record(size_t index) const { return records_[index]; }
+    const char* symbol_name(uint32_t symbol_index) const { return symbols_[symbol_index].symbol; }
+
+    // Index of the first record with timestamp >= / > the given time
+    size_t lower_bound(uint64_t timestamp) const;
+    size_t upper_bound(uint64_t timestamp) const;
+
+    // Per-symbol index: returns nullptr if the symbol is not in the file
+    const TickStoreSymbol* find_symbol(const std::string& symbol) const;
+    const uint64_t* postings(const TickStoreSymbol& symbol) const { return postings_ + symbol.postings_begin; }
+    size_t symbol_lower_bound(const TickStoreSymbol& symbol, uint64_t timestamp) const;
+    size_t symbol_upper_bound(const TickStoreSymbol& symbol, uint64_t timestamp) const;
+
+    HistoricalDataPoint to_data_point(const TickRecord& record) const;
+
+private:
+    void* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    const TickStoreHeader* header_ = nullptr;
+    const TickRecord* records_ = nullptr;
+    const TickStoreSymbol* symbols_ = nullptr;
+    const uint64_t* postings_ = nullptr;
+};
+
+} // namespace hft
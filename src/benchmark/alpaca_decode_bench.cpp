@@ -0,0 +1,257 @@
+// Alpaca stream decoding benchmark: ns per message and MB/s for AlpacaDecoder
+// against the nlohmann DOM path AlpacaMarketData used before it (parse the
+// frame, then dump and re-parse each message), over generated quote/trade
+// frames or frames recorded one per line. Results go out as JSON lines like
+// transport_bench; a summary goes to stderr. The DOM baseline is only built
+// where nlohmann/json is installed.
+//
+// Usage: alpaca_decode_bench [--frames N] [--messages-per-frame N] [--symbols N]
+//                            [--trade-ratio 0.2] [--seed N] [--cpu N]
+//                            [--input file] [--output file]
+
+#include "../market_data_handler/alpaca_decoder.h"
+#include "../common/high_res_timer.h"
+#include "../common/latency_histogram.h"
+#include "../common/cpu_affinity.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<nlohmann/json.hpp>)
+#include <nlohmann/json.hpp>
+#define HFT_BENCH_DOM 1
+#endif
+
+using namespace hft;
+
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+
+struct Options {
+    size_t frames = 20000;
+    size_t messages_per_frame = 8;
+    size_t symbols = 100;
+    double trade_ratio = 0.2;
+    uint64_t seed = 1;
+    int cpu = -1;
+    std::string input_file;
+    std::string output_file;
+};
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("Missing value for " + key);
+        std::string value = argv[++i];
+        if (key == "--frames") {
+            options.frames = std::stoull(value);
+        } else if (key == "--messages-per-frame") {
+            options.messages_per_frame = std::stoull(value);
+        } else if (key == "--symbols") {
+            options.symbols = std::stoull(value);
+        } else if (key == "--trade-ratio") {
+            options.trade_ratio = std::stod(value);
+        } else if (key == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (key == "--cpu") {
+            options.cpu = std::stoi(value);
+        } else if (key == "--input") {
+            options.input_file = value;
+        } else if (key == "--output") {
+            options.output_file = value;
+        } else {
+            throw std::runtime_error("Unknown option " + key);
+        }
+    }
+    if (options.symbols == 0 || options.messages_per_frame == 0) {
+        throw std::runtime_error("--symbols and --messages-per-frame must be positive");
+    }
+    return options;
+}
+
+// Frames shaped like the live v2 stream: every member, in Alpaca's order
+std::vector<std::string> generate_frames(const Options& options) {
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> mids(options.symbols);
+    for (auto& mid : mids) mid = 20.0 + unit(rng) * 400.0;
+
+    std::vector<std::string> frames;
+    frames.reserve(options.frames);
+    uint64_t nanos = 208234521;
+    for (size_t f = 0; f < options.frames; ++f) {
+        std::ostringstream frame;
+        frame.setf(std::ios::fixed);
+        frame << '[';
+        for (size_t m = 0; m < options.messages_per_frame; ++m) {
+            size_t s = rng() % options.symbols;
+            mids[s] *= 1.0 + (unit(rng) - 0.5) * 0.0005;
+            nanos = (nanos + 1379) % 1000000000;
+            if (m > 0) frame << ',';
+            if (unit(rng) < options.trade_ratio) {
+                frame << R"({"T":"t","i":)" << 52983525029461 + f * 16 + m << R"(,"S":"SYM)" << s
+                      << R"(","x":"V","p":)" << std::setprecision(3) << mids[s] << R"(,"s":)" << 1 + rng() % 500
+                      << R"(,"c":["@","I"],"z":"C","t":"2021-02-22T15:51:44.)" << std::setw(9) << std::setfill('0')
+                      << nanos << std::setfill(' ') << R"(Z"})";
+            } else {
+                frame << R"({"T":"q","S":"SYM)" << s << R"(","bx":"U","bp":)" << std::setprecision(2)
+                      << mids[s] - 0.01 << R"(,"bs":)" << 1 + rng() % 10 << R"(,"ax":"Q","ap":)"
+                      << mids[s] + 0.01 << R"(,"as":)" << 1 + rng() % 10
+                      << R"(,"c":["R"],"z":"C","t":"2021-02-22T15:51:44.)" << std::setw(9) << std::setfill('0')
+                      << nanos << std::setfill(' ') << R"(Z"})";
+            }
+        }
+        frame << ']';
+        frames.push_back(frame.str());
+    }
+    return frames;
+}
+
+std::vector<std::string> load_frames(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+    std::vector<std::string> frames;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) frames.push_back(line);
+    }
+    if (frames.empty()) throw std::runtime_error("No frames in " + path);
+    return frames;
+}
+
+struct Measurement {
+    HistogramSnapshot per_frame;
+    double mean_message_ns = 0.0;
+    double megabytes_per_second = 0.0;
+    size_t messages = 0;
+    size_t failures = 0;
+};
+
+// Untimed warm pass, then a whole-run pass for the mean and a per-frame pass
+// for the distribution, so timer reads don't pad the mean
+template <typename Decode>
+Measurement measure(const std::vector<std::string>& frames, size_t bytes, Decode&& decode) {
+    Measurement result;
+    for (const auto& frame : frames) decode(frame, result.failures);
+    result.failures = 0;
+
+    size_t messages = 0;
+    auto start = HighResTimer::get_ticks_start();
+    for (const auto& frame : frames) messages += decode(frame, result.failures);
+    auto elapsed_ns = HighResTimer::ticks_to_nanoseconds(HighResTimer::get_ticks_end() - start);
+
+    size_t ignored = 0;
+    for (const auto& frame : frames) {
+        auto t0 = HighResTimer::get_ticks_start();
+        decode(frame, ignored);
+        result.per_frame.record(HighResTimer::ticks_to_nanoseconds(HighResTimer::get_ticks_end() - t0));
+    }
+
+    result.messages = messages;
+    result.mean_message_ns = messages > 0 ? static_cast<double>(elapsed_ns) / messages : 0.0;
+    result.megabytes_per_second = elapsed_ns > 0 ? bytes * 1e3 / elapsed_ns : 0.0;
+    return result;
+}
+
+void write_result(std::ostream& out, const std::string& source, const char* decoder, const Measurement& m) {
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"result\""
+        << ",\"source\":\"" << source << "\""
+        << ",\"decoder\":\"" << decoder << "\""
+        << ",\"messages\":" << m.messages
+        << ",\"failures\":" << m.failures
+        << ",\"mean_message_ns\":" << m.mean_message_ns
+        << ",\"mb_per_s\":" << m.megabytes_per_second
+        << ",\"frame_p50_ns\":" << m.per_frame.percentile(0.50)
+        << ",\"frame_p99_ns\":" << m.per_frame.percentile(0.99)
+        << ",\"frame_max_ns\":" << m.per_frame.max_value << "}" << std::endl;
+    std::cerr << "[AlpacaDecodeBench] " << decoder << ": " << m.mean_message_ns << "ns/message, "
+              << m.megabytes_per_second << " MB/s, frame p50 " << m.per_frame.percentile(0.50)
+              << "ns p99 " << m.per_frame.percentile(0.99) << "ns" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> frames;
+    try {
+        options = parse_options(argc, argv);
+        frames = options.input_file.empty() ? generate_frames(options) : load_frames(options.input_file);
+    } catch (const std::exception& e) {
+        std::cerr << "[AlpacaDecodeBench] " << e.what() << std::endl;
+        return 1;
+    }
+    std::string source = options.input_file.empty() ? "generated" : options.input_file;
+    size_t bytes = 0;
+    for (const auto& frame : frames) bytes += frame.size();
+
+    // Results own stdout; console logging from the timer joins the summary on stderr
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    if (options.cpu >= 0 && !CPUAffinity::set_thread_affinity(options.cpu)) {
+        std::cerr << "[AlpacaDecodeBench] Cannot pin to CPU " << options.cpu << std::endl;
+    }
+    HighResTimer::initialize();
+
+    std::ofstream file;
+    if (!options.output_file.empty()) {
+        file.open(options.output_file, std::ios::app);
+        if (!file) {
+            std::cerr << "[AlpacaDecodeBench] Cannot open " << options.output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_file.empty() ? results : file;
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"run\""
+        << ",\"tsc_hz\":" << HighResTimer::get_tsc_frequency()
+        << ",\"cpu\":" << options.cpu
+        << ",\"seed\":" << options.seed
+        << ",\"frames\":" << frames.size()
+        << ",\"bytes\":" << bytes << "}" << std::endl;
+
+    AlpacaDecoder decoder;
+    std::vector<AlpacaRecord> batch;
+    batch.reserve(1024);
+    volatile int64_t sink = 0;
+    Measurement fast = measure(frames, bytes, [&](const std::string& frame, size_t& failures) {
+        batch.clear();
+        if (!decoder.decode(frame.data(), frame.size(), batch)) failures++;
+        for (const auto& record : batch) sink = sink + record.bid_price + record.price;
+        return batch.size();
+    });
+    write_result(out, source, "alpaca", fast);
+
+#ifdef HFT_BENCH_DOM
+    Measurement dom = measure(frames, bytes, [&](const std::string& frame, size_t& failures) {
+        size_t messages = 0;
+        try {
+            auto json = nlohmann::json::parse(frame);
+            for (const auto& msg : json) {
+                std::string type = msg.value("T", "");
+                auto message = nlohmann::json::parse(msg.dump());
+                std::string symbol = message.value("S", "");
+                double price = type == "q" ? message.value("bp", 0.0) : message.value("p", 0.0);
+                sink = sink + static_cast<int64_t>(price) + static_cast<int64_t>(symbol.size());
+                messages++;
+            }
+        } catch (const std::exception&) {
+            failures++;
+        }
+        return messages;
+    });
+    write_result(out, source, "dom", dom);
+    if (dom.mean_message_ns > 0.0 && fast.mean_message_ns > 0.0) {
+        std::cerr << "[AlpacaDecodeBench] speedup " << dom.mean_message_ns / fast.mean_message_ns << "x" << std::endl;
+    }
+#endif
+    (void)sink;
+    return fast.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,368 @@
+// Order book microbenchmarks: ns per apply_update, get_best_bid,
+// get_volume_weighted_price, get_total_size and the features() recompute
+// after a change for each book implementation,
+// over generated update streams at several depths or over a replayed
+// ITCH/pcap capture. With --verify every implementation is first replayed
+// against the std::map OrderBook and the run fails on the first difference.
+// Results go out as JSON lines like transport_bench; a summary goes to stderr.
+//
+// Usage: order_book_bench [--depths 5,50,500,5000] [--updates N] [--seed N]
+//                         [--impls map,ladder] [--verify] [--cpu N]
+//                         [--itch file | --pcap file] [--symbol SYM]
+//                         [--output file]
+//
+// --itch takes the NASDAQ historical format (2-byte length per message),
+// --pcap MoldUDP64 over UDP. Replay uses the most active symbol unless
+// --symbol is given; --depths is ignored then.
+
+#include "../common/book_features.h"
+#include "../common/book_replay.h"
+#include "../common/order_book.h"
+#include "../common/high_res_timer.h"
+#include "../common/latency_histogram.h"
+#include "../common/cpu_affinity.h"
+#include "../market_data_handler/itch_decoder.h"
+#include "../market_data_handler/pcap_file.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+constexpr uint32_t VWAP_SHARES = 1000;
+constexpr size_t TOTAL_SIZE_LEVELS = 10;
+
+struct Options {
+    std::vector<size_t> depths = {5, 50, 500, 5000};
+    size_t updates = 200000;
+    uint64_t seed = 1;
+    std::vector<BookImplementation> impls = {BookImplementation::MAP, BookImplementation::LADDER};
+    bool verify = false;
+    int cpu = -1;
+    std::string itch_file;
+    std::string pcap_file;
+    std::string symbol;
+    std::string output_file;
+};
+
+// One stream to benchmark: seed updates build the book untimed
+struct Workload {
+    std::string source;             // "generated" or the capture path
+    std::string symbol;
+    size_t depth = 0;               // Target depth (generated) or 0
+    std::vector<OrderBookUpdate> updates;
+    size_t seed_updates = 0;
+};
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+const char* impl_name(BookImplementation impl) {
+    return impl == BookImplementation::LADDER ? "ladder" : "map";
+}
+
+BookImplementation parse_impl(const std::string& name) {
+    if (name == "map") return BookImplementation::MAP;
+    if (name == "ladder") return BookImplementation::LADDER;
+    throw std::runtime_error("Unknown book implementation " + name);
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--verify") {
+            options.verify = true;
+            continue;
+        }
+        if (i + 1 >= argc) throw std::runtime_error("Missing value for " + key);
+        std::string value = argv[++i];
+        if (key == "--depths") {
+            options.depths.clear();
+            for (const auto& depth : split(value)) options.depths.push_back(std::stoull(depth));
+        } else if (key == "--updates") {
+            options.updates = std::stoull(value);
+        } else if (key == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (key == "--impls") {
+            options.impls.clear();
+            for (const auto& name : split(value)) options.impls.push_back(parse_impl(name));
+        } else if (key == "--cpu") {
+            options.cpu = std::stoi(value);
+        } else if (key == "--itch") {
+            options.itch_file = value;
+        } else if (key == "--pcap") {
+            options.pcap_file = value;
+        } else if (key == "--symbol") {
+            options.symbol = value;
+        } else if (key == "--output") {
+            options.output_file = value;
+        } else {
+            throw std::runtime_error("Unknown option " + key);
+        }
+    }
+    return options;
+}
+
+// Ethernet + IPv4 + UDP, as PCAPReader::extract_udp_payload
+bool udp_payload(const PcapPacket& packet, const uint8_t*& payload, size_t& len) {
+    constexpr size_t ETH_HEADER = 14, UDP_HEADER = 8;
+    if (packet.length < ETH_HEADER + 20 + UDP_HEADER) return false;
+    const uint8_t* ip = packet.data + ETH_HEADER;
+    size_t ip_header = (ip[0] & 0x0F) * 4;
+    if (ip[9] != 17 || ip_header < 20) return false;
+    const uint8_t* udp = ip + ip_header;
+    if (udp + UDP_HEADER > packet.data + packet.length) return false;
+    uint16_t udp_len = 0;
+    std::memcpy(&udp_len, udp + 4, sizeof(udp_len));
+    udp_len = ntohs(udp_len);
+    if (udp_len < UDP_HEADER) return false;
+    payload = udp + UDP_HEADER;
+    len = udp_len - UDP_HEADER;
+    return payload + len <= packet.data + packet.length;
+}
+
+// Decodes the capture and keeps one symbol's level updates. Their book
+// sequence numbers come from the decoder, so the replay is gap-free.
+Workload load_capture(const Options& options) {
+    ItchDecoder decoder;
+    std::unordered_map<std::string, std::vector<OrderBookUpdate>> by_symbol;
+    decoder.set_book_update_callback([&](const OrderBookUpdate& update) {
+        by_symbol[update.symbol].push_back(update);
+    });
+    if (!options.symbol.empty()) decoder.set_symbol_filter({options.symbol});
+
+    Workload workload;
+    if (!options.itch_file.empty()) {
+        workload.source = options.itch_file;
+        std::ifstream file(options.itch_file, std::ios::binary);
+        if (!file) throw std::runtime_error("Cannot open " + options.itch_file);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        decoder.decode_stream(data.data(), data.size());
+    } else {
+        workload.source = options.pcap_file;
+        MappedPcapFile capture;
+        if (!capture.open(options.pcap_file)) throw std::runtime_error("Cannot open " + options.pcap_file);
+        PcapPacket packets[256];
+        while (size_t count = capture.next_batch(packets, 256)) {
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t* payload = nullptr;
+                size_t len = 0;
+                if (udp_payload(packets[i], payload, len)) decoder.decode_moldudp64(payload, len);
+            }
+        }
+    }
+
+    auto best = by_symbol.end();
+    for (auto it = by_symbol.begin(); it != by_symbol.end(); ++it) {
+        if (best == by_symbol.end() || it->second.size() > best->second.size()) best = it;
+    }
+    if (best == by_symbol.end()) throw std::runtime_error("No book updates in " + workload.source);
+    workload.symbol = best->first;
+    workload.updates = std::move(best->second);
+    return workload;
+}
+
+// Wide enough that a generated stream's random walk stays inside the window
+size_t ladder_levels_for(const Workload& workload) {
+    size_t levels = LadderOrderBook::DEFAULT_LADDER_LEVELS;
+    while (levels < 8 * workload.depth) levels <<= 1;
+    return levels;
+}
+
+std::unique_ptr<IOrderBook> make_book(const Workload& workload, BookImplementation impl) {
+    return OrderBookFactory::create_book(workload.symbol, impl, DEFAULT_TICK, ladder_levels_for(workload));
+}
+
+void write_result(std::ostream& out, const Workload& workload, BookImplementation impl,
+                  const char* operation, const HistogramSnapshot& latency, double mean_ns) {
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"result\""
+        << ",\"source\":\"" << workload.source << "\""
+        << ",\"symbol\":\"" << workload.symbol << "\""
+        << ",\"depth\":" << workload.depth
+        << ",\"implementation\":\"" << impl_name(impl) << "\""
+        << ",\"operation\":\"" << operation << "\""
+        << ",\"count\":" << latency.total
+        << ",\"mean_ns\":" << mean_ns
+        << ",\"p50_ns\":" << latency.percentile(0.50)
+        << ",\"p99_ns\":" << latency.percentile(0.99)
+        << ",\"p999_ns\":" << latency.percentile(0.999)
+        << ",\"max_ns\":" << latency.max_value << "}" << std::endl;
+}
+
+// Mean ns per update over one untimed-per-call pass, so timer reads don't
+// pad the number
+double mean_apply_ns(const Workload& workload, BookImplementation impl) {
+    auto book = make_book(workload, impl);
+    for (size_t i = 0; i < workload.seed_updates; ++i) book->apply_update(workload.updates[i]);
+    size_t count = workload.updates.size() - workload.seed_updates;
+    auto start = HighResTimer::get_ticks_start();
+    for (size_t i = workload.seed_updates; i < workload.updates.size(); ++i) {
+        book->apply_update(workload.updates[i]);
+    }
+    auto elapsed = HighResTimer::get_ticks_end() - start;
+    return count > 0 ? static_cast<double>(HighResTimer::ticks_to_nanoseconds(elapsed)) / count : 0.0;
+}
+
+void run_workload(std::ostream& out, const Workload& workload, BookImplementation impl) {
+    double apply_mean = mean_apply_ns(workload, impl);
+
+    // Second pass: every call timed on its own, queries interleaved with
+    // updates so they see the book as it evolves
+    auto book = make_book(workload, impl);
+    for (size_t i = 0; i < workload.seed_updates; ++i) book->apply_update(workload.updates[i]);
+
+    HistogramSnapshot apply, best_bid, vwap, total_size, features;
+    volatile double double_sink = 0;
+    volatile uint32_t size_sink = 0;
+    for (size_t i = workload.seed_updates; i < workload.updates.size(); ++i) {
+        BookSide side = (i & 1) ? BookSide::BID : BookSide::ASK;
+
+        auto t0 = HighResTimer::get_ticks_start();
+        book->apply_update(workload.updates[i]);
+        auto t1 = HighResTimer::get_ticks_end();
+        double_sink = book->get_best_bid();
+        auto t2 = HighResTimer::get_ticks_end();
+        double_sink = book->get_volume_weighted_price(side, VWAP_SHARES);
+        auto t3 = HighResTimer::get_ticks_end();
+        size_sink = book->get_total_size(side, TOTAL_SIZE_LEVELS);
+        auto t4 = HighResTimer::get_ticks_end();
+        double_sink = book->features().microprice;
+        auto t5 = HighResTimer::get_ticks_end();
+
+        apply.record(HighResTimer::ticks_to_nanoseconds(t1 - t0));
+        best_bid.record(HighResTimer::ticks_to_nanoseconds(t2 - t1));
+        vwap.record(HighResTimer::ticks_to_nanoseconds(t3 - t2));
+        total_size.record(HighResTimer::ticks_to_nanoseconds(t4 - t3));
+        features.record(HighResTimer::ticks_to_nanoseconds(t5 - t4));
+    }
+    (void)double_sink;
+    (void)size_sink;
+
+    auto mean = [](const HistogramSnapshot& h) { return h.empty() ? 0.0 : static_cast<double>(h.sum) / h.total; };
+    write_result(out, workload, impl, "apply_update", apply, apply_mean);
+    write_result(out, workload, impl, "get_best_bid", best_bid, mean(best_bid));
+    write_result(out, workload, impl, "get_volume_weighted_price", vwap, mean(vwap));
+    write_result(out, workload, impl, "get_total_size", total_size, mean(total_size));
+    write_result(out, workload, impl, "features", features, mean(features));
+
+    std::cerr << "[OrderBookBench] " << workload.symbol << " depth=" << workload.depth
+              << " " << impl_name(impl) << ": apply " << apply_mean << "ns mean, p99 "
+              << apply.percentile(0.99) << "ns; best_bid p50 " << best_bid.percentile(0.50)
+              << "ns; vwap p50 " << vwap.percentile(0.50) << "ns; total_size p50 "
+              << total_size.percentile(0.50) << "ns; features (" << active_book_kernels().name
+              << ") p50 " << features.percentile(0.50) << "ns" << std::endl;
+}
+
+// Replays the workload into the map book and each other implementation
+bool verify_workload(std::ostream& out, const Workload& workload, const Options& options) {
+    bool ok = true;
+    for (BookImplementation impl : options.impls) {
+        if (impl == BookImplementation::MAP) continue;
+        auto reference = make_book(workload, BookImplementation::MAP);
+        auto candidate = make_book(workload, impl);
+        DifferentialResult result = replay_differential(workload.updates, *reference, *candidate);
+
+        out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"verify\""
+            << ",\"source\":\"" << workload.source << "\""
+            << ",\"symbol\":\"" << workload.symbol << "\""
+            << ",\"depth\":" << workload.depth
+            << ",\"implementation\":\"" << impl_name(impl) << "\""
+            << ",\"updates\":" << result.updates_applied
+            << ",\"ok\":" << (result.ok() ? "true" : "false") << "}" << std::endl;
+        if (!result.ok()) {
+            std::cerr << "[OrderBookBench] " << impl_name(impl) << " differs from map at update "
+                      << result.mismatch_index << " (" << OrderBookFactory::update_to_string(
+                             workload.updates[result.mismatch_index]) << "): " << result.mismatch << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<Workload> workloads;
+    try {
+        options = parse_options(argc, argv);
+        if (!options.itch_file.empty() || !options.pcap_file.empty()) {
+            workloads.push_back(load_capture(options));
+        } else {
+            for (size_t depth : options.depths) {
+                BookStreamConfig config;
+                config.depth = depth;
+                config.updates = options.updates;
+                config.seed = options.seed;
+                BookStream stream = generate_book_stream(config);
+
+                Workload workload;
+                workload.source = "generated";
+                workload.symbol = config.symbol;
+                workload.depth = depth;
+                workload.updates = std::move(stream.updates);
+                workload.seed_updates = stream.seed_updates;
+                workloads.push_back(std::move(workload));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[OrderBookBench] " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Results own stdout; console logging from the timer and transports
+    // joins the summary on stderr
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    if (options.cpu >= 0 && !CPUAffinity::set_thread_affinity(options.cpu)) {
+        std::cerr << "[OrderBookBench] Cannot pin to CPU " << options.cpu << std::endl;
+    }
+    HighResTimer::initialize();
+
+    std::ofstream file;
+    if (!options.output_file.empty()) {
+        file.open(options.output_file, std::ios::app);
+        if (!file) {
+            std::cerr << "[OrderBookBench] Cannot open " << options.output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_file.empty() ? results : file;
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"run\""
+        << ",\"tsc_hz\":" << HighResTimer::get_tsc_frequency()
+        << ",\"cpu\":" << options.cpu
+        << ",\"seed\":" << options.seed << "}" << std::endl;
+
+    bool ok = true;
+    for (const auto& workload : workloads) {
+        if (options.verify && !verify_workload(out, workload, options)) {
+            ok = false;
+            continue;
+        }
+        for (BookImplementation impl : options.impls) {
+            run_workload(out, workload, impl);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,621 @@
+// End-to-end load test: runs market_data_handler on the synthetic load
+// source, strategy_engine, order_gateway (paper fills, no fill delay) and
+// position_risk_service as separate processes on a generated config, and
+// reads every bus from outside. Tick-to-order latency and the per-stage
+// breakdown come from the trace each execution carries back, so nothing in
+// the services is instrumented for the test. Results go out as JSON lines
+// (one "run" record, one "result" record); a summary and the SLO verdicts go
+// to stderr.
+//
+// Usage: pipeline_load_bench [--rate N] [--symbols N] [--profile flat|open|bursts]
+//                            [--seed N] [--duration S] [--settle S] [--drain-ms N]
+//                            [--config file] [--bin-dir dir] [--work-dir dir]
+//                            [--scheme ipc|tcp] [--set key=value]...
+//                            [--slo-p50-us N] [--slo-p99-us N] [--slo-p999-us N]
+//                            [--slo-min-rate N] [--slo-max-drop-ratio X]
+//                            [--output file]
+//
+// The generated config is the base config with the load source, the rate,
+// no paper fill delay, no per-symbol order rate limit and a journal under
+// the work directory appended; --set lines go after those and win. With
+// the default ipc scheme the data buses live in the work directory, so a
+// run never crosses a system already up on the tcp ports (the metrics and
+// control ports still come from the base config).
+//
+// Only ticks received between settle and settle + duration seconds after
+// the first quote count, so service warmup and shutdown stay out of the
+// numbers; their orders are waited for up to drain-ms past the window.
+// Offered quotes follow the generator's clock, taken to start at that first
+// quote. Exit status: 0 when every SLO holds, 2 when one is breached, 1 when
+// the pipeline could not be run.
+
+#include "../common/zmq_transport.h"
+#include "../common/high_res_timer.h"
+#include "../common/latency_histogram.h"
+#include "../common/static_config.h"
+#include "../common/message_types.h"
+#include "../market_data_handler/load_generator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace hft;
+
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+constexpr int FIRST_QUOTE_TIMEOUT_S = 60;      // Covers service startup and warmup
+constexpr int STOP_TIMEOUT_MS = 10000;         // Then SIGKILL
+constexpr uint64_t OFFERED_STEP_NS = 1'000'000;
+
+// Launch order: everything downstream is subscribed before quotes flow
+const char* const SERVICES[] = {"position_risk_service", "order_gateway", "strategy_engine", "market_data_handler"};
+
+struct Options {
+    uint64_t rate = 100000;
+    int symbols = 1000;
+    std::string profile = "flat";
+    uint64_t seed = 1;
+    int duration_s = 30;
+    int settle_s = 5;
+    int drain_ms = 1000;
+    std::string config_file = "config/hft_config.conf";
+    std::string bin_dir;               // Default: this executable's directory
+    std::string work_dir;              // Default: a fresh /tmp/hft-load-XXXXXX
+    std::string scheme = "ipc";
+    std::vector<std::string> overrides;
+    double slo_p50_us = 0;             // SLOs left at 0 are not checked
+    double slo_p99_us = 0;
+    double slo_p999_us = 0;
+    double slo_min_rate = 0;           // Quotes/s through the feed
+    double slo_max_drop_ratio = 0.001; // Of quotes offered, and of orders signalled
+    std::string output_file;
+};
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("Missing value for " + key);
+        std::string value = argv[++i];
+        if (key == "--rate") {
+            options.rate = std::stoull(value);
+        } else if (key == "--symbols") {
+            options.symbols = std::stoi(value);
+        } else if (key == "--profile") {
+            LoadProfile profile;
+            if (!parse_load_profile(value, profile)) throw std::runtime_error("Unknown profile " + value);
+            options.profile = value;
+        } else if (key == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (key == "--duration") {
+            options.duration_s = std::stoi(value);
+        } else if (key == "--settle") {
+            options.settle_s = std::stoi(value);
+        } else if (key == "--drain-ms") {
+            options.drain_ms = std::stoi(value);
+        } else if (key == "--config") {
+            options.config_file = value;
+        } else if (key == "--bin-dir") {
+            options.bin_dir = value;
+        } else if (key == "--work-dir") {
+            options.work_dir = value;
+        } else if (key == "--scheme") {
+            if (value != "ipc" && value != "tcp") throw std::runtime_error("Scheme must be ipc or tcp");
+            options.scheme = value;
+        } else if (key == "--set") {
+            if (value.find('=') == std::string::npos) throw std::runtime_error("--set needs key=value");
+            options.overrides.push_back(value);
+        } else if (key == "--slo-p50-us") {
+            options.slo_p50_us = std::stod(value);
+        } else if (key == "--slo-p99-us") {
+            options.slo_p99_us = std::stod(value);
+        } else if (key == "--slo-p999-us") {
+            options.slo_p999_us = std::stod(value);
+        } else if (key == "--slo-min-rate") {
+            options.slo_min_rate = std::stod(value);
+        } else if (key == "--slo-max-drop-ratio") {
+            options.slo_max_drop_ratio = std::stod(value);
+        } else if (key == "--output") {
+            options.output_file = value;
+        } else {
+            throw std::runtime_error("Unknown option " + key);
+        }
+    }
+    if (options.duration_s <= 0 || options.settle_s < 0) throw std::runtime_error("Bad --duration or --settle");
+    return options;
+}
+
+std::string executable_dir() {
+    char path[4096] = {};
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) return ".";
+    std::string exe(path, static_cast<size_t>(length));
+    size_t slash = exe.rfind('/');
+    return slash == std::string::npos ? "." : exe.substr(0, slash);
+}
+
+// The base config with this run's settings appended; later keys win
+std::string write_config(const Options& options) {
+    std::ifstream base;
+    for (const std::string& path : {options.config_file, "../" + options.config_file, "../../" + options.config_file}) {
+        base.open(path);
+        if (base.is_open()) break;
+        base.clear();
+    }
+    if (!base.is_open()) throw std::runtime_error("Cannot open " + options.config_file);
+
+    std::string path = options.work_dir + "/pipeline_load.conf";
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out << base.rdbuf()
+        << "\n# pipeline_load_bench\n"
+        << "market_data.source=load\n"
+        << "market_data.load_rate=" << options.rate << "\n"
+        << "market_data.load_symbols=" << options.symbols << "\n"
+        << "market_data.load_profile=" << options.profile << "\n"
+        << "market_data.load_seed=" << options.seed << "\n"
+        << "trading.enabled=false\n"
+        << "trading.paper_mode=true\n"
+        << "timing.order_execution_min_delay_ms=0\n"
+        << "timing.order_execution_max_delay_ms=0\n"
+        << "timing.config_reload_check_ms=0\n"
+        << "risk.max_orders_per_second=0\n"
+        << "journal.directory=" << options.work_dir << "/journal\n"
+        << "capture.enabled=false\n"
+        << "zmq.endpoint_scheme=" << options.scheme << "\n"
+        << "zmq.ipc_dir=" << options.work_dir << "\n";
+    for (const std::string& line : options.overrides) out << line << "\n";
+    return path;
+}
+
+// The services under test, as child processes; stopped on destruction
+class ServiceSet {
+public:
+    ~ServiceSet() { stop(); }
+
+    void launch(const std::string& name, const std::string& binary, const std::string& config,
+                const std::string& log) {
+        if (access(binary.c_str(), X_OK) != 0) throw std::runtime_error("No executable " + binary);
+        pid_t pid = fork();
+        if (pid < 0) throw std::runtime_error("fork failed: " + std::string(std::strerror(errno)));
+        if (pid == 0) {
+            int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd >= 0) {
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+            execl(binary.c_str(), binary.c_str(), config.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        services_.push_back({name, log, pid});
+    }
+
+    // Name of the first service found to have exited, if any
+    std::string exited() {
+        for (auto& service : services_) {
+            int status;
+            if (service.pid > 0 && waitpid(service.pid, &status, WNOHANG) == service.pid) {
+                service.pid = -1;
+                return service.name + " (see " + service.log + ")";
+            }
+        }
+        return "";
+    }
+
+    // SIGINT in reverse launch order, SIGKILL for anything still up after
+    // the timeout
+    void stop() {
+        for (auto it = services_.rbegin(); it != services_.rend(); ++it) {
+            if (it->pid > 0) kill(it->pid, SIGINT);
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(STOP_TIMEOUT_MS);
+        for (auto& service : services_) {
+            while (service.pid > 0) {
+                int status;
+                if (waitpid(service.pid, &status, WNOHANG) == service.pid) {
+                    service.pid = -1;
+                } else if (std::chrono::steady_clock::now() >= deadline) {
+                    std::cerr << "[PipelineLoadBench] " << service.name << " did not stop; killing" << std::endl;
+                    kill(service.pid, SIGKILL);
+                    waitpid(service.pid, &status, 0);
+                    service.pid = -1;
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+        }
+    }
+
+private:
+    struct Service {
+        std::string name;
+        std::string log;
+        pid_t pid;
+    };
+    std::vector<Service> services_;
+};
+
+// Ticks count when their FEED_RECEIVE stamp falls in [start, end)
+struct Window {
+    std::atomic<uint64_t> first_ticks{0};    // First quote seen; the generator's time zero
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+
+    bool contains(const TraceContext& trace) const {
+        uint64_t receive = trace.tsc[static_cast<size_t>(TraceStage::FEED_RECEIVE)];
+        uint64_t from = start.load(std::memory_order_acquire);
+        return from != 0 && receive >= from && receive < end.load(std::memory_order_relaxed);
+    }
+};
+
+struct FlowStats {
+    uint64_t signals = 0;              // BUY/SELL signals: each should come back as a fill or a reject
+    uint64_t quote_updates = 0;        // MODIFY signals; the gateway may coalesce these
+    uint64_t fills = 0;
+    uint64_t rejects = 0;
+    uint64_t positions = 0;
+    std::unordered_map<uint64_t, uint32_t> unanswered;     // Signal trace ID -> count
+
+    HistogramSnapshot tick_to_order;   // FEED_RECEIVE -> GATEWAY_SEND
+    HistogramSnapshot tick_to_ack;     // FEED_RECEIVE -> GATEWAY_ACK
+    HistogramSnapshot feed;            // FEED_RECEIVE -> FEED_PUBLISH
+    HistogramSnapshot bus_to_strategy; // FEED_PUBLISH -> STRATEGY_DECISION
+    HistogramSnapshot strategy_to_risk;// STRATEGY_DECISION -> RISK_CHECK
+    HistogramSnapshot risk_to_send;    // RISK_CHECK -> GATEWAY_SEND
+
+    uint64_t signal_drops() const {
+        uint64_t drops = 0;
+        for (const auto& entry : unanswered) drops += entry.second;
+        return drops;
+    }
+};
+
+std::unique_ptr<IMessageSubscriber> subscribe(const std::string& endpoint) {
+    auto subscriber = TransportFactory::open_subscriber(zmq_subscriber_config(zmq_data_endpoint(endpoint)));
+    subscriber->subscribe("");
+    return subscriber;
+}
+
+// Counts quotes through the feed. Frames are counted whole: a batch is
+// windowed by its first quote's receive stamp, and never unpacked, since
+// this process has none of the services' symbol IDs.
+void count_quotes(Window& window, std::atomic<bool>& running, uint64_t& quotes) {
+    auto subscriber = subscribe(StaticConfig::get_market_data_endpoint());
+    MarketDataFrame frame;
+    while (running.load(std::memory_order_relaxed)) {
+        size_t size = sizeof(frame);
+        if (!subscriber->receive(&frame, size, true)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const TraceContext* trace = nullptr;
+        uint64_t count = 0;
+        if (size == sizeof(MarketData) && frame.header.type == MessageType::MARKET_DATA) {
+            trace = &frame.quote.trace;
+            count = 1;
+        } else if (size >= offsetof(MarketDataBatch, records) && frame.header.type == MessageType::MARKET_DATA_BATCH &&
+                   frame.batch.count <= MarketDataBatch::MAX_RECORDS && size == frame.batch.wire_size()) {
+            trace = &frame.batch.trace;
+            count = frame.batch.count;
+        }
+        if (!trace) continue;
+
+        uint64_t expected = 0;
+        window.first_ticks.compare_exchange_strong(expected, trace->tsc[static_cast<size_t>(TraceStage::FEED_RECEIVE)],
+                                                   std::memory_order_acq_rel);
+        if (window.contains(*trace)) quotes += count;
+    }
+}
+
+void record_stage(HistogramSnapshot& histogram, const TraceContext& trace, TraceStage from, TraceStage to) {
+    if (uint64_t ns = trace.elapsed_ns(from, to)) histogram.record(ns);
+}
+
+// Follows signals, executions and positions; latencies come from the
+// traces of the fills
+void follow_orders(Window& window, std::atomic<bool>& running, FlowStats& stats) {
+    auto signals = subscribe(StaticConfig::get_signals_endpoint());
+    auto executions = subscribe(StaticConfig::get_executions_endpoint());
+    auto positions = subscribe(StaticConfig::get_positions_endpoint());
+
+    TradingSignal signal;
+    OrderExecution execution;
+    PositionUpdate position;
+    while (running.load(std::memory_order_relaxed)) {
+        bool received = false;
+
+        size_t size = sizeof(signal);
+        if (signals->receive(&signal, size, true) && size == sizeof(TradingSignal)) {
+            received = true;
+            if (window.contains(signal.trace)) {
+                if (signal.action == SignalAction::MODIFY) {
+                    stats.quote_updates++;
+                } else {
+                    stats.signals++;
+                    stats.unanswered[signal.trace.trace_id]++;
+                }
+            }
+        }
+
+        size = sizeof(execution);
+        if (executions->receive(&execution, size, true) && size == sizeof(OrderExecution)) {
+            received = true;
+            if (window.contains(execution.trace)) {
+                // Answers a signal whether it filled or was refused
+                auto it = stats.unanswered.find(execution.trace.trace_id);
+                if (it != stats.unanswered.end() && --it->second == 0) stats.unanswered.erase(it);
+
+                if (execution.exec_type == ExecutionType::REJECTED) {
+                    stats.rejects++;
+                } else {
+                    stats.fills++;
+                    const TraceContext& trace = execution.trace;
+                    record_stage(stats.tick_to_order, trace, TraceStage::FEED_RECEIVE, TraceStage::GATEWAY_SEND);
+                    record_stage(stats.tick_to_ack, trace, TraceStage::FEED_RECEIVE, TraceStage::GATEWAY_ACK);
+                    record_stage(stats.feed, trace, TraceStage::FEED_RECEIVE, TraceStage::FEED_PUBLISH);
+                    record_stage(stats.bus_to_strategy, trace, TraceStage::FEED_PUBLISH, TraceStage::STRATEGY_DECISION);
+                    record_stage(stats.strategy_to_risk, trace, TraceStage::STRATEGY_DECISION, TraceStage::RISK_CHECK);
+                    record_stage(stats.risk_to_send, trace, TraceStage::RISK_CHECK, TraceStage::GATEWAY_SEND);
+                }
+            }
+        }
+
+        // Risk limit pushes share the bus; only position updates are counted
+        size = sizeof(position);
+        if (positions->receive(&position, size, true) && size == sizeof(PositionUpdate)) {
+            received = true;
+            if (window.start.load(std::memory_order_acquire) != 0) stats.positions++;
+        }
+
+        if (!received) std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Quotes the generator owes between from_ns and to_ns of its clock
+double offered_quotes(const Options& options, uint64_t from_ns, uint64_t to_ns) {
+    LoadProfile profile = LoadProfile::FLAT;
+    parse_load_profile(options.profile, profile);
+    double offered = 0.0;
+    for (uint64_t t = from_ns; t < to_ns; t += OFFERED_STEP_NS) {
+        uint64_t step = std::min(OFFERED_STEP_NS, to_ns - t);
+        offered += static_cast<double>(options.rate) * load_rate_multiplier(profile, t) * static_cast<double>(step) * 1e-9;
+    }
+    return offered;
+}
+
+void write_latency(std::ostream& out, const HistogramSnapshot& latency) {
+    out << "{\"count\":" << latency.total
+        << ",\"min\":" << (latency.empty() ? 0 : latency.min_value)
+        << ",\"p50\":" << latency.percentile(0.50)
+        << ",\"p90\":" << latency.percentile(0.90)
+        << ",\"p99\":" << latency.percentile(0.99)
+        << ",\"p999\":" << latency.percentile(0.999)
+        << ",\"max\":" << latency.max_value
+        << ",\"mean\":" << (latency.empty() ? 0 : latency.sum / latency.total) << "}";
+}
+
+struct SloCheck {
+    std::string name;
+    double limit;
+    double actual;
+    bool passed;
+};
+
+std::vector<SloCheck> check_slos(const Options& options, const FlowStats& stats, double quotes_per_sec,
+                                 double quote_drop_ratio, double signal_drop_ratio) {
+    std::vector<SloCheck> checks;
+    // No fills at all fails a latency SLO rather than passing it vacuously
+    auto latency = [&](const char* name, double limit_us, double q) {
+        if (limit_us <= 0) return;
+        double actual = stats.tick_to_order.empty() ? -1.0 : stats.tick_to_order.percentile(q) / 1000.0;
+        checks.push_back({name, limit_us, actual, actual >= 0 && actual <= limit_us});
+    };
+    latency("tick_to_order_p50_us", options.slo_p50_us, 0.50);
+    latency("tick_to_order_p99_us", options.slo_p99_us, 0.99);
+    latency("tick_to_order_p999_us", options.slo_p999_us, 0.999);
+    if (options.slo_min_rate > 0) {
+        checks.push_back({"quotes_per_sec", options.slo_min_rate, quotes_per_sec, quotes_per_sec >= options.slo_min_rate});
+    }
+    // A negative limit turns the drop checks off
+    if (options.slo_max_drop_ratio >= 0) {
+        checks.push_back({"quote_drop_ratio", options.slo_max_drop_ratio, quote_drop_ratio,
+                          quote_drop_ratio <= options.slo_max_drop_ratio});
+        checks.push_back({"signal_drop_ratio", options.slo_max_drop_ratio, signal_drop_ratio,
+                          signal_drop_ratio <= options.slo_max_drop_ratio});
+    }
+    return checks;
+}
+
+std::string run_record(const Options& options) {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    std::ostringstream out;
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"run\""
+        << ",\"unix_time\":" << std::time(nullptr)
+        << ",\"host\":\"" << host << "\""
+        << ",\"cpus\":" << std::thread::hardware_concurrency()
+        << ",\"tsc_hz\":" << HighResTimer::get_tsc_frequency()
+        << ",\"tsc_invariant\":" << (HighResTimer::is_tsc_invariant() ? "true" : "false")
+        << ",\"rate\":" << options.rate
+        << ",\"symbols\":" << options.symbols
+        << ",\"profile\":\"" << options.profile << "\""
+        << ",\"seed\":" << options.seed
+        << ",\"duration_s\":" << options.duration_s
+        << ",\"settle_s\":" << options.settle_s
+        << ",\"scheme\":\"" << options.scheme << "\"}";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "[PipelineLoadBench] " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Results own stdout; console logging from the config and transports
+    // joins the summary on stderr
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    if (options.bin_dir.empty()) options.bin_dir = executable_dir();
+    if (options.work_dir.empty()) {
+        char work[] = "/tmp/hft-load-XXXXXX";
+        if (!mkdtemp(work)) {
+            std::cerr << "[PipelineLoadBench] Cannot create a work directory" << std::endl;
+            return 1;
+        }
+        options.work_dir = work;
+    }
+
+    std::ofstream file;
+    if (!options.output_file.empty()) {
+        file.open(options.output_file, std::ios::app);
+        if (!file) {
+            std::cerr << "[PipelineLoadBench] Cannot open " << options.output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_file.empty() ? results : file;
+
+    ServiceSet services;
+    Window window;
+    std::atomic<bool> running{true};
+    uint64_t quotes = 0;
+    FlowStats stats;
+    std::thread quote_thread;
+    std::thread order_thread;
+    auto join = [&]() {
+        running.store(false);
+        if (quote_thread.joinable()) quote_thread.join();
+        if (order_thread.joinable()) order_thread.join();
+    };
+
+    try {
+        std::string config = write_config(options);
+        if (!StaticConfig::load_from_file(config.c_str())) throw std::runtime_error("Cannot load " + config);
+        HighResTimer::initialize();
+        std::cerr << "[PipelineLoadBench] " << options.rate << " quotes/s " << options.profile << " over "
+                  << options.symbols << " symbols; config and logs in " << options.work_dir << std::endl;
+
+        // Subscribed before anything publishes
+        quote_thread = std::thread(count_quotes, std::ref(window), std::ref(running), std::ref(quotes));
+        order_thread = std::thread(follow_orders, std::ref(window), std::ref(running), std::ref(stats));
+
+        for (const char* service : SERVICES) {
+            services.launch(service, options.bin_dir + "/" + service, config,
+                            options.work_dir + "/" + service + ".log");
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(FIRST_QUOTE_TIMEOUT_S);
+        while (window.first_ticks.load(std::memory_order_acquire) == 0) {
+            std::string exited = services.exited();
+            if (!exited.empty()) throw std::runtime_error(exited + " exited during startup");
+            if (std::chrono::steady_clock::now() >= deadline) throw std::runtime_error("No market data within timeout");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        uint64_t first = window.first_ticks.load(std::memory_order_acquire);
+        uint64_t ticks_per_second = HighResTimer::get_tsc_frequency();
+        window.end.store(first + (options.settle_s + options.duration_s) * ticks_per_second, std::memory_order_relaxed);
+        window.start.store(first + options.settle_s * ticks_per_second, std::memory_order_release);
+
+        // Through the window, then long enough for its last orders to come back
+        auto window_end = std::chrono::steady_clock::now() +
+            std::chrono::seconds(options.settle_s + options.duration_s) + std::chrono::milliseconds(options.drain_ms);
+        while (std::chrono::steady_clock::now() < window_end) {
+            std::string exited = services.exited();
+            if (!exited.empty()) throw std::runtime_error(exited + " exited under load");
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        join();
+        services.stop();
+    } catch (const std::exception& e) {
+        join();
+        std::cerr << "[PipelineLoadBench] " << e.what() << std::endl;
+        return 1;
+    }
+
+    uint64_t from_ns = static_cast<uint64_t>(options.settle_s) * 1'000'000'000ULL;
+    uint64_t to_ns = from_ns + static_cast<uint64_t>(options.duration_s) * 1'000'000'000ULL;
+    uint64_t offered = static_cast<uint64_t>(offered_quotes(options, from_ns, to_ns));
+    uint64_t quote_drops = offered > quotes ? offered - quotes : 0;
+    uint64_t signal_drops = stats.signal_drops();
+    double quotes_per_sec = static_cast<double>(quotes) / options.duration_s;
+    double orders_per_sec = static_cast<double>(stats.fills) / options.duration_s;
+    double quote_drop_ratio = offered > 0 ? static_cast<double>(quote_drops) / offered : 0.0;
+    double signal_drop_ratio = stats.signals > 0 ? static_cast<double>(signal_drops) / stats.signals : 0.0;
+    auto checks = check_slos(options, stats, quotes_per_sec, quote_drop_ratio, signal_drop_ratio);
+    bool passed = true;
+    for (const auto& check : checks) passed = passed && check.passed;
+
+    out << run_record(options) << std::endl;
+    std::ostringstream record;
+    record << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"result\""
+           << ",\"offered\":" << offered
+           << ",\"quotes\":" << quotes
+           << ",\"quote_drops\":" << quote_drops
+           << ",\"signals\":" << stats.signals
+           << ",\"signal_drops\":" << signal_drops
+           << ",\"quote_updates\":" << stats.quote_updates
+           << ",\"fills\":" << stats.fills
+           << ",\"rejects\":" << stats.rejects
+           << ",\"positions\":" << stats.positions
+           << ",\"quotes_per_sec\":" << static_cast<uint64_t>(quotes_per_sec)
+           << ",\"orders_per_sec\":" << orders_per_sec
+           << ",\"tick_to_order_ns\":";
+    write_latency(record, stats.tick_to_order);
+    record << ",\"tick_to_ack_ns\":";
+    write_latency(record, stats.tick_to_ack);
+    record << ",\"stages_ns\":{\"feed\":";
+    write_latency(record, stats.feed);
+    record << ",\"bus_to_strategy\":";
+    write_latency(record, stats.bus_to_strategy);
+    record << ",\"strategy_to_risk\":";
+    write_latency(record, stats.strategy_to_risk);
+    record << ",\"risk_to_send\":";
+    write_latency(record, stats.risk_to_send);
+    record << "},\"slo\":[";
+    for (size_t i = 0; i < checks.size(); ++i) {
+        record << (i ? "," : "") << "{\"name\":\"" << checks[i].name << "\",\"limit\":" << checks[i].limit
+               << ",\"actual\":" << checks[i].actual << ",\"passed\":" << (checks[i].passed ? "true" : "false") << "}";
+    }
+    record << "],\"passed\":" << (passed ? "true" : "false") << "}";
+    out << record.str() << std::endl;
+
+    std::cerr << "[PipelineLoadBench] quotes " << quotes << "/" << offered << " offered ("
+              << static_cast<uint64_t>(quotes_per_sec) << "/s), signals " << stats.signals
+              << " (" << signal_drops << " unanswered), fills " << stats.fills << ", rejects " << stats.rejects
+              << std::endl;
+    std::cerr << "[PipelineLoadBench] tick-to-order p50=" << stats.tick_to_order.percentile(0.50)
+              << "ns p99=" << stats.tick_to_order.percentile(0.99)
+              << "ns p99.9=" << stats.tick_to_order.percentile(0.999) << "ns over "
+              << stats.tick_to_order.total << " orders" << std::endl;
+    for (const auto& check : checks) {
+        std::cerr << "[PipelineLoadBench] " << (check.passed ? "PASS " : "FAIL ") << check.name
+                  << " " << check.actual << " (limit " << check.limit << ")" << std::endl;
+    }
+    return passed ? 0 : 2;
+}
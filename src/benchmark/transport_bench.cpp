@@ -0,0 +1,711 @@
+// Transport microbenchmarks: one-way latency, throughput, fan-out and
+// slow-consumer behaviour of every TransportType, measured in one process
+// with TSC timestamps carried in each message. Results go out as JSON lines
+// (one "run" record, then one "result" record per scenario) so successive
+// releases can be diffed; a short summary goes to stderr.
+//
+// Usage: transport_bench [--transports zeromq,spmc,shmem,rmcast]
+//                        [--scenarios latency,throughput,fanout,slow_consumer]
+//                        [--messages N] [--interval-ns N] [--slow-work-ns N]
+//                        [--cpus 2,3,4,...] [--config file] [--output file]
+//                        [--zmq-endpoint inproc://...|ipc://...|tcp://...]
+//                        [--rmcast-endpoint rmcast://<group>:<port>]
+//
+// Threads are pinned from thread.transport_bench.producer and
+// thread.transport_bench.consumer.<n> in the config, else round-robin over
+// --cpus (producer first), else not at all. ZeroMQ sockets take their HWM,
+// linger and zero-copy settings from the zmq.* config keys; multicast sends
+// and joins on the multicast.interface the config names.
+
+#include "../common/zmq_transport.h"
+#include "../common/shm_transport.h"
+#include "../common/spmc_transport.h"
+#include "../common/multicast_transport.h"
+#include "../common/high_res_timer.h"
+#include "../common/latency_histogram.h"
+#include "../common/cpu_topology.h"
+#include "../common/static_config.h"
+#include "../common/message_types.h"
+#include "../common/order_book.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace hft;
+
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+constexpr size_t MAX_MESSAGE_SIZE = 1024;
+constexpr uint64_t PROBE_SEQUENCE = UINT64_MAX;       // Join handshake, never measured
+constexpr uint64_t IDLE_EXIT_NS = 200'000'000;        // Consumer gives up this long after the producer
+constexpr uint64_t JOIN_TIMEOUT_NS = 5'000'000'000;
+
+// Leading bytes of every benchmark message; the rest is padding
+struct Stamp {
+    uint64_t sequence;
+    uint64_t sent_ticks;
+};
+
+struct Scenario {
+    std::string name;
+    size_t message_size = sizeof(MarketData);
+    int consumers = 1;
+    uint64_t messages = 0;
+    uint64_t interval_ns = 0;          // Producer pacing; 0 sends flat out
+    uint64_t slow_work_ns = 0;         // Extra work per message on consumer 0
+    SlowConsumerPolicy policy = SlowConsumerPolicy::BLOCK;
+    bool policy_applies = false;       // Only SPMC has a selectable policy
+};
+
+struct ConsumerResult {
+    HistogramSnapshot latency;         // Messages after the warmup share
+    uint64_t received = 0;
+    uint64_t gaps = 0;                 // Sequence numbers skipped (dropped or lapped)
+    uint64_t first_ticks = 0;
+    uint64_t last_ticks = 0;
+};
+
+struct RunResult {
+    uint64_t sent = 0;
+    uint64_t send_retries = 0;         // Non-blocking sends refused for lack of space
+    uint64_t producer_ns = 0;
+    uint64_t transport_drops = 0;      // Laps (SPMC) or evictions (shmem) the transport counted
+    std::vector<ConsumerResult> consumers;
+};
+
+using StampFn = std::function<void(const Stamp&)>;
+
+// One transport under test. open() builds the producer and every consumer on
+// the calling thread; send() is then only called from the producer thread and
+// poll(i) only from consumer i's thread.
+class BenchTransport {
+public:
+    virtual ~BenchTransport() = default;
+    virtual TransportType type() const = 0;
+    virtual int max_consumers() const = 0;
+    virtual void open(const Scenario& scenario) = 0;
+    virtual bool send(const void* data, size_t size) = 0;
+    // Hands up to a batch of ready messages to fn; returns how many
+    virtual size_t poll(int consumer, const StampFn& fn) = 0;
+    virtual uint64_t transport_drops() const { return 0; }
+    virtual void close() = 0;
+};
+
+// PUB/SUB on the process context; drops at the high water mark
+class ZmqBench : public BenchTransport {
+public:
+    explicit ZmqBench(std::string endpoint) : endpoint_(std::move(endpoint)) {}
+
+    TransportType type() const override { return TransportType::ZEROMQ; }
+    int max_consumers() const override { return 32; }
+
+    void open(const Scenario& scenario) override {
+        publisher_ = TransportFactory::open_publisher(zmq_publisher_config(endpoint_));
+        subscribers_.clear();
+        buffers_.assign(scenario.consumers, std::vector<char>(MAX_MESSAGE_SIZE));
+        for (int i = 0; i < scenario.consumers; ++i) {
+            subscribers_.push_back(TransportFactory::open_subscriber(zmq_subscriber_config(endpoint_)));
+        }
+    }
+
+    bool send(const void* data, size_t size) override {
+        return publisher_->publish(data, size);
+    }
+
+    size_t poll(int consumer, const StampFn& fn) override {
+        char* buffer = buffers_[consumer].data();
+        size_t count = 0;
+        for (; count < 64; ++count) {
+            size_t size = MAX_MESSAGE_SIZE;
+            if (!subscribers_[consumer]->receive(buffer, size, true)) break;
+            Stamp stamp;
+            std::memcpy(&stamp, buffer, sizeof(stamp));
+            fn(stamp);
+        }
+        return count;
+    }
+
+    void close() override {
+        for (auto& subscriber : subscribers_) subscriber->close();
+        subscribers_.clear();
+        if (publisher_) publisher_->close();
+        publisher_.reset();
+    }
+
+private:
+    std::string endpoint_;
+    std::unique_ptr<IMessagePublisher> publisher_;
+    std::vector<std::unique_ptr<IMessageSubscriber>> subscribers_;
+    std::vector<std::vector<char>> buffers_;
+};
+
+// In-process ring; consumers read records in place through read_batch
+class SpmcBench : public BenchTransport {
+public:
+    using Ring = SPMCTransport<4 * 1024 * 1024>;
+
+    TransportType type() const override { return TransportType::SPMC_RING; }
+    int max_consumers() const override { return 32; }
+
+    void open(const Scenario& scenario) override {
+        TransportConfig config(TransportType::SPMC_RING, TransportPattern::PUBLISH_SUBSCRIBE,
+                               "bind:inproc://transport-bench");
+        config.slow_consumer_policy = scenario.policy;
+        ring_ = std::make_unique<Ring>();
+        if (!ring_->initialize(config)) {
+            throw std::runtime_error("Cannot initialize SPMC ring");
+        }
+        consumer_ids_.clear();
+        for (int i = 0; i < scenario.consumers; ++i) {
+            uint32_t id = ring_->register_consumer();
+            if (id == UINT32_MAX) throw std::runtime_error("SPMC ring is out of consumer slots");
+            consumer_ids_.push_back(id);
+        }
+    }
+
+    bool send(const void* data, size_t size) override {
+        return ring_->send(data, size, true);
+    }
+
+    size_t poll(int consumer, const StampFn& fn) override {
+        uint32_t id = consumer_ids_[consumer];
+        MessageSpan spans[64];
+        Stamp stamps[64];
+        size_t count = ring_->read_batch(id, spans, 64);
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(&stamps[i], spans[i].data, sizeof(Stamp));
+        }
+        // A lapped batch may be torn; the ring has already resynced the cursor
+        if (count == 0 || !ring_->release_batch(id)) return 0;
+        for (size_t i = 0; i < count; ++i) fn(stamps[i]);
+        return count;
+    }
+
+    uint64_t transport_drops() const override {
+        uint64_t lapped = 0;
+        for (uint32_t id : consumer_ids_) lapped += ring_->get_lapped_messages(id);
+        return lapped;
+    }
+
+    void close() override {
+        if (!ring_) return;
+        for (uint32_t id : consumer_ids_) ring_->unregister_consumer(id);
+        consumer_ids_.clear();
+        ring_->close();
+        ring_.reset();
+    }
+
+private:
+    std::unique_ptr<Ring> ring_;
+    std::vector<uint32_t> consumer_ids_;
+};
+
+// POSIX shared-memory segment; the producer waits for the slowest consumer
+// until that one is evicted
+class ShmBench : public BenchTransport {
+public:
+    TransportType type() const override { return TransportType::SHARED_MEMORY; }
+    int max_consumers() const override { return static_cast<int>(shm::MAX_CONSUMERS); }
+
+    void open(const Scenario& scenario) override {
+        TransportConfig config(TransportType::SHARED_MEMORY, TransportPattern::PUBLISH_SUBSCRIBE, ENDPOINT);
+        config.buffer_size = 4 * 1024 * 1024;
+        ShmTransport::unlink_segment(ENDPOINT);
+        publisher_ = TransportFactory::open_publisher(config);
+        subscribers_.clear();
+        buffers_.assign(scenario.consumers, std::vector<char>(MAX_MESSAGE_SIZE));
+        for (int i = 0; i < scenario.consumers; ++i) {
+            subscribers_.push_back(TransportFactory::open_subscriber(config));
+        }
+    }
+
+    bool send(const void* data, size_t size) override {
+        return publisher_->publish(data, size);
+    }
+
+    size_t poll(int consumer, const StampFn& fn) override {
+        char* buffer = buffers_[consumer].data();
+        size_t count = 0;
+        for (; count < 64; ++count) {
+            size_t size = MAX_MESSAGE_SIZE;
+            if (!subscribers_[consumer]->receive(buffer, size, true)) break;
+            Stamp stamp;
+            std::memcpy(&stamp, buffer, sizeof(stamp));
+            fn(stamp);
+        }
+        return count;
+    }
+
+    uint64_t transport_drops() const override {
+        auto* producer = dynamic_cast<ShmTransport*>(publisher_.get());
+        return producer ? producer->get_slow_consumer_evictions() : 0;
+    }
+
+    void close() override {
+        for (auto& subscriber : subscribers_) subscriber->close();
+        subscribers_.clear();
+        if (publisher_) publisher_->close();
+        publisher_.reset();
+        ShmTransport::unlink_segment(ENDPOINT);
+    }
+
+private:
+    static constexpr const char* ENDPOINT = "shm://hft-transport-bench";
+    std::unique_ptr<IMessagePublisher> publisher_;
+    std::vector<std::unique_ptr<IMessageSubscriber>> subscribers_;
+    std::vector<std::vector<char>> buffers_;
+};
+
+// UDP multicast with NAK repair; every consumer is its own group member,
+// and messages the repair gave up on count as drops
+class MulticastBench : public BenchTransport {
+public:
+    explicit MulticastBench(std::string endpoint) : endpoint_(std::move(endpoint)) {}
+
+    TransportType type() const override { return TransportType::RELIABLE_MULTICAST; }
+    int max_consumers() const override { return 32; }
+
+    void open(const Scenario& scenario) override {
+        TransportConfig config = multicast_config(endpoint_);
+        subscribers_.clear();
+        buffers_.assign(scenario.consumers, std::vector<char>(MAX_MESSAGE_SIZE));
+        for (int i = 0; i < scenario.consumers; ++i) {
+            auto subscriber = std::make_unique<RmcastSubscriber>();
+            if (!subscriber->initialize(config) || !subscriber->connect(endpoint_)) {
+                throw std::runtime_error("Cannot join " + endpoint_);
+            }
+            subscribers_.push_back(std::move(subscriber));
+        }
+        publisher_ = std::make_unique<RmcastPublisher>();
+        if (!publisher_->initialize(config) || !publisher_->bind(endpoint_)) {
+            throw std::runtime_error("Cannot publish to " + endpoint_);
+        }
+    }
+
+    bool send(const void* data, size_t size) override {
+        return publisher_->publish(data, size);
+    }
+
+    size_t poll(int consumer, const StampFn& fn) override {
+        char* buffer = buffers_[consumer].data();
+        size_t count = 0;
+        for (; count < 64; ++count) {
+            size_t size = MAX_MESSAGE_SIZE;
+            if (!subscribers_[consumer]->receive(buffer, size, true)) break;
+            Stamp stamp;
+            std::memcpy(&stamp, buffer, sizeof(stamp));
+            fn(stamp);
+        }
+        return count;
+    }
+
+    // Consumer threads have joined by now, so their stats are safe to read
+    uint64_t transport_drops() const override {
+        uint64_t lost = 0;
+        for (const auto& subscriber : subscribers_) lost += subscriber->stats().lost;
+        return lost;
+    }
+
+    void close() override {
+        for (auto& subscriber : subscribers_) subscriber->close();
+        subscribers_.clear();
+        if (publisher_) publisher_->close();
+        publisher_.reset();
+    }
+
+private:
+    std::string endpoint_;
+    std::unique_ptr<RmcastPublisher> publisher_;
+    std::vector<std::unique_ptr<RmcastSubscriber>> subscribers_;
+    std::vector<std::vector<char>> buffers_;
+};
+
+struct Options {
+    std::vector<TransportType> transports = TransportFactory::get_supported_types();
+    std::vector<std::string> scenarios = {"latency", "throughput", "fanout", "slow_consumer"};
+    uint64_t messages = 200000;
+    uint64_t interval_ns = 10000;      // Paced scenarios: 100k msg/s
+    uint64_t slow_work_ns = 20000;
+    std::vector<int> cpus;
+    std::string config_file;
+    std::string output_file;
+    std::string zmq_endpoint = "inproc://transport-bench";
+    std::string rmcast_endpoint = "rmcast://239.255.0.1:31000";
+};
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("Missing value for " + key);
+        std::string value = argv[++i];
+        if (key == "--transports") {
+            options.transports.clear();
+            for (const auto& name : split(value)) options.transports.push_back(TransportFactory::parse_type(name));
+        } else if (key == "--scenarios") {
+            options.scenarios = split(value);
+        } else if (key == "--messages") {
+            options.messages = std::stoull(value);
+        } else if (key == "--interval-ns") {
+            options.interval_ns = std::stoull(value);
+        } else if (key == "--slow-work-ns") {
+            options.slow_work_ns = std::stoull(value);
+        } else if (key == "--cpus") {
+            options.cpus = parse_cpu_list(value);
+        } else if (key == "--config") {
+            options.config_file = value;
+        } else if (key == "--output") {
+            options.output_file = value;
+        } else if (key == "--zmq-endpoint") {
+            options.zmq_endpoint = value;
+        } else if (key == "--rmcast-endpoint") {
+            options.rmcast_endpoint = value;
+        } else {
+            throw std::runtime_error("Unknown option " + key);
+        }
+    }
+    return options;
+}
+
+void pin_thread(const Options& options, const std::string& thread, size_t index) {
+    int fallback = -1;
+    if (!options.cpus.empty()) {
+        fallback = (index == 0 || options.cpus.size() == 1)
+            ? options.cpus[0]
+            : options.cpus[1 + (index - 1) % (options.cpus.size() - 1)];
+    }
+    ThreadPlan::instance().pin_current_thread(thread, fallback);
+}
+
+inline void spin_for_ticks(uint64_t ticks) {
+    uint64_t until = HighResTimer::get_ticks() + ticks;
+    while (HighResTimer::get_ticks() < until) HighResTimer::cpu_relax();
+}
+
+RunResult run_scenario(BenchTransport& transport, const Scenario& scenario, const Options& options) {
+    transport.open(scenario);
+
+    const int consumers = scenario.consumers;
+    const uint64_t warmup = scenario.messages / 10;    // Cold caches and lazy connects
+    const uint64_t slow_ticks = HighResTimer::nanoseconds_to_ticks(scenario.slow_work_ns);
+    const bool oversubscribed = static_cast<unsigned>(consumers + 1) > std::thread::hardware_concurrency();
+
+    RunResult result;
+    result.consumers.resize(consumers);
+    std::vector<std::atomic<bool>> joined(consumers);
+    for (auto& flag : joined) flag.store(false);
+    std::atomic<bool> producer_done{false};
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            pin_thread(options, "consumer." + std::to_string(c), static_cast<size_t>(c) + 1);
+            ConsumerResult& out = result.consumers[c];
+            uint64_t expected = 0;
+            uint64_t idle_since = 0;
+            const bool slow = c == 0 && slow_ticks > 0;
+
+            StampFn on_message = [&](const Stamp& stamp) {
+                uint64_t now = HighResTimer::get_ticks();
+                if (stamp.sequence == PROBE_SEQUENCE) {
+                    joined[c].store(true, std::memory_order_release);
+                    return;
+                }
+                if (stamp.sequence > expected) out.gaps += stamp.sequence - expected;
+                expected = stamp.sequence + 1;
+                if (out.received++ == 0) out.first_ticks = now;
+                out.last_ticks = now;
+                if (stamp.sequence >= warmup) {
+                    // Cores can disagree by a few ticks; never report wrapped values
+                    uint64_t ticks = now > stamp.sent_ticks ? now - stamp.sent_ticks : 0;
+                    out.latency.record(HighResTimer::ticks_to_nanoseconds(ticks));
+                }
+                if (slow) spin_for_ticks(slow_ticks);
+            };
+
+            while (expected < scenario.messages) {
+                if (transport.poll(c, on_message) > 0) {
+                    idle_since = 0;
+                    continue;
+                }
+                if (producer_done.load(std::memory_order_acquire)) {
+                    uint64_t now = HighResTimer::get_nanoseconds();
+                    if (idle_since == 0) idle_since = now;
+                    if (now - idle_since > IDLE_EXIT_NS) break;
+                }
+                if (oversubscribed) std::this_thread::yield();
+            }
+        });
+    }
+
+    pin_thread(options, "producer", 0);
+    alignas(64) char payload[MAX_MESSAGE_SIZE] = {};
+    Stamp stamp{PROBE_SEQUENCE, 0};
+
+    // PUB/SUB drops whatever is sent before a subscription lands, so probe
+    // until every consumer has seen one
+    uint64_t join_start = HighResTimer::get_nanoseconds();
+    auto all_joined = [&] {
+        for (auto& flag : joined) {
+            if (!flag.load(std::memory_order_acquire)) return false;
+        }
+        return true;
+    };
+    while (!all_joined()) {
+        std::memcpy(payload, &stamp, sizeof(stamp));
+        transport.send(payload, scenario.message_size);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (HighResTimer::get_nanoseconds() - join_start > JOIN_TIMEOUT_NS) {
+            producer_done.store(true);
+            for (auto& thread : threads) thread.join();
+            transport.close();
+            throw std::runtime_error("Consumers never joined");
+        }
+    }
+
+    const uint64_t interval_ticks = HighResTimer::nanoseconds_to_ticks(scenario.interval_ns);
+    uint64_t start = HighResTimer::get_ticks();
+    uint64_t next_send = start;
+    for (uint64_t seq = 0; seq < scenario.messages; ++seq) {
+        if (interval_ticks > 0) {
+            while (HighResTimer::get_ticks() < next_send) HighResTimer::cpu_relax();
+            next_send += interval_ticks;
+        }
+        stamp.sequence = seq;
+        stamp.sent_ticks = HighResTimer::get_ticks();
+        std::memcpy(payload, &stamp, sizeof(stamp));
+        while (!transport.send(payload, scenario.message_size)) {
+            result.send_retries++;
+            HighResTimer::cpu_relax();
+            // The wait belongs to this message's latency
+            stamp.sent_ticks = HighResTimer::get_ticks();
+            std::memcpy(payload, &stamp, sizeof(stamp));
+        }
+        result.sent++;
+    }
+    result.producer_ns = HighResTimer::ticks_to_nanoseconds(HighResTimer::get_ticks() - start);
+    producer_done.store(true, std::memory_order_release);
+
+    for (auto& thread : threads) thread.join();
+    result.transport_drops = transport.transport_drops();
+    transport.close();
+    return result;
+}
+
+std::vector<Scenario> build_scenarios(const Options& options, const BenchTransport& transport) {
+    const size_t sizes[] = {sizeof(MarketData), sizeof(OrderBookUpdate), MAX_MESSAGE_SIZE};
+    std::vector<Scenario> scenarios;
+
+    for (const auto& name : options.scenarios) {
+        Scenario base;
+        base.name = name;
+        base.messages = options.messages;
+        if (name == "latency" || name == "throughput") {
+            base.interval_ns = name == "latency" ? options.interval_ns : 0;
+            for (size_t size : sizes) {
+                Scenario scenario = base;
+                scenario.message_size = size;
+                scenarios.push_back(scenario);
+            }
+        } else if (name == "fanout") {
+            base.interval_ns = options.interval_ns;
+            for (int consumers = 1; consumers <= 32; consumers *= 2) {
+                if (consumers > transport.max_consumers()) break;
+                Scenario scenario = base;
+                scenario.consumers = consumers;
+                scenarios.push_back(scenario);
+            }
+        } else if (name == "slow_consumer") {
+            // Consumer 0 falls behind at this rate; consumer 1 keeps up. Large
+            // messages so the backlog outgrows every transport's buffering
+            base.consumers = 2;
+            base.message_size = MAX_MESSAGE_SIZE;
+            base.messages = std::max<uint64_t>(options.messages / 10, 1000);
+            base.interval_ns = options.slow_work_ns / 4;
+            base.slow_work_ns = options.slow_work_ns;
+            if (transport.type() == TransportType::SPMC_RING) {
+                for (auto policy : {SlowConsumerPolicy::BLOCK, SlowConsumerPolicy::OVERWRITE}) {
+                    Scenario scenario = base;
+                    scenario.policy = policy;
+                    scenario.policy_applies = true;
+                    scenarios.push_back(scenario);
+                }
+            } else {
+                scenarios.push_back(base);
+            }
+        } else {
+            throw std::runtime_error("Unknown scenario " + name);
+        }
+    }
+    return scenarios;
+}
+
+void write_latency(std::ostream& out, const HistogramSnapshot& latency) {
+    out << "{\"min\":" << (latency.empty() ? 0 : latency.min_value)
+        << ",\"p50\":" << latency.percentile(0.50)
+        << ",\"p90\":" << latency.percentile(0.90)
+        << ",\"p99\":" << latency.percentile(0.99)
+        << ",\"p999\":" << latency.percentile(0.999)
+        << ",\"max\":" << latency.max_value
+        << ",\"mean\":" << (latency.empty() ? 0 : latency.sum / latency.total) << "}";
+}
+
+std::string result_record(TransportType type, const Scenario& scenario, const RunResult& result) {
+    HistogramSnapshot latency;
+    uint64_t received = 0;
+    uint64_t gaps = 0;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    for (const auto& consumer : result.consumers) {
+        latency.merge(consumer.latency);
+        received += consumer.received;
+        gaps += consumer.gaps;
+        if (consumer.received > 0) {
+            first = std::min(first, consumer.first_ticks);
+            last = std::max(last, consumer.last_ticks);
+        }
+    }
+    uint64_t expected = result.sent * result.consumers.size();
+    uint64_t receive_ns = last > first ? HighResTimer::ticks_to_nanoseconds(last - first) : 0;
+    double msgs_per_sec = receive_ns > 0 ? received * 1e9 / static_cast<double>(receive_ns) : 0.0;
+
+    std::ostringstream out;
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"result\""
+        << ",\"transport\":\"" << TransportFactory::get_type_name(type) << "\""
+        << ",\"scenario\":\"" << scenario.name << "\""
+        << ",\"message_size\":" << scenario.message_size
+        << ",\"consumers\":" << scenario.consumers
+        << ",\"policy\":\"" << (!scenario.policy_applies ? "default"
+                                : scenario.policy == SlowConsumerPolicy::BLOCK ? "block" : "overwrite") << "\""
+        << ",\"interval_ns\":" << scenario.interval_ns
+        << ",\"slow_work_ns\":" << scenario.slow_work_ns
+        << ",\"sent\":" << result.sent
+        << ",\"send_retries\":" << result.send_retries
+        << ",\"producer_ns\":" << result.producer_ns
+        << ",\"received\":" << received
+        << ",\"lost\":" << (expected > received ? expected - received : 0)
+        << ",\"gaps\":" << gaps
+        << ",\"transport_drops\":" << result.transport_drops
+        << ",\"msgs_per_sec\":" << static_cast<uint64_t>(msgs_per_sec)
+        << ",\"mb_per_sec\":" << msgs_per_sec * scenario.message_size / 1e6
+        << ",\"latency_ns\":";
+    write_latency(out, latency);
+    out << ",\"per_consumer\":[";
+    for (size_t i = 0; i < result.consumers.size(); ++i) {
+        const auto& consumer = result.consumers[i];
+        out << (i ? "," : "") << "{\"received\":" << consumer.received
+            << ",\"gaps\":" << consumer.gaps << ",\"latency_ns\":";
+        write_latency(out, consumer.latency);
+        out << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string run_record(const Options& options) {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    std::ostringstream out;
+    out << "{\"schema\":" << SCHEMA_VERSION << ",\"record\":\"run\""
+        << ",\"unix_time\":" << std::time(nullptr)
+        << ",\"host\":\"" << host << "\""
+        << ",\"cpus\":" << std::thread::hardware_concurrency()
+        << ",\"tsc_hz\":" << HighResTimer::get_tsc_frequency()
+        << ",\"tsc_invariant\":" << (HighResTimer::is_tsc_invariant() ? "true" : "false")
+        << ",\"pinned\":" << (!options.cpus.empty() || !options.config_file.empty() ? "true" : "false")
+        << ",\"messages\":" << options.messages
+        << ",\"zmq_endpoint\":\"" << options.zmq_endpoint << "\""
+        << ",\"rmcast_endpoint\":\"" << options.rmcast_endpoint << "\"}";
+    return out.str();
+}
+
+std::unique_ptr<BenchTransport> make_bench(TransportType type, const Options& options) {
+    switch (type) {
+        case TransportType::ZEROMQ: return std::make_unique<ZmqBench>(options.zmq_endpoint);
+        case TransportType::SPMC_RING: return std::make_unique<SpmcBench>();
+        case TransportType::SHARED_MEMORY: return std::make_unique<ShmBench>();
+        case TransportType::RELIABLE_MULTICAST: return std::make_unique<MulticastBench>(options.rmcast_endpoint);
+    }
+    throw std::runtime_error("Unsupported transport type");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "[TransportBench] " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Results own stdout; console logging from the timer and transports
+    // joins the summary on stderr
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    if (!options.config_file.empty()) {
+        StaticConfig::load_from_file(options.config_file.c_str());
+    }
+    ThreadPlan::instance().configure("transport_bench");
+    HighResTimer::initialize();
+
+    std::ofstream file;
+    if (!options.output_file.empty()) {
+        file.open(options.output_file, std::ios::app);
+        if (!file) {
+            std::cerr << "[TransportBench] Cannot open " << options.output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output_file.empty() ? results : file;
+    out << run_record(options) << std::endl;
+
+    bool ok = true;
+    for (TransportType type : options.transports) {
+        auto transport = make_bench(type, options);
+        for (const auto& scenario : build_scenarios(options, *transport)) {
+            try {
+                RunResult result = run_scenario(*transport, scenario, options);
+                std::string record = result_record(type, scenario, result);
+                out << record << std::endl;
+
+                HistogramSnapshot latency;
+                for (const auto& consumer : result.consumers) latency.merge(consumer.latency);
+                std::cerr << "[TransportBench] " << TransportFactory::get_type_name(type) << " "
+                          << scenario.name << " size=" << scenario.message_size
+                          << " consumers=" << scenario.consumers
+                          << " p50=" << latency.percentile(0.50) << "ns p99=" << latency.percentile(0.99)
+                          << "ns retries=" << result.send_retries << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "[TransportBench] " << TransportFactory::get_type_name(type) << " "
+                          << scenario.name << " failed: " << e.what() << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
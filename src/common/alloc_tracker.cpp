@@ -0,0 +1,299 @@
+#include "alloc_tracker.h"
+#include "fixed_format.h"
+#include "hft_metrics.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+#ifdef HFT_ALLOC_TRACKING
+#include <cerrno>
+#include <new>
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+std::atomic<uint8_t> g_action{static_cast<uint8_t>(AllocTracker::Action::RECORD)};
+
+#ifdef HFT_ALLOC_TRACKING
+
+// Only the owning thread writes a slot, so counting is a relaxed load and
+// store rather than a locked add; the shared overflow slot pays for one
+struct Slot {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> violations{0};
+    std::atomic<int64_t> tid{0};
+};
+
+Slot g_slots[AllocTracker::MAX_THREADS];
+Slot g_overflow;
+std::atomic<size_t> g_slot_count{0};
+std::atomic<uint64_t> g_reports{0};
+
+// Constant-initialized, so touching it from inside malloc needs no TLS
+// initializer and cannot recurse
+struct ThreadState {
+    Slot* slot;
+    const char* region;         // Innermost NoAllocGuard, nullptr outside any
+    bool reporting;             // Allocations made while reporting are not counted
+};
+constinit thread_local ThreadState t_state{nullptr, nullptr, false};
+
+Slot& current_slot() {
+    if (!t_state.slot) {
+        size_t index = g_slot_count.fetch_add(1, std::memory_order_relaxed);
+        if (index < AllocTracker::MAX_THREADS) {
+            t_state.slot = &g_slots[index];
+            t_state.slot->tid.store(syscall(SYS_gettid), std::memory_order_relaxed);
+        } else {
+            t_state.slot = &g_overflow;
+        }
+    }
+    return *t_state.slot;
+}
+
+void bump(Slot& slot, std::atomic<uint64_t>& counter, uint64_t amount) {
+    if (&slot == &g_overflow) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    } else {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+// Written straight to stderr: no stream, no heap, safe inside malloc
+void report_violation(size_t size, AllocTracker::Action action) {
+    char line[256];
+    FixedWriter out(line, sizeof(line));
+    out << "[NoAllocGuard] " << size << "-byte allocation in " << t_state.region
+        << " on thread " << static_cast<int64_t>(syscall(SYS_gettid))
+        << (action == AllocTracker::Action::ABORT ? ", aborting\n" : "\n");
+    ssize_t ignored = write(STDERR_FILENO, out.c_str(), out.size());
+    (void)ignored;
+
+    void* frames[32];
+    int depth = backtrace(frames, 32);
+    backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+}
+
+void on_allocation(size_t size) {
+    if (t_state.reporting) return;
+    Slot& slot = current_slot();
+    bump(slot, slot.allocations, 1);
+    bump(slot, slot.bytes, size);
+
+    if (!t_state.region) return;
+    auto action = static_cast<AllocTracker::Action>(g_action.load(std::memory_order_relaxed));
+    if (action == AllocTracker::Action::IGNORE) return;
+
+    // backtrace() loads libgcc on first use, which allocates
+    t_state.reporting = true;
+    bump(slot, slot.violations, 1);
+    if (action == AllocTracker::Action::ABORT ||
+        g_reports.fetch_add(1, std::memory_order_relaxed) < AllocTracker::MAX_REPORTS) {
+        report_violation(size, action);
+    }
+    if (action == AllocTracker::Action::ABORT) {
+        std::abort();
+    }
+    t_state.reporting = false;
+}
+
+void on_free() {
+    if (t_state.reporting) return;
+    Slot& slot = current_slot();
+    bump(slot, slot.frees, 1);
+}
+
+AllocTracker::Counts read(const Slot& slot) {
+    AllocTracker::Counts counts;
+    counts.allocations = slot.allocations.load(std::memory_order_relaxed);
+    counts.frees = slot.frees.load(std::memory_order_relaxed);
+    counts.bytes = slot.bytes.load(std::memory_order_relaxed);
+    counts.violations = slot.violations.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void add(AllocTracker::Counts& total, const AllocTracker::Counts& counts) {
+    total.allocations += counts.allocations;
+    total.frees += counts.frees;
+    total.bytes += counts.bytes;
+    total.violations += counts.violations;
+}
+
+#endif // HFT_ALLOC_TRACKING
+
+} // namespace
+
+void AllocTracker::set_action(Action action) {
+    g_action.store(static_cast<uint8_t>(action), std::memory_order_relaxed);
+}
+
+AllocTracker::Action AllocTracker::action() {
+    return static_cast<Action>(g_action.load(std::memory_order_relaxed));
+}
+
+AllocTracker::Action AllocTracker::parse_action(const std::string& name) {
+    if (name == "off") return Action::IGNORE;
+    if (name == "abort") return Action::ABORT;
+    return Action::RECORD;
+}
+
+#ifdef HFT_ALLOC_TRACKING
+
+AllocTracker::Counts AllocTracker::current_thread() {
+    return read(current_slot());
+}
+
+AllocTracker::Counts AllocTracker::process() {
+    Counts total = read(g_overflow);
+    size_t count = std::min(g_slot_count.load(std::memory_order_relaxed), MAX_THREADS);
+    for (size_t i = 0; i < count; ++i) {
+        add(total, read(g_slots[i]));
+    }
+    return total;
+}
+
+void AllocTracker::publish_metrics() {
+    std::map<std::string, Counts> by_name;
+    size_t count = std::min(g_slot_count.load(std::memory_order_relaxed), MAX_THREADS);
+    for (size_t i = 0; i < count; ++i) {
+        int64_t tid = g_slots[i].tid.load(std::memory_order_relaxed);
+        std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+        std::string name;
+        if (tid == 0 || !std::getline(comm, name)) continue;    // Exited, or still claiming
+        add(by_name[name], read(g_slots[i]));
+    }
+    if (g_slot_count.load(std::memory_order_relaxed) > MAX_THREADS) {
+        add(by_name["other"], read(g_overflow));
+    }
+
+    // Only the publisher thread gets here; names are registered once each
+    static std::unordered_map<std::string, std::array<metric_id_t, 4>> ids;
+    auto& collector = MetricsCollector::instance();
+    for (const auto& [name, total] : by_name) {
+        auto it = ids.find(name);
+        if (it == ids.end()) {
+            std::string prefix = "thread." + name;
+            std::replace(prefix.begin(), prefix.end(), ' ', '_');
+            it = ids.emplace(name, std::array<metric_id_t, 4>{
+                collector.register_metric((prefix + metrics::THREAD_ALLOCATIONS_SUFFIX).c_str(), MetricType::GAUGE),
+                collector.register_metric((prefix + metrics::THREAD_FREES_SUFFIX).c_str(), MetricType::GAUGE),
+                collector.register_metric((prefix + metrics::THREAD_ALLOCATED_BYTES_SUFFIX).c_str(), MetricType::GAUGE),
+                collector.register_metric((prefix + metrics::THREAD_ALLOC_VIOLATIONS_SUFFIX).c_str(), MetricType::GAUGE)}).first;
+        }
+        collector.set_gauge(it->second[0], total.allocations);
+        collector.set_gauge(it->second[1], total.frees);
+        collector.set_gauge(it->second[2], total.bytes);
+        collector.set_gauge(it->second[3], total.violations);
+    }
+}
+
+const char* NoAllocGuard::enter(const char* region) {
+    const char* outer = t_state.region;
+    t_state.region = region;
+    return outer;
+}
+
+void NoAllocGuard::leave(const char* outer) {
+    t_state.region = outer;
+}
+
+#else
+
+AllocTracker::Counts AllocTracker::current_thread() { return {}; }
+AllocTracker::Counts AllocTracker::process() { return {}; }
+void AllocTracker::publish_metrics() {}
+
+#endif // HFT_ALLOC_TRACKING
+
+} // namespace hft
+
+#ifdef HFT_ALLOC_TRACKING
+
+#if defined(__GLIBC__)
+
+// glibc's own entry points, so the hooks need no dlsym (which allocates)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size) noexcept {
+    hft::on_allocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    hft::on_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+    // A free and an allocation, even when the block grows in place: it may not
+    if (pointer) hft::on_free();
+    if (size > 0) hft::on_allocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    hft::on_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* pointer = memalign(alignment, size);
+    if (!pointer) {
+        return ENOMEM;
+    }
+    *out = pointer;
+    return 0;
+}
+
+void free(void* pointer) noexcept {
+    if (pointer) hft::on_free();
+    __libc_free(pointer);
+}
+}
+
+#else
+
+// No malloc hooks outside glibc: C++ allocations only
+void* operator new(std::size_t size) {
+    hft::on_allocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer) hft::on_free();
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+#endif // __GLIBC__
+
+#endif // HFT_ALLOC_TRACKING
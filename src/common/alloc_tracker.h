@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hft {
+
+// Heap allocation counts per thread, for keeping live paths allocation-free.
+// Only built in with -DHFT_ALLOC_TRACKING=ON (a debug/benchmark option):
+// hft_common then interposes malloc, calloc, realloc, the aligned variants
+// and free (glibc; operator new reaches them through libstdc++), or replaces
+// operator new/delete elsewhere. Without it nothing is hooked, guards are
+// empty and every count reads 0.
+//
+// Counts go out through MetricsPublisher as thread.<name><suffix> gauges,
+// the name from /proc like the interference gauges; a thread that has
+// exited drops out. Up to MAX_THREADS threads are counted on their own,
+// later ones together as thread.other.
+class AllocTracker {
+public:
+    // What an allocation inside a NoAllocGuard does; profiler.alloc_guard
+    enum class Action : uint8_t {
+        IGNORE,     // Counted like any other
+        RECORD,     // Counted as a violation; the first MAX_REPORTS print a stack trace
+        ABORT       // Print a stack trace and abort()
+    };
+
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        uint64_t bytes = 0;         // Requested, not the allocator's rounding
+        uint64_t violations = 0;    // Allocations inside a NoAllocGuard
+    };
+
+    static constexpr size_t MAX_THREADS = 256;
+    static constexpr uint64_t MAX_REPORTS = 32;
+
+    static constexpr bool enabled() {
+#ifdef HFT_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void set_action(Action action);
+    static Action action();
+    // "off", "record" or "abort"; anything else records
+    static Action parse_action(const std::string& name);
+
+    // The calling thread's totals since it first allocated
+    static Counts current_thread();
+    // Sums over every thread, live or exited
+    static Counts process();
+
+    // Sets the per-thread gauges; MetricsPublisher calls this before each message
+    static void publish_metrics();
+};
+
+// Marks the rest of a scope as allocation-free: an allocation on this
+// thread before it ends is handled as AllocTracker::action() says. Guards
+// nest; reports name the innermost region, which must be a constant.
+class NoAllocGuard {
+public:
+#ifdef HFT_ALLOC_TRACKING
+    explicit NoAllocGuard(const char* region) : outer_(enter(region)) {}
+    ~NoAllocGuard() { leave(outer_); }
+#else
+    explicit NoAllocGuard(const char*) {}
+#endif
+
+    NoAllocGuard(const NoAllocGuard&) = delete;
+    NoAllocGuard& operator=(const NoAllocGuard&) = delete;
+
+#ifdef HFT_ALLOC_TRACKING
+private:
+    static const char* enter(const char* region);
+    static void leave(const char* outer);
+
+    const char* outer_;
+#endif
+};
+
+#define HFT_NO_ALLOC_SCOPE(name) hft::NoAllocGuard _no_alloc_guard(name)
+
+} // namespace hft
@@ -0,0 +1,498 @@
+#include "binary_log.h"
+
+#include <zmq.hpp>
+
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+namespace hft {
+namespace binlog {
+
+namespace {
+
+constexpr size_t BATCH_FLUSH_BYTES = 60 * 1024;
+constexpr auto IDLE_SLEEP = std::chrono::milliseconds(1);
+constexpr auto DEFINITION_REFRESH_INTERVAL = std::chrono::seconds(10);
+
+// Keeps this thread's ring alive until the backend has drained it
+struct RingOwner {
+    std::shared_ptr<ThreadRing> ring;
+    ~RingOwner() {
+        if (ring) ring->retired.store(true, std::memory_order_release);
+    }
+};
+
+class Backend {
+public:
+    static Backend& instance() {
+        static Backend backend;
+        return backend;
+    }
+
+    ~Backend() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (socket_) {
+            socket_->close();
+        }
+    }
+
+    uint32_t register_format(const char* format) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        formats_.emplace_back(format);
+        return static_cast<uint32_t>(formats_.size() - 1);
+    }
+
+    uint16_t register_component(const std::string& name) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (size_t i = 0; i < components_.size(); ++i) {
+            if (components_[i] == name) return static_cast<uint16_t>(i);
+        }
+        components_.push_back(name);
+        return static_cast<uint16_t>(components_.size() - 1);
+    }
+
+    ThreadRing* add_ring() {
+        static thread_local RingOwner owner;
+        if (!owner.ring) {
+            owner.ring = std::make_shared<ThreadRing>();
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(owner.ring);
+        }
+        return owner.ring.get();
+    }
+
+    void start(const std::string& endpoint) {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        if (thread_.joinable()) {
+            return;
+        }
+
+        try {
+            context_ = std::make_unique<zmq::context_t>(1);
+            socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUSH);
+            // Give the last batch at shutdown a moment to reach the logger service
+            int linger = 200;
+            socket_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+            socket_->connect(endpoint);
+        } catch (const zmq::error_t& e) {
+            std::cerr << "[Logger] Failed to connect to " << endpoint << ": " << e.what() << std::endl;
+            socket_.reset();
+        }
+
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread(&Backend::run, this);
+    }
+
+    void flush(std::chrono::milliseconds timeout) {
+        if (!thread_.joinable()) {
+            return;
+        }
+        // Two full passes guarantee one started after this call
+        uint64_t target = cycles_.load(std::memory_order_acquire) + 2;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (cycles_.load(std::memory_order_acquire) < target && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void note_dropped() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    Backend()
+        : formats_{"{}"}
+        , source_pid_(static_cast<uint32_t>(getpid()))
+        , source_start_ns_(now_ns()) {
+        batch_.reserve(BATCH_FLUSH_BYTES + MAX_RECORD_SIZE * 2);
+        reset_batch();
+    }
+
+    // Registry (any thread, under registry_mutex_)
+    std::mutex registry_mutex_;
+    std::vector<std::string> formats_;
+    std::vector<std::string> components_;
+
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+
+    std::mutex start_mutex_;
+    std::unique_ptr<zmq::context_t> context_;
+    std::unique_ptr<zmq::socket_t> socket_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> cycles_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    // Backend thread only
+    const uint32_t source_pid_;
+    const int64_t source_start_ns_;
+    std::vector<char> batch_;
+    std::vector<std::string> local_formats_;        // Copies, so rendering needs no lock
+    std::vector<std::string> local_components_;
+    std::vector<bool> format_sent_;
+    std::vector<bool> component_sent_;
+    uint64_t dropped_sent_ = 0;
+    std::string line_;
+    std::string message_;
+
+    void run() {
+        auto last_refresh = std::chrono::steady_clock::now();
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+
+        while (true) {
+            bool stopping = !running_.load(std::memory_order_acquire);
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings = rings_;
+            }
+
+            size_t drained = 0;
+            for (auto& ring : rings) {
+                drained += ring->drain([this](const char* record, size_t size) {
+                    handle_record(record, size);
+                    return true;
+                });
+            }
+            send_batch();
+            if (drained > 0) {
+                std::fflush(stdout);
+            }
+
+            // Threads that have exited leave empty rings behind
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const auto& ring) {
+                    return ring->retired.load(std::memory_order_acquire) && ring->empty();
+                }), rings_.end());
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_refresh >= DEFINITION_REFRESH_INTERVAL) {
+                // The logger service may have rotated files; announce everything again
+                std::fill(format_sent_.begin(), format_sent_.end(), false);
+                std::fill(component_sent_.begin(), component_sent_.end(), false);
+                last_refresh = now;
+            }
+
+            cycles_.fetch_add(1, std::memory_order_release);
+            if (stopping) {
+                break;
+            }
+            if (drained == 0) {
+                std::this_thread::sleep_for(IDLE_SLEEP);
+            }
+        }
+    }
+
+    void handle_record(const char* record, size_t size) {
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+
+        sync_definitions(header.format_id, header.component_id);
+        if (header.format_id >= local_formats_.size() || header.component_id >= local_components_.size()) {
+            return;     // Not a registered ID; nothing we could decode it with
+        }
+        if (!format_sent_[header.format_id]) {
+            append_definition(RecordKind::FORMAT, header.format_id, 0, local_formats_[header.format_id]);
+            format_sent_[header.format_id] = true;
+        }
+        if (!component_sent_[header.component_id]) {
+            append_definition(RecordKind::COMPONENT, 0, header.component_id,
+                              local_components_[header.component_id]);
+            component_sent_[header.component_id] = true;
+        }
+
+        if (socket_) {
+            batch_.insert(batch_.end(), record, record + size);
+        }
+
+        if (header.flags & FLAG_CONSOLE) {
+            print(header, record + sizeof(header), size - sizeof(header));
+        }
+
+        if (batch_.size() >= BATCH_FLUSH_BYTES) {
+            send_batch();
+        }
+    }
+
+    void sync_definitions(uint32_t format_id, uint16_t component_id) {
+        if (format_id < local_formats_.size() && component_id < local_components_.size()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (size_t i = local_formats_.size(); i < formats_.size(); ++i) {
+            local_formats_.push_back(formats_[i]);
+        }
+        for (size_t i = local_components_.size(); i < components_.size(); ++i) {
+            local_components_.push_back(components_[i]);
+        }
+        format_sent_.resize(local_formats_.size(), false);
+        component_sent_.resize(local_components_.size(), false);
+    }
+
+    void append_definition(RecordKind kind, uint32_t format_id, uint16_t component_id, const std::string& text) {
+        if (!socket_) {
+            return;
+        }
+        size_t length = std::min(text.size(), MAX_RECORD_SIZE - sizeof(RecordHeader));
+        RecordHeader header{static_cast<uint16_t>(sizeof(RecordHeader) + length), kind, LogLevel::INFO,
+                            component_id, 0, format_id, now_ns()};
+        const char* bytes = reinterpret_cast<const char*>(&header);
+        batch_.insert(batch_.end(), bytes, bytes + sizeof(header));
+        batch_.insert(batch_.end(), text.data(), text.data() + length);
+    }
+
+    void print(const RecordHeader& header, const char* args, size_t args_size) {
+        message_.clear();
+        if (!render_message(message_, local_formats_[header.format_id], args, args_size)) {
+            message_ += " <malformed arguments>";
+        }
+        line_.clear();
+        render_line(line_, header.timestamp_ns, header.level, local_components_[header.component_id], message_);
+        line_ += '\n';
+        std::fwrite(line_.data(), 1, line_.size(), header.level >= LogLevel::ERROR ? stderr : stdout);
+    }
+
+    void reset_batch() {
+        batch_.assign(sizeof(BatchHeader), 0);
+    }
+
+    void send_batch() {
+        if (batch_.size() == sizeof(BatchHeader) || !socket_) {
+            return;
+        }
+
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        BatchHeader header{BATCH_MAGIC, source_pid_, source_start_ns_,
+                           static_cast<uint32_t>(batch_.size() - sizeof(BatchHeader)),
+                           static_cast<uint32_t>(dropped - dropped_sent_)};
+        std::memcpy(batch_.data(), &header, sizeof(header));
+
+        try {
+            zmq::message_t message(batch_.data(), batch_.size());
+            if (socket_->send(message, zmq::send_flags::dontwait)) {
+                dropped_sent_ = dropped;
+            } else {
+                // Logger service backed up: this batch is lost, count its entries
+                dropped_.fetch_add(count_entries(), std::memory_order_relaxed);
+            }
+        } catch (const zmq::error_t& e) {
+            std::cerr << "[Logger] Failed to send log batch: " << e.what() << std::endl;
+        }
+        reset_batch();
+    }
+
+    uint32_t count_entries() const {
+        uint32_t entries = 0;
+        for (size_t offset = sizeof(BatchHeader); offset + sizeof(RecordHeader) <= batch_.size();) {
+            RecordHeader header;
+            std::memcpy(&header, batch_.data() + offset, sizeof(header));
+            entries += header.kind == RecordKind::ENTRY;
+            offset += header.size;
+        }
+        return entries;
+    }
+};
+
+template<typename T>
+bool read_value(const char*& args, const char* end, T& value) {
+    if (args + sizeof(T) > end) return false;
+    std::memcpy(&value, args, sizeof(T));
+    args += sizeof(T);
+    return true;
+}
+
+// Appends one argument; false if the bytes don't parse
+bool render_arg(std::string& out, const char*& args, const char* end) {
+    ArgType type = static_cast<ArgType>(*args++);
+    // Wide enough for any double in fixed notation: 309 integer digits,
+    // sign, point and six decimals
+    char buffer[320];
+    switch (type) {
+        case ArgType::INT: {
+            int64_t v;
+            if (!read_value(args, end, v)) return false;
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+            return true;
+        }
+        case ArgType::UINT: {
+            uint64_t v;
+            if (!read_value(args, end, v)) return false;
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+            return true;
+        }
+        case ArgType::DOUBLE: {
+            double v;
+            if (!read_value(args, end, v)) return false;
+            // Six decimals like std::to_string, which the string-built messages used
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::fixed, 6).ptr);
+            return true;
+        }
+        case ArgType::CHAR: {
+            char v;
+            if (!read_value(args, end, v)) return false;
+            out += v;
+            return true;
+        }
+        case ArgType::BOOL: {
+            char v;
+            if (!read_value(args, end, v)) return false;
+            out += v ? "true" : "false";
+            return true;
+        }
+        case ArgType::STRING: {
+            uint16_t length;
+            if (!read_value(args, end, length) || args + length > end) return false;
+            out.append(args, length);
+            args += length;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+uint32_t register_format(const char* format) {
+    return Backend::instance().register_format(format);
+}
+
+uint16_t register_component(const std::string& name) {
+    return Backend::instance().register_component(name);
+}
+
+void start_backend(const std::string& endpoint) {
+    Backend::instance().start(endpoint);
+}
+
+void flush(std::chrono::milliseconds timeout) {
+    Backend::instance().flush(timeout);
+}
+
+ThreadRing* register_thread_ring() {
+    return Backend::instance().add_ring();
+}
+
+void note_dropped() {
+    Backend::instance().note_dropped();
+}
+
+uint64_t dropped_records() {
+    return Backend::instance().dropped();
+}
+
+bool render_message(std::string& out, std::string_view format, const char* args, size_t args_size) {
+    const char* end = args + args_size;
+    size_t pos = 0;
+    while (pos < format.size()) {
+        size_t next = format.find("{}", pos);
+        if (next == std::string_view::npos) {
+            out.append(format.substr(pos));
+            break;
+        }
+        out.append(format.substr(pos, next - pos));
+        pos = next + 2;
+        if (args < end && !render_arg(out, args, end)) {
+            return false;
+        }
+    }
+    // More arguments than placeholders: keep them rather than lose them
+    while (args < end) {
+        out += ' ';
+        if (!render_arg(out, args, end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void render_line(std::string& out, int64_t timestamp_ns, LogLevel level, std::string_view component,
+                 std::string_view message) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000LL);
+    int millis = static_cast<int>((timestamp_ns / 1000000LL) % 1000);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+
+    char stamp[48];
+    size_t n = std::strftime(stamp, sizeof(stamp), "[%Y-%m-%d %H:%M:%S", &local);
+    n += std::snprintf(stamp + n, sizeof(stamp) - n, ".%03d] ", millis);
+    out.append(stamp, n);
+
+    switch (level) {
+        case LogLevel::DEBUG: out += "[DEBUG] "; break;
+        case LogLevel::INFO: out += "[INFO]  "; break;
+        case LogLevel::WARNING: out += "[WARN]  "; break;
+        case LogLevel::ERROR: out += "[ERROR] "; break;
+        case LogLevel::CRITICAL: out += "[CRIT]  "; break;
+    }
+
+    out.append(component);
+    out += ": ";
+    out.append(message);
+}
+
+bool LogDecoder::decode_batch(const char* data, size_t size, std::string& out) {
+    BatchHeader batch;
+    if (size < sizeof(batch)) return false;
+    std::memcpy(&batch, data, sizeof(batch));
+    if (batch.magic != BATCH_MAGIC || sizeof(batch) + batch.payload_size > size) return false;
+
+    Source& source = sources_[{uint32_t{batch.source_pid}, int64_t{batch.source_start_ns}}];
+    dropped_reported_ += batch.dropped;
+
+    const char* record = data + sizeof(batch);
+    const char* end = record + batch.payload_size;
+    std::string message;
+    while (record + sizeof(RecordHeader) <= end) {
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        if (header.size < sizeof(header) || record + header.size > end) return false;
+
+        const char* payload = record + sizeof(header);
+        size_t payload_size = header.size - sizeof(header);
+        switch (header.kind) {
+            case RecordKind::FORMAT:
+                source.formats[header.format_id].assign(payload, payload_size);
+                break;
+            case RecordKind::COMPONENT:
+                source.components[header.component_id].assign(payload, payload_size);
+                break;
+            case RecordKind::ENTRY: {
+                message.clear();
+                auto format = source.formats.find(header.format_id);
+                auto component = source.components.find(header.component_id);
+                // Definitions are re-sent periodically; until then show raw arguments
+                std::string_view format_text;
+                if (format != source.formats.end()) {
+                    format_text = format->second;
+                } else {
+                    message = "<format " + std::to_string(header.format_id) + ">";
+                }
+                if (!render_message(message, format_text, payload, payload_size)) {
+                    message += " <malformed arguments>";
+                }
+                std::string component_name = component != source.components.end()
+                    ? component->second : "pid" + std::to_string(batch.source_pid);
+                render_line(out, header.timestamp_ns, header.level, component_name, message);
+                out += '\n';
+                entries_decoded_++;
+                break;
+            }
+            case RecordKind::PAD:
+                break;
+        }
+        record += header.size;
+    }
+    return true;
+}
+
+} // namespace binlog
+} // namespace hft
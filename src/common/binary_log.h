@@ -0,0 +1,307 @@
+#pragma once
+
+#include "message_types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hft {
+namespace binlog {
+
+// Deferred-format logging. A log call copies its format ID and raw arguments
+// into the calling thread's ring; one backend thread per process drains every
+// ring, batches the records and PUSHes them to the logger service, which
+// appends the batches to a binary file as-is. Text is only produced by the
+// backend (console output) and by the offline decoder.
+//
+// File layout: a sequence of batches, each a BatchHeader followed by
+// payload_size bytes of records. Format strings and component names are
+// numbered per process, so each process sends FORMAT/COMPONENT definition
+// records ahead of the first entry that uses them (and again periodically, in
+// case the logger service started a new file).
+
+static constexpr uint32_t BATCH_MAGIC = 0x42544648;   // "HFTB"
+
+struct BatchHeader {
+    uint32_t magic;
+    uint32_t source_pid;
+    int64_t source_start_ns;   // With the pid, tells restarted processes apart
+    uint32_t payload_size;
+    uint32_t dropped;          // Records lost to full rings since the last batch
+} __attribute__((packed));
+
+enum class RecordKind : uint8_t {
+    PAD = 0,        // Ring only: rest of the buffer is unused, wrap around
+    ENTRY = 1,      // A log call: format ID plus encoded arguments
+    FORMAT = 2,     // Defines format_id; payload is the format string
+    COMPONENT = 3   // Defines component_id; payload is the component name
+};
+
+struct RecordHeader {
+    uint16_t size;             // Header plus payload, in bytes
+    RecordKind kind;
+    LogLevel level;
+    uint16_t component_id;
+    uint16_t flags;
+    uint32_t format_id;
+    int64_t timestamp_ns;      // Wall clock, ns since epoch
+} __attribute__((packed));
+
+static constexpr uint16_t FLAG_CONSOLE = 1;         // Print on the logging process's console too
+static constexpr uint32_t PLAIN_FORMAT_ID = 0;      // "{}", used by Logger::log(std::string)
+static constexpr size_t MAX_RECORD_SIZE = 4096;     // Larger entries are dropped
+static constexpr size_t MAX_STRING_ARG = 1024;      // Longer string arguments are truncated
+
+// Each argument is a type tag followed by its value
+enum class ArgType : uint8_t {
+    INT = 1,        // int64_t
+    UINT = 2,       // uint64_t
+    DOUBLE = 3,
+    CHAR = 4,
+    BOOL = 5,
+    STRING = 6      // uint16_t length, then the bytes
+};
+
+template<typename T>
+inline size_t encoded_size(const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+        return 2;
+    } else if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U>) {
+        return 1 + 8;
+    } else {
+        return 3 + std::min(std::string_view(value).size(), MAX_STRING_ARG);
+    }
+}
+
+template<typename T>
+inline char* encode(char* out, const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        *out++ = static_cast<char>(ArgType::BOOL);
+        *out++ = value ? 1 : 0;
+    } else if constexpr (std::is_same_v<U, char>) {
+        *out++ = static_cast<char>(ArgType::CHAR);
+        *out++ = value;
+    } else if constexpr (std::is_enum_v<U>) {
+        return encode(out, static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        *out++ = static_cast<char>(ArgType::INT);
+        int64_t v = value;
+        std::memcpy(out, &v, sizeof(v));
+        out += sizeof(v);
+    } else if constexpr (std::is_integral_v<U>) {
+        *out++ = static_cast<char>(ArgType::UINT);
+        uint64_t v = value;
+        std::memcpy(out, &v, sizeof(v));
+        out += sizeof(v);
+    } else if constexpr (std::is_floating_point_v<U>) {
+        *out++ = static_cast<char>(ArgType::DOUBLE);
+        double v = value;
+        std::memcpy(out, &v, sizeof(v));
+        out += sizeof(v);
+    } else {
+        static_assert(std::is_convertible_v<const T&, std::string_view>,
+                      "binlog arguments are arithmetic, enum, bool, char or string-like");
+        std::string_view s(value);
+        uint16_t length = static_cast<uint16_t>(std::min(s.size(), MAX_STRING_ARG));
+        *out++ = static_cast<char>(ArgType::STRING);
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), s.data(), length);
+        out += sizeof(length) + length;
+    }
+    return out;
+}
+
+// Compile-time argument check for HFT_LOGF: "{}" count of a literal format
+constexpr size_t count_placeholders(std::string_view format) {
+    size_t count = 0;
+    for (size_t pos = format.find("{}"); pos != std::string_view::npos; pos = format.find("{}", pos + 2)) {
+        count++;
+    }
+    return count;
+}
+
+// Argument count as a type, so it is usable in a constant expression
+// whatever the arguments are; only ever named inside decltype
+template<typename... Args>
+std::integral_constant<size_t, sizeof...(Args)> count_args(const Args&...);
+
+// Size of an ENTRY record for these arguments
+template<typename... Args>
+inline size_t entry_size(const Args&... args) {
+    return sizeof(RecordHeader) + (size_t{0} + ... + encoded_size(args));
+}
+
+// Writes an ENTRY record of entry_size(args...) bytes at out
+template<typename... Args>
+inline void encode_entry(char* out, size_t size, uint16_t component_id, LogLevel level, uint16_t flags,
+                         uint32_t format_id, int64_t timestamp_ns, const Args&... args) {
+    RecordHeader header{static_cast<uint16_t>(size), RecordKind::ENTRY, level, component_id, flags,
+                        format_id, timestamp_ns};
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    ((out = encode(out, args)), ...);
+}
+
+// Single-producer, single-consumer byte ring holding whole records. Records
+// are 8-byte aligned and never split: one that doesn't fit before the end of
+// the buffer is preceded by a zero size marker and starts again at offset 0.
+class ThreadRing {
+public:
+    static constexpr size_t CAPACITY = 256 * 1024;
+
+    ThreadRing() : buffer_(new char[CAPACITY]) {}
+
+    ThreadRing(const ThreadRing&) = delete;
+    ThreadRing& operator=(const ThreadRing&) = delete;
+
+    // Producer: room for size bytes, or nullptr if the ring is full
+    char* reserve(size_t size) {
+        size_t aligned = align(size);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t to_end = CAPACITY - (head & MASK);
+        size_t needed = aligned <= to_end ? aligned : to_end + aligned;
+        if (head + needed - cached_tail_ > CAPACITY) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head + needed - cached_tail_ > CAPACITY) {
+                return nullptr;
+            }
+        }
+        if (aligned > to_end) {
+            uint16_t marker = 0;
+            std::memcpy(buffer_.get() + (head & MASK), &marker, sizeof(marker));
+            head += to_end;
+        }
+        pending_head_ = head + aligned;
+        return buffer_.get() + (head & MASK);
+    }
+
+    // Producer: publishes the record written into the last reserve()
+    void commit() { head_.store(pending_head_, std::memory_order_release); }
+
+    // Consumer: calls fn(record, size) for each record; fn returns false to
+    // leave that record for the next drain. Returns the number consumed.
+    template<typename Fn>
+    size_t drain(Fn&& fn) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (tail < head) {
+            size_t offset = tail & MASK;
+            uint16_t size;
+            std::memcpy(&size, buffer_.get() + offset, sizeof(size));
+            if (size == 0) {
+                tail += CAPACITY - offset;
+                continue;
+            }
+            if (!fn(buffer_.get() + offset, static_cast<size_t>(size))) {
+                break;
+            }
+            tail += align(size);
+            count++;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+    std::atomic<bool> retired{false};   // Owning thread has exited
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "CAPACITY must be power of 2");
+
+    static size_t align(size_t size) { return (size + 7) & ~size_t{7}; }
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t pending_head_ = 0;     // Producer only
+    uint64_t cached_tail_ = 0;      // Producer only
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::unique_ptr<char[]> buffer_;
+};
+
+// Registration (cold path, thread-safe). IDs are stable for the process.
+uint32_t register_format(const char* format);
+uint16_t register_component(const std::string& name);
+
+// Starts the backend thread that ships records to endpoint; later calls
+// with a different endpoint are ignored
+void start_backend(const std::string& endpoint);
+// Blocks until records logged before the call have been sent (or timeout)
+void flush(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+ThreadRing* register_thread_ring();
+void note_dropped();
+uint64_t dropped_records();
+
+inline ThreadRing& thread_ring() {
+    static thread_local ThreadRing* ring = register_thread_ring();
+    return *ring;
+}
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Hot path: one ring reservation and a few memcpys. False if dropped.
+template<typename... Args>
+inline bool write_entry(uint16_t component_id, LogLevel level, uint16_t flags, uint32_t format_id,
+                        const Args&... args) {
+    size_t size = entry_size(args...);
+    ThreadRing& ring = thread_ring();
+    char* out = size <= MAX_RECORD_SIZE ? ring.reserve(size) : nullptr;
+    if (!out) {
+        note_dropped();
+        return false;
+    }
+    encode_entry(out, size, component_id, level, flags, format_id, now_ns(), args...);
+    ring.commit();
+    return true;
+}
+
+// Substitutes each "{}" in format with the next argument; extra arguments
+// are appended. False if the argument bytes are malformed.
+bool render_message(std::string& out, std::string_view format, const char* args, size_t args_size);
+// "[2024-01-02 09:30:00.123] [INFO]  Component: message"
+void render_line(std::string& out, int64_t timestamp_ns, LogLevel level, std::string_view component,
+                 std::string_view message);
+
+// Offline side: turns batches back into text lines, tracking each source
+// process's format and component tables
+class LogDecoder {
+public:
+    // data holds one BatchHeader plus its payload; appends one line per entry
+    bool decode_batch(const char* data, size_t size, std::string& out);
+
+    uint64_t entries_decoded() const { return entries_decoded_; }
+    uint64_t dropped_reported() const { return dropped_reported_; }
+
+private:
+    struct Source {
+        std::unordered_map<uint32_t, std::string> formats;
+        std::unordered_map<uint16_t, std::string> components;
+    };
+
+    std::map<std::pair<uint32_t, int64_t>, Source> sources_;
+    uint64_t entries_decoded_ = 0;
+    uint64_t dropped_reported_ = 0;
+};
+
+} // namespace binlog
+} // namespace hft
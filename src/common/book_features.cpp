@@ -0,0 +1,282 @@
+#include "book_features.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+// Scalar kernels; also the tails of the vector ones
+void accumulate_scalar(const double* price, const double* size,
+                       double* cum_size, double* cum_notional, size_t n) {
+    double depth = 0.0;
+    double notional = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        depth += size[i];
+        notional += price[i] * size[i];
+        cum_size[i] = depth;
+        cum_notional[i] = notional;
+    }
+}
+
+void imbalance_scalar(const double* bid, const double* ask, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double total = bid[i] + ask[i];
+        out[i] = total > 0.0 ? (bid[i] - ask[i]) / total : 0.0;
+    }
+}
+
+size_t first_reaching_scalar(const double* cum, size_t n, double target) {
+    for (size_t i = 0; i < n; ++i) {
+        if (cum[i] >= target) return i;
+    }
+    return n;
+}
+
+#if defined(__x86_64__)
+
+// Inclusive prefix sum of four lanes plus the running carry
+__attribute__((target("avx2")))
+inline __m256d prefix_sum4(__m256d x, __m256d carry) {
+    const __m256d zero = _mm256_setzero_pd();
+    // [0, x0, x1, x2]
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    // [0, 0, x0, x1]
+    x = _mm256_add_pd(x, _mm256_permute2f128_pd(x, x, 0x08));
+    return _mm256_add_pd(x, carry);
+}
+
+__attribute__((target("avx2")))
+void accumulate_avx2(const double* price, const double* size,
+                     double* cum_size, double* cum_notional, size_t n) {
+    __m256d depth = _mm256_setzero_pd();
+    __m256d notional = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d s = _mm256_loadu_pd(size + i);
+        __m256d pv = _mm256_mul_pd(_mm256_loadu_pd(price + i), s);
+        __m256d d = prefix_sum4(s, depth);
+        __m256d v = prefix_sum4(pv, notional);
+        _mm256_storeu_pd(cum_size + i, d);
+        _mm256_storeu_pd(cum_notional + i, v);
+        depth = _mm256_permute4x64_pd(d, _MM_SHUFFLE(3, 3, 3, 3));
+        notional = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    if (i < n) {
+        double d0 = i > 0 ? cum_size[i - 1] : 0.0;
+        double v0 = i > 0 ? cum_notional[i - 1] : 0.0;
+        accumulate_scalar(price + i, size + i, cum_size + i, cum_notional + i, n - i);
+        for (; i < n; ++i) {
+            cum_size[i] += d0;
+            cum_notional[i] += v0;
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void imbalance_avx2(const double* bid, const double* ask, double* out, size_t n) {
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d b = _mm256_loadu_pd(bid + i);
+        __m256d a = _mm256_loadu_pd(ask + i);
+        __m256d total = _mm256_add_pd(b, a);
+        __m256d ratio = _mm256_div_pd(_mm256_sub_pd(b, a), total);
+        // Lanes with nothing on either side divided 0 by 0
+        _mm256_storeu_pd(out + i, _mm256_and_pd(ratio, _mm256_cmp_pd(total, zero, _CMP_GT_OQ)));
+    }
+    imbalance_scalar(bid + i, ask + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+size_t first_reaching_avx2(const double* cum, size_t n, double target) {
+    const __m256d t = _mm256_set1_pd(target);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(cum + i), t, _CMP_GE_OQ));
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + first_reaching_scalar(cum + i, n - i, target);
+}
+
+__attribute__((target("avx512f")))
+inline __m512d prefix_sum8(__m512d x, __m512d carry) {
+    x = _mm512_add_pd(x, _mm512_maskz_permutexvar_pd(0xFE, _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0), x));
+    x = _mm512_add_pd(x, _mm512_maskz_permutexvar_pd(0xFC, _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0), x));
+    x = _mm512_add_pd(x, _mm512_maskz_permutexvar_pd(0xF0, _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0), x));
+    return _mm512_add_pd(x, carry);
+}
+
+__attribute__((target("avx512f")))
+void accumulate_avx512(const double* price, const double* size,
+                       double* cum_size, double* cum_notional, size_t n) {
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512d depth = _mm512_setzero_pd();
+    __m512d notional = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d s = _mm512_loadu_pd(size + i);
+        __m512d pv = _mm512_mul_pd(_mm512_loadu_pd(price + i), s);
+        __m512d d = prefix_sum8(s, depth);
+        __m512d v = prefix_sum8(pv, notional);
+        _mm512_storeu_pd(cum_size + i, d);
+        _mm512_storeu_pd(cum_notional + i, v);
+        depth = _mm512_permutexvar_pd(last, d);
+        notional = _mm512_permutexvar_pd(last, v);
+    }
+    if (i < n) {
+        double d0 = i > 0 ? cum_size[i - 1] : 0.0;
+        double v0 = i > 0 ? cum_notional[i - 1] : 0.0;
+        accumulate_scalar(price + i, size + i, cum_size + i, cum_notional + i, n - i);
+        for (; i < n; ++i) {
+            cum_size[i] += d0;
+            cum_notional[i] += v0;
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void imbalance_avx512(const double* bid, const double* ask, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d b = _mm512_loadu_pd(bid + i);
+        __m512d a = _mm512_loadu_pd(ask + i);
+        __m512d total = _mm512_add_pd(b, a);
+        __mmask8 populated = _mm512_cmp_pd_mask(total, _mm512_setzero_pd(), _CMP_GT_OQ);
+        _mm512_storeu_pd(out + i, _mm512_maskz_div_pd(populated, _mm512_sub_pd(b, a), total));
+    }
+    imbalance_scalar(bid + i, ask + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+size_t first_reaching_avx512(const double* cum, size_t n, double target) {
+    const __m512d t = _mm512_set1_pd(target);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __mmask8 mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(cum + i), t, _CMP_GE_OQ);
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + first_reaching_scalar(cum + i, n - i, target);
+}
+
+#endif
+
+const BookKernels SCALAR_KERNELS{"scalar", accumulate_scalar, imbalance_scalar, first_reaching_scalar};
+#if defined(__x86_64__)
+const BookKernels AVX2_KERNELS{"avx2", accumulate_avx2, imbalance_avx2, first_reaching_avx2};
+const BookKernels AVX512_KERNELS{"avx512", accumulate_avx512, imbalance_avx512, first_reaching_avx512};
+#endif
+
+} // namespace
+
+const BookKernels& scalar_book_kernels() {
+    return SCALAR_KERNELS;
+}
+
+const BookKernels* avx2_book_kernels() {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("avx2") ? &AVX2_KERNELS : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const BookKernels* avx512_book_kernels() {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("avx512f") ? &AVX512_KERNELS : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const BookKernels& active_book_kernels() {
+    static const BookKernels& kernels = [] () -> const BookKernels& {
+        if (const BookKernels* k = avx512_book_kernels()) return *k;
+        if (const BookKernels* k = avx2_book_kernels()) return *k;
+        return scalar_book_kernels();
+    }();
+    return kernels;
+}
+
+void BookFeatures::compute(const IOrderBook& book, const BookKernels& kernels) {
+    version = book.get_version();
+
+    // Gather, then every signal is a straight pass over LEVELS slots
+    bid_levels = book.copy_levels(BookSide::BID, bid_price, bid_size, LEVELS);
+    ask_levels = book.copy_levels(BookSide::ASK, ask_price, ask_size, LEVELS);
+    std::fill(bid_price + bid_levels, bid_price + LEVELS, 0.0);
+    std::fill(bid_size + bid_levels, bid_size + LEVELS, 0.0);
+    std::fill(ask_price + ask_levels, ask_price + LEVELS, 0.0);
+    std::fill(ask_size + ask_levels, ask_size + LEVELS, 0.0);
+    bid_truncated = book.get_book_depth(BookSide::BID) > bid_levels;
+    ask_truncated = book.get_book_depth(BookSide::ASK) > ask_levels;
+
+    kernels.accumulate(bid_price, bid_size, bid_depth, bid_notional, LEVELS);
+    kernels.accumulate(ask_price, ask_size, ask_depth, ask_notional, LEVELS);
+    kernels.imbalance(bid_depth, ask_depth, imbalance, LEVELS);
+
+    best_bid = bid_price[0];
+    best_ask = ask_price[0];
+    if (bid_levels > 0 && ask_levels > 0) {
+        // From the fixed-point prices, so these equal get_mid_price() / get_spread()
+        mid = book.get_mid_price();
+        spread = book.get_spread();
+        microprice = (best_bid * ask_size[0] + best_ask * bid_size[0]) / (bid_size[0] + ask_size[0]);
+    } else {
+        mid = 0.0;
+        spread = 0.0;
+        microprice = 0.0;
+    }
+}
+
+double BookFeatures::depth(BookSide side, size_t levels) const {
+    if (levels == 0) return 0.0;
+    levels = std::min(levels, LEVELS);
+    return side == BookSide::BID ? bid_depth[levels - 1] : ask_depth[levels - 1];
+}
+
+double BookFeatures::depth_imbalance(size_t levels) const {
+    if (levels == 0) return 0.0;
+    return imbalance[std::min(levels, LEVELS) - 1];
+}
+
+bool BookFeatures::covers(BookSide side, uint32_t shares) const {
+    const bool is_bid = (side == BookSide::BID);
+    return !(is_bid ? bid_truncated : ask_truncated) ||
+           (is_bid ? bid_depth : ask_depth)[LEVELS - 1] >= static_cast<double>(shares);
+}
+
+double BookFeatures::vwap(BookSide side, uint32_t shares) const {
+    const bool is_bid = (side == BookSide::BID);
+    const double* price = is_bid ? bid_price : ask_price;
+    const double* cum_size = is_bid ? bid_depth : ask_depth;
+    const double* cum_notional = is_bid ? bid_notional : ask_notional;
+    if (shares == 0 || cum_size[LEVELS - 1] <= 0.0) return 0.0;
+
+    const double wanted = static_cast<double>(shares);
+    size_t level = active_book_kernels().first_reaching(cum_size, LEVELS, wanted);
+    if (level == LEVELS) {
+        // Not enough size: the whole captured side
+        return cum_notional[LEVELS - 1] / cum_size[LEVELS - 1];
+    }
+
+    // Whole levels before the one that fills the order, then part of it
+    double before_size = level > 0 ? cum_size[level - 1] : 0.0;
+    double before_notional = level > 0 ? cum_notional[level - 1] : 0.0;
+    return (before_notional + price[level] * (wanted - before_size)) / wanted;
+}
+
+double BookFeatures::market_impact(BookSide side, uint32_t shares) const {
+    double current_price = (side == BookSide::BID) ? best_bid : best_ask;
+    double average = vwap(side, shares);
+    if (current_price > 0.0 && average > 0.0) {
+        return std::abs(average - current_price) / current_price;
+    }
+    return 0.0;
+}
+
+} // namespace hft
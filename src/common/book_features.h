@@ -0,0 +1,80 @@
+#pragma once
+
+#include "order_book.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+
+// Depth kernels over dense top-of-book arrays (best level first). Each has a
+// scalar version and, on x86-64, AVX2 and AVX-512 versions compiled with
+// per-function target attributes, so the build needs no -m flags; the widest
+// one the CPU supports is picked once at startup.
+struct BookKernels {
+    const char* name;
+
+    // cum_size[i] = size[0..i] summed, cum_notional[i] = price * size over the same levels
+    void (*accumulate)(const double* price, const double* size,
+                       double* cum_size, double* cum_notional, size_t n);
+
+    // out[i] = (bid[i] - ask[i]) / (bid[i] + ask[i]), 0 where both are 0
+    void (*imbalance)(const double* bid, const double* ask, double* out, size_t n);
+
+    // Index of the first cum[i] >= target, n if none (cum is non-decreasing)
+    size_t (*first_reaching)(const double* cum, size_t n, double target);
+};
+
+const BookKernels& scalar_book_kernels();
+const BookKernels* avx2_book_kernels();     // nullptr if the CPU lacks AVX2
+const BookKernels* avx512_book_kernels();   // nullptr if the CPU lacks AVX-512F
+const BookKernels& active_book_kernels();   // Widest supported
+
+// Depth signals for the top LEVELS levels of a book, computed in one pass
+// per book change (IOrderBook::features()) and read by every strategy on the
+// symbol instead of re-walking the book for each query.
+struct alignas(64) BookFeatures {
+    static constexpr size_t LEVELS = 16;
+
+    uint64_t version = 0;           // IOrderBook::get_version() these reflect
+    size_t bid_levels = 0;          // Populated levels captured, <= LEVELS
+    size_t ask_levels = 0;
+    bool bid_truncated = false;     // The side has levels beyond LEVELS
+    bool ask_truncated = false;
+
+    // Best first; slots past the populated levels are zero
+    alignas(64) double bid_price[LEVELS];
+    alignas(64) double bid_size[LEVELS];
+    alignas(64) double bid_depth[LEVELS];       // Cumulative size through level i
+    alignas(64) double bid_notional[LEVELS];    // Cumulative price * size through level i
+    alignas(64) double ask_price[LEVELS];
+    alignas(64) double ask_size[LEVELS];
+    alignas(64) double ask_depth[LEVELS];
+    alignas(64) double ask_notional[LEVELS];
+    alignas(64) double imbalance[LEVELS];       // Over the top i+1 levels of each side
+
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double mid = 0.0;               // 0 unless both sides are populated
+    double spread = 0.0;
+    double microprice = 0.0;        // Top-level size-weighted mid, 0 unless both sides are populated
+
+    // Recompute everything from the book's current levels
+    void compute(const IOrderBook& book, const BookKernels& kernels = active_book_kernels());
+
+    // Size in the top `levels` levels (capped at LEVELS)
+    double depth(BookSide side, size_t levels) const;
+
+    // Imbalance over the top `levels` levels of each side (capped at LEVELS)
+    double depth_imbalance(size_t levels) const;
+
+    // True if the captured levels hold enough size to fill `shares`, or the
+    // side has no levels beyond them; vwap() and market_impact() then match
+    // the book's own get_volume_weighted_price() / get_market_impact()
+    bool covers(BookSide side, uint32_t shares) const;
+
+    // VWAP of sweeping `shares` through the captured levels
+    double vwap(BookSide side, uint32_t shares) const;
+    double market_impact(BookSide side, uint32_t shares) const;
+};
+
+} // namespace hft
@@ -0,0 +1,180 @@
+#include "book_replay.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace hft {
+
+namespace {
+
+// Generator's own view of one side; best level first
+template<typename Compare>
+using SideLevels = std::map<price_t, uint32_t, Compare>;
+
+// Index in [0, count), skewed toward 0 (the touch)
+size_t skewed_index(std::mt19937_64& rng, size_t count) {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    return std::min(count - 1, static_cast<size_t>(u * u * u * static_cast<double>(count)));
+}
+
+template<typename Compare>
+price_t price_at(const SideLevels<Compare>& levels, size_t index) {
+    auto it = levels.begin();
+    std::advance(it, index);
+    return it->first;
+}
+
+} // namespace
+
+BookStream generate_book_stream(const BookStreamConfig& config) {
+    BookStream stream;
+    stream.updates.reserve(2 * config.depth + config.updates);
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<uint32_t> lots(1, 10);
+    std::uniform_int_distribution<uint32_t> orders(1, 5);
+
+    SideLevels<std::greater<price_t>> bids;
+    SideLevels<std::less<price_t>> asks;
+    const price_t tick = config.tick_size > 0 ? config.tick_size : DEFAULT_TICK;
+    const price_t mid = round_to_tick(config.mid_price, tick);
+    const size_t depth = std::max<size_t>(config.depth, 1);
+    uint64_t sequence = 0;
+
+    auto emit = [&](BookSide side, BookUpdateType type, price_t price, uint32_t size) {
+        ++sequence;
+        auto update = OrderBookFactory::create_level_update(config.symbol, side, type, price, size,
+                                                            sequence, size > 0 ? orders(rng) : 0);
+        update.exchange_timestamp = sequence * 1000;   // Fixed, so streams compare equal
+        stream.updates.push_back(update);
+        if (side == BookSide::BID) {
+            if (type == BookUpdateType::DELETE) bids.erase(price); else bids[price] = size;
+        } else {
+            if (type == BookUpdateType::DELETE) asks.erase(price); else asks[price] = size;
+        }
+    };
+
+    for (size_t i = 1; i <= depth; ++i) {
+        emit(BookSide::BID, BookUpdateType::ADD, mid - static_cast<price_t>(i) * tick, lots(rng) * 100);
+        emit(BookSide::ASK, BookUpdateType::ADD, mid + static_cast<price_t>(i) * tick, lots(rng) * 100);
+    }
+    stream.seed_updates = stream.updates.size();
+
+    while (stream.updates.size() < stream.seed_updates + config.updates) {
+        BookSide side = unit(rng) < 0.5 ? BookSide::BID : BookSide::ASK;
+        size_t count = side == BookSide::BID ? bids.size() : asks.size();
+
+        // Lean toward whichever of add/delete brings the side back to depth
+        double add_p = count < depth ? 0.35 : (count > depth ? 0.15 : 0.25);
+        double delete_p = count > depth ? 0.35 : (count < depth ? 0.15 : 0.25);
+        double roll = unit(rng);
+
+        if (roll < add_p || count <= 1) {
+            // New level near the touch, possibly inside the spread
+            price_t best_bid = bids.begin()->first;
+            price_t best_ask = asks.begin()->first;
+            price_t offset = static_cast<price_t>(skewed_index(rng, count + 2)) * tick;
+            price_t price = side == BookSide::BID
+                ? std::min(best_bid + tick - offset, best_ask - tick)
+                : std::max(best_ask - tick + offset, best_bid + tick);
+            // First free tick at or behind it, so every add grows the side
+            if (side == BookSide::BID) {
+                while (bids.count(price)) price -= tick;
+            } else {
+                while (asks.count(price)) price += tick;
+            }
+            if (price <= 0) continue;
+            emit(side, BookUpdateType::ADD, price, lots(rng) * 100);
+        } else if (roll < add_p + delete_p) {
+            size_t index = skewed_index(rng, count);
+            price_t price = side == BookSide::BID ? price_at(bids, index) : price_at(asks, index);
+            emit(side, BookUpdateType::DELETE, price, 0);
+        } else {
+            size_t index = skewed_index(rng, count);
+            price_t price = side == BookSide::BID ? price_at(bids, index) : price_at(asks, index);
+            emit(side, BookUpdateType::UPDATE, price, lots(rng) * 100);
+        }
+    }
+    return stream;
+}
+
+std::string compare_books(const IOrderBook& reference, const IOrderBook& candidate, size_t levels) {
+    std::ostringstream diff;
+    auto differ = [&](const char* what, auto expected, auto actual) {
+        diff << what << ": expected " << expected << ", got " << actual;
+        return diff.str();
+    };
+
+    if (reference.get_status() != candidate.get_status()) {
+        return differ("status", static_cast<int>(reference.get_status()), static_cast<int>(candidate.get_status()));
+    }
+    if (reference.get_last_sequence() != candidate.get_last_sequence()) {
+        return differ("last sequence", reference.get_last_sequence(), candidate.get_last_sequence());
+    }
+    if (reference.get_best_bid_fixed() != candidate.get_best_bid_fixed()) {
+        return differ("best bid", reference.get_best_bid_fixed(), candidate.get_best_bid_fixed());
+    }
+    if (reference.get_best_ask_fixed() != candidate.get_best_ask_fixed()) {
+        return differ("best ask", reference.get_best_ask_fixed(), candidate.get_best_ask_fixed());
+    }
+
+    for (BookSide side : {BookSide::BID, BookSide::ASK}) {
+        const char* name = side == BookSide::BID ? "bid" : "ask";
+        if (reference.get_book_depth(side) != candidate.get_book_depth(side)) {
+            diff << name << " ";
+            return differ("depth", reference.get_book_depth(side), candidate.get_book_depth(side));
+        }
+        for (size_t level = 0; level < levels; ++level) {
+            uint32_t expected = side == BookSide::BID ? reference.get_bid_size_at_level(level)
+                                                      : reference.get_ask_size_at_level(level);
+            uint32_t actual = side == BookSide::BID ? candidate.get_bid_size_at_level(level)
+                                                    : candidate.get_ask_size_at_level(level);
+            if (expected != actual) {
+                diff << name << " level " << level << " ";
+                return differ("size", expected, actual);
+            }
+        }
+        for (size_t n : {size_t(1), size_t(5), levels}) {
+            if (reference.get_total_size(side, n) != candidate.get_total_size(side, n)) {
+                diff << name << " top " << n << " ";
+                return differ("total size", reference.get_total_size(side, n), candidate.get_total_size(side, n));
+            }
+        }
+        for (uint32_t shares : {100u, 1000u, 100000u}) {
+            double expected = reference.get_volume_weighted_price(side, shares);
+            double actual = candidate.get_volume_weighted_price(side, shares);
+            if (std::abs(expected - actual) > 1e-9 * std::max(1.0, std::abs(expected))) {
+                diff.precision(12);
+                diff << name << " " << shares << " shares ";
+                return differ("vwap", expected, actual);
+            }
+        }
+    }
+    return {};
+}
+
+DifferentialResult replay_differential(const std::vector<OrderBookUpdate>& updates,
+                                       IOrderBook& reference, IOrderBook& candidate,
+                                       size_t check_every, size_t levels) {
+    DifferentialResult result;
+    check_every = std::max<size_t>(check_every, 1);
+    for (size_t i = 0; i < updates.size(); ++i) {
+        reference.apply_update(updates[i]);
+        candidate.apply_update(updates[i]);
+        result.updates_applied++;
+        if ((i + 1) % check_every == 0 || i + 1 == updates.size()) {
+            result.mismatch = compare_books(reference, candidate, levels);
+            if (!result.mismatch.empty()) {
+                result.mismatch_index = i;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace hft
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "order_book.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// Synthetic level-update stream for one symbol. Each side is seeded with
+// `depth` levels around mid_price, then a random walk of size changes, new
+// levels and deletions keeps it near that depth. Activity is skewed toward
+// the top of book as on real feeds, and adds inside the spread and deletes at
+// the touch move the best prices. The book never crosses and never empties.
+// Deterministic for a given config.
+struct BookStreamConfig {
+    std::string symbol = "BENCH";
+    size_t depth = 50;                          // Target levels per side
+    size_t updates = 100000;                    // After the seeding updates
+    price_t mid_price = to_fixed_price(500.0);
+    price_t tick_size = DEFAULT_TICK;
+    uint64_t seed = 1;
+};
+
+struct BookStream {
+    std::vector<OrderBookUpdate> updates;       // Sequenced from 1
+    size_t seed_updates = 0;                    // Leading updates that only build the initial book
+};
+
+BookStream generate_book_stream(const BookStreamConfig& config);
+
+// Empty if the two books answer every query identically, else a description
+// of the first difference. Checks status, last sequence, top of book, depth,
+// the size of each of the first `levels` levels, get_total_size and
+// get_volume_weighted_price (to 1e-9 relative) for a few quantities.
+std::string compare_books(const IOrderBook& reference, const IOrderBook& candidate, size_t levels = 10);
+
+struct DifferentialResult {
+    size_t updates_applied = 0;
+    size_t mismatch_index = 0;                  // Update after which the books first differed
+    std::string mismatch;                       // Empty when they never did
+
+    bool ok() const { return mismatch.empty(); }
+};
+
+// Applies updates to both books, comparing them every check_every updates
+// and after the last one; stops at the first difference
+DifferentialResult replay_differential(const std::vector<OrderBookUpdate>& updates,
+                                       IOrderBook& reference, IOrderBook& candidate,
+                                       size_t check_every = 1, size_t levels = 10);
+
+} // namespace hft
@@ -0,0 +1,112 @@
+#include "config_reloader.h"
+#include <chrono>
+#include <iostream>
+#include <sys/stat.h>
+
+namespace hft {
+
+namespace {
+
+bool modification_time(const std::string& path, struct timespec& mtime) {
+    struct stat st;
+    if (path.empty() || stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    mtime = st.st_mtim;
+    return true;
+}
+
+} // namespace
+
+ConfigReloader::~ConfigReloader() {
+    stop();
+}
+
+void ConfigReloader::start(ReloadCallback on_reload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    on_reload_ = std::move(on_reload);
+    watched_path_ = StaticConfig::runtime().source_path;
+    modification_time(watched_path_, watched_mtime_);
+    running_ = true;
+    thread_ = std::thread(&ConfigReloader::run, this);
+}
+
+void ConfigReloader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ConfigReloader::request_reload() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reload_requested_ = true;
+    }
+    wake_.notify_all();
+}
+
+void ConfigReloader::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        int check_ms = StaticConfig::get_config_reload_check_ms();
+        auto ready = [this] { return !running_ || reload_requested_; };
+        if (check_ms > 0) {
+            wake_.wait_for(lock, std::chrono::milliseconds(check_ms), ready);
+        } else {
+            wake_.wait(lock, ready);
+        }
+        if (!running_) {
+            break;
+        }
+        
+        bool requested = reload_requested_;
+        reload_requested_ = false;
+        std::string path = watched_path_;
+        lock.unlock();
+        
+        // Compare mtimes so an editor's save triggers one reload
+        struct timespec mtime = {};
+        bool changed = modification_time(path, mtime) &&
+                       (mtime.tv_sec != watched_mtime_.tv_sec || mtime.tv_nsec != watched_mtime_.tv_nsec);
+        if (changed) {
+            watched_mtime_ = mtime;
+        }
+        if (requested || changed) {
+            reload(path.empty() ? "config/hft_config.conf" : path);
+        }
+        
+        lock.lock();
+    }
+}
+
+void ConfigReloader::reload(const std::string& path) {
+    if (!StaticConfig::load_from_file(path.c_str())) {
+        failed_reloads_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "[ConfigReloader] Reload of " << path << " failed, keeping generation "
+                  << StaticConfig::get_config_generation() << std::endl;
+        return;
+    }
+    
+    reloads_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t generation = StaticConfig::get_config_generation();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watched_path_ = StaticConfig::runtime().source_path;
+    }
+    if (on_reload_) {
+        on_reload_(generation);
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "static_config.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ctime>
+
+namespace hft {
+
+// Re-runs StaticConfig::load_from_file() on its own thread when the loaded
+// config file changes on disk, or when asked to (ControlAction::UPDATE_CONFIG).
+// Parsing and validation never happen on a processing thread; readers pick
+// up the new snapshot on their next getter call or StaticConfig::Snapshot.
+class ConfigReloader {
+public:
+    // Called on the reloader thread after each successful reload
+    using ReloadCallback = std::function<void(uint64_t generation)>;
+    
+    ConfigReloader() = default;
+    ~ConfigReloader();
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+    
+    // Watches StaticConfig's current source file, polling every
+    // timing.config_reload_check_ms (0 = reload on request only)
+    void start(ReloadCallback on_reload = nullptr);
+    void stop();
+    
+    // Reload on the reloader thread as soon as possible
+    void request_reload();
+    
+    uint64_t get_reloads() const { return reloads_.load(std::memory_order_relaxed); }
+    uint64_t get_failed_reloads() const { return failed_reloads_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void reload(const std::string& path);
+    
+    ReloadCallback on_reload_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_ = false;
+    bool reload_requested_ = false;
+    
+    std::string watched_path_;
+    struct timespec watched_mtime_ = {};
+    
+    std::atomic<uint64_t> reloads_{0};
+    std::atomic<uint64_t> failed_reloads_{0};
+};
+
+} // namespace hft
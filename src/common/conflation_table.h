@@ -0,0 +1,108 @@
+#pragma once
+
+#include "high_res_timer.h"
+#include "symbol_table.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace hft {
+
+// Latest-value table for slow consumers (GUI, dashboards). One slot per
+// symbol ID, overwritten in place by a single writer with seqlock semantics:
+// the writer never waits, readers copy a slot and retry if a write raced
+// them. A consumer reading at its own cadence sees the last state of each
+// symbol, so a refresh costs O(symbols) however many ticks arrived since.
+template<typename T, size_t CAPACITY = SymbolTable::MAX_SYMBOLS>
+class ConflationTable {
+    static_assert(std::is_trivially_copyable_v<T>, "ConflationTable copies values byte-wise");
+
+public:
+    ConflationTable() : slots_(CAPACITY) {}
+
+    ConflationTable(const ConflationTable&) = delete;
+    ConflationTable& operator=(const ConflationTable&) = delete;
+
+    // Single writer only; false if the ID is out of range
+    bool write(symbol_id_t id, const T& value) {
+        if (id >= CAPACITY) {
+            return false;
+        }
+
+        Slot& slot = slots_[id];
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);     // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.value, &value, sizeof(T));
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        if (id >= used_.load(std::memory_order_relaxed)) {
+            used_.store(id + 1, std::memory_order_release);
+        }
+        updates_.store(updates_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consistent copy of the latest value; false if the slot was never
+    // written. version counts writes to the slot, so a consumer can skip
+    // symbols that have not changed since its last refresh.
+    bool read(symbol_id_t id, T& out, uint64_t* version = nullptr) const {
+        if (id >= CAPACITY) {
+            return false;
+        }
+
+        const Slot& slot = slots_[id];
+        for (;;) {
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            if (before & 1) {
+                HighResTimer::cpu_relax();
+                continue;
+            }
+            std::memcpy(&out, &slot.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                if (version) {
+                    *version = before / 2;
+                }
+                return true;
+            }
+        }
+    }
+
+    // Calls fn(id, value, version) for every written slot; returns the count
+    template<typename Fn>
+    size_t for_each(Fn&& fn) const {
+        size_t visited = 0;
+        size_t used = used_.load(std::memory_order_acquire);
+        T value;
+        for (size_t id = 0; id < used; ++id) {
+            uint64_t version = 0;
+            if (read(static_cast<symbol_id_t>(id), value, &version)) {
+                fn(static_cast<symbol_id_t>(id), value, version);
+                visited++;
+            }
+        }
+        return visited;
+    }
+
+    size_t used() const { return used_.load(std::memory_order_acquire); }     // One past the highest written ID
+    uint64_t get_updates() const { return updates_.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};  // Odd while written; even = 2 * writes
+        T value{};
+    };
+
+    std::vector<Slot> slots_;
+    std::atomic<size_t> used_{0};
+    std::atomic<uint64_t> updates_{0};
+};
+
+} // namespace hft
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace hft {
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2,
+// 3", SC'11): a keyed bijection on 128-bit counters whose outputs pass
+// BigCrush. A draw is a pure function of (key, counter), so there is no
+// generator state to share, seed or advance: any thread can compute any
+// draw, in any order, and get the same bits.
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t product0 = uint64_t{0xD2511F53u} * counter[0];
+            uint64_t product1 = uint64_t{0xCD9E8D57u} * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                       static_cast<uint32_t>(product0)};
+        }
+        return counter;
+    }
+};
+
+// A stream of draws addressed by (seed, domain, stream, index). Simulators
+// key each stream by something the input fixes, such as an order ID, so a
+// draw depends only on what it is for: not on how many draws other orders,
+// symbols or threads made first.
+class CounterRng {
+public:
+    CounterRng(uint64_t seed, uint32_t domain, uint64_t stream)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}
+        , domain_(domain)
+        , stream_(stream) {}
+
+    // 64 random bits for draw index
+    uint64_t bits(uint32_t index) const {
+        Philox4x32::Counter out = Philox4x32::generate(
+            {static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32), index, domain_}, key_);
+        return (uint64_t{out[0]} << 32) | out[1];
+    }
+
+    // [0, 1) with 53 random bits
+    double uniform(uint32_t index) const {
+        return static_cast<double>(bits(index) >> 11) * 0x1.0p-53;
+    }
+
+    double uniform(uint32_t index, double min, double max) const {
+        return min + (max - min) * uniform(index);
+    }
+
+    // [min, max]; the modulo bias is below 2^-32 for any int range
+    int uniform_int(uint32_t index, int min, int max) const {
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<int64_t>(bits(index) % span));
+    }
+
+    // Box-Muller over draws 2 * index and 2 * index + 1
+    double normal(uint32_t index, double mean, double stddev) const {
+        double u1 = 1.0 - uniform(2 * index);   // (0, 1]
+        double u2 = uniform(2 * index + 1);
+        return mean + stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+    // Stable stream ID for a name (FNV-1a), the same on every platform and run
+    static uint64_t stream_id(const std::string& name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+private:
+    Philox4x32::Key key_;
+    uint32_t domain_;
+    uint64_t stream_;
+};
+
+} // namespace hft
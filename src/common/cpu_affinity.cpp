@@ -1,5 +1,7 @@
 #include "cpu_affinity.h"
+#include "cpu_topology.h"
 #include "logging.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -162,51 +164,35 @@ void initialize_high_performance_trading() {
     std::cout << "High-performance initialization complete." << std::endl;
 }
 
-void set_thread_for_market_data() {
-    // Dedicate CPU core 0 for market data processing
+// The old fixed placements (CPU 0/1/2) are now only the fallback when the
+// thread plan has no processing entry for the service
+static void pin_processing_thread(const char* name, int default_cpu) {
     int cpu_count = CPUAffinity::get_cpu_count();
-    if (cpu_count < 1) {
+    int fallback = std::min(default_cpu, cpu_count - 1);
+    if (fallback < 0) {
         std::cerr << "Error: No CPUs available" << std::endl;
         return;
     }
-    
-    if (CPUAffinity::set_thread_affinity(0)) {
-        std::cout << "Market data thread pinned to CPU 0" << std::endl;
+
+    const ThreadPlacement* placement = ThreadPlan::instance().find("processing");
+    int cpu = placement ? placement->cpu : fallback;
+    if (ThreadPlan::instance().pin_current_thread("processing", fallback)) {
+        std::cout << name << " thread pinned to CPU " << cpu << std::endl;
     } else {
-        std::cout << "Warning: Failed to pin market data thread to CPU 0" << std::endl;
+        std::cout << "Warning: Failed to pin " << name << " thread to CPU " << cpu << std::endl;
     }
 }
 
+void set_thread_for_market_data() {
+    pin_processing_thread("Market data", 0);
+}
+
 void set_thread_for_trading_engine() {
-    // Dedicate CPU core 1 for trading engine
-    int cpu_count = CPUAffinity::get_cpu_count();
-    if (cpu_count < 2) {
-        std::cerr << "Warning: Less than 2 CPUs available, using CPU 0" << std::endl;
-        CPUAffinity::set_thread_affinity(0);
-        return;
-    }
-    
-    if (CPUAffinity::set_thread_affinity(1)) {
-        std::cout << "Trading engine thread pinned to CPU 1" << std::endl;
-    } else {
-        std::cout << "Warning: Failed to pin trading engine thread to CPU 1" << std::endl;
-    }
+    pin_processing_thread("Trading engine", 1);
 }
 
 void set_thread_for_order_gateway() {
-    // Dedicate CPU core 2 for order gateway
-    int cpu_count = CPUAffinity::get_cpu_count();
-    int target_cpu = (cpu_count >= 3) ? 2 : (cpu_count - 1);
-    
-    if (cpu_count < 3) {
-        std::cerr << "Warning: Less than 3 CPUs available, using CPU " << target_cpu << std::endl;
-    }
-    
-    if (CPUAffinity::set_thread_affinity(target_cpu)) {
-        std::cout << "Order gateway thread pinned to CPU " << target_cpu << std::endl;
-    } else {
-        std::cout << "Warning: Failed to pin order gateway thread to CPU " << target_cpu << std::endl;
-    }
+    pin_processing_thread("Order gateway", 2);
 }
 
 } // namespace hft
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "cpu_topology.h"
+#include "cpu_affinity.h"
+#include "static_config.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <zmq.hpp>
+
+namespace hft {
+
+namespace {
+
+// From linux/mempolicy.h, which we don't want to depend on for three values
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_BIND_MODE = 2;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+constexpr int MAX_NUMA_NODES = 64;      // One word of node mask
+
+bool read_line(const std::string& path, std::string& out) {
+    std::ifstream file(path);
+    if (!file.is_open() || !std::getline(file, out)) {
+        return false;
+    }
+    out.erase(out.find_last_not_of(" \t\r\n") + 1);
+    return true;
+}
+
+int read_int(const std::string& path, int fallback) {
+    std::string text;
+    if (!read_line(path, text) || text.empty()) return fallback;
+    try {
+        return std::stoi(text);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+bool set_memory_policy(int mode, int node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    if (node < 0 || node >= MAX_NUMA_NODES) return false;
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_set_mempolicy, mode, &mask, MAX_NUMA_NODES + 1) == 0;
+#else
+    (void)mode;
+    (void)node;
+    return false;
+#endif
+}
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(0, range.find_first_not_of(" \t"));
+        range.erase(range.find_last_not_of(" \t\r\n") + 1);
+        if (range.empty()) continue;
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (first < 0 || last < first) return {};
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+// ---------------------------------------------------------------------------
+// CpuTopology
+
+const CpuTopology& CpuTopology::system() {
+    static const CpuTopology topology = [] {
+        CpuTopology t;
+        t.load();
+        return t;
+    }();
+    return topology;
+}
+
+bool CpuTopology::load(const std::string& sysfs_root) {
+    cpus_.clear();
+    node_count_ = 1;
+    socket_count_ = 1;
+
+    std::string text;
+    std::vector<int> online;
+    if (read_line(sysfs_root + "/cpu/online", text)) {
+        online = parse_cpu_list(text);
+    }
+    if (online.empty()) {
+        std::cerr << "[CpuTopology] Could not read " << sysfs_root << "/cpu/online" << std::endl;
+        return false;
+    }
+
+    std::vector<int> isolated;
+    if (read_line(sysfs_root + "/cpu/isolated", text)) {
+        isolated = parse_cpu_list(text);
+    }
+
+    std::set<int> sockets;
+    for (int id : online) {
+        CpuInfo info;
+        info.cpu = id;
+        std::string topology = sysfs_root + "/cpu/cpu" + std::to_string(id) + "/topology/";
+        info.core_id = read_int(topology + "core_id", id);
+        info.socket = read_int(topology + "physical_package_id", 0);
+        if (read_line(topology + "thread_siblings_list", text)) {
+            info.siblings = parse_cpu_list(text);
+        }
+        if (info.siblings.empty()) {
+            info.siblings = {id};
+        }
+        info.isolated = std::binary_search(isolated.begin(), isolated.end(), id);
+        sockets.insert(info.socket);
+        cpus_.push_back(std::move(info));
+    }
+    socket_count_ = static_cast<int>(sockets.size());
+
+    // Node membership; without the node directory everything is node 0
+    for (int node = 0; node < MAX_NUMA_NODES; ++node) {
+        if (!read_line(sysfs_root + "/node/node" + std::to_string(node) + "/cpulist", text)) {
+            continue;
+        }
+        node_count_ = std::max(node_count_, node + 1);
+        for (int id : parse_cpu_list(text)) {
+            auto it = std::lower_bound(cpus_.begin(), cpus_.end(), id,
+                                       [](const CpuInfo& info, int cpu) { return info.cpu < cpu; });
+            if (it != cpus_.end() && it->cpu == id) {
+                it->numa_node = node;
+            }
+        }
+    }
+    return true;
+}
+
+const CpuInfo* CpuTopology::cpu(int id) const {
+    auto it = std::lower_bound(cpus_.begin(), cpus_.end(), id,
+                               [](const CpuInfo& info, int cpu) { return info.cpu < cpu; });
+    return it != cpus_.end() && it->cpu == id ? &*it : nullptr;
+}
+
+std::vector<int> CpuTopology::cpus_on_node(int node) const {
+    std::vector<int> result;
+    for (const CpuInfo& info : cpus_) {
+        if (info.numa_node == node) result.push_back(info.cpu);
+    }
+    return result;
+}
+
+std::vector<int> CpuTopology::isolated_cpus() const {
+    std::vector<int> result;
+    for (const CpuInfo& info : cpus_) {
+        if (info.isolated) result.push_back(info.cpu);
+    }
+    return result;
+}
+
+int CpuTopology::node_of(int id) const {
+    const CpuInfo* info = cpu(id);
+    return info ? info->numa_node : 0;
+}
+
+bool CpuTopology::share_core(int a, int b) const {
+    if (a == b) return true;
+    const CpuInfo* info = cpu(a);
+    return info && std::binary_search(info->siblings.begin(), info->siblings.end(), b);
+}
+
+std::string CpuTopology::describe() const {
+    size_t smt = cpus_.empty() ? 1 : cpus_.front().siblings.size();
+    std::ostringstream oss;
+    oss << cpus_.size() << " CPUs, " << socket_count_ << " sockets, " << node_count_ << " NUMA nodes, "
+        << smt << " threads per core";
+    std::vector<int> isolated = isolated_cpus();
+    if (!isolated.empty()) {
+        oss << ", isolated:";
+        for (int cpu : isolated) oss << " " << cpu;
+    }
+    return oss.str();
+}
+
+// ---------------------------------------------------------------------------
+// ThreadPlan
+
+ThreadPlan& ThreadPlan::instance() {
+    static ThreadPlan plan;
+    return plan;
+}
+
+bool ThreadPlan::configure(const std::string& service) {
+    const CpuTopology& topology = CpuTopology::system();
+    bool ok = configure(service, StaticConfig::get_thread_plan(), topology);
+    std::cout << "[ThreadPlan] " << topology.describe() << "; " << placements_.size()
+              << " threads planned for " << service << std::endl;
+    for (const std::string& error : errors_) {
+        std::cerr << "[ThreadPlan] " << error << std::endl;
+    }
+    return ok;
+}
+
+bool ThreadPlan::configure(const std::string& service, const std::unordered_map<std::string, std::string>& entries,
+                           const CpuTopology& topology) {
+    service_ = service;
+    placements_.clear();
+    errors_.clear();
+
+    // Hot threads claim cores in key order, so the outcome doesn't depend
+    // on hash order
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : entries) keys.push_back(key);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<ThreadPlacement> hot;
+    for (const std::string& key : keys) {
+        const std::string& value = entries.at(key);
+        size_t dot = key.find('.');
+        if (dot == std::string::npos || dot == 0 || dot + 1 == key.size()) {
+            errors_.push_back("thread." + key + ": expected thread.<service>.<thread>");
+            continue;
+        }
+
+        ThreadPlacement placement;
+        placement.service = key.substr(0, dot);
+        placement.thread = key.substr(dot + 1);
+        size_t colon = value.find(':');
+        std::string flag = colon == std::string::npos ? "" : value.substr(colon + 1);
+        try {
+            placement.cpu = std::stoi(value.substr(0, colon));
+        } catch (const std::exception&) {
+            placement.cpu = -1;
+        }
+        if (placement.cpu < 0 || (!flag.empty() && flag != "hot")) {
+            errors_.push_back("thread." + key + ": expected <cpu>[:hot], got '" + value + "'");
+            continue;
+        }
+        placement.hot = flag == "hot";
+
+        const CpuInfo* info = topology.cpu(placement.cpu);
+        if (!info) {
+            errors_.push_back("thread." + key + ": CPU " + std::to_string(placement.cpu) + " is not online");
+            continue;
+        }
+        placement.numa_node = info->numa_node;
+
+        if (placement.hot) {
+            auto clash = std::find_if(hot.begin(), hot.end(), [&](const ThreadPlacement& other) {
+                return topology.share_core(placement.cpu, other.cpu);
+            });
+            if (clash != hot.end()) {
+                errors_.push_back("thread." + key + ": CPU " + std::to_string(placement.cpu) +
+                                  " shares a core with hot thread " + clash->service + "." + clash->thread +
+                                  " on CPU " + std::to_string(clash->cpu) + "; left unpinned");
+                continue;
+            }
+            hot.push_back(placement);
+        }
+
+        if (placement.service == service) {
+            placements_[placement.thread] = placement;
+        }
+    }
+    return errors_.empty();
+}
+
+const ThreadPlacement* ThreadPlan::find(const std::string& thread) const {
+    auto it = placements_.find(thread);
+    return it != placements_.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> ThreadPlan::threads_with_prefix(const std::string& prefix) const {
+    std::vector<std::string> threads;
+    for (const auto& [thread, placement] : placements_) {
+        if (thread.rfind(prefix, 0) == 0) {
+            threads.push_back(thread);
+        }
+    }
+    std::sort(threads.begin(), threads.end());
+    return threads;
+}
+
+bool ThreadPlan::pin_current_thread(const std::string& thread, int fallback_cpu) const {
+    // Named whether or not it is placed, so top -H and profiles can tell the
+    // threads apart; the kernel keeps 15 characters
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), thread.substr(0, 15).c_str());
+#endif
+
+    const ThreadPlacement* placement = find(thread);
+    int cpu = placement ? placement->cpu : fallback_cpu;
+    if (cpu < 0) {
+        return true;
+    }
+    if (!CPUAffinity::set_thread_affinity(cpu)) {
+        return false;
+    }
+
+    // First-touch allocations from here on come from the local node;
+    // preferred rather than bound, so a full node still falls back
+    int node = placement ? placement->numa_node : CpuTopology::system().node_of(cpu);
+    if (CpuTopology::system().node_count() > 1) {
+        set_memory_policy(MPOL_PREFERRED_MODE, node);
+    }
+    return true;
+}
+
+bool ThreadPlan::pin_zmq_io_threads(void* zmq_context) const {
+    const ThreadPlacement* placement = find("zmq_io");
+    if (!placement || !zmq_context) {
+        return true;
+    }
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+    return zmq_ctx_set(zmq_context, ZMQ_THREAD_AFFINITY_CPU_ADD, placement->cpu) == 0;
+#else
+    std::cerr << "[ThreadPlan] libzmq has no ZMQ_THREAD_AFFINITY_CPU_ADD; zmq_io not pinned" << std::endl;
+    return false;
+#endif
+}
+
+bool ThreadPlan::move_to_local_node(void* addr, size_t len) {
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+    const CpuTopology& topology = CpuTopology::system();
+    if (topology.node_count() < 2) {
+        return true;
+    }
+
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0 || node >= MAX_NUMA_NODES) {
+        return false;
+    }
+
+    // Only pages entirely inside the range, so neighbours stay put
+    uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + len) & ~(page - 1);
+    if (end <= start) {
+        return true;
+    }
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, start, end - start, MPOL_BIND_MODE, &mask, MAX_NUMA_NODES + 1,
+                   MPOL_MF_MOVE_FLAG) == 0;
+#else
+    (void)addr;
+    (void)len;
+    return false;
+#endif
+}
+
+} // namespace hft
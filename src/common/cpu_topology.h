@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+// "0-3,8,10-11" (the sysfs cpulist format) to a sorted CPU list; empty on
+// malformed input
+std::vector<int> parse_cpu_list(const std::string& list);
+
+struct CpuInfo {
+    int cpu = -1;
+    int core_id = -1;
+    int socket = -1;
+    int numa_node = 0;
+    bool isolated = false;          // In isolcpus, the scheduler leaves it alone
+    std::vector<int> siblings;      // SMT threads sharing the core, including this one
+};
+
+// Online CPUs with their socket, core, NUMA node and SMT siblings, read from
+// sysfs. A missing file leaves the defaults (one node, no siblings), so
+// containers that hide parts of /sys still get a usable topology.
+class CpuTopology {
+public:
+    // The machine's topology, discovered on first use
+    static const CpuTopology& system();
+
+    // sysfs_root is /sys/devices/system on a real machine; tests point it at
+    // a fake tree
+    bool load(const std::string& sysfs_root = "/sys/devices/system");
+
+    const CpuInfo* cpu(int id) const;
+    const std::vector<CpuInfo>& cpus() const { return cpus_; }
+    std::vector<int> cpus_on_node(int node) const;
+    std::vector<int> isolated_cpus() const;
+    int node_count() const { return node_count_; }
+    int socket_count() const { return socket_count_; }
+    int node_of(int cpu) const;
+
+    // Same physical core (a CPU is its own sibling)
+    bool share_core(int a, int b) const;
+
+    std::string describe() const;
+
+private:
+    std::vector<CpuInfo> cpus_;     // Ascending CPU number
+    int node_count_ = 1;
+    int socket_count_ = 1;
+};
+
+// Where one named thread runs. Hot threads busy-spin or sit on the latency
+// path and get a physical core to themselves.
+struct ThreadPlacement {
+    std::string service;
+    std::string thread;
+    int cpu = -1;
+    int numa_node = 0;
+    bool hot = false;
+};
+
+// Config-driven pinning for every named thread of every service
+// (thread.<service>.<thread>=<cpu>[:hot] in hft_config.conf). The whole file
+// is validated at once, so two services can't claim sibling hyperthreads for
+// hot threads either. Threads without an entry are left to the scheduler.
+//
+// Names used in the tree: processing, control, feed_rx, publisher,
+// worker.<n>, metrics_update, alpaca_io, alpaca_md.<n>, aggregator,
+// rmcast_repair, plus metrics, metrics_publisher, http, profiler, jitter.<n>
+// and zmq_io in every service.
+class ThreadPlan {
+public:
+    static ThreadPlan& instance();
+
+    // Loads this process's placements from StaticConfig against the system
+    // topology; false if any entry was rejected (the rest still apply)
+    bool configure(const std::string& service);
+    bool configure(const std::string& service, const std::unordered_map<std::string, std::string>& entries,
+                   const CpuTopology& topology);
+
+    const ThreadPlacement* find(const std::string& thread) const;
+    // This service's placed thread names starting with prefix, sorted
+    std::vector<std::string> threads_with_prefix(const std::string& prefix) const;
+    const std::vector<std::string>& errors() const { return errors_; }
+    const std::string& service() const { return service_; }
+
+    // Names the calling thread, pins it to its planned CPU (fallback_cpu if
+    // the plan has no entry, nothing if that is -1) and makes its allocations
+    // prefer that CPU's NUMA node. False only if pinning was attempted and
+    // failed.
+    bool pin_current_thread(const std::string& thread, int fallback_cpu = -1) const;
+
+    // Restricts the zmq context's I/O threads to the zmq_io CPU; call before
+    // creating sockets
+    bool pin_zmq_io_threads(void* zmq_context) const;
+
+    // Moves the whole pages of [addr, addr + len) to the calling thread's
+    // NUMA node, for buffers allocated before the owner was pinned
+    static bool move_to_local_node(void* addr, size_t len);
+
+private:
+    std::string service_;
+    std::unordered_map<std::string, ThreadPlacement> placements_;    // This service, by thread name
+    std::vector<std::string> errors_;
+};
+
+} // namespace hft
@@ -0,0 +1,479 @@
+#include "event_journal.h"
+#include "cpu_affinity.h"
+#include "static_config.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr size_t BATCH_LIMIT_BYTES = 256 * 1024;
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(100);
+constexpr char SEGMENT_EXTENSION[] = ".journal";
+
+constexpr uint32_t FNV_OFFSET = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+
+uint32_t fnv1a(uint32_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+uint32_t snapshot_checksum(const JournalSnapshotHeader& header, const void* records) {
+    uint32_t hash = fnv1a(FNV_OFFSET, &header.sequence, sizeof(header.sequence));
+    hash = fnv1a(hash, &header.records, sizeof(header.records));
+    hash = fnv1a(hash, &header.size, sizeof(header.size));
+    return fnv1a(hash, records, header.size);
+}
+
+// A rename or a new file is only durable once its directory is synced
+void sync_directory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Read-only view of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                // Recovery is one forward scan
+                ::madvise(addr, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(addr);
+            } else {
+                std::cerr << "[EventJournal] mmap of " << path << " failed: " << std::strerror(errno) << std::endl;
+                size_ = 0;
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Bytes of the valid record at `offset`, or 0 if it is torn or corrupt
+size_t valid_record(const char* data, size_t size, size_t offset, JournalRecordHeader& header) {
+    if (size - offset < sizeof(JournalRecordHeader)) return 0;
+    std::memcpy(&header, data + offset, sizeof(header));
+    if (header.size < sizeof(JournalRecordHeader) || header.size > size - offset) return 0;
+    if (EventJournal::checksum(header, data + offset + sizeof(header)) != header.checksum) return 0;
+    return std::min(align8(header.size), size - offset);
+}
+
+} // namespace
+
+JournalConfig JournalConfig::from_config(const std::string& name) {
+    JournalConfig config;
+    config.directory = StaticConfig::get_journal_directory();
+    config.name = name;
+    config.sync_interval = std::chrono::milliseconds(StaticConfig::get_journal_sync_interval_ms());
+    return config;
+}
+
+std::string JournalRecovery::describe() const {
+    std::ostringstream out;
+    if (snapshot_sequence > 0) {
+        out << "snapshot at #" << snapshot_sequence << " (" << snapshot_records << " records), ";
+    } else {
+        out << "no snapshot, ";
+    }
+    out << records_replayed << " journal records to #" << last_sequence;
+    if (torn_bytes > 0) {
+        out << ", dropped " << torn_bytes << " torn bytes";
+    }
+    out << " in " << elapsed.count() << " us";
+    return out.str();
+}
+
+void JournalSnapshot::add(JournalRecordType type, const void* data, size_t size) {
+    JournalRecordHeader header{};
+    header.size = static_cast<uint16_t>(sizeof(header) + size);
+    header.type = type;
+    header.sequence = 0;
+    header.checksum = EventJournal::checksum(header, data);
+
+    size_t offset = data_.size();
+    data_.resize(offset + align8(header.size));
+    std::memcpy(data_.data() + offset, &header, sizeof(header));
+    std::memcpy(data_.data() + offset + sizeof(header), data, size);
+    records_++;
+}
+
+EventJournal::EventJournal(const JournalConfig& config) : config_(config) {}
+
+EventJournal::~EventJournal() {
+    close();
+}
+
+uint32_t EventJournal::checksum(const JournalRecordHeader& header, const void* payload) {
+    uint32_t hash = fnv1a(FNV_OFFSET, &header.size, sizeof(header.size));
+    hash = fnv1a(hash, &header.type, sizeof(header.type));
+    hash = fnv1a(hash, &header.sequence, sizeof(header.sequence));
+    return fnv1a(hash, payload, header.size - sizeof(JournalRecordHeader));
+}
+
+std::string EventJournal::snapshot_path() const {
+    return config_.directory + "/" + config_.name + ".snapshot";
+}
+
+std::string EventJournal::segment_path(uint64_t first_sequence) const {
+    return config_.directory + "/" + config_.name + "." + std::to_string(first_sequence) + SEGMENT_EXTENSION;
+}
+
+std::vector<uint64_t> EventJournal::list_segments() const {
+    std::vector<uint64_t> segments;
+    std::error_code ec;
+    std::string prefix = config_.name + ".";
+    for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec)) {
+        std::string file = entry.path().filename().string();
+        if (file.size() <= prefix.size() + sizeof(SEGMENT_EXTENSION) - 1 ||
+            file.compare(0, prefix.size(), prefix) != 0 ||
+            !file.ends_with(SEGMENT_EXTENSION)) {
+            continue;
+        }
+        std::string digits = file.substr(prefix.size(), file.size() - prefix.size() - (sizeof(SEGMENT_EXTENSION) - 1));
+        if (digits.find_first_not_of("0123456789") != std::string::npos) continue;
+        segments.push_back(std::stoull(digits));
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+JournalRecovery EventJournal::recover(const RecordHandler& handler) {
+    auto start = std::chrono::steady_clock::now();
+    JournalRecovery result;
+    uint64_t applied = 0;
+
+    {
+        MappedFile snapshot(snapshot_path());
+        JournalSnapshotHeader header{};
+        bool valid = snapshot.data() && snapshot.size() >= sizeof(header);
+        if (valid) {
+            std::memcpy(&header, snapshot.data(), sizeof(header));
+            valid = header.magic == JOURNAL_SNAPSHOT_MAGIC &&
+                    header.size == snapshot.size() - sizeof(header) &&
+                    snapshot_checksum(header, snapshot.data() + sizeof(header)) == header.checksum;
+            if (!valid) {
+                std::cerr << "[EventJournal] Ignoring corrupt snapshot " << snapshot_path() << std::endl;
+            }
+        }
+        if (valid) {
+            const char* records = snapshot.data() + sizeof(header);
+            size_t offset = 0;
+            JournalRecordHeader record;
+            while (offset < header.size) {
+                size_t length = valid_record(records, header.size, offset, record);
+                if (length == 0) break;
+                if (handler) handler(record.type, records + offset + sizeof(record), record.size - sizeof(record));
+                result.snapshot_records++;
+                offset += length;
+            }
+            result.snapshot_sequence = header.sequence;
+            applied = header.sequence;
+        }
+    }
+
+    std::vector<uint64_t> segments = list_segments();
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (segments[i] > applied + 1) {
+            std::cerr << "[EventJournal] " << segment_path(segments[i]) << " starts after #" << applied
+                      << "; records in between are missing, stopping replay" << std::endl;
+            break;
+        }
+
+        std::string path = segment_path(segments[i]);
+        MappedFile segment(path);
+        size_t offset = 0;
+        bool intact = true;
+        JournalRecordHeader record;
+        while (offset < segment.size()) {
+            size_t length = valid_record(segment.data(), segment.size(), offset, record);
+            if (length == 0 || record.sequence > applied + 1) {
+                intact = false;
+                break;
+            }
+            if (record.sequence == applied + 1) {
+                if (handler) handler(record.type, segment.data() + offset + sizeof(record), record.size - sizeof(record));
+                applied = record.sequence;
+                result.records_replayed++;
+            }
+            offset += length;
+        }
+        if (intact) continue;
+
+        // A crash mid-write leaves a partial tail: cut it so appends continue
+        // from the last whole record. Anything after it cannot be replayed.
+        result.torn_bytes += segment.size() - offset;
+        if (::truncate(path.c_str(), static_cast<off_t>(offset)) != 0) {
+            std::cerr << "[EventJournal] Failed to truncate " << path << ": " << std::strerror(errno) << std::endl;
+        }
+        for (size_t j = i + 1; j < segments.size(); ++j) {
+            std::string later = segment_path(segments[j]);
+            std::cerr << "[EventJournal] Setting aside " << later << " after a corrupt record in " << path << std::endl;
+            std::rename(later.c_str(), (later + ".discarded").c_str());
+        }
+        break;
+    }
+
+    result.last_sequence = applied;
+    next_sequence_ = applied + 1;
+    written_sequence_ = applied;
+    appended_sequence_.store(applied, std::memory_order_relaxed);
+    synced_sequence_.store(applied, std::memory_order_release);
+    recovered_ = true;
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+bool EventJournal::open() {
+    if (is_open()) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec) {
+        std::cerr << "[EventJournal] Cannot create " << config_.directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+    if (!recovered_) {
+        recover(nullptr);
+    }
+    if (!open_segment(next_sequence_)) {
+        return false;
+    }
+
+    writer_running_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { run_writer(); });
+    return true;
+}
+
+void EventJournal::close() {
+    if (!writer_running_.exchange(false, std::memory_order_acq_rel)) return;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void EventJournal::append(JournalRecordType type, const void* data, size_t size) {
+    size_t total = sizeof(JournalRecordHeader) + size;
+    if (total > UINT16_MAX || !writer_running_.load(std::memory_order_relaxed)) return;
+
+    char* slot = ring_.reserve(total);
+    if (!slot) {
+        ring_full_waits_.fetch_add(1, std::memory_order_relaxed);
+        while (!(slot = ring_.reserve(total))) {
+            if (!writer_running_.load(std::memory_order_relaxed)) return;
+            CPUAffinity::cpu_pause();
+        }
+    }
+
+    // The writer fills in the checksum, keeping the hash off this thread
+    JournalRecordHeader header{};
+    header.size = static_cast<uint16_t>(total);
+    header.type = type;
+    header.sequence = next_sequence_++;
+    std::memcpy(slot, &header, sizeof(header));
+    std::memcpy(slot + sizeof(header), data, size);
+    ring_.commit();
+    appended_sequence_.store(header.sequence, std::memory_order_relaxed);
+}
+
+void EventJournal::snapshot(JournalSnapshot&& snapshot) {
+    snapshot.sequence_ = next_sequence_ - 1;
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    pending_snapshot_ = std::move(snapshot);
+    snapshot_pending_ = true;
+}
+
+void EventJournal::run_writer() {
+    auto last_sync = std::chrono::steady_clock::now();
+    while (writer_running_.load(std::memory_order_acquire)) {
+        bool wrote = write_batch();
+
+        // Group commit: one fdatasync covers every batch since the last one
+        auto now = std::chrono::steady_clock::now();
+        if (written_sequence_ > synced_sequence_.load(std::memory_order_relaxed) &&
+            now - last_sync >= config_.sync_interval) {
+            sync();
+            last_sync = now;
+        }
+        maybe_write_snapshot();
+
+        if (!wrote) {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+
+    while (write_batch()) {}
+    sync();
+    maybe_write_snapshot();
+}
+
+bool EventJournal::write_batch() {
+    batch_.clear();
+    uint64_t last_sequence = written_sequence_;
+    ring_.drain([&](const char* record, size_t size) {
+        size_t aligned = align8(size);
+        if (!batch_.empty() && batch_.size() + aligned > BATCH_LIMIT_BYTES) {
+            return false;
+        }
+        size_t offset = batch_.size();
+        batch_.resize(offset + aligned);
+        char* out = batch_.data() + offset;
+        std::memcpy(out, record, size);
+
+        JournalRecordHeader header;
+        std::memcpy(&header, out, sizeof(header));
+        header.checksum = checksum(header, out + sizeof(header));
+        std::memcpy(out, &header, sizeof(header));
+        last_sequence = header.sequence;
+        return true;
+    });
+    if (batch_.empty()) {
+        return false;
+    }
+
+    if (!write_all(fd_, batch_.data(), batch_.size())) {
+        if (write_errors_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            std::cerr << "[EventJournal] Write to " << segment_path(next_sequence_) << " failed: "
+                      << std::strerror(errno) << std::endl;
+        }
+        return true;
+    }
+    written_sequence_ = last_sequence;
+    return true;
+}
+
+void EventJournal::sync() {
+    if (fd_ < 0 || written_sequence_ == synced_sequence_.load(std::memory_order_relaxed)) return;
+    if (::fdatasync(fd_) != 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    synced_sequence_.store(written_sequence_, std::memory_order_release);
+}
+
+bool EventJournal::open_segment(uint64_t first_sequence) {
+    std::string path = segment_path(first_sequence);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[EventJournal] Failed to open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    sync_directory(config_.directory);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    return true;
+}
+
+void EventJournal::maybe_write_snapshot() {
+    JournalSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        if (!snapshot_pending_ || pending_snapshot_.sequence_ > written_sequence_) return;
+        snapshot = std::move(pending_snapshot_);
+        snapshot_pending_ = false;
+    }
+
+    // The snapshot must never be newer on disk than the records it follows
+    sync();
+    if (!store_snapshot(snapshot)) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    snapshots_written_.fetch_add(1, std::memory_order_relaxed);
+
+    // Later records go to a fresh segment; whole segments the snapshot
+    // covers are dropped
+    if (!open_segment(written_sequence_ + 1)) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::vector<uint64_t> segments = list_segments();
+    for (size_t i = 0; i + 1 < segments.size(); ++i) {
+        if (segments[i + 1] - 1 <= snapshot.sequence_) {
+            ::unlink(segment_path(segments[i]).c_str());
+        }
+    }
+}
+
+bool EventJournal::store_snapshot(const JournalSnapshot& snapshot) {
+    JournalSnapshotHeader header{};
+    header.magic = JOURNAL_SNAPSHOT_MAGIC;
+    header.sequence = snapshot.sequence_;
+    header.records = snapshot.records_;
+    header.size = snapshot.data_.size();
+    header.checksum = snapshot_checksum(header, snapshot.data_.data());
+
+    std::string path = snapshot_path();
+    std::string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[EventJournal] Failed to open " << temp << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    bool ok = write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+              write_all(fd, snapshot.data_.data(), snapshot.data_.size()) &&
+              ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::cerr << "[EventJournal] Failed to store " << path << ": " << std::strerror(errno) << std::endl;
+        ::unlink(temp.c_str());
+        return false;
+    }
+    sync_directory(config_.directory);
+    return true;
+}
+
+} // namespace hft
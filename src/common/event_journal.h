@@ -0,0 +1,180 @@
+#pragma once
+
+#include "binary_log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hft {
+
+// What a journal record's payload holds
+enum class JournalRecordType : uint16_t {
+    ORDER_EXECUTION = 1,    // OrderExecution
+    POSITION_UPDATE = 2,    // PositionUpdate (position service snapshots)
+    ORDER_STATE = 3,        // Gateway Order as of this record: opened, or broker ID assigned
+    ORDER_CLOSED = 4,       // uint64_t order ID left the gateway's working orders
+    ORDER_SEQUENCE = 5,     // uint64_t next gateway order ID (snapshots)
+    RISK_POSITION = 6       // JournalRiskPosition (gateway snapshots)
+};
+
+// Symbols are journaled by name: only preloaded IDs agree across restarts
+struct JournalRiskPosition {
+    char symbol[16];
+    int64_t position;
+} __attribute__((packed));
+
+// On disk, records are 8-byte aligned and each starts with this header. The
+// first field doubles as binlog::ThreadRing framing on the way to the writer.
+struct JournalRecordHeader {
+    uint16_t size;          // Header plus payload, in bytes
+    JournalRecordType type;
+    uint32_t checksum;      // FNV-1a over size, type, sequence and payload
+    uint64_t sequence;      // From 1, continuous across segments and restarts
+} __attribute__((packed));
+
+static constexpr uint32_t JOURNAL_SNAPSHOT_MAGIC = 0x534A4648;   // "HFJS"
+
+// Snapshot file: this header, then `size` bytes of records
+struct JournalSnapshotHeader {
+    uint32_t magic;
+    uint32_t checksum;      // FNV-1a over sequence, records, size and the records
+    uint64_t sequence;      // Last journal record the snapshot includes
+    uint64_t records;
+    uint64_t size;
+} __attribute__((packed));
+
+struct JournalConfig {
+    std::string directory = "journal";
+    std::string name;                                   // File prefix, one per service
+    std::chrono::milliseconds sync_interval{5};         // Group commit interval (0 = after every write)
+
+    // journal.* keys from StaticConfig
+    static JournalConfig from_config(const std::string& name);
+};
+
+struct JournalRecovery {
+    uint64_t snapshot_sequence = 0;     // 0 = no snapshot
+    uint64_t snapshot_records = 0;
+    uint64_t records_replayed = 0;      // Journal records after the snapshot
+    uint64_t last_sequence = 0;
+    uint64_t torn_bytes = 0;            // Incomplete tail dropped (crash mid-write)
+    std::chrono::microseconds elapsed{0};
+
+    std::string describe() const;
+};
+
+// A compact image of a service's state, as of everything it journaled
+// before handing the image to EventJournal::snapshot()
+class JournalSnapshot {
+public:
+    void add(JournalRecordType type, const void* data, size_t size);
+
+    template <typename T>
+    void add(JournalRecordType type, const T& record) { add(type, &record, sizeof(T)); }
+
+    size_t records() const { return records_; }
+
+private:
+    friend class EventJournal;
+    std::vector<char> data_;
+    size_t records_ = 0;
+    uint64_t sequence_ = 0;
+};
+
+// Append-only, event-sourced journal for a service's state. The service's
+// processing thread appends records the way it logs: a copy into a private
+// ring (binlog::ThreadRing), no syscalls. A writer thread drains the ring
+// in batches, writes each batch with one write() and commits in groups:
+// at most one fdatasync per sync interval covers everything written so far.
+//
+// Snapshots compact the journal: the writer stores the image once every
+// record it covers is on disk (temp file, fsync, rename), starts a new
+// segment file and deletes the segments the snapshot made redundant.
+// recover() maps the snapshot and the remaining segments read-only and
+// hands every record back in order, stopping at a torn or corrupt tail.
+//
+// Files: <directory>/<name>.snapshot and <name>.<first sequence>.journal
+class EventJournal {
+public:
+    using RecordHandler = std::function<void(JournalRecordType type, const void* data, size_t size)>;
+
+    explicit EventJournal(const JournalConfig& config);
+    ~EventJournal();
+
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    // Before open(): replays the snapshot's records and then every journal
+    // record after it. Appends after open() continue the sequence.
+    JournalRecovery recover(const RecordHandler& handler);
+
+    // Creates the directory and a new segment and starts the writer thread
+    // (recovering first, without a handler, if recover() was not called)
+    bool open();
+    // Writes and syncs everything appended, then stops the writer
+    void close();
+    bool is_open() const { return writer_running_.load(std::memory_order_acquire); }
+
+    // Processing thread (one thread only). Waits if the writer is a full
+    // ring behind rather than lose a record.
+    void append(JournalRecordType type, const void* data, size_t size);
+
+    template <typename T>
+    void append(JournalRecordType type, const T& record) { append(type, &record, sizeof(T)); }
+
+    // Same thread as append(): stored once the records before it are on disk.
+    // A snapshot still pending is replaced.
+    void snapshot(JournalSnapshot&& snapshot);
+
+    // Statistics (any thread)
+    uint64_t appended_sequence() const { return appended_sequence_.load(std::memory_order_relaxed); }
+    uint64_t synced_sequence() const { return synced_sequence_.load(std::memory_order_acquire); }
+    uint64_t snapshots_written() const { return snapshots_written_.load(std::memory_order_relaxed); }
+    uint64_t ring_full_waits() const { return ring_full_waits_.load(std::memory_order_relaxed); }
+    uint64_t write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+
+    static uint32_t checksum(const JournalRecordHeader& header, const void* payload);
+
+private:
+    JournalConfig config_;
+    binlog::ThreadRing ring_;
+    uint64_t next_sequence_ = 1;        // Processing thread (recover() before that)
+
+    std::thread writer_;
+    std::atomic<bool> writer_running_{false};
+    int fd_ = -1;                       // Writer thread, once open
+    std::vector<char> batch_;
+    uint64_t written_sequence_ = 0;
+
+    std::mutex snapshot_mutex_;
+    JournalSnapshot pending_snapshot_;
+    bool snapshot_pending_ = false;
+    bool recovered_ = false;
+
+    std::atomic<uint64_t> appended_sequence_{0};
+    std::atomic<uint64_t> synced_sequence_{0};
+    std::atomic<uint64_t> snapshots_written_{0};
+    std::atomic<uint64_t> ring_full_waits_{0};
+    std::atomic<uint64_t> write_errors_{0};
+
+    std::string snapshot_path() const;
+    std::string segment_path(uint64_t first_sequence) const;
+    // First sequences of the segments on disk, ascending
+    std::vector<uint64_t> list_segments() const;
+
+    void run_writer();
+    // Moves what the ring holds to the segment; false if there was nothing
+    bool write_batch();
+    void sync();
+    bool open_segment(uint64_t first_sequence);
+    void maybe_write_snapshot();
+    bool store_snapshot(const JournalSnapshot& snapshot);
+};
+
+} // namespace hft
@@ -0,0 +1,232 @@
+#include "event_loop.h"
+#include "cpu_topology.h"
+#include <zmq.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr int MAX_EVENTS = 64;
+
+// -1 if the socket can't be watched through epoll
+int zmq_fd(void* socket) {
+    int fd = -1;
+    size_t len = sizeof(fd);
+    if (!socket || zmq_getsockopt(socket, ZMQ_FD, &fd, &len) != 0) {
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+void Task::promise_type::unhandled_exception() {
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        std::cerr << "[EventLoop] Task ended by exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "[EventLoop] Task ended by unknown exception" << std::endl;
+    }
+}
+
+bool EventLoop::ZmqAwaiter::await_ready() const {
+    // Reading ZMQ_EVENTS also resets ZMQ_FD, which only signals a change
+    int events = 0;
+    size_t len = sizeof(events);
+    return socket && zmq_getsockopt(socket, ZMQ_EVENTS, &events, &len) == 0 && (events & ZMQ_POLLIN);
+}
+
+void EventLoop::ZmqAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    int fd = zmq_fd(socket);
+    if (fd >= 0) {
+        loop.watch(fd, handle);
+    } else {
+        loop.add_timer(clock::now() + FALLBACK_POLL_INTERVAL, handle);
+    }
+}
+
+EventLoop::EventLoop(const std::string& name) : name_(name) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        std::cerr << "[" << name_ << "] epoll/eventfd setup failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+}
+
+EventLoop::~EventLoop() {
+    stop();
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+}
+
+void EventLoop::start(const std::string& thread) {
+    if (running_ || epoll_fd_ < 0) return;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&EventLoop::run, this, thread);
+}
+
+void EventLoop::stop() {
+    if (running_.exchange(false)) {
+        wake();
+        if (thread_ && thread_->joinable()) {
+            thread_->join();
+        }
+        thread_.reset();
+    }
+
+    // No thread runs the loop any more, so its state is ours
+    for (void* address : tasks_) {
+        std::coroutine_handle<>::from_address(address).destroy();
+    }
+    tasks_.clear();
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        for (auto handle : spawned_) handle.destroy();
+        spawned_.clear();
+        posted_.clear();
+    }
+    for (const auto& [fd, handle] : watchers_) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    watchers_.clear();
+    timers_ = {};
+    task_count_.store(0, std::memory_order_relaxed);
+}
+
+void EventLoop::spawn(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        spawned_.push_back(std::exchange(task.handle_, nullptr));
+    }
+    wake();
+}
+
+void EventLoop::post(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        posted_.push_back(std::move(fn));
+    }
+    wake();
+}
+
+void EventLoop::wake() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void EventLoop::run(std::string thread) {
+    if (!ThreadPlan::instance().pin_current_thread(thread)) {
+        std::cerr << "[" << name_ << "] Failed to pin " << thread << " thread to its planned CPU" << std::endl;
+    }
+    loop_thread_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    epoll_event events[MAX_EVENTS];
+
+    while (running_) {
+        run_posted();
+        run_timers();
+
+        int timeout_ms = -1;
+        if (!timers_.empty()) {
+            // Round up: waking before the deadline would only wait again
+            auto wait = timers_.top().deadline - clock::now() + std::chrono::microseconds(999);
+            timeout_ms = static_cast<int>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(wait).count()));
+        }
+
+        int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "[" << name_ << "] epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+
+        for (int i = 0; i < std::max(ready, 0); ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t count;
+                ssize_t ignored = read(wake_fd_, &count, sizeof(count));
+                (void)ignored;
+                continue;
+            }
+
+            // One-shot: the task watches again if it awaits again
+            auto it = watchers_.find(fd);
+            if (it == watchers_.end()) continue;
+            std::coroutine_handle<> handle = it->second;
+            watchers_.erase(it);
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            resume(handle);
+        }
+    }
+}
+
+void EventLoop::run_posted() {
+    std::vector<std::coroutine_handle<>> spawned;
+    std::vector<std::function<void()>> posted;
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        spawned.swap(spawned_);
+        posted.swap(posted_);
+    }
+    for (auto handle : spawned) {
+        tasks_.insert(handle.address());
+        task_count_.fetch_add(1, std::memory_order_relaxed);
+        resume(handle);
+    }
+    for (auto& fn : posted) {
+        fn();
+    }
+}
+
+void EventLoop::run_timers() {
+    auto now = clock::now();
+    while (!timers_.empty() && timers_.top().deadline <= now) {
+        std::coroutine_handle<> handle = timers_.top().handle;
+        timers_.pop();
+        resume(handle);
+    }
+}
+
+void EventLoop::resume(std::coroutine_handle<> handle) {
+    handle.resume();
+    if (handle.done()) {
+        tasks_.erase(handle.address());
+        handle.destroy();
+        task_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void EventLoop::add_timer(clock::time_point deadline, std::coroutine_handle<> handle) {
+    timers_.push(Timer{deadline, timer_sequence_++, handle});
+}
+
+void EventLoop::watch(int fd, std::coroutine_handle<> handle) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        // Not pollable (or already watched): look again shortly instead
+        add_timer(clock::now() + FALLBACK_POLL_INTERVAL, handle);
+        return;
+    }
+    watchers_[fd] = handle;
+}
+
+} // namespace hft
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace hft {
+
+class EventLoop;
+
+// A coroutine run by an EventLoop. It does nothing until spawned; from then
+// on the loop owns its frame, resumes it on the loop thread whenever what
+// it awaits is ready and frees it when it returns (or when the loop stops
+// while it is suspended, so a task never needs a stop flag of its own).
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();     // Logged; the task ends
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+private:
+    friend class EventLoop;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Single-threaded reactor for the services off the trading path (control
+// API, dashboard bridge, metrics aggregation). Instead of a thread per
+// socket polling with sleep_for, each consumer is a Task that co_awaits
+// readiness, so one thread waits in epoll_wait for all of them and wakes
+// only when there is work. ZMQ sockets are watched through ZMQ_FD.
+//
+//     Task consume(EventLoop& loop, IMessageSubscriber& sub) {
+//         for (;;) {
+//             co_await loop.zmq_readable(sub.get_native_handle());
+//             while (sub.receive(buffer, size, true)) { ... }
+//         }
+//     }
+//
+// Everything but spawn(), post(), start() and stop() is for the loop thread.
+class EventLoop {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // How often zmq_readable() looks again for a socket without a ZMQ_FD
+    // (not ZMQ, or a libzmq that can't provide one)
+    static constexpr std::chrono::milliseconds FALLBACK_POLL_INTERVAL{1};
+
+    explicit EventLoop(const std::string& name);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Runs the loop on a new thread, named and pinned as ThreadPlan thread
+    void start(const std::string& thread);
+    // Joins the loop thread, then frees every task still suspended (or
+    // never started). Not from a task.
+    void stop();
+    bool is_running() const { return running_.load(); }
+    bool in_loop_thread() const { return std::this_thread::get_id() == loop_thread_id_.load(std::memory_order_relaxed); }
+
+    // Thread-safe; the task first runs on the loop thread
+    void spawn(Task task);
+    // Thread-safe; fn runs on the loop thread
+    void post(std::function<void()> fn);
+
+    struct SleepAwaiter {
+        EventLoop& loop;
+        clock::time_point deadline;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.add_timer(deadline, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct FdAwaiter {
+        EventLoop& loop;
+        int fd;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop.watch(fd, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // Resumes when the socket has a message to receive. Wakeups may be
+    // spurious; drain with non-blocking receives, then await again.
+    struct ZmqAwaiter {
+        EventLoop& loop;
+        void* socket;
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    SleepAwaiter sleep_for(clock::duration duration) { return {*this, clock::now() + duration}; }
+    SleepAwaiter sleep_until(clock::time_point deadline) { return {*this, deadline}; }
+    // Lets the other ready tasks run first, for long drains
+    SleepAwaiter yield() { return {*this, clock::time_point::min()}; }
+    // One waiter per fd at a time
+    FdAwaiter readable(int fd) { return {*this, fd}; }
+    ZmqAwaiter zmq_readable(void* socket) { return {*this, socket}; }
+
+    // Statistics
+    size_t get_task_count() const { return task_count_.load(std::memory_order_relaxed); }
+    uint64_t get_wakeups() const { return wakeups_.load(std::memory_order_relaxed); }
+
+private:
+    struct Timer {
+        clock::time_point deadline;
+        uint64_t sequence;              // FIFO among equal deadlines
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    std::string name_;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;                  // eventfd: posts and stop
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<std::thread::id> loop_thread_id_{};
+
+    std::mutex post_mutex_;
+    std::vector<std::function<void()>> posted_;
+    std::vector<std::coroutine_handle<>> spawned_;      // Not yet started
+
+    // Loop thread only (and stop() once the thread is joined)
+    std::unordered_set<void*> tasks_;   // Frames owned by the loop
+    std::unordered_map<int, std::coroutine_handle<>> watchers_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_sequence_ = 0;
+
+    std::atomic<size_t> task_count_{0};
+    std::atomic<uint64_t> wakeups_{0};
+
+    void run(std::string thread);
+    void run_posted();
+    void run_timers();
+    // Resumes a task and frees it if that finished it
+    void resume(std::coroutine_handle<> handle);
+    void add_timer(clock::time_point deadline, std::coroutine_handle<> handle);
+    void watch(int fd, std::coroutine_handle<> handle);
+    void wake();
+};
+
+} // namespace hft
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace hft {
+
+// Text builder over a caller-owned buffer, for formatting on live paths:
+// no heap, no locale, no stream state. Integers and doubles go through
+// std::to_chars. Output that does not fit is cut off and reported by
+// truncated(); the buffer is always NUL-terminated.
+//
+//   char line[128];
+//   FixedWriter out(line, sizeof(line));
+//   out << symbol << " bid=" << bid << "x" << bid_size;
+class FixedWriter {
+public:
+    FixedWriter(char* buffer, size_t capacity)
+        : begin_(buffer)
+        , out_(buffer)
+        , end_(capacity > 0 ? buffer + capacity - 1 : buffer) {
+        if (capacity > 0) *out_ = '\0';
+    }
+
+    // Digits after the point for doubles (default 4)
+    FixedWriter& precision(int digits) {
+        precision_ = digits;
+        return *this;
+    }
+
+    FixedWriter& operator<<(std::string_view text) {
+        size_t room = static_cast<size_t>(end_ - out_);
+        size_t count = text.size() <= room ? text.size() : room;
+        truncated_ = truncated_ || count < text.size();
+        std::memcpy(out_, text.data(), count);
+        out_ += count;
+        *out_ = '\0';
+        return *this;
+    }
+
+    FixedWriter& operator<<(const char* text) { return *this << std::string_view(text); }
+
+    FixedWriter& operator<<(char c) { return *this << std::string_view(&c, 1); }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                                     !std::is_same_v<T, bool>>>
+    FixedWriter& operator<<(T value) {
+        return put(std::to_chars(out_, end_, value));
+    }
+
+    FixedWriter& operator<<(double value) {
+        return put(std::to_chars(out_, end_, value, std::chars_format::fixed, precision_));
+    }
+
+    size_t size() const { return static_cast<size_t>(out_ - begin_); }
+    bool truncated() const { return truncated_; }
+    std::string_view view() const { return std::string_view(begin_, size()); }
+    const char* c_str() const { return begin_; }
+
+private:
+    char* begin_;
+    char* out_;
+    char* end_;                 // Last usable byte, kept for the NUL
+    int precision_ = 4;
+    bool truncated_ = false;
+
+    FixedWriter& put(std::to_chars_result result) {
+        if (result.ec == std::errc()) {
+            out_ = result.ptr;
+        } else {
+            truncated_ = true;  // A number is never cut in half
+        }
+        *out_ = '\0';
+        return *this;
+    }
+};
+
+// Bounded copy of text into a fixed char field, zero-filling the rest;
+// the field always ends in at least one NUL
+template<size_t N>
+inline void copy_field(char (&field)[N], std::string_view text) {
+    size_t count = text.size() < N ? text.size() : N - 1;
+    std::memcpy(field, text.data(), count);
+    std::memset(field + count, 0, N - count);
+}
+
+} // namespace hft
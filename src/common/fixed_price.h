@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+namespace hft {
+
+// Fixed-point price: signed count of 1/PRICE_SCALE currency units.
+// Wire structs and order book keys use price_t so comparisons are exact
+// integer compares; convert to double only for display and analytics.
+using price_t = int64_t;
+
+constexpr int PRICE_DECIMALS = 4;            // Matches ITCH/most US equity feeds
+constexpr price_t PRICE_SCALE = 10000;       // 10^PRICE_DECIMALS
+constexpr price_t DEFAULT_TICK = 100;        // $0.01 in fixed units
+
+inline price_t to_fixed_price(double price) {
+    return static_cast<price_t>(std::llround(price * static_cast<double>(PRICE_SCALE)));
+}
+
+constexpr double to_double_price(price_t price) {
+    return static_cast<double>(price) / static_cast<double>(PRICE_SCALE);
+}
+
+// Rescale an integer feed price with `decimals` implied decimal places
+constexpr price_t rescale_price(int64_t raw, int decimals) {
+    while (decimals < PRICE_DECIMALS) {
+        raw *= 10;
+        ++decimals;
+    }
+    while (decimals > PRICE_DECIMALS) {
+        raw /= 10;
+        --decimals;
+    }
+    return raw;
+}
+
+// Snap a price to a symbol's tick grid (round half away from zero)
+constexpr price_t round_to_tick(price_t price, price_t tick) {
+    if (tick <= 1) return price;
+    price_t half = tick / 2;
+    return price >= 0 ? ((price + half) / tick) * tick
+                      : -(((-price + half) / tick) * tick);
+}
+
+} // namespace hft
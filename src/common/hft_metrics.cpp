@@ -1,8 +1,15 @@
 #include "hft_metrics.h"
+#include "jitter_monitor.h"
+#include "pmu_counters.h"
+#include "alloc_tracker.h"
+#include "static_config.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <map>
+#include <unordered_map>
 
 #ifdef __linux__
 #include <unistd.h>
@@ -161,6 +168,77 @@ void SystemResourceMonitor::update_thread_stats() {
 #endif
 }
 
+void SystemResourceMonitor::update_thread_interference() {
+#ifdef __linux__
+    struct Interference {
+        uint64_t involuntary_switches = 0;
+        uint64_t minor_faults = 0;
+        uint64_t major_faults = 0;
+    };
+    std::map<std::string, Interference> by_name;
+    
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] == '.') continue;
+        std::string task = std::string("/proc/self/task/") + entry->d_name;
+        
+        // stat: "tid (comm) state ..." with minflt and majflt the 8th and
+        // 10th fields after the closing paren; comm may hold spaces
+        std::ifstream stat_file(task + "/stat");
+        std::string stat;
+        if (!std::getline(stat_file, stat)) continue;   // Exited meanwhile
+        size_t open = stat.find('(');
+        size_t close = stat.rfind(')');
+        if (open == std::string::npos || close == std::string::npos || close < open) continue;
+        std::string name = stat.substr(open + 1, close - open - 1);
+        std::istringstream fields(stat.substr(close + 1));
+        std::string field;
+        Interference counts;
+        for (int i = 1; i <= 10 && fields >> field; ++i) {
+            if (i == 8) counts.minor_faults = std::stoull(field);
+            if (i == 10) counts.major_faults = std::stoull(field);
+        }
+        
+        std::ifstream status_file(task + "/status");
+        std::string line;
+        while (std::getline(status_file, line)) {
+            if (line.rfind("nonvoluntary_ctxt_switches:", 0) == 0) {
+                counts.involuntary_switches = std::stoull(line.substr(line.find(':') + 1));
+                break;
+            }
+        }
+        
+        Interference& total = by_name[name];
+        total.involuntary_switches += counts.involuntary_switches;
+        total.minor_faults += counts.minor_faults;
+        total.major_faults += counts.major_faults;
+    }
+    closedir(dir);
+    
+    // Only the monitor thread gets here; names are registered once each
+    static std::unordered_map<std::string, std::array<metric_id_t, 3>> ids;
+    auto& collector = MetricsCollector::instance();
+    for (const auto& [name, total] : by_name) {
+        auto it = ids.find(name);
+        if (it == ids.end()) {
+            std::string prefix = "thread." + name;
+            std::replace(prefix.begin(), prefix.end(), ' ', '_');
+            it = ids.emplace(name, std::array<metric_id_t, 3>{
+                collector.register_metric((prefix + metrics::THREAD_INVOLUNTARY_SWITCHES_SUFFIX).c_str(), MetricType::GAUGE),
+                collector.register_metric((prefix + metrics::THREAD_MINOR_FAULTS_SUFFIX).c_str(), MetricType::GAUGE),
+                collector.register_metric((prefix + metrics::THREAD_MAJOR_FAULTS_SUFFIX).c_str(), MetricType::GAUGE)}).first;
+        }
+        collector.set_gauge(it->second[0], total.involuntary_switches);
+        collector.set_gauge(it->second[1], total.minor_faults);
+        collector.set_gauge(it->second[2], total.major_faults);
+    }
+#endif
+}
+
 // Component throughput tracker implementation
 ComponentThroughput::ComponentThroughput(const char* counter_name, const char* rate_name) 
     : counter_name_(counter_name), rate_name_(rate_name), last_count_(0) {
@@ -218,6 +296,7 @@ private:
             SystemResourceMonitor::update_cpu_usage();
             SystemResourceMonitor::update_network_stats();
             SystemResourceMonitor::update_thread_stats();
+            SystemResourceMonitor::update_thread_interference();
             
             // Update system uptime
             auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
@@ -241,11 +320,15 @@ static SystemMonitorThread g_system_monitor;
 // Initialize HFT metrics system
 void initialize_hft_metrics() {
     MetricsCollector::instance().initialize();
+    PmuCounters::set_enabled(StaticConfig::get_profiler_pmu_counters());
+    AllocTracker::set_action(AllocTracker::parse_action(StaticConfig::get_profiler_alloc_guard()));
     g_system_monitor.start();
+    JitterMonitor::instance().start();
 }
 
 // Shutdown HFT metrics system
 void shutdown_hft_metrics() {
+    JitterMonitor::instance().stop();
     g_system_monitor.stop();
     MetricsCollector::instance().shutdown();
 }
@@ -43,6 +43,18 @@ constexpr const char* SIGNAL_TO_ORDER = "signal_to_order_ns";
 constexpr const char* TICK_TO_FILL = "tick_to_fill_ns";
 constexpr const char* TICK_TO_ORDER = "tick_to_order_ns";
 
+// Per-hop latencies from TraceContext, indexed by the stage the hop ends at
+// (time since the previous stamped stage). Recorded by MetricsCollector::record_trace.
+constexpr const char* TRACE_HOP_LATENCY[] = {
+    nullptr,                        // FEED_RECEIVE starts the trace
+    "hop_receive_to_parse_ns",      // FEED_PARSE
+    "hop_parse_to_publish_ns",      // FEED_PUBLISH
+    "hop_publish_to_decision_ns",   // STRATEGY_DECISION (includes transport)
+    "hop_decision_to_risk_ns",      // RISK_CHECK (includes transport)
+    "hop_risk_to_send_ns",          // GATEWAY_SEND
+    "hop_send_to_ack_ns"            // GATEWAY_ACK (broker round trip)
+};
+
 // Backward compatibility - deprecated, use above constants
 constexpr const char* E2E_TICK_TO_SIGNAL = "tick_to_signal_ns";
 constexpr const char* E2E_SIGNAL_TO_ORDER = "signal_to_order_ns";  
@@ -60,6 +72,7 @@ constexpr const char* MESSAGES_PUBLISHED = "messages_published_total";
 constexpr const char* MESSAGES_DROPPED = "messages_dropped_total";
 constexpr const char* MESSAGES_PER_SECOND = "messages_per_second";
 constexpr const char* BYTES_RECEIVED_TOTAL = "bytes_received_total";
+constexpr const char* BATCHES_PUBLISHED = "batches_published_total";  // Multi-quote frames, one per feed packet
 
 // Backward compatibility - deprecated, use above constants
 constexpr const char* MD_MESSAGES_RECEIVED = "messages_received_total";
@@ -85,6 +98,7 @@ constexpr const char* ORDERS_SUBMITTED_TOTAL = "orders_submitted_total";
 constexpr const char* ORDERS_FILLED_TOTAL = "orders_filled_total";
 constexpr const char* ORDERS_REJECTED_TOTAL = "orders_rejected_total";
 constexpr const char* ORDERS_CANCELLED_TOTAL = "orders_cancelled_total";
+constexpr const char* ORDERS_MODIFIED_TOTAL = "orders_modified_total";    // Quote replaces sent
 constexpr const char* ORDERS_PER_SECOND = "orders_per_second";
 
 // Backward compatibility - deprecated, use above constants
@@ -99,12 +113,23 @@ constexpr const char* ORDERS_PER_SEC = "orders_per_second";
 constexpr const char* POSITIONS_UPDATED_TOTAL = "positions_updated_total";
 constexpr const char* RISK_CHECKS_TOTAL = "risk_checks_total";
 constexpr const char* RISK_VIOLATIONS_TOTAL = "risk_violations_total";
+constexpr const char* KILL_SWITCH_LATENCY = "kill_switch_latency_ns";    // Trigger to the service's halt
 
 // Backward compatibility - deprecated, use above constants
 constexpr const char* POSITIONS_UPDATED = "positions_updated_total";
 constexpr const char* RISK_CHECKS = "risk_checks_total";
 constexpr const char* RISK_VIOLATIONS = "risk_violations_total";
 
+// Logger Service
+constexpr const char* LOG_BATCHES_TOTAL = "log_batches_total";
+constexpr const char* LOG_BYTES_WRITTEN_TOTAL = "log_bytes_written_total";
+constexpr const char* LOG_WRITE_BYTES_PER_SEC = "log_write_bytes_per_second";
+constexpr const char* LOG_RECORDS_DROPPED_TOTAL = "log_records_dropped_total";
+constexpr const char* LOG_INVALID_MESSAGES_TOTAL = "log_invalid_messages_total";
+constexpr const char* LOG_WRITE_ERRORS_TOTAL = "log_write_errors_total";
+constexpr const char* LOG_BUFFER_WAITS_TOTAL = "log_buffer_waits_total";
+constexpr const char* LOG_FILE_ROTATIONS_TOTAL = "log_file_rotations_total";
+
 // =======================
 // TRADING PERFORMANCE METRICS
 // =======================
@@ -115,6 +140,8 @@ constexpr const char* POSITIONS_CLOSED_TOTAL = "positions_closed_total";
 constexpr const char* POSITION_SIZE_CURRENT = "position_size";
 constexpr const char* GROSS_EXPOSURE_USD = "gross_exposure_usd";
 constexpr const char* NET_EXPOSURE_USD = "net_exposure_usd";
+constexpr const char* BETA_EXPOSURE_USD = "beta_exposure_usd";
+constexpr const char* VALUE_AT_RISK_USD = "value_at_risk_usd";
 
 // P&L Metrics - remove prefixes, use service labels
 constexpr const char* PNL_REALIZED_USD = "pnl_realized_usd";
@@ -177,6 +204,27 @@ constexpr const char* LOCK_CONTENTION = "system.lock_contention_ns";
 constexpr const char* HFT_QUEUE_DEPTH = "system.queue_depth";
 constexpr const char* QUEUE_FULL_EVENTS = "system.queue_full_events_total";
 
+// OS interference per thread, as thread.<name><suffix> with the name from
+// /proc (the ThreadPlan name for pinned threads)
+constexpr const char* THREAD_INVOLUNTARY_SWITCHES_SUFFIX = ".involuntary_switches_total";
+constexpr const char* THREAD_MINOR_FAULTS_SUFFIX = ".minor_faults_total";
+constexpr const char* THREAD_MAJOR_FAULTS_SUFFIX = ".major_faults_total";
+
+// Heap use per thread, same naming; only with -DHFT_ALLOC_TRACKING=ON
+constexpr const char* THREAD_ALLOCATIONS_SUFFIX = ".allocations_total";
+constexpr const char* THREAD_FREES_SUFFIX = ".frees_total";
+constexpr const char* THREAD_ALLOCATED_BYTES_SUFFIX = ".allocated_bytes_total";
+constexpr const char* THREAD_ALLOC_VIOLATIONS_SUFFIX = ".alloc_guard_violations_total";   // Inside a NoAllocGuard
+
+// JitterMonitor probes, as jitter.cpu<n><suffix>
+constexpr const char* JITTER_GAP_SUFFIX = ".gap_ns";                   // Each TSC gap over jitter.threshold_ns
+constexpr const char* JITTER_INTERRUPTED_SUFFIX = ".interrupted_ppm";  // Share of the last second lost to gaps
+
+// OrderGateway venues, as venue.<name><suffix> (venue.<name> in hft_config.conf)
+constexpr const char* VENUE_ACK_LATENCY_SUFFIX = ".ack_latency_ns";            // Send to venue ack
+constexpr const char* VENUE_EXPECTED_LATENCY_SUFFIX = ".expected_latency_ns";  // What the router scores with
+constexpr const char* VENUE_ORDERS_ROUTED_SUFFIX = ".orders_routed_total";
+
 // Garbage Collection (if applicable)
 constexpr const char* GC_COLLECTIONS = "system.gc_collections_total";
 constexpr const char* GC_TIME = "system.gc_time_ms";
@@ -216,6 +264,8 @@ constexpr const char* MD_LATE_ARRIVALS = "data.md_late_arrivals_total";
 constexpr const char* MD_OUT_OF_ORDER = "data.md_out_of_order_total";
 constexpr const char* MD_STALE_QUOTES = "data.md_stale_quotes_total";
 constexpr const char* MD_FEED_LATENCY = "data.md_feed_latency_ms";
+constexpr const char* MD_MESSAGES_LOST = "data.md_messages_lost_total";
+constexpr const char* MD_LINE_DUPLICATES = "data.md_line_duplicates_total";
 
 // Data Integrity
 constexpr const char* DATA_CORRUPTION = "data.corruption_events_total";
@@ -252,39 +302,30 @@ constexpr const char* SERVICE_UPTIME = "health.uptime_seconds";
 constexpr const char* HEARTBEAT = "health.heartbeat_timestamp";
 constexpr const char* ERROR_RATE = "health.error_rate_percent";
 constexpr const char* WARNING_COUNT = "health.warnings_total";
+constexpr const char* WARMUP_COMPLETE = "health.warmup_complete";   // 1 once warmup finished
+constexpr const char* WARMUP_P99 = "health.warmup_p99_ns";          // Last warmup round's p99
+constexpr const char* WARMUP_ROUNDS = "health.warmup_rounds";
+constexpr const char* STARTUP_READY_MS = "health.startup_ready_ms";   // main() to trading-ready
 
 } // namespace metrics
 
-// RDTSC-based high precision timer for latency measurements
+// RDTSC-based high precision timer for latency measurements; fenced reads
+// so the measured region doesn't leak past either end
 class RDTSCTimer {
 private:
-    uint64_t start_ticks_;
-    const char* label_;
+    HighResTimer::ticks_t start_ticks_;
+    metric_id_t id_;
     
 public:
-    explicit RDTSCTimer(const char* label) : label_(label) {
-        start_ticks_ = __builtin_ia32_rdtsc();
+    explicit RDTSCTimer(metric_id_t id) : id_(id) {
+        start_ticks_ = HighResTimer::get_ticks_start();
     }
     
     ~RDTSCTimer() {
-        uint64_t end_ticks = __builtin_ia32_rdtsc();
-        uint64_t elapsed_ticks = end_ticks - start_ticks_;
-        
-        // Bounds checking to prevent overflow and invalid values
-        if (elapsed_ticks > 0 && elapsed_ticks < UINT64_MAX / 1000) {
-            // Convert TSC to nanoseconds with safer arithmetic
-            // Use conservative 2.5GHz base frequency to avoid division by zero
-            // and handle various CPU speeds more safely
-            uint64_t elapsed_ns = (elapsed_ticks * 1000) / 2500; // ~2.5GHz assumption
-            
-            // Sanity check: if result seems unreasonable (>1 second), cap it
-            if (elapsed_ns > 1000000000ULL) {
-                elapsed_ns = 1000000000ULL; // Cap at 1 second
-            }
-            
-            MetricsCollector::instance().record_latency(label_, elapsed_ns);
+        HighResTimer::ticks_t end_ticks = HighResTimer::get_ticks_end();
+        if (end_ticks > start_ticks_) {
+            MetricsCollector::instance().record_latency(id_, HighResTimer::ticks_to_nanoseconds(end_ticks - start_ticks_));
         }
-        // If elapsed_ticks is invalid, we simply don't record the metric
     }
 };
 
@@ -308,6 +349,9 @@ public:
     static void update_cpu_usage();
     static void update_network_stats();
     static void update_thread_stats();
+    // Involuntary context switches and page faults of every thread, summed
+    // by thread name
+    static void update_thread_interference();
 };
 
 // HFT Metrics System Initialization
@@ -315,9 +359,12 @@ void initialize_hft_metrics();
 void shutdown_hft_metrics();
 
 // Convenient macros for HFT metrics
-#define HFT_RDTSC_TIMER(label) hft::RDTSCTimer _rdtsc_timer(label)
-#define HFT_COMPONENT_COUNTER(name) hft::MetricsCollector::instance().increment_counter(name)
-#define HFT_LATENCY_NS(label, ns) hft::MetricsCollector::instance().record_latency(label, ns)
-#define HFT_GAUGE_VALUE(label, value) hft::MetricsCollector::instance().set_gauge(label, value)
+#define HFT_RDTSC_TIMER(label) hft::RDTSCTimer _rdtsc_timer(HFT_METRIC_ID(label, hft::MetricType::LATENCY))
+#define HFT_COMPONENT_COUNTER(name) \
+    hft::MetricsCollector::instance().increment_counter(HFT_METRIC_ID(name, hft::MetricType::COUNTER))
+#define HFT_LATENCY_NS(label, ns) \
+    hft::MetricsCollector::instance().record_latency(HFT_METRIC_ID(label, hft::MetricType::LATENCY), ns)
+#define HFT_GAUGE_VALUE(label, value) \
+    hft::MetricsCollector::instance().set_gauge(HFT_METRIC_ID(label, hft::MetricType::GAUGE), value)
 
 } // namespace hft
\ No newline at end of file
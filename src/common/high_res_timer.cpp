@@ -1,28 +1,196 @@
 #include "high_res_timer.h"
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <sstream>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#ifdef __x86_64__
+#include <cpuid.h>
+#endif
 
 namespace hft {
 
 // Static member definitions
-uint64_t HighResTimer::tsc_frequency_ = 0;
+#ifdef __x86_64__
+std::atomic<uint64_t> HighResTimer::ns_per_tick_{0};
+std::atomic<uint64_t> HighResTimer::ticks_per_ns_{0};
+#else
+// Ticks are steady_clock nanoseconds
+std::atomic<uint64_t> HighResTimer::ns_per_tick_{1ULL << SCALE_SHIFT};
+std::atomic<uint64_t> HighResTimer::ticks_per_ns_{1ULL << SCALE_SHIFT};
+#endif
+std::atomic<uint32_t> HighResTimer::steady_seq_{0};
+std::atomic<uint64_t> HighResTimer::steady_base_ticks_{0};
+std::atomic<uint64_t> HighResTimer::steady_base_ns_{0};
+std::atomic<uint64_t> HighResTimer::tsc_frequency_{0};
+bool HighResTimer::tsc_invariant_ = false;
 bool HighResTimer::initialized_ = false;
 
+namespace {
+
+constexpr int CALIBRATION_RUNS = 5;
+constexpr auto CALIBRATION_INTERVAL = std::chrono::milliseconds(50);
+constexpr int SAMPLE_ATTEMPTS = 8;
+constexpr int SYNC_ROUNDS = 200;
+constexpr uint64_t SKEW_WARNING_NS = 1000;
+
+// A clock reading paired with the TSC at the same instant
+struct ClockSample {
+    uint64_t ticks;
+    uint64_t ns;
+};
+
+uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// Brackets the clock read between two TSC reads and keeps the tightest
+// bracket, so a preemption or SMI in the middle doesn't skew the pair
+ClockSample sample_clock(clockid_t clock) {
+    ClockSample best{0, 0};
+    uint64_t best_window = UINT64_MAX;
+    for (int i = 0; i < SAMPLE_ATTEMPTS; ++i) {
+        uint64_t before = HighResTimer::get_ticks_start();
+        uint64_t ns = clock_ns(clock);
+        uint64_t after = HighResTimer::get_ticks_end();
+        if (after - before < best_window) {
+            best_window = after - before;
+            best = {before + (after - before) / 2, ns};
+        }
+    }
+    return best;
+}
+
+// First calibration point; recalibrate() measures from here
+ClockSample calibration_base{0, 0};
+
+// Wall clock anchor, read under a seqlock
+std::atomic<uint32_t> anchor_seq{0};
+std::atomic<uint64_t> anchor_ticks{0};
+std::atomic<uint64_t> anchor_wall_ns{0};
+
+void set_wall_anchor() {
+    ClockSample wall = sample_clock(CLOCK_REALTIME);
+    uint32_t seq = anchor_seq.load(std::memory_order_relaxed);
+    anchor_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    anchor_ticks.store(wall.ticks, std::memory_order_relaxed);
+    anchor_wall_ns.store(wall.ns, std::memory_order_relaxed);
+    anchor_seq.store(seq + 2, std::memory_order_release);
+}
+
+bool cpuid_invariant_tsc() {
+#ifdef __x86_64__
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007 &&
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return (edx & (1u << 8)) != 0;
+    }
+#endif
+    return false;
+}
+
+bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Ping-pong between two pinned threads. The remote TSC reading must fall
+// between the reference's send and receive readings; how far outside it
+// lands is skew that no amount of transfer latency explains.
+bool measure_skew(int reference_cpu, int remote_cpu, uint64_t& skew_ticks) {
+    alignas(64) std::atomic<int> request{0};
+    alignas(64) std::atomic<int> reply{0};
+    alignas(64) std::atomic<uint64_t> remote_ticks{0};
+    std::atomic<bool> abort{false};     // Either side couldn't pin
+
+    std::thread remote([&] {
+        if (!pin_to_cpu(remote_cpu)) {
+            abort.store(true);
+            return;
+        }
+        for (int round = 1; round <= SYNC_ROUNDS; ++round) {
+            while (request.load(std::memory_order_acquire) != round) {
+                if (abort.load(std::memory_order_relaxed)) return;
+                HighResTimer::cpu_relax();
+            }
+            remote_ticks.store(HighResTimer::get_ticks_end(), std::memory_order_relaxed);
+            reply.store(round, std::memory_order_release);
+        }
+    });
+
+    bool completed = false;
+    uint64_t worst = 0;
+    std::thread reference([&] {
+        if (!pin_to_cpu(reference_cpu)) {
+            abort.store(true);
+            return;
+        }
+        for (int round = 1; round <= SYNC_ROUNDS; ++round) {
+            uint64_t sent = HighResTimer::get_ticks_end();
+            request.store(round, std::memory_order_release);
+            while (reply.load(std::memory_order_acquire) != round) {
+                if (abort.load(std::memory_order_relaxed)) return;
+                HighResTimer::cpu_relax();
+            }
+            uint64_t received = HighResTimer::get_ticks_start();
+            uint64_t seen = remote_ticks.load(std::memory_order_relaxed);
+            if (seen < sent) {
+                worst = std::max(worst, sent - seen);
+            } else if (seen > received) {
+                worst = std::max(worst, seen - received);
+            }
+        }
+        completed = true;
+    });
+
+    reference.join();
+    remote.join();
+    skew_ticks = worst;
+    return completed;
+}
+
+} // namespace
+
 void HighResTimer::initialize() {
     if (initialized_) {
         return;
     }
-    
+
     std::cout << "[HighResTimer] Initializing high-precision timer..." << std::endl;
-    
+
 #ifdef __x86_64__
+    tsc_invariant_ = cpuid_invariant_tsc();
+    if (!tsc_invariant_) {
+        std::cout << "[HighResTimer] Warning: CPU does not report an invariant TSC; "
+                  << "latencies may be wrong across frequency changes" << std::endl;
+    }
+
     calibrate_tsc_frequency();
-    
-    if (tsc_frequency_ > 0) {
-        std::cout << "[HighResTimer] TSC frequency: " << tsc_frequency_ << " Hz" << std::endl;
-        std::cout << "[HighResTimer] Timer resolution: " << 
-                    (1000000000.0 / tsc_frequency_) << " ns per tick" << std::endl;
+
+    uint64_t frequency = get_tsc_frequency();
+    if (frequency > 0) {
+        std::cout << "[HighResTimer] TSC frequency: " << frequency << " Hz" << std::endl;
+        std::cout << "[HighResTimer] Timer resolution: " <<
+                    (1000000000.0 / frequency) << " ns per tick" << std::endl;
+
+        TscSyncResult sync = check_tsc_sync();
+        if (sync.cpus_checked > 0) {
+            std::cout << "[HighResTimer] Cross-core TSC skew: " << sync.max_skew_ns << " ns max over "
+                      << sync.cpus_checked << " CPUs" << std::endl;
+            if (sync.max_skew_ns > SKEW_WARNING_NS) {
+                std::cout << "[HighResTimer] Warning: TSC skew on CPU " << sync.worst_cpu
+                          << "; cross-thread latencies are unreliable" << std::endl;
+            }
+        }
         std::cout << "[HighResTimer] High-precision timing enabled" << std::endl;
     } else {
         std::cout << "[HighResTimer] Warning: TSC calibration failed, falling back to std::chrono" << std::endl;
@@ -30,61 +198,139 @@ void HighResTimer::initialize() {
 #else
     std::cout << "[HighResTimer] Warning: RDTSC not available on this architecture, using std::chrono" << std::endl;
 #endif
-    
+
+    set_wall_anchor();
     initialized_ = true;
 }
 
+void HighResTimer::set_frequency(uint64_t frequency) {
+    // The first rate starts the timeline at tick 0; later ones continue it
+    // from where the old rate has it now
+    uint64_t base_ticks = 0;
+    uint64_t base_ns = 0;
+    if (ns_per_tick_.load(std::memory_order_relaxed) != 0) {
+        base_ticks = get_ticks();
+        base_ns = ticks_to_steady_nanoseconds(base_ticks);
+    }
+    
+    uint32_t seq = steady_seq_.load(std::memory_order_relaxed);
+    steady_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    steady_base_ticks_.store(base_ticks, std::memory_order_relaxed);
+    steady_base_ns_.store(base_ns, std::memory_order_relaxed);
+    tsc_frequency_.store(frequency, std::memory_order_relaxed);
+    ns_per_tick_.store(static_cast<uint64_t>((static_cast<uint128_t>(1000000000ULL) << SCALE_SHIFT) / frequency),
+                       std::memory_order_relaxed);
+    ticks_per_ns_.store(static_cast<uint64_t>((static_cast<uint128_t>(frequency) << SCALE_SHIFT) / 1000000000ULL),
+                        std::memory_order_relaxed);
+    steady_seq_.store(seq + 2, std::memory_order_release);
+}
+
 void HighResTimer::calibrate_tsc_frequency() {
 #ifdef __x86_64__
     std::cout << "[HighResTimer] Calibrating TSC frequency..." << std::endl;
-    
-    // Use multiple calibration runs for better accuracy
-    const int num_runs = 5;
-    const auto calibration_duration = std::chrono::milliseconds(100);
-    uint64_t total_frequency = 0;
-    int valid_runs = 0;
-    
-    for (int run = 0; run < num_runs; ++run) {
-        // Get initial timestamps
-        auto chrono_start = std::chrono::steady_clock::now();
-        uint64_t tsc_start = __rdtsc();
-        
-        // Wait for calibration period
-        std::this_thread::sleep_for(calibration_duration);
-        
-        // Get final timestamps
-        auto chrono_end = std::chrono::steady_clock::now();
-        uint64_t tsc_end = __rdtsc();
-        
-        // Calculate frequencies
-        auto chrono_duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            chrono_end - chrono_start).count();
-        uint64_t tsc_ticks = tsc_end - tsc_start;
-        
-        // Calculate TSC frequency
-        if (chrono_duration_ns > 0 && tsc_ticks > 0) {
-            uint64_t frequency = (tsc_ticks * 1000000000ULL) / chrono_duration_ns;
-            total_frequency += frequency;
-            valid_runs++;
-            
-            std::cout << "[HighResTimer] Calibration run " << (run + 1) << ": " 
-                     << frequency << " Hz" << std::endl;
+
+    // The rate comes from the whole span; the per-interval estimates only
+    // show how stable it was
+    ClockSample start = sample_clock(CLOCK_MONOTONIC_RAW);
+    ClockSample previous = start;
+    std::vector<uint64_t> estimates;
+
+    for (int run = 0; run < CALIBRATION_RUNS; ++run) {
+        std::this_thread::sleep_for(CALIBRATION_INTERVAL);
+        ClockSample sample = sample_clock(CLOCK_MONOTONIC_RAW);
+        if (sample.ns > previous.ns && sample.ticks > previous.ticks) {
+            estimates.push_back((sample.ticks - previous.ticks) * 1000000000ULL / (sample.ns - previous.ns));
         }
+        previous = sample;
     }
-    
-    if (valid_runs > 0) {
-        tsc_frequency_ = total_frequency / valid_runs;
-        std::cout << "[HighResTimer] Average TSC frequency: " << tsc_frequency_ << " Hz" << std::endl;
-    } else {
+
+    if (estimates.empty() || previous.ns <= start.ns || previous.ticks <= start.ticks) {
         std::cout << "[HighResTimer] Error: All calibration runs failed" << std::endl;
-        tsc_frequency_ = 0;
+        return;
+    }
+
+    uint64_t frequency = static_cast<uint64_t>(
+        static_cast<uint128_t>(previous.ticks - start.ticks) * 1000000000ULL / (previous.ns - start.ns));
+    auto [low, high] = std::minmax_element(estimates.begin(), estimates.end());
+    std::cout << "[HighResTimer] Calibration spread: " << ((*high - *low) * 1000000 / frequency)
+              << " ppm over " << estimates.size() << " intervals" << std::endl;
+
+    calibration_base = start;
+    set_frequency(frequency);
+#endif
+}
+
+void HighResTimer::recalibrate() {
+#ifdef __x86_64__
+    if (!initialized_ || calibration_base.ns == 0) {
+        return;
+    }
+
+    ClockSample now = sample_clock(CLOCK_MONOTONIC_RAW);
+    if (now.ns > calibration_base.ns && now.ticks > calibration_base.ticks) {
+        set_frequency(static_cast<uint64_t>(
+            static_cast<uint128_t>(now.ticks - calibration_base.ticks) * 1000000000ULL /
+            (now.ns - calibration_base.ns)));
     }
 #endif
+    set_wall_anchor();
+}
+
+uint64_t HighResTimer::ticks_to_wall_nanoseconds(ticks_t ticks) {
+    uint32_t seq;
+    uint64_t base_ticks, base_ns;
+    do {
+        seq = anchor_seq.load(std::memory_order_acquire);
+        base_ticks = anchor_ticks.load(std::memory_order_relaxed);
+        base_ns = anchor_wall_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != anchor_seq.load(std::memory_order_relaxed));
+
+    if (seq == 0) {
+        return clock_ns(CLOCK_REALTIME);    // Not initialized yet
+    }
+    return ticks >= base_ticks ? base_ns + ticks_to_nanoseconds(ticks - base_ticks)
+                               : base_ns - ticks_to_nanoseconds(base_ticks - ticks);
+}
+
+TscSyncResult HighResTimer::check_tsc_sync(int max_cpus) {
+    TscSyncResult result;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return result;
+    }
+
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+    if (cpus.size() < 2) {
+        return result;
+    }
+
+    uint64_t worst_ticks = 0;
+    for (size_t i = 1; i < cpus.size() && result.cpus_checked < max_cpus; ++i) {
+        uint64_t skew_ticks;
+        if (!measure_skew(cpus[0], cpus[i], skew_ticks)) {
+            continue;
+        }
+        result.cpus_checked++;
+        if (skew_ticks > worst_ticks || result.worst_cpu < 0) {
+            worst_ticks = skew_ticks;
+            result.worst_cpu = cpus[i];
+        }
+    }
+    result.max_skew_ns = ticks_to_nanoseconds(worst_ticks);
+    return result;
 }
 
 std::string HighResTimer::get_timer_info() {
     std::ostringstream oss;
-    
+    uint64_t frequency = get_tsc_frequency();
+
     oss << "HighResTimer Info:\n";
     oss << "  Architecture: ";
 #ifdef __x86_64__
@@ -92,28 +338,29 @@ std::string HighResTimer::get_timer_info() {
 #else
     oss << "Non-x86 (using std::chrono)\n";
 #endif
-    
+
     oss << "  Initialized: " << (initialized_ ? "Yes" : "No") << "\n";
-    
-    if (initialized_ && tsc_frequency_ > 0) {
-        oss << "  TSC Frequency: " << tsc_frequency_ << " Hz\n";
-        oss << "  Resolution: " << (1000000000.0 / tsc_frequency_) << " ns per tick\n";
+
+    if (initialized_ && frequency > 0) {
+        oss << "  TSC Frequency: " << frequency << " Hz\n";
+        oss << "  Invariant TSC: " << (tsc_invariant_ ? "Yes" : "No") << "\n";
+        oss << "  Resolution: " << (1000000000.0 / frequency) << " ns per tick\n";
         oss << "  High Precision: Available\n";
-        
+
         // Test timing accuracy
-        auto start = get_ticks();
+        auto start = get_ticks_start();
         std::this_thread::sleep_for(std::chrono::microseconds(1));
-        auto end = get_ticks();
-        
+        auto end = get_ticks_end();
+
         oss << "  Test 1μs delay: " << ticks_to_nanoseconds(end - start) << " ns measured\n";
     } else {
         oss << "  High Precision: Unavailable (fallback to std::chrono)\n";
-        oss << "  Resolution: ~" << 
-            std::chrono::steady_clock::period::num * 1000000000LL / 
+        oss << "  Resolution: ~" <<
+            std::chrono::steady_clock::period::num * 1000000000LL /
             std::chrono::steady_clock::period::den << " ns\n";
     }
-    
+
     return oss.str();
 }
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <string>
@@ -10,8 +11,26 @@
 
 namespace hft {
 
+// 128-bit intermediate for tick conversions; __extension__ keeps the GNU
+// type quiet under -Wpedantic
+__extension__ typedef unsigned __int128 uint128_t;
+
+// Result of HighResTimer::check_tsc_sync()
+struct TscSyncResult {
+    int cpus_checked = 0;
+    int worst_cpu = -1;
+    uint64_t max_skew_ns = 0;       // Largest skew proven against the reference CPU
+};
+
 // High-precision timer using RDTSC instruction for sub-nanosecond timing
-// Critical for measuring HFT latencies where every nanosecond counts
+// Critical for measuring HFT latencies where every nanosecond counts.
+//
+// The one clock every latency number goes through: initialize() checks for
+// an invariant TSC, calibrates it against CLOCK_MONOTONIC_RAW and looks for
+// skew between cores; recalibrate() refines the rate over a growing baseline
+// and re-anchors wall time. Tick to nanosecond conversion is a multiply and
+// shift, and ticks_to_wall_nanoseconds() maps a TSC reading onto
+// CLOCK_REALTIME so it compares with exchange timestamps.
 class HighResTimer {
 public:
     using ticks_t = uint64_t;
@@ -19,6 +38,10 @@ public:
     // Initialize timer and calibrate TSC frequency
     static void initialize();
     
+    // Re-estimate the frequency from the initial calibration point to now
+    // and re-anchor wall time; the metrics collector calls this periodically
+    static void recalibrate();
+    
     // Get current timestamp in CPU ticks (highest precision)
     static inline ticks_t get_ticks() {
 #ifdef __x86_64__
@@ -29,43 +52,120 @@ public:
 #endif
     }
     
+    // Fenced reads for timing a code region: the start read waits for earlier
+    // instructions to finish, and later instructions don't begin before the
+    // end read. get_ticks() is cheaper but can drift into the measured code.
+    static inline ticks_t get_ticks_start() {
+#ifdef __x86_64__
+        _mm_lfence();
+        return __rdtsc();
+#else
+        return get_ticks();
+#endif
+    }
+    
+    static inline ticks_t get_ticks_end() {
+#ifdef __x86_64__
+        unsigned int aux;
+        ticks_t ticks = __rdtscp(&aux);
+        _mm_lfence();
+        return ticks;
+#else
+        return get_ticks();
+#endif
+    }
+    
+    // Spin-wait hint for busy loops polling on the clock or a queue
+    static inline void cpu_relax() {
+#ifdef __x86_64__
+        _mm_pause();
+#endif
+    }
+    
     // Get current timestamp in nanoseconds (calibrated)
     static inline uint64_t get_nanoseconds() {
-        return ticks_to_nanoseconds(get_ticks());
+        return ticks_to_steady_nanoseconds(get_ticks());
     }
     
-    // Convert ticks to nanoseconds using calibrated frequency
+    // A TSC reading on the get_nanoseconds() timeline. The timeline is
+    // re-anchored whenever recalibrate() changes the rate, so it stays
+    // continuous: intervals that span a recalibration are still right.
+    static inline uint64_t ticks_to_steady_nanoseconds(ticks_t ticks) {
+        uint32_t seq;
+        uint64_t base_ticks, base_ns, factor;
+        do {
+            seq = steady_seq_.load(std::memory_order_acquire);
+            base_ticks = steady_base_ticks_.load(std::memory_order_relaxed);
+            base_ns = steady_base_ns_.load(std::memory_order_relaxed);
+            factor = ns_per_tick_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != steady_seq_.load(std::memory_order_relaxed));
+        return ticks >= base_ticks ? base_ns + scale(ticks - base_ticks, factor)
+                                   : base_ns - scale(base_ticks - ticks, factor);
+    }
+    
+    // Convert a tick interval to nanoseconds using calibrated frequency (0
+    // before initialize() on x86). For absolute readings use
+    // ticks_to_steady_nanoseconds(), which survives recalibration.
     static inline uint64_t ticks_to_nanoseconds(ticks_t ticks) {
-
-        return (ticks * 1000000000ULL) / tsc_frequency_;
+        return scale(ticks, ns_per_tick_.load(std::memory_order_relaxed));
     }
     
     // Convert nanoseconds to ticks
     static inline ticks_t nanoseconds_to_ticks(uint64_t nanoseconds) {
-
-        return (nanoseconds * tsc_frequency_) / 1000000000ULL;
+        return scale(nanoseconds, ticks_per_ns_.load(std::memory_order_relaxed));
     }
     
+    // CLOCK_REALTIME nanoseconds at the given TSC reading
+    static uint64_t ticks_to_wall_nanoseconds(ticks_t ticks);
+    static uint64_t get_wall_nanoseconds() { return ticks_to_wall_nanoseconds(get_ticks()); }
+    
     // Get TSC frequency in Hz
-    static uint64_t get_tsc_frequency() { return tsc_frequency_; }
+    static uint64_t get_tsc_frequency() { return tsc_frequency_.load(std::memory_order_relaxed); }
+    
+    // CPUID says the TSC runs at a constant rate through P/C-states
+    static bool is_tsc_invariant() { return tsc_invariant_; }
     
     // Check if high-precision timing is available
     static bool is_high_precision_available() { 
 #ifdef __x86_64__
-        return tsc_frequency_ > 0;
+        return get_tsc_frequency() > 0;
 #else
         return false;
 #endif
     }
     
+    // Ping-pongs a cache line between the first allowed CPU and up to
+    // max_cpus others, comparing TSC readings on both sides. Skew smaller
+    // than the round trip can't be seen, so a 0 result is an upper bound of
+    // roughly one cache-line transfer.
+    static TscSyncResult check_tsc_sync(int max_cpus = 64);
+    
     // Calibration info
     static std::string get_timer_info();
 
 private:
-    static uint64_t tsc_frequency_;  // TSC frequency in Hz
+    // Conversions are value * factor / 2^48: under 2 ns of rounding over days
+    // of ticks, and a factor fits 64 bits for counters from 1 MHz to 10 GHz
+    static constexpr int SCALE_SHIFT = 48;
+    
+    static std::atomic<uint64_t> ns_per_tick_;
+    static std::atomic<uint64_t> ticks_per_ns_;
+    // get_nanoseconds() anchor, written with ns_per_tick_ under a seqlock
+    static std::atomic<uint32_t> steady_seq_;
+    static std::atomic<uint64_t> steady_base_ticks_;
+    static std::atomic<uint64_t> steady_base_ns_;
+    static std::atomic<uint64_t> tsc_frequency_;  // TSC frequency in Hz
+    static bool tsc_invariant_;
     static bool initialized_;
     
-    // Calibrate TSC frequency against std::chrono
+    static inline uint64_t scale(uint64_t value, uint64_t factor) {
+        return static_cast<uint64_t>((static_cast<uint128_t>(value) * factor) >> SCALE_SHIFT);
+    }
+    
+    static void set_frequency(uint64_t frequency);
+    
+    // Calibrate TSC frequency against CLOCK_MONOTONIC_RAW
     static void calibrate_tsc_frequency();
 };
 
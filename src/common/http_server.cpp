@@ -0,0 +1,717 @@
+#include "http_server.h"
+#include "cpu_topology.h"
+#include <algorithm>
+#include <array>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr const char* WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+constexpr uint8_t OPCODE_TEXT = 0x1;
+constexpr uint8_t OPCODE_BINARY = 0x2;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+constexpr int MAX_EVENTS = 64;
+constexpr size_t READ_CHUNK = 16384;
+
+std::string to_lower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string trim(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(begin, end - begin + 1);
+}
+
+// SHA-1 is only needed for the WebSocket handshake
+std::array<uint8_t, 20> sha1(const std::string& input) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    auto rotl = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+
+    std::string data = input;
+    uint64_t bit_length = static_cast<uint64_t>(input.size()) * 8;
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) data.push_back(0);
+    for (int i = 7; i >= 0; --i) data.push_back(static_cast<char>(bit_length >> (i * 8)));
+
+    for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const uint8_t*>(data.data() + chunk + i * 4);
+            w[i] = (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i) w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);           k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                    k = 0xCA62C1D6; }
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rotl(b, 30); b = a; a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (int i = 0; i < 20; ++i) digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+    return digest;
+}
+
+std::string base64(const uint8_t* data, size_t len) {
+    static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t n = uint32_t{data[i]} << 16;
+        if (i + 1 < len) n |= uint32_t{data[i + 1]} << 8;
+        if (i + 2 < len) n |= data[i + 2];
+        out.push_back(table[(n >> 18) & 63]);
+        out.push_back(table[(n >> 12) & 63]);
+        out.push_back(i + 1 < len ? table[(n >> 6) & 63] : '=');
+        out.push_back(i + 2 < len ? table[n & 63] : '=');
+    }
+    return out;
+}
+
+std::string serialize(const HttpResponse& response, bool keep_alive) {
+    std::ostringstream out;
+    out << "HTTP/1.1 " << response.status << " " << response.status_text << "\r\n";
+    out << "Content-Type: " << response.content_type << "\r\n";
+    out << "Access-Control-Allow-Origin: *\r\n";
+    for (const auto& [name, value] : response.headers) {
+        out << name << ": " << value << "\r\n";
+    }
+    out << "Content-Length: " << response.body.size() << "\r\n";
+    out << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
+    out << "\r\n";
+    out << response.body;
+    return out.str();
+}
+
+// Parses the head of a request (everything before the blank line)
+bool parse_head(const std::string& head, HttpRequest& request) {
+    std::istringstream stream(head);
+    std::string line;
+    if (!std::getline(stream, line)) return false;
+
+    std::istringstream request_line(line);
+    std::string target;
+    request_line >> request.method >> target >> request.version;
+    if (request.method.empty() || target.empty()) return false;
+
+    size_t query = target.find('?');
+    request.path = target.substr(0, query);
+    request.query = query == std::string::npos ? "" : target.substr(query + 1);
+
+    while (std::getline(stream, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        request.headers[to_lower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+    }
+    return true;
+}
+
+} // namespace
+
+const std::string& HttpRequest::header(const std::string& name) const {
+    static const std::string empty;
+    auto it = headers.find(to_lower(name));
+    return it != headers.end() ? it->second : empty;
+}
+
+std::string HttpRequest::query_parameter(const std::string& name) const {
+    size_t pos = 0;
+    while (pos <= query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) end = query.size();
+        if (query.compare(pos, name.size(), name) == 0 && pos + name.size() < end && query[pos + name.size()] == '=') {
+            return query.substr(pos + name.size() + 1, end - pos - name.size() - 1);
+        }
+        pos = end + 1;
+    }
+    return "";
+}
+
+HttpResponse HttpResponse::json(std::string body, int status, std::string status_text) {
+    HttpResponse response;
+    response.status = status;
+    response.status_text = std::move(status_text);
+    response.content_type = "application/json";
+    response.body = std::move(body);
+    return response;
+}
+
+HttpResponse HttpResponse::text(std::string body, int status, std::string status_text) {
+    HttpResponse response;
+    response.status = status;
+    response.status_text = std::move(status_text);
+    response.body = std::move(body);
+    return response;
+}
+
+std::string websocket_accept_key(const std::string& client_key) {
+    auto digest = sha1(client_key + WEBSOCKET_GUID);
+    return base64(digest.data(), digest.size());
+}
+
+std::string websocket_frame(const std::string& payload, uint8_t opcode) {
+    // Server frames are never masked
+    std::string frame;
+    frame.reserve(payload.size() + 10);
+    frame.push_back(static_cast<char>(0x80 | opcode));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        frame.push_back(static_cast<char>(126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size()));
+    } else {
+        frame.push_back(static_cast<char>(127));
+        for (int i = 7; i >= 0; --i) frame.push_back(static_cast<char>(static_cast<uint64_t>(payload.size()) >> (i * 8)));
+    }
+    frame += payload;
+    return frame;
+}
+
+HttpServer::HttpServer(const std::string& name) : name_(name) {}
+
+HttpServer::~HttpServer() {
+    stop();
+    if (listen_fd_ >= 0) close(listen_fd_);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+}
+
+void HttpServer::set_websocket_protocols(std::vector<std::string> protocols) {
+    if (protocols.size() > MAX_SUBPROTOCOLS) {
+        protocols.resize(MAX_SUBPROTOCOLS);
+    }
+    protocols_ = std::move(protocols);
+}
+
+int HttpServer::protocol_index(const std::string& protocol) const {
+    if (protocol.empty()) return 0;
+    for (size_t i = 0; i < protocols_.size(); ++i) {
+        if (protocols_[i] == protocol) return static_cast<int>(i + 1);
+    }
+    return -1;
+}
+
+size_t HttpServer::get_websocket_client_count(const std::string& protocol) const {
+    int index = protocol_index(protocol);
+    return index < 0 ? 0 : protocol_clients_[index].load(std::memory_order_relaxed);
+}
+
+void HttpServer::set_timer(std::chrono::milliseconds interval, TimerHandler handler) {
+    timer_interval_ = interval;
+    timer_handler_ = std::move(handler);
+}
+
+bool HttpServer::listen(const std::string& address, uint16_t port, int backlog) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "[" << name_ << "] socket failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#ifdef SO_REUSEPORT
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "[" << name_ << "] Invalid listen address " << address << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, backlog) < 0) {
+        std::cerr << "[" << name_ << "] Failed to listen on " << address << ":" << port
+                  << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    bound_port_ = ntohs(addr.sin_port);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        std::cerr << "[" << name_ << "] epoll/eventfd setup failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+    event.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+    return true;
+}
+
+void HttpServer::start() {
+    if (running_ || listen_fd_ < 0) return;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&HttpServer::run, this);
+}
+
+void HttpServer::stop() {
+    if (!running_.exchange(false)) return;
+    wake();
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+
+    std::vector<int> fds;
+    for (const auto& [fd, conn] : connections_) fds.push_back(fd);
+    for (int fd : fds) close_connection(fd);
+}
+
+void HttpServer::broadcast(const std::string& message, const std::string& protocol, bool binary,
+                           Delivery delivery) {
+    int index = protocol_index(protocol);
+    if (index < 0) return;
+
+    Broadcast broadcast{std::make_shared<const std::string>(websocket_frame(message, binary ? OPCODE_BINARY : OPCODE_TEXT)),
+                        static_cast<uint8_t>(index), delivery};
+    if (std::this_thread::get_id() == reactor_thread_id_.load(std::memory_order_relaxed)) {
+        fan_out(broadcast);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(broadcast_mutex_);
+        pending_broadcasts_.push_back(std::move(broadcast));
+    }
+    wake();
+}
+
+bool HttpServer::send(connection_id_t client, const std::string& message, bool binary) {
+    for (auto& [fd, conn] : connections_) {
+        if (conn->id != client) continue;
+        if (!conn->websocket || conn->close_after_send) return false;
+        if (!queue(*conn, std::make_shared<const std::string>(websocket_frame(message, binary ? OPCODE_BINARY : OPCODE_TEXT)))) {
+            abandon(*conn);
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+void HttpServer::wake() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void HttpServer::run() {
+    if (!ThreadPlan::instance().pin_current_thread("http")) {
+        std::cerr << "[HttpServer] Failed to pin http thread to its planned CPU" << std::endl;
+    }
+    reactor_thread_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    epoll_event events[MAX_EVENTS];
+    auto now = std::chrono::steady_clock::now();
+    auto next_timer = now + timer_interval_;
+    auto next_sweep = now + std::chrono::seconds(1);
+
+    while (running_) {
+        now = std::chrono::steady_clock::now();
+        auto deadline = next_sweep;
+        if (timer_handler_ && next_timer < deadline) deadline = next_timer;
+        int timeout_ms = static_cast<int>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()));
+
+        int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "[" << name_ << "] epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < std::max(ready, 0); ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd_) {
+                accept_connections();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                uint64_t count;
+                ssize_t ignored = read(wake_fd_, &count, sizeof(count));
+                (void)ignored;
+                fan_out_broadcasts();
+                continue;
+            }
+
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            Connection& conn = *it->second;
+
+            bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (alive && (events[i].events & EPOLLIN)) alive = on_readable(conn);
+            if (alive && (events[i].events & EPOLLOUT)) alive = flush(conn);
+            if (!alive) close_connection(fd);
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (timer_handler_ && now >= next_timer) {
+            timer_handler_();
+            next_timer = now + timer_interval_;
+        }
+        if (now >= next_sweep) {
+            close_idle(now);
+            next_sweep = now + std::chrono::seconds(1);
+        }
+    }
+}
+
+void HttpServer::accept_connections() {
+    for (;;) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;     // EAGAIN, or an error the next wakeup will retry
+        }
+        if (connections_.size() >= max_connections_) {
+            connections_rejected_.fetch_add(1, std::memory_order_relaxed);
+            close(fd);
+            continue;
+        }
+
+        int opt = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+        auto conn = std::make_unique<Connection>();
+        conn->fd = fd;
+        conn->id = next_id_++;
+        conn->last_active = std::chrono::steady_clock::now();
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        connections_[fd] = std::move(conn);
+        connection_count_.store(connections_.size(), std::memory_order_relaxed);
+    }
+}
+
+bool HttpServer::on_readable(Connection& conn) {
+    char buffer[READ_CHUNK];
+    for (;;) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn.input.append(buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == 0) return false;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        return false;
+    }
+
+    conn.last_active = std::chrono::steady_clock::now();
+    if (conn.close_after_send) {
+        conn.input.clear();     // Answered already, just draining
+        return true;
+    }
+    return conn.websocket ? process_websocket(conn) : process_http(conn);
+}
+
+bool HttpServer::process_http(Connection& conn) {
+    // Pipelined requests are answered in order
+    while (!conn.websocket && !conn.close_after_send) {
+        size_t head_end = conn.input.find("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            if (conn.input.size() > MAX_REQUEST_SIZE) {
+                conn.close_after_send = true;
+                return queue(conn, std::make_shared<const std::string>(
+                    serialize(HttpResponse::text("Request too large", 413, "Request Entity Too Large"), false)));
+            }
+            return true;
+        }
+
+        HttpRequest request;
+        if (!parse_head(conn.input.substr(0, head_end), request)) {
+            conn.close_after_send = true;
+            return queue(conn, std::make_shared<const std::string>(
+                serialize(HttpResponse::text("Invalid request", 400, "Bad Request"), false)));
+        }
+
+        size_t body_length = 0;
+        const std::string& content_length = request.header("content-length");
+        if (!content_length.empty()) {
+            body_length = std::strtoull(content_length.c_str(), nullptr, 10);
+        }
+        // Checked before the sum, which a huge Content-Length would wrap
+        if (body_length > MAX_REQUEST_SIZE || head_end + 4 + body_length > MAX_REQUEST_SIZE) {
+            conn.close_after_send = true;
+            return queue(conn, std::make_shared<const std::string>(
+                serialize(HttpResponse::text("Request too large", 413, "Request Entity Too Large"), false)));
+        }
+        size_t total = head_end + 4 + body_length;
+        if (conn.input.size() < total) {
+            return true;    // Body still arriving
+        }
+
+        request.body = conn.input.substr(head_end + 4, body_length);
+        conn.input.erase(0, total);
+        if (!handle_request(conn, request)) {
+            return false;
+        }
+    }
+
+    // Frames sent right behind the upgrade request
+    return conn.websocket && !conn.input.empty() ? process_websocket(conn) : true;
+}
+
+bool HttpServer::handle_request(Connection& conn, const HttpRequest& request) {
+    requests_served_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!websocket_path_.empty() && request.path == websocket_path_ &&
+        to_lower(request.header("upgrade")) == "websocket" && !request.header("sec-websocket-key").empty()) {
+        // First subprotocol the client offers that we support
+        uint8_t protocol = 0;
+        std::istringstream offered(request.header("sec-websocket-protocol"));
+        std::string name;
+        while (protocol == 0 && std::getline(offered, name, ',')) {
+            protocol = static_cast<uint8_t>(std::max(protocol_index(trim(name)), 0));
+        }
+
+        std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                               "Upgrade: websocket\r\n"
+                               "Connection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: " + websocket_accept_key(request.header("sec-websocket-key")) + "\r\n";
+        if (protocol != 0) {
+            response += "Sec-WebSocket-Protocol: " + protocols_[protocol - 1] + "\r\n";
+        }
+        response += "\r\n";
+        conn.websocket = true;
+        conn.protocol = protocol;
+        websocket_clients_.fetch_add(1, std::memory_order_relaxed);
+        protocol_clients_[protocol].fetch_add(1, std::memory_order_relaxed);
+        if (!queue(conn, std::make_shared<const std::string>(std::move(response)))) {
+            return false;
+        }
+        if (open_handler_) {
+            open_handler_(conn.id, protocol == 0 ? std::string() : protocols_[protocol - 1]);
+        }
+        return true;
+    }
+
+    std::string connection = to_lower(request.header("connection"));
+    bool keep_alive = request.version == "HTTP/1.0" ? connection == "keep-alive" : connection != "close";
+
+    HttpResponse response;
+    try {
+        response = request_handler_ ? request_handler_(request)
+                                    : HttpResponse::text("Endpoint not found", 404, "Not Found");
+    } catch (const std::exception& e) {
+        std::cerr << "[" << name_ << "] Handler for " << request.path << " failed: " << e.what() << std::endl;
+        response = HttpResponse::text("Internal error", 500, "Internal Server Error");
+    }
+
+    if (!keep_alive) {
+        conn.close_after_send = true;
+    }
+    return queue(conn, std::make_shared<const std::string>(serialize(response, keep_alive)));
+}
+
+bool HttpServer::process_websocket(Connection& conn) {
+    while (conn.input.size() >= 2) {
+        const auto* p = reinterpret_cast<const uint8_t*>(conn.input.data());
+        bool fin = p[0] & 0x80;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = p[1] & 0x80;
+        uint64_t length = p[1] & 0x7F;
+        size_t offset = 2;
+
+        if (length == 126) {
+            if (conn.input.size() < 4) return true;
+            length = (uint64_t{p[2]} << 8) | p[3];
+            offset = 4;
+        } else if (length == 127) {
+            if (conn.input.size() < 10) return true;
+            length = 0;
+            for (int i = 0; i < 8; ++i) length = (length << 8) | p[2 + i];
+            offset = 10;
+        }
+
+        // Client frames must be masked
+        if (!masked || length + conn.message.size() > MAX_WEBSOCKET_MESSAGE) {
+            conn.close_after_send = true;
+            conn.input.clear();
+            return queue(conn, std::make_shared<const std::string>(websocket_frame("", OPCODE_CLOSE)));
+        }
+        if (conn.input.size() < offset + 4 + length) return true;
+
+        const uint8_t* mask = p + offset;
+        std::string payload(conn.input, offset + 4, length);
+        for (size_t i = 0; i < payload.size(); ++i) payload[i] ^= static_cast<char>(mask[i % 4]);
+        conn.input.erase(0, offset + 4 + length);
+
+        switch (opcode) {
+            case OPCODE_CLOSE:
+                conn.close_after_send = true;
+                conn.input.clear();
+                return queue(conn, std::make_shared<const std::string>(websocket_frame(payload, OPCODE_CLOSE)));
+            case OPCODE_PING:
+                if (!queue(conn, std::make_shared<const std::string>(websocket_frame(payload, 0xA)))) return false;
+                break;
+            case OPCODE_TEXT:
+            case OPCODE_BINARY:
+            case OPCODE_CONTINUATION:
+                conn.message += payload;
+                if (fin) {
+                    if (websocket_handler_) websocket_handler_(conn.id, conn.message);
+                    conn.message.clear();
+                }
+                break;
+            default:
+                break;  // Pong and reserved opcodes
+        }
+    }
+    return true;
+}
+
+bool HttpServer::queue(Connection& conn, Buffer buffer) {
+    conn.queued_bytes += buffer->size();
+    conn.output.push_back(std::move(buffer));
+    return flush(conn);
+}
+
+bool HttpServer::flush(Connection& conn) {
+    while (!conn.output.empty()) {
+        const std::string& front = *conn.output.front();
+        ssize_t sent = ::send(conn.fd, front.data() + conn.output_offset, front.size() - conn.output_offset,
+                              MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        conn.output_offset += static_cast<size_t>(sent);
+        if (conn.output_offset == front.size()) {
+            conn.queued_bytes -= front.size();
+            conn.output.pop_front();
+            conn.output_offset = 0;
+        }
+    }
+
+    if (conn.output.empty() && conn.close_after_send) {
+        return false;
+    }
+    update_interest(conn);
+    return true;
+}
+
+void HttpServer::update_interest(Connection& conn) {
+    bool want_write = !conn.output.empty();
+    if (want_write == conn.want_write) return;
+    conn.want_write = want_write;
+
+    epoll_event event{};
+    event.events = EPOLLIN | (want_write ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = conn.fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &event);
+}
+
+void HttpServer::close_connection(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    if (it->second->websocket) {
+        websocket_clients_.fetch_sub(1, std::memory_order_relaxed);
+        protocol_clients_[it->second->protocol].fetch_sub(1, std::memory_order_relaxed);
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(it);
+    connection_count_.store(connections_.size(), std::memory_order_relaxed);
+}
+
+void HttpServer::fan_out_broadcasts() {
+    std::vector<Broadcast> broadcasts;
+    {
+        std::lock_guard<std::mutex> lock(broadcast_mutex_);
+        broadcasts.swap(pending_broadcasts_);
+    }
+
+    for (const Broadcast& broadcast : broadcasts) {
+        fan_out(broadcast);
+    }
+}
+
+void HttpServer::fan_out(const Broadcast& broadcast) {
+    broadcasts_.fetch_add(1, std::memory_order_relaxed);
+    for (auto& [fd, conn] : connections_) {
+        if (!conn->websocket || conn->close_after_send || conn->protocol != broadcast.protocol) continue;
+        if (conn->queued_bytes > send_queue_limit_) {
+            if (broadcast.delivery == Delivery::LATEST) {
+                // Backlogged client: the next broadcast supersedes this one
+                broadcasts_skipped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (conn->queued_bytes > 2 * send_queue_limit_) {
+                // Too far behind to be given every event; it reconnects to a fresh snapshot
+                slow_clients_dropped_.fetch_add(1, std::memory_order_relaxed);
+                abandon(*conn);
+                continue;
+            }
+        }
+        if (!queue(*conn, broadcast.frame)) {
+            abandon(*conn);
+        }
+    }
+}
+
+void HttpServer::abandon(Connection& conn) {
+    // May run inside a handler for this very connection, so rather than
+    // closing here let epoll report the hangup to the reactor loop
+    conn.close_after_send = true;
+    ::shutdown(conn.fd, SHUT_RDWR);
+}
+
+void HttpServer::close_idle(std::chrono::steady_clock::time_point now) {
+    std::vector<int> idle;
+    for (const auto& [fd, conn] : connections_) {
+        // WebSocket clients stay connected for as long as they like
+        if (!conn->websocket && now - conn->last_active > idle_timeout_) {
+            idle.push_back(fd);
+        }
+    }
+    for (int fd : idle) close_connection(fd);
+}
+
+} // namespace hft
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hft {
+
+struct HttpRequest {
+    std::string method;
+    std::string path;                               // Without the query string
+    std::string query;
+    std::string version;
+    std::map<std::string, std::string> headers;     // Names lowercased
+    std::string body;
+
+    // Case-insensitive lookup; empty if absent
+    const std::string& header(const std::string& name) const;
+    // Value of name=value in the query string, as sent (no percent
+    // decoding); empty if absent
+    std::string query_parameter(const std::string& name) const;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string status_text = "OK";
+    std::string content_type = "text/plain";
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;  // Extra headers
+
+    static HttpResponse json(std::string body, int status = 200, std::string status_text = "OK");
+    static HttpResponse text(std::string body, int status = 200, std::string status_text = "OK");
+};
+
+// Non-blocking epoll reactor for the dashboard-facing HTTP servers. One
+// thread serves every connection: HTTP/1.1 keep-alive with pipelining, and
+// WebSocket upgrades on a configured path. Each connection has its own send
+// queue; broadcasts are framed once and the same buffer is queued to every
+// WebSocket client. A client whose queue is over the limit skips state
+// broadcasts until it catches up instead of growing without bound; event
+// broadcasts are still queued, and a client twice the limit behind on
+// those is disconnected rather than silently missing one.
+// Clients may negotiate a subprotocol (Sec-WebSocket-Protocol); broadcasts
+// target the clients of one subprotocol, "" being clients without one.
+class HttpServer {
+public:
+    using connection_id_t = uint64_t;
+    using RequestHandler = std::function<HttpResponse(const HttpRequest&)>;
+    using WebSocketHandler = std::function<void(connection_id_t client, const std::string& message)>;
+    using WebSocketOpenHandler = std::function<void(connection_id_t client, const std::string& protocol)>;
+    using TimerHandler = std::function<void()>;
+
+    // How a broadcast treats a client whose send queue is over the limit
+    enum class Delivery : uint8_t {
+        LATEST,     // State the next broadcast supersedes: skipped
+        EVERY       // Events (executions): queued, or the client is dropped
+    };
+
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;          // Headers and body
+    static constexpr size_t MAX_WEBSOCKET_MESSAGE = 65536;
+    static constexpr size_t DEFAULT_MAX_CONNECTIONS = 256;
+    static constexpr size_t DEFAULT_SEND_QUEUE_LIMIT = 1024 * 1024;
+    static constexpr size_t MAX_SUBPROTOCOLS = 4;
+
+    explicit HttpServer(const std::string& name);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Configuration, before start()
+    void set_request_handler(RequestHandler handler) { request_handler_ = std::move(handler); }
+    void set_websocket_path(const std::string& path) { websocket_path_ = path; }
+    void set_websocket_handler(WebSocketHandler handler) { websocket_handler_ = std::move(handler); }
+    // Accepted subprotocols, in order of preference (at most MAX_SUBPROTOCOLS)
+    void set_websocket_protocols(std::vector<std::string> protocols);
+    // Runs on the reactor thread once the upgrade response is queued
+    void set_websocket_open_handler(WebSocketOpenHandler handler) { open_handler_ = std::move(handler); }
+    void set_max_connections(size_t connections) { max_connections_ = connections; }
+    void set_send_queue_limit(size_t bytes) { send_queue_limit_ = bytes; }
+    void set_idle_timeout(std::chrono::milliseconds timeout) { idle_timeout_ = timeout; }
+    // Runs on the reactor thread at roughly this interval
+    void set_timer(std::chrono::milliseconds interval, TimerHandler handler);
+
+    // Port 0 picks a free port (see port())
+    bool listen(const std::string& address, uint16_t port, int backlog = 128);
+    void start();
+    void stop();
+    bool is_running() const { return running_.load(); }
+    uint16_t port() const { return bound_port_; }
+
+    // Thread-safe: sends one frame to every WebSocket client on the
+    // subprotocol. From the reactor thread (handlers, timer) it is queued
+    // immediately, so it stays ordered with send().
+    void broadcast(const std::string& message, const std::string& protocol = "", bool binary = false,
+                   Delivery delivery = Delivery::LATEST);
+    // Reactor thread only: one frame to one client; false if it is gone
+    bool send(connection_id_t client, const std::string& message, bool binary = false);
+
+    // Statistics
+    size_t get_connection_count() const { return connection_count_.load(std::memory_order_relaxed); }
+    size_t get_websocket_client_count() const { return websocket_clients_.load(std::memory_order_relaxed); }
+    size_t get_websocket_client_count(const std::string& protocol) const;
+    uint64_t get_requests_served() const { return requests_served_.load(std::memory_order_relaxed); }
+    uint64_t get_broadcasts() const { return broadcasts_.load(std::memory_order_relaxed); }
+    uint64_t get_broadcasts_skipped() const { return broadcasts_skipped_.load(std::memory_order_relaxed); }
+    uint64_t get_slow_clients_dropped() const { return slow_clients_dropped_.load(std::memory_order_relaxed); }
+    uint64_t get_connections_rejected() const { return connections_rejected_.load(std::memory_order_relaxed); }
+
+private:
+    using Buffer = std::shared_ptr<const std::string>;
+
+    struct Connection {
+        int fd = -1;
+        connection_id_t id = 0;
+        bool websocket = false;
+        uint8_t protocol = 0;               // 0 = none, else index into protocols_ + 1
+        bool close_after_send = false;
+        bool want_write = false;            // EPOLLOUT registered
+        std::string input;
+        std::string message;                // WebSocket fragments being assembled
+        std::deque<Buffer> output;
+        size_t output_offset = 0;           // Sent part of output.front()
+        size_t queued_bytes = 0;
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    std::string name_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;                      // eventfd: broadcasts and stop
+    uint16_t bound_port_ = 0;
+
+    RequestHandler request_handler_;
+    WebSocketHandler websocket_handler_;
+    std::string websocket_path_;
+    std::vector<std::string> protocols_;
+    WebSocketOpenHandler open_handler_;
+    TimerHandler timer_handler_;
+    std::chrono::milliseconds timer_interval_{0};
+    size_t max_connections_ = DEFAULT_MAX_CONNECTIONS;
+    size_t send_queue_limit_ = DEFAULT_SEND_QUEUE_LIMIT;
+    std::chrono::milliseconds idle_timeout_{30000};
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<std::thread::id> reactor_thread_id_{};
+
+    // Reactor thread only
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    connection_id_t next_id_ = 1;
+
+    struct Broadcast {
+        Buffer frame;
+        uint8_t protocol;
+        Delivery delivery;
+    };
+    std::mutex broadcast_mutex_;
+    std::vector<Broadcast> pending_broadcasts_;
+
+    std::atomic<size_t> connection_count_{0};
+    std::atomic<size_t> websocket_clients_{0};
+    std::atomic<size_t> protocol_clients_[MAX_SUBPROTOCOLS + 1] = {};
+    std::atomic<uint64_t> requests_served_{0};
+    std::atomic<uint64_t> broadcasts_{0};
+    std::atomic<uint64_t> broadcasts_skipped_{0};
+    std::atomic<uint64_t> slow_clients_dropped_{0};
+    std::atomic<uint64_t> connections_rejected_{0};
+
+    void run();
+    void accept_connections();
+    // These return false when the connection should be closed
+    bool on_readable(Connection& conn);
+    bool process_http(Connection& conn);
+    bool process_websocket(Connection& conn);
+    bool handle_request(Connection& conn, const HttpRequest& request);
+    bool queue(Connection& conn, Buffer buffer);
+    bool flush(Connection& conn);
+    void update_interest(Connection& conn);
+    void close_connection(int fd);
+    void fan_out_broadcasts();
+    void fan_out(const Broadcast& broadcast);
+    void abandon(Connection& conn);             // Dead socket; closed on its next event
+    int protocol_index(const std::string& protocol) const;     // -1 if unknown
+    void close_idle(std::chrono::steady_clock::time_point now);
+    void wake();
+};
+
+// WebSocket helpers (RFC 6455), exposed for tests
+std::string websocket_accept_key(const std::string& client_key);
+std::string websocket_frame(const std::string& payload, uint8_t opcode = 0x1);
+
+} // namespace hft
@@ -0,0 +1,184 @@
+#include "hugepage_arena.h"
+#include "static_config.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace hft {
+
+namespace {
+
+constexpr size_t SIZE_2MB = size_t{2} << 20;
+constexpr size_t SIZE_1GB = size_t{1} << 30;
+
+size_t page_bytes(HugePageSize size) {
+    switch (size) {
+    case HugePageSize::HUGE_1GB: return SIZE_1GB;
+    case HugePageSize::HUGE_2MB: return SIZE_2MB;
+    default: return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+}
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+const char* page_name(HugePageSize size) {
+    switch (size) {
+    case HugePageSize::HUGE_1GB: return "1GB";
+    case HugePageSize::HUGE_2MB: return "2MB";
+    default: return "4KB";
+    }
+}
+
+} // namespace
+
+bool parse_huge_page_size(const std::string& text, HugePageSize& size) {
+    if (text == "2M" || text == "2MB") {
+        size = HugePageSize::HUGE_2MB;
+    } else if (text == "1G" || text == "1GB") {
+        size = HugePageSize::HUGE_1GB;
+    } else if (text == "none" || text == "0") {
+        size = HugePageSize::NONE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+HugePageArena::HugePageArena(size_t size, HugePageSize page_size, bool prefault,
+                             std::pmr::memory_resource* upstream)
+    : upstream_(upstream) {
+    if (size == 0) {
+        return;
+    }
+
+    // Largest page size first; the pools for 1GB pages are usually empty
+    bool mapped = false;
+    if (page_size == HugePageSize::HUGE_1GB) {
+        mapped = map_region(size, HugePageSize::HUGE_1GB);
+    }
+    if (!mapped && page_size != HugePageSize::NONE) {
+        mapped = map_region(size, HugePageSize::HUGE_2MB);
+    }
+    if (!mapped && !map_region(size, HugePageSize::NONE)) {
+        std::cerr << "[HugePageArena] mmap of " << size << " bytes failed: " << std::strerror(errno)
+                  << "; all allocations go upstream" << std::endl;
+        return;
+    }
+    if (page_size_ != page_size) {
+        std::cerr << "[HugePageArena] No " << page_name(page_size) << " hugepages reserved, using "
+                  << page_name(page_size_) << " pages" << std::endl;
+    }
+
+    if (prefault) {
+        // Write every page now so the kernel backs the whole region before
+        // the first tick, then keep it resident
+        size_t step = page_bytes(page_size_);
+        for (size_t offset = 0; offset < mapped_size_; offset += step) {
+            base_[offset] = 0;
+        }
+        locked_ = ::mlock(base_, mapped_size_) == 0;
+    }
+}
+
+HugePageArena::~HugePageArena() {
+    if (base_) {
+        ::munmap(base_, mapped_size_);
+    }
+}
+
+bool HugePageArena::map_region(size_t size, HugePageSize page_size) {
+    size_t length = align_up(size, page_bytes(page_size));
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (page_size == HugePageSize::HUGE_2MB) {
+        flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+    } else if (page_size == HugePageSize::HUGE_1GB) {
+        flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+    }
+#else
+    if (page_size != HugePageSize::NONE) {
+        return false;
+    }
+#endif
+
+    void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+#ifdef MADV_HUGEPAGE
+    if (page_size == HugePageSize::NONE) {
+        // Transparent hugepages are the next best thing when none are reserved
+        ::madvise(addr, length, MADV_HUGEPAGE);
+    }
+#endif
+
+    base_ = static_cast<uint8_t*>(addr);
+    capacity_ = size;
+    mapped_size_ = length;
+    page_size_ = page_size;
+    return true;
+}
+
+HugePageArena& HugePageArena::hot() {
+    // Never destroyed: service objects in globals may outlive function statics
+    static HugePageArena* arena = [] {
+        HugePageSize page_size = HugePageSize::HUGE_2MB;
+        parse_huge_page_size(StaticConfig::get_hot_arena_page_size(), page_size);
+        return new HugePageArena(static_cast<size_t>(StaticConfig::get_hot_arena_mb()) << 20, page_size,
+                                 StaticConfig::get_hot_arena_prefault());
+    }();
+    return *arena;
+}
+
+void* HugePageArena::do_allocate(size_t bytes, size_t alignment) {
+    if (base_) {
+        size_t offset = offset_.load(std::memory_order_relaxed);
+        while (true) {
+            size_t start = align_up(reinterpret_cast<uintptr_t>(base_) + offset, alignment) -
+                           reinterpret_cast<uintptr_t>(base_);
+            if (start + bytes > capacity_) {
+                break;
+            }
+            if (offset_.compare_exchange_weak(offset, start + bytes, std::memory_order_relaxed)) {
+                return base_ + start;
+            }
+        }
+    }
+
+    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    overflow_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return upstream_->allocate(bytes, alignment);
+}
+
+void HugePageArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    // Arena memory is released with the arena; only overflow goes back
+    if (!owns(p)) {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+}
+
+bool HugePageArena::owns(const void* p) const {
+    auto* byte = static_cast<const uint8_t*>(p);
+    return base_ && byte >= base_ && byte < base_ + mapped_size_;
+}
+
+std::string HugePageArena::describe() const {
+    std::ostringstream oss;
+    oss << (used() >> 10) << "KB of " << (capacity_ >> 20) << "MB on " << page_name(page_size_) << " pages"
+        << (locked_ ? ", locked" : "");
+    if (get_overflow_count() > 0) {
+        oss << ", " << get_overflow_count() << " overflow allocations (" << (get_overflow_bytes() >> 10) << "KB)";
+    }
+    return oss.str();
+}
+
+} // namespace hft
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+namespace hft {
+
+enum class HugePageSize : uint8_t {
+    NONE = 0,       // Regular pages (still pre-faulted and locked)
+    HUGE_2MB = 1,
+    HUGE_1GB = 2,
+};
+
+// "2M", "1G" or "none"; false leaves size untouched
+bool parse_huge_page_size(const std::string& text, HugePageSize& size);
+
+// Monotonic arena for state that is sized once at startup and then lives for
+// the whole process: position tables, order pools, ladder books, per-symbol
+// strategy state. The region is one anonymous mapping on hugepages (falling
+// back 1GB -> 2MB -> transparent hugepages -> regular pages), touched and
+// mlocked up front, so nothing on the hot path takes a page fault or a TLB
+// miss on a 4K page.
+//
+// Allocation is a lock-free bump; deallocate is a no-op, so only containers
+// that never shrink or reallocate belong here. Requests past the end go to
+// the upstream resource and are counted, rather than failing.
+class HugePageArena : public std::pmr::memory_resource {
+public:
+    HugePageArena(size_t size, HugePageSize page_size = HugePageSize::HUGE_2MB, bool prefault = true,
+                  std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~HugePageArena() override;
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // Process-wide arena for service hot state, sized from StaticConfig
+    // (memory.*) on first use. Call it from main after loading the config
+    // so the pre-fault happens at startup, not on the first allocation.
+    static HugePageArena& hot();
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return std::min(offset_.load(std::memory_order_relaxed), capacity_); }
+    HugePageSize page_size() const { return page_size_; }
+    bool locked() const { return locked_; }
+    uint64_t get_overflow_count() const { return overflow_count_.load(std::memory_order_relaxed); }
+    uint64_t get_overflow_bytes() const { return overflow_bytes_.load(std::memory_order_relaxed); }
+
+    std::string describe() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    bool map_region(size_t size, HugePageSize page_size);
+    bool owns(const void* p) const;
+
+    uint8_t* base_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+    HugePageSize page_size_ = HugePageSize::NONE;
+    bool locked_ = false;
+    std::pmr::memory_resource* upstream_;
+
+    std::atomic<size_t> offset_{0};
+    std::atomic<uint64_t> overflow_count_{0};
+    std::atomic<uint64_t> overflow_bytes_{0};
+};
+
+// Shorthand for the resource hot containers are constructed with
+inline std::pmr::memory_resource* hot_memory() {
+    return &HugePageArena::hot();
+}
+
+} // namespace hft
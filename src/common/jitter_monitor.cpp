@@ -0,0 +1,82 @@
+#include "jitter_monitor.h"
+#include "cpu_topology.h"
+#include "hft_metrics.h"
+#include "high_res_timer.h"
+#include "metrics_collector.h"
+#include "static_config.h"
+#include <algorithm>
+#include <iostream>
+
+namespace hft {
+
+JitterMonitor& JitterMonitor::instance() {
+    static JitterMonitor monitor;
+    return monitor;
+}
+
+size_t JitterMonitor::start() {
+    uint64_t threshold_ns = static_cast<uint64_t>(std::max(1, StaticConfig::get_jitter_threshold_ns()));
+    for (const std::string& thread : ThreadPlan::instance().threads_with_prefix("jitter.")) {
+        start_probe(thread, threshold_ns);
+    }
+    if (!probes_.empty()) {
+        std::cerr << "[JitterMonitor] " << probes_.size() << " probes, reporting gaps over "
+                  << threshold_ns << "ns" << std::endl;
+    }
+    return probes_.size();
+}
+
+void JitterMonitor::start_probe(const std::string& thread, uint64_t threshold_ns) {
+    running_.store(true, std::memory_order_release);
+    probes_.emplace_back(&JitterMonitor::probe, this, thread, threshold_ns);
+}
+
+void JitterMonitor::stop() {
+    running_.store(false, std::memory_order_release);
+    for (auto& probe : probes_) {
+        if (probe.joinable()) probe.join();
+    }
+    probes_.clear();
+}
+
+void JitterMonitor::probe(std::string thread, uint64_t threshold_ns) {
+    const ThreadPlan& plan = ThreadPlan::instance();
+    if (!plan.pin_current_thread(thread)) {
+        std::cerr << "[JitterMonitor] Failed to pin " << thread << " to its planned CPU" << std::endl;
+    }
+    const ThreadPlacement* placement = plan.find(thread);
+    std::string prefix = std::string("jitter.") +
+                         (placement && placement->cpu >= 0 ? "cpu" + std::to_string(placement->cpu) : "unpinned");
+
+    MetricsCollector& collector = MetricsCollector::instance();
+    metric_id_t gap_id = collector.register_metric((prefix + metrics::JITTER_GAP_SUFFIX).c_str(), MetricType::LATENCY);
+    metric_id_t interrupted_id = collector.register_metric((prefix + metrics::JITTER_INTERRUPTED_SUFFIX).c_str(),
+                                                           MetricType::GAUGE);
+
+    const uint64_t threshold = HighResTimer::nanoseconds_to_ticks(threshold_ns);
+    const uint64_t window = HighResTimer::nanoseconds_to_ticks(1000000000ULL);
+    uint64_t window_start = HighResTimer::get_ticks();
+    uint64_t previous = window_start;
+    uint64_t lost = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 4096; ++i) {
+            uint64_t now = HighResTimer::get_ticks();
+            uint64_t gap = now - previous;
+            previous = now;
+            if (gap > threshold) {
+                lost += gap;
+                collector.record_latency(gap_id, HighResTimer::ticks_to_nanoseconds(gap));
+                // Recording isn't interference
+                previous = HighResTimer::get_ticks();
+            }
+        }
+        if (previous - window_start >= window) {
+            collector.set_gauge(interrupted_id, lost * 1000000 / (previous - window_start));
+            window_start = previous;
+            lost = 0;
+        }
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hft {
+
+// Measures what the OS and firmware take away from a CPU: a probe thread
+// spins reading the TSC, and any gap between two consecutive reads longer
+// than jitter.threshold_ns is time the thread didn't run (preemption, an
+// interrupt, an SMI). Per probe it records
+//   jitter.cpu<n>.gap_ns              histogram of every gap over threshold
+//   jitter.cpu<n>.interrupted_ppm     share of the last second lost to them
+// ("unpinned" in place of cpu<n> for a probe without a CPU).
+//
+// A probe burns its CPU, so it belongs on an idle isolated core next to the
+// hot ones: one is started per jitter.<n> placement in this service's
+// ThreadPlan (thread.<service>.jitter.<n>=<cpu>[:hot]).
+class JitterMonitor {
+public:
+    static JitterMonitor& instance();
+
+    // Starts the planned probes; returns how many
+    size_t start();
+
+    // Starts one probe on the calling process, pinned through the plan if
+    // thread has a placement
+    void start_probe(const std::string& thread, uint64_t threshold_ns);
+
+    void stop();
+    size_t probe_count() const { return probes_.size(); }
+
+    ~JitterMonitor() { stop(); }
+
+private:
+    JitterMonitor() = default;
+
+    void probe(std::string thread, uint64_t threshold_ns);
+
+    std::atomic<bool> running_{false};
+    std::vector<std::thread> probes_;
+};
+
+} // namespace hft
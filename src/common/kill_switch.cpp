@@ -0,0 +1,189 @@
+#include "kill_switch.h"
+#include "cpu_affinity.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+// Abstract namespace: nothing on disk to clean up, gone with the process
+bool abstract_address(const std::string& name, sockaddr_un& address, socklen_t& length) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (name.size() + 1 > sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path + 1, name.data(), name.size());
+    length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+    return true;
+}
+
+} // namespace
+
+const char* to_string(KillParty party) {
+    switch (party) {
+        case KillParty::STRATEGY: return "strategy";
+        case KillParty::GATEWAY: return "gateway";
+        case KillParty::FEED: return "feed";
+    }
+    return "unknown";
+}
+
+KillSwitch& KillSwitch::instance() {
+    static KillSwitch instance;
+    return instance;
+}
+
+bool KillSwitch::open(const std::string& name) {
+    if (mapping_) return true;
+    name_ = name;
+
+    std::string shm_name = "/" + name;
+    int fd = ::shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0660);
+    if (fd < 0) {
+        std::cerr << "[KillSwitch] shm_open(" << shm_name << ") failed: " << std::strerror(errno)
+                  << "; kills reach this process only" << std::endl;
+        return false;
+    }
+    // Sized by whoever gets here first; ftruncate to the same size is harmless
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 ||
+        (static_cast<size_t>(st.st_size) < sizeof(Page) && ::ftruncate(fd, sizeof(Page)) != 0)) {
+        std::cerr << "[KillSwitch] sizing " << shm_name << " failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* addr = ::mmap(nullptr, sizeof(Page), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[KillSwitch] mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A fresh segment is zero-filled, which is already a valid unhalted
+    // page; the magic only tells a stale layout apart
+    Page* page = static_cast<Page*>(addr);
+    uint64_t magic = page->magic.load(std::memory_order_acquire);
+    if (magic != MAGIC) {
+        if (magic != 0) {
+            std::cerr << "[KillSwitch] " << shm_name << " has an unknown layout; reinitializing" << std::endl;
+            new (page) Page();
+        }
+        page->magic.store(MAGIC, std::memory_order_release);
+    }
+    // A kill raised before open() stays raised
+    if (halted(local_.word.load(std::memory_order_relaxed)) && !halted(page->word.load(std::memory_order_relaxed))) {
+        page->triggered_ns.store(local_.triggered_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        page->word.fetch_add(2 | HALTED, std::memory_order_release);
+    }
+    mapping_ = addr;
+    page_ = page;
+    return true;
+}
+
+uint64_t KillSwitch::advance(bool halt) {
+    uint64_t current = page_->word.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        next = ((current >> 1) + 1) << 1 | (halt ? HALTED : 0);
+    } while (!page_->word.compare_exchange_weak(current, next, std::memory_order_release,
+                                                std::memory_order_relaxed));
+    return next;
+}
+
+uint64_t KillSwitch::trigger() {
+    // Stamped first, so a party that sees the word sees its time too
+    page_->triggered_ns.store(now(), std::memory_order_release);
+    uint64_t word = advance(true);
+    wake_all();
+    return word;
+}
+
+uint64_t KillSwitch::reset() {
+    uint64_t word = advance(false);
+    wake_all();
+    return word;
+}
+
+void KillSwitch::acknowledge(KillParty party, uint64_t word, int64_t now_ns) {
+    Ack& ack = page_->acks[static_cast<size_t>(party)];
+    ack.time_ns.store(now_ns, std::memory_order_relaxed);
+    ack.word.store(word, std::memory_order_release);
+}
+
+int64_t KillSwitch::ack_latency_ns(KillParty party, uint64_t word) const {
+    const Ack& ack = page_->acks[static_cast<size_t>(party)];
+    if (ack.word.load(std::memory_order_acquire) != word) return -1;
+    return std::max<int64_t>(0, ack.time_ns.load(std::memory_order_relaxed) - triggered_ns());
+}
+
+int64_t KillSwitch::wait_for_ack(KillParty party, uint64_t word, std::chrono::nanoseconds timeout) const {
+    int64_t deadline = now() + timeout.count();
+    uint32_t spins = 0;
+    while (true) {
+        int64_t latency = ack_latency_ns(party, word);
+        if (latency >= 0 || now() >= deadline) return latency;
+        // Spin through the expected microseconds, then stop burning the core
+        if (++spins < 4096) {
+            CPUAffinity::cpu_pause();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+std::string KillSwitch::wake_address(KillParty party) const {
+    return name_ + "." + to_string(party);
+}
+
+int KillSwitch::wake_fd(KillParty party) {
+    size_t index = static_cast<size_t>(party);
+    if (wake_tried_[index]) return wake_fds_[index];
+    wake_tried_[index] = true;
+
+    sockaddr_un address;
+    socklen_t length;
+    if (!abstract_address(wake_address(party), address, length)) return -1;
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    wake_fds_[index] = fd;
+    return fd;
+}
+
+void KillSwitch::drain_wake(KillParty party) {
+    int fd = wake_fds_[static_cast<size_t>(party)];
+    if (fd < 0) return;
+    char buffer[16];
+    while (::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+}
+
+void KillSwitch::wake_all() {
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return;
+    for (size_t i = 0; i < KILL_PARTIES; ++i) {
+        sockaddr_un address;
+        socklen_t length;
+        if (!abstract_address(wake_address(static_cast<KillParty>(i)), address, length)) continue;
+        // Nobody listening (or a full queue, already woken) is fine: the word is what counts
+        char byte = 1;
+        ::sendto(fd, &byte, 1, MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&address), length);
+    }
+    ::close(fd);
+}
+
+} // namespace hft
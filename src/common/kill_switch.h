@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace hft {
+
+// The loops a kill reaches, each with its own acknowledgement
+enum class KillParty : uint8_t {
+    STRATEGY,
+    GATEWAY,
+    FEED
+};
+
+constexpr size_t KILL_PARTIES = 3;
+
+const char* to_string(KillParty party);
+
+// Out-of-band emergency stop, bypassing the ZMQ control path and whatever
+// is queued on it. The state is one word in a small POSIX shared memory
+// segment (/dev/shm/<kill_switch.name>):
+//
+//   bit 0        halted
+//   bits 1..63   generation, bumped by every trigger() and reset()
+//
+// Hot loops load it once per iteration (relaxed; on x86 a plain load from a
+// line that is only ever written by a kill) and act when it differs from
+// the word they last saw. Each party then acknowledges the word with the
+// time it stopped, so the controller can tell how long "no new orders"
+// took. Loops that block (in zmq::poll, say) also listen on a datagram
+// socket that trigger() writes to, so a kill wakes them instead of waiting
+// out their timeout.
+//
+// Every process maps the same segment; without /dev/shm it falls back to a
+// process-local word, which still covers the in-process fast path. Times
+// are steady_clock (CLOCK_MONOTONIC), shared by every process on the host.
+class KillSwitch {
+public:
+    static constexpr uint64_t HALTED = 1;
+
+    static KillSwitch& instance();
+
+    // Maps the named segment, creating it if needed; false (and the process
+    // keeps its local word) if it can't. Idempotent.
+    bool open(const std::string& name);
+    bool is_shared() const { return mapping_ != nullptr; }
+
+    // Hot path
+    uint64_t word() const { return page_->word.load(std::memory_order_relaxed); }
+    bool halted() const { return halted(word()); }
+    static bool halted(uint64_t word) { return (word & HALTED) != 0; }
+
+    // Halts every party and wakes the listeners; returns the new word
+    uint64_t trigger();
+    // Lifts the halt (the parties see a new, unhalted word); returns it
+    uint64_t reset();
+    int64_t triggered_ns() const { return page_->triggered_ns.load(std::memory_order_acquire); }
+
+    // The party has acted on word, at now_ns
+    void acknowledge(KillParty party, uint64_t word, int64_t now_ns = now());
+    // Nanoseconds from the trigger to the party's acknowledgement of word,
+    // or -1 if it has not acknowledged it (yet)
+    int64_t ack_latency_ns(KillParty party, uint64_t word) const;
+    // Polls ack_latency_ns() until it is known or timeout has passed
+    int64_t wait_for_ack(KillParty party, uint64_t word, std::chrono::nanoseconds timeout) const;
+
+    // A non-blocking datagram socket that becomes readable on trigger(), for
+    // poll(); -1 if it can't be bound (another process of the same party has
+    // it). Opened on first use and kept for the process.
+    int wake_fd(KillParty party);
+    // Empties the wake socket after it polled readable
+    void drain_wake(KillParty party);
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    struct alignas(64) Ack {
+        std::atomic<uint64_t> word;
+        std::atomic<int64_t> time_ns;
+    };
+
+    struct Page {
+        std::atomic<uint64_t> magic;
+        // Read by every hot loop: a line of its own, written only by kills
+        alignas(64) std::atomic<uint64_t> word;
+        std::atomic<int64_t> triggered_ns;
+        Ack acks[KILL_PARTIES];
+    };
+    static constexpr uint64_t MAGIC = 0x314C4C494B544648ULL;   // "HFTKILL1"
+
+    KillSwitch() = default;
+    KillSwitch(const KillSwitch&) = delete;
+    KillSwitch& operator=(const KillSwitch&) = delete;
+
+    // The next word's generation, halted or not
+    uint64_t advance(bool halt);
+    void wake_all();
+    std::string wake_address(KillParty party) const;
+
+    Page local_{};
+    Page* page_ = &local_;
+    void* mapping_ = nullptr;
+    std::string name_ = "hft_kill_switch";
+    int wake_fds_[KILL_PARTIES] = {-1, -1, -1};
+    bool wake_tried_[KILL_PARTIES] = {};
+};
+
+} // namespace hft
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace hft {
+
+// Log-linear (HDR-style) bucket layout shared by the recording histogram and
+// its snapshots. Values below SUB_BUCKETS get exact buckets; above that every
+// power of two is split into SUB_BUCKETS linear buckets, so a bucket is never
+// wider than 1/64 of its lower bound (<1.6% relative error at any magnitude).
+namespace histogram {
+
+constexpr uint32_t SUB_BUCKET_BITS = 6;
+constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+constexpr uint32_t MAX_MAGNITUDE = 44;  // Values >= 2^44 ns (~4.9h) land in the last bucket
+constexpr size_t BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+inline size_t bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+    uint32_t magnitude = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+    if (magnitude >= MAX_MAGNITUDE) return BUCKET_COUNT - 1;
+    uint32_t shift = magnitude - SUB_BUCKET_BITS;
+    return (static_cast<size_t>(shift) + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+inline uint64_t bucket_lower_bound(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    uint32_t shift = static_cast<uint32_t>(index / SUB_BUCKETS) - 1;
+    return (static_cast<uint64_t>(SUB_BUCKETS) + index % SUB_BUCKETS) << shift;
+}
+
+inline uint64_t bucket_upper_bound(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    uint32_t shift = static_cast<uint32_t>(index / SUB_BUCKETS) - 1;
+    return bucket_lower_bound(index) + (uint64_t(1) << shift) - 1;
+}
+
+} // namespace histogram
+
+// Recording side: one instance per (thread, metric). Only the owning thread
+// writes, so record() is plain relaxed load/store pairs with no locked
+// instructions; any thread may read it concurrently for a snapshot.
+class LatencyHistogram {
+public:
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value) {
+        auto& bucket = counts_[histogram::bucket_index(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value < min_.load(std::memory_order_relaxed)) min_.store(value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) max_.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t bucket_count(size_t index) const { return counts_[index].load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t min() const { return min_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Not synchronized with the writer: a record racing a reset may survive it
+    void reset() {
+        for (auto& bucket : counts_) bucket.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> counts_[histogram::BUCKET_COUNT]{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Plain, copyable merge of one or more LatencyHistograms. Counts stay empty
+// until the first value so idle metrics cost nothing to copy around.
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+
+    bool empty() const { return total == 0; }
+
+    void record(uint64_t value) {
+        if (counts.empty()) counts.resize(histogram::BUCKET_COUNT, 0);
+        counts[histogram::bucket_index(value)]++;
+        total++;
+        sum += value;
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+
+    // Relaxed reads of a live histogram; each bucket is individually exact
+    void add(const LatencyHistogram& source) {
+        if (counts.empty()) counts.resize(histogram::BUCKET_COUNT, 0);
+        uint64_t added = 0;
+        for (size_t i = 0; i < histogram::BUCKET_COUNT; ++i) {
+            uint64_t n = source.bucket_count(i);
+            counts[i] += n;
+            added += n;
+        }
+        if (added == 0) return;
+        total += added;
+        sum += source.sum();
+        min_value = std::min(min_value, source.min());
+        max_value = std::max(max_value, source.max());
+    }
+
+    void merge(const HistogramSnapshot& other) {
+        if (other.empty()) return;
+        if (counts.empty()) counts.resize(histogram::BUCKET_COUNT, 0);
+        for (size_t i = 0; i < histogram::BUCKET_COUNT; ++i) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    // Highest value equivalent to the q-quantile's bucket, clamped to [min, max]
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(total) + 0.999999);
+        target = std::clamp<uint64_t>(target, 1, total);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < histogram::BUCKET_COUNT; ++i) {
+            cumulative += counts[i];
+            if (cumulative >= target) {
+                return std::clamp(histogram::bucket_upper_bound(i), min_value, max_value);
+            }
+        }
+        return max_value;
+    }
+
+    // Samples in buckets that start at or below value (Prometheus "le" buckets)
+    uint64_t count_at_or_below(uint64_t value) const {
+        if (total == 0) return 0;
+        size_t last = histogram::bucket_index(value);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i <= last; ++i) cumulative += counts[i];
+        return cumulative;
+    }
+};
+
+} // namespace hft
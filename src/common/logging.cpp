@@ -1,37 +1,17 @@
 #include "logging.h"
-#include <iostream>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <stdexcept>
 
 namespace hft {
 
 Logger::Logger(const std::string& component_name, const std::string& endpoint)
     : component_name_(component_name)
+    , component_id_(binlog::register_component(component_name))
     , min_level_(LogLevel::INFO)
-    , console_output_(true)
-    , connected_(false) {
-    
-    try {
-        context_ = std::make_unique<zmq::context_t>(1);
-        socket_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUSH);
-        
-        // Set socket options for low latency
-        int linger = 0;
-        socket_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
-        
-        socket_->connect(endpoint);
-        connected_ = true;
-    } catch (const zmq::error_t& e) {
-        std::cerr << "Logger failed to connect to " << endpoint << ": " << e.what() << std::endl;
-        connected_ = false;
-    }
+    , console_output_(true) {
+    binlog::start_backend(endpoint);
 }
 
 Logger::~Logger() {
-    if (socket_) {
-        socket_->close();
-    }
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
@@ -39,43 +19,7 @@ void Logger::log(LogLevel level, const std::string& message) {
         return;
     }
     
-    // Create log message
-    LogMessage log_msg = MessageFactory::create_log_message(level, component_name_, message);
-    
-    // Send to centralized logger if connected
-    if (connected_) {
-        send_log_message(log_msg);
-    }
-    
-    // Output to console if enabled
-    if (console_output_) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()
-        ) % 1000;
-        
-        std::ostringstream oss;
-        oss << "[" << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        oss << "." << std::setfill('0') << std::setw(3) << ms.count() << "] ";
-        
-        // Add log level
-        switch (level) {
-            case LogLevel::DEBUG: oss << "[DEBUG] "; break;
-            case LogLevel::INFO: oss << "[INFO]  "; break;
-            case LogLevel::WARNING: oss << "[WARN]  "; break;
-            case LogLevel::ERROR: oss << "[ERROR] "; break;
-            case LogLevel::CRITICAL: oss << "[CRIT]  "; break;
-        }
-        
-        oss << component_name_ << ": " << message;
-        
-        if (level >= LogLevel::ERROR) {
-            std::cerr << oss.str() << std::endl;
-        } else {
-            std::cout << oss.str() << std::endl;
-        }
-    }
+    log_format(level, binlog::PLAIN_FORMAT_ID, message);
 }
 
 void Logger::debug(const std::string& message) {
@@ -106,18 +50,6 @@ void Logger::set_console_output(bool enable) {
     console_output_ = enable;
 }
 
-void Logger::send_log_message(const LogMessage& log_msg) {
-    try {
-        zmq::message_t message(sizeof(LogMessage));
-        std::memcpy(message.data(), &log_msg, sizeof(LogMessage));
-        socket_->send(message, zmq::send_flags::dontwait);
-    } catch (const zmq::error_t& e) {
-        if (console_output_) {
-            std::cerr << "Failed to send log message: " << e.what() << std::endl;
-        }
-    }
-}
-
 // Singleton implementation
 GlobalLogger& GlobalLogger::instance() {
     static GlobalLogger instance;
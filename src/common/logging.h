@@ -2,19 +2,33 @@
 
 #include "message_types.h"
 #include "static_config.h"
+#include "binary_log.h"
 
 #include <memory>
 #include <string>
-#include <zmq.hpp>
 
 namespace hft {
 
+// Log calls never format or send on the calling thread: they append a binary
+// record to a per-thread ring (see binary_log.h) and the process's log backend
+// ships it to the logger service and prints it. Hot paths should use
+// HFT_LOGF, which skips building the std::string entirely.
 class Logger {
 public:
+    // All Loggers in a process share one backend; the first endpoint wins
     Logger(const std::string& component_name, const std::string& endpoint);
     ~Logger();
     
     void log(LogLevel level, const std::string& message);
+    
+    // Deferred formatting: format_id comes from binlog::register_format
+    template<typename... Args>
+    void log_format(LogLevel level, uint32_t format_id, const Args&... args) {
+        binlog::write_entry(component_id_, level, console_output_ ? binlog::FLAG_CONSOLE : 0,
+                            format_id, args...);
+    }
+    
+    bool is_enabled(LogLevel level) const { return level >= min_level_; }
     void debug(const std::string& message);
     void info(const std::string& message);
     void warning(const std::string& message);
@@ -26,16 +40,15 @@ public:
     
     // Enable/disable console output
     void set_console_output(bool enable);
+    
+    // Blocks until everything logged so far has left the process
+    static void flush() { binlog::flush(); }
 
 private:
     std::string component_name_;
+    uint16_t component_id_;
     LogLevel min_level_;
     bool console_output_;
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> socket_;
-    bool connected_;
-    
-    void send_log_message(const LogMessage& log_msg);
 };
 
 // Singleton logger for easy access across the application
@@ -57,4 +70,20 @@ private:
 #define HFT_LOG_ERROR(msg) GlobalLogger::instance().get().error(msg)
 #define HFT_LOG_CRITICAL(msg) GlobalLogger::instance().get().critical(msg)
 
+// Deferred-format logging: "{}" placeholders, arguments copied raw (integers,
+// floating point, char, bool, C strings, std::string). The format string is
+// registered once per call site; rendering happens off the calling thread.
+// The placeholder count must match the argument count (checked at compile time).
+//   HFT_LOGF(logger_, LogLevel::INFO, "Filled {} {} @ {}", symbol, qty, price);
+#define HFT_LOGF(logger, level, format, ...)                                              \
+    do {                                                                                  \
+        static_assert(::hft::binlog::count_placeholders(format) ==                        \
+                          decltype(::hft::binlog::count_args(__VA_ARGS__))::value,        \
+                      "HFT_LOGF: placeholder count does not match argument count");       \
+        if ((logger).is_enabled(level)) {                                                 \
+            static const uint32_t hft_format_id_ = ::hft::binlog::register_format(format); \
+            (logger).log_format(level, hft_format_id_, ##__VA_ARGS__);                    \
+        }                                                                                 \
+    } while (0)
+
 } // namespace hft
\ No newline at end of file
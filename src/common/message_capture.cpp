@@ -0,0 +1,355 @@
+#include "message_capture.h"
+#include "high_res_timer.h"
+#include "static_config.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr size_t BATCH_FLUSH_BYTES = 256 * 1024;
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(200);
+
+std::atomic<uint64_t> next_capture_id{1};
+
+size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+MessageCapture::MessageCapture(const std::string& directory, const std::string& service)
+    : directory_(directory), service_(service), id_(next_capture_id.fetch_add(1)) {}
+
+MessageCapture::~MessageCapture() {
+    stop();
+}
+
+std::unique_ptr<MessageCapture> MessageCapture::from_config(const std::string& service) {
+    if (!StaticConfig::get_capture_enabled()) return nullptr;
+    return std::make_unique<MessageCapture>(StaticConfig::get_capture_directory(), service);
+}
+
+bool MessageCapture::start() {
+    if (running_.load(std::memory_order_acquire)) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "[MessageCapture] Cannot create " << directory_ << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+    path_ = directory_ + "/" + service_ + "_" + stamp + "_" + std::to_string(getpid()) + ".capture";
+
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[MessageCapture] Failed to open " << path_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    CaptureFileHeader header{};
+    header.magic = CAPTURE_MAGIC;
+    header.version = CAPTURE_VERSION;
+    std::strncpy(header.service, service_.c_str(), sizeof(header.service) - 1);
+    header.pid = static_cast<uint32_t>(getpid());
+    header.tsc_frequency = HighResTimer::get_tsc_frequency();
+    header.start_tsc = HighResTimer::get_ticks();
+    header.start_wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!write_all(fd_, reinterpret_cast<const char*>(&header), sizeof(header))) {
+        std::cerr << "[MessageCapture] Failed to write " << path_ << ": " << std::strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { run_writer(); });
+    return true;
+}
+
+void MessageCapture::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+uint8_t MessageCapture::channel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        if (channels_[i] == name) return static_cast<uint8_t>(i);
+    }
+    if (channels_.size() == MAX_CAPTURE_CHANNELS) {
+        std::cerr << "[MessageCapture] Channel limit reached; " << name << " shares the last channel" << std::endl;
+        return static_cast<uint8_t>(MAX_CAPTURE_CHANNELS - 1);
+    }
+    channels_.push_back(name);
+    return static_cast<uint8_t>(channels_.size() - 1);
+}
+
+binlog::ThreadRing& MessageCapture::thread_ring() {
+    struct CachedRing {
+        uint64_t capture_id;
+        binlog::ThreadRing* ring;
+    };
+    static thread_local std::vector<CachedRing> cache;
+    for (const CachedRing& cached : cache) {
+        if (cached.capture_id == id_) return *cached.ring;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(std::make_unique<binlog::ThreadRing>());
+    cache.push_back(CachedRing{id_, rings_.back().get()});
+    return *rings_.back();
+}
+
+bool MessageCapture::record(uint8_t channel, const void* data, size_t size) {
+    if (!running_.load(std::memory_order_relaxed)) return false;
+
+    size_t total = sizeof(CaptureRecordHeader) + size;
+    binlog::ThreadRing& ring = thread_ring();
+    char* out = size <= MAX_CAPTURE_MESSAGE ? ring.reserve(total) : nullptr;
+    if (!out) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    CaptureRecordHeader header{};
+    header.size = static_cast<uint16_t>(total);
+    header.kind = CaptureRecordKind::MESSAGE;
+    header.channel = channel;
+    header.sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    header.tsc = HighResTimer::get_ticks();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), data, size);
+    ring.commit();
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void MessageCapture::run_writer() {
+    while (running_.load(std::memory_order_acquire)) {
+        if (!write_pending()) {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+    while (write_pending()) {}
+}
+
+bool MessageCapture::write_pending() {
+    std::vector<binlog::ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (; channels_written_ < channels_.size(); ++channels_written_) {
+            const std::string& name = channels_[channels_written_];
+            append_record(CaptureRecordKind::CHANNEL, static_cast<uint8_t>(channels_written_), name.data(), name.size());
+        }
+        for (const auto& ring : rings_) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != dropped_written_) {
+        uint64_t lost = dropped - dropped_written_;
+        append_record(CaptureRecordKind::DROPPED, 0, &lost, sizeof(lost));
+        dropped_written_ = dropped;
+    }
+
+    bool drained = false;
+    for (binlog::ThreadRing* ring : rings) {
+        ring->drain([&](const char* record, size_t size) {
+            if (batch_.size() + align8(size) > BATCH_FLUSH_BYTES) {
+                flush_batch();
+            }
+            size_t offset = batch_.size();
+            batch_.resize(offset + align8(size));
+            std::memcpy(batch_.data() + offset, record, size);
+            drained = true;
+            return true;
+        });
+    }
+    flush_batch();
+    return drained;
+}
+
+void MessageCapture::append_record(CaptureRecordKind kind, uint8_t channel, const void* data, size_t size) {
+    CaptureRecordHeader header{};
+    header.size = static_cast<uint16_t>(sizeof(header) + size);
+    header.kind = kind;
+    header.channel = channel;
+    header.tsc = HighResTimer::get_ticks();
+
+    size_t offset = batch_.size();
+    batch_.resize(offset + align8(header.size));
+    std::memcpy(batch_.data() + offset, &header, sizeof(header));
+    std::memcpy(batch_.data() + offset + sizeof(header), data, size);
+}
+
+void MessageCapture::flush_batch() {
+    if (batch_.empty()) return;
+    if (write_all(fd_, batch_.data(), batch_.size())) {
+        bytes_written_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    } else {
+        std::cerr << "[MessageCapture] Write to " << path_ << " failed: " << std::strerror(errno) << std::endl;
+    }
+    batch_.clear();
+}
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[CaptureReader] Could not open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CaptureFileHeader)) {
+        std::cerr << "[CaptureReader] " << path << " is too small for a capture" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    size_t file_size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[CaptureReader] mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ::madvise(addr, file_size, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(addr);
+    size_ = file_size;
+
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (header_.magic != CAPTURE_MAGIC || header_.version != CAPTURE_VERSION) {
+        std::cerr << "[CaptureReader] " << path << " is not a capture file" << std::endl;
+        close();
+        return false;
+    }
+
+    size_t offset = sizeof(CaptureFileHeader);
+    while (size_ - offset >= sizeof(CaptureRecordHeader)) {
+        CaptureRecordHeader record;
+        std::memcpy(&record, data_ + offset, sizeof(record));
+        if (record.size < sizeof(record) || record.size > size_ - offset) break;
+
+        const char* payload = data_ + offset + sizeof(record);
+        size_t payload_size = record.size - sizeof(record);
+        switch (record.kind) {
+            case CaptureRecordKind::MESSAGE:
+                index_.push_back(Entry{record.sequence, offset});
+                break;
+            case CaptureRecordKind::CHANNEL:
+                if (channels_.size() <= record.channel) channels_.resize(record.channel + 1);
+                channels_[record.channel].assign(payload, payload_size);
+                break;
+            case CaptureRecordKind::DROPPED:
+                if (payload_size == sizeof(uint64_t)) {
+                    uint64_t lost;
+                    std::memcpy(&lost, payload, sizeof(lost));
+                    dropped_ += lost;
+                }
+                break;
+        }
+        offset += align8(record.size);
+    }
+    // A capture cut off mid-write (crash, kill -9) keeps its whole records
+    torn_bytes_ = offset < size_ ? size_ - offset : 0;
+
+    // Threads' rings drain in turn, so file order is only receive order per thread
+    std::sort(index_.begin(), index_.end(), [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+    for (const Entry& entry : index_) {
+        CaptureRecordHeader record;
+        std::memcpy(&record, data_ + entry.offset, sizeof(record));
+        first_tsc_ = first_tsc_ == 0 ? record.tsc : std::min(first_tsc_, record.tsc);
+        last_tsc_ = std::max(last_tsc_, record.tsc);
+    }
+    return true;
+}
+
+void CaptureReader::close() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    header_ = CaptureFileHeader{};
+    channels_.clear();
+    index_.clear();
+    dropped_ = 0;
+    torn_bytes_ = 0;
+    first_tsc_ = last_tsc_ = 0;
+}
+
+std::string CaptureReader::service() const {
+    return std::string(header_.service, strnlen(header_.service, sizeof(header_.service)));
+}
+
+int CaptureReader::channel(const std::string& name) const {
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        if (channels_[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+uint64_t CaptureReader::span_ns() const {
+    if (header_.tsc_frequency == 0 || last_tsc_ <= first_tsc_) return 0;
+    return static_cast<uint64_t>(static_cast<long double>(last_tsc_ - first_tsc_) * 1e9L /
+                                 header_.tsc_frequency);
+}
+
+std::string ReplayReport::describe() const {
+    std::ostringstream out;
+    double seconds = elapsed.count() / 1e9;
+    out << messages << " messages";
+    if (skipped > 0) out << " (" << skipped << " skipped)";
+    out << " in " << (elapsed.count() / 1000) << " us";
+    if (seconds > 0.0) {
+        out << ", " << static_cast<uint64_t>(messages / seconds) << " msg/s";
+    }
+    if (captured_span_ns > 0 && elapsed.count() > 0) {
+        out << "; captured over " << (captured_span_ns / 1000000) << " ms ("
+            << static_cast<double>(captured_span_ns) / elapsed.count() << "x real time)";
+    }
+    if (dropped_at_capture > 0) {
+        out << "; " << dropped_at_capture << " messages were dropped at capture";
+    }
+    return out.str();
+}
+
+} // namespace hft
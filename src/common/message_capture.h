@@ -0,0 +1,244 @@
+#pragma once
+
+#include "binary_log.h"
+#include "transport_interface.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hft {
+
+// Capture file: this header, then 8-byte aligned records in the order the
+// writer drained them (record sequence numbers give the order they were
+// received in)
+static constexpr uint32_t CAPTURE_MAGIC = 0x50434648;   // "HFCP"
+static constexpr uint16_t CAPTURE_VERSION = 1;
+
+struct CaptureFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    char service[32];
+    uint32_t pid;
+    uint64_t tsc_frequency;     // Hz, 0 if the TSC was not calibrated
+    uint64_t start_tsc;         // With start_wall_ns, maps record TSCs to wall time
+    int64_t start_wall_ns;
+} __attribute__((packed));
+
+enum class CaptureRecordKind : uint8_t {
+    MESSAGE = 1,    // A received message; payload is its bytes
+    CHANNEL = 2,    // Names channel; payload is the name
+    DROPPED = 3     // Messages lost to a full ring since the last one; payload is uint64_t
+};
+
+// The first field doubles as binlog::ThreadRing framing
+struct CaptureRecordHeader {
+    uint16_t size;              // Header plus payload, in bytes
+    CaptureRecordKind kind;
+    uint8_t channel;
+    uint32_t reserved;
+    uint64_t sequence;          // Process-wide receive order
+    uint64_t tsc;               // HighResTimer ticks at receive
+} __attribute__((packed));
+
+static constexpr size_t MAX_CAPTURE_CHANNELS = 32;
+static constexpr size_t MAX_CAPTURE_MESSAGE = 65535 - sizeof(CaptureRecordHeader);
+
+// Records every message a service's subscribers receive, with the local TSC
+// at receive, to one file per service run. Receiving threads copy messages
+// into a private ring (binlog::ThreadRing), as log calls do; a writer thread
+// drains the rings and appends to the file. Nothing on the receive path
+// waits: a message that finds its ring full is dropped and counted, and
+// replay reports the loss.
+//
+// File: <directory>/<service>_<YYYYmmdd_HHMMSS>_<pid>.capture
+class MessageCapture {
+public:
+    MessageCapture(const std::string& directory, const std::string& service);
+    ~MessageCapture();
+
+    MessageCapture(const MessageCapture&) = delete;
+    MessageCapture& operator=(const MessageCapture&) = delete;
+
+    // Capture for service when capture.enabled is set, else null
+    static std::unique_ptr<MessageCapture> from_config(const std::string& service);
+
+    // Opens the file and starts the writer thread
+    bool start();
+    // Writes everything recorded so far and stops the writer
+    void stop();
+
+    // Cold path: channel ID for name (registered on first use)
+    uint8_t channel(const std::string& name);
+
+    // Any receiving thread; false if the message was dropped
+    bool record(uint8_t channel, const void* data, size_t size);
+
+    const std::string& path() const { return path_; }
+    uint64_t messages_recorded() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t messages_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+
+private:
+    std::string directory_;
+    std::string service_;
+    std::string path_;
+    uint64_t id_;                           // Tells captures apart in the thread-local ring cache
+
+    std::mutex mutex_;                      // Guards rings_ and channels_
+    std::vector<std::unique_ptr<binlog::ThreadRing>> rings_;
+    std::vector<std::string> channels_;
+    size_t channels_written_ = 0;           // Writer thread
+
+    std::atomic<uint64_t> next_sequence_{0};
+    std::atomic<uint64_t> recorded_{0};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t dropped_written_ = 0;          // Writer thread
+    std::atomic<uint64_t> bytes_written_{0};
+
+    int fd_ = -1;
+    std::vector<char> batch_;
+    std::thread writer_;
+    std::atomic<bool> running_{false};
+
+    binlog::ThreadRing& thread_ring();
+    void run_writer();
+    // Definitions and dropped counts first, then whatever the rings hold
+    bool write_pending();
+    void append_record(CaptureRecordKind kind, uint8_t channel, const void* data, size_t size);
+    void flush_batch();
+};
+
+// Subscriber decorator: everything is forwarded to the wrapped transport,
+// and each message receive() returns is recorded on the way out. The
+// native handle is the wrapped one, so zmq::poll() works unchanged.
+class CaptureTap : public IMessageSubscriber {
+public:
+    CaptureTap(std::unique_ptr<IMessageSubscriber> inner, MessageCapture& capture, const std::string& channel)
+        : inner_(std::move(inner)), capture_(capture), channel_(capture.channel(channel)) {}
+
+    bool receive(void* data, size_t& size, bool non_blocking = false) override {
+        if (!inner_->receive(data, size, non_blocking)) return false;
+        capture_.record(channel_, data, size);
+        return true;
+    }
+
+    bool subscribe(const std::string& topic = "") override { return inner_->subscribe(topic); }
+    bool unsubscribe(const std::string& topic = "") override { return inner_->unsubscribe(topic); }
+    bool initialize(const TransportConfig& config) override { return inner_->initialize(config); }
+    bool bind(const std::string& endpoint) override { return inner_->bind(endpoint); }
+    bool connect(const std::string& endpoint) override { return inner_->connect(endpoint); }
+    void close() override { inner_->close(); }
+    bool send(const void* data, size_t size, bool non_blocking = false) override {
+        return inner_->send(data, size, non_blocking);
+    }
+    void set_receive_callback(MessageCallback callback) override {
+        inner_->set_receive_callback([this, callback = std::move(callback)](const void* data, size_t size) {
+            capture_.record(channel_, data, size);
+            callback(data, size);
+        });
+    }
+    void start_async_receive() override { inner_->start_async_receive(); }
+    void stop_async_receive() override { inner_->stop_async_receive(); }
+    bool is_connected() const override { return inner_->is_connected(); }
+    TransportType get_type() const override { return inner_->get_type(); }
+    std::string get_endpoint() const override { return inner_->get_endpoint(); }
+    uint64_t get_messages_sent() const override { return inner_->get_messages_sent(); }
+    uint64_t get_messages_received() const override { return inner_->get_messages_received(); }
+    uint64_t get_bytes_sent() const override { return inner_->get_bytes_sent(); }
+    uint64_t get_bytes_received() const override { return inner_->get_bytes_received(); }
+    void* get_native_handle() override { return inner_->get_native_handle(); }
+    int get_poll_fd() override { return inner_->get_poll_fd(); }
+
+private:
+    std::unique_ptr<IMessageSubscriber> inner_;
+    MessageCapture& capture_;
+    uint8_t channel_;
+};
+
+// subscriber wrapped in a CaptureTap on channel, or returned as is without a capture
+inline std::unique_ptr<IMessageSubscriber> capture_tap(std::unique_ptr<IMessageSubscriber> subscriber,
+                                                       MessageCapture* capture, const std::string& channel) {
+    if (!capture || !subscriber) return subscriber;
+    return std::make_unique<CaptureTap>(std::move(subscriber), *capture, channel);
+}
+
+// One captured message, as replay hands it back
+struct CapturedMessage {
+    uint8_t channel;
+    uint64_t sequence;
+    uint64_t tsc;
+    const void* data;
+    size_t size;
+};
+
+// Read side: maps a capture file and walks its messages in receive order
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const CaptureFileHeader& header() const { return header_; }
+    std::string service() const;
+    // Channel ID for name, or -1 if the capture has no such channel
+    int channel(const std::string& name) const;
+    const std::vector<std::string>& channels() const { return channels_; }
+
+    size_t messages() const { return index_.size(); }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t torn_bytes() const { return torn_bytes_; }
+    // Wall time between the first and last captured message
+    uint64_t span_ns() const;
+
+    // fn(const CapturedMessage&) for every message, in receive order
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Entry& entry : index_) {
+            CaptureRecordHeader record;
+            std::memcpy(&record, data_ + entry.offset, sizeof(record));
+            fn(CapturedMessage{record.channel, record.sequence, record.tsc,
+                               data_ + entry.offset + sizeof(record), record.size - sizeof(record)});
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t sequence;
+        size_t offset;
+    };
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    CaptureFileHeader header_{};
+    std::vector<std::string> channels_;
+    std::vector<Entry> index_;
+    uint64_t dropped_ = 0;
+    uint64_t torn_bytes_ = 0;
+    uint64_t first_tsc_ = 0;
+    uint64_t last_tsc_ = 0;
+};
+
+// What a service's replay_capture() did
+struct ReplayReport {
+    uint64_t messages = 0;
+    uint64_t skipped = 0;                   // Channels or sizes the service does not consume
+    uint64_t dropped_at_capture = 0;
+    uint64_t captured_span_ns = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    std::string describe() const;
+};
+
+} // namespace hft
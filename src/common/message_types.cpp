@@ -1,11 +1,12 @@
 #include "message_types.h"
+#include "fixed_format.h"
 #include <cstring>
-#include <sstream>
-#include <iomanip>
+#include <atomic>
 
 namespace hft {
 
-static uint32_t g_sequence_number = 0;
+// Atomic: headers are created from several threads (services, parallel backtests)
+static std::atomic<uint32_t> g_sequence_number{0};
 
 MessageHeader MessageFactory::create_header(MessageType type, uint16_t payload_size) {
     MessageHeader header;
@@ -18,15 +19,33 @@ MessageHeader MessageFactory::create_header(MessageType type, uint16_t payload_s
     return header;
 }
 
-MarketData MessageFactory::create_market_data(const std::string& symbol,
+MessageHeader MessageFactory::create_header_tsc(MessageType type, uint16_t payload_size,
+                                                HighResTimer::ticks_t tsc) {
+    MessageHeader header;
+    header.type = type;
+    header.sequence_number = ++g_sequence_number;
+    header.timestamp = timestamp_t(HighResTimer::ticks_to_wall_nanoseconds(tsc));
+    header.payload_size = payload_size;
+    return header;
+}
+
+MarketData MessageFactory::create_market_data(std::string_view symbol,
                                              double bid, double ask,
                                              uint32_t bid_size, uint32_t ask_size,
                                              double last_price, uint32_t last_size) {
+    return create_market_data_fixed(symbol, to_fixed_price(bid), to_fixed_price(ask),
+                                    bid_size, ask_size, to_fixed_price(last_price), last_size);
+}
+
+MarketData MessageFactory::create_market_data_fixed(std::string_view symbol,
+                                                   price_t bid, price_t ask,
+                                                   uint32_t bid_size, uint32_t ask_size,
+                                                   price_t last_price, uint32_t last_size) {
     MarketData data;
-    data.header = create_header(MessageType::MARKET_DATA, sizeof(MarketData) - sizeof(MessageHeader));
+    data.header = create_header_tsc(MessageType::MARKET_DATA, sizeof(MarketData) - sizeof(MessageHeader));
     
-    std::memset(data.symbol, 0, sizeof(data.symbol));
-    std::strncpy(data.symbol, symbol.c_str(), sizeof(data.symbol) - 1);
+    copy_field(data.symbol, symbol);
+    data.symbol_id = SymbolTable::instance().intern(data.symbol);
     
     data.bid_price = bid;
     data.ask_price = ask;
@@ -35,11 +54,85 @@ MarketData MessageFactory::create_market_data(const std::string& symbol,
     data.last_price = last_price;
     data.last_size = last_size;
     data.exchange_timestamp = data.header.timestamp.count();
+    data.publish_timestamp = 0;
+    data.trace.begin(data.header.sequence_number);
     
     return data;
 }
 
-TradingSignal MessageFactory::create_trading_signal(const std::string& symbol,
+void MessageFactory::begin_market_data_batch(MarketDataBatch& batch) {
+    batch.header = create_header(MessageType::MARKET_DATA_BATCH,
+                                 offsetof(MarketDataBatch, records) - sizeof(MessageHeader));
+    batch.publish_timestamp = 0;
+    std::memset(&batch.trace, 0, sizeof(batch.trace));
+    batch.count = 0;
+}
+
+bool MessageFactory::append_quote(MarketDataBatch& batch, const MarketData& data) {
+    if (batch.full()) {
+        return false;
+    }
+    if (batch.count == 0) {
+        // The packet's trace starts with its first quote
+        batch.trace = data.trace;
+    } else {
+        batch.trace.tsc[static_cast<size_t>(TraceStage::FEED_PARSE)] =
+            data.trace.tsc[static_cast<size_t>(TraceStage::FEED_PARSE)];
+    }
+    
+    QuoteRecord& record = batch.records[batch.count++];
+    record.sequence = data.header.sequence_number;
+    record.exchange_timestamp = data.exchange_timestamp;
+    record.local_timestamp = data.header.timestamp.count();
+    record.bid_price = data.bid_price;
+    record.ask_price = data.ask_price;
+    record.last_price = data.last_price;
+    record.bid_size = data.bid_size;
+    record.ask_size = data.ask_size;
+    record.last_size = data.last_size;
+    record.symbol_id = data.symbol_id;
+    
+    batch.header.payload_size = static_cast<uint16_t>(batch.wire_size() - sizeof(MessageHeader));
+    return true;
+}
+
+MarketData MessageFactory::unpack_quote(const MarketDataBatch& batch, size_t index) {
+    const QuoteRecord& record = batch.records[index];
+    MarketData data;
+    data.header.type = MessageType::MARKET_DATA;
+    data.header.sequence_number = static_cast<uint32_t>(record.sequence);
+    data.header.timestamp = timestamp_t(record.local_timestamp);
+    data.header.payload_size = sizeof(MarketData) - sizeof(MessageHeader);
+    std::strncpy(data.symbol, SymbolTable::instance().name(record.symbol_id), sizeof(data.symbol) - 1);
+    data.symbol[sizeof(data.symbol) - 1] = '\0';
+    data.symbol_id = record.symbol_id;
+    data.bid_price = record.bid_price;
+    data.ask_price = record.ask_price;
+    data.bid_size = record.bid_size;
+    data.ask_size = record.ask_size;
+    data.last_price = record.last_price;
+    data.last_size = record.last_size;
+    data.exchange_timestamp = record.exchange_timestamp;
+    data.publish_timestamp = batch.publish_timestamp;
+    data.trace = batch.trace;
+    data.trace.trace_id = record.sequence;
+    return data;
+}
+
+TradingSignal MessageFactory::create_trading_signal(std::string_view symbol,
+                                                   SignalAction action,
+                                                   OrderType type,
+                                                   double price,
+                                                   uint32_t quantity,
+                                                   uint64_t strategy_id,
+                                                   double confidence) {
+    char name[sizeof(TradingSignal::symbol)];
+    copy_field(name, symbol);
+    return create_trading_signal(SymbolTable::instance().intern(name), action, type,
+                                 price, quantity, strategy_id, confidence);
+}
+
+TradingSignal MessageFactory::create_trading_signal(symbol_id_t symbol_id,
                                                    SignalAction action,
                                                    OrderType type,
                                                    double price,
@@ -47,34 +140,44 @@ TradingSignal MessageFactory::create_trading_signal(const std::string& symbol,
                                                    uint64_t strategy_id,
                                                    double confidence) {
     TradingSignal signal;
-    signal.header = create_header(MessageType::TRADING_SIGNAL, sizeof(TradingSignal) - sizeof(MessageHeader));
+    signal.header = create_header_tsc(MessageType::TRADING_SIGNAL, sizeof(TradingSignal) - sizeof(MessageHeader));
     
-    std::memset(signal.symbol, 0, sizeof(signal.symbol));
-    std::strncpy(signal.symbol, symbol.c_str(), sizeof(signal.symbol) - 1);
+    copy_field(signal.symbol, SymbolTable::instance().name(symbol_id));
+    signal.symbol_id = symbol_id;
     
     signal.action = action;
+    signal.side = action == SignalAction::SELL ? SignalAction::SELL : SignalAction::BUY;
     signal.order_type = type;
-    signal.price = price;
+    signal.price = to_fixed_price(price);
     signal.quantity = quantity;
     signal.strategy_id = strategy_id;
     signal.confidence = confidence;
+    signal.trace = {};  // Callers copy the originating tick's trace in
     
     return signal;
 }
 
+TradingSignal MessageFactory::create_quote_signal(symbol_id_t symbol_id,
+                                                 SignalAction side,
+                                                 double price,
+                                                 uint32_t quantity,
+                                                 uint64_t strategy_id,
+                                                 double confidence) {
+    TradingSignal signal = create_trading_signal(symbol_id, SignalAction::MODIFY, OrderType::LIMIT,
+                                                 price, quantity, strategy_id, confidence);
+    signal.side = side;
+    return signal;
+}
+
 LogMessage MessageFactory::create_log_message(LogLevel level,
-                                             const std::string& component,
-                                             const std::string& message) {
+                                             std::string_view component,
+                                             std::string_view message) {
     LogMessage log;
-    log.header = create_header(MessageType::LOG_MESSAGE, sizeof(LogMessage) - sizeof(MessageHeader));
+    log.header = create_header_tsc(MessageType::LOG_MESSAGE, sizeof(LogMessage) - sizeof(MessageHeader));
     
     log.level = level;
-    
-    std::memset(log.component, 0, sizeof(log.component));
-    std::strncpy(log.component, component.c_str(), sizeof(log.component) - 1);
-    
-    std::memset(log.message, 0, sizeof(log.message));
-    std::strncpy(log.message, message.c_str(), sizeof(log.message) - 1);
+    copy_field(log.component, component);
+    copy_field(log.message, message);
     
     return log;
 }
@@ -86,9 +189,7 @@ bool MessageFactory::validate_message(const Message& msg) {
     }
     
     // Validate timestamp is reasonable (not too far in past/future)
-    auto now = std::chrono::duration_cast<timestamp_t>(
-        std::chrono::high_resolution_clock::now().time_since_epoch()
-    );
+    auto now = timestamp_t(HighResTimer::get_wall_nanoseconds());
     auto age = now - msg.header.timestamp;
     if (age > std::chrono::seconds(60) || age < std::chrono::seconds(-1)) {
         return false;
@@ -111,41 +212,50 @@ bool MessageFactory::validate_message(const Message& msg) {
     }
 }
 
-std::string MessageFactory::message_to_string(const Message& msg) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(4);
+size_t MessageFactory::format_message(const Message& msg, char* buffer, size_t size) {
+    // Wire fields are not trusted to be NUL-terminated
+    auto field = [](const auto& text) {
+        return std::string_view(text, strnlen(text, sizeof(text)));
+    };
     
-    oss << "Message[seq=" << msg.header.sequence_number 
+    FixedWriter out(buffer, size);
+    out << "Message[seq=" << msg.header.sequence_number
         << ", ts=" << msg.header.timestamp.count() << "ns, ";
     
     switch (msg.header.type) {
         case MessageType::MARKET_DATA:
-            oss << "MARKET_DATA: " << msg.market_data.symbol
-                << " bid=" << msg.market_data.bid_price << "x" << msg.market_data.bid_size
-                << " ask=" << msg.market_data.ask_price << "x" << msg.market_data.ask_size
-                << " last=" << msg.market_data.last_price;
+            out << "MARKET_DATA: " << field(msg.market_data.symbol)
+                << " bid=" << to_double_price(msg.market_data.bid_price) << "x" << msg.market_data.bid_size
+                << " ask=" << to_double_price(msg.market_data.ask_price) << "x" << msg.market_data.ask_size
+                << " last=" << to_double_price(msg.market_data.last_price);
             break;
             
         case MessageType::TRADING_SIGNAL:
-            oss << "TRADING_SIGNAL: " << msg.trading_signal.symbol
+            out << "TRADING_SIGNAL: " << field(msg.trading_signal.symbol)
                 << " action=" << static_cast<int>(msg.trading_signal.action)
-                << " price=" << msg.trading_signal.price
+                << " side=" << static_cast<int>(msg.trading_signal.side)
+                << " price=" << to_double_price(msg.trading_signal.price)
                 << " qty=" << msg.trading_signal.quantity
                 << " conf=" << msg.trading_signal.confidence;
             break;
             
         case MessageType::LOG_MESSAGE:
-            oss << "LOG[" << static_cast<int>(msg.log_message.level) << "]: "
-                << msg.log_message.component << " - " << msg.log_message.message;
+            out << "LOG[" << static_cast<int>(msg.log_message.level) << "]: "
+                << field(msg.log_message.component) << " - " << field(msg.log_message.message);
             break;
             
         default:
-            oss << "Type=" << static_cast<int>(msg.header.type);
+            out << "Type=" << static_cast<int>(msg.header.type);
             break;
     }
     
-    oss << "]";
-    return oss.str();
+    out << "]";
+    return out.size();
+}
+
+std::string MessageFactory::message_to_string(const Message& msg) {
+    char buffer[512];   // Fits the longest case, a full LogMessage
+    return std::string(buffer, format_message(msg, buffer, sizeof(buffer)));
 }
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -2,8 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <array>
+#include <cstddef>
+#include "fixed_price.h"
+#include "symbol_table.h"
+#include "trace_context.h"
 
 namespace hft {
 
@@ -21,7 +26,9 @@ enum class MessageType : uint16_t {
     RISK_ALERT = 7,
     LOG_MESSAGE = 8,
     CONTROL_COMMAND = 9,
-    SYSTEM_STATUS = 10
+    SYSTEM_STATUS = 10,
+    RISK_LIMIT_UPDATE = 11,
+    MARKET_DATA_BATCH = 12
 };
 
 // Common message header for all internal messages
@@ -36,16 +43,62 @@ struct MessageHeader {
 struct MarketData {
     MessageHeader header;
     char symbol[16];           // Symbol name (null-terminated)
-    double bid_price;          // Best bid price
-    double ask_price;          // Best ask price
+    symbol_id_t symbol_id;     // Dense ID from SymbolTable
+    price_t bid_price;         // Best bid price (fixed-point, see fixed_price.h)
+    price_t ask_price;         // Best ask price (fixed-point)
     uint32_t bid_size;         // Best bid size
     uint32_t ask_size;         // Best ask size
-    double last_price;         // Last trade price
+    price_t last_price;        // Last trade price (fixed-point)
     uint32_t last_size;        // Last trade size
     uint64_t exchange_timestamp; // Exchange timestamp in nanoseconds
     uint64_t publish_timestamp; // Publish timestamp in nanoseconds
+    TraceContext trace;        // Per-stage TSC stamps, starts at feed receive
 } __attribute__((packed));
 
+// Bus form of a quote: one naturally aligned cache line, no symbol name.
+// The symbol ID is only meaningful across services for the preloaded symbol
+// list (SymbolTable::is_preloaded); other symbols travel as MarketData.
+// MessageFactory::unpack_quote turns a record back into the MarketData the
+// feed produced.
+struct alignas(64) QuoteRecord {
+    uint64_t sequence;            // The quote's header sequence (and trace ID)
+    uint64_t exchange_timestamp;  // Exchange timestamp in nanoseconds
+    int64_t local_timestamp;      // Feed handler receive time in nanoseconds
+    price_t bid_price;            // Fixed-point, see fixed_price.h
+    price_t ask_price;
+    price_t last_price;
+    uint32_t bid_size;
+    uint32_t ask_size;
+    uint32_t last_size;
+    symbol_id_t symbol_id;
+};
+
+static_assert(sizeof(QuoteRecord) == 64, "QuoteRecord must fill exactly one cache line");
+
+// The market data bus frame: quotes parsed from one exchange packet (or a
+// single quote from the other sources). Only the first `count` records go
+// on the wire (wire_size()); they start on a cache line boundary. The trace
+// covers the frame: receive and parse stamps of its quotes, then publish.
+struct MarketDataBatch {
+    static constexpr size_t MAX_RECORDS = 32;
+
+    MessageHeader header;
+    uint64_t publish_timestamp;
+    TraceContext trace;
+    uint16_t count;
+    QuoteRecord records[MAX_RECORDS];
+
+    size_t wire_size() const { return offsetof(MarketDataBatch, records) + count * sizeof(QuoteRecord); }
+    bool full() const { return count >= MAX_RECORDS; }
+};
+
+// Receive buffer for the market data stream, which carries both messages
+union MarketDataFrame {
+    MessageHeader header;
+    MarketData quote;
+    MarketDataBatch batch;
+};
+
 // Trading signal - output from strategy engine
 enum class SignalAction : uint8_t {
     BUY = 1,
@@ -64,12 +117,15 @@ enum class OrderType : uint8_t {
 struct TradingSignal {
     MessageHeader header;
     char symbol[16];           // Symbol to trade
+    symbol_id_t symbol_id;     // Dense ID from SymbolTable
     SignalAction action;       // What action to take
+    SignalAction side;         // BUY or SELL; for MODIFY, which of the strategy's quotes to move
     OrderType order_type;      // Type of order
-    double price;              // Limit price (0.0 for market orders)
+    price_t price;             // Limit price, fixed-point (0 for market orders)
     uint32_t quantity;         // Number of shares
     uint64_t strategy_id;      // ID of generating strategy
     double confidence;         // Signal confidence [0.0, 1.0]
+    TraceContext trace;        // Carried forward from the originating tick
 } __attribute__((packed));
 
 // Order execution report from broker
@@ -85,11 +141,13 @@ struct OrderExecution {
     MessageHeader header;
     uint64_t order_id;         // Unique order identifier
     char symbol[16];           // Symbol traded
+    symbol_id_t symbol_id;     // Dense ID from SymbolTable
     ExecutionType exec_type;   // Type of execution
-    double fill_price;         // Price of execution
+    price_t fill_price;        // Price of execution (fixed-point)
     uint32_t fill_quantity;    // Quantity executed
     uint32_t remaining_quantity; // Quantity remaining
     double commission;         // Commission charged
+    TraceContext trace;        // Carried forward from the originating signal
 } __attribute__((packed));
 
 // Position update from position service
@@ -119,6 +177,21 @@ struct RiskAlert {
     double current_value;      // Current value
 } __attribute__((packed));
 
+// Pre-trade limits pushed from the risk service into the gateway's PreTradeRisk.
+// symbol_id == INVALID_SYMBOL_ID sets the defaults for every symbol and the halt flag.
+struct RiskLimitUpdate {
+    MessageHeader header;
+    char symbol[16];               // Symbol name (empty for the defaults)
+    symbol_id_t symbol_id;         // Dense ID from SymbolTable
+    uint32_t max_order_quantity;   // Shares per order
+    double max_order_notional;     // Price * quantity per order
+    int64_t max_position;          // Absolute net shares, working orders included
+    double price_band_ratio;       // Max limit-price deviation from reference (0 = off)
+    uint32_t max_orders_per_second; // Per symbol (0 = off)
+    price_t reference_price;       // Fat-finger reference, fixed-point (0 = unchanged)
+    uint8_t halted;                // Defaults only: reject every new order
+} __attribute__((packed));
+
 // Log message for centralized logging
 enum class LogLevel : uint8_t {
     DEBUG = 1,
@@ -144,7 +217,11 @@ enum class ControlAction : uint8_t {
     SHUTDOWN_SYSTEM = 5,
     UPDATE_CONFIG = 6,
     EMERGENCY_STOP = 7,
-    LIQUIDATE_ALL = 8
+    LIQUIDATE_ALL = 8,
+    LOAD_STRATEGY = 9,                 // parameters: "type=<name> id=<n> [param=value ...]"
+    UNLOAD_STRATEGY = 10,              // parameters: "id=<n>"
+    UPDATE_STRATEGY_PARAMETERS = 11,   // parameters: "id=<n> param=value ..."
+    START_PROFILE = 12                 // parameters: "[seconds=<n>] [hz=<n>]"
 };
 
 struct ControlCommand {
@@ -181,6 +258,7 @@ union Message {
     OrderExecution order_execution;
     PositionUpdate position_update;
     RiskAlert risk_alert;
+    RiskLimitUpdate risk_limit_update;
     LogMessage log_message;
     ControlCommand control_command;
     SystemStatus system_status;
@@ -190,23 +268,81 @@ union Message {
 class MessageFactory {
 public:
     static MessageHeader create_header(MessageType type, uint16_t payload_size);
-    static MarketData create_market_data(const std::string& symbol,
+    // Live-path variant: stamped from a TSC reading (taken now by default)
+    // mapped to wall time, instead of a clock call per message
+    static MessageHeader create_header_tsc(MessageType type, uint16_t payload_size,
+                                           HighResTimer::ticks_t tsc = HighResTimer::get_ticks());
+    static MarketData create_market_data(std::string_view symbol,
                                        double bid, double ask,
                                        uint32_t bid_size, uint32_t ask_size,
                                        double last_price, uint32_t last_size);
-    static TradingSignal create_trading_signal(const std::string& symbol,
+    // Feed-side variant for sources that already carry integer prices
+    static MarketData create_market_data_fixed(std::string_view symbol,
+                                             price_t bid, price_t ask,
+                                             uint32_t bid_size, uint32_t ask_size,
+                                             price_t last_price, uint32_t last_size);
+    static TradingSignal create_trading_signal(std::string_view symbol,
                                              SignalAction action,
                                              OrderType type,
                                              double price,
                                              uint32_t quantity,
                                              uint64_t strategy_id,
                                              double confidence = 1.0);
+    // Hot-path variant: symbol name comes from SymbolTable, no string construction
+    static TradingSignal create_trading_signal(symbol_id_t symbol_id,
+                                             SignalAction action,
+                                             OrderType type,
+                                             double price,
+                                             uint32_t quantity,
+                                             uint64_t strategy_id,
+                                             double confidence = 1.0);
+    // Two-sided quoting: a MODIFY limit order that replaces the strategy's
+    // working quote on side, or places one if there is none
+    static TradingSignal create_quote_signal(symbol_id_t symbol_id,
+                                             SignalAction side,
+                                             double price,
+                                             uint32_t quantity,
+                                             uint64_t strategy_id,
+                                             double confidence = 1.0);
+    
+    // Batches: start an empty one, append quotes in feed order (false when
+    // full), and turn record `index` back into a standalone MarketData
+    static void begin_market_data_batch(MarketDataBatch& batch);
+    static bool append_quote(MarketDataBatch& batch, const MarketData& data);
+    static MarketData unpack_quote(const MarketDataBatch& batch, size_t index);
+    
     static LogMessage create_log_message(LogLevel level,
-                                       const std::string& component,
-                                       const std::string& message);
+                                       std::string_view component,
+                                       std::string_view message);
     
     static bool validate_message(const Message& msg);
+    // Writes the message_to_string() text into buffer without allocating;
+    // returns its length, cut to size - 1 if it does not fit
+    static size_t format_message(const Message& msg, char* buffer, size_t size);
     static std::string message_to_string(const Message& msg);
 };
 
+// Calls on_quote(const MarketData&) for each quote in a frame received from
+// the market data stream: once for a MarketData, once per record, in order,
+// for a MarketDataBatch. Returns the number of quotes; 0 for anything else.
+template <typename F>
+size_t for_each_quote(const void* frame, size_t size, F&& on_quote) {
+    const auto* message = static_cast<const MarketDataFrame*>(frame);
+    if (size == sizeof(MarketData) && message->header.type == MessageType::MARKET_DATA) {
+        on_quote(message->quote);
+        return 1;
+    }
+    if (size < offsetof(MarketDataBatch, records) || message->header.type != MessageType::MARKET_DATA_BATCH) {
+        return 0;
+    }
+    const MarketDataBatch& batch = message->batch;
+    if (batch.count > MarketDataBatch::MAX_RECORDS || size != batch.wire_size()) {
+        return 0;
+    }
+    for (size_t i = 0; i < batch.count; ++i) {
+        on_quote(MessageFactory::unpack_quote(batch, i));
+    }
+    return batch.count;
+}
+
 } // namespace hft
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "high_res_timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace hft {
+
+// Recent history of one metric at three resolutions, for dashboards that
+// want a chart without a TSDB. Each tier is a ring of fixed-width buckets
+// (last, min and max of the values recorded in the bucket); the oldest
+// bucket is overwritten once the ring is full. One writer; any number of
+// readers, which copy buckets under a per-bucket sequence and retry if the
+// writer raced them, so neither side ever waits.
+class MetricHistory {
+public:
+    enum Tier : uint8_t { SECONDS, TEN_SECONDS, MINUTES, TIER_COUNT };
+
+    struct Point {
+        uint32_t time_s;      // Bucket start
+        uint32_t samples;     // Values recorded into it
+        uint64_t last;
+        uint64_t min;
+        uint64_t max;
+    };
+
+    static constexpr uint32_t WIDTH_SECONDS[TIER_COUNT] = {1, 10, 60};
+    static constexpr uint32_t RETAINED_POINTS[TIER_COUNT] = {300, 360, 1440};   // 5 minutes, 1 hour, 1 day
+
+    MetricHistory() {
+        for (size_t tier = 0; tier < TIER_COUNT; ++tier) {
+            rings_[tier] = std::vector<Slot>(RETAINED_POINTS[tier]);
+        }
+    }
+
+    MetricHistory(const MetricHistory&) = delete;
+    MetricHistory& operator=(const MetricHistory&) = delete;
+
+    // Single writer only. A time before the newest bucket of a tier is
+    // dropped from that tier rather than reordering it.
+    void record(uint32_t time_s, uint64_t value) {
+        for (size_t tier = 0; tier < TIER_COUNT; ++tier) {
+            record_tier(tier, time_s - time_s % WIDTH_SECONDS[tier], value);
+        }
+    }
+
+    // Appends the tier's buckets starting at or after since_s, oldest
+    // first; returns how many
+    size_t read(Tier tier, uint32_t since_s, std::vector<Point>& out) const {
+        const std::vector<Slot>& ring = rings_[tier];
+        uint64_t end = counts_[tier].load(std::memory_order_acquire);
+        uint64_t begin = end > ring.size() ? end - ring.size() : 0;
+        size_t appended = 0;
+        Point point;
+        for (uint64_t i = begin; i < end; ++i) {
+            // A slot the writer has since reused holds a newer bucket: skip it
+            if (!read_slot(ring[i % ring.size()], static_cast<uint32_t>(i), point) || point.time_s < since_s) continue;
+            out.push_back(point);
+            appended++;
+        }
+        return appended;
+    }
+
+    uint64_t get_points_written(Tier tier) const { return counts_[tier].load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};  // Odd while written; 0 = never written
+        uint32_t index = 0;                 // Bucket number within the tier, mod 2^32
+        Point point{};
+    };
+
+    void record_tier(size_t tier, uint32_t bucket_s, uint64_t value) {
+        std::vector<Slot>& ring = rings_[tier];
+        uint64_t count = counts_[tier].load(std::memory_order_relaxed);
+        Point point;
+        if (count > 0) {
+            Slot& newest = ring[(count - 1) % ring.size()];
+            point = newest.point;   // Only this thread writes it
+            if (bucket_s < point.time_s) {
+                return;
+            }
+            if (bucket_s == point.time_s) {
+                point.samples++;
+                point.last = value;
+                point.min = std::min(point.min, value);
+                point.max = std::max(point.max, value);
+                write_slot(newest, static_cast<uint32_t>(count - 1), point);
+                return;
+            }
+        }
+        point = Point{bucket_s, 1, value, value, value};
+        write_slot(ring[count % ring.size()], static_cast<uint32_t>(count), point);
+        counts_[tier].store(count + 1, std::memory_order_release);
+    }
+
+    static void write_slot(Slot& slot, uint32_t index, const Point& point) {
+        uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.index = index;
+        std::memcpy(&slot.point, &point, sizeof(Point));
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    static bool read_slot(const Slot& slot, uint32_t index, Point& out) {
+        for (;;) {
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            if (before & 1) {
+                HighResTimer::cpu_relax();
+                continue;
+            }
+            uint32_t written_index = slot.index;
+            std::memcpy(&out, &slot.point, sizeof(Point));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                return written_index == index;
+            }
+        }
+    }
+
+    std::vector<Slot> rings_[TIER_COUNT];
+    std::atomic<uint64_t> counts_[TIER_COUNT] = {};   // Buckets ever started per tier
+};
+
+} // namespace hft
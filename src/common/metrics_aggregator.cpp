@@ -34,7 +34,8 @@ bool MetricsAggregator::initialize() {
             "tcp://localhost:5561", // Strategy Engine
             "tcp://localhost:5562", // Market Data Handler  
             "tcp://localhost:5563", // Order Gateway
-            "tcp://localhost:5564"  // Position Risk Service
+            "tcp://localhost:5564", // Position Risk Service
+            "tcp://localhost:5565"  // Low-Latency Logger
         };
         
         for (const auto& endpoint : endpoints) {
@@ -57,14 +58,20 @@ bool MetricsAggregator::initialize() {
     }
 }
 
-void MetricsAggregator::start() {
+void MetricsAggregator::start(EventLoop* loop) {
     if (running_.load()) {
         return;
     }
     
     running_.store(true);
-    subscribe_thread_ = std::make_unique<std::thread>(&MetricsAggregator::subscribe_loop, this);
-    cleanup_thread_ = std::make_unique<std::thread>(&MetricsAggregator::cleanup_loop, this);
+    if (!loop) {
+        own_loop_ = std::make_unique<EventLoop>("MetricsAggregator");
+        own_loop_->start("aggregator");
+        loop = own_loop_.get();
+    }
+    loop_ = loop;
+    loop_->spawn(subscribe_task());
+    loop_->spawn(cleanup_task());
     
     std::cout << "[MetricsAggregator] Started metrics aggregation" << std::endl;
 }
@@ -76,13 +83,11 @@ void MetricsAggregator::stop() {
     
     running_.store(false);
     
-    if (subscribe_thread_ && subscribe_thread_->joinable()) {
-        subscribe_thread_->join();
-    }
-    
-    if (cleanup_thread_ && cleanup_thread_->joinable()) {
-        cleanup_thread_->join();
+    if (own_loop_) {
+        own_loop_->stop();
+        own_loop_.reset();
     }
+    loop_ = nullptr;
     
     if (subscriber_) {
         subscriber_->close();
@@ -92,8 +97,6 @@ void MetricsAggregator::stop() {
 }
 
 void MetricsAggregator::initialize_default_metrics() {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    
     // Initialize all HFT metrics with default values and service labels
     auto init_metric = [this](const char* name, MetricType type, uint64_t default_value = 0) {
         MetricStats stats;
@@ -145,146 +148,230 @@ void MetricsAggregator::initialize_default_metrics() {
     std::cout << "[MetricsAggregator] Initialized " << default_metrics_.size() << " default metrics" << std::endl;
 }
 
-void MetricsAggregator::subscribe_loop() {
+Task MetricsAggregator::subscribe_task() {
+    void* socket = static_cast<void*>(*subscriber_);
     while (running_.load()) {
-        try {
-            zmq::message_t message;
-            auto result = subscriber_->recv(message, zmq::recv_flags::dontwait);
-            
-            if (result && message.size() >= sizeof(MetricsMessage)) {
-                std::vector<uint8_t> data(static_cast<uint8_t*>(message.data()),
-                                         static_cast<uint8_t*>(message.data()) + message.size());
-                process_metrics_message(data);
-            }
-            
-        } catch (const zmq::error_t& e) {
-            if (e.num() != EAGAIN && e.num() != ETERM) {
-                std::cerr << "[MetricsAggregator] Receive error: " << e.what() << std::endl;
+        co_await loop_->zmq_readable(socket);
+        
+        for (;;) {
+            try {
+                zmq::message_t message;
+                if (!subscriber_->recv(message, zmq::recv_flags::dontwait)) {
+                    break;
+                }
+                process_metrics_message(static_cast<const uint8_t*>(message.data()), message.size(),
+                                        HighResTimer::get_wall_nanoseconds());
+                
+            } catch (const zmq::error_t& e) {
+                if (e.num() != EAGAIN && e.num() != ETERM) {
+                    std::cerr << "[MetricsAggregator] Receive error: " << e.what() << std::endl;
+                }
+                break;
             }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 }
 
-void MetricsAggregator::cleanup_loop() {
+Task MetricsAggregator::cleanup_task() {
     while (running_.load()) {
-        uint64_t now_ns = HighResTimer::get_nanoseconds();
+        uint64_t now_ns = HighResTimer::get_wall_nanoseconds();
         
-        // Limit scope of mutex lock - don't hold it during sleep!
-        {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
-            for (auto& [service_name, service_metrics] : service_metrics_) {
-                if (service_metrics.is_online && 
-                    (now_ns - service_metrics.last_update_ns) > SERVICE_TIMEOUT_NS) {
-                    mark_service_offline(service_name);
-                }
+        size_t count = service_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            ServiceSlot& service = *services_[i];
+            if (now_ns - service.last_update_ns.load(std::memory_order_relaxed) > SERVICE_TIMEOUT_NS &&
+                service.online.exchange(false, std::memory_order_relaxed)) {
+                std::cout << "[MetricsAggregator] Service " << service.name << " marked offline" << std::endl;
             }
         }
         
-        // Sleep OUTSIDE the mutex lock
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        co_await loop_->sleep_for(std::chrono::seconds(2));
     }
 }
 
-void MetricsAggregator::process_metrics_message(const std::vector<uint8_t>& data) {
-    if (data.size() < sizeof(MetricsMessage)) {
-        return;
+MetricsAggregator::ServiceSlot* MetricsAggregator::find_or_add_service(const char* name) {
+    auto it = service_index_.find(name);
+    if (it != service_index_.end()) {
+        return it->second;
     }
     
-    const MetricsMessage* header = reinterpret_cast<const MetricsMessage*>(data.data());
-    std::string service_name(header->service_name);
+    size_t count = service_count_.load(std::memory_order_relaxed);
+    if (count >= MAX_SERVICES) {
+        return nullptr;
+    }
+    auto slot = std::make_unique<ServiceSlot>();
+    std::strncpy(slot->name, name, sizeof(slot->name) - 1);
+    ServiceSlot* service = slot.get();
+    services_[count] = std::move(slot);
+    service_index_.emplace(name, service);
+    service_count_.store(count + 1, std::memory_order_release);
+    return service;
+}
+
+bool MetricsAggregator::process_metrics_message(const uint8_t* data, size_t size, uint64_t now_ns) {
+    MetricsMessage header;
+    if (size < sizeof(header)) {
+        rejected_messages_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
     
-    // Validate message size
-    size_t expected_size = sizeof(MetricsMessage) + (header->metric_count * sizeof(SerializedMetricEntry));
-    if (data.size() < expected_size) {
-        std::cerr << "[MetricsAggregator] Invalid message size from " << service_name << std::endl;
-        return;
+    size_t expected_size = sizeof(MetricsMessage) + header.definition_count * sizeof(MetricDefinition) +
+                           header.value_count * sizeof(MetricValue);
+    if (header.magic != METRICS_MAGIC || header.version != METRICS_VERSION || size != expected_size) {
+        rejected_messages_.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
     
-    const SerializedMetricEntry* entries = reinterpret_cast<const SerializedMetricEntry*>(data.data() + sizeof(MetricsMessage));
+    char name[sizeof(header.service_name) + 1] = {};
+    std::memcpy(name, header.service_name, sizeof(header.service_name));
+    ServiceSlot* service = find_or_add_service(name);
+    if (!service) {
+        rejected_messages_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
     
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    ServiceMetrics& service_metrics = service_metrics_[service_name];
-    service_metrics.service_name = service_name;
-    service_metrics.last_update_ns = header->timestamp_ns;
-    service_metrics.is_online = true;
-    service_metrics.metrics.clear();
+    // A new session (service restart) renumbers its metrics
+    if (service->session_id.load(std::memory_order_relaxed) != header.session_id) {
+        service->session_id.store(header.session_id, std::memory_order_release);
+    } else if (header.sequence != service->last_sequence + 1) {
+        sequence_gaps_.fetch_add(1, std::memory_order_relaxed);
+    }
+    service->last_sequence = header.sequence;
     
-    // Process each metric entry with service identification
-    for (uint32_t i = 0; i < header->metric_count; ++i) {
-        const SerializedMetricEntry& entry = entries[i];
-        std::string metric_name(entry.name);
-        
-        MetricStats stats;
-        stats.name = metric_name;
-        stats.service_name = service_name;  // Set the service that produced this metric
-        stats.type = static_cast<MetricType>(entry.type);
-        stats.count = 1;
-        stats.sum = entry.value;
-        stats.min_value = entry.value;
-        stats.max_value = entry.value;
-        stats.p50 = entry.value;
-        stats.p90 = entry.value;
-        stats.p95 = entry.value;
-        stats.p99 = entry.value;
-        stats.p999 = entry.value;
-        stats.mean = entry.value;
+    const uint8_t* pos = data + sizeof(MetricsMessage);
+    AggregatedMetric metric;
+    for (uint16_t i = 0; i < header.definition_count; ++i, pos += sizeof(MetricDefinition)) {
+        MetricDefinition definition;
+        std::memcpy(&definition, pos, sizeof(definition));
+        if (definition.metric_id >= MAX_METRICS_PER_SERVICE) continue;
         
-        // Use service-prefixed key for unique identification
-        std::string service_metric_key = service_name + "." + metric_name;
-        service_metrics.metrics[service_metric_key] = stats;
+        // Full messages repeat definitions; keep the value if it is the same metric
+        bool known = service->metrics.read(definition.metric_id, metric) && metric.session_id == header.session_id &&
+                     std::strncmp(metric.name, definition.name, sizeof(definition.name)) == 0;
+        if (!known) {
+            std::memset(&metric, 0, sizeof(metric));
+            std::memcpy(metric.name, definition.name, sizeof(definition.name));
+            metric.name[sizeof(metric.name) - 1] = '\0';
+            metric.session_id = header.session_id;
+            metric.type = static_cast<MetricType>(definition.type);
+            service->metrics.write(definition.metric_id, metric);
+            service->history[definition.metric_id].store(nullptr, std::memory_order_release);
+        }
+    }
+    
+    for (uint16_t i = 0; i < header.value_count; ++i, pos += sizeof(MetricValue)) {
+        MetricValue value;
+        std::memcpy(&value, pos, sizeof(value));
+        if (!service->metrics.read(value.metric_id, metric) || metric.session_id != header.session_id) {
+            // Defined in a message we missed; the next full message has it
+            undefined_values_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (metric.value != value.value) {
+            metric.value = value.value;
+            service->metrics.write(value.metric_id, metric);
+        }
     }
+    
+    // Unchanged values aren't resent, so every metric of the session gets
+    // its current value recorded
+    uint32_t now_s = static_cast<uint32_t>(now_ns / 1000000000ULL);
+    service->metrics.for_each([&](symbol_id_t id, const AggregatedMetric& current, uint64_t) {
+        if (current.session_id != header.session_id) return;
+        MetricHistory* history = service->history[id].load(std::memory_order_relaxed);
+        if (!history) {
+            auto& owned = service->histories[current.name];
+            if (!owned) owned = std::make_unique<MetricHistory>();
+            history = owned.get();
+            service->history[id].store(history, std::memory_order_release);
+        }
+        history->record(now_s, current.value);
+    });
+    
+    service->last_update_ns.store(now_ns, std::memory_order_relaxed);
+    service->online.store(true, std::memory_order_relaxed);
+    messages_processed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-void MetricsAggregator::mark_service_offline(const std::string& service_name) {
-    auto it = service_metrics_.find(service_name);
-    if (it != service_metrics_.end()) {
-        it->second.is_online = false;
-        std::cout << "[MetricsAggregator] Service " << service_name << " marked offline" << std::endl;
+template<typename Fn>
+void MetricsAggregator::for_each_metric(const ServiceSlot& service, Fn&& fn) const {
+    if (!service.online.load(std::memory_order_relaxed)) {
+        return;
     }
+    uint64_t session_id = service.session_id.load(std::memory_order_acquire);
+    service.metrics.for_each([&](symbol_id_t, const AggregatedMetric& metric, uint64_t) {
+        if (metric.session_id != session_id) return;
+        
+        MetricStats stats;
+        stats.name = metric.name;
+        stats.service_name = service.name;  // Set the service that produced this metric
+        stats.type = metric.type;
+        stats.count = 1;
+        stats.sum = metric.value;
+        stats.min_value = metric.value;
+        stats.max_value = metric.value;
+        stats.p50 = metric.value;
+        stats.p90 = metric.value;
+        stats.p95 = metric.value;
+        stats.p99 = metric.value;
+        stats.p999 = metric.value;
+        stats.mean = metric.value;
+        fn(std::move(stats));
+    });
 }
 
 std::unordered_map<std::string, MetricStats> MetricsAggregator::get_all_metrics() const {
-    // std::cout << "[MetricsAggregator] get_all_metrics() - trying to acquire mutex..." << std::endl;
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    // std::cout << "[MetricsAggregator] get_all_metrics() - mutex acquired, processing metrics..." << std::endl;
-    
     // Start with default metrics
     auto result = default_metrics_;
     
     // Override with actual metrics from online services
     // Keep service-specific keys to avoid conflicts between services
-    for (const auto& [service_name, service_metrics] : service_metrics_) {
-        if (service_metrics.is_online) {
-            for (const auto& [service_metric_key, stats] : service_metrics.metrics) {
-                result[service_metric_key] = stats;
-            }
-        }
+    size_t count = service_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        for_each_metric(*services_[i], [&](MetricStats&& stats) {
+            std::string service_metric_key = stats.service_name + "." + stats.name;
+            result[service_metric_key] = std::move(stats);
+        });
     }
     
-    // std::cout << "[MetricsAggregator] get_all_metrics() - returning " << result.size() << " metrics, releasing mutex..." << std::endl;
     return result;
 }
 
+std::vector<MetricHistory::Point> MetricsAggregator::get_metric_history(const std::string& service_name,
+                                                                       const std::string& metric_name,
+                                                                       MetricHistory::Tier tier, uint32_t since_s) const {
+    std::vector<MetricHistory::Point> points;
+    size_t count = service_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        const ServiceSlot& service = *services_[i];
+        if (service_name != service.name) continue;
+        
+        uint64_t session_id = service.session_id.load(std::memory_order_acquire);
+        service.metrics.for_each([&](symbol_id_t id, const AggregatedMetric& metric, uint64_t) {
+            if (metric.session_id != session_id || metric_name != metric.name) return;
+            if (const MetricHistory* history = service.history[id].load(std::memory_order_acquire)) {
+                history->read(tier, since_s, points);
+            }
+        });
+    }
+    return points;
+}
+
 std::vector<std::string> MetricsAggregator::get_online_services() const {
-    // std::cout << "[MetricsAggregator] get_online_services() - trying to acquire mutex..." << std::endl;
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    // std::cout << "[MetricsAggregator] get_online_services() - mutex acquired" << std::endl;
-    
     std::vector<std::string> online_services;
-    for (const auto& [service_name, service_metrics] : service_metrics_) {
-        if (service_metrics.is_online) {
-            online_services.push_back(service_name);
+    size_t count = service_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (services_[i]->online.load(std::memory_order_relaxed)) {
+            online_services.push_back(services_[i]->name);
         }
     }
     
-    // std::cout << "[MetricsAggregator] get_online_services() - returning " << online_services.size() << " services, releasing mutex..." << std::endl;
     return online_services;
 }
 
 std::unordered_map<std::string, MetricStats> MetricsAggregator::get_service_metrics(const std::string& service_name) const {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
     std::unordered_map<std::string, MetricStats> result;
     
     // Get default metrics for this service
@@ -295,20 +382,17 @@ std::unordered_map<std::string, MetricStats> MetricsAggregator::get_service_metr
     }
     
     // Override with actual metrics if service is online
-    auto service_it = service_metrics_.find(service_name);
-    if (service_it != service_metrics_.end() && service_it->second.is_online) {
-        for (const auto& [service_metric_key, stats] : service_it->second.metrics) {
-            // Extract metric name from service_metric_key (remove service prefix)
-            std::string metric_name = service_metric_key;
-            size_t dot_pos = metric_name.find('.');
-            if (dot_pos != std::string::npos) {
-                metric_name = metric_name.substr(dot_pos + 1);
-            }
-            result[metric_name] = stats;
+    size_t count = service_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (service_name == services_[i]->name) {
+            for_each_metric(*services_[i], [&](MetricStats&& stats) {
+                std::string metric_name = stats.name;
+                result[metric_name] = std::move(stats);
+            });
         }
     }
     
     return result;
 }
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
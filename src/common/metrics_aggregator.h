@@ -2,35 +2,39 @@
 
 #include "metrics_collector.h"
 #include "metrics_publisher.h"
+#include "conflation_table.h"
+#include "metric_history.h"
+#include "event_loop.h"
 #include <zmq.hpp>
+#include <array>
 #include <string>
 #include <atomic>
 #include <thread>
 #include <memory>
 #include <unordered_map>
-#include <mutex>
 #include <chrono>
+#include <vector>
 
 namespace hft {
 
-// Service metrics with timestamp for staleness detection
-struct ServiceMetrics {
-    std::string service_name;
-    uint64_t last_update_ns;
-    std::unordered_map<std::string, MetricStats> metrics;
-    bool is_online;
-    
-    ServiceMetrics() : last_update_ns(0), is_online(false) {}
-};
-
-// Aggregates metrics from multiple services via ZMQ
+// Aggregates metrics from multiple services via ZMQ. The subscriber (a task
+// on an EventLoop) is the only writer: each service gets a slot on first contact, and each
+// of its metrics a seqlock slot by metric ID, so merging a message takes no
+// lock and the dashboard's reads never wait on it. Every message also
+// extends each of the service's metrics' MetricHistory with its current
+// value, so recent history is served from here rather than by re-querying
+// the services.
 class MetricsAggregator {
 public:
+    static constexpr size_t MAX_SERVICES = 16;
+    
     explicit MetricsAggregator(const std::string& subscriber_endpoint = "tcp://localhost:5560");
     ~MetricsAggregator();
     
     bool initialize();
-    void start();
+    // Runs on the caller's loop, or on a loop thread of its own if none.
+    // A caller's loop must be stopped before stop().
+    void start(EventLoop* loop = nullptr);
     void stop();
     
     // Get aggregated metrics from all services
@@ -40,30 +44,76 @@ public:
     // Get metrics for a specific service
     std::unordered_map<std::string, MetricStats> get_service_metrics(const std::string& service_name) const;
     
-    // Initialize all expected metrics with zero values
+    // Buckets of one metric's history (service and metric as in
+    // get_service_metrics()) starting at or after since_s, oldest first;
+    // empty if the service or metric is unknown. Times are Unix seconds
+    // when the messages came through start().
+    std::vector<MetricHistory::Point> get_metric_history(const std::string& service_name, const std::string& metric_name,
+                                                         MetricHistory::Tier tier, uint32_t since_s = 0) const;
+    
+    // Initialize all expected metrics with zero values (before start())
     void initialize_default_metrics();
+    
+    // Merges one MetricsMessage; false if malformed. Called by the subscriber
+    // thread, exposed for tests.
+    bool process_metrics_message(const uint8_t* data, size_t size, uint64_t now_ns);
+    
+    // Statistics
+    uint64_t get_messages_processed() const { return messages_processed_.load(std::memory_order_relaxed); }
+    uint64_t get_sequence_gaps() const { return sequence_gaps_.load(std::memory_order_relaxed); }
+    uint64_t get_undefined_values() const { return undefined_values_.load(std::memory_order_relaxed); }
+    uint64_t get_rejected_messages() const { return rejected_messages_.load(std::memory_order_relaxed); }
 
 private:
+    struct AggregatedMetric {
+        char name[64];
+        uint64_t session_id;       // Slots from an earlier session are ignored
+        uint64_t value;
+        MetricType type;
+    };
+    
+    struct ServiceSlot {
+        char name[32] = {};                         // Fixed once the slot is published
+        std::atomic<uint64_t> session_id{0};
+        std::atomic<uint64_t> last_update_ns{0};
+        std::atomic<bool> online{false};
+        uint32_t last_sequence = 0;                 // Subscriber thread only
+        ConflationTable<AggregatedMetric, MAX_METRICS_PER_SERVICE> metrics;
+        // By metric ID, linked on the metric's first value. Histories belong
+        // to metric names and live as long as the aggregator, so a restarted
+        // service that renumbers its metrics carries on the same charts.
+        std::unique_ptr<std::atomic<MetricHistory*>[]> history{new std::atomic<MetricHistory*>[MAX_METRICS_PER_SERVICE]()};
+        std::unordered_map<std::string, std::unique_ptr<MetricHistory>> histories;   // Subscriber thread only
+    };
+    
     std::string subscriber_endpoint_;
     
     std::unique_ptr<zmq::context_t> context_;
     std::unique_ptr<zmq::socket_t> subscriber_;
     
     std::atomic<bool> running_;
-    std::unique_ptr<std::thread> subscribe_thread_;
-    std::unique_ptr<std::thread> cleanup_thread_;
+    EventLoop* loop_ = nullptr;
+    std::unique_ptr<EventLoop> own_loop_;      // When start() was given none
     
-    // Thread-safe storage for aggregated metrics
-    mutable std::mutex metrics_mutex_;
-    std::unordered_map<std::string, ServiceMetrics> service_metrics_;
+    // Slots [0, service_count_) are published; the name index is writer-only
+    std::array<std::unique_ptr<ServiceSlot>, MAX_SERVICES> services_;
+    std::atomic<size_t> service_count_{0};
+    std::unordered_map<std::string, ServiceSlot*> service_index_;
     
     // Default metric values to ensure all metrics are always available
     std::unordered_map<std::string, MetricStats> default_metrics_;
     
-    void subscribe_loop();
-    void cleanup_loop();
-    void process_metrics_message(const std::vector<uint8_t>& data);
-    void mark_service_offline(const std::string& service_name);
+    std::atomic<uint64_t> messages_processed_{0};
+    std::atomic<uint64_t> sequence_gaps_{0};
+    std::atomic<uint64_t> undefined_values_{0};
+    std::atomic<uint64_t> rejected_messages_{0};
+    
+    Task subscribe_task();
+    Task cleanup_task();
+    ServiceSlot* find_or_add_service(const char* name);
+    // Calls fn(metric) for every current metric of an online service
+    template<typename Fn>
+    void for_each_metric(const ServiceSlot& service, Fn&& fn) const;
     
     // Service staleness detection (5 seconds timeout)
     static constexpr uint64_t SERVICE_TIMEOUT_NS = 5000000000ULL;
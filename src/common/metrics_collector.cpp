@@ -1,4 +1,7 @@
 #include "metrics_collector.h"
+#include "hft_metrics.h"
+#include "trace_context.h"
+#include "cpu_topology.h"
 #include <algorithm>
 #include <fstream>
 #include <sstream>
@@ -7,15 +10,91 @@
 
 namespace hft {
 
-// Thread-local storage definitions
-thread_local std::unique_ptr<MetricsRingBuffer<>> MetricsCollector::thread_buffer_;
-thread_local std::unordered_map<std::string, HighResTimer::ticks_t> MetricsCollector::thread_timers_;
+// Entries moved per ring per pass of the drain loop
+static constexpr size_t DRAIN_BATCH = 256;
+// Collection passes (100ms each) between clock recalibrations
+static constexpr int RECALIBRATE_PASSES = 100;
 
 MetricsCollector& MetricsCollector::instance() {
     static MetricsCollector instance;
     return instance;
 }
 
+MetricsCollector::~MetricsCollector() {
+    HistogramNode* node = histogram_head_.load(std::memory_order_acquire);
+    while (node) {
+        HistogramNode* next = node->next;
+        delete node;
+        node = next;
+    }
+    
+    BufferNode* buffer = buffer_head_.load(std::memory_order_acquire);
+    while (buffer) {
+        BufferNode* next = buffer->next;
+        delete buffer;
+        buffer = next;
+    }
+}
+
+MetricsCollector::ThreadState& MetricsCollector::thread_state() {
+    thread_local ThreadState state;
+    return state;
+}
+
+MetricsCollector::ThreadState::~ThreadState() {
+    // Entries still in the ring are drained as usual; the next thread to
+    // claim it carries on from the same head
+    if (buffer) {
+        buffer->in_use.store(false, std::memory_order_release);
+    }
+}
+
+metric_id_t MetricsCollector::register_metric(const char* label, MetricType type) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto it = metric_ids_.find(label);
+    if (it != metric_ids_.end()) {
+        if (types_[it->second] != type) {
+            std::cerr << "[MetricsCollector] Metric " << label << " registered again as type "
+                      << static_cast<int>(type) << ", keeping " << static_cast<int>(types_[it->second]) << std::endl;
+        }
+        return it->second;
+    }
+    
+    size_t count = metric_count_.load(std::memory_order_relaxed);
+    if (count >= MAX_METRIC_IDS) {
+        std::cerr << "[MetricsCollector] Metric registry full, dropping: " << label << std::endl;
+        return INVALID_METRIC_ID;
+    }
+    
+    metric_id_t id = static_cast<metric_id_t>(count);
+    names_[id] = label;
+    types_[id] = type;
+    metric_ids_.emplace(label, id);
+    metric_count_.store(count + 1, std::memory_order_release);
+    return id;
+}
+
+const std::string& MetricsCollector::metric_name(metric_id_t id) const {
+    static const std::string unknown;
+    return id < metric_count() ? names_[id] : unknown;
+}
+
+MetricType MetricsCollector::metric_type(metric_id_t id) const {
+    return id < metric_count() ? types_[id] : MetricType::COUNTER;
+}
+
+metric_id_t MetricsCollector::label_id(const char* label, MetricType type) {
+    auto& ids = thread_state().label_ids;
+    auto it = ids.find(label);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    
+    metric_id_t id = register_metric(label, type);
+    ids.emplace(label, id);
+    return id;
+}
+
 void MetricsCollector::initialize() {
     if (initialized_.load()) {
         return;
@@ -57,115 +136,238 @@ void MetricsCollector::shutdown() {
     std::cout << "[MetricsCollector] Metrics collection system shutdown complete" << std::endl;
 }
 
-void MetricsCollector::record_latency(const char* label, uint64_t nanoseconds) {
-    auto* buffer = get_thread_buffer();
-    if (buffer) {
-        buffer->push(MetricEntry(label, nanoseconds, MetricType::LATENCY));
+void MetricsCollector::record_latency(metric_id_t id, uint64_t nanoseconds) {
+    if (LatencyHistogram* histogram = get_thread_histogram(id, MetricType::LATENCY)) {
+        histogram->record(nanoseconds);
     }
 }
 
-void MetricsCollector::increment_counter(const char* label) {
-    auto* buffer = get_thread_buffer();
-    if (buffer) {
-        buffer->push(MetricEntry(label, 1, MetricType::COUNTER));
+void MetricsCollector::increment_counter(metric_id_t id, uint64_t count) {
+    push(id, count, MetricType::COUNTER);
+}
+
+void MetricsCollector::set_gauge(metric_id_t id, uint64_t value) {
+    push(id, value, MetricType::GAUGE);
+}
+
+void MetricsCollector::record_histogram_value(metric_id_t id, uint64_t value) {
+    if (LatencyHistogram* histogram = get_thread_histogram(id, MetricType::HISTOGRAM)) {
+        histogram->record(value);
     }
 }
 
+void MetricsCollector::record_latency(const char* label, uint64_t nanoseconds) {
+    record_latency(label_id(label, MetricType::LATENCY), nanoseconds);
+}
+
+void MetricsCollector::increment_counter(const char* label) {
+    increment_counter(label_id(label, MetricType::COUNTER));
+}
+
 void MetricsCollector::set_gauge(const char* label, uint64_t value) {
-    auto* buffer = get_thread_buffer();
-    if (buffer) {
-        buffer->push(MetricEntry(label, value, MetricType::GAUGE));
-    }
+    set_gauge(label_id(label, MetricType::GAUGE), value);
 }
 
 void MetricsCollector::record_histogram_value(const char* label, uint64_t value) {
-    auto* buffer = get_thread_buffer();
-    if (buffer) {
-        buffer->push(MetricEntry(label, value, MetricType::HISTOGRAM));
+    record_histogram_value(label_id(label, MetricType::HISTOGRAM), value);
+}
+
+void MetricsCollector::push(metric_id_t id, uint64_t value, MetricType type) {
+    if (id >= MAX_METRIC_IDS) return;
+    if (!get_thread_buffer()->push(MetricEntry(id, value, type))) {
+        dropped_entries_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void MetricsCollector::start_timer(const char* label) {
-    thread_timers_[std::string(label)] = HighResTimer::get_ticks();
+void MetricsCollector::record_trace(const TraceContext& trace) {
+    // Each hop runs from the previous stage that was actually stamped
+    size_t previous = TRACE_STAGE_COUNT;
+    for (size_t i = 0; i < TRACE_STAGE_COUNT; ++i) {
+        if (trace.tsc[i] == 0) continue;
+        if (previous != TRACE_STAGE_COUNT) {
+            uint64_t ns = trace.elapsed_ns(static_cast<TraceStage>(previous), static_cast<TraceStage>(i));
+            if (ns > 0) {
+                record_latency(metrics::TRACE_HOP_LATENCY[i], ns);
+            }
+        }
+        previous = i;
+    }
+
+    if (uint64_t ns = trace.elapsed_ns(TraceStage::FEED_RECEIVE, TraceStage::STRATEGY_DECISION)) {
+        record_latency(metrics::TICK_TO_SIGNAL, ns);
+    }
+    if (uint64_t ns = trace.elapsed_ns(TraceStage::FEED_RECEIVE, TraceStage::GATEWAY_SEND)) {
+        record_latency(metrics::TICK_TO_ORDER, ns);
+    }
+    if (uint64_t ns = trace.elapsed_ns(TraceStage::FEED_RECEIVE, TraceStage::GATEWAY_ACK)) {
+        record_latency(metrics::TICK_TO_FILL, ns);
+    }
 }
 
-void MetricsCollector::end_timer(const char* label) {
-    auto it = thread_timers_.find(std::string(label));
-    if (it != thread_timers_.end()) {
+void MetricsCollector::start_timer(metric_id_t id) {
+    if (id >= MAX_METRIC_IDS) return;
+    auto& timers = thread_state().timers;
+    if (timers.size() <= id) {
+        timers.resize(id + 1, 0);
+    }
+    timers[id] = HighResTimer::get_ticks();
+}
+
+void MetricsCollector::end_timer(metric_id_t id) {
+    auto& timers = thread_state().timers;
+    if (id < timers.size() && timers[id] != 0) {
         uint64_t elapsed_ns = HighResTimer::ticks_to_nanoseconds(
-            HighResTimer::get_ticks() - it->second);
-        record_latency(label, elapsed_ns);
-        thread_timers_.erase(it);
+            HighResTimer::get_ticks() - timers[id]);
+        record_latency(id, elapsed_ns);
+        timers[id] = 0;
     }
 }
 
+void MetricsCollector::start_timer(const char* label) {
+    start_timer(label_id(label, MetricType::LATENCY));
+}
+
+void MetricsCollector::end_timer(const char* label) {
+    end_timer(label_id(label, MetricType::LATENCY));
+}
+
 MetricsRingBuffer<>* MetricsCollector::get_thread_buffer() {
-    if (!thread_buffer_) {
-        thread_buffer_ = std::make_unique<MetricsRingBuffer<>>();
-        
-        // Register this buffer for collection
-        std::lock_guard<std::mutex> lock(buffers_mutex_);
-        thread_buffers_.push_back(thread_buffer_.get());
+    ThreadState& state = thread_state();
+    if (state.buffer) {
+        return &state.buffer->ring;
+    }
+    
+    // Reuse a ring released by an exited thread
+    for (BufferNode* node = buffer_head_.load(std::memory_order_acquire); node; node = node->next) {
+        bool expected = false;
+        if (!node->in_use.load(std::memory_order_relaxed) &&
+            node->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            state.buffer = node;
+            return &node->ring;
+        }
+    }
+    
+    // Register a new one for collection
+    BufferNode* node = new BufferNode();
+    node->next = buffer_head_.load(std::memory_order_relaxed);
+    while (!buffer_head_.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+    }
+    state.buffer = node;
+    return &node->ring;
+}
+
+LatencyHistogram* MetricsCollector::get_thread_histogram(metric_id_t id, MetricType type) {
+    if (id >= MAX_METRIC_IDS) return nullptr;
+    auto& histograms = thread_state().histograms;
+    if (id < histograms.size() && histograms[id]) {
+        return &histograms[id]->histogram;
     }
-    return thread_buffer_.get();
+    
+    HistogramNode* node = new HistogramNode(metric_name(id), type);
+    node->next = histogram_head_.load(std::memory_order_relaxed);
+    while (!histogram_head_.compare_exchange_weak(node->next, node,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+    }
+    if (histograms.size() <= id) {
+        histograms.resize(id + 1, nullptr);
+    }
+    histograms[id] = node;
+    return &node->histogram;
 }
 
 std::unordered_map<std::string, MetricStats> MetricsCollector::get_statistics() const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(stats_mutex_));
-    return statistics_;
+    std::unordered_map<std::string, MetricStats> result;
+    {
+        std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(stats_mutex_));
+        result = statistics_;
+    }
+    
+    // Merge every thread's histogram for each label; recorders are never blocked
+    for (HistogramNode* node = histogram_head_.load(std::memory_order_acquire); node; node = node->next) {
+        auto& stats = result[node->label];
+        if (stats.name.empty()) {
+            stats.name = node->label;
+            stats.type = node->type;
+        }
+        stats.histogram.add(node->histogram);
+    }
+    
+    for (auto& [name, stats] : result) {
+        if (stats.type == MetricType::LATENCY || stats.type == MetricType::HISTOGRAM) {
+            stats.calculate_percentiles();
+        }
+    }
+    
+    return result;
 }
 
 void MetricsCollector::collect_from_all_threads() {
-    std::lock_guard<std::mutex> buffers_lock(buffers_mutex_);
+    // Single consumer: the stats lock also serialises the drain
     std::lock_guard<std::mutex> stats_lock(stats_mutex_);
     
-    // Collect from all thread buffers
-    for (auto* buffer : thread_buffers_) {
-        if (!buffer) continue;
-        
-        MetricEntry entry;
-        while (buffer->pop(entry)) {
-            std::string label(entry.label);
-            
-            // Get or create metric stats
-            auto& stats = statistics_[label];
-            if (stats.name.empty()) {
-                stats.name = label;
-                stats.type = entry.type;
-            }
-            
-            // Update statistics based on type
-            switch (entry.type) {
-                case MetricType::LATENCY:
-                case MetricType::HISTOGRAM:
-                    stats.update(entry.value);
-                    break;
-                    
-                case MetricType::COUNTER:
-                    stats.count += entry.value;
-                    stats.sum += entry.value;
-                    break;
-                    
-                case MetricType::GAUGE:
-                    stats.recent_values.push_back(entry.value);
-                    if (stats.recent_values.size() > 100) {
-                        stats.recent_values.erase(stats.recent_values.begin());
-                    }
-                    if (!stats.recent_values.empty()) {
-                        stats.sum = stats.recent_values.back(); // Latest value for gauges
+    std::array<MetricEntry, DRAIN_BATCH> batch;
+    for (BufferNode* node = buffer_head_.load(std::memory_order_acquire); node; node = node->next) {
+        size_t count;
+        while ((count = node->ring.pop_batch(batch.data(), batch.size())) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                const MetricEntry& entry = batch[i];
+                
+                if (stats_by_id_.size() <= entry.metric_id) {
+                    stats_by_id_.resize(entry.metric_id + 1, nullptr);
+                }
+                MetricStats*& slot = stats_by_id_[entry.metric_id];
+                if (!slot) {
+                    const std::string& label = metric_name(entry.metric_id);
+                    slot = &statistics_[label];
+                    if (slot->name.empty()) {
+                        slot->name = label;
+                        slot->type = entry.type;
                     }
-                    break;
+                }
+                MetricStats& stats = *slot;
+                
+                // Latency/histogram values never go through the ring buffers
+                switch (entry.type) {
+                    case MetricType::LATENCY:
+                    case MetricType::HISTOGRAM:
+                        break;
+                        
+                    case MetricType::COUNTER:
+                        stats.count += entry.value;
+                        stats.sum += entry.value;
+                        break;
+                        
+                    case MetricType::GAUGE:
+                        stats.recent_values.push_back(entry.value);
+                        if (stats.recent_values.size() > 100) {
+                            stats.recent_values.erase(stats.recent_values.begin());
+                        }
+                        stats.sum = entry.value; // Latest value for gauges
+                        break;
+                }
             }
         }
     }
 }
 
 void MetricsCollector::collection_thread_main() {
+    if (!ThreadPlan::instance().pin_current_thread("metrics")) {
+        std::cerr << "[MetricsCollector] Failed to pin metrics thread to its planned CPU" << std::endl;
+    }
     std::cout << "[MetricsCollector] Collection thread started" << std::endl;
     
+    int passes = 0;
     while (!shutdown_requested_.load()) {
         collect_from_all_threads();
         
+        // Refine the TSC rate and follow wall clock adjustments
+        if (++passes % RECALIBRATE_PASSES == 0) {
+            HighResTimer::recalibrate();
+        }
+        
         // Sleep for 100ms between collections
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
@@ -242,6 +444,11 @@ void MetricsCollector::monitoring_thread_main(int interval_ms) {
 void MetricsCollector::clear() {
     std::lock_guard<std::mutex> lock(stats_mutex_);
     statistics_.clear();
+    stats_by_id_.clear();
+    
+    for (HistogramNode* node = histogram_head_.load(std::memory_order_acquire); node; node = node->next) {
+        node->histogram.reset();
+    }
 }
 
 std::string MetricsCollector::export_to_csv() const {
@@ -249,7 +456,7 @@ std::string MetricsCollector::export_to_csv() const {
     std::ostringstream oss;
     
     // CSV header
-    oss << "metric_name,type,count,min_ns,max_ns,mean_ns,p50_ns,p90_ns,p95_ns,p99_ns,p999_ns\n";
+    oss << "metric_name,type,count,min_ns,max_ns,mean_ns,p50_ns,p90_ns,p95_ns,p99_ns,p999_ns,p9999_ns\n";
     
     for (const auto& [name, metric] : stats) {
         oss << name << ","
@@ -262,7 +469,8 @@ std::string MetricsCollector::export_to_csv() const {
             << metric.p90 << ","
             << metric.p95 << ","
             << metric.p99 << ","
-            << metric.p999 << "\n";
+            << metric.p999 << ","
+            << metric.p9999 << "\n";
     }
     
     return oss.str();
@@ -290,7 +498,8 @@ std::string MetricsCollector::export_to_json() const {
             << "      \"p90_ns\": " << metric.p90 << ",\n"
             << "      \"p95_ns\": " << metric.p95 << ",\n"
             << "      \"p99_ns\": " << metric.p99 << ",\n"
-            << "      \"p999_ns\": " << metric.p999 << "\n"
+            << "      \"p999_ns\": " << metric.p999 << ",\n"
+            << "      \"p9999_ns\": " << metric.p9999 << "\n"
             << "    }";
     }
     
@@ -320,17 +529,20 @@ void MetricsCollector::export_to_file(const std::string& filename, const std::st
 }
 
 void MetricStats::calculate_percentiles() {
-    if (recent_values.empty()) return;
+    if (histogram.empty()) return;
     
-    auto sorted_values = recent_values;
-    std::sort(sorted_values.begin(), sorted_values.end());
+    count = histogram.total;
+    sum = histogram.sum;
+    min_value = histogram.min_value;
+    max_value = histogram.max_value;
+    mean = static_cast<double>(sum) / count;
     
-    size_t size = sorted_values.size();
-    p50 = sorted_values[size * 50 / 100];
-    p90 = sorted_values[size * 90 / 100];
-    p95 = sorted_values[size * 95 / 100];
-    p99 = sorted_values[size * 99 / 100];
-    p999 = sorted_values[size * 999 / 1000];
+    p50 = histogram.percentile(0.50);
+    p90 = histogram.percentile(0.90);
+    p95 = histogram.percentile(0.95);
+    p99 = histogram.percentile(0.99);
+    p999 = histogram.percentile(0.999);
+    p9999 = histogram.percentile(0.9999);
 }
 
 } // namespace hft
\ No newline at end of file
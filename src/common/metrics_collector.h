@@ -1,8 +1,10 @@
 #pragma once
 
 #include "high_res_timer.h"
+#include "latency_histogram.h"
 #include <atomic>
 #include <array>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +15,8 @@
 
 namespace hft {
 
+struct TraceContext;
+
 // Metric types for different kinds of measurements
 enum class MetricType : uint8_t {
     LATENCY = 0,      // Timing measurements in nanoseconds
@@ -21,75 +25,85 @@ enum class MetricType : uint8_t {
     HISTOGRAM = 3     // Distribution of values
 };
 
+// Dense metric ID from MetricsCollector::register_metric(); the hot-path
+// record calls take it instead of a label
+using metric_id_t = uint16_t;
+static constexpr metric_id_t INVALID_METRIC_ID = UINT16_MAX;
+static constexpr size_t MAX_METRIC_IDS = 4096;
+
 // Individual metric entry - designed for lock-free operation
 struct MetricEntry {
     HighResTimer::ticks_t timestamp;
     uint64_t value;
-    const char* label;
+    metric_id_t metric_id;
     MetricType type;
-    uint32_t thread_id;
     
-    MetricEntry() : timestamp(0), value(0), label(""), type(MetricType::COUNTER), thread_id(0) {}
+    MetricEntry() : timestamp(0), value(0), metric_id(INVALID_METRIC_ID), type(MetricType::COUNTER) {}
     
-    MetricEntry(const char* lbl, uint64_t val, MetricType t)
-        : timestamp(HighResTimer::get_ticks()), value(val), label(lbl), type(t), thread_id(0) {}
+    MetricEntry(metric_id_t id, uint64_t val, MetricType t)
+        : timestamp(HighResTimer::get_ticks()), value(val), metric_id(id), type(t) {}
 };
 
-// Lock-free circular buffer for metrics (one per thread)
+// Lock-free SPSC ring for metrics (one per thread). Head and tail only
+// grow and are masked into the buffer; each side keeps a cached copy of the
+// other's index and only re-reads it (a cross-core cache miss) when the
+// cached value says the ring is full or empty.
 template<size_t CAPACITY = 1048576>  // 1M entries per thread
 class MetricsRingBuffer {
-public:
-    MetricsRingBuffer() : head_(0), tail_(0) {}
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static constexpr uint64_t MASK = CAPACITY - 1;
     
+public:
     // Add metric entry (lock-free for single producer)
     bool push(const MetricEntry& entry) {
-        uint64_t current_head = head_.load(std::memory_order_relaxed);
-        uint64_t next_head = (current_head + 1) % CAPACITY;
-        
-        if (next_head == tail_.load(std::memory_order_acquire)) {
-            // Buffer full - could increment a drop counter here
-            return false;
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= CAPACITY) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= CAPACITY) {
+                return false;   // Full
+            }
         }
         
-        buffer_[current_head] = entry;
-        head_.store(next_head, std::memory_order_release);
+        buffer_[head & MASK] = entry;
+        head_.store(head + 1, std::memory_order_release);
         return true;
     }
     
     // Pop metric entry (single consumer)
     bool pop(MetricEntry& entry) {
-        uint64_t current_tail = tail_.load(std::memory_order_relaxed);
-        
-        if (current_tail == head_.load(std::memory_order_acquire)) {
-            // Buffer empty
-            return false;
+        return pop_batch(&entry, 1) == 1;
+    }
+    
+    // Pops up to max entries with one index update; returns the count
+    size_t pop_batch(MetricEntry* out, size_t max) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (cached_head_ - tail < max) {
+            cached_head_ = head_.load(std::memory_order_acquire);
         }
-        
-        entry = buffer_[current_tail];
-        tail_.store((current_tail + 1) % CAPACITY, std::memory_order_release);
-        return true;
+        size_t count = static_cast<size_t>(std::min<uint64_t>(cached_head_ - tail, max));
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = buffer_[(tail + i) & MASK];
+        }
+        if (count) {
+            tail_.store(tail + count, std::memory_order_release);
+        }
+        return count;
     }
     
     // Get approximate size (for monitoring)
     size_t size() const {
-        uint64_t h = head_.load(std::memory_order_relaxed);
-        uint64_t t = tail_.load(std::memory_order_relaxed);
-        return (h >= t) ? (h - t) : (CAPACITY - t + h);
-    }
-    
-    bool empty() const {
-        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+        return static_cast<size_t>(head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed));
     }
     
-    bool full() const {
-        uint64_t next_head = (head_.load(std::memory_order_relaxed) + 1) % CAPACITY;
-        return next_head == tail_.load(std::memory_order_relaxed);
-    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= CAPACITY; }
 
 private:
     std::array<MetricEntry, CAPACITY> buffer_;
-    alignas(64) std::atomic<uint64_t> head_;  // Cache line aligned
-    alignas(64) std::atomic<uint64_t> tail_;  // Cache line aligned
+    alignas(64) std::atomic<uint64_t> head_{0};     // Written by the producer
+    uint64_t cached_tail_ = 0;                      // Producer's copy of tail_
+    alignas(64) std::atomic<uint64_t> tail_{0};     // Written by the consumer
+    uint64_t cached_head_ = 0;                      // Consumer's copy of head_
 };
 
 // Statistics for a metric
@@ -107,32 +121,25 @@ struct MetricStats {
     uint64_t p95 = 0;
     uint64_t p99 = 0;
     uint64_t p999 = 0;
+    uint64_t p9999 = 0;
+    
+    // Bucketed distribution for LATENCY/HISTOGRAM metrics
+    HistogramSnapshot histogram;
     
-    // Recent values for trend analysis
+    // Recent values for gauges
     std::vector<uint64_t> recent_values;
     
+    // Single-sample path; bulk callers merge into histogram and call
+    // calculate_percentiles() once instead
     void update(uint64_t value) {
-        count++;
-        min_value = std::min(min_value, value);
-        max_value = std::max(max_value, value);
-        sum += value;
-        mean = static_cast<double>(sum) / count;
-        
-        // Keep last 1000 values for percentile calculation
-        recent_values.push_back(value);
-        if (recent_values.size() > 1000) {
-            recent_values.erase(recent_values.begin());
-        }
-        
-        // Calculate percentiles if we have enough data
-        if (recent_values.size() >= 10) {
-            calculate_percentiles();
-        }
+        histogram.record(value);
+        calculate_percentiles();
     }
     
-private:
+    // Refresh count/sum/min/max/mean/percentiles from the histogram
     void calculate_percentiles();
     
+private:
     friend std::ostream& operator<<(std::ostream& os, const MetricStats& stats) {
         os << stats.name << ": count=" << stats.count << " mean=" << stats.mean 
            << " p50=" << stats.p50 << " p95=" << stats.p95 << " p99=" << stats.p99;
@@ -151,20 +158,44 @@ public:
     // Shutdown metrics system
     void shutdown();
     
+    // Same label, same ID; INVALID_METRIC_ID once MAX_METRIC_IDS are taken.
+    // Takes a lock: call it once per call site (the HFT_METRICS_* macros do)
+    // and keep the ID. The first registration fixes the type; a later one
+    // with another type gets the same ID and a warning.
+    metric_id_t register_metric(const char* label, MetricType type);
+    const std::string& metric_name(metric_id_t id) const;
+    MetricType metric_type(metric_id_t id) const;       // COUNTER if unknown
+    size_t metric_count() const { return metric_count_.load(std::memory_order_acquire); }
+    
     // Record different types of metrics
+    void record_latency(metric_id_t id, uint64_t nanoseconds);
+    void increment_counter(metric_id_t id, uint64_t count = 1);
+    void set_gauge(metric_id_t id, uint64_t value);
+    void record_histogram_value(metric_id_t id, uint64_t value);
+    
+    // Label forms resolve the ID through a per-thread cache keyed by pointer
     void record_latency(const char* label, uint64_t nanoseconds);
     void increment_counter(const char* label);
     void set_gauge(const char* label, uint64_t value);
     void record_histogram_value(const char* label, uint64_t value);
     
-    // Timing helpers
+    // Record every hop of a finished trace, plus tick-to-signal/order/fill
+    void record_trace(const TraceContext& trace);
+    
+    // Timing helpers (one pending start per metric and thread)
+    void start_timer(metric_id_t id);
+    void end_timer(metric_id_t id);
     void start_timer(const char* label);
     void end_timer(const char* label);
     
     // Get thread-local metrics buffer
     MetricsRingBuffer<>* get_thread_buffer();
     
-    // Get collected statistics
+    // Entries lost to full rings since startup
+    uint64_t get_dropped_entries() const { return dropped_entries_.load(std::memory_order_relaxed); }
+    
+    // Get collected statistics. Latency/histogram metrics are merged from
+    // the per-thread histograms on the fly without taking any lock.
     std::unordered_map<std::string, MetricStats> get_statistics() const;
     
     // Export metrics to different formats
@@ -181,20 +212,62 @@ public:
 
 private:
     MetricsCollector() = default;
-    ~MetricsCollector() = default;
+    ~MetricsCollector();
     
-    // Thread-local storage for metrics buffers
-    thread_local static std::unique_ptr<MetricsRingBuffer<>> thread_buffer_;
-    thread_local static std::unordered_map<std::string, HighResTimer::ticks_t> thread_timers_;
+    // One histogram per (thread, metric), pushed onto a lock-free list and
+    // never removed, so readers can walk it while threads keep adding
+    struct HistogramNode {
+        std::string label;
+        MetricType type;
+        LatencyHistogram histogram;
+        HistogramNode* next = nullptr;
+        
+        HistogramNode(const std::string& lbl, MetricType t) : label(lbl), type(t) {}
+    };
+    
+    // Ring buffers are owned by the collector, not the thread: a thread
+    // claims a free one on first use and hands it back when it exits, so
+    // registration takes no lock and the drain never sees a freed ring
+    struct BufferNode {
+        MetricsRingBuffer<> ring;
+        std::atomic<bool> in_use{true};
+        BufferNode* next = nullptr;
+    };
+    
+    // Per-thread state, indexed by metric ID
+    struct ThreadState {
+        BufferNode* buffer = nullptr;
+        std::vector<HistogramNode*> histograms;
+        std::vector<HighResTimer::ticks_t> timers;  // 0 = not started
+        std::unordered_map<const char*, metric_id_t> label_ids;
+        
+        ~ThreadState();
+    };
+    
+    static ThreadState& thread_state();
+    LatencyHistogram* get_thread_histogram(metric_id_t id, MetricType type);
+    metric_id_t label_id(const char* label, MetricType type);
+    
+    std::atomic<HistogramNode*> histogram_head_{nullptr};
+    std::atomic<BufferNode*> buffer_head_{nullptr};
+    std::atomic<uint64_t> dropped_entries_{0};
+    
+    // ID registry: names_ and types_ [0, metric_count_) are immutable once published
+    std::mutex registry_mutex_;
+    std::unordered_map<std::string, metric_id_t> metric_ids_;
+    std::unique_ptr<std::string[]> names_{new std::string[MAX_METRIC_IDS]};
+    std::unique_ptr<MetricType[]> types_{new MetricType[MAX_METRIC_IDS]};
+    std::atomic<size_t> metric_count_{0};
     
     // Global state
     std::atomic<bool> initialized_{false};
     std::atomic<bool> shutdown_requested_{false};
     
-    // Collection thread
+    // Collection thread (counters and gauges)
     std::unique_ptr<std::thread> collection_thread_;
     std::mutex stats_mutex_;
     std::unordered_map<std::string, MetricStats> statistics_;
+    std::vector<MetricStats*> stats_by_id_;         // Into statistics_, under stats_mutex_
     
     // Monitoring thread
     std::unique_ptr<std::thread> monitoring_thread_;
@@ -206,34 +279,43 @@ private:
     void collect_from_all_threads();
     void collection_thread_main();
     void monitoring_thread_main(int interval_ms);
-    
-    // Registered thread buffers (for collection)
-    std::mutex buffers_mutex_;
-    std::vector<MetricsRingBuffer<>*> thread_buffers_;
+    void push(metric_id_t id, uint64_t value, MetricType type);
 };
 
 // RAII metrics timer
 class MetricsTimer {
 public:
-    explicit MetricsTimer(const char* label)
-        : label_(label), start_ticks_(HighResTimer::get_ticks()) {}
+    explicit MetricsTimer(metric_id_t id)
+        : id_(id), start_ticks_(HighResTimer::get_ticks()) {}
     
     ~MetricsTimer() {
         uint64_t elapsed_ns = HighResTimer::ticks_to_nanoseconds(
             HighResTimer::get_ticks() - start_ticks_);
-        MetricsCollector::instance().record_latency(label_, elapsed_ns);
+        MetricsCollector::instance().record_latency(id_, elapsed_ns);
     }
 
 private:
-    const char* label_;
+    metric_id_t id_;
     HighResTimer::ticks_t start_ticks_;
 };
 
-// Convenient macros for metrics collection
-#define HFT_METRICS_TIMER(label) hft::MetricsTimer _metrics_timer(label)
-#define HFT_METRICS_LATENCY(label, ns) hft::MetricsCollector::instance().record_latency(label, ns)
-#define HFT_METRICS_COUNTER(label) hft::MetricsCollector::instance().increment_counter(label)
-#define HFT_METRICS_GAUGE(label, value) hft::MetricsCollector::instance().set_gauge(label, value)
-#define HFT_METRICS_HISTOGRAM(label, value) hft::MetricsCollector::instance().record_histogram_value(label, value)
+// The label's ID, registered the first time this call site runs; after
+// that a static guard check
+#define HFT_METRIC_ID(label, type) \
+    ([]() -> hft::metric_id_t { \
+        static const hft::metric_id_t id = hft::MetricsCollector::instance().register_metric(label, type); \
+        return id; \
+    }())
+
+// Convenient macros for metrics collection; label must be a constant
+#define HFT_METRICS_TIMER(label) hft::MetricsTimer _metrics_timer(HFT_METRIC_ID(label, hft::MetricType::LATENCY))
+#define HFT_METRICS_LATENCY(label, ns) \
+    hft::MetricsCollector::instance().record_latency(HFT_METRIC_ID(label, hft::MetricType::LATENCY), ns)
+#define HFT_METRICS_COUNTER(label) \
+    hft::MetricsCollector::instance().increment_counter(HFT_METRIC_ID(label, hft::MetricType::COUNTER))
+#define HFT_METRICS_GAUGE(label, value) \
+    hft::MetricsCollector::instance().set_gauge(HFT_METRIC_ID(label, hft::MetricType::GAUGE), value)
+#define HFT_METRICS_HISTOGRAM(label, value) \
+    hft::MetricsCollector::instance().record_histogram_value(HFT_METRIC_ID(label, hft::MetricType::HISTOGRAM), value)
 
 } // namespace hft
\ No newline at end of file
@@ -1,13 +1,101 @@
 #include "metrics_publisher.h"
 #include "high_res_timer.h"
+#include "cpu_topology.h"
+#include "alloc_tracker.h"
 #include <iostream>
 #include <cstring>
 #include <algorithm>
 
 namespace hft {
 
+uint64_t representative_value(const MetricStats& stats) {
+    switch (stats.type) {
+        case MetricType::LATENCY:
+            return stats.p99;
+        case MetricType::COUNTER:
+            return stats.count;
+        case MetricType::GAUGE:
+            return stats.recent_values.empty() ? 0 : stats.recent_values.back();
+        case MetricType::HISTOGRAM:
+            return stats.p95;
+    }
+    return 0;
+}
+
+MetricsEncoder::MetricsEncoder(const std::string& service_name, uint64_t session_id)
+    : session_id_(session_id) {
+    std::strncpy(service_name_, service_name.c_str(), sizeof(service_name_) - 1);
+    
+    names_.reserve(MAX_METRICS_PER_SERVICE);
+    types_.reserve(MAX_METRICS_PER_SERVICE);
+    last_values_.reserve(MAX_METRICS_PER_SERVICE);
+    value_sent_.reserve(MAX_METRICS_PER_SERVICE);
+    values_.reserve(MAX_METRICS_PER_SERVICE);
+    buffer_.resize(sizeof(MetricsMessage) +
+                   MAX_METRICS_PER_SERVICE * (sizeof(MetricDefinition) + sizeof(MetricValue)));
+}
+
+size_t MetricsEncoder::encode(const std::unordered_map<std::string, MetricStats>& stats, uint64_t timestamp_ns,
+                              bool full) {
+    uint8_t* out = buffer_.data() + sizeof(MetricsMessage);
+    size_t first_new = full ? 0 : names_.size();
+    values_.clear();
+    
+    for (const auto& [name, metric_stats] : stats) {
+        auto it = ids_.find(name);
+        if (it == ids_.end()) {
+            if (names_.size() >= MAX_METRICS_PER_SERVICE) {
+                dropped_metrics_++;
+                continue;
+            }
+            it = ids_.emplace(name, static_cast<uint16_t>(names_.size())).first;
+            names_.push_back(name);
+            types_.push_back(static_cast<uint8_t>(metric_stats.type));
+            last_values_.push_back(0);
+            value_sent_.push_back(0);
+        }
+        
+        uint16_t id = it->second;
+        uint64_t value = representative_value(metric_stats);
+        if (full || !value_sent_[id] || value != last_values_[id]) {
+            values_.push_back(MetricValue{id, value});
+            last_values_[id] = value;
+            value_sent_[id] = 1;
+        }
+    }
+    
+    // Definitions (all of them for a full message), then the values
+    for (size_t id = first_new; id < names_.size(); ++id) {
+        MetricDefinition definition{};
+        definition.metric_id = static_cast<uint16_t>(id);
+        definition.type = types_[id];
+        std::strncpy(definition.name, names_[id].c_str(), sizeof(definition.name) - 1);
+        std::memcpy(out, &definition, sizeof(definition));
+        out += sizeof(definition);
+    }
+    std::memcpy(out, values_.data(), values_.size() * sizeof(MetricValue));
+    out += values_.size() * sizeof(MetricValue);
+    
+    MetricsMessage header{};
+    header.magic = METRICS_MAGIC;
+    header.version = METRICS_VERSION;
+    header.flags = full ? METRICS_FLAG_FULL : 0;
+    std::memcpy(header.service_name, service_name_, sizeof(header.service_name));
+    header.session_id = session_id_;
+    header.sequence = ++sequence_;
+    header.timestamp_ns = timestamp_ns;
+    header.definition_count = static_cast<uint16_t>(names_.size() - first_new);
+    header.value_count = static_cast<uint16_t>(values_.size());
+    std::memcpy(buffer_.data(), &header, sizeof(header));
+    
+    return static_cast<size_t>(out - buffer_.data());
+}
+
 MetricsPublisher::MetricsPublisher(const std::string& service_name, const std::string& endpoint)
-    : service_name_(service_name), endpoint_(endpoint), running_(false) {
+    : service_name_(service_name), endpoint_(endpoint), 
+      encoder_(service_name, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count())),
+      running_(false) {
     // Truncate service name if too long
     if (service_name_.length() >= 32) {
         service_name_ = service_name_.substr(0, 31);
@@ -21,6 +109,7 @@ MetricsPublisher::~MetricsPublisher() {
 bool MetricsPublisher::initialize() {
     try {
         context_ = std::make_unique<zmq::context_t>(1);
+        ThreadPlan::instance().pin_zmq_io_threads(static_cast<void*>(*context_));
         publisher_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
         
         // Set socket options for better performance
@@ -70,17 +159,21 @@ void MetricsPublisher::stop() {
 }
 
 void MetricsPublisher::publish_loop(int interval_ms) {
+    if (!ThreadPlan::instance().pin_current_thread("metrics_publisher")) {
+        std::cerr << "[MetricsPublisher] Failed to pin metrics_publisher thread to its planned CPU" << std::endl;
+    }
     auto interval = std::chrono::milliseconds(interval_ms);
+    uint64_t published = 0;
     
     while (running_.load()) {
         try {
-            auto message_data = serialize_metrics();
-            
-            if (!message_data.empty()) {
-                zmq::message_t message(message_data.size());
-                std::memcpy(message.data(), message_data.data(), message_data.size());
-                publisher_->send(message, zmq::send_flags::dontwait);
-            }
+            // Sent even when nothing changed: it doubles as the heartbeat
+            bool full = published++ % FULL_SNAPSHOT_INTERVAL == 0;
+            AllocTracker::publish_metrics();
+            size_t size = encoder_.encode(MetricsCollector::instance().get_statistics(),
+                                          HighResTimer::get_nanoseconds(), full);
+            zmq::message_t message(encoder_.data(), size);
+            publisher_->send(message, zmq::send_flags::dontwait);
             
         } catch (const zmq::error_t& e) {
             if (e.num() != EAGAIN) {
@@ -92,54 +185,4 @@ void MetricsPublisher::publish_loop(int interval_ms) {
     }
 }
 
-std::vector<uint8_t> MetricsPublisher::serialize_metrics() {
-    auto& collector = MetricsCollector::instance();
-    auto stats = collector.get_statistics();
-    
-    if (stats.empty()) {
-        return {};
-    }
-    
-    // Calculate message size
-    size_t message_size = sizeof(MetricsMessage) + (stats.size() * sizeof(SerializedMetricEntry));
-    std::vector<uint8_t> buffer(message_size);
-    
-    // Fill header
-    MetricsMessage* header = reinterpret_cast<MetricsMessage*>(buffer.data());
-    std::memset(header->service_name, 0, sizeof(header->service_name));
-    std::strncpy(header->service_name, service_name_.c_str(), sizeof(header->service_name) - 1);
-    header->timestamp_ns = HighResTimer::get_nanoseconds();
-    header->metric_count = static_cast<uint32_t>(stats.size());
-    
-    // Fill metrics data
-    SerializedMetricEntry* entries = reinterpret_cast<SerializedMetricEntry*>(buffer.data() + sizeof(MetricsMessage));
-    size_t entry_idx = 0;
-    
-    for (const auto& [name, metric_stats] : stats) {
-        SerializedMetricEntry& entry = entries[entry_idx++];
-        
-        std::memset(entry.name, 0, sizeof(entry.name));
-        std::strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
-        entry.type = static_cast<uint32_t>(metric_stats.type);
-        
-        // Choose appropriate value based on metric type
-        switch (metric_stats.type) {
-            case MetricType::LATENCY:
-                entry.value = metric_stats.p99; // Use P99 as representative value
-                break;
-            case MetricType::COUNTER:
-                entry.value = metric_stats.count;
-                break;
-            case MetricType::GAUGE:
-                entry.value = metric_stats.recent_values.empty() ? 0 : metric_stats.recent_values.back();
-                break;
-            case MetricType::HISTOGRAM:
-                entry.value = metric_stats.p95; // Use P95 as representative value
-                break;
-        }
-    }
-    
-    return buffer;
-}
-
 } // namespace hft
\ No newline at end of file
@@ -7,24 +7,80 @@
 #include <thread>
 #include <memory>
 #include <chrono>
+#include <unordered_map>
+#include <vector>
 
 namespace hft {
 
-// Metrics message for inter-process communication
+// Metrics wire format. A message is a MetricsMessage header, then
+// definition_count MetricDefinition records, then value_count MetricValue
+// records. A metric's name and type are sent once, when it first appears,
+// and after that only its ID and value, and only when the value changed.
+// Every FULL_SNAPSHOT_INTERVAL-th message is full (FLAG_FULL): every
+// definition and every value, so a subscriber that joined late or missed
+// messages catches up. IDs are per session; a restarted publisher starts a
+// new session and numbers its metrics again.
+static constexpr uint32_t METRICS_MAGIC = 0x4D544648;     // "HFTM"
+static constexpr uint16_t METRICS_VERSION = 2;
+static constexpr uint16_t METRICS_FLAG_FULL = 1;
+static constexpr size_t MAX_METRICS_PER_SERVICE = 1024;
+
 struct MetricsMessage {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
     char service_name[32];
+    uint64_t session_id;
+    uint32_t sequence;         // Per session, increments every message
     uint64_t timestamp_ns;
-    uint32_t metric_count;
-    // Variable-length data follows: SerializedMetricEntry entries
+    uint16_t definition_count;
+    uint16_t value_count;
 } __attribute__((packed));
 
-// Individual metric entry in the message
-struct SerializedMetricEntry {
+struct MetricDefinition {
+    uint16_t metric_id;
+    uint8_t type;              // MetricType
     char name[64];
+} __attribute__((packed));
+
+struct MetricValue {
+    uint16_t metric_id;
     uint64_t value;
-    uint32_t type; // MetricType enum value
 } __attribute__((packed));
 
+// One value per metric on the wire: p99 for latencies, p95 for histograms,
+// the count for counters and the last value for gauges
+uint64_t representative_value(const MetricStats& stats);
+
+// Builds the messages for one publisher into a buffer allocated once.
+// Single-threaded.
+class MetricsEncoder {
+public:
+    explicit MetricsEncoder(const std::string& service_name, uint64_t session_id);
+
+    // Returns the message size; data() holds it until the next call.
+    // Metrics beyond MAX_METRICS_PER_SERVICE are not published.
+    size_t encode(const std::unordered_map<std::string, MetricStats>& stats, uint64_t timestamp_ns, bool full);
+    const uint8_t* data() const { return buffer_.data(); }
+
+    size_t metric_count() const { return names_.size(); }
+    uint64_t get_dropped_metrics() const { return dropped_metrics_; }
+
+private:
+    char service_name_[32] = {};
+    uint64_t session_id_;
+    uint32_t sequence_ = 0;
+
+    std::unordered_map<std::string, uint16_t> ids_;
+    std::vector<std::string> names_;            // By ID
+    std::vector<uint8_t> types_;
+    std::vector<uint64_t> last_values_;
+    std::vector<uint8_t> value_sent_;
+    std::vector<MetricValue> values_;           // Scratch, reserved once
+    std::vector<uint8_t> buffer_;
+    uint64_t dropped_metrics_ = 0;
+};
+
 // Publisher for distributing metrics to central aggregator
 class MetricsPublisher {
 public:
@@ -36,9 +92,13 @@ public:
     void start(int publish_interval_ms = 2000); // Default 2 seconds
     void stop();
     
+    // Messages between full snapshots (2 s interval: every 10 s)
+    static constexpr uint32_t FULL_SNAPSHOT_INTERVAL = 5;
+    
 private:
     std::string service_name_;
     std::string endpoint_;
+    MetricsEncoder encoder_;
     
     std::unique_ptr<zmq::context_t> context_;
     std::unique_ptr<zmq::socket_t> publisher_;
@@ -47,7 +107,6 @@ private:
     std::unique_ptr<std::thread> publish_thread_;
     
     void publish_loop(int interval_ms);
-    std::vector<uint8_t> serialize_metrics();
 };
 
 } // namespace hft
\ No newline at end of file
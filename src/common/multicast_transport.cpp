@@ -0,0 +1,595 @@
+#include "multicast_transport.h"
+#include "static_config.h"
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr int SOCKET_BUFFER_BYTES = 4 * 1024 * 1024;
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t ring_capacity(size_t requested) {
+    size_t size = 16;
+    while (size < requested) size <<= 1;
+    return size;
+}
+
+} // namespace
+
+namespace rmcast {
+
+bool parse_endpoint(const std::string& endpoint, sockaddr_in& group) {
+    static const std::string scheme = "rmcast://";
+    if (endpoint.compare(0, scheme.size(), scheme) != 0) return false;
+    std::string address = endpoint.substr(scheme.size());
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) return false;
+
+    int port = 0;
+    try {
+        port = std::stoi(address.substr(colon + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    std::memset(&group, 0, sizeof(group));
+    group.sin_family = AF_INET;
+    group.sin_port = htons(static_cast<uint16_t>(port));
+    return port > 0 && port <= 65535 &&
+           inet_pton(AF_INET, address.substr(0, colon).c_str(), &group.sin_addr) == 1 &&
+           IN_MULTICAST(ntohl(group.sin_addr.s_addr));
+}
+
+} // namespace rmcast
+
+// ---------------------------------------------------------------------------
+// MulticastTransport
+
+MulticastTransport::MulticastTransport() = default;
+
+MulticastTransport::~MulticastTransport() {
+    close();
+}
+
+bool MulticastTransport::initialize(const TransportConfig& config) {
+    config_ = config;
+    endpoint_ = config.endpoint;
+    ring_size_ = ring_capacity(config.retransmit_ring);
+    interface_.s_addr = htonl(INADDR_ANY);
+    if (!config.multicast_interface.empty() &&
+        inet_pton(AF_INET, config.multicast_interface.c_str(), &interface_) != 1) {
+        std::cerr << "[Multicast] Invalid interface address " << config.multicast_interface << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MulticastTransport::open_socket() {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        std::cerr << "[Multicast] socket failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MulticastTransport::close() {
+    stop_async_receive();
+    on_close();
+    connected_.store(false);
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void MulticastTransport::start_async_receive() {
+    if (async_active_.load() || !receive_callback_ || !connected_.load()) return;
+
+    async_active_.store(true);
+    receive_thread_ = std::make_unique<std::thread>([this]() {
+        char buffer[rmcast::MAX_PAYLOAD];
+        pollfd entry{get_poll_fd(), POLLIN, 0};
+        while (async_active_.load(std::memory_order_relaxed) && connected_.load(std::memory_order_relaxed)) {
+            size_t size = sizeof(buffer);
+            if (receive(buffer, size, true)) {
+                receive_callback_(buffer, size);
+            } else {
+                ::poll(&entry, 1, 100);
+            }
+        }
+    });
+}
+
+void MulticastTransport::stop_async_receive() {
+    async_active_.store(false);
+    if (receive_thread_ && receive_thread_->joinable()) {
+        receive_thread_->join();
+    }
+    receive_thread_.reset();
+}
+
+// ---------------------------------------------------------------------------
+// RmcastPublisher
+
+RmcastPublisher::~RmcastPublisher() {
+    close();
+}
+
+bool RmcastPublisher::bind(const std::string& endpoint) {
+    if (!rmcast::parse_endpoint(endpoint, group_)) {
+        std::cerr << "[Multicast] Invalid endpoint " << endpoint << " (rmcast://<group>:<port>)" << std::endl;
+        return false;
+    }
+    if (!open_socket()) return false;
+
+    // An ephemeral unicast port: receivers NAK to where the data came from
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr = interface_;
+    int ttl = config_.multicast_ttl;
+    int loop = 1;   // Receivers on this host hear the group too
+    int buffer = SOCKET_BUFFER_BYTES;
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+        (interface_.s_addr != htonl(INADDR_ANY) &&
+         setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &interface_, sizeof(interface_)) != 0)) {
+        std::cerr << "[Multicast] Cannot set up " << endpoint << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+
+    // Receivers tell a restarted publisher from the old one by this
+    session_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    ring_ = std::make_unique<Slot[]>(ring_size_);
+    last_sequence_.store(0);
+    last_send_ns_.store(steady_now_ns());
+    endpoint_ = endpoint;
+    connected_.store(true);
+
+    repairing_.store(true);
+    repair_thread_ = std::thread(&RmcastPublisher::run_repair, this);
+    return true;
+}
+
+void RmcastPublisher::on_close() {
+    repairing_.store(false);
+    if (repair_thread_.joinable()) {
+        repair_thread_.join();
+    }
+}
+
+bool RmcastPublisher::send(const void* data, size_t size, bool non_blocking) {
+    (void)non_blocking;     // Never blocks: the kernel takes it or the ring keeps it
+    if (size > rmcast::MAX_PAYLOAD || !connected_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Into the ring first, so a NAK for it can be answered from the moment it is sent
+    uint64_t sequence = last_sequence_.load(std::memory_order_relaxed) + 1;
+    Slot& slot = ring_[sequence & (ring_size_ - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(slot.payload, data, size);
+    slot.size = static_cast<uint32_t>(size);
+    slot.sequence.store(sequence, std::memory_order_release);
+    last_sequence_.store(sequence, std::memory_order_release);
+
+    if (!send_packet(rmcast::PacketType::DATA, sequence, static_cast<uint32_t>(size), slot.payload, size, group_)) {
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    last_send_ns_.store(steady_now_ns(), std::memory_order_relaxed);
+    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(size, std::memory_order_relaxed);
+    return true;
+}
+
+bool RmcastPublisher::publish(const std::string& topic, const void* data, size_t size) {
+    // "topic\0payload", as the shared memory transport frames it
+    char framed[rmcast::MAX_PAYLOAD];
+    size_t prefix = topic.size() + 1;
+    if (prefix + size > sizeof(framed)) return false;
+    std::memcpy(framed, topic.c_str(), prefix);
+    std::memcpy(framed + prefix, data, size);
+    return send(framed, prefix + size, true);
+}
+
+bool RmcastPublisher::send_packet(rmcast::PacketType type, uint64_t sequence, uint32_t count,
+                                  const void* payload, size_t size, const sockaddr_in& to) {
+    rmcast::PacketHeader header{rmcast::MAGIC, type, 0, session_, sequence, count, 0};
+    iovec parts[2] = {{&header, sizeof(header)}, {const_cast<void*>(payload), size}};
+    msghdr message{};
+    message.msg_name = const_cast<sockaddr_in*>(&to);
+    message.msg_namelen = sizeof(to);
+    message.msg_iov = parts;
+    message.msg_iovlen = size > 0 ? 2 : 1;
+    return ::sendmsg(fd_, &message, MSG_DONTWAIT) >= 0;
+}
+
+bool RmcastPublisher::read_slot(uint64_t sequence, char* payload, uint32_t& size) const {
+    const Slot& slot = ring_[sequence & (ring_size_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != sequence) return false;
+    size = slot.size;
+    if (size > rmcast::MAX_PAYLOAD) return false;
+    std::memcpy(payload, slot.payload, size);
+    // The publisher may have lapped the slot during the copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+void RmcastPublisher::run_repair() {
+    if (!ThreadPlan::instance().pin_current_thread("rmcast_repair")) {
+        std::cerr << "[Multicast] Failed to pin rmcast_repair thread to its planned CPU" << std::endl;
+    }
+    const int64_t heartbeat_ns = static_cast<int64_t>(std::max(1, config_.heartbeat_interval_ms)) * 1000000;
+    const int poll_ms = std::max(1, std::min(config_.heartbeat_interval_ms, 50));
+    pollfd entry{fd_, POLLIN, 0};
+    char buffer[rmcast::MAX_DATAGRAM];
+
+    while (repairing_.load(std::memory_order_acquire)) {
+        ::poll(&entry, 1, poll_ms);
+
+        sockaddr_in from{};
+        socklen_t length = sizeof(from);
+        ssize_t received;
+        while ((received = ::recvfrom(fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                      reinterpret_cast<sockaddr*>(&from), &length)) >= 0) {
+            rmcast::PacketHeader header;
+            if (static_cast<size_t>(received) >= sizeof(header)) {
+                std::memcpy(&header, buffer, sizeof(header));
+                if (header.magic == rmcast::MAGIC && header.type == rmcast::PacketType::NAK &&
+                    header.session == session_) {
+                    answer_nak(header, from);
+                }
+            }
+            length = sizeof(from);
+        }
+
+        // Quiet publisher: tell receivers where the sequence stands, so a
+        // lost last message is noticed without waiting for the next one
+        int64_t now = steady_now_ns();
+        if (now - last_send_ns_.load(std::memory_order_relaxed) >= heartbeat_ns) {
+            send_packet(rmcast::PacketType::HEARTBEAT, last_sequence(), 0, nullptr, 0, group_);
+            last_send_ns_.store(now, std::memory_order_relaxed);
+        }
+    }
+}
+
+void RmcastPublisher::answer_nak(const rmcast::PacketHeader& nak, const sockaddr_in& from) {
+    naks_received_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t first = std::max<uint64_t>(nak.sequence, 1);
+    uint64_t end = std::min(first + std::min(nak.count, rmcast::MAX_NAK_RANGE), last_sequence() + 1);
+
+    // Runs of messages already overwritten go back as one UNAVAILABLE each
+    char payload[rmcast::MAX_PAYLOAD];
+    uint64_t gone_first = 0;
+    uint32_t gone = 0;
+    for (uint64_t sequence = first; sequence < end; ++sequence) {
+        uint32_t size = 0;
+        if (read_slot(sequence, payload, size)) {
+            if (gone > 0) {
+                send_packet(rmcast::PacketType::UNAVAILABLE, gone_first, gone, nullptr, 0, from);
+                gone = 0;
+            }
+            send_packet(rmcast::PacketType::RETRANSMIT, sequence, size, payload, size, from);
+            retransmitted_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            if (gone++ == 0) gone_first = sequence;
+            unavailable_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (gone > 0) {
+        send_packet(rmcast::PacketType::UNAVAILABLE, gone_first, gone, nullptr, 0, from);
+    }
+}
+
+rmcast::PublisherStats RmcastPublisher::stats() const {
+    rmcast::PublisherStats stats;
+    stats.naks_received = naks_received_.load(std::memory_order_relaxed);
+    stats.retransmitted = retransmitted_.load(std::memory_order_relaxed);
+    stats.unavailable = unavailable_.load(std::memory_order_relaxed);
+    stats.send_errors = send_errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// RmcastSubscriber
+
+RmcastSubscriber::~RmcastSubscriber() {
+    close();
+}
+
+bool RmcastSubscriber::connect(const std::string& endpoint) {
+    if (!rmcast::parse_endpoint(endpoint, group_)) {
+        std::cerr << "[Multicast] Invalid endpoint " << endpoint << " (rmcast://<group>:<port>)" << std::endl;
+        return false;
+    }
+    if (!open_socket()) return false;
+
+    // Bound to the group address, so other groups on the port stay out;
+    // several receivers on one host share the port
+    int one = 1;
+    int buffer = SOCKET_BUFFER_BYTES;
+    ip_mreq membership{};
+    membership.imr_multiaddr = group_.sin_addr;
+    membership.imr_interface = interface_;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&group_), sizeof(group_)) != 0 ||
+        setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        std::cerr << "[Multicast] Cannot join " << endpoint << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    // NAKs leave from a socket of our own, so retransmits come back to
+    // this receiver and not to whichever one shares the group port
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr = interface_;
+    nak_fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    ready_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    retry_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (nak_fd_ < 0 || epoll_fd_ < 0 || ready_fd_ < 0 || retry_fd_ < 0 ||
+        ::bind(nak_fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        std::cerr << "[Multicast] Cannot set up " << endpoint << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    for (int fd : {fd_, nak_fd_, ready_fd_, retry_fd_}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    window_.assign(ring_size_, Slot{});
+    session_ = 0;
+    endpoint_ = endpoint;
+    connected_.store(true);
+    return true;
+}
+
+void RmcastSubscriber::on_close() {
+    for (int* fd : {&nak_fd_, &epoll_fd_, &ready_fd_, &retry_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    ready_signaled_ = false;
+    retry_armed_ = false;
+}
+
+bool RmcastSubscriber::receive(void* data, size_t& size, bool non_blocking) {
+    if (!connected_.load(std::memory_order_relaxed)) return false;
+
+    int64_t deadline = config_.receive_timeout_ms >= 0
+        ? steady_now_ns() + static_cast<int64_t>(config_.receive_timeout_ms) * 1000000 : INT64_MAX;
+    while (true) {
+        // Read until the next message is in, repairs before new data
+        while (!ready() && (read_datagram(nak_fd_) || read_datagram(fd_))) {}
+        check_gap(steady_now_ns());
+
+        if (ready()) {
+            Slot& slot = window_[next_ & (ring_size_ - 1)];
+            if (slot.size > size) {
+                std::cerr << "[Multicast] Receive buffer too small" << std::endl;
+                return false;
+            }
+            std::memcpy(data, slot.payload, slot.size);
+            size = slot.size;
+            slot.sequence = 0;
+            ++next_;
+            messages_received_.fetch_add(1, std::memory_order_relaxed);
+            bytes_received_.fetch_add(size, std::memory_order_relaxed);
+            update_ready();
+            return true;
+        }
+        update_ready();
+
+        int64_t now = steady_now_ns();
+        if (non_blocking || now >= deadline) return false;
+        // Wake for a datagram, or to re-NAK a gap nobody answered
+        int64_t wait_ns = std::min(deadline - now, rmcast::NAK_RETRY_NS);
+        pollfd entry{epoll_fd_, POLLIN, 0};
+        ::poll(&entry, 1, static_cast<int>(std::max<int64_t>(1, wait_ns / 1000000)));
+    }
+}
+
+bool RmcastSubscriber::read_datagram(int fd) {
+    char buffer[rmcast::MAX_DATAGRAM];
+    sockaddr_in from{};
+    socklen_t length = sizeof(from);
+    ssize_t received = ::recvfrom(fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                  reinterpret_cast<sockaddr*>(&from), &length);
+    if (received < 0) return false;
+
+    rmcast::PacketHeader header;
+    if (static_cast<size_t>(received) < sizeof(header)) return true;
+    std::memcpy(&header, buffer, sizeof(header));
+    if (header.magic != rmcast::MAGIC) return true;
+    const char* payload = buffer + sizeof(header);
+
+    switch (header.type) {
+        case rmcast::PacketType::DATA:
+            if (header.count != static_cast<size_t>(received) - sizeof(header) || header.sequence == 0) break;
+            if (header.session != session_) {
+                // Joined mid-stream, or the publisher restarted
+                follow(header.session, header.sequence, from);
+            }
+            on_data(header, payload);
+            break;
+        case rmcast::PacketType::RETRANSMIT:
+            if (header.count != static_cast<size_t>(received) - sizeof(header) || header.session != session_) break;
+            on_data(header, payload);
+            break;
+        case rmcast::PacketType::HEARTBEAT:
+            if (header.session != session_) {
+                follow(header.session, header.sequence + 1, from);
+            } else if (header.sequence > highest_) {
+                highest_ = header.sequence;
+            }
+            break;
+        case rmcast::PacketType::UNAVAILABLE:
+            if (header.session == session_) {
+                on_unavailable(header.sequence, header.count);
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void RmcastSubscriber::follow(uint64_t session, uint64_t next_sequence, const sockaddr_in& from) {
+    session_ = session;
+    next_ = next_sequence;
+    highest_ = next_sequence - 1;
+    publisher_ = from;
+    gap_start_ = 0;
+    for (Slot& slot : window_) {
+        slot.sequence = 0;
+    }
+    stats_.sessions++;
+}
+
+void RmcastSubscriber::on_data(const rmcast::PacketHeader& header, const char* payload) {
+    uint64_t sequence = header.sequence;
+    Slot& slot = window_[sequence & (ring_size_ - 1)];
+    if (sequence < next_ || slot.sequence == sequence) {
+        stats_.duplicates++;
+        return;
+    }
+    if (sequence >= next_ + ring_size_) {
+        // Further ahead than the window holds: what is missing before it
+        // would never fit, so it is lost. Held messages are still delivered;
+        // while one occupies the slot this datagram is dropped and NAKed
+        // again once the application has caught up.
+        highest_ = std::max(highest_, sequence);
+        skip_missing(sequence - ring_size_ + 1);
+        if (sequence >= next_ + ring_size_) {
+            stats_.deferred++;
+            return;
+        }
+    }
+    std::memcpy(slot.payload, payload, header.count);
+    slot.size = header.count;
+    slot.sequence = sequence;
+    if (header.type == rmcast::PacketType::RETRANSMIT) {
+        stats_.recovered++;
+    }
+    highest_ = std::max(highest_, sequence);
+}
+
+void RmcastSubscriber::on_unavailable(uint64_t first, uint32_t count) {
+    if (next_ < first) return;
+    skip_missing(first + count);
+}
+
+void RmcastSubscriber::check_gap(int64_t now_ns) {
+    if (session_ == 0 || next_ > highest_ || ready()) {
+        gap_start_ = 0;
+        arm_retry(0);
+        return;
+    }
+    if (gap_start_ != next_) {
+        gap_start_ = next_;
+        nak_attempts_ = 0;
+        stats_.gaps++;
+    } else if (now_ns - last_nak_ns_ < rmcast::NAK_RETRY_NS) {
+        if (retry_armed_) arm_retry(rmcast::NAK_RETRY_NS - (now_ns - last_nak_ns_));     // Woken early
+        return;
+    } else if (nak_attempts_ >= rmcast::MAX_NAK_ATTEMPTS) {
+        // The publisher isn't answering: move on to what we have
+        skip_missing(highest_ + 1);
+        gap_start_ = 0;
+        arm_retry(0);
+        return;
+    }
+
+    // The missing run at next_, as one NAK
+    uint32_t count = 0;
+    while (count < rmcast::MAX_NAK_RANGE && next_ + count <= highest_ &&
+           window_[(next_ + count) & (ring_size_ - 1)].sequence != next_ + count) {
+        ++count;
+    }
+    rmcast::PacketHeader nak{rmcast::MAGIC, rmcast::PacketType::NAK, 0, session_, next_, count, 0};
+    ::sendto(nak_fd_, &nak, sizeof(nak), MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&publisher_), sizeof(publisher_));
+    nak_attempts_++;
+    last_nak_ns_ = now_ns;
+    stats_.naks_sent++;
+    arm_retry(rmcast::NAK_RETRY_NS);
+}
+
+void RmcastSubscriber::arm_retry(int64_t delay_ns) {
+    if (delay_ns == 0 && !retry_armed_) return;
+    // Setting the timer also clears an expiry nobody has read
+    itimerspec spec{};
+    spec.it_value.tv_sec = delay_ns / 1000000000;
+    spec.it_value.tv_nsec = delay_ns % 1000000000;
+    ::timerfd_settime(retry_fd_, 0, &spec, nullptr);
+    retry_armed_ = delay_ns != 0;
+}
+
+void RmcastSubscriber::skip_missing(uint64_t limit) {
+    while (next_ < limit && next_ <= highest_ && !ready()) {
+        ++next_;
+        stats_.lost++;
+    }
+    gap_start_ = 0;
+}
+
+bool RmcastSubscriber::ready() const {
+    return session_ != 0 && window_[next_ & (ring_size_ - 1)].sequence == next_;
+}
+
+void RmcastSubscriber::update_ready() {
+    bool now_ready = ready();
+    if (now_ready == ready_signaled_) return;
+    uint64_t value = 1;
+    if (now_ready) {
+        ssize_t written = ::write(ready_fd_, &value, sizeof(value));
+        (void)written;
+    } else {
+        ssize_t read_bytes = ::read(ready_fd_, &value, sizeof(value));
+        (void)read_bytes;
+    }
+    ready_signaled_ = now_ready;
+}
+
+TransportConfig multicast_config(const std::string& endpoint) {
+    TransportConfig config(TransportType::RELIABLE_MULTICAST, TransportPattern::PUBLISH_SUBSCRIBE, endpoint);
+    config.multicast_interface = StaticConfig::get_multicast_interface();
+    config.multicast_ttl = StaticConfig::get_multicast_ttl();
+    config.retransmit_ring = static_cast<size_t>(std::max(16, StaticConfig::get_multicast_retransmit_ring()));
+    config.heartbeat_interval_ms = StaticConfig::get_multicast_heartbeat_ms();
+    return config;
+}
+
+} // namespace hft
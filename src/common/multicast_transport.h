@@ -0,0 +1,265 @@
+#pragma once
+
+#include "transport_interface.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+
+namespace hft {
+
+// Reliable UDP multicast for fanning one publisher out to many hosts. The
+// publisher sends each message once to the group, whatever the number of
+// receivers; a ZMQ TCP subscriber costs the publisher a copy and a socket
+// write apiece.
+//
+// Endpoint: "rmcast://<group>:<port>", e.g. rmcast://239.192.0.1:31001.
+//
+// Every message is one datagram with a sequence number, and stays in a
+// ring on the publisher until it is overwritten. A receiver that sees a
+// gap NAKs the missing range to the publisher's unicast address and gets
+// the messages back (RETRANSMIT) to itself alone; messages already gone
+// from the ring come back as UNAVAILABLE and are counted lost, as is a
+// range still missing after a few NAKs. Receivers deliver in sequence
+// order. An idle publisher heartbeats its last sequence number so a lost
+// tail is noticed too. A restarted publisher is a new session: receivers
+// start over at its first message.
+namespace rmcast {
+
+constexpr uint32_t MAGIC = 0x314D5248;      // "HRM1"
+constexpr size_t MAX_DATAGRAM = 1472;       // Ethernet MTU less IPv4/UDP headers: never fragmented
+constexpr uint32_t MAX_NAK_RANGE = 256;     // Messages one NAK asks for
+constexpr int64_t NAK_RETRY_NS = 20000000;  // Re-NAK a gap this long unanswered
+constexpr uint32_t MAX_NAK_ATTEMPTS = 5;    // Then count it lost and move on
+
+enum class PacketType : uint16_t {
+    DATA = 1,
+    RETRANSMIT = 2,
+    HEARTBEAT = 3,
+    NAK = 4,
+    UNAVAILABLE = 5
+};
+
+struct PacketHeader {
+    uint32_t magic;
+    PacketType type;
+    uint16_t reserved;
+    uint64_t session;       // Publisher instance
+    uint64_t sequence;      // DATA/RETRANSMIT: the message; HEARTBEAT: the last sent;
+                            // NAK/UNAVAILABLE: the first of the range
+    uint32_t count;         // DATA/RETRANSMIT: payload bytes; NAK/UNAVAILABLE: messages in the range
+    uint32_t reserved2;
+};
+static_assert(sizeof(PacketHeader) == 32, "PacketHeader is a fixed wire layout");
+
+constexpr size_t MAX_PAYLOAD = MAX_DATAGRAM - sizeof(PacketHeader);
+
+// "rmcast://239.192.0.1:31001" to a group address; false if malformed or
+// not a multicast address
+bool parse_endpoint(const std::string& endpoint, sockaddr_in& group);
+
+struct PublisherStats {
+    uint64_t naks_received = 0;
+    uint64_t retransmitted = 0;
+    uint64_t unavailable = 0;       // Asked for after they left the ring
+    uint64_t send_errors = 0;       // Left to the receivers' NAKs
+};
+
+struct SubscriberStats {
+    uint64_t gaps = 0;              // Times a missing message was noticed
+    uint64_t naks_sent = 0;
+    uint64_t recovered = 0;         // Missing messages a retransmit filled in
+    uint64_t lost = 0;              // Skipped: unavailable, out of NAKs or past the window
+    uint64_t duplicates = 0;
+    uint64_t deferred = 0;          // Past a window of held messages; left to a later NAK
+    uint64_t sessions = 0;          // Publisher instances followed
+};
+
+} // namespace rmcast
+
+// Shared socket plumbing and statistics
+class MulticastTransport : public virtual IMessageTransport {
+public:
+    MulticastTransport();
+    virtual ~MulticastTransport();
+
+    bool initialize(const TransportConfig& config) override;
+    void close() override;
+
+    void set_receive_callback(MessageCallback callback) override { receive_callback_ = std::move(callback); }
+    void start_async_receive() override;
+    void stop_async_receive() override;
+
+    bool is_connected() const override { return connected_.load(); }
+    TransportType get_type() const override { return TransportType::RELIABLE_MULTICAST; }
+    std::string get_endpoint() const override { return endpoint_; }
+
+    uint64_t get_messages_sent() const override { return messages_sent_.load(); }
+    uint64_t get_messages_received() const override { return messages_received_.load(); }
+    uint64_t get_bytes_sent() const override { return bytes_sent_.load(); }
+    uint64_t get_bytes_received() const override { return bytes_received_.load(); }
+
+    void* get_native_handle() override { return nullptr; }
+
+protected:
+    // Opens fd_ (non-blocking) and resolves config_.multicast_interface
+    bool open_socket();
+    virtual void on_close() {}
+
+    TransportConfig config_;
+    std::string endpoint_;
+    sockaddr_in group_{};
+    in_addr interface_{};
+    int fd_ = -1;
+    size_t ring_size_ = 0;          // Power of 2
+    std::atomic<bool> connected_{false};
+
+    std::atomic<uint64_t> messages_sent_{0};
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+
+    MessageCallback receive_callback_;
+    std::unique_ptr<std::thread> receive_thread_;
+    std::atomic<bool> async_active_{false};
+};
+
+// Sender side: bind() joins nothing, it opens the socket that sends to the
+// group and takes NAKs, and starts the repair thread that answers them and
+// sends heartbeats. publish() is single-producer.
+class RmcastPublisher : public MulticastTransport, public virtual IMessagePublisher {
+public:
+    ~RmcastPublisher() override;
+
+    bool bind(const std::string& endpoint) override;
+    bool connect(const std::string& endpoint) override { (void)endpoint; return false; }
+
+    // False only if size is over rmcast::MAX_PAYLOAD. A message the kernel
+    // would not take is still in the ring, for the receivers' NAKs.
+    bool send(const void* data, size_t size, bool non_blocking = false) override;
+    bool receive(void* data, size_t& size, bool non_blocking = false) override {
+        (void)data; (void)size; (void)non_blocking;
+        return false;
+    }
+
+    bool publish(const void* data, size_t size) override { return send(data, size, true); }
+    bool publish(const std::string& topic, const void* data, size_t size) override;
+    void set_filter(const std::string& filter) override { (void)filter; }
+
+    uint64_t session() const { return session_; }
+    uint64_t last_sequence() const { return last_sequence_.load(std::memory_order_acquire); }
+    rmcast::PublisherStats stats() const;
+
+protected:
+    void on_close() override;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};   // 0 while being written
+        uint32_t size = 0;
+        char payload[rmcast::MAX_PAYLOAD];
+    };
+
+    void run_repair();
+    void answer_nak(const rmcast::PacketHeader& nak, const sockaddr_in& from);
+    // Header and payload gathered into one datagram; false if the kernel refused it
+    bool send_packet(rmcast::PacketType type, uint64_t sequence, uint32_t count,
+                     const void* payload, size_t size, const sockaddr_in& to);
+    // Copies the slot out if it still holds sequence; false if overwritten
+    bool read_slot(uint64_t sequence, char* payload, uint32_t& size) const;
+
+    uint64_t session_ = 0;
+    std::unique_ptr<Slot[]> ring_;
+    std::atomic<uint64_t> last_sequence_{0};
+    std::atomic<int64_t> last_send_ns_{0};
+
+    std::thread repair_thread_;
+    std::atomic<bool> repairing_{false};
+
+    std::atomic<uint64_t> naks_received_{0};
+    std::atomic<uint64_t> retransmitted_{0};
+    std::atomic<uint64_t> unavailable_{0};
+    std::atomic<uint64_t> send_errors_{0};
+};
+
+// Receiver side: connect() joins the group. Messages come out of receive()
+// in sequence order; get_poll_fd() is readable whenever receive() has one
+// to give, a datagram to process or a gap to NAK again, so it goes into
+// poll()/zmq::poll().
+class RmcastSubscriber : public MulticastTransport, public virtual IMessageSubscriber {
+public:
+    ~RmcastSubscriber() override;
+
+    bool bind(const std::string& endpoint) override { (void)endpoint; return false; }
+    bool connect(const std::string& endpoint) override;
+
+    bool send(const void* data, size_t size, bool non_blocking = false) override {
+        (void)data; (void)size; (void)non_blocking;
+        return false;
+    }
+    bool receive(void* data, size_t& size, bool non_blocking = false) override;
+
+    // Every message goes to every receiver; the group is the filter
+    bool subscribe(const std::string& topic = "") override { (void)topic; return true; }
+    bool unsubscribe(const std::string& topic = "") override { (void)topic; return true; }
+
+    int get_poll_fd() override { return epoll_fd_; }
+
+    // Receiving thread only
+    rmcast::SubscriberStats stats() const { return stats_; }
+
+protected:
+    void on_close() override;
+
+private:
+    struct Slot {
+        uint64_t sequence = 0;      // 0 = empty
+        uint32_t size = 0;
+        char payload[rmcast::MAX_PAYLOAD];
+    };
+
+    // Handles one datagram from fd; false if none was waiting
+    bool read_datagram(int fd);
+    void on_data(const rmcast::PacketHeader& header, const char* payload);
+    void on_unavailable(uint64_t first, uint32_t count);
+    // New session: forget the old one's sequence numbers
+    void follow(uint64_t session, uint64_t next_sequence, const sockaddr_in& from);
+    // NAKs the gap at next_ if there is one and it is due; gives up on it
+    // after MAX_NAK_ATTEMPTS
+    void check_gap(int64_t now_ns);
+    // Makes the poll fd readable delay_ns from now, so a caller driven by
+    // poll() comes back to re-NAK an unanswered gap; 0 disarms
+    void arm_retry(int64_t delay_ns);
+    // Drops the missing run at next_, up to the next held message
+    void skip_missing(uint64_t limit);
+    // Keeps the poll fd readable exactly while a message is ready
+    void update_ready();
+    bool ready() const;
+
+    int nak_fd_ = -1;               // Unicast: NAKs out, retransmits back to this receiver alone
+    int epoll_fd_ = -1;             // fd_, nak_fd_, ready_fd_ and retry_fd_
+    int ready_fd_ = -1;             // eventfd, set while ready()
+    int retry_fd_ = -1;             // timerfd, fires when a NAK is due again
+    bool ready_signaled_ = false;
+    bool retry_armed_ = false;
+
+    std::vector<Slot> window_;      // Reorder window, indexed by sequence
+    uint64_t session_ = 0;          // 0 = not following a publisher yet
+    uint64_t next_ = 0;             // Next sequence to deliver
+    uint64_t highest_ = 0;          // Highest sequence known to exist
+    sockaddr_in publisher_{};       // Where NAKs go
+
+    uint64_t gap_start_ = 0;        // Gap being NAKed, 0 = none
+    uint32_t nak_attempts_ = 0;
+    int64_t last_nak_ns_ = 0;
+
+    rmcast::SubscriberStats stats_;
+};
+
+// TransportConfig for the rmcast endpoint, with the multicast.* keys from
+// StaticConfig
+TransportConfig multicast_config(const std::string& endpoint);
+
+} // namespace hft
@@ -1,28 +1,222 @@
 #include "order_book.h"
+#include "alloc_tracker.h"
+#include "book_features.h"
 #include "logging.h"
+#include "pmu_counters.h"
+#include "static_config.h"
 #include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <cmath>
 
 namespace hft {
 
-// OrderBook Implementation
-OrderBook::OrderBook(const std::string& symbol)
-    : symbol_(symbol)
-    , last_update_time_(0)
-    , last_sequence_number_(0) {
+namespace {
+
+uint64_t steady_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
 }
 
-void OrderBook::apply_update(const OrderBookUpdate& update) {
-    // Validate sequence number (basic gap detection)
-    if (last_sequence_number_ != 0 && update.sequence_number <= last_sequence_number_) {
-        // Log warning about out-of-order update
+} // namespace
+
+// IOrderBook shared logic
+IOrderBook::IOrderBook(const std::string& symbol)
+    : symbol_(symbol), last_update_time_(0), last_sequence_number_(0) {
+}
+
+IOrderBook::~IOrderBook() = default;
+
+void IOrderBook::apply_update(const OrderBookUpdate& update) {
+    HFT_PMU_SCOPE("order_book_apply_update");
+    HFT_NO_ALLOC_SCOPE("OrderBook::apply_update");
+    uint64_t sequence = update.sequence_number;
+    
+    if (status_ == BookStatus::LIVE) {
+        if (sequence == last_sequence_number_ + 1 || last_sequence_number_ == 0) {
+            apply_sequenced(update);
+            return;
+        }
+        if (sequence <= last_sequence_number_) {
+            duplicate_updates_++;
+            return;
+        }
+        
+        // Forward gap: the levels no longer match the exchange
+        gaps_++;
+        missed_updates_ += sequence - last_sequence_number_ - 1;
+        status_ = BookStatus::STALE;
+        stale_since_ns_ = steady_now_ns();
+        buffer_update(update);
         return;
     }
     
+    if (sequence <= last_sequence_number_) {
+        duplicate_updates_++;
+        return;
+    }
+    buffer_update(update);
+    if (sequence == last_sequence_number_ + 1) {
+        // The missing update arrived late
+        replay_buffered();
+    }
+}
+
+bool IOrderBook::apply_snapshot(const std::vector<OrderBookLevel>& bids,
+                                const std::vector<OrderBookLevel>& asks,
+                                uint64_t snapshot_sequence) {
+    if (status_ == BookStatus::LIVE && snapshot_sequence != 0 && snapshot_sequence < last_sequence_number_) {
+        return false;
+    }
+    
+    load_snapshot(bids, asks);
+    version_++;
+    
+    if (snapshot_sequence == 0) {
+        // Unknown position in the stream: everything buffered is assumed included
+        for (const auto& update : buffered_) {
+            last_sequence_number_ = std::max<uint64_t>(last_sequence_number_, update.sequence_number);
+        }
+        buffered_.clear();
+        if (status_ == BookStatus::STALE) {
+            mark_recovered();
+        }
+        return true;
+    }
+    
+    last_sequence_number_ = snapshot_sequence;
+    if (status_ == BookStatus::STALE) {
+        replay_buffered();
+    }
+    return true;
+}
+
+void IOrderBook::apply_sequenced(const OrderBookUpdate& update) {
+    apply_level(update);
+    version_++;
     last_sequence_number_ = update.sequence_number;
     last_update_time_ = update.exchange_timestamp;
+}
+
+void IOrderBook::buffer_update(const OrderBookUpdate& update) {
+    if (buffered_.size() >= recovery_buffer_limit_) {
+        // Too far behind to replay; only a snapshot newer than the dropped
+        // updates can bring the book back
+        buffer_overflows_++;
+        buffered_.clear();
+    }
+    buffered_.push_back(update);
+}
+
+void IOrderBook::replay_buffered() {
+    std::stable_sort(buffered_.begin(), buffered_.end(),
+                     [](const OrderBookUpdate& a, const OrderBookUpdate& b) {
+                         return a.sequence_number < b.sequence_number;
+                     });
     
+    size_t consumed = 0;
+    for (; consumed < buffered_.size(); ++consumed) {
+        const OrderBookUpdate& update = buffered_[consumed];
+        if (update.sequence_number <= last_sequence_number_) {
+            continue;   // Covered by the snapshot, or a duplicate
+        }
+        if (update.sequence_number != last_sequence_number_ + 1) {
+            break;      // Still a hole
+        }
+        apply_sequenced(update);
+    }
+    buffered_.erase(buffered_.begin(), buffered_.begin() + static_cast<std::ptrdiff_t>(consumed));
+    
+    if (buffered_.empty()) {
+        mark_recovered();
+    }
+}
+
+void IOrderBook::mark_recovered() {
+    uint64_t elapsed = steady_now_ns() - stale_since_ns_;
+    status_ = BookStatus::LIVE;
+    recoveries_++;
+    last_recovery_ns_ = elapsed;
+    max_recovery_ns_ = std::max(max_recovery_ns_, elapsed);
+    total_recovery_ns_ += elapsed;
+}
+
+double IOrderBook::get_mid_price() const {
+    price_t best_bid = get_best_bid_fixed();
+    price_t best_ask = get_best_ask_fixed();
+    
+    if (best_bid > 0 && best_ask > 0) {
+        return to_double_price(best_bid + best_ask) / 2.0;
+    }
+    return 0.0;
+}
+
+double IOrderBook::get_spread() const {
+    price_t best_bid = get_best_bid_fixed();
+    price_t best_ask = get_best_ask_fixed();
+    
+    if (best_bid > 0 && best_ask > 0) {
+        return to_double_price(best_ask - best_bid);
+    }
+    return 0.0;
+}
+
+double IOrderBook::get_market_impact(BookSide side, uint32_t shares) const {
+    if (shares == 0) return 0.0;
+    
+    const BookFeatures& cached = features();
+    if (cached.covers(side, shares)) {
+        return cached.market_impact(side, shares);
+    }
+    
+    // Deeper than the cached levels: walk the book
+    double current_price = (side == BookSide::BID) ? get_best_bid() : get_best_ask();
+    double vwap = get_volume_weighted_price(side, shares);
+    
+    if (current_price > 0.0 && vwap > 0.0) {
+        return std::abs(vwap - current_price) / current_price;
+    }
+    
+    return 0.0;
+}
+
+double IOrderBook::get_bid_ask_imbalance() const {
+    return features().depth_imbalance(1);  // Best level of each side
+}
+
+const BookFeatures& IOrderBook::features() const {
+    if (!features_) {
+        features_ = std::make_unique<BookFeatures>();
+        features_->compute(*this);
+    } else if (features_->version != version_) {
+        features_->compute(*this);
+    }
+    return *features_;
+}
+
+bool IOrderBook::is_valid() const {
+    if (status_ == BookStatus::STALE) {
+        return false;
+    }
+    
+    // Basic validation: best bid < best ask
+    price_t best_bid = get_best_bid_fixed();
+    price_t best_ask = get_best_ask_fixed();
+    
+    if (best_bid > 0 && best_ask > 0) {
+        return best_bid < best_ask;
+    }
+    
+    // Valid if we have at least one side
+    return get_book_depth(BookSide::BID) > 0 || get_book_depth(BookSide::ASK) > 0;
+}
+
+// OrderBook Implementation
+OrderBook::OrderBook(const std::string& symbol)
+    : IOrderBook(symbol) {
+}
+
+void OrderBook::apply_level(const OrderBookUpdate& update) {
     if (update.side == BookSide::BID) {
         update_level(bids_, update.level, update.update_type);
     } else {
@@ -30,7 +224,7 @@ void OrderBook::apply_update(const OrderBookUpdate& update) {
     }
 }
 
-void OrderBook::apply_snapshot(const std::vector<OrderBookLevel>& bids,
+void OrderBook::load_snapshot(const std::vector<OrderBookLevel>& bids,
                               const std::vector<OrderBookLevel>& asks) {
     // Clear existing book
     bids_.clear();
@@ -51,32 +245,12 @@ void OrderBook::apply_snapshot(const std::vector<OrderBookLevel>& bids,
     }
 }
 
-double OrderBook::get_best_bid() const {
-    return bids_.empty() ? 0.0 : bids_.begin()->first;
-}
-
-double OrderBook::get_best_ask() const {
-    return asks_.empty() ? 0.0 : asks_.begin()->first;
-}
-
-double OrderBook::get_mid_price() const {
-    double best_bid = get_best_bid();
-    double best_ask = get_best_ask();
-    
-    if (best_bid > 0.0 && best_ask > 0.0) {
-        return (best_bid + best_ask) / 2.0;
-    }
-    return 0.0;
+price_t OrderBook::get_best_bid_fixed() const {
+    return bids_.empty() ? 0 : bids_.begin()->first;
 }
 
-double OrderBook::get_spread() const {
-    double best_bid = get_best_bid();
-    double best_ask = get_best_ask();
-    
-    if (best_bid > 0.0 && best_ask > 0.0) {
-        return best_ask - best_bid;
-    }
-    return 0.0;
+price_t OrderBook::get_best_ask_fixed() const {
+    return asks_.empty() ? 0 : asks_.begin()->first;
 }
 
 uint32_t OrderBook::get_bid_size_at_level(size_t level) const {
@@ -97,7 +271,7 @@ uint32_t OrderBook::get_ask_size_at_level(size_t level) const {
 
 double OrderBook::get_volume_weighted_price(BookSide side, uint32_t shares) const {
     const auto& book = (side == BookSide::BID) ? 
-        reinterpret_cast<const std::map<double, OrderBookLevel>&>(bids_) : asks_;
+        reinterpret_cast<const std::map<price_t, OrderBookLevel>&>(bids_) : asks_;
     
     if (book.empty() || shares == 0) return 0.0;
     
@@ -107,7 +281,7 @@ double OrderBook::get_volume_weighted_price(BookSide side, uint32_t shares) cons
     
     for (const auto& [price, level] : book) {
         uint32_t take_size = std::min(remaining_shares, level.size);
-        total_cost += price * take_size;
+        total_cost += to_double_price(price) * take_size;
         total_shares += take_size;
         remaining_shares -= take_size;
         
@@ -117,22 +291,9 @@ double OrderBook::get_volume_weighted_price(BookSide side, uint32_t shares) cons
     return total_shares > 0 ? total_cost / total_shares : 0.0;
 }
 
-double OrderBook::get_market_impact(BookSide side, uint32_t shares) const {
-    if (shares == 0) return 0.0;
-    
-    double current_price = (side == BookSide::BID) ? get_best_bid() : get_best_ask();
-    double vwap = get_volume_weighted_price(side, shares);
-    
-    if (current_price > 0.0 && vwap > 0.0) {
-        return std::abs(vwap - current_price) / current_price;
-    }
-    
-    return 0.0;
-}
-
 uint32_t OrderBook::get_total_size(BookSide side, size_t levels) const {
     const auto& book = (side == BookSide::BID) ? 
-        reinterpret_cast<const std::map<double, OrderBookLevel>&>(bids_) : asks_;
+        reinterpret_cast<const std::map<price_t, OrderBookLevel>&>(bids_) : asks_;
     
     uint32_t total = 0;
     size_t count = 0;
@@ -146,35 +307,25 @@ uint32_t OrderBook::get_total_size(BookSide side, size_t levels) const {
     return total;
 }
 
-double OrderBook::get_bid_ask_imbalance() const {
-    uint32_t bid_size = get_bid_size_at_level(0);  // Best bid size
-    uint32_t ask_size = get_ask_size_at_level(0);  // Best ask size
-    
-    if (bid_size + ask_size == 0) return 0.0;
-    
-    return static_cast<double>(bid_size - ask_size) / (bid_size + ask_size);
-}
-
 size_t OrderBook::get_book_depth(BookSide side) const {
     return (side == BookSide::BID) ? bids_.size() : asks_.size();
 }
 
-bool OrderBook::is_valid() const {
-    // Basic validation: best bid < best ask
-    double best_bid = get_best_bid();
-    double best_ask = get_best_ask();
+size_t OrderBook::copy_levels(BookSide side, double* prices, double* sizes, size_t max_levels) const {
+    const auto& book = (side == BookSide::BID) ? 
+        reinterpret_cast<const std::map<price_t, OrderBookLevel>&>(bids_) : asks_;
     
-    if (best_bid > 0.0 && best_ask > 0.0) {
-        return best_bid < best_ask;
+    size_t count = 0;
+    for (auto it = book.begin(); it != book.end() && count < max_levels; ++it, ++count) {
+        prices[count] = to_double_price(it->first);
+        sizes[count] = it->second.size;
     }
-    
-    // Valid if we have at least one side
-    return !bids_.empty() || !asks_.empty();
+    return count;
 }
 
 // Helper methods
-void OrderBook::update_level(std::map<double, OrderBookLevel, std::greater<double>>& book, 
-                            const OrderBookLevel& level, BookUpdateType type) {
+template<typename Book>
+void OrderBook::update_level(Book& book, const OrderBookLevel& level, BookUpdateType type) {
     switch (type) {
         case BookUpdateType::ADD:
         case BookUpdateType::UPDATE:
@@ -195,59 +346,332 @@ void OrderBook::update_level(std::map<double, OrderBookLevel, std::greater<doubl
     }
 }
 
-void OrderBook::update_level(std::map<double, OrderBookLevel>& book, 
-                            const OrderBookLevel& level, BookUpdateType type) {
-    switch (type) {
-        case BookUpdateType::ADD:
-        case BookUpdateType::UPDATE:
-            if (level.size > 0) {
-                book[level.price] = level;
-            } else {
-                book.erase(level.price);  // Zero size = delete
-            }
-            break;
-            
-        case BookUpdateType::DELETE:
-            book.erase(level.price);
-            break;
-            
-        case BookUpdateType::SNAPSHOT:
-            // Snapshot should use apply_snapshot method
-            break;
+// LadderOrderBook Implementation
+LadderOrderBook::LadderOrderBook(const std::string& symbol, price_t tick_size, size_t num_levels,
+                                 std::pmr::memory_resource* memory)
+    : IOrderBook(symbol)
+    , tick_size_(tick_size > 0 ? tick_size : DEFAULT_TICK)
+    , base_tick_(0)
+    , anchored_(false)
+    , bid_sizes_(num_levels > 0 ? num_levels : DEFAULT_LADDER_LEVELS, 0, memory)
+    , bid_counts_(bid_sizes_.size(), 0, memory)
+    , ask_sizes_(bid_sizes_.size(), 0, memory)
+    , ask_counts_(bid_sizes_.size(), 0, memory)
+    , best_bid_idx_(NO_LEVEL)
+    , best_ask_idx_(NO_LEVEL)
+    , bid_depth_(0)
+    , ask_depth_(0)
+    , out_of_range_count_(0) {
+}
+
+void LadderOrderBook::apply_level(const OrderBookUpdate& update) {
+    if (update.update_type == BookUpdateType::SNAPSHOT) {
+        // Snapshot should use apply_snapshot method
+        return;
+    }
+    
+    int64_t idx = slot_for_price(update.level.price);
+    if (idx == NO_LEVEL) {
+        ++out_of_range_count_;
+        return;
+    }
+    
+    // DELETE and zero-size ADD/UPDATE both clear the level
+    uint32_t size = (update.update_type == BookUpdateType::DELETE) ? 0 : update.level.size;
+    uint32_t count = size > 0 ? update.level.order_count : 0;
+    
+    if (update.side == BookSide::BID) {
+        set_bid(idx, size, count);
+    } else {
+        set_ask(idx, size, count);
+    }
+}
+
+void LadderOrderBook::load_snapshot(const std::vector<OrderBookLevel>& bids,
+                                    const std::vector<OrderBookLevel>& asks) {
+    clear_levels();
+    
+    // Re-anchor the window around the new top of book
+    anchored_ = false;
+    
+    for (const auto& level : bids) {
+        if (level.size == 0) continue;
+        int64_t idx = slot_for_price(level.price);
+        if (idx == NO_LEVEL) {
+            ++out_of_range_count_;
+            continue;
+        }
+        set_bid(idx, level.size, level.order_count);
+    }
+    
+    for (const auto& level : asks) {
+        if (level.size == 0) continue;
+        int64_t idx = slot_for_price(level.price);
+        if (idx == NO_LEVEL) {
+            ++out_of_range_count_;
+            continue;
+        }
+        set_ask(idx, level.size, level.order_count);
+    }
+}
+
+price_t LadderOrderBook::get_best_bid_fixed() const {
+    return best_bid_idx_ == NO_LEVEL ? 0 : slot_to_price(best_bid_idx_);
+}
+
+price_t LadderOrderBook::get_best_ask_fixed() const {
+    return best_ask_idx_ == NO_LEVEL ? 0 : slot_to_price(best_ask_idx_);
+}
+
+uint32_t LadderOrderBook::get_bid_size_at_level(size_t level) const {
+    int64_t idx = nth_bid_slot(level);
+    return idx == NO_LEVEL ? 0 : bid_sizes_[idx];
+}
+
+uint32_t LadderOrderBook::get_ask_size_at_level(size_t level) const {
+    int64_t idx = nth_ask_slot(level);
+    return idx == NO_LEVEL ? 0 : ask_sizes_[idx];
+}
+
+double LadderOrderBook::get_volume_weighted_price(BookSide side, uint32_t shares) const {
+    if (shares == 0) return 0.0;
+    
+    const bool is_bid = (side == BookSide::BID);
+    int64_t idx = is_bid ? best_bid_idx_ : best_ask_idx_;
+    if (idx == NO_LEVEL) return 0.0;
+    
+    const auto& sizes = is_bid ? bid_sizes_ : ask_sizes_;
+    const int64_t end = is_bid ? -1 : static_cast<int64_t>(sizes.size());
+    const int64_t step = is_bid ? -1 : 1;
+    
+    uint32_t remaining_shares = shares;
+    double total_cost = 0.0;
+    uint32_t total_shares = 0;
+    
+    for (; idx != end && remaining_shares > 0; idx += step) {
+        uint32_t level_size = sizes[idx];
+        if (level_size == 0) continue;
+        
+        uint32_t take_size = std::min(remaining_shares, level_size);
+        total_cost += to_double_price(slot_to_price(idx)) * take_size;
+        total_shares += take_size;
+        remaining_shares -= take_size;
+    }
+    
+    return total_shares > 0 ? total_cost / total_shares : 0.0;
+}
+
+uint32_t LadderOrderBook::get_total_size(BookSide side, size_t levels) const {
+    const bool is_bid = (side == BookSide::BID);
+    int64_t idx = is_bid ? best_bid_idx_ : best_ask_idx_;
+    if (idx == NO_LEVEL) return 0;
+    
+    const auto& sizes = is_bid ? bid_sizes_ : ask_sizes_;
+    const int64_t end = is_bid ? -1 : static_cast<int64_t>(sizes.size());
+    const int64_t step = is_bid ? -1 : 1;
+    
+    uint32_t total = 0;
+    size_t count = 0;
+    levels = std::min(levels, is_bid ? bid_depth_ : ask_depth_);  // Stop at the last level, not the window edge
+    
+    for (; idx != end && count < levels; idx += step) {
+        if (sizes[idx] == 0) continue;
+        total += sizes[idx];
+        ++count;
+    }
+    
+    return total;
+}
+
+size_t LadderOrderBook::get_book_depth(BookSide side) const {
+    return (side == BookSide::BID) ? bid_depth_ : ask_depth_;
+}
+
+size_t LadderOrderBook::copy_levels(BookSide side, double* prices, double* sizes, size_t max_levels) const {
+    const bool is_bid = (side == BookSide::BID);
+    int64_t idx = is_bid ? best_bid_idx_ : best_ask_idx_;
+    if (idx == NO_LEVEL) return 0;
+    
+    const auto& slots = is_bid ? bid_sizes_ : ask_sizes_;
+    const int64_t end = is_bid ? -1 : static_cast<int64_t>(slots.size());
+    const int64_t step = is_bid ? -1 : 1;
+    
+    size_t count = 0;
+    max_levels = std::min(max_levels, is_bid ? bid_depth_ : ask_depth_);
+    for (; idx != end && count < max_levels; idx += step) {
+        if (slots[idx] == 0) continue;
+        prices[count] = to_double_price(slot_to_price(idx));
+        sizes[count] = slots[idx];
+        ++count;
+    }
+    return count;
+}
+
+price_t LadderOrderBook::get_base_price() const {
+    return anchored_ ? base_tick_ * tick_size_ : 0;
+}
+
+// Helper methods
+price_t LadderOrderBook::slot_to_price(int64_t idx) const {
+    return (base_tick_ + idx) * tick_size_;
+}
+
+int64_t LadderOrderBook::slot_for_price(price_t price) {
+    if (price <= 0) return NO_LEVEL;
+    
+    // Off-grid prices snap to the nearest tick
+    int64_t tick = round_to_tick(price, tick_size_) / tick_size_;
+    
+    // Centre the window on the first price seen (or after the book empties)
+    if (!anchored_ || (bid_depth_ == 0 && ask_depth_ == 0)) {
+        base_tick_ = std::max<int64_t>(0, tick - static_cast<int64_t>(num_levels() / 2));
+        anchored_ = true;
+    }
+    
+    int64_t idx = tick - base_tick_;
+    if (idx < 0 || idx >= static_cast<int64_t>(num_levels())) {
+        return NO_LEVEL;
+    }
+    return idx;
+}
+
+void LadderOrderBook::set_bid(int64_t idx, uint32_t size, uint32_t count) {
+    uint32_t old_size = bid_sizes_[idx];
+    bid_sizes_[idx] = size;
+    bid_counts_[idx] = count;
+    
+    if (size > 0) {
+        if (old_size == 0) ++bid_depth_;
+        if (best_bid_idx_ == NO_LEVEL || idx > best_bid_idx_) {
+            best_bid_idx_ = idx;
+        }
+    } else if (old_size > 0) {
+        --bid_depth_;
+        if (idx == best_bid_idx_) {
+            // Walk down to the next populated level
+            int64_t next = idx - 1;
+            while (next >= 0 && bid_sizes_[next] == 0) --next;
+            best_bid_idx_ = (bid_depth_ > 0 && next >= 0) ? next : NO_LEVEL;
+        }
+    }
+}
+
+void LadderOrderBook::set_ask(int64_t idx, uint32_t size, uint32_t count) {
+    uint32_t old_size = ask_sizes_[idx];
+    ask_sizes_[idx] = size;
+    ask_counts_[idx] = count;
+    
+    const int64_t limit = static_cast<int64_t>(ask_sizes_.size());
+    
+    if (size > 0) {
+        if (old_size == 0) ++ask_depth_;
+        if (best_ask_idx_ == NO_LEVEL || idx < best_ask_idx_) {
+            best_ask_idx_ = idx;
+        }
+    } else if (old_size > 0) {
+        --ask_depth_;
+        if (idx == best_ask_idx_) {
+            // Walk up to the next populated level
+            int64_t next = idx + 1;
+            while (next < limit && ask_sizes_[next] == 0) ++next;
+            best_ask_idx_ = (ask_depth_ > 0 && next < limit) ? next : NO_LEVEL;
+        }
+    }
+}
+
+void LadderOrderBook::clear_levels() {
+    std::fill(bid_sizes_.begin(), bid_sizes_.end(), 0);
+    std::fill(bid_counts_.begin(), bid_counts_.end(), 0);
+    std::fill(ask_sizes_.begin(), ask_sizes_.end(), 0);
+    std::fill(ask_counts_.begin(), ask_counts_.end(), 0);
+    best_bid_idx_ = NO_LEVEL;
+    best_ask_idx_ = NO_LEVEL;
+    bid_depth_ = 0;
+    ask_depth_ = 0;
+}
+
+int64_t LadderOrderBook::nth_bid_slot(size_t level) const {
+    if (level >= bid_depth_) return NO_LEVEL;
+    
+    int64_t idx = best_bid_idx_;
+    for (size_t seen = 0; idx >= 0; --idx) {
+        if (bid_sizes_[idx] == 0) continue;
+        if (seen++ == level) return idx;
+    }
+    return NO_LEVEL;
+}
+
+int64_t LadderOrderBook::nth_ask_slot(size_t level) const {
+    if (level >= ask_depth_) return NO_LEVEL;
+    
+    const int64_t limit = static_cast<int64_t>(ask_sizes_.size());
+    int64_t idx = best_ask_idx_;
+    for (size_t seen = 0; idx < limit; ++idx) {
+        if (ask_sizes_[idx] == 0) continue;
+        if (seen++ == level) return idx;
     }
+    return NO_LEVEL;
 }
 
 // OrderBookManager Implementation
 void OrderBookManager::add_symbol(const std::string& symbol) {
+    add_symbol(symbol, default_impl_);
+}
+
+void OrderBookManager::add_symbol(const std::string& symbol, BookImplementation impl,
+                                  price_t tick_size, size_t ladder_levels) {
     if (books_.find(symbol) == books_.end()) {
-        books_[symbol] = std::make_unique<OrderBook>(symbol);
+        if (tick_size <= 0) {
+            tick_size = StaticConfig::get_symbol_tick(symbol);
+        }
+        auto& book = books_[symbol];
+        book = OrderBookFactory::create_book(symbol, impl, tick_size, ladder_levels, memory_);
+        
+        symbol_id_t id = SymbolTable::instance().intern(symbol);
+        if (id != INVALID_SYMBOL_ID) {
+            if (id >= books_by_id_.size()) {
+                books_by_id_.resize(id + 1, nullptr);
+            }
+            books_by_id_[id] = book.get();
+        }
     }
 }
 
-OrderBook* OrderBookManager::get_book(const std::string& symbol) {
+IOrderBook* OrderBookManager::get_book(const std::string& symbol) {
     auto it = books_.find(symbol);
     return (it != books_.end()) ? it->second.get() : nullptr;
 }
 
-const OrderBook* OrderBookManager::get_book(const std::string& symbol) const {
+const IOrderBook* OrderBookManager::get_book(const std::string& symbol) const {
     auto it = books_.find(symbol);
     return (it != books_.end()) ? it->second.get() : nullptr;
 }
 
 void OrderBookManager::process_update(const OrderBookUpdate& update) {
-    std::string symbol(update.symbol);
+    symbol_id_t id = SymbolTable::instance().resolve(update.symbol_id, update.symbol);
     
-    // Auto-create book if it doesn't exist
-    if (books_.find(symbol) == books_.end()) {
-        add_symbol(symbol);
+    auto* book = get_book(id);
+    if (!book) {
+        // Auto-create book if it doesn't exist
+        add_symbol(std::string(update.symbol));
+        book = get_book(id);
     }
     
-    auto* book = get_book(symbol);
     if (book) {
+        bool was_stale = book->is_stale();
+        uint64_t expected = book->get_last_sequence() + 1;
         book->apply_update(update);
+        if (!was_stale && book->is_stale() && gap_callback_) {
+            gap_callback_(*book, expected, update.sequence_number);
+        }
     }
 }
 
+void OrderBookManager::clear() {
+    books_by_id_.clear();
+    books_.clear();
+}
+
 std::vector<std::string> OrderBookManager::get_symbols() const {
     std::vector<std::string> symbols;
     symbols.reserve(books_.size());
@@ -259,11 +683,29 @@ std::vector<std::string> OrderBookManager::get_symbols() const {
     return symbols;
 }
 
+std::vector<std::string> OrderBookManager::get_stale_symbols() const {
+    std::vector<std::string> symbols;
+    for (const auto& [symbol, book] : books_) {
+        if (book->is_stale()) {
+            symbols.push_back(symbol);
+        }
+    }
+    return symbols;
+}
+
+uint64_t OrderBookManager::get_total_gaps() const {
+    uint64_t gaps = 0;
+    for (const auto& [symbol, book] : books_) {
+        gaps += book->get_gap_count();
+    }
+    return gaps;
+}
+
 // OrderBookFactory Implementation
 OrderBookUpdate OrderBookFactory::create_level_update(const std::string& symbol,
                                                       BookSide side,
                                                       BookUpdateType type,
-                                                      double price,
+                                                      price_t price,
                                                       uint32_t size,
                                                       uint64_t seq_num,
                                                       uint32_t order_count) {
@@ -274,6 +716,7 @@ OrderBookUpdate OrderBookFactory::create_level_update(const std::string& symbol,
     // Copy symbol (ensure null termination)
     std::strncpy(update.symbol, symbol.c_str(), sizeof(update.symbol) - 1);
     update.symbol[sizeof(update.symbol) - 1] = '\0';
+    update.symbol_id = SymbolTable::instance().intern(update.symbol);
     
     update.update_type = type;
     update.side = side;
@@ -285,12 +728,23 @@ OrderBookUpdate OrderBookFactory::create_level_update(const std::string& symbol,
     return update;
 }
 
+std::unique_ptr<IOrderBook> OrderBookFactory::create_book(const std::string& symbol,
+                                                          BookImplementation impl,
+                                                          price_t tick_size,
+                                                          size_t ladder_levels,
+                                                          std::pmr::memory_resource* memory) {
+    if (impl == BookImplementation::LADDER) {
+        return std::make_unique<LadderOrderBook>(symbol, tick_size, ladder_levels, memory);
+    }
+    return std::make_unique<OrderBook>(symbol);
+}
+
 std::string OrderBookFactory::update_to_string(const OrderBookUpdate& update) {
     std::string result = "OrderBookUpdate{";
     result += "symbol=" + std::string(update.symbol);
     result += ", side=" + std::string(update.side == BookSide::BID ? "BID" : "ASK");
     result += ", type=" + std::to_string(static_cast<int>(update.update_type));
-    result += ", price=" + std::to_string(update.level.price);
+    result += ", price=" + std::to_string(to_double_price(update.level.price));
     result += ", size=" + std::to_string(update.level.size);
     result += ", seq=" + std::to_string(update.sequence_number);
     result += "}";
@@ -1,20 +1,22 @@
 #pragma once
 
 #include "message_types.h"
+#include <functional>
 #include <map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace hft {
 
 // Level 2 market data - order book depth
 struct OrderBookLevel {
-    double price;
+    price_t price;         // Fixed-point price (see fixed_price.h)
     uint32_t size;
     uint32_t order_count;  // Number of orders at this level
     
-    OrderBookLevel(double p = 0.0, uint32_t s = 0, uint32_t c = 0)
+    OrderBookLevel(price_t p = 0, uint32_t s = 0, uint32_t c = 0)
         : price(p), size(s), order_count(c) {}
 } __attribute__((packed));
 
@@ -34,6 +36,7 @@ enum class BookSide : uint8_t {
 struct OrderBookUpdate {
     MessageHeader header;
     char symbol[16];
+    symbol_id_t symbol_id;       // Dense ID from SymbolTable
     BookUpdateType update_type;
     BookSide side;
     OrderBookLevel level;
@@ -41,77 +44,296 @@ struct OrderBookUpdate {
     uint64_t exchange_timestamp; // Exchange timestamp
 } __attribute__((packed));
 
-// In-memory order book representation
-class OrderBook {
+// Book implementation selectable per symbol in OrderBookManager
+enum class BookImplementation : uint8_t {
+    MAP = 1,        // std::map keyed by price, unbounded price range
+    LADDER = 2      // Contiguous fixed-tick price ladder, allocation-free updates
+};
+
+// Sequencing state of a book
+enum class BookStatus : uint8_t {
+    LIVE = 1,       // Updates contiguous, levels can be trusted
+    STALE = 2       // Gap seen; levels unreliable until the gap is closed
+};
+
+struct BookFeatures;  // book_features.h
+
+// Common query interface shared by all order book implementations
+class IOrderBook {
 public:
-    explicit OrderBook(const std::string& symbol);
-    ~OrderBook() = default;
+    static constexpr size_t DEFAULT_RECOVERY_BUFFER = 65536;
+
+    virtual ~IOrderBook();
 
-    // Process order book updates
+    // Process order book updates. Updates must be numbered contiguously per
+    // book; sequence 0 is unsequenced and only accepted until the first
+    // numbered update. A forward gap marks the book stale: later updates are
+    // buffered until apply_snapshot() or the missing update closes the gap,
+    // then replayed in order.
     void apply_update(const OrderBookUpdate& update);
-    void apply_snapshot(const std::vector<OrderBookLevel>& bids,
-                       const std::vector<OrderBookLevel>& asks);
+
+    // Replace every level. snapshot_sequence is the last update the snapshot
+    // reflects; buffered updates after it are replayed. 0 = unknown, the
+    // snapshot is taken as current and the buffer is dropped. Returns false
+    // (and leaves the book alone) for a snapshot older than a live book.
+    bool apply_snapshot(const std::vector<OrderBookLevel>& bids,
+                        const std::vector<OrderBookLevel>& asks,
+                        uint64_t snapshot_sequence = 0);
+
+    // Top of book in fixed-point units (0 when the side is empty)
+    virtual price_t get_best_bid_fixed() const = 0;
+    virtual price_t get_best_ask_fixed() const = 0;
 
     // Query methods
-    double get_best_bid() const;
-    double get_best_ask() const;
+    double get_best_bid() const { return to_double_price(get_best_bid_fixed()); }
+    double get_best_ask() const { return to_double_price(get_best_ask_fixed()); }
     double get_mid_price() const;
     double get_spread() const;
-    uint32_t get_bid_size_at_level(size_t level) const;  // 0 = best
-    uint32_t get_ask_size_at_level(size_t level) const;
-    
+    virtual uint32_t get_bid_size_at_level(size_t level) const = 0;  // 0 = best
+    virtual uint32_t get_ask_size_at_level(size_t level) const = 0;
+
     // Advanced queries for strategies
-    double get_volume_weighted_price(BookSide side, uint32_t shares) const;
+    virtual double get_volume_weighted_price(BookSide side, uint32_t shares) const = 0;
     double get_market_impact(BookSide side, uint32_t shares) const;
-    uint32_t get_total_size(BookSide side, size_t levels = 5) const;
-    
+    virtual uint32_t get_total_size(BookSide side, size_t levels = 5) const = 0;
+
     // Book quality metrics
     double get_bid_ask_imbalance() const;  // (bid_size - ask_size) / (bid_size + ask_size)
-    size_t get_book_depth(BookSide side) const;
-    
-    // Validation
+    virtual size_t get_book_depth(BookSide side) const = 0;
+
+    // Copies up to max_levels populated levels of one side, best first, into
+    // dense arrays; returns how many were written
+    virtual size_t copy_levels(BookSide side, double* prices, double* sizes, size_t max_levels) const = 0;
+
+    // Depth signals for the top levels, recomputed on the first call after
+    // each change and cached until the next one. Not thread-safe: the caller
+    // that applies updates is the one that reads them.
+    const BookFeatures& features() const;
+    uint64_t get_version() const { return version_; }   // Bumped by every applied update or snapshot
+
+    // Validation (a stale book is never valid)
     bool is_valid() const;
     uint64_t get_last_update_time() const { return last_update_time_; }
-    
+
+    // Gap state
+    BookStatus get_status() const { return status_; }
+    bool is_stale() const { return status_ == BookStatus::STALE; }
+    uint64_t get_last_sequence() const { return last_sequence_number_; }
+    size_t get_buffered_count() const { return buffered_.size(); }
+    void set_recovery_buffer_limit(size_t updates) { recovery_buffer_limit_ = updates > 0 ? updates : 1; }
+
+    // Gap statistics
+    uint64_t get_gap_count() const { return gaps_; }
+    uint64_t get_missed_updates() const { return missed_updates_; }         // Sequence numbers skipped
+    uint64_t get_duplicate_updates() const { return duplicate_updates_; }   // At or below the last applied
+    uint64_t get_buffer_overflows() const { return buffer_overflows_; }
+    uint64_t get_recovery_count() const { return recoveries_; }
+    uint64_t get_last_recovery_ns() const { return last_recovery_ns_; }     // Stale to live, steady clock
+    uint64_t get_max_recovery_ns() const { return max_recovery_ns_; }
+    uint64_t get_total_recovery_ns() const { return total_recovery_ns_; }
+
     const std::string& symbol() const { return symbol_; }
+    virtual BookImplementation implementation() const = 0;
+
+protected:
+    explicit IOrderBook(const std::string& symbol);
+
+    // Implementation hooks; sequencing is handled here
+    virtual void apply_level(const OrderBookUpdate& update) = 0;
+    virtual void load_snapshot(const std::vector<OrderBookLevel>& bids,
+                               const std::vector<OrderBookLevel>& asks) = 0;
 
-private:
     std::string symbol_;
-    
-    // Ordered maps: price -> level (bids descending, asks ascending)
-    std::map<double, OrderBookLevel, std::greater<double>> bids_;  // Best bid = highest price
-    std::map<double, OrderBookLevel> asks_;                       // Best ask = lowest price
-    
     uint64_t last_update_time_;
     uint64_t last_sequence_number_;
+
+private:
+    BookStatus status_ = BookStatus::LIVE;
+    uint64_t version_ = 0;
+    mutable std::unique_ptr<BookFeatures> features_;  // Allocated on first use
+    std::vector<OrderBookUpdate> buffered_;     // Held while stale, allocated on the first gap
+    size_t recovery_buffer_limit_ = DEFAULT_RECOVERY_BUFFER;
+    uint64_t stale_since_ns_ = 0;
+
+    uint64_t gaps_ = 0;
+    uint64_t missed_updates_ = 0;
+    uint64_t duplicate_updates_ = 0;
+    uint64_t buffer_overflows_ = 0;
+    uint64_t recoveries_ = 0;
+    uint64_t last_recovery_ns_ = 0;
+    uint64_t max_recovery_ns_ = 0;
+    uint64_t total_recovery_ns_ = 0;
+
+    void apply_sequenced(const OrderBookUpdate& update);
+    void buffer_update(const OrderBookUpdate& update);
+    void replay_buffered();     // Applies the contiguous run after the last sequence
+    void mark_recovered();
+};
+
+// In-memory order book representation
+class OrderBook : public IOrderBook {
+public:
+    explicit OrderBook(const std::string& symbol);
+    ~OrderBook() override = default;
+
+    // Query methods
+    price_t get_best_bid_fixed() const override;
+    price_t get_best_ask_fixed() const override;
+    uint32_t get_bid_size_at_level(size_t level) const override;  // 0 = best
+    uint32_t get_ask_size_at_level(size_t level) const override;
+    
+    // Advanced queries for strategies
+    double get_volume_weighted_price(BookSide side, uint32_t shares) const override;
+    uint32_t get_total_size(BookSide side, size_t levels = 5) const override;
+    
+    // Book quality metrics
+    size_t get_book_depth(BookSide side) const override;
+    size_t copy_levels(BookSide side, double* prices, double* sizes, size_t max_levels) const override;
+    
+    BookImplementation implementation() const override { return BookImplementation::MAP; }
+
+protected:
+    void apply_level(const OrderBookUpdate& update) override;
+    void load_snapshot(const std::vector<OrderBookLevel>& bids,
+                       const std::vector<OrderBookLevel>& asks) override;
+
+private:
+    // Ordered maps: price -> level (bids descending, asks ascending)
+    std::map<price_t, OrderBookLevel, std::greater<price_t>> bids_;  // Best bid = highest price
+    std::map<price_t, OrderBookLevel> asks_;                        // Best ask = lowest price
     
     // Helper methods
-    void update_level(std::map<double, OrderBookLevel, std::greater<double>>& book, 
-                     const OrderBookLevel& level, BookUpdateType type);
-    void update_level(std::map<double, OrderBookLevel>& book, 
-                     const OrderBookLevel& level, BookUpdateType type);
+    template<typename Book>
+    void update_level(Book& book, const OrderBookLevel& level, BookUpdateType type);
+};
+
+// Array-backed order book: one slot per price tick in a fixed window around an
+// anchor price. Slots are preallocated, so updates never allocate, and best
+// bid/ask are tracked by cursors for O(1) top-of-book reads. Updates priced
+// outside the window are dropped and counted.
+class LadderOrderBook : public IOrderBook {
+public:
+    static constexpr size_t DEFAULT_LADDER_LEVELS = 8192;
+
+    // The per-tick slots come from memory (see HugePageArena); they are sized
+    // once here and never reallocated
+    LadderOrderBook(const std::string& symbol,
+                    price_t tick_size = DEFAULT_TICK,
+                    size_t num_levels = DEFAULT_LADDER_LEVELS,
+                    std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    ~LadderOrderBook() override = default;
+
+    // Query methods
+    price_t get_best_bid_fixed() const override;
+    price_t get_best_ask_fixed() const override;
+    uint32_t get_bid_size_at_level(size_t level) const override;  // 0 = best
+    uint32_t get_ask_size_at_level(size_t level) const override;
+
+    // Advanced queries for strategies
+    double get_volume_weighted_price(BookSide side, uint32_t shares) const override;
+    uint32_t get_total_size(BookSide side, size_t levels = 5) const override;
+
+    // Book quality metrics
+    size_t get_book_depth(BookSide side) const override;
+    size_t copy_levels(BookSide side, double* prices, double* sizes, size_t max_levels) const override;
+
+    BookImplementation implementation() const override { return BookImplementation::LADDER; }
+
+    // Ladder geometry
+    price_t tick_size() const { return tick_size_; }
+    size_t num_levels() const { return bid_sizes_.size(); }
+    price_t get_base_price() const;
+    uint64_t get_out_of_range_count() const { return out_of_range_count_; }
+
+protected:
+    void apply_level(const OrderBookUpdate& update) override;
+    void load_snapshot(const std::vector<OrderBookLevel>& bids,
+                       const std::vector<OrderBookLevel>& asks) override;
+
+private:
+    static constexpr int64_t NO_LEVEL = -1;
+
+    price_t tick_size_;
+    int64_t base_tick_;   // Absolute tick of slot 0
+    bool anchored_;       // Set once the window is placed around the first price
+
+    // Per-tick slots; size 0 means the level is empty
+    std::pmr::vector<uint32_t> bid_sizes_;
+    std::pmr::vector<uint32_t> bid_counts_;
+    std::pmr::vector<uint32_t> ask_sizes_;
+    std::pmr::vector<uint32_t> ask_counts_;
+
+    // Best-price cursors (slot index, NO_LEVEL when the side is empty)
+    int64_t best_bid_idx_;
+    int64_t best_ask_idx_;
+    size_t bid_depth_;
+    size_t ask_depth_;
+
+    uint64_t out_of_range_count_;
+
+    // Helper methods
+    price_t slot_to_price(int64_t idx) const;
+    int64_t slot_for_price(price_t price);  // Anchors the window on first use
+    void set_bid(int64_t idx, uint32_t size, uint32_t count);
+    void set_ask(int64_t idx, uint32_t size, uint32_t count);
+    void clear_levels();
+    int64_t nth_bid_slot(size_t level) const;
+    int64_t nth_ask_slot(size_t level) const;
 };
 
 // Order book manager - handles multiple symbols
 class OrderBookManager {
 public:
-    OrderBookManager() = default;
+    // Fired when a book goes stale, so the owner can request a snapshot
+    using GapCallback = std::function<void(IOrderBook& book, uint64_t expected_sequence,
+                                           uint64_t received_sequence)>;
+
+    // Ladder books take their slots from memory; map books always use the
+    // heap, since their nodes come and go
+    explicit OrderBookManager(BookImplementation default_impl = BookImplementation::MAP,
+                              std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : default_impl_(default_impl), memory_(memory) {}
     ~OrderBookManager() = default;
 
     // Book management
     void add_symbol(const std::string& symbol);
-    OrderBook* get_book(const std::string& symbol);
-    const OrderBook* get_book(const std::string& symbol) const;
+    // Ladder books default to the symbol's configured tick (StaticConfig)
+    void add_symbol(const std::string& symbol, BookImplementation impl,
+                    price_t tick_size = 0,
+                    size_t ladder_levels = LadderOrderBook::DEFAULT_LADDER_LEVELS);
+    IOrderBook* get_book(const std::string& symbol);
+    const IOrderBook* get_book(const std::string& symbol) const;
+    // Drops every book; pointers from get_book() are invalidated
+    void clear();
+    
+    // Hot-path lookup by SymbolTable ID (nullptr if no book)
+    IOrderBook* get_book(symbol_id_t symbol_id) {
+        return symbol_id < books_by_id_.size() ? books_by_id_[symbol_id] : nullptr;
+    }
+    const IOrderBook* get_book(symbol_id_t symbol_id) const {
+        return symbol_id < books_by_id_.size() ? books_by_id_[symbol_id] : nullptr;
+    }
+
+    // Implementation used for symbols auto-created by process_update
+    void set_default_implementation(BookImplementation impl) { default_impl_ = impl; }
+    BookImplementation get_default_implementation() const { return default_impl_; }
     
     // Process updates
     void process_update(const OrderBookUpdate& update);
+    void set_gap_callback(GapCallback callback) { gap_callback_ = std::move(callback); }
     
     // Statistics
     size_t get_book_count() const { return books_.size(); }
     std::vector<std::string> get_symbols() const;
+    std::vector<std::string> get_stale_symbols() const;
+    uint64_t get_total_gaps() const;
 
 private:
-    std::map<std::string, std::unique_ptr<OrderBook>> books_;
+    std::map<std::string, std::unique_ptr<IOrderBook>> books_;
+    std::vector<IOrderBook*> books_by_id_;   // Indexed by symbol_id_t
+    BookImplementation default_impl_;
+    std::pmr::memory_resource* memory_;
+    GapCallback gap_callback_;
 };
 
 // Helper functions for creating order book messages
@@ -120,11 +342,17 @@ public:
     static OrderBookUpdate create_level_update(const std::string& symbol,
                                               BookSide side,
                                               BookUpdateType type,
-                                              double price,
+                                              price_t price,
                                               uint32_t size,
                                               uint64_t seq_num = 0,
                                               uint32_t order_count = 1);
     
+    static std::unique_ptr<IOrderBook> create_book(const std::string& symbol,
+                                                   BookImplementation impl,
+                                                   price_t tick_size = DEFAULT_TICK,
+                                                   size_t ladder_levels = LadderOrderBook::DEFAULT_LADDER_LEVELS,
+                                                   std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    
     static std::string update_to_string(const OrderBookUpdate& update);
 };
 
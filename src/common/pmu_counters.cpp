@@ -0,0 +1,201 @@
+#include "pmu_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+
+std::atomic<bool> PmuCounters::enabled_{false};
+
+namespace {
+
+#ifdef __linux__
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr EventSpec EVENT_SPECS[PmuCounters::EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},   // Last-level cache, as perf's cache-misses
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int perf_event_open(perf_event_attr* attr, int group_fd) {
+    // This thread, any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0));
+}
+
+#if defined(__x86_64__)
+inline uint64_t rdpmc(uint32_t counter) {
+    uint32_t low, high;
+    __asm__ volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+#endif
+#endif
+
+} // namespace
+
+const char* PmuCounters::event_name(Event event) {
+    switch (event) {
+        case CYCLES: return "cycles";
+        case INSTRUCTIONS: return "instructions";
+        case LLC_MISSES: return "llc_misses";
+        case BRANCH_MISSES: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+PmuCounters* PmuCounters::for_current_thread() {
+    thread_local std::unique_ptr<PmuCounters> counters;
+    thread_local bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        std::unique_ptr<PmuCounters> opened(new PmuCounters());
+        if (opened->open()) {
+            counters = std::move(opened);
+        }
+    }
+    return counters.get();
+}
+
+bool PmuCounters::open() {
+#ifdef __linux__
+    long page_size = sysconf(_SC_PAGESIZE);
+    int leader = -1;
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = EVENT_SPECS[i].type;
+        attr.config = EVENT_SPECS[i].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        int fd = perf_event_open(&attr, leader);
+        if (fd < 0) {
+            if (leader < 0) {
+                // Without cycles there is nothing to anchor the group to
+                std::cerr << "[PmuCounters] perf_event_open failed (" << std::strerror(errno)
+                          << "); PMU probes off for this thread" << std::endl;
+                return false;
+            }
+            std::cerr << "[PmuCounters] " << event_name(static_cast<Event>(i)) << " unavailable ("
+                      << std::strerror(errno) << ")" << std::endl;
+            continue;
+        }
+        if (leader < 0) leader = fd;
+        fds_[i] = fd;
+        group_slots_[i] = opened_++;
+
+        void* page = mmap(nullptr, static_cast<size_t>(page_size), PROT_READ, MAP_SHARED, fd, 0);
+        pages_[i] = page == MAP_FAILED ? nullptr : static_cast<perf_event_mmap_page*>(page);
+    }
+
+#if defined(__x86_64__)
+    // rdpmc only if every open event can use it; mixing the two read paths
+    // would skew the deltas between events
+    rdpmc_ = true;
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (fds_[i] >= 0 && (!pages_[i] || !pages_[i]->cap_user_rdpmc)) {
+            rdpmc_ = false;
+        }
+    }
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+PmuCounters::~PmuCounters() {
+#ifdef __linux__
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (pages_[i]) munmap(pages_[i], static_cast<size_t>(page_size));
+        if (fds_[i] >= 0) close(fds_[i]);
+    }
+#endif
+}
+
+bool PmuCounters::read(Reading& out) const {
+    if (rdpmc_ && read_rdpmc(out)) {
+        return true;
+    }
+    return read_group(out);
+}
+
+bool PmuCounters::read_rdpmc(Reading& out) const {
+#if defined(__linux__) && defined(__x86_64__)
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        out[i] = 0;
+        const perf_event_mmap_page* page = pages_[i];
+        if (!page) continue;
+
+        // The kernel bumps lock around any update to index/offset (e.g. on
+        // a context switch); retry until a read saw none
+        uint32_t sequence;
+        uint64_t count;
+        do {
+            sequence = page->lock;
+            __asm__ volatile("" ::: "memory");
+            uint32_t index = page->index;
+            if (index == 0) {
+                // Not on a counter right now (multiplexed out)
+                return false;
+            }
+            int64_t raw = static_cast<int64_t>(rdpmc(index - 1));
+            uint16_t width = page->pmc_width;
+            raw <<= 64 - width;
+            raw >>= 64 - width;
+            count = static_cast<uint64_t>(page->offset + raw);
+            __asm__ volatile("" ::: "memory");
+        } while (page->lock != sequence);
+        out[i] = count;
+    }
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+bool PmuCounters::read_group(Reading& out) const {
+#ifdef __linux__
+    // PERF_FORMAT_GROUP: the number of events, then one value per event in
+    // the order they joined the group
+    uint64_t buffer[1 + EVENT_COUNT];
+    ssize_t bytes = ::read(fds_[CYCLES], buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(sizeof(uint64_t)) || buffer[0] != opened_) {
+        return false;
+    }
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        out[i] = fds_[i] >= 0 ? buffer[1 + group_slots_[i]] : 0;
+    }
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+PmuRegion::PmuRegion(const char* name) {
+    for (size_t i = 0; i < PmuCounters::EVENT_COUNT; ++i) {
+        std::string label = std::string("pmu.") + name + "." +
+                            PmuCounters::event_name(static_cast<PmuCounters::Event>(i));
+        ids[i] = MetricsCollector::instance().register_metric(label.c_str(), MetricType::HISTOGRAM);
+    }
+}
+
+} // namespace hft
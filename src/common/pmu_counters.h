@@ -0,0 +1,108 @@
+#pragma once
+
+#include "metrics_collector.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+struct perf_event_mmap_page;
+
+namespace hft {
+
+// Hardware counters for the calling thread, to tell whether a slower region
+// is slower because of cache misses, branch misses or just more work.
+// One perf_event_open group per thread (user-mode cycles, instructions, LLC
+// misses, branch misses), opened on the thread's first probe. Reads use
+// rdpmc through the events' mmap pages when the kernel allows it (tens of
+// cycles) and fall back to one read() of the group otherwise.
+//
+// Off unless profiler.pmu_counters=true; a disabled probe costs one relaxed
+// load. Needs perf_event_paranoid <= 2 and a PMU the VM exposes; without
+// them each thread logs once and its probes record nothing.
+class PmuCounters {
+public:
+    enum Event : uint8_t { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+    using Reading = std::array<uint64_t, EVENT_COUNT>;
+
+    static const char* event_name(Event event);
+
+    // Process-wide switch, set from StaticConfig by initialize_hft_metrics()
+    static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // The calling thread's group; nullptr if the kernel refused it
+    static PmuCounters* for_current_thread();
+
+    // Running totals since the group was opened. Events the PMU couldn't
+    // open read 0 and are absent from available().
+    bool read(Reading& out) const;
+    bool available(Event event) const { return fds_[event] >= 0; }
+    bool uses_rdpmc() const { return rdpmc_; }
+
+    ~PmuCounters();
+    PmuCounters(const PmuCounters&) = delete;
+    PmuCounters& operator=(const PmuCounters&) = delete;
+
+private:
+    PmuCounters() = default;
+
+    bool open();
+    bool read_rdpmc(Reading& out) const;
+    bool read_group(Reading& out) const;
+
+    int fds_[EVENT_COUNT] = {-1, -1, -1, -1};
+    perf_event_mmap_page* pages_[EVENT_COUNT] = {};
+    uint8_t group_slots_[EVENT_COUNT] = {};   // Slot of each value in a group read()
+    uint8_t opened_ = 0;
+    bool rdpmc_ = false;
+
+    static std::atomic<bool> enabled_;
+};
+
+// The histogram IDs of one probed region: pmu.<name>.cycles,
+// .instructions, .llc_misses and .branch_misses
+struct PmuRegion {
+    explicit PmuRegion(const char* name);
+    metric_id_t ids[PmuCounters::EVENT_COUNT];
+};
+
+// Records the counter deltas across its lifetime into the region's
+// histograms; does nothing given a null region
+class PmuScope {
+public:
+    explicit PmuScope(const PmuRegion* region)
+        : region_(region), counters_(region ? PmuCounters::for_current_thread() : nullptr) {
+        if (counters_ && !counters_->read(start_)) {
+            counters_ = nullptr;
+        }
+    }
+
+    ~PmuScope() {
+        PmuCounters::Reading end;
+        if (!counters_ || !counters_->read(end)) {
+            return;
+        }
+        MetricsCollector& collector = MetricsCollector::instance();
+        for (size_t i = 0; i < PmuCounters::EVENT_COUNT; ++i) {
+            if (counters_->available(static_cast<PmuCounters::Event>(i))) {
+                collector.record_histogram_value(region_->ids[i], end[i] - start_[i]);
+            }
+        }
+    }
+
+    PmuScope(const PmuScope&) = delete;
+    PmuScope& operator=(const PmuScope&) = delete;
+
+private:
+    const PmuRegion* region_;
+    PmuCounters* counters_;
+    PmuCounters::Reading start_{};
+};
+
+// Probes the rest of the enclosing scope; name must be a constant. The
+// region's metrics are only registered once probes are enabled.
+#define HFT_PMU_SCOPE(name) \
+    hft::PmuScope _pmu_scope(hft::PmuCounters::enabled() ? \
+        &[]() -> const hft::PmuRegion& { static const hft::PmuRegion region(name); return region; }() : nullptr)
+
+} // namespace hft
@@ -0,0 +1,205 @@
+#include "pre_trade_risk.h"
+#include "static_config.h"
+#include <cstdlib>
+
+namespace hft {
+
+const char* risk_check_result_to_string(RiskCheckResult result) {
+    switch (result) {
+        case RiskCheckResult::PASSED: return "PASSED";
+        case RiskCheckResult::INVALID_ORDER: return "INVALID_ORDER";
+        case RiskCheckResult::HALTED: return "HALTED";
+        case RiskCheckResult::ORDER_SIZE: return "ORDER_SIZE";
+        case RiskCheckResult::ORDER_NOTIONAL: return "ORDER_NOTIONAL";
+        case RiskCheckResult::POSITION_LIMIT: return "POSITION_LIMIT";
+        case RiskCheckResult::PRICE_BAND: return "PRICE_BAND";
+        case RiskCheckResult::RATE_LIMIT: return "RATE_LIMIT";
+        case RiskCheckResult::VENUE_UNAVAILABLE: return "VENUE_UNAVAILABLE";
+    }
+    return "UNKNOWN";
+}
+
+RiskLimits RiskLimits::from_config() {
+    RiskLimits limits;
+    limits.max_order_quantity = static_cast<uint32_t>(StaticConfig::get_max_order_quantity());
+    limits.max_order_notional = StaticConfig::get_max_order_notional();
+    limits.max_position = StaticConfig::get_position_limit_per_symbol();
+    limits.price_band_ratio = StaticConfig::get_price_band_ratio();
+    limits.max_orders_per_second = static_cast<uint32_t>(StaticConfig::get_max_orders_per_second());
+    return limits;
+}
+
+PreTradeRisk::PreTradeRisk()
+    : symbols_(SymbolTable::MAX_SYMBOLS)
+    , halted_(false) {
+}
+
+RiskCheckResult PreTradeRisk::check(symbol_id_t symbol_id, SignalAction action, OrderType type,
+                                    price_t price, uint32_t quantity, int64_t now_ns) {
+    if (symbol_id >= symbols_.size() || quantity == 0 ||
+        (action != SignalAction::BUY && action != SignalAction::SELL)) {
+        return RiskCheckResult::INVALID_ORDER;
+    }
+    if (halted_.load(std::memory_order_relaxed)) {
+        return RiskCheckResult::HALTED;
+    }
+
+    SymbolRisk& risk = symbols_[symbol_id];
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    uint32_t max_quantity = risk.max_order_quantity.load(relaxed);
+    if (max_quantity != 0 && quantity > max_quantity) {
+        return RiskCheckResult::ORDER_SIZE;
+    }
+
+    // Market orders are valued at the reference price
+    price_t reference = risk.reference_price.load(relaxed);
+    bool has_limit_price = type != OrderType::MARKET && price > 0;
+    price_t value_price = has_limit_price ? price : reference;
+
+    double max_notional = risk.max_order_notional.load(relaxed);
+    if (max_notional > 0.0 && value_price > 0 &&
+        to_double_price(value_price) * quantity > max_notional) {
+        return RiskCheckResult::ORDER_NOTIONAL;
+    }
+
+    double band = risk.price_band_ratio.load(relaxed);
+    if (band > 0.0 && has_limit_price && reference > 0 &&
+        static_cast<double>(std::llabs(price - reference)) > band * static_cast<double>(reference)) {
+        return RiskCheckResult::PRICE_BAND;
+    }
+
+    // Worst case: every working order on this side fills
+    int64_t max_position = risk.max_position.load(relaxed);
+    if (max_position > 0) {
+        int64_t position = risk.position.load(relaxed);
+        int64_t projected = action == SignalAction::BUY
+            ? position + risk.working_buy.load(relaxed) + quantity
+            : -(position - risk.working_sell.load(relaxed) - static_cast<int64_t>(quantity));
+        if (projected > max_position) {
+            return RiskCheckResult::POSITION_LIMIT;
+        }
+    }
+
+    // Generic cell rate algorithm: bursts of max_orders_per_second, then one
+    // order per 1/rate seconds; one timestamp of state, no buckets to refill
+    uint32_t rate = risk.max_orders_per_second.load(relaxed);
+    if (rate != 0) {
+        int64_t interval = 1000000000LL / rate;
+        int64_t tolerance = interval * (static_cast<int64_t>(rate) - 1);
+        if (now_ns < risk.next_order_ns - tolerance) {
+            return RiskCheckResult::RATE_LIMIT;
+        }
+        risk.next_order_ns = (risk.next_order_ns > now_ns ? risk.next_order_ns : now_ns) + interval;
+    }
+
+    add(action == SignalAction::BUY ? risk.working_buy : risk.working_sell, quantity);
+    return RiskCheckResult::PASSED;
+}
+
+void PreTradeRisk::on_fill(symbol_id_t symbol_id, SignalAction action, uint32_t fill_quantity) {
+    if (symbol_id >= symbols_.size() || fill_quantity == 0) return;
+    SymbolRisk& risk = symbols_[symbol_id];
+    if (action == SignalAction::BUY) {
+        add(risk.working_buy, -static_cast<int64_t>(fill_quantity));
+        add(risk.position, fill_quantity);
+    } else {
+        add(risk.working_sell, -static_cast<int64_t>(fill_quantity));
+        add(risk.position, -static_cast<int64_t>(fill_quantity));
+    }
+}
+
+void PreTradeRisk::on_order_closed(symbol_id_t symbol_id, SignalAction action, uint32_t remaining_quantity) {
+    if (symbol_id >= symbols_.size() || remaining_quantity == 0) return;
+    SymbolRisk& risk = symbols_[symbol_id];
+    add(action == SignalAction::BUY ? risk.working_buy : risk.working_sell,
+        -static_cast<int64_t>(remaining_quantity));
+}
+
+void PreTradeRisk::restore_working(symbol_id_t symbol_id, SignalAction action, uint32_t quantity) {
+    if (symbol_id >= symbols_.size() || quantity == 0) return;
+    SymbolRisk& risk = symbols_[symbol_id];
+    add(action == SignalAction::BUY ? risk.working_buy : risk.working_sell, quantity);
+}
+
+void PreTradeRisk::restore_position(symbol_id_t symbol_id, int64_t position) {
+    if (symbol_id >= symbols_.size()) return;
+    symbols_[symbol_id].position.store(position, std::memory_order_relaxed);
+}
+
+void PreTradeRisk::reset_order_state() {
+    for (auto& risk : symbols_) {
+        risk.position.store(0, std::memory_order_relaxed);
+        risk.working_buy.store(0, std::memory_order_relaxed);
+        risk.working_sell.store(0, std::memory_order_relaxed);
+        risk.next_order_ns = 0;
+    }
+}
+
+void PreTradeRisk::set_default_limits(const RiskLimits& limits) {
+    for (symbol_id_t id = 0; id < symbols_.size(); ++id) {
+        set_symbol_limits(id, limits);
+    }
+}
+
+void PreTradeRisk::set_symbol_limits(symbol_id_t symbol_id, const RiskLimits& limits) {
+    if (symbol_id >= symbols_.size()) return;
+    SymbolRisk& risk = symbols_[symbol_id];
+    constexpr auto relaxed = std::memory_order_relaxed;
+    risk.max_order_quantity.store(limits.max_order_quantity, relaxed);
+    risk.max_order_notional.store(limits.max_order_notional, relaxed);
+    risk.max_position.store(limits.max_position, relaxed);
+    risk.price_band_ratio.store(limits.price_band_ratio, relaxed);
+    risk.max_orders_per_second.store(limits.max_orders_per_second, relaxed);
+}
+
+void PreTradeRisk::set_reference_price(symbol_id_t symbol_id, price_t price) {
+    if (symbol_id >= symbols_.size()) return;
+    symbols_[symbol_id].reference_price.store(price, std::memory_order_relaxed);
+}
+
+void PreTradeRisk::apply(const RiskLimitUpdate& update) {
+    RiskLimits limits;
+    limits.max_order_quantity = update.max_order_quantity;
+    limits.max_order_notional = update.max_order_notional;
+    limits.max_position = update.max_position;
+    limits.price_band_ratio = update.price_band_ratio;
+    limits.max_orders_per_second = update.max_orders_per_second;
+
+    if (update.symbol_id == INVALID_SYMBOL_ID) {
+        set_default_limits(limits);
+        set_halted(update.halted != 0);
+        return;
+    }
+
+    symbol_id_t id = SymbolTable::instance().resolve(update.symbol_id, update.symbol);
+    set_symbol_limits(id, limits);
+    if (update.reference_price > 0) {
+        set_reference_price(id, update.reference_price);
+    }
+}
+
+int64_t PreTradeRisk::get_position(symbol_id_t symbol_id) const {
+    return symbol_id < symbols_.size() ? symbols_[symbol_id].position.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t PreTradeRisk::get_working_quantity(symbol_id_t symbol_id, SignalAction action) const {
+    if (symbol_id >= symbols_.size()) return 0;
+    const SymbolRisk& risk = symbols_[symbol_id];
+    return (action == SignalAction::BUY ? risk.working_buy : risk.working_sell).load(std::memory_order_relaxed);
+}
+
+RiskLimits PreTradeRisk::get_limits(symbol_id_t symbol_id) const {
+    RiskLimits limits;
+    if (symbol_id >= symbols_.size()) return limits;
+    const SymbolRisk& risk = symbols_[symbol_id];
+    constexpr auto relaxed = std::memory_order_relaxed;
+    limits.max_order_quantity = risk.max_order_quantity.load(relaxed);
+    limits.max_order_notional = risk.max_order_notional.load(relaxed);
+    limits.max_position = risk.max_position.load(relaxed);
+    limits.price_band_ratio = risk.price_band_ratio.load(relaxed);
+    limits.max_orders_per_second = risk.max_orders_per_second.load(relaxed);
+    return limits;
+}
+
+} // namespace hft
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "message_types.h"
+#include "symbol_table.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+
+enum class RiskCheckResult : uint8_t {
+    PASSED = 0,
+    INVALID_ORDER,      // Zero quantity, unknown symbol or non-order action
+    HALTED,
+    ORDER_SIZE,
+    ORDER_NOTIONAL,
+    POSITION_LIMIT,
+    PRICE_BAND,
+    RATE_LIMIT,
+    VENUE_UNAVAILABLE   // Not a limit: no venue can take the order (its session is down)
+};
+
+const char* risk_check_result_to_string(RiskCheckResult result);
+
+struct RiskLimits {
+    uint32_t max_order_quantity = 0;      // 0 = off, for every limit
+    double max_order_notional = 0.0;
+    int64_t max_position = 0;             // |position + working orders on that side|
+    double price_band_ratio = 0.0;        // e.g. 0.05 = limit within 5% of reference
+    uint32_t max_orders_per_second = 0;   // Burst of up to this many, then evenly spaced
+
+    // risk.* keys from StaticConfig
+    static RiskLimits from_config();
+};
+
+// In-process pre-trade checks for the order gateway's hot path. State is
+// preallocated per dense symbol ID, so check() is a handful of loads and
+// compares with no allocation, locking or hashing.
+//
+// Threading: check() and the order lifecycle calls (on_fill, on_order_closed)
+// come from the one thread that sends orders. Limits, reference prices and
+// the halt flag may be updated from any thread; each value is a relaxed atomic
+// and takes effect on the next check, independently of the others.
+class PreTradeRisk {
+public:
+    PreTradeRisk();
+
+    // Checks a new order and, if it passes, books it as working and charges
+    // the rate limit. Notional and price band checks are skipped while the
+    // symbol has neither a limit price nor a reference price.
+    RiskCheckResult check(symbol_id_t symbol_id, SignalAction action, OrderType type,
+                          price_t price, uint32_t quantity, int64_t now_ns);
+    RiskCheckResult check(const TradingSignal& signal, int64_t now_ns) {
+        return check(signal.symbol_id, signal.action, signal.order_type, signal.price, signal.quantity, now_ns);
+    }
+
+    // Working quantity becomes position as it fills
+    void on_fill(symbol_id_t symbol_id, SignalAction action, uint32_t fill_quantity);
+    // Cancelled, rejected or expired remainder leaves the working total
+    void on_order_closed(symbol_id_t symbol_id, SignalAction action, uint32_t remaining_quantity);
+    // Forgets positions, working totals and rate-limit history (order thread
+    // only); limits and reference prices are kept. Used after a warmup replay.
+    void reset_order_state();
+    // Journal recovery (order thread, before trading): books a working order
+    // without checking it, and sets a symbol's position outright
+    void restore_working(symbol_id_t symbol_id, SignalAction action, uint32_t quantity);
+    void restore_position(symbol_id_t symbol_id, int64_t position);
+
+    // Limit updates (any thread)
+    void set_default_limits(const RiskLimits& limits);     // Every symbol
+    void set_symbol_limits(symbol_id_t symbol_id, const RiskLimits& limits);
+    void set_reference_price(symbol_id_t symbol_id, price_t price);
+    void set_halted(bool halted) { halted_.store(halted, std::memory_order_relaxed); }
+    void apply(const RiskLimitUpdate& update);
+
+    bool is_halted() const { return halted_.load(std::memory_order_relaxed); }
+    int64_t get_position(symbol_id_t symbol_id) const;
+    int64_t get_working_quantity(symbol_id_t symbol_id, SignalAction action) const;
+    RiskLimits get_limits(symbol_id_t symbol_id) const;
+
+private:
+    // One cache line pair per symbol; limits are written rarely, the rest
+    // only by the order thread, so there is no contended sharing
+    struct alignas(64) SymbolRisk {
+        std::atomic<uint32_t> max_order_quantity{0};
+        std::atomic<uint32_t> max_orders_per_second{0};
+        std::atomic<double> max_order_notional{0.0};
+        std::atomic<int64_t> max_position{0};
+        std::atomic<double> price_band_ratio{0.0};
+        std::atomic<price_t> reference_price{0};
+
+        // Order thread only; atomic so stats readers are race-free
+        std::atomic<int64_t> position{0};
+        std::atomic<int64_t> working_buy{0};
+        std::atomic<int64_t> working_sell{0};
+        int64_t next_order_ns = 0;       // GCRA theoretical arrival time
+    };
+
+    std::vector<SymbolRisk> symbols_;
+    std::atomic<bool> halted_;
+
+    static void add(std::atomic<int64_t>& value, int64_t delta) {
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+};
+
+} // namespace hft
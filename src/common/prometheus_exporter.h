@@ -2,54 +2,97 @@
 
 #include "metrics_collector.h"
 #include "hft_metrics.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
-#include <vector>
+#include <type_traits>
+#include <unordered_set>
 #include <chrono>
-#include <iomanip>
-#include <set>
 
 namespace hft {
 
-// Prometheus metrics exporter for HFT system
+// Appends exposition text to a caller-owned string, so a buffer reused
+// between scrapes keeps its capacity. Numbers go through std::to_chars
+// instead of iostreams.
+class PrometheusWriter {
+public:
+    explicit PrometheusWriter(std::string& out) : out_(out) {}
+    
+    PrometheusWriter& operator<<(std::string_view text) {
+        out_.append(text);
+        return *this;
+    }
+    
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    PrometheusWriter& operator<<(T value) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out_.append(digits, result.ptr);
+        return *this;
+    }
+    
+private:
+    std::string& out_;
+};
+
+// Prometheus metrics exporter for HFT system. render() keeps the text of
+// each metric family between calls and only re-renders the families whose
+// values changed, so a steady scrape rate costs copies, not formatting.
 class PrometheusExporter {
 public:
-    static std::string export_metrics(const std::unordered_map<std::string, MetricStats>* external_metrics = nullptr) {
-        std::ostringstream prometheus_output;
+    // Renders into a buffer kept between calls; the reference is valid until
+    // the next call. Not thread-safe: one exporter per scraping thread.
+    const std::string& render(const std::unordered_map<std::string, MetricStats>& stats) {
+        output_.clear();
+        PrometheusWriter output(output_);
+        generation_++;
         
         // Add system information
-        add_system_info(prometheus_output);
+        add_system_info(output);
         
-        // Use external metrics if provided, otherwise fall back to local collector
-        std::unordered_map<std::string, MetricStats> stats;
-        if (external_metrics) {
-            stats = *external_metrics;
-        } else {
-            auto& collector = MetricsCollector::instance();
-            stats = collector.get_statistics();
+        for (const auto& [name, metric_stats] : stats) {
+            if (hft_handled_metrics().count(name) == 0) {
+                append_family(output, name, metric_stats, false);
+            }
         }
         
-        // Metrics that are handled by HFT-specific export functions to avoid duplicates
-        std::set<std::string> hft_handled_metrics = {
-            "e2e.tick_to_signal_ns", "e2e.tick_to_order_ns", "e2e.tick_to_fill_ns",
-            "md.total_latency_ns", "strategy.total_latency_ns", "order.total_latency_ns",
-            "md.messages_per_second", "strategy.decisions_per_second", "orders.per_second",
-            "trading.positions_open", "trading.pnl_total_usd", "trading.fill_rate_percent",
-            "system.memory_rss_mb", "system.cpu_usage_percent", "system.thread_count",
-            "network.bytes_received_total"
-        };
+        // Critical path latencies with appropriate buckets for HFT
+        for (const std::string& metric_name : critical_latencies()) {
+            auto it = stats.find(metric_name);
+            if (it != stats.end() && it->second.type == MetricType::LATENCY) {
+                append_family(output, it->first, it->second, true);
+            }
+        }
         
-        for (const auto& [name, metric_stats] : stats) {
-            if (hft_handled_metrics.find(name) == hft_handled_metrics.end()) {
-                export_metric(prometheus_output, name, metric_stats);
+        // Gone from the stats since the last scrape
+        for (auto* families : {&families_, &hft_families_}) {
+            for (auto it = families->begin(); it != families->end();) {
+                it = it->second.generation == generation_ ? std::next(it) : families->erase(it);
             }
         }
         
-        // Add custom HFT metrics
-        add_hft_specific_metrics(prometheus_output, stats);
+        add_hft_throughput_metrics(output, stats);
+        add_hft_trading_metrics(output, stats);
+        add_hft_system_metrics(output, stats);
+        add_hft_component_status(output);
         
-        return prometheus_output.str();
+        return output_;
+    }
+    
+    uint64_t get_families_rendered() const { return families_rendered_; }
+    uint64_t get_families_reused() const { return families_reused_; }
+    
+    // One-shot export, without the cache
+    static std::string export_metrics(const std::unordered_map<std::string, MetricStats>* external_metrics = nullptr) {
+        PrometheusExporter exporter;
+        if (external_metrics) {
+            return exporter.render(*external_metrics);
+        }
+        // Fall back to the local collector
+        return exporter.render(MetricsCollector::instance().get_statistics());
     }
     
     static std::string get_content_type() {
@@ -57,7 +100,74 @@ public:
     }
 
 private:
-    static void add_system_info(std::ostringstream& output) {
+    // The values a family's text is made of; unchanged key, unchanged text
+    struct FamilyKey {
+        MetricType type;
+        uint64_t count, sum, min_value, max_value;
+        uint64_t p50, p90, p95, p99, p999, p9999;
+        uint64_t histogram_total;
+        
+        bool operator==(const FamilyKey& other) const = default;
+    };
+    
+    struct Family {
+        FamilyKey key;
+        std::string text;
+        uint64_t generation = 0;
+    };
+    
+    std::string output_;
+    std::map<std::string, Family> families_;       // By metric name
+    std::map<std::string, Family> hft_families_;   // HFT latency histograms
+    uint64_t generation_ = 0;
+    uint64_t families_rendered_ = 0;
+    uint64_t families_reused_ = 0;
+    
+    static const std::array<std::string, 6>& critical_latencies() {
+        static const std::array<std::string, 6> names = {
+            "e2e.tick_to_signal_ns", "e2e.tick_to_order_ns", "e2e.tick_to_fill_ns",
+            "md.total_latency_ns", "strategy.total_latency_ns", "order.total_latency_ns"
+        };
+        return names;
+    }
+    
+    // Metrics that are handled by HFT-specific export functions to avoid duplicates
+    static const std::unordered_set<std::string>& hft_handled_metrics() {
+        static const std::unordered_set<std::string> handled = {
+            "e2e.tick_to_signal_ns", "e2e.tick_to_order_ns", "e2e.tick_to_fill_ns",
+            "md.total_latency_ns", "strategy.total_latency_ns", "order.total_latency_ns",
+            "md.messages_per_second", "strategy.decisions_per_second", "orders.per_second",
+            "trading.positions_open", "trading.pnl_total_usd", "trading.fill_rate_percent",
+            "system.memory_rss_mb", "system.cpu_usage_percent", "system.thread_count",
+            "network.bytes_received_total"
+        };
+        return handled;
+    }
+    
+    void append_family(PrometheusWriter& output, const std::string& name, const MetricStats& stats, bool hft_histogram) {
+        FamilyKey key{stats.type, stats.count, stats.sum, stats.min_value, stats.max_value,
+                      stats.p50, stats.p90, stats.p95, stats.p99, stats.p999, stats.p9999,
+                      stats.histogram.total};
+        
+        Family& family = (hft_histogram ? hft_families_ : families_)[name];
+        if (family.generation == 0 || !(family.key == key)) {
+            family.key = key;
+            family.text.clear();
+            PrometheusWriter writer(family.text);
+            if (hft_histogram) {
+                export_hft_latency_histogram(writer, name, stats);
+            } else {
+                export_metric(writer, name, stats);
+            }
+            families_rendered_++;
+        } else {
+            families_reused_++;
+        }
+        family.generation = generation_;
+        output << family.text;
+    }
+    
+    static void add_system_info(PrometheusWriter& output) {
         auto now = std::chrono::system_clock::now();
         auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
         
@@ -77,7 +187,7 @@ private:
         output << "hft_process_start_time_seconds " << (timestamp / 1000.0) << "\n";
     }
     
-    static void export_metric(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_metric(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         std::string metric_name = sanitize_metric_name(name);
         
         switch (stats.type) {
@@ -96,21 +206,17 @@ private:
         }
     }
     
-    static void export_latency_metric(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_latency_metric(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         // Export as histogram with predefined buckets for latency
         output << "# HELP hft_" << name << "_nanoseconds Latency measurements in nanoseconds\n";
         output << "# TYPE hft_" << name << "_nanoseconds histogram\n";
         
         // Define latency buckets (in nanoseconds)
-        std::vector<uint64_t> buckets = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+        static constexpr uint64_t buckets[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
         
-        uint64_t cumulative_count = 0;
         for (uint64_t bucket : buckets) {
-            // Estimate count in this bucket (simplified)
-            uint64_t bucket_count = (stats.min_value <= bucket) ? stats.count : 0;
-            cumulative_count += bucket_count;
-            
-            output << "hft_" << name << "_nanoseconds_bucket{le=\"" << bucket << "\"} " << cumulative_count << "\n";
+            output << "hft_" << name << "_nanoseconds_bucket{le=\"" << bucket << "\"} "
+                   << cumulative_count(stats, bucket) << "\n";
         }
         
         output << "hft_" << name << "_nanoseconds_bucket{le=\"+Inf\"} " << stats.count << "\n";
@@ -131,13 +237,13 @@ private:
         output << "hft_" << name << "_p99_nanoseconds " << stats.p99 << "\n";
     }
     
-    static void export_counter_metric(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_counter_metric(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         output << "# HELP hft_" << name << "_total Total count of " << name << "\n";
         output << "# TYPE hft_" << name << "_total counter\n";
         output << "hft_" << name << "_total " << stats.sum << "\n";
     }
     
-    static void export_gauge_metric(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_gauge_metric(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         output << "# HELP hft_" << name << " Current value of " << name << "\n";
         output << "# TYPE hft_" << name << " gauge\n";
         output << "hft_" << name << " " << stats.max_value << "\n";  // Use most recent max as current
@@ -154,68 +260,41 @@ private:
         }
     }
     
-    static void export_histogram_metric(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_histogram_metric(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         output << "# HELP hft_" << name << " Distribution of " << name << "\n";
         output << "# TYPE hft_" << name << " histogram\n";
         
-        // Simple histogram export (would need more sophisticated bucketing in production)
+        // Power-of-two edges; values are not necessarily nanoseconds
+        if (!stats.histogram.empty()) {
+            for (uint64_t bucket = 1; bucket < stats.max_value && bucket < (uint64_t(1) << 40); bucket <<= 1) {
+                output << "hft_" << name << "_bucket{le=\"" << bucket << "\"} "
+                       << cumulative_count(stats, bucket) << "\n";
+            }
+        }
         output << "hft_" << name << "_bucket{le=\"+Inf\"} " << stats.count << "\n";
         output << "hft_" << name << "_count " << stats.count << "\n";
         output << "hft_" << name << "_sum " << stats.sum << "\n";
     }
     
-    static void add_hft_specific_metrics(std::ostringstream& output, const std::unordered_map<std::string, MetricStats>& stats) {
-        
-        // Export critical latency metrics with proper buckets
-        add_hft_latency_metrics(output, stats);
-        
-        // Export throughput metrics  
-        add_hft_throughput_metrics(output, stats);
-        
-        // Export trading performance metrics
-        add_hft_trading_metrics(output, stats);
-        
-        // Export system health metrics
-        add_hft_system_metrics(output, stats);
-        
-        // Export component status
-        add_hft_component_status(output);
-    }
-    
-    static void add_hft_latency_metrics(std::ostringstream& output, const auto& stats) {
-        // Critical path latencies with appropriate buckets for HFT
-        std::vector<std::string> critical_latencies = {
-            "e2e.tick_to_signal_ns", "e2e.tick_to_order_ns", "e2e.tick_to_fill_ns",
-            "md.total_latency_ns", "strategy.total_latency_ns", "order.total_latency_ns"
-        };
-        
-        for (const auto& metric_name : critical_latencies) {
-            auto it = stats.find(metric_name);
-            if (it != stats.end() && it->second.type == MetricType::LATENCY) {
-                export_hft_latency_histogram(output, metric_name, it->second);
-            }
-        }
-    }
-    
-    static void add_hft_throughput_metrics(std::ostringstream& output, const auto& stats) {
-        // Message throughput metrics
-        std::vector<std::pair<std::string, std::string>> throughput_metrics = {
-            {"md.messages_per_second", "Market data messages per second"},
-            {"strategy.decisions_per_second", "Strategy decisions per second"}, 
-            {"orders.per_second", "Orders per second"}
-        };
-        
-        for (const auto& [metric_name, help_text] : throughput_metrics) {
+    static void add_hft_throughput_metrics(PrometheusWriter& output, const auto& stats) {
+        // Message throughput metrics: key, exported name, help
+        static const std::array<std::array<std::string, 3>, 3> throughput_metrics = {{
+            {"md.messages_per_second", "md_messages_per_second", "Market data messages per second"},
+            {"strategy.decisions_per_second", "strategy_decisions_per_second", "Strategy decisions per second"},
+            {"orders.per_second", "orders_per_second", "Orders per second"}
+        }};
+        
+        for (const auto& [metric_name, exported_name, help_text] : throughput_metrics) {
             auto it = stats.find(metric_name);
             if (it != stats.end()) {
-                output << "# HELP hft_" << sanitize_metric_name(metric_name) << " " << help_text << "\n";
-                output << "# TYPE hft_" << sanitize_metric_name(metric_name) << " gauge\n";
-                output << "hft_" << sanitize_metric_name(metric_name) << " " << it->second.max_value << "\n";
+                output << "# HELP hft_" << exported_name << " " << help_text << "\n";
+                output << "# TYPE hft_" << exported_name << " gauge\n";
+                output << "hft_" << exported_name << " " << it->second.max_value << "\n";
             }
         }
     }
     
-    static void add_hft_trading_metrics(std::ostringstream& output, const auto& stats) {
+    static void add_hft_trading_metrics(PrometheusWriter& output, const auto& stats) {
         // Trading performance
         output << "# HELP hft_trading_positions_open Current open positions\n";
         output << "# TYPE hft_trading_positions_open gauge\n";
@@ -233,7 +312,7 @@ private:
         output << "hft_trading_fill_rate_percent " << (it != stats.end() ? it->second.max_value : 100) << "\n";
     }
     
-    static void add_hft_system_metrics(std::ostringstream& output, const auto& stats) {
+    static void add_hft_system_metrics(PrometheusWriter& output, const auto& stats) {
         // System resource utilization  
         output << "# HELP hft_system_memory_rss_mb RSS memory usage in MB\n";
         output << "# TYPE hft_system_memory_rss_mb gauge\n";
@@ -257,7 +336,7 @@ private:
         output << "hft_network_bytes_received_total " << (it != stats.end() ? it->second.sum : 0) << "\n";
     }
     
-    static void add_hft_component_status(std::ostringstream& output) {
+    static void add_hft_component_status(PrometheusWriter& output) {
         // Component health status - would be updated by actual components
         output << "# HELP hft_component_status Component operational status (1=healthy, 0=degraded)\n";
         output << "# TYPE hft_component_status gauge\n";
@@ -275,11 +354,11 @@ private:
         output << "hft_service_uptime_seconds " << uptime << "\n";
     }
     
-    static void export_hft_latency_histogram(std::ostringstream& output, const std::string& name, const MetricStats& stats) {
+    static void export_hft_latency_histogram(PrometheusWriter& output, const std::string& name, const MetricStats& stats) {
         std::string sanitized_name = sanitize_metric_name(name);
         
         // HFT-specific latency buckets (nanoseconds) - much tighter for trading systems
-        std::vector<uint64_t> hft_buckets = {
+        static constexpr uint64_t hft_buckets[] = {
             100, 250, 500, 1000,     // Sub-microsecond (100ns - 1μs)
             2500, 5000, 10000,       // Low microsecond (2.5μs - 10μs) 
             25000, 50000, 100000,    // High microsecond (25μs - 100μs)
@@ -290,18 +369,9 @@ private:
         output << "# HELP hft_" << sanitized_name << "_histogram HFT latency distribution\n";
         output << "# TYPE hft_" << sanitized_name << "_histogram histogram\n";
         
-        // Estimate bucket counts based on percentiles
-        uint64_t cumulative = 0;
         for (uint64_t bucket : hft_buckets) {
-            uint64_t bucket_count = 0;
-            if (bucket >= stats.p99) bucket_count = stats.count;
-            else if (bucket >= stats.p95) bucket_count = stats.count * 99 / 100;
-            else if (bucket >= stats.p90) bucket_count = stats.count * 95 / 100;
-            else if (bucket >= stats.p50) bucket_count = stats.count * 90 / 100;
-            else if (bucket >= stats.min_value) bucket_count = stats.count * 50 / 100;
-            
             output << "hft_" << sanitized_name << "_histogram_bucket{le=\""
-                   << bucket << "\"} " << bucket_count << "\n";
+                   << bucket << "\"} " << cumulative_count(stats, bucket) << "\n";
         }
         
         output << "hft_" << sanitized_name << "_histogram_bucket{le=\"+Inf\"} " << stats.count << "\n";
@@ -316,6 +386,29 @@ private:
         output << "# HELP hft_" << sanitized_name << "_p99_ns 99th percentile latency\n";
         output << "# TYPE hft_" << sanitized_name << "_p99_ns gauge\n";
         output << "hft_" << sanitized_name << "_p99_ns " << stats.p99 << "\n";
+        
+        output << "# HELP hft_" << sanitized_name << "_p999_ns 99.9th percentile latency\n";
+        output << "# TYPE hft_" << sanitized_name << "_p999_ns gauge\n";
+        output << "hft_" << sanitized_name << "_p999_ns " << stats.p999 << "\n";
+        
+        output << "# HELP hft_" << sanitized_name << "_p9999_ns 99.99th percentile latency\n";
+        output << "# TYPE hft_" << sanitized_name << "_p9999_ns gauge\n";
+        output << "hft_" << sanitized_name << "_p9999_ns " << stats.p9999 << "\n";
+    }
+    
+    // Cumulative count for an "le" bucket. Locally collected metrics carry the
+    // full histogram (exact to its <1.6% bucket resolution); metrics relayed
+    // through the aggregator only have percentiles, so those are estimated.
+    static uint64_t cumulative_count(const MetricStats& stats, uint64_t le) {
+        if (!stats.histogram.empty()) {
+            return stats.histogram.count_at_or_below(le);
+        }
+        if (stats.count == 0 || le < stats.min_value) return 0;
+        if (le >= stats.max_value || le >= stats.p99) return stats.count;
+        if (le >= stats.p95) return stats.count * 95 / 100;
+        if (le >= stats.p90) return stats.count * 90 / 100;
+        if (le >= stats.p50) return stats.count * 50 / 100;
+        return 0;
     }
     
     static std::string sanitize_metric_name(const std::string& name) {
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+
+// Fixed-capacity sliding window over doubles for per-tick strategy state.
+// push() is O(1): values live in a ring buffer, mean/variance are updated
+// incrementally (Welford, with removal of the evicted value), and min/max come
+// from monotonic queues (amortized O(1)). The EWMA runs over every pushed
+// value, independent of the window length. Storage is allocated by reset()
+// only, never on push.
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity = 1, double ewma_alpha = 0.0) {
+        ewma_alpha_ = ewma_alpha;
+        reset(capacity);
+    }
+
+    // Clears the window and sets a new capacity (at least 1)
+    void reset(size_t capacity) {
+        capacity_ = std::max<size_t>(capacity, 1);
+        values_.assign(capacity_, 0.0);
+        min_queue_.assign(capacity_, 0);
+        max_queue_.assign(capacity_, 0);
+        clear();
+    }
+
+    void clear() {
+        pushed_ = 0;
+        count_ = 0;
+        mean_ = 0.0;
+        m2_ = 0.0;
+        min_head_ = min_size_ = 0;
+        max_head_ = max_size_ = 0;
+        ewma_ = 0.0;
+    }
+
+    void set_ewma_alpha(double alpha) { ewma_alpha_ = alpha; }
+
+    void push(double value) {
+        ewma_ = pushed_ == 0 ? value : ewma_ + ewma_alpha_ * (value - ewma_);
+
+        if (count_ == capacity_) {
+            double evicted = values_[slot(pushed_ - capacity_)];
+            double old_mean = mean_;
+            mean_ += (value - evicted) / count_;
+            m2_ += (value - evicted) * (value - mean_ + evicted - old_mean);
+        } else {
+            ++count_;
+            double delta = value - mean_;
+            mean_ += delta / count_;
+            m2_ += delta * (value - mean_);
+        }
+        values_[slot(pushed_)] = value;
+
+        // Drop queue entries that left the window or can no longer be the extreme
+        uint64_t oldest = pushed_ + 1 - count_;
+        push_monotonic(min_queue_, min_head_, min_size_, oldest, [this, value](uint64_t seq) {
+            return values_[slot(seq)] >= value;
+        });
+        push_monotonic(max_queue_, max_head_, max_size_, oldest, [this, value](uint64_t seq) {
+            return values_[slot(seq)] <= value;
+        });
+        ++pushed_;
+
+        // Removal updates accumulate rounding error; re-sum now and then
+        if (pushed_ % (capacity_ * RESYNC_INTERVAL) == 0) {
+            resync();
+        }
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == capacity_; }
+
+    // 0 = oldest value in the window
+    double operator[](size_t index) const { return values_[slot(pushed_ - count_ + index)]; }
+    double front() const { return (*this)[0]; }
+    double back() const { return values_[slot(pushed_ - 1)]; }
+
+    double mean() const { return mean_; }
+    double sum() const { return mean_ * count_; }
+    double variance() const { return count_ > 0 ? std::max(m2_ / count_, 0.0) : 0.0; }  // Population
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return values_[slot(min_queue_[min_head_])]; }
+    double max() const { return values_[slot(max_queue_[max_head_])]; }
+    double ewma() const { return ewma_; }
+
+    // Standard score against the window; 0 while fewer than two values
+    double z_score(double value) const {
+        double sd = count_ >= 2 ? stddev() : 0.0;
+        return sd > 0.0 ? (value - mean_) / sd : 0.0;
+    }
+
+private:
+    static constexpr uint64_t RESYNC_INTERVAL = 1024;   // Windows between exact re-sums
+
+    std::vector<double> values_;
+    size_t capacity_ = 1;
+    uint64_t pushed_ = 0;     // Values ever pushed; value n lives in slot(n)
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;         // Sum of squared deviations from the mean
+    double ewma_ = 0.0;
+    double ewma_alpha_ = 0.0;
+
+    // Ring-buffered deques of sequence numbers; values are monotonic from head
+    std::vector<uint64_t> min_queue_;
+    std::vector<uint64_t> max_queue_;
+    size_t min_head_ = 0, min_size_ = 0;
+    size_t max_head_ = 0, max_size_ = 0;
+
+    size_t slot(uint64_t seq) const { return static_cast<size_t>(seq % capacity_); }
+
+    template<typename Dominated>
+    void push_monotonic(std::vector<uint64_t>& queue, size_t& head, size_t& size,
+                        uint64_t oldest, Dominated dominated) {
+        while (size > 0 && queue[head] < oldest) {
+            head = (head + 1) % capacity_;
+            --size;
+        }
+        while (size > 0 && dominated(queue[(head + size - 1) % capacity_])) {
+            --size;
+        }
+        queue[(head + size) % capacity_] = pushed_;
+        ++size;
+    }
+
+    void resync() {
+        double sum = 0.0;
+        for (size_t i = 0; i < count_; ++i) sum += (*this)[i];
+        mean_ = sum / count_;
+        double m2 = 0.0;
+        for (size_t i = 0; i < count_; ++i) {
+            double d = (*this)[i] - mean_;
+            m2 += d * d;
+        }
+        m2_ = m2;
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,434 @@
+#include "sampling_profiler.h"
+#include "cpu_topology.h"
+#include "high_res_timer.h"
+#include "message_types.h"
+#include "static_config.h"
+#include "transport_interface.h"
+#include "zmq_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+namespace {
+
+constexpr size_t MAX_THREADS = 64;
+constexpr size_t RING_SIZE = 512;             // Per thread: half a second at 999Hz, drained every 20ms
+constexpr size_t MAX_DEPTH = 32;
+constexpr int SKIPPED_FRAMES = 2;             // The handler and the signal trampoline
+constexpr int MAX_HZ = 10000;
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+struct Sample {
+    uint64_t tsc;
+    uint32_t depth;
+    void* pcs[MAX_DEPTH];     // Innermost first; pcs[0] is the interrupted instruction
+};
+
+// One per sampled thread; that thread's signal handler is the only producer
+struct ThreadRing {
+    std::atomic<pid_t> tid{0};
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};   // Ring full when the signal came
+    Sample samples[RING_SIZE];
+};
+
+// Allocated by the first window and kept: a thread holds on to its ring
+// pointer for life, so a ring is only reused once its thread has exited
+ThreadRing* g_rings = nullptr;
+std::atomic<bool> g_sampling{false};
+std::atomic<uint64_t> g_unringed{0};    // Samples from threads beyond MAX_THREADS
+thread_local ThreadRing* tls_ring = nullptr;
+
+pid_t current_tid() {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+ThreadRing* claim_ring() {
+    pid_t tid = current_tid();
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+        pid_t expected = 0;
+        if (g_rings[i].tid.load(std::memory_order_relaxed) == 0 &&
+            g_rings[i].tid.compare_exchange_strong(expected, tid, std::memory_order_acq_rel)) {
+            return &g_rings[i];
+        }
+    }
+    return nullptr;
+}
+
+// Async-signal-safe except for backtrace(), whose unwinder is loaded by a
+// call outside the handler before the handler is installed
+void on_sigprof(int, siginfo_t*, void*) {
+    if (!g_sampling.load(std::memory_order_relaxed)) return;
+    int saved_errno = errno;
+
+    ThreadRing* ring = tls_ring;
+    if (!ring) ring = tls_ring = claim_ring();
+    if (!ring) {
+        g_unringed.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            Sample& sample = ring->samples[head & (RING_SIZE - 1)];
+            sample.tsc = HighResTimer::get_ticks();
+            void* frames[MAX_DEPTH + SKIPPED_FRAMES];
+            int depth = backtrace(frames, static_cast<int>(MAX_DEPTH + SKIPPED_FRAMES)) - SKIPPED_FRAMES;
+            depth = std::max(depth, 0);
+            std::memcpy(sample.pcs, frames + SKIPPED_FRAMES, static_cast<size_t>(depth) * sizeof(void*));
+            sample.depth = static_cast<uint32_t>(depth);
+            ring->head.store(head + 1, std::memory_order_release);
+        }
+    }
+    errno = saved_errno;
+}
+
+bool thread_alive(pid_t tid) {
+    return access(("/proc/self/task/" + std::to_string(tid)).c_str(), F_OK) == 0;
+}
+
+std::string thread_name(pid_t tid) {
+    std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+    std::string name;
+    if (!std::getline(comm, name) || name.empty()) name = "thread";
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name + "-" + std::to_string(tid);
+}
+
+// Everything the collector has taken off the rings in one window
+struct Profile {
+    std::map<std::vector<void*>, uint32_t> stack_ids;
+    std::vector<std::vector<void*>> stacks;
+    std::map<std::pair<pid_t, uint32_t>, uint64_t> counts;
+    std::unordered_map<pid_t, std::string> threads;
+
+    struct Entry {
+        uint64_t tsc;
+        pid_t tid;
+        uint32_t stack;
+    };
+    std::vector<Entry> timeline;
+};
+
+void drain(Profile& profile) {
+    std::vector<void*> stack;
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+        ThreadRing& ring = g_rings[i];
+        pid_t tid = ring.tid.load(std::memory_order_acquire);
+        if (tid == 0) continue;
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail == head) continue;
+
+        // Named while the thread is still there to ask
+        if (profile.threads.find(tid) == profile.threads.end()) {
+            profile.threads.emplace(tid, thread_name(tid));
+        }
+        for (; tail != head; ++tail) {
+            const Sample& sample = ring.samples[tail & (RING_SIZE - 1)];
+            stack.assign(sample.pcs, sample.pcs + sample.depth);
+            auto [it, added] = profile.stack_ids.emplace(stack, static_cast<uint32_t>(profile.stacks.size()));
+            if (added) profile.stacks.push_back(stack);
+            profile.counts[{tid, it->second}]++;
+            profile.timeline.push_back({sample.tsc, tid, it->second});
+        }
+        ring.tail.store(head, std::memory_order_release);
+    }
+}
+
+// Function name, or module+0xoffset when the symbol isn't exported. Return
+// addresses are looked up one byte back, inside the calling function.
+std::string frame_name(void* pc, bool return_address) {
+    char* address = static_cast<char*>(pc) - (return_address ? 1 : 0);
+    Dl_info info{};
+    if (dladdr(address, &info) == 0) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "0x%lx", reinterpret_cast<unsigned long>(address));
+        return text;
+    }
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+        // Semicolons separate frames in the folded format
+        std::replace(name.begin(), name.end(), ';', ':');
+        return name;
+    }
+    const char* module = info.dli_fname ? std::strrchr(info.dli_fname, '/') : nullptr;
+    module = module ? module + 1 : (info.dli_fname ? info.dli_fname : "?");
+    char offset[32];
+    std::snprintf(offset, sizeof(offset), "+0x%lx",
+                  static_cast<unsigned long>(address - static_cast<char*>(info.dli_fbase)));
+    return std::string(module) + offset;
+}
+
+// Base path of the two files written
+std::string write_profile(const std::string& service, const Profile& profile, uint64_t dropped) {
+    std::string directory = StaticConfig::get_profiler_directory();
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "[SamplingProfiler] Cannot create " << directory << ": " << ec.message() << std::endl;
+        return "";
+    }
+    std::string base = directory + "/" + service + "-" + std::to_string(getpid()) + "-" +
+                       std::to_string(std::time(nullptr));
+
+    // Each distinct stack is named once, outermost frame first
+    std::unordered_map<void*, std::string> names;
+    std::vector<std::string> folded(profile.stacks.size());
+    for (size_t id = 0; id < profile.stacks.size(); ++id) {
+        const auto& stack = profile.stacks[id];
+        std::string text;
+        for (size_t i = stack.size(); i-- > 0;) {
+            void* key = static_cast<char*>(stack[i]) + (i > 0 ? 1 : 0);   // Leaf and callers never collide
+            auto it = names.find(key);
+            if (it == names.end()) it = names.emplace(key, frame_name(stack[i], i > 0)).first;
+            if (!text.empty()) text += ';';
+            text += it->second;
+        }
+        folded[id] = text.empty() ? "[unknown]" : text;
+    }
+
+    std::ofstream stacks(base + ".folded");
+    for (const auto& [key, count] : profile.counts) {
+        stacks << profile.threads.at(key.first) << ';' << folded[key.second] << ' ' << count << '\n';
+    }
+    std::ofstream samples(base + ".samples");
+    samples << "# tsc wall_ns thread stack\n";
+    for (const auto& entry : profile.timeline) {
+        samples << entry.tsc << ' ' << HighResTimer::ticks_to_wall_nanoseconds(entry.tsc) << ' '
+                << profile.threads.at(entry.tid) << ' ' << folded[entry.stack] << '\n';
+    }
+    if (!stacks || !samples) {
+        std::cerr << "[SamplingProfiler] Failed to write " << base << ".{folded,samples}" << std::endl;
+        return "";
+    }
+
+    std::cerr << "[SamplingProfiler] " << profile.timeline.size() << " samples from " << profile.threads.size()
+              << " threads (" << dropped << " dropped) written to " << base << ".{folded,samples}" << std::endl;
+    return base;
+}
+
+} // namespace
+
+SamplingProfiler& SamplingProfiler::instance() {
+    static SamplingProfiler profiler;
+    return profiler;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop_control_listener();
+    stop();
+}
+
+bool SamplingProfiler::parse_options(const std::string& spec, Options& options, std::string& error) {
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        size_t end = spec.find_first_of(" \t\r\n,;&", pos);
+        if (end == std::string::npos) end = spec.size();
+        std::string item = spec.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) continue;
+
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            error = "expected key=value, got " + item;
+            return false;
+        }
+        std::string key = item.substr(0, equals);
+        std::string value = item.substr(equals + 1);
+        char* parsed_end = nullptr;
+        long number = std::strtol(value.c_str(), &parsed_end, 10);
+        if (value.empty() || *parsed_end != '\0') {
+            error = "bad value for " + key + ": " + value;
+            return false;
+        }
+        if (key == "seconds") {
+            options.seconds = static_cast<int>(std::min<long>(number, INT_MAX));
+        } else if (key == "hz") {
+            options.hz = static_cast<int>(std::min<long>(number, INT_MAX));
+        } else {
+            error = "unknown parameter " + key;
+            return false;
+        }
+    }
+    if (options.seconds <= 0 || options.hz <= 0 || options.hz > MAX_HZ) {
+        error = "seconds must be positive and hz in 1.." + std::to_string(MAX_HZ);
+        return false;
+    }
+    return true;
+}
+
+bool SamplingProfiler::start(const std::string& service, const Options& options, std::string& error) {
+    std::lock_guard<std::mutex> control(control_mutex_);
+    if (active()) {
+        error = "a profile is already running";
+        return false;
+    }
+    if (collector_.joinable()) collector_.join();
+
+    if (!g_rings) {
+        g_rings = new ThreadRing[MAX_THREADS];
+        // Loads the unwinder here rather than in the first signal
+        void* frames[4];
+        backtrace(frames, 4);
+        // Stays installed: a SIGPROF still in flight after a window closes
+        // must not meet the default action, which ends the process
+        struct sigaction action{};
+        action.sa_sigaction = on_sigprof;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            error = std::string("sigaction: ") + std::strerror(errno);
+            return false;
+        }
+    }
+
+    // Rings of exited threads go back to the pool; the rest start empty
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+        ThreadRing& ring = g_rings[i];
+        pid_t tid = ring.tid.load(std::memory_order_acquire);
+        if (tid != 0 && !thread_alive(tid)) {
+            ring.head.store(0, std::memory_order_relaxed);
+            ring.tail.store(0, std::memory_order_relaxed);
+            ring.tid.store(0, std::memory_order_release);
+        } else {
+            ring.tail.store(ring.head.load(std::memory_order_acquire), std::memory_order_release);
+        }
+        ring.dropped.store(0, std::memory_order_relaxed);
+    }
+    g_unringed.store(0, std::memory_order_relaxed);
+
+    int seconds = std::min(options.seconds, std::max(1, StaticConfig::get_profiler_max_seconds()));
+    g_sampling.store(true, std::memory_order_release);
+    itimerval timer{};
+    timer.it_interval.tv_usec = std::max(1, 1'000'000 / options.hz);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        g_sampling.store(false, std::memory_order_release);
+        error = std::string("setitimer: ") + std::strerror(errno);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = false;
+    }
+    active_.store(true, std::memory_order_release);
+    collector_ = std::thread(&SamplingProfiler::run_window, this, service, seconds);
+    std::cerr << "[SamplingProfiler] Profiling " << service << " at " << options.hz << "Hz for "
+              << seconds << "s" << std::endl;
+    return true;
+}
+
+void SamplingProfiler::stop() {
+    std::lock_guard<std::mutex> control(control_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    wake_.notify_all();
+    if (collector_.joinable()) collector_.join();
+}
+
+std::string SamplingProfiler::last_output() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_output_;
+}
+
+void SamplingProfiler::run_window(std::string service, int seconds) {
+    if (!ThreadPlan::instance().pin_current_thread("profiler")) {
+        std::cerr << "[SamplingProfiler] Failed to pin profiler thread to its planned CPU" << std::endl;
+    }
+
+    Profile profile;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_requested_ && std::chrono::steady_clock::now() < deadline) {
+        wake_.wait_for(lock, DRAIN_INTERVAL);
+        lock.unlock();
+        drain(profile);
+        lock.lock();
+    }
+    lock.unlock();
+
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    g_sampling.store(false, std::memory_order_release);
+    drain(profile);
+
+    uint64_t dropped = g_unringed.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < MAX_THREADS; ++i) dropped += g_rings[i].dropped.load(std::memory_order_relaxed);
+    std::string base = write_profile(service, profile, dropped);
+
+    lock.lock();
+    last_output_ = base;
+    active_.store(false, std::memory_order_release);
+}
+
+void SamplingProfiler::start_control_listener(const std::string& service) {
+    if (listening_.exchange(true)) return;
+    listener_ = std::thread(&SamplingProfiler::listen, this, service);
+}
+
+void SamplingProfiler::stop_control_listener() {
+    if (!listening_.exchange(false)) return;
+    if (listener_.joinable()) listener_.join();
+}
+
+void SamplingProfiler::listen(std::string service) {
+    std::unique_ptr<IMessageSubscriber> subscriber;
+    try {
+        TransportConfig config = zmq_subscriber_config(
+            "tcp://localhost:" + std::to_string(StaticConfig::get_control_commands_port()));
+        config.high_water_mark = 100;
+        subscriber = TransportFactory::open_subscriber(config);
+    } catch (const std::exception& e) {
+        std::cerr << "[SamplingProfiler] No control endpoint, profiling unavailable: " << e.what() << std::endl;
+        return;
+    }
+
+    while (listening_.load(std::memory_order_acquire)) {
+        ControlCommand command;
+        size_t size = sizeof(command);
+        if (subscriber->receive(&command, size, true) && size == sizeof(ControlCommand) &&
+            command.action == ControlAction::START_PROFILE) {
+            std::string target(command.target_service, strnlen(command.target_service, sizeof(command.target_service)));
+            if (target == service || target == "all") {
+                std::string spec(command.parameters, strnlen(command.parameters, sizeof(command.parameters)));
+                Options options;
+                std::string error;
+                if (!parse_options(spec, options, error) || !start(service, options, error)) {
+                    std::cerr << "[SamplingProfiler] Profile request (" << spec << ") refused: " << error << std::endl;
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(StaticConfig::get_control_poll_interval_ms()));
+    }
+    subscriber->close();
+}
+
+} // namespace hft
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace hft {
+
+// In-process CPU profiler, for boxes where attaching perf is not allowed.
+// While a window is open, ITIMER_PROF sends SIGPROF at the requested rate to
+// whichever thread is using CPU. The handler writes a backtrace into that
+// thread's own ring: claimed on its first sample, written only by that
+// thread and never locked. Each sample is stamped with HighResTimer ticks,
+// the clock that MetricsCollector entries and traces use. A collector
+// thread ("profiler") drains the rings. When the window closes it writes
+//   <profiler.directory>/<service>-<pid>-<unix time>.folded
+//       one line per stack and count, rooted at the thread name, for
+//       flamegraph.pl
+//   <profiler.directory>/<service>-<pid>-<unix time>.samples
+//       one line per sample: tsc wall_ns thread stack, to line samples up
+//       with a latency spike
+// Frames are named through dladdr (the services export their symbols for
+// it); anything else is written as module+0xoffset for addr2line.
+//
+// The handler is installed by the first window and left in place; between
+// windows the timer is off and nothing is sampled.
+class SamplingProfiler {
+public:
+    struct Options {
+        int hz = 999;          // Off the round numbers periodic work runs at
+        int seconds = 10;      // Capped at profiler.max_seconds
+    };
+
+    static SamplingProfiler& instance();
+
+    // "seconds=<n> hz=<n>", either or neither, in any order; pairs may also be
+    // separated by commas, semicolons or '&'
+    static bool parse_options(const std::string& spec, Options& options, std::string& error);
+
+    // Opens a window for service; false with a reason if one is already open
+    // or the timer can't be armed
+    bool start(const std::string& service, const Options& options, std::string& error);
+
+    // Closes the open window early and writes its files
+    void stop();
+
+    bool active() const { return active_.load(std::memory_order_acquire); }
+
+    // Base path (no extension) of the files the last closed window wrote
+    std::string last_output() const;
+
+    // Opens a window on each ControlAction::START_PROFILE whose target is
+    // service or "all", from a thread of its own
+    void start_control_listener(const std::string& service);
+    void stop_control_listener();
+
+    ~SamplingProfiler();
+
+private:
+    SamplingProfiler() = default;
+
+    void run_window(std::string service, int seconds);
+    void listen(std::string service);
+
+    std::mutex control_mutex_;    // Serializes start and stop
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> active_{false};
+    bool stop_requested_ = false;
+    std::thread collector_;
+    std::string last_output_;
+
+    std::atomic<bool> listening_{false};
+    std::thread listener_;
+};
+
+} // namespace hft
@@ -0,0 +1,588 @@
+#include "shm_transport.h"
+#include "cpu_affinity.h"
+#include <iostream>
+#include <new>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace hft {
+
+namespace shm {
+
+uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace shm
+
+namespace {
+
+constexpr size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 4096;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+bool process_alive(int32_t pid) {
+    if (pid <= 0) return false;
+    return ::kill(pid, 0) == 0 || errno == EPERM;
+}
+
+} // namespace
+
+ShmTransport::ShmTransport() = default;
+
+ShmTransport::~ShmTransport() {
+    close();
+}
+
+bool ShmTransport::initialize(const TransportConfig& config) {
+    if (initialized_.load()) return true;
+
+    endpoint_ = config.endpoint;
+    requested_size_ = round_up_pow2(config.buffer_size);
+    use_huge_pages_ = config.huge_pages;
+    slow_consumer_timeout_ns_ = static_cast<uint64_t>(config.slow_consumer_timeout_ms) * 1000000ULL;
+
+    initialized_.store(true);
+    return true;
+}
+
+std::string ShmTransport::segment_name(const std::string& endpoint) {
+    std::string name = endpoint;
+    const std::string scheme = "shm://";
+    if (name.compare(0, scheme.size(), scheme) == 0) {
+        name = name.substr(scheme.size());
+    }
+    for (char& c : name) {
+        if (c == '/') c = '_';
+    }
+    return "hft_" + name;
+}
+
+bool ShmTransport::bind(const std::string& endpoint) {
+    if (!initialized_.load() || connected_.load()) return false;
+
+    endpoint_ = endpoint;
+    is_producer_ = true;
+    is_consumer_ = false;
+
+    if (!map_segment(segment_name(endpoint), true)) {
+        return false;
+    }
+
+    cached_min_read_ = header_->write_pos.load(std::memory_order_acquire);
+    connected_.store(true);
+
+    std::cout << "[ShmTransport] Producer bound " << endpoint << " (" << capacity_ << " byte ring"
+              << (huge_pages_mapped_ ? ", huge pages" : "") << ")" << std::endl;
+    return true;
+}
+
+bool ShmTransport::connect(const std::string& endpoint) {
+    if (!initialized_.load() || connected_.load()) return false;
+
+    // Reconnecting after an eviction: hand back the old slot and mapping
+    if (header_) {
+        release_slot();
+        unmap_segment();
+    }
+
+    endpoint_ = endpoint;
+    is_producer_ = false;
+    is_consumer_ = true;
+
+    if (!map_segment(segment_name(endpoint), false)) {
+        return false;
+    }
+
+    if (!claim_slot()) {
+        std::cerr << "[ShmTransport] No free consumer slot on " << endpoint << std::endl;
+        unmap_segment();
+        return false;
+    }
+
+    evicted_.store(false);
+    connected_.store(true);
+    return true;
+}
+
+bool ShmTransport::map_segment(const std::string& name, bool create) {
+    shm_name_ = "/" + name;
+    hugepage_path_ = "/dev/hugepages/" + name;
+
+    int fd = -1;
+    huge_pages_mapped_ = false;
+
+    if (use_huge_pages_) {
+        fd = ::open(hugepage_path_.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0660);
+        if (fd >= 0) {
+            huge_pages_mapped_ = true;
+        } else if (create) {
+            std::cerr << "[ShmTransport] hugetlbfs unavailable at " << hugepage_path_
+                      << ", falling back to /dev/shm" << std::endl;
+        }
+    }
+    if (fd < 0) {
+        fd = ::shm_open(shm_name_.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0660);
+    }
+    if (fd < 0) {
+        if (create) {
+            std::cerr << "[ShmTransport] shm_open(" << shm_name_ << ") failed: " << std::strerror(errno) << std::endl;
+        }
+        return false;
+    }
+
+    const size_t header_size = align_up(sizeof(shm::SegmentHeader), 4096);
+    size_t total_size = 0;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (create) {
+        total_size = header_size + requested_size_;
+        if (huge_pages_mapped_) total_size = align_up(total_size, shm::HUGE_PAGE_SIZE);
+
+        // Reuse a compatible segment so attached consumers survive a producer restart
+        bool reuse = static_cast<size_t>(st.st_size) == total_size;
+        if (!reuse && ::ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+            std::cerr << "[ShmTransport] ftruncate failed: " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        void* addr = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            std::cerr << "[ShmTransport] mmap failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        header_ = static_cast<shm::SegmentHeader*>(addr);
+        mapped_size_ = total_size;
+
+        reuse = reuse &&
+                header_->magic.load(std::memory_order_acquire) == shm::SEGMENT_MAGIC &&
+                header_->version == shm::SEGMENT_VERSION &&
+                header_->capacity == requested_size_;
+
+        if (!reuse) {
+            new (header_) shm::SegmentHeader();
+            header_->version = shm::SEGMENT_VERSION;
+            header_->max_consumers = shm::MAX_CONSUMERS;
+            header_->capacity = requested_size_;
+            header_->data_offset = header_size;
+            header_->write_pos.store(0, std::memory_order_relaxed);
+            header_->slow_consumer_evictions.store(0, std::memory_order_relaxed);
+            header_->sequence.store(0, std::memory_order_relaxed);
+            for (auto& slot : header_->consumers) {
+                slot.read_pos.store(0, std::memory_order_relaxed);
+                slot.heartbeat_ns.store(0, std::memory_order_relaxed);
+                slot.messages.store(0, std::memory_order_relaxed);
+                slot.pid.store(0, std::memory_order_relaxed);
+                slot.state.store(shm::SLOT_FREE, std::memory_order_relaxed);
+            }
+        }
+        header_->producer_pid = static_cast<int32_t>(::getpid());
+        header_->magic.store(shm::SEGMENT_MAGIC, std::memory_order_release);
+    } else {
+        if (static_cast<size_t>(st.st_size) < header_size) {
+            ::close(fd);
+            return false;  // Producer has not sized the segment yet
+        }
+        total_size = static_cast<size_t>(st.st_size);
+
+        void* addr = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            std::cerr << "[ShmTransport] mmap failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        header_ = static_cast<shm::SegmentHeader*>(addr);
+        mapped_size_ = total_size;
+
+        if (header_->magic.load(std::memory_order_acquire) != shm::SEGMENT_MAGIC ||
+            header_->version != shm::SEGMENT_VERSION ||
+            header_->data_offset + header_->capacity > total_size) {
+            unmap_segment();
+            return false;  // Not initialized yet or incompatible layout
+        }
+    }
+
+    capacity_ = header_->capacity;
+    mask_ = capacity_ - 1;
+    data_ = reinterpret_cast<char*>(header_) + header_->data_offset;
+    return true;
+}
+
+void ShmTransport::unmap_segment() {
+    if (header_) {
+        ::munmap(header_, mapped_size_);
+    }
+    header_ = nullptr;
+    data_ = nullptr;
+    mapped_size_ = 0;
+    capacity_ = 0;
+    mask_ = 0;
+}
+
+bool ShmTransport::claim_slot() {
+    const int32_t pid = static_cast<int32_t>(::getpid());
+
+    for (uint32_t i = 0; i < shm::MAX_CONSUMERS; ++i) {
+        auto& slot = header_->consumers[i];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+
+        // A slot whose owner died without detaching can be reclaimed. A free
+        // slot's pid is always 0, so a CLAIMING one still at 0 belongs to a
+        // live claimant that has not written its pid yet.
+        int32_t owner = slot.pid.load(std::memory_order_acquire);
+        if (state != shm::SLOT_FREE) {
+            if ((state == shm::SLOT_CLAIMING && owner == 0) || process_alive(owner)) continue;
+        }
+
+        // Take the slot before touching it, so a losing claimant never
+        // overwrites the winner's pid or cursor: CLAIMING keeps the producer
+        // off it, and the pid swap decides between reclaimers of a dead one
+        if (state != shm::SLOT_CLAIMING &&
+            !slot.state.compare_exchange_strong(state, shm::SLOT_CLAIMING, std::memory_order_acq_rel)) {
+            continue;
+        }
+        if (!slot.pid.compare_exchange_strong(owner, pid, std::memory_order_acq_rel)) continue;
+        slot.heartbeat_ns.store(shm::monotonic_ns(), std::memory_order_relaxed);
+        slot.messages.store(0, std::memory_order_relaxed);
+        slot.read_pos.store(header_->write_pos.load(std::memory_order_acquire), std::memory_order_relaxed);
+        slot.state.store(shm::SLOT_ACTIVE, std::memory_order_release);
+
+        // Producer may have advanced while we claimed; start from the latest position
+        read_pos_ = header_->write_pos.load(std::memory_order_acquire);
+        slot.read_pos.store(read_pos_, std::memory_order_release);
+        slot_ = i;
+        heartbeat_countdown_ = HEARTBEAT_INTERVAL;
+        return true;
+    }
+    return false;
+}
+
+void ShmTransport::release_slot() {
+    if (!header_ || slot_ >= shm::MAX_CONSUMERS) return;
+
+    auto& slot = header_->consumers[slot_];
+    slot.pid.store(0, std::memory_order_relaxed);
+    slot.state.store(shm::SLOT_FREE, std::memory_order_release);
+    slot_ = UINT32_MAX;
+}
+
+void ShmTransport::close() {
+    stop_async_receive();
+
+    if (is_consumer_) {
+        release_slot();
+    }
+    unmap_segment();
+
+    connected_.store(false);
+    initialized_.store(false);
+}
+
+bool ShmTransport::unlink_segment(const std::string& endpoint) {
+    std::string name = segment_name(endpoint);
+    bool removed = ::shm_unlink(("/" + name).c_str()) == 0;
+    removed |= ::unlink(("/dev/hugepages/" + name).c_str()) == 0;
+    return removed;
+}
+
+uint64_t ShmTransport::compute_min_read_position() {
+    uint64_t write_pos = header_->write_pos.load(std::memory_order_relaxed);
+    uint64_t min_pos = write_pos;
+
+    for (const auto& slot : header_->consumers) {
+        if (slot.state.load(std::memory_order_acquire) != shm::SLOT_ACTIVE) continue;
+        uint64_t pos = slot.read_pos.load(std::memory_order_acquire);
+        if (pos < min_pos) min_pos = pos;
+    }
+
+    cached_min_read_ = min_pos;
+    return min_pos;
+}
+
+uint32_t ShmTransport::evict_slow_consumers() {
+    if (!header_) return 0;
+
+    uint64_t now = shm::monotonic_ns();
+    uint64_t write_pos = header_->write_pos.load(std::memory_order_relaxed);
+    uint32_t evicted = 0;
+
+    for (uint32_t i = 0; i < shm::MAX_CONSUMERS; ++i) {
+        auto& slot = header_->consumers[i];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state != shm::SLOT_ACTIVE) continue;
+
+        // Only consumers that are actually behind can be holding us back
+        if (slot.read_pos.load(std::memory_order_acquire) == write_pos) continue;
+
+        uint64_t heartbeat = slot.heartbeat_ns.load(std::memory_order_relaxed);
+        bool stale = now > heartbeat && now - heartbeat > slow_consumer_timeout_ns_;
+        bool dead = !process_alive(slot.pid.load(std::memory_order_relaxed));
+
+        if ((stale || dead) &&
+            slot.state.compare_exchange_strong(state, shm::SLOT_EVICTED, std::memory_order_acq_rel)) {
+            header_->slow_consumer_evictions.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "[ShmTransport] Evicted " << (dead ? "dead" : "slow") << " consumer slot " << i
+                      << " (pid " << slot.pid.load(std::memory_order_relaxed) << ", lag "
+                      << (write_pos - slot.read_pos.load(std::memory_order_relaxed)) << " bytes)" << std::endl;
+            ++evicted;
+        }
+    }
+    return evicted;
+}
+
+bool ShmTransport::reserve(size_t record_size, bool non_blocking, uint64_t& write_pos) {
+    write_pos = header_->write_pos.load(std::memory_order_relaxed);
+
+    // Space needed includes the tail skipped when the record would cross the end
+    size_t tail = capacity_ - (write_pos & mask_);
+    size_t needed = record_size > tail ? tail + record_size : record_size;
+
+    if (write_pos + needed - cached_min_read_ <= capacity_) return true;
+
+    uint64_t deadline = 0;
+    while (true) {
+        if (write_pos + needed - compute_min_read_position() <= capacity_) return true;
+
+        // Full because of a laggard: see whether it is stalled or gone
+        if (evict_slow_consumers() > 0) continue;
+
+        if (non_blocking) return false;
+
+        uint64_t now = shm::monotonic_ns();
+        if (deadline == 0) {
+            deadline = now + slow_consumer_timeout_ns_;
+        } else if (now > deadline) {
+            return false;
+        }
+        CPUAffinity::cpu_pause();
+    }
+}
+
+bool ShmTransport::send(const void* data, size_t size, bool non_blocking) {
+    return send_parts(nullptr, 0, data, size, non_blocking);
+}
+
+bool ShmTransport::send_parts(const void* prefix, size_t prefix_size, const void* data, size_t size, bool non_blocking) {
+    if (!is_producer_ || !connected_.load(std::memory_order_relaxed)) return false;
+
+    size_t payload_size = prefix_size + size;
+    size_t record_size = align_up(sizeof(shm::RecordHeader) + payload_size, shm::RECORD_ALIGN);
+    if (record_size > capacity_ / 4) return false;  // Max 25% of ring per message
+
+    uint64_t write_pos = 0;
+    if (!reserve(record_size, non_blocking, write_pos)) {
+        send_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t ring_pos = write_pos & mask_;
+    size_t tail = capacity_ - ring_pos;
+    if (record_size > tail) {
+        // Fill the tail with a padding record; tails shorter than a header are skipped implicitly
+        if (tail >= sizeof(shm::RecordHeader)) {
+            auto* pad = reinterpret_cast<shm::RecordHeader*>(data_ + ring_pos);
+            pad->size = 0;
+            pad->flags = shm::RECORD_PADDING;
+            pad->sequence = 0;
+        }
+        write_pos += tail;
+        ring_pos = 0;
+    }
+
+    auto* record = reinterpret_cast<shm::RecordHeader*>(data_ + ring_pos);
+    record->size = static_cast<uint32_t>(payload_size);
+    record->flags = 0;
+    record->sequence = header_->sequence.fetch_add(1, std::memory_order_relaxed);
+
+    char* payload = reinterpret_cast<char*>(record + 1);
+    if (prefix_size > 0) std::memcpy(payload, prefix, prefix_size);
+    if (size > 0) std::memcpy(payload + prefix_size, data, size);
+
+    header_->write_pos.store(write_pos + record_size, std::memory_order_release);
+
+    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(payload_size, std::memory_order_relaxed);
+    return true;
+}
+
+void ShmTransport::touch_heartbeat() {
+    header_->consumers[slot_].heartbeat_ns.store(shm::monotonic_ns(), std::memory_order_relaxed);
+    heartbeat_countdown_ = HEARTBEAT_INTERVAL;
+}
+
+const char* ShmTransport::peek_next(uint32_t& size) {
+    if (!is_consumer_ || !connected_.load(std::memory_order_relaxed)) return nullptr;
+
+    auto& slot = header_->consumers[slot_];
+    if (slot.state.load(std::memory_order_relaxed) != shm::SLOT_ACTIVE) {
+        if (!evicted_.exchange(true)) {
+            std::cerr << "[ShmTransport] Consumer slot " << slot_ << " on " << endpoint_
+                      << " was evicted as a slow consumer" << std::endl;
+        }
+        connected_.store(false);
+        return nullptr;
+    }
+
+    while (true) {
+        uint64_t write_pos = header_->write_pos.load(std::memory_order_acquire);
+        if (read_pos_ == write_pos) {
+            touch_heartbeat();
+            return nullptr;
+        }
+
+        size_t ring_pos = read_pos_ & mask_;
+        size_t tail = capacity_ - ring_pos;
+        if (tail < sizeof(shm::RecordHeader)) {
+            read_pos_ += tail;
+            continue;
+        }
+
+        const auto* record = reinterpret_cast<const shm::RecordHeader*>(data_ + ring_pos);
+        if (record->flags & shm::RECORD_PADDING) {
+            read_pos_ += tail;
+            continue;
+        }
+
+        size = record->size;
+        pending_record_size_ = align_up(sizeof(shm::RecordHeader) + record->size, shm::RECORD_ALIGN);
+        return reinterpret_cast<const char*>(record + 1);
+    }
+}
+
+void ShmTransport::consume_current() {
+    read_pos_ += pending_record_size_;
+    pending_record_size_ = 0;
+
+    auto& slot = header_->consumers[slot_];
+    slot.read_pos.store(read_pos_, std::memory_order_release);
+    slot.messages.fetch_add(1, std::memory_order_relaxed);
+
+    if (--heartbeat_countdown_ == 0) {
+        touch_heartbeat();
+    }
+}
+
+const char* ShmTransport::next_accepted(uint32_t& size) {
+    while (true) {
+        const char* payload = peek_next(size);
+        if (!payload || accept_record(payload, size)) return payload;
+        consume_current();  // Filtered out without touching the payload
+    }
+}
+
+bool ShmTransport::receive(void* data, size_t& size, bool non_blocking) {
+    while (true) {
+        uint32_t record_size = 0;
+        const char* payload = next_accepted(record_size);
+        if (payload) {
+            if (size < record_size) return false;  // Buffer too small, record stays queued
+            std::memcpy(data, payload, record_size);
+            size = record_size;
+            consume_current();
+
+            messages_received_.fetch_add(1, std::memory_order_relaxed);
+            bytes_received_.fetch_add(record_size, std::memory_order_relaxed);
+            return true;
+        }
+        if (non_blocking || !connected_.load(std::memory_order_relaxed)) return false;
+        CPUAffinity::cpu_pause();
+    }
+}
+
+bool ShmSubscriber::accept_record(const char*& payload, uint32_t& size) {
+    if (topic_filter_.empty()) return true;
+
+    // Records are "topic\0payload"; compare in place and strip the prefix
+    size_t prefix = topic_filter_.size() + 1;
+    if (size < prefix || std::memcmp(payload, topic_filter_.c_str(), prefix) != 0) {
+        return false;
+    }
+    payload += prefix;
+    size -= static_cast<uint32_t>(prefix);
+    return true;
+}
+
+void ShmTransport::set_receive_callback(MessageCallback callback) {
+    receive_callback_ = callback;
+}
+
+void ShmTransport::start_async_receive() {
+    if (async_active_.load() || !receive_callback_ || !is_consumer_) return;
+
+    async_active_.store(true);
+    receive_thread_ = std::make_unique<std::thread>([this]() {
+        // Deliver straight from the mapping; the callback must not retain the pointer
+        while (async_active_.load(std::memory_order_relaxed) && connected_.load(std::memory_order_relaxed)) {
+            uint32_t record_size = 0;
+            const char* payload = next_accepted(record_size);
+            if (payload) {
+                receive_callback_(payload, record_size);
+                consume_current();
+                messages_received_.fetch_add(1, std::memory_order_relaxed);
+                bytes_received_.fetch_add(record_size, std::memory_order_relaxed);
+            } else {
+                CPUAffinity::cpu_pause();
+            }
+        }
+    });
+}
+
+void ShmTransport::stop_async_receive() {
+    async_active_.store(false);
+    if (receive_thread_ && receive_thread_->joinable()) {
+        receive_thread_->join();
+    }
+    receive_thread_.reset();
+}
+
+std::vector<shm::ConsumerInfo> ShmTransport::get_consumer_info() const {
+    std::vector<shm::ConsumerInfo> info;
+    if (!header_) return info;
+
+    uint64_t now = shm::monotonic_ns();
+    uint64_t write_pos = header_->write_pos.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < shm::MAX_CONSUMERS; ++i) {
+        const auto& slot = header_->consumers[i];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == shm::SLOT_FREE) continue;
+
+        uint64_t read_pos = slot.read_pos.load(std::memory_order_acquire);
+        uint64_t heartbeat = slot.heartbeat_ns.load(std::memory_order_relaxed);
+        info.push_back({i,
+                        slot.pid.load(std::memory_order_relaxed),
+                        state,
+                        write_pos > read_pos ? write_pos - read_pos : 0,
+                        now > heartbeat ? now - heartbeat : 0,
+                        slot.messages.load(std::memory_order_relaxed)});
+    }
+    return info;
+}
+
+uint64_t ShmTransport::get_slow_consumer_evictions() const {
+    return header_ ? header_->slow_consumer_evictions.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace hft
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "transport_interface.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <sys/types.h>
+
+namespace hft {
+
+// Cross-process SPMC ring living in a POSIX shared memory (or hugetlbfs) segment.
+// The producer binds "shm://<name>" and owns the segment; consumers in other
+// processes connect to the same name and claim a cursor slot in the segment.
+// Records never wrap: a padding record fills the tail so every payload is
+// contiguous in the mapping.
+namespace shm {
+
+constexpr uint64_t SEGMENT_MAGIC = 0x48465453484D5631ULL;  // "HFTSHMV1"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr uint32_t MAX_CONSUMERS = 16;
+constexpr size_t RECORD_ALIGN = 8;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Consumer slot states
+constexpr uint32_t SLOT_FREE = 0;
+constexpr uint32_t SLOT_ACTIVE = 1;
+constexpr uint32_t SLOT_EVICTED = 2;  // Producer gave up on this consumer
+constexpr uint32_t SLOT_CLAIMING = 3; // Taken by a joining consumer that is still filling it in
+
+// Record flags
+constexpr uint32_t RECORD_PADDING = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm cursors need lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shm slots need lock-free 32-bit atomics");
+
+struct alignas(64) ConsumerSlot {
+    std::atomic<uint64_t> read_pos;
+    std::atomic<uint64_t> heartbeat_ns;   // CLOCK_MONOTONIC, shared by all processes on the host
+    std::atomic<uint64_t> messages;
+    std::atomic<uint32_t> state;
+    std::atomic<int32_t> pid;
+};
+
+struct SegmentHeader {
+    std::atomic<uint64_t> magic;          // Stored last by the producer: segment is ready
+    uint32_t version;
+    uint32_t max_consumers;
+    uint64_t capacity;                    // Data bytes, power of 2
+    uint64_t data_offset;                 // Offset of the data region from segment start
+    int32_t producer_pid;
+
+    alignas(64) std::atomic<uint64_t> write_pos;
+    alignas(64) std::atomic<uint64_t> slow_consumer_evictions;
+    std::atomic<uint64_t> sequence;
+
+    ConsumerSlot consumers[MAX_CONSUMERS];
+};
+
+struct RecordHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint64_t sequence;
+};
+
+// Snapshot of one consumer cursor, for monitoring
+struct ConsumerInfo {
+    uint32_t slot;
+    int32_t pid;
+    uint32_t state;
+    uint64_t lag_bytes;
+    uint64_t heartbeat_age_ns;
+    uint64_t messages;
+};
+
+uint64_t monotonic_ns();
+
+} // namespace shm
+
+class ShmTransport : public virtual IMessageTransport {
+public:
+    ShmTransport();
+    virtual ~ShmTransport();
+
+    // IMessageTransport interface
+    bool initialize(const TransportConfig& config) override;
+    bool bind(const std::string& endpoint) override;      // Producer: create/own the segment
+    bool connect(const std::string& endpoint) override;   // Consumer: attach and claim a slot
+    void close() override;
+
+    bool send(const void* data, size_t size, bool non_blocking = false) override;
+    bool receive(void* data, size_t& size, bool non_blocking = false) override;
+
+    void set_receive_callback(MessageCallback callback) override;
+    void start_async_receive() override;
+    void stop_async_receive() override;
+
+    bool is_connected() const override { return connected_.load(); }
+    TransportType get_type() const override { return TransportType::SHARED_MEMORY; }
+    std::string get_endpoint() const override { return endpoint_; }
+
+    uint64_t get_messages_sent() const override { return messages_sent_.load(); }
+    uint64_t get_messages_received() const override { return messages_received_.load(); }
+    uint64_t get_bytes_sent() const override { return bytes_sent_.load(); }
+    uint64_t get_bytes_received() const override { return bytes_received_.load(); }
+
+    void* get_native_handle() override { return header_; }
+
+    // Gather-send: writes `prefix` then `data` as one record without staging
+    bool send_parts(const void* prefix, size_t prefix_size, const void* data, size_t size, bool non_blocking);
+
+    // Slow-consumer handling: consumers whose heartbeat is older than the
+    // configured timeout (or whose process is gone) are evicted so they
+    // cannot hold the producer back. Returns number evicted.
+    uint32_t evict_slow_consumers();
+    std::vector<shm::ConsumerInfo> get_consumer_info() const;
+    uint64_t get_slow_consumer_evictions() const;
+    uint64_t get_send_failures() const { return send_failures_.load(); }
+    bool was_evicted() const { return evicted_.load(); }
+
+    size_t capacity() const { return capacity_; }
+    bool uses_huge_pages() const { return huge_pages_mapped_; }
+
+    // Remove a segment left behind by a dead producer
+    static bool unlink_segment(const std::string& endpoint);
+
+protected:
+    // Consumer side: locate the next payload in place. Returns nullptr when
+    // the ring is empty. The pointer stays valid until consume_current().
+    const char* peek_next(uint32_t& size);
+    void consume_current();
+
+    // Consumer-side filter hook; may narrow payload/size to the part delivered
+    virtual bool accept_record(const char*& payload, uint32_t& size) {
+        (void)payload;
+        (void)size;
+        return true;
+    }
+
+    bool is_consumer_{false};
+    bool is_producer_{false};
+
+private:
+    bool map_segment(const std::string& name, bool create);
+    void unmap_segment();
+    bool claim_slot();
+    void release_slot();
+    uint64_t compute_min_read_position();
+    bool reserve(size_t record_size, bool non_blocking, uint64_t& write_pos);
+    void touch_heartbeat();
+    const char* next_accepted(uint32_t& size);
+
+    static std::string segment_name(const std::string& endpoint);
+
+    // Mapping
+    shm::SegmentHeader* header_{nullptr};
+    char* data_{nullptr};
+    size_t mapped_size_{0};
+    size_t capacity_{0};
+    size_t mask_{0};
+    std::string shm_name_;
+    std::string hugepage_path_;
+    bool huge_pages_mapped_{false};
+
+    // Configuration and state
+    std::string endpoint_;
+    size_t requested_size_{1024 * 1024};
+    bool use_huge_pages_{false};
+    uint64_t slow_consumer_timeout_ns_{1000000000ULL};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> initialized_{false};
+    std::atomic<bool> evicted_{false};
+
+    // Producer cache of the slowest cursor, refreshed only when the ring looks full
+    uint64_t cached_min_read_{0};
+
+    // Consumer cursor, mirrored into the shared slot after each record
+    uint32_t slot_{UINT32_MAX};
+    uint64_t read_pos_{0};
+    uint64_t pending_record_size_{0};
+    uint32_t heartbeat_countdown_{0};
+
+    // Statistics
+    std::atomic<uint64_t> messages_sent_{0};
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> send_failures_{0};
+
+    // Async receive
+    MessageCallback receive_callback_;
+    std::unique_ptr<std::thread> receive_thread_;
+    std::atomic<bool> async_active_{false};
+
+    static constexpr uint32_t HEARTBEAT_INTERVAL = 64;  // Records between heartbeat updates
+};
+
+// Shared-memory publisher (single producer)
+class ShmPublisher : public ShmTransport, public virtual IMessagePublisher {
+public:
+    bool publish(const void* data, size_t size) override {
+        return send(data, size, true);
+    }
+
+    // "topic\0payload" framing, gathered straight into the ring
+    bool publish(const std::string& topic, const void* data, size_t size) override {
+        return send_parts(topic.c_str(), topic.size() + 1, data, size, true);
+    }
+
+    void set_filter(const std::string& filter) override {
+        (void)filter;   // Filtering happens in each consumer, in place in the mapping
+    }
+};
+
+// Shared-memory subscriber (one of many consumers)
+class ShmSubscriber : public ShmTransport, public virtual IMessageSubscriber {
+public:
+    bool subscribe(const std::string& topic = "") override {
+        topic_filter_ = topic;
+        return true;
+    }
+
+    bool unsubscribe(const std::string& topic = "") override {
+        (void)topic;
+        topic_filter_.clear();
+        return true;
+    }
+
+protected:
+    // Skips non-matching topics without copying their payloads
+    bool accept_record(const char*& payload, uint32_t& size) override;
+
+private:
+    std::string topic_filter_;
+};
+
+} // namespace hft
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "message_types.h"
+#include <chrono>
+
+namespace hft {
+
+// Logical time for in-process backtests. The event loop advances it to each
+// tick's exchange time; components holding a clock pointer read it instead
+// of the wall clock (nullptr = live, wall-clock behaviour). Single-threaded.
+class SimulationClock {
+public:
+    timestamp_t now() const { return now_; }
+
+    // Time only moves forward so out-of-order ticks can't rewind timers
+    void advance_to(timestamp_t time) {
+        if (time > now_) now_ = time;
+    }
+
+    void reset(timestamp_t time = timestamp_t(0)) { now_ = time; }
+
+    // For code that keeps steady_clock time points (strategy rate limits)
+    std::chrono::steady_clock::time_point steady_now() const {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(now_));
+    }
+
+private:
+    timestamp_t now_{0};
+};
+
+} // namespace hft
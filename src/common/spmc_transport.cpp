@@ -1,4 +1,5 @@
 #include "spmc_transport.h"
+#include "cpu_affinity.h"
 #include <iostream>
 #include <cstring>
 #include <thread>
@@ -6,11 +7,8 @@
 namespace hft {
 
 template<size_t RING_SIZE>
-SPMCTransport<RING_SIZE>::SPMCTransport() {
-    // Initialize all read positions to 0
-    for (size_t i = 0; i < MAX_CONSUMERS; ++i) {
-        read_positions_[i].store(0);
-    }
+SPMCTransport<RING_SIZE>::SPMCTransport()
+    : config_(TransportType::SPMC_RING, TransportPattern::PUBLISH_SUBSCRIBE, "") {
 }
 
 template<size_t RING_SIZE>
@@ -21,10 +19,11 @@ SPMCTransport<RING_SIZE>::~SPMCTransport() {
 template<size_t RING_SIZE>
 bool SPMCTransport<RING_SIZE>::initialize(const TransportConfig& config) {
     if (initialized_.load()) return true;
-    
+
     config_ = config;
     endpoint_ = config.endpoint;
-    
+    policy_ = config.slow_consumer_policy;
+
     // Determine role based on pattern
     if (config.pattern == TransportPattern::PUBLISH_SUBSCRIBE) {
         is_producer_ = (endpoint_.find("bind:") == 0);
@@ -34,7 +33,7 @@ bool SPMCTransport<RING_SIZE>::initialize(const TransportConfig& config) {
         is_producer_ = true;
         is_consumer_ = true;
     }
-    
+
     if (is_consumer_) {
         consumer_id_ = register_consumer();
         if (consumer_id_ == UINT32_MAX) {
@@ -42,11 +41,12 @@ bool SPMCTransport<RING_SIZE>::initialize(const TransportConfig& config) {
             return false;
         }
     }
-    
+
     initialized_.store(true);
     connected_.store(true);  // SPMC is always "connected"
-    
-    std::cout << "[SPMCTransport] Initialized with " << RING_SIZE << " byte ring buffer" << std::endl;
+
+    std::cout << "[SPMCTransport] Initialized with " << RING_SIZE << " byte ring buffer ("
+              << (policy_ == SlowConsumerPolicy::OVERWRITE ? "overwrite" : "block") << " on slow consumer)" << std::endl;
     return true;
 }
 
@@ -63,41 +63,273 @@ bool SPMCTransport<RING_SIZE>::connect(const std::string& endpoint) {
     endpoint_ = endpoint;
     is_producer_ = false;
     is_consumer_ = true;
-    
-    if (consumer_id_ == 0) {
+
+    if (consumer_id_ == UINT32_MAX) {
         consumer_id_ = register_consumer();
     }
-    
+
     return consumer_id_ != UINT32_MAX;
 }
 
 template<size_t RING_SIZE>
 void SPMCTransport<RING_SIZE>::close() {
     stop_async_receive();
-    
+
     if (is_consumer_ && consumer_id_ != UINT32_MAX) {
         unregister_consumer(consumer_id_);
         consumer_id_ = UINT32_MAX;
     }
-    
+
     connected_.store(false);
     initialized_.store(false);
 }
 
 template<size_t RING_SIZE>
 bool SPMCTransport<RING_SIZE>::send(const void* data, size_t size, bool non_blocking) {
-    if (!is_producer_ || !connected_.load()) return false;
+    return send_topic(NO_TOPIC, data, size, non_blocking);
+}
+
+template<size_t RING_SIZE>
+bool SPMCTransport<RING_SIZE>::send_topic(topic_id_t topic_id, const void* data, size_t size, bool non_blocking) {
+    if (!is_producer_ || !connected_.load(std::memory_order_relaxed)) return false;
     if (size > MAX_MESSAGE_SIZE) return false;
-    
-    return try_push(data, size);
+
+    size_t msg_size = get_message_size_with_header(size);
+    uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
+    size_t ring_pos = write_pos & RING_MASK;
+    size_t tail = RING_SIZE - ring_pos;
+    size_t needed = msg_size > tail ? tail + msg_size : msg_size;
+
+    if (policy_ == SlowConsumerPolicy::BLOCK) {
+        while (!has_space(write_pos, needed)) {
+            if (non_blocking) return false;
+            CPUAffinity::cpu_pause();
+        }
+    } else {
+        // Announce the bytes about to be overwritten before touching them, so
+        // readers validating against claim_pos_ see the lap (seqlock style)
+        claim_pos_.store(write_pos + needed, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    if (msg_size > tail) {
+        // Pad out the tail; a tail shorter than a header is skipped implicitly
+        if (tail >= sizeof(MessageHeader)) {
+            MessageHeader* pad = reinterpret_cast<MessageHeader*>(&ring_buffer_[ring_pos]);
+            pad->size = PADDING_SIZE;
+            pad->topic_id = NO_TOPIC;
+            pad->sequence = sequence_counter_;
+        }
+        write_pos += tail;
+        ring_pos = 0;
+    }
+
+    // Create message header
+    MessageHeader* header = reinterpret_cast<MessageHeader*>(&ring_buffer_[ring_pos]);
+    header->size = static_cast<uint32_t>(size);
+    header->topic_id = topic_id;
+    header->sequence = sequence_counter_++;
+
+    if (size > 0) std::memcpy(header + 1, data, size);
+
+    // Publish the record
+    write_pos_.store(write_pos + msg_size, std::memory_order_release);
+
+    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(size, std::memory_order_relaxed);
+
+    return true;
 }
 
 template<size_t RING_SIZE>
 bool SPMCTransport<RING_SIZE>::receive(void* data, size_t& size, bool non_blocking) {
     if (!is_consumer_ || !connected_.load()) return false;
     if (consumer_id_ == UINT32_MAX) return false;
-    
-    return try_pop(data, size, consumer_id_);
+
+    MessageSpan span;
+    while (true) {
+        if (read_batch(consumer_id_, &span, 1) == 1) {
+            if (size < span.size) return false;  // Buffer too small
+
+            std::memcpy(data, span.data, span.size);
+            if (release_batch(consumer_id_)) {
+                size = span.size;
+                return true;
+            }
+            continue;  // Lapped during the copy, take the next message
+        }
+        if (non_blocking || !connected_.load(std::memory_order_relaxed)) return false;
+        CPUAffinity::cpu_pause();
+    }
+}
+
+template<size_t RING_SIZE>
+size_t SPMCTransport<RING_SIZE>::read_batch(uint32_t consumer_id, MessageSpan* spans, size_t max_spans) {
+    if (consumer_id >= MAX_CONSUMERS) return 0;
+
+    ConsumerState& consumer = consumers_[consumer_id];
+    if (!consumer.active.load(std::memory_order_relaxed)) return 0;
+
+    const bool overwrite = policy_ == SlowConsumerPolicy::OVERWRITE;
+    uint64_t pos = consumer.read_pos.load(std::memory_order_relaxed);
+    uint64_t write_pos = write_pos_.load(std::memory_order_acquire);
+
+    if (overwrite && lapped(pos)) {
+        resync(consumer);
+        pos = consumer.read_pos.load(std::memory_order_relaxed);
+        write_pos = write_pos_.load(std::memory_order_acquire);
+    }
+
+    size_t count = 0;
+    size_t bytes = 0;
+    bool seen = false;
+    uint64_t last_sequence = consumer.expected_sequence;
+
+    while (count < max_spans && pos != write_pos) {
+        size_t ring_pos = pos & RING_MASK;
+        size_t tail = RING_SIZE - ring_pos;
+        if (tail < sizeof(MessageHeader)) {
+            pos += tail;
+            continue;
+        }
+
+        const MessageHeader* header = reinterpret_cast<const MessageHeader*>(&ring_buffer_[ring_pos]);
+        uint32_t msg_size = header->size;
+        topic_id_t topic_id = header->topic_id;
+        uint64_t sequence = header->sequence;
+
+        // Don't follow a header the producer may have overwritten under us
+        if (overwrite && lapped(pos)) {
+            if (count > 0) break;  // Let release_batch() report the lap on what we have
+            resync(consumer);
+            pos = consumer.read_pos.load(std::memory_order_relaxed);
+            write_pos = write_pos_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (msg_size == PADDING_SIZE) {
+            pos += tail;
+            continue;
+        }
+
+        if (consumer.resynced) {
+            // First record after a resync: the sequence gap is what we lost
+            if (consumer.expected_sequence != NO_SEQUENCE && sequence > consumer.expected_sequence) {
+                consumer.lapped_messages.fetch_add(sequence - consumer.expected_sequence, std::memory_order_relaxed);
+            }
+            consumer.resynced = false;
+        }
+
+        seen = true;
+        last_sequence = sequence;
+        pos += get_message_size_with_header(msg_size);
+
+        // Other topics are skipped on the header alone
+        if (consumer.topic_filtered && !topic_selected(consumer, topic_id)) continue;
+
+        spans[count].data = reinterpret_cast<const char*>(header + 1);
+        spans[count].size = msg_size;
+        spans[count].topic_id = topic_id;
+        spans[count].sequence = sequence;
+        ++count;
+        bytes += msg_size;
+    }
+
+    consumer.batch_end = pos;
+    consumer.batch_last_sequence = last_sequence;
+    consumer.batch_count = count;
+    consumer.batch_bytes = bytes;
+
+    // Padding and filtered-out records are committed right away
+    if (count == 0) {
+        if (seen) consumer.expected_sequence = last_sequence + 1;
+        consumer.read_pos.store(pos, std::memory_order_release);
+    }
+    return count;
+}
+
+template<size_t RING_SIZE>
+bool SPMCTransport<RING_SIZE>::release_batch(uint32_t consumer_id) {
+    if (consumer_id >= MAX_CONSUMERS) return false;
+
+    ConsumerState& consumer = consumers_[consumer_id];
+    if (consumer.batch_count == 0) return true;
+
+    if (policy_ == SlowConsumerPolicy::OVERWRITE) {
+        // Everything read since the batch began must still be intact
+        if (lapped(consumer.read_pos.load(std::memory_order_relaxed))) {
+            consumer.batch_count = 0;
+            resync(consumer);
+            return false;
+        }
+    }
+
+    consumer.expected_sequence = consumer.batch_last_sequence + 1;
+    consumer.read_pos.store(consumer.batch_end, std::memory_order_release);
+
+    messages_received_.fetch_add(consumer.batch_count, std::memory_order_relaxed);
+    bytes_received_.fetch_add(consumer.batch_bytes, std::memory_order_relaxed);
+    consumer.batch_count = 0;
+    return true;
+}
+
+template<size_t RING_SIZE>
+bool SPMCTransport<RING_SIZE>::lapped(uint64_t position) const {
+    // Bytes at `position` are gone once the producer has claimed a full ring
+    // past them. The fence keeps preceding ring reads ahead of the claim load.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return claim_pos_.load(std::memory_order_relaxed) - position > RING_SIZE;
+}
+
+template<size_t RING_SIZE>
+bool SPMCTransport<RING_SIZE>::topic_selected(const ConsumerState& consumer, topic_id_t topic_id) {
+    if (topic_id >= SymbolTable::MAX_SYMBOLS) return false;
+    return (consumer.topic_mask[topic_id >> 6] >> (topic_id & 63)) & 1;
+}
+
+template<size_t RING_SIZE>
+bool SPMCTransport<RING_SIZE>::subscribe_topic(uint32_t consumer_id, topic_id_t topic_id) {
+    if (consumer_id >= MAX_CONSUMERS || topic_id >= SymbolTable::MAX_SYMBOLS) return false;
+
+    ConsumerState& consumer = consumers_[consumer_id];
+    consumer.topic_mask[topic_id >> 6] |= 1ULL << (topic_id & 63);
+    consumer.topic_filtered = true;
+    return true;
+}
+
+template<size_t RING_SIZE>
+void SPMCTransport<RING_SIZE>::unsubscribe_topic(uint32_t consumer_id, topic_id_t topic_id) {
+    if (consumer_id >= MAX_CONSUMERS || topic_id >= SymbolTable::MAX_SYMBOLS) return;
+    consumers_[consumer_id].topic_mask[topic_id >> 6] &= ~(1ULL << (topic_id & 63));
+}
+
+template<size_t RING_SIZE>
+void SPMCTransport<RING_SIZE>::clear_topic_filter(uint32_t consumer_id) {
+    if (consumer_id >= MAX_CONSUMERS) return;
+
+    ConsumerState& consumer = consumers_[consumer_id];
+    std::memset(consumer.topic_mask, 0, sizeof(consumer.topic_mask));
+    consumer.topic_filtered = false;
+}
+
+template<size_t RING_SIZE>
+void SPMCTransport<RING_SIZE>::resync(ConsumerState& consumer) {
+    // Jump to the newest record boundary; the gap is counted on the next read
+    consumer.read_pos.store(write_pos_.load(std::memory_order_acquire), std::memory_order_release);
+    consumer.resynced = true;
+    consumer.lap_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<size_t RING_SIZE>
+uint64_t SPMCTransport<RING_SIZE>::get_lapped_messages(uint32_t consumer_id) const {
+    if (consumer_id >= MAX_CONSUMERS) return 0;
+    return consumers_[consumer_id].lapped_messages.load(std::memory_order_relaxed);
+}
+
+template<size_t RING_SIZE>
+uint64_t SPMCTransport<RING_SIZE>::get_lap_events(uint32_t consumer_id) const {
+    if (consumer_id >= MAX_CONSUMERS) return 0;
+    return consumers_[consumer_id].lap_events.load(std::memory_order_relaxed);
 }
 
 template<size_t RING_SIZE>
@@ -108,7 +340,7 @@ void SPMCTransport<RING_SIZE>::set_receive_callback(MessageCallback callback) {
 template<size_t RING_SIZE>
 void SPMCTransport<RING_SIZE>::start_async_receive() {
     if (async_active_.load() || !receive_callback_ || !is_consumer_) return;
-    
+
     async_active_.store(true);
     receive_thread_ = std::make_unique<std::thread>(&SPMCTransport::async_receive_loop, this);
 }
@@ -128,31 +360,40 @@ uint32_t SPMCTransport<RING_SIZE>::register_consumer() {
     if (count >= MAX_CONSUMERS) {
         return UINT32_MAX;  // Too many consumers
     }
-    
+
     // Find an available consumer slot
     for (uint32_t i = 0; i < MAX_CONSUMERS; ++i) {
-        uint64_t expected = 0;
-        if (read_positions_[i].compare_exchange_weak(expected, write_pos_.load())) {
+        bool expected = false;
+        ConsumerState& consumer = consumers_[i];
+        if (consumer.active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            consumer.read_pos.store(write_pos_.load(std::memory_order_acquire), std::memory_order_release);
+            consumer.batch_count = 0;
+            consumer.expected_sequence = NO_SEQUENCE;
+            consumer.resynced = false;
+            clear_topic_filter(i);
+            consumer.lapped_messages.store(0, std::memory_order_relaxed);
+            consumer.lap_events.store(0, std::memory_order_relaxed);
             consumer_count_++;
             return i;
         }
     }
-    
+
     return UINT32_MAX;  // No available slots
 }
 
 template<size_t RING_SIZE>
 void SPMCTransport<RING_SIZE>::unregister_consumer(uint32_t consumer_id) {
     if (consumer_id >= MAX_CONSUMERS) return;
-    
-    read_positions_[consumer_id].store(UINT64_MAX);  // Mark as inactive
-    consumer_count_--;
+
+    if (consumers_[consumer_id].active.exchange(false)) {
+        consumer_count_--;
+    }
 }
 
 template<size_t RING_SIZE>
 bool SPMCTransport<RING_SIZE>::empty() const {
     if (consumer_id_ == UINT32_MAX) return true;
-    return read_positions_[consumer_id_].load() == write_pos_.load();
+    return consumers_[consumer_id_].read_pos.load() == write_pos_.load();
 }
 
 template<size_t RING_SIZE>
@@ -162,14 +403,8 @@ bool SPMCTransport<RING_SIZE>::full() const {
 
 template<size_t RING_SIZE>
 size_t SPMCTransport<RING_SIZE>::available_space() const {
-    uint64_t write_pos = write_pos_.load();
-    uint64_t min_read_pos = get_min_read_position();
-    
-    if (write_pos >= min_read_pos) {
-        return RING_SIZE - (write_pos - min_read_pos);
-    } else {
-        return min_read_pos - write_pos;
-    }
+    uint64_t used = write_pos_.load() - get_min_read_position();
+    return used >= RING_SIZE ? 0 : RING_SIZE - used;
 }
 
 template<size_t RING_SIZE>
@@ -179,133 +414,52 @@ size_t SPMCTransport<RING_SIZE>::used_space() const {
 
 template<size_t RING_SIZE>
 void SPMCTransport<RING_SIZE>::async_receive_loop() {
-    char buffer[MAX_MESSAGE_SIZE];
-    
+    MessageSpan spans[ASYNC_BATCH];
+
     while (async_active_.load() && connected_.load()) {
-        size_t size = sizeof(buffer);
-        
-        if (receive(buffer, size, true)) {
+        size_t count = read_batch(consumer_id_, spans, ASYNC_BATCH);
+        if (count == 0) {
+            CPUAffinity::cpu_pause();
+            continue;
+        }
+
+        // Deliver straight from the ring; under OVERWRITE a lapped batch may
+        // already have been handed out in part, and the lap is counted
+        for (size_t i = 0; i < count; ++i) {
             if (receive_callback_) {
-                receive_callback_(buffer, size);
+                receive_callback_(spans[i].data, spans[i].size);
             }
-        } else {
-            // Small delay if no data available
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
         }
+        release_batch(consumer_id_);
     }
 }
 
-template<size_t RING_SIZE>
-bool SPMCTransport<RING_SIZE>::try_push(const void* data, size_t size) {
-    size_t msg_size = get_message_size_with_header(size);
-    
-    if (!can_write(msg_size)) {
-        return false;  // Not enough space
-    }
-    
-    uint64_t write_pos = write_pos_.load();
-    size_t ring_pos = write_pos & RING_MASK;
-    
-    // Create message header
-    MessageHeader* header = reinterpret_cast<MessageHeader*>(&ring_buffer_[ring_pos]);
-    header->size = static_cast<uint32_t>(size);
-    header->sequence = sequence_counter_++;
-    
-    // Copy data after header
-    if (ring_pos + msg_size <= RING_SIZE) {
-        // Message fits in one piece
-        std::memcpy(header->data, data, size);
-    } else {
-        // Message wraps around
-        size_t first_part = RING_SIZE - ring_pos - sizeof(MessageHeader);
-        std::memcpy(header->data, data, first_part);
-        std::memcpy(&ring_buffer_[0], static_cast<const char*>(data) + first_part, size - first_part);
-    }
-    
-    // Advance write position atomically
-    advance_write_position(msg_size);
-    
-    messages_sent_++;
-    bytes_sent_ += size;
-    
-    return true;
-}
-
-template<size_t RING_SIZE>
-bool SPMCTransport<RING_SIZE>::try_pop(void* data, size_t& size, uint32_t consumer_id) {
-    if (consumer_id >= MAX_CONSUMERS) return false;
-    
-    uint64_t read_pos = read_positions_[consumer_id].load();
-    uint64_t write_pos = write_pos_.load();
-    
-    if (read_pos == write_pos) {
-        return false;  // No data available
-    }
-    
-    size_t ring_pos = read_pos & RING_MASK;
-    
-    // Read message header
-    const MessageHeader* header = reinterpret_cast<const MessageHeader*>(&ring_buffer_[ring_pos]);
-    uint32_t msg_size = header->size;
-    
-    if (size < msg_size) {
-        return false;  // Buffer too small
-    }
-    
-    // Copy data from ring buffer
-    if (ring_pos + sizeof(MessageHeader) + msg_size <= RING_SIZE) {
-        // Message fits in one piece
-        std::memcpy(data, header->data, msg_size);
-    } else {
-        // Message wraps around
-        size_t first_part = RING_SIZE - ring_pos - sizeof(MessageHeader);
-        std::memcpy(data, header->data, first_part);
-        std::memcpy(static_cast<char*>(data) + first_part, &ring_buffer_[0], msg_size - first_part);
-    }
-    
-    size = msg_size;
-    
-    // Advance read position
-    advance_read_position(consumer_id, get_message_size_with_header(msg_size));
-    
-    messages_received_++;
-    bytes_received_ += msg_size;
-    
-    return true;
-}
-
 template<size_t RING_SIZE>
 size_t SPMCTransport<RING_SIZE>::get_message_size_with_header(size_t data_size) const {
-    return sizeof(MessageHeader) + data_size;
+    return (sizeof(MessageHeader) + data_size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
 }
 
 template<size_t RING_SIZE>
 uint64_t SPMCTransport<RING_SIZE>::get_min_read_position() const {
     uint64_t min_pos = write_pos_.load();
-    
+
     for (uint32_t i = 0; i < MAX_CONSUMERS; ++i) {
-        uint64_t pos = read_positions_[i].load();
-        if (pos != UINT64_MAX && pos < min_pos) {
+        if (!consumers_[i].active.load(std::memory_order_acquire)) continue;
+        uint64_t pos = consumers_[i].read_pos.load(std::memory_order_acquire);
+        if (pos < min_pos) {
             min_pos = pos;
         }
     }
-    
-    return min_pos;
-}
-
-template<size_t RING_SIZE>
-bool SPMCTransport<RING_SIZE>::can_write(size_t required_size) const {
-    return available_space() >= required_size;
-}
 
-template<size_t RING_SIZE>
-void SPMCTransport<RING_SIZE>::advance_write_position(size_t size) {
-    write_pos_ += size;
+    return min_pos;
 }
 
 template<size_t RING_SIZE>
-void SPMCTransport<RING_SIZE>::advance_read_position(uint32_t consumer_id, size_t size) {
-    read_positions_[consumer_id] += size;
+bool SPMCTransport<RING_SIZE>::has_space(uint64_t write_pos, size_t required_size) {
+    // Only rescan the consumer cursors when the cached slowest one says full
+    if (write_pos + required_size - cached_min_read_ <= RING_SIZE) return true;
+    cached_min_read_ = get_min_read_position();
+    return write_pos + required_size - cached_min_read_ <= RING_SIZE;
 }
 
 // Explicit template instantiations for common sizes
@@ -313,4 +467,4 @@ template class SPMCTransport<1024 * 1024>;
 template class SPMCTransport<4 * 1024 * 1024>;
 template class SPMCTransport<16 * 1024 * 1024>;
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "transport_interface.h"
+#include "symbol_table.h"
 #include <atomic>
 #include <memory>
 #include <thread>
@@ -10,181 +11,224 @@
 
 namespace hft {
 
+// Ring records carry a topic ID (normally the interned symbol ID) in their
+// header so filtered consumers skip other topics without touching payloads
+using topic_id_t = symbol_id_t;
+constexpr topic_id_t NO_TOPIC = INVALID_SYMBOL_ID;
+
+// Zero-copy view of one message inside the SPMC ring
+struct MessageSpan {
+    const char* data;
+    uint32_t size;
+    topic_id_t topic_id;
+    uint64_t sequence;
+};
+
 // SPMC (Single Producer, Multiple Consumer) transport implementation
 template<size_t RING_SIZE = 1024 * 1024>  // 1MB default ring buffer
-class SPMCTransport : public IMessageTransport {
+class SPMCTransport : public virtual IMessageTransport {
     static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be power of 2");
-    
+
 public:
     SPMCTransport();
     virtual ~SPMCTransport();
-    
+
     // IMessageTransport interface
     bool initialize(const TransportConfig& config) override;
     bool bind(const std::string& endpoint) override;
     bool connect(const std::string& endpoint) override;
     void close() override;
-    
+
     bool send(const void* data, size_t size, bool non_blocking = false) override;
+    bool send_topic(topic_id_t topic_id, const void* data, size_t size, bool non_blocking = false);
     bool receive(void* data, size_t& size, bool non_blocking = false) override;
-    
+
     void set_receive_callback(MessageCallback callback) override;
     void start_async_receive() override;
     void stop_async_receive() override;
-    
+
     bool is_connected() const override { return connected_.load(); }
     TransportType get_type() const override { return TransportType::SPMC_RING; }
     std::string get_endpoint() const override { return endpoint_; }
-    
+
     uint64_t get_messages_sent() const override { return messages_sent_.load(); }
     uint64_t get_messages_received() const override { return messages_received_.load(); }
     uint64_t get_bytes_sent() const override { return bytes_sent_.load(); }
     uint64_t get_bytes_received() const override { return bytes_received_.load(); }
-    
+
     void* get_native_handle() override { return nullptr; }  // No native handle for SPMC
 
     // SPMC-specific methods
     uint32_t register_consumer();
     void unregister_consumer(uint32_t consumer_id);
-    
+
+    // Batched zero-copy drain. read_batch() fills up to max_spans views of
+    // ready messages without advancing the cursor; release_batch() commits
+    // them. Records outside the consumer's topic filter are stepped over
+    // by header only. Under OVERWRITE, release_batch() returns false if the producer
+    // lapped the batch while it was being processed: the spans may hold
+    // torn data and must be discarded (the consumer has already resynced).
+    size_t read_batch(uint32_t consumer_id, MessageSpan* spans, size_t max_spans);
+    bool release_batch(uint32_t consumer_id);
+    size_t read_batch(MessageSpan* spans, size_t max_spans) { return read_batch(consumer_id_, spans, max_spans); }
+    bool release_batch() { return release_batch(consumer_id_); }
+
+    // Lap accounting (OVERWRITE policy). A lapped consumer jumps to the
+    // newest message; the sequence gap is added to its lapped count.
+    uint64_t get_lapped_messages(uint32_t consumer_id) const;
+    uint64_t get_lap_events(uint32_t consumer_id) const;
+
+    // Per-consumer topic filter; call from the consumer's own thread.
+    // An empty filter receives everything, including untopiced records.
+    bool subscribe_topic(uint32_t consumer_id, topic_id_t topic_id);
+    void unsubscribe_topic(uint32_t consumer_id, topic_id_t topic_id);
+    void clear_topic_filter(uint32_t consumer_id);
+
+    void set_slow_consumer_policy(SlowConsumerPolicy policy) { policy_ = policy; }
+    SlowConsumerPolicy get_slow_consumer_policy() const { return policy_; }
+
     // Ring buffer status
     bool empty() const;
     bool full() const;
     size_t available_space() const;
     size_t used_space() const;
 
+protected:
+    uint32_t consumer_id_{UINT32_MAX};
+
 private:
-    // Message header in ring buffer
+    // Message header in ring buffer. Records are RECORD_ALIGN aligned and
+    // never straddle the end of the ring; a padding record fills the tail.
     struct MessageHeader {
-        uint32_t size;
-        uint32_t sequence;
-        char data[];  // Flexible array member (C99)
-    } __attribute__((packed));
-    
+        uint32_t size;        // PADDING_SIZE marks a tail filler
+        topic_id_t topic_id;
+        uint64_t sequence;
+    };
+
+    static constexpr size_t TOPIC_WORDS = SymbolTable::MAX_SYMBOLS / 64;
+
+    // Per-consumer cursor, one cache line each so consumers don't false-share
+    struct alignas(64) ConsumerState {
+        std::atomic<uint64_t> read_pos{0};
+        std::atomic<bool> active{false};
+        uint64_t batch_end{0};            // Cursor after the pending batch
+        uint64_t batch_last_sequence{0};
+        size_t batch_count{0};
+        size_t batch_bytes{0};
+        uint64_t expected_sequence{UINT64_MAX};
+        bool resynced{false};             // Next record's sequence gap counts as lapped
+        bool topic_filtered{false};
+        uint64_t topic_mask[TOPIC_WORDS]{};
+        std::atomic<uint64_t> lapped_messages{0};
+        std::atomic<uint64_t> lap_events{0};
+    };
+
     // Ring buffer structure
     alignas(64) char ring_buffer_[RING_SIZE];
     alignas(64) std::atomic<uint64_t> write_pos_{0};
-    alignas(64) std::atomic<uint64_t> read_positions_[32];  // Up to 32 consumers
+    std::atomic<uint64_t> claim_pos_{0};  // End of the record being written (OVERWRITE)
     alignas(64) std::atomic<uint32_t> consumer_count_{0};
-    alignas(64) std::atomic<uint32_t> next_consumer_id_{0};
-    alignas(64) std::atomic<uint32_t> sequence_counter_{0};
-    
+    alignas(64) uint64_t sequence_counter_{0};
+    uint64_t cached_min_read_{0};         // Producer-only: slowest cursor at last scan
+    ConsumerState consumers_[32];         // Up to 32 consumers
+
     // Configuration and state
     TransportConfig config_;
     std::string endpoint_;
+    SlowConsumerPolicy policy_{SlowConsumerPolicy::BLOCK};
     std::atomic<bool> connected_{false};
     std::atomic<bool> initialized_{false};
-    
+
     // Statistics
     std::atomic<uint64_t> messages_sent_{0};
     std::atomic<uint64_t> messages_received_{0};
     std::atomic<uint64_t> bytes_sent_{0};
     std::atomic<uint64_t> bytes_received_{0};
-    
+
     // Consumer management
-    uint32_t consumer_id_{0};
     bool is_consumer_{false};
     bool is_producer_{false};
-    
+
     // Async receive
     MessageCallback receive_callback_;
     std::unique_ptr<std::thread> receive_thread_;
     std::atomic<bool> async_active_{false};
-    
+
     // Constants
     static constexpr size_t RING_MASK = RING_SIZE - 1;
     static constexpr size_t MAX_MESSAGE_SIZE = RING_SIZE / 4;  // Max 25% of ring per message
+    static constexpr size_t RECORD_ALIGN = 8;
+    static constexpr uint32_t PADDING_SIZE = UINT32_MAX;
     static constexpr uint32_t MAX_CONSUMERS = 32;
-    
+    static constexpr size_t ASYNC_BATCH = 64;
+    static constexpr uint64_t NO_SEQUENCE = UINT64_MAX;  // Consumer has not read anything yet
+
     // Helper methods
     void async_receive_loop();
-    bool try_push(const void* data, size_t size);
-    bool try_pop(void* data, size_t& size, uint32_t consumer_id);
     size_t get_message_size_with_header(size_t data_size) const;
     uint64_t get_min_read_position() const;
-    bool can_write(size_t required_size) const;
-    void advance_write_position(size_t size);
-    void advance_read_position(uint32_t consumer_id, size_t size);
+    bool has_space(uint64_t write_pos, size_t required_size);
+    bool lapped(uint64_t position) const;
+    static bool topic_selected(const ConsumerState& consumer, topic_id_t topic_id);
+    void resync(ConsumerState& consumer);
 };
 
 // SPMC Publisher (single producer)
 template<size_t RING_SIZE = 1024 * 1024>
-class SPMCPublisher : public virtual SPMCTransport<RING_SIZE>, public virtual IMessagePublisher {
+class SPMCPublisher : public SPMCTransport<RING_SIZE>, public virtual IMessagePublisher {
 public:
     bool publish(const void* data, size_t size) override {
         return SPMCTransport<RING_SIZE>::send(data, size, true);  // Non-blocking by default
     }
-    
+
     bool publish(const std::string& topic, const void* data, size_t size) override {
-        // For SPMC, topics are handled at application level
-        // Just append topic to the beginning of data
-        std::vector<char> msg_buffer(topic.size() + 1 + size);
-        std::memcpy(msg_buffer.data(), topic.c_str(), topic.size());
-        msg_buffer[topic.size()] = '\0';  // Null terminate topic
-        std::memcpy(msg_buffer.data() + topic.size() + 1, data, size);
-        
-        return publish(msg_buffer.data(), msg_buffer.size());
+        // Topic goes in the record header as its symbol ID; payload is untouched
+        return this->send_topic(SymbolTable::instance().intern(topic), data, size, true);
     }
-    
+
+    // Hot path: caller already holds the interned ID
+    bool publish(topic_id_t topic_id, const void* data, size_t size) {
+        return this->send_topic(topic_id, data, size, true);
+    }
+
     void set_filter(const std::string& filter) override {
-        // SPMC doesn't support server-side filtering like ZMQ
-        // This would need to be implemented at application level
+        // Filtering is per consumer: each one skips other topics by header
     }
 };
 
 // SPMC Subscriber (multiple consumers)
 template<size_t RING_SIZE = 1024 * 1024>
-class SPMCSubscriber : public virtual SPMCTransport<RING_SIZE>, public virtual IMessageSubscriber {
+class SPMCSubscriber : public SPMCTransport<RING_SIZE>, public virtual IMessageSubscriber {
 public:
     bool subscribe(const std::string& topic = "") override {
-        topic_filter_ = topic;
-        return this->register_consumer() != UINT32_MAX;
-    }
-    
-    bool unsubscribe(const std::string& topic = "") override {
-        // For SPMC, unsubscribing means unregistering as consumer
-        if (consumer_id_ != UINT32_MAX) {
-            this->unregister_consumer(consumer_id_);
-            consumer_id_ = UINT32_MAX;
+        if (this->consumer_id_ == UINT32_MAX) return false;
+        if (topic.empty()) {
+            this->clear_topic_filter(this->consumer_id_);
+            return true;
         }
-        return true;
+        return this->subscribe_topic(this->consumer_id_, SymbolTable::instance().intern(topic));
+    }
+
+    bool subscribe(topic_id_t topic_id) {
+        return this->consumer_id_ != UINT32_MAX && this->subscribe_topic(this->consumer_id_, topic_id);
     }
-    
-    bool receive(void* data, size_t& size, bool non_blocking = false) override {
-        // Override to add topic filtering
-        char temp_buffer[RING_SIZE / 4];  // Temporary buffer for filtering
-        size_t temp_size = sizeof(temp_buffer);
-        
-        if (SPMCTransport<RING_SIZE>::receive(temp_buffer, temp_size, non_blocking)) {
-            // Check topic filter if set
-            if (!topic_filter_.empty()) {
-                if (temp_size < topic_filter_.size() + 1) return false;
-                if (std::strncmp(temp_buffer, topic_filter_.c_str(), topic_filter_.size()) != 0) {
-                    return false;  // Topic doesn't match
-                }
-                
-                // Skip topic and null terminator
-                size_t data_offset = topic_filter_.size() + 1;
-                size_t actual_size = temp_size - data_offset;
-                
-                if (size < actual_size) return false;  // Buffer too small
-                
-                std::memcpy(data, temp_buffer + data_offset, actual_size);
-                size = actual_size;
-            } else {
-                // No filtering, copy all data
-                if (size < temp_size) return false;
-                std::memcpy(data, temp_buffer, temp_size);
-                size = temp_size;
+
+    bool unsubscribe(const std::string& topic = "") override {
+        if (this->consumer_id_ == UINT32_MAX) return true;
+
+        if (!topic.empty()) {
+            symbol_id_t topic_id = SymbolTable::instance().find(topic.c_str());
+            if (topic_id != INVALID_SYMBOL_ID) {
+                this->unsubscribe_topic(this->consumer_id_, topic_id);
             }
             return true;
         }
-        return false;
-    }
 
-private:
-    std::string topic_filter_;
-    uint32_t consumer_id_ = UINT32_MAX;
+        // For SPMC, unsubscribing from everything means unregistering as consumer
+        this->unregister_consumer(this->consumer_id_);
+        this->consumer_id_ = UINT32_MAX;
+        return true;
+    }
 };
 
 // Type aliases for common ring buffer sizes
@@ -195,4 +239,4 @@ using SPMC16M = SPMCTransport<16 * 1024 * 1024>; // 16MB ring
 using SPMCPublisher1M = SPMCPublisher<1024 * 1024>;
 using SPMCSubscriber1M = SPMCSubscriber<1024 * 1024>;
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "message_types.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace hft {
+
+// Single-producer/single-consumer ring for handing fixed-size messages
+// between two pinned threads of one process. Each item gets its own cache
+// line(s) and, unlike SPSCQueue, there is no per-slot flag: the producer
+// stages any number of items and makes them visible with one release store
+// (publish), and the consumer frees a whole drained batch with one store.
+// Each side keeps a cached copy of the other's index, so the shared index
+// lines only move between cores when the cached view says full or empty.
+template<typename T, size_t SIZE>
+class SPSCChannel {
+    static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "items are copied in and out of the ring");
+
+public:
+    SPSCChannel() = default;
+    SPSCChannel(const SPSCChannel&) = delete;
+    SPSCChannel& operator=(const SPSCChannel&) = delete;
+
+    // Producer: copies the item in without publishing it; false when full
+    // (staged but unpublished items count towards full)
+    bool try_stage(const T& item) {
+        size_t head = producer_.staged;
+        if (head - producer_.cached_tail >= SIZE) {
+            producer_.cached_tail = tail_.load(std::memory_order_acquire);
+            if (head - producer_.cached_tail >= SIZE) {
+                return false;
+            }
+        }
+        slots_[head & MASK].value = item;
+        producer_.staged = head + 1;
+        return true;
+    }
+
+    // Producer: makes everything staged so far visible to the consumer
+    void publish() {
+        if (producer_.staged != head_.load(std::memory_order_relaxed)) {
+            head_.store(producer_.staged, std::memory_order_release);
+        }
+    }
+
+    bool try_push(const T& item) {
+        if (!try_stage(item)) return false;
+        publish();
+        return true;
+    }
+
+    // Consumer: calls fn(const T&) for up to max_items published items in
+    // order, then frees their slots at once. Returns how many were handled;
+    // the producer's index is only re-read once the cached one is used up,
+    // so a batch may stop short of everything published.
+    template<typename Fn>
+    size_t drain(Fn&& fn, size_t max_items = SIZE) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (consumer_.cached_head == tail) {
+            consumer_.cached_head = head_.load(std::memory_order_acquire);
+            if (consumer_.cached_head == tail) {
+                return 0;
+            }
+        }
+        size_t count = consumer_.cached_head - tail;
+        if (count > max_items) count = max_items;
+        for (size_t i = 0; i < count; ++i) {
+            fn(static_cast<const T&>(slots_[(tail + i) & MASK].value));
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool try_pop(T& item) {
+        return drain([&item](const T& value) { item = value; }, 1) == 1;
+    }
+
+    // Published and not yet drained (approximate from a third thread)
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return SIZE; }
+
+private:
+    static constexpr size_t MASK = SIZE - 1;
+
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    // Shared indices, one line each; the producer writes head_, the
+    // consumer tail_
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+
+    // Side-local state, never touched by the other thread
+    struct alignas(64) ProducerState {
+        size_t staged = 0;
+        size_t cached_tail = 0;
+    } producer_;
+    struct alignas(64) ConsumerState {
+        size_t cached_head = 0;
+    } consumer_;
+
+    std::array<Slot, SIZE> slots_;
+};
+
+// Strategy -> gateway hop of the single-process fast path (src/fast_path)
+using SignalChannel = SPSCChannel<TradingSignal, 4096>;
+
+} // namespace hft
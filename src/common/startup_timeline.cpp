@@ -0,0 +1,127 @@
+#include "startup_timeline.h"
+#include "hft_metrics.h"
+
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+namespace hft {
+
+namespace {
+
+bool run_step(const StartupStep& step) {
+    try {
+        return step.run();
+    } catch (const std::exception& e) {
+        std::cerr << "[Startup] " << step.name << " failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // namespace
+
+StartupTimeline& StartupTimeline::instance() {
+    static StartupTimeline instance;
+    return instance;
+}
+
+StartupTimeline::StartupTimeline() : origin_(std::chrono::steady_clock::now()) {}
+
+bool StartupTimeline::run(const char* phase, const std::function<bool()>& step) {
+    int64_t start = now_ns();
+    bool ok = run_step({phase, step});
+    record(phase, start, now_ns(), ok);
+    return ok;
+}
+
+bool StartupTimeline::run_parallel(std::initializer_list<StartupStep> steps) {
+    if (steps.size() == 0) return true;
+    int group;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        group = ++groups_;
+    }
+
+    // Slots written by one step each, read after the joins
+    std::vector<StartupPhase> results(steps.size());
+    auto run_one = [&](size_t index, const StartupStep& step) {
+        StartupPhase& phase = results[index];
+        phase.name = step.name;
+        phase.group = group;
+        phase.start_ns = now_ns();
+        phase.ok = run_step(step);
+        phase.duration_ns = now_ns() - phase.start_ns;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(steps.size() - 1);
+    const StartupStep* first = steps.begin();
+    for (size_t i = 1; i < steps.size(); ++i) {
+        threads.emplace_back(run_one, i, std::cref(first[i]));
+    }
+    run_one(0, *first);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool ok = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& phase : results) {
+        ok = ok && phase.ok;
+        phases_.push_back(std::move(phase));
+    }
+    return ok;
+}
+
+void StartupTimeline::record(const std::string& phase, int64_t start_ns, int64_t end_ns, bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_.push_back({phase, start_ns, end_ns - start_ns, ok, 0});
+}
+
+void StartupTimeline::ready(const std::string& service) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ready_ns_ >= 0) return;
+        ready_ns_ = now_ns();
+    }
+    HFT_GAUGE_VALUE(hft::metrics::STARTUP_READY_MS, static_cast<uint64_t>(ready_ns() / 1000000));
+    std::cout << service << " " << describe() << std::flush;
+}
+
+bool StartupTimeline::is_ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_ns_ >= 0;
+}
+
+int64_t StartupTimeline::ready_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_ns_;
+}
+
+std::vector<StartupPhase> StartupTimeline::phases() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+}
+
+std::string StartupTimeline::describe() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    char line[160];
+    std::string out;
+    if (ready_ns_ >= 0) {
+        std::snprintf(line, sizeof(line), "startup: trading-ready in %.1fms\n", ready_ns_ / 1e6);
+    } else {
+        std::snprintf(line, sizeof(line), "startup: not ready after %.1fms\n", now_ns() / 1e6);
+    }
+    out += line;
+    // "|" marks phases that ran side by side with the ones next to them
+    for (const StartupPhase& phase : phases_) {
+        std::snprintf(line, sizeof(line), "  at %8.1fms  took %8.1fms  %s%s%s\n", phase.start_ns / 1e6,
+                      phase.duration_ns / 1e6, phase.group ? "| " : "", phase.name.c_str(),
+                      phase.ok ? "" : " (failed)");
+        out += line;
+    }
+    return out;
+}
+
+} // namespace hft
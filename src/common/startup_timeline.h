@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+struct StartupPhase {
+    std::string name;
+    int64_t start_ns = 0;       // From the timeline's origin
+    int64_t duration_ns = 0;
+    bool ok = true;
+    int group = 0;              // Phases run side by side share a group; 0 = ran alone
+};
+
+struct StartupStep {
+    const char* name;
+    std::function<bool()> run;  // false (or an exception) fails the step
+};
+
+// Where a service's startup time goes, phase by phase, from main() to
+// trading-ready, and the place independent startup steps run side by side.
+// Broker handshakes are network round trips while ZMQ sockets, the journal
+// and the metrics publisher are local work; run_parallel() overlaps them
+// instead of adding them up.
+//
+// One per process, so main() and the service's initialize() add to the
+// same timeline. The origin is the first use, which main() makes first.
+class StartupTimeline {
+public:
+    static StartupTimeline& instance();
+
+    // Runs step on the calling thread as one phase; returns its result
+    bool run(const char* phase, const std::function<bool()>& step);
+
+    // Runs the steps concurrently, the first on the calling thread and each
+    // other on a thread of its own, and waits for all of them. Steps must
+    // not depend on each other. True if every step succeeded.
+    bool run_parallel(std::initializer_list<StartupStep> steps);
+
+    // A phase timed elsewhere (on a service's own thread, say)
+    void record(const std::string& phase, int64_t start_ns, int64_t end_ns, bool ok = true);
+
+    // Trading-ready: stamps the time, sets the health.startup_ready_ms
+    // gauge and prints the timeline. Only the first call counts.
+    void ready(const std::string& service);
+    bool is_ready() const;
+    int64_t ready_ns() const;
+
+    std::vector<StartupPhase> phases() const;
+    std::string describe() const;
+
+    // Nanoseconds since the origin
+    int64_t now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin_).count();
+    }
+
+private:
+    StartupTimeline();
+
+    std::chrono::steady_clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<StartupPhase> phases_;
+    int groups_ = 0;
+    int64_t ready_ns_ = -1;
+};
+
+} // namespace hft
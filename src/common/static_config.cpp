@@ -1,13 +1,155 @@
 #include "static_config.h"
+#include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 namespace hft {
 
-// Initialize static runtime overrides with compile-time defaults
-StaticConfig::RuntimeOverrides StaticConfig::runtime = {};
+// Constant-initialized, so getters called during other translation units'
+// static initialization see the defaults rather than an unconstructed object
+std::atomic<const StaticConfig::RuntimeOverrides*> StaticConfig::current_{nullptr};
+
+namespace {
+
+// Snapshot reclamation. A reader publishes the epoch it started in to its
+// thread's slot before loading the snapshot pointer; a snapshot replaced at
+// epoch E is freed once no slot holds an epoch <= E. Plain getters read
+// without a slot, so replaced snapshots are also kept for a grace period.
+constexpr size_t MAX_CONFIG_READERS = 128;
+constexpr auto RETIRED_CONFIG_GRACE = std::chrono::seconds(30);
+
+struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> epoch{0};     // 0 = not reading
+    std::atomic<bool> claimed{false};
+};
+
+ReaderSlot reader_slots[MAX_CONFIG_READERS];
+std::atomic<uint64_t> config_epoch{1};
+std::atomic<uint32_t> unslotted_readers{0};   // Threads past MAX_CONFIG_READERS block reclamation
+
+struct RetiredConfig {
+    const StaticConfig::RuntimeOverrides* config;
+    uint64_t epoch;
+    std::chrono::steady_clock::time_point retired_at;
+};
+
+std::mutex publish_mutex;
+std::vector<RetiredConfig> retired_configs;
+
+struct ThreadReader {
+    ReaderSlot* slot = nullptr;
+    uint32_t depth = 0;     // Nested Snapshots share the outermost one's epoch and snapshot
+    const StaticConfig::RuntimeOverrides* pinned = nullptr;
+    
+    ThreadReader() {
+        for (auto& candidate : reader_slots) {
+            bool expected = false;
+            if (!candidate.claimed.load(std::memory_order_relaxed) &&
+                candidate.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                slot = &candidate;
+                break;
+            }
+        }
+    }
+    
+    ~ThreadReader() {
+        if (slot) {
+            slot->epoch.store(0, std::memory_order_release);
+            slot->claimed.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadReader thread_reader;
+
+bool reclaimable(const RetiredConfig& retired, std::chrono::steady_clock::time_point now) {
+    if (now - retired.retired_at < RETIRED_CONFIG_GRACE ||
+        unslotted_readers.load(std::memory_order_seq_cst) != 0) {
+        return false;
+    }
+    for (const auto& slot : reader_slots) {
+        uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch <= retired.epoch) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+StaticConfig::Snapshot::Snapshot() {
+    ThreadReader& reader = thread_reader;
+    if (reader.depth++ == 0) {
+        if (reader.slot) {
+            reader.slot->epoch.store(config_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        } else {
+            unslotted_readers.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Announce before loading the pointer; pairs with the swap in publish()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        reader.pinned = &runtime();
+    }
+    config_ = reader.pinned;
+}
+
+StaticConfig::Snapshot::~Snapshot() {
+    ThreadReader& reader = thread_reader;
+    if (--reader.depth == 0) {
+        if (reader.slot) {
+            reader.slot->epoch.store(0, std::memory_order_release);
+        } else {
+            unslotted_readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
+
+const StaticConfig::RuntimeOverrides& StaticConfig::defaults() {
+    static const RuntimeOverrides config{};
+    return config;
+}
+
+void StaticConfig::RuntimeOverrides::rebind_endpoints() {
+    if (!market_data_endpoint_storage.empty()) market_data_endpoint = market_data_endpoint_storage.c_str();
+    if (!logger_endpoint_storage.empty()) logger_endpoint = logger_endpoint_storage.c_str();
+    if (!signals_endpoint_storage.empty()) signals_endpoint = signals_endpoint_storage.c_str();
+    if (!executions_endpoint_storage.empty()) executions_endpoint = executions_endpoint_storage.c_str();
+    if (!positions_endpoint_storage.empty()) positions_endpoint = positions_endpoint_storage.c_str();
+}
+
+void StaticConfig::publish(RuntimeOverrides&& next) {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    
+    next.generation = runtime().generation + 1;
+    auto* fresh = new RuntimeOverrides(std::move(next));
+    fresh->rebind_endpoints();
+    
+    const RuntimeOverrides* previous = current_.exchange(fresh, std::memory_order_seq_cst);
+    uint64_t epoch = config_epoch.fetch_add(1, std::memory_order_seq_cst);
+    auto now = std::chrono::steady_clock::now();
+    if (previous) {
+        retired_configs.push_back({previous, epoch, now});
+    }
+    
+    size_t kept = 0;
+    for (const auto& retired : retired_configs) {
+        if (reclaimable(retired, now)) {
+            delete retired.config;
+        } else {
+            retired_configs[kept++] = retired;
+        }
+    }
+    retired_configs.resize(kept);
+}
+
+size_t StaticConfig::get_retired_config_count() {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    return retired_configs.size();
+}
 
 bool StaticConfig::load_from_file(const char* filename) {
     // Try multiple possible paths to make it always succeed
@@ -41,6 +183,11 @@ bool StaticConfig::load_from_file(const char* filename) {
     
     std::cout << "[StaticConfig] Found config file at: " << successful_path << std::endl;
     
+    // Keys absent from the file keep their current values
+    RuntimeOverrides next = runtime();
+    next.rebind_endpoints();
+    next.source_path = successful_path;
+    
     std::string line;
     int line_number = 0;
     
@@ -70,43 +217,166 @@ bool StaticConfig::load_from_file(const char* filename) {
         // Parse configuration values using constexpr string comparisons where possible
         if (key == "market_data.endpoint") {
             // For endpoints, we need to store the string (allocation required)
-            static std::string market_data_endpoint_storage = value;
-            runtime.market_data_endpoint = market_data_endpoint_storage.c_str();
+            next.market_data_endpoint_storage = value;
+            next.market_data_endpoint = next.market_data_endpoint_storage.c_str();
         }
         else if (key == "logger.endpoint") {
-            static std::string logger_endpoint_storage = value;
-            runtime.logger_endpoint = logger_endpoint_storage.c_str();
+            next.logger_endpoint_storage = value;
+            next.logger_endpoint = next.logger_endpoint_storage.c_str();
+        }
+        else if (key == "timing.config_reload_check_ms") {
+            next.config_reload_check_ms = std::stoi(value);
+        }
+        else if (key == "timing.order_execution_min_delay_ms") {
+            next.order_execution_min_delay_ms = std::stoi(value);
+        }
+        else if (key == "timing.order_execution_max_delay_ms") {
+            next.order_execution_max_delay_ms = std::stoi(value);
         }
         else if (key == "market_data.enable_dpdk") {
-            runtime.enable_dpdk = (value == "true");
+            next.enable_dpdk = (value == "true");
         }
         else if (key == "market_data.source") {
-            runtime.market_data_source = value;
+            next.market_data_source = value;
+        }
+        else if (key == "market_data.pcap_file") {
+            next.pcap_file_path = value;
+        }
+        else if (key == "market_data.pcap_format") {
+            next.pcap_format = value;
+        }
+        else if (key == "market_data.replay_speed") {
+            next.replay_speed = std::stod(value);
+        }
+        else if (key == "market_data.loop_replay") {
+            next.loop_replay = (value == "true");
+        }
+        else if (key == "market_data.itch_max_orders") {
+            next.itch_max_orders = std::stoull(value);
+        }
+        else if (key == "market_data.pcap_batch_size") {
+            next.pcap_batch_size = std::stoull(value);
+        }
+        else if (key == "market_data.pcap_prefetch_distance") {
+            next.pcap_prefetch_distance = std::stoull(value);
+        }
+        else if (key == "market_data.batch_packet_quotes") {
+            next.batch_packet_quotes = (value == "true");
+        }
+        else if (key == "market_data.feed_a_group") {
+            next.feed_a_group = value;
+        }
+        else if (key == "market_data.feed_a_port") {
+            next.feed_a_port = std::stoi(value);
+        }
+        else if (key == "market_data.feed_b_group") {
+            next.feed_b_group = value;
+        }
+        else if (key == "market_data.feed_b_port") {
+            next.feed_b_port = std::stoi(value);
+        }
+        else if (key == "market_data.feed_interface") {
+            next.feed_interface = value;
+        }
+        else if (key == "market_data.feed_rx_burst") {
+            next.feed_rx_burst = std::stoi(value);
+        }
+        else if (key == "market_data.feed_hold_slots") {
+            next.feed_hold_slots = std::stoull(value);
+        }
+        else if (key == "market_data.feed_gap_timeout_us") {
+            next.feed_gap_timeout_us = std::stoi(value);
+        }
+        else if (key == "market_data.dpdk_port_id") {
+            next.dpdk_port_id = std::stoi(value);
+        }
+        else if (key == "market_data.dpdk_eal_args") {
+            next.dpdk_eal_args = value;
+        }
+        else if (key == "market_data.load_symbols") {
+            next.load_symbols = std::stoi(value);
+        }
+        else if (key == "market_data.load_rate") {
+            next.load_rate = std::stoi(value);
+        }
+        else if (key == "market_data.load_profile") {
+            next.load_profile = value;
+        }
+        else if (key == "market_data.load_seed") {
+            next.load_seed = std::stoull(value);
         }
         else if (key == "logger.enable_io_uring") {
-            runtime.enable_io_uring = (value == "true");
+            next.enable_io_uring = (value == "true");
+        }
+        else if (key == "logger.write_buffer_kb") {
+            next.logger_write_buffer_kb = std::stoi(value);
+        }
+        else if (key == "logger.preallocate_mb") {
+            next.logger_preallocate_mb = std::stoi(value);
+        }
+        else if (key == "logger.rotate_size_mb") {
+            next.logger_rotate_size_mb = std::stoi(value);
+        }
+        else if (key == "logger.rotate_interval_seconds") {
+            next.logger_rotate_interval_seconds = std::stoi(value);
+        }
+        else if (key == "logger.direct_io") {
+            next.logger_direct_io = (value == "true");
+        }
+        else if (key == "journal.enabled") {
+            next.journal_enabled = (value == "true");
+        }
+        else if (key == "journal.directory") {
+            next.journal_directory = value;
+        }
+        else if (key == "journal.sync_interval_ms") {
+            next.journal_sync_interval_ms = std::stoi(value);
+        }
+        else if (key == "journal.snapshot_interval_seconds") {
+            next.journal_snapshot_interval_seconds = std::stoi(value);
+        }
+        else if (key == "capture.enabled") {
+            next.capture_enabled = (value == "true");
+        }
+        else if (key == "capture.directory") {
+            next.capture_directory = value;
+        }
+        else if (key == "profiler.directory") {
+            next.profiler_directory = value;
+        }
+        else if (key == "profiler.max_seconds") {
+            next.profiler_max_seconds = std::stoi(value);
+        }
+        else if (key == "profiler.pmu_counters") {
+            next.profiler_pmu_counters = (value == "true");
+        }
+        else if (key == "profiler.alloc_guard") {
+            next.profiler_alloc_guard = value;
+        }
+        else if (key == "jitter.threshold_ns") {
+            next.jitter_threshold_ns = std::stoi(value);
         }
         else if (key == "trading.enabled") {
-            runtime.trading_enabled = (value == "true");
+            next.trading_enabled = (value == "true");
         }
         else if (key == "trading.paper_mode") {
-            runtime.paper_trading = (value == "true");
+            next.paper_trading = (value == "true");
         }
         else if (key == "mock_data.enabled") {
-            runtime.mock_data_enabled = (value == "true");
+            next.mock_data_enabled = (value == "true");
         }
         else if (key == "logging.console") {
-            runtime.log_to_console = (value == "true");
+            next.log_to_console = (value == "true");
         }
         else if (key == "logging.level") {
-            runtime.log_level = get_log_level_from_string(value.c_str());
+            next.log_level = get_log_level_from_string(value.c_str());
         }
         else if (key == "mock_data.frequency_hz") {
-            runtime.mock_data_frequency_hz = std::stoi(value);
+            next.mock_data_frequency_hz = std::stoi(value);
         }
         else if (key == "mock_data.symbols") {
             // Parse comma-separated symbol list
-            runtime.symbols.clear();
+            next.symbols.clear();
             std::istringstream iss(value);
             std::string symbol;
             while (std::getline(iss, symbol, ',')) {
@@ -114,79 +384,322 @@ bool StaticConfig::load_from_file(const char* filename) {
                 symbol.erase(0, symbol.find_first_not_of(" \t"));
                 symbol.erase(symbol.find_last_not_of(" \t") + 1);
                 if (!symbol.empty()) {
-                    runtime.symbols.push_back(symbol);
+                    next.symbols.push_back(symbol);
                 }
             }
         }
         else if (key == "risk.max_position_value") {
-            runtime.max_position_value = std::stod(value);
+            next.max_position_value = std::stod(value);
         }
         else if (key == "risk.max_daily_loss") {
-            runtime.max_daily_loss = std::stod(value);
+            next.max_daily_loss = std::stod(value);
         }
         else if (key == "risk.position_limit_per_symbol") {
-            runtime.position_limit_per_symbol = std::stoi(value);
+            next.position_limit_per_symbol = std::stoi(value);
+        }
+        else if (key == "risk.max_order_quantity") {
+            next.max_order_quantity = std::stoi(value);
+        }
+        else if (key == "risk.max_order_notional") {
+            next.max_order_notional = std::stod(value);
+        }
+        else if (key == "risk.price_band_ratio") {
+            next.price_band_ratio = std::stod(value);
+        }
+        else if (key == "risk.max_orders_per_second") {
+            next.max_orders_per_second = std::stoi(value);
+        }
+        else if (key == "risk.position_publish_interval_ms") {
+            next.position_publish_interval_ms = std::stoi(value);
+        }
+        else if (key == "risk.max_gross_exposure") {
+            next.max_gross_exposure = std::stod(value);
+        }
+        else if (key == "risk.max_net_exposure") {
+            next.max_net_exposure = std::stod(value);
+        }
+        else if (key == "risk.max_sector_exposure") {
+            next.max_sector_exposure = std::stod(value);
+        }
+        else if (key == "risk.max_value_at_risk") {
+            next.max_value_at_risk = std::stod(value);
+        }
+        else if (key == "risk.factor_daily_volatility") {
+            next.factor_daily_volatility = std::stod(value);
+        }
+        else if (key == "risk.symbol_daily_volatility") {
+            next.symbol_daily_volatility = std::stod(value);
+        }
+        else if (key == "risk.var_z") {
+            next.var_z = std::stod(value);
+        }
+        else if (key.rfind("risk.symbol.", 0) == 0) {
+            next.risk_symbols[key.substr(12)] = value;
+        }
+        else if (key == "kill_switch.name") {
+            next.kill_switch_name = value;
+        }
+        else if (key == "kill_switch.ack_timeout_ms") {
+            next.kill_switch_ack_timeout_ms = std::stoi(value);
+        }
+        else if (key.rfind("tick_size.", 0) == 0) {
+            price_t tick = to_fixed_price(std::stod(value));
+            if (tick > 0) {
+                std::string symbol = key.substr(10);
+                if (symbol == "default") {
+                    next.default_tick = tick;
+                } else {
+                    next.symbol_ticks[symbol] = tick;
+                }
+            }
+        }
+        else if (key.rfind("thread.", 0) == 0) {
+            next.thread_plan[key.substr(7)] = value;
+        }
+        else if (key.rfind("venue.", 0) == 0) {
+            next.venues[key.substr(6)] = value;
+        }
+        else if (key == "router.latency_cost_per_ms") {
+            next.router_latency_cost_per_ms = std::stod(value);
+        }
+        else if (key == "router.quote_max_age_ms") {
+            next.router_quote_max_age_ms = std::stoi(value);
+        }
+        else if (key == "router.score_refresh_ms") {
+            next.router_score_refresh_ms = std::stoi(value);
+        }
+        else if (key == "fix.host") {
+            next.fix_host = value;
+        }
+        else if (key == "fix.port") {
+            next.fix_port = std::stoi(value);
+        }
+        else if (key == "fix.begin_string") {
+            next.fix_begin_string = value;
+        }
+        else if (key == "fix.sender_comp_id") {
+            next.fix_sender_comp_id = value;
+        }
+        else if (key == "fix.target_comp_id") {
+            next.fix_target_comp_id = value;
+        }
+        else if (key == "fix.account") {
+            next.fix_account = value;
+        }
+        else if (key == "fix.heartbeat_interval_seconds") {
+            next.fix_heartbeat_interval_seconds = std::stoi(value);
+        }
+        else if (key == "fix.reconnect_interval_seconds") {
+            next.fix_reconnect_interval_seconds = std::stoi(value);
+        }
+        else if (key == "fix.reset_on_logon") {
+            next.fix_reset_on_logon = (value == "true");
         }
         else if (key == "strategy.momentum.threshold") {
-            runtime.momentum_threshold = std::stod(value);
+            next.momentum_threshold = std::stod(value);
         }
         else if (key == "strategy.momentum.min_signal_interval_ms") {
-            runtime.min_signal_interval_ms = std::stoi(value);
+            next.min_signal_interval_ms = std::stoi(value);
+        }
+        else if (key == "strategy.busy_poll") {
+            next.strategy_busy_poll = (value == "true");
+        }
+        else if (key == "strategy.busy_poll_cpu") {
+            next.strategy_busy_poll_cpu = std::stoi(value);
+        }
+        else if (key == "strategy.worker_threads") {
+            next.strategy_worker_threads = std::stoi(value);
+        }
+        else if (key == "strategy.worker_first_cpu") {
+            next.strategy_worker_first_cpu = std::stoi(value);
+        }
+        else if (key == "memory.hot_arena_mb") {
+            next.hot_arena_mb = std::stoi(value);
+        }
+        else if (key == "memory.hot_arena_page_size") {
+            next.hot_arena_page_size = value;
+        }
+        else if (key == "memory.hot_arena_prefault") {
+            next.hot_arena_prefault = (value == "true");
+        }
+        else if (key == "warmup.enabled") {
+            next.warmup_enabled = (value == "true");
+        }
+        else if (key == "warmup.round_events") {
+            next.warmup_round_events = std::stoi(value);
+        }
+        else if (key == "warmup.max_rounds") {
+            next.warmup_max_rounds = std::stoi(value);
+        }
+        else if (key == "warmup.stable_rounds") {
+            next.warmup_stable_rounds = std::stoi(value);
+        }
+        else if (key == "warmup.tolerance") {
+            next.warmup_tolerance = std::stod(value);
+        }
+        else if (key == "warmup.required_for_start") {
+            next.warmup_required_for_start = (value == "true");
+        }
+        else if (key == "zmq.send_hwm") {
+            next.zmq_send_hwm = std::stoi(value);
+        }
+        else if (key == "zmq.recv_hwm") {
+            next.zmq_recv_hwm = std::stoi(value);
+        }
+        else if (key == "zmq.linger") {
+            next.zmq_linger_ms = std::stoi(value);
+        }
+        else if (key == "zmq.io_threads") {
+            next.zmq_io_threads = std::stoi(value);
+        }
+        else if (key == "zmq.io_thread_cpus") {
+            // Comma-separated CPU list
+            next.zmq_io_thread_cpus.clear();
+            std::istringstream iss(value);
+            std::string cpu;
+            while (std::getline(iss, cpu, ',')) {
+                if (cpu.find_first_not_of(" \t") != std::string::npos) {
+                    next.zmq_io_thread_cpus.push_back(std::stoi(cpu));
+                }
+            }
+        }
+        else if (key == "zmq.immediate") {
+            next.zmq_immediate = (value == "true");
+        }
+        else if (key == "zmq.zero_copy") {
+            next.zmq_zero_copy = (value == "true");
+        }
+        else if (key == "zmq.endpoint_scheme") {
+            next.zmq_endpoint_scheme = value;
+        }
+        else if (key == "zmq.ipc_dir") {
+            next.zmq_ipc_dir = value;
+        }
+        else if (key == "market_data.multicast_endpoint") {
+            next.market_data_multicast_endpoint = value;
+        }
+        else if (key == "market_data.multicast_subscribe") {
+            next.market_data_multicast_subscribe = (value == "true");
+        }
+        else if (key == "multicast.interface") {
+            next.multicast_interface = value;
+        }
+        else if (key == "multicast.ttl") {
+            next.multicast_ttl = std::stoi(value);
+        }
+        else if (key == "multicast.retransmit_ring") {
+            next.multicast_retransmit_ring = std::stoi(value);
+        }
+        else if (key == "multicast.heartbeat_ms") {
+            next.multicast_heartbeat_ms = std::stoi(value);
+        }
+        // Dashboard servers
+        else if (key == "websocket.port") {
+            next.websocket_port = std::stoi(value);
+        }
+        else if (key == "control_api.port") {
+            next.control_api_port = std::stoi(value);
+        }
+        else if (key == "http.max_connections") {
+            next.http_max_connections = std::stoi(value);
+        }
+        else if (key == "http.send_queue_limit_kb") {
+            next.http_send_queue_limit_kb = std::stoi(value);
+        }
+        else if (key == "websocket.broadcast_interval_ms") {
+            next.websocket_broadcast_interval_ms = std::stoi(value);
+        }
+        else if (key == "websocket.binary_keyframe_interval") {
+            next.websocket_binary_keyframe_interval = std::stoi(value);
         }
         // Alpaca configuration
         else if (key == "alpaca.api_key") {
-            runtime.alpaca_api_key = value;
+            next.alpaca_api_key = value;
         }
         else if (key == "alpaca.secret_key") {
-            runtime.alpaca_secret_key = value;
+            next.alpaca_secret_key = value;
         }
         else if (key == "alpaca.paper_trading") {
-            runtime.alpaca_paper_trading = (value == "true");
+            next.alpaca_paper_trading = (value == "true");
         }
         else if (key == "alpaca.websocket_feed") {
-            runtime.alpaca_websocket_feed = value;
+            next.alpaca_websocket_feed = value;
         }
         else if (key == "alpaca.websocket_url") {
-            runtime.alpaca_websocket_url = value;
+            next.alpaca_websocket_url = value;
         }
         else if (key == "alpaca.websocket_host") {
-            runtime.alpaca_websocket_host = value;
+            next.alpaca_websocket_host = value;
         }
         else if (key == "alpaca.max_symbols_per_request") {
-            runtime.alpaca_max_symbols_per_request = std::stoi(value);
+            next.alpaca_max_symbols_per_request = std::stoi(value);
         }
         else if (key == "alpaca.max_message_size_kb") {
-            runtime.alpaca_max_message_size_kb = std::stoi(value);
+            next.alpaca_max_message_size_kb = std::stoi(value);
         }
         else if (key == "alpaca.reconnect_interval_seconds") {
-            runtime.alpaca_reconnect_interval_seconds = std::stoi(value);
+            next.alpaca_reconnect_interval_seconds = std::stoi(value);
         }
         else if (key == "alpaca.max_reconnect_attempts") {
-            runtime.alpaca_max_reconnect_attempts = std::stoi(value);
+            next.alpaca_max_reconnect_attempts = std::stoi(value);
         }
         else if (key == "alpaca.auth_timeout_seconds") {
-            runtime.alpaca_auth_timeout_seconds = std::stoi(value);
+            next.alpaca_auth_timeout_seconds = std::stoi(value);
         }
         else if (key == "alpaca.circuit_breaker_failures") {
-            runtime.alpaca_circuit_breaker_failures = std::stoi(value);
+            next.alpaca_circuit_breaker_failures = std::stoi(value);
         }
         else if (key == "alpaca.circuit_breaker_timeout_minutes") {
-            runtime.alpaca_circuit_breaker_timeout_minutes = std::stoi(value);
+            next.alpaca_circuit_breaker_timeout_minutes = std::stoi(value);
+        }
+        else if (key == "alpaca.order_connections") {
+            next.alpaca_order_connections = std::stoi(value);
+        }
+        else if (key == "alpaca.stream_connections") {
+            next.alpaca_stream_connections = std::stoi(value);
+        }
+        else if (key == "alpaca.merge_window_us") {
+            next.alpaca_merge_window_us = std::stoi(value);
+        }
+        else if (key == "alpaca.rate_limit_per_minute") {
+            next.alpaca_rate_limit_per_minute = std::stoi(value);
+        }
+        else if (key == "alpaca.rate_limit_burst") {
+            next.alpaca_rate_limit_burst = std::stoi(value);
         }
         // Ignore unknown keys silently for forward compatibility
     }
     
     file.close();
     
-    if (!validate_config()) {
-        std::cerr << "[StaticConfig] Error: Invalid configuration after loading from " << filename << std::endl;
+    // Every service reads this file, so padding the list here gives the
+    // synthetic symbols the same preloaded IDs in all of them
+    if (next.market_data_source == "load") {
+        for (int i = 0; static_cast<int>(next.symbols.size()) < next.load_symbols; ++i) {
+            char name[16];
+            std::snprintf(name, sizeof(name), "LT%05d", i);
+            next.symbols.push_back(name);
+        }
+    }
+    
+    if (!validate(next)) {
+        std::cerr << "[StaticConfig] Error: Invalid configuration in " << filename
+                  << ", keeping the current one" << std::endl;
         return false;
     }
     
+    publish(std::move(next));
+    
     std::cout << "[StaticConfig] Successfully loaded configuration from " << filename << std::endl;
     return true;
 }
 
+bool StaticConfig::reload() {
+    // Copied: the load replaces the snapshot it points into
+    std::string path = runtime().source_path;
+    return load_from_file(path.empty() ? "config/hft_config.conf" : path.c_str());
+}
+
 std::string StaticConfig::to_string() {
     std::ostringstream oss;
     
@@ -205,13 +718,17 @@ std::string StaticConfig::to_string() {
     oss << "    paper_trading: " << (get_paper_trading() ? "true" : "false") << "\n";
     oss << "    mock_data_enabled: " << (get_mock_data_enabled() ? "true" : "false") << "\n";
     oss << "    log_to_console: " << (get_log_to_console() ? "true" : "false") << "\n";
+    oss << "    strategy_busy_poll: " << (get_strategy_busy_poll() ? "true" : "false") << "\n";
     
     oss << "  Parameters:\n";
     oss << "    log_level: " << get_log_level() << "\n";
+    oss << "    strategy_worker_threads: " << get_strategy_worker_threads() << "\n";
     oss << "    mock_data_frequency_hz: " << get_mock_data_frequency_hz() << "\n";
     oss << "    max_position_value: " << get_max_position_value() << "\n";
     oss << "    max_daily_loss: " << get_max_daily_loss() << "\n";
     oss << "    position_limit_per_symbol: " << get_position_limit_per_symbol() << "\n";
+    oss << "    max_order_quantity: " << get_max_order_quantity() << "\n";
+    oss << "    max_order_notional: " << get_max_order_notional() << "\n";
     oss << "    momentum_threshold: " << get_momentum_threshold() << "\n";
     oss << "    min_signal_interval_ms: " << get_min_signal_interval_ms() << "\n";
     
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <cstring>
 #include <vector>
 #include <unordered_map>
+#include "fixed_price.h"
 
 namespace hft {
 
@@ -17,12 +20,12 @@ public:
     static constexpr const char* SIGNALS_ENDPOINT = "tcp://localhost:5558";
     static constexpr const char* EXECUTIONS_ENDPOINT = "tcp://localhost:5557";
     static constexpr const char* POSITIONS_ENDPOINT = "tcp://localhost:5559";
-    static constexpr const char* CONTROL_ENDPOINT = "tcp://localhost:8080";
-    static constexpr const char* WEBSOCKET_ENDPOINT = "tcp://localhost:8081";
+    static constexpr const char* CONTROL_ENDPOINT = "tcp://localhost:8081";
+    static constexpr const char* WEBSOCKET_ENDPOINT = "tcp://localhost:8080";
     
     // Port numbers as integers for direct use
-    static constexpr int CONTROL_API_PORT = 8080;
-    static constexpr int WEBSOCKET_PORT = 8081;
+    static constexpr int CONTROL_API_PORT = 8081;
+    static constexpr int WEBSOCKET_PORT = 8080;
     static constexpr int MARKET_DATA_PORT = 5556;
     static constexpr int LOGGER_PORT = 5555;
     static constexpr int SIGNALS_PORT = 5558;
@@ -33,6 +36,19 @@ public:
     static constexpr int ZMQ_SEND_HWM = 1000;
     static constexpr int ZMQ_RECV_HWM = 1000;
     static constexpr int ZMQ_LINGER_MS = 0;
+    static constexpr int ZMQ_IO_THREADS = 1;             // Per service context
+    static constexpr bool ZMQ_IMMEDIATE = false;         // Queue only to completed connections
+    static constexpr bool ZMQ_ZERO_COPY = true;          // Send from pooled buffers (zmq_msg_init_data)
+    static constexpr const char* ZMQ_ENDPOINT_SCHEME = "tcp";  // Data endpoints: "tcp", "ipc" or "inproc"
+    static constexpr const char* ZMQ_IPC_DIR = "/tmp";
+    
+    // Market data to other hosts over reliable multicast (multicast_transport.h)
+    static constexpr const char* MARKET_DATA_MULTICAST_ENDPOINT = "";   // rmcast://group:port; empty = off
+    static constexpr bool MARKET_DATA_MULTICAST_SUBSCRIBE = false;      // Strategy engine reads it instead of ZMQ
+    static constexpr const char* MULTICAST_INTERFACE = "";
+    static constexpr int MULTICAST_TTL = 1;
+    static constexpr int MULTICAST_RETRANSMIT_RING = 4096;
+    static constexpr int MULTICAST_HEARTBEAT_MS = 100;
     
     // Feature flags
     static constexpr bool ENABLE_DPDK = false;
@@ -41,31 +57,125 @@ public:
     static constexpr bool PAPER_TRADING = true;
     static constexpr bool LOG_TO_CONSOLE = true;
     
+    // Logger service file writer
+    static constexpr int LOGGER_WRITE_BUFFER_KB = 2048;          // Each of two write buffers
+    static constexpr int LOGGER_PREALLOCATE_MB = 256;            // fallocate'd per file (0 = off)
+    static constexpr int LOGGER_ROTATE_SIZE_MB = 256;            // 0 = no size rotation
+    static constexpr int LOGGER_ROTATE_INTERVAL_SECONDS = 3600;  // 0 = no time rotation
+    static constexpr bool LOGGER_DIRECT_IO = true;
+    
+    // Event journal for positions and working orders (EventJournal)
+    static constexpr bool JOURNAL_ENABLED = true;
+    static constexpr const char* JOURNAL_DIRECTORY = "journal";
+    static constexpr int JOURNAL_SYNC_INTERVAL_MS = 5;            // Group commit: at most one fdatasync per interval
+    static constexpr int JOURNAL_SNAPSHOT_INTERVAL_SECONDS = 60;  // 0 = never compact
+    
+    // Input capture for deterministic replay (MessageCapture)
+    static constexpr bool CAPTURE_ENABLED = false;
+    static constexpr const char* CAPTURE_DIRECTORY = "capture";
+    
+    // Sampling profiler windows (SamplingProfiler)
+    static constexpr const char* PROFILER_DIRECTORY = "profiles";
+    static constexpr int PROFILER_MAX_SECONDS = 300;
+    static constexpr bool PROFILER_PMU_COUNTERS = false;   // Hardware counters around HFT_PMU_SCOPE regions
+    static constexpr const char* PROFILER_ALLOC_GUARD = "record";   // off, record or abort; HFT_ALLOC_TRACKING builds
+    static constexpr int JITTER_THRESHOLD_NS = 1000;        // JitterMonitor: shorter TSC gaps are just the loop
+    
     // Transport configuration
     static constexpr const char* DEFAULT_TRANSPORT_TYPE = "zeromq";  // "zeromq" or "spmc"
     static constexpr size_t DEFAULT_RING_BUFFER_SIZE = 1024 * 1024; // 1MB for SPMC
     
+    // Feed decoding
+    static constexpr size_t ITCH_MAX_ORDERS = 1 << 21;   // Live orders tracked by the ITCH decoder
+    static constexpr size_t PCAP_BATCH_SIZE = 64;        // Packets parsed per pass over the mapped capture
+    static constexpr size_t PCAP_PREFETCH_DISTANCE = 4;  // Packets ahead to prefetch (0 = off)
+    static constexpr bool BATCH_PACKET_QUOTES = true;    // One MarketDataBatch per feed packet (pcap, multicast)
+    
+    // Live multicast feed (market_data.source=multicast)
+    static constexpr const char* FEED_A_GROUP = "233.54.12.111";
+    static constexpr int FEED_A_PORT = 26477;
+    static constexpr const char* FEED_B_GROUP = "233.49.196.111";   // Empty = A line only
+    static constexpr int FEED_B_PORT = 26477;
+    static constexpr const char* FEED_INTERFACE = "0.0.0.0";       // Local address to join the groups on
+    static constexpr int FEED_RX_BURST = 32;                         // Packets per poll
+    static constexpr size_t FEED_HOLD_SLOTS = 64;                    // Out-of-order packets kept during a gap
+    static constexpr int FEED_GAP_TIMEOUT_US = 200;                  // Wait for the other line before declaring loss
+    static constexpr int DPDK_PORT_ID = 0;
+    static constexpr const char* DPDK_EAL_ARGS = "--in-memory";
+    
     // Trading parameters
     static constexpr double MAX_POSITION_VALUE = 100000.0;
     static constexpr double MAX_DAILY_LOSS = 5000.0;
     static constexpr int POSITION_LIMIT_PER_SYMBOL = 1000;
     
+    // Gateway pre-trade checks (0 = check off)
+    static constexpr int MAX_ORDER_QUANTITY = 500;
+    static constexpr double MAX_ORDER_NOTIONAL = 50000.0;
+    static constexpr double PRICE_BAND_RATIO = 0.05;     // Limit price within 5% of reference
+    static constexpr int MAX_ORDERS_PER_SECOND = 20;     // Per symbol
+    static constexpr int POSITION_PUBLISH_INTERVAL_MS = 100;  // PositionUpdate batch coalescing
+    
+    // Portfolio limits in the risk service (PortfolioRisk; 0 = limit off)
+    static constexpr double MAX_GROSS_EXPOSURE = 0.0;
+    static constexpr double MAX_NET_EXPOSURE = 0.0;
+    static constexpr double MAX_SECTOR_EXPOSURE = 0.0;
+    static constexpr double MAX_VALUE_AT_RISK = 0.0;
+    static constexpr double FACTOR_DAILY_VOLATILITY = 0.012;  // Market factor, for VaR
+    static constexpr double SYMBOL_DAILY_VOLATILITY = 0.02;   // Idiosyncratic default
+    static constexpr double VAR_Z = 2.33;                     // 99% one-sided
+    
+    // Out-of-band kill switch (KillSwitch): a flag word in shared memory
+    static constexpr const char* KILL_SWITCH_NAME = "hft_kill_switch";
+    static constexpr int KILL_SWITCH_ACK_TIMEOUT_MS = 50;  // Control API waits this long for "no new orders"
+    
     // Strategy parameters
     static constexpr double MOMENTUM_THRESHOLD = 0.001;  // 0.1%
     static constexpr int MIN_SIGNAL_INTERVAL_MS = 1000;
     
+    // Strategy engine receive path
+    static constexpr bool STRATEGY_BUSY_POLL = false;    // Spin on recv instead of zmq::poll
+    static constexpr int STRATEGY_BUSY_POLL_CPU = 1;     // Core for the spinning thread
+    static constexpr int STRATEGY_WORKER_THREADS = 0;    // Symbol shards; 0 = strategies on the receive thread
+    static constexpr int STRATEGY_WORKER_FIRST_CPU = 2;  // Worker i is pinned to first_cpu + i
+    
+    // Hot-state arena (HugePageArena::hot)
+    static constexpr int HOT_ARENA_MB = 64;
+    static constexpr const char* HOT_ARENA_PAGE_SIZE = "2M";    // "2M", "1G" or "none"
+    static constexpr bool HOT_ARENA_PREFAULT = true;             // Touch and mlock at startup
+    
+    // Warmup phase before START_TRADING is accepted (Warmup)
+    static constexpr bool WARMUP_ENABLED = true;
+    static constexpr int WARMUP_ROUND_EVENTS = 2000;     // Synthetic events per measured round
+    static constexpr int WARMUP_MAX_ROUNDS = 50;         // Give up (and report unstable) after this
+    static constexpr int WARMUP_STABLE_ROUNDS = 3;       // Consecutive rounds within tolerance
+    static constexpr double WARMUP_TOLERANCE = 0.10;     // Allowed p99 change between rounds
+    static constexpr bool WARMUP_REQUIRED_FOR_START = true;  // ControlAPI refuses START until warm
+    
     // Mock data parameters
     static constexpr bool MOCK_DATA_ENABLED = true;
     static constexpr int MOCK_DATA_FREQUENCY_HZ = 100;
     
+    // Synthetic load (market_data.source=load)
+    static constexpr int LOAD_SYMBOLS = 10000;           // Symbol list padded to this many (LT00000, LT00001, ...)
+    static constexpr int LOAD_RATE = 1000000;            // Quotes per second at the profile's baseline
+    static constexpr const char* LOAD_PROFILE = "open";  // "flat", "open" or "bursts"
+    static constexpr uint64_t LOAD_SEED = 1;
+    
     // Metrics publisher ports (one per service)
     static constexpr int STRATEGY_ENGINE_METRICS_PORT = 5561;
     static constexpr int MARKET_DATA_HANDLER_METRICS_PORT = 5562;
     static constexpr int ORDER_GATEWAY_METRICS_PORT = 5563;
     static constexpr int POSITION_RISK_SERVICE_METRICS_PORT = 5564;
+    static constexpr int LOW_LATENCY_LOGGER_METRICS_PORT = 5565;
     static constexpr int METRICS_AGGREGATOR_PORT = 5560;
     static constexpr int CONTROL_COMMANDS_PORT = 5570;
     
+    // Dashboard HTTP/WebSocket servers
+    static constexpr int HTTP_MAX_CONNECTIONS = 256;
+    static constexpr int HTTP_SEND_QUEUE_LIMIT_KB = 1024;            // Per client; a backlogged client skips broadcasts
+    static constexpr int WEBSOCKET_BROADCAST_INTERVAL_MS = 100;      // Also the binary stream's flush interval
+    static constexpr int WEBSOCKET_BINARY_KEYFRAME_INTERVAL = 50;    // Flushes between full binary snapshots
+    
     // Service-specific timing parameters (milliseconds)
     static constexpr int DEFAULT_POLL_TIMEOUT_MS = 100;
     static constexpr int STATS_INTERVAL_SECONDS = 10;
@@ -76,6 +186,7 @@ public:
     static constexpr int ORDER_EXECUTION_MAX_DELAY_MS = 100;
     static constexpr int METRICS_UPDATE_INTERVAL_SECONDS = 5;
     static constexpr int METRICS_PUBLISHER_INTERVAL_MS = 2000;
+    static constexpr int CONFIG_RELOAD_CHECK_MS = 1000;   // Config file change poll (0 = reload on request only)
     
     // Mock data generation parameters
     static constexpr double DEFAULT_PRICE_CHANGE_VOLATILITY = 0.01; // 1%
@@ -93,9 +204,23 @@ public:
     static constexpr int ALPACA_RECONNECT_INTERVAL_SECONDS = 30;
     static constexpr int ALPACA_MAX_RECONNECT_ATTEMPTS = 10;
     static constexpr int ALPACA_AUTH_TIMEOUT_SECONDS = 10;
-    static constexpr int ALPACA_RATE_LIMIT_PER_MINUTE = 200;
+    static constexpr int ALPACA_RATE_LIMIT_PER_MINUTE = 200;   // Order entry messages, place and replace
+    static constexpr int ALPACA_RATE_LIMIT_BURST = 10;
     static constexpr int ALPACA_CIRCUIT_BREAKER_FAILURES = 5;
     static constexpr int ALPACA_CIRCUIT_BREAKER_TIMEOUT_MINUTES = 1;
+    static constexpr int ALPACA_ORDER_CONNECTIONS = 4;     // Keep-alive sockets for async order entry
+    static constexpr int ALPACA_STREAM_CONNECTIONS = 1;    // Market data websockets the symbols are sharded over
+    static constexpr int ALPACA_MERGE_WINDOW_US = 500;     // Longest a quote waits for the other connections
+    
+    // Smart order routing across venue.* (OrderGateway's VenueRouter)
+    static constexpr double ROUTER_LATENCY_COST_PER_MS = 0.0001;   // USD per share per ms of p90 ack latency
+    static constexpr int ROUTER_QUOTE_MAX_AGE_MS = 1000;           // Older venue quotes count as absent
+    static constexpr int ROUTER_SCORE_REFRESH_MS = 1000;           // Latency feedback into venue scores
+    
+    // FIX order entry, for venues of kind fix (OrderGateway's FixSession)
+    static constexpr const char* FIX_BEGIN_STRING = "FIX.4.4";
+    static constexpr int FIX_HEARTBEAT_INTERVAL_SECONDS = 30;
+    static constexpr int FIX_RECONNECT_INTERVAL_SECONDS = 5;
     
     // Log levels (enum converted to constexpr ints for performance)
     static constexpr int LOG_LEVEL_DEBUG = 1;
@@ -132,6 +257,9 @@ public:
     
     // Runtime configuration override support (for file-based config)
     struct RuntimeOverrides {
+        uint64_t generation = 0;   // Bumped by every successful load_from_file(); 0 = compile-time defaults
+        std::string source_path;   // File the last successful load read
+        
         const char* market_data_endpoint = MARKET_DATA_ENDPOINT;
         const char* logger_endpoint = LOGGER_ENDPOINT;
         const char* signals_endpoint = SIGNALS_ENDPOINT;
@@ -152,34 +280,127 @@ public:
         bool mock_data_enabled = MOCK_DATA_ENABLED;
         bool log_to_console = LOG_TO_CONSOLE;
         
+        int logger_write_buffer_kb = LOGGER_WRITE_BUFFER_KB;
+        int logger_preallocate_mb = LOGGER_PREALLOCATE_MB;
+        int logger_rotate_size_mb = LOGGER_ROTATE_SIZE_MB;
+        int logger_rotate_interval_seconds = LOGGER_ROTATE_INTERVAL_SECONDS;
+        bool logger_direct_io = LOGGER_DIRECT_IO;
+        
+        bool journal_enabled = JOURNAL_ENABLED;
+        std::string journal_directory = JOURNAL_DIRECTORY;
+        int journal_sync_interval_ms = JOURNAL_SYNC_INTERVAL_MS;
+        int journal_snapshot_interval_seconds = JOURNAL_SNAPSHOT_INTERVAL_SECONDS;
+        
+        bool capture_enabled = CAPTURE_ENABLED;
+        std::string capture_directory = CAPTURE_DIRECTORY;
+        std::string profiler_directory = PROFILER_DIRECTORY;
+        int profiler_max_seconds = PROFILER_MAX_SECONDS;
+        bool profiler_pmu_counters = PROFILER_PMU_COUNTERS;
+        std::string profiler_alloc_guard = PROFILER_ALLOC_GUARD;
+        int jitter_threshold_ns = JITTER_THRESHOLD_NS;
+        
         int log_level = DEFAULT_LOG_LEVEL;
         int mock_data_frequency_hz = MOCK_DATA_FREQUENCY_HZ;
         
         double max_position_value = MAX_POSITION_VALUE;
         double max_daily_loss = MAX_DAILY_LOSS;
         int position_limit_per_symbol = POSITION_LIMIT_PER_SYMBOL;
+        int max_order_quantity = MAX_ORDER_QUANTITY;
+        double max_order_notional = MAX_ORDER_NOTIONAL;
+        double price_band_ratio = PRICE_BAND_RATIO;
+        int max_orders_per_second = MAX_ORDERS_PER_SECOND;
+        int position_publish_interval_ms = POSITION_PUBLISH_INTERVAL_MS;
+        double max_gross_exposure = MAX_GROSS_EXPOSURE;
+        double max_net_exposure = MAX_NET_EXPOSURE;
+        double max_sector_exposure = MAX_SECTOR_EXPOSURE;
+        double max_value_at_risk = MAX_VALUE_AT_RISK;
+        double factor_daily_volatility = FACTOR_DAILY_VOLATILITY;
+        double symbol_daily_volatility = SYMBOL_DAILY_VOLATILITY;
+        double var_z = VAR_Z;
+        // <symbol> -> "<sector>[:<beta>[:<daily vol>[:<max position value>]]]"
+        // (risk.symbol.* in config, see SymbolRiskConfig::parse)
+        std::unordered_map<std::string, std::string> risk_symbols;
+        std::string kill_switch_name = KILL_SWITCH_NAME;
+        int kill_switch_ack_timeout_ms = KILL_SWITCH_ACK_TIMEOUT_MS;
         
         double momentum_threshold = MOMENTUM_THRESHOLD;
         int min_signal_interval_ms = MIN_SIGNAL_INTERVAL_MS;
         
+        bool strategy_busy_poll = STRATEGY_BUSY_POLL;
+        int strategy_busy_poll_cpu = STRATEGY_BUSY_POLL_CPU;
+        int strategy_worker_threads = STRATEGY_WORKER_THREADS;
+        int strategy_worker_first_cpu = STRATEGY_WORKER_FIRST_CPU;
+        
+        int hot_arena_mb = HOT_ARENA_MB;
+        std::string hot_arena_page_size = HOT_ARENA_PAGE_SIZE;
+        bool hot_arena_prefault = HOT_ARENA_PREFAULT;
+        
+        bool warmup_enabled = WARMUP_ENABLED;
+        int warmup_round_events = WARMUP_ROUND_EVENTS;
+        int warmup_max_rounds = WARMUP_MAX_ROUNDS;
+        int warmup_stable_rounds = WARMUP_STABLE_ROUNDS;
+        double warmup_tolerance = WARMUP_TOLERANCE;
+        bool warmup_required_for_start = WARMUP_REQUIRED_FOR_START;
+        
         // Transport configuration
         const char* transport_type = DEFAULT_TRANSPORT_TYPE;
         size_t ring_buffer_size = DEFAULT_RING_BUFFER_SIZE;
         
+        int zmq_send_hwm = ZMQ_SEND_HWM;
+        int zmq_recv_hwm = ZMQ_RECV_HWM;
+        int zmq_linger_ms = ZMQ_LINGER_MS;
+        int zmq_io_threads = ZMQ_IO_THREADS;
+        std::vector<int> zmq_io_thread_cpus;    // Empty: ThreadPlan's zmq_io placement
+        bool zmq_immediate = ZMQ_IMMEDIATE;
+        bool zmq_zero_copy = ZMQ_ZERO_COPY;
+        std::string zmq_endpoint_scheme = ZMQ_ENDPOINT_SCHEME;
+        std::string zmq_ipc_dir = ZMQ_IPC_DIR;
+        std::string market_data_multicast_endpoint = MARKET_DATA_MULTICAST_ENDPOINT;
+        bool market_data_multicast_subscribe = MARKET_DATA_MULTICAST_SUBSCRIBE;
+        std::string multicast_interface = MULTICAST_INTERFACE;
+        int multicast_ttl = MULTICAST_TTL;
+        int multicast_retransmit_ring = MULTICAST_RETRANSMIT_RING;
+        int multicast_heartbeat_ms = MULTICAST_HEARTBEAT_MS;
+        
         // Market data source configuration
-        std::string market_data_source = "mock";  // "mock", "pcap", "alpaca"
+        std::string market_data_source = "mock";  // "mock", "pcap", "alpaca", "multicast", "load"
         std::string pcap_file_path = "data/market_data.pcap";
         std::string pcap_format = "generic_csv";  // "generic_csv", "nasdaq_itch", "nyse_pillar", "iex_tops", "fix"
         double replay_speed = 1.0;
         bool loop_replay = false;
+        size_t itch_max_orders = ITCH_MAX_ORDERS;
+        size_t pcap_batch_size = PCAP_BATCH_SIZE;
+        size_t pcap_prefetch_distance = PCAP_PREFETCH_DISTANCE;
+        bool batch_packet_quotes = BATCH_PACKET_QUOTES;
+        std::string feed_a_group = FEED_A_GROUP;
+        int feed_a_port = FEED_A_PORT;
+        std::string feed_b_group = FEED_B_GROUP;
+        int feed_b_port = FEED_B_PORT;
+        std::string feed_interface = FEED_INTERFACE;
+        int feed_rx_burst = FEED_RX_BURST;
+        size_t feed_hold_slots = FEED_HOLD_SLOTS;
+        int feed_gap_timeout_us = FEED_GAP_TIMEOUT_US;
+        int dpdk_port_id = DPDK_PORT_ID;
+        std::string dpdk_eal_args = DPDK_EAL_ARGS;
+        int load_symbols = LOAD_SYMBOLS;
+        int load_rate = LOAD_RATE;
+        std::string load_profile = LOAD_PROFILE;
+        uint64_t load_seed = LOAD_SEED;
         
         // Metrics publisher ports
         int strategy_engine_metrics_port = STRATEGY_ENGINE_METRICS_PORT;
         int market_data_handler_metrics_port = MARKET_DATA_HANDLER_METRICS_PORT;
         int order_gateway_metrics_port = ORDER_GATEWAY_METRICS_PORT;
         int position_risk_service_metrics_port = POSITION_RISK_SERVICE_METRICS_PORT;
+        int low_latency_logger_metrics_port = LOW_LATENCY_LOGGER_METRICS_PORT;
         int metrics_aggregator_port = METRICS_AGGREGATOR_PORT;
         int control_commands_port = CONTROL_COMMANDS_PORT;
+        int websocket_port = WEBSOCKET_PORT;
+        int control_api_port = CONTROL_API_PORT;
+        int http_max_connections = HTTP_MAX_CONNECTIONS;
+        int http_send_queue_limit_kb = HTTP_SEND_QUEUE_LIMIT_KB;
+        int websocket_broadcast_interval_ms = WEBSOCKET_BROADCAST_INTERVAL_MS;
+        int websocket_binary_keyframe_interval = WEBSOCKET_BINARY_KEYFRAME_INTERVAL;
         
         // Timing parameters
         int poll_timeout_ms = DEFAULT_POLL_TIMEOUT_MS;
@@ -191,6 +412,7 @@ public:
         int order_execution_max_delay_ms = ORDER_EXECUTION_MAX_DELAY_MS;
         int metrics_update_interval_seconds = METRICS_UPDATE_INTERVAL_SECONDS;
         int metrics_publisher_interval_ms = METRICS_PUBLISHER_INTERVAL_MS;
+        int config_reload_check_ms = CONFIG_RELOAD_CHECK_MS;
         
         // Mock data generation parameters
         double price_change_volatility = DEFAULT_PRICE_CHANGE_VOLATILITY;
@@ -217,6 +439,33 @@ public:
             {"TLT", 0.12}, {"VIX", 0.80}, {"TQQQ", 0.60}, {"SQQQ", 0.60}
         };
         
+        // Per-symbol tick size in fixed-point units (tick_size.<SYMBOL> in config)
+        price_t default_tick = DEFAULT_TICK;
+        std::unordered_map<std::string, price_t> symbol_ticks;
+        
+        // Thread placement, <service>.<thread> -> "<cpu>[:hot]" (thread.* in
+        // config, see ThreadPlan)
+        std::unordered_map<std::string, std::string> thread_plan;
+        
+        // Order venues, <name> -> "<kind>[:<taker fee>[:<maker rebate>]]"
+        // (venue.* in config, see VenueConfig::parse); empty routes
+        // everything to the one venue the trading mode implies
+        std::unordered_map<std::string, std::string> venues;
+        double router_latency_cost_per_ms = ROUTER_LATENCY_COST_PER_MS;
+        int router_quote_max_age_ms = ROUTER_QUOTE_MAX_AGE_MS;
+        int router_score_refresh_ms = ROUTER_SCORE_REFRESH_MS;
+        
+        // FIX session; no host leaves fix venues without orders
+        std::string fix_host;
+        int fix_port = 0;
+        std::string fix_begin_string = FIX_BEGIN_STRING;
+        std::string fix_sender_comp_id;
+        std::string fix_target_comp_id;
+        std::string fix_account;
+        int fix_heartbeat_interval_seconds = FIX_HEARTBEAT_INTERVAL_SECONDS;
+        int fix_reconnect_interval_seconds = FIX_RECONNECT_INTERVAL_SECONDS;
+        bool fix_reset_on_logon = false;
+        
         // Alpaca API configuration
         std::string alpaca_api_key;
         std::string alpaca_secret_key;
@@ -230,136 +479,318 @@ public:
         int alpaca_max_reconnect_attempts = ALPACA_MAX_RECONNECT_ATTEMPTS;
         int alpaca_auth_timeout_seconds = ALPACA_AUTH_TIMEOUT_SECONDS;
         int alpaca_rate_limit_per_minute = ALPACA_RATE_LIMIT_PER_MINUTE;
+        int alpaca_rate_limit_burst = ALPACA_RATE_LIMIT_BURST;
         int alpaca_circuit_breaker_failures = ALPACA_CIRCUIT_BREAKER_FAILURES;
         int alpaca_circuit_breaker_timeout_minutes = ALPACA_CIRCUIT_BREAKER_TIMEOUT_MINUTES;
+        int alpaca_order_connections = ALPACA_ORDER_CONNECTIONS;
+        int alpaca_stream_connections = ALPACA_STREAM_CONNECTIONS;
+        int alpaca_merge_window_us = ALPACA_MERGE_WINDOW_US;
+        
+        // Point the endpoint fields at this object's own storage strings
+        void rebind_endpoints();
     };
     
-    // Global runtime overrides (for file-based configuration)
-    static RuntimeOverrides runtime;
-    
-    // Fast access methods that check runtime overrides first, then fall back to compile-time
-    static const char* get_market_data_endpoint() { return runtime.market_data_endpoint; }
-    static const char* get_logger_endpoint() { return runtime.logger_endpoint; }
-    static const char* get_signals_endpoint() { return runtime.signals_endpoint; }
-    static const char* get_executions_endpoint() { return runtime.executions_endpoint; }
-    static const char* get_positions_endpoint() { return runtime.positions_endpoint; }
-    
-    static bool get_enable_dpdk() { return runtime.enable_dpdk; }
-    static bool get_enable_io_uring() { return runtime.enable_io_uring; }
-    static bool get_trading_enabled() { return runtime.trading_enabled; }
-    static bool get_paper_trading() { return runtime.paper_trading; }
-    static bool get_mock_data_enabled() { return runtime.mock_data_enabled; }
-    static bool get_log_to_console() { return runtime.log_to_console; }
+    // The live configuration is an immutable snapshot. load_from_file()
+    // parses into a fresh RuntimeOverrides off to the side, validates it and
+    // publishes it with one atomic pointer swap, so a reload never stops or
+    // tears a reader. Getters read whichever snapshot is current.
+    static const RuntimeOverrides& runtime() {
+        const RuntimeOverrides* config = current_.load(std::memory_order_acquire);
+        return __builtin_expect(config != nullptr, 1) ? *config : defaults();
+    }
     
-    static int get_log_level() { return runtime.log_level; }
-    static int get_mock_data_frequency_hz() { return runtime.mock_data_frequency_hz; }
+    // Epoch-protected reference to one snapshot, for code that reads several
+    // related values (a strategy's parameters, a set of limits) and needs
+    // them from the same load. Costs a store to a thread-local reader slot
+    // and a fence; the pinned snapshot is not reclaimed while the guard lives.
+    // Guards nested on one thread all see the outermost guard's snapshot.
+    // Plain getters need no guard: strings and containers come back as
+    // copies, since a replaced snapshot is reclaimed once its readers leave.
+    class Snapshot {
+    public:
+        Snapshot();
+        ~Snapshot();
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        
+        const RuntimeOverrides* operator->() const { return config_; }
+        const RuntimeOverrides& operator*() const { return *config_; }
+        
+    private:
+        const RuntimeOverrides* config_;
+    };
     
-    static double get_max_position_value() { return runtime.max_position_value; }
-    static double get_max_daily_loss() { return runtime.max_daily_loss; }
-    static int get_position_limit_per_symbol() { return runtime.position_limit_per_symbol; }
+    static uint64_t get_config_generation() { return runtime().generation; }
     
-    static double get_momentum_threshold() { return runtime.momentum_threshold; }
-    static int get_min_signal_interval_ms() { return runtime.min_signal_interval_ms; }
+    // Replaced snapshots not yet reclaimed (for monitoring and tests)
+    static size_t get_retired_config_count();
     
-    static const char* get_transport_type() { return runtime.transport_type; }
-    static size_t get_ring_buffer_size() { return runtime.ring_buffer_size; }
+    // Fast access methods that check runtime overrides first, then fall back to compile-time
+    static std::string get_market_data_endpoint() { return runtime().market_data_endpoint; }
+    static std::string get_logger_endpoint() { return runtime().logger_endpoint; }
+    static std::string get_signals_endpoint() { return runtime().signals_endpoint; }
+    static std::string get_executions_endpoint() { return runtime().executions_endpoint; }
+    static std::string get_positions_endpoint() { return runtime().positions_endpoint; }
+    
+    static bool get_enable_dpdk() { return runtime().enable_dpdk; }
+    static bool get_enable_io_uring() { return runtime().enable_io_uring; }
+    static bool get_trading_enabled() { return runtime().trading_enabled; }
+    static bool get_paper_trading() { return runtime().paper_trading; }
+    static bool get_mock_data_enabled() { return runtime().mock_data_enabled; }
+    static bool get_log_to_console() { return runtime().log_to_console; }
+    
+    static int get_log_level() { return runtime().log_level; }
+    static int get_mock_data_frequency_hz() { return runtime().mock_data_frequency_hz; }
+    
+    static double get_max_position_value() { return runtime().max_position_value; }
+    static double get_max_daily_loss() { return runtime().max_daily_loss; }
+    static int get_position_limit_per_symbol() { return runtime().position_limit_per_symbol; }
+    static int get_max_order_quantity() { return runtime().max_order_quantity; }
+    static double get_max_order_notional() { return runtime().max_order_notional; }
+    static double get_price_band_ratio() { return runtime().price_band_ratio; }
+    static int get_max_orders_per_second() { return runtime().max_orders_per_second; }
+    static int get_position_publish_interval_ms() { return runtime().position_publish_interval_ms; }
+    static double get_max_gross_exposure() { return runtime().max_gross_exposure; }
+    static double get_max_net_exposure() { return runtime().max_net_exposure; }
+    static double get_max_sector_exposure() { return runtime().max_sector_exposure; }
+    static double get_max_value_at_risk() { return runtime().max_value_at_risk; }
+    static double get_factor_daily_volatility() { return runtime().factor_daily_volatility; }
+    static double get_symbol_daily_volatility() { return runtime().symbol_daily_volatility; }
+    static double get_var_z() { return runtime().var_z; }
+    static std::unordered_map<std::string, std::string> get_risk_symbols() { return runtime().risk_symbols; }
+    static std::string get_kill_switch_name() { return runtime().kill_switch_name; }
+    static int get_kill_switch_ack_timeout_ms() { return runtime().kill_switch_ack_timeout_ms; }
+    
+    static double get_momentum_threshold() { return runtime().momentum_threshold; }
+    static int get_min_signal_interval_ms() { return runtime().min_signal_interval_ms; }
+    
+    static bool get_strategy_busy_poll() { return runtime().strategy_busy_poll; }
+    static int get_strategy_busy_poll_cpu() { return runtime().strategy_busy_poll_cpu; }
+    static int get_strategy_worker_threads() { return runtime().strategy_worker_threads; }
+    static int get_strategy_worker_first_cpu() { return runtime().strategy_worker_first_cpu; }
+    
+    static int get_hot_arena_mb() { return runtime().hot_arena_mb; }
+    static std::string get_hot_arena_page_size() { return runtime().hot_arena_page_size; }
+    static bool get_hot_arena_prefault() { return runtime().hot_arena_prefault; }
+    
+    static bool get_warmup_enabled() { return runtime().warmup_enabled; }
+    static int get_warmup_round_events() { return runtime().warmup_round_events; }
+    static int get_warmup_max_rounds() { return runtime().warmup_max_rounds; }
+    static int get_warmup_stable_rounds() { return runtime().warmup_stable_rounds; }
+    static double get_warmup_tolerance() { return runtime().warmup_tolerance; }
+    static bool get_warmup_required_for_start() { return runtime().warmup_required_for_start; }
+    
+    static std::string get_transport_type() { return runtime().transport_type; }
+    static size_t get_ring_buffer_size() { return runtime().ring_buffer_size; }
+    
+    static int get_zmq_send_hwm() { return runtime().zmq_send_hwm; }
+    static int get_zmq_recv_hwm() { return runtime().zmq_recv_hwm; }
+    static int get_zmq_linger_ms() { return runtime().zmq_linger_ms; }
+    static int get_zmq_io_threads() { return runtime().zmq_io_threads; }
+    static std::vector<int> get_zmq_io_thread_cpus() { return runtime().zmq_io_thread_cpus; }
+    static bool get_zmq_immediate() { return runtime().zmq_immediate; }
+    static bool get_zmq_zero_copy() { return runtime().zmq_zero_copy; }
+    static std::string get_zmq_endpoint_scheme() { return runtime().zmq_endpoint_scheme; }
+    static std::string get_zmq_ipc_dir() { return runtime().zmq_ipc_dir; }
+    static std::string get_market_data_multicast_endpoint() { return runtime().market_data_multicast_endpoint; }
+    static bool get_market_data_multicast_subscribe() { return runtime().market_data_multicast_subscribe; }
+    static std::string get_multicast_interface() { return runtime().multicast_interface; }
+    static int get_multicast_ttl() { return runtime().multicast_ttl; }
+    static int get_multicast_retransmit_ring() { return runtime().multicast_retransmit_ring; }
+    static int get_multicast_heartbeat_ms() { return runtime().multicast_heartbeat_ms; }
     
     // Market data source configuration getters
-    static const std::string& get_market_data_source() { return runtime.market_data_source; }
-    static const std::string& get_pcap_file_path() { return runtime.pcap_file_path; }
-    static const std::string& get_pcap_format() { return runtime.pcap_format; }
-    static double get_replay_speed() { return runtime.replay_speed; }
-    static bool get_loop_replay() { return runtime.loop_replay; }
+    static std::string get_market_data_source() { return runtime().market_data_source; }
+    static std::string get_pcap_file_path() { return runtime().pcap_file_path; }
+    static std::string get_pcap_format() { return runtime().pcap_format; }
+    static double get_replay_speed() { return runtime().replay_speed; }
+    static bool get_loop_replay() { return runtime().loop_replay; }
+    static size_t get_itch_max_orders() { return runtime().itch_max_orders; }
+    static size_t get_pcap_batch_size() { return runtime().pcap_batch_size; }
+    static size_t get_pcap_prefetch_distance() { return runtime().pcap_prefetch_distance; }
+    static bool get_batch_packet_quotes() { return runtime().batch_packet_quotes; }
+    
+    // Live multicast feed getters
+    static std::string get_feed_a_group() { return runtime().feed_a_group; }
+    static int get_feed_a_port() { return runtime().feed_a_port; }
+    static std::string get_feed_b_group() { return runtime().feed_b_group; }
+    static int get_feed_b_port() { return runtime().feed_b_port; }
+    static std::string get_feed_interface() { return runtime().feed_interface; }
+    static int get_feed_rx_burst() { return runtime().feed_rx_burst; }
+    static size_t get_feed_hold_slots() { return runtime().feed_hold_slots; }
+    static int get_feed_gap_timeout_us() { return runtime().feed_gap_timeout_us; }
+    static int get_dpdk_port_id() { return runtime().dpdk_port_id; }
+    static std::string get_dpdk_eal_args() { return runtime().dpdk_eal_args; }
+    
+    // Synthetic load getters
+    static int get_load_symbols() { return runtime().load_symbols; }
+    static int get_load_rate() { return runtime().load_rate; }
+    static std::string get_load_profile() { return runtime().load_profile; }
+    static uint64_t get_load_seed() { return runtime().load_seed; }
+    
+    // Logger service file writer getters
+    static int get_logger_write_buffer_kb() { return runtime().logger_write_buffer_kb; }
+    static int get_logger_preallocate_mb() { return runtime().logger_preallocate_mb; }
+    static int get_logger_rotate_size_mb() { return runtime().logger_rotate_size_mb; }
+    static int get_logger_rotate_interval_seconds() { return runtime().logger_rotate_interval_seconds; }
+    static bool get_logger_direct_io() { return runtime().logger_direct_io; }
+    
+    // Event journal getters
+    static bool get_journal_enabled() { return runtime().journal_enabled; }
+    static std::string get_journal_directory() { return runtime().journal_directory; }
+    static int get_journal_sync_interval_ms() { return runtime().journal_sync_interval_ms; }
+    static int get_journal_snapshot_interval_seconds() { return runtime().journal_snapshot_interval_seconds; }
+    
+    // Input capture getters
+    static bool get_capture_enabled() { return runtime().capture_enabled; }
+    static std::string get_capture_directory() { return runtime().capture_directory; }
+    
+    // Sampling profiler getters
+    static std::string get_profiler_directory() { return runtime().profiler_directory; }
+    static int get_profiler_max_seconds() { return runtime().profiler_max_seconds; }
+    static bool get_profiler_pmu_counters() { return runtime().profiler_pmu_counters; }
+    static std::string get_profiler_alloc_guard() { return runtime().profiler_alloc_guard; }
+    static int get_jitter_threshold_ns() { return runtime().jitter_threshold_ns; }
     
     // Metrics publisher port getters
-    static int get_strategy_engine_metrics_port() { return runtime.strategy_engine_metrics_port; }
-    static int get_market_data_handler_metrics_port() { return runtime.market_data_handler_metrics_port; }
-    static int get_order_gateway_metrics_port() { return runtime.order_gateway_metrics_port; }
-    static int get_position_risk_service_metrics_port() { return runtime.position_risk_service_metrics_port; }
-    static int get_metrics_aggregator_port() { return runtime.metrics_aggregator_port; }
-    static int get_control_commands_port() { return runtime.control_commands_port; }
+    static int get_strategy_engine_metrics_port() { return runtime().strategy_engine_metrics_port; }
+    static int get_market_data_handler_metrics_port() { return runtime().market_data_handler_metrics_port; }
+    static int get_order_gateway_metrics_port() { return runtime().order_gateway_metrics_port; }
+    static int get_position_risk_service_metrics_port() { return runtime().position_risk_service_metrics_port; }
+    static int get_low_latency_logger_metrics_port() { return runtime().low_latency_logger_metrics_port; }
+    static int get_metrics_aggregator_port() { return runtime().metrics_aggregator_port; }
+    static int get_control_commands_port() { return runtime().control_commands_port; }
+    
+    // Dashboard server getters
+    static int get_websocket_port() { return runtime().websocket_port; }
+    static int get_control_api_port() { return runtime().control_api_port; }
+    static int get_http_max_connections() { return runtime().http_max_connections; }
+    static int get_http_send_queue_limit_kb() { return runtime().http_send_queue_limit_kb; }
+    static int get_websocket_broadcast_interval_ms() { return runtime().websocket_broadcast_interval_ms; }
+    static int get_websocket_binary_keyframe_interval() { return runtime().websocket_binary_keyframe_interval; }
     
     // Timing parameter getters
-    static int get_poll_timeout_ms() { return runtime.poll_timeout_ms; }
-    static int get_stats_interval_seconds() { return runtime.stats_interval_seconds; }
-    static int get_control_poll_interval_ms() { return runtime.control_poll_interval_ms; }
-    static int get_processing_sleep_microseconds() { return runtime.processing_sleep_microseconds; }
-    static int get_fast_processing_sleep_microseconds() { return runtime.fast_processing_sleep_microseconds; }
-    static int get_order_execution_min_delay_ms() { return runtime.order_execution_min_delay_ms; }
-    static int get_order_execution_max_delay_ms() { return runtime.order_execution_max_delay_ms; }
-    static int get_metrics_update_interval_seconds() { return runtime.metrics_update_interval_seconds; }
-    static int get_metrics_publisher_interval_ms() { return runtime.metrics_publisher_interval_ms; }
+    static int get_poll_timeout_ms() { return runtime().poll_timeout_ms; }
+    static int get_stats_interval_seconds() { return runtime().stats_interval_seconds; }
+    static int get_control_poll_interval_ms() { return runtime().control_poll_interval_ms; }
+    static int get_config_reload_check_ms() { return runtime().config_reload_check_ms; }
+    static int get_processing_sleep_microseconds() { return runtime().processing_sleep_microseconds; }
+    static int get_fast_processing_sleep_microseconds() { return runtime().fast_processing_sleep_microseconds; }
+    static int get_order_execution_min_delay_ms() { return runtime().order_execution_min_delay_ms; }
+    static int get_order_execution_max_delay_ms() { return runtime().order_execution_max_delay_ms; }
+    static int get_metrics_update_interval_seconds() { return runtime().metrics_update_interval_seconds; }
+    static int get_metrics_publisher_interval_ms() { return runtime().metrics_publisher_interval_ms; }
     
     // Mock data generation parameter getters
-    static double get_price_change_volatility() { return runtime.price_change_volatility; }
-    static double get_min_price_multiplier() { return runtime.min_price_multiplier; }
-    static double get_max_price_multiplier() { return runtime.max_price_multiplier; }
-    static double get_base_spread_basis_points() { return runtime.base_spread_basis_points; }
-    static int get_min_volume() { return runtime.min_volume; }
-    static int get_max_volume() { return runtime.max_volume; }
-    static int get_min_last_size() { return runtime.min_last_size; }
-    static int get_max_last_size() { return runtime.max_last_size; }
+    static double get_price_change_volatility() { return runtime().price_change_volatility; }
+    static double get_min_price_multiplier() { return runtime().min_price_multiplier; }
+    static double get_max_price_multiplier() { return runtime().max_price_multiplier; }
+    static double get_base_spread_basis_points() { return runtime().base_spread_basis_points; }
+    static int get_min_volume() { return runtime().min_volume; }
+    static int get_max_volume() { return runtime().max_volume; }
+    static int get_min_last_size() { return runtime().min_last_size; }
+    static int get_max_last_size() { return runtime().max_last_size; }
     
     // Symbol configuration getters
-    static const std::vector<std::string>& get_symbols() { return runtime.symbols; }
-    static const std::unordered_map<std::string, double>& get_symbol_base_prices() { return runtime.symbol_base_prices; }
-    static const std::unordered_map<std::string, double>& get_symbol_volatilities() { return runtime.symbol_volatilities; }
+    static std::vector<std::string> get_symbols() { return runtime().symbols; }
+    static std::unordered_map<std::string, double> get_symbol_base_prices() { return runtime().symbol_base_prices; }
+    static std::unordered_map<std::string, double> get_symbol_volatilities() { return runtime().symbol_volatilities; }
+    static price_t get_symbol_tick(const std::string& symbol) {
+        const RuntimeOverrides& config = runtime();
+        auto it = config.symbol_ticks.find(symbol);
+        return it != config.symbol_ticks.end() ? it->second : config.default_tick;
+    }
+    static std::unordered_map<std::string, std::string> get_thread_plan() { return runtime().thread_plan; }
     
     // Alpaca API configuration getters
-    static const std::string& get_alpaca_api_key() { return runtime.alpaca_api_key; }
-    static const std::string& get_alpaca_secret_key() { return runtime.alpaca_secret_key; }
-    static bool get_alpaca_paper_trading() { return runtime.alpaca_paper_trading; }
-    static const std::string& get_alpaca_websocket_feed() { return runtime.alpaca_websocket_feed; }
-    static const std::string& get_alpaca_websocket_url() { return runtime.alpaca_websocket_url; }
-    static const std::string& get_alpaca_websocket_host() { return runtime.alpaca_websocket_host; }
-    static int get_alpaca_max_symbols_per_request() { return runtime.alpaca_max_symbols_per_request; }
-    static int get_alpaca_max_message_size_kb() { return runtime.alpaca_max_message_size_kb; }
-    static int get_alpaca_reconnect_interval_seconds() { return runtime.alpaca_reconnect_interval_seconds; }
-    static int get_alpaca_max_reconnect_attempts() { return runtime.alpaca_max_reconnect_attempts; }
-    static int get_alpaca_auth_timeout_seconds() { return runtime.alpaca_auth_timeout_seconds; }
-    static int get_alpaca_rate_limit_per_minute() { return runtime.alpaca_rate_limit_per_minute; }
-    static int get_alpaca_circuit_breaker_failures() { return runtime.alpaca_circuit_breaker_failures; }
-    static int get_alpaca_circuit_breaker_timeout_minutes() { return runtime.alpaca_circuit_breaker_timeout_minutes; }
+    static std::string get_alpaca_api_key() { return runtime().alpaca_api_key; }
+    static std::string get_alpaca_secret_key() { return runtime().alpaca_secret_key; }
+    static bool get_alpaca_paper_trading() { return runtime().alpaca_paper_trading; }
+    static std::string get_alpaca_websocket_feed() { return runtime().alpaca_websocket_feed; }
+    static std::string get_alpaca_websocket_url() { return runtime().alpaca_websocket_url; }
+    static std::string get_alpaca_websocket_host() { return runtime().alpaca_websocket_host; }
+    static int get_alpaca_max_symbols_per_request() { return runtime().alpaca_max_symbols_per_request; }
+    static int get_alpaca_max_message_size_kb() { return runtime().alpaca_max_message_size_kb; }
+    static int get_alpaca_reconnect_interval_seconds() { return runtime().alpaca_reconnect_interval_seconds; }
+    static int get_alpaca_max_reconnect_attempts() { return runtime().alpaca_max_reconnect_attempts; }
+    static int get_alpaca_auth_timeout_seconds() { return runtime().alpaca_auth_timeout_seconds; }
+    static int get_alpaca_rate_limit_per_minute() { return runtime().alpaca_rate_limit_per_minute; }
+    static int get_alpaca_rate_limit_burst() { return runtime().alpaca_rate_limit_burst; }
+    static int get_alpaca_circuit_breaker_failures() { return runtime().alpaca_circuit_breaker_failures; }
+    static int get_alpaca_circuit_breaker_timeout_minutes() { return runtime().alpaca_circuit_breaker_timeout_minutes; }
+    static int get_alpaca_order_connections() { return runtime().alpaca_order_connections; }
+    static int get_alpaca_stream_connections() { return runtime().alpaca_stream_connections; }
+    static int get_alpaca_merge_window_us() { return runtime().alpaca_merge_window_us; }
+    
+    static std::unordered_map<std::string, std::string> get_venues() { return runtime().venues; }
+    static double get_router_latency_cost_per_ms() { return runtime().router_latency_cost_per_ms; }
+    static int get_router_quote_max_age_ms() { return runtime().router_quote_max_age_ms; }
+    static int get_router_score_refresh_ms() { return runtime().router_score_refresh_ms; }
+    
+    static std::string get_fix_host() { return runtime().fix_host; }
+    static int get_fix_port() { return runtime().fix_port; }
+    static std::string get_fix_begin_string() { return runtime().fix_begin_string; }
+    static std::string get_fix_sender_comp_id() { return runtime().fix_sender_comp_id; }
+    static std::string get_fix_target_comp_id() { return runtime().fix_target_comp_id; }
+    static std::string get_fix_account() { return runtime().fix_account; }
+    static int get_fix_heartbeat_interval_seconds() { return runtime().fix_heartbeat_interval_seconds; }
+    static int get_fix_reconnect_interval_seconds() { return runtime().fix_reconnect_interval_seconds; }
+    static bool get_fix_reset_on_logon() { return runtime().fix_reset_on_logon; }
     
     // Generic configuration value getters (with defaults)
     static std::string get_config_value(const std::string& key, const std::string& default_value) {
-        if (key == "market_data.source") return runtime.market_data_source;
-        if (key == "market_data.pcap_file") return runtime.pcap_file_path;
-        if (key == "market_data.pcap_format") return runtime.pcap_format;
-        if (key == "market_data.replay_speed") return std::to_string(runtime.replay_speed);
+        if (key == "market_data.source") return runtime().market_data_source;
+        if (key == "market_data.pcap_file") return runtime().pcap_file_path;
+        if (key == "market_data.pcap_format") return runtime().pcap_format;
+        if (key == "market_data.replay_speed") return std::to_string(runtime().replay_speed);
         return default_value;
     }
     
     static bool get_config_bool(const std::string& key, bool default_value) {
-        if (key == "market_data.loop_replay") return runtime.loop_replay;
+        if (key == "market_data.loop_replay") return runtime().loop_replay;
         return default_value;
     }
     
-    // Load configuration from file into runtime overrides
+    // Load configuration from file on top of the current snapshot and
+    // publish the result. A file that fails validation changes nothing.
+    // Safe to call while other threads read; reloads are serialized.
     static bool load_from_file(const char* filename);
     
+    // Re-read the file the last successful load read, or the default
+    // config/hft_config.conf if none has, so a service started on another
+    // file keeps it
+    static bool reload();
+    
     // Validate configuration
-    static bool validate_config();
+    static bool validate_config() { return validate(runtime()); }
+    static bool validate(const RuntimeOverrides& config);
     
     // Get configuration as string for debugging
     static std::string to_string();
+
+private:
+    static std::atomic<const RuntimeOverrides*> current_;   // nullptr until the first load
+    static const RuntimeOverrides& defaults();
+    static void publish(RuntimeOverrides&& next);
 };
 
 // Inline definitions for better performance
-inline bool StaticConfig::validate_config() {
-    return runtime.market_data_endpoint != nullptr &&
-           runtime.logger_endpoint != nullptr &&
-           runtime.signals_endpoint != nullptr &&
-           runtime.executions_endpoint != nullptr &&
-           runtime.positions_endpoint != nullptr &&
-           runtime.log_level >= LOG_LEVEL_DEBUG &&
-           runtime.log_level <= LOG_LEVEL_CRITICAL &&
-           runtime.mock_data_frequency_hz > 0 &&
-           runtime.max_position_value > 0.0 &&
-           runtime.max_daily_loss > 0.0 &&
-           runtime.position_limit_per_symbol > 0 &&
-           runtime.momentum_threshold > 0.0 &&
-           runtime.min_signal_interval_ms > 0;
+inline bool StaticConfig::validate(const RuntimeOverrides& config) {
+    return config.market_data_endpoint != nullptr &&
+           config.logger_endpoint != nullptr &&
+           config.signals_endpoint != nullptr &&
+           config.executions_endpoint != nullptr &&
+           config.positions_endpoint != nullptr &&
+           config.log_level >= LOG_LEVEL_DEBUG &&
+           config.log_level <= LOG_LEVEL_CRITICAL &&
+           config.mock_data_frequency_hz > 0 &&
+           config.max_position_value > 0.0 &&
+           config.max_daily_loss > 0.0 &&
+           config.position_limit_per_symbol > 0 &&
+           config.momentum_threshold > 0.0 &&
+           config.min_signal_interval_ms > 0 &&
+           config.journal_sync_interval_ms >= 0 &&
+           config.journal_snapshot_interval_seconds >= 0;
 }
 
 } // namespace hft
\ No newline at end of file
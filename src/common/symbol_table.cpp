@@ -0,0 +1,60 @@
+#include "symbol_table.h"
+#include <iostream>
+
+namespace hft {
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::SymbolTable() : count_(0), preloaded_(0) {
+    for (auto& name : names_) {
+        name.fill('\0');
+    }
+    index_.reserve(MAX_SYMBOLS);
+}
+
+symbol_id_t SymbolTable::intern(const char* symbol) {
+    std::string key(symbol, strnlen(symbol, SYMBOL_LENGTH - 1));
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    
+    uint32_t id = count_.load(std::memory_order_relaxed);
+    if (id >= MAX_SYMBOLS) {
+        std::cerr << "[SymbolTable] Table full, cannot intern " << key << std::endl;
+        return INVALID_SYMBOL_ID;
+    }
+    
+    std::memcpy(names_[id].data(), key.data(), key.size());
+    index_.emplace(std::move(key), id);
+    
+    // Publish the name before the new count becomes visible to readers
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+symbol_id_t SymbolTable::find(const char* symbol) const {
+    std::string key(symbol, strnlen(symbol, SYMBOL_LENGTH - 1));
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    return it != index_.end() ? it->second : INVALID_SYMBOL_ID;
+}
+
+void SymbolTable::preload(const std::vector<std::string>& symbols) {
+    // IDs only match other services if the list went into an empty table
+    bool fresh = size() == 0;
+    for (const auto& symbol : symbols) {
+        intern(symbol);
+    }
+    if (fresh) {
+        preloaded_.store(count_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
+
+} // namespace hft
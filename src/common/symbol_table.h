@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+// Dense symbol identifier, carried in message payloads next to the symbol name
+using symbol_id_t = uint32_t;
+constexpr symbol_id_t INVALID_SYMBOL_ID = 0xFFFFFFFFu;
+
+// Process-wide symbol table assigning dense IDs in first-seen order.
+// Interning takes a lock and is meant for feed ingest and startup; name()
+// and resolve() are lock-free so hot paths can index flat per-symbol vectors.
+// Every process preloads the configured symbol list, so IDs agree across
+// services; resolve() re-interns by name if a wire ID does not match.
+class SymbolTable {
+public:
+    static constexpr size_t MAX_SYMBOLS = 16384;  // Room for market_data.source=load's 10k symbols
+    static constexpr size_t SYMBOL_LENGTH = 16;  // Matches char symbol[16] in message_types.h
+    
+    static SymbolTable& instance();
+    
+    // Return the ID for a symbol, assigning the next free one if needed.
+    // Returns INVALID_SYMBOL_ID when the table is full.
+    symbol_id_t intern(const char* symbol);
+    symbol_id_t intern(const std::string& symbol) { return intern(symbol.c_str()); }
+    
+    // Lookup without assigning
+    symbol_id_t find(const char* symbol) const;
+    
+    // Intern a list of symbols in order (used at startup with StaticConfig::get_symbols())
+    void preload(const std::vector<std::string>& symbols);
+    
+    // True for IDs assigned by preload(), which every service agrees on and
+    // may therefore be sent without the symbol name
+    bool is_preloaded(symbol_id_t id) const {
+        return id < preloaded_.load(std::memory_order_acquire);
+    }
+    
+    // Validate an ID received on the wire against the payload symbol
+    symbol_id_t resolve(symbol_id_t id, const char* symbol) {
+        if (id < size() && std::strncmp(names_[id].data(), symbol, SYMBOL_LENGTH) == 0) {
+            return id;
+        }
+        return intern(symbol);
+    }
+    
+    const char* name(symbol_id_t id) const {
+        return id < size() ? names_[id].data() : "";
+    }
+    
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+    
+    std::array<std::array<char, SYMBOL_LENGTH>, MAX_SYMBOLS> names_;
+    std::atomic<uint32_t> count_;
+    std::atomic<uint32_t> preloaded_;
+    
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, symbol_id_t> index_;
+};
+
+} // namespace hft
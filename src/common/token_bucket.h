@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace hft {
+
+// A message budget, a venue's or a data source's: bursts of up to `burst`
+// messages, refilled at messages_per_second. Kept in GCRA form, as
+// PreTradeRisk's per-symbol limit is: one timestamp of state, nothing to
+// refill. Off until configured.
+class TokenBucket {
+public:
+    void configure(double messages_per_second, uint32_t burst) {
+        if (messages_per_second <= 0.0) {
+            interval_ns_ = 0;
+            return;
+        }
+        interval_ns_ = std::llround(1e9 / messages_per_second);
+        tolerance_ns_ = interval_ns_ * (static_cast<int64_t>(burst > 0 ? burst : 1) - 1);
+    }
+
+    bool enabled() const { return interval_ns_ > 0; }
+
+    // Takes a token if one is available at now_ns
+    bool try_acquire(int64_t now_ns) {
+        if (interval_ns_ == 0) return true;
+        if (now_ns < next_ns_ - tolerance_ns_) return false;
+        next_ns_ = (next_ns_ > now_ns ? next_ns_ : now_ns) + interval_ns_;
+        return true;
+    }
+
+    // Earliest time try_acquire succeeds
+    int64_t ready_at_ns() const { return next_ns_ - tolerance_ns_; }
+
+    // The other side pushed back (an HTTP 429, say): nothing before until_ns
+    void defer(int64_t until_ns) {
+        if (until_ns + tolerance_ns_ > next_ns_) next_ns_ = until_ns + tolerance_ns_;
+    }
+
+    void reset() { next_ns_ = 0; }
+
+private:
+    int64_t interval_ns_ = 0;
+    int64_t tolerance_ns_ = 0;
+    int64_t next_ns_ = 0;       // Theoretical arrival time of the next message
+};
+
+} // namespace hft
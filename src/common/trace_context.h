@@ -0,0 +1,57 @@
+#pragma once
+
+#include "high_res_timer.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Pipeline stages stamped into a TraceContext, in tick-to-trade order
+enum class TraceStage : uint8_t {
+    FEED_RECEIVE = 0,      // Raw tick arrived at the market data handler
+    FEED_PARSE = 1,        // Normalized into MarketData
+    FEED_PUBLISH = 2,      // Handed to the transport
+    STRATEGY_DECISION = 3, // Strategy emitted a TradingSignal
+    RISK_CHECK = 4,        // Pre-trade risk check passed
+    GATEWAY_SEND = 5,      // Order sent to the broker/venue
+    GATEWAY_ACK = 6,       // Broker acknowledged/filled
+    COUNT = 7
+};
+
+constexpr size_t TRACE_STAGE_COUNT = static_cast<size_t>(TraceStage::COUNT);
+
+// Per-tick trace carried in MarketData and copied forward into the
+// TradingSignal and OrderExecution it causes. Stamps are raw TSC ticks from
+// HighResTimer (0 = stage not reached); services on one host share the TSC,
+// so deltas across processes are meaningful with an invariant TSC.
+struct TraceContext {
+    uint64_t trace_id;                     // Originating tick's sequence number
+    uint64_t tsc[TRACE_STAGE_COUNT];
+
+    // Start a new trace at the feed: clears all stages and stamps receive
+    void begin(uint64_t id) {
+        trace_id = id;
+        for (size_t i = 0; i < TRACE_STAGE_COUNT; ++i) tsc[i] = 0;
+        tsc[0] = HighResTimer::get_ticks();
+    }
+
+    void stamp(TraceStage stage) {
+        tsc[static_cast<size_t>(stage)] = HighResTimer::get_ticks();
+    }
+
+    bool has(TraceStage stage) const {
+        return tsc[static_cast<size_t>(stage)] != 0;
+    }
+
+    // Nanoseconds between two stamped stages; 0 if either is missing or out of order
+    uint64_t elapsed_ns(TraceStage from, TraceStage to) const {
+        uint64_t start = tsc[static_cast<size_t>(from)];
+        uint64_t end = tsc[static_cast<size_t>(to)];
+        if (start == 0 || end <= start) return 0;
+        return HighResTimer::ticks_to_nanoseconds(end - start);
+    }
+} __attribute__((packed));
+
+static_assert(sizeof(TraceContext) == 64, "TraceContext should stay one cache line");
+
+} // namespace hft
@@ -1,6 +1,8 @@
 #include "transport_interface.h"
 #include "zmq_transport.h"
 #include "spmc_transport.h"
+#include "shm_transport.h"
+#include "multicast_transport.h"
 #include <stdexcept>
 #include <algorithm>
 
@@ -20,6 +22,12 @@ std::unique_ptr<IMessagePublisher> TransportFactory::create_publisher(const Tran
                 return std::make_unique<SPMCPublisher<16 * 1024 * 1024>>();
             }
             
+        case TransportType::SHARED_MEMORY:
+            return std::make_unique<ShmPublisher>();
+            
+        case TransportType::RELIABLE_MULTICAST:
+            return std::make_unique<RmcastPublisher>();
+            
         default:
             throw std::runtime_error("Unsupported transport type for publisher");
     }
@@ -39,6 +47,12 @@ std::unique_ptr<IMessageSubscriber> TransportFactory::create_subscriber(const Tr
                 return std::make_unique<SPMCSubscriber<16 * 1024 * 1024>>();
             }
             
+        case TransportType::SHARED_MEMORY:
+            return std::make_unique<ShmSubscriber>();
+            
+        case TransportType::RELIABLE_MULTICAST:
+            return std::make_unique<RmcastSubscriber>();
+            
         default:
             throw std::runtime_error("Unsupported transport type for subscriber");
     }
@@ -79,10 +93,28 @@ std::unique_ptr<IMessageTransport> TransportFactory::create_transport(const Tran
     }
 }
 
+std::unique_ptr<IMessagePublisher> TransportFactory::open_publisher(const TransportConfig& config) {
+    auto publisher = create_publisher(config);
+    if (!publisher->initialize(config) || !publisher->bind(config.endpoint)) {
+        throw std::runtime_error("Cannot bind publisher to " + config.endpoint);
+    }
+    return publisher;
+}
+
+std::unique_ptr<IMessageSubscriber> TransportFactory::open_subscriber(const TransportConfig& config) {
+    auto subscriber = create_subscriber(config);
+    if (!subscriber->initialize(config) || !subscriber->connect(config.endpoint)) {
+        throw std::runtime_error("Cannot connect subscriber to " + config.endpoint);
+    }
+    return subscriber;
+}
+
 std::vector<TransportType> TransportFactory::get_supported_types() {
     return {
         TransportType::ZEROMQ,
-        TransportType::SPMC_RING
+        TransportType::SPMC_RING,
+        TransportType::SHARED_MEMORY,
+        TransportType::RELIABLE_MULTICAST
     };
 }
 
@@ -91,6 +123,7 @@ std::string TransportFactory::get_type_name(TransportType type) {
         case TransportType::ZEROMQ: return "zeromq";
         case TransportType::SPMC_RING: return "spmc";
         case TransportType::SHARED_MEMORY: return "shmem";
+        case TransportType::RELIABLE_MULTICAST: return "rmcast";
         default: return "unknown";
     }
 }
@@ -105,6 +138,8 @@ TransportType TransportFactory::parse_type(const std::string& type_name) {
         return TransportType::SPMC_RING;
     } else if (lower_name == "shmem" || lower_name == "shm") {
         return TransportType::SHARED_MEMORY;
+    } else if (lower_name == "rmcast" || lower_name == "multicast") {
+        return TransportType::RELIABLE_MULTICAST;
     } else {
         throw std::runtime_error("Unknown transport type: " + type_name);
     }
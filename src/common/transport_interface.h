@@ -13,7 +13,8 @@ namespace hft {
 enum class TransportType {
     ZEROMQ,
     SPMC_RING,
-    SHARED_MEMORY
+    SHARED_MEMORY,
+    RELIABLE_MULTICAST      // Across hosts: UDP multicast with NAK retransmit
 };
 
 // Transport patterns
@@ -24,6 +25,12 @@ enum class TransportPattern {
     PAIR              // Bidirectional
 };
 
+// What an SPMC producer does when the slowest consumer has not freed space
+enum class SlowConsumerPolicy {
+    BLOCK,      // Wait for the slowest consumer (lossless)
+    OVERWRITE   // Keep publishing; lapped consumers detect it and resync
+};
+
 // Transport configuration
 struct TransportConfig {
     TransportType type;
@@ -32,7 +39,31 @@ struct TransportConfig {
     size_t buffer_size = 1024 * 1024;  // 1MB default
     int high_water_mark = 1000;
     bool blocking = false;
-    
+    bool huge_pages = false;           // SHARED_MEMORY: back the ring with hugetlbfs
+    int slow_consumer_timeout_ms = 1000;  // SHARED_MEMORY: evict consumers silent this long
+    SlowConsumerPolicy slow_consumer_policy = SlowConsumerPolicy::BLOCK;  // SPMC_RING
+
+    // ZEROMQ tuning (ZmqTransportBase::configure_socket). TCP_NODELAY needs no
+    // option: libzmq sets it on every TCP connection.
+    int io_threads = 1;                // IO threads of a context the transport creates
+    std::vector<int> io_thread_cpus;   // CPUs those IO threads may run on (empty: any)
+    void* shared_context = nullptr;    // zmq context to use instead (needed for inproc://)
+    uint64_t io_affinity = 0;          // ZMQ_AFFINITY: IO threads serving this socket (0: all)
+    int linger_ms = 0;
+    int receive_timeout_ms = -1;       // Blocking receive() gives up after this (-1: never)
+    bool immediate = false;            // Queue only to completed connections (ZMQ_IMMEDIATE)
+    bool conflate = false;             // Keep only the newest message per peer; single-part
+                                       // topics where each message supersedes the last
+    bool zero_copy = false;            // Send from pooled buffers (zmq_msg_init_data)
+
+    // RELIABLE_MULTICAST
+    std::string multicast_interface;   // Local address to send from and join on (empty: the kernel's choice)
+    int multicast_ttl = 1;             // Router hops; 1 stays on the local subnet
+    size_t retransmit_ring = 4096;     // Messages the publisher can resend and a receiver can reorder
+    int heartbeat_interval_ms = 100;   // Idle publisher's heartbeat, so receivers notice a lost tail
+
+    TransportConfig()
+        : type(TransportType::ZEROMQ), pattern(TransportPattern::PUBLISH_SUBSCRIBE) {}
     TransportConfig(TransportType t, TransportPattern p, const std::string& ep)
         : type(t), pattern(p), endpoint(ep) {}
 };
@@ -71,6 +102,9 @@ public:
     
     // Socket/handle for polling (ZMQ compatibility)
     virtual void* get_native_handle() = 0;
+    // For transports polled by file descriptor instead: readable when
+    // receive() can make progress; -1 when get_native_handle() is the one
+    virtual int get_poll_fd() { return -1; }
 };
 
 // Publisher interface (one-to-many)
@@ -81,6 +115,14 @@ public:
     // Topic-based publishing (for pub/sub)
     virtual bool publish(const std::string& topic, const void* data, size_t size) = 0;
     virtual void set_filter(const std::string& filter) = 0;
+
+    // One part of a batch subscribers receive all-or-nothing; the part with
+    // more == false ends it. Transports without multipart framing deliver
+    // each part as its own message.
+    virtual bool publish_part(const void* data, size_t size, bool more) {
+        (void)more;
+        return publish(data, size);
+    }
 };
 
 // Subscriber interface (one-to-many consumer)
@@ -120,6 +162,11 @@ public:
     // Create generic transport
     static std::unique_ptr<IMessageTransport> create_transport(const TransportConfig& config);
     
+    // Created, initialized and bound (publisher) or connected (subscriber) to
+    // config.endpoint; throw std::runtime_error naming the endpoint on failure
+    static std::unique_ptr<IMessagePublisher> open_publisher(const TransportConfig& config);
+    static std::unique_ptr<IMessageSubscriber> open_subscriber(const TransportConfig& config);
+    
     // Get available transport types
     static std::vector<TransportType> get_supported_types();
     
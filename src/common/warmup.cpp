@@ -0,0 +1,127 @@
+#include "warmup.h"
+#include "hft_metrics.h"
+#include "metrics_collector.h"
+#include "static_config.h"
+#include "symbol_table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace hft {
+
+namespace {
+
+// Mid price for a symbol's step-th event: up four 0.2% steps, then back down
+double synthetic_mid(uint64_t step) {
+    static constexpr int WALK[] = {0, 1, 2, 3, 4, 3, 2, 1};
+    return 100.0 * (1.0 + 0.002 * WALK[step % 8]);
+}
+
+} // namespace
+
+WarmupOptions WarmupOptions::from_config() {
+    WarmupOptions options;
+    options.round_events = static_cast<size_t>(std::max(1, StaticConfig::get_warmup_round_events()));
+    options.max_rounds = static_cast<size_t>(std::max(1, StaticConfig::get_warmup_max_rounds()));
+    options.stable_rounds = static_cast<size_t>(std::max(1, StaticConfig::get_warmup_stable_rounds()));
+    options.tolerance = StaticConfig::get_warmup_tolerance();
+    return options;
+}
+
+std::string WarmupReport::describe() const {
+    std::ostringstream oss;
+    oss << (stable ? "stable" : "NOT stable") << " after " << rounds << " rounds (" << events
+        << " events), p99 " << first_p99_ns << "ns cold -> " << p99_ns << "ns warm";
+    return oss.str();
+}
+
+WarmupTracker::WarmupTracker(const WarmupOptions& options)
+    : options_(options) {
+}
+
+bool WarmupTracker::end_round() {
+    uint64_t p99 = round_.percentile(0.99);
+    report_.events += round_.total;
+    report_.rounds++;
+    report_.p99_ns = p99;
+    if (report_.rounds == 1) {
+        report_.first_p99_ns = p99;
+    } else {
+        double change = previous_p99_ == 0 ? (p99 == 0 ? 0.0 : 1.0)
+                        : std::abs(static_cast<double>(p99) - static_cast<double>(previous_p99_)) /
+                              static_cast<double>(previous_p99_);
+        rounds_within_ = change <= options_.tolerance ? rounds_within_ + 1 : 0;
+    }
+    previous_p99_ = p99;
+    round_ = HistogramSnapshot{};
+
+    report_.stable = rounds_within_ >= options_.stable_rounds;
+    return report_.stable || report_.rounds >= options_.max_rounds;
+}
+
+namespace warmup {
+
+std::vector<symbol_id_t> universe() {
+    std::vector<symbol_id_t> ids;
+    for (const auto& symbol : StaticConfig::get_symbols()) {
+        symbol_id_t id = SymbolTable::instance().intern(symbol);
+        if (id != INVALID_SYMBOL_ID) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+MarketData synthetic_tick(symbol_id_t symbol_id, uint64_t step) {
+    MarketData data{};
+    data.header = MessageFactory::create_header(MessageType::MARKET_DATA, sizeof(MarketData) - sizeof(MessageHeader));
+    std::strncpy(data.symbol, SymbolTable::instance().name(symbol_id), sizeof(data.symbol) - 1);
+    data.symbol_id = symbol_id;
+
+    double mid = synthetic_mid(step);
+    data.bid_price = to_fixed_price(mid - 0.01);
+    data.ask_price = to_fixed_price(mid + 0.01);
+    data.bid_size = 100;
+    data.ask_size = 100;
+    data.last_price = to_fixed_price(mid);
+    data.last_size = 100;
+    data.exchange_timestamp = data.header.timestamp.count();
+    data.publish_timestamp = data.exchange_timestamp;
+    return data;
+}
+
+TradingSignal synthetic_signal(symbol_id_t symbol_id, uint64_t step) {
+    SignalAction action = (step & 1) ? SignalAction::SELL : SignalAction::BUY;
+    return MessageFactory::create_trading_signal(symbol_id, action, OrderType::LIMIT, synthetic_mid(step), 100, 0);
+}
+
+OrderExecution synthetic_execution(symbol_id_t symbol_id, uint64_t step) {
+    OrderExecution execution{};
+    execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION,
+                                                    sizeof(OrderExecution) - sizeof(MessageHeader));
+    execution.order_id = step + 1;
+    std::strncpy(execution.symbol, SymbolTable::instance().name(symbol_id), sizeof(execution.symbol) - 1);
+    execution.symbol_id = symbol_id;
+    execution.exec_type = (step % 4 == 3) ? ExecutionType::PARTIAL_FILL : ExecutionType::FILL;
+    execution.fill_price = to_fixed_price(synthetic_mid(step));
+    execution.fill_quantity = 100;
+    execution.remaining_quantity = 0;
+    execution.commission = 0.1;
+    return execution;
+}
+
+void publish_pending() {
+    HFT_GAUGE_VALUE(hft::metrics::WARMUP_COMPLETE, 0);
+}
+
+void publish(const WarmupReport& report) {
+    HFT_GAUGE_VALUE(hft::metrics::WARMUP_P99, report.p99_ns);
+    HFT_GAUGE_VALUE(hft::metrics::WARMUP_ROUNDS, report.rounds);
+    // An unstable finish still completes: max_rounds is the operator's cap
+    HFT_GAUGE_VALUE(hft::metrics::WARMUP_COMPLETE, 1);
+}
+
+} // namespace warmup
+
+} // namespace hft
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "high_res_timer.h"
+#include "latency_histogram.h"
+#include "message_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+struct WarmupOptions {
+    size_t round_events = 2000;    // Synthetic events per measured round
+    size_t max_rounds = 50;        // Stop (unstable) after this many rounds
+    size_t stable_rounds = 3;      // Consecutive rounds within tolerance of the one before
+    double tolerance = 0.10;       // Allowed relative p99 change between rounds
+
+    // warmup.* keys from StaticConfig
+    static WarmupOptions from_config();
+};
+
+struct WarmupReport {
+    size_t rounds = 0;
+    uint64_t events = 0;
+    uint64_t first_p99_ns = 0;     // Cold: first round
+    uint64_t p99_ns = 0;           // Warm: last round
+    bool stable = false;           // False if max_rounds ran out first
+
+    std::string describe() const;
+};
+
+// Round-by-round p99 of a warmup replay. Warm once `stable_rounds` rounds in
+// a row each land within `tolerance` of the round before.
+class WarmupTracker {
+public:
+    explicit WarmupTracker(const WarmupOptions& options);
+
+    void record(uint64_t latency_ns) { round_.record(latency_ns); }
+
+    // Closes the current round; true once warm or out of rounds
+    bool end_round();
+
+    const WarmupReport& report() const { return report_; }
+
+private:
+    WarmupOptions options_;
+    HistogramSnapshot round_;
+    uint64_t previous_p99_ = 0;
+    size_t rounds_within_ = 0;
+    WarmupReport report_;
+};
+
+// Calls step(i) for i = 0, 1, ... on the calling thread, timing each call,
+// until the tracker reports warm. `step` should drive a service's real
+// handlers with that service's outputs suppressed.
+template<typename Step>
+WarmupReport run_warmup(const WarmupOptions& options, Step&& step) {
+    WarmupTracker tracker(options);
+    uint64_t i = 0;
+    do {
+        for (size_t n = 0; n < options.round_events; ++n, ++i) {
+            HighResTimer::ticks_t start = HighResTimer::get_ticks();
+            step(i);
+            tracker.record(HighResTimer::ticks_to_nanoseconds(HighResTimer::get_ticks() - start));
+        }
+    } while (!tracker.end_round());
+    return tracker.report();
+}
+
+// Synthetic inputs over the configured universe. Event i is for
+// universe[i % size]; prices walk a few ticks around 100.00 so momentum,
+// fill and mark-to-market branches all go both ways.
+namespace warmup {
+
+// StaticConfig::get_symbols() as interned IDs, in config order
+std::vector<symbol_id_t> universe();
+
+MarketData synthetic_tick(symbol_id_t symbol_id, uint64_t i);
+TradingSignal synthetic_signal(symbol_id_t symbol_id, uint64_t i);
+OrderExecution synthetic_execution(symbol_id_t symbol_id, uint64_t i);
+
+// WARMUP_* gauges; ControlAPI reads health.warmup_complete before it
+// accepts START_TRADING. publish_pending() marks the service as still warming.
+void publish_pending();
+void publish(const WarmupReport& report);
+
+} // namespace warmup
+
+} // namespace hft
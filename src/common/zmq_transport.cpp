@@ -1,9 +1,150 @@
 #include "zmq_transport.h"
+#include "cpu_topology.h"
+#include "static_config.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <new>
 
 namespace hft {
 
+namespace {
+
+// zmq keeps messages up to this size inside zmq_msg_t, with no allocation
+constexpr size_t INLINE_MESSAGE_MAX = 33;
+
+TransportConfig zmq_config(const std::string& endpoint, int high_water_mark) {
+    TransportConfig config(TransportType::ZEROMQ, TransportPattern::PUBLISH_SUBSCRIBE, endpoint);
+    config.high_water_mark = high_water_mark;
+    config.shared_context = &process_zmq_context();
+    config.linger_ms = StaticConfig::get_zmq_linger_ms();
+    config.immediate = StaticConfig::get_zmq_immediate();
+    config.zero_copy = StaticConfig::get_zmq_zero_copy();
+    return config;
+}
+
+} // namespace
+
+ZmqBufferPool* ZmqBufferPool::create(size_t buffers) {
+    return new ZmqBufferPool(buffers);
+}
+
+ZmqBufferPool::ZmqBufferPool(size_t buffers)
+    : storage_(static_cast<char*>(::operator new(buffers * BUFFER_SIZE, std::align_val_t(64)))),
+      count_(buffers),
+      next_(std::make_unique<std::atomic<uint32_t>[]>(buffers)) {
+    for (size_t i = 0; i < count_; ++i) {
+        next_[i].store(i + 1 < count_ ? static_cast<uint32_t>(i + 1) : NIL, std::memory_order_relaxed);
+    }
+    free_head_.store(count_ > 0 ? 0 : NIL, std::memory_order_release);
+}
+
+ZmqBufferPool::~ZmqBufferPool() {
+    ::operator delete(storage_, std::align_val_t(64));
+}
+
+void ZmqBufferPool::retire() {
+    unref();
+}
+
+void ZmqBufferPool::unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+void* ZmqBufferPool::acquire() {
+    uint32_t head = free_head_.load(std::memory_order_acquire);
+    while (head != NIL) {
+        uint32_t next = next_[head].load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head, next, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+            refs_.fetch_add(1, std::memory_order_relaxed);
+            return storage_ + static_cast<size_t>(head) * BUFFER_SIZE;
+        }
+    }
+    return nullptr;
+}
+
+void ZmqBufferPool::release(void* data, void* hint) {
+    auto* pool = static_cast<ZmqBufferPool*>(hint);
+    auto index = static_cast<uint32_t>((static_cast<char*>(data) - pool->storage_) / BUFFER_SIZE);
+    uint32_t head = pool->free_head_.load(std::memory_order_relaxed);
+    do {
+        pool->next_[index].store(head, std::memory_order_relaxed);
+    } while (!pool->free_head_.compare_exchange_weak(head, index, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    pool->unref();
+}
+
+size_t ZmqBufferPool::available() const {
+    size_t free = 0;
+    for (uint32_t i = free_head_.load(std::memory_order_acquire); i != NIL && free < count_;
+         i = next_[i].load(std::memory_order_relaxed)) {
+        free++;
+    }
+    return free;
+}
+
+std::string rewrite_zmq_endpoint(const std::string& endpoint, const std::string& scheme,
+                                 const std::string& ipc_dir) {
+    size_t colon = endpoint.rfind(':');
+    if (endpoint.rfind("tcp://", 0) != 0 || colon == std::string::npos || colon < 6) {
+        return endpoint;
+    }
+    std::string port = endpoint.substr(colon + 1);
+    if (scheme == "ipc") {
+        return "ipc://" + ipc_dir + "/hft-" + port;
+    }
+    if (scheme == "inproc") {
+        return "inproc://hft-" + port;
+    }
+    return endpoint;
+}
+
+std::string zmq_data_endpoint(const std::string& endpoint) {
+    return rewrite_zmq_endpoint(endpoint, StaticConfig::get_zmq_endpoint_scheme(),
+                                StaticConfig::get_zmq_ipc_dir());
+}
+
+std::unique_ptr<zmq::context_t> create_zmq_context(const TransportConfig& config) {
+    // IO threads start with the first socket, so affinity has to be set first
+    auto context = std::make_unique<zmq::context_t>(std::max(1, config.io_threads));
+    if (config.io_thread_cpus.empty()) {
+        ThreadPlan::instance().pin_zmq_io_threads(static_cast<void*>(*context));
+        return context;
+    }
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+    for (int cpu : config.io_thread_cpus) {
+        if (zmq_ctx_set(static_cast<void*>(*context), ZMQ_THREAD_AFFINITY_CPU_ADD, cpu) != 0) {
+            std::cerr << "[ZmqTransport] Cannot add CPU " << cpu << " to IO thread affinity" << std::endl;
+        }
+    }
+#else
+    std::cerr << "[ZmqTransport] libzmq has no ZMQ_THREAD_AFFINITY_CPU_ADD; IO threads not pinned" << std::endl;
+#endif
+    return context;
+}
+
+zmq::context_t& process_zmq_context() {
+    static zmq::context_t* context = [] {
+        TransportConfig config;
+        config.io_threads = StaticConfig::get_zmq_io_threads();
+        config.io_thread_cpus = StaticConfig::get_zmq_io_thread_cpus();
+        return create_zmq_context(config).release();
+    }();
+    return *context;
+}
+
+TransportConfig zmq_publisher_config(const std::string& endpoint) {
+    return zmq_config(endpoint, StaticConfig::get_zmq_send_hwm());
+}
+
+TransportConfig zmq_subscriber_config(const std::string& endpoint) {
+    return zmq_config(endpoint, StaticConfig::get_zmq_recv_hwm());
+}
+
 ZmqTransportBase::ZmqTransportBase(int socket_type) 
     : socket_type_(socket_type) {
 }
@@ -19,12 +160,22 @@ bool ZmqTransportBase::initialize(const TransportConfig& config) {
     endpoint_ = config.endpoint;
     
     try {
-        context_ = std::make_unique<zmq::context_t>(1);
-        socket_ = std::make_unique<zmq::socket_t>(*context_, socket_type_);
+        zmq::context_t* context = static_cast<zmq::context_t*>(config.shared_context);
+        if (!context) {
+            context_ = create_zmq_context(config);
+            context = context_.get();
+        }
+        socket_ = std::make_unique<zmq::socket_t>(*context, socket_type_);
         
         if (!configure_socket()) {
+            socket_.reset();
+            context_.reset();
             return false;
         }
+        if (config.zero_copy && (socket_type_ == ZMQ_PUB || socket_type_ == ZMQ_PUSH)) {
+            // Enough for a full send queue plus what the IO thread is writing
+            pool_ = ZmqBufferPool::create(static_cast<size_t>(std::max(config.high_water_mark, 0)) + 1024);
+        }
         
         initialized_.store(true);
         return true;
@@ -37,6 +188,9 @@ bool ZmqTransportBase::initialize(const TransportConfig& config) {
 
 bool ZmqTransportBase::bind(const std::string& endpoint) {
     if (!initialized_.load()) return false;
+    if (endpoint.rfind("inproc://", 0) == 0 && !config_.shared_context) {
+        std::cerr << "[ZmqTransport] " << endpoint << " is only reachable through this transport's own context" << std::endl;
+    }
     
     try {
         socket_->bind(endpoint);
@@ -71,19 +225,43 @@ void ZmqTransportBase::close() {
         socket_.reset();
     }
     
+    // In-flight messages keep the pool alive until zmq releases them
+    if (pool_) {
+        pool_->retire();
+        pool_ = nullptr;
+    }
+    
     context_.reset();
     connected_.store(false);
     initialized_.store(false);
 }
 
 bool ZmqTransportBase::send(const void* data, size_t size, bool non_blocking) {
+    return send_part(data, size, non_blocking, false);
+}
+
+zmq::message_t ZmqTransportBase::make_message(const void* data, size_t size) {
+    // Small messages never allocate, so only larger ones come from the pool
+    if (pool_ && size > INLINE_MESSAGE_MAX && size <= ZmqBufferPool::BUFFER_SIZE) {
+        if (void* buffer = pool_->acquire()) {
+            std::memcpy(buffer, data, size);
+            return zmq::message_t(buffer, size, &ZmqBufferPool::release, pool_);
+        }
+        pool_misses_++;
+    }
+    return zmq::message_t(data, size);
+}
+
+bool ZmqTransportBase::send_part(const void* data, size_t size, bool non_blocking, bool more) {
     if (!connected_.load()) return false;
     
     try {
-        zmq::message_t message(size);
-        std::memcpy(message.data(), data, size);
+        zmq::message_t message = make_message(data, size);
         
         auto flags = non_blocking ? zmq::send_flags::dontwait : zmq::send_flags::none;
+        if (more) {
+            flags = flags | zmq::send_flags::sndmore;
+        }
         bool result = socket_->send(message, flags).has_value();
         
         if (result) {
@@ -180,8 +358,21 @@ bool ZmqTransportBase::configure_socket() {
         socket_->set(zmq::sockopt::sndhwm, hwm);
         socket_->set(zmq::sockopt::rcvhwm, hwm);
         
-        // Set linger time (don't wait on close)
-        socket_->set(zmq::sockopt::linger, 0);
+        // Set linger time (0: don't wait on close)
+        socket_->set(zmq::sockopt::linger, config_.linger_ms);
+        
+        if (config_.receive_timeout_ms >= 0) {
+            socket_->set(zmq::sockopt::rcvtimeo, config_.receive_timeout_ms);
+        }
+        if (config_.immediate) {
+            socket_->set(zmq::sockopt::immediate, true);
+        }
+        if (config_.conflate) {
+            socket_->set(zmq::sockopt::conflate, true);
+        }
+        if (config_.io_affinity != 0) {
+            socket_->set(zmq::sockopt::affinity, config_.io_affinity);
+        }
         
         // Configure based on socket type
         if (socket_type_ == ZMQ_SUB) {
@@ -208,8 +399,7 @@ bool ZmqPublisher::publish(const std::string& topic, const void* data, size_t si
         zmq::message_t topic_msg(topic.size());
         std::memcpy(topic_msg.data(), topic.c_str(), topic.size());
         
-        zmq::message_t data_msg(size);
-        std::memcpy(data_msg.data(), data, size);
+        zmq::message_t data_msg = make_message(data, size);
         
         bool result = socket_->send(topic_msg, zmq::send_flags::sndmore | zmq::send_flags::dontwait).has_value();
         if (result) {
@@ -233,6 +423,14 @@ void ZmqPublisher::set_filter(const std::string& filter) {
     // Publishers don't use filters in ZMQ
 }
 
+bool ZmqPublisher::publish_part(const void* data, size_t size, bool more) {
+    // Conflation keeps single frames, so it would split a batch
+    if (more && config_.conflate) {
+        return false;
+    }
+    return send_part(data, size, true, more);
+}
+
 // ZmqSubscriber implementation
 bool ZmqSubscriber::subscribe(const std::string& topic) {
     if (!socket_) return false;
@@ -2,15 +2,75 @@
 
 #include "transport_interface.h"
 #include <zmq.hpp>
-#include <memory>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <thread>
 #include <mutex>
 
 namespace hft {
 
+// Fixed-size send buffers for zmq_msg_init_data. The sending thread takes a
+// buffer, fills it and hands it to zmq; zmq gives it back through release()
+// from whichever thread drops the last reference (an IO thread for tcp and
+// ipc peers). Only the sender pops the free list, so a plain CAS list has no
+// ABA problem. The pool is reference counted by its owner plus every buffer
+// in flight, so messages still queued when the owning socket closes return
+// their buffers safely.
+class ZmqBufferPool {
+public:
+    static constexpr size_t BUFFER_SIZE = 256;     // Every message struct fits
+
+    static ZmqBufferPool* create(size_t buffers);
+    void retire();                                 // Owner is done with the pool
+
+    void* acquire();                               // Sender only; nullptr when exhausted
+    static void release(void* data, void* hint);   // zmq free callback, any thread
+
+    size_t capacity() const { return count_; }
+    size_t available() const;
+
+private:
+    explicit ZmqBufferPool(size_t buffers);
+    ~ZmqBufferPool();
+    void unref();
+
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    char* storage_;
+    size_t count_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    alignas(64) std::atomic<uint32_t> free_head_{NIL};
+    alignas(64) std::atomic<int64_t> refs_{1};
+};
+
+// Rewrites a tcp://host:port endpoint for scheme "ipc"
+// (ipc://<ipc_dir>/hft-<port>) or "inproc" (inproc://hft-<port>). Bind and
+// connect strings for one port map to the same address; anything else is
+// returned unchanged.
+std::string rewrite_zmq_endpoint(const std::string& endpoint, const std::string& scheme,
+                                 const std::string& ipc_dir);
+
+// A data endpoint (market data, signals, executions, positions) under
+// zmq.endpoint_scheme
+std::string zmq_data_endpoint(const std::string& endpoint);
+
+// One context per process for every service socket, with zmq.io_threads IO
+// threads on zmq.io_thread_cpus (or the process's zmq_io placement). Sharing
+// it is what lets inproc:// connect services of one process. Never
+// terminated, so exit does not wait on a socket someone forgot to close.
+zmq::context_t& process_zmq_context();
+
+// Context with config.io_threads IO threads limited to config.io_thread_cpus
+std::unique_ptr<zmq::context_t> create_zmq_context(const TransportConfig& config);
+
+// ZEROMQ configs from the zmq.* settings on the process context
+TransportConfig zmq_publisher_config(const std::string& endpoint);
+TransportConfig zmq_subscriber_config(const std::string& endpoint);
+
 // Base ZeroMQ transport implementation
-class ZmqTransportBase : public IMessageTransport {
+class ZmqTransportBase : public virtual IMessageTransport {
 public:
     ZmqTransportBase(int socket_type);
     virtual ~ZmqTransportBase();
@@ -38,10 +98,14 @@ public:
     uint64_t get_bytes_received() const override { return bytes_received_.load(); }
     
     void* get_native_handle() override;
+    
+    // Sends that found the buffer pool empty and fell back to a copy
+    uint64_t get_pool_misses() const { return pool_misses_.load(); }
 
 protected:
-    std::unique_ptr<zmq::context_t> context_;
+    std::unique_ptr<zmq::context_t> context_;     // Only when not sharing one
     std::unique_ptr<zmq::socket_t> socket_;
+    ZmqBufferPool* pool_ = nullptr;               // With config.zero_copy
     int socket_type_;
     std::string endpoint_;
     TransportConfig config_;
@@ -54,6 +118,7 @@ protected:
     std::atomic<uint64_t> messages_received_{0};
     std::atomic<uint64_t> bytes_sent_{0};
     std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> pool_misses_{0};
     
     // Async receive
     MessageCallback receive_callback_;
@@ -63,6 +128,8 @@ protected:
     
     void async_receive_loop();
     bool configure_socket();
+    bool send_part(const void* data, size_t size, bool non_blocking, bool more);
+    zmq::message_t make_message(const void* data, size_t size);
 };
 
 // ZeroMQ Publisher implementation
@@ -74,6 +141,7 @@ public:
     bool publish(const void* data, size_t size) override;
     bool publish(const std::string& topic, const void* data, size_t size) override;
     void set_filter(const std::string& filter) override;
+    bool publish_part(const void* data, size_t size, bool more) override;
 };
 
 // ZeroMQ Subscriber implementation  
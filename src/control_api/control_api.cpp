@@ -1,22 +1,20 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
-#include <zmq.hpp>
+#include "../common/http_server.h"
+#include "../common/metrics_aggregator.h"
+#include "../common/hft_metrics.h"
+#include "../common/zmq_transport.h"
+#include "../common/kill_switch.h"
+#include "../strategy_engine/strategy_parameters.h"
 #include <thread>
 #include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <atomic>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <unistd.h>
 #include <sstream>
-#include <map>
-#include <vector>
 #include <cstring>
-#include <algorithm>
 
 namespace hft {
 
@@ -25,15 +23,9 @@ public:
     ControlAPI() 
         : running_(false)
         , logger_("ControlAPI", StaticConfig::get_logger_endpoint())
-        , context_(1)
-        , zmq_publisher_(context_, ZMQ_PUB)
-        , server_socket_(-1)
-        , port_(8081)
+        , http_server_("ControlAPI")
+        , port_(StaticConfig::get_control_api_port())
         , api_key_(get_api_key_from_env()) {
-        
-        // Set socket options for publishing
-        int linger = 0;
-        zmq_publisher_.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
     }
     
     ~ControlAPI() {
@@ -44,35 +36,25 @@ public:
         try {
             // Bind ZMQ publisher to send control commands
             std::string zmq_endpoint = "tcp://*:5560";  // Control command endpoint
-            zmq_publisher_.bind(zmq_endpoint);
+            zmq_publisher_ = TransportFactory::open_publisher(zmq_publisher_config(zmq_endpoint));
             logger_.info("ZMQ publisher bound to: " + zmq_endpoint);
             
-            // Create HTTP server socket
-            server_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-            if (server_socket_ < 0) {
-                logger_.error("Failed to create server socket");
-                return false;
+            // Emergency stops bypass that socket and whatever is queued on it
+            if (!KillSwitch::instance().open(StaticConfig::get_kill_switch_name())) {
+                logger_.warning("Kill switch not shared; emergency stops go over ZMQ only");
             }
             
-            // Set socket options
-            int opt = 1;
-            setsockopt(server_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-            
-            // Bind to port
-            sockaddr_in server_addr{};
-            server_addr.sin_family = AF_INET;
-            server_addr.sin_addr.s_addr = INADDR_LOOPBACK;  // Only localhost access
-            server_addr.sin_port = htons(port_);
-            
-            if (bind(server_socket_, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-                logger_.error("Failed to bind to port " + std::to_string(port_));
-                close(server_socket_);
+            // Warmup status comes from the services' metrics streams
+            if (!metrics_aggregator_.initialize()) {
+                logger_.error("Failed to initialize metrics aggregator");
                 return false;
             }
             
-            if (listen(server_socket_, 5) < 0) {
-                logger_.error("Failed to listen on socket");
-                close(server_socket_);
+            // Requests are served from a non-blocking epoll loop
+            http_server_.set_max_connections(static_cast<size_t>(StaticConfig::get_http_max_connections()));
+            http_server_.set_request_handler([this](const HttpRequest& request) { return handle_request(request); });
+            if (!http_server_.listen("127.0.0.1", static_cast<uint16_t>(port_), 5)) {  // Only localhost access
+                logger_.error("Failed to bind to port " + std::to_string(port_));
                 return false;
             }
             
@@ -88,8 +70,10 @@ public:
     void start() {
         running_ = true;
         
+        metrics_aggregator_.start();
+        
         // Start HTTP server thread
-        server_thread_ = std::make_unique<std::thread>(&ControlAPI::server_loop, this);
+        http_server_.start();
         
         logger_.info("Control API started");
     }
@@ -97,14 +81,8 @@ public:
     void stop() {
         running_ = false;
         
-        if (server_socket_ >= 0) {
-            close(server_socket_);
-            server_socket_ = -1;
-        }
-        
-        if (server_thread_ && server_thread_->joinable()) {
-            server_thread_->join();
-        }
+        http_server_.stop();
+        metrics_aggregator_.stop();
         
         logger_.info("Control API stopped");
     }
@@ -116,14 +94,12 @@ public:
 private:
     std::atomic<bool> running_;
     Logger logger_;
-    zmq::context_t context_;
-    zmq::socket_t zmq_publisher_;
-    int server_socket_;
+    std::unique_ptr<IMessagePublisher> zmq_publisher_;
+    HttpServer http_server_;
+    MetricsAggregator metrics_aggregator_;
     int port_;
     std::string api_key_;
     
-    std::unique_ptr<std::thread> server_thread_;
-    
     // Security helpers
     static std::string get_api_key_from_env() {
         const char* env_key = std::getenv("HFT_API_KEY");
@@ -136,145 +112,83 @@ private:
         return "hft-control-key-2025";  // Development fallback
     }
     
-    static constexpr size_t MAX_REQUEST_SIZE = 8192;  // 8KB limit
-    
-    void server_loop() {
-        logger_.info("HTTP server thread started");
-        
-        while (running_) {
-            sockaddr_in client_addr{};
-            socklen_t client_len = sizeof(client_addr);
-            
-            int client_socket = accept(server_socket_, (struct sockaddr*)&client_addr, &client_len);
-            if (client_socket < 0) {
-                if (running_) {
-                    logger_.warning("Failed to accept client connection");
-                }
-                continue;
-            }
-            
-            // Handle client request
-            handle_request(client_socket);
-            close(client_socket);
-        }
-        
-        logger_.info("HTTP server thread stopped");
-    }
-    
-    void handle_request(int client_socket) {
-        // Set socket timeout for security
-        struct timeval timeout;
-        timeout.tv_sec = 5;  // 5 second timeout
-        timeout.tv_usec = 0;
-        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-        
-        std::vector<char> buffer(MAX_REQUEST_SIZE);
-        ssize_t bytes_read = read(client_socket, buffer.data(), buffer.size() - 1);
-        
-        if (bytes_read <= 0) {
-            send_response(client_socket, 400, "Bad Request", "Invalid request");
-            return;
-        }
-        
-        if (static_cast<size_t>(bytes_read) >= buffer.size() - 1) {
-            send_response(client_socket, 413, "Request Entity Too Large", "Request too large");
-            return;
-        }
-        
-        buffer[bytes_read] = '\0';  // Null terminate
-        std::string request(buffer.data(), bytes_read);
-        
-        // Parse HTTP request
-        auto request_info = parse_http_request(request);
-        
+    HttpResponse handle_request(const HttpRequest& req) {
         // Authenticate
-        if (!authenticate(request_info)) {
-            send_response(client_socket, 401, "Unauthorized", "Invalid API key");
-            return;
+        if (!authenticate(req)) {
+            return HttpResponse::text("Invalid API key", 401, "Unauthorized");
         }
         
         // Route the request
-        route_request(client_socket, request_info);
+        return route_request(req);
     }
     
-    struct HTTPRequest {
-        std::string method;
-        std::string path;
-        std::map<std::string, std::string> headers;
-        std::string body;
-    };
-    
-    HTTPRequest parse_http_request(const std::string& request) {
-        HTTPRequest req;
-        std::istringstream stream(request);
-        std::string line;
-        
-        // Parse request line
-        if (std::getline(stream, line)) {
-            std::istringstream line_stream(line);
-            line_stream >> req.method >> req.path;
-        }
-        
-        // Parse headers
-        while (std::getline(stream, line) && line != "\r" && !line.empty()) {
-            size_t colon_pos = line.find(':');
-            if (colon_pos != std::string::npos) {
-                std::string key = line.substr(0, colon_pos);
-                std::string value = line.substr(colon_pos + 1);
-                
-                // Trim whitespace
-                key.erase(key.find_last_not_of(" \t\r\n") + 1);
-                value.erase(0, value.find_first_not_of(" \t\r\n"));
-                value.erase(value.find_last_not_of(" \t\r\n") + 1);
-                
-                req.headers[key] = value;
-            }
-        }
-        
-        // Parse body (remaining content)
-        std::string remaining_content;
-        std::string body_line;
-        while (std::getline(stream, body_line)) {
-            remaining_content += body_line + "\n";
-        }
-        req.body = remaining_content;
-        
-        return req;
+    bool authenticate(const HttpRequest& req) {
+        const std::string& api_key = req.header("X-API-Key");
+        return !api_key.empty() && api_key == api_key_;
     }
     
-    bool authenticate(const HTTPRequest& req) {
-        auto auth_header = req.headers.find("X-API-Key");
-        if (auth_header == req.headers.end()) {
-            return false;
-        }
-        return auth_header->second == api_key_;
-    }
-    
-    void route_request(int client_socket, const HTTPRequest& req) {
+    HttpResponse route_request(const HttpRequest& req) {
         if (req.method == "POST") {
             if (req.path == "/api/start") {
-                handle_start_command(client_socket);
+                return handle_start_command();
             } else if (req.path == "/api/stop") {
-                handle_stop_command(client_socket);
+                return handle_stop_command();
             } else if (req.path == "/api/emergency_stop") {
-                handle_emergency_stop_command(client_socket);
+                return handle_emergency_stop_command();
             } else if (req.path == "/api/liquidate") {
-                handle_liquidate_command(client_socket);
-            } else {
-                send_response(client_socket, 404, "Not Found", "Endpoint not found");
+                return handle_liquidate_command();
+            } else if (req.path == "/api/reload_config") {
+                return handle_reload_config_command();
+            } else if (req.path == "/api/strategy/load") {
+                return handle_strategy_command(req, ControlAction::LOAD_STRATEGY);
+            } else if (req.path == "/api/strategy/unload") {
+                return handle_strategy_command(req, ControlAction::UNLOAD_STRATEGY);
+            } else if (req.path == "/api/strategy/parameters") {
+                return handle_strategy_command(req, ControlAction::UPDATE_STRATEGY_PARAMETERS);
+            } else if (req.path == "/api/profile") {
+                return handle_profile_command(req);
             }
+            return HttpResponse::text("Endpoint not found", 404, "Not Found");
         } else if (req.method == "GET") {
             if (req.path == "/api/status") {
-                handle_status_request(client_socket);
-            } else {
-                send_response(client_socket, 404, "Not Found", "Endpoint not found");
+                return handle_status_request();
+            }
+            return HttpResponse::text("Endpoint not found", 404, "Not Found");
+        }
+        return HttpResponse::text("Method not supported", 405, "Method Not Allowed");
+    }
+    
+    // Services that must report health.warmup_complete before START_TRADING
+    static constexpr const char* WARMUP_SERVICES[] = {"StrategyEngine", "OrderGateway", "PositionRiskService"};
+    
+    // Comma-separated services still warming up (or not reporting at all)
+    std::string services_not_warm() const {
+        std::string cold;
+        for (const char* service : WARMUP_SERVICES) {
+            auto metrics = metrics_aggregator_.get_service_metrics(service);
+            auto it = metrics.find(hft::metrics::WARMUP_COMPLETE);
+            if (it == metrics.end() || it->second.max_value == 0) {
+                cold += cold.empty() ? service : std::string(",") + service;
             }
-        } else {
-            send_response(client_socket, 405, "Method Not Allowed", "Method not supported");
         }
+        return cold;
     }
     
-    void handle_start_command(int client_socket) {
+    HttpResponse handle_start_command() {
+        if (StaticConfig::get_warmup_required_for_start()) {
+            std::string cold = services_not_warm();
+            if (!cold.empty()) {
+                logger_.warning("Refused START_TRADING, still warming up: " + cold);
+                return HttpResponse::json("{\"status\":\"error\",\"message\":\"Services still warming up\",\"services\":\"" +
+                                          cold + "\"}", 409, "Conflict");
+            }
+        }
+        
+        if (KillSwitch::instance().halted()) {
+            KillSwitch::instance().reset();
+            logger_.warning("Kill switch reset");
+        }
+        
         // Send control command to start trading
         ControlCommand cmd{};
         cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
@@ -284,10 +198,10 @@ private:
         send_zmq_command(cmd);
         
         logger_.info("Sent START_TRADING command");
-        send_json_response(client_socket, 200, "OK", "{\"status\":\"success\",\"message\":\"Trading started\"}");
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Trading started\"}");
     }
     
-    void handle_stop_command(int client_socket) {
+    HttpResponse handle_stop_command() {
         // Send control command to stop trading
         ControlCommand cmd{};
         cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
@@ -297,11 +211,13 @@ private:
         send_zmq_command(cmd);
         
         logger_.info("Sent STOP_TRADING command");
-        send_json_response(client_socket, 200, "OK", "{\"status\":\"success\",\"message\":\"Trading stopped\"}");
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Trading stopped\"}");
     }
     
-    void handle_emergency_stop_command(int client_socket) {
-        // Send emergency stop command
+    HttpResponse handle_emergency_stop_command() {
+        std::string kill = trigger_kill_switch();
+        
+        // Still sent, for anything that only listens on the control socket
         ControlCommand cmd{};
         cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
         cmd.action = ControlAction::EMERGENCY_STOP;
@@ -310,10 +226,13 @@ private:
         send_zmq_command(cmd);
         
         logger_.info("Sent EMERGENCY_STOP command");
-        send_json_response(client_socket, 200, "OK", "{\"status\":\"success\",\"message\":\"Emergency stop executed\"}");
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Emergency stop executed\"," + kill + "}");
     }
     
-    void handle_liquidate_command(int client_socket) {
+    HttpResponse handle_liquidate_command() {
+        // Nothing new goes out and working orders are cancelled first
+        std::string kill = trigger_kill_switch();
+        
         // Send liquidate all positions command
         ControlCommand cmd{};
         cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
@@ -323,10 +242,110 @@ private:
         send_zmq_command(cmd);
         
         logger_.info("Sent LIQUIDATE_ALL command");
-        send_json_response(client_socket, 200, "OK", "{\"status\":\"success\",\"message\":\"All positions liquidated\"}");
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"All positions liquidated\"," + kill + "}");
+    }
+    
+    // Raises the kill switch and waits (up to kill_switch.ack_timeout_ms) for
+    // the gateway to stop taking orders. Returns the JSON members reporting
+    // each party's latency from the trigger, null where it has not answered.
+    std::string trigger_kill_switch() {
+        KillSwitch& kill_switch = KillSwitch::instance();
+        uint64_t word = kill_switch.trigger();
+        int64_t gateway_ns = kill_switch.wait_for_ack(
+            KillParty::GATEWAY, word, std::chrono::milliseconds(StaticConfig::get_kill_switch_ack_timeout_ms()));
+        
+        std::ostringstream json;
+        json << "\"kill_switch\":{";
+        for (size_t i = 0; i < KILL_PARTIES; ++i) {
+            KillParty party = static_cast<KillParty>(i);
+            int64_t latency_ns = party == KillParty::GATEWAY ? gateway_ns : kill_switch.ack_latency_ns(party, word);
+            json << (i > 0 ? "," : "") << "\"" << to_string(party) << "_ns\":";
+            if (latency_ns >= 0) {
+                json << latency_ns;
+            } else {
+                json << "null";
+            }
+        }
+        json << "}";
+        
+        if (gateway_ns >= 0) {
+            logger_.warning("Kill switch raised; gateway halted in " + std::to_string(gateway_ns) + "ns");
+        } else {
+            logger_.error("Kill switch raised; no gateway acknowledgement within " +
+                          std::to_string(StaticConfig::get_kill_switch_ack_timeout_ms()) + "ms");
+        }
+        return json.str();
+    }
+    
+    HttpResponse handle_reload_config_command() {
+        // Every service re-reads its config file on its reloader thread
+        ControlCommand cmd{};
+        cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
+        cmd.action = ControlAction::UPDATE_CONFIG;
+        std::strncpy(cmd.target_service, "all", sizeof(cmd.target_service) - 1);
+        std::strncpy(cmd.parameters, "{\"action\":\"reload_config\"}", sizeof(cmd.parameters) - 1);
+        
+        send_zmq_command(cmd);
+        
+        logger_.info("Sent UPDATE_CONFIG command");
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Configuration reload requested\"}");
+    }
+    
+    // The body (or query string) is forwarded as the command's "key=value"
+    // list; the strategy engine validates it and logs anything it rejects
+    HttpResponse handle_strategy_command(const HttpRequest& req, ControlAction action) {
+        const std::string& spec = req.body.empty() ? req.query : req.body;
+        if (spec.empty()) {
+            return HttpResponse::json("{\"status\":\"error\",\"message\":\"Expected key=value parameters\"}", 400, "Bad Request");
+        }
+        
+        ControlCommand cmd{};
+        if (spec.size() >= sizeof(cmd.parameters)) {
+            return HttpResponse::json("{\"status\":\"error\",\"message\":\"Parameters exceed 127 bytes\"}", 400, "Bad Request");
+        }
+        cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
+        cmd.action = action;
+        std::strncpy(cmd.target_service, "StrategyEngine", sizeof(cmd.target_service) - 1);
+        std::memcpy(cmd.parameters, spec.data(), spec.size());
+        
+        send_zmq_command(cmd);
+        
+        logger_.info("Sent strategy command " + std::to_string(static_cast<int>(action)) + ": " + spec);
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Strategy command sent\"}");
     }
     
-    void handle_status_request(int client_socket) {
+    // "[service=<name>] [seconds=<n>] [hz=<n>]": service defaults to all of
+    // them; the rest is checked by each service's SamplingProfiler
+    HttpResponse handle_profile_command(const HttpRequest& req) {
+        const std::string& spec = req.body.empty() ? req.query : req.body;
+        ParameterAssignments assignments;
+        std::string error;
+        if (!parse_parameter_assignments(spec, assignments, error)) {
+            return HttpResponse::json("{\"status\":\"error\",\"message\":\"Expected key=value parameters\"}", 400, "Bad Request");
+        }
+        std::string service = "all";
+        take_assignment(assignments, "service", service);
+        std::string options;
+        for (const auto& assignment : assignments) {
+            options += (options.empty() ? "" : " ") + assignment.key + "=" + assignment.value;
+        }
+        
+        ControlCommand cmd{};
+        if (service.size() >= sizeof(cmd.target_service) || options.size() >= sizeof(cmd.parameters)) {
+            return HttpResponse::json("{\"status\":\"error\",\"message\":\"Service name or parameters too long\"}", 400, "Bad Request");
+        }
+        cmd.header = MessageFactory::create_header(MessageType::CONTROL_COMMAND, sizeof(cmd));
+        cmd.action = ControlAction::START_PROFILE;
+        std::strncpy(cmd.target_service, service.c_str(), sizeof(cmd.target_service) - 1);
+        std::memcpy(cmd.parameters, options.data(), options.size());
+        
+        send_zmq_command(cmd);
+        
+        logger_.info("Sent START_PROFILE to " + service + (options.empty() ? "" : ": " + options));
+        return HttpResponse::json("{\"status\":\"success\",\"message\":\"Profile requested\"}");
+    }
+    
+    HttpResponse handle_status_request() {
         // Return system status
         std::ostringstream status_json;
         status_json << "{";
@@ -334,47 +353,17 @@ private:
         status_json << "\"timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count() << ",";
         status_json << "\"version\":\"2.0\",";
-        status_json << "\"available_endpoints\":[\"start\",\"stop\",\"emergency_stop\",\"liquidate\",\"status\"]";
+        status_json << "\"available_endpoints\":[\"start\",\"stop\",\"emergency_stop\",\"liquidate\",\"reload_config\",\"strategy/load\",\"strategy/unload\",\"strategy/parameters\",\"profile\",\"status\"]";
         status_json << "}";
         
-        send_json_response(client_socket, 200, "OK", status_json.str());
+        return HttpResponse::json(status_json.str());
     }
     
     void send_zmq_command(const ControlCommand& cmd) {
-        try {
-            zmq::message_t msg(sizeof(cmd));
-            std::memcpy(msg.data(), &cmd, sizeof(cmd));
-            zmq_publisher_.send(msg, zmq::send_flags::dontwait);
-        } catch (const std::exception& e) {
-            logger_.error("Failed to send ZMQ command: " + std::string(e.what()));
+        if (!zmq_publisher_->publish(&cmd, sizeof(cmd))) {
+            logger_.error("Failed to send ZMQ command");
         }
     }
-    
-    void send_response(int client_socket, int status_code, const std::string& status_text, const std::string& body) {
-        std::ostringstream response;
-        response << "HTTP/1.1 " << status_code << " " << status_text << "\r\n";
-        response << "Content-Type: text/plain\r\n";
-        response << "Access-Control-Allow-Origin: *\r\n";
-        response << "Content-Length: " << body.length() << "\r\n";
-        response << "\r\n";
-        response << body;
-        
-        std::string response_str = response.str();
-        send(client_socket, response_str.c_str(), response_str.length(), 0);
-    }
-    
-    void send_json_response(int client_socket, int status_code, const std::string& status_text, const std::string& json_body) {
-        std::ostringstream response;
-        response << "HTTP/1.1 " << status_code << " " << status_text << "\r\n";
-        response << "Content-Type: application/json\r\n";
-        response << "Access-Control-Allow-Origin: *\r\n";
-        response << "Content-Length: " << json_body.length() << "\r\n";
-        response << "\r\n";
-        response << json_body;
-        
-        std::string response_str = response.str();
-        send(client_socket, response_str.c_str(), response_str.length(), 0);
-    }
 };
 
 } // namespace hft
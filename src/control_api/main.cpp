@@ -1,5 +1,8 @@
 #include "control_api.h"
+#include "../common/static_config.h"
+#include "../common/cpu_topology.h"
 #include <iostream>
+#include <string>
 #include <thread>
 #include <chrono>
 #include <signal.h>
@@ -11,10 +14,14 @@ void signal_handler(int signal) {
     g_running = false;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "HFT Control API v2.0" << std::endl;
     std::cout << "====================" << std::endl;
     
+    std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
+    hft::StaticConfig::load_from_file(config_file.c_str());
+    hft::ThreadPlan::instance().configure("control_api");
+    
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
@@ -0,0 +1,97 @@
+#include "../strategy_engine/strategy_engine.h"
+#include "../order_gateway/order_gateway.h"
+#include "../common/logging.h"
+#include "../common/static_config.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/sampling_profiler.h"
+#include "../common/spsc_channel.h"
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <signal.h>
+#include <thread>
+
+using namespace hft;
+
+// Strategy engine and order gateway in one process: signals cross from the
+// strategy thread to the gateway thread through a SignalChannel instead of
+// ZMQ PUB/SUB. Market data, executions, risk limits and metrics still use the
+// usual endpoints, so this replaces the strategy_engine and order_gateway
+// processes (never run it alongside them). Threads come from
+// thread.fast_path.strategy.* and thread.fast_path.gateway.* in the config.
+
+static std::atomic<bool> g_stop_requested{false};
+
+void signal_handler(int signal) {
+    std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
+    g_stop_requested.store(true);
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "HFT Fast Path (strategy + gateway) v1.0" << std::endl;
+    std::cout << "=======================================" << std::endl;
+
+    std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
+    StaticConfig::load_from_file(config_file.c_str());
+    ThreadPlan::instance().configure("fast_path");
+    // Reserve and pre-fault hot-state memory before the services allocate from it
+    HugePageArena::hot();
+    GlobalLogger::instance().init("FastPath", StaticConfig::get_logger_endpoint());
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    try {
+        // In the hot arena with the rest of the hot state; outlives both services
+        auto* channel_memory = hot_memory()->allocate(sizeof(SignalChannel), alignof(SignalChannel));
+        auto* channel = new (channel_memory) SignalChannel();
+
+        auto gateway = std::make_unique<OrderGateway>();
+        auto engine = std::make_unique<StrategyEngine>();
+        gateway->set_thread_prefix("gateway.");
+        gateway->set_signal_channel(channel);
+        engine->set_thread_prefix("strategy.");
+        engine->set_signal_channel(channel);
+
+        if (!gateway->initialize()) {
+            std::cerr << "Failed to initialize Order Gateway" << std::endl;
+            return 1;
+        }
+        if (!engine->initialize()) {
+            std::cerr << "Failed to initialize Strategy Engine" << std::endl;
+            return 1;
+        }
+        std::cout << "Hot arena: " << HugePageArena::hot().describe() << std::endl;
+
+        // Gateway warms up first: both services set this process's one warmup
+        // gauge, so the engine has to be the one that finishes last
+        gateway->start();
+        while (!gateway->is_warm() && !g_stop_requested.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        engine->start();
+        SamplingProfiler::instance().start_control_listener("FastPath");
+
+        std::cout << "Fast path is running. Press Ctrl+C to stop." << std::endl;
+
+        while (!g_stop_requested.load() && engine->is_running() && gateway->is_running()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        SamplingProfiler::instance().stop_control_listener();
+        SamplingProfiler::instance().stop();
+
+        // Producer first, so nothing is staged for a gateway that has stopped
+        engine->stop();
+        gateway->stop();
+
+        std::cout << "Fast path shutdown complete." << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
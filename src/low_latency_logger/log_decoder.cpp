@@ -0,0 +1,81 @@
+// Renders binary log files written by the low_latency_logger service as the
+// same text lines the services print on their consoles.
+//
+// Usage: hft_log_decoder <file.bin> [more files...]   (text goes to stdout)
+
+#include "../common/binary_log.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+bool decode_file(const char* path, binlog::LogDecoder& decoder) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::cerr << "[LogDecoder] Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::vector<char> batch;
+    std::string text;
+    uint64_t offset = 0;
+    bool ok = true;
+
+    while (true) {
+        binlog::BatchHeader header;
+        size_t n = std::fread(&header, 1, sizeof(header), file);
+        if (n == 0) break;
+        // A file still being written ends in a zero-padded block
+        if (n >= sizeof(header.magic) && header.magic == 0) break;
+        if (n != sizeof(header) || header.magic != binlog::BATCH_MAGIC) {
+            std::cerr << "[LogDecoder] " << path << ": bad batch header at offset " << offset << std::endl;
+            ok = false;
+            break;
+        }
+
+        batch.resize(sizeof(header) + header.payload_size);
+        std::memcpy(batch.data(), &header, sizeof(header));
+        if (std::fread(batch.data() + sizeof(header), 1, header.payload_size, file) != header.payload_size) {
+            std::cerr << "[LogDecoder] " << path << ": truncated batch at offset " << offset << std::endl;
+            ok = false;
+            break;
+        }
+
+        text.clear();
+        if (!decoder.decode_batch(batch.data(), batch.size(), text)) {
+            std::cerr << "[LogDecoder] " << path << ": corrupt batch at offset " << offset << std::endl;
+        }
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        offset += batch.size();
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.bin> [more files...]" << std::endl;
+        return 1;
+    }
+
+    binlog::LogDecoder decoder;
+    bool ok = true;
+    for (int i = 1; i < argc; ++i) {
+        ok = decode_file(argv[i], decoder) && ok;
+    }
+
+    std::cerr << "[LogDecoder] " << decoder.entries_decoded() << " entries";
+    if (decoder.dropped_reported() > 0) {
+        std::cerr << ", " << decoder.dropped_reported() << " dropped by senders";
+    }
+    std::cerr << std::endl;
+    return ok ? 0 : 1;
+}
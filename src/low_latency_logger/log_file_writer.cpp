@@ -0,0 +1,377 @@
+#include "log_file_writer.h"
+#include "../common/static_config.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+size_t round_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+LogFileWriterConfig LogFileWriterConfig::from_config() {
+    LogFileWriterConfig config;
+    config.buffer_size = static_cast<size_t>(StaticConfig::get_logger_write_buffer_kb()) * 1024;
+    config.preallocate_bytes = static_cast<uint64_t>(StaticConfig::get_logger_preallocate_mb()) << 20;
+    config.rotate_bytes = static_cast<uint64_t>(StaticConfig::get_logger_rotate_size_mb()) << 20;
+    config.rotate_interval = std::chrono::seconds(StaticConfig::get_logger_rotate_interval_seconds());
+    config.direct_io = StaticConfig::get_logger_direct_io();
+    config.use_io_uring = StaticConfig::get_enable_io_uring();
+    return config;
+}
+
+LogFileWriter::LogFileWriter(const LogFileWriterConfig& config)
+    : config_(config)
+    , capacity_(round_up(std::max(config.buffer_size, 16 * BLOCK_SIZE), BLOCK_SIZE)) {
+}
+
+LogFileWriter::~LogFileWriter() {
+    close();
+    for (auto& buffer : buffers_) {
+        std::free(buffer.data);
+        buffer.data = nullptr;
+    }
+}
+
+bool LogFileWriter::open() {
+    for (auto& buffer : buffers_) {
+        if (!buffer.data) {
+            void* memory = nullptr;
+            if (posix_memalign(&memory, BLOCK_SIZE, capacity_) != 0) {
+                std::cerr << "[LogFileWriter] Failed to allocate " << capacity_ << " byte buffer" << std::endl;
+                return false;
+            }
+            buffer.data = static_cast<char*>(memory);
+        }
+    }
+
+    if (config_.use_io_uring) {
+        init_io_uring();
+    }
+    return open_file();
+}
+
+void LogFileWriter::close() {
+    close_file();
+    cleanup_io_uring();
+}
+
+bool LogFileWriter::append(const void* data, size_t size) {
+    if (fd_ < 0) {
+        return false;
+    }
+    // A carried partial block plus the record must fit in one buffer
+    if (size > capacity_ - BLOCK_SIZE) {
+        write_errors_++;
+        return false;
+    }
+
+    if (rotation_due(size)) {
+        close_file();
+        rotations_++;
+        if (!open_file()) {
+            return false;
+        }
+    }
+
+    Buffer* buffer = &buffers_[active_];
+    if (buffer->used + size > capacity_) {
+        // Write the whole blocks; the partial one starts the next buffer
+        int next = active_ ^ 1;
+        if (buffers_[next].in_flight) {
+            buffer_waits_++;
+            wait_for(next);
+        }
+
+        size_t aligned = buffer->used & ~(BLOCK_SIZE - 1);
+        Buffer& next_buffer = buffers_[next];
+        next_buffer.used = buffer->used - aligned;
+        next_buffer.flushed = 0;
+        next_buffer.file_offset = buffer->file_offset + aligned;
+        std::memcpy(next_buffer.data, buffer->data + aligned, next_buffer.used);
+
+        submit(active_, aligned);
+        active_ = next;
+        buffer = &next_buffer;
+    }
+
+    std::memcpy(buffer->data + buffer->used, data, size);
+    buffer->used += size;
+    logical_size_ += size;
+    bytes_appended_.fetch_add(size, std::memory_order_relaxed);
+
+    if (uring_active_) {
+        reap_completions(false);
+    }
+    return true;
+}
+
+void LogFileWriter::flush() {
+    if (fd_ < 0) {
+        return;
+    }
+    // Quiet periods are when time-based rotation gets noticed
+    if (rotation_due(0)) {
+        close_file();
+        rotations_++;
+        open_file();
+        return;
+    }
+    flush_buffers();
+}
+
+void LogFileWriter::flush_buffers() {
+    wait_for(active_ ^ 1);
+
+    Buffer& buffer = buffers_[active_];
+    if (buffer.used == buffer.flushed) {
+        return;
+    }
+
+    // Zero-pad to a whole block; the block is rewritten as it fills up
+    size_t padded = round_up(buffer.used, BLOCK_SIZE);
+    std::memset(buffer.data + buffer.used, 0, padded - buffer.used);
+    submit(active_, padded);
+    wait_for(active_);
+    buffer.flushed = buffer.used;
+}
+
+bool LogFileWriter::rotation_due(size_t incoming) const {
+    if (logical_size_ == 0) {
+        return false;
+    }
+    if (config_.rotate_bytes > 0 && logical_size_ + incoming > config_.rotate_bytes) {
+        return true;
+    }
+    return config_.rotate_interval.count() > 0 &&
+           std::chrono::steady_clock::now() - opened_at_ >= config_.rotate_interval;
+}
+
+bool LogFileWriter::open_file() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+
+    // Rotations within the same second get a sequence suffix
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        path_ = config_.directory + "/" + config_.prefix + stamp;
+        if (file_sequence_ > 0) {
+            path_ += "_" + std::to_string(file_sequence_);
+        }
+        path_ += config_.extension;
+
+        int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+        fd_ = ::open(path_.c_str(), flags | (config_.direct_io ? O_DIRECT : 0), 0644);
+        direct_active_ = config_.direct_io && fd_ >= 0;
+        if (fd_ < 0 && config_.direct_io && errno == EINVAL) {
+            // tmpfs and some network filesystems don't do O_DIRECT
+            fd_ = ::open(path_.c_str(), flags, 0644);
+        }
+        if (fd_ >= 0) {
+            break;
+        }
+        if (errno != EEXIST) {
+            std::cerr << "[LogFileWriter] Failed to open " << path_ << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        file_sequence_++;
+    }
+    if (fd_ < 0) {
+        return false;
+    }
+    file_sequence_++;
+
+    // Reserve the extents now so appends don't allocate; KEEP_SIZE leaves
+    // the visible size at what has actually been written
+    if (config_.preallocate_bytes > 0 &&
+        fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(config_.preallocate_bytes)) != 0) {
+        std::cerr << "[LogFileWriter] fallocate failed on " << path_ << ": " << std::strerror(errno)
+                  << " (continuing without preallocation)" << std::endl;
+    }
+
+    for (auto& buffer : buffers_) {
+        buffer.used = 0;
+        buffer.flushed = 0;
+        buffer.file_offset = 0;
+    }
+    active_ = 0;
+    logical_size_ = 0;
+    opened_at_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void LogFileWriter::close_file() {
+    if (fd_ < 0) {
+        return;
+    }
+    flush_buffers();
+    // Drop the zero padding of the last partial block
+    if (ftruncate(fd_, static_cast<off_t>(logical_size_)) != 0) {
+        std::cerr << "[LogFileWriter] ftruncate failed on " << path_ << ": " << std::strerror(errno) << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void LogFileWriter::submit(int index, size_t length) {
+    Buffer& buffer = buffers_[index];
+    if (length == 0) {
+        return;
+    }
+
+#ifdef HAS_IO_URING
+    if (uring_active_) {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            reap_completions(true);
+            sqe = io_uring_get_sqe(&ring_);
+        }
+        if (sqe) {
+            io_uring_prep_write_fixed(sqe, fd_, buffer.data, static_cast<unsigned>(length),
+                                      buffer.file_offset, index);
+            sqe->user_data = static_cast<uint64_t>(index);
+            buffer.write_length = length;
+            buffer.in_flight = true;
+            io_uring_submit(&ring_);
+            return;
+        }
+    }
+#endif
+
+    buffer.write_length = length;
+    if (write_sync(buffer.data, length, buffer.file_offset)) {
+        writes_completed_++;
+    } else {
+        write_errors_++;
+    }
+}
+
+void LogFileWriter::wait_for(int index) {
+    while (buffers_[index].in_flight) {
+        reap_completions(true);
+    }
+}
+
+void LogFileWriter::reap_completions(bool wait) {
+#ifdef HAS_IO_URING
+    if (!uring_active_) {
+        return;
+    }
+    io_uring_cqe* cqe = nullptr;
+    int ret = wait ? io_uring_wait_cqe(&ring_, &cqe) : io_uring_peek_cqe(&ring_, &cqe);
+    if (ret < 0 && ret != -EAGAIN && ret != -EINTR) {
+        // The ring is unusable; fail what's in flight rather than spin on it
+        std::cerr << "[LogFileWriter] io_uring wait failed: " << std::strerror(-ret) << std::endl;
+        for (int i = 0; i < 2; ++i) {
+            if (buffers_[i].in_flight) complete(i, ret);
+        }
+        return;
+    }
+    while (ret == 0 && cqe) {
+        int index = static_cast<int>(cqe->user_data);
+        long result = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        complete(index, result);
+        ret = io_uring_peek_cqe(&ring_, &cqe);
+    }
+#else
+    (void)wait;
+#endif
+}
+
+void LogFileWriter::complete(int index, long result) {
+    Buffer& buffer = buffers_[index];
+    buffer.in_flight = false;
+    if (result == static_cast<long>(buffer.write_length)) {
+        writes_completed_++;
+        return;
+    }
+    if (result >= 0 && write_sync(buffer.data + result, buffer.write_length - result, buffer.file_offset + result)) {
+        writes_completed_++;    // Short write, finished synchronously
+        return;
+    }
+    write_errors_++;
+    std::cerr << "[LogFileWriter] Write to " << path_ << " failed: "
+              << std::strerror(result < 0 ? static_cast<int>(-result) : EIO) << std::endl;
+}
+
+bool LogFileWriter::write_sync(const char* data, size_t length, uint64_t offset) {
+    while (length > 0) {
+        ssize_t written = ::pwrite(fd_, data, length, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && errno == EINVAL && direct_active_) {
+            // Opened fine but the filesystem refuses direct writes
+            std::cerr << "[LogFileWriter] O_DIRECT write rejected, continuing with buffered I/O" << std::endl;
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) & ~O_DIRECT);
+            direct_active_ = false;
+            continue;
+        }
+        if (written <= 0) {
+            std::cerr << "[LogFileWriter] Write to " << path_ << " failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+void LogFileWriter::init_io_uring() {
+#ifdef HAS_IO_URING
+    if (uring_active_) {
+        return;
+    }
+    if (io_uring_queue_init(8, &ring_, 0) < 0) {
+        std::cerr << "[LogFileWriter] Failed to initialize io_uring, using pwrite" << std::endl;
+        return;
+    }
+    // Registered once, so the kernel doesn't map the pages on every write
+    struct iovec iovecs[2];
+    for (int i = 0; i < 2; ++i) {
+        iovecs[i].iov_base = buffers_[i].data;
+        iovecs[i].iov_len = capacity_;
+    }
+    if (io_uring_register_buffers(&ring_, iovecs, 2) < 0) {
+        std::cerr << "[LogFileWriter] Failed to register io_uring buffers, using pwrite" << std::endl;
+        io_uring_queue_exit(&ring_);
+        return;
+    }
+    uring_active_ = true;
+    std::cout << "[LogFileWriter] io_uring initialized with 2 x " << (capacity_ >> 10) << " KB registered buffers"
+              << std::endl;
+#else
+    std::cerr << "[LogFileWriter] Built without io_uring support, using pwrite" << std::endl;
+#endif
+}
+
+void LogFileWriter::cleanup_io_uring() {
+#ifdef HAS_IO_URING
+    if (uring_active_) {
+        for (int i = 0; i < 2; ++i) {
+            wait_for(i);
+        }
+        io_uring_unregister_buffers(&ring_);
+        io_uring_queue_exit(&ring_);
+        uring_active_ = false;
+    }
+#endif
+}
+
+} // namespace hft
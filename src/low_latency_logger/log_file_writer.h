@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#ifdef HAS_IO_URING
+#include <liburing.h>
+#endif
+
+namespace hft {
+
+struct LogFileWriterConfig {
+    std::string directory = "logs";
+    std::string prefix = "hft_";
+    std::string extension = ".bin";
+    size_t buffer_size = 2 * 1024 * 1024;          // Each of the two buffers; rounded to 4 KB
+    uint64_t preallocate_bytes = 256ULL << 20;     // fallocate'd up front, per file (0 = off)
+    uint64_t rotate_bytes = 256ULL << 20;          // Start a new file past this size (0 = off)
+    std::chrono::seconds rotate_interval{3600};    // ...or after this long (0 = off)
+    bool direct_io = true;                         // O_DIRECT; falls back if the filesystem refuses
+    bool use_io_uring = false;                     // Needs HAS_IO_URING at build time
+
+    // logger.* keys from StaticConfig
+    static LogFileWriterConfig from_config();
+};
+
+// Appends log batches to disk through two aligned buffers: one fills while
+// the other is being written. With io_uring both buffers are registered
+// once and written with WRITE_FIXED, so the writer thread only blocks when
+// the disk falls a full buffer behind; without it, writes are plain pwrite.
+//
+// O_DIRECT writes must be block-aligned, so a buffer is written up to its
+// last whole block and the remainder is carried into the next buffer. flush()
+// writes the partial block zero-padded and rewrites it once it fills; close()
+// and rotation truncate the padding away. Single-threaded.
+class LogFileWriter {
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    explicit LogFileWriter(const LogFileWriterConfig& config);
+    ~LogFileWriter();
+
+    LogFileWriter(const LogFileWriter&) = delete;
+    LogFileWriter& operator=(const LogFileWriter&) = delete;
+
+    bool open();
+    void close();
+
+    // A record (log batch) never straddles two files. False if it couldn't
+    // be stored (larger than a buffer, or the file couldn't be opened).
+    bool append(const void* data, size_t size);
+
+    // Gets everything appended so far onto disk; call when idle
+    void flush();
+
+    const std::string& current_path() const { return path_; }
+    bool is_direct() const { return direct_active_; }
+    bool is_io_uring() const { return uring_active_; }
+
+    // Statistics (readable from other threads)
+    uint64_t bytes_appended() const { return bytes_appended_.load(std::memory_order_relaxed); }
+    uint64_t writes_completed() const { return writes_completed_.load(std::memory_order_relaxed); }
+    uint64_t write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+    uint64_t buffer_waits() const { return buffer_waits_.load(std::memory_order_relaxed); }
+    uint64_t rotations() const { return rotations_.load(std::memory_order_relaxed); }
+
+private:
+    struct Buffer {
+        char* data = nullptr;
+        size_t used = 0;
+        uint64_t file_offset = 0;   // Block-aligned position of data[0] in the file
+        size_t write_length = 0;    // Bytes of the write in flight
+        size_t flushed = 0;         // used as of the last flush()
+        bool in_flight = false;
+    };
+
+    LogFileWriterConfig config_;
+    size_t capacity_;               // Per buffer, block-aligned
+    Buffer buffers_[2];
+    int active_ = 0;
+    int fd_ = -1;
+    std::string path_;
+    uint64_t logical_size_ = 0;     // Bytes appended to the current file
+    std::chrono::steady_clock::time_point opened_at_;
+    int file_sequence_ = 0;
+    bool direct_active_ = false;
+    bool uring_active_ = false;
+
+#ifdef HAS_IO_URING
+    struct io_uring ring_;
+#endif
+
+    std::atomic<uint64_t> bytes_appended_{0};
+    std::atomic<uint64_t> writes_completed_{0};
+    std::atomic<uint64_t> write_errors_{0};
+    std::atomic<uint64_t> buffer_waits_{0};
+    std::atomic<uint64_t> rotations_{0};
+
+    bool open_file();
+    void close_file();
+    bool rotation_due(size_t incoming) const;
+    void flush_buffers();
+
+    // Starts writing length bytes of buffer (length is block-aligned)
+    void submit(int index, size_t length);
+    void wait_for(int index);
+    void reap_completions(bool wait);
+    void complete(int index, long result);
+    bool write_sync(const char* data, size_t length, uint64_t offset);
+
+    void init_io_uring();
+    void cleanup_io_uring();
+};
+
+} // namespace hft
@@ -1,19 +1,21 @@
 #include "low_latency_logger.h"
+#include "../common/metrics_collector.h"
+#include "../common/hft_metrics.h"
+#include "../common/cpu_topology.h"
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
 #include <iostream>
 
 namespace hft {
 
 LowLatencyLogger::LowLatencyLogger()
     : running_(false)
-    , messages_received_(0)
-    , messages_written_(0)
-    , messages_dropped_(0)
-#ifdef HAS_IO_URING
-    , io_uring_initialized_(false)
-#endif
+    , metrics_publisher_("LowLatencyLogger",
+                         "tcp://*:" + std::to_string(StaticConfig::get_low_latency_logger_metrics_port()))
+    , batches_received_(0)
+    , bytes_written_(0)
+    , records_dropped_(0)
+    , invalid_messages_(0)
 {
 }
 
@@ -24,6 +26,12 @@ LowLatencyLogger::~LowLatencyLogger() {
 bool LowLatencyLogger::initialize() {
     std::cout << "[LowLatencyLogger] Initializing Low-Latency Logger" << std::endl;
     
+    MetricsCollector::instance().initialize();
+    if (!metrics_publisher_.initialize()) {
+        std::cerr << "[LowLatencyLogger] Failed to initialize metrics publisher" << std::endl;
+        return false;
+    }
+    
     try {
         // Initialize ZeroMQ
         context_ = std::make_unique<zmq::context_t>(1);
@@ -31,33 +39,24 @@ bool LowLatencyLogger::initialize() {
         
         int rcvhwm = 10000;
         log_subscriber_->setsockopt(ZMQ_RCVHWM, &rcvhwm, sizeof(rcvhwm));
+        int rcvtimeo = 100;     // Idle wakeups flush the file and check running_
+        log_subscriber_->setsockopt(ZMQ_RCVTIMEO, &rcvtimeo, sizeof(rcvtimeo));
         
-        const char* endpoint = StaticConfig::get_logger_endpoint();
+        std::string endpoint = StaticConfig::get_logger_endpoint();
         log_subscriber_->bind(endpoint);
         std::cout << "[LowLatencyLogger] Bound to " << endpoint << std::endl;
         
-        // Initialize log file
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        
-        std::ostringstream filename_ss;
-        filename_ss << "logs/hft_" << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") << ".log";
-        log_filename_ = filename_ss.str();
-        
-        log_file_ = std::make_unique<std::ofstream>(log_filename_, std::ios::app);
-        if (!log_file_->is_open()) {
-            std::cerr << "[LowLatencyLogger] Failed to open log file: " << log_filename_ << std::endl;
+        // Open the first log file
+        writer_ = std::make_unique<LogFileWriter>(LogFileWriterConfig::from_config());
+        if (!writer_->open()) {
+            std::cerr << "[LowLatencyLogger] Failed to open log file in logs/" << std::endl;
             return false;
         }
         
-        std::cout << "[LowLatencyLogger] Logging to: " << log_filename_ << std::endl;
-        
-        // Initialize io_uring if available and enabled
-#ifdef HAS_IO_URING
-        if (StaticConfig::get_enable_io_uring()) {
-            init_io_uring();
-        }
-#endif
+        std::cout << "[LowLatencyLogger] Logging to: " << writer_->current_path()
+                  << " (" << (writer_->is_io_uring() ? "io_uring" : "pwrite")
+                  << (writer_->is_direct() ? ", O_DIRECT" : "")
+                  << "; render with hft_log_decoder)" << std::endl;
         
         return true;
         
@@ -79,9 +78,9 @@ void LowLatencyLogger::start() {
     std::cout << "[LowLatencyLogger] Starting logger" << std::endl;
     running_.store(true);
     
-    // Start receiver and writer threads
+    last_metrics_time_ = std::chrono::steady_clock::now();
     receiver_thread_ = std::make_unique<std::thread>(&LowLatencyLogger::receive_messages, this);
-    writer_thread_ = std::make_unique<std::thread>(&LowLatencyLogger::write_messages, this);
+    metrics_publisher_.start(StaticConfig::get_metrics_publisher_interval_ms());
     
     std::cout << "[LowLatencyLogger] Logger started" << std::endl;
 }
@@ -94,28 +93,20 @@ void LowLatencyLogger::stop() {
     std::cout << "[LowLatencyLogger] Stopping logger" << std::endl;
     running_.store(false);
     
-    // Wake up writer thread
-    queue_cv_.notify_all();
-    
     if (receiver_thread_ && receiver_thread_->joinable()) {
         receiver_thread_->join();
     }
     
-    if (writer_thread_ && writer_thread_->joinable()) {
-        writer_thread_->join();
-    }
-    
     if (log_subscriber_) {
         log_subscriber_->close();
     }
     
-    if (log_file_) {
-        log_file_->close();
+    if (writer_) {
+        writer_->close();
     }
     
-#ifdef HAS_IO_URING
-    cleanup_io_uring();
-#endif
+    update_metrics();
+    metrics_publisher_.stop();
     
     log_statistics();
     std::cout << "[LowLatencyLogger] Logger stopped" << std::endl;
@@ -126,31 +117,36 @@ bool LowLatencyLogger::is_running() const {
 }
 
 void LowLatencyLogger::receive_messages() {
+    if (!ThreadPlan::instance().pin_current_thread("processing")) {
+        std::cerr << "[LowLatencyLogger] Failed to pin processing thread to its planned CPU" << std::endl;
+    }
     std::cout << "[LowLatencyLogger] Message receiver thread started" << std::endl;
     
+    auto last_flush_time = std::chrono::steady_clock::now();
+    auto last_stats_time = last_flush_time;
+    const auto flush_interval = std::chrono::seconds(1);
+    const auto stats_interval = std::chrono::seconds(60);
+    
     while (running_.load()) {
         try {
             zmq::message_t message;
-            if (log_subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                if (message.size() == sizeof(LogMessage)) {
-                    LogMessage log_msg;
-                    std::memcpy(&log_msg, message.data(), sizeof(LogMessage));
-                    
-                    // Add to queue for async processing
-                    {
-                        std::lock_guard<std::mutex> lock(queue_mutex_);
-                        if (message_queue_.size() < MAX_QUEUE_SIZE) {
-                            message_queue_.push(log_msg);
-                            messages_received_++;
-                        } else {
-                            messages_dropped_++;
-                        }
-                    }
-                    queue_cv_.notify_one();
-                }
+            bool received = static_cast<bool>(log_subscriber_->recv(message, zmq::recv_flags::none));
+            if (received) {
+                write_batch(message);
             }
             
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            auto now = std::chrono::steady_clock::now();
+            if (!received || now - last_flush_time >= flush_interval) {
+                writer_->flush();
+                last_flush_time = now;
+            }
+            if (now - last_metrics_time_ >= flush_interval) {
+                update_metrics();
+            }
+            if (now - last_stats_time >= stats_interval) {
+                log_statistics();
+                last_stats_time = now;
+            }
             
         } catch (const zmq::error_t& e) {
             if (e.num() != EAGAIN && e.num() != EINTR) {
@@ -159,130 +155,65 @@ void LowLatencyLogger::receive_messages() {
         }
     }
     
+    writer_->flush();
     std::cout << "[LowLatencyLogger] Message receiver thread stopped" << std::endl;
 }
 
-void LowLatencyLogger::write_messages() {
-    std::cout << "[LowLatencyLogger] Message writer thread started" << std::endl;
-    
-    auto last_stats_time = std::chrono::steady_clock::now();
-    const auto stats_interval = std::chrono::seconds(60);
-    
-    while (running_.load() || !message_queue_.empty()) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        
-        // Wait for messages or timeout
-        queue_cv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
-            return !message_queue_.empty() || !running_.load();
-        });
-        
-        // Process all available messages
-        while (!message_queue_.empty()) {
-            LogMessage msg = message_queue_.front();
-            message_queue_.pop();
-            lock.unlock();
-            
-            write_log_message(msg);
-            messages_written_++;
-            
-            lock.lock();
-        }
-        
-        lock.unlock();
-        
-        // Log statistics periodically
-        auto now = std::chrono::steady_clock::now();
-        if (now - last_stats_time >= stats_interval) {
-            log_statistics();
-            last_stats_time = now;
-        }
-    }
-    
-    std::cout << "[LowLatencyLogger] Message writer thread stopped" << std::endl;
-}
-
-void LowLatencyLogger::write_log_message(const LogMessage& msg) {
-    if (!log_file_ || !log_file_->is_open()) {
+void LowLatencyLogger::write_batch(const zmq::message_t& message) {
+    binlog::BatchHeader header;
+    if (message.size() < sizeof(header)) {
+        invalid_messages_++;
         return;
     }
-    
-    std::string formatted = format_log_message(msg);
-    
-#ifdef HAS_IO_URING
-    if (io_uring_initialized_) {
-        // TODO: Implement async write with io_uring
-        // For now, fall back to synchronous write
-        *log_file_ << formatted << std::endl;
-        log_file_->flush();
-    } else {
-#endif
-        *log_file_ << formatted << std::endl;
-        log_file_->flush();
-#ifdef HAS_IO_URING
+    std::memcpy(&header, message.data(), sizeof(header));
+    if (header.magic != binlog::BATCH_MAGIC || sizeof(header) + header.payload_size != message.size()) {
+        invalid_messages_++;
+        return;
     }
-#endif
-}
-
-std::string LowLatencyLogger::format_log_message(const LogMessage& msg) {
-    auto time_point = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(time_point);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        time_point.time_since_epoch()
-    ) % 1000;
-    
-    std::ostringstream oss;
-    oss << "[" << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    oss << "." << std::setfill('0') << std::setw(3) << ms.count() << "] ";
     
-    // Add level
-    switch (msg.level) {
-        case LogLevel::DEBUG: oss << "[DEBUG] "; break;
-        case LogLevel::INFO: oss << "[INFO]  "; break;
-        case LogLevel::WARNING: oss << "[WARN]  "; break;
-        case LogLevel::ERROR: oss << "[ERROR] "; break;
-        case LogLevel::CRITICAL: oss << "[CRIT]  "; break;
+    if (!writer_->append(message.data(), message.size())) {
+        return;     // Counted in the writer's write_errors
     }
     
-    oss << msg.component << ": " << msg.message;
-    return oss.str();
+    batches_received_++;
+    bytes_written_ += message.size();
+    records_dropped_ += header.dropped;
 }
 
-void LowLatencyLogger::init_io_uring() {
-#ifdef HAS_IO_URING
-    if (io_uring_queue_init(256, &ring_, 0) < 0) {
-        std::cerr << "[LowLatencyLogger] Failed to initialize io_uring" << std::endl;
-        io_uring_initialized_ = false;
-    } else {
-        io_uring_initialized_ = true;
-        std::cout << "[LowLatencyLogger] io_uring initialized successfully" << std::endl;
+void LowLatencyLogger::update_metrics() {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t bytes = bytes_written_.load();
+    double seconds = std::chrono::duration<double>(now - last_metrics_time_).count();
+    if (seconds > 0) {
+        HFT_GAUGE_VALUE(metrics::LOG_WRITE_BYTES_PER_SEC,
+                        static_cast<uint64_t>((bytes - last_metrics_bytes_) / seconds));
     }
-#endif
-}
-
-void LowLatencyLogger::cleanup_io_uring() {
-#ifdef HAS_IO_URING
-    if (io_uring_initialized_) {
-        io_uring_queue_exit(&ring_);
-        io_uring_initialized_ = false;
+    last_metrics_bytes_ = bytes;
+    last_metrics_time_ = now;
+    
+    HFT_GAUGE_VALUE(metrics::LOG_BATCHES_TOTAL, batches_received_.load());
+    HFT_GAUGE_VALUE(metrics::LOG_BYTES_WRITTEN_TOTAL, bytes);
+    HFT_GAUGE_VALUE(metrics::LOG_RECORDS_DROPPED_TOTAL, records_dropped_.load());
+    HFT_GAUGE_VALUE(metrics::LOG_INVALID_MESSAGES_TOTAL, invalid_messages_.load());
+    if (writer_) {
+        HFT_GAUGE_VALUE(metrics::LOG_WRITE_ERRORS_TOTAL, writer_->write_errors());
+        HFT_GAUGE_VALUE(metrics::LOG_BUFFER_WAITS_TOTAL, writer_->buffer_waits());
+        HFT_GAUGE_VALUE(metrics::LOG_FILE_ROTATIONS_TOTAL, writer_->rotations());
     }
-#endif
 }
 
 void LowLatencyLogger::log_statistics() {
-    uint64_t received = messages_received_.load();
-    uint64_t written = messages_written_.load();
-    uint64_t dropped = messages_dropped_.load();
-    
-    std::string stats = "[LowLatencyLogger] Stats: received=" + std::to_string(received) +
-                       ", written=" + std::to_string(written) +
-                       ", dropped=" + std::to_string(dropped) +
-                       ", queue_size=" + std::to_string(message_queue_.size());
-    
-    std::cout << stats << std::endl;
-    
-    if (log_file_ && log_file_->is_open()) {
-        *log_file_ << stats << std::endl;
+    std::cout << "[LowLatencyLogger] Stats: batches=" << batches_received_.load()
+              << ", bytes_written=" << bytes_written_.load()
+              << ", dropped_by_senders=" << records_dropped_.load()
+              << ", invalid=" << invalid_messages_.load();
+    if (writer_) {
+        std::cout << ", write_errors=" << writer_->write_errors()
+                  << ", buffer_waits=" << writer_->buffer_waits()
+                  << ", rotations=" << writer_->rotations()
+                  << ", file=" << writer_->current_path();
     }
+    std::cout << std::endl;
 }
 
-} // namespace hft
\ No newline at end of file
+} // namespace hft
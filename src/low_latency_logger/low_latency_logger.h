@@ -2,21 +2,20 @@
 
 #include "../common/message_types.h"
 #include "../common/static_config.h"
+#include "../common/binary_log.h"
+#include "../common/metrics_publisher.h"
+#include "log_file_writer.h"
 #include <zmq.hpp>
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <fstream>
-
-#ifdef HAS_IO_URING
-#include <liburing.h>
-#endif
+#include <chrono>
+#include <string>
 
 namespace hft {
 
+// Collects binary log batches (see binary_log.h) from every service and
+// appends them unchanged to a .bin file; hft_log_decoder renders it as text.
 class LowLatencyLogger {
 public:
     LowLatencyLogger();
@@ -33,40 +32,28 @@ private:
     std::unique_ptr<zmq::context_t> context_;
     std::unique_ptr<zmq::socket_t> log_subscriber_;
     
-    // Threading
+    // Threading: one thread receives and appends; batches need no parsing
     std::atomic<bool> running_;
     std::unique_ptr<std::thread> receiver_thread_;
-    std::unique_ptr<std::thread> writer_thread_;
-    
-    // Message queue for async processing
-    std::queue<LogMessage> message_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
-    static constexpr size_t MAX_QUEUE_SIZE = 10000;
     
-    // File handling
-    std::unique_ptr<std::ofstream> log_file_;
-    std::string log_filename_;
+    // Double-buffered (io_uring or pwrite), flushed when idle and at least every second
+    std::unique_ptr<LogFileWriter> writer_;
+    MetricsPublisher metrics_publisher_;
     
     // Statistics
-    std::atomic<uint64_t> messages_received_;
-    std::atomic<uint64_t> messages_written_;
-    std::atomic<uint64_t> messages_dropped_;
+    std::atomic<uint64_t> batches_received_;
+    std::atomic<uint64_t> bytes_written_;
+    std::atomic<uint64_t> records_dropped_;     // Reported by senders (full rings)
+    std::atomic<uint64_t> invalid_messages_;
     
-    // io_uring specific (if available)
-#ifdef HAS_IO_URING
-    struct io_uring ring_;
-    bool io_uring_initialized_;
-#endif
+    // For the write throughput gauge
+    uint64_t last_metrics_bytes_ = 0;
+    std::chrono::steady_clock::time_point last_metrics_time_;
     
     void receive_messages();
-    void write_messages();
-    void write_log_message(const LogMessage& msg);
-    void init_io_uring();
-    void cleanup_io_uring();
+    void write_batch(const zmq::message_t& message);
+    void update_metrics();
     void log_statistics();
-    
-    std::string format_log_message(const LogMessage& msg);
 };
 
 } // namespace hft
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "low_latency_logger.h"
 #include "../common/static_config.h"
+#include "../common/cpu_topology.h"
 #include <iostream>
 #include <signal.h>
 #include <thread>
@@ -21,6 +22,7 @@ int main(int argc, char* argv[]) {
     
     std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
     StaticConfig::load_from_file(config_file.c_str());
+    ThreadPlan::instance().configure("low_latency_logger");
     
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
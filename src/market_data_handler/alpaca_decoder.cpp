@@ -0,0 +1,322 @@
+#include "alpaca_decoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace hft {
+
+namespace {
+
+constexpr int MAX_DEPTH = 32;               // Nesting skip_value will follow
+constexpr int MAX_WHOLE_DIGITS = 14;        // Keeps whole * PRICE_SCALE inside int64
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+// Forward-only reader over one frame
+class Cursor {
+public:
+    Cursor(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+    char peek() {
+        skip_whitespace();
+        return p_ < end_ ? *p_ : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        ++p_;
+        return true;
+    }
+
+    bool at_end() {
+        skip_whitespace();
+        return p_ == end_;
+    }
+
+    // The raw text between the quotes; escapes are left as they are, which is
+    // all the fields we keep (symbols, codes, timestamps) ever need
+    bool string(std::string_view& out) {
+        if (!consume('"')) return false;
+        const char* start = p_;
+        while (p_ < end_) {
+            const char* quote = static_cast<const char*>(std::memchr(p_, '"', end_ - p_));
+            if (!quote) return false;
+            p_ = quote + 1;
+            size_t backslashes = 0;
+            for (const char* c = quote; c > start && c[-1] == '\\'; --c) backslashes++;
+            if (backslashes % 2 == 0) {
+                out = std::string_view(start, quote - start);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A decimal price to fixed point, rounding past PRICE_DECIMALS half up
+    bool price(price_t& out) {
+        skip_whitespace();
+        const char* number = p_;
+        bool negative = p_ < end_ && *p_ == '-';
+        if (negative) ++p_;
+
+        const char* whole_start = p_;
+        int64_t whole = 0;
+        while (p_ < end_ && is_digit(*p_)) whole = whole * 10 + (*p_++ - '0');
+        if (p_ == whole_start || p_ - whole_start > MAX_WHOLE_DIGITS) return false;
+
+        int64_t fraction = 0;
+        int decimals = 0;
+        bool round_up = false;
+        if (p_ < end_ && *p_ == '.') {
+            const char* fraction_start = ++p_;
+            for (; p_ < end_ && is_digit(*p_); ++p_) {
+                if (decimals < PRICE_DECIMALS) {
+                    fraction = fraction * 10 + (*p_ - '0');
+                    decimals++;
+                } else if (p_ - fraction_start == PRICE_DECIMALS) {
+                    round_up = *p_ >= '5';
+                }
+            }
+            if (p_ == fraction_start) return false;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) return exponent(number, out);
+
+        for (; decimals < PRICE_DECIMALS; ++decimals) fraction *= 10;
+        price_t value = whole * PRICE_SCALE + fraction + (round_up ? 1 : 0);
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Sizes and volumes; a fractional part is dropped
+    bool count(uint64_t& out) {
+        skip_whitespace();
+        const char* start = p_;
+        uint64_t value = 0;
+        while (p_ < end_ && is_digit(*p_)) value = value * 10 + static_cast<uint64_t>(*p_++ - '0');
+        if (p_ == start) return false;
+        if (p_ < end_ && *p_ == '.') {
+            ++p_;
+            while (p_ < end_ && is_digit(*p_)) ++p_;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            double scientific = 0.0;
+            auto result = std::from_chars(start, end_, scientific);
+            if (result.ec != std::errc() || scientific < 0.0) return false;
+            p_ = result.ptr;
+            value = static_cast<uint64_t>(scientific);
+        }
+        out = value;
+        return true;
+    }
+
+    bool skip_value(int depth = 0) {
+        if (depth > MAX_DEPTH) return false;
+        std::string_view ignored;
+        switch (peek()) {
+            case '"':
+                return string(ignored);
+            case '{':
+                ++p_;
+                if (consume('}')) return true;
+                do {
+                    if (!string(ignored) || !consume(':') || !skip_value(depth + 1)) return false;
+                } while (consume(','));
+                return consume('}');
+            case '[':
+                ++p_;
+                if (consume(']')) return true;
+                do {
+                    if (!skip_value(depth + 1)) return false;
+                } while (consume(','));
+                return consume(']');
+            case 't':
+                return literal("true");
+            case 'f':
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default: {
+                const char* start = p_;
+                while (p_ < end_ && (is_digit(*p_) || *p_ == '-' || *p_ == '+' || *p_ == '.' ||
+                                     *p_ == 'e' || *p_ == 'E')) {
+                    ++p_;
+                }
+                return p_ != start;
+            }
+        }
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+
+    void skip_whitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool literal(std::string_view word) {
+        if (static_cast<size_t>(end_ - p_) < word.size() || std::memcmp(p_, word.data(), word.size()) != 0) {
+            return false;
+        }
+        p_ += word.size();
+        return true;
+    }
+
+    // Scientific notation never shows up in practice; take the slow road
+    bool exponent(const char* number, price_t& out) {
+        double value = 0.0;
+        auto result = std::from_chars(number, end_, value);
+        if (result.ec != std::errc()) return false;
+        p_ = result.ptr;
+        out = to_fixed_price(value);
+        return true;
+    }
+};
+
+// One {...} message; keep is false for messages that carry nothing to emit
+bool decode_message(Cursor& cursor, AlpacaRecord& record, bool& keep, uint64_t& skipped) {
+    record = AlpacaRecord{};
+    keep = false;
+    std::string_view type;
+    std::string_view symbol;
+    uint64_t size = 0;
+
+    if (!cursor.consume('{')) return false;
+    if (cursor.consume('}')) return true;
+    do {
+        std::string_view key;
+        if (!cursor.string(key) || !cursor.consume(':')) return false;
+
+        bool ok;
+        uint64_t value = 0;
+        if (key.size() == 1) {
+            switch (key[0]) {
+                case 'T': ok = cursor.string(type); break;
+                case 'S': ok = cursor.string(symbol); break;
+                case 'p': ok = cursor.price(record.price); break;
+                // A bar's close; quotes and trades use "c" for their conditions
+                case 'c': ok = cursor.peek() == '[' ? cursor.skip_value() : cursor.price(record.price); break;
+                case 's':
+                case 'v': ok = cursor.count(size); break;
+                case 't': {
+                    std::string_view timestamp;
+                    ok = cursor.string(timestamp);
+                    record.timestamp_ns = parse_alpaca_timestamp(timestamp);
+                    break;
+                }
+                default: ok = cursor.skip_value(); break;
+            }
+        } else if (key == "bp") {
+            ok = cursor.price(record.bid_price);
+        } else if (key == "ap") {
+            ok = cursor.price(record.ask_price);
+        } else if (key == "bs") {
+            ok = cursor.count(value);
+            record.bid_size = static_cast<uint32_t>(std::min<uint64_t>(value, UINT32_MAX));
+        } else if (key == "as") {
+            ok = cursor.count(value);
+            record.ask_size = static_cast<uint32_t>(std::min<uint64_t>(value, UINT32_MAX));
+        } else if (key == "msg") {
+            ok = cursor.string(record.text);
+        } else {
+            ok = cursor.skip_value();
+        }
+        if (!ok) return false;
+    } while (cursor.consume(','));
+    if (!cursor.consume('}')) return false;
+
+    if (type == "q") {
+        record.type = AlpacaRecordType::QUOTE;
+    } else if (type == "t") {
+        record.type = AlpacaRecordType::TRADE;
+    } else if (type == "b" || type == "d" || type == "u") {
+        record.type = AlpacaRecordType::BAR;
+    } else {
+        record.type = AlpacaRecordType::STATUS;
+        record.kind = type;
+        keep = true;
+        return true;
+    }
+
+    if (symbol.empty() || symbol.size() >= sizeof(record.symbol)) {
+        skipped++;
+        return true;
+    }
+    std::memcpy(record.symbol, symbol.data(), symbol.size());
+    record.symbol_length = static_cast<uint8_t>(symbol.size());
+    record.size = static_cast<uint32_t>(std::min<uint64_t>(size, UINT32_MAX));
+    keep = true;
+    return true;
+}
+
+} // namespace
+
+bool AlpacaDecoder::decode(const char* data, size_t size, std::vector<AlpacaRecord>& batch) {
+    Cursor cursor(data, data + size);
+    AlpacaRecord record;
+    bool keep = false;
+
+    if (!cursor.consume('[')) {
+        if (!decode_message(cursor, record, keep, skipped_)) return false;
+        if (keep) batch.push_back(record);
+        return cursor.at_end();
+    }
+    if (cursor.consume(']')) return cursor.at_end();
+    do {
+        if (!decode_message(cursor, record, keep, skipped_)) return false;
+        if (keep) batch.push_back(record);
+    } while (cursor.consume(','));
+    return cursor.consume(']') && cursor.at_end();
+}
+
+uint64_t parse_alpaca_timestamp(std::string_view text) {
+    if (text.size() < 20 || text[4] != '-' || text[7] != '-' || text[10] != 'T' ||
+        text[13] != ':' || text[16] != ':' || text.back() != 'Z') {
+        return 0;
+    }
+    auto field = [&](size_t pos, size_t digits, unsigned& out) {
+        out = 0;
+        for (size_t i = pos; i < pos + digits; ++i) {
+            if (!is_digit(text[i])) return false;
+            out = out * 10 + static_cast<unsigned>(text[i] - '0');
+        }
+        return true;
+    };
+    unsigned year, month, day, hour, minute, second;
+    if (!field(0, 4, year) || !field(5, 2, month) || !field(8, 2, day) ||
+        !field(11, 2, hour) || !field(14, 2, minute) || !field(17, 2, second) ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+
+    uint64_t nanos = 0;
+    size_t pos = 19;
+    if (text[pos] == '.') {
+        int digits = 0;
+        for (++pos; pos < text.size() && is_digit(text[pos]); ++pos) {
+            if (digits < 9) {
+                nanos = nanos * 10 + static_cast<uint64_t>(text[pos] - '0');
+                digits++;
+            }
+        }
+        for (; digits < 9; ++digits) nanos *= 10;
+    }
+    if (pos != text.size() - 1) return 0;
+
+    int64_t days = days_from_civil(year, month, day);
+    if (days < 0) return 0;
+    uint64_t seconds = static_cast<uint64_t>(days) * 86400 + hour * 3600 + minute * 60 + second;
+    return seconds * 1'000'000'000ULL + nanos;
+}
+
+} // namespace hft
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../common/fixed_price.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace hft {
+
+enum class AlpacaRecordType : uint8_t {
+    QUOTE,      // "q"
+    TRADE,      // "t"
+    BAR,        // "b", and the daily ("d") and updated ("u") bars
+    STATUS      // "success", "error", "subscription" and anything else
+};
+
+// One message of an Alpaca stream frame, decoded in place. Prices go
+// straight from the decimal text to fixed point; no double in between.
+struct AlpacaRecord {
+    AlpacaRecordType type;
+    uint8_t symbol_length;
+    char symbol[16];                // NUL-terminated; empty for STATUS
+    price_t bid_price;              // Quotes
+    price_t ask_price;
+    uint32_t bid_size;
+    uint32_t ask_size;
+    price_t price;                  // Trade price, or a bar's close
+    uint32_t size;                  // Trade size, or a bar's volume
+    uint64_t timestamp_ns;          // "t", Unix nanoseconds; 0 if absent
+    std::string_view kind;          // STATUS: the "T" text, pointing into the frame
+    std::string_view text;          // STATUS: the "msg" text, pointing into the frame
+};
+
+// Hand-written decoder for the message shapes of Alpaca's v2 stock stream.
+// It walks the frame once, keeps only the members the feed uses and skips
+// the rest (conditions arrays, exchange codes, bar OHLC) without building a
+// DOM or allocating: the batch's capacity is reused from frame to frame.
+class AlpacaDecoder {
+public:
+    // Appends the records of one frame (an array of messages, or a single
+    // message) to batch. Returns false if the frame is not JSON of that
+    // shape; records decoded before the fault are kept. Messages with a
+    // symbol too long for AlpacaRecord::symbol are skipped and counted.
+    bool decode(const char* data, size_t size, std::vector<AlpacaRecord>& batch);
+
+    uint64_t skipped() const { return skipped_; }
+
+private:
+    uint64_t skipped_ = 0;
+};
+
+// RFC 3339 UTC ("2021-02-22T15:51:44.208234521Z") to Unix nanoseconds;
+// 0 if text is not in that form
+uint64_t parse_alpaca_timestamp(std::string_view text);
+
+} // namespace hft
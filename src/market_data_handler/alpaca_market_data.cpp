@@ -1,6 +1,7 @@
 #include "alpaca_market_data.h"
 #include "../common/static_config.h"
 #include "../common/hft_metrics.h"
+#include "../common/cpu_topology.h"
 #include <nlohmann/json.hpp>
 #include <chrono>
 #include <sstream>
@@ -20,6 +21,7 @@ AlpacaMarketData::AlpacaMarketData()
     
     logger_.info("AlpacaMarketData client initialized with Boost.Beast");
     metrics_.reset();
+    batch_.reserve(1024);
     
     // Initialize curl for any HTTP requests if needed
     curl_global_init(CURL_GLOBAL_DEFAULT);
@@ -64,6 +66,11 @@ bool AlpacaMarketData::connect() {
     
     logger_.info("Connecting to Alpaca market data WebSocket...");
     
+    // A thread that ended on a read error is still waiting to be joined
+    if (ws_thread_ && ws_thread_->joinable()) {
+        ws_thread_->join();
+    }
+    
     try {
         // Initialize io_context and SSL context
         ioc_ = std::make_unique<net::io_context>();
@@ -113,19 +120,18 @@ bool AlpacaMarketData::connect() {
 }
 
 void AlpacaMarketData::disconnect() {
-    if (!connected_.load()) return;
-    
-    logger_.info("Disconnecting from Alpaca WebSocket");
-    
-    connected_ = false;
-    close_websocket_connection();
+    if (connected_.load()) {
+        logger_.info("Disconnecting from Alpaca WebSocket");
+        connected_ = false;
+        close_websocket_connection();
+    }
     
+    // Joined even after the connection dropped by itself, so it can be reopened
     if (ws_thread_ && ws_thread_->joinable()) {
         ws_thread_->join();
+        logger_.info("Disconnected from Alpaca WebSocket");
+        log_status();
     }
-    
-    logger_.info("Disconnected from Alpaca WebSocket");
-    log_status();
 }
 
 bool AlpacaMarketData::subscribe(const std::vector<std::string>& symbols) {
@@ -234,9 +240,9 @@ bool AlpacaMarketData::establish_websocket_connection() {
         // Make the connection on the IP address we get from a lookup
         auto ep = beast::get_lowest_layer(*ws_).connect(results);
         
-        // Update the host string. This will provide the value of the
-        // Host HTTP header during the WebSocket handshake.
-        host_ += ":" + std::to_string(ep.port());
+        // The Host header of the WebSocket handshake carries the port; host_
+        // itself stays bare for the next reconnect
+        std::string handshake_host = host_ + ":" + std::to_string(ep.port());
         
         // Perform the SSL handshake
         ws_->next_layer().handshake(ssl::stream_base::client);
@@ -248,7 +254,7 @@ bool AlpacaMarketData::establish_websocket_connection() {
             }));
         
         // Perform the websocket handshake
-        ws_->handshake(host_, path_);
+        ws_->handshake(handshake_host, path_);
         
         logger_.info("WebSocket connection established successfully");
         connected_ = true;
@@ -263,30 +269,25 @@ bool AlpacaMarketData::establish_websocket_connection() {
 }
 
 void AlpacaMarketData::websocket_thread_func() {
+    if (!thread_name_.empty() && !ThreadPlan::instance().pin_current_thread(thread_name_)) {
+        logger_.warning("Failed to pin " + thread_name_ + " to its planned CPU");
+    }
     logger_.info("WebSocket thread started");
     logger_.info("Initial state - connected: " + std::string(connected_.load() ? "true" : "false") + ", running: " + std::string(running_.load() ? "true" : "false"));
     
     while (connected_.load() && running_.load()) {
         try {
-            logger_.debug("About to read WebSocket message...");
-            
             // Read a message into our buffer
             buffer_.clear();
             ws_->read(buffer_);
             
-            logger_.debug("Successfully read WebSocket message");
-            
-            // Convert to string
-            std::string message = beast::buffers_to_string(buffer_.data());
-            
-            metrics_.bytes_received += message.size();
+            // Decode in place: a flat_buffer is one contiguous block
+            auto frame = buffer_.cdata();
+            metrics_.bytes_received += frame.size();
             metrics_.messages_received++;
             metrics_.last_message_time = std::chrono::steady_clock::now();
             
-            logger_.debug("Received WebSocket message (" + std::to_string(message.size()) + " bytes): " + message.substr(0, 500));
-            
-            // Process the message
-            process_message(message);
+            process_message(static_cast<const char*>(frame.data()), frame.size());
             
         } catch (beast::system_error const& se) {
             logger_.error("Beast system error in WebSocket thread: " + se.code().message());
@@ -350,166 +351,86 @@ void AlpacaMarketData::close_websocket_connection() {
     connected_ = false;
 }
 
-// Message Processing - Handle Alpaca's array format
-void AlpacaMarketData::process_message(const std::string& message) {
-    logger_.debug("Processing message: " + message);
-    
-    try {
-        auto json = nlohmann::json::parse(message);
-        
-        // Alpaca sends messages as arrays: [{"T": "t", "S": "AAPL", ...}, ...]
-        if (json.is_array()) {
-            for (const auto& msg : json) {
-                process_single_message(msg);
-            }
-        }
-        // Handle single message objects (auth responses, etc.)
-        else if (json.is_object()) {
-            process_single_message(json);
-        } else {
-            logger_.warning("Message is neither array nor object: " + message);
+// Message Processing - a frame is an array of messages: [{"T": "q", "S": "AAPL", ...}, ...]
+void AlpacaMarketData::process_message(const char* data, size_t size) {
+    batch_.clear();
+    bool decoded = decoder_.decode(data, size, batch_);
+    
+    // Records before a fault are good; deliver them either way
+    for (const AlpacaRecord& record : batch_) {
+        switch (record.type) {
+            case AlpacaRecordType::QUOTE: handle_quote(record); break;
+            case AlpacaRecordType::TRADE: handle_trade(record); break;
+            case AlpacaRecordType::BAR: handle_bar(record); break;
+            case AlpacaRecordType::STATUS: handle_status(record); break;
         }
-        
-        metrics_.messages_processed++;
-        
-    } catch (const std::exception& e) {
-        logger_.error("Failed to parse JSON message: " + std::string(e.what()));
-        logger_.error("Raw message content: " + message);
-        metrics_.parse_errors++;
     }
-}
-
-void AlpacaMarketData::process_single_message(const nlohmann::json& msg) {
-    if (msg.contains("T")) {
-        std::string msg_type = msg["T"];
-        logger_.debug("Processing message type: " + msg_type);
-        
-        std::string msg_str = msg.dump();
-        
-        if (msg_type == "q") {
-            handle_quote_message(msg_str);
-        } else if (msg_type == "t") {
-            handle_trade_message(msg_str);
-        } else if (msg_type == "b" || msg_type == "d" || msg_type == "u") {
-            handle_bar_message(msg_str);
-        } else {
-            logger_.info("Ignoring message type: " + msg_type + ", full message: " + msg_str);
-        }
-    } else if (msg.contains("msg")) {
-        // Handle status/error messages
-        std::string status_msg = msg["msg"];
-        logger_.info("Received status message: " + status_msg);
-        
-        if (status_msg == "connected") {
-            logger_.info("Alpaca reports connection successful");
-        } else if (status_msg == "authenticated") {
-            logger_.info("Alpaca authentication confirmed - ready to subscribe");
-        } else {
-            logger_.warning("Alpaca status: " + status_msg);
-        }
-    } else {
-        logger_.info("Message without 'T' or 'msg' field: " + msg.dump());
+    if (frame_end_callback_ && !batch_.empty()) {
+        frame_end_callback_();
+    }
+    
+    if (!decoded) {
+        logger_.error("Failed to parse JSON message: " + std::string(data, std::min<size_t>(size, 500)));
+        metrics_.parse_errors++;
+        return;
     }
+    metrics_.messages_processed++;
 }
 
-bool AlpacaMarketData::handle_quote_message(const std::string& message) {
-    try {
-        auto json = nlohmann::json::parse(message);
-        
-        std::string symbol = json.value("S", "");
-        double bid = json.value("bp", 0.0);
-        double ask = json.value("ap", 0.0);
-        uint32_t bid_size = json.value("bs", 0u);
-        uint32_t ask_size = json.value("as", 0u);
-        
-        if (symbol.empty() || bid <= 0.0 || ask <= 0.0) {
-            return false;
-        }
-        
-        metrics_.quotes_processed++;
-        
-        // Update last quotes for trade processing
-        last_quotes_[symbol] = (bid + ask) / 2.0;
-        
-        // Convert to internal format and call callback
-        if (data_callback_) {
-            MarketData market_data = convert_alpaca_quote_to_market_data(symbol, bid, ask, bid_size, ask_size);
-            data_callback_(market_data);
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        logger_.debug("Error parsing quote: " + std::string(e.what()));
+bool AlpacaMarketData::handle_quote(const AlpacaRecord& record) {
+    if (record.bid_price <= 0 || record.ask_price <= 0) {
         return false;
     }
+    
+    metrics_.quotes_processed++;
+    
+    if (data_callback_) {
+        data_callback_(convert_alpaca_quote_to_market_data(record));
+    }
+    return true;
 }
 
-bool AlpacaMarketData::handle_trade_message(const std::string& message) {
-    try {
-        auto json = nlohmann::json::parse(message);
-        
-        std::string symbol = json.value("S", "");
-        double price = json.value("p", 0.0);
-        uint32_t size = json.value("s", 0u);
-        
-        if (symbol.empty() || price <= 0.0 || size == 0) {
-            return false;
-        }
-        
-        metrics_.trades_processed++;
-        
-        // Convert to internal format and call callback
-        if (data_callback_) {
-            MarketData market_data = convert_alpaca_trade_to_market_data(symbol, price, size);
-            data_callback_(market_data);
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        logger_.debug("Error parsing trade: " + std::string(e.what()));
+bool AlpacaMarketData::handle_trade(const AlpacaRecord& record) {
+    if (record.price <= 0 || record.size == 0) {
         return false;
     }
+    
+    metrics_.trades_processed++;
+    
+    if (data_callback_) {
+        data_callback_(convert_alpaca_trade_to_market_data(record));
+    }
+    return true;
 }
 
-bool AlpacaMarketData::handle_bar_message(const std::string& message) {
-    try {
-        auto json = nlohmann::json::parse(message);
-        
-        std::string symbol = json.value("S", "");
-        double close = json.value("c", 0.0);
-        uint32_t volume = json.value("v", 0u);
-        
-        if (symbol.empty() || close <= 0.0) {
-            return false;
-        }
-        
-        metrics_.bars_processed++;
-        
-        // For bars, create a market data message using close price as last trade
-        if (data_callback_) {
-            MarketData market_data = convert_alpaca_trade_to_market_data(symbol, close, volume);
-            data_callback_(market_data);
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        logger_.debug("Error parsing bar: " + std::string(e.what()));
+bool AlpacaMarketData::handle_bar(const AlpacaRecord& record) {
+    if (record.price <= 0) {
         return false;
     }
+    
+    metrics_.bars_processed++;
+    
+    // For bars, create a market data message using close price as last trade
+    if (data_callback_) {
+        data_callback_(convert_alpaca_trade_to_market_data(record));
+    }
+    return true;
 }
 
-bool AlpacaMarketData::handle_error_message(const std::string& message) {
-    try {
-        auto json = nlohmann::json::parse(message);
-        std::string error = json.value("msg", "Unknown error");
-        logger_.error("Alpaca API error: " + error);
-        return true;
-    } catch (const std::exception& e) {
-        logger_.warning("Error parsing error message: " + std::string(e.what()));
-        return false;
+void AlpacaMarketData::handle_status(const AlpacaRecord& record) {
+    std::string kind(record.kind);
+    std::string status(record.text);
+    
+    if (kind == "error") {
+        logger_.error("Alpaca API error: " + status);
+    } else if (status == "connected") {
+        logger_.info("Alpaca reports connection successful");
+    } else if (status == "authenticated") {
+        logger_.info("Alpaca authentication confirmed - ready to subscribe");
+    } else if (kind == "subscription") {
+        logger_.info("Alpaca subscription updated");
+    } else {
+        logger_.info("Ignoring message type: " + kind + (status.empty() ? "" : ", msg: " + status));
     }
 }
 
@@ -531,66 +452,28 @@ std::string AlpacaMarketData::create_subscription_message(const std::vector<std:
     return sub.dump();
 }
 
-MarketData AlpacaMarketData::convert_alpaca_quote_to_market_data(const std::string& symbol, double bid, double ask, uint32_t bid_size, uint32_t ask_size) {
-    // Use last trade price if available, otherwise use mid-price
-    double last_price = (last_quotes_.count(symbol)) ? last_quotes_[symbol] : (bid + ask) / 2.0;
+MarketData AlpacaMarketData::convert_alpaca_quote_to_market_data(const AlpacaRecord& record) {
+    // Quotes carry no trade; last is the mid
+    price_t mid = (record.bid_price + record.ask_price) / 2;
     uint32_t last_size = 100; // Default size for quotes
     
-    return MessageFactory::create_market_data(symbol, bid, ask, bid_size, ask_size, last_price, last_size);
+    MarketData data = MessageFactory::create_market_data_fixed(record.symbol, record.bid_price, record.ask_price,
+                                                               record.bid_size, record.ask_size, mid, last_size);
+    if (record.timestamp_ns != 0) data.exchange_timestamp = record.timestamp_ns;
+    data.trace.stamp(TraceStage::FEED_PARSE);
+    return data;
 }
 
-MarketData AlpacaMarketData::convert_alpaca_trade_to_market_data(const std::string& symbol, double price, uint32_t size) {
+MarketData AlpacaMarketData::convert_alpaca_trade_to_market_data(const AlpacaRecord& record) {
     // For trades, use the trade price/size as last, and create synthetic bid/ask
-    double spread = price * 0.001; // 0.1% spread assumption
-    double bid = price - spread / 2.0;
-    double ask = price + spread / 2.0;
-    
-    return MessageFactory::create_market_data(symbol, bid, ask, size, size, price, size);
-}
-
-// Fast JSON parsing helpers (optimized for performance)
-std::string AlpacaMarketData::extract_json_string(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":\"";
-    size_t start = json.find(search);
-    if (start == std::string::npos) return "";
-    
-    start += search.length();
-    size_t end = json.find("\"", start);
-    if (end == std::string::npos) return "";
-    
-    return json.substr(start, end - start);
-}
-
-double AlpacaMarketData::extract_json_double(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
-    size_t start = json.find(search);
-    if (start == std::string::npos) return 0.0;
-    
-    start += search.length();
-    size_t end = json.find_first_of(",}", start);
-    if (end == std::string::npos) return 0.0;
-    
-    try {
-        return std::stod(json.substr(start, end - start));
-    } catch (...) {
-        return 0.0;
-    }
-}
-
-uint32_t AlpacaMarketData::extract_json_uint(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
-    size_t start = json.find(search);
-    if (start == std::string::npos) return 0;
-    
-    start += search.length();
-    size_t end = json.find_first_of(",}", start);
-    if (end == std::string::npos) return 0;
-    
-    try {
-        return static_cast<uint32_t>(std::stoul(json.substr(start, end - start)));
-    } catch (...) {
-        return 0;
-    }
+    price_t half_spread = record.price / 2000; // 0.1% spread assumption
+    
+    MarketData data = MessageFactory::create_market_data_fixed(record.symbol, record.price - half_spread,
+                                                               record.price + half_spread, record.size,
+                                                               record.size, record.price, record.size);
+    if (record.timestamp_ns != 0) data.exchange_timestamp = record.timestamp_ns;
+    data.trace.stamp(TraceStage::FEED_PARSE);
+    return data;
 }
 
 // Metrics helpers
@@ -3,13 +3,13 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "../common/hft_metrics.h"
+#include "alpaca_decoder.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <thread>
 #include <atomic>
-#include <unordered_map>
 #include <chrono>
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -88,6 +88,12 @@ public:
     // Set callback for market data
     void set_data_callback(std::function<void(const MarketData&)> callback);
     
+    // Called once a frame's quotes have all gone to the data callback
+    void set_frame_end_callback(std::function<void()> callback) { frame_end_callback_ = std::move(callback); }
+    
+    // ThreadPlan name the websocket thread pins itself to; set before connect()
+    void set_thread_name(const std::string& name) { thread_name_ = name; }
+    
     // Start/stop processing
     void start();
     void stop();
@@ -113,8 +119,10 @@ private:
     std::atomic<bool> connected_{false};
     std::atomic<bool> running_{false};
     
-    // Callback
+    // Callbacks
     std::function<void(const MarketData&)> data_callback_;
+    std::function<void()> frame_end_callback_;
+    std::string thread_name_;
     
     // Boost.Beast WebSocket connection
     std::unique_ptr<boost::asio::io_context> ioc_;
@@ -130,8 +138,9 @@ private:
     mutable AlpacaMetrics metrics_;
     mutable Logger logger_;
     
-    // Message parsing state
-    std::unordered_map<std::string, double> last_quotes_;
+    // Frames decode from buffer_ into batch_, whose capacity is kept
+    AlpacaDecoder decoder_;
+    std::vector<AlpacaRecord> batch_;
     
     // Boost.Beast WebSocket connection methods
     bool establish_websocket_connection();
@@ -139,25 +148,18 @@ private:
     bool send_message(const std::string& message);
     void close_websocket_connection();
     
-    // Message processing - simplified and fast
-    void process_message(const std::string& message);
-    void process_single_message(const nlohmann::json& msg);
-    bool handle_quote_message(const std::string& message);
-    bool handle_trade_message(const std::string& message);
-    bool handle_bar_message(const std::string& message);
-    bool handle_error_message(const std::string& message);
+    // Message processing
+    void process_message(const char* data, size_t size);
+    bool handle_quote(const AlpacaRecord& record);
+    bool handle_trade(const AlpacaRecord& record);
+    bool handle_bar(const AlpacaRecord& record);
+    void handle_status(const AlpacaRecord& record);
     
     // Utilities
     std::string create_auth_message();
     std::string create_subscription_message(const std::vector<std::string>& symbols);
-    MarketData convert_alpaca_quote_to_market_data(const std::string& symbol, double bid, double ask, 
-                                                   uint32_t bid_size, uint32_t ask_size);
-    MarketData convert_alpaca_trade_to_market_data(const std::string& symbol, double price, uint32_t size);
-    
-    // Fast JSON parsing helpers
-    std::string extract_json_string(const std::string& json, const std::string& key);
-    double extract_json_double(const std::string& json, const std::string& key);
-    uint32_t extract_json_uint(const std::string& json, const std::string& key);
+    MarketData convert_alpaca_quote_to_market_data(const AlpacaRecord& record);
+    MarketData convert_alpaca_trade_to_market_data(const AlpacaRecord& record);
     
     // Metrics helpers
     void record_latency(std::chrono::steady_clock::time_point start_time);
@@ -0,0 +1,175 @@
+#include "alpaca_stream_set.h"
+#include "../common/static_config.h"
+#include <algorithm>
+
+namespace hft {
+
+namespace {
+
+// A connection with nothing to say for this long is reopened
+constexpr auto STALE_AFTER = std::chrono::minutes(1);
+constexpr auto SUPERVISOR_INTERVAL = std::chrono::milliseconds(100);
+
+} // namespace
+
+AlpacaStreamSet::AlpacaStreamSet()
+    : logger_("AlpacaStreamSet", StaticConfig::get_logger_endpoint()) {
+}
+
+AlpacaStreamSet::~AlpacaStreamSet() {
+    stop();
+}
+
+bool AlpacaStreamSet::initialize(const std::string& api_key, const std::string& api_secret,
+                                 const std::string& websocket_url, const std::string& host, bool paper_trading,
+                                 const std::vector<std::string>& symbols, size_t connections,
+                                 uint64_t merge_window_ns) {
+    if (symbols.empty()) {
+        logger_.error("No symbols to subscribe to");
+        return false;
+    }
+    connections = std::clamp<size_t>(connections, 1, symbols.size());
+
+    merger_ = std::make_unique<FeedMerger>(connections, merge_window_ns);
+    connections_.clear();
+    for (size_t i = 0; i < connections; ++i) {
+        auto connection = std::make_unique<Connection>();
+        connection->index = i;
+        connection->client = std::make_unique<AlpacaMarketData>();
+        if (!connection->client->initialize(api_key, api_secret, websocket_url, host, paper_trading)) {
+            logger_.error("Failed to initialize Alpaca connection " + std::to_string(i));
+            return false;
+        }
+        connection->client->set_thread_name("alpaca_md." + std::to_string(i));
+
+        // The connection's websocket thread is the channel's only producer;
+        // a frame's quotes become visible to the merger together
+        FeedMerger::Channel& channel = merger_->channel(i);
+        connection->client->set_data_callback([this, &channel](const MarketData& data) {
+            if (!channel.try_stage(data)) {
+                dropped_++;
+            }
+        });
+        connection->client->set_frame_end_callback([&channel]() { channel.publish(); });
+        connections_.push_back(std::move(connection));
+    }
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        connections_[i % connections]->symbols.push_back(symbols[i]);
+    }
+
+    logger_.info("Sharding " + std::to_string(symbols.size()) + " symbols over " +
+                 std::to_string(connections) + " Alpaca connections, merge window " +
+                 std::to_string(merge_window_ns / 1000) + "us");
+    return true;
+}
+
+void AlpacaStreamSet::start() {
+    if (running_.load() || connections_.empty()) {
+        return;
+    }
+    running_ = true;
+    supervisor_thread_ = std::make_unique<std::thread>(&AlpacaStreamSet::supervise, this);
+}
+
+void AlpacaStreamSet::stop() {
+    if (!running_.load()) {
+        return;
+    }
+    running_ = false;
+    if (supervisor_thread_ && supervisor_thread_->joinable()) {
+        supervisor_thread_->join();
+    }
+    for (auto& connection : connections_) {
+        close(*connection);
+    }
+}
+
+size_t AlpacaStreamSet::live_connections() const {
+    size_t live = 0;
+    for (size_t i = 0; i < connections_.size(); ++i) {
+        if (merger_->is_live(i)) live++;
+    }
+    return live;
+}
+
+void AlpacaStreamSet::log_status() const {
+    logger_.info("Alpaca connections live: " + std::to_string(live_connections()) + "/" +
+                 std::to_string(connections_.size()) + ", reconnects: " + std::to_string(reconnects_.load()) +
+                 ", dropped: " + std::to_string(dropped_.load()) + ", merged late: " + std::to_string(late()));
+    for (const auto& connection : connections_) {
+        connection->client->log_status();
+    }
+}
+
+void AlpacaStreamSet::supervise() {
+    logger_.info("Alpaca supervisor started");
+    while (running_.load()) {
+        for (auto& connection : connections_) {
+            if (!running_.load()) break;
+            maintain(*connection, std::chrono::steady_clock::now());
+        }
+        std::this_thread::sleep_for(SUPERVISOR_INTERVAL);
+    }
+    logger_.info("Alpaca supervisor stopped");
+}
+
+void AlpacaStreamSet::maintain(Connection& connection, std::chrono::steady_clock::time_point now) {
+    AlpacaMarketData& client = *connection.client;
+    if (connection.subscribed) {
+        bool dropped = !client.is_connected();
+        bool stale = now - connection.connected_at > STALE_AFTER && !client.is_healthy();
+        if (!dropped && !stale) {
+            return;
+        }
+        logger_.warning("Alpaca connection " + std::to_string(connection.index) +
+                        (dropped ? " dropped" : " went quiet") + ", reopening it for its " +
+                        std::to_string(connection.symbols.size()) + " symbols");
+        close(connection);
+        reconnects_++;
+        connection.next_attempt = now;
+    }
+
+    if (now < connection.next_attempt) {
+        return;
+    }
+    if (open(connection)) {
+        connection.failures = 0;
+        return;
+    }
+    close(connection);
+    connection.failures++;
+    connection.next_attempt = std::chrono::steady_clock::now() + backoff(connection.failures);
+    logger_.error("Alpaca connection " + std::to_string(connection.index) + " failed to open (attempt " +
+                  std::to_string(connection.failures) + "), retrying in " +
+                  std::to_string(backoff(connection.failures).count()) + "s");
+}
+
+bool AlpacaStreamSet::open(Connection& connection) {
+    AlpacaMarketData& client = *connection.client;
+    client.start();
+    if (!client.connect() || !client.subscribe(connection.symbols)) {
+        return false;
+    }
+    connection.subscribed = true;
+    connection.connected_at = std::chrono::steady_clock::now();
+    merger_->set_live(connection.index, true);
+    logger_.info("Alpaca connection " + std::to_string(connection.index) + " subscribed to " +
+                 std::to_string(connection.symbols.size()) + " symbols");
+    return true;
+}
+
+void AlpacaStreamSet::close(Connection& connection) {
+    // Stop waiting for it first, so the merger doesn't hold the others back
+    merger_->set_live(connection.index, false);
+    connection.subscribed = false;
+    connection.client->stop();
+}
+
+std::chrono::seconds AlpacaStreamSet::backoff(int failures) const {
+    // 1s, 2s, 4s... up to the configured reconnect interval
+    int interval = std::max(1, StaticConfig::get_alpaca_reconnect_interval_seconds());
+    int shift = std::min(failures - 1, 16);
+    return std::chrono::seconds(std::min(interval, 1 << std::max(shift, 0)));
+}
+
+} // namespace hft
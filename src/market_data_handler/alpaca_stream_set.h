@@ -0,0 +1,85 @@
+#pragma once
+
+#include "alpaca_market_data.h"
+#include "feed_merger.h"
+#include "../common/logging.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hft {
+
+// The Alpaca symbol universe spread over several websocket connections. Each
+// connection reads and decodes on its own thread (alpaca_md.<n> in the thread
+// plan) and hands its quotes to a FeedMerger, which the caller drains in
+// exchange timestamp order. A supervisor thread opens the connections and
+// reopens any that drop or go quiet, one at a time: the others keep
+// delivering while it does.
+class AlpacaStreamSet {
+public:
+    AlpacaStreamSet();
+    ~AlpacaStreamSet();
+
+    // Deals symbols round-robin over `connections` connections (at most one
+    // per symbol). merge_window_ns bounds how long a quote waits for the
+    // other connections before it is merged regardless.
+    bool initialize(const std::string& api_key, const std::string& api_secret,
+                    const std::string& websocket_url, const std::string& host, bool paper_trading,
+                    const std::vector<std::string>& symbols, size_t connections, uint64_t merge_window_ns);
+
+    // Starts the supervisor, which connects every connection in turn
+    void start();
+    void stop();
+
+    // Hands merged quotes to emit(const MarketData&); one consumer thread
+    template<typename Fn>
+    size_t poll(Fn&& emit) {
+        return merger_->poll(now_ns(), std::forward<Fn>(emit));
+    }
+
+    size_t connection_count() const { return connections_.size(); }
+    size_t live_connections() const;
+    uint64_t reconnects() const { return reconnects_.load(); }
+    uint64_t dropped() const { return dropped_.load(); }
+    uint64_t late() const { return merger_->late(); }
+
+    void log_status() const;
+
+private:
+    struct Connection {
+        size_t index = 0;
+        std::vector<std::string> symbols;
+        std::unique_ptr<AlpacaMarketData> client;
+        // Supervisor thread only
+        bool subscribed = false;
+        int failures = 0;
+        std::chrono::steady_clock::time_point connected_at;
+        std::chrono::steady_clock::time_point next_attempt;
+    };
+
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::unique_ptr<FeedMerger> merger_;
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> supervisor_thread_;
+    std::atomic<uint64_t> reconnects_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    mutable Logger logger_;
+
+    void supervise();
+    void maintain(Connection& connection, std::chrono::steady_clock::time_point now);
+    bool open(Connection& connection);
+    void close(Connection& connection);
+    std::chrono::seconds backoff(int failures) const;
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+} // namespace hft
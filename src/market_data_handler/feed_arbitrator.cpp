@@ -0,0 +1,206 @@
+#include "feed_arbitrator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace hft {
+
+namespace {
+
+constexpr size_t SESSION_SIZE = 10;
+constexpr uint16_t END_OF_SESSION = 0xFFFF;
+
+uint16_t read_be16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint64_t read_be64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value = (value << 8) | p[i];
+    return value;
+}
+
+void write_be16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+void write_be64(uint8_t* p, uint64_t value) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+} // namespace
+
+FeedArbitrator::FeedArbitrator(size_t hold_slots, uint64_t gap_timeout_ns)
+    : held_(std::max<size_t>(1, hold_slots))
+    , gap_timeout_ns_(gap_timeout_ns) {}
+
+bool FeedArbitrator::on_packet(uint8_t line, const uint8_t* packet, size_t len, uint64_t timestamp_ns,
+                               uint64_t now_ns) {
+    if (line >= MAX_LINES || len < HEADER_SIZE || len > MAX_PACKET_SIZE) {
+        malformed_packets_++;
+        return false;
+    }
+
+    uint64_t sequence = read_be64(packet + SESSION_SIZE);
+    uint16_t raw_count = read_be16(packet + SESSION_SIZE + 8);
+    uint32_t count = raw_count == END_OF_SESSION ? 0 : raw_count;
+
+    // A new session restarts sequencing
+    if (!synced_ || std::memcmp(session_.data(), packet, SESSION_SIZE) != 0) {
+        if (synced_) {
+            session_changes_++;
+        }
+        reset();
+        std::memcpy(session_.data(), packet, SESSION_SIZE);
+        synced_ = true;
+        next_sequence_ = sequence;
+        highest_seen_ = sequence;
+    }
+
+    uint64_t end = sequence + count;
+    highest_seen_ = std::max(highest_seen_, end);   // Heartbeats carry the next sequence
+
+    if (sequence > next_sequence_) {
+        // Ahead of what we have: wait for the other line to fill the hole
+        if (count > 0) {
+            HeldPacket* same = nullptr;
+            for (HeldPacket& held : held_) {
+                if (held.used && held.sequence == sequence) same = &held;
+            }
+            if (same) {
+                duplicates_[line]++;
+            } else if (held_count_ == held_.size()) {
+                hold_overflows_++;
+                skip_gap(now_ns);
+                return on_packet(line, packet, len, timestamp_ns, now_ns);
+            } else {
+                hold(packet, len, sequence, count, timestamp_ns);
+            }
+        }
+        if (gap_since_ns_ == 0) {
+            gap_since_ns_ = now_ns;
+        }
+        return true;
+    }
+
+    if (end <= next_sequence_) {
+        if (count > 0) {
+            duplicates_[line]++;
+        }
+        return true;
+    }
+
+    packets_won_[line]++;
+    deliver(packet, len, sequence, count, timestamp_ns);
+    drain_held();
+
+    // Any hole left is a new one; its wait starts now
+    gap_since_ns_ = (held_count_ > 0 || highest_seen_ > next_sequence_) ? now_ns : 0;
+    return true;
+}
+
+void FeedArbitrator::poll(uint64_t now_ns) {
+    if (gap_since_ns_ != 0 && now_ns - gap_since_ns_ >= gap_timeout_ns_) {
+        skip_gap(now_ns);
+    }
+}
+
+void FeedArbitrator::reset() {
+    for (HeldPacket& held : held_) {
+        held.used = false;
+    }
+    held_count_ = 0;
+    synced_ = false;
+    next_sequence_ = 0;
+    highest_seen_ = 0;
+    gap_since_ns_ = 0;
+}
+
+void FeedArbitrator::deliver(const uint8_t* packet, size_t len, uint64_t sequence, uint32_t count,
+                             uint64_t timestamp_ns) {
+    uint64_t end = sequence + count;
+
+    if (sequence < next_sequence_) {
+        // Overlaps what was delivered: rebuild the packet from its new messages
+        uint64_t skip = next_sequence_ - sequence;
+        size_t offset = HEADER_SIZE;
+        for (uint64_t i = 0; i < skip; ++i) {
+            if (offset + 2 > len || offset + 2 + read_be16(packet + offset) > len) {
+                malformed_packets_++;
+                messages_lost_ += end - next_sequence_;
+                next_sequence_ = end;
+                return;
+            }
+            offset += 2 + read_be16(packet + offset);
+        }
+        std::memcpy(trimmed_.data(), packet, SESSION_SIZE);
+        write_be64(trimmed_.data() + SESSION_SIZE, next_sequence_);
+        write_be16(trimmed_.data() + SESSION_SIZE + 8, static_cast<uint16_t>(end - next_sequence_));
+        std::memcpy(trimmed_.data() + HEADER_SIZE, packet + offset, len - offset);
+        packet = trimmed_.data();
+        len = HEADER_SIZE + (len - offset);
+    }
+
+    next_sequence_ = end;
+    packets_delivered_++;
+    if (deliver_callback_) {
+        deliver_callback_(packet, len, timestamp_ns);
+    }
+}
+
+void FeedArbitrator::hold(const uint8_t* packet, size_t len, uint64_t sequence, uint32_t count,
+                          uint64_t timestamp_ns) {
+    for (HeldPacket& held : held_) {
+        if (held.used) continue;
+        held.used = true;
+        held.sequence = sequence;
+        held.count = count;
+        held.timestamp_ns = timestamp_ns;
+        held.length = len;
+        std::memcpy(held.data.data(), packet, len);
+        held_count_++;
+        packets_held_++;
+        return;
+    }
+}
+
+void FeedArbitrator::drain_held() {
+    while (HeldPacket* held = lowest_held()) {
+        if (held->sequence > next_sequence_) break;
+        if (held->sequence + held->count > next_sequence_) {
+            deliver(held->data.data(), held->length, held->sequence, held->count, held->timestamp_ns);
+        }
+        held->used = false;
+        held_count_--;
+    }
+}
+
+void FeedArbitrator::skip_gap(uint64_t now_ns) {
+    HeldPacket* lowest = lowest_held();
+    uint64_t target = lowest ? lowest->sequence : highest_seen_;
+    if (target > next_sequence_) {
+        uint64_t lost = target - next_sequence_;
+        gaps_++;
+        messages_lost_ += lost;
+        if (gap_callback_) {
+            gap_callback_(next_sequence_, lost);
+        }
+        next_sequence_ = target;
+    }
+    drain_held();
+    gap_since_ns_ = (held_count_ > 0 || highest_seen_ > next_sequence_) ? now_ns : 0;
+}
+
+FeedArbitrator::HeldPacket* FeedArbitrator::lowest_held() {
+    if (held_count_ == 0) return nullptr;
+    HeldPacket* lowest = nullptr;
+    for (HeldPacket& held : held_) {
+        if (held.used && (!lowest || held.sequence < lowest->sequence)) lowest = &held;
+    }
+    return lowest;
+}
+
+} // namespace hft
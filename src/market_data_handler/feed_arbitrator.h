@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace hft {
+
+// A/B line arbitration for MoldUDP64 feeds. Both lines carry the same
+// sequenced packets; whichever copy arrives first is delivered, the other
+// is dropped as a duplicate. A packet that skips ahead of the next expected
+// sequence is held (copied into a preallocated slot) while the other line
+// gets a chance to fill the hole. If the hole is still there after the gap
+// timeout, or the hold slots run out, the missing messages are declared
+// lost and delivery resumes from the held packets.
+//
+// Delivered packets are always contiguous: a packet that overlaps what was
+// already delivered is trimmed to its new messages before delivery.
+// Single-threaded.
+class FeedArbitrator {
+public:
+    using DeliverCallback = std::function<void(const uint8_t* packet, size_t len, uint64_t timestamp_ns)>;
+    using GapCallback = std::function<void(uint64_t first_missing, uint64_t count)>;
+
+    static constexpr size_t MAX_LINES = 2;
+    static constexpr size_t MAX_PACKET_SIZE = 2048;     // Larger packets can't be held
+    static constexpr size_t HEADER_SIZE = 20;           // Session, sequence, message count
+
+    FeedArbitrator(size_t hold_slots, uint64_t gap_timeout_ns);
+
+    void set_deliver_callback(DeliverCallback callback) { deliver_callback_ = std::move(callback); }
+    void set_gap_callback(GapCallback callback) { gap_callback_ = std::move(callback); }
+
+    // One packet from line (0 = A, 1 = B); now_ns is any monotonic clock.
+    // false if it isn't MoldUDP64 framed.
+    bool on_packet(uint8_t line, const uint8_t* packet, size_t len, uint64_t timestamp_ns, uint64_t now_ns);
+
+    // Gives up on a hole once it has been waited on for the gap timeout;
+    // call from the receive loop whether or not packets arrived
+    void poll(uint64_t now_ns);
+
+    // Forget the session and anything held
+    void reset();
+
+    uint64_t next_sequence() const { return next_sequence_; }
+
+    // Statistics
+    uint64_t packets_delivered() const { return packets_delivered_; }
+    uint64_t packets_won(uint8_t line) const { return packets_won_[line]; }        // Delivered first from this line
+    uint64_t duplicates(uint8_t line) const { return duplicates_[line]; }
+    uint64_t gaps() const { return gaps_; }
+    uint64_t messages_lost() const { return messages_lost_; }
+    uint64_t packets_held() const { return packets_held_; }
+    uint64_t hold_overflows() const { return hold_overflows_; }
+    uint64_t session_changes() const { return session_changes_; }
+    uint64_t malformed_packets() const { return malformed_packets_; }
+
+private:
+    struct HeldPacket {
+        bool used = false;
+        uint64_t sequence = 0;
+        uint32_t count = 0;
+        uint64_t timestamp_ns = 0;
+        size_t length = 0;
+        std::array<uint8_t, MAX_PACKET_SIZE> data;
+    };
+
+    std::vector<HeldPacket> held_;
+    size_t held_count_ = 0;
+    uint64_t gap_timeout_ns_;
+
+    bool synced_ = false;
+    std::array<uint8_t, 10> session_{};
+    uint64_t next_sequence_ = 0;
+    uint64_t highest_seen_ = 0;         // One past the last sequence any line has shown
+    uint64_t gap_since_ns_ = 0;         // 0 = no hole being waited on
+
+    DeliverCallback deliver_callback_;
+    GapCallback gap_callback_;
+    std::array<uint8_t, MAX_PACKET_SIZE> trimmed_;
+
+    uint64_t packets_delivered_ = 0;
+    std::array<uint64_t, MAX_LINES> packets_won_{};
+    std::array<uint64_t, MAX_LINES> duplicates_{};
+    uint64_t gaps_ = 0;
+    uint64_t messages_lost_ = 0;
+    uint64_t packets_held_ = 0;
+    uint64_t hold_overflows_ = 0;
+    uint64_t session_changes_ = 0;
+    uint64_t malformed_packets_ = 0;
+
+    // Delivers whatever part of the packet is past next_sequence_
+    void deliver(const uint8_t* packet, size_t len, uint64_t sequence, uint32_t count, uint64_t timestamp_ns);
+    void hold(const uint8_t* packet, size_t len, uint64_t sequence, uint32_t count, uint64_t timestamp_ns);
+    void drain_held();
+    void skip_gap(uint64_t now_ns);     // Declare the current hole lost
+    HeldPacket* lowest_held();
+};
+
+} // namespace hft
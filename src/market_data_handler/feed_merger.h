@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include "../common/spsc_channel.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hft {
+
+// Merges the quotes of several feed connections, each handed over on its own
+// SPSC channel, into one stream in exchange timestamp order. Each connection
+// delivers in order already; across connections the earliest queued quote goes
+// out once every live input has a quote queued behind it, or once it has
+// waited window_ns for the quiet ones. Inputs marked down are not waited for,
+// so one dropped connection never holds the others back.
+//
+// One consumer thread calls poll(); each channel has one producer at a time.
+class FeedMerger {
+public:
+    using Channel = SPSCChannel<MarketData, 4096>;
+
+    FeedMerger(size_t inputs, uint64_t window_ns) : window_ns_(window_ns) {
+        for (size_t i = 0; i < inputs; ++i) inputs_.push_back(std::make_unique<Input>());
+    }
+
+    size_t inputs() const { return inputs_.size(); }
+
+    // Producer end of one input
+    Channel& channel(size_t input) { return inputs_[input]->channel; }
+
+    // Whether poll() waits for this input; any thread
+    void set_live(size_t input, bool live) { inputs_[input]->live.store(live, std::memory_order_release); }
+    bool is_live(size_t input) const { return inputs_[input]->live.load(std::memory_order_acquire); }
+
+    // Consumer: hands quotes to emit(const MarketData&) in merged order until
+    // the next one has to wait; now_ns is any monotonic clock. Returns how
+    // many went out.
+    template<typename Fn>
+    size_t poll(uint64_t now_ns, Fn&& emit) {
+        size_t emitted = 0;
+        for (;;) {
+            Input* earliest = nullptr;
+            bool waiting = false;
+            for (auto& input : inputs_) {
+                if (!input->has_head && input->channel.try_pop(input->head)) {
+                    input->has_head = true;
+                    input->head_since_ns = now_ns;
+                }
+                if (input->has_head) {
+                    // Ties go to the lower input; a quote without an exchange
+                    // time sorts first and goes out at once
+                    if (!earliest || input->head.exchange_timestamp < earliest->head.exchange_timestamp) {
+                        earliest = input.get();
+                    }
+                } else if (input->live.load(std::memory_order_acquire)) {
+                    waiting = true;
+                }
+            }
+            if (!earliest) break;
+            if (waiting && now_ns - earliest->head_since_ns < window_ns_) break;
+
+            // Something older may still turn up after the window; count it
+            uint64_t timestamp = earliest->head.exchange_timestamp;
+            if (timestamp != 0 && timestamp < last_timestamp_) {
+                late_++;
+            } else if (timestamp > last_timestamp_) {
+                last_timestamp_ = timestamp;
+            }
+            emit(static_cast<const MarketData&>(earliest->head));
+            earliest->has_head = false;
+            emitted++;
+        }
+        return emitted;
+    }
+
+    // Quotes that went out behind a later one already sent (consumer thread)
+    uint64_t late() const { return late_; }
+
+private:
+    struct Input {
+        Channel channel;
+        std::atomic<bool> live{false};
+        // Consumer side: the input's next quote, taken off the channel
+        MarketData head{};
+        bool has_head = false;
+        uint64_t head_since_ns = 0;
+    };
+
+    std::vector<std::unique_ptr<Input>> inputs_;
+    uint64_t window_ns_;
+    uint64_t last_timestamp_ = 0;
+    uint64_t late_ = 0;
+};
+
+} // namespace hft
@@ -0,0 +1,382 @@
+#include "itch_decoder.h"
+#include <limits>
+
+namespace hft {
+
+namespace {
+
+// ITCH is big-endian; these compile to a load plus bswap (or movbe)
+inline uint16_t load_be16(const uint8_t* p) {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap16(value);
+}
+
+inline uint32_t load_be32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap32(value);
+}
+
+inline uint64_t load_be64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap64(value);
+}
+
+// 6-byte timestamp, nanoseconds since midnight
+inline uint64_t load_timestamp(const uint8_t* message) {
+    return (static_cast<uint64_t>(load_be16(message + 5)) << 32) | load_be32(message + 7);
+}
+
+inline uint16_t load_locate(const uint8_t* message) {
+    return load_be16(message + 1);
+}
+
+inline BookSide load_side(uint8_t indicator) {
+    return indicator == 'B' ? BookSide::BID : BookSide::ASK;
+}
+
+constexpr size_t MOLD_HEADER_SIZE = 20;         // Session (10), sequence (8), count (2)
+constexpr uint16_t MOLD_END_OF_SESSION = 0xFFFF;
+
+} // namespace
+
+// Message lengths from the ITCH 5.0 specification (type byte included)
+constexpr std::array<ItchDecoder::MessageSpec, 256> ItchDecoder::build_dispatch_table() {
+    std::array<MessageSpec, 256> table{};
+    auto set = [&table](char type, uint16_t length, Handler handler) {
+        table[static_cast<uint8_t>(type)] = MessageSpec{length, handler};
+    };
+
+    set('S', 12, nullptr);                                          // System Event
+    set('R', 39, &ItchDecoder::on_stock_directory);                 // Stock Directory
+    set('H', 25, nullptr);                                          // Stock Trading Action
+    set('Y', 20, nullptr);                                          // Reg SHO Restriction
+    set('L', 26, nullptr);                                          // Market Participant Position
+    set('V', 35, nullptr);                                          // MWCB Decline Level
+    set('W', 12, nullptr);                                          // MWCB Status
+    set('K', 28, nullptr);                                          // IPO Quoting Period
+    set('J', 35, nullptr);                                          // LULD Auction Collar
+    set('h', 21, nullptr);                                          // Operational Halt
+    set('A', 36, &ItchDecoder::on_add_order);                       // Add Order
+    set('F', 40, &ItchDecoder::on_add_order);                       // Add Order with MPID
+    set('E', 31, &ItchDecoder::on_order_executed);                  // Order Executed
+    set('C', 36, &ItchDecoder::on_order_executed_with_price);       // Order Executed with Price
+    set('X', 23, &ItchDecoder::on_order_cancel);                    // Order Cancel
+    set('D', 19, &ItchDecoder::on_order_delete);                    // Order Delete
+    set('U', 35, &ItchDecoder::on_order_replace);                   // Order Replace
+    set('P', 44, &ItchDecoder::on_trade);                           // Trade (non-cross)
+    set('Q', 40, &ItchDecoder::on_cross_trade);                     // Cross Trade
+    set('B', 19, nullptr);                                          // Broken Trade
+    set('I', 50, nullptr);                                          // NOII
+    set('N', 20, nullptr);                                          // Retail Price Improvement
+    set('O', 48, nullptr);                                          // Direct Listing with Capital Raise
+    return table;
+}
+
+constinit const std::array<ItchDecoder::MessageSpec, 256> ItchDecoder::DISPATCH =
+    ItchDecoder::build_dispatch_table();
+
+ItchDecoder::ItchDecoder(size_t max_orders, std::pmr::memory_resource* memory)
+    : max_orders_(max_orders)
+    , orders_(max_orders, memory)
+    , levels_(max_orders, memory)   // Every live level holds at least one live order
+    , locates_(std::numeric_limits<uint16_t>::max() + 1)
+    , update_{} {
+    update_.header = MessageFactory::create_header(MessageType::ORDER_BOOK_UPDATE,
+                                                   sizeof(OrderBookUpdate) - sizeof(MessageHeader));
+}
+
+void ItchDecoder::set_symbol_filter(const std::vector<std::string>& symbols) {
+    symbol_filter_ = symbols;
+    for (auto& info : locates_) {
+        info = LocateInfo{};
+    }
+}
+
+bool ItchDecoder::decode_message(const uint8_t* message, size_t len) {
+    if (len == 0) {
+        malformed_messages_++;
+        return false;
+    }
+    const MessageSpec& spec = DISPATCH[message[0]];
+    if (spec.length == 0) {
+        unknown_messages_++;
+        return false;
+    }
+    if (len < spec.length) {
+        malformed_messages_++;
+        return false;
+    }
+
+    messages_decoded_++;
+    if (spec.handler) {
+        (this->*spec.handler)(message);
+    }
+    return true;
+}
+
+size_t ItchDecoder::decode_stream(const uint8_t* data, size_t len) {
+    size_t pos = 0;
+    while (pos + 2 <= len) {
+        size_t end = pos + 2 + load_be16(data + pos);
+        if (end > len) {
+            break;
+        }
+        // Start fetching the order the next message refers to; the order
+        // table is far larger than cache, so this hides most of the miss
+        if (end + 2 + 19 <= len) {
+            prefetch_order(data + end + 2);
+        }
+        decode_message(data + pos + 2, end - pos - 2);
+        pos = end;
+    }
+    return pos;
+}
+
+bool ItchDecoder::decode_moldudp64(const uint8_t* payload, size_t len) {
+    if (len < MOLD_HEADER_SIZE) {
+        return false;
+    }
+    uint16_t count = load_be16(payload + 18);
+    if (count == MOLD_END_OF_SESSION) {
+        return len == MOLD_HEADER_SIZE;
+    }
+
+    // Check the blocks exactly fill the packet before touching any state
+    const uint8_t* blocks = payload + MOLD_HEADER_SIZE;
+    size_t blocks_len = len - MOLD_HEADER_SIZE;
+    size_t pos = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (pos + 2 > blocks_len) {
+            return false;
+        }
+        pos += 2 + load_be16(blocks + pos);
+    }
+    if (pos != blocks_len) {
+        return false;
+    }
+
+    decode_stream(blocks, blocks_len);
+    return true;
+}
+
+void ItchDecoder::reset() {
+    orders_.clear();
+    levels_.clear();
+    live_orders_ = 0;
+}
+
+void ItchDecoder::prefetch_order(const uint8_t* message) const {
+    switch (message[0]) {
+        case 'E': case 'C': case 'X': case 'D': case 'U':
+            orders_.prefetch(load_be64(message + 11));
+            break;
+        default:
+            break;
+    }
+}
+
+ItchDecoder::LocateInfo& ItchDecoder::locate_info(uint16_t locate, const uint8_t* stock) {
+    LocateInfo& info = locates_[locate];
+    if (info.state != LocateState::UNKNOWN) {
+        return info;
+    }
+
+    // Stock field is 8 characters, right-padded with spaces
+    size_t length = 0;
+    while (length < 8 && stock[length] != ' ' && stock[length] != '\0') {
+        info.symbol[length] = static_cast<char>(stock[length]);
+        length++;
+    }
+    info.symbol[length] = '\0';
+
+    bool wanted = symbol_filter_.empty() ||
+                  std::find(symbol_filter_.begin(), symbol_filter_.end(), info.symbol) != symbol_filter_.end();
+    if (wanted) {
+        info.state = LocateState::TRACKED;
+        info.symbol_id = SymbolTable::instance().intern(info.symbol);
+    } else {
+        info.state = LocateState::IGNORED;
+    }
+    return info;
+}
+
+void ItchDecoder::on_stock_directory(const uint8_t* message) {
+    locate_info(load_locate(message), message + 11);
+}
+
+void ItchDecoder::on_add_order(const uint8_t* message) {
+    uint16_t locate = load_locate(message);
+    if (locate_info(locate, message + 24).state != LocateState::TRACKED) {
+        return;
+    }
+    add_order(load_be64(message + 11), locate, load_side(message[19]), load_be32(message + 32),
+              load_be32(message + 20), load_timestamp(message));
+}
+
+void ItchDecoder::on_order_executed(const uint8_t* message) {
+    const LocateInfo& info = locates_[load_locate(message)];
+    if (info.state == LocateState::IGNORED) {
+        return;
+    }
+    uint64_t timestamp = load_timestamp(message);
+    uint32_t shares = load_be32(message + 19);
+    OrderEntry order;
+    if (reduce_order(load_be64(message + 11), shares, timestamp, &order)) {
+        emit_trade(info, order.price, std::min(shares, order.shares), timestamp);
+    }
+}
+
+void ItchDecoder::on_order_executed_with_price(const uint8_t* message) {
+    const LocateInfo& info = locates_[load_locate(message)];
+    if (info.state == LocateState::IGNORED) {
+        return;
+    }
+    uint64_t timestamp = load_timestamp(message);
+    uint32_t shares = load_be32(message + 19);
+    OrderEntry order;
+    // Non-printable executions change the book but aren't reported as trades
+    if (reduce_order(load_be64(message + 11), shares, timestamp, &order) && message[31] == 'Y') {
+        emit_trade(info, load_be32(message + 32), std::min(shares, order.shares), timestamp);
+    }
+}
+
+void ItchDecoder::on_order_cancel(const uint8_t* message) {
+    if (locates_[load_locate(message)].state == LocateState::IGNORED) {
+        return;
+    }
+    reduce_order(load_be64(message + 11), load_be32(message + 19), load_timestamp(message));
+}
+
+void ItchDecoder::on_order_delete(const uint8_t* message) {
+    if (locates_[load_locate(message)].state == LocateState::IGNORED) {
+        return;
+    }
+    reduce_order(load_be64(message + 11), std::numeric_limits<uint32_t>::max(), load_timestamp(message));
+}
+
+void ItchDecoder::on_order_replace(const uint8_t* message) {
+    if (locates_[load_locate(message)].state == LocateState::IGNORED) {
+        return;
+    }
+    // The new order keeps the original's side and stock
+    uint64_t timestamp = load_timestamp(message);
+    OrderEntry original;
+    if (reduce_order(load_be64(message + 11), std::numeric_limits<uint32_t>::max(), timestamp, &original)) {
+        add_order(load_be64(message + 19), original.locate, original.side, load_be32(message + 31),
+                  load_be32(message + 27), timestamp);
+    }
+}
+
+void ItchDecoder::on_trade(const uint8_t* message) {
+    // Executions against hidden orders: no book change
+    const LocateInfo& info = locate_info(load_locate(message), message + 24);
+    if (info.state == LocateState::TRACKED) {
+        emit_trade(info, load_be32(message + 32), load_be32(message + 20), load_timestamp(message));
+    }
+}
+
+void ItchDecoder::on_cross_trade(const uint8_t* message) {
+    const LocateInfo& info = locate_info(load_locate(message), message + 19);
+    uint64_t shares = load_be64(message + 11);
+    if (info.state == LocateState::TRACKED && shares > 0) {
+        uint32_t clamped = static_cast<uint32_t>(std::min<uint64_t>(shares, std::numeric_limits<uint32_t>::max()));
+        emit_trade(info, load_be32(message + 27), clamped, load_timestamp(message));
+    }
+}
+
+void ItchDecoder::add_order(uint64_t ref, uint16_t locate, BookSide side, uint32_t price, uint32_t shares,
+                            uint64_t timestamp) {
+    if (ref == 0 || shares == 0) {
+        malformed_messages_++;
+        return;
+    }
+    if (live_orders_ >= max_orders_) {
+        orders_dropped_++;
+        return;
+    }
+
+    bool inserted;
+    OrderEntry& order = orders_.find_or_insert(ref, inserted);
+    if (!inserted) {
+        malformed_messages_++;      // Reference numbers are unique for the day
+        return;
+    }
+    order.price = price;
+    order.shares = shares;
+    order.locate = locate;
+    order.side = side;
+    live_orders_++;
+
+    change_level(order, shares, 1, timestamp);
+}
+
+bool ItchDecoder::reduce_order(uint64_t ref, uint32_t shares, uint64_t timestamp, OrderEntry* order_out) {
+    OrderEntry* order = orders_.find(ref);
+    if (!order) {
+        missing_orders_++;
+        return false;
+    }
+
+    OrderEntry before = *order;
+    uint32_t removed = std::min(shares, order->shares);
+    order->shares -= removed;
+    bool gone = order->shares == 0;
+    if (gone) {
+        orders_.erase(order);
+        live_orders_--;
+    }
+    if (order_out) {
+        *order_out = before;
+    }
+
+    change_level(before, -static_cast<int64_t>(removed), gone ? -1 : 0, timestamp);
+    return true;
+}
+
+void ItchDecoder::change_level(const OrderEntry& order, int64_t shares, int32_t orders, uint64_t timestamp) {
+    bool inserted;
+    LevelEntry& level = levels_.find_or_insert(level_key(order.locate, order.side, order.price), inserted);
+    int64_t new_shares = static_cast<int64_t>(level.shares) + shares;
+    level.shares = new_shares > 0 ? static_cast<uint64_t>(new_shares) : 0;
+    level.order_count = static_cast<uint32_t>(std::max<int64_t>(int64_t{level.order_count} + orders, 0));
+
+    BookUpdateType type = inserted ? BookUpdateType::ADD : BookUpdateType::UPDATE;
+    uint32_t size = static_cast<uint32_t>(std::min<uint64_t>(level.shares, std::numeric_limits<uint32_t>::max()));
+    uint32_t count = level.order_count;
+    if (level.shares == 0 || level.order_count == 0) {
+        type = BookUpdateType::DELETE;
+        size = 0;
+        count = 0;
+        levels_.erase(&level);
+    }
+
+    book_updates_++;
+    if (!book_callback_) {
+        return;
+    }
+
+    LocateInfo& info = locates_[order.locate];
+    sequence_++;
+    update_.header.sequence_number = static_cast<uint32_t>(sequence_);
+    update_.header.timestamp = timestamp_t(timestamp);
+    std::memcpy(update_.symbol, info.symbol, sizeof(update_.symbol));
+    update_.symbol_id = info.symbol_id;
+    update_.update_type = type;
+    update_.side = order.side;
+    update_.level = OrderBookLevel(rescale_price(order.price, 4), size, count);
+    update_.sequence_number = ++info.book_sequence;
+    update_.exchange_timestamp = timestamp;
+    book_callback_(update_);
+}
+
+void ItchDecoder::emit_trade(const LocateInfo& info, uint32_t price, uint32_t shares, uint64_t timestamp) {
+    trades_++;
+    if (trade_callback_) {
+        trade_callback_(ItchTrade{info.symbol_id, info.symbol, rescale_price(price, 4), shares, timestamp});
+    }
+}
+
+} // namespace hft
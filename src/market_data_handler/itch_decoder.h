@@ -0,0 +1,223 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include "../common/order_book.h"
+#include "../common/symbol_table.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// Trades reported by the feed: executions against displayed orders ('E', 'C'),
+// hidden-order trades ('P') and crosses ('Q')
+struct ItchTrade {
+    symbol_id_t symbol_id;
+    const char* symbol;
+    price_t price;
+    uint32_t shares;
+    uint64_t timestamp_ns;      // Since midnight, exchange time
+};
+
+// Open-addressed table of Entry values keyed by Entry::key (linear probing,
+// backward-shift deletion, key 0 = empty). Storage is allocated once from
+// memory; the caller keeps the load factor in check.
+template<typename Entry>
+class FlatTable {
+public:
+    explicit FlatTable(size_t capacity, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : entries_(table_size(capacity), memory), mask_(entries_.size() - 1) {}
+
+    Entry* find(uint64_t key) {
+        for (size_t i = bucket(key); entries_[i].key != 0; i = (i + 1) & mask_) {
+            if (entries_[i].key == key) return &entries_[i];
+        }
+        return nullptr;
+    }
+
+    // Slot for key, value-initialized if new; inserted tells which
+    Entry& find_or_insert(uint64_t key, bool& inserted) {
+        size_t i = bucket(key);
+        for (; entries_[i].key != 0; i = (i + 1) & mask_) {
+            if (entries_[i].key == key) {
+                inserted = false;
+                return entries_[i];
+            }
+        }
+        entries_[i] = Entry{};
+        entries_[i].key = key;
+        inserted = true;
+        return entries_[i];
+    }
+
+    // entry must come from find()/find_or_insert() and is invalid afterwards
+    void erase(Entry* entry) {
+        size_t gap = static_cast<size_t>(entry - entries_.data());
+        for (size_t j = (gap + 1) & mask_; entries_[j].key != 0; j = (j + 1) & mask_) {
+            size_t home = bucket(entries_[j].key);
+            if (((j - home) & mask_) >= ((j - gap) & mask_)) {
+                entries_[gap] = entries_[j];
+                gap = j;
+            }
+        }
+        entries_[gap] = Entry{};
+    }
+
+    void prefetch(uint64_t key) const { __builtin_prefetch(&entries_[bucket(key)]); }
+
+    void clear() { std::fill(entries_.begin(), entries_.end(), Entry{}); }
+
+private:
+    std::pmr::vector<Entry> entries_;
+    size_t mask_;
+
+    // Power of two at least twice the capacity, so load stays at or below 50%
+    static size_t table_size(size_t capacity) {
+        size_t size = 16;
+        while (size < capacity * 2) size <<= 1;
+        return size;
+    }
+
+    size_t bucket(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+    }
+};
+
+// NASDAQ TotalView-ITCH 5.0 decoder. Tracks every live order (Add, Execute,
+// Cancel, Delete, Replace) and aggregates them into price levels, emitting
+// one OrderBookUpdate per level change in the form OrderBookManager applies:
+// ADD for a new price, UPDATE with the level's new total size, DELETE when
+// the last order at a price goes. Orders and levels live in preallocated
+// FlatTables, so decoding doesn't allocate once symbols are known.
+//
+// Messages are dispatched through a table indexed by message type, built at
+// compile time with each type's length and handler. Single-threaded.
+class ItchDecoder {
+public:
+    using BookUpdateCallback = std::function<void(const OrderBookUpdate&)>;
+    using TradeCallback = std::function<void(const ItchTrade&)>;
+
+    static constexpr size_t DEFAULT_MAX_ORDERS = 1 << 21;
+
+    // The order and level tables (about 100 bytes per max order) come from
+    // memory, typically the hot arena
+    explicit ItchDecoder(size_t max_orders = DEFAULT_MAX_ORDERS,
+                         std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    void set_book_update_callback(BookUpdateCallback callback) { book_callback_ = std::move(callback); }
+    void set_trade_callback(TradeCallback callback) { trade_callback_ = std::move(callback); }
+
+    // Only build books for these symbols (empty = all); call before decoding
+    void set_symbol_filter(const std::vector<std::string>& symbols);
+
+    // One message starting at its type byte; false if unknown or truncated
+    bool decode_message(const uint8_t* message, size_t len);
+
+    // Back-to-back messages, each behind a 2-byte big-endian length (the
+    // NASDAQ historical file format). Returns the bytes consumed; a partial
+    // message at the end is left for the next call.
+    size_t decode_stream(const uint8_t* data, size_t len);
+
+    // One MoldUDP64 packet; false if the framing doesn't check out
+    bool decode_moldudp64(const uint8_t* payload, size_t len);
+
+    // Drops all orders and levels (e.g. when replay loops)
+    void reset();
+
+    // Statistics
+    uint64_t messages_decoded() const { return messages_decoded_; }
+    uint64_t book_updates() const { return book_updates_; }
+    uint64_t trades() const { return trades_; }
+    uint64_t unknown_messages() const { return unknown_messages_; }
+    uint64_t malformed_messages() const { return malformed_messages_; }
+    uint64_t missing_orders() const { return missing_orders_; }   // Refs never added or already gone
+    uint64_t orders_dropped() const { return orders_dropped_; }   // Table full
+    size_t live_orders() const { return live_orders_; }
+    size_t max_orders() const { return max_orders_; }
+
+private:
+    using Handler = void (ItchDecoder::*)(const uint8_t*);
+
+    struct MessageSpec {
+        uint16_t length = 0;        // 0 = not an ITCH 5.0 message type
+        Handler handler = nullptr;  // nullptr = valid but not needed for the book
+    };
+
+    struct OrderEntry {
+        uint64_t key = 0;           // Order reference number
+        uint32_t price = 0;         // Feed units (4 decimals)
+        uint32_t shares = 0;
+        uint16_t locate = 0;
+        BookSide side = BookSide::BID;
+    };
+
+    struct LevelEntry {
+        uint64_t key = 0;           // level_key(locate, side, price)
+        uint64_t shares = 0;
+        uint32_t order_count = 0;
+    };
+
+    enum class LocateState : uint8_t { UNKNOWN, TRACKED, IGNORED };
+
+    struct LocateInfo {
+        LocateState state = LocateState::UNKNOWN;
+        symbol_id_t symbol_id = INVALID_SYMBOL_ID;
+        char symbol[16] = {};
+        uint64_t book_sequence = 0;             // Per-book update numbering, for gap detection
+    };
+
+    static constexpr std::array<MessageSpec, 256> build_dispatch_table();
+    static const std::array<MessageSpec, 256> DISPATCH;
+
+    size_t max_orders_;
+    FlatTable<OrderEntry> orders_;
+    FlatTable<LevelEntry> levels_;
+    std::vector<LocateInfo> locates_;           // Indexed by stock locate
+    std::vector<std::string> symbol_filter_;
+    size_t live_orders_ = 0;
+
+    BookUpdateCallback book_callback_;
+    TradeCallback trade_callback_;
+    OrderBookUpdate update_;                    // Reused for every callback
+    uint64_t sequence_ = 0;
+
+    uint64_t messages_decoded_ = 0;
+    uint64_t book_updates_ = 0;
+    uint64_t trades_ = 0;
+    uint64_t unknown_messages_ = 0;
+    uint64_t malformed_messages_ = 0;
+    uint64_t missing_orders_ = 0;
+    uint64_t orders_dropped_ = 0;
+
+    // Message handlers (message points at the type byte)
+    void on_stock_directory(const uint8_t* message);
+    void on_add_order(const uint8_t* message);
+    void on_order_executed(const uint8_t* message);
+    void on_order_executed_with_price(const uint8_t* message);
+    void on_order_cancel(const uint8_t* message);
+    void on_order_delete(const uint8_t* message);
+    void on_order_replace(const uint8_t* message);
+    void on_trade(const uint8_t* message);
+    void on_cross_trade(const uint8_t* message);
+
+    LocateInfo& locate_info(uint16_t locate, const uint8_t* stock);
+    void add_order(uint64_t ref, uint16_t locate, BookSide side, uint32_t price, uint32_t shares,
+                   uint64_t timestamp);
+    // Takes shares off an order, removing it at zero; false if the ref is
+    // unknown. order_out gets the order as it was before the reduction.
+    bool reduce_order(uint64_t ref, uint32_t shares, uint64_t timestamp, OrderEntry* order_out = nullptr);
+    void change_level(const OrderEntry& order, int64_t shares, int32_t orders, uint64_t timestamp);
+    void emit_trade(const LocateInfo& info, uint32_t price, uint32_t shares, uint64_t timestamp);
+    void prefetch_order(const uint8_t* message) const;
+
+    static uint64_t level_key(uint16_t locate, BookSide side, uint32_t price) {
+        return (static_cast<uint64_t>(locate) << 48) | (static_cast<uint64_t>(side) << 40) | price;
+    }
+};
+
+} // namespace hft
@@ -0,0 +1,275 @@
+#include "load_generator.h"
+#include "../common/static_config.h"
+#include "../common/symbol_table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace hft {
+
+namespace {
+
+constexpr double STEP_SECONDS = 0.001;              // Price step per quote, as in the mock generator
+constexpr uint64_t MAX_BACKLOG_NS = 10'000'000;     // Quotes owed beyond 10ms are dropped
+
+constexpr double OPEN_PEAK = 5.0;
+constexpr double OPEN_DECAY_SECONDS = 90.0;
+constexpr double BURST_PEAK = 10.0;
+constexpr uint64_t BURST_PERIOD_NS = 1'000'000'000;
+constexpr uint64_t BURST_LENGTH_NS = 20'000'000;
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// The Ziggurat layer and signed abscissa from one draw; xoshiro256+'s low
+// bits are its weakest, so both come from the top
+inline int32_t ziggurat_hz(uint64_t bits) { return static_cast<int32_t>(bits >> 32); }
+inline uint32_t ziggurat_iz(uint64_t bits) { return static_cast<uint32_t>(bits >> 25) & 127; }
+inline uint32_t magnitude(int32_t hz) { return hz < 0 ? 0u - static_cast<uint32_t>(hz) : static_cast<uint32_t>(hz); }
+
+} // namespace
+
+BlockRandom::BlockRandom(uint64_t seed) {
+    uint64_t state = seed;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        s0_[lane] = splitmix64(state);
+        s1_[lane] = splitmix64(state);
+        s2_[lane] = splitmix64(state);
+        s3_[lane] = splitmix64(state);
+    }
+
+    // Marsaglia and Tsang, "The Ziggurat Method for Generating Random
+    // Variables" (2000), 128 layers
+    const double m1 = 2147483648.0;
+    double dn = 3.442619855899;
+    double tn = dn;
+    const double vn = 9.91256303526217e-3;
+    const double q = vn / std::exp(-0.5 * dn * dn);
+    kn_[0] = static_cast<uint32_t>((dn / q) * m1);
+    kn_[1] = 0;
+    wn_[0] = q / m1;
+    wn_[127] = dn / m1;
+    fn_[0] = 1.0;
+    fn_[127] = std::exp(-0.5 * dn * dn);
+    for (int i = 126; i >= 1; --i) {
+        dn = std::sqrt(-2.0 * std::log(vn / dn + std::exp(-0.5 * dn * dn)));
+        kn_[i + 1] = static_cast<uint32_t>((dn / tn) * m1);
+        tn = dn;
+        fn_[i] = std::exp(-0.5 * dn * dn);
+        wn_[i] = dn / m1;
+    }
+}
+
+void BlockRandom::fill(uint64_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            out[i + lane] = s0_[lane] + s3_[lane];
+            uint64_t t = s1_[lane] << 17;
+            s2_[lane] ^= s0_[lane];
+            s3_[lane] ^= s1_[lane];
+            s1_[lane] ^= s2_[lane];
+            s0_[lane] ^= s3_[lane];
+            s2_[lane] ^= t;
+            s3_[lane] = rotl(s3_[lane], 45);
+        }
+    }
+    if (i < n) {
+        uint64_t tail[LANES];
+        fill(tail, LANES);
+        std::memcpy(out + i, tail, (n - i) * sizeof(uint64_t));
+    }
+}
+
+void BlockRandom::fill_normal(double* out, size_t n) {
+    scratch_.resize(n);
+    fill(scratch_.data(), n);
+
+    // The fast path for every draw, branch-free
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = ziggurat_hz(scratch_[i]) * wn_[ziggurat_iz(scratch_[i])];
+    }
+    // The ~1% that fall outside their layer's rectangle
+    for (size_t i = 0; i < n; ++i) {
+        int32_t hz = ziggurat_hz(scratch_[i]);
+        uint32_t iz = ziggurat_iz(scratch_[i]);
+        if (magnitude(hz) >= kn_[iz]) {
+            out[i] = normal_tail(hz, iz);
+        }
+    }
+}
+
+double BlockRandom::uniform() {
+    uint64_t bits;
+    fill(&bits, 1);
+    return (static_cast<double>(bits >> 11) + 0.5) * 0x1.0p-53;
+}
+
+double BlockRandom::normal_tail(int32_t hz, uint32_t iz) {
+    const double r = 3.442620;
+    for (;;) {
+        double x = hz * wn_[iz];
+        if (iz == 0) {
+            double y;
+            do {
+                x = -std::log(uniform()) * 0.2904764;   // 1/r
+                y = -std::log(uniform());
+            } while (y + y < x * x);
+            return hz > 0 ? r + x : -r - x;
+        }
+        if (fn_[iz] + uniform() * (fn_[iz - 1] - fn_[iz]) < std::exp(-0.5 * x * x)) {
+            return x;
+        }
+        uint64_t bits;
+        fill(&bits, 1);
+        hz = ziggurat_hz(bits);
+        iz = ziggurat_iz(bits);
+        if (magnitude(hz) < kn_[iz]) {
+            return hz * wn_[iz];
+        }
+    }
+}
+
+bool parse_load_profile(const std::string& text, LoadProfile& profile) {
+    if (text == "flat") {
+        profile = LoadProfile::FLAT;
+    } else if (text == "open") {
+        profile = LoadProfile::OPEN;
+    } else if (text == "bursts") {
+        profile = LoadProfile::BURSTS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double load_rate_multiplier(LoadProfile profile, uint64_t elapsed_ns) {
+    switch (profile) {
+        case LoadProfile::OPEN:
+            return 1.0 + (OPEN_PEAK - 1.0) * std::exp(-static_cast<double>(elapsed_ns) * 1e-9 / OPEN_DECAY_SECONDS);
+        case LoadProfile::BURSTS:
+            return elapsed_ns % BURST_PERIOD_NS < BURST_LENGTH_NS ? BURST_PEAK : 1.0;
+        case LoadProfile::FLAT:
+            break;
+    }
+    return 1.0;
+}
+
+LoadGenerator::LoadGenerator(const std::vector<std::string>& symbols, double rate, LoadProfile profile,
+                             uint64_t seed)
+    : rate_(rate)
+    , profile_(profile)
+    , random_(seed)
+    , bits_(BLOCK)
+    , normals_(BLOCK)
+    , picks_(BLOCK) {
+    const auto& base_prices = StaticConfig::get_symbol_base_prices();
+    const auto& volatilities = StaticConfig::get_symbol_volatilities();
+    const double min_multiplier = StaticConfig::get_min_price_multiplier();
+    const double max_multiplier = StaticConfig::get_max_price_multiplier();
+    const double base_spread_bp = StaticConfig::get_base_spread_basis_points();
+
+    uint64_t bits[BlockRandom::LANES];
+    for (const std::string& symbol : symbols) {
+        std::array<char, 16> name{};
+        std::strncpy(name.data(), symbol.c_str(), name.size() - 1);
+
+        // Configured symbols keep their configured price and volatility;
+        // synthetic ones get a spread of both
+        random_.fill(bits, BlockRandom::LANES);
+        auto price = base_prices.find(symbol);
+        auto volatility = volatilities.find(symbol);
+        double base = price != base_prices.end() ? price->second : 10.0 + static_cast<double>(bits[0] % 49000) / 100.0;
+        double vol = volatility != volatilities.end() ? volatility->second : 0.01 + static_cast<double>(bits[1] % 300) / 10000.0;
+
+        mid_.push_back(base);
+        sigma_.push_back(vol * std::sqrt(STEP_SECONDS));
+        half_spread_.push_back((base_spread_bp + vol * 100.0) / 20000.0);
+        floor_.push_back(base * min_multiplier);
+        ceiling_.push_back(base * max_multiplier);
+        ids_.push_back(SymbolTable::instance().intern(name.data()));
+        names_.push_back(name);
+    }
+
+    min_size_ = static_cast<uint32_t>(std::max(1, StaticConfig::get_min_volume()));
+    size_range_ = static_cast<uint32_t>(std::max(1, StaticConfig::get_max_volume() - StaticConfig::get_min_volume() + 1));
+    min_last_size_ = static_cast<uint32_t>(std::max(1, StaticConfig::get_min_last_size()));
+    last_size_range_ = static_cast<uint32_t>(std::max(1, StaticConfig::get_max_last_size() - StaticConfig::get_min_last_size() + 1));
+}
+
+size_t LoadGenerator::generate(uint64_t elapsed_ns, MarketData* out, size_t max) {
+    if (mid_.empty()) {
+        return 0;
+    }
+    elapsed_ns = std::max(elapsed_ns, last_elapsed_ns_);
+    double rate = rate_at(elapsed_ns);
+    credit_ += rate * static_cast<double>(elapsed_ns - last_elapsed_ns_) * 1e-9;
+    last_elapsed_ns_ = elapsed_ns;
+
+    double backlog = std::max(1.0, rate * static_cast<double>(MAX_BACKLOG_NS) * 1e-9);
+    if (credit_ > backlog) {
+        shortfall_ += static_cast<uint64_t>(credit_ - backlog);
+        credit_ = backlog;
+    }
+
+    size_t count = std::min(static_cast<size_t>(credit_), max);
+    credit_ -= static_cast<double>(count);
+    for (size_t done = 0; done < count; done += BLOCK) {
+        fill_block(elapsed_ns, out + done, std::min(BLOCK, count - done));
+    }
+    generated_ += count;
+    return count;
+}
+
+void LoadGenerator::fill_block(uint64_t elapsed_ns, MarketData* out, size_t count) {
+    random_.fill(bits_.data(), count);
+    random_.fill_normal(normals_.data(), count);
+    const double scale = std::sqrt(load_rate_multiplier(profile_, elapsed_ns));
+
+    // Squaring a uniform skews the picks towards the front of the list
+    const double symbols = static_cast<double>(mid_.size());
+    for (size_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(bits_[i] >> 40) * 0x1.0p-24;
+        picks_[i] = static_cast<uint32_t>(x * x * symbols);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t k = picks_[i];
+        double mid = mid_[k] * (1.0 + sigma_[k] * scale * normals_[i]);
+        mid = std::min(ceiling_[k], std::max(floor_[k], mid));
+        mid_[k] = mid;
+
+        // Sizes and the trade's place in the spread from the draw's low bits
+        uint64_t bits = bits_[i];
+        double half_spread = mid * half_spread_[k] * scale;
+        double bid = mid - half_spread;
+        double ask = mid + half_spread;
+        double position = 0.2 + 0.6 * static_cast<double>((bits >> 32) & 0xFF) / 255.0;
+        uint64_t mixed = bits * 0x9E3779B97F4A7C15ULL;
+
+        MarketData& data = out[i];
+        data.header = MessageFactory::create_header_tsc(MessageType::MARKET_DATA, sizeof(MarketData) - sizeof(MessageHeader));
+        std::memcpy(data.symbol, names_[k].data(), sizeof(data.symbol));
+        data.symbol_id = ids_[k];
+        data.bid_price = to_fixed_price(bid);
+        data.ask_price = to_fixed_price(ask);
+        data.bid_size = min_size_ + static_cast<uint32_t>(((bits & 0xFFFF) * size_range_) >> 16);
+        data.ask_size = min_size_ + static_cast<uint32_t>((((bits >> 16) & 0xFFFF) * size_range_) >> 16);
+        data.last_price = to_fixed_price(bid + (ask - bid) * position);
+        data.last_size = min_last_size_ + static_cast<uint32_t>(((mixed >> 48) * last_size_range_) >> 16);
+        data.exchange_timestamp = data.header.timestamp.count();
+        data.publish_timestamp = 0;
+        data.trace.begin(data.header.sequence_number);
+        data.trace.stamp(TraceStage::FEED_PARSE);
+    }
+}
+
+} // namespace hft
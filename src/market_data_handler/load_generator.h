@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// xoshiro256+ over LANES independent streams held as structure of arrays, so
+// a block of draws is one loop the compiler turns into vector code. Normals
+// use Marsaglia and Tsang's 128-layer Ziggurat: its fast path runs
+// branch-free over the whole block, and only the ~1% of draws outside their
+// layer's rectangle go back through the scalar wedge and tail code.
+class BlockRandom {
+public:
+    static constexpr size_t LANES = 8;
+
+    explicit BlockRandom(uint64_t seed);
+
+    // n raw 64-bit draws
+    void fill(uint64_t* out, size_t n);
+
+    // n standard normal draws
+    void fill_normal(double* out, size_t n);
+
+    // One uniform in (0, 1), for the Ziggurat slow path
+    double uniform();
+
+private:
+    alignas(64) uint64_t s0_[LANES];
+    alignas(64) uint64_t s1_[LANES];
+    alignas(64) uint64_t s2_[LANES];
+    alignas(64) uint64_t s3_[LANES];
+    std::vector<uint64_t> scratch_;
+
+    // Ziggurat tables, built once per generator
+    std::array<uint32_t, 128> kn_;
+    std::array<double, 128> wn_;
+    std::array<double, 128> fn_;
+
+    double normal_tail(int32_t hz, uint32_t iz);
+};
+
+// Rate envelopes: FLAT stays at the base rate; OPEN starts at five times it
+// and decays back over the first minutes like a cash open; BURSTS adds a 20ms
+// spike at ten times the rate every second. Volatility follows the square
+// root of the rate multiplier.
+enum class LoadProfile { FLAT, OPEN, BURSTS };
+
+bool parse_load_profile(const std::string& text, LoadProfile& profile);
+double load_rate_multiplier(LoadProfile profile, uint64_t elapsed_ns);
+
+// Synthetic quote source for driving the services downstream of the feed at
+// rates the mock generator can't reach. Per-symbol state is structure of
+// arrays; each call draws its random numbers for a block of quotes at once,
+// leaving a gather, a price step and a scatter per quote. Symbol choice is
+// skewed towards the front of the list, as activity is in real markets.
+class LoadGenerator {
+public:
+    // Symbol IDs are interned once here; prices and volatilities come from
+    // the mock_data settings where configured
+    LoadGenerator(const std::vector<std::string>& symbols, double rate, LoadProfile profile, uint64_t seed);
+
+    // Fills out with up to max quotes: those due between the previous call
+    // and elapsed_ns into the run. A backlog beyond 10ms of quotes is
+    // dropped and counted, so a slow consumer shows up as shortfall rather
+    // than an ever-growing burst.
+    size_t generate(uint64_t elapsed_ns, MarketData* out, size_t max);
+
+    size_t symbol_count() const { return mid_.size(); }
+    double mid(size_t symbol) const { return mid_[symbol]; }
+    uint64_t elapsed_ns() const { return last_elapsed_ns_; }    // As of the last generate()
+    uint64_t generated() const { return generated_; }
+    uint64_t shortfall() const { return shortfall_; }
+    double rate_at(uint64_t elapsed_ns) const { return rate_ * load_rate_multiplier(profile_, elapsed_ns); }
+
+private:
+    static constexpr size_t BLOCK = 256;
+
+    double rate_;
+    LoadProfile profile_;
+    BlockRandom random_;
+
+    // Per symbol
+    std::vector<double> mid_;
+    std::vector<double> sigma_;          // Relative move per step
+    std::vector<double> half_spread_;    // Fraction of the mid
+    std::vector<double> floor_;
+    std::vector<double> ceiling_;
+    std::vector<symbol_id_t> ids_;
+    std::vector<std::array<char, 16>> names_;
+
+    // Per block
+    std::vector<uint64_t> bits_;
+    std::vector<double> normals_;
+    std::vector<uint32_t> picks_;
+
+    uint32_t min_size_;
+    uint32_t size_range_;
+    uint32_t min_last_size_;
+    uint32_t last_size_range_;
+
+    uint64_t last_elapsed_ns_ = 0;
+    double credit_ = 0.0;
+    uint64_t generated_ = 0;
+    uint64_t shortfall_ = 0;
+
+    void fill_block(uint64_t elapsed_ns, MarketData* out, size_t count);
+};
+
+} // namespace hft
@@ -1,6 +1,10 @@
 #include "market_data_handler.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/sampling_profiler.h"
+#include "../common/startup_timeline.h"
 #include "../common/cpu_affinity.h"
 #include "../common/hft_metrics.h"
 #include <iostream>
@@ -23,9 +27,14 @@ int main(int argc, char* argv[]) {
     std::cout << "HFT Market Data Handler v1.0" << std::endl;
     std::cout << "==============================" << std::endl;
     
+    StartupTimeline& startup = StartupTimeline::instance();
+    
     // Initialize configuration
     std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
-    StaticConfig::load_from_file(config_file.c_str());
+    startup.run("config", [&] { StaticConfig::load_from_file(config_file.c_str()); return true; });
+    ThreadPlan::instance().configure("market_data_handler");
+    // Reserve and pre-fault hot-state memory before the service allocates from it
+    startup.run("hot_arena", [] { HugePageArena::hot(); return true; });
     
     // Initialize logging
     GlobalLogger::instance().init("MarketDataHandler", StaticConfig::get_logger_endpoint());
@@ -36,9 +45,6 @@ int main(int argc, char* argv[]) {
     // Initialize HFT metrics system (includes HighResTimer initialization)
     initialize_hft_metrics();
     
-    // Set CPU affinity for market data processing (CPU 0)
-    set_thread_for_market_data();
-    
     // Set up signal handling for clean shutdown
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
@@ -47,13 +53,16 @@ int main(int argc, char* argv[]) {
         // Create and initialize handler
         g_handler = std::make_unique<MarketDataHandler>();
         
-        if (!g_handler->initialize()) {
+        if (!startup.run("initialize", [] { return g_handler->initialize(); })) {
             std::cerr << "Failed to initialize Market Data Handler" << std::endl;
             return 1;
         }
+        std::cout << "Hot arena: " << HugePageArena::hot().describe() << std::endl;
         
         // Start processing
         g_handler->start();
+        SamplingProfiler::instance().start_control_listener("MarketDataHandler");
+        startup.ready("Market Data Handler");
         
         std::cout << "Market Data Handler is running. Press Ctrl+C to stop." << std::endl;
         
@@ -61,6 +70,8 @@ int main(int argc, char* argv[]) {
         while (g_handler->is_running()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        SamplingProfiler::instance().stop_control_listener();
+        SamplingProfiler::instance().stop();
         
         std::cout << "Market Data Handler shutdown complete." << std::endl;
         
@@ -4,8 +4,13 @@
 #include "../common/hft_metrics.h"
 #include "../common/metrics_collector.h"
 #include "../common/metrics_publisher.h"
+#include "../common/cpu_topology.h"
+#include "../common/startup_timeline.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <poll.h>
 #include <random>
 #include <iostream>
 #include <sstream>
@@ -22,11 +27,9 @@ MarketDataHandler::MarketDataHandler()
     , metrics_publisher_("MarketDataHandler", ("tcp://*:" + std::to_string(StaticConfig::get_market_data_handler_metrics_port())).c_str())
     , price_generator_(std::random_device{}())
     , price_change_dist_(0.0, StaticConfig::get_price_change_volatility())
-    , session_start_time_(std::chrono::steady_clock::now())
-    , alpaca_connected_(false)
-    , alpaca_fallback_mode_(false)
-    , last_alpaca_data_(std::chrono::steady_clock::now())
-    , alpaca_messages_received_(0) {
+    , session_start_time_(std::chrono::steady_clock::now()) {
+    
+    MessageFactory::begin_market_data_batch(pending_batch_);
     
     // Initialize symbol base prices and volatilities from StaticConfig
     symbol_prices_ = StaticConfig::get_symbol_base_prices();
@@ -44,8 +47,21 @@ bool MarketDataHandler::initialize() {
     logger_.info("Initializing Market Data Handler");
     
     MetricsCollector::instance().initialize();
-    StaticConfig::load_from_file("config/hft_config.conf");
+    StaticConfig::reload();
+    // Assign symbol IDs in config order so they agree across services
+    SymbolTable::instance().preload(StaticConfig::get_symbols());
+    if (!kill_switch_->open(StaticConfig::get_kill_switch_name())) {
+        logger_.warning("Kill switch not shared; only this process can pause the feed");
+    }
+    kill_word_ = kill_switch_->word() & ~KillSwitch::HALTED;
+
+    return StartupTimeline::instance().run_parallel({
+        {"feed.source", [this] { return initialize_data_source(); }},
+        {"feed.transports", [this] { return open_transports(); }},
+    });
+}
 
+bool MarketDataHandler::open_transports() {
     // Initialize metrics publisher
     if (!metrics_publisher_.initialize()) {
         logger_.error("Failed to initialize metrics publisher");
@@ -53,50 +69,23 @@ bool MarketDataHandler::initialize() {
     }
     
     try {
-        // Initialize ZeroMQ context and sockets
-        context_ = std::make_unique<zmq::context_t>(1);
-        publisher_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
-        control_subscriber_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        
-        // Set socket options for high performance
-        int sndhwm = 1000;  // Send high water mark
-        publisher_->setsockopt(ZMQ_SNDHWM, &sndhwm, sizeof(sndhwm));
-        
-        int linger = 0;  // Don't wait for messages to be sent on close
-        publisher_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
-        
         // Bind to market data endpoint
-        const char* endpoint = StaticConfig::get_market_data_endpoint();
-        publisher_->bind(endpoint);
+        publisher_ = TransportFactory::open_publisher(
+            zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
+        logger_.info("Bound to market data endpoint: " + publisher_->get_endpoint());
         
-        logger_.info("Bound to market data endpoint: " + std::string(endpoint));
-        
-        // Subscribe to control messages
-        control_subscriber_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        int rcvhwm = 100;
-        control_subscriber_->setsockopt(ZMQ_RCVHWM, &rcvhwm, sizeof(rcvhwm));
-        std::string control_endpoint = "tcp://localhost:" + std::to_string(StaticConfig::get_control_commands_port());
-        control_subscriber_->connect(control_endpoint);
-        logger_.info("Connected to control endpoint: " + control_endpoint);
-        
-        // Initialize data sources based on configuration
-        std::string data_source = StaticConfig::get_market_data_source();
-        
-        if (data_source == "pcap") {
-            if (!initialize_pcap_reader()) {
-                logger_.warning("PCAP initialization failed, falling back to mock data");
-            }
-        } else if (data_source == "alpaca") {
-            if (!initialize_alpaca()) {
-                logger_.warning("Alpaca initialization failed, exiting");
-                return false;
-            }
-        } else if (StaticConfig::get_enable_dpdk()) {
-            if (!initialize_dpdk()) {
-                logger_.warning("DPDK initialization failed, using mock data");
-            }
+        std::string multicast_endpoint = StaticConfig::get_market_data_multicast_endpoint();
+        if (!multicast_endpoint.empty()) {
+            multicast_publisher_ = TransportFactory::open_publisher(multicast_config(multicast_endpoint));
+            logger_.info("Publishing market data to multicast group: " + multicast_publisher_->get_endpoint());
         }
         
+        // Subscribe to control messages
+        TransportConfig control_config = zmq_subscriber_config(
+            "tcp://localhost:" + std::to_string(StaticConfig::get_control_commands_port()));
+        control_config.high_water_mark = 100;
+        control_subscriber_ = TransportFactory::open_subscriber(control_config);
+        logger_.info("Connected to control endpoint: " + control_subscriber_->get_endpoint());
         return true;
         
     } catch (const zmq::error_t& e) {
@@ -108,6 +97,32 @@ bool MarketDataHandler::initialize() {
     }
 }
 
+bool MarketDataHandler::initialize_data_source() {
+    // Initialize data sources based on configuration
+    std::string data_source = StaticConfig::get_market_data_source();
+    
+    if (data_source == "pcap") {
+        if (!initialize_pcap_reader()) {
+            logger_.warning("PCAP initialization failed, falling back to mock data");
+        }
+    } else if (data_source == "alpaca") {
+        if (!initialize_alpaca()) {
+            logger_.warning("Alpaca initialization failed, exiting");
+            return false;
+        }
+    } else if (data_source == "load") {
+        if (!initialize_load_generator()) {
+            logger_.warning("Load generator initialization failed, exiting");
+            return false;
+        }
+    } else if (data_source == "multicast" || StaticConfig::get_enable_dpdk()) {
+        if (!initialize_multicast_feed()) {
+            logger_.warning("Multicast feed initialization failed, using mock data");
+        }
+    }
+    return true;
+}
+
 void MarketDataHandler::start() {
     if (running_.load()) {
         logger_.warning("Market Data Handler is already running");
@@ -123,6 +138,9 @@ void MarketDataHandler::start() {
     // Start processing threads
     processing_thread_ = std::make_unique<std::thread>(&MarketDataHandler::process_market_data, this);
     control_thread_ = std::make_unique<std::thread>(&MarketDataHandler::process_control_messages, this);
+    config_reloader_.start([this](uint64_t generation) {
+        logger_.info("Configuration reloaded (generation " + std::to_string(generation) + ")");
+    });
     
     logger_.info("Market Data Handler started");
 }
@@ -137,6 +155,7 @@ void MarketDataHandler::stop() {
     
     // Stop metrics publisher
     metrics_publisher_.stop();
+    config_reloader_.stop();
     
     if (processing_thread_ && processing_thread_->joinable()) {
         processing_thread_->join();
@@ -155,6 +174,10 @@ void MarketDataHandler::stop() {
             // Ignore close errors during shutdown
         }
     }
+    if (multicast_publisher_) {
+        multicast_publisher_->close();
+        multicast_publisher_.reset();
+    }
     if (control_subscriber_) {
         try {
             control_subscriber_->close();
@@ -173,12 +196,20 @@ bool MarketDataHandler::is_running() const {
 }
 
 void MarketDataHandler::process_market_data() {
+    if (!ThreadPlan::instance().pin_current_thread("processing")) {
+        logger_.warning("Failed to pin processing thread to its planned CPU");
+    }
     logger_.info("Market data processing thread started");
     
     auto last_stats_time = std::chrono::steady_clock::now();
     const auto stats_interval = std::chrono::seconds(StaticConfig::get_stats_interval_seconds());
     
     while (running_.load()) {
+        uint64_t kill_word = kill_switch_->word();
+        if (kill_word != kill_word_) [[unlikely]] {
+            handle_kill_switch(kill_word);
+        }
+        
         // Check if paused
         if (paused_.load()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(StaticConfig::get_poll_timeout_ms()));
@@ -194,9 +225,12 @@ void MarketDataHandler::process_market_data() {
         } else if (data_source == "alpaca") {
             // Alpaca API mode with full integration
             process_alpaca_data();
-        } else if (StaticConfig::get_enable_dpdk()) {
-            // DPDK mode
-            process_dpdk_packets();
+        } else if (load_generator_) {
+            // Synthetic load, paced on this thread
+            process_load_data();
+        } else if (multicast_feed_) {
+            // Live exchange feed, busy-polled on its own thread
+            process_multicast_data();
         } else {
             // Default to enhanced realistic mock data
             generate_realistic_mock_data();
@@ -218,17 +252,31 @@ void MarketDataHandler::process_market_data() {
     logger_.info("Market data processing thread stopped");
 }
 
+void MarketDataHandler::handle_kill_switch(uint64_t word) {
+    kill_word_ = word;
+    if (KillSwitch::halted(word)) {
+        paused_by_kill_ = paused_by_kill_ || !paused_.exchange(true);
+        kill_switch_->acknowledge(KillParty::FEED, word);
+        logger_.error("Kill switch: market data paused");
+    } else if (paused_by_kill_) {
+        paused_by_kill_ = false;
+        paused_.store(false);
+        logger_.warning("Kill switch reset; market data resumed");
+    }
+}
+
 void MarketDataHandler::process_control_messages() {
+    if (!ThreadPlan::instance().pin_current_thread("control")) {
+        logger_.warning("Failed to pin control thread to its planned CPU");
+    }
     logger_.info("Control message processing thread started");
     
     while (running_.load()) {
         try {
-            zmq::message_t message;
-            if (control_subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                if (message.size() == sizeof(ControlCommand)) {
-                    ControlCommand command;
-                    std::memcpy(&command, message.data(), sizeof(ControlCommand));
-                    
+            ControlCommand command;
+            size_t size = sizeof(command);
+            if (control_subscriber_->receive(&command, size, true)) {
+                if (size == sizeof(ControlCommand)) {
                     // Check if this command is for us
                     std::string target(command.target_service);
                     if (target == "MarketDataHandler" || target == "all") {
@@ -269,72 +317,173 @@ void MarketDataHandler::handle_control_command(const ControlCommand& command) {
             }
             break;
             
+        case ControlAction::UPDATE_CONFIG:
+            // Parsed on the reloader thread, not this one
+            logger_.info("Configuration reload requested via control command");
+            config_reloader_.request_reload();
+            break;
+            
+        case ControlAction::START_PROFILE:
+            // Handled by the SamplingProfiler's own listener
+            break;
+            
         default:
             logger_.warning("Unsupported control action: " + std::to_string(static_cast<int>(command.action)));
             break;
     }
 }
 
-bool MarketDataHandler::initialize_dpdk() {
-    // This is a proof-of-concept placeholder for DPDK initialization
-    // In a real implementation, this would:
-    // 1. Initialize DPDK EAL (Environment Abstraction Layer)
-    // 2. Configure memory pools
-    // 3. Set up network interfaces
-    // 4. Configure packet processing
+bool MarketDataHandler::initialize_multicast_feed() {
+    logger_.info("Initializing multicast market data feed");
     
-    logger_.info("DPDK initialization - proof of concept");
-    logger_.warning("DPDK functionality is not fully implemented in this phase");
+    multicast_feed_ = std::make_unique<MulticastFeed>(parse_feed_format(StaticConfig::get_pcap_format()));
+    if (!multicast_feed_->initialize(StaticConfig::get_enable_dpdk())) {
+        logger_.error("Failed to initialize multicast feed");
+        multicast_feed_.reset();
+        return false;
+    }
     
-    // For now, return false to indicate DPDK is not available
-    // This will cause the system to use mock data
-    return false;
+    multicast_feed_->set_data_callback([this](const MarketData& data) {
+        publish_market_data(data);
+        HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PROCESSED);
+        throughput_tracker_.increment();
+    });
+    if (StaticConfig::get_batch_packet_quotes()) {
+        batch_packets_ = true;
+        multicast_feed_->set_packet_end_callback([this]() { flush_market_data_batch(); });
+    }
+    
+    logger_.info(std::string("Multicast feed initialized (") + multicast_feed_->get_source_name() + ")");
+    return true;
 }
 
-bool MarketDataHandler::process_dpdk_packets() {
-    HFT_RDTSC_TIMER(hft::metrics::MD_TOTAL_LATENCY);
-    
-    // This is a proof-of-concept placeholder for DPDK packet processing
-    // In a real implementation, this would:
-    // 1. Poll network interface for new packets
-    // 2. Parse raw ethernet/IP/UDP packets
-    // 3. Extract market data from packet payload
-    // 4. Convert to internal MarketData format
+void MarketDataHandler::process_multicast_data() {
+    multicast_feed_->start();
+    
+    // The feed runs on its own threads; this one waits on the kill switch's
+    // wake socket, so a kill doesn't wait out the 100ms
+    pollfd kill_wake{kill_switch_->wake_fd(KillParty::FEED), POLLIN, 0};
+    auto last_stats_log = std::chrono::steady_clock::now();
+    while (running_.load() && !paused_.load() && !kill_pending()) {
+        if (kill_wake.fd >= 0) {
+            if (::poll(&kill_wake, 1, 100) > 0) kill_switch_->drain_wake(KillParty::FEED);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        HFT_GAUGE_VALUE(hft::metrics::MD_GAPS, multicast_feed_->get_gaps());
+        HFT_GAUGE_VALUE(hft::metrics::MD_MESSAGES_LOST, multicast_feed_->get_messages_lost());
+        HFT_GAUGE_VALUE(hft::metrics::MD_LINE_DUPLICATES, multicast_feed_->get_duplicates());
+        
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_stats_log >= std::chrono::seconds(10)) {
+            logger_.info("Feed Stats - A: " + std::to_string(multicast_feed_->get_packets_received(0)) +
+                        ", B: " + std::to_string(multicast_feed_->get_packets_received(1)) +
+                        ", Delivered: " + std::to_string(multicast_feed_->get_packets_delivered()) +
+                        ", Gaps: " + std::to_string(multicast_feed_->get_gaps()) +
+                        ", Lost: " + std::to_string(multicast_feed_->get_messages_lost()) +
+                        ", Parse errors: " + std::to_string(multicast_feed_->get_parse_errors()));
+            last_stats_log = now;
+        }
+    }
     
-    // For now, return false to indicate no packets processed
-    return false;
+    multicast_feed_->stop();
 }
 
 void MarketDataHandler::publish_market_data(const MarketData& data) {
+    if (!SymbolTable::instance().is_preloaded(data.symbol_id)) {
+        // Subscribers cannot map this ID back to a name; keep the name on
+        // the wire, after anything queued ahead of it
+        flush_market_data_batch();
+        send_market_data(data);
+        return;
+    }
+    
+    if (!MessageFactory::append_quote(pending_batch_, data)) {
+        // More quotes than a frame holds: send what we have, keep going
+        flush_market_data_batch();
+        MessageFactory::append_quote(pending_batch_, data);
+    }
+    if (!batch_packets_) {
+        flush_market_data_batch();
+    }
+}
+
+void MarketDataHandler::flush_market_data_batch() {
+    if (pending_batch_.count == 0) {
+        return;
+    }
+    
     HFT_RDTSC_TIMER(hft::metrics::MD_PUBLISH_LATENCY);
+    pending_batch_.trace.stamp(TraceStage::FEED_PUBLISH);
+    size_t size = pending_batch_.wire_size();
+    uint16_t count = pending_batch_.count;
+    bool sent = publisher_->publish(&pending_batch_, size);
+    if (multicast_publisher_) {
+        publish_multicast_batch(pending_batch_);
+    }
+    MessageFactory::begin_market_data_batch(pending_batch_);
+    if (!sent) {
+        MetricsCollector::instance().increment_counter(
+            HFT_METRIC_ID(hft::metrics::MD_MESSAGES_DROPPED, MetricType::COUNTER), count);
+        return;
+    }
     
-    try {
-        zmq::message_t message(sizeof(MarketData));
-        std::memcpy(message.data(), &data, sizeof(MarketData));
-        logger_.info("Publishing market data: " + std::string(data.symbol) + " " + std::to_string(data.bid_price) + " " + std::to_string(data.ask_price) + " " + std::to_string(data.bid_size) + " " + std::to_string(data.ask_size) + " " + std::to_string(data.last_price) + " " + std::to_string(data.last_size));
-        {
-            publisher_->send(message, zmq::send_flags::dontwait);
-        }
-        
-        messages_processed_++;
-        bytes_processed_ += sizeof(MarketData);
-        
-        // Update HFT metrics
-        HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PUBLISHED);
-        HFT_GAUGE_VALUE(hft::metrics::MD_BYTES_RECEIVED, bytes_processed_.load());
-        
-    } catch (const zmq::error_t& e) {
-        if (e.num() != EAGAIN) {  // EAGAIN is expected with dontwait
-            logger_.error("Failed to publish market data: " + std::string(e.what()));
-            HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_DROPPED);
-        }
+    messages_processed_ += count;
+    bytes_processed_ += size;
+    MetricsCollector::instance().increment_counter(
+        HFT_METRIC_ID(hft::metrics::MD_MESSAGES_PUBLISHED, MetricType::COUNTER), count);
+    HFT_COMPONENT_COUNTER(hft::metrics::BATCHES_PUBLISHED);
+    HFT_GAUGE_VALUE(hft::metrics::MD_BYTES_RECEIVED, bytes_processed_.load());
+}
+
+void MarketDataHandler::publish_multicast_batch(const MarketDataBatch& batch) {
+    if (batch.wire_size() <= rmcast::MAX_PAYLOAD) {
+        multicast_publisher_->publish(&batch, batch.wire_size());
+        return;
+    }
+    
+    // A full batch is over the MTU; IP fragments would make one lost
+    // fragment cost the whole frame, so send it as several smaller ones
+    constexpr size_t per_frame = (rmcast::MAX_PAYLOAD - offsetof(MarketDataBatch, records)) / sizeof(QuoteRecord);
+    std::memcpy(&multicast_batch_, &batch, offsetof(MarketDataBatch, records));
+    for (size_t first = 0; first < batch.count; first += per_frame) {
+        size_t count = std::min(per_frame, batch.count - first);
+        std::memcpy(multicast_batch_.records, batch.records + first, count * sizeof(QuoteRecord));
+        multicast_batch_.count = static_cast<uint16_t>(count);
+        multicast_publisher_->publish(&multicast_batch_, multicast_batch_.wire_size());
     }
 }
 
+void MarketDataHandler::send_market_data(const MarketData& data) {
+    HFT_RDTSC_TIMER(hft::metrics::MD_PUBLISH_LATENCY);
+    
+    MarketData stamped = data;
+    stamped.trace.stamp(TraceStage::FEED_PUBLISH);
+    HFT_LOGF(logger_, LogLevel::INFO, "Publishing market data: {} {} {} {} {} {} {}", data.symbol,
+             to_double_price(data.bid_price), to_double_price(data.ask_price), data.bid_size, data.ask_size,
+             to_double_price(data.last_price), data.last_size);
+    if (multicast_publisher_) {
+        multicast_publisher_->publish(&stamped, sizeof(MarketData));
+    }
+    if (!publisher_->publish(&stamped, sizeof(MarketData))) {
+        HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_DROPPED);
+        return;
+    }
+    
+    messages_processed_++;
+    bytes_processed_ += sizeof(MarketData);
+    
+    // Update HFT metrics
+    HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PUBLISHED);
+    HFT_GAUGE_VALUE(hft::metrics::MD_BYTES_RECEIVED, bytes_processed_.load());
+}
+
 
 
 void MarketDataHandler::generate_realistic_mock_data() {
     HFT_RDTSC_TIMER(hft::metrics::MD_TOTAL_LATENCY);
+    HighResTimer::ticks_t receive_ticks = HighResTimer::get_ticks();
     
     // Select symbol in round-robin fashion for better distribution
     static std::vector<std::string> symbols;
@@ -403,6 +552,8 @@ void MarketDataHandler::generate_realistic_mock_data() {
     MarketData data = MessageFactory::create_market_data(
         symbol, bid_price, ask_price, bid_size, ask_size, last_price, last_size
     );
+    data.trace.tsc[static_cast<size_t>(TraceStage::FEED_RECEIVE)] = receive_ticks;
+    data.trace.stamp(TraceStage::FEED_PARSE);
     
     // Track metrics
     HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PROCESSED);
@@ -411,6 +562,69 @@ void MarketDataHandler::generate_realistic_mock_data() {
     publish_market_data(data);
 }
 
+bool MarketDataHandler::initialize_load_generator() {
+    LoadProfile profile;
+    if (!parse_load_profile(StaticConfig::get_load_profile(), profile)) {
+        logger_.error("Unknown load profile: " + StaticConfig::get_load_profile());
+        return false;
+    }
+    
+    // StaticConfig has already padded the symbol list to load_symbols
+    const std::vector<std::string>& symbols = StaticConfig::get_symbols();
+    if (symbols.empty() || StaticConfig::get_load_rate() <= 0) {
+        logger_.error("Load generator needs symbols and a positive market_data.load_rate");
+        return false;
+    }
+    
+    load_generator_ = std::make_unique<LoadGenerator>(symbols, StaticConfig::get_load_rate(), profile,
+                                                      StaticConfig::get_load_seed());
+    load_quotes_.resize(MarketDataBatch::MAX_RECORDS * 32);
+    batch_packets_ = true;
+    
+    logger_.info("Load generator: " + std::to_string(symbols.size()) + " symbols at " +
+                 std::to_string(StaticConfig::get_load_rate()) + " quotes/s, profile " +
+                 StaticConfig::get_load_profile());
+    return true;
+}
+
+void MarketDataHandler::process_load_data() {
+    auto start = std::chrono::steady_clock::now();
+    auto last_stats_log = start;
+    uint64_t last_generated = load_generator_->generated();
+    // After a pause the run picks up where it stopped, profile and all
+    uint64_t start_offset = load_generator_->elapsed_ns();
+    
+    while (running_.load() && !paused_.load() && !kill_pending()) {
+        auto now = std::chrono::steady_clock::now();
+        uint64_t elapsed_ns = start_offset + static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+        
+        size_t count = load_generator_->generate(elapsed_ns, load_quotes_.data(), load_quotes_.size());
+        for (size_t i = 0; i < count; ++i) {
+            publish_market_data(load_quotes_[i]);
+        }
+        flush_market_data_batch();
+        if (count > 0) {
+            MetricsCollector::instance().increment_counter(
+                HFT_METRIC_ID(hft::metrics::MD_MESSAGES_PROCESSED, MetricType::COUNTER), count);
+            throughput_tracker_.increment(count);
+        } else {
+            std::this_thread::yield();
+        }
+        
+        if (now - last_stats_log >= std::chrono::seconds(10)) {
+            double seconds = std::chrono::duration<double>(now - last_stats_log).count();
+            uint64_t generated = load_generator_->generated();
+            logger_.info("Load Stats - target: " + std::to_string(static_cast<uint64_t>(load_generator_->rate_at(elapsed_ns))) +
+                        "/s, sent: " + std::to_string(static_cast<uint64_t>((generated - last_generated) / seconds)) +
+                        "/s, shortfall: " + std::to_string(load_generator_->shortfall()));
+            HFT_GAUGE_VALUE(hft::metrics::MD_MESSAGES_LOST, load_generator_->shortfall());
+            last_generated = generated;
+            last_stats_log = now;
+        }
+    }
+}
+
 double MarketDataHandler::get_market_session_volatility() const {
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::minutes>(now - session_start_time_).count();
@@ -451,17 +665,7 @@ bool MarketDataHandler::initialize_pcap_reader() {
     std::string format_str = StaticConfig::get_pcap_format();
     bool use_dpdk = StaticConfig::get_enable_dpdk();
     
-    // Convert format string to enum
-    FeedFormat format = FeedFormat::GENERIC_CSV;
-    if (format_str == "nasdaq_itch") {
-        format = FeedFormat::NASDAQ_ITCH_5_0;
-    } else if (format_str == "nyse_pillar") {
-        format = FeedFormat::NYSE_PILLAR;
-    } else if (format_str == "iex_tops") {
-        format = FeedFormat::IEX_TOPS;
-    } else if (format_str == "fix") {
-        format = FeedFormat::FIX_PROTOCOL;
-    }
+    FeedFormat format = parse_feed_format(format_str);
     
     // Create PCAP reader
     pcap_reader_ = std::make_unique<PCAPReader>(pcap_file, format);
@@ -476,7 +680,7 @@ bool MarketDataHandler::initialize_pcap_reader() {
     pcap_reader_->set_data_callback([this](const MarketData& data) {
         // Update internal price tracking for realistic continuity
         std::string symbol(data.symbol);
-        double mid_price = (data.bid_price + data.ask_price) / 2.0;
+        double mid_price = to_double_price(data.bid_price + data.ask_price) / 2.0;
         symbol_prices_[symbol] = mid_price;
         
         // Publish the market data
@@ -487,6 +691,11 @@ bool MarketDataHandler::initialize_pcap_reader() {
         throughput_tracker_.increment();
     });
     
+    if (StaticConfig::get_batch_packet_quotes()) {
+        batch_packets_ = true;
+        pcap_reader_->set_packet_end_callback([this]() { flush_market_data_batch(); });
+    }
+    
     // Configure replay parameters
     double replay_speed = StaticConfig::get_replay_speed();
     bool loop_replay = StaticConfig::get_loop_replay();
@@ -546,97 +755,54 @@ bool MarketDataHandler::initialize_alpaca() {
         return false;
     }
     
-    // Create Alpaca client
-    alpaca_client_ = std::make_unique<AlpacaMarketData>();
-    
-    // Initialize with credentials and WebSocket configuration
-    bool paper_trading = StaticConfig::get_alpaca_paper_trading();
-    std::string websocket_url = StaticConfig::get_alpaca_websocket_url();
-    std::string websocket_host = StaticConfig::get_alpaca_websocket_host();
+    // One client per connection, the symbol list dealt across them
+    alpaca_streams_ = std::make_unique<AlpacaStreamSet>();
+    size_t connections = static_cast<size_t>(std::max(1, StaticConfig::get_alpaca_stream_connections()));
+    uint64_t merge_window_ns = static_cast<uint64_t>(std::max(0, StaticConfig::get_alpaca_merge_window_us())) * 1000;
     
-    if (!alpaca_client_->initialize(api_key, secret_key, websocket_url, websocket_host, paper_trading)) {
+    if (!alpaca_streams_->initialize(api_key, secret_key, StaticConfig::get_alpaca_websocket_url(),
+                                     StaticConfig::get_alpaca_websocket_host(),
+                                     StaticConfig::get_alpaca_paper_trading(), StaticConfig::get_symbols(),
+                                     connections, merge_window_ns)) {
         logger_.error("Failed to initialize Alpaca client");
-        alpaca_client_.reset();
+        alpaca_streams_.reset();
         return false;
     }
     
-    // Set up market data callback
-    alpaca_client_->set_data_callback([this](const MarketData& data) {
-        // Update last data time
-        last_alpaca_data_ = std::chrono::steady_clock::now();
-        alpaca_messages_received_++;
-        
-        // Publish market data through existing infrastructure
-        publish_market_data(data);
-        
-        // Update HFT metrics
-        HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PROCESSED);
-        throughput_tracker_.increment();
-    });
+    // Each poll's merged quotes leave as one bus frame
+    batch_packets_ = true;
     
     logger_.info("Alpaca client initialized successfully");
     return true;
 }
 
 void MarketDataHandler::process_alpaca_data() {
-    // Check connection health
-    auto now = std::chrono::steady_clock::now();
-    auto time_since_data = now - last_alpaca_data_;
-    
-    if (alpaca_connected_.load() && time_since_data > std::chrono::minutes(1)) {
-        logger_.warning("No Alpaca data received for 1 minute, checking connection");
-        handle_alpaca_connection_error();
-    }
-    
-    // Try to connect if not connected - simplified
-    if (!alpaca_connected_.load()) {
-        logger_.info("Attempting to connect to Alpaca");
-        
-        // Start processing FIRST (sets running_ = true)
-        alpaca_client_->start();
+    // Connections open and reopen on the stream set's supervisor; this
+    // thread only merges
+    alpaca_streams_->start();
+    
+    auto last_stats_log = std::chrono::steady_clock::now();
+    const auto idle_sleep = std::chrono::microseconds(StaticConfig::get_processing_sleep_microseconds());
+    while (running_.load() && !paused_.load() && !kill_pending()) {
+        size_t merged = alpaca_streams_->poll([this](const MarketData& data) {
+            publish_market_data(data);
+            HFT_COMPONENT_COUNTER(hft::metrics::MD_MESSAGES_PROCESSED);
+            throughput_tracker_.increment();
+        });
+        flush_market_data_batch();
+        if (merged == 0) {
+            std::this_thread::sleep_for(idle_sleep);
+        }
         
-        if (alpaca_client_->connect()) {
-            logger_.info("Connected to Alpaca successfully");
-            alpaca_connected_ = true;
-            
-            // Set up subscription
-            setup_alpaca_subscription();
-            
-        } else {
-            logger_.error("Failed to connect to Alpaca");
-            // Stop if connection failed
-            alpaca_client_->stop();
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_stats_log >= std::chrono::seconds(10)) {
+            HFT_GAUGE_VALUE(hft::metrics::MD_MESSAGES_LOST, alpaca_streams_->dropped());
+            alpaca_streams_->log_status();
+            last_stats_log = now;
         }
     }
-    return;
-}
-
-void MarketDataHandler::setup_alpaca_subscription() {
-    if (!alpaca_client_ || !alpaca_connected_.load()) {
-        return;
-    }
     
-    // Get symbols from configuration - simplified
-    const std::vector<std::string>& symbols = StaticConfig::get_symbols();
-    
-    logger_.info("Setting up Alpaca subscription for " + std::to_string(symbols.size()) + " symbols");
-    
-    // Subscribe to all symbols at once - simplified
-    if (!alpaca_client_->subscribe(symbols)) {
-        logger_.error("Failed to subscribe to symbols");
-    } else {
-        logger_.info("Subscribed to " + std::to_string(symbols.size()) + " symbols");
-    }
-}
-
-void MarketDataHandler::handle_alpaca_connection_error() {
-    logger_.warning("Handling Alpaca connection error");
-    
-    alpaca_connected_ = false;
-    
-    if (alpaca_client_) {
-        alpaca_client_->stop();
-    }
+    alpaca_streams_->stop();
 }
 
 } // namespace hft
\ No newline at end of file
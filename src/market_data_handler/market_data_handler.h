@@ -3,11 +3,16 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/config_reloader.h"
 #include "../common/hft_metrics.h"
 #include "../common/metrics_publisher.h"
+#include "../common/kill_switch.h"
 #include "pcap_reader.h"
-#include "alpaca_market_data.h"
-#include <zmq.hpp>
+#include "multicast_feed.h"
+#include "alpaca_stream_set.h"
+#include "load_generator.h"
+#include "../common/zmq_transport.h"
+#include "../common/multicast_transport.h"
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -35,21 +40,39 @@ public:
 
 private:
     
-    // ZeroMQ context and sockets
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> publisher_;
-    std::unique_ptr<zmq::socket_t> control_subscriber_;
+    // Transports on the process ZeroMQ context
+    std::unique_ptr<IMessagePublisher> publisher_;
+    std::unique_ptr<IMessageSubscriber> control_subscriber_;
+    
+    // The same stream to other hosts over reliable multicast, when
+    // market_data.multicast_endpoint is set
+    std::unique_ptr<IMessagePublisher> multicast_publisher_;
     
     // Processing control
     std::atomic<bool> running_;
     std::atomic<bool> paused_;
     std::unique_ptr<std::thread> processing_thread_;
     std::unique_ptr<std::thread> control_thread_;
+    ConfigReloader config_reloader_;
+    
+    // Emergency stop: a new word ends the source loop, and the processing
+    // thread pauses (or resumes, if the kill had paused it)
+    KillSwitch* kill_switch_ = &KillSwitch::instance();
+    uint64_t kill_word_ = 0;        // Processing thread only
+    bool paused_by_kill_ = false;
+    bool kill_pending() const { return kill_switch_->word() != kill_word_; }
+    void handle_kill_switch(uint64_t word);
     
     // Statistics
     std::atomic<uint64_t> messages_processed_;
     std::atomic<uint64_t> bytes_processed_;
     
+    // Quote records for the next bus frame, owned by whichever thread runs
+    // the source. Packet-based sources fill it per packet when batch_packets_
+    // is set; otherwise every quote goes out in its own frame.
+    bool batch_packets_ = false;
+    MarketDataBatch pending_batch_;
+    
     // Main processing loop
     void process_market_data();
     
@@ -57,9 +80,14 @@ private:
     void process_control_messages();
     void handle_control_command(const ControlCommand& command);
     
-    // DPDK-specific functions (proof-of-concept)
-    bool initialize_dpdk();
-    bool process_dpdk_packets();
+    // initialize()'s two halves, run side by side: a source can be a
+    // network handshake (Alpaca) or a file scan (PCAP)
+    bool open_transports();
+    bool initialize_data_source();
+    
+    // Live multicast feed (DPDK or kernel sockets)
+    bool initialize_multicast_feed();
+    void process_multicast_data();
     
     // PCAP file processing
     bool initialize_pcap_reader();
@@ -68,8 +96,10 @@ private:
     // Alpaca real-time data processing
     bool initialize_alpaca();
     void process_alpaca_data();
-    void setup_alpaca_subscription();
-    void handle_alpaca_connection_error();
+    
+    // Synthetic load for stress-testing downstream services
+    bool initialize_load_generator();
+    void process_load_data();
     
     // Mock data generation for testing
     void generate_mock_data();
@@ -81,8 +111,17 @@ private:
     double get_market_session_volatility() const;
     double get_symbol_base_price(const std::string& symbol) const;
     
-    // Publish market data message
+    // Publish a quote as a QuoteRecord; while batching, held until flush_market_data_batch().
+    // Quotes for symbols outside the preloaded list go out as MarketData (send_market_data).
     void publish_market_data(const MarketData& data);
+    void send_market_data(const MarketData& data);
+    
+    // Sends the held quote records as one MarketDataBatch frame
+    void flush_market_data_batch();
+    
+    // A batch to the multicast group, split so each frame fits one datagram
+    void publish_multicast_batch(const MarketDataBatch& batch);
+    MarketDataBatch multicast_batch_;
     
     // Performance monitoring
     void log_statistics();
@@ -103,14 +142,15 @@ private:
     // PCAP reader for market data replay
     std::unique_ptr<PCAPReader> pcap_reader_;
     
-    // Alpaca real-time data integration
-    std::unique_ptr<AlpacaMarketData> alpaca_client_;
-
-    // Alpaca connection state
-    std::atomic<bool> alpaca_connected_;
-    std::atomic<bool> alpaca_fallback_mode_;
-    std::chrono::steady_clock::time_point last_alpaca_data_;
-    std::atomic<uint64_t> alpaca_messages_received_;
+    // Live exchange feed
+    std::unique_ptr<MulticastFeed> multicast_feed_;
+    
+    // Alpaca real-time data: one or more websocket connections, merged here
+    std::unique_ptr<AlpacaStreamSet> alpaca_streams_;
+    
+    // Synthetic load source and the quotes of its current pass
+    std::unique_ptr<LoadGenerator> load_generator_;
+    std::vector<MarketData> load_quotes_;
 };
 
 } // namespace hft
\ No newline at end of file
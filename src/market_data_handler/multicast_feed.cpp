@@ -0,0 +1,463 @@
+#include "multicast_feed.h"
+#include "../common/cpu_topology.h"
+#include "../common/static_config.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <netinet/in.h>
+#include <sstream>
+#include <unistd.h>
+
+#ifdef DPDK_ENABLED
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+constexpr int SOCKET_RECEIVE_BUFFER = 16 << 20;
+constexpr int SOCKET_BUSY_POLL_US = 50;
+
+std::string describe_lines(const std::vector<FeedLineConfig>& lines) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (i) oss << ", ";
+        oss << static_cast<char>('A' + i) << "=" << lines[i].group << ":" << lines[i].port;
+    }
+    return oss.str();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SocketRxSource
+
+SocketRxSource::SocketRxSource(size_t max_burst)
+    : max_burst_(std::max<size_t>(1, max_burst))
+    , buffers_(max_burst_ * SLOT_SIZE)
+    , iovecs_(max_burst_)
+    , messages_(max_burst_) {
+    for (size_t i = 0; i < max_burst_; ++i) {
+        iovecs_[i].iov_base = buffers_.data() + i * SLOT_SIZE;
+        iovecs_[i].iov_len = SLOT_SIZE;
+        std::memset(&messages_[i], 0, sizeof(messages_[i]));
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+SocketRxSource::~SocketRxSource() {
+    close_all();
+}
+
+bool SocketRxSource::open(const std::vector<FeedLineConfig>& lines, const std::string& interface_address) {
+    close_all();
+
+    struct in_addr interface;
+    if (inet_pton(AF_INET, interface_address.c_str(), &interface) != 1) {
+        std::cerr << "[SocketRxSource] Invalid interface address: " << interface_address << std::endl;
+        return false;
+    }
+
+    for (const FeedLineConfig& line : lines) {
+        struct in_addr group;
+        if (inet_pton(AF_INET, line.group.c_str(), &group) != 1) {
+            std::cerr << "[SocketRxSource] Invalid group address: " << line.group << std::endl;
+            close_all();
+            return false;
+        }
+
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            std::cerr << "[SocketRxSource] socket failed: " << std::strerror(errno) << std::endl;
+            close_all();
+            return false;
+        }
+        sockets_.push_back(fd);
+
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        // Both are best effort: capped by net.core.rmem_max, and busy
+        // polling above net.core.busy_read needs CAP_NET_ADMIN
+        int receive_buffer = SOCKET_RECEIVE_BUFFER;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+#ifdef SO_BUSY_POLL
+        int busy_poll = SOCKET_BUSY_POLL_US;
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll));
+#endif
+
+        // Binding to the group address keeps other groups on the port out
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(line.port);
+        address.sin_addr = group;
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cerr << "[SocketRxSource] bind " << line.group << ":" << line.port << " failed: "
+                      << std::strerror(errno) << std::endl;
+            close_all();
+            return false;
+        }
+
+        if (IN_MULTICAST(ntohl(group.s_addr))) {
+            struct ip_mreq membership{};
+            membership.imr_multiaddr = group;
+            membership.imr_interface = interface;
+            if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+                std::cerr << "[SocketRxSource] Joining " << line.group << " failed: " << std::strerror(errno)
+                          << std::endl;
+                close_all();
+                return false;
+            }
+        }
+    }
+    return !sockets_.empty();
+}
+
+size_t SocketRxSource::poll(FeedPacket* out, size_t max) {
+    max = std::min(max, max_burst_);
+    size_t slots_used = 0;
+    size_t count = 0;
+    HighResTimer::ticks_t receive_ticks = 0;
+    uint64_t timestamp_ns = 0;
+
+    for (size_t i = 0; i < sockets_.size() && slots_used < max; ++i) {
+        size_t line = (next_line_ + i) % sockets_.size();
+        int received = recvmmsg(sockets_[line], &messages_[slots_used], static_cast<unsigned>(max - slots_used),
+                                MSG_DONTWAIT, nullptr);
+        if (received <= 0) continue;
+
+        if (timestamp_ns == 0) {
+            receive_ticks = HighResTimer::get_ticks();
+            timestamp_ns = HighResTimer::ticks_to_wall_nanoseconds(receive_ticks);
+        }
+        for (int j = 0; j < received; ++j) {
+            const struct mmsghdr& message = messages_[slots_used + j];
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                truncated_datagrams_++;
+                continue;
+            }
+            out[count++] = FeedPacket{buffers_.data() + (slots_used + j) * SLOT_SIZE, message.msg_len,
+                                      static_cast<uint8_t>(line), timestamp_ns, receive_ticks};
+        }
+        slots_used += static_cast<size_t>(received);
+    }
+    if (!sockets_.empty()) {
+        next_line_ = (next_line_ + 1) % sockets_.size();
+    }
+    return count;
+}
+
+uint16_t SocketRxSource::bound_port(size_t line) const {
+    struct sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (line >= sockets_.size() ||
+        getsockname(sockets_[line], reinterpret_cast<struct sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+void SocketRxSource::close_all() {
+    for (int fd : sockets_) {
+        ::close(fd);
+    }
+    sockets_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// DpdkRxSource
+
+#ifdef DPDK_ENABLED
+DpdkRxSource::DpdkRxSource(uint16_t port_id, const std::string& eal_args, size_t max_burst)
+    : port_id_(port_id)
+    , eal_args_(eal_args)
+    , max_burst_(std::max<size_t>(1, max_burst))
+    , held_(max_burst_, nullptr) {}
+
+DpdkRxSource::~DpdkRxSource() {
+    if (held_count_ > 0) {
+        rte_pktmbuf_free_bulk(held_.data(), static_cast<unsigned>(held_count_));
+    }
+    if (started_) {
+        rte_eth_dev_stop(port_id_);
+    }
+}
+
+bool DpdkRxSource::open(const std::vector<FeedLineConfig>& lines, const std::string&) {
+    static bool eal_initialized = false;
+    if (!eal_initialized) {
+        std::vector<std::string> args{"market_data_handler"};
+        std::istringstream iss(eal_args_);
+        for (std::string arg; iss >> arg;) args.push_back(arg);
+        std::vector<char*> argv;
+        for (std::string& arg : args) argv.push_back(arg.data());
+        if (rte_eal_init(static_cast<int>(argv.size()), argv.data()) < 0) {
+            std::cerr << "[DpdkRxSource] EAL initialization failed: " << rte_strerror(rte_errno) << std::endl;
+            return false;
+        }
+        eal_initialized = true;
+    }
+
+    if (!rte_eth_dev_is_valid_port(port_id_)) {
+        std::cerr << "[DpdkRxSource] No DPDK port " << port_id_ << std::endl;
+        return false;
+    }
+    int socket_id = rte_eth_dev_socket_id(port_id_);
+
+    pool_ = rte_pktmbuf_pool_create("feed_rx_pool", MBUF_COUNT, MBUF_CACHE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, socket_id);
+    if (!pool_) {
+        std::cerr << "[DpdkRxSource] mbuf pool creation failed: " << rte_strerror(rte_errno) << std::endl;
+        return false;
+    }
+
+    // One RX queue polled by the feed thread; the TX queue only satisfies
+    // PMDs that refuse to start without one
+    struct rte_eth_conf conf{};
+    uint16_t rx_descriptors = RX_DESCRIPTORS;
+    uint16_t tx_descriptors = 512;
+    if (rte_eth_dev_configure(port_id_, 1, 1, &conf) != 0 ||
+        rte_eth_dev_adjust_nb_rx_tx_desc(port_id_, &rx_descriptors, &tx_descriptors) != 0 ||
+        rte_eth_rx_queue_setup(port_id_, 0, rx_descriptors, socket_id, nullptr, pool_) != 0 ||
+        rte_eth_tx_queue_setup(port_id_, 0, tx_descriptors, socket_id, nullptr) != 0) {
+        std::cerr << "[DpdkRxSource] Port " << port_id_ << " configuration failed" << std::endl;
+        return false;
+    }
+    if (rte_eth_dev_start(port_id_) != 0) {
+        std::cerr << "[DpdkRxSource] Port " << port_id_ << " failed to start" << std::endl;
+        return false;
+    }
+    started_ = true;
+    rte_eth_allmulticast_enable(port_id_);
+
+    line_addresses_.clear();
+    line_ports_.clear();
+    for (const FeedLineConfig& line : lines) {
+        struct in_addr group;
+        if (inet_pton(AF_INET, line.group.c_str(), &group) != 1) {
+            std::cerr << "[DpdkRxSource] Invalid group address: " << line.group << std::endl;
+            return false;
+        }
+        line_addresses_.push_back(group.s_addr);
+        line_ports_.push_back(htons(line.port));
+    }
+    return true;
+}
+
+size_t DpdkRxSource::poll(FeedPacket* out, size_t max) {
+    if (held_count_ > 0) {
+        rte_pktmbuf_free_bulk(held_.data(), static_cast<unsigned>(held_count_));
+        held_count_ = 0;
+    }
+
+    held_count_ = rte_eth_rx_burst(port_id_, 0, held_.data(), static_cast<uint16_t>(std::min(max, max_burst_)));
+    if (held_count_ == 0) {
+        return 0;
+    }
+    HighResTimer::ticks_t receive_ticks = HighResTimer::get_ticks();
+    uint64_t timestamp_ns = HighResTimer::ticks_to_wall_nanoseconds(receive_ticks);
+
+    size_t count = 0;
+    for (size_t i = 0; i < held_count_; ++i) {
+        const uint8_t* frame = rte_pktmbuf_mtod(held_[i], const uint8_t*);
+        size_t length = rte_pktmbuf_data_len(held_[i]);
+
+        // Ethernet (optionally one VLAN tag), IPv4, UDP
+        size_t offset = ETH_HEADER_SIZE;
+        if (length < offset) continue;
+        uint16_t ether_type = static_cast<uint16_t>((frame[12] << 8) | frame[13]);
+        if (ether_type == 0x8100 && length >= offset + 4) {
+            ether_type = static_cast<uint16_t>((frame[16] << 8) | frame[17]);
+            offset += 4;
+        }
+        if (ether_type != 0x0800 || length < offset + IP_HEADER_SIZE) continue;
+        const uint8_t* ip = frame + offset;
+        size_t ip_header_length = (ip[0] & 0x0F) * 4u;
+        if (ip[9] != 17 || ip_header_length < IP_HEADER_SIZE ||
+            length < offset + ip_header_length + UDP_HEADER_SIZE) continue;
+
+        uint32_t destination;
+        uint16_t destination_port;
+        std::memcpy(&destination, ip + 16, sizeof(destination));
+        const uint8_t* udp = ip + ip_header_length;
+        std::memcpy(&destination_port, udp + 2, sizeof(destination_port));
+        int line = match_line(destination, destination_port);
+        if (line < 0) continue;
+
+        size_t udp_length = static_cast<size_t>((udp[4] << 8) | udp[5]);
+        const uint8_t* payload = udp + UDP_HEADER_SIZE;
+        if (udp_length < UDP_HEADER_SIZE || payload + (udp_length - UDP_HEADER_SIZE) > frame + length) continue;
+
+        out[count++] = FeedPacket{payload, static_cast<uint32_t>(udp_length - UDP_HEADER_SIZE),
+                                  static_cast<uint8_t>(line), timestamp_ns, receive_ticks};
+    }
+    return count;
+}
+
+int DpdkRxSource::match_line(uint32_t address, uint16_t port) const {
+    for (size_t i = 0; i < line_addresses_.size(); ++i) {
+        if (line_addresses_[i] == address && line_ports_[i] == port) return static_cast<int>(i);
+    }
+    return -1;
+}
+#endif // DPDK_ENABLED
+
+// ---------------------------------------------------------------------------
+// MulticastFeed
+
+MulticastFeed::MulticastFeed(FeedFormat format)
+    : format_(format)
+    , parser_(std::make_unique<PCAPReader>("", format))
+    , logger_("MulticastFeed", StaticConfig::get_logger_endpoint()) {}
+
+MulticastFeed::~MulticastFeed() {
+    stop();
+}
+
+bool MulticastFeed::initialize(bool use_dpdk) {
+    std::vector<FeedLineConfig> lines;
+    lines.push_back({StaticConfig::get_feed_a_group(), static_cast<uint16_t>(StaticConfig::get_feed_a_port())});
+    if (!StaticConfig::get_feed_b_group().empty()) {
+        lines.push_back({StaticConfig::get_feed_b_group(), static_cast<uint16_t>(StaticConfig::get_feed_b_port())});
+    }
+    rx_burst_ = static_cast<size_t>(std::max(1, StaticConfig::get_feed_rx_burst()));
+
+    std::unique_ptr<FeedRxSource> source;
+#ifdef DPDK_ENABLED
+    if (use_dpdk) {
+        source = std::make_unique<DpdkRxSource>(static_cast<uint16_t>(StaticConfig::get_dpdk_port_id()),
+                                                StaticConfig::get_dpdk_eal_args(), rx_burst_);
+    }
+#else
+    if (use_dpdk) {
+        logger_.warning("DPDK not available, receiving through kernel sockets");
+    }
+#endif
+    if (!source) {
+        source = std::make_unique<SocketRxSource>(rx_burst_);
+    }
+    return initialize(std::move(source), lines, StaticConfig::get_feed_interface());
+}
+
+bool MulticastFeed::initialize(std::unique_ptr<FeedRxSource> source, const std::vector<FeedLineConfig>& lines,
+                               const std::string& interface_address) {
+    if (lines.empty() || lines.size() > FeedArbitrator::MAX_LINES) {
+        logger_.error("Multicast feed needs one or two lines");
+        return false;
+    }
+    if (!source->open(lines, interface_address)) {
+        logger_.error(std::string("Failed to open ") + source->name() + " feed source for " + describe_lines(lines));
+        return false;
+    }
+    source_ = std::move(source);
+
+    // MoldUDP64 framing gives the sequence numbers to arbitrate on
+    if (format_ == FeedFormat::NASDAQ_ITCH_5_0) {
+        arbitrator_ = std::make_unique<FeedArbitrator>(
+            StaticConfig::get_feed_hold_slots(), static_cast<uint64_t>(StaticConfig::get_feed_gap_timeout_us()) * 1000ULL);
+        arbitrator_->set_deliver_callback([this](const uint8_t* packet, size_t len, uint64_t timestamp_ns) {
+            parser_->process_payload(packet, len, timestamp_ns, current_receive_ticks_);
+        });
+        arbitrator_->set_gap_callback([this](uint64_t first_missing, uint64_t count) {
+            logger_.warning("Feed gap: " + std::to_string(count) + " messages lost from sequence " +
+                            std::to_string(first_missing));
+        });
+    } else {
+        arbitrator_.reset();
+        if (lines.size() > 1) {
+            logger_.warning("Feed format carries no sequence numbers; using the A line only");
+        }
+    }
+
+    HighResTimer::initialize();
+
+    logger_.info(std::string("Multicast feed on ") + source_->name() + ": " + describe_lines(lines));
+    return true;
+}
+
+void MulticastFeed::set_data_callback(std::function<void(const MarketData&)> callback) {
+    parser_->set_data_callback(std::move(callback));
+}
+
+void MulticastFeed::set_book_update_callback(std::function<void(const OrderBookUpdate&)> callback) {
+    parser_->set_book_update_callback(std::move(callback));
+}
+
+void MulticastFeed::set_packet_end_callback(std::function<void()> callback) {
+    parser_->set_packet_end_callback(std::move(callback));
+}
+
+void MulticastFeed::start() {
+    if (running_.load() || !source_) {
+        return;
+    }
+    running_.store(true);
+    rx_thread_ = std::make_unique<std::thread>(&MulticastFeed::run, this);
+}
+
+void MulticastFeed::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (rx_thread_ && rx_thread_->joinable()) {
+        rx_thread_->join();
+    }
+    rx_thread_.reset();
+}
+
+void MulticastFeed::run() {
+    if (!ThreadPlan::instance().pin_current_thread("feed_rx")) {
+        logger_.warning("Failed to pin feed_rx thread to its planned CPU");
+    }
+    logger_.info("Multicast feed RX loop started");
+
+    std::vector<FeedPacket> batch(rx_burst_);
+    while (running_.load(std::memory_order_relaxed)) {
+        size_t count = source_->poll(batch.data(), rx_burst_);
+
+        for (size_t i = 0; i < count; ++i) {
+            const FeedPacket& packet = batch[i];
+            received_[packet.line]++;
+            current_receive_ticks_ = packet.receive_ticks;
+            if (arbitrator_) {
+                arbitrator_->on_packet(packet.line, packet.payload, packet.length, packet.timestamp_ns,
+                                       HighResTimer::ticks_to_steady_nanoseconds(packet.receive_ticks));
+            } else if (packet.line == 0) {
+                parser_->process_payload(packet.payload, packet.length, packet.timestamp_ns, packet.receive_ticks);
+                passed_through_++;
+            }
+        }
+
+        if (arbitrator_) {
+            arbitrator_->poll(HighResTimer::get_nanoseconds());
+        }
+        if (count == 0) {
+            HighResTimer::cpu_relax();
+        } else {
+            publish_stats();
+        }
+    }
+
+    publish_stats();
+    logger_.info("Multicast feed RX loop stopped");
+}
+
+void MulticastFeed::publish_stats() {
+    for (size_t line = 0; line < FeedArbitrator::MAX_LINES; ++line) {
+        packets_received_[line].store(received_[line], std::memory_order_relaxed);
+    }
+    if (arbitrator_) {
+        packets_delivered_.store(arbitrator_->packets_delivered(), std::memory_order_relaxed);
+        duplicates_.store(arbitrator_->duplicates(0) + arbitrator_->duplicates(1), std::memory_order_relaxed);
+        gaps_.store(arbitrator_->gaps(), std::memory_order_relaxed);
+        messages_lost_.store(arbitrator_->messages_lost(), std::memory_order_relaxed);
+    } else {
+        packets_delivered_.store(passed_through_, std::memory_order_relaxed);
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "../common/high_res_timer.h"
+#include "../common/logging.h"
+#include "feed_arbitrator.h"
+#include "pcap_reader.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+
+#ifdef DPDK_ENABLED
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#endif
+
+namespace hft {
+
+// One received datagram; payload is the UDP payload
+struct FeedPacket {
+    const uint8_t* payload;
+    uint32_t length;
+    uint8_t line;                           // Index into the configured lines (0 = A, 1 = B)
+    uint64_t timestamp_ns;                  // Wall clock at receipt
+    HighResTimer::ticks_t receive_ticks;
+};
+
+struct FeedLineConfig {
+    std::string group;                      // Multicast group (a unicast address just binds)
+    uint16_t port = 0;
+};
+
+// Receive side of the live feed. poll() never blocks; the payloads it
+// returns stay valid until the next poll().
+class FeedRxSource {
+public:
+    virtual ~FeedRxSource() = default;
+
+    virtual bool open(const std::vector<FeedLineConfig>& lines, const std::string& interface_address) = 0;
+    virtual size_t poll(FeedPacket* out, size_t max) = 0;
+    virtual const char* name() const = 0;
+};
+
+// Kernel UDP sockets, one per line, drained with non-blocking recvmmsg and
+// SO_BUSY_POLL where the kernel allows it
+class SocketRxSource : public FeedRxSource {
+public:
+    static constexpr size_t SLOT_SIZE = 2048;
+
+    explicit SocketRxSource(size_t max_burst);
+    ~SocketRxSource() override;
+
+    bool open(const std::vector<FeedLineConfig>& lines, const std::string& interface_address) override;
+    size_t poll(FeedPacket* out, size_t max) override;
+    const char* name() const override { return "socket"; }
+
+    uint64_t truncated_datagrams() const { return truncated_datagrams_; }
+    uint16_t bound_port(size_t line) const;     // For tests binding port 0
+
+private:
+    std::vector<int> sockets_;
+    size_t max_burst_;
+    std::vector<uint8_t> buffers_;              // max_burst_ slots of SLOT_SIZE
+    std::vector<struct iovec> iovecs_;
+    std::vector<struct mmsghdr> messages_;
+    size_t next_line_ = 0;                      // Round-robin start, so one line can't starve the other
+    uint64_t truncated_datagrams_ = 0;
+
+    void close_all();
+};
+
+#ifdef DPDK_ENABLED
+// DPDK poll-mode driver on one port, RX queue 0. Frames are matched to lines
+// by destination address and port; everything else is freed. DPDK owns the
+// NIC, so no IGMP joins go out from here: the groups have to be statically
+// forwarded to the port.
+class DpdkRxSource : public FeedRxSource {
+public:
+    DpdkRxSource(uint16_t port_id, const std::string& eal_args, size_t max_burst);
+    ~DpdkRxSource() override;
+
+    bool open(const std::vector<FeedLineConfig>& lines, const std::string& interface_address) override;
+    size_t poll(FeedPacket* out, size_t max) override;
+    const char* name() const override { return "dpdk"; }
+
+private:
+    static constexpr uint16_t RX_DESCRIPTORS = 4096;
+    static constexpr unsigned MBUF_COUNT = 16383;
+    static constexpr unsigned MBUF_CACHE = 512;
+
+    uint16_t port_id_;
+    std::string eal_args_;
+    size_t max_burst_;
+    bool started_ = false;
+    struct rte_mempool* pool_ = nullptr;
+    std::vector<struct rte_mbuf*> held_;        // Returned by the last poll, freed by the next
+    size_t held_count_ = 0;
+    std::vector<uint32_t> line_addresses_;      // Network byte order
+    std::vector<uint16_t> line_ports_;
+
+    int match_line(uint32_t address, uint16_t port) const;
+};
+#endif
+
+// Live exchange feed: busy-polls the RX source on the market data core,
+// arbitrates the A and B lines (MoldUDP64 feeds) and hands each packet to
+// the same parsers PCAPReader uses for replay.
+class MulticastFeed {
+public:
+    explicit MulticastFeed(FeedFormat format);
+    ~MulticastFeed();
+
+    // Lines and sizing from StaticConfig; use_dpdk picks the RX source
+    bool initialize(bool use_dpdk);
+    // Explicit lines on a given source (tests, tools)
+    bool initialize(std::unique_ptr<FeedRxSource> source, const std::vector<FeedLineConfig>& lines,
+                    const std::string& interface_address);
+
+    void set_data_callback(std::function<void(const MarketData&)> callback);
+    void set_book_update_callback(std::function<void(const OrderBookUpdate&)> callback);
+    void set_packet_end_callback(std::function<void()> callback);   // After each delivered packet
+
+    void start();
+    void stop();
+    bool is_running() const { return running_.load(); }
+
+    // Statistics, safe to read from other threads
+    uint64_t get_packets_received(uint8_t line) const { return packets_received_[line].load(std::memory_order_relaxed); }
+    uint64_t get_packets_delivered() const { return packets_delivered_.load(std::memory_order_relaxed); }
+    uint64_t get_duplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+    uint64_t get_gaps() const { return gaps_.load(std::memory_order_relaxed); }
+    uint64_t get_messages_lost() const { return messages_lost_.load(std::memory_order_relaxed); }
+    uint64_t get_parse_errors() const { return parser_->get_parse_errors(); }
+    const char* get_source_name() const { return source_ ? source_->name() : "none"; }
+
+private:
+    FeedFormat format_;
+    std::unique_ptr<PCAPReader> parser_;        // Replay reader used only for its parsers
+    std::unique_ptr<FeedRxSource> source_;
+    std::unique_ptr<FeedArbitrator> arbitrator_;    // nullptr = unsequenced format, A line only
+    size_t rx_burst_ = 32;
+    HighResTimer::ticks_t current_receive_ticks_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> rx_thread_;
+
+    // Counted on the RX thread, published to the atomics after each burst
+    std::array<uint64_t, FeedArbitrator::MAX_LINES> received_{};
+    uint64_t passed_through_ = 0;               // Unsequenced formats
+
+    std::atomic<uint64_t> packets_received_[FeedArbitrator::MAX_LINES] = {};
+    std::atomic<uint64_t> packets_delivered_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<uint64_t> gaps_{0};
+    std::atomic<uint64_t> messages_lost_{0};
+
+    Logger logger_;
+
+    void run();
+    void publish_stats();
+};
+
+} // namespace hft
@@ -0,0 +1,292 @@
+#include "pcap_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+constexpr uint32_t PCAP_MAGIC_MICRO = 0xa1b2c3d4;
+constexpr uint32_t PCAP_MAGIC_NANO = 0xa1b23c4d;
+constexpr size_t PCAP_FILE_HEADER_SIZE = 24;
+constexpr size_t PCAP_RECORD_HEADER_SIZE = 16;
+
+constexpr uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+constexpr uint32_t PCAPNG_INTERFACE_DESCRIPTION = 1;
+constexpr uint32_t PCAPNG_SIMPLE_PACKET = 3;
+constexpr uint32_t PCAPNG_ENHANCED_PACKET = 6;
+constexpr uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+constexpr uint16_t PCAPNG_OPTION_TSRESOL = 9;
+
+constexpr uint32_t LINKTYPE_ETHERNET = 1;
+
+__extension__ typedef unsigned __int128 uint128_t;     // Quiet under -Wpedantic
+
+uint64_t to_nanoseconds(uint64_t ticks, uint64_t ticks_per_second) {
+    if (ticks_per_second == 1000000000ULL) return ticks;
+    if (ticks_per_second == 1000000ULL) return ticks * 1000ULL;
+    return static_cast<uint64_t>(static_cast<uint128_t>(ticks) * 1000000000ULL / ticks_per_second);
+}
+
+} // namespace
+
+MappedPcapFile::~MappedPcapFile() {
+    close();
+}
+
+bool MappedPcapFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[MappedPcapFile] Cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(PCAP_FILE_HEADER_SIZE)) {
+        std::cerr << "[MappedPcapFile] " << path << " is too small to be a capture" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        std::cerr << "[MappedPcapFile] mmap failed for " << path << ": " << std::strerror(errno) << std::endl;
+        size_ = 0;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+
+    if (!parse_file_header()) {
+        std::cerr << "[MappedPcapFile] " << path << " is not a pcap or pcapng file" << std::endl;
+        close();
+        return false;
+    }
+    rewind();
+    return true;
+}
+
+void MappedPcapFile::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    offset_ = 0;
+    interfaces_.clear();
+}
+
+void MappedPcapFile::rewind() {
+    offset_ = first_record_;
+    readahead_until_ = 0;
+    truncated_ = false;
+    last_timestamp_ns_ = 0;
+    if (pcapng_) {
+        // Interfaces are redefined by the section header at offset 0
+        offset_ = 0;
+        interfaces_.clear();
+    }
+}
+
+size_t MappedPcapFile::next_batch(PcapPacket* out, size_t max) {
+    if (!data_) {
+        return 0;
+    }
+    advise_readahead();
+
+    size_t count = 0;
+    while (count < max) {
+        bool more = pcapng_ ? next_pcapng_block(out[count]) : next_pcap_record(out[count]);
+        if (!more) break;
+        if (out[count].data) count++;   // Non-packet blocks and skipped link types leave data null
+    }
+    return count;
+}
+
+bool MappedPcapFile::parse_file_header() {
+    uint32_t magic;
+    std::memcpy(&magic, data_, sizeof(magic));
+
+    if (magic == PCAPNG_SECTION_HEADER) {
+        pcapng_ = true;
+        uint32_t byte_order;
+        std::memcpy(&byte_order, data_ + 8, sizeof(byte_order));
+        if (byte_order != PCAPNG_BYTE_ORDER_MAGIC && byte_order != __builtin_bswap32(PCAPNG_BYTE_ORDER_MAGIC)) {
+            return false;
+        }
+        swapped_ = byte_order != PCAPNG_BYTE_ORDER_MAGIC;
+        first_record_ = 0;
+        return true;
+    }
+
+    pcapng_ = false;
+    if (magic == PCAP_MAGIC_MICRO || magic == PCAP_MAGIC_NANO) {
+        swapped_ = false;
+    } else if (magic == __builtin_bswap32(PCAP_MAGIC_MICRO) || magic == __builtin_bswap32(PCAP_MAGIC_NANO)) {
+        swapped_ = true;
+        magic = __builtin_bswap32(magic);
+    } else {
+        return false;
+    }
+    nanosecond_ = magic == PCAP_MAGIC_NANO;
+    link_type_ = read32(20) & 0xFFFF;     // Upper bits carry FCS information
+    first_record_ = PCAP_FILE_HEADER_SIZE;
+    return true;
+}
+
+void MappedPcapFile::advise_readahead() {
+    // Keep a window of pages requested ahead of the cursor
+    if (offset_ + READAHEAD_WINDOW / 2 < readahead_until_ || readahead_until_ >= size_) {
+        return;
+    }
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = std::max(readahead_until_, offset_) & ~(page_size - 1);
+    size_t length = std::min(READAHEAD_WINDOW, size_ - start);
+    madvise(const_cast<uint8_t*>(data_) + start, length, MADV_WILLNEED);
+    readahead_until_ = start + length;
+}
+
+bool MappedPcapFile::next_pcap_record(PcapPacket& packet) {
+    if (offset_ + PCAP_RECORD_HEADER_SIZE > size_) {
+        truncated_ = offset_ != size_;
+        return false;
+    }
+    uint32_t seconds = read32(offset_);
+    uint32_t fraction = read32(offset_ + 4);
+    uint32_t captured = read32(offset_ + 8);
+    size_t data_offset = offset_ + PCAP_RECORD_HEADER_SIZE;
+    if (data_offset + captured > size_) {
+        truncated_ = true;
+        return false;
+    }
+
+    offset_ = data_offset + captured;
+    if (link_type_ != LINKTYPE_ETHERNET) {
+        skipped_packets_++;
+        packet.data = nullptr;
+        return true;
+    }
+    packet.data = data_ + data_offset;
+    packet.length = captured;
+    packet.timestamp_ns = static_cast<uint64_t>(seconds) * 1000000000ULL +
+                          (nanosecond_ ? fraction : static_cast<uint64_t>(fraction) * 1000ULL);
+    return true;
+}
+
+bool MappedPcapFile::next_pcapng_block(PcapPacket& packet) {
+    packet.data = nullptr;
+    if (offset_ + 12 > size_) {
+        truncated_ = offset_ != size_;
+        return false;
+    }
+
+    uint32_t type;
+    std::memcpy(&type, data_ + offset_, sizeof(type));     // Palindromic for section headers
+    if (type == PCAPNG_SECTION_HEADER) {
+        // A new section may switch byte order; its interfaces replace the old ones
+        uint32_t byte_order;
+        std::memcpy(&byte_order, data_ + offset_ + 8, sizeof(byte_order));
+        swapped_ = byte_order != PCAPNG_BYTE_ORDER_MAGIC;
+        interfaces_.clear();
+    } else {
+        type = swapped_ ? __builtin_bswap32(type) : type;
+    }
+
+    uint32_t length = read32(offset_ + 4);
+    if (length < 12 || (length & 3) != 0 || offset_ + length > size_) {
+        truncated_ = true;
+        return false;
+    }
+    size_t block = offset_;
+    offset_ += length;
+
+    switch (type) {
+        case PCAPNG_INTERFACE_DESCRIPTION:
+            parse_interface(block, length);
+            break;
+
+        case PCAPNG_ENHANCED_PACKET: {
+            if (length < 32) break;
+            uint32_t interface_id = read32(block + 8);
+            uint64_t ticks = (static_cast<uint64_t>(read32(block + 12)) << 32) | read32(block + 16);
+            uint32_t captured = read32(block + 20);
+            if (28 + static_cast<size_t>(captured) > length - 4) break;
+            if (interface_id >= interfaces_.size() || interfaces_[interface_id].link_type != LINKTYPE_ETHERNET) {
+                skipped_packets_++;
+                break;
+            }
+            packet.data = data_ + block + 28;
+            packet.length = captured;
+            packet.timestamp_ns = to_nanoseconds(ticks, interfaces_[interface_id].ticks_per_second);
+            last_timestamp_ns_ = packet.timestamp_ns;
+            break;
+        }
+
+        case PCAPNG_SIMPLE_PACKET: {
+            // No timestamp (reuse the previous one); always interface 0
+            if (interfaces_.empty() || interfaces_[0].link_type != LINKTYPE_ETHERNET) {
+                skipped_packets_++;
+                break;
+            }
+            uint32_t original = read32(block + 8);
+            packet.data = data_ + block + 12;
+            packet.length = std::min<uint32_t>(original, length - 16);
+            packet.timestamp_ns = last_timestamp_ns_;
+            break;
+        }
+
+        default:
+            break;      // Name resolution, statistics, custom blocks...
+    }
+    return true;
+}
+
+void MappedPcapFile::parse_interface(size_t offset, size_t length) {
+    Interface interface;
+    if (length >= 20) {
+        interface.link_type = read16(offset + 8);
+    }
+
+    // Options run from after snaplen to the trailing length field
+    size_t option = offset + 16;
+    size_t end = offset + length - 4;
+    while (option + 4 <= end) {
+        uint16_t code = read16(option);
+        uint16_t option_length = read16(option + 2);
+        if (code == 0 || option + 4 + option_length > end) break;
+        if (code == PCAPNG_OPTION_TSRESOL && option_length >= 1) {
+            uint8_t resolution = data_[option + 4];
+            uint8_t exponent = resolution & 0x7F;
+            if (resolution & 0x80) {
+                interface.ticks_per_second = exponent < 64 ? (1ULL << exponent) : 1;
+            } else {
+                interface.ticks_per_second = 1;
+                for (uint8_t i = 0; i < exponent && i < 19; ++i) interface.ticks_per_second *= 10;
+            }
+        }
+        option += 4 + ((option_length + 3) & ~3u);
+    }
+    interfaces_.push_back(interface);
+}
+
+uint16_t MappedPcapFile::read16(size_t offset) const {
+    uint16_t value;
+    std::memcpy(&value, data_ + offset, sizeof(value));
+    return swapped_ ? __builtin_bswap16(value) : value;
+}
+
+uint32_t MappedPcapFile::read32(size_t offset) const {
+    uint32_t value;
+    std::memcpy(&value, data_ + offset, sizeof(value));
+    return swapped_ ? __builtin_bswap32(value) : value;
+}
+
+} // namespace hft
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// One captured packet, pointing into the mapped file
+struct PcapPacket {
+    const uint8_t* data;
+    uint32_t length;            // Captured bytes (may be less than on the wire)
+    uint64_t timestamp_ns;      // Since the epoch
+};
+
+// Read-only mmap of a pcap or pcapng capture. Records are walked in place:
+// next_batch() hands back pointers into the mapping, so packet bytes are
+// never copied and there is no read() per packet. The mapping is advised
+// MADV_SEQUENTIAL, and the window ahead of the cursor is requested with
+// MADV_WILLNEED so page cache misses overlap with parsing. Both byte
+// orders, microsecond/nanosecond pcap and pcapng's per-interface timestamp
+// resolution are handled. Only Ethernet link types are returned; other
+// packets are skipped and counted.
+class MappedPcapFile {
+public:
+    MappedPcapFile() = default;
+    ~MappedPcapFile();
+
+    MappedPcapFile(const MappedPcapFile&) = delete;
+    MappedPcapFile& operator=(const MappedPcapFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return data_ != nullptr; }
+
+    // Up to max packets into out; 0 at end of file (or a truncated record).
+    // Pointers stay valid until close().
+    size_t next_batch(PcapPacket* out, size_t max);
+
+    // Back to the first packet (for looped replay)
+    void rewind();
+
+    bool is_pcapng() const { return pcapng_; }
+    size_t file_size() const { return size_; }
+    size_t bytes_consumed() const { return offset_; }
+    uint64_t skipped_packets() const { return skipped_packets_; }   // Non-Ethernet link types
+    bool truncated() const { return truncated_; }                   // File ended mid-record
+
+private:
+    static constexpr size_t READAHEAD_WINDOW = 32 << 20;
+
+    struct Interface {
+        uint16_t link_type = 0;
+        uint64_t ticks_per_second = 1000000;    // pcapng default: microseconds
+    };
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    size_t first_record_ = 0;
+    size_t readahead_until_ = 0;
+    bool pcapng_ = false;
+    bool swapped_ = false;          // File byte order differs from ours
+    bool truncated_ = false;
+
+    // Classic pcap
+    uint32_t link_type_ = 0;
+    bool nanosecond_ = false;
+
+    // pcapng: interfaces of the current section
+    std::vector<Interface> interfaces_;
+    uint64_t last_timestamp_ns_ = 0;        // Simple packet blocks carry none
+
+    uint64_t skipped_packets_ = 0;
+
+    bool parse_file_header();
+    void advise_readahead();
+    bool next_pcap_record(PcapPacket& packet);
+    bool next_pcapng_block(PcapPacket& packet);
+    void parse_interface(size_t offset, size_t length);
+
+    uint16_t read16(size_t offset) const;
+    uint32_t read32(size_t offset) const;
+};
+
+} // namespace hft
@@ -1,6 +1,8 @@
 #include "pcap_reader.h"
 #include "../common/static_config.h"
-#include <fstream>
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <sstream>
@@ -8,17 +10,32 @@
 #include <arpa/inet.h>
 #include <cmath>
 
-#ifdef HAS_PCAP
-#include <pcap/pcap.h>
-#endif
-
 namespace hft {
 
+namespace {
+
+// Below this much lead the replay thread spins instead of sleeping; the
+// scheduler's wakeup jitter is larger than typical inter-packet gaps
+constexpr uint64_t REPLAY_SPIN_THRESHOLD_NS = 200000;
+
+} // namespace
+
+FeedFormat parse_feed_format(const std::string& name) {
+    if (name == "nasdaq_itch") return FeedFormat::NASDAQ_ITCH_5_0;
+    if (name == "nyse_pillar") return FeedFormat::NYSE_PILLAR;
+    if (name == "iex_tops") return FeedFormat::IEX_TOPS;
+    if (name == "fix") return FeedFormat::FIX_PROTOCOL;
+    return FeedFormat::GENERIC_CSV;
+}
+
 PCAPReader::PCAPReader(const std::string& pcap_file, FeedFormat format)
     : pcap_file_(pcap_file)
     , feed_format_(format)
     , logger_("PCAPReader", StaticConfig::get_logger_endpoint()) {
     logger_.info("PCAPReader initialized for file: " + pcap_file);
+    if (feed_format_ == FeedFormat::NASDAQ_ITCH_5_0) {
+        init_itch_decoder();
+    }
 }
 
 PCAPReader::~PCAPReader() {
@@ -28,30 +45,24 @@ PCAPReader::~PCAPReader() {
 bool PCAPReader::initialize(bool use_dpdk) {
     use_dpdk_ = use_dpdk;
     
-#ifndef HAS_PCAP
-    logger_.error("PCAP support not available. Install libpcap-dev and rebuild");
-    return false;
-#endif
-    
-    // Check if PCAP file exists
-    std::ifstream file(pcap_file_);
-    if (!file.good()) {
-        logger_.error("PCAP file not found: " + pcap_file_);
-        return false;
-    }
-    
 #ifdef DPDK_ENABLED
     if (use_dpdk_) {
         return initialize_dpdk_pcap();
     }
 #else
     if (use_dpdk_) {
-        logger_.warning("DPDK not available, falling back to libpcap");
+        logger_.warning("DPDK not available, falling back to the mmap reader");
         use_dpdk_ = false;
     }
 #endif
     
-    logger_.info("PCAP reader initialized with libpcap backend");
+    if (!capture_.open(pcap_file_)) {
+        logger_.error("Failed to open PCAP file: " + pcap_file_);
+        return false;
+    }
+    
+    logger_.info("PCAP reader initialized: " + std::to_string(capture_.file_size()) + " bytes mapped (" +
+                 (capture_.is_pcapng() ? "pcapng" : "pcap") + ")");
     return true;
 }
 
@@ -85,93 +96,121 @@ void PCAPReader::set_data_callback(std::function<void(const MarketData&)> callba
     data_callback_ = callback;
 }
 
+void PCAPReader::set_book_update_callback(std::function<void(const OrderBookUpdate&)> callback) {
+    book_update_callback_ = callback;
+}
+
+void PCAPReader::init_itch_decoder() {
+    itch_decoder_ = std::make_unique<ItchDecoder>(StaticConfig::get_itch_max_orders(), hot_memory());
+    // Books only for the configured universe; everything else is skipped at Add
+    itch_decoder_->set_symbol_filter(StaticConfig::get_symbols());
+    itch_decoder_->set_book_update_callback([this](const OrderBookUpdate& update) { on_itch_book_update(update); });
+    itch_decoder_->set_trade_callback([this](const ItchTrade& trade) { on_itch_trade(trade); });
+    itch_books_ = std::make_unique<OrderBookManager>(BookImplementation::MAP, hot_memory());
+    itch_tops_.assign(SymbolTable::MAX_SYMBOLS, TopOfBook{});
+}
+
 void PCAPReader::process_pcap_file() {
+    if (!ThreadPlan::instance().pin_current_thread("feed_rx")) {
+        logger_.warning("Failed to pin feed_rx thread to its planned CPU");
+    }
     logger_.info("Starting PCAP file processing thread");
     
-#ifndef HAS_PCAP
-    logger_.error("PCAP support not available");
-    reading_ = false;
-    return;
-#endif
-
-#ifdef HAS_PCAP
-    char errbuf[PCAP_ERRBUF_SIZE];
-    pcap_t* pcap_handle = pcap_open_offline(pcap_file_.c_str(), errbuf);
-    
-    if (!pcap_handle) {
-        logger_.error("Failed to open PCAP file: " + std::string(errbuf));
+    if (!capture_.is_open()) {
+        logger_.error("PCAP file not open; call initialize() first");
         reading_ = false;
         return;
     }
     
-    struct pcap_pkthdr* header;
-    const u_char* packet_data;
-    auto start_time = std::chrono::steady_clock::now();
-    uint64_t first_packet_ts = 0;
+    // Records are parsed a batch at a time straight out of the mapping;
+    // while one packet is processed, the one prefetch_distance ahead is
+    // pulled into cache
+    const size_t batch_size = std::max<size_t>(1, StaticConfig::get_pcap_batch_size());
+    const size_t prefetch_distance = StaticConfig::get_pcap_prefetch_distance();
+    std::vector<PcapPacket> batch(batch_size);
+    
+    HighResTimer::initialize();
+    replay_first_packet_ns_ = 0;
     
     while (!should_stop_ && reading_) {
-        int result = pcap_next_ex(pcap_handle, &header, &packet_data);
+        size_t count = capture_.next_batch(batch.data(), batch_size);
         
-        if (result == 1) { // Packet read successfully
-            packets_processed_++;
-            
-            // Calculate replay timing for realistic playback
-            uint64_t packet_ts = static_cast<uint64_t>(header->ts.tv_sec) * 1000000ULL + header->ts.tv_usec;
-            
-            if (first_packet_ts == 0) {
-                first_packet_ts = packet_ts;
+        if (count == 0) {
+            if (capture_.truncated()) {
+                logger_.warning("PCAP file ends with a truncated record");
             }
-            
-            // Apply replay speed control
-            if (replay_speed_ > 0.0 && replay_speed_ != 1.0) {
-                uint64_t elapsed_packet_time = packet_ts - first_packet_ts;
-                uint64_t target_real_time = static_cast<uint64_t>(elapsed_packet_time / replay_speed_);
-                
-                auto current_real_time = std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::steady_clock::now() - start_time).count();
-                
-                if (target_real_time > current_real_time) {
-                    std::this_thread::sleep_for(std::chrono::microseconds(target_real_time - current_real_time));
-                }
-            }
-            
-            // Process the packet
-            if (process_packet(packet_data, header->caplen, packet_ts * 1000ULL)) {
-                packets_parsed_++;
-            }
-            
-        } else if (result == -2) { // End of file
             if (loop_replay_) {
                 logger_.info("Reached end of PCAP file, looping...");
-                pcap_close(pcap_handle);
-                pcap_handle = pcap_open_offline(pcap_file_.c_str(), errbuf);
-                if (!pcap_handle) {
-                    logger_.error("Failed to reopen PCAP file for looping: " + std::string(errbuf));
-                    break;
+                capture_.rewind();
+                replay_first_packet_ns_ = 0;
+                if (itch_decoder_) {
+                    init_itch_decoder();    // Order refs restart with the file
                 }
-                first_packet_ts = 0;
-                start_time = std::chrono::steady_clock::now();
                 continue;
-            } else {
-                logger_.info("Reached end of PCAP file");
-                break;
             }
-        } else if (result == -1) { // Error reading packet
-            logger_.error("Error reading PCAP packet: " + std::string(pcap_geterr(pcap_handle)));
+            logger_.info("Reached end of PCAP file");
             break;
         }
+        
+        for (size_t i = 0; i < count && !should_stop_; ++i) {
+            if (prefetch_distance > 0 && i + prefetch_distance < count) {
+                const PcapPacket& ahead = batch[i + prefetch_distance];
+                __builtin_prefetch(ahead.data);
+                __builtin_prefetch(ahead.data + 64);
+            }
+            
+            const PcapPacket& packet = batch[i];
+            packets_processed_++;
+            pace_until(packet.timestamp_ns);
+            
+            if (process_packet(packet.data, packet.length, packet.timestamp_ns)) {
+                packets_parsed_++;
+            }
+        }
     }
     
-    pcap_close(pcap_handle);
     reading_ = false;
     
     logger_.info("PCAP processing complete. Processed: " + std::to_string(packets_processed_.load()) +
                 ", Parsed: " + std::to_string(packets_parsed_.load()) +
-                ", Errors: " + std::to_string(parse_errors_.load()));
-#endif // HAS_PCAP
+                ", Errors: " + std::to_string(parse_errors_.load()) +
+                ", Skipped (link type): " + std::to_string(capture_.skipped_packets()));
+}
+
+void PCAPReader::pace_until(uint64_t packet_ns) {
+    if (replay_speed_ <= 0.0) {
+        return;     // As fast as possible
+    }
+    
+    HighResTimer::ticks_t now = HighResTimer::get_ticks();
+    if (replay_first_packet_ns_ == 0) {
+        replay_first_packet_ns_ = packet_ns;
+        replay_start_ticks_ = now;
+        return;
+    }
+    if (packet_ns <= replay_first_packet_ns_) {
+        return;
+    }
+    
+    // Deadline on the TSC; sleep off most of a long gap, spin the rest
+    double elapsed_ns = static_cast<double>(packet_ns - replay_first_packet_ns_) / replay_speed_;
+    HighResTimer::ticks_t target = replay_start_ticks_ + HighResTimer::nanoseconds_to_ticks(static_cast<uint64_t>(elapsed_ns));
+    if (now >= target) {
+        return;     // Behind schedule
+    }
+    
+    uint64_t remaining_ns = HighResTimer::ticks_to_nanoseconds(target - now);
+    if (remaining_ns > REPLAY_SPIN_THRESHOLD_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining_ns - REPLAY_SPIN_THRESHOLD_NS));
+    }
+    while (HighResTimer::get_ticks() < target && !should_stop_.load(std::memory_order_relaxed)) {
+        HighResTimer::cpu_relax();
+    }
 }
 
 bool PCAPReader::process_packet(const uint8_t* packet_data, size_t packet_len, uint64_t timestamp_ns) {
+    HighResTimer::ticks_t receive_ticks = HighResTimer::get_ticks();
+    
     if (packet_len < MIN_MARKET_DATA_PACKET_SIZE) {
         return false; // Too small to be a valid market data packet
     }
@@ -183,6 +222,31 @@ bool PCAPReader::process_packet(const uint8_t* packet_data, size_t packet_len, u
         return false; // Not a UDP packet or extraction failed
     }
     
+    return process_payload(payload, payload_len, timestamp_ns, receive_ticks);
+}
+
+bool PCAPReader::process_payload(const uint8_t* payload, size_t payload_len, uint64_t timestamp_ns,
+                                 HighResTimer::ticks_t receive_ticks) {
+    bool parsed = parse_payload(payload, payload_len, timestamp_ns, receive_ticks);
+    if (packet_end_callback_) {
+        packet_end_callback_();
+    }
+    return parsed;
+}
+
+bool PCAPReader::parse_payload(const uint8_t* payload, size_t payload_len, uint64_t timestamp_ns,
+                               HighResTimer::ticks_t receive_ticks) {
+    // Order-level feeds carry many messages per packet and emit from callbacks
+    if (feed_format_ == FeedFormat::NASDAQ_ITCH_5_0) {
+        current_packet_ns_ = timestamp_ns;
+        current_receive_ticks_ = receive_ticks;
+        bool parsed = parse_nasdaq_itch(payload, payload_len);
+        if (!parsed) {
+            parse_errors_++;
+        }
+        return parsed;
+    }
+    
     // Parse based on feed format
     MarketDataPacket packet;
     packet.timestamp = std::chrono::nanoseconds(timestamp_ns);
@@ -190,9 +254,6 @@ bool PCAPReader::process_packet(const uint8_t* packet_data, size_t packet_len, u
     
     bool parsed = false;
     switch (feed_format_) {
-        case FeedFormat::NASDAQ_ITCH_5_0:
-            parsed = parse_nasdaq_itch(payload, payload_len, packet);
-            break;
         case FeedFormat::NYSE_PILLAR:
             parsed = parse_nyse_pillar(payload, payload_len, packet);
             break;
@@ -212,6 +273,8 @@ bool PCAPReader::process_packet(const uint8_t* packet_data, size_t packet_len, u
     
     if (parsed && data_callback_) {
         MarketData data = convert_to_market_data(packet);
+        data.trace.tsc[static_cast<size_t>(TraceStage::FEED_RECEIVE)] = receive_ticks;
+        data.trace.stamp(TraceStage::FEED_PARSE);
         data_callback_(data);
         return true;
     }
@@ -263,48 +326,65 @@ bool PCAPReader::extract_udp_payload(const uint8_t* packet, size_t len, const ui
     return true;
 }
 
-bool PCAPReader::parse_nasdaq_itch(const uint8_t* payload, size_t len, MarketDataPacket& packet) {
-    if (len < sizeof(ITCHMessageHeader)) {
-        return false;
+bool PCAPReader::parse_nasdaq_itch(const uint8_t* payload, size_t len) {
+    // MoldUDP64 as multicast; bare length-prefixed messages as in NASDAQ's files
+    uint64_t decoded_before = itch_decoder_->messages_decoded();
+    if (!itch_decoder_->decode_moldudp64(payload, len)) {
+        itch_decoder_->decode_stream(payload, len);
     }
-    
-    const ITCHMessageHeader* header = reinterpret_cast<const ITCHMessageHeader*>(payload);
-    uint16_t message_len = ntohs(header->length);
-    
-    if (len < message_len) {
-        return false;
+    return itch_decoder_->messages_decoded() > decoded_before;
+}
+
+void PCAPReader::on_itch_book_update(const OrderBookUpdate& update) {
+    if (book_update_callback_) {
+        book_update_callback_(update);
     }
-    
-    // Parse based on ITCH message type
-    switch (header->message_type) {
-        case 'A': // Add Order (no quotes)
-        case 'F': // Add Order with MPID
-            // These don't provide quote data, skip
-            return false;
-            
-        case 'Q': { // Cross Trade (provides price info)
-            if (message_len < 40) return false;
-            
-            const uint8_t* data = payload + sizeof(ITCHMessageHeader);
-            
-            // Extract symbol (8 bytes, right-padded with spaces)
-            packet.symbol = parse_symbol(reinterpret_cast<const char*>(data + 11), 8);
-            
-            // Extract cross price (8 bytes, big endian)
-            uint64_t price_raw = be64toh(*reinterpret_cast<const uint64_t*>(data + 19));
-            packet.last_price = parse_price_field(price_raw);
-            
-            // Extract quantity (8 bytes, big endian)
-            uint64_t qty_raw = be64toh(*reinterpret_cast<const uint64_t*>(data + 27));
-            packet.last_size = static_cast<uint32_t>(qty_raw);
-            
-            return true;
+    itch_books_->process_update(update);
+    publish_itch_quote(update.symbol, update.symbol_id, 0, 0);
+}
+
+void PCAPReader::on_itch_trade(const ItchTrade& trade) {
+    publish_itch_quote(trade.symbol, trade.symbol_id, trade.price, trade.shares);
+}
+
+void PCAPReader::publish_itch_quote(const char* symbol, symbol_id_t symbol_id, price_t last_price,
+                                    uint32_t last_size) {
+    if (!data_callback_) {
+        return;
+    }
+    const IOrderBook* book = symbol_id != INVALID_SYMBOL_ID ? itch_books_->get_book(symbol_id)
+                                                             : itch_books_->get_book(std::string(symbol));
+    if (!book) {
+        return;
+    }
+
+    TopOfBook top{book->get_best_bid_fixed(), book->get_best_ask_fixed(),
+                  book->get_bid_size_at_level(0), book->get_ask_size_at_level(0)};
+    if (last_size == 0 && symbol_id < itch_tops_.size()) {
+        // Most level changes are behind the top; only quote when the top moves
+        TopOfBook& last = itch_tops_[symbol_id];
+        if (last.bid_price == top.bid_price && last.ask_price == top.ask_price &&
+            last.bid_size == top.bid_size && last.ask_size == top.ask_size) {
+            return;
         }
-        
-        default:
-            // Other message types - could implement more as needed
-            return false;
+        last = top;
     }
+
+    MarketDataPacket packet;
+    packet.timestamp = std::chrono::nanoseconds(current_packet_ns_);
+    packet.symbol = symbol;
+    packet.bid_price = top.bid_price;
+    packet.ask_price = top.ask_price;
+    packet.bid_size = top.bid_size;
+    packet.ask_size = top.ask_size;
+    packet.last_price = last_price;
+    packet.last_size = last_size;
+    packet.format = feed_format_;
+
+    MarketData data = convert_to_market_data(packet);
+    data.trace.tsc[static_cast<size_t>(TraceStage::FEED_RECEIVE)] = current_receive_ticks_;
+    data.trace.stamp(TraceStage::FEED_PARSE);
+    data_callback_(data);
 }
 
 bool PCAPReader::parse_nyse_pillar(const uint8_t* payload, size_t len, MarketDataPacket& packet) {
@@ -375,11 +455,11 @@ bool PCAPReader::parse_generic_csv(const uint8_t* payload, size_t len, MarketDat
     try {
         packet.symbol = fields[0];
         // Skip timestamp (fields[1]) - use packet timestamp
-        packet.bid_price = std::stod(fields[2]);
-        packet.ask_price = std::stod(fields[3]);
+        packet.bid_price = to_fixed_price(std::stod(fields[2]));
+        packet.ask_price = to_fixed_price(std::stod(fields[3]));
         packet.bid_size = static_cast<uint32_t>(std::stoul(fields[4]));
         packet.ask_size = static_cast<uint32_t>(std::stoul(fields[5]));
-        packet.last_price = std::stod(fields[6]);
+        packet.last_price = to_fixed_price(std::stod(fields[6]));
         packet.last_size = static_cast<uint32_t>(std::stoul(fields[7]));
         
         return true;
@@ -401,12 +481,13 @@ std::string PCAPReader::parse_symbol(const char* symbol_data, size_t max_len) {
     return symbol;
 }
 
-double PCAPReader::parse_price_field(uint64_t price_int, uint32_t decimal_places) {
-    return static_cast<double>(price_int) / std::pow(10.0, decimal_places);
+price_t PCAPReader::parse_price_field(uint64_t price_int, uint32_t decimal_places) {
+    // Feed prices are already integers; only the implied decimals may differ
+    return rescale_price(static_cast<int64_t>(price_int), static_cast<int>(decimal_places));
 }
 
 MarketData PCAPReader::convert_to_market_data(const MarketDataPacket& packet) {
-    MarketData data = MessageFactory::create_market_data(
+    MarketData data = MessageFactory::create_market_data_fixed(
         packet.symbol,
         packet.bid_price,
         packet.ask_price,
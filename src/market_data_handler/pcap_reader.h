@@ -2,6 +2,9 @@
 
 #include "../common/message_types.h"
 #include "../common/logging.h"
+#include "../common/order_book.h"
+#include "itch_decoder.h"
+#include "pcap_file.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -35,21 +38,18 @@ enum class FeedFormat {
     GENERIC_CSV         // Generic CSV format for testing
 };
 
-// NASDAQ ITCH message types
-struct ITCHMessageHeader {
-    uint16_t length;
-    uint8_t message_type;
-} __attribute__((packed));
+// "nasdaq_itch", "nyse_pillar", "iex_tops", "fix"; anything else is generic CSV
+FeedFormat parse_feed_format(const std::string& name);
 
 // Basic market data packet structure
 struct MarketDataPacket {
     std::chrono::nanoseconds timestamp;
     std::string symbol;
-    double bid_price = 0.0;
-    double ask_price = 0.0;
+    price_t bid_price = 0;     // Fixed-point prices (see fixed_price.h)
+    price_t ask_price = 0;
     uint32_t bid_size = 0;
     uint32_t ask_size = 0;
-    double last_price = 0.0;
+    price_t last_price = 0;
     uint32_t last_size = 0;
     FeedFormat format;
 };
@@ -70,14 +70,28 @@ public:
     // Set callback for processed market data
     void set_data_callback(std::function<void(const MarketData&)> callback);
     
+    // Order-level feeds (ITCH): every price level change, before it is
+    // applied to the reader's books and turned into top-of-book MarketData
+    void set_book_update_callback(std::function<void(const OrderBookUpdate&)> callback);
+    
+    // Called after the last MarketData from each packet, so the owner can
+    // send everything one packet produced as one batch
+    void set_packet_end_callback(std::function<void()> callback) { packet_end_callback_ = std::move(callback); }
+    
     // Replay control
     void set_replay_speed(double speed_multiplier) { replay_speed_ = speed_multiplier; }
     void set_loop_replay(bool loop) { loop_replay_ = loop; }
     
+    // One UDP payload through the feed's parser, for live feeds that have
+    // already stripped the headers (see MulticastFeed)
+    bool process_payload(const uint8_t* payload, size_t len, uint64_t timestamp_ns,
+                         HighResTimer::ticks_t receive_ticks);
+    
     // Statistics
     uint64_t get_packets_processed() const { return packets_processed_; }
     uint64_t get_packets_parsed() const { return packets_parsed_; }
     uint64_t get_parse_errors() const { return parse_errors_; }
+    const ItchDecoder* get_itch_decoder() const { return itch_decoder_.get(); }
 
 private:
     std::string pcap_file_;
@@ -94,6 +108,26 @@ private:
     
     // Callback for processed data
     std::function<void(const MarketData&)> data_callback_;
+    std::function<void(const OrderBookUpdate&)> book_update_callback_;
+    std::function<void()> packet_end_callback_;
+    
+    // ITCH: decoder plus the books it builds; quotes go out when the top changes
+    struct TopOfBook {
+        price_t bid_price = 0;
+        price_t ask_price = 0;
+        uint32_t bid_size = 0;
+        uint32_t ask_size = 0;
+    };
+    std::unique_ptr<ItchDecoder> itch_decoder_;
+    std::unique_ptr<OrderBookManager> itch_books_;
+    std::vector<TopOfBook> itch_tops_;          // Indexed by symbol_id_t
+    uint64_t current_packet_ns_ = 0;
+    HighResTimer::ticks_t current_receive_ticks_ = 0;
+    
+    // Mapped capture and replay pacing (TSC deadline per packet)
+    MappedPcapFile capture_;
+    uint64_t replay_first_packet_ns_ = 0;
+    HighResTimer::ticks_t replay_start_ticks_ = 0;
     
     // Processing thread
     std::unique_ptr<std::thread> processing_thread_;
@@ -103,10 +137,13 @@ private:
     
     // Core processing methods
     void process_pcap_file();
+    void pace_until(uint64_t packet_ns);   // Waits until the packet is due at replay_speed_
     bool process_packet(const uint8_t* packet_data, size_t packet_len, uint64_t timestamp_ns);
+    bool parse_payload(const uint8_t* payload, size_t len, uint64_t timestamp_ns,
+                       HighResTimer::ticks_t receive_ticks);
     
     // Protocol parsers
-    bool parse_nasdaq_itch(const uint8_t* payload, size_t len, MarketDataPacket& packet);
+    bool parse_nasdaq_itch(const uint8_t* payload, size_t len);   // Emits through the decoder callbacks
     bool parse_nyse_pillar(const uint8_t* payload, size_t len, MarketDataPacket& packet);
     bool parse_iex_tops(const uint8_t* payload, size_t len, MarketDataPacket& packet);
     bool parse_fix_protocol(const uint8_t* payload, size_t len, MarketDataPacket& packet);
@@ -115,11 +152,17 @@ private:
     // Network parsing helpers
     bool extract_udp_payload(const uint8_t* packet, size_t len, const uint8_t*& payload, size_t& payload_len);
     std::string parse_symbol(const char* symbol_data, size_t max_len);
-    double parse_price_field(uint64_t price_int, uint32_t decimal_places = 4);
+    price_t parse_price_field(uint64_t price_int, uint32_t decimal_places = 4);
     
     // Convert to internal format
     MarketData convert_to_market_data(const MarketDataPacket& packet);
     
+    // ITCH decoder plumbing
+    void init_itch_decoder();
+    void on_itch_book_update(const OrderBookUpdate& update);
+    void on_itch_trade(const ItchTrade& trade);
+    void publish_itch_quote(const char* symbol, symbol_id_t symbol_id, price_t last_price, uint32_t last_size);
+    
     // DPDK-specific methods (if enabled)
 #ifdef DPDK_ENABLED
     bool initialize_dpdk_pcap();
@@ -1,12 +1,67 @@
 #include "alpaca_client.h"
 #include "../common/static_config.h"
+#include "../common/cpu_affinity.h"
+#include "../common/cpu_topology.h"
 #include <curl/curl.h>
 #include <json/json.h>
+#include <algorithm>
 #include <sstream>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 namespace hft {
 
+namespace {
+
+// Gateway -> I/O thread; plain data so enqueueing never allocates
+struct AsyncOrderRequest {
+    uint64_t order_id = 0;
+    char symbol[16] = {};
+    SignalAction action = SignalAction::BUY;
+    OrderType type = OrderType::MARKET;
+    double quantity = 0.0;
+    double limit_price = 0.0;
+    char replace_id[AlpacaClient::BROKER_ID_LENGTH] = {};  // Broker order to replace; "" places a new one
+    bool cancel_all = false;                                // DELETE /v2/orders; the rest is unused
+};
+
+struct AsyncOrderCompletion {
+    uint64_t order_id = 0;
+    AlpacaOrderResponse response{};
+};
+
+} // namespace
+
+// One easy handle per in-flight order. Handles are reused, so their options
+// (URL, headers, callbacks) are set once and the multi handle's connection
+// cache keeps the TLS sessions to the broker warm between orders.
+struct AlpacaClient::AsyncState {
+    struct Transfer {
+        CURL* easy = nullptr;
+        uint64_t order_id = 0;
+        bool cancel_all = false;
+        bool warm = false;      // Opening a connection at startup; completes to nobody
+        std::string url;
+        std::string payload;
+        std::string response;
+    };
+    
+    CURLM* multi = nullptr;
+    curl_slist* headers = nullptr;
+    std::string orders_url;
+    size_t connections = 0;
+    std::vector<Transfer> transfers;
+    std::vector<size_t> free_transfers;
+    
+    SPSCQueue<AsyncOrderRequest, AlpacaClient::MAX_INFLIGHT_ORDERS> requests;
+    SPSCQueue<AsyncOrderCompletion, AlpacaClient::MAX_INFLIGHT_ORDERS> completions;
+    std::atomic<size_t> inflight{0};    // Submitted and not yet polled
+    
+    std::atomic<bool> running{false};
+    std::thread io_thread;
+};
+
 // Callback for curl to write response data
 size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
     size_t newLength = size * nmemb;
@@ -27,6 +82,7 @@ AlpacaClient::AlpacaClient()
 }
 
 AlpacaClient::~AlpacaClient() {
+    stop_async();
     curl_global_cleanup();
 }
 
@@ -77,16 +133,7 @@ AlpacaOrderResponse AlpacaClient::submit_market_order(const std::string& symbol,
         return response;
     }
     
-    Json::Value order;
-    order["symbol"] = symbol;
-    order["qty"] = quantity;
-    order["side"] = side;
-    order["type"] = "market";
-    order["time_in_force"] = "day";
-    
-    Json::StreamWriterBuilder builder;
-    std::string payload = Json::writeString(builder, order);
-    
+    std::string payload = build_order_payload(symbol, side, quantity, AlpacaOrderType::MARKET, 0.0);
     std::string api_response = make_http_request("POST", "/v2/orders", payload);
     return parse_order_response(api_response);
 }
@@ -102,21 +149,298 @@ AlpacaOrderResponse AlpacaClient::submit_limit_order(const std::string& symbol,
         return response;
     }
     
-    Json::Value order;
-    order["symbol"] = symbol;
-    order["qty"] = quantity;
-    order["side"] = side;
-    order["type"] = "limit";
-    order["limit_price"] = limit_price;
-    order["time_in_force"] = "day";
-    
-    Json::StreamWriterBuilder builder;
-    std::string payload = Json::writeString(builder, order);
-    
+    std::string payload = build_order_payload(symbol, side, quantity, AlpacaOrderType::LIMIT, limit_price);
     std::string api_response = make_http_request("POST", "/v2/orders", payload);
     return parse_order_response(api_response);
 }
 
+bool AlpacaClient::start_async(size_t max_connections) {
+    if (async_) {
+        return true;
+    }
+    if (!connected_) {
+        logger_.error("Cannot start async order entry: Alpaca client not connected");
+        return false;
+    }
+    
+    auto state = std::make_unique<AsyncState>();
+    state->multi = curl_multi_init();
+    if (!state->multi) {
+        logger_.error("Failed to initialize curl multi handle");
+        return false;
+    }
+    
+    // Orders share max_connections sockets; with HTTP/2 they multiplex on one
+    curl_multi_setopt(state->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(state->multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_connections));
+    curl_multi_setopt(state->multi, CURLMOPT_MAXCONNECTS, static_cast<long>(max_connections));
+    
+    std::string key_header = "APCA-API-KEY-ID: " + api_key_;
+    std::string secret_header = "APCA-API-SECRET-KEY: " + api_secret_;
+    state->headers = curl_slist_append(state->headers, key_header.c_str());
+    state->headers = curl_slist_append(state->headers, secret_header.c_str());
+    state->headers = curl_slist_append(state->headers, "Content-Type: application/json");
+    
+    state->orders_url = base_url_ + "/v2/orders";
+    state->connections = std::min(max_connections, static_cast<size_t>(MAX_INFLIGHT_ORDERS));
+    state->transfers.resize(MAX_INFLIGHT_ORDERS);
+    for (size_t i = 0; i < state->transfers.size(); ++i) {
+        AsyncState::Transfer& transfer = state->transfers[i];
+        transfer.easy = curl_easy_init();
+        if (!transfer.easy) {
+            logger_.error("Failed to initialize curl handle for async order entry");
+            async_ = std::move(state);
+            stop_async();
+            return false;
+        }
+        curl_easy_setopt(transfer.easy, CURLOPT_HTTPHEADER, state->headers);
+        curl_easy_setopt(transfer.easy, CURLOPT_POST, 1L);
+        curl_easy_setopt(transfer.easy, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(transfer.easy, CURLOPT_WRITEDATA, &transfer.response);
+        curl_easy_setopt(transfer.easy, CURLOPT_PRIVATE, &transfer);
+        curl_easy_setopt(transfer.easy, CURLOPT_TIMEOUT, 30L);
+        curl_easy_setopt(transfer.easy, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(transfer.easy, CURLOPT_TCP_NODELAY, 1L);
+        curl_easy_setopt(transfer.easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(transfer.easy, CURLOPT_PIPEWAIT, 1L);   // Prefer multiplexing over a new socket
+        transfer.url.reserve(state->orders_url.size() + BROKER_ID_LENGTH + 1);
+        transfer.payload.reserve(256);
+        state->free_transfers.push_back(i);
+    }
+    
+    async_ = std::move(state);
+    async_->running.store(true, std::memory_order_release);
+    async_->io_thread = std::thread(&AlpacaClient::run_async_io, this);
+    
+    logger_.info("Async order entry started with " + std::to_string(max_connections) + " connections");
+    return true;
+}
+
+void AlpacaClient::stop_async() {
+    if (!async_) {
+        return;
+    }
+    
+    async_->running.store(false, std::memory_order_release);
+    if (async_->io_thread.joinable()) {
+        curl_multi_wakeup(async_->multi);
+        async_->io_thread.join();
+    }
+    
+    size_t abandoned = async_->transfers.size() - async_->free_transfers.size();
+    if (abandoned > 0) {
+        logger_.warning("Async order entry stopped with " + std::to_string(abandoned) + " orders in flight");
+    }
+    
+    for (auto& transfer : async_->transfers) {
+        if (transfer.easy) {
+            curl_multi_remove_handle(async_->multi, transfer.easy);
+            curl_easy_cleanup(transfer.easy);
+        }
+    }
+    curl_multi_cleanup(async_->multi);
+    curl_slist_free_all(async_->headers);
+    async_.reset();
+}
+
+bool AlpacaClient::submit_order_async(uint64_t order_id, const char* symbol, SignalAction action,
+                                      OrderType type, double quantity, double limit_price) {
+    if (!async_ || !async_->running.load(std::memory_order_acquire)) {
+        return false;
+    }
+    // Bounded by the transfer pool so completions always have queue room
+    if (async_->inflight.load(std::memory_order_relaxed) >= MAX_INFLIGHT_ORDERS) {
+        return false;
+    }
+    
+    AsyncOrderRequest request;
+    request.order_id = order_id;
+    std::strncpy(request.symbol, symbol, sizeof(request.symbol) - 1);
+    request.action = action;
+    request.type = type;
+    request.quantity = quantity;
+    request.limit_price = limit_price;
+    if (!async_->requests.try_enqueue(request)) {
+        return false;
+    }
+    
+    async_->inflight.fetch_add(1, std::memory_order_relaxed);
+    curl_multi_wakeup(async_->multi);
+    return true;
+}
+
+bool AlpacaClient::replace_order_async(uint64_t order_id, const char* broker_order_id,
+                                       double quantity, double limit_price) {
+    if (!async_ || !async_->running.load(std::memory_order_acquire)) {
+        return false;
+    }
+    size_t length = std::strlen(broker_order_id);
+    if (length == 0 || length >= BROKER_ID_LENGTH ||
+        async_->inflight.load(std::memory_order_relaxed) >= MAX_INFLIGHT_ORDERS) {
+        return false;
+    }
+    
+    AsyncOrderRequest request;
+    request.order_id = order_id;
+    request.type = OrderType::LIMIT;
+    request.quantity = quantity;
+    request.limit_price = limit_price;
+    std::memcpy(request.replace_id, broker_order_id, length + 1);
+    if (!async_->requests.try_enqueue(request)) {
+        return false;
+    }
+    
+    async_->inflight.fetch_add(1, std::memory_order_relaxed);
+    curl_multi_wakeup(async_->multi);
+    return true;
+}
+
+bool AlpacaClient::cancel_all_async() {
+    if (!async_ || !async_->running.load(std::memory_order_acquire) ||
+        async_->inflight.load(std::memory_order_relaxed) >= MAX_INFLIGHT_ORDERS) {
+        return false;
+    }
+    
+    AsyncOrderRequest request;
+    request.cancel_all = true;
+    if (!async_->requests.try_enqueue(request)) {
+        return false;
+    }
+    
+    async_->inflight.fetch_add(1, std::memory_order_relaxed);
+    curl_multi_wakeup(async_->multi);
+    return true;
+}
+
+size_t AlpacaClient::poll_completions(const OrderCompletionCallback& callback, size_t max_completions) {
+    if (!async_) {
+        return 0;
+    }
+    
+    size_t count = 0;
+    AsyncOrderCompletion completion;
+    while (count < max_completions && async_->completions.try_dequeue(completion)) {
+        async_->inflight.fetch_sub(1, std::memory_order_relaxed);
+        callback(completion.order_id, completion.response);
+        count++;
+    }
+    return count;
+}
+
+size_t AlpacaClient::inflight_orders() const {
+    return async_ ? async_->inflight.load(std::memory_order_relaxed) : 0;
+}
+
+void AlpacaClient::run_async_io() {
+    if (!ThreadPlan::instance().pin_current_thread("alpaca_io")) {
+        logger_.warning("Failed to pin alpaca_io thread to its planned CPU");
+    }
+    AsyncState& state = *async_;
+    
+    // Open the pool's connections now, TLS handshakes included, so the
+    // first order after a restart doesn't pay for them: a cheap GET per
+    // connection (they share one where the server multiplexes)
+    for (size_t i = 0; i < state.connections && !state.free_transfers.empty(); ++i) {
+        AsyncState::Transfer& transfer = state.transfers[state.free_transfers.back()];
+        state.free_transfers.pop_back();
+        transfer.warm = true;
+        transfer.response.clear();
+        transfer.url = base_url_ + "/v2/clock";
+        curl_easy_setopt(transfer.easy, CURLOPT_CUSTOMREQUEST, static_cast<const char*>(nullptr));
+        curl_easy_setopt(transfer.easy, CURLOPT_HTTPGET, 1L);
+        curl_easy_setopt(transfer.easy, CURLOPT_URL, transfer.url.c_str());
+        curl_multi_add_handle(state.multi, transfer.easy);
+    }
+    
+    while (state.running.load(std::memory_order_acquire)) {
+        // Start queued orders; the queue and the pool are the same size, so
+        // there is always a free transfer for every request
+        AsyncOrderRequest request;
+        while (!state.free_transfers.empty() && state.requests.try_dequeue(request)) {
+            size_t index = state.free_transfers.back();
+            state.free_transfers.pop_back();
+            
+            AsyncState::Transfer& transfer = state.transfers[index];
+            transfer.order_id = request.order_id;
+            transfer.cancel_all = request.cancel_all;
+            transfer.response.clear();
+            transfer.url = state.orders_url;
+            if (request.cancel_all) {
+                // One request for every open order, whatever the gateway knows of
+                transfer.payload.clear();
+                curl_easy_setopt(transfer.easy, CURLOPT_CUSTOMREQUEST, "DELETE");
+            } else if (request.replace_id[0] != '\0') {
+                // Replace: PATCH /v2/orders/{id}; the broker answers with the new order
+                transfer.url += '/';
+                transfer.url += request.replace_id;
+                transfer.payload = build_replace_payload(request.quantity, request.limit_price);
+                curl_easy_setopt(transfer.easy, CURLOPT_CUSTOMREQUEST, "PATCH");
+            } else {
+                AlpacaOrderType type = request.type == OrderType::LIMIT ? AlpacaOrderType::LIMIT : AlpacaOrderType::MARKET;
+                transfer.payload = build_order_payload(request.symbol, convert_signal_action_to_side(request.action),
+                                                       request.quantity, type, request.limit_price);
+                curl_easy_setopt(transfer.easy, CURLOPT_CUSTOMREQUEST, static_cast<const char*>(nullptr));
+            }
+            curl_easy_setopt(transfer.easy, CURLOPT_URL, transfer.url.c_str());
+            curl_easy_setopt(transfer.easy, CURLOPT_POSTFIELDS, transfer.payload.c_str());
+            curl_easy_setopt(transfer.easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer.payload.size()));
+            curl_multi_add_handle(state.multi, transfer.easy);
+        }
+        
+        int still_running = 0;
+        curl_multi_perform(state.multi, &still_running);
+        
+        CURLMsg* msg;
+        int msgs_left = 0;
+        while ((msg = curl_multi_info_read(state.multi, &msgs_left))) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            
+            AsyncState::Transfer* transfer = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+            long response_code = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &response_code);
+            
+            if (transfer->warm) {
+                if (msg->data.result != CURLE_OK) {
+                    logger_.warning("Could not pre-open an order connection: " +
+                                    std::string(curl_easy_strerror(msg->data.result)));
+                }
+                transfer->warm = false;
+                curl_easy_setopt(transfer->easy, CURLOPT_POST, 1L);
+                curl_multi_remove_handle(state.multi, msg->easy_handle);
+                state.free_transfers.push_back(static_cast<size_t>(transfer - state.transfers.data()));
+                continue;
+            }
+            
+            AsyncOrderCompletion completion;
+            completion.order_id = transfer->order_id;
+            if (msg->data.result != CURLE_OK) {
+                completion.response.error_message = "HTTP request failed: " +
+                                                    std::string(curl_easy_strerror(msg->data.result));
+            } else if (transfer->cancel_all) {
+                // The body is a status per order, not an order
+                if (response_code >= 400) {
+                    completion.response.error_message = "HTTP error " + std::to_string(response_code);
+                }
+            } else {
+                completion.response = parse_order_response(transfer->response);
+                if (completion.response.is_success() && response_code >= 400) {
+                    completion.response.error_message = "HTTP error " + std::to_string(response_code);
+                }
+            }
+            
+            curl_multi_remove_handle(state.multi, msg->easy_handle);
+            state.free_transfers.push_back(static_cast<size_t>(transfer - state.transfers.data()));
+            
+            // Can't overflow: completions are bounded by MAX_INFLIGHT_ORDERS
+            state.completions.try_enqueue(completion);
+        }
+        
+        // Sleeps until a socket is ready or submit_order_async wakes us
+        curl_multi_poll(state.multi, nullptr, 0, 100, nullptr);
+    }
+}
+
 AlpacaOrderResponse AlpacaClient::get_order_status(const std::string& order_id) {
     AlpacaOrderResponse response{};
     
@@ -309,6 +633,31 @@ AlpacaOrderResponse AlpacaClient::parse_order_response(const std::string& respon
     return result;
 }
 
+std::string AlpacaClient::build_order_payload(const std::string& symbol, const std::string& side, double quantity,
+                                              AlpacaOrderType type, double limit_price) {
+    Json::Value order;
+    order["symbol"] = symbol;
+    order["qty"] = quantity;
+    order["side"] = side;
+    order["type"] = type == AlpacaOrderType::LIMIT ? "limit" : "market";
+    if (type == AlpacaOrderType::LIMIT) {
+        order["limit_price"] = limit_price;
+    }
+    order["time_in_force"] = "day";
+    
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, order);
+}
+
+std::string AlpacaClient::build_replace_payload(double quantity, double limit_price) {
+    Json::Value order;
+    order["qty"] = quantity;
+    order["limit_price"] = limit_price;
+    
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, order);
+}
+
 std::string AlpacaClient::convert_signal_action_to_side(SignalAction action) {
     return (action == SignalAction::BUY) ? "buy" : "sell";
 }
@@ -72,6 +72,9 @@ struct AlpacaOrderResponse {
 // Callback for order status updates
 using OrderStatusCallback = std::function<void(const AlpacaOrderResponse&)>;
 
+// Result of an async submission, delivered on the thread that polls for it
+using OrderCompletionCallback = std::function<void(uint64_t order_id, const AlpacaOrderResponse&)>;
+
 class AlpacaClient {
 public:
     AlpacaClient();
@@ -91,6 +94,29 @@ public:
                                           double quantity, 
                                           double limit_price);
     
+    // Async order entry: orders are handed to an I/O thread that keeps a pool
+    // of keep-alive connections (HTTP/2 multiplexed where the server allows)
+    // and runs submissions concurrently. The caller never waits on the broker.
+    // The connections are opened as the I/O thread starts, not by the first order.
+    bool start_async(size_t max_connections);
+    void stop_async();
+    // false if async entry isn't running or MAX_INFLIGHT_ORDERS are pending
+    bool submit_order_async(uint64_t order_id, const char* symbol, SignalAction action,
+                            OrderType type, double quantity, double limit_price);
+    // Async cancel/replace of a working limit order, by the broker's order ID.
+    // Completes like a submission, with the replacement order in the response.
+    bool replace_order_async(uint64_t order_id, const char* broker_order_id,
+                             double quantity, double limit_price);
+    // Async cancel of every open order at the broker; completes with order
+    // ID 0 and no order in the response
+    bool cancel_all_async();
+    // Runs callback for each finished submission; returns how many ran
+    size_t poll_completions(const OrderCompletionCallback& callback, size_t max_completions = 64);
+    size_t inflight_orders() const;
+    
+    static constexpr size_t MAX_INFLIGHT_ORDERS = 256;
+    static constexpr size_t BROKER_ID_LENGTH = 48;     // As Order::BROKER_ID_LENGTH
+    
     AlpacaOrderResponse get_order_status(const std::string& order_id);
     AlpacaOrderResponse cancel_order(const std::string& order_id);
     
@@ -115,6 +141,11 @@ private:
     Logger logger_;
     OrderStatusCallback order_status_callback_;
     
+    // Async order entry state (curl multi handle, transfer pool, queues)
+    struct AsyncState;
+    std::unique_ptr<AsyncState> async_;
+    void run_async_io();
+    
     // HTTP client methods
     std::string make_http_request(const std::string& method, 
                                  const std::string& endpoint,
@@ -122,6 +153,9 @@ private:
     
     std::string get_auth_header();
     AlpacaOrderResponse parse_order_response(const std::string& response);
+    std::string build_order_payload(const std::string& symbol, const std::string& side, double quantity,
+                                    AlpacaOrderType type, double limit_price);
+    std::string build_replace_payload(double quantity, double limit_price);
     
     // Convert internal types to Alpaca format
     std::string convert_signal_action_to_side(SignalAction action);
@@ -0,0 +1,511 @@
+#pragma once
+
+#include "../common/fixed_price.h"
+#include "../common/message_types.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+
+namespace hft {
+namespace fix {
+
+// Tag=value encoding for FIX 4.2/4.4 order entry (see FixSession). Nothing
+// here allocates: outbound messages are MessageTemplates built once and
+// patched per send, inbound ones are parsed in place into views of the
+// receive buffer.
+
+constexpr char SOH = '\x01';
+
+// Tags the session and order entry use
+constexpr int ACCOUNT = 1;
+constexpr int BEGIN_SEQ_NO = 7;
+constexpr int BEGIN_STRING = 8;
+constexpr int BODY_LENGTH = 9;
+constexpr int CHECKSUM = 10;
+constexpr int CL_ORD_ID = 11;
+constexpr int CUM_QTY = 14;
+constexpr int END_SEQ_NO = 16;
+constexpr int HANDL_INST = 21;
+constexpr int LAST_PX = 31;
+constexpr int LAST_QTY = 32;
+constexpr int MSG_SEQ_NUM = 34;
+constexpr int MSG_TYPE = 35;
+constexpr int NEW_SEQ_NO = 36;
+constexpr int ORDER_ID = 37;
+constexpr int ORDER_QTY = 38;
+constexpr int ORD_STATUS = 39;
+constexpr int ORD_TYPE = 40;
+constexpr int ORIG_CL_ORD_ID = 41;
+constexpr int POSS_DUP_FLAG = 43;
+constexpr int PRICE = 44;
+constexpr int SENDER_COMP_ID = 49;
+constexpr int SENDING_TIME = 52;
+constexpr int SIDE = 54;
+constexpr int SYMBOL = 55;
+constexpr int TARGET_COMP_ID = 56;
+constexpr int TEXT = 58;
+constexpr int TIME_IN_FORCE = 59;
+constexpr int TRANSACT_TIME = 60;
+constexpr int ENCRYPT_METHOD = 98;
+constexpr int HEART_BT_INT = 108;
+constexpr int TEST_REQ_ID = 112;
+constexpr int ORIG_SENDING_TIME = 122;
+constexpr int GAP_FILL_FLAG = 123;
+constexpr int RESET_SEQ_NUM_FLAG = 141;
+constexpr int EXEC_TYPE = 150;
+constexpr int LEAVES_QTY = 151;
+constexpr int MASS_CANCEL_REQUEST_TYPE = 530;
+
+// MsgType (35)
+constexpr std::string_view HEARTBEAT = "0";
+constexpr std::string_view TEST_REQUEST = "1";
+constexpr std::string_view RESEND_REQUEST = "2";
+constexpr std::string_view REJECT = "3";
+constexpr std::string_view SEQUENCE_RESET = "4";
+constexpr std::string_view LOGOUT = "5";
+constexpr std::string_view EXECUTION_REPORT = "8";
+constexpr std::string_view ORDER_CANCEL_REJECT = "9";
+constexpr std::string_view LOGON = "A";
+constexpr std::string_view NEW_ORDER_SINGLE = "D";
+constexpr std::string_view ORDER_CANCEL_REPLACE_REQUEST = "G";
+constexpr std::string_view ORDER_MASS_CANCEL_REQUEST = "q";
+constexpr std::string_view ORDER_MASS_CANCEL_REPORT = "r";
+
+// ExecType (150); 1 and 2 are FIX 4.2's fills, F is 4.4's
+constexpr char EXEC_NEW = '0';
+constexpr char EXEC_PARTIAL_FILL = '1';
+constexpr char EXEC_FILL = '2';
+constexpr char EXEC_DONE_FOR_DAY = '3';
+constexpr char EXEC_CANCELED = '4';
+constexpr char EXEC_REPLACED = '5';
+constexpr char EXEC_REJECTED = '8';
+constexpr char EXEC_EXPIRED = 'C';
+constexpr char EXEC_TRADE = 'F';
+
+// Fixed widths of the patched fields. FIX allows leading zeros in int and
+// price fields, so a zero-padded value never changes the message length.
+constexpr size_t SEQ_NUM_WIDTH = 9;
+constexpr size_t TIMESTAMP_WIDTH = 21;     // YYYYMMDD-HH:MM:SS.sss
+constexpr size_t CL_ORD_ID_WIDTH = 21;     // <order ID, 16 digits>-<revision, 4 digits>
+constexpr size_t QUANTITY_WIDTH = 10;      // Any uint32_t
+constexpr size_t PRICE_WIDTH = 12;         // 7 integer digits, point, 4 decimals
+constexpr size_t CHECKSUM_WIDTH = 3;
+static_assert(PRICE_SCALE == 10000, "PRICE_WIDTH assumes four decimals");
+
+// Right-aligned and zero-padded; false if value has more than width digits
+inline bool write_digits(char* out, size_t width, uint64_t value) {
+    for (size_t i = width; i-- > 0;) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return value == 0;
+}
+
+// PRICE_WIDTH characters
+inline bool write_price(char* out, price_t price) {
+    if (price < 0) return false;
+    uint64_t value = static_cast<uint64_t>(price);
+    out[7] = '.';
+    write_digits(out + 8, 4, value % PRICE_SCALE);
+    return write_digits(out, 7, value / PRICE_SCALE);
+}
+
+// CL_ORD_ID_WIDTH characters. A replace needs a new ClOrdID, so each one
+// bumps the revision; the order ID stays how executions find the order.
+inline void write_cl_ord_id(char* out, uint64_t order_id, uint16_t revision) {
+    write_digits(out, 16, order_id);
+    out[16] = '-';
+    write_digits(out + 17, 4, revision % 10000);
+}
+
+inline bool parse_uint(std::string_view text, uint64_t& value) {
+    if (text.empty() || text.size() > 19) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+// Decimal to fixed-point without going through double; digits past the
+// fourth decimal are dropped
+inline bool parse_price(std::string_view text, price_t& price) {
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative) text.remove_prefix(1);
+    size_t point = text.find('.');
+    uint64_t whole = 0;
+    if (!parse_uint(text.substr(0, point), whole)) return false;
+    uint64_t fraction = 0;
+    if (point != std::string_view::npos) {
+        std::string_view decimals = text.substr(point + 1);
+        for (size_t i = 0; i < 4; ++i) {
+            char c = i < decimals.size() ? decimals[i] : '0';
+            if (c < '0' || c > '9') return false;
+            fraction = fraction * 10 + static_cast<uint64_t>(c - '0');
+        }
+        for (size_t i = 4; i < decimals.size(); ++i) {
+            if (decimals[i] < '0' || decimals[i] > '9') return false;
+        }
+    }
+    price = static_cast<price_t>(whole * PRICE_SCALE + fraction);
+    if (negative) price = -price;
+    return true;
+}
+
+inline bool parse_cl_ord_id(std::string_view text, uint64_t& order_id, uint16_t& revision) {
+    size_t dash = text.find('-');
+    uint64_t parsed_revision = 0;
+    if (dash == std::string_view::npos || !parse_uint(text.substr(0, dash), order_id) ||
+        !parse_uint(text.substr(dash + 1), parsed_revision) || parsed_revision > 9999) {
+        return false;
+    }
+    revision = static_cast<uint16_t>(parsed_revision);
+    return true;
+}
+
+// UTCTimestamp with milliseconds. The date and time of day are formatted
+// once a second; in between only the milliseconds are rewritten.
+class TimestampCache {
+public:
+    // TIMESTAMP_WIDTH characters, valid until the next call
+    const char* format(int64_t unix_ns) {
+        int64_t second = unix_ns / 1000000000;
+        if (second != cached_second_) {
+            time_t seconds = static_cast<time_t>(second);
+            tm parts{};
+            gmtime_r(&seconds, &parts);
+            std::strftime(text_, sizeof(text_), "%Y%m%d-%H:%M:%S", &parts);
+            text_[17] = '.';
+            cached_second_ = second;
+        }
+        write_digits(text_ + 18, 3, static_cast<uint64_t>(unix_ns / 1000000 % 1000));
+        return text_;
+    }
+
+private:
+    char text_[TIMESTAMP_WIDTH + 1] = {};
+    int64_t cached_second_ = -1;
+};
+
+// One outbound message, laid out once with a fixed-width slot for each
+// field that changes between sends. set_*() patch a slot in place and keep
+// the checksum current by adding the byte differences, so a send touches
+// only the changed bytes and the three checksum digits; BodyLength never
+// changes. Admin messages are built the same way and used once.
+//
+//     MessageTemplate order("FIX.4.4", NEW_ORDER_SINGLE);
+//     int seq = order.add_slot(MSG_SEQ_NUM, SEQ_NUM_WIDTH);
+//     order.add(SYMBOL, "AAPL");
+//     order.finish();
+//     order.set_digits(seq, 42);
+//     send(order.data(), order.size());
+class MessageTemplate {
+public:
+    static constexpr size_t CAPACITY = 512;
+    static constexpr size_t MAX_SLOTS = 12;
+
+    MessageTemplate(std::string_view begin_string, std::string_view msg_type)
+        : begin_string_(begin_string) {
+        add(MSG_TYPE, msg_type);
+    }
+
+    void add(int tag, std::string_view value) {
+        if (!append_tag(tag) || !append(value.data(), value.size()) || !append(&SOH, 1)) overflow_ = true;
+    }
+
+    void add(int tag, uint64_t value) {
+        char digits[20];
+        size_t width = 1;
+        for (uint64_t rest = value / 10; rest > 0; rest /= 10) ++width;
+        write_digits(digits, width, value);
+        add(tag, std::string_view(digits, width));
+    }
+
+    // A field of exactly width characters, zeros until set; -1 when full
+    int add_slot(int tag, size_t width) {
+        if (slot_count_ == MAX_SLOTS || !append_tag(tag)) {
+            overflow_ = true;
+            return -1;
+        }
+        slots_[slot_count_] = Slot{static_cast<uint16_t>(length_), static_cast<uint16_t>(width)};
+        for (size_t i = 0; i < width; ++i) {
+            if (!append("0", 1)) overflow_ = true;
+        }
+        if (!append(&SOH, 1)) overflow_ = true;
+        return static_cast<int>(slot_count_++);
+    }
+
+    // Moves the body behind the 8= and 9= header and adds the trailer; no
+    // add() after this. False if the message did not fit.
+    bool finish() {
+        if (overflow_) return false;
+        char header[64];
+        size_t header_length = 0;
+        auto put = [&](std::string_view text) {
+            std::memcpy(header + header_length, text.data(), text.size());
+            header_length += text.size();
+        };
+        char body_length[8];
+        size_t digits = 1;
+        for (size_t rest = length_ / 10; rest > 0; rest /= 10) ++digits;
+        write_digits(body_length, digits, length_);
+        if (begin_string_.size() > 32) return false;
+        put("8=");
+        put(begin_string_);
+        put(std::string_view(&SOH, 1));
+        put("9=");
+        put(std::string_view(body_length, digits));
+        put(std::string_view(&SOH, 1));
+        if (header_length + length_ + 4 + CHECKSUM_WIDTH > CAPACITY) return false;
+
+        std::memmove(buffer_.data() + header_length, buffer_.data(), length_);
+        std::memcpy(buffer_.data(), header, header_length);
+        for (size_t i = 0; i < slot_count_; ++i) {
+            slots_[i].offset = static_cast<uint16_t>(slots_[i].offset + header_length);
+        }
+        length_ += header_length;
+
+        sum_ = 0;
+        for (size_t i = 0; i < length_; ++i) sum_ = static_cast<uint8_t>(sum_ + static_cast<uint8_t>(buffer_[i]));
+        std::memcpy(buffer_.data() + length_, "10=", 3);
+        buffer_[length_ + 3 + CHECKSUM_WIDTH] = SOH;
+        checksum_offset_ = length_ + 3;
+        length_ += 4 + CHECKSUM_WIDTH;
+        write_checksum();
+        return true;
+    }
+
+    // Exactly the slot's width of bytes
+    void set(int slot, const char* bytes) {
+        const Slot& s = slots_[slot];
+        char* out = buffer_.data() + s.offset;
+        for (size_t i = 0; i < s.width; ++i) {
+            sum_ = static_cast<uint8_t>(sum_ + static_cast<uint8_t>(bytes[i]) - static_cast<uint8_t>(out[i]));
+            out[i] = bytes[i];
+        }
+        write_checksum();
+    }
+
+    bool set_digits(int slot, uint64_t value) {
+        char digits[32];
+        if (!write_digits(digits, slots_[slot].width, value)) return false;
+        set(slot, digits);
+        return true;
+    }
+
+    bool set_price(int slot, price_t price) {
+        char text[PRICE_WIDTH];
+        if (slots_[slot].width != PRICE_WIDTH || !write_price(text, price)) return false;
+        set(slot, text);
+        return true;
+    }
+
+    void set_char(int slot, char value) { set(slot, &value); }
+
+    const char* data() const { return buffer_.data(); }
+    size_t size() const { return length_; }
+
+private:
+    struct Slot {
+        uint16_t offset = 0;
+        uint16_t width = 0;
+    };
+
+    bool append(const char* bytes, size_t count) {
+        if (length_ + count > CAPACITY) return false;
+        std::memcpy(buffer_.data() + length_, bytes, count);
+        length_ += count;
+        return true;
+    }
+
+    bool append_tag(int tag) {
+        char digits[12];
+        size_t width = 1;
+        for (int rest = tag / 10; rest > 0; rest /= 10) ++width;
+        write_digits(digits, width, static_cast<uint64_t>(tag));
+        digits[width] = '=';
+        return append(digits, width + 1);
+    }
+
+    void write_checksum() {
+        if (checksum_offset_ != 0) write_digits(buffer_.data() + checksum_offset_, CHECKSUM_WIDTH, sum_);
+    }
+
+    std::string_view begin_string_;     // Outlives the template (the session's config)
+    std::array<char, CAPACITY> buffer_{};
+    size_t length_ = 0;
+    std::array<Slot, MAX_SLOTS> slots_{};
+    size_t slot_count_ = 0;
+    size_t checksum_offset_ = 0;
+    uint8_t sum_ = 0;                   // Of every byte before 10=
+    bool overflow_ = false;
+};
+
+// Length of the complete message at the start of data: 0 while more bytes
+// are needed, -1 if it does not start with 8= and 9= or its checksum is wrong
+inline ptrdiff_t frame(const char* data, size_t size, size_t max_body = 65536) {
+    if (size < 2) return 0;
+    if (data[0] != '8' || data[1] != '=') return -1;
+    const char* end = data + size;
+    const char* soh = static_cast<const char*>(std::memchr(data, SOH, size));
+    if (!soh) return size > 64 ? -1 : 0;
+    const char* length_field = soh + 1;
+    if (end - length_field < 2) return 0;
+    if (length_field[0] != '9' || length_field[1] != '=') return -1;
+    const char* length_soh = static_cast<const char*>(std::memchr(length_field, SOH, end - length_field));
+    if (!length_soh) return end - length_field > 12 ? -1 : 0;
+    uint64_t body = 0;
+    if (!parse_uint(std::string_view(length_field + 2, length_soh - length_field - 2), body) || body > max_body) {
+        return -1;
+    }
+
+    size_t before_trailer = static_cast<size_t>(length_soh + 1 - data) + body;
+    size_t total = before_trailer + 4 + CHECKSUM_WIDTH;
+    if (size < total) return 0;
+    const char* trailer = data + before_trailer;
+    uint64_t checksum = 0;
+    if (std::memcmp(trailer, "10=", 3) != 0 || trailer[3 + CHECKSUM_WIDTH] != SOH ||
+        !parse_uint(std::string_view(trailer + 3, CHECKSUM_WIDTH), checksum)) {
+        return -1;
+    }
+    uint8_t sum = 0;
+    for (size_t i = 0; i < before_trailer; ++i) sum = static_cast<uint8_t>(sum + static_cast<uint8_t>(data[i]));
+    return sum == checksum ? static_cast<ptrdiff_t>(total) : -1;
+}
+
+// The fields of one framed inbound message the session and gateway use,
+// from a single pass. Views point into the receive buffer.
+struct Message {
+    std::string_view msg_type;
+    std::string_view sender_comp_id;
+    std::string_view target_comp_id;
+    uint64_t seq_num = 0;
+    bool poss_dup = false;
+    bool gap_fill = false;
+    bool reset_seq_num = false;
+    uint64_t new_seq_no = 0;
+    uint64_t begin_seq_no = 0;
+    uint64_t end_seq_no = 0;
+    std::string_view test_req_id;
+    std::string_view text;
+
+    // ExecutionReport and OrderCancelReject
+    std::string_view cl_ord_id;
+    std::string_view orig_cl_ord_id;
+    std::string_view order_id;
+    std::string_view symbol;
+    char exec_type = 0;
+    char ord_status = 0;
+    price_t last_px = 0;
+    uint64_t last_qty = 0;
+    uint64_t leaves_qty = 0;
+    uint64_t cum_qty = 0;
+};
+
+// False if a field is not tag=value or a number does not parse
+inline bool parse(const char* data, size_t size, Message& message) {
+    message = Message{};
+    const char* end = data + size;
+    const char* field = data;
+    while (field < end) {
+        const char* soh = static_cast<const char*>(std::memchr(field, SOH, end - field));
+        if (!soh) return false;
+        const char* equals = static_cast<const char*>(std::memchr(field, '=', soh - field));
+        uint64_t tag = 0;
+        if (!equals || !parse_uint(std::string_view(field, equals - field), tag)) return false;
+        std::string_view value(equals + 1, soh - equals - 1);
+        field = soh + 1;
+
+        bool ok = true;
+        switch (tag) {
+            case MSG_TYPE: message.msg_type = value; break;
+            case SENDER_COMP_ID: message.sender_comp_id = value; break;
+            case TARGET_COMP_ID: message.target_comp_id = value; break;
+            case MSG_SEQ_NUM: ok = parse_uint(value, message.seq_num); break;
+            case POSS_DUP_FLAG: message.poss_dup = value == "Y"; break;
+            case GAP_FILL_FLAG: message.gap_fill = value == "Y"; break;
+            case RESET_SEQ_NUM_FLAG: message.reset_seq_num = value == "Y"; break;
+            case NEW_SEQ_NO: ok = parse_uint(value, message.new_seq_no); break;
+            case BEGIN_SEQ_NO: ok = parse_uint(value, message.begin_seq_no); break;
+            case END_SEQ_NO: ok = parse_uint(value, message.end_seq_no); break;
+            case TEST_REQ_ID: message.test_req_id = value; break;
+            case TEXT: message.text = value; break;
+            case CL_ORD_ID: message.cl_ord_id = value; break;
+            case ORIG_CL_ORD_ID: message.orig_cl_ord_id = value; break;
+            case ORDER_ID: message.order_id = value; break;
+            case SYMBOL: message.symbol = value; break;
+            case EXEC_TYPE: message.exec_type = value.empty() ? 0 : value[0]; break;
+            case ORD_STATUS: message.ord_status = value.empty() ? 0 : value[0]; break;
+            case LAST_PX: ok = parse_price(value, message.last_px); break;
+            // Quantities may be sent as decimals; shares are whole
+            case LAST_QTY: ok = parse_uint(value.substr(0, value.find('.')), message.last_qty); break;
+            case LEAVES_QTY: ok = parse_uint(value.substr(0, value.find('.')), message.leaves_qty); break;
+            case CUM_QTY: ok = parse_uint(value.substr(0, value.find('.')), message.cum_qty); break;
+            default: break;
+        }
+        if (!ok) return false;
+    }
+    return !message.msg_type.empty();
+}
+
+// An ExecutionReport or OrderCancelReject for one of our orders
+struct ExecutionReport {
+    uint64_t order_id = 0;              // From ClOrdID
+    uint16_t revision = 0;
+    char exec_type = 0;                 // ExecType; 0 for a cancel reject
+    bool cancel_reject = false;         // A refused replace: the order stands as it was
+    std::string_view broker_order_id;   // OrderID
+    std::string_view text;
+    // Symbol, fill and leaves; the gateway adds the header, symbol ID and
+    // trace from its order
+    OrderExecution execution{};
+};
+
+// False if the message is neither, or its ClOrdID is not one of ours
+inline bool decode_execution_report(const Message& message, ExecutionReport& report) {
+    report = ExecutionReport{};
+    report.cancel_reject = message.msg_type == ORDER_CANCEL_REJECT;
+    if (message.msg_type != EXECUTION_REPORT && !report.cancel_reject) return false;
+    if (!parse_cl_ord_id(message.cl_ord_id, report.order_id, report.revision)) return false;
+    report.exec_type = report.cancel_reject ? 0 : message.exec_type;
+    report.broker_order_id = message.order_id;
+    report.text = message.text;
+
+    OrderExecution& execution = report.execution;
+    execution.order_id = report.order_id;
+    std::memcpy(execution.symbol, message.symbol.data(), std::min(message.symbol.size(), sizeof(execution.symbol) - 1));
+    execution.fill_price = message.last_px;
+    execution.fill_quantity = static_cast<uint32_t>(message.last_qty);
+    execution.remaining_quantity = static_cast<uint32_t>(message.leaves_qty);
+    switch (report.exec_type) {
+        case EXEC_PARTIAL_FILL:
+            execution.exec_type = ExecutionType::PARTIAL_FILL;
+            break;
+        case EXEC_FILL:
+            execution.exec_type = ExecutionType::FILL;
+            break;
+        case EXEC_TRADE:
+            execution.exec_type = message.leaves_qty > 0 ? ExecutionType::PARTIAL_FILL : ExecutionType::FILL;
+            break;
+        case EXEC_CANCELED:
+        case EXEC_EXPIRED:
+        case EXEC_DONE_FOR_DAY:
+            execution.exec_type = ExecutionType::CANCELLED;
+            break;
+        case EXEC_REJECTED:
+            execution.exec_type = ExecutionType::REJECTED;
+            break;
+        default:
+            execution.exec_type = ExecutionType::NEW;
+            break;
+    }
+    return true;
+}
+
+} // namespace fix
+} // namespace hft
@@ -0,0 +1,592 @@
+#include "fix_session.h"
+
+#include "../common/static_config.h"
+#include "../common/symbol_table.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace hft {
+
+namespace {
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t unix_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+constexpr int64_t NS_PER_SECOND = 1000000000;
+
+} // namespace
+
+FixSessionConfig FixSessionConfig::from_config() {
+    FixSessionConfig config;
+    config.host = StaticConfig::get_fix_host();
+    config.port = StaticConfig::get_fix_port();
+    config.begin_string = StaticConfig::get_fix_begin_string();
+    config.sender_comp_id = StaticConfig::get_fix_sender_comp_id();
+    config.target_comp_id = StaticConfig::get_fix_target_comp_id();
+    config.account = StaticConfig::get_fix_account();
+    config.heartbeat_interval_seconds = StaticConfig::get_fix_heartbeat_interval_seconds();
+    config.reconnect_interval_seconds = StaticConfig::get_fix_reconnect_interval_seconds();
+    config.reset_on_logon = StaticConfig::get_fix_reset_on_logon();
+    if (!config.sender_comp_id.empty() && !config.target_comp_id.empty()) {
+        config.sequence_file = StaticConfig::get_journal_directory() + "/fix_" + config.sender_comp_id + "_" +
+                               config.target_comp_id + ".seq";
+    }
+    return config;
+}
+
+std::string FixSessionConfig::validate() const {
+    if (host.empty()) return "fix.host is not set";
+    if (port <= 0 || port > 65535) return "fix.port must be 1-65535";
+    if (begin_string != "FIX.4.2" && begin_string != "FIX.4.4") return "fix.begin_string must be FIX.4.2 or FIX.4.4";
+    if (sender_comp_id.empty() || target_comp_id.empty()) return "fix.sender_comp_id and fix.target_comp_id are required";
+    if (heartbeat_interval_seconds <= 0) return "fix.heartbeat_interval_seconds must be positive";
+    return "";
+}
+
+FixSequenceStore::~FixSequenceStore() {
+    close();
+}
+
+bool FixSequenceStore::open(const std::string& path) {
+    close();
+    std::error_code ignored;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ignored);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    struct stat info{};
+    bool fresh = fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Record));
+    if (fresh && ftruncate(fd, sizeof(Record)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, sizeof(Record), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    mapping_ = mapping;
+    record_ = static_cast<Record*>(mapping);
+    if (fresh || record_->magic != MAGIC) {
+        record_->magic = MAGIC;
+        reset();
+    }
+    return true;
+}
+
+void FixSequenceStore::close() {
+    if (!mapping_) return;
+    memory_ = *record_;
+    msync(mapping_, sizeof(Record), MS_SYNC);
+    munmap(mapping_, sizeof(Record));
+    mapping_ = nullptr;
+    record_ = &memory_;
+}
+
+FixSession::FixSession(const FixSessionConfig& config, std::pmr::memory_resource* memory)
+    : config_(config)
+    , logger_("FixSession", StaticConfig::get_logger_endpoint())
+    , templates_(memory)
+    , template_index_(SymbolTable::MAX_SYMBOLS, -1, memory)
+    , heartbeat_(begin_message(fix::HEARTBEAT))
+    , mass_cancel_(begin_message(fix::ORDER_MASS_CANCEL_REQUEST)) {
+    heartbeat_.finish();
+    mass_cancel_.add_slot(fix::CL_ORD_ID, fix::CL_ORD_ID_WIDTH);      // SLOT_CL_ORD_ID
+    mass_cancel_.add(fix::MASS_CANCEL_REQUEST_TYPE, "7");            // All orders
+    mass_cancel_time_slot_ = mass_cancel_.add_slot(fix::TRANSACT_TIME, fix::TIMESTAMP_WIDTH);
+    mass_cancel_.finish();
+    templates_.reserve(256);
+}
+
+FixSession::~FixSession() {
+    stop();
+}
+
+bool FixSession::start() {
+    std::string error = config_.validate();
+    if (!error.empty()) {
+        logger_.error("FIX session not started: " + error);
+        return false;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(config_.host.c_str(), std::to_string(config_.port).c_str(), &hints, &result);
+    if (rc != 0 || !result) {
+        logger_.error("FIX session: cannot resolve " + config_.host + ": " + gai_strerror(rc));
+        return false;
+    }
+    std::memcpy(&address_, result->ai_addr, result->ai_addrlen);
+    address_length_ = static_cast<socklen_t>(result->ai_addrlen);
+    freeaddrinfo(result);
+
+    if (!config_.sequence_file.empty() && !sequences_.open(config_.sequence_file)) {
+        logger_.warning("FIX sequence numbers kept in memory only; cannot map " + config_.sequence_file);
+    }
+    logger_.info("FIX session " + config_.sender_comp_id + " -> " + config_.target_comp_id + " at " +
+                 config_.host + ":" + std::to_string(config_.port) + ", next sequence numbers " +
+                 std::to_string(sequences_.next_outgoing()) + " out, " +
+                 std::to_string(sequences_.next_incoming()) + " in");
+    return true;
+}
+
+void FixSession::stop() {
+    if (state_ == State::LOGGED_ON) {
+        int64_t now_ns = steady_now_ns();
+        send_logout("", now_ns);
+        // The counterparty's Logout closes the session
+        int64_t deadline = now_ns + NS_PER_SECOND;
+        while (fd_ >= 0 && steady_now_ns() < deadline) {
+            flush();
+            read_messages(steady_now_ns());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (fd_ >= 0) {
+        disconnect("session stopped");
+    }
+    sequences_.close();
+}
+
+void FixSession::poll(int64_t now_ns) {
+    switch (state_) {
+        case State::DISCONNECTED:
+            if (address_length_ != 0 && now_ns >= next_connect_ns_) {
+                connect(now_ns);
+            }
+            return;
+        case State::CONNECTING:
+            finish_connect(now_ns);
+            return;
+        default:
+            break;
+    }
+    flush();
+    if (fd_ >= 0) read_messages(now_ns);
+    if (fd_ >= 0) check_heartbeat(now_ns);
+}
+
+void FixSession::connect(int64_t now_ns) {
+    fd_ = ::socket(address_.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        disconnect(std::string("socket: ") + std::strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    state_ = State::CONNECTING;
+    awaiting_since_ns_ = now_ns;
+    if (::connect(fd_, reinterpret_cast<const sockaddr*>(&address_), address_length_) == 0) {
+        finish_connect(now_ns);
+    } else if (errno != EINPROGRESS) {
+        disconnect(std::string("connect: ") + std::strerror(errno));
+    }
+}
+
+void FixSession::finish_connect(int64_t now_ns) {
+    pollfd writable{fd_, POLLOUT, 0};
+    if (::poll(&writable, 1, 0) == 0) {
+        if (now_ns - awaiting_since_ns_ > config_.heartbeat_interval_seconds * NS_PER_SECOND) {
+            disconnect("connect timed out");
+        }
+        return;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        disconnect(std::string("connect: ") + std::strerror(error));
+        return;
+    }
+    send_logon(now_ns);
+}
+
+void FixSession::disconnect(const std::string& reason) {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        logger_.warning("FIX session disconnected: " + reason);
+    }
+    state_ = State::DISCONNECTED;
+    in_size_ = 0;
+    out_size_ = 0;
+    test_request_pending_ = false;
+    resend_requested_to_ = 0;
+    next_connect_ns_ = steady_now_ns() + config_.reconnect_interval_seconds * NS_PER_SECOND;
+}
+
+void FixSession::read_messages(int64_t now_ns) {
+    for (;;) {
+        if (in_size_ == in_.size()) {
+            disconnect("message larger than the receive buffer");
+            return;
+        }
+        ssize_t received = ::recv(fd_, in_.data() + in_size_, in_.size() - in_size_, MSG_DONTWAIT);
+        if (received == 0) {
+            disconnect("connection closed by the counterparty");
+            return;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            disconnect(std::string("recv: ") + std::strerror(errno));
+            return;
+        }
+        in_size_ += static_cast<size_t>(received);
+
+        size_t offset = 0;
+        while (offset < in_size_) {
+            ptrdiff_t length = fix::frame(in_.data() + offset, in_size_ - offset, BUFFER_SIZE);
+            if (length == 0) break;
+            fix::Message message;
+            if (length < 0 || !fix::parse(in_.data() + offset, static_cast<size_t>(length), message)) {
+                disconnect("garbled message");
+                return;
+            }
+            offset += static_cast<size_t>(length);
+            messages_received_++;
+            last_received_ns_ = now_ns;
+            test_request_pending_ = false;
+            handle_message(message, now_ns);
+            if (fd_ < 0) return;
+        }
+        std::memmove(in_.data(), in_.data() + offset, in_size_ - offset);
+        in_size_ -= offset;
+    }
+}
+
+void FixSession::handle_message(const fix::Message& message, int64_t now_ns) {
+    if (message.msg_type == fix::LOGON && message.reset_seq_num) {
+        sequences_.set_next_incoming(message.seq_num);
+    }
+    // Gap fill or reset, the next message is NewSeqNo either way
+    if (message.msg_type == fix::SEQUENCE_RESET) {
+        if (message.new_seq_no > sequences_.next_incoming()) {
+            sequences_.set_next_incoming(message.new_seq_no);
+        }
+        return;
+    }
+
+    uint64_t expected = sequences_.next_incoming();
+    if (message.seq_num < expected) {
+        if (message.poss_dup) return;
+        logger_.error("FIX MsgSeqNum " + std::to_string(message.seq_num) + " below the expected " +
+                      std::to_string(expected));
+        send_logout("MsgSeqNum too low, expecting " + std::to_string(expected), now_ns);
+        disconnect("sequence number too low");
+        return;
+    }
+    if (message.seq_num > expected) {
+        // Asked for once (through the latest); what follows the gap is
+        // dropped and comes back with the resend
+        if (resend_requested_to_ < expected) {
+            send_resend_request(expected, now_ns);
+            resend_requested_to_ = message.seq_num;
+        }
+        if (message.msg_type == fix::LOGON && state_ == State::LOGON_SENT) {
+            state_ = State::LOGGED_ON;
+            logger_.info("FIX session logged on, recovering from sequence number " + std::to_string(expected));
+        } else if (message.msg_type == fix::LOGOUT) {
+            disconnect("logout: " + std::string(message.text));
+        }
+        return;
+    }
+    sequences_.set_next_incoming(expected + 1);
+
+    if (message.msg_type == fix::LOGON) {
+        if (state_ == State::LOGON_SENT) {
+            state_ = State::LOGGED_ON;
+            logger_.info("FIX session logged on, next sequence numbers " +
+                         std::to_string(sequences_.next_outgoing()) + " out, " +
+                         std::to_string(sequences_.next_incoming()) + " in");
+        }
+    } else if (message.msg_type == fix::TEST_REQUEST) {
+        send_heartbeat(message.test_req_id, now_ns);
+    } else if (message.msg_type == fix::RESEND_REQUEST) {
+        send_gap_fill(message.begin_seq_no, now_ns);
+    } else if (message.msg_type == fix::REJECT) {
+        logger_.warning("FIX session reject: " + std::string(message.text));
+    } else if (message.msg_type == fix::LOGOUT) {
+        if (state_ != State::LOGOUT_SENT) {
+            send_logout("", now_ns);
+        }
+        disconnect("logout" + (message.text.empty() ? std::string() : ": " + std::string(message.text)));
+    } else if (message.msg_type == fix::ORDER_MASS_CANCEL_REPORT) {
+        // The cancels themselves come as execution reports
+        logger_.info("FIX mass cancel acknowledged" +
+                     (message.text.empty() ? std::string() : ": " + std::string(message.text)));
+    } else if (message.msg_type == fix::EXECUTION_REPORT || message.msg_type == fix::ORDER_CANCEL_REJECT) {
+        fix::ExecutionReport report;
+        if (!fix::decode_execution_report(message, report)) {
+            logger_.warning("FIX report for a ClOrdID not ours: " + std::string(message.cl_ord_id));
+        } else if (report_handler_) {
+            report_handler_(report);
+        }
+    }
+}
+
+void FixSession::check_heartbeat(int64_t now_ns) {
+    int64_t interval = config_.heartbeat_interval_seconds * NS_PER_SECOND;
+    if (state_ == State::LOGON_SENT || state_ == State::LOGOUT_SENT) {
+        if (now_ns - awaiting_since_ns_ > interval) {
+            disconnect(state_ == State::LOGON_SENT ? "no logon reply" : "no logout reply");
+        }
+        return;
+    }
+    if (now_ns - last_sent_ns_ >= interval) {
+        send_heartbeat({}, now_ns);
+    }
+    // Quiet for a heartbeat and a fifth: ask. Quiet for another: give up.
+    int64_t quiet = now_ns - last_received_ns_;
+    if (!test_request_pending_ && quiet >= interval + interval / 5) {
+        send_test_request(now_ns);
+        test_request_pending_ = true;
+    } else if (test_request_pending_ && quiet >= 2 * interval + interval / 5) {
+        disconnect("heartbeat timeout");
+    }
+}
+
+fix::MessageTemplate FixSession::begin_message(std::string_view msg_type) const {
+    fix::MessageTemplate message(config_.begin_string, msg_type);
+    message.add(fix::SENDER_COMP_ID, config_.sender_comp_id);
+    message.add(fix::TARGET_COMP_ID, config_.target_comp_id);
+    message.add_slot(fix::MSG_SEQ_NUM, fix::SEQ_NUM_WIDTH);          // SLOT_SEQ_NUM
+    message.add_slot(fix::SENDING_TIME, fix::TIMESTAMP_WIDTH);       // SLOT_SENDING_TIME
+    return message;
+}
+
+FixSession::SymbolTemplates* FixSession::templates_for(const Order& order) {
+    if (order.symbol_id >= template_index_.size()) return nullptr;
+    int32_t& index = template_index_[order.symbol_id];
+    if (index >= 0) return &templates_[index];
+
+    // Same slot numbers in all three; market orders carry no price
+    auto build = [&](std::string_view msg_type, char ord_type, bool price, bool replace) {
+        fix::MessageTemplate message = begin_message(msg_type);
+        message.add_slot(fix::CL_ORD_ID, fix::CL_ORD_ID_WIDTH);      // SLOT_CL_ORD_ID
+        if (!config_.account.empty()) message.add(fix::ACCOUNT, config_.account);
+        message.add(fix::HANDL_INST, "1");
+        message.add(fix::SYMBOL, std::string_view(order.symbol, strnlen(order.symbol, sizeof(order.symbol))));
+        message.add_slot(fix::SIDE, 1);                              // SLOT_SIDE
+        message.add_slot(fix::TRANSACT_TIME, fix::TIMESTAMP_WIDTH);  // SLOT_TRANSACT_TIME
+        message.add_slot(fix::ORDER_QTY, fix::QUANTITY_WIDTH);       // SLOT_QUANTITY
+        message.add(fix::ORD_TYPE, std::string_view(&ord_type, 1));
+        if (price) message.add_slot(fix::PRICE, fix::PRICE_WIDTH);   // SLOT_PRICE
+        message.add(fix::TIME_IN_FORCE, "0");
+        if (replace) message.add_slot(fix::ORIG_CL_ORD_ID, fix::CL_ORD_ID_WIDTH);  // SLOT_ORIG_CL_ORD_ID
+        message.finish();
+        return message;
+    };
+    templates_.push_back(SymbolTemplates{
+        build(fix::NEW_ORDER_SINGLE, '1', false, false),
+        build(fix::NEW_ORDER_SINGLE, '2', true, false),
+        build(fix::ORDER_CANCEL_REPLACE_REQUEST, '2', true, true)});
+    index = static_cast<int32_t>(templates_.size() - 1);
+    return &templates_.back();
+}
+
+const char* FixSession::now_timestamp() {
+    return timestamps_.format(unix_now_ns());
+}
+
+bool FixSession::send_new_order(const Order& order) {
+    if (state_ != State::LOGGED_ON || (order.type != OrderType::MARKET && order.type != OrderType::LIMIT)) {
+        return false;
+    }
+    SymbolTemplates* templates = templates_for(order);
+    if (!templates) return false;
+    fix::MessageTemplate& message = order.type == OrderType::MARKET ? templates->market : templates->limit;
+
+    char cl_ord_id[fix::CL_ORD_ID_WIDTH];
+    fix::write_cl_ord_id(cl_ord_id, order.order_id, order.revision);
+    message.set(SLOT_CL_ORD_ID, cl_ord_id);
+    message.set_char(SLOT_SIDE, order.action == SignalAction::BUY ? '1' : '2');
+    if (!message.set_digits(SLOT_QUANTITY, order.quantity)) return false;
+    if (order.type == OrderType::LIMIT && !message.set_price(SLOT_PRICE, order.price)) return false;
+    const char* timestamp = now_timestamp();
+    message.set(SLOT_TRANSACT_TIME, timestamp);
+    return send_message(message, steady_now_ns(), timestamp);
+}
+
+bool FixSession::send_replace(const Order& order) {
+    if (state_ != State::LOGGED_ON || order.revision == 0) return false;
+    SymbolTemplates* templates = templates_for(order);
+    if (!templates) return false;
+    fix::MessageTemplate& message = templates->replace;
+
+    char cl_ord_id[fix::CL_ORD_ID_WIDTH];
+    fix::write_cl_ord_id(cl_ord_id, order.order_id, order.revision);
+    message.set(SLOT_CL_ORD_ID, cl_ord_id);
+    fix::write_cl_ord_id(cl_ord_id, order.order_id, static_cast<uint16_t>(order.revision - 1));
+    message.set(SLOT_ORIG_CL_ORD_ID, cl_ord_id);
+    message.set_char(SLOT_SIDE, order.action == SignalAction::BUY ? '1' : '2');
+    if (!message.set_digits(SLOT_QUANTITY, order.quantity) || !message.set_price(SLOT_PRICE, order.price)) {
+        return false;
+    }
+    const char* timestamp = now_timestamp();
+    message.set(SLOT_TRANSACT_TIME, timestamp);
+    return send_message(message, steady_now_ns(), timestamp);
+}
+
+bool FixSession::send_mass_cancel() {
+    if (state_ != State::LOGGED_ON) return false;
+    char cl_ord_id[fix::CL_ORD_ID_WIDTH];
+    fix::write_cl_ord_id(cl_ord_id, 0, ++mass_cancels_sent_);
+    mass_cancel_.set(SLOT_CL_ORD_ID, cl_ord_id);
+    const char* timestamp = now_timestamp();
+    mass_cancel_.set(mass_cancel_time_slot_, timestamp);
+    return send_message(mass_cancel_, steady_now_ns(), timestamp);
+}
+
+bool FixSession::send_message(fix::MessageTemplate& message, int64_t now_ns, const char* timestamp) {
+    uint64_t seq = sequences_.next_outgoing();
+    if (!message.set_digits(SLOT_SEQ_NUM, seq)) {
+        disconnect("outgoing sequence numbers exhausted");
+        return false;
+    }
+    message.set(SLOT_SENDING_TIME, timestamp);
+    if (!write_out(message.data(), message.size())) return false;
+    sequences_.set_next_outgoing(seq + 1);
+    last_sent_ns_ = now_ns;
+    messages_sent_++;
+    return true;
+}
+
+bool FixSession::write_out(const char* data, size_t size) {
+    if (fd_ < 0) return false;
+    size_t sent = 0;
+    if (out_size_ == 0) {
+        ssize_t written = ::send(fd_, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            disconnect(std::string("send: ") + std::strerror(errno));
+            return false;
+        }
+        sent = written > 0 ? static_cast<size_t>(written) : 0;
+    }
+    // Behind what is already queued, to keep the order
+    if (sent < size) {
+        if (out_size_ + size - sent > out_.size()) {
+            disconnect("send backlog full");
+            return false;
+        }
+        std::memcpy(out_.data() + out_size_, data + sent, size - sent);
+        out_size_ += size - sent;
+    }
+    return true;
+}
+
+void FixSession::flush() {
+    if (out_size_ == 0 || fd_ < 0) return;
+    ssize_t written = ::send(fd_, out_.data(), out_size_, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            disconnect(std::string("send: ") + std::strerror(errno));
+        }
+        return;
+    }
+    std::memmove(out_.data(), out_.data() + written, out_size_ - static_cast<size_t>(written));
+    out_size_ -= static_cast<size_t>(written);
+}
+
+void FixSession::send_logon(int64_t now_ns) {
+    if (config_.reset_on_logon) {
+        sequences_.reset();
+    }
+    fix::MessageTemplate logon = begin_message(fix::LOGON);
+    logon.add(fix::ENCRYPT_METHOD, "0");
+    logon.add(fix::HEART_BT_INT, static_cast<uint64_t>(config_.heartbeat_interval_seconds));
+    if (config_.reset_on_logon) {
+        logon.add(fix::RESET_SEQ_NUM_FLAG, "Y");
+    }
+    logon.finish();
+    state_ = State::LOGON_SENT;
+    awaiting_since_ns_ = now_ns;
+    last_received_ns_ = now_ns;
+    send_message(logon, now_ns, now_timestamp());
+}
+
+void FixSession::send_logout(std::string_view text, int64_t now_ns) {
+    fix::MessageTemplate logout = begin_message(fix::LOGOUT);
+    if (!text.empty()) {
+        logout.add(fix::TEXT, text);
+    }
+    logout.finish();
+    if (send_message(logout, now_ns, now_timestamp())) {
+        state_ = State::LOGOUT_SENT;
+        awaiting_since_ns_ = now_ns;
+    }
+}
+
+void FixSession::send_heartbeat(std::string_view test_req_id, int64_t now_ns) {
+    if (test_req_id.empty()) {
+        send_message(heartbeat_, now_ns, now_timestamp());
+        return;
+    }
+    fix::MessageTemplate heartbeat = begin_message(fix::HEARTBEAT);
+    heartbeat.add(fix::TEST_REQ_ID, test_req_id);
+    heartbeat.finish();
+    send_message(heartbeat, now_ns, now_timestamp());
+}
+
+void FixSession::send_test_request(int64_t now_ns) {
+    fix::MessageTemplate request = begin_message(fix::TEST_REQUEST);
+    request.add(fix::TEST_REQ_ID, static_cast<uint64_t>(now_ns));
+    request.finish();
+    send_message(request, now_ns, now_timestamp());
+}
+
+void FixSession::send_resend_request(uint64_t from, int64_t now_ns) {
+    fix::MessageTemplate request = begin_message(fix::RESEND_REQUEST);
+    request.add(fix::BEGIN_SEQ_NO, from);
+    request.add(fix::END_SEQ_NO, uint64_t{0});  // Through the latest
+    request.finish();
+    if (send_message(request, now_ns, now_timestamp())) {
+        resend_requests_sent_++;
+        logger_.warning("FIX sequence gap: resend requested from " + std::to_string(from));
+    }
+}
+
+void FixSession::send_gap_fill(uint64_t from, int64_t now_ns) {
+    uint64_t next = sequences_.next_outgoing();
+    if (from == 0 || from >= next) return;
+
+    // Takes the first resent number, not a new one
+    fix::MessageTemplate fill = begin_message(fix::SEQUENCE_RESET);
+    int orig_sending_time = fill.add_slot(fix::ORIG_SENDING_TIME, fix::TIMESTAMP_WIDTH);
+    fill.add(fix::POSS_DUP_FLAG, "Y");
+    fill.add(fix::GAP_FILL_FLAG, "Y");
+    fill.add(fix::NEW_SEQ_NO, next);
+    fill.finish();
+    const char* timestamp = now_timestamp();
+    fill.set_digits(SLOT_SEQ_NUM, from);
+    fill.set(SLOT_SENDING_TIME, timestamp);
+    fill.set(orig_sending_time, timestamp);
+    if (write_out(fill.data(), fill.size())) {
+        last_sent_ns_ = now_ns;
+        messages_sent_++;
+        gap_fills_sent_++;
+        logger_.info("FIX resend of " + std::to_string(from) + "-" + std::to_string(next - 1) + " answered with a gap fill");
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../common/logging.h"
+#include "fix_codec.h"
+#include "order_table.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+namespace hft {
+
+struct FixSessionConfig {
+    std::string host;
+    int port = 0;
+    std::string begin_string = "FIX.4.4";      // Or FIX.4.2
+    std::string sender_comp_id;
+    std::string target_comp_id;
+    std::string account;                       // Account (1) on orders when set
+    int heartbeat_interval_seconds = 30;
+    int reconnect_interval_seconds = 5;
+    bool reset_on_logon = false;               // ResetSeqNumFlag: both sides start again at 1
+    std::string sequence_file;                 // "" keeps sequence numbers in memory only
+
+    // fix.* in hft_config.conf, with the sequence file in journal.directory
+    static FixSessionConfig from_config();
+    // Empty if the session can start, else what is missing
+    std::string validate() const;
+};
+
+// Next outgoing and expected incoming MsgSeqNum, in a page of a shared file
+// mapping: updated with plain stores, so a send costs no syscall, and kept
+// by the page cache across a process restart.
+class FixSequenceStore {
+public:
+    FixSequenceStore() = default;
+    ~FixSequenceStore();
+    FixSequenceStore(const FixSequenceStore&) = delete;
+    FixSequenceStore& operator=(const FixSequenceStore&) = delete;
+
+    // Maps path, creating it at 1 and 1; false (and memory only) on failure
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t next_outgoing() const { return record_->next_outgoing; }
+    uint64_t next_incoming() const { return record_->next_incoming; }
+    void set_next_outgoing(uint64_t seq) { record_->next_outgoing = seq; }
+    void set_next_incoming(uint64_t seq) { record_->next_incoming = seq; }
+    void reset() {
+        record_->next_outgoing = 1;
+        record_->next_incoming = 1;
+    }
+
+private:
+    struct Record {
+        uint64_t magic;
+        uint64_t next_outgoing;
+        uint64_t next_incoming;
+    };
+    static constexpr uint64_t MAGIC = 0x3153514E58494648ULL;   // "HFIXNQS1"
+
+    Record memory_{MAGIC, 1, 1};
+    Record* record_ = &memory_;
+    void* mapping_ = nullptr;
+};
+
+// FIX 4.2/4.4 initiator session for order entry, driven from the gateway's
+// processing thread: poll() connects (non-blocking, TCP_NODELAY), logs on,
+// keeps the heartbeat, answers test and resend requests and hands each
+// ExecutionReport or OrderCancelReject to the report handler. Orders go
+// out from the caller's thread with one send(): NewOrderSingle and
+// OrderCancelReplaceRequest come from per-symbol MessageTemplates, so only
+// the sequence number, times, ClOrdID, side, size and price are written.
+//
+// A ResendRequest is answered with a gap fill, never by replaying orders:
+// an order too old to have arrived is not one to send again late.
+class FixSession {
+public:
+    enum class State : uint8_t {
+        DISCONNECTED,
+        CONNECTING,
+        LOGON_SENT,
+        LOGGED_ON,
+        LOGOUT_SENT
+    };
+
+    using ReportHandler = std::function<void(const fix::ExecutionReport&)>;
+
+    static constexpr size_t BUFFER_SIZE = 65536;
+
+    explicit FixSession(const FixSessionConfig& config,
+                        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    ~FixSession();
+    FixSession(const FixSession&) = delete;
+    FixSession& operator=(const FixSession&) = delete;
+
+    // Resolves the host and opens the sequence store; no I/O until poll()
+    bool start();
+    // Logs out (briefly waiting for the reply) and disconnects
+    void stop();
+
+    void set_report_handler(ReportHandler handler) { report_handler_ = std::move(handler); }
+
+    // Connects, reads and dispatches, heartbeats; now_ns from steady_clock
+    void poll(int64_t now_ns);
+
+    // False unless logged on, or if the message could not be queued
+    bool send_new_order(const Order& order);
+    // order.revision is the replacement's; the one before it is replaced
+    bool send_replace(const Order& order);
+    // OrderMassCancelRequest for every order of the session, from a message
+    // built at construction; the venue answers with one cancel per order
+    bool send_mass_cancel();
+
+    State state() const { return state_; }
+    bool is_logged_on() const { return state_ == State::LOGGED_ON; }
+    uint64_t next_outgoing_seq() const { return sequences_.next_outgoing(); }
+    uint64_t next_incoming_seq() const { return sequences_.next_incoming(); }
+
+    // Statistics
+    uint64_t messages_sent() const { return messages_sent_; }
+    uint64_t messages_received() const { return messages_received_; }
+    uint64_t resend_requests_sent() const { return resend_requests_sent_; }
+    uint64_t gap_fills_sent() const { return gap_fills_sent_; }
+
+private:
+    // Slots every template has, then the order templates' own
+    enum Slot : int {
+        SLOT_SEQ_NUM = 0,
+        SLOT_SENDING_TIME,
+        SLOT_CL_ORD_ID,
+        SLOT_SIDE,
+        SLOT_TRANSACT_TIME,
+        SLOT_QUANTITY,
+        SLOT_PRICE,
+        SLOT_ORIG_CL_ORD_ID
+    };
+
+    struct SymbolTemplates {
+        fix::MessageTemplate market;
+        fix::MessageTemplate limit;
+        fix::MessageTemplate replace;
+    };
+
+    FixSessionConfig config_;
+    sockaddr_storage address_{};
+    socklen_t address_length_ = 0;
+    int fd_ = -1;
+    State state_ = State::DISCONNECTED;
+    FixSequenceStore sequences_;
+    fix::TimestampCache timestamps_;
+    ReportHandler report_handler_;
+    Logger logger_;
+
+    // Built on a symbol's first order; template_index_ maps symbol IDs into
+    // templates_ (-1 until then)
+    std::pmr::vector<SymbolTemplates> templates_;
+    std::pmr::vector<int32_t> template_index_;
+    fix::MessageTemplate heartbeat_;
+    fix::MessageTemplate mass_cancel_;
+    int mass_cancel_time_slot_ = -1;
+    uint16_t mass_cancels_sent_ = 0;           // ClOrdIDs 0-<n>: no order has ID 0
+
+    std::array<char, BUFFER_SIZE> in_{};
+    size_t in_size_ = 0;
+    std::array<char, BUFFER_SIZE> out_{};      // What send() did not take yet
+    size_t out_size_ = 0;
+
+    int64_t next_connect_ns_ = 0;
+    int64_t last_sent_ns_ = 0;
+    int64_t last_received_ns_ = 0;
+    int64_t awaiting_since_ns_ = 0;            // Connect, logon or logout sent; the reply is due
+    bool test_request_pending_ = false;
+    uint64_t resend_requested_to_ = 0;         // Gap already asked for, up to this seq
+
+    uint64_t messages_sent_ = 0;
+    uint64_t messages_received_ = 0;
+    uint64_t resend_requests_sent_ = 0;
+    uint64_t gap_fills_sent_ = 0;
+
+    void connect(int64_t now_ns);
+    void finish_connect(int64_t now_ns);
+    // Closes the socket and schedules the next connect
+    void disconnect(const std::string& reason);
+    void read_messages(int64_t now_ns);
+    void handle_message(const fix::Message& message, int64_t now_ns);
+    void check_heartbeat(int64_t now_ns);
+
+    // A message with this session's header slots: SLOT_SEQ_NUM and
+    // SLOT_SENDING_TIME
+    fix::MessageTemplate begin_message(std::string_view msg_type) const;
+    // Null if the symbol ID can't be indexed
+    SymbolTemplates* templates_for(const Order& order);
+    const char* now_timestamp();
+    // Stamps the next sequence number and the sending time, then writes it out
+    bool send_message(fix::MessageTemplate& message, int64_t now_ns, const char* timestamp);
+    bool write_out(const char* data, size_t size);
+    void flush();
+
+    void send_logon(int64_t now_ns);
+    void send_logout(std::string_view text, int64_t now_ns);
+    void send_heartbeat(std::string_view test_req_id, int64_t now_ns);
+    void send_test_request(int64_t now_ns);
+    void send_resend_request(uint64_t from, int64_t now_ns);
+    void send_gap_fill(uint64_t from, int64_t now_ns);
+};
+
+} // namespace hft
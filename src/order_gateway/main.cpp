@@ -1,6 +1,10 @@
 #include "order_gateway.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/sampling_profiler.h"
+#include "../common/startup_timeline.h"
 #include <iostream>
 #include <signal.h>
 #include <thread>
@@ -20,8 +24,12 @@ int main(int argc, char* argv[]) {
     std::cout << "HFT Order Gateway v1.0" << std::endl;
     std::cout << "======================" << std::endl;
     
+    StartupTimeline& startup = StartupTimeline::instance();
     std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
-    StaticConfig::load_from_file(config_file.c_str());
+    startup.run("config", [&] { StaticConfig::load_from_file(config_file.c_str()); return true; });
+    ThreadPlan::instance().configure("order_gateway");
+    // Reserve and pre-fault hot-state memory before the service allocates from it
+    startup.run("hot_arena", [] { HugePageArena::hot(); return true; });
     GlobalLogger::instance().init("OrderGateway", StaticConfig::get_logger_endpoint());
     
     signal(SIGINT, signal_handler);
@@ -30,18 +38,23 @@ int main(int argc, char* argv[]) {
     try {
         g_gateway = std::make_unique<OrderGateway>();
         
-        if (!g_gateway->initialize()) {
+        if (!startup.run("initialize", [] { return g_gateway->initialize(); })) {
             std::cerr << "Failed to initialize Order Gateway" << std::endl;
             return 1;
         }
+        std::cout << "Hot arena: " << HugePageArena::hot().describe() << std::endl;
         
         g_gateway->start();
+        SamplingProfiler::instance().start_control_listener("OrderGateway");
         
+        // The timeline prints once the processing thread is warm
         std::cout << "Order Gateway is running. Press Ctrl+C to stop." << std::endl;
         
         while (g_gateway->is_running()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        SamplingProfiler::instance().stop_control_listener();
+        SamplingProfiler::instance().stop();
         
         std::cout << "Order Gateway shutdown complete." << std::endl;
         
@@ -3,15 +3,36 @@
 #include "../common/static_config.h"
 #include "../common/metrics_collector.h"
 #include "../common/metrics_publisher.h"
+#include "../common/cpu_affinity.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
 #include "../common/hft_metrics.h"
+#include "../common/alloc_tracker.h"
+#include "../common/startup_timeline.h"
+#include "../common/warmup.h"
 
+#include <algorithm>
 #include <random>
 #include <chrono>
 
 namespace hft {
 
+namespace {
+
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* side_name(SignalAction side) {
+    return side == SignalAction::BUY ? "BUY" : "SELL";
+}
+
+} // namespace
+
 OrderGateway::OrderGateway()
-    : running_(false), next_order_id_(1), use_alpaca_(false), orders_processed_(0), orders_filled_(0), orders_rejected_(0)
+    : running_(false), active_orders_(MAX_ACTIVE_ORDERS, hot_memory()), next_order_id_(1)
+    , quotes_(MAX_QUOTE_SLOTS, hot_memory()), router_(hot_memory()), use_alpaca_(false), orders_processed_(0), orders_filled_(0), orders_rejected_(0)
     , logger_("OrderGateway", StaticConfig::get_logger_endpoint())
     , metrics_publisher_("OrderGateway", "tcp://*:5563") {
 }
@@ -24,61 +45,97 @@ bool OrderGateway::initialize() {
     logger_.info("Initializing Order Gateway");
     
     MetricsCollector::instance().initialize();
-    StaticConfig::load_from_file("config/hft_config.conf");
-
-    // Initialize metrics publisher
-    if (!metrics_publisher_.initialize()) {
-        logger_.error("Failed to initialize metrics publisher");
+    StaticConfig::reload();
+    // Assign symbol IDs in config order so they agree across services
+    SymbolTable::instance().preload(StaticConfig::get_symbols());
+    if (!kill_switch_->open(StaticConfig::get_kill_switch_name())) {
+        logger_.warning("Kill switch not shared; only this process can halt the gateway");
+    }
+    kill_cancels_.reserve(MAX_ACTIVE_ORDERS);
+    
+    // Venues need both: whether the broker answered, and the sockets
+    if (!StartupTimeline::instance().run_parallel({
+            {"gateway.broker", [this] { connect_broker(); return true; }},
+            {"gateway.transports", [this] { return open_transports(); }},
+        })) {
         return false;
     }
     
     try {
-        context_ = std::make_unique<zmq::context_t>(1);
-        
-        // Signal subscriber
-        signal_subscriber_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        signal_subscriber_->setsockopt(ZMQ_SUBSCRIBE, "", 0);  // Subscribe to all messages
-        int rcvhwm = 1000;
-        signal_subscriber_->setsockopt(ZMQ_RCVHWM, &rcvhwm, sizeof(rcvhwm));
-        signal_subscriber_->connect(StaticConfig::get_signals_endpoint());
-        
-        // Execution publisher
-        execution_publisher_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
-        int sndhwm = 1000;
-        execution_publisher_->setsockopt(ZMQ_SNDHWM, &sndhwm, sizeof(sndhwm));
-        int linger = 0;
-        execution_publisher_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
-        execution_publisher_->bind(StaticConfig::get_executions_endpoint());
+        // Paper fills are local; only the broker has a message budget
+        if (use_alpaca_) {
+            quotes_.venue_limit().configure(StaticConfig::get_alpaca_rate_limit_per_minute() / 60.0,
+                                            static_cast<uint32_t>(StaticConfig::get_alpaca_rate_limit_burst()));
+        }
         
-        // Initialize Alpaca client if trading is enabled and not in paper mode
-        if (StaticConfig::get_trading_enabled() && !StaticConfig::get_paper_trading()) {
-            alpaca_client_ = std::make_unique<AlpacaClient>();
-            
-            // Try to load Alpaca credentials from environment variables
-            const char* api_key = std::getenv("ALPACA_API_KEY");
-            const char* api_secret = std::getenv("ALPACA_API_SECRET");
-            const char* base_url = std::getenv("ALPACA_BASE_URL");
-            
-            if (api_key && api_secret) {
-                std::string url = base_url ? base_url : "https://paper-api.alpaca.markets";
-                if (alpaca_client_->initialize(api_key, api_secret, url)) {
-                    use_alpaca_ = true;
-                    logger_.info("Alpaca client initialized successfully");
-                } else {
-                    logger_.warning("Failed to initialize Alpaca client, falling back to paper trading");
-                    use_alpaca_ = false;
-                }
-            } else {
-                logger_.warning("Alpaca credentials not found, using paper trading mode");
-                use_alpaca_ = false;
-            }
+        configure_venues();
+        if (router_.venue_count() > 1) {
+            market_data_subscriber_ = TransportFactory::open_subscriber(
+                zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
         }
         
         std::string mode = use_alpaca_ ? "live trading (Alpaca)" : "paper trading";
         logger_.info("Order Gateway initialized in " + mode + " mode");
         return true;
         
-    } catch (const zmq::error_t& e) {
+    } catch (const std::exception& e) {
+        logger_.error("Initialization failed: " + std::string(e.what()));
+        return false;
+    }
+}
+
+void OrderGateway::connect_broker() {
+    // Initialize Alpaca client if trading is enabled and not in paper mode
+    if (!StaticConfig::get_trading_enabled() || StaticConfig::get_paper_trading()) {
+        return;
+    }
+    alpaca_client_ = std::make_unique<AlpacaClient>();
+    
+    // Try to load Alpaca credentials from environment variables
+    const char* api_key = std::getenv("ALPACA_API_KEY");
+    const char* api_secret = std::getenv("ALPACA_API_SECRET");
+    const char* base_url = std::getenv("ALPACA_BASE_URL");
+    
+    if (api_key && api_secret) {
+        std::string url = base_url ? base_url : "https://paper-api.alpaca.markets";
+        if (alpaca_client_->initialize(api_key, api_secret, url) &&
+            alpaca_client_->start_async(StaticConfig::get_alpaca_order_connections())) {
+            use_alpaca_ = true;
+            logger_.info("Alpaca client initialized successfully");
+        } else {
+            logger_.warning("Failed to initialize Alpaca client, falling back to paper trading");
+            use_alpaca_ = false;
+        }
+    } else {
+        logger_.warning("Alpaca credentials not found, using paper trading mode");
+        use_alpaca_ = false;
+    }
+}
+
+bool OrderGateway::open_transports() {
+    if (StaticConfig::get_journal_enabled()) {
+        journal_ = std::make_unique<EventJournal>(JournalConfig::from_config("order_gateway"));
+    }
+    
+    // Initialize metrics publisher
+    if (!metrics_publisher_.initialize()) {
+        logger_.error("Failed to initialize metrics publisher");
+        return false;
+    }
+    
+    try {
+        signal_subscriber_ = TransportFactory::open_subscriber(
+            zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_signals_endpoint())));
+        execution_publisher_ = TransportFactory::open_publisher(
+            zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_executions_endpoint())));
+        
+        // Limits start from config; the risk service overrides them at runtime
+        risk_.set_default_limits(RiskLimits::from_config());
+        risk_limits_subscriber_ = TransportFactory::open_subscriber(
+            zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_positions_endpoint())));
+        return true;
+        
+    } catch (const std::exception& e) {
         logger_.error("Initialization failed: " + std::string(e.what()));
         return false;
     }
@@ -95,6 +152,7 @@ void OrderGateway::start() {
     
     // Start metrics publisher
     metrics_publisher_.start();
+    warmup::publish_pending();
     
     processing_thread_ = std::make_unique<std::thread>(&OrderGateway::process_signals, this);
     logger_.info("Order Gateway started");
@@ -115,6 +173,17 @@ void OrderGateway::stop() {
         processing_thread_->join();
     }
     
+    if (alpaca_client_) {
+        alpaca_client_->stop_async();
+    }
+    if (fix_session_) {
+        fix_session_->stop();
+    }
+    
+    if (journal_) {
+        journal_->close();
+    }
+    
     if (signal_subscriber_) {
         try {
             signal_subscriber_->close();
@@ -127,6 +196,18 @@ void OrderGateway::stop() {
             execution_publisher_.reset();
         } catch (const zmq::error_t&) {}
     }
+    if (risk_limits_subscriber_) {
+        try {
+            risk_limits_subscriber_->close();
+            risk_limits_subscriber_.reset();
+        } catch (const zmq::error_t&) {}
+    }
+    if (market_data_subscriber_) {
+        try {
+            market_data_subscriber_->close();
+            market_data_subscriber_.reset();
+        } catch (const zmq::error_t&) {}
+    }
     
     log_statistics();
     logger_.info("Order Gateway stopped");
@@ -137,29 +218,113 @@ bool OrderGateway::is_running() const {
 }
 
 void OrderGateway::process_signals() {
-    logger_.info("Signal processing thread started");
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "processing")) {
+        logger_.warning("Failed to pin processing thread to its planned CPU");
+    }
+    logger_.info(std::string("Signal processing thread started") +
+                 (signal_channel_ ? " (in-process fast path)" : ""));
+    StartupTimeline& startup = StartupTimeline::instance();
+    startup.run("gateway.warmup", [this] { warm_up(); return true; });
+    startup.run("gateway.journal_recovery", [this] { recover_from_journal(); return true; });
+    warm_.store(true, std::memory_order_release);
+    startup.ready("Order Gateway");
     
     auto last_stats_time = std::chrono::steady_clock::now();
     const auto stats_interval = std::chrono::seconds(30);
+    last_snapshot_time_ = last_stats_time;
+    last_router_refresh_ = last_stats_time;
+    uint32_t iterations = 0;
+    // A kill raised before we got here is acted on in the first iteration
+    kill_word_ = kill_switch_->word() & ~KillSwitch::HALTED;
     
-    while (running_.load()) {
+    while (running_.load(std::memory_order_relaxed)) {
         try {
-            zmq::message_t message;
-            if (signal_subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                if (message.size() == sizeof(TradingSignal)) {
-                    TradingSignal signal;
-                    std::memcpy(&signal, message.data(), sizeof(TradingSignal));
+            // One load per iteration, ahead of any signal: a kill never
+            // waits behind the queues
+            uint64_t kill_word = kill_switch_->word();
+            if (kill_word != kill_word_) [[unlikely]] {
+                handle_kill_switch(kill_word);
+            }
+            
+            if (signal_channel_) {
+                // Fast path: the channel is checked every spin, the sockets
+                // (limits, broker completions, stray ZMQ signals) every 64th
+                // whether or not signals arrived, so a sustained burst holds
+                // them off for at most 63 drains of 64 signals
+                size_t drained = signal_channel_->drain([this](const TradingSignal& signal) {
+                    handle_trading_signal(signal);
+                }, 64);
+                if ((++iterations & 63) != 0) {
+                    if (drained == 0) CPUAffinity::cpu_pause();
+                    continue;
+                }
+            }
+            
+            // Drain every pending signal; broker round trips no longer block intake
+            TradingSignal signal;
+            size_t size = sizeof(signal);
+            while (signal_subscriber_->receive(&signal, size, true)) {
+                if (size == sizeof(TradingSignal)) {
                     handle_trading_signal(signal);
                 }
+                size = sizeof(signal);
+            }
+            
+            if (use_alpaca_) {
+                alpaca_client_->poll_completions([this](uint64_t order_id, const AlpacaOrderResponse& response) {
+                    if (order_id == 0) {
+                        handle_alpaca_cancel_all(response);
+                    } else {
+                        handle_alpaca_completion(order_id, response);
+                    }
+                });
+            }
+            if (fix_session_) {
+                fix_session_->poll(steady_now_ns());
+                update_fix_venues();
+            }
+            
+            // Quotes held for an ack or a venue token
+            if (quotes_.has_releases()) {
+                quotes_.release(steady_now_ns(), [this](QuoteSlot& slot) { send_quote(slot); });
+            }
+            
+            // Position updates share this socket; only limit updates are used
+            alignas(8) char limits_message[std::max(sizeof(RiskLimitUpdate), sizeof(PositionUpdate))];
+            size = sizeof(limits_message);
+            while (risk_limits_subscriber_->receive(limits_message, size, true)) {
+                if (size == sizeof(RiskLimitUpdate)) {
+                    RiskLimitUpdate update;
+                    std::memcpy(&update, limits_message, sizeof(RiskLimitUpdate));
+                    if (update.header.type == MessageType::RISK_LIMIT_UPDATE) {
+                        handle_risk_limit_update(update);
+                    }
+                }
+                size = sizeof(limits_message);
+            }
+            
+            if (market_data_subscriber_) {
+                drain_market_data();
             }
             
             auto now = std::chrono::steady_clock::now();
+            if (now - last_router_refresh_ >= std::chrono::milliseconds(StaticConfig::get_router_score_refresh_ms())) {
+                refresh_venue_scores();
+                last_router_refresh_ = now;
+            }
             if (now - last_stats_time >= stats_interval) {
                 log_statistics();
                 last_stats_time = now;
             }
+            int snapshot_seconds = StaticConfig::get_journal_snapshot_interval_seconds();
+            if (journal_ && snapshot_seconds > 0 && now - last_snapshot_time_ >= std::chrono::seconds(snapshot_seconds)) {
+                snapshot_orders();
+                last_snapshot_time_ = now;
+            }
             
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            if (!signal_channel_) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
             
         } catch (const zmq::error_t& e) {
             if (e.num() != EAGAIN && e.num() != EINTR) {
@@ -171,33 +336,371 @@ void OrderGateway::process_signals() {
     logger_.info("Signal processing thread stopped");
 }
 
+void OrderGateway::warm_up() {
+    std::vector<symbol_id_t> symbols = warmup::universe();
+    if (!StaticConfig::get_warmup_enabled() || symbols.empty()) {
+        warmup::publish(WarmupReport{});
+        return;
+    }
+    
+    std::vector<TradingSignal> signals;
+    for (uint64_t i = 0; i < symbols.size() * 8; ++i) {
+        signals.push_back(warmup::synthetic_signal(symbols[i % symbols.size()], i / symbols.size()));
+    }
+    
+    warming_up_ = true;
+    WarmupReport report = run_warmup(WarmupOptions::from_config(), [&](uint64_t i) {
+        handle_trading_signal(signals[i % signals.size()]);
+    });
+    warming_up_ = false;
+    
+    // Nothing was routed; start the session from a clean slate
+    risk_.reset_order_state();
+    next_order_id_.store(1);
+    orders_processed_.store(0);
+    orders_filled_.store(0);
+    orders_rejected_.store(0);
+    
+    warmup::publish(report);
+    logger_.info("Warmup " + report.describe());
+}
+
+void OrderGateway::recover_from_journal() {
+    if (!journal_) return;
+    
+    replaying_ = true;
+    JournalRecovery recovery = journal_->recover([this](JournalRecordType type, const void* data, size_t size) {
+        replay_journal_record(type, data, size);
+    });
+    replaying_ = false;
+    
+    logger_.info("Journal recovery: " + recovery.describe() + ", " +
+                 std::to_string(active_orders_.size()) + " working orders, next order ID " +
+                 std::to_string(next_order_id_.load()));
+    if (!journal_->open()) {
+        logger_.error("Failed to open the order journal; orders will not be journaled");
+    }
+}
+
+void OrderGateway::replay_journal_record(JournalRecordType type, const void* data, size_t size) {
+    auto advance_sequence = [this](uint64_t order_id) {
+        if (order_id >= next_order_id_.load()) next_order_id_.store(order_id + 1);
+    };
+    
+    switch (type) {
+        case JournalRecordType::ORDER_STATE: {
+            if (size != sizeof(Order)) return;
+            Order order;
+            std::memcpy(&order, data, sizeof(order));
+            advance_sequence(order.order_id);
+            
+            Order* stored = active_orders_.find(order.order_id);
+            if (!stored) {
+                // Only preloaded symbol IDs agree across restarts
+                order.symbol_id = SymbolTable::instance().resolve(order.symbol_id, order.symbol);
+                order.created_time = std::chrono::steady_clock::now();
+                // Journaled under another venue list: the first venue takes it
+                if (order.venue >= router_.venue_count()) order.venue = 0;
+                stored = active_orders_.insert(order);
+                if (!stored) return;
+                risk_.restore_working(order.symbol_id, order.action, order.quantity - order.filled_quantity);
+            } else if (stored->quantity != order.quantity || stored->filled_quantity != order.filled_quantity) {
+                // Replaced: the new size takes over the working total
+                risk_.on_order_closed(stored->symbol_id, stored->action, stored->quantity - stored->filled_quantity);
+                risk_.restore_working(stored->symbol_id, stored->action, order.quantity - order.filled_quantity);
+                stored->quantity = order.quantity;
+                stored->filled_quantity = order.filled_quantity;
+            }
+            stored->price = order.price;
+            if (order.external_order_id[0] != '\0') {
+                active_orders_.set_broker_id(*stored, order.external_order_id);
+            }
+            if (stored->quote) {
+                quotes_.adopt(stored->strategy_id, stored->symbol_id, stored->action,
+                              stored->order_id, stored->price, stored->quantity);
+            }
+            break;
+        }
+        case JournalRecordType::ORDER_EXECUTION: {
+            if (size != sizeof(OrderExecution)) return;
+            OrderExecution execution;
+            std::memcpy(&execution, data, sizeof(execution));
+            advance_sequence(execution.order_id);
+            
+            Order* order = active_orders_.find(execution.order_id);
+            if (order && execution.exec_type == ExecutionType::FILL) {
+                order->filled_quantity += execution.fill_quantity;
+                risk_.on_fill(order->symbol_id, order->action, execution.fill_quantity);
+            }
+            break;
+        }
+        case JournalRecordType::ORDER_CLOSED: {
+            if (size != sizeof(uint64_t)) return;
+            uint64_t order_id;
+            std::memcpy(&order_id, data, sizeof(order_id));
+            if (Order* order = active_orders_.find(order_id)) {
+                if (order->quantity > order->filled_quantity) {
+                    risk_.on_order_closed(order->symbol_id, order->action, order->quantity - order->filled_quantity);
+                }
+                if (QuoteSlot* slot = quote_slot(*order)) {
+                    quotes_.on_closed(*slot);
+                }
+                active_orders_.erase(order_id);
+            }
+            break;
+        }
+        case JournalRecordType::ORDER_SEQUENCE: {
+            if (size != sizeof(uint64_t)) return;
+            uint64_t next_order_id;
+            std::memcpy(&next_order_id, data, sizeof(next_order_id));
+            if (next_order_id > next_order_id_.load()) next_order_id_.store(next_order_id);
+            break;
+        }
+        case JournalRecordType::RISK_POSITION: {
+            if (size != sizeof(JournalRiskPosition)) return;
+            JournalRiskPosition position;
+            std::memcpy(&position, data, sizeof(position));
+            char symbol[sizeof(position.symbol) + 1] = {};
+            std::memcpy(symbol, position.symbol, sizeof(position.symbol));
+            risk_.restore_position(SymbolTable::instance().intern(symbol), position.position);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void OrderGateway::snapshot_orders() {
+    JournalSnapshot snapshot;
+    uint64_t next_order_id = next_order_id_.load();
+    snapshot.add(JournalRecordType::ORDER_SEQUENCE, next_order_id);
+    
+    const SymbolTable& symbols = SymbolTable::instance();
+    for (symbol_id_t id = 0; id < symbols.size(); ++id) {
+        int64_t position = risk_.get_position(id);
+        if (position == 0) continue;
+        JournalRiskPosition record{};
+        std::strncpy(record.symbol, symbols.name(id), sizeof(record.symbol));
+        record.position = position;
+        snapshot.add(JournalRecordType::RISK_POSITION, record);
+    }
+    
+    active_orders_.for_each([&](const Order& order) {
+        snapshot.add(JournalRecordType::ORDER_STATE, order);
+    });
+    journal_->snapshot(std::move(snapshot));
+}
+
+void OrderGateway::journal_order(const Order& order) {
+    if (journal_ && !warming_up_ && !replaying_) {
+        journal_->append(JournalRecordType::ORDER_STATE, order);
+    }
+}
+
+void OrderGateway::close_order(uint64_t order_id) {
+    if (journal_ && !warming_up_ && !replaying_) {
+        journal_->append(JournalRecordType::ORDER_CLOSED, order_id);
+    }
+    if (Order* order = active_orders_.find(order_id)) {
+        if (QuoteSlot* slot = quote_slot(*order)) {
+            quotes_.on_closed(*slot);
+        }
+    }
+    active_orders_.erase(order_id);
+}
+
+QuoteSlot* OrderGateway::quote_slot(const Order& order) {
+    if (!order.quote) return nullptr;
+    QuoteSlot* slot = quotes_.find(order.strategy_id, order.symbol_id, order.action);
+    return slot && slot->order_id == order.order_id ? slot : nullptr;
+}
+
 void OrderGateway::handle_trading_signal(const TradingSignal& signal) {
+    HFT_NO_ALLOC_SCOPE("OrderGateway::handle_trading_signal");
+    if (signal.action == SignalAction::MODIFY) {
+        handle_quote(signal);
+        return;
+    }
+    
     HFT_RDTSC_TIMER(hft::metrics::ORDER_PROCESS_LATENCY);
     
     // Create new order
     uint64_t order_id = next_order_id_++;
     Order order(order_id, signal);
     
-    logger_.info("Processing " + std::string(signal.action == SignalAction::BUY ? "BUY" : "SELL") +
-                " signal for " + order.symbol + 
-                " qty=" + std::to_string(signal.quantity) +
-                " price=" + std::to_string(signal.price));
+    // Plain orders spend the venue's message budget too
+    if (!warming_up_ && !quotes_.venue_limit().try_acquire(steady_now_ns())) {
+        reject_order(order, RiskCheckResult::RATE_LIMIT);
+        return;
+    }
+    submit_order(order);
+}
+
+bool OrderGateway::submit_order(Order& order) {
+    RiskCheckResult risk_result;
+    {
+        HFT_RDTSC_TIMER(hft::metrics::RISK_CHECK_LATENCY);
+        int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            order.created_time.time_since_epoch()).count();
+        risk_result = risk_.check(order.symbol_id, order.action, order.type, order.price, order.quantity, now_ns);
+    }
+    if (risk_result != RiskCheckResult::PASSED) {
+        reject_order(order, risk_result);
+        return false;
+    }
+    order.trace.stamp(TraceStage::RISK_CHECK);
+    
+    if (warming_up_) {
+        // Exercise the order table, then unwind as if cancelled
+        if (active_orders_.insert(order)) {
+            active_orders_.erase(order.order_id);
+        }
+        risk_.on_order_closed(order.symbol_id, order.action, order.quantity);
+        return true;
+    }
     
-    // Store order
-    active_orders_[order_id] = order;
+    HFT_LOGF(logger_, LogLevel::INFO, "Processing {} {} for {} qty={} price={}", side_name(order.action),
+             order.quote ? "quote" : "signal", order.symbol, order.quantity, to_double_price(order.price));
+    
+    // Routed before it is stored, so the journal records the venue
+    order.venue = router_.route(order.symbol_id, order.action, order.type, order.price, steady_now_ns());
+    if (order.venue == VenueRouter::NO_VENUE) {
+        // Only fix venues are configured, and the session is down
+        risk_.on_order_closed(order.symbol_id, order.action, order.quantity);
+        reject_order(order, RiskCheckResult::VENUE_UNAVAILABLE);
+        return false;
+    }
+    Order* stored = active_orders_.insert(order);
+    if (!stored) {
+        logger_.error("Order table full (" + std::to_string(active_orders_.capacity()) + " working orders)");
+        risk_.on_order_closed(order.symbol_id, order.action, order.quantity);
+        orders_rejected_++;
+        HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_REJECTED_TOTAL);
+        return false;
+    }
     orders_processed_++;
+    journal_order(*stored);
     
     // Record metrics
     HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_RECEIVED_TOTAL);
     
     // Route to appropriate execution method
-    if (use_alpaca_) {
-        handle_alpaca_order(active_orders_[order_id]);
+    VenueKind kind = router_.config(stored->venue).kind;
+    if (kind == VenueKind::ALPACA) {
+        handle_alpaca_order(*stored);
+    } else if (kind == VenueKind::FIX) {
+        handle_fix_order(*stored);
     } else {
+        // Paper fills ack before returning, and free the order
+        uint8_t venue = stored->venue;
+        auto sent_time = stored->created_time;
+        simulate_order_fill(*stored);
+        record_venue_ack(venue, sent_time);
+    }
+    return true;
+}
+
+void OrderGateway::handle_quote(const TradingSignal& quote) {
+    HFT_RDTSC_TIMER(hft::metrics::ORDER_PROCESS_LATENCY);
+    
+    QuoteSlot* slot = nullptr;
+    switch (quotes_.on_quote(quote, steady_now_ns(), slot)) {
+        case QuoteCoalescer::Decision::SEND:
+            send_quote(*slot);
+            break;
+        case QuoteCoalescer::Decision::FULL: {
+            // Bad side, or more strategy/symbol/side triples than slots
+            Order order(next_order_id_++, quote);
+            reject_order(order, RiskCheckResult::INVALID_ORDER);
+            break;
+        }
+        case QuoteCoalescer::Decision::HELD:
+        case QuoteCoalescer::Decision::UNCHANGED:
+            break;
+    }
+}
+
+void OrderGateway::send_quote(QuoteSlot& slot) {
+    Order* working = slot.order_id != 0 ? active_orders_.find(slot.order_id) : nullptr;
+    if (working) {
+        replace_quote(slot, *working);
+        return;
+    }
+    
+    Order order(next_order_id_++, slot.latest);
+    // Linked first: a paper fill closes the order before submit_order returns
+    quotes_.on_sent(slot, order.order_id);
+    if (!submit_order(order)) {
+        quotes_.on_closed(slot);
+    }
+}
+
+void OrderGateway::replace_quote(QuoteSlot& slot, Order& order) {
+    const TradingSignal& quote = slot.latest;
+    
+    // The new size replaces what was still working, and is checked in its place
+    uint32_t working = order.quantity - order.filled_quantity;
+    risk_.on_order_closed(order.symbol_id, order.action, working);
+    RiskCheckResult risk_result = risk_.check(order.symbol_id, order.action, OrderType::LIMIT,
+                                              quote.price, quote.quantity, steady_now_ns());
+    if (risk_result != RiskCheckResult::PASSED) {
+        // The order stays as it was; only the replace is refused
+        risk_.restore_working(order.symbol_id, order.action, working);
+        orders_rejected_++;
+        HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_REJECTED_TOTAL);
+        HFT_LOGF(logger_, LogLevel::WARNING, "Pre-trade reject {} on replace of order {}: {} qty={} price={}",
+                 risk_check_result_to_string(risk_result), order.order_id, order.symbol, quote.quantity,
+                 to_double_price(quote.price));
+        return;
+    }
+    
+    // The replacement is a fresh order at the broker; earlier fills stay with the old one
+    order.price = quote.price;
+    order.quantity = quote.quantity;
+    order.filled_quantity = 0;
+    order.revision++;           // A FIX replace takes a new ClOrdID
+    order.trace = quote.trace;
+    order.trace.stamp(TraceStage::RISK_CHECK);
+    journal_order(order);
+    quotes_.on_sent(slot, order.order_id);
+    HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_MODIFIED_TOTAL);
+    
+    HFT_LOGF(logger_, LogLevel::INFO, "Replacing {} quote {} for {} qty={} price={}", side_name(order.action),
+             order.order_id, order.symbol, order.quantity, to_double_price(order.price));
+    
+    VenueKind kind = router_.config(order.venue).kind;
+    if (kind == VenueKind::FIX) {
+        order.trace.stamp(TraceStage::GATEWAY_SEND);
+        if (!fix_session_ || !fix_session_->send_replace(order)) {
+            logger_.warning("FIX replace not sent; quote " + std::to_string(order.order_id) + " left as it was");
+            order.revision--;
+            revert_quote(slot, order);
+        }
+        return;
+    }
+    if (kind != VenueKind::ALPACA) {
         simulate_order_fill(order);
+        return;
+    }
+    order.trace.stamp(TraceStage::GATEWAY_SEND);
+    if (!alpaca_client_->replace_order_async(order.order_id, order.external_order_id,
+                                             order.quantity, to_double_price(order.price))) {
+        logger_.warning("Alpaca replace not queued (" + std::to_string(alpaca_client_->inflight_orders()) +
+                        " in flight); quote " + std::to_string(order.order_id) + " left as it was");
+        revert_quote(slot, order);
     }
 }
 
+void OrderGateway::revert_quote(QuoteSlot& slot, Order& order) {
+    risk_.on_order_closed(order.symbol_id, order.action, order.quantity - order.filled_quantity);
+    risk_.restore_working(order.symbol_id, order.action, slot.acked_quantity);
+    order.price = slot.acked_price;
+    order.quantity = slot.acked_quantity;
+    order.filled_quantity = 0;
+    journal_order(order);
+    quotes_.on_ack(slot, order.price, order.quantity);
+}
+
 void OrderGateway::simulate_order_fill(const Order& order) {
     HFT_RDTSC_TIMER(hft::metrics::SUBMIT_LATENCY);
     
@@ -205,31 +708,34 @@ void OrderGateway::simulate_order_fill(const Order& order) {
     std::random_device rd;
     std::mt19937 gen(rd());
     
+    TraceContext trace = order.trace;
+    
     // Validate order first
     {
-        if (order.quantity == 0 || order.symbol.empty()) {
+        if (order.quantity == 0 || order.symbol[0] == '\0') {
+            risk_.on_order_closed(order.symbol_id, order.action, order.quantity);
             orders_rejected_++;
             HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_REJECTED_TOTAL);
+            MetricsCollector::instance().record_trace(trace);
             return;
         }
     }
     
-    // Risk check simulation
-    {
-        HFT_RDTSC_TIMER(hft::metrics::RISK_CHECK_LATENCY);
-        // Simulate risk check processing
-        std::this_thread::sleep_for(std::chrono::microseconds(50));
-    }
+    // Pre-trade risk already ran in handle_trading_signal
+    trace.stamp(TraceStage::GATEWAY_SEND);
     
-    // Simulate fill delay
-    std::uniform_int_distribution<> delay_dist(10, 100); // 10-100ms
-    // auto fill_start = std::chrono::steady_clock::now();
-    std::this_thread::sleep_for(std::chrono::milliseconds(delay_dist(gen)));
+    // Simulate fill delay (timing.order_execution_*_delay_ms; 0 fills at once)
+    int min_delay_ms = StaticConfig::get_order_execution_min_delay_ms();
+    int max_delay_ms = std::max(min_delay_ms, StaticConfig::get_order_execution_max_delay_ms());
+    if (max_delay_ms > 0) {
+        std::uniform_int_distribution<> delay_dist(min_delay_ms, max_delay_ms);
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_dist(gen)));
+    }
     
     // auto fill_end = std::chrono::steady_clock::now();
     
     // Simulate fill price with some slippage
-    double fill_price = order.price;
+    double fill_price = to_double_price(order.price);
     if (order.type == OrderType::MARKET) {
         std::normal_distribution<> slippage_dist(0.0, 0.01); // 1% std dev
         fill_price = fill_price * (1.0 + slippage_dist(gen));
@@ -237,20 +743,25 @@ void OrderGateway::simulate_order_fill(const Order& order) {
     
     // Create execution report
     OrderExecution execution{};
-    execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION, 
-                                                    sizeof(OrderExecution) - sizeof(MessageHeader));
+    execution.header = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION, 
+                                                        sizeof(OrderExecution) - sizeof(MessageHeader));
     execution.order_id = order.order_id;
-    std::strncpy(execution.symbol, order.symbol.c_str(), sizeof(execution.symbol) - 1);
+    std::strncpy(execution.symbol, order.symbol, sizeof(execution.symbol) - 1);
+    execution.symbol_id = order.symbol_id;
     execution.exec_type = ExecutionType::FILL;
-    execution.fill_price = fill_price;
+    execution.fill_price = to_fixed_price(fill_price);
     execution.fill_quantity = order.quantity;
     execution.remaining_quantity = 0;
     execution.commission = order.quantity * 0.001; // $0.001 per share
+    execution.trace = trace;
+    execution.trace.stamp(TraceStage::GATEWAY_ACK);
     
+    MetricsCollector::instance().record_trace(execution.trace);
     publish_execution(execution);
+    risk_.on_fill(order.symbol_id, order.action, order.quantity);
     
     // Remove from active orders
-    active_orders_.erase(order.order_id);
+    close_order(order.order_id);
     orders_filled_++;
     
     // Record metrics
@@ -269,89 +780,451 @@ void OrderGateway::handle_alpaca_order(Order& order) {
         return;
     }
     
-    try {
-        AlpacaOrderResponse response;
-        std::string side = (order.action == SignalAction::BUY) ? "buy" : "sell";
-        
-        // Submit order to Alpaca
-        if (order.type == OrderType::MARKET) {
-            response = alpaca_client_->submit_market_order(order.symbol, side, order.quantity);
-        } else if (order.type == OrderType::LIMIT) {
-            response = alpaca_client_->submit_limit_order(order.symbol, side, order.quantity, order.price);
-        } else {
-            logger_.error("Unsupported order type for Alpaca: " + std::to_string(static_cast<int>(order.type)));
-            simulate_order_fill(order);
+    if (order.type != OrderType::MARKET && order.type != OrderType::LIMIT) {
+        logger_.error("Unsupported order type for Alpaca: " + std::to_string(static_cast<int>(order.type)));
+        simulate_order_fill(order);
+        return;
+    }
+    
+    // Hand off to the client's I/O thread; the result comes back through
+    // handle_alpaca_completion so signal intake never waits on the broker
+    order.trace.stamp(TraceStage::GATEWAY_SEND);
+    if (!alpaca_client_->submit_order_async(order.order_id, order.symbol, order.action, order.type,
+                                            order.quantity, to_double_price(order.price))) {
+        logger_.warning("Alpaca submission queue full (" + std::to_string(alpaca_client_->inflight_orders()) +
+                        " in flight), falling back to paper trading");
+        simulate_order_fill(order);
+    }
+}
+
+void OrderGateway::handle_alpaca_completion(uint64_t order_id, const AlpacaOrderResponse& response) {
+    Order* order = active_orders_.find(order_id);
+    if (!order) {
+        logger_.warning("Alpaca response for unknown order " + std::to_string(order_id));
+        return;
+    }
+    
+    QuoteSlot* slot = quote_slot(*order);
+    if (!response.is_success()) {
+        // A refused replace leaves the broker's order as it was
+        if (slot && order->external_order_id[0] != '\0') {
+            logger_.warning("Alpaca replace of order " + std::to_string(order_id) + " failed: " +
+                            response.error_message);
+            revert_quote(*slot, *order);
             return;
         }
+        logger_.error("Alpaca order failed: " + response.error_message + ", falling back to paper trading");
+        simulate_order_fill(*order);
+        return;
+    }
+    
+    // Placed while the cancel-all was already out: it needs one of its own
+    if (KillSwitch::halted(kill_word_) && !alpaca_client_->cancel_all_async()) {
+        logger_.error("Alpaca cancel-all not queued for order " + std::to_string(order_id) + " placed after the kill");
+    }
+    
+    // A new order's first ack (a replace's created_time is the original's)
+    if (order->external_order_id[0] == '\0') {
+        record_venue_ack(order->venue, order->created_time);
+    }
+    
+    // Index by the broker's ID so its acks map back to this order
+    if (!active_orders_.set_broker_id(*order, response.order_id.c_str())) {
+        logger_.warning("Broker order ID not indexable: " + response.order_id);
+    }
+    journal_order(*order);
+    if (slot) {
+        quotes_.on_ack(*slot, order->price, order->quantity);
+    }
+    
+    logger_.info("Alpaca order submitted: " + response.order_id);
+    
+    // Check if order was immediately filled
+    if (response.is_filled()) {
+        // Create execution report
+        OrderExecution execution{};
+        execution.header = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION, 
+                                                            sizeof(OrderExecution) - sizeof(MessageHeader));
+        execution.order_id = order->order_id;
+        std::strncpy(execution.symbol, order->symbol, sizeof(execution.symbol) - 1);
+        execution.symbol_id = order->symbol_id;
+        execution.exec_type = ExecutionType::FILL;
+        execution.fill_price = to_fixed_price(response.fill_price);
+        execution.fill_quantity = static_cast<uint32_t>(response.filled_qty);
+        execution.remaining_quantity = static_cast<uint32_t>(response.quantity - response.filled_qty);
+        execution.commission = response.filled_qty * 0.001; // Estimate commission
+        execution.trace = order->trace;
+        execution.trace.stamp(TraceStage::GATEWAY_ACK);
+        
+        MetricsCollector::instance().record_trace(execution.trace);
+        publish_execution(execution);
+        risk_.on_fill(order->symbol_id, order->action, execution.fill_quantity);
+        order->filled_quantity += execution.fill_quantity;
         
-        if (!response.is_success()) {
-            logger_.error("Alpaca order failed: " + response.error_message + ", falling back to paper trading");
-            simulate_order_fill(order);
+        // Remove from active orders if fully filled
+        if (execution.remaining_quantity == 0) {
+            close_order(order_id);
+            orders_filled_++;
+        }
+    }
+}
+
+void OrderGateway::handle_alpaca_cancel_all(const AlpacaOrderResponse& response) {
+    if (!response.is_success()) {
+        logger_.error("Alpaca cancel-all failed: " + response.error_message);
+        return;
+    }
+    // The broker has nothing open any more; neither do we
+    kill_cancels_.clear();
+    active_orders_.for_each([this](const Order& order) {
+        if (router_.config(order.venue).kind == VenueKind::ALPACA) kill_cancels_.push_back(order.order_id);
+    });
+    for (uint64_t order_id : kill_cancels_) {
+        if (const Order* order = active_orders_.find(order_id)) cancel_order_locally(*order);
+    }
+    logger_.warning("Alpaca cancel-all done, " + std::to_string(kill_cancels_.size()) + " orders cancelled");
+}
+
+void OrderGateway::handle_fix_order(Order& order) {
+    order.trace.stamp(TraceStage::GATEWAY_SEND);
+    if (fix_session_ && fix_session_->send_new_order(order)) {
+        return;
+    }
+    // Not paper: a fix venue's orders are meant for the broker
+    logger_.error("FIX order " + std::to_string(order.order_id) + " not sent");
+    Order rejected = order;
+    risk_.on_order_closed(order.symbol_id, order.action, order.quantity);
+    close_order(order.order_id);
+    reject_order(rejected, RiskCheckResult::VENUE_UNAVAILABLE);
+}
+
+void OrderGateway::handle_fix_report(const fix::ExecutionReport& report) {
+    Order* order = active_orders_.find(report.order_id);
+    if (!order) {
+        logger_.warning("FIX report for unknown order " + std::to_string(report.order_id));
+        return;
+    }
+    QuoteSlot* slot = quote_slot(*order);
+    
+    // A refused replace leaves the broker's order (and its ClOrdID) as it was
+    if (report.cancel_reject) {
+        logger_.warning("FIX replace of order " + std::to_string(report.order_id) + " refused: " +
+                        std::string(report.text));
+        if (order->revision > 0) order->revision--;
+        if (slot) revert_quote(*slot, *order);
+        return;
+    }
+    
+    switch (report.exec_type) {
+        case fix::EXEC_NEW:
+            // The first ack carries the broker's ID; later ones are restatements
+            if (order->external_order_id[0] == '\0') {
+                record_venue_ack(order->venue, order->created_time);
+                char broker_id[Order::BROKER_ID_LENGTH] = {};
+                std::memcpy(broker_id, report.broker_order_id.data(),
+                            std::min(report.broker_order_id.size(), sizeof(broker_id) - 1));
+                if (broker_id[0] != '\0' && !active_orders_.set_broker_id(*order, broker_id)) {
+                    logger_.warning("Broker order ID not indexable: " + std::string(broker_id));
+                }
+                journal_order(*order);
+            }
+            if (slot) quotes_.on_ack(*slot, order->price, order->quantity);
+            return;
+        case fix::EXEC_REPLACED:
+            if (slot) quotes_.on_ack(*slot, order->price, order->quantity);
+            return;
+        case fix::EXEC_PARTIAL_FILL:
+        case fix::EXEC_FILL:
+        case fix::EXEC_TRADE:
+        case fix::EXEC_CANCELED:
+        case fix::EXEC_EXPIRED:
+        case fix::EXEC_DONE_FOR_DAY:
+        case fix::EXEC_REJECTED:
+            break;
+        default:
+            // Pending states and status replies change nothing here
+            return;
+    }
+    
+    OrderExecution execution = report.execution;
+    execution.header = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION,
+                                                        sizeof(OrderExecution) - sizeof(MessageHeader));
+    std::strncpy(execution.symbol, order->symbol, sizeof(execution.symbol) - 1);
+    execution.symbol_id = order->symbol_id;
+    execution.commission = execution.fill_quantity * 0.001; // Estimate commission
+    execution.trace = order->trace;
+    execution.trace.stamp(TraceStage::GATEWAY_ACK);
+    
+    MetricsCollector::instance().record_trace(execution.trace);
+    publish_execution(execution);
+    
+    uint64_t order_id = order->order_id;
+    if (execution.exec_type == ExecutionType::FILL || execution.exec_type == ExecutionType::PARTIAL_FILL) {
+        risk_.on_fill(order->symbol_id, order->action, execution.fill_quantity);
+        order->filled_quantity += execution.fill_quantity;
+        if (execution.remaining_quantity > 0) {
+            journal_order(*order);
             return;
         }
-        
-        // Store external order ID
-        order.external_order_id = response.order_id;
-        active_orders_[order.order_id] = order;
-        
-        logger_.info("Alpaca order submitted: " + response.order_id);
-        
-        // Check if order was immediately filled
-        if (response.is_filled()) {
-            // Create execution report
-            OrderExecution execution{};
-            execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION, 
-                                                            sizeof(OrderExecution) - sizeof(MessageHeader));
-            execution.order_id = order.order_id;
-            std::strncpy(execution.symbol, order.symbol.c_str(), sizeof(execution.symbol) - 1);
-            execution.exec_type = ExecutionType::FILL;
-            execution.fill_price = response.fill_price;
-            execution.fill_quantity = static_cast<uint32_t>(response.filled_qty);
-            execution.remaining_quantity = static_cast<uint32_t>(response.quantity - response.filled_qty);
-            execution.commission = response.filled_qty * 0.001; // Estimate commission
-            
-            publish_execution(execution);
-            
-            // Remove from active orders if fully filled
-            if (execution.remaining_quantity == 0) {
-                active_orders_.erase(order.order_id);
-                orders_filled_++;
+        orders_filled_++;
+        HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_FILLED_TOTAL);
+    } else {
+        // Cancelled, expired or rejected: whatever was still working is gone
+        risk_.on_order_closed(order->symbol_id, order->action, order->quantity - order->filled_quantity);
+        if (execution.exec_type == ExecutionType::REJECTED) {
+            orders_rejected_++;
+            HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_REJECTED_TOTAL);
+            logger_.warning("FIX order " + std::to_string(order_id) + " rejected: " + std::string(report.text));
+        }
+    }
+    close_order(order_id);
+}
+
+void OrderGateway::update_fix_venues() {
+    bool logged_on = fix_session_->is_logged_on();
+    if (logged_on == fix_logged_on_) return;
+    fix_logged_on_ = logged_on;
+    for (uint8_t venue = 0; venue < router_.venue_count(); ++venue) {
+        if (router_.config(venue).kind == VenueKind::FIX) {
+            router_.set_enabled(venue, logged_on);
+        }
+    }
+    logger_.info(logged_on ? "FIX venues taking orders" : "FIX session down; its venues get no orders");
+}
+
+void OrderGateway::reject_order(const Order& order, RiskCheckResult reason) {
+    if (warming_up_) return;
+    
+    orders_rejected_++;
+    HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_REJECTED_TOTAL);
+    HFT_LOGF(logger_, LogLevel::WARNING, "Pre-trade reject {}: {} qty={} price={}",
+             risk_check_result_to_string(reason), order.symbol, order.quantity, to_double_price(order.price));
+    
+    // Tell the strategy its order never went out
+    OrderExecution execution{};
+    execution.header = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION,
+                                                        sizeof(OrderExecution) - sizeof(MessageHeader));
+    execution.order_id = order.order_id;
+    std::strncpy(execution.symbol, order.symbol, sizeof(execution.symbol) - 1);
+    execution.symbol_id = order.symbol_id;
+    execution.exec_type = ExecutionType::REJECTED;
+    execution.fill_price = 0;
+    execution.fill_quantity = 0;
+    execution.remaining_quantity = order.quantity;
+    execution.commission = 0.0;
+    execution.trace = order.trace;
+    
+    MetricsCollector::instance().record_trace(execution.trace);
+    publish_execution(execution);
+}
+
+void OrderGateway::handle_risk_limit_update(const RiskLimitUpdate& update) {
+    bool was_halted = risk_.is_halted();
+    risk_.apply(update);
+    // The kill switch outranks the risk service
+    if (KillSwitch::halted(kill_word_)) {
+        risk_.set_halted(true);
+    }
+    if (risk_.is_halted() != was_halted) {
+        logger_.warning(risk_.is_halted() ? "Trading halted by risk service" : "Trading resumed by risk service");
+    }
+}
+
+void OrderGateway::handle_kill_switch(uint64_t word) {
+    kill_word_ = word;
+    if (!KillSwitch::halted(word)) {
+        // The risk service's next update halts again if it still wants to
+        risk_.set_halted(false);
+        logger_.warning("Kill switch reset; taking orders again");
+        return;
+    }
+    
+    // No new orders from here: every check, quote and replace fails HALTED
+    risk_.set_halted(true);
+    int64_t now_ns = KillSwitch::now();
+    kill_switch_->acknowledge(KillParty::GATEWAY, word, now_ns);
+    int64_t latency_ns = std::max<int64_t>(0, now_ns - kill_switch_->triggered_ns());
+    HFT_LATENCY_NS(hft::metrics::KILL_SWITCH_LATENCY, static_cast<uint64_t>(latency_ns));
+    
+    size_t working = active_orders_.size();
+    cancel_all_orders();
+    logger_.error("Kill switch: orders halted " + std::to_string(latency_ns / 1000) + "us after the trigger, " +
+                  std::to_string(working) + " working orders being cancelled");
+}
+
+void OrderGateway::cancel_all_orders() {
+    // One message per broker, whatever the order count
+    if (fix_session_ && !fix_session_->send_mass_cancel()) {
+        logger_.error("FIX mass cancel not sent (session " +
+                      std::string(fix_session_->is_logged_on() ? "backlogged" : "down") + ")");
+    }
+    if (use_alpaca_ && !alpaca_client_->cancel_all_async()) {
+        logger_.error("Alpaca cancel-all not queued");
+    }
+    
+    // The brokers' cancels close their orders as they come back; paper
+    // orders are only here
+    kill_cancels_.clear();
+    active_orders_.for_each([this](const Order& order) {
+        if (router_.config(order.venue).kind == VenueKind::SIMULATED) kill_cancels_.push_back(order.order_id);
+    });
+    for (uint64_t order_id : kill_cancels_) {
+        if (const Order* order = active_orders_.find(order_id)) cancel_order_locally(*order);
+    }
+}
+
+void OrderGateway::cancel_order_locally(const Order& order) {
+    uint32_t remaining = order.quantity - order.filled_quantity;
+    OrderExecution execution{};
+    execution.header = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION,
+                                                        sizeof(OrderExecution) - sizeof(MessageHeader));
+    execution.order_id = order.order_id;
+    std::strncpy(execution.symbol, order.symbol, sizeof(execution.symbol) - 1);
+    execution.symbol_id = order.symbol_id;
+    execution.exec_type = ExecutionType::CANCELLED;
+    execution.remaining_quantity = remaining;
+    execution.trace = order.trace;
+    publish_execution(execution);
+    
+    risk_.on_order_closed(order.symbol_id, order.action, remaining);
+    HFT_COMPONENT_COUNTER(hft::metrics::ORDERS_CANCELLED_TOTAL);
+    close_order(order.order_id);
+}
+
+void OrderGateway::configure_venues() {
+    std::vector<VenueConfig> venues;
+    for (const auto& [name, value] : StaticConfig::get_venues()) {
+        VenueConfig config;
+        std::string error;
+        if (!VenueConfig::parse(name, value, config, error)) {
+            logger_.error(error);
+            continue;
+        }
+        venues.push_back(config);
+    }
+    // Name order, so venue indexes (and the journal's) are stable across restarts
+    std::sort(venues.begin(), venues.end(),
+              [](const VenueConfig& a, const VenueConfig& b) { return a.name < b.name; });
+    
+    bool any_enabled = false;
+    bool fix_tried = false;
+    for (const VenueConfig& config : venues) {
+        uint8_t venue = router_.add_venue(config);
+        if (venue == VenueRouter::NO_VENUE) {
+            logger_.warning("More than " + std::to_string(VenueRouter::MAX_VENUES) + " venues; " +
+                            config.name + " ignored");
+            continue;
+        }
+        if (config.kind == VenueKind::ALPACA && !use_alpaca_) {
+            logger_.warning("Venue " + config.name + " needs the Alpaca client; it gets no orders");
+            router_.set_enabled(venue, false);
+        } else if (config.kind == VenueKind::FIX) {
+            if (!fix_session_ && !fix_tried) {
+                fix_tried = true;
+                fix_session_ = std::make_unique<FixSession>(FixSessionConfig::from_config(), hot_memory());
+                if (fix_session_->start()) {
+                    fix_session_->set_report_handler([this](const fix::ExecutionReport& report) {
+                        handle_fix_report(report);
+                    });
+                } else {
+                    fix_session_.reset();
+                }
+            }
+            if (!fix_session_) {
+                logger_.warning("Venue " + config.name + " needs a FIX session (fix.*); it gets no orders");
+            } else {
+                any_enabled = true;
             }
+            // Enabled by update_fix_venues() once the session logs on
+            router_.set_enabled(venue, false);
+        } else {
+            any_enabled = true;
         }
-        
-    } catch (const std::exception& e) {
-        logger_.error("Exception in Alpaca order handling: " + std::string(e.what()) + ", falling back to paper trading");
-        simulate_order_fill(order);
     }
+    if (!any_enabled) {
+        VenueConfig config;
+        config.name = use_alpaca_ ? "alpaca" : "paper";
+        config.kind = use_alpaca_ ? VenueKind::ALPACA : VenueKind::SIMULATED;
+        router_.add_venue(config);
+    }
+    
+    router_.set_latency_cost(StaticConfig::get_router_latency_cost_per_ms());
+    router_.set_quote_max_age(static_cast<int64_t>(StaticConfig::get_router_quote_max_age_ms()) * 1000000);
+    // One venue takes every order; quotes only matter to choose between several
+    if (router_.venue_count() > 1) {
+        router_.reserve_quotes(SymbolTable::MAX_SYMBOLS);
+    }
+    router_.refresh_scores();
+    
+    MetricsCollector& collector = MetricsCollector::instance();
+    std::string names;
+    for (uint8_t venue = 0; venue < router_.venue_count(); ++venue) {
+        std::string prefix = "venue." + router_.config(venue).name;
+        venue_metrics_.push_back(VenueMetrics{
+            collector.register_metric((prefix + metrics::VENUE_ACK_LATENCY_SUFFIX).c_str(), MetricType::LATENCY),
+            collector.register_metric((prefix + metrics::VENUE_EXPECTED_LATENCY_SUFFIX).c_str(), MetricType::GAUGE),
+            collector.register_metric((prefix + metrics::VENUE_ORDERS_ROUTED_SUFFIX).c_str(), MetricType::GAUGE)});
+        if (router_.enabled(venue)) {
+            names += (names.empty() ? "" : ", ") + router_.config(venue).name;
+        }
+    }
+    logger_.info("Routing across " + names);
+}
+
+void OrderGateway::drain_market_data() {
+    // The bus carries one consolidated book, so every venue is taken to
+    // show its touch; per-venue feeds would call on_quote per venue
+    int64_t now_ns = steady_now_ns();
+    MarketDataFrame frame;
+    size_t size = sizeof(frame);
+    while (market_data_subscriber_->receive(&frame, size, true)) {
+        for_each_quote(&frame, size, [this, now_ns](const MarketData& data) {
+            symbol_id_t symbol = SymbolTable::instance().resolve(data.symbol_id, data.symbol);
+            for (uint8_t venue = 0; venue < router_.venue_count(); ++venue) {
+                router_.on_quote(venue, symbol, data.bid_price, data.ask_price, now_ns);
+            }
+        });
+        size = sizeof(frame);
+    }
+}
+
+void OrderGateway::refresh_venue_scores() {
+    router_.refresh_scores();
+    MetricsCollector& collector = MetricsCollector::instance();
+    for (uint8_t venue = 0; venue < router_.venue_count(); ++venue) {
+        collector.set_gauge(venue_metrics_[venue].expected_latency, router_.expected_latency_ns(venue));
+        collector.set_gauge(venue_metrics_[venue].orders_routed, router_.routed(venue));
+    }
+}
+
+void OrderGateway::record_venue_ack(uint8_t venue, std::chrono::steady_clock::time_point sent_time) {
+    if (replaying_ || venue >= router_.venue_count()) return;
+    uint64_t latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - sent_time).count());
+    router_.on_ack(venue, latency_ns);
+    MetricsCollector::instance().record_latency(venue_metrics_[venue].ack_latency, latency_ns);
 }
 
 void OrderGateway::publish_execution(const OrderExecution& execution) {
     HFT_RDTSC_TIMER(hft::metrics::PUBLISH_LATENCY);
     
-    try {
-        zmq::message_t message(sizeof(OrderExecution));
-        std::memcpy(message.data(), &execution, sizeof(OrderExecution));
-        
-        execution_publisher_->send(message, zmq::send_flags::dontwait);
-        
-        logger_.info("Execution: " + std::string(execution.symbol) +
-                    " " + std::to_string(execution.fill_quantity) + 
-                    " @ " + std::to_string(execution.fill_price));
-        
-        // Update throughput metrics
-        static auto last_rate_update = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_rate_update).count();
-        if (elapsed >= 1) {
-            uint64_t orders_per_sec = orders_filled_.load() / std::max(elapsed, 1L);
-            HFT_GAUGE_VALUE(hft::metrics::ORDERS_PER_SECOND, orders_per_sec);
-            last_rate_update = now;
-        }
-        
-    } catch (const zmq::error_t& e) {
-        if (e.num() != EAGAIN) {
-            logger_.error("Failed to publish execution: " + std::string(e.what()));
-        }
+    // Rejects too: their order IDs must not be reissued after a restart
+    if (journal_ && !replaying_) {
+        journal_->append(JournalRecordType::ORDER_EXECUTION, execution);
+    }
+    execution_publisher_->publish(&execution, sizeof(OrderExecution));
+    
+    HFT_LOGF(logger_, LogLevel::INFO, "Execution: {} {} @ {}", execution.symbol, execution.fill_quantity,
+             to_double_price(execution.fill_price));
+    
+    // Update throughput metrics
+    static auto last_rate_update = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_rate_update).count();
+    if (elapsed >= 1) {
+        uint64_t orders_per_sec = orders_filled_.load() / std::max(elapsed, 1L);
+        HFT_GAUGE_VALUE(hft::metrics::ORDERS_PER_SECOND, orders_per_sec);
+        last_rate_update = now;
     }
 }
 
@@ -363,7 +1236,10 @@ void OrderGateway::log_statistics() {
     std::string stats = "Processed " + std::to_string(processed) +
                        " orders, filled " + std::to_string(filled) +
                        " orders, rejected " + std::to_string(rejected) +
-                       " orders, " + std::to_string(active_orders_.size()) + " active";
+                       " orders, " + std::to_string(active_orders_.size()) + " active; " +
+                       std::to_string(quotes_.quotes()) + " quotes, " + std::to_string(quotes_.sent()) +
+                       " sent, " + std::to_string(quotes_.coalesced()) + " coalesced, " +
+                       std::to_string(quotes_.throttled()) + " held for the venue rate limit";
     logger_.info(stats);
     
     // Update gauge metrics
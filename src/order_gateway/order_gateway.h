@@ -4,35 +4,22 @@
 #include "../common/logging.h"
 #include "../common/static_config.h"
 #include "../common/metrics_publisher.h"
+#include "../common/event_journal.h"
+#include "../common/pre_trade_risk.h"
+#include "../common/spsc_channel.h"
+#include "../common/kill_switch.h"
+#include "order_table.h"
+#include "quote_coalescer.h"
+#include "venue_router.h"
 #include "alpaca_client.h"
-#include <zmq.hpp>
+#include "fix_session.h"
+#include "../common/zmq_transport.h"
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <unordered_map>
 
 namespace hft {
 
-struct Order {
-    uint64_t order_id;
-    std::string symbol;
-    SignalAction action;
-    OrderType type;
-    double price;
-    uint32_t quantity;
-    uint32_t filled_quantity;
-    std::chrono::steady_clock::time_point created_time;
-    std::string external_order_id;  // For broker order ID (Alpaca)
-    
-    Order() : order_id(0), action(SignalAction::BUY), type(OrderType::MARKET)
-        , price(0.0), quantity(0), filled_quantity(0), created_time(std::chrono::steady_clock::now()) {}
-    
-    Order(uint64_t id, const TradingSignal& signal)
-        : order_id(id), symbol(signal.symbol), action(signal.action)
-        , type(signal.order_type), price(signal.price), quantity(signal.quantity)
-        , filled_quantity(0), created_time(std::chrono::steady_clock::now()) {}
-};
-
 class OrderGateway {
 public:
     OrderGateway();
@@ -42,37 +29,136 @@ public:
     void start();
     void stop();
     bool is_running() const;
+    
+    // Fast path: take signals from a StrategyEngine in this process. The
+    // processing thread then spins instead of sleeping between polls.
+    // Set before start().
+    void set_signal_channel(SignalChannel* channel) { signal_channel_ = channel; }
+    
+    // Prepended to the "processing" thread plan name; set before start()
+    void set_thread_prefix(const std::string& prefix) { thread_prefix_ = prefix; }
+    
+    // True once warmup is over and live signals are being taken
+    bool is_warm() const { return warm_.load(std::memory_order_acquire); }
 
 private:
-    // ZeroMQ sockets
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> signal_subscriber_;
-    std::unique_ptr<zmq::socket_t> execution_publisher_;
+    // Transports on the process ZeroMQ context
+    std::unique_ptr<IMessageSubscriber> signal_subscriber_;
+    std::unique_ptr<IMessagePublisher> execution_publisher_;
+    std::unique_ptr<IMessageSubscriber> risk_limits_subscriber_;   // RiskLimitUpdate from the risk service
+    std::unique_ptr<IMessageSubscriber> market_data_subscriber_;   // Quotes for the router; null with one venue
     
     // Processing control
     std::atomic<bool> running_;
     std::unique_ptr<std::thread> processing_thread_;
     
-    // Order management
-    std::unordered_map<uint64_t, Order> active_orders_;
+    // Order management (preallocated; see OrderTable)
+    static constexpr size_t MAX_ACTIVE_ORDERS = 65536;
+    OrderTable active_orders_;
     std::atomic<uint64_t> next_order_id_;
     
+    // Synchronous pre-trade checks, run before any order leaves the gateway
+    PreTradeRisk risk_;
+    
+    // MODIFY quotes, collapsed per strategy, symbol and side while unacked,
+    // and the venue's message budget, shared with plain orders
+    static constexpr size_t MAX_QUOTE_SLOTS = 4096;
+    QuoteCoalescer quotes_;
+    
+    // Where each order goes (venue.<name> in hft_config.conf); scores are
+    // refreshed every router.score_refresh_ms on the processing thread
+    VenueRouter router_;
+    struct VenueMetrics {
+        metric_id_t ack_latency;
+        metric_id_t expected_latency;
+        metric_id_t orders_routed;
+    };
+    std::vector<VenueMetrics> venue_metrics_;
+    std::chrono::steady_clock::time_point last_router_refresh_;
+    
     // Alpaca integration (optional)
     std::unique_ptr<AlpacaClient> alpaca_client_;
     bool use_alpaca_;
     
+    // FIX order entry, when a venue is of kind fix; polled on the processing
+    // thread, and its venues only get orders while it is logged on
+    std::unique_ptr<FixSession> fix_session_;
+    bool fix_logged_on_ = false;
+    
     // Statistics
     std::atomic<uint64_t> orders_processed_;
     std::atomic<uint64_t> orders_filled_;
     std::atomic<uint64_t> orders_rejected_;
     
+    // Emergency stop, read once per processing loop iteration; the word last
+    // acted on (see KillSwitch)
+    KillSwitch* kill_switch_ = &KillSwitch::instance();
+    uint64_t kill_word_ = 0;
+    std::vector<uint64_t> kill_cancels_;    // Reserved for every working order up front
+    
+    // Processing thread only: orders are checked and booked but never routed
+    bool warming_up_ = false;
+    std::atomic<bool> warm_{false};
+    
+    // Working orders, fills and risk positions, journaled as they change and
+    // replayed on startup (null when journal.enabled is off)
+    std::unique_ptr<EventJournal> journal_;
+    bool replaying_ = false;    // Processing thread only
+    std::chrono::steady_clock::time_point last_snapshot_time_;
+    
+    SignalChannel* signal_channel_ = nullptr;
+    std::string thread_prefix_;
+    
     // Metrics
     MetricsPublisher metrics_publisher_;
     
     void process_signals();
+    // initialize()'s two halves, run side by side: the broker handshake is
+    // network round trips, the journal and sockets local work
+    void connect_broker();
+    bool open_transports();
+    // Replays synthetic signals through handle_trading_signal, then clears
+    // every order, risk and statistics trace they left behind
+    void warm_up();
+    // Rebuilds working orders, risk positions and the order ID sequence
+    void recover_from_journal();
+    void replay_journal_record(JournalRecordType type, const void* data, size_t size);
+    void snapshot_orders();
+    void journal_order(const Order& order);
+    // Journals the close and frees the order's slot
+    void close_order(uint64_t order_id);
     void handle_trading_signal(const TradingSignal& signal);
+    // Risk-checks, books and routes a new order; false if it was rejected
+    bool submit_order(Order& order);
+    void handle_quote(const TradingSignal& quote);
+    // Places or replaces the slot's order with its latest quote
+    void send_quote(QuoteSlot& slot);
+    void replace_quote(QuoteSlot& slot, Order& order);
+    // A replace the venue refused: the order goes back to what was acked
+    void revert_quote(QuoteSlot& slot, Order& order);
+    QuoteSlot* quote_slot(const Order& order);
+    void handle_risk_limit_update(const RiskLimitUpdate& update);
+    // Halts (and acknowledges) or resumes on a new kill switch word
+    void handle_kill_switch(uint64_t word);
+    // One mass cancel per broker, then the orders only this process holds
+    void cancel_all_orders();
+    // Reports the order cancelled, releases its risk and frees it
+    void cancel_order_locally(const Order& order);
+    // Venues from config, or the one the trading mode implies
+    void configure_venues();
+    void drain_market_data();
+    void refresh_venue_scores();
+    // An order sent to the venue at sent_time was acked now
+    void record_venue_ack(uint8_t venue, std::chrono::steady_clock::time_point sent_time);
+    void reject_order(const Order& order, RiskCheckResult reason);
     void simulate_order_fill(const Order& order);
     void handle_alpaca_order(Order& order);
+    void handle_alpaca_completion(uint64_t order_id, const AlpacaOrderResponse& response);
+    void handle_alpaca_cancel_all(const AlpacaOrderResponse& response);
+    void handle_fix_order(Order& order);
+    void handle_fix_report(const fix::ExecutionReport& report);
+    // Enables the fix venues while the session is logged on
+    void update_fix_venues();
     void publish_execution(const OrderExecution& execution);
     void log_statistics();
     
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include "../common/symbol_table.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+namespace hft {
+
+struct Order {
+    static constexpr size_t BROKER_ID_LENGTH = 48;    // Alpaca IDs are 36-char UUIDs
+
+    uint64_t order_id;
+    char symbol[SymbolTable::SYMBOL_LENGTH];
+    symbol_id_t symbol_id;
+    SignalAction action;
+    OrderType type;
+    price_t price;                  // Fixed-point limit price
+    uint32_t quantity;
+    uint32_t filled_quantity;
+    std::chrono::steady_clock::time_point created_time;
+    char external_order_id[BROKER_ID_LENGTH];  // Broker order ID (Alpaca), "" until acked
+    TraceContext trace;             // From the signal; gateway stages stamped here
+    uint64_t strategy_id;
+    bool quote;                     // Placed by a MODIFY: the strategy's working quote on this side
+    uint8_t venue;                  // VenueRouter index, set when routed
+    uint16_t revision;              // Replaces sent; FIX ClOrdIDs end in it
+
+    Order() : order_id(0), symbol{}, symbol_id(INVALID_SYMBOL_ID), action(SignalAction::BUY), type(OrderType::MARKET)
+        , price(0), quantity(0), filled_quantity(0), created_time(std::chrono::steady_clock::now())
+        , external_order_id{}, trace{}, strategy_id(0), quote(false), venue(0), revision(0) {}
+
+    // A MODIFY becomes an order on its side
+    Order(uint64_t id, const TradingSignal& signal)
+        : order_id(id), symbol{}
+        , symbol_id(SymbolTable::instance().resolve(signal.symbol_id, signal.symbol))
+        , action(signal.action == SignalAction::MODIFY ? signal.side : signal.action)
+        , type(signal.order_type), price(signal.price), quantity(signal.quantity)
+        , filled_quantity(0), created_time(std::chrono::steady_clock::now()), external_order_id{}
+        , trace(signal.trace), strategy_id(signal.strategy_id), quote(signal.action == SignalAction::MODIFY), venue(0)
+        , revision(0) {
+        std::strncpy(symbol, signal.symbol, sizeof(symbol) - 1);
+    }
+};
+
+// Working orders for the gateway: a preallocated pool of Order slots plus two
+// flat open-addressed indexes (linear probing, backward-shift deletion, no
+// tombstones), one by our order ID and one by broker order ID. Nothing
+// allocates after construction, so submit, ack and fill stay off the heap.
+// Single-threaded, like the gateway's processing loop. The pool and indexes
+// come from memory, typically the service's HugePageArena.
+class OrderTable {
+public:
+    explicit OrderTable(size_t capacity, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : slots_(capacity, memory)
+        , free_slots_(memory)
+        , id_index_(index_size(capacity), memory)
+        , broker_index_(index_size(capacity), memory)
+        , mask_(index_size(capacity) - 1)
+        , size_(0) {
+        free_slots_.reserve(capacity);
+        for (size_t i = capacity; i-- > 0;) {
+            free_slots_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Stores a copy of order; nullptr if the pool is full or the ID is taken
+    Order* insert(const Order& order) {
+        if (free_slots_.empty() || order.order_id == EMPTY_KEY || find(order.order_id)) {
+            return nullptr;
+        }
+        uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        slots_[slot] = order;
+        slots_[slot].external_order_id[0] = '\0';
+        index_insert(id_index_, order.order_id, slot);
+        size_++;
+        return &slots_[slot];
+    }
+
+    Order* find(uint64_t order_id) {
+        for (size_t i = bucket(order_id); id_index_[i].key != EMPTY_KEY; i = (i + 1) & mask_) {
+            if (id_index_[i].key == order_id) return &slots_[id_index_[i].slot];
+        }
+        return nullptr;
+    }
+
+    // Copies the broker's ID inline and indexes it; false if it doesn't fit
+    bool set_broker_id(Order& order, const char* broker_id) {
+        size_t length = std::strlen(broker_id);
+        if (length == 0 || length >= Order::BROKER_ID_LENGTH) return false;
+        uint32_t slot = slot_of(order);
+        if (order.external_order_id[0] != '\0') {
+            index_erase(broker_index_, broker_hash(order.external_order_id), slot);
+        }
+        std::memcpy(order.external_order_id, broker_id, length + 1);
+        index_insert(broker_index_, broker_hash(broker_id), slot);
+        return true;
+    }
+
+    Order* find_by_broker_id(const char* broker_id) {
+        uint64_t key = broker_hash(broker_id);
+        for (size_t i = bucket(key); broker_index_[i].key != EMPTY_KEY; i = (i + 1) & mask_) {
+            // Distinct IDs can share a hash; the inline copy breaks the tie
+            Order& order = slots_[broker_index_[i].slot];
+            if (broker_index_[i].key == key &&
+                std::strncmp(order.external_order_id, broker_id, Order::BROKER_ID_LENGTH) == 0) {
+                return &order;
+            }
+        }
+        return nullptr;
+    }
+
+    // The slot goes back to the pool; pointers to it are invalid afterwards
+    bool erase(uint64_t order_id) {
+        Order* order = find(order_id);
+        if (!order) return false;
+        uint32_t slot = slot_of(*order);
+        if (order->external_order_id[0] != '\0') {
+            index_erase(broker_index_, broker_hash(order->external_order_id), slot);
+        }
+        index_erase(id_index_, order_id, slot);
+        free_slots_.push_back(slot);
+        size_--;
+        return true;
+    }
+
+    // fn(const Order&) for every working order, in no particular order
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Entry& entry : id_index_) {
+            if (entry.key != EMPTY_KEY) fn(slots_[entry.slot]);
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    bool full() const { return free_slots_.empty(); }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = 0;    // Order IDs start at 1
+
+    struct Entry {
+        uint64_t key = EMPTY_KEY;
+        uint32_t slot = 0;
+    };
+
+    std::pmr::vector<Order> slots_;
+    std::pmr::vector<uint32_t> free_slots_;
+    std::pmr::vector<Entry> id_index_;
+    std::pmr::vector<Entry> broker_index_;
+    size_t mask_;
+    size_t size_;
+
+    // Power of two at least twice the pool, so load stays at or below 50%
+    static size_t index_size(size_t capacity) {
+        size_t size = 16;
+        while (size < capacity * 2) size <<= 1;
+        return size;
+    }
+
+    size_t bucket(uint64_t key) const {
+        // Fibonacci hashing: sequential IDs spread across the table
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+    }
+
+    static uint64_t broker_hash(const char* id) {
+        uint64_t hash = 14695981039346656037ULL;    // FNV-1a
+        for (; *id; ++id) {
+            hash = (hash ^ static_cast<uint8_t>(*id)) * 1099511628211ULL;
+        }
+        return hash == EMPTY_KEY ? 1 : hash;
+    }
+
+    uint32_t slot_of(const Order& order) const { return static_cast<uint32_t>(&order - slots_.data()); }
+
+    void index_insert(std::pmr::vector<Entry>& index, uint64_t key, uint32_t slot) {
+        size_t i = bucket(key);
+        while (index[i].key != EMPTY_KEY) i = (i + 1) & mask_;
+        index[i] = Entry{key, slot};
+    }
+
+    void index_erase(std::pmr::vector<Entry>& index, uint64_t key, uint32_t slot) {
+        size_t i = bucket(key);
+        while (index[i].key != EMPTY_KEY && !(index[i].key == key && index[i].slot == slot)) {
+            i = (i + 1) & mask_;
+        }
+        if (index[i].key == EMPTY_KEY) return;
+
+        // Pull later entries of the probe run back into the gap, unless that
+        // would move one in front of its home bucket
+        size_t gap = i;
+        for (size_t j = (i + 1) & mask_; index[j].key != EMPTY_KEY; j = (j + 1) & mask_) {
+            size_t home = bucket(index[j].key);
+            if (((j - home) & mask_) >= ((j - gap) & mask_)) {
+                index[gap] = index[j];
+                gap = j;
+            }
+        }
+        index[gap] = Entry{};
+    }
+};
+
+} // namespace hft
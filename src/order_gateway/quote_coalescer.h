@@ -0,0 +1,225 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include "../common/symbol_table.h"
+#include "../common/token_bucket.h"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace hft {
+
+// A strategy's quote on one side of one symbol, and the order working it
+struct QuoteSlot {
+    uint64_t strategy_id = 0;
+    symbol_id_t symbol_id = INVALID_SYMBOL_ID;
+    SignalAction side = SignalAction::BUY;
+    uint64_t order_id = 0;          // Working order, 0 when there is none
+    bool in_flight = false;         // A place or replace is waiting on the venue's ack
+    bool pending = false;           // latest has not been sent
+    bool queued = false;            // On the release list
+    price_t acked_price = 0;        // The quote as the venue last confirmed it
+    uint32_t acked_quantity = 0;
+    TradingSignal latest{};         // Newest quote from the strategy
+};
+
+// Cancel/replace aggregation for the gateway's quoting orders. Each
+// (strategy, symbol, side) has one slot and at most one order working it.
+// A quote that arrives while the slot's previous message is unacked, or when
+// the venue's TokenBucket is empty, is held as the slot's pending quote, and
+// a newer quote overwrites it: however fast a strategy requotes, each slot
+// sends at most one message per ack, and only the latest price and size.
+//
+// Slots are preallocated and never freed (the set of strategy, symbol and
+// side triples is small and stable), indexed by an open-addressed table.
+// Single-threaded, like the gateway's processing loop.
+class QuoteCoalescer {
+public:
+    enum class Decision : uint8_t {
+        SEND,       // Send now, a token taken: place if slot.order_id is 0, else replace
+        HELD,       // Pending until the slot's ack or a token
+        UNCHANGED,  // Same price and size as the working order; nothing to send
+        FULL        // No slot left for a new strategy, symbol and side
+    };
+
+    explicit QuoteCoalescer(size_t capacity, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : slots_(memory)
+        , index_(index_size(capacity), 0, memory)
+        , release_(memory)
+        , mask_(index_size(capacity) - 1)
+        , capacity_(capacity) {
+        slots_.reserve(capacity);
+        release_.reserve(capacity);
+    }
+
+    TokenBucket& venue_limit() { return venue_; }
+
+    // Takes a MODIFY signal; slot is set unless the decision is FULL
+    Decision on_quote(const TradingSignal& quote, int64_t now_ns, QuoteSlot*& slot) {
+        slot = find_or_add(quote.strategy_id, quote.symbol_id, quote.side);
+        if (!slot) return Decision::FULL;
+        quotes_++;
+
+        // An unsent quote is superseded, never sent
+        bool superseded = slot->pending;
+        slot->latest = quote;
+        if (slot->in_flight) {
+            slot->pending = true;
+            if (superseded) coalesced_++;
+            return Decision::HELD;
+        }
+        if (slot->order_id != 0 && quote.price == slot->acked_price && quote.quantity == slot->acked_quantity) {
+            slot->pending = false;
+            if (superseded) coalesced_++;
+            return Decision::UNCHANGED;
+        }
+        if (!venue_.try_acquire(now_ns)) {
+            slot->pending = true;
+            if (superseded) coalesced_++;
+            throttled_++;
+            queue(*slot);
+            return Decision::HELD;
+        }
+        slot->pending = false;
+        if (superseded) coalesced_++;
+        return Decision::SEND;
+    }
+
+    // slot's latest went out as order_id
+    void on_sent(QuoteSlot& slot, uint64_t order_id) {
+        slot.order_id = order_id;
+        slot.in_flight = true;
+        sent_++;
+    }
+
+    // The venue acked the slot's in-flight message, or refused it and the
+    // order kept (or went back to) price and quantity
+    void on_ack(QuoteSlot& slot, price_t price, uint32_t quantity) {
+        slot.in_flight = false;
+        slot.acked_price = price;
+        slot.acked_quantity = quantity;
+        if (slot.pending) queue(slot);
+    }
+
+    // The slot's order is gone: filled, cancelled or rejected
+    void on_closed(QuoteSlot& slot) {
+        slot.order_id = 0;
+        slot.in_flight = false;
+        slot.acked_price = 0;
+        slot.acked_quantity = 0;
+        if (slot.pending) queue(slot);
+    }
+
+    // Journal recovery: order_id is working the slot, as last acked
+    QuoteSlot* adopt(uint64_t strategy_id, symbol_id_t symbol_id, SignalAction side,
+                     uint64_t order_id, price_t price, uint32_t quantity) {
+        QuoteSlot* slot = find_or_add(strategy_id, symbol_id, side);
+        if (!slot) return nullptr;
+        slot->order_id = order_id;
+        slot->in_flight = false;
+        slot->acked_price = price;
+        slot->acked_quantity = quantity;
+        return slot;
+    }
+
+    QuoteSlot* find(uint64_t strategy_id, symbol_id_t symbol_id, SignalAction side) {
+        for (size_t i = bucket(strategy_id, symbol_id, side); index_[i] != 0; i = (i + 1) & mask_) {
+            QuoteSlot& slot = slots_[index_[i] - 1];
+            if (slot.strategy_id == strategy_id && slot.symbol_id == symbol_id && slot.side == side) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    // send(QuoteSlot&) for each pending quote that can go now: its slot is
+    // not waiting on an ack, and a token was available. Returns how many went.
+    template <typename Fn>
+    size_t release(int64_t now_ns, Fn&& send) {
+        size_t sent = 0;
+        size_t kept = 0;
+        // send() may queue slots; they land past i and are visited this pass
+        for (size_t i = 0; i < release_.size(); ++i) {
+            QuoteSlot& slot = slots_[release_[i]];
+            if (!slot.pending) {
+                slot.queued = false;
+                continue;
+            }
+            if (slot.in_flight) {
+                slot.queued = false;    // on_ack queues it again
+                continue;
+            }
+            if (!venue_.try_acquire(now_ns)) {
+                release_[kept++] = release_[i];
+                continue;
+            }
+            slot.pending = false;
+            slot.queued = false;
+            send(slot);
+            sent++;
+        }
+        release_.resize(kept);
+        return sent;
+    }
+
+    bool has_releases() const { return !release_.empty(); }
+
+    size_t size() const { return slots_.size(); }
+    size_t capacity() const { return capacity_; }
+    uint64_t quotes() const { return quotes_; }
+    uint64_t sent() const { return sent_; }
+    uint64_t coalesced() const { return coalesced_; }     // Quotes superseded before they were sent
+    uint64_t throttled() const { return throttled_; }     // Quotes held for a venue token
+
+private:
+    std::pmr::vector<QuoteSlot> slots_;
+    std::pmr::vector<uint32_t> index_;      // Slot + 1; 0 is empty
+    std::pmr::vector<uint32_t> release_;    // Slots with a quote to send once allowed
+    size_t mask_;
+    size_t capacity_;
+    TokenBucket venue_;
+
+    uint64_t quotes_ = 0;
+    uint64_t sent_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t throttled_ = 0;
+
+    // Power of two at least twice the slot count, so load stays at or below 50%
+    static size_t index_size(size_t capacity) {
+        size_t size = 16;
+        while (size < capacity * 2) size <<= 1;
+        return size;
+    }
+
+    size_t bucket(uint64_t strategy_id, symbol_id_t symbol_id, SignalAction side) const {
+        uint64_t key = strategy_id * 0x9E3779B97F4A7C15ULL ^
+                       ((static_cast<uint64_t>(symbol_id) << 1 | (side == SignalAction::SELL)) * 0xC2B2AE3D27D4EB4FULL);
+        return static_cast<size_t>(key >> 32) & mask_;
+    }
+
+    QuoteSlot* find_or_add(uint64_t strategy_id, symbol_id_t symbol_id, SignalAction side) {
+        if (side != SignalAction::BUY && side != SignalAction::SELL) return nullptr;
+        size_t i = bucket(strategy_id, symbol_id, side);
+        for (; index_[i] != 0; i = (i + 1) & mask_) {
+            QuoteSlot& slot = slots_[index_[i] - 1];
+            if (slot.strategy_id == strategy_id && slot.symbol_id == symbol_id && slot.side == side) {
+                return &slot;
+            }
+        }
+        if (slots_.size() == capacity_) return nullptr;     // Full: slot pointers must stay put
+        QuoteSlot& slot = slots_.emplace_back();
+        slot.strategy_id = strategy_id;
+        slot.symbol_id = symbol_id;
+        slot.side = side;
+        index_[i] = static_cast<uint32_t>(slots_.size());
+        return &slot;
+    }
+
+    void queue(QuoteSlot& slot) {
+        if (slot.queued) return;
+        slot.queued = true;
+        release_.push_back(static_cast<uint32_t>(&slot - slots_.data()));
+    }
+};
+
+} // namespace hft
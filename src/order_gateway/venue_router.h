@@ -0,0 +1,225 @@
+#pragma once
+
+#include "../common/fixed_price.h"
+#include "../common/latency_histogram.h"
+#include "../common/message_types.h"
+#include "../common/symbol_table.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace hft {
+
+// How the gateway reaches a venue
+enum class VenueKind : uint8_t {
+    SIMULATED,  // Local paper fills (simulate_order_fill)
+    ALPACA,     // AlpacaClient
+    FIX         // FixSession
+};
+
+struct VenueConfig {
+    std::string name;
+    VenueKind kind = VenueKind::SIMULATED;
+    price_t taker_fee = 0;          // Per share, paid by marketable orders (fixed-point)
+    price_t maker_rebate = 0;       // Per share, earned by resting orders (fixed-point)
+
+    // "<kind>[:<taker fee>[:<maker rebate>]]", kind simulated, alpaca or fix and
+    // fees in USD per share (venue.<name> in hft_config.conf); false with
+    // error set on anything else
+    static bool parse(const std::string& name, const std::string& value, VenueConfig& config, std::string& error) {
+        config = VenueConfig{};
+        config.name = name;
+        size_t first = value.find(':');
+        std::string kind = value.substr(0, first);
+        if (kind == "simulated") {
+            config.kind = VenueKind::SIMULATED;
+        } else if (kind == "alpaca") {
+            config.kind = VenueKind::ALPACA;
+        } else if (kind == "fix") {
+            config.kind = VenueKind::FIX;
+        } else {
+            error = "venue." + name + ": unknown kind '" + kind + "'";
+            return false;
+        }
+        if (first == std::string::npos) return true;
+
+        size_t second = value.find(':', first + 1);
+        if (!parse_fee(value.substr(first + 1, second - first - 1), config.taker_fee) ||
+            (second != std::string::npos && !parse_fee(value.substr(second + 1), config.maker_rebate))) {
+            error = "venue." + name + ": fees must be USD per share, as in simulated:0.003:0.002";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static bool parse_fee(const std::string& text, price_t& fee) {
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        if (text.empty() || *end != '\0' || value < 0.0 || value > 1.0) return false;
+        fee = to_fixed_price(value);
+        return true;
+    }
+};
+
+// Smart order routing across the gateway's venues. Each order goes to the
+// venue with the lowest expected cost per share:
+//
+//   latency cost (p90 ack latency x router.latency_cost_per_ms)
+//   + taker fee and distance from the best quote, if the order is
+//     marketable, or - maker rebate if it would rest
+//
+// A marketable order only goes where it crosses: resting it on another
+// venue for the rebate would give up the fill.
+//
+// The latency part only changes as acks come in, so it is folded into a
+// per-venue base score by refresh_scores(), off the order path; route()
+// then reads one row of quotes and a handful of precomputed scores, and
+// allocates nothing. Quotes older than the max age count as absent: a venue
+// without a price loses a marketable order to one that has one.
+//
+// Venues are added at setup, in priority order (ties go to the first).
+// Single-threaded, like the gateway's processing loop.
+class VenueRouter {
+public:
+    static constexpr size_t MAX_VENUES = 8;
+    static constexpr uint8_t NO_VENUE = 0xFF;
+
+    explicit VenueRouter(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : quotes_(memory) {}
+
+    // Setup, before reserve_quotes(); the venue's index, or NO_VENUE when full
+    uint8_t add_venue(const VenueConfig& config) {
+        if (count_ == MAX_VENUES) return NO_VENUE;
+        Venue& venue = venues_[count_];
+        venue.config = config;
+        venue.enabled = true;
+        return static_cast<uint8_t>(count_++);
+    }
+
+    // Quote rows for symbol IDs below symbols; quotes for others are dropped
+    void reserve_quotes(size_t symbols) {
+        quotes_.assign(symbols * count_, VenueQuote{});
+        symbol_capacity_ = symbols;
+    }
+
+    // USD per share per millisecond of expected ack latency
+    void set_latency_cost(double usd_per_share_per_ms) { latency_cost_per_ms_ = usd_per_share_per_ms; }
+    void set_quote_max_age(int64_t max_age_ns) { quote_max_age_ns_ = max_age_ns; }
+
+    // A disabled venue gets no orders (a broker that is down, say)
+    void set_enabled(uint8_t venue, bool enabled) {
+        if (venue < count_) venues_[venue].enabled = enabled;
+    }
+
+    void on_quote(uint8_t venue, symbol_id_t symbol, price_t bid, price_t ask, int64_t now_ns) {
+        if (venue >= count_ || symbol >= symbol_capacity_) return;
+        quotes_[symbol * count_ + venue] = VenueQuote{bid, ask, now_ns};
+    }
+
+    // The venue acked an order latency_ns after it was sent
+    void on_ack(uint8_t venue, uint64_t latency_ns) {
+        if (venue < count_) venues_[venue].window.record(latency_ns);
+    }
+
+    // Folds each venue's acks since the last refresh into its expected
+    // latency (half the new window's p90, half the old estimate) and
+    // recomputes the base scores. Takes a snapshot, so not per order.
+    void refresh_scores() {
+        for (size_t i = 0; i < count_; ++i) {
+            Venue& venue = venues_[i];
+            HistogramSnapshot snapshot;
+            snapshot.add(venue.window);
+            if (!snapshot.empty()) {
+                uint64_t p90 = snapshot.percentile(0.90);
+                venue.expected_latency_ns = venue.expected_latency_ns == 0 ? p90 : (venue.expected_latency_ns + p90) / 2;
+                venue.window.reset();
+            }
+            double cost = static_cast<double>(venue.expected_latency_ns) / 1e6 * latency_cost_per_ms_;
+            venue.base_cost = to_fixed_price(cost);
+        }
+    }
+
+    // Best venue for the order; NO_VENUE only if every venue is disabled
+    uint8_t route(symbol_id_t symbol, SignalAction side, OrderType type, price_t limit, int64_t now_ns) {
+        const VenueQuote* row = symbol < symbol_capacity_ ? &quotes_[symbol * count_] : nullptr;
+        bool buy = side == SignalAction::BUY;
+
+        // Best touch among the venues with a fresh quote
+        price_t best_touch = 0;
+        bool any_fresh = false;
+        for (size_t i = 0; row && i < count_; ++i) {
+            if (!venues_[i].enabled || !fresh(row[i], now_ns)) continue;
+            price_t touch = buy ? row[i].ask : row[i].bid;
+            if (!any_fresh || (buy ? touch < best_touch : touch > best_touch)) best_touch = touch;
+            any_fresh = true;
+        }
+
+        bool marketable = type == OrderType::MARKET ||
+                          (any_fresh && (buy ? limit >= best_touch : limit <= best_touch));
+
+        uint8_t best = NO_VENUE;
+        int64_t best_cost = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            const Venue& venue = venues_[i];
+            if (!venue.enabled) continue;
+            bool quoted = row && fresh(row[i], now_ns);
+            price_t touch = quoted ? (buy ? row[i].ask : row[i].bid) : 0;
+
+            int64_t cost = venue.base_cost;
+            if (marketable) {
+                // Without any fresh quote there is no touch to compare: fees decide
+                bool crosses = quoted && (type == OrderType::MARKET || (buy ? limit >= touch : limit <= touch));
+                if (any_fresh && !crosses) continue;
+                cost += venue.config.taker_fee + (quoted ? (buy ? touch - best_touch : best_touch - touch) : 0);
+            } else {
+                cost -= venue.config.maker_rebate;
+            }
+            if (best == NO_VENUE || cost < best_cost) {
+                best = static_cast<uint8_t>(i);
+                best_cost = cost;
+            }
+        }
+        if (best != NO_VENUE) venues_[best].routed++;
+        return best;
+    }
+
+    size_t venue_count() const { return count_; }
+    const VenueConfig& config(uint8_t venue) const { return venues_[venue].config; }
+    bool enabled(uint8_t venue) const { return venues_[venue].enabled; }
+    uint64_t expected_latency_ns(uint8_t venue) const { return venues_[venue].expected_latency_ns; }
+    price_t base_cost(uint8_t venue) const { return venues_[venue].base_cost; }
+    uint64_t routed(uint8_t venue) const { return venues_[venue].routed; }
+
+private:
+    struct VenueQuote {
+        price_t bid = 0;
+        price_t ask = 0;
+        int64_t time_ns = 0;        // 0 = never quoted
+    };
+
+    struct Venue {
+        VenueConfig config;
+        bool enabled = false;
+        LatencyHistogram window;            // Acks since the last refresh
+        uint64_t expected_latency_ns = 0;
+        price_t base_cost = 0;              // Latency cost per share, from refresh_scores()
+        uint64_t routed = 0;
+    };
+
+    bool fresh(const VenueQuote& quote, int64_t now_ns) const {
+        return quote.time_ns != 0 && now_ns - quote.time_ns <= quote_max_age_ns_ && quote.bid > 0 && quote.ask > 0;
+    }
+
+    std::array<Venue, MAX_VENUES> venues_;
+    size_t count_ = 0;
+    std::pmr::vector<VenueQuote> quotes_;   // Row per symbol, column per venue
+    size_t symbol_capacity_ = 0;
+    double latency_cost_per_ms_ = 0.0;
+    int64_t quote_max_age_ns_ = 1000000000;
+};
+
+} // namespace hft
@@ -1,6 +1,10 @@
 #include "position_risk_service.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/sampling_profiler.h"
+#include "../common/startup_timeline.h"
 #include <iostream>
 #include <signal.h>
 #include <thread>
@@ -20,8 +24,22 @@ int main(int argc, char* argv[]) {
     std::cout << "HFT Position & Risk Service v1.0" << std::endl;
     std::cout << "=================================" << std::endl;
     
-    std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
-    StaticConfig::load_from_file(config_file.c_str());
+    // [config] [--replay <capture file>]
+    StartupTimeline& startup = StartupTimeline::instance();
+    std::string config_file = "config/hft_config.conf";
+    std::string replay_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            replay_file = argv[++i];
+        } else {
+            config_file = arg;
+        }
+    }
+    startup.run("config", [&] { StaticConfig::load_from_file(config_file.c_str()); return true; });
+    ThreadPlan::instance().configure("position_risk_service");
+    // Reserve and pre-fault hot-state memory before the service allocates from it
+    startup.run("hot_arena", [] { HugePageArena::hot(); return true; });
     GlobalLogger::instance().init("PositionRiskService", StaticConfig::get_logger_endpoint());
     
     signal(SIGINT, signal_handler);
@@ -30,18 +48,35 @@ int main(int argc, char* argv[]) {
     try {
         g_service = std::make_unique<PositionRiskService>();
         
-        if (!g_service->initialize()) {
+        if (!startup.run("initialize", [] { return g_service->initialize(); })) {
             std::cerr << "Failed to initialize Position & Risk Service" << std::endl;
             return 1;
         }
+        std::cout << "Hot arena: " << HugePageArena::hot().describe() << std::endl;
+        
+        if (!replay_file.empty()) {
+            CaptureReader capture;
+            if (!capture.open(replay_file)) {
+                return 1;
+            }
+            std::cout << "Replaying " << capture.messages() << " messages captured by "
+                      << capture.service() << " from " << replay_file << std::endl;
+            ReplayReport report = g_service->replay_capture(capture);
+            std::cout << "Replay: " << report.describe() << std::endl;
+            return 0;
+        }
         
         g_service->start();
+        SamplingProfiler::instance().start_control_listener("PositionRiskService");
+        startup.ready("Position & Risk Service");
         
         std::cout << "Position & Risk Service is running. Press Ctrl+C to stop." << std::endl;
         
         while (g_service->is_running()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        SamplingProfiler::instance().stop_control_listener();
+        SamplingProfiler::instance().stop();
         
         std::cout << "Position & Risk Service shutdown complete." << std::endl;
         
@@ -0,0 +1,321 @@
+#include "portfolio_risk.h"
+#include "../common/static_config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace hft {
+
+namespace {
+
+// A register of doubles and its comparison masks, as GCC/Clang vector
+// extensions
+using Lanes = double __attribute__((vector_size(PortfolioRisk::LANES * sizeof(double))));
+using Mask = int64_t __attribute__((vector_size(PortfolioRisk::LANES * sizeof(int64_t))));
+
+constexpr size_t LANES = PortfolioRisk::LANES;
+constexpr double UNLIMITED = std::numeric_limits<double>::infinity();
+
+// Candidates gathered per pass of evaluate()
+constexpr size_t BATCH = 64;
+
+inline Lanes load(const double* p) {
+    Lanes v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void store(double* p, Lanes v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline Lanes splat(double value) {
+    return Lanes{} + value;
+}
+
+inline Lanes abs(Lanes v) {
+    return reinterpret_cast<Lanes>(reinterpret_cast<Mask>(v) & (Mask{} + std::numeric_limits<int64_t>::max()));
+}
+
+inline double sum(Lanes v) {
+    double total = 0.0;
+    for (size_t i = 0; i < LANES; ++i) total += v[i];
+    return total;
+}
+
+// Where mask is set, code; elsewhere what was there
+inline Mask select(Mask mask, int64_t code, Mask otherwise) {
+    return (mask & (Mask{} + code)) | (~mask & otherwise);
+}
+
+double positive_or_unlimited(double limit) {
+    return limit > 0.0 ? limit : UNLIMITED;
+}
+
+bool parse_number(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+} // namespace
+
+bool SymbolRiskConfig::parse(const std::string& symbol, const std::string& value, SymbolRiskConfig& config,
+                             std::string& error) {
+    config = SymbolRiskConfig{};
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t colon = value.find(':', start);
+        fields.push_back(value.substr(start, colon - start));
+        if (colon == std::string::npos) break;
+        start = colon + 1;
+    }
+    config.sector = fields[0];
+    bool ok = fields.size() <= 4 &&
+              (fields.size() < 2 || parse_number(fields[1], config.beta)) &&
+              (fields.size() < 3 || (parse_number(fields[2], config.daily_volatility) && config.daily_volatility >= 0.0)) &&
+              (fields.size() < 4 || (parse_number(fields[3], config.max_position_value) && config.max_position_value >= 0.0));
+    if (!ok) {
+        error = "risk.symbol." + symbol + ": expected <sector>[:<beta>[:<daily volatility>[:<max position value>]]], got '" +
+                value + "'";
+    }
+    return ok;
+}
+
+PortfolioLimits PortfolioLimits::from_config() {
+    PortfolioLimits limits;
+    limits.max_position_value = StaticConfig::get_max_position_value();
+    limits.max_gross_exposure = StaticConfig::get_max_gross_exposure();
+    limits.max_net_exposure = StaticConfig::get_max_net_exposure();
+    limits.max_sector_exposure = StaticConfig::get_max_sector_exposure();
+    limits.max_value_at_risk = StaticConfig::get_max_value_at_risk();
+    limits.factor_daily_volatility = StaticConfig::get_factor_daily_volatility();
+    limits.symbol_daily_volatility = StaticConfig::get_symbol_daily_volatility();
+    limits.var_z = StaticConfig::get_var_z();
+    return limits;
+}
+
+const char* to_string(PortfolioCheck check) {
+    switch (check) {
+        case PortfolioCheck::OK: return "OK";
+        case PortfolioCheck::POSITION_LIMIT: return "POSITION_LIMIT";
+        case PortfolioCheck::GROSS_EXPOSURE: return "GROSS_EXPOSURE";
+        case PortfolioCheck::NET_EXPOSURE: return "NET_EXPOSURE";
+        case PortfolioCheck::SECTOR_EXPOSURE: return "SECTOR_EXPOSURE";
+        case PortfolioCheck::VALUE_AT_RISK: return "VALUE_AT_RISK";
+        case PortfolioCheck::UNKNOWN_SYMBOL: return "UNKNOWN_SYMBOL";
+    }
+    return "UNKNOWN";
+}
+
+PortfolioRisk::PortfolioRisk(size_t capacity, std::pmr::memory_resource* memory)
+    : capacity_((capacity + LANES - 1) / LANES * LANES)
+    , quantity_(capacity_, 0.0, memory)
+    , mark_(capacity_, 0.0, memory)
+    , value_(capacity_, 0.0, memory)
+    , beta_(capacity_, 1.0, memory)
+    , volatility_(capacity_, 0.0, memory)
+    , limit_(capacity_, UNLIMITED, memory)
+    , sector_(capacity_, 0, memory)
+    , own_volatility_(capacity_, 0.0, memory)
+    , own_limit_(capacity_, 0.0, memory)
+    , sector_names_{""} {
+    set_limits(PortfolioLimits{});
+}
+
+void PortfolioRisk::set_limits(const PortfolioLimits& limits) {
+    limits_ = limits;
+    for (size_t i = 0; i < capacity_; ++i) {
+        volatility_[i] = own_volatility_[i] > 0.0 ? own_volatility_[i] : limits.symbol_daily_volatility;
+        limit_[i] = positive_or_unlimited(own_limit_[i] > 0.0 ? own_limit_[i] : limits.max_position_value);
+    }
+    double var_limit = limits.max_value_at_risk / limits.var_z;
+    variance_limit_ = limits.max_value_at_risk > 0.0 && limits.var_z > 0.0 ? var_limit * var_limit : UNLIMITED;
+    // The idiosyncratic sum is weighted by the volatilities just changed
+    recompute();
+}
+
+bool PortfolioRisk::configure_symbol(symbol_id_t symbol_id, const SymbolRiskConfig& config) {
+    if (symbol_id >= capacity_) return false;
+    size_t sector = 0;
+    if (!config.sector.empty()) {
+        auto it = std::find(sector_names_.begin(), sector_names_.end(), config.sector);
+        sector = static_cast<size_t>(it - sector_names_.begin());
+        if (it == sector_names_.end()) {
+            if (sector_names_.size() == MAX_SECTORS) return false;
+            sector_names_.push_back(config.sector);
+        }
+    }
+    sector_[symbol_id] = static_cast<uint8_t>(sector);
+    beta_[symbol_id] = config.beta;
+    own_volatility_[symbol_id] = config.daily_volatility;
+    own_limit_[symbol_id] = config.max_position_value;
+    return true;
+}
+
+bool PortfolioRisk::load_config(std::string& error) {
+    bool ok = true;
+    for (const auto& [symbol, value] : StaticConfig::get_risk_symbols()) {
+        SymbolRiskConfig config;
+        std::string entry_error;
+        symbol_id_t id = SymbolTable::instance().find(symbol.c_str());
+        if (!SymbolRiskConfig::parse(symbol, value, config, entry_error)) {
+            error += (error.empty() ? "" : "; ") + entry_error;
+            ok = false;
+        } else if (id != INVALID_SYMBOL_ID && !configure_symbol(id, config)) {
+            error += (error.empty() ? "" : "; ") + std::string("risk.symbol.") + symbol + ": too many sectors";
+            ok = false;
+        }
+    }
+    set_limits(PortfolioLimits::from_config());
+    return ok;
+}
+
+void PortfolioRisk::update(symbol_id_t symbol_id, double quantity, double price) {
+    if (symbol_id >= capacity_) return;
+    if (price > 0.0) mark_[symbol_id] = price;
+    double old_value = value_[symbol_id];
+    double value = quantity * mark_[symbol_id];
+    quantity_[symbol_id] = quantity;
+    value_[symbol_id] = value;
+
+    double volatility = volatility_[symbol_id];
+    gross_ += std::abs(value) - std::abs(old_value);
+    net_ += value - old_value;
+    beta_exposure_ += beta_[symbol_id] * (value - old_value);
+    idiosyncratic_variance_ += volatility * volatility * (value * value - old_value * old_value);
+    sector_net_[sector_[symbol_id]] += value - old_value;
+}
+
+void PortfolioRisk::recompute() {
+    Lanes gross{}, net{}, beta{}, idiosyncratic{};
+    for (size_t i = 0; i < capacity_; i += LANES) {
+        Lanes value = load(&quantity_[i]) * load(&mark_[i]);
+        store(&value_[i], value);
+        Lanes weighted = load(&volatility_[i]) * value;
+        gross += abs(value);
+        net += value;
+        beta += load(&beta_[i]) * value;
+        idiosyncratic += weighted * weighted;
+    }
+    gross_ = sum(gross);
+    net_ = sum(net);
+    beta_exposure_ = sum(beta);
+    idiosyncratic_variance_ = sum(idiosyncratic);
+
+    // A scatter, so scalar; only symbols with a sector and a position add
+    sector_net_.fill(0.0);
+    for (size_t i = 0; i < capacity_; ++i) {
+        sector_net_[sector_[i]] += value_[i];
+    }
+}
+
+void PortfolioRisk::evaluate(const CandidateOrder* orders, size_t count, PortfolioCheck* results) const {
+    const double factor_variance = limits_.factor_daily_volatility * limits_.factor_daily_volatility;
+    const double variance = factor_variance * beta_exposure_ * beta_exposure_ + idiosyncratic_variance_;
+    const Lanes gross = splat(gross_);
+    const Lanes net = splat(net_);
+    const Lanes abs_net = abs(net);
+    const Lanes beta_exposure = splat(beta_exposure_);
+    const Lanes idiosyncratic = splat(idiosyncratic_variance_);
+    const Lanes max_gross = splat(positive_or_unlimited(limits_.max_gross_exposure));
+    const Lanes max_net = splat(positive_or_unlimited(limits_.max_net_exposure));
+    const Lanes max_sector = splat(positive_or_unlimited(limits_.max_sector_exposure));
+    const Lanes max_variance = splat(variance_limit_);
+
+    // Gathered per pass; the tail past count stays zero and passes
+    alignas(32) double old_value[BATCH], delta[BATCH], beta[BATCH], volatility[BATCH], limit[BATCH];
+    alignas(32) double sector_before[BATCH], sector_limited[BATCH];
+    alignas(32) int64_t codes[BATCH];
+
+    for (size_t base = 0; base < count; base += BATCH) {
+        size_t n = std::min(BATCH, count - base);
+        size_t padded = (n + LANES - 1) / LANES * LANES;
+        for (size_t j = 0; j < padded; ++j) {
+            const CandidateOrder* order = j < n ? &orders[base + j] : nullptr;
+            symbol_id_t id = order ? order->symbol_id : INVALID_SYMBOL_ID;
+            if (id >= capacity_) {
+                old_value[j] = delta[j] = beta[j] = volatility[j] = sector_before[j] = sector_limited[j] = 0.0;
+                limit[j] = UNLIMITED;
+                continue;
+            }
+            double price = order->price > 0.0 ? order->price : mark_[id];
+            old_value[j] = value_[id];
+            delta[j] = order->quantity * price;
+            beta[j] = beta_[id];
+            volatility[j] = volatility_[id];
+            limit[j] = limit_[id];
+            sector_before[j] = sector_net_[sector_[id]];
+            sector_limited[j] = sector_[id] != 0 ? 1.0 : 0.0;
+        }
+
+        // A check fails only if the order makes its measure worse: orders
+        // that reduce an exposure already over its limit go through
+        for (size_t j = 0; j < padded; j += LANES) {
+            Lanes before = load(&old_value[j]);
+            Lanes change = load(&delta[j]);
+            Lanes after = before + change;
+            Lanes abs_after = abs(after);
+
+            Mask position = (abs_after > load(&limit[j])) & (abs_after > abs(before));
+
+            Lanes gross_after = gross + abs_after - abs(before);
+            Mask gross_over = (gross_after > max_gross) & (gross_after > gross);
+
+            Lanes net_after = abs(net + change);
+            Mask net_over = (net_after > max_net) & (net_after > abs_net);
+
+            Lanes sector = load(&sector_before[j]);
+            Lanes sector_after = abs(sector + change);
+            Mask sector_over = (sector_after > max_sector) & (sector_after > abs(sector)) &
+                               (load(&sector_limited[j]) > 0.0);
+
+            Lanes factor = beta_exposure + load(&beta[j]) * change;
+            Lanes weighted_before = load(&volatility[j]) * before;
+            Lanes weighted_after = load(&volatility[j]) * after;
+            Lanes variance_after = factor_variance * factor * factor + idiosyncratic +
+                                   weighted_after * weighted_after - weighted_before * weighted_before;
+            Mask var_over = (variance_after > max_variance) & (variance_after > variance);
+
+            // Last write wins: the first failing check in enum order
+            Mask code{};
+            code = select(var_over, static_cast<int64_t>(PortfolioCheck::VALUE_AT_RISK), code);
+            code = select(sector_over, static_cast<int64_t>(PortfolioCheck::SECTOR_EXPOSURE), code);
+            code = select(net_over, static_cast<int64_t>(PortfolioCheck::NET_EXPOSURE), code);
+            code = select(gross_over, static_cast<int64_t>(PortfolioCheck::GROSS_EXPOSURE), code);
+            code = select(position, static_cast<int64_t>(PortfolioCheck::POSITION_LIMIT), code);
+            std::memcpy(&codes[j], &code, sizeof(code));
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            results[base + j] = orders[base + j].symbol_id >= capacity_ ? PortfolioCheck::UNKNOWN_SYMBOL
+                                                                        : static_cast<PortfolioCheck>(codes[j]);
+        }
+    }
+}
+
+double PortfolioRisk::value_at_risk() const {
+    double factor = limits_.factor_daily_volatility * beta_exposure_;
+    return limits_.var_z * std::sqrt(std::max(0.0, factor * factor + idiosyncratic_variance_));
+}
+
+double PortfolioRisk::sector_exposure(const std::string& sector) const {
+    auto it = std::find(sector_names_.begin(), sector_names_.end(), sector);
+    if (sector.empty() || it == sector_names_.end()) return 0.0;
+    return sector_net_[static_cast<size_t>(it - sector_names_.begin())];
+}
+
+bool PortfolioRisk::breached() const {
+    if (gross_ > positive_or_unlimited(limits_.max_gross_exposure)) return true;
+    if (std::abs(net_) > positive_or_unlimited(limits_.max_net_exposure)) return true;
+    for (size_t i = 1; i < sector_names_.size(); ++i) {
+        if (std::abs(sector_net_[i]) > positive_or_unlimited(limits_.max_sector_exposure)) return true;
+    }
+    double factor = limits_.factor_daily_volatility * beta_exposure_;
+    return factor * factor + idiosyncratic_variance_ > variance_limit_;
+}
+
+} // namespace hft
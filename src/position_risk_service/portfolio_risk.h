@@ -0,0 +1,146 @@
+#pragma once
+
+#include "../common/symbol_table.h"
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hft {
+
+// Per-symbol risk attributes (risk.symbol.<SYMBOL> in hft_config.conf)
+struct SymbolRiskConfig {
+    std::string sector;                 // "" = none, no sector limit applies
+    double beta = 1.0;                  // To the market factor
+    double daily_volatility = 0.0;      // Idiosyncratic, as a fraction; 0 = the configured default
+    double max_position_value = 0.0;    // USD; 0 = the portfolio default
+
+    // "<sector>[:<beta>[:<daily volatility>[:<max position value>]]]"; false
+    // with error set on anything else
+    static bool parse(const std::string& symbol, const std::string& value, SymbolRiskConfig& config,
+                      std::string& error);
+};
+
+// Portfolio-wide limits; 0 turns a limit off
+struct PortfolioLimits {
+    double max_position_value = 0.0;        // Per symbol, unless its SymbolRiskConfig says otherwise
+    double max_gross_exposure = 0.0;
+    double max_net_exposure = 0.0;          // Either direction
+    double max_sector_exposure = 0.0;       // Net, either direction, per named sector
+    double max_value_at_risk = 0.0;
+    double factor_daily_volatility = 0.012; // The market factor's
+    double symbol_daily_volatility = 0.02;  // Idiosyncratic, for symbols without their own
+    double var_z = 2.33;                    // 99% one-sided
+
+    static PortfolioLimits from_config();
+};
+
+enum class PortfolioCheck : uint8_t {
+    OK,
+    POSITION_LIMIT,
+    GROSS_EXPOSURE,
+    NET_EXPOSURE,
+    SECTOR_EXPOSURE,
+    VALUE_AT_RISK,
+    UNKNOWN_SYMBOL
+};
+
+const char* to_string(PortfolioCheck check);
+
+// A would-be order: quantity is signed (negative sells), price 0 uses the mark
+struct CandidateOrder {
+    symbol_id_t symbol_id = INVALID_SYMBOL_ID;
+    int32_t quantity = 0;
+    double price = 0.0;
+};
+
+// Portfolio exposure and a one-factor VaR over every symbol, kept in
+// structure-of-arrays form indexed by symbol ID:
+//
+//   market value   mv_i = quantity_i x mark_i
+//   gross, net     sum |mv_i|, sum mv_i; per sector, sum mv_i
+//   VaR            z x sqrt((factor vol x sum beta_i mv_i)^2 + sum (vol_i mv_i)^2)
+//
+// update() moves the sums by one symbol's change, so a fill or tick costs
+// O(1); recompute() rebuilds them from the arrays (on a timer, to shed the
+// running sums' drift) with vector kernels, four doubles wide with AVX and
+// two without. evaluate()
+// checks a batch of candidate orders, each against the current portfolio
+// (not against each other), the same way: gathered into lanes, then checked
+// without branches, so one call for a hundred orders costs little more
+// than for one. The VaR check compares variances, so it takes no square
+// roots.
+//
+// Single-threaded, like the risk service's processing loop.
+class PortfolioRisk {
+public:
+#if defined(__AVX__)
+    static constexpr size_t LANES = 4;
+#else
+    static constexpr size_t LANES = 2;
+#endif
+    static constexpr size_t MAX_SECTORS = 64;   // Sector 0 is "none"
+
+    explicit PortfolioRisk(size_t capacity = SymbolTable::MAX_SYMBOLS,
+                           std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Re-derives the per-symbol limit and volatility arrays from the limits
+    // and every symbol's config
+    void set_limits(const PortfolioLimits& limits);
+    // False if the ID is out of range or the sectors are full
+    bool configure_symbol(symbol_id_t symbol_id, const SymbolRiskConfig& config);
+    // risk.symbol.* for symbols already in the SymbolTable, then set_limits();
+    // false if an entry does not parse (logged by the caller from error)
+    bool load_config(std::string& error);
+
+    // The symbol now holds quantity, marked at price (0 keeps the last mark)
+    void update(symbol_id_t symbol_id, double quantity, double price);
+    // Exact sums from the arrays
+    void recompute();
+
+    // One result per order
+    void evaluate(const CandidateOrder* orders, size_t count, PortfolioCheck* results) const;
+    PortfolioCheck check(const CandidateOrder& order) const {
+        PortfolioCheck result;
+        evaluate(&order, 1, &result);
+        return result;
+    }
+
+    double gross_exposure() const { return gross_; }
+    double net_exposure() const { return net_; }
+    double beta_exposure() const { return beta_exposure_; }
+    double value_at_risk() const;
+    // Net market value of a named sector; 0 for one never configured
+    double sector_exposure(const std::string& sector) const;
+    size_t sector_count() const { return sector_names_.size(); }
+    // Any portfolio-wide limit (gross, net, sector, VaR) already exceeded
+    bool breached() const;
+
+private:
+    size_t capacity_;                       // Rounded up to LANES; the padding stays 0
+    PortfolioLimits limits_;
+
+    // Structure of arrays, by symbol ID
+    std::pmr::vector<double> quantity_;
+    std::pmr::vector<double> mark_;
+    std::pmr::vector<double> value_;        // quantity x mark, as last updated
+    std::pmr::vector<double> beta_;
+    std::pmr::vector<double> volatility_;   // Effective idiosyncratic daily vol
+    std::pmr::vector<double> limit_;        // Effective max position value; infinity = none
+    std::pmr::vector<uint8_t> sector_;
+    std::pmr::vector<double> own_volatility_;   // From SymbolRiskConfig; 0 = default
+    std::pmr::vector<double> own_limit_;
+
+    std::vector<std::string> sector_names_;     // [0] is ""
+    std::array<double, MAX_SECTORS> sector_net_{};
+
+    double gross_ = 0.0;
+    double net_ = 0.0;
+    double beta_exposure_ = 0.0;
+    double idiosyncratic_variance_ = 0.0;   // sum (vol_i mv_i)^2
+    double variance_limit_ = 0.0;           // (max VaR / z)^2; infinity = off
+};
+
+} // namespace hft
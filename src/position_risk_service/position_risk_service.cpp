@@ -2,7 +2,12 @@
 #include "../common/static_config.h"
 #include "../common/metrics_collector.h"
 #include "../common/metrics_publisher.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
 #include "../common/hft_metrics.h"
+#include "../common/warmup.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -10,10 +15,26 @@
 namespace hft {
 
 PositionRiskService::PositionRiskService()
-    : running_(false), max_position_value_(100000.0), max_daily_loss_(5000.0)
-    , current_daily_pnl_(0.0), positions_updated_(0), risk_checks_(0), risk_violations_(0)
+    : running_(false)
+    , positions_(SymbolTable::MAX_SYMBOLS, hot_memory())
+    , current_prices_(SymbolTable::MAX_SYMBOLS, 0.0, hot_memory())
+    , position_ids_(hot_memory())
+    , total_unrealized_(0.0), total_realized_(0.0), gross_exposure_(0.0), net_exposure_(0.0)
+    , open_position_count_(0)
+    , portfolio_(SymbolTable::MAX_SYMBOLS, hot_memory())
+    , value_at_risk_(0.0), beta_exposure_(0.0)
+    , dirty_(SymbolTable::MAX_SYMBOLS, 0, hot_memory())
+    , dirty_ids_(hot_memory())
+    , publish_interval_(StaticConfig::POSITION_PUBLISH_INTERVAL_MS)
+    , max_daily_loss_(5000.0)
+    , current_daily_pnl_(0.0)
+    , positions_updated_(0), risk_checks_(0), risk_violations_(0), position_batches_(0)
+    , warm_(false)
     , logger_("PositionRiskService", StaticConfig::get_logger_endpoint())
     , metrics_publisher_("PositionRiskService", ("tcp://*:" + std::to_string(StaticConfig::get_position_risk_service_metrics_port())).c_str()) {
+    // Reserve up front so the metrics thread never observes a reallocation
+    position_ids_.reserve(SymbolTable::MAX_SYMBOLS);
+    dirty_ids_.reserve(SymbolTable::MAX_SYMBOLS);
 }
 
 PositionRiskService::~PositionRiskService() {
@@ -24,7 +45,18 @@ bool PositionRiskService::initialize() {
     logger_.info("Initializing Position & Risk Service");
     
     MetricsCollector::instance().initialize();
-    StaticConfig::load_from_file("config/hft_config.conf");
+    StaticConfig::reload();
+    // Assign symbol IDs in config order so they agree across services
+    SymbolTable::instance().preload(StaticConfig::get_symbols());
+    publish_interval_ = std::chrono::milliseconds(StaticConfig::get_position_publish_interval_ms());
+    std::string portfolio_error;
+    if (!portfolio_.load_config(portfolio_error)) {
+        logger_.warning("Portfolio risk config: " + portfolio_error);
+    }
+    logger_.info("Portfolio risk over " + std::to_string(portfolio_.sector_count() - 1) + " sectors");
+    if (StaticConfig::get_journal_enabled()) {
+        journal_ = std::make_unique<EventJournal>(JournalConfig::from_config("position_risk"));
+    }
 
     // Initialize metrics publisher
     if (!metrics_publisher_.initialize()) {
@@ -33,27 +65,21 @@ bool PositionRiskService::initialize() {
     }
     
     
+    capture_ = MessageCapture::from_config("position_risk_service");
     try {
-        context_ = std::make_unique<zmq::context_t>(1);
-        
-        // Execution subscriber
-        execution_subscriber_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        execution_subscriber_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        execution_subscriber_->connect(StaticConfig::get_executions_endpoint());
-        
-        // Market data subscriber
-        market_data_subscriber_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        market_data_subscriber_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        market_data_subscriber_->connect(StaticConfig::get_market_data_endpoint());
-        
-        // Position publisher
-        position_publisher_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
-        position_publisher_->bind(StaticConfig::get_positions_endpoint());
+        execution_subscriber_ = capture_tap(TransportFactory::open_subscriber(
+            zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_executions_endpoint()))),
+            capture_.get(), "executions");
+        market_data_subscriber_ = capture_tap(TransportFactory::open_subscriber(
+            zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint()))),
+            capture_.get(), "market_data");
+        position_publisher_ = TransportFactory::open_publisher(
+            zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_positions_endpoint())));
         
         logger_.info("Position & Risk Service initialized");
         return true;
         
-    } catch (const zmq::error_t& e) {
+    } catch (const std::exception& e) {
         logger_.error("Initialization failed: " + std::string(e.what()));
         return false;
     }
@@ -70,9 +96,16 @@ void PositionRiskService::start() {
     
     // Start metrics publisher
     metrics_publisher_.start();
+    warmup::publish_pending();
+    if (capture_ && capture_->start()) {
+        logger_.info("Capturing input to " + capture_->path());
+    }
     
     processing_thread_ = std::make_unique<std::thread>(&PositionRiskService::process_messages, this);
     metrics_thread_ = std::make_unique<std::thread>(&PositionRiskService::metrics_update_loop, this);
+    config_reloader_.start([this](uint64_t generation) {
+        logger_.info("Configuration reloaded (generation " + std::to_string(generation) + ")");
+    });
     logger_.info("Service started");
 }
 
@@ -84,6 +117,7 @@ void PositionRiskService::stop() {
     
     // Stop metrics publisher
     metrics_publisher_.stop();
+    config_reloader_.stop();
     
     if (processing_thread_ && processing_thread_->joinable()) {
         processing_thread_->join();
@@ -93,6 +127,13 @@ void PositionRiskService::stop() {
         metrics_thread_->join();
     }
     
+    if (journal_) {
+        journal_->close();
+    }
+    if (capture_) {
+        capture_->stop();
+    }
+    
     if (execution_subscriber_) {
         try {
             execution_subscriber_->close();
@@ -120,39 +161,66 @@ bool PositionRiskService::is_running() const {
 }
 
 void PositionRiskService::process_messages() {
+    if (!ThreadPlan::instance().pin_current_thread("processing")) {
+        logger_.warning("Failed to pin processing thread to its planned CPU");
+    }
     logger_.info("Processing thread started");
+    warm_up();
+    recover_from_journal();
     
     zmq::pollitem_t items[] = {
-        { *execution_subscriber_, 0, ZMQ_POLLIN, 0 },
-        { *market_data_subscriber_, 0, ZMQ_POLLIN, 0 }
+        { execution_subscriber_->get_native_handle(), 0, ZMQ_POLLIN, 0 },
+        { market_data_subscriber_->get_native_handle(), 0, ZMQ_POLLIN, 0 }
     };
     
+    // Limit pushes go out on this thread: position_publisher_ is not shared
+    auto last_limits_time = std::chrono::steady_clock::time_point{};
+    const auto limits_interval = std::chrono::seconds(1);
+    last_snapshot_time_ = std::chrono::steady_clock::now();
+    
+    // Wake at least once per publish interval so batches go out on time
+    auto poll_timeout = std::min(std::chrono::milliseconds(100), std::max(publish_interval_, std::chrono::milliseconds(1)));
+    
     while (running_.load()) {
         try {
-            zmq::poll(&items[0], 2, std::chrono::milliseconds(100));
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_limits_time >= limits_interval) {
+                resync_totals();
+                publish_risk_limits();
+                last_limits_time = now;
+                
+                int snapshot_seconds = StaticConfig::get_journal_snapshot_interval_seconds();
+                if (journal_ && snapshot_seconds > 0 && now - last_snapshot_time_ >= std::chrono::seconds(snapshot_seconds)) {
+                    snapshot_positions();
+                    last_snapshot_time_ = now;
+                }
+            }
             
+            zmq::poll(&items[0], 2, poll_timeout);
+            
+            // Drain everything queued: each message only touches its own symbol
             if (items[0].revents & ZMQ_POLLIN) {
-                zmq::message_t message;
-                if (execution_subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                    if (message.size() == sizeof(OrderExecution)) {
-                        OrderExecution execution;
-                        std::memcpy(&execution, message.data(), sizeof(OrderExecution));
+                OrderExecution execution;
+                size_t size = sizeof(execution);
+                while (execution_subscriber_->receive(&execution, size, true)) {
+                    if (size == sizeof(OrderExecution)) {
                         handle_execution(execution);
                     }
+                    size = sizeof(execution);
                 }
             }
             
             if (items[1].revents & ZMQ_POLLIN) {
-                zmq::message_t message;
-                if (market_data_subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                    if (message.size() == sizeof(MarketData)) {
-                        MarketData data;
-                        std::memcpy(&data, message.data(), sizeof(MarketData));
-                        handle_market_data(data);
-                    }
+                MarketDataFrame frame;
+                size_t size = sizeof(frame);
+                while (market_data_subscriber_->receive(&frame, size, true)) {
+                    for_each_quote(&frame, size, [this](const MarketData& data) { handle_market_data(data); });
+                    size = sizeof(frame);
                 }
             }
             
+            flush_position_updates();
+            
         } catch (const zmq::error_t& e) {
             if (e.num() != EINTR) {
                 logger_.error("Processing error: " + std::string(e.what()));
@@ -160,27 +228,172 @@ void PositionRiskService::process_messages() {
         }
     }
     
+    flush_position_updates(true);
     logger_.info("Processing thread stopped");
 }
 
+ReplayReport PositionRiskService::replay_capture(const CaptureReader& capture) {
+    ReplayReport report;
+    report.dropped_at_capture = capture.dropped();
+    report.captured_span_ns = capture.span_ns();
+    int executions = capture.channel("executions");
+    int market_data = capture.channel("market_data");
+    
+    auto start = std::chrono::steady_clock::now();
+    capture.for_each([&](const CapturedMessage& message) {
+        if (message.channel == executions && message.size == sizeof(OrderExecution)) {
+            OrderExecution execution;
+            std::memcpy(&execution, message.data, sizeof(execution));
+            handle_execution(execution);
+        } else if (message.channel == market_data && message.size <= sizeof(MarketDataFrame)) {
+            // Copied out: the mapped record is only 8-byte aligned
+            MarketDataFrame frame;
+            std::memcpy(&frame, message.data, message.size);
+            for_each_quote(&frame, message.size, [this](const MarketData& data) { handle_market_data(data); });
+        } else {
+            report.skipped++;
+            return;
+        }
+        report.messages++;
+        flush_position_updates();
+    });
+    flush_position_updates(true);
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    return report;
+}
+
+void PositionRiskService::warm_up() {
+    std::vector<symbol_id_t> symbols = warmup::universe();
+    if (!StaticConfig::get_warmup_enabled() || symbols.empty()) {
+        warm_.store(true, std::memory_order_release);
+        warmup::publish(WarmupReport{});
+        return;
+    }
+    
+    // Alternating fill and tick per symbol
+    std::vector<OrderExecution> executions;
+    std::vector<MarketData> ticks;
+    for (uint64_t i = 0; i < symbols.size() * 8; ++i) {
+        executions.push_back(warmup::synthetic_execution(symbols[i % symbols.size()], i / symbols.size()));
+        ticks.push_back(warmup::synthetic_tick(symbols[i % symbols.size()], i / symbols.size()));
+    }
+    
+    warming_up_ = true;
+    WarmupReport report = run_warmup(WarmupOptions::from_config(), [&](uint64_t i) {
+        size_t slot = (i / 2) % ticks.size();
+        if (i & 1) {
+            handle_market_data(ticks[slot]);
+        } else {
+            handle_execution(executions[slot]);
+        }
+    });
+    warming_up_ = false;
+    
+    // Nothing was published; the first real fill starts each position afresh
+    for (symbol_id_t id : position_ids_) {
+        positions_[id] = Position{};
+        portfolio_.update(id, 0.0, 0.0);
+    }
+    position_ids_.clear();
+    open_position_count_.store(0, std::memory_order_release);
+    std::fill(current_prices_.begin(), current_prices_.end(), 0.0);
+    for (symbol_id_t id : dirty_ids_) {
+        dirty_[id] = 0;
+    }
+    dirty_ids_.clear();
+    resync_totals();
+    positions_updated_.store(0);
+    
+    warm_.store(true, std::memory_order_release);
+    warmup::publish(report);
+    logger_.info("Warmup " + report.describe());
+}
+
+void PositionRiskService::recover_from_journal() {
+    if (!journal_) return;
+    
+    replaying_ = true;
+    JournalRecovery recovery = journal_->recover([this](JournalRecordType type, const void* data, size_t size) {
+        if (type == JournalRecordType::POSITION_UPDATE && size == sizeof(PositionUpdate)) {
+            PositionUpdate update;
+            std::memcpy(&update, data, sizeof(update));
+            restore_position(update);
+        } else if (type == JournalRecordType::ORDER_EXECUTION && size == sizeof(OrderExecution)) {
+            OrderExecution execution;
+            std::memcpy(&execution, data, sizeof(execution));
+            handle_execution(execution);
+        }
+    });
+    replaying_ = false;
+    resync_totals();
+    
+    logger_.info("Journal recovery: " + recovery.describe() + ", " +
+                 std::to_string(position_ids_.size()) + " positions");
+    if (!journal_->open()) {
+        logger_.error("Failed to open the position journal; fills will not be journaled");
+    }
+}
+
+void PositionRiskService::restore_position(const PositionUpdate& update) {
+    char symbol[sizeof(update.symbol) + 1] = {};
+    std::memcpy(symbol, update.symbol, sizeof(update.symbol));
+    symbol_id_t id = SymbolTable::instance().intern(symbol);
+    if (id >= positions_.size()) return;
+    
+    auto& position = positions_[id];
+    if (position.symbol.empty()) {
+        position_ids_.push_back(id);
+        open_position_count_.store(position_ids_.size(), std::memory_order_release);
+    }
+    position.symbol = symbol;
+    position.quantity = update.position;
+    position.average_price = update.average_price;
+    position.unrealized_pnl = update.unrealized_pnl;
+    position.realized_pnl = update.realized_pnl;
+    mark_position(id);
+}
+
+void PositionRiskService::snapshot_positions() {
+    JournalSnapshot snapshot;
+    for (symbol_id_t id : position_ids_) {
+        snapshot.add(JournalRecordType::POSITION_UPDATE, make_position_update(id));
+    }
+    journal_->snapshot(std::move(snapshot));
+}
+
 void PositionRiskService::handle_execution(const OrderExecution& execution) {
     HFT_RDTSC_TIMER(hft::metrics::TOTAL_LATENCY);
     
-    std::string symbol(execution.symbol);
-    auto& position = positions_[symbol];
+    // Gateway pre-trade rejects never reached the market
+    if (execution.exec_type == ExecutionType::REJECTED) return;
+    
+    // A copy into the journal's ring; the writer thread does the I/O
+    if (journal_ && !warming_up_ && !replaying_) {
+        journal_->append(JournalRecordType::ORDER_EXECUTION, execution);
+    }
+    
+    symbol_id_t id = SymbolTable::instance().resolve(execution.symbol_id, execution.symbol);
+    if (id >= positions_.size()) return;
+    
+    auto& position = positions_[id];
+    if (position.symbol.empty()) {
+        // First fill for this symbol
+        position.symbol = execution.symbol;
+        position_ids_.push_back(id);
+        open_position_count_.store(position_ids_.size(), std::memory_order_release);
+    }
     
     int32_t qty_change = (execution.exec_type == ExecutionType::FILL) ? 
                         static_cast<int32_t>(execution.fill_quantity) : 0;
     
     // Update position
     if (position.quantity == 0) {
-        position.symbol = symbol;
         position.quantity = qty_change;
-        position.average_price = execution.fill_price;
+        position.average_price = to_double_price(execution.fill_price);
     } else {
         // Update average price
         double total_cost = position.quantity * position.average_price + 
-                           qty_change * execution.fill_price;
+                           qty_change * to_double_price(execution.fill_price);
         position.quantity += qty_change;
         if (position.quantity != 0) {
             position.average_price = total_cost / position.quantity;
@@ -190,50 +403,150 @@ void PositionRiskService::handle_execution(const OrderExecution& execution) {
     positions_updated_++;
     HFT_COMPONENT_COUNTER(hft::metrics::POSITIONS_UPDATED_TOTAL);
     
-    publish_position_update(symbol);
-    logger_.info("Position updated: " + symbol + " qty=" + std::to_string(position.quantity));
+    mark_position(id);
+    if (!warming_up_ && !replaying_) {
+        HFT_LOGF(logger_, LogLevel::INFO, "Position updated: {} qty={}", position.symbol, position.quantity);
+    }
 }
 
 void PositionRiskService::handle_market_data(const MarketData& data) {
-    std::string symbol(data.symbol);
-    current_prices_[symbol] = data.last_price;
-    update_unrealized_pnl();
+    symbol_id_t id = SymbolTable::instance().resolve(data.symbol_id, data.symbol);
+    if (id >= current_prices_.size()) return;
+    
+    current_prices_[id] = to_double_price(data.last_price);
+    
+    // Symbols we have never traded have nothing to re-mark
+    if (!positions_[id].symbol.empty()) {
+        mark_position(id);
+    }
 }
 
-void PositionRiskService::update_unrealized_pnl() {
-    for (auto& [symbol, position] : positions_) {
-        if (position.quantity != 0 && current_prices_.count(symbol)) {
-            double current_price = current_prices_[symbol];
-            position.unrealized_pnl = (current_price - position.average_price) * position.quantity;
-        }
+void PositionRiskService::mark_position(symbol_id_t symbol_id) {
+    auto& position = positions_[symbol_id];
+    double current_price = current_prices_[symbol_id];
+    
+    double old_unrealized = position.unrealized_pnl;
+    double old_value = position.market_value;
+    if (position.quantity != 0 && current_price > 0.0) {
+        position.unrealized_pnl = (current_price - position.average_price) * position.quantity;
     }
+    position.market_value = position.quantity * (current_price > 0.0 ? current_price : position.average_price);
+    
+    auto add = [](std::atomic<double>& total, double delta) {
+        total.store(total.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    };
+    add(total_unrealized_, position.unrealized_pnl - old_unrealized);
+    add(gross_exposure_, std::abs(position.market_value) - std::abs(old_value));
+    add(net_exposure_, position.market_value - old_value);
+    portfolio_.update(symbol_id, position.quantity, current_price > 0.0 ? current_price : position.average_price);
+    
+    if (!dirty_[symbol_id]) {
+        dirty_[symbol_id] = 1;
+        dirty_ids_.push_back(symbol_id);
+    }
+}
+
+void PositionRiskService::resync_totals() {
+    double unrealized = 0.0, realized = 0.0, gross = 0.0, net = 0.0;
+    for (symbol_id_t id : position_ids_) {
+        const auto& position = positions_[id];
+        unrealized += position.unrealized_pnl;
+        realized += position.realized_pnl;
+        gross += std::abs(position.market_value);
+        net += position.market_value;
+    }
+    total_unrealized_.store(unrealized, std::memory_order_relaxed);
+    total_realized_.store(realized, std::memory_order_relaxed);
+    gross_exposure_.store(gross, std::memory_order_relaxed);
+    net_exposure_.store(net, std::memory_order_relaxed);
+    
+    // Reloaded limits apply from here; sectors and betas are read at startup
+    portfolio_.set_limits(PortfolioLimits::from_config());
+    value_at_risk_.store(portfolio_.value_at_risk(), std::memory_order_relaxed);
+    beta_exposure_.store(portfolio_.beta_exposure(), std::memory_order_relaxed);
 }
 
-void PositionRiskService::publish_position_update(const std::string& symbol) {
-    if (!positions_.count(symbol)) return;
+void PositionRiskService::flush_position_updates(bool force) {
+    if (dirty_ids_.empty()) return;
+    
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - last_publish_time_ < publish_interval_) return;
+    last_publish_time_ = now;
+    
+    // Parts of one multipart message arrive together or not at all, and each
+    // part is still exactly one PositionUpdate for existing subscribers
+    for (size_t i = 0; i < dirty_ids_.size(); ++i) {
+        PositionUpdate update = make_position_update(dirty_ids_[i]);
+        position_publisher_->publish_part(&update, sizeof(PositionUpdate), i + 1 < dirty_ids_.size());
+    }
+    position_batches_++;
     
-    const auto& position = positions_[symbol];
+    for (symbol_id_t id : dirty_ids_) {
+        dirty_[id] = 0;
+    }
+    dirty_ids_.clear();
+}
+
+PositionUpdate PositionRiskService::make_position_update(symbol_id_t symbol_id) const {
+    const auto& position = positions_[symbol_id];
     
     PositionUpdate update{};
-    update.header = MessageFactory::create_header(MessageType::POSITION_UPDATE, 
-                                                 sizeof(PositionUpdate) - sizeof(MessageHeader));
-    std::strncpy(update.symbol, symbol.c_str(), sizeof(update.symbol) - 1);
+    update.header = MessageFactory::create_header_tsc(MessageType::POSITION_UPDATE, 
+                                                     sizeof(PositionUpdate) - sizeof(MessageHeader));
+    std::strncpy(update.symbol, position.symbol.c_str(), sizeof(update.symbol) - 1);
     update.position = position.quantity;
     update.average_price = position.average_price;
     update.unrealized_pnl = position.unrealized_pnl;
     update.realized_pnl = position.realized_pnl;
-    update.market_value = current_prices_.count(symbol) ? 
-                         current_prices_[symbol] * position.quantity : 0.0;
-    
-    try {
-        zmq::message_t message(sizeof(PositionUpdate));
-        std::memcpy(message.data(), &update, sizeof(PositionUpdate));
-        position_publisher_->send(message, zmq::send_flags::dontwait);
-    } catch (const zmq::error_t& e) {
-        if (e.num() != EAGAIN) {
-            logger_.error("Failed to publish position update: " + std::string(e.what()));
+    update.market_value = current_prices_[symbol_id] > 0.0 ? position.market_value : 0.0;
+    return update;
+}
+
+void PositionRiskService::publish_risk_limits() {
+    RiskLimits limits = RiskLimits::from_config();
+    
+    RiskLimitUpdate update{};
+    update.header = MessageFactory::create_header(MessageType::RISK_LIMIT_UPDATE,
+                                                 sizeof(RiskLimitUpdate) - sizeof(MessageHeader));
+    update.max_order_quantity = limits.max_order_quantity;
+    update.max_order_notional = limits.max_order_notional;
+    update.max_position = limits.max_position;
+    update.price_band_ratio = limits.price_band_ratio;
+    update.max_orders_per_second = limits.max_orders_per_second;
+    
+    // Defaults first, with the kill switch once the session loss limit is hit
+    double session_pnl = current_daily_pnl_ + total_unrealized_.load(std::memory_order_relaxed) +
+                         total_realized_.load(std::memory_order_relaxed);
+    update.symbol_id = INVALID_SYMBOL_ID;
+    bool breached = portfolio_.breached();
+    if (breached != portfolio_breached_) {
+        portfolio_breached_ = breached;
+        if (breached) {
+            logger_.warning("Portfolio limit exceeded (gross " + std::to_string(portfolio_.gross_exposure()) +
+                            ", net " + std::to_string(portfolio_.net_exposure()) + ", VaR " +
+                            std::to_string(portfolio_.value_at_risk()) + "); halting the gateway");
+        } else {
+            logger_.info("Portfolio back within limits");
         }
     }
+    update.halted = session_pnl < -max_daily_loss_ || breached ? 1 : 0;
+    send_risk_limit_update(update);
+    
+    // Then a fat-finger reference for every symbol with a price
+    update.halted = 0;
+    size_t symbol_count = std::min(SymbolTable::instance().size(), current_prices_.size());
+    for (symbol_id_t id = 0; id < symbol_count; ++id) {
+        if (current_prices_[id] <= 0.0) continue;
+        std::memset(update.symbol, 0, sizeof(update.symbol));
+        std::strncpy(update.symbol, SymbolTable::instance().name(id), sizeof(update.symbol) - 1);
+        update.symbol_id = id;
+        update.reference_price = to_fixed_price(current_prices_[id]);
+        send_risk_limit_update(update);
+    }
+}
+
+void PositionRiskService::send_risk_limit_update(const RiskLimitUpdate& update) {
+    position_publisher_->publish(&update, sizeof(RiskLimitUpdate));
 }
 
 bool PositionRiskService::check_risk_limits(const TradingSignal& signal) {
@@ -242,17 +555,16 @@ bool PositionRiskService::check_risk_limits(const TradingSignal& signal) {
     risk_checks_++;
     HFT_COMPONENT_COUNTER(hft::metrics::RISK_CHECKS_TOTAL);
     
-    // Check position size limits
-    std::string symbol(signal.symbol);
-    if (positions_.count(symbol)) {
-        const auto& position = positions_[symbol];
-        double proposed_value = std::abs(position.quantity + static_cast<int32_t>(signal.quantity)) * signal.price;
-        
-        if (proposed_value > max_position_value_) {
-            risk_violations_++;
-            HFT_COMPONENT_COUNTER(hft::metrics::RISK_VIOLATIONS_TOTAL);
-            return false;
-        }
+    // Position, exposure, sector and VaR limits
+    CandidateOrder order;
+    order.symbol_id = SymbolTable::instance().resolve(signal.symbol_id, signal.symbol);
+    order.quantity = static_cast<int32_t>(signal.quantity) * (signal.action == SignalAction::SELL ? -1 : 1);
+    order.price = to_double_price(signal.price);
+    PortfolioCheck result = portfolio_.check(order);
+    if (result != PortfolioCheck::OK && result != PortfolioCheck::UNKNOWN_SYMBOL) {
+        risk_violations_++;
+        HFT_COMPONENT_COUNTER(hft::metrics::RISK_VIOLATIONS_TOTAL);
+        return false;
     }
     
     // Check daily P&L limits
@@ -266,39 +578,29 @@ bool PositionRiskService::check_risk_limits(const TradingSignal& signal) {
 }
 
 void PositionRiskService::update_metrics() {
-    double total_unrealized = 0.0;
-    double total_realized = 0.0;
-    double gross_exposure = 0.0;
-    double net_exposure = 0.0;
-    
-    for (const auto& [symbol, position] : positions_) {
-        total_unrealized += position.unrealized_pnl;
-        total_realized += position.realized_pnl;
-        
-        // Calculate exposure (using current prices if available)
-        double market_value = 0.0;
-        if (current_prices_.count(symbol)) {
-            market_value = position.quantity * current_prices_[symbol];
-        } else {
-            market_value = position.quantity * position.average_price;
-        }
-        
-        gross_exposure += std::abs(market_value);
-        net_exposure += market_value;
-    }
+    // Running sums from mark_position(); no walk over the positions
+    double total_unrealized = total_unrealized_.load(std::memory_order_relaxed);
+    double total_realized = total_realized_.load(std::memory_order_relaxed);
+    double gross_exposure = gross_exposure_.load(std::memory_order_relaxed);
+    double net_exposure = net_exposure_.load(std::memory_order_relaxed);
+    size_t open_positions = open_position_count_.load(std::memory_order_acquire);
     
     // Update metrics
-    HFT_GAUGE_VALUE(hft::metrics::POSITIONS_OPEN_COUNT, positions_.size());
+    HFT_GAUGE_VALUE(hft::metrics::POSITIONS_OPEN_COUNT, open_positions);
     HFT_GAUGE_VALUE(hft::metrics::PNL_UNREALIZED_USD, static_cast<double>(total_unrealized));
     HFT_GAUGE_VALUE(hft::metrics::PNL_REALIZED_USD, static_cast<double>(total_realized));
     HFT_GAUGE_VALUE(hft::metrics::PNL_TOTAL_USD, static_cast<double>(total_unrealized + total_realized));
     HFT_GAUGE_VALUE(hft::metrics::GROSS_EXPOSURE_USD, static_cast<uint64_t>(gross_exposure));
     HFT_GAUGE_VALUE(hft::metrics::NET_EXPOSURE_USD, static_cast<uint64_t>(net_exposure));
-    
-    // Log each symbol's details
-    for (const auto& [symbol, position] : positions_) {
-        double current_price = current_prices_.count(symbol) ? current_prices_[symbol] : 0.0;
-        logger_.info("Symbol: " + symbol + 
+    HFT_GAUGE_VALUE(hft::metrics::VALUE_AT_RISK_USD, value_at_risk_.load(std::memory_order_relaxed));
+    HFT_GAUGE_VALUE(hft::metrics::BETA_EXPOSURE_USD, beta_exposure_.load(std::memory_order_relaxed));
+    
+    // Log each symbol's details (entries below the published count are fully set up)
+    for (size_t i = 0; i < open_positions; ++i) {
+        symbol_id_t id = position_ids_[i];
+        const auto& position = positions_[id];
+        double current_price = current_prices_[id];
+        logger_.info("Symbol: " + position.symbol + 
                     " | Current Price: " + std::to_string(current_price) +
                     " | Our Avg Price: " + std::to_string(position.average_price) +
                     " | Our Volume: " + std::to_string(position.quantity) +
@@ -306,20 +608,27 @@ void PositionRiskService::update_metrics() {
     }
     
     // Log each metric update
-    logger_.info("POSITIONS_OPEN_COUNT: " + std::to_string(positions_.size()));
+    logger_.info("POSITIONS_OPEN_COUNT: " + std::to_string(open_positions));
+    logger_.info("POSITION_UPDATE_BATCHES: " + std::to_string(position_batches_.load()));
     logger_.info("PNL_UNREALIZED_USD: " + std::to_string(static_cast<double>(total_unrealized)));
     logger_.info("PNL_REALIZED_USD: " + std::to_string(static_cast<double>(total_realized)));
     logger_.info("PNL_TOTAL_USD: " + std::to_string(static_cast<double>(total_unrealized + total_realized)));
     logger_.info("GROSS_EXPOSURE_USD: " + std::to_string(static_cast<uint64_t>(gross_exposure)));
     logger_.info("NET_EXPOSURE_USD: " + std::to_string(static_cast<uint64_t>(net_exposure)));
+    logger_.info("VALUE_AT_RISK_USD: " + std::to_string(value_at_risk_.load(std::memory_order_relaxed)));
 }
 
 void PositionRiskService::metrics_update_loop() {
+    if (!ThreadPlan::instance().pin_current_thread("metrics_update")) {
+        logger_.warning("Failed to pin metrics_update thread to its planned CPU");
+    }
     logger_.info("Metrics update loop started");
     
     while (running_.load()) {
         try {
-            update_metrics();
+            if (warm_.load(std::memory_order_acquire)) {
+                update_metrics();
+            }
             
             // Update metrics at configurable interval
             std::this_thread::sleep_for(std::chrono::seconds(StaticConfig::get_metrics_update_interval_seconds()));
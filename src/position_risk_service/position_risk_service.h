@@ -3,12 +3,19 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/config_reloader.h"
+#include "../common/event_journal.h"
+#include "../common/message_capture.h"
 #include "../common/metrics_publisher.h"
-#include <zmq.hpp>
+#include "../common/pre_trade_risk.h"
+#include "../common/zmq_transport.h"
+#include "portfolio_risk.h"
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <memory_resource>
 #include <unordered_map>
+#include <vector>
 
 namespace hft {
 
@@ -18,8 +25,9 @@ struct Position {
     double average_price;
     double unrealized_pnl;
     double realized_pnl;
+    double market_value;       // As last marked: current price, else average price
     
-    Position() : quantity(0), average_price(0.0), unrealized_pnl(0.0), realized_pnl(0.0) {}
+    Position() : quantity(0), average_price(0.0), unrealized_pnl(0.0), realized_pnl(0.0), market_value(0.0) {}
 };
 
 class PositionRiskService {
@@ -31,26 +39,55 @@ public:
     void start();
     void stop();
     bool is_running() const;
+    
+    // After initialize(), instead of start(): feeds a capture of this
+    // service's input through the same handlers on the calling thread, as
+    // fast as possible, in the order it was received
+    ReplayReport replay_capture(const CaptureReader& capture);
 
 private:
     
-    // ZeroMQ sockets
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> execution_subscriber_;
-    std::unique_ptr<zmq::socket_t> market_data_subscriber_;
-    std::unique_ptr<zmq::socket_t> position_publisher_;
+    // Transports on the process ZeroMQ context
+    std::unique_ptr<IMessageSubscriber> execution_subscriber_;
+    std::unique_ptr<IMessageSubscriber> market_data_subscriber_;
+    std::unique_ptr<IMessagePublisher> position_publisher_;
+    std::unique_ptr<MessageCapture> capture_;   // Tap on both subscribers (capture.enabled)
     
     // Threading
     std::atomic<bool> running_;
     std::unique_ptr<std::thread> processing_thread_;
     std::unique_ptr<std::thread> metrics_thread_;
+    ConfigReloader config_reloader_;     // Reloaded limits go out with the next limits push
+    
+    // Position tracking, indexed by symbol_id_t (preallocated to SymbolTable::MAX_SYMBOLS
+    // in the hot arena)
+    std::pmr::vector<Position> positions_;
+    std::pmr::vector<double> current_prices_;   // 0.0 = no price yet
+    std::pmr::vector<symbol_id_t> position_ids_;    // Symbols that have traded, in first-fill order
+    
+    // Portfolio sums kept current by mark_position(), one symbol at a time.
+    // Written by the processing thread only; the metrics thread reads them.
+    std::atomic<double> total_unrealized_;
+    std::atomic<double> total_realized_;
+    std::atomic<double> gross_exposure_;
+    std::atomic<double> net_exposure_;
+    std::atomic<size_t> open_position_count_;
     
-    // Position tracking
-    std::unordered_map<std::string, Position> positions_;
-    std::unordered_map<std::string, double> current_prices_;
+    // Exposure, sectors and VaR over every symbol, moved by mark_position()
+    // and recomputed in full with the limits push; the metrics thread reads
+    // the VaR and beta exposure through the atomics
+    PortfolioRisk portfolio_;
+    std::atomic<double> value_at_risk_;
+    std::atomic<double> beta_exposure_;
+    bool portfolio_breached_ = false;   // Processing thread only
+    
+    // Symbols re-marked since the last PositionUpdate batch (dirty_ is by symbol_id_t)
+    std::pmr::vector<uint8_t> dirty_;
+    std::pmr::vector<symbol_id_t> dirty_ids_;
+    std::chrono::milliseconds publish_interval_;
+    std::chrono::steady_clock::time_point last_publish_time_;
     
     // Risk limits
-    double max_position_value_;
     double max_daily_loss_;
     double current_daily_pnl_;
     
@@ -58,15 +95,41 @@ private:
     std::atomic<uint64_t> positions_updated_;
     std::atomic<uint64_t> risk_checks_;
     std::atomic<uint64_t> risk_violations_;
+    std::atomic<uint64_t> position_batches_;
+    
+    // The metrics thread holds off until the warmup positions are cleared
+    std::atomic<bool> warm_;
+    bool warming_up_ = false;   // Processing thread only
+    
+    // Fills journaled as they arrive, positions snapshotted periodically;
+    // replayed on startup (null when journal.enabled is off)
+    std::unique_ptr<EventJournal> journal_;
+    bool replaying_ = false;    // Processing thread only
+    std::chrono::steady_clock::time_point last_snapshot_time_;
     
     // Metrics
     MetricsPublisher metrics_publisher_;
     
     void process_messages();
+    // Replays synthetic fills and ticks through the handlers with nothing
+    // published, then clears the positions and totals they built up
+    void warm_up();
+    // Rebuilds positions from the snapshot and the fills journaled after it
+    void recover_from_journal();
+    void restore_position(const PositionUpdate& update);
+    void snapshot_positions();
     void handle_execution(const OrderExecution& execution);
     void handle_market_data(const MarketData& data);
-    void update_unrealized_pnl();
-    void publish_position_update(const std::string& symbol);
+    // Re-marks one symbol and moves the portfolio sums by its change
+    void mark_position(symbol_id_t symbol_id);
+    // Exact re-sum, to shed floating point drift from the running totals
+    void resync_totals();
+    // One multipart message, one PositionUpdate per part, at most every publish_interval_
+    void flush_position_updates(bool force = false);
+    PositionUpdate make_position_update(symbol_id_t symbol_id) const;
+    // Pushes limits, reference prices and the halt flag to the gateway's PreTradeRisk
+    void publish_risk_limits();
+    void send_risk_limit_update(const RiskLimitUpdate& update);
     bool check_risk_limits(const TradingSignal& signal);
     void log_statistics();
     void update_metrics();
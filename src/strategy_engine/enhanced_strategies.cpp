@@ -1,26 +1,52 @@
 #include "enhanced_strategies.h"
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 
 namespace hft {
 
+// OrderBookStrategy Implementation
+const IOrderBook* OrderBookStrategy::apply_book_update(const OrderBookUpdate& update) {
+    if (!shared_books_) {
+        own_books_.process_update(update);
+    }
+    return books().get_book(SymbolTable::instance().resolve(update.symbol_id, update.symbol));
+}
+
 // MarketMakingStrategy Implementation
 MarketMakingStrategy::MarketMakingStrategy(uint64_t strategy_id)
     : OrderBookStrategy(strategy_id, "MarketMaking") {
 }
 
+const std::vector<ParameterField<MarketMakingStrategy::Parameters>>& MarketMakingStrategy::parameter_fields() {
+    using P = Parameters;
+    static const std::vector<ParameterField<P>> fields = {
+        {"spread_threshold", [](P& p, double v) { p.spread_threshold = v; }},
+        {"quote_size_ratio", [](P& p, double v) { p.quote_size_ratio = v; }},
+        {"max_inventory", [](P& p, double v) { p.max_inventory = v; }},
+        {"inventory_skew_factor", [](P& p, double v) { p.inventory_skew_factor = v; }},
+        {"min_quote_size", [](P& p, double v) { p.min_quote_size = to_count(v); }},
+        {"max_quote_size", [](P& p, double v) { p.max_quote_size = to_count(v); }},
+        {"microprice_fair_value", [](P& p, double v) { p.microprice_fair_value = v != 0.0; }},
+    };
+    return fields;
+}
+
+bool MarketMakingStrategy::validate_parameters(const Parameters& params, std::string& error) {
+    if (params.spread_threshold < 0.0 || params.quote_size_ratio <= 0.0 || params.max_inventory <= 0.0) {
+        error = "spread_threshold must be >= 0, quote_size_ratio and max_inventory > 0";
+        return false;
+    }
+    if (params.min_quote_size == 0 || params.min_quote_size > params.max_quote_size) {
+        error = "need 0 < min_quote_size <= max_quote_size";
+        return false;
+    }
+    return true;
+}
+
 bool MarketMakingStrategy::initialize() {
     logger_.info("Initializing Market Making Strategy with ID: " + std::to_string(strategy_id_));
     
-    // Initialize with default parameters - could be loaded from config
-    params_.spread_threshold = 0.001;
-    params_.quote_size_ratio = 0.1;
-    params_.max_inventory = 1000.0;
-    params_.inventory_skew_factor = 0.5;
-    params_.min_quote_size = 100;
-    params_.max_quote_size = 500;
-    
+    // Parameters keep their defaults unless set_parameters() was called
     return true;
 }
 
@@ -39,11 +65,8 @@ void MarketMakingStrategy::on_market_data(const MarketData& data) {
 void MarketMakingStrategy::on_order_book_update(const OrderBookUpdate& update) {
     std::string symbol(update.symbol);
     
-    // Process order book update
-    book_manager_.process_update(update);
-    
     // Re-evaluate quotes if book structure changed significantly
-    const auto* book = book_manager_.get_book(symbol);
+    const auto* book = apply_book_update(update);
     if (book && should_quote(symbol, book)) {
         generate_quotes(symbol, book);
     }
@@ -59,13 +82,12 @@ void MarketMakingStrategy::on_execution(const OrderExecution& execution) {
         // Update position (simplified - need to track order direction)
         positions_[symbol] += execution.fill_quantity;  // Assuming all fills are buys for now
         
-        logger_.info("Position updated for " + symbol + ": " + 
-                    std::to_string(positions_[symbol]));
+        HFT_LOGF(logger_, LogLevel::INFO, "Position updated for {}: {}", symbol, positions_[symbol]);
     }
 }
 
 void MarketMakingStrategy::evaluate_market_making_opportunity(const std::string& symbol) {
-    const auto* book = book_manager_.get_book(symbol);
+    const auto* book = books().get_book(symbol);
     if (!book || !book->is_valid()) return;
     
     if (should_quote(symbol, book)) {
@@ -73,8 +95,8 @@ void MarketMakingStrategy::evaluate_market_making_opportunity(const std::string&
     }
 }
 
-void MarketMakingStrategy::generate_quotes(const std::string& symbol, const OrderBook* book) {
-    auto now = std::chrono::steady_clock::now();
+void MarketMakingStrategy::generate_quotes(const std::string& symbol, const IOrderBook* book) {
+    auto now = current_time();
     
     // Rate limiting
     auto it = last_quote_time_.find(symbol);
@@ -82,17 +104,18 @@ void MarketMakingStrategy::generate_quotes(const std::string& symbol, const Orde
         return;
     }
     
+    const BookFeatures& features = book->features();
     double fair_value = calculate_fair_value(book);
     double skew = calculate_quote_skew(symbol);
-    double spread = book->get_spread();
+    double spread = features.spread;
     
     // Calculate quote prices with inventory skew
     double bid_price = fair_value - (spread / 4.0) - skew;
     double ask_price = fair_value + (spread / 4.0) - skew;  // Negative skew moves ask down when long
     
     // Calculate quote sizes based on best level
-    uint32_t best_bid_size = book->get_bid_size_at_level(0);
-    uint32_t best_ask_size = book->get_ask_size_at_level(0);
+    uint32_t best_bid_size = static_cast<uint32_t>(features.bid_size[0]);
+    uint32_t best_ask_size = static_cast<uint32_t>(features.ask_size[0]);
     
     uint32_t bid_size = std::max(params_.min_quote_size,
                                 std::min(params_.max_quote_size,
@@ -101,26 +124,27 @@ void MarketMakingStrategy::generate_quotes(const std::string& symbol, const Orde
                                 std::min(params_.max_quote_size,
                                         static_cast<uint32_t>(best_ask_size * params_.quote_size_ratio)));
     
-    // Generate bid signal
-    TradingSignal bid_signal = MessageFactory::create_trading_signal(
-        symbol, SignalAction::BUY, OrderType::LIMIT, bid_price, bid_size, strategy_id_, 0.8
+    // Move the bid and ask quotes (placed on first use)
+    symbol_id_t symbol_id = SymbolTable::instance().intern(symbol);
+    TradingSignal bid_signal = MessageFactory::create_quote_signal(
+        symbol_id, SignalAction::BUY, bid_price, bid_size, strategy_id_, 0.8
     );
-    
-    // Generate ask signal  
-    TradingSignal ask_signal = MessageFactory::create_trading_signal(
-        symbol, SignalAction::SELL, OrderType::LIMIT, ask_price, ask_size, strategy_id_, 0.8
+    TradingSignal ask_signal = MessageFactory::create_quote_signal(
+        symbol_id, SignalAction::SELL, ask_price, ask_size, strategy_id_, 0.8
     );
     
-    logger_.info("Generated MM quotes for " + symbol + 
-                ": BID " + std::to_string(bid_size) + "@" + std::to_string(bid_price) +
-                ", ASK " + std::to_string(ask_size) + "@" + std::to_string(ask_price));
+    emit_signal(bid_signal);
+    emit_signal(ask_signal);
+    
+    HFT_LOGF(logger_, LogLevel::INFO, "Generated MM quotes for {}: BID {}@{}, ASK {}@{}",
+             symbol, bid_size, bid_price, ask_size, ask_price);
     
     last_quote_time_[symbol] = now;
 }
 
-double MarketMakingStrategy::calculate_fair_value(const OrderBook* book) const {
-    // Use mid-price as fair value (could be enhanced with VWAP, etc.)
-    return book->get_mid_price();
+double MarketMakingStrategy::calculate_fair_value(const IOrderBook* book) const {
+    const BookFeatures& features = book->features();
+    return params_.microprice_fair_value ? features.microprice : features.mid;
 }
 
 double MarketMakingStrategy::calculate_quote_skew(const std::string& symbol) const {
@@ -135,10 +159,11 @@ double MarketMakingStrategy::calculate_quote_skew(const std::string& symbol) con
     return -(position / max_pos) * params_.inventory_skew_factor;
 }
 
-bool MarketMakingStrategy::should_quote(const std::string& symbol, const OrderBook* book) const {
+bool MarketMakingStrategy::should_quote(const std::string& symbol, const IOrderBook* book) const {
     // Check minimum spread requirement
-    double spread = book->get_spread();
-    double mid_price = book->get_mid_price();
+    const BookFeatures& features = book->features();
+    double spread = features.spread;
+    double mid_price = features.mid;
     
     if (mid_price <= 0.0 || spread <= 0.0) return false;
     
@@ -163,20 +188,39 @@ StatArbStrategy::StatArbStrategy(uint64_t strategy_id)
     : OrderBookStrategy(strategy_id, "StatArb") {
 }
 
+const std::vector<ParameterField<StatArbStrategy::Parameters>>& StatArbStrategy::parameter_fields() {
+    using P = Parameters;
+    static const std::vector<ParameterField<P>> fields = {
+        {"imbalance_threshold", [](P& p, double v) { p.imbalance_threshold = v; }},
+        {"price_threshold", [](P& p, double v) { p.price_threshold = v; }},
+        {"lookback_periods", [](P& p, double v) { p.lookback_periods = to_count(v); }, false},
+        {"min_signal_interval_ms", [](P& p, double v) { p.min_signal_interval_ms = to_count(v); }},
+        {"signal_size", [](P& p, double v) { p.signal_size = to_count(v); }},
+        {"imbalance_levels", [](P& p, double v) { p.imbalance_levels = to_count(v); }},
+    };
+    return fields;
+}
+
+bool StatArbStrategy::validate_parameters(const Parameters& params, std::string& error) {
+    if (params.lookback_periods == 0 || params.signal_size == 0 || params.imbalance_levels == 0) {
+        error = "lookback_periods, signal_size and imbalance_levels must be > 0";
+        return false;
+    }
+    return true;
+}
+
 bool StatArbStrategy::initialize() {
     logger_.info("Initializing Statistical Arbitrage Strategy with ID: " + std::to_string(strategy_id_));
     return true;
 }
 
-void StatArbStrategy::on_market_data(const MarketData& data) {
+void StatArbStrategy::on_market_data([[maybe_unused]] const MarketData& data) {
     // Placeholder - basic market data handling
 }
 
 void StatArbStrategy::on_order_book_update(const OrderBookUpdate& update) {
     std::string symbol(update.symbol);
-    book_manager_.process_update(update);
-    
-    const auto* book = book_manager_.get_book(symbol);
+    const auto* book = apply_book_update(update);
     if (book && book->is_valid()) {
         update_market_state(symbol, book);
         evaluate_stat_arb_signal(symbol);
@@ -185,40 +229,29 @@ void StatArbStrategy::on_order_book_update(const OrderBookUpdate& update) {
 
 void StatArbStrategy::on_execution(const OrderExecution& execution) {
     std::string symbol(execution.symbol);
-    logger_.info("StatArb execution for " + symbol + ": " + 
-                std::to_string(execution.fill_quantity) + " @ " +
-                std::to_string(execution.fill_price));
+    HFT_LOGF(logger_, LogLevel::INFO, "StatArb execution for {}: {} @ {}",
+             symbol, execution.fill_quantity, to_double_price(execution.fill_price));
 }
 
-void StatArbStrategy::update_market_state(const std::string& symbol, const OrderBook* book) {
-    auto& state = market_states_[symbol];
-    
-    double mid_price = book->get_mid_price();
-    double imbalance = book->get_bid_ask_imbalance();
-    
-    // Maintain rolling window
-    state.mid_prices.push_back(mid_price);
-    state.imbalances.push_back(imbalance);
-    
-    if (state.mid_prices.size() > params_.lookback_periods) {
-        state.mid_prices.erase(state.mid_prices.begin());
-        state.imbalances.erase(state.imbalances.begin());
+void StatArbStrategy::update_market_state(const std::string& symbol, const IOrderBook* book) {
+    auto [it, inserted] = market_states_.try_emplace(symbol);
+    auto& state = it->second;
+    if (inserted) {
+        state.mid_prices.reset(params_.lookback_periods);
+        state.imbalances.reset(params_.lookback_periods);
     }
     
-    // Update means
-    if (!state.mid_prices.empty()) {
-        state.mean_price = std::accumulate(state.mid_prices.begin(), 
-                                         state.mid_prices.end(), 0.0) / state.mid_prices.size();
-        state.mean_imbalance = std::accumulate(state.imbalances.begin(),
-                                             state.imbalances.end(), 0.0) / state.imbalances.size();
-    }
+    // Rolling windows evict the oldest value and keep their stats in O(1)
+    const BookFeatures& features = book->features();
+    state.mid_prices.push(features.mid);
+    state.imbalances.push(features.depth_imbalance(params_.imbalance_levels));
 }
 
 void StatArbStrategy::evaluate_stat_arb_signal(const std::string& symbol) {
     if (!should_generate_signal(symbol)) return;
     
     const auto& state = market_states_[symbol];
-    if (state.mid_prices.size() < params_.lookback_periods) return;
+    if (!state.mid_prices.full()) return;
     
     double current_price = state.mid_prices.back();
     double current_imbalance = state.imbalances.back();
@@ -236,31 +269,24 @@ void StatArbStrategy::evaluate_stat_arb_signal(const std::string& symbol) {
             symbol, action, OrderType::MARKET, 0.0, params_.signal_size, 
             strategy_id_, std::min(std::abs(price_z) + std::abs(imbalance_z), 1.0)
         );
+        emit_signal(signal);
         
-        logger_.info("Generated StatArb " + std::string(action == SignalAction::BUY ? "BUY" : "SELL") +
-                    " signal for " + symbol + " (price_z=" + std::to_string(price_z) + 
-                    ", imb_z=" + std::to_string(imbalance_z) + ")");
+        HFT_LOGF(logger_, LogLevel::INFO, "Generated StatArb {} signal for {} (price_z={}, imb_z={})",
+                 action == SignalAction::BUY ? "BUY" : "SELL", symbol, price_z, imbalance_z);
         
-        last_signal_time_[symbol] = std::chrono::steady_clock::now();
+        last_signal_time_[symbol] = current_time();
     }
 }
 
-double StatArbStrategy::calculate_z_score(const std::vector<double>& data, double current_value) const {
-    if (data.size() < 2) return 0.0;
-    
-    double mean = std::accumulate(data.begin(), data.end(), 0.0) / data.size();
-    
-    double sq_sum = std::inner_product(data.begin(), data.end(), data.begin(), 0.0);
-    double stdev = std::sqrt(sq_sum / data.size() - mean * mean);
-    
-    return (stdev > 0.0) ? (current_value - mean) / stdev : 0.0;
+double StatArbStrategy::calculate_z_score(const RollingWindow& data, double current_value) const {
+    return data.z_score(current_value);
 }
 
 bool StatArbStrategy::should_generate_signal(const std::string& symbol) const {
     auto it = last_signal_time_.find(symbol);
     if (it == last_signal_time_.end()) return true;
     
-    auto now = std::chrono::steady_clock::now();
+    auto now = current_time();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second);
     
     return elapsed.count() >= static_cast<int>(params_.min_signal_interval_ms);
@@ -271,51 +297,72 @@ EnhancedMomentumStrategy::EnhancedMomentumStrategy(uint64_t strategy_id)
     : OrderBookStrategy(strategy_id, "EnhancedMomentum") {
 }
 
+const std::vector<ParameterField<EnhancedMomentumStrategy::Parameters>>& EnhancedMomentumStrategy::parameter_fields() {
+    using P = Parameters;
+    static const std::vector<ParameterField<P>> fields = {
+        {"momentum_threshold", [](P& p, double v) { p.momentum_threshold = v; }},
+        {"flow_threshold", [](P& p, double v) { p.flow_threshold = v; }},
+        {"momentum_window", [](P& p, double v) { p.momentum_window = to_count(v); }, false},
+        {"min_signal_interval_ms", [](P& p, double v) { p.min_signal_interval_ms = to_count(v); }},
+        {"base_signal_size", [](P& p, double v) { p.base_signal_size = to_count(v); }},
+        {"max_signal_multiplier", [](P& p, double v) { p.max_signal_multiplier = v; }},
+        {"imbalance_levels", [](P& p, double v) { p.imbalance_levels = to_count(v); }},
+    };
+    return fields;
+}
+
+bool EnhancedMomentumStrategy::validate_parameters(const Parameters& params, std::string& error) {
+    if (params.momentum_window == 0 || params.base_signal_size == 0 || params.imbalance_levels == 0) {
+        error = "momentum_window, base_signal_size and imbalance_levels must be > 0";
+        return false;
+    }
+    if (params.max_signal_multiplier < 1.0) {
+        error = "max_signal_multiplier must be >= 1";
+        return false;
+    }
+    return true;
+}
+
 bool EnhancedMomentumStrategy::initialize() {
     logger_.info("Initializing Enhanced Momentum Strategy with ID: " + std::to_string(strategy_id_));
     return true;
 }
 
-void EnhancedMomentumStrategy::on_market_data(const MarketData& data) {
+void EnhancedMomentumStrategy::on_market_data([[maybe_unused]] const MarketData& data) {
     // Basic implementation - could be enhanced
 }
 
 void EnhancedMomentumStrategy::on_order_book_update(const OrderBookUpdate& update) {
     std::string symbol(update.symbol);
-    book_manager_.process_update(update);
-    
-    const auto* book = book_manager_.get_book(symbol);
+    const auto* book = apply_book_update(update);
     if (book && book->is_valid()) {
-        double mid_price = book->get_mid_price();
-        double imbalance = book->get_bid_ask_imbalance();
+        const BookFeatures& features = book->features();
+        double mid_price = features.mid;
+        double imbalance = features.depth_imbalance(params_.imbalance_levels);
         
         update_momentum_state(symbol, mid_price, imbalance);
         evaluate_momentum_signal(symbol);
     }
 }
 
-void EnhancedMomentumStrategy::on_execution(const OrderExecution& execution) {
+void EnhancedMomentumStrategy::on_execution([[maybe_unused]] const OrderExecution& execution) {
     // Handle executions
 }
 
 void EnhancedMomentumStrategy::update_momentum_state(const std::string& symbol, 
                                                    double mid_price, double imbalance) {
-    auto& state = momentum_states_[symbol];
-    auto now = std::chrono::steady_clock::now();
-    
-    if (state.last_mid_price > 0.0) {
-        double price_change = (mid_price - state.last_mid_price) / state.last_mid_price;
-        state.price_changes.push_back(price_change);
-        
-        if (state.price_changes.size() > params_.momentum_window) {
-            state.price_changes.erase(state.price_changes.begin());
-        }
+    auto [it, inserted] = momentum_states_.try_emplace(symbol);
+    auto& state = it->second;
+    if (inserted) {
+        state.price_changes.reset(params_.momentum_window);
+        state.flow_imbalances.reset(params_.momentum_window);
     }
+    auto now = current_time();
     
-    state.flow_imbalances.push_back(imbalance);
-    if (state.flow_imbalances.size() > params_.momentum_window) {
-        state.flow_imbalances.erase(state.flow_imbalances.begin());
+    if (state.last_mid_price > 0.0) {
+        state.price_changes.push((mid_price - state.last_mid_price) / state.last_mid_price);
     }
+    state.flow_imbalances.push(imbalance);
     
     state.last_mid_price = mid_price;
     state.last_update = now;
@@ -325,13 +372,11 @@ void EnhancedMomentumStrategy::evaluate_momentum_signal(const std::string& symbo
     const auto& state = momentum_states_.find(symbol);
     if (state == momentum_states_.end()) return;
     
-    if (state->second.price_changes.size() < params_.momentum_window) return;
+    if (!state->second.price_changes.full()) return;
     
     // Calculate momentum and flow scores
     double momentum_score = calculate_momentum_score(state->second.price_changes);
-    double avg_flow = std::accumulate(state->second.flow_imbalances.begin(),
-                                    state->second.flow_imbalances.end(), 0.0) / 
-                     state->second.flow_imbalances.size();
+    double avg_flow = state->second.flow_imbalances.mean();
     
     // Generate signal if thresholds are met
     if (std::abs(momentum_score) > params_.momentum_threshold &&
@@ -345,21 +390,18 @@ void EnhancedMomentumStrategy::evaluate_momentum_signal(const std::string& symbo
         TradingSignal signal = MessageFactory::create_trading_signal(
             symbol, action, OrderType::MARKET, 0.0, signal_size, strategy_id_, confidence
         );
+        emit_signal(signal);
         
-        logger_.info("Generated Enhanced Momentum " + 
-                    std::string(action == SignalAction::BUY ? "BUY" : "SELL") +
-                    " signal for " + symbol + " (momentum=" + std::to_string(momentum_score) + 
-                    ", flow=" + std::to_string(avg_flow) + ", size=" + std::to_string(signal_size) + ")");
+        HFT_LOGF(logger_, LogLevel::INFO, "Generated Enhanced Momentum {} signal for {} (momentum={}, flow={}, size={})",
+                 action == SignalAction::BUY ? "BUY" : "SELL", symbol, momentum_score, avg_flow, signal_size);
         
-        last_signal_time_[symbol] = std::chrono::steady_clock::now();
+        last_signal_time_[symbol] = current_time();
     }
 }
 
-double EnhancedMomentumStrategy::calculate_momentum_score(const std::vector<double>& changes) const {
-    if (changes.empty()) return 0.0;
-    
+double EnhancedMomentumStrategy::calculate_momentum_score(const RollingWindow& changes) const {
     // Simple momentum: sum of recent price changes
-    return std::accumulate(changes.begin(), changes.end(), 0.0);
+    return changes.sum();
 }
 
 double EnhancedMomentumStrategy::calculate_signal_confidence(double momentum, double flow) const {
@@ -398,4 +440,15 @@ std::string StrategyFactory::strategy_type_to_string(StrategyType type) {
     }
 }
 
+bool StrategyFactory::strategy_type_from_string(const std::string& name, StrategyType& type) {
+    for (StrategyType candidate : {StrategyType::MARKET_MAKING, StrategyType::STAT_ARB,
+                                   StrategyType::ENHANCED_MOMENTUM}) {
+        if (name == strategy_type_to_string(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace hft
\ No newline at end of file
@@ -2,18 +2,27 @@
 
 #include "../common/message_types.h"
 #include "../common/order_book.h"
+#include "../common/book_features.h"
 #include "../common/logging.h"
+#include "../common/static_config.h"
+#include "../common/simulation_clock.h"
+#include "../common/rolling_window.h"
+#include "strategy_parameters.h"
 #include <unordered_map>
 #include <memory>
 #include <chrono>
+#include <functional>
 
 namespace hft {
 
 // Enhanced strategy base class with order book support
 class OrderBookStrategy {
 public:
+    using SignalCallback = std::function<void(const TradingSignal&)>;
+
     explicit OrderBookStrategy(uint64_t strategy_id, const std::string& name)
-        : strategy_id_(strategy_id), strategy_name_(name), logger_(name) {}
+        : strategy_id_(strategy_id), strategy_name_(name),
+          logger_(name, StaticConfig::get_logger_endpoint()) {}
     
     virtual ~OrderBookStrategy() = default;
 
@@ -25,15 +34,65 @@ public:
     
     uint64_t get_strategy_id() const { return strategy_id_; }
     const std::string& get_name() const { return strategy_name_; }
+    
+    // Where generated signals go (engine publisher or backtest event loop)
+    void set_signal_callback(SignalCallback callback) { signal_callback_ = std::move(callback); }
+    
+    // Logical clock for backtests; rate limits use wall time when unset
+    void set_clock(const SimulationClock* clock) { clock_ = clock; }
+    
+    // Per-signal INFO logs dominate tight replay loops; benchmarks raise this
+    void set_log_level(LogLevel level) { logger_.set_log_level(level); }
+    
+    // Books owned by the engine and shared by all its strategies: the engine
+    // applies each update once, before dispatching it, and strategies only
+    // read them (one book and one BookFeatures cache per symbol). Unset, the
+    // strategy maintains its own books.
+    void set_shared_books(const OrderBookManager* books) { shared_books_ = books; }
+    bool uses_shared_books() const { return shared_books_ != nullptr; }
+    
+    // Runtime retuning (ControlAPI). One control thread stages updates while
+    // the strategy runs; the thread driving the strategy applies the newest
+    // staged set between ticks, without locks. set_parameters() is for
+    // configuring a strategy before it runs. A strategy without tunable
+    // parameters rejects every update.
+    virtual bool stage_parameters(const ParameterAssignments& assignments, std::string& error) {
+        (void)assignments;
+        error = strategy_name_ + " has no runtime parameters";
+        return false;
+    }
+    // True if a staged set was applied
+    virtual bool apply_staged_parameters() { return false; }
 
 protected:
     uint64_t strategy_id_;
     std::string strategy_name_;
     Logger logger_;
+    
+    void emit_signal(const TradingSignal& signal) {
+        if (signal_callback_) signal_callback_(signal);
+    }
+    
+    std::chrono::steady_clock::time_point current_time() const {
+        return clock_ ? clock_->steady_now() : std::chrono::steady_clock::now();
+    }
+    
+    // Read-only view of the books, shared or own
+    const OrderBookManager& books() const { return shared_books_ ? *shared_books_ : own_books_; }
+    
+    // Applies the update to the strategy's own books (the engine already has
+    // when they are shared) and returns the symbol's book, nullptr if none
+    const IOrderBook* apply_book_update(const OrderBookUpdate& update);
+
+private:
+    SignalCallback signal_callback_;
+    const SimulationClock* clock_ = nullptr;
+    OrderBookManager own_books_;
+    const OrderBookManager* shared_books_ = nullptr;
 };
 
 // Market making strategy using order book depth
-class MarketMakingStrategy : public OrderBookStrategy {
+class MarketMakingStrategy final : public OrderBookStrategy {
 public:
     explicit MarketMakingStrategy(uint64_t strategy_id);
     ~MarketMakingStrategy() override = default;
@@ -51,26 +110,40 @@ public:
         double inventory_skew_factor = 0.5; // How much to skew quotes based on inventory
         uint32_t min_quote_size = 100;      // Minimum quote size
         uint32_t max_quote_size = 500;      // Maximum quote size
+        bool microprice_fair_value = false; // Quote around the top-level microprice instead of mid
     };
 
+    void set_parameters(const Parameters& params) { params_ = params; tuning_.reset(params); }
+    const Parameters& get_parameters() const { return params_; }
+    
+    bool stage_parameters(const ParameterAssignments& assignments, std::string& error) override {
+        return tuning_.stage(assignments, error);
+    }
+    bool apply_staged_parameters() override { return tuning_.apply(params_); }
+    
+    static const std::vector<ParameterField<Parameters>>& parameter_fields();
+    static bool validate_parameters(const Parameters& params, std::string& error);
+
 private:
     Parameters params_;
-    OrderBookManager book_manager_;
+    TunableParameters<Parameters> tuning_{parameter_fields(), &validate_parameters};
     std::unordered_map<std::string, double> positions_;  // Current positions by symbol
     std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_quote_time_;
     
-    static constexpr auto MIN_QUOTE_INTERVAL = std::chrono::milliseconds(100);
+    // Quotes are MODIFYs: the gateway replaces the working quote in place and
+    // coalesces any that outrun the venue's acks or rate limit
+    static constexpr auto MIN_QUOTE_INTERVAL = std::chrono::milliseconds(25);
     
     // Strategy logic
     void evaluate_market_making_opportunity(const std::string& symbol);
-    void generate_quotes(const std::string& symbol, const OrderBook* book);
-    double calculate_fair_value(const OrderBook* book) const;
+    void generate_quotes(const std::string& symbol, const IOrderBook* book);
+    double calculate_fair_value(const IOrderBook* book) const;
     double calculate_quote_skew(const std::string& symbol) const;
-    bool should_quote(const std::string& symbol, const OrderBook* book) const;
+    bool should_quote(const std::string& symbol, const IOrderBook* book) const;
 };
 
 // Statistical arbitrage strategy using order book imbalance
-class StatArbStrategy : public OrderBookStrategy {
+class StatArbStrategy final : public OrderBookStrategy {
 public:
     explicit StatArbStrategy(uint64_t strategy_id);
     ~StatArbStrategy() override = default;
@@ -86,32 +159,42 @@ public:
         uint32_t lookback_periods = 20;     // Periods for mean reversion
         uint32_t min_signal_interval_ms = 500;  // Minimum time between signals
         uint32_t signal_size = 200;         // Signal size in shares
+        uint32_t imbalance_levels = 1;      // Book levels per side in the imbalance signal
     };
 
+    void set_parameters(const Parameters& params) { params_ = params; tuning_.reset(params); }
+    const Parameters& get_parameters() const { return params_; }
+    
+    bool stage_parameters(const ParameterAssignments& assignments, std::string& error) override {
+        return tuning_.stage(assignments, error);
+    }
+    bool apply_staged_parameters() override { return tuning_.apply(params_); }
+    
+    static const std::vector<ParameterField<Parameters>>& parameter_fields();
+    static bool validate_parameters(const Parameters& params, std::string& error);
+
 private:
     Parameters params_;
-    OrderBookManager book_manager_;
+    TunableParameters<Parameters> tuning_{parameter_fields(), &validate_parameters};
     
-    // Market data history for mean reversion
+    // Market data history for mean reversion (lookback_periods long)
     struct MarketState {
-        std::vector<double> mid_prices;
-        std::vector<double> imbalances;
-        double mean_price = 0.0;
-        double mean_imbalance = 0.0;
+        RollingWindow mid_prices;
+        RollingWindow imbalances;
     };
     
     std::unordered_map<std::string, MarketState> market_states_;
     std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_signal_time_;
     
     // Strategy logic
-    void update_market_state(const std::string& symbol, const OrderBook* book);
+    void update_market_state(const std::string& symbol, const IOrderBook* book);
     void evaluate_stat_arb_signal(const std::string& symbol);
-    double calculate_z_score(const std::vector<double>& data, double current_value) const;
+    double calculate_z_score(const RollingWindow& data, double current_value) const;
     bool should_generate_signal(const std::string& symbol) const;
 };
 
 // Momentum strategy enhanced with order book flow
-class EnhancedMomentumStrategy : public OrderBookStrategy {
+class EnhancedMomentumStrategy final : public OrderBookStrategy {
 public:
     explicit EnhancedMomentumStrategy(uint64_t strategy_id);
     ~EnhancedMomentumStrategy() override = default;
@@ -128,15 +211,28 @@ public:
         uint32_t min_signal_interval_ms = 1000;  // Minimum time between signals
         uint32_t base_signal_size = 100;    // Base signal size
         double max_signal_multiplier = 3.0; // Max multiplier based on conviction
+        uint32_t imbalance_levels = 1;      // Book levels per side in the flow signal
     };
 
+    void set_parameters(const Parameters& params) { params_ = params; tuning_.reset(params); }
+    const Parameters& get_parameters() const { return params_; }
+    
+    bool stage_parameters(const ParameterAssignments& assignments, std::string& error) override {
+        return tuning_.stage(assignments, error);
+    }
+    bool apply_staged_parameters() override { return tuning_.apply(params_); }
+    
+    static const std::vector<ParameterField<Parameters>>& parameter_fields();
+    static bool validate_parameters(const Parameters& params, std::string& error);
+
 private:
     Parameters params_;
-    OrderBookManager book_manager_;
+    TunableParameters<Parameters> tuning_{parameter_fields(), &validate_parameters};
     
+    // Windows are momentum_window long
     struct MomentumState {
-        std::vector<double> price_changes;
-        std::vector<double> flow_imbalances;
+        RollingWindow price_changes;
+        RollingWindow flow_imbalances;
         double last_mid_price = 0.0;
         std::chrono::steady_clock::time_point last_update;
     };
@@ -147,7 +243,7 @@ private:
     // Strategy logic
     void update_momentum_state(const std::string& symbol, double mid_price, double imbalance);
     void evaluate_momentum_signal(const std::string& symbol);
-    double calculate_momentum_score(const std::vector<double>& changes) const;
+    double calculate_momentum_score(const RollingWindow& changes) const;
     double calculate_signal_confidence(double momentum, double flow) const;
     uint32_t calculate_signal_size(double confidence) const;
 };
@@ -165,6 +261,9 @@ public:
         StrategyType type, uint64_t strategy_id);
     
     static std::string strategy_type_to_string(StrategyType type);
+    
+    // Inverse of strategy_type_to_string; false for an unknown name
+    static bool strategy_type_from_string(const std::string& name, StrategyType& type);
 };
 
 } // namespace hft
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "strategy_engine.h"
 #include "../common/logging.h"
 #include "../common/static_config.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/sampling_profiler.h"
+#include "../common/startup_timeline.h"
 #include <iostream>
 #include <signal.h>
 #include <thread>
@@ -20,9 +24,24 @@ int main(int argc, char* argv[]) {
     std::cout << "HFT Strategy Engine v1.0" << std::endl;
     std::cout << "=========================" << std::endl;
     
+    StartupTimeline& startup = StartupTimeline::instance();
+    
     // Initialize configuration
-    std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
-    StaticConfig::load_from_file(config_file.c_str());
+    // [config] [--replay <capture file>]
+    std::string config_file = "config/hft_config.conf";
+    std::string replay_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            replay_file = argv[++i];
+        } else {
+            config_file = arg;
+        }
+    }
+    startup.run("config", [&] { StaticConfig::load_from_file(config_file.c_str()); return true; });
+    ThreadPlan::instance().configure("strategy_engine");
+    // Reserve and pre-fault hot-state memory before the service allocates from it
+    startup.run("hot_arena", [] { HugePageArena::hot(); return true; });
     
     // Initialize logging
     GlobalLogger::instance().init("StrategyEngine", StaticConfig::get_logger_endpoint());
@@ -34,18 +53,35 @@ int main(int argc, char* argv[]) {
     try {
         g_engine = std::make_unique<StrategyEngine>();
         
-        if (!g_engine->initialize()) {
+        if (!startup.run("initialize", [] { return g_engine->initialize(); })) {
             std::cerr << "Failed to initialize Strategy Engine" << std::endl;
             return 1;
         }
+        std::cout << "Hot arena: " << HugePageArena::hot().describe() << std::endl;
+        
+        if (!replay_file.empty()) {
+            CaptureReader capture;
+            if (!capture.open(replay_file)) {
+                return 1;
+            }
+            std::cout << "Replaying " << capture.messages() << " messages captured by "
+                      << capture.service() << " from " << replay_file << std::endl;
+            ReplayReport report = g_engine->replay_capture(capture);
+            std::cout << "Replay: " << report.describe() << std::endl;
+            return 0;
+        }
         
         g_engine->start();
+        SamplingProfiler::instance().start_control_listener("StrategyEngine");
+        startup.ready("Strategy Engine");
         
         std::cout << "Strategy Engine is running. Press Ctrl+C to stop." << std::endl;
         
         while (g_engine->is_running()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        SamplingProfiler::instance().stop_control_listener();
+        SamplingProfiler::instance().stop();
         
         std::cout << "Strategy Engine shutdown complete." << std::endl;
         
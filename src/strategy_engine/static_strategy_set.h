@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../common/message_types.h"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace hft {
+
+// Fixed set of strategies given as a type list, for engines whose strategy
+// mix is known at compile time. The strategies are stored by value in one
+// tuple (contiguous, no per-strategy heap allocation) and every event is
+// delivered by a qualified call, S::on_market_data, which the compiler binds
+// statically: no vtable load, and the handler can be inlined wherever its
+// definition is visible (same TU or LTO). Strategies still derive from their
+// usual virtual base, so the same classes work in the plugin vector path.
+//
+//   StaticStrategySet<MarketMakingStrategy, StatArbStrategy> set(1, 2);
+//   engine.run(set, ticks);
+template <typename... Strategies>
+class StaticStrategySet {
+public:
+    static_assert(sizeof...(Strategies) > 0, "StaticStrategySet needs at least one strategy");
+
+    // One constructor argument per strategy, in type-list order
+    template <typename... Args>
+    explicit StaticStrategySet(Args&&... args) : strategies_(std::forward<Args>(args)...) {}
+
+    StaticStrategySet(const StaticStrategySet&) = delete;
+    StaticStrategySet& operator=(const StaticStrategySet&) = delete;
+
+    static constexpr size_t size() { return sizeof...(Strategies); }
+
+    template <size_t I>
+    auto& get() { return std::get<I>(strategies_); }
+
+    template <typename S>
+    S& get() { return std::get<S>(strategies_); }
+
+    // Calls f(strategy) for each strategy, in type-list order
+    template <typename F>
+    void for_each(F&& f) {
+        std::apply([&f](auto&... strategy) { (f(strategy), ...); }, strategies_);
+    }
+
+    void on_market_data(const MarketData& data) {
+        std::apply([&data](Strategies&... strategy) { (strategy.Strategies::on_market_data(data), ...); },
+                   strategies_);
+    }
+
+    void on_order_book_update(const OrderBookUpdate& update) {
+        std::apply([&update](Strategies&... strategy) {
+            (strategy.Strategies::on_order_book_update(update), ...);
+        }, strategies_);
+    }
+
+    void on_execution(const OrderExecution& execution) {
+        std::apply([&execution](Strategies&... strategy) {
+            (strategy.Strategies::on_execution(execution), ...);
+        }, strategies_);
+    }
+
+private:
+    std::tuple<Strategies...> strategies_;
+};
+
+} // namespace hft
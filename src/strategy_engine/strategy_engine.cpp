@@ -1,40 +1,76 @@
 #include "strategy_engine.h"
+#include "enhanced_strategies.h"
 
 #include "../common/static_config.h"
 #include "../common/metrics_collector.h"
 #include "../common/metrics_publisher.h"
 #include "../common/hft_metrics.h"
+#include "../common/pmu_counters.h"
+#include "../common/alloc_tracker.h"
+#include "../common/cpu_affinity.h"
+#include "../common/cpu_topology.h"
+#include "../common/hugepage_arena.h"
+#include "../common/spsc_channel.h"
+#include "../common/multicast_transport.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 
 namespace hft {
 
+namespace {
+
+// Shard owned by the calling worker thread; strategies publish through it
+thread_local void* tls_current_shard = nullptr;
+
+// Set while this thread replays warmup ticks; signals are dropped
+thread_local bool tls_warming_up = false;
+
+// Spin briefly when idle, then start yielding the core
+inline void idle_backoff(uint32_t& idle_spins) {
+    if (++idle_spins < 1024) {
+        CPUAffinity::cpu_pause();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
 // MomentumStrategy Implementation
 MomentumStrategy::MomentumStrategy(uint64_t strategy_id)
     : strategy_id_(strategy_id)
+    , last_prices_(SymbolTable::MAX_SYMBOLS, 0.0, hot_memory())
+    , last_signal_time_(SymbolTable::MAX_SYMBOLS, hot_memory())
     , logger_("MomentumStrategy", StaticConfig::get_logger_endpoint()) {
     logger_.info("Initialized with ID: " + std::to_string(strategy_id));
 }
 
 void MomentumStrategy::on_market_data(const MarketData& data) {
-    std::string symbol(data.symbol);
-    double mid_price = (data.bid_price + data.ask_price) / 2.0;
+    symbol_id_t id = SymbolTable::instance().resolve(data.symbol_id, data.symbol);
+    if (id >= last_prices_.size()) return;
+    
+    double mid_price = to_double_price(data.bid_price + data.ask_price) / 2.0;
     
     auto now = std::chrono::steady_clock::now();
     
     // Check if we have previous price data
-    auto price_it = last_prices_.find(symbol);
-    if (price_it != last_prices_.end()) {
-        double price_change = (mid_price - price_it->second) / price_it->second;
+    double last_price = last_prices_[id];
+    if (last_price > 0.0) {
+        double price_change = (mid_price - last_price) / last_price;
+        
+        // Threshold and interval from the same config load, even mid-reload
+        StaticConfig::Snapshot config;
         
         // Check if enough time has passed since last signal
-        auto time_it = last_signal_time_.find(symbol);
-        bool can_signal = (time_it == last_signal_time_.end()) ||
+        auto last_signal = last_signal_time_[id];
+        bool can_signal = (last_signal == std::chrono::steady_clock::time_point{}) ||
                          (std::chrono::duration_cast<std::chrono::milliseconds>(
-                             now - time_it->second).count() >= StaticConfig::get_min_signal_interval_ms());
+                             now - last_signal).count() >= config->min_signal_interval_ms);
         
-        if (can_signal && std::abs(price_change) > StaticConfig::get_momentum_threshold()) {
+        if (can_signal && std::abs(price_change) > config->momentum_threshold) {
             
             // Generate momentum signal with LIMIT orders using real prices
             SignalAction action = (price_change > 0) ? SignalAction::BUY : SignalAction::SELL;
@@ -52,37 +88,79 @@ void MomentumStrategy::on_market_data(const MarketData& data) {
             }
             
             TradingSignal signal = MessageFactory::create_trading_signal(
-                symbol, action, OrderType::LIMIT, limit_price, 100, strategy_id_, 
-                std::min(std::abs(price_change) / StaticConfig::get_momentum_threshold(), 1.0)
+                id, action, OrderType::LIMIT, limit_price, 100, strategy_id_, 
+                std::min(std::abs(price_change) / config->momentum_threshold, 1.0)
             );
+            signal.trace = data.trace;
+            signal.trace.stamp(TraceStage::STRATEGY_DECISION);
             
             // Publish signal through engine
             publish_signal(signal);
             
-            logger_.info("Published " + std::string(action == SignalAction::BUY ? "BUY" : "SELL") +
-                        " signal for " + symbol + " (change: " + 
-                        std::to_string(price_change * 100) + "%)");
+            HFT_LOGF(logger_, LogLevel::INFO, "Published {} signal for {} (change: {}%)",
+                     action == SignalAction::BUY ? "BUY" : "SELL", data.symbol, price_change * 100);
             
-            last_signal_time_[symbol] = now;
+            last_signal_time_[id] = now;
         }
     }
     
     // Update last price
-    last_prices_[symbol] = mid_price;
+    last_prices_[id] = mid_price;
+}
+
+void MomentumStrategy::reset_state() {
+    // Keep the arena allocations, just forget the prices
+    std::fill(last_prices_.begin(), last_prices_.end(), 0.0);
+    std::fill(last_signal_time_.begin(), last_signal_time_.end(), std::chrono::steady_clock::time_point{});
 }
 
 void MomentumStrategy::on_execution(const OrderExecution& execution) {
     std::string symbol(execution.symbol);
-    logger_.info("Execution for " + symbol + ": " + 
-                std::to_string(execution.fill_quantity) + " @ " +
-                std::to_string(execution.fill_price));
+    HFT_LOGF(logger_, LogLevel::INFO, "Execution for {}: {} @ {}",
+             symbol, execution.fill_quantity, to_double_price(execution.fill_price));
+}
+
+// OrderBookStrategyAdapter Implementation
+OrderBookStrategyAdapter::OrderBookStrategyAdapter(std::unique_ptr<OrderBookStrategy> strategy)
+    : strategy_(std::move(strategy)) {
+    strategy_->set_signal_callback([this](const TradingSignal& signal) { publish_signal(signal); });
+}
+
+OrderBookStrategyAdapter::~OrderBookStrategyAdapter() = default;
+
+void OrderBookStrategyAdapter::on_market_data(const MarketData& data) {
+    strategy_->apply_staged_parameters();
+    strategy_->on_market_data(data);
+}
+
+void OrderBookStrategyAdapter::on_execution(const OrderExecution& execution) {
+    strategy_->apply_staged_parameters();
+    strategy_->on_execution(execution);
+}
+
+std::string OrderBookStrategyAdapter::get_name() const {
+    return strategy_->get_name();
+}
+
+uint64_t OrderBookStrategyAdapter::get_id() const {
+    return strategy_->get_strategy_id();
+}
+
+bool OrderBookStrategyAdapter::stage_parameters(const ParameterAssignments& assignments, std::string& error) {
+    return strategy_->stage_parameters(assignments, error);
 }
 
 // StrategyEngine Implementation
 StrategyEngine::StrategyEngine()
     : running_(false)
+    , publisher_running_(false)
+    , shard_queue_full_(0)
+    , shards_warm_(0)
+    , signal_channel_full_(0)
     , market_data_processed_(0)
     , signals_generated_(0)
+    , signals_killed_(0)
+    , signal_channel_(nullptr)
     , logger_("StrategyEngine", StaticConfig::get_logger_endpoint())
     , metrics_publisher_("StrategyEngine", "tcp://*:5561") {
 }
@@ -96,7 +174,18 @@ bool StrategyEngine::initialize() {
     
     // Initialize high-performance systems
     MetricsCollector::instance().initialize();
-    StaticConfig::load_from_file("config/hft_config.conf");
+    StaticConfig::reload();
+    // Assign symbol IDs in config order so they agree across services
+    SymbolTable::instance().preload(StaticConfig::get_symbols());
+    if (!kill_switch_->open(StaticConfig::get_kill_switch_name())) {
+        logger_.warning("Kill switch not shared; only this process can stop its signals");
+    }
+    kill_word_ = kill_switch_->word() & ~KillSwitch::HALTED;
+    
+    // Shards must exist before strategies are added
+    if (StaticConfig::get_strategy_worker_threads() > 0) {
+        create_shards(static_cast<size_t>(StaticConfig::get_strategy_worker_threads()));
+    }
     
     // Initialize metrics publisher
     if (!metrics_publisher_.initialize()) {
@@ -105,43 +194,33 @@ bool StrategyEngine::initialize() {
     }
     
     try {
-        // Initialize ZeroMQ context and sockets
-        context_ = std::make_unique<zmq::context_t>(1);
-        
-        // Market data subscriber
-        subscriber_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        subscriber_->setsockopt(ZMQ_SUBSCRIBE, "", 0);  // Subscribe to all messages
-        int rcvhwm = 1000;
-        subscriber_->setsockopt(ZMQ_RCVHWM, &rcvhwm, sizeof(rcvhwm));
-        
-        // Execution subscriber
-        execution_sub_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_SUB);
-        execution_sub_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        execution_sub_->setsockopt(ZMQ_RCVHWM, &rcvhwm, sizeof(rcvhwm));
+        // Market data and execution subscribers, signal publisher
+        capture_ = MessageCapture::from_config("strategy_engine");
+        // From another host, market data comes over the multicast group
+        TransportConfig market_data_config = StaticConfig::get_market_data_multicast_subscribe()
+            ? multicast_config(StaticConfig::get_market_data_multicast_endpoint())
+            : zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint()));
+        subscriber_ = capture_tap(TransportFactory::open_subscriber(market_data_config),
+            capture_.get(), "market_data");
+        logger_.info("Connected to market data: " + subscriber_->get_endpoint());
         
-        // Signal publisher
-        signal_pub_ = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUB);
-        int sndhwm = 1000;
-        signal_pub_->setsockopt(ZMQ_SNDHWM, &sndhwm, sizeof(sndhwm));
-        int linger = 0;
-        signal_pub_->setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+        execution_sub_ = capture_tap(TransportFactory::open_subscriber(
+            zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_executions_endpoint()))),
+            capture_.get(), "executions");
         
-        // Connect to endpoints using StaticConfig for better performance
-        const char* market_data_endpoint = StaticConfig::get_market_data_endpoint();
-        subscriber_->connect(market_data_endpoint);
-        logger_.info("Connected to market data: " + std::string(market_data_endpoint));
+        signal_pub_ = TransportFactory::open_publisher(
+            zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_signals_endpoint())));
+        logger_.info("Signal publisher bound to " + signal_pub_->get_endpoint());
         
-        // Connect to executions endpoint using StaticConfig
-        const char* executions_endpoint = StaticConfig::get_executions_endpoint();
-        execution_sub_->connect(executions_endpoint);
-        
-        // Bind signal publisher
-        const char* signals_endpoint = StaticConfig::get_signals_endpoint();
-        signal_pub_->bind(signals_endpoint);
-        logger_.info("Signal publisher bound to " + std::string(signals_endpoint));
+        // Control commands: strategy load/unload/parameters, config reloads
+        TransportConfig control_config = zmq_subscriber_config(
+            "tcp://localhost:" + std::to_string(StaticConfig::get_control_commands_port()));
+        control_config.high_water_mark = 100;
+        control_sub_ = capture_tap(TransportFactory::open_subscriber(control_config), capture_.get(), "control");
+        logger_.info("Connected to control endpoint: " + control_sub_->get_endpoint());
         
         // Add default momentum strategy
-        add_strategy(std::make_unique<MomentumStrategy>(1001));
+        add_strategy_factory([] { return std::make_unique<MomentumStrategy>(1001); });
         
         return true;
         
@@ -165,9 +244,27 @@ void StrategyEngine::start() {
     
     // Start metrics publisher
     metrics_publisher_.start();
+    warmup::publish_pending();
+    if (capture_ && capture_->start()) {
+        logger_.info("Capturing input to " + capture_->path());
+    }
+    
+    // Workers and the merged publisher come up before the receive thread feeds them
+    if (!shards_.empty()) {
+        publisher_running_.store(true);
+        for (auto& shard : shards_) {
+            Shard* raw = shard.get();
+            shard->thread = std::thread([this, raw] { run_shard(*raw); });
+        }
+        publisher_thread_ = std::make_unique<std::thread>(&StrategyEngine::run_publisher, this);
+    }
     
     // Start processing thread
     processing_thread_ = std::make_unique<std::thread>(&StrategyEngine::process_messages, this);
+    control_thread_ = std::make_unique<std::thread>(&StrategyEngine::process_control_messages, this);
+    config_reloader_.start([this](uint64_t generation) {
+        logger_.info("Configuration reloaded (generation " + std::to_string(generation) + ")");
+    });
     
     logger_.info("Strategy Engine started");
 }
@@ -182,11 +279,35 @@ void StrategyEngine::stop() {
     
     // Stop metrics publisher
     metrics_publisher_.stop();
+    config_reloader_.stop();
     
+    if (control_thread_ && control_thread_->joinable()) {
+        control_thread_->join();
+    }
     if (processing_thread_ && processing_thread_->joinable()) {
         processing_thread_->join();
     }
     
+    // Workers first, so the publisher's final drain sees every signal
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+    
+    // Adopt loads still queued so they are freed with the rest
+    apply_strategy_changes(strategy_changes_, strategies_);
+    for (auto& shard : shards_) {
+        apply_strategy_changes(shard->strategy_changes, shard->strategies);
+    }
+    publisher_running_.store(false);
+    if (publisher_thread_ && publisher_thread_->joinable()) {
+        publisher_thread_->join();
+    }
+    if (capture_) {
+        capture_->stop();
+    }
+    
     // Close sockets safely
     if (subscriber_) {
         try {
@@ -206,6 +327,12 @@ void StrategyEngine::stop() {
             signal_pub_.reset();
         } catch (const zmq::error_t&) {}
     }
+    if (control_sub_) {
+        try {
+            control_sub_->close();
+            control_sub_.reset();
+        } catch (const zmq::error_t&) {}
+    }
     
     log_statistics();
     
@@ -221,61 +348,267 @@ bool StrategyEngine::is_running() const {
 }
 
 void StrategyEngine::add_strategy(std::unique_ptr<Strategy> strategy) {
+    if (!shards_.empty()) {
+        logger_.error("Strategy " + strategy->get_name() +
+                      " not added: sharded engines need add_strategy_factory()");
+        return;
+    }
+    
     logger_.info("Adding strategy: " + strategy->get_name() + 
                 " (ID: " + std::to_string(strategy->get_id()) + ")");
     
     // Set engine reference for signal publishing
     strategy->set_engine(this);
     
+    strategy_registry_[strategy->get_id()].push_back(strategy.get());
     strategies_.push_back(std::move(strategy));
 }
 
+void StrategyEngine::add_strategy_factory(const StrategyMaker& maker) {
+    if (shards_.empty()) {
+        add_strategy(maker());
+        return;
+    }
+    
+    for (auto& shard : shards_) {
+        auto strategy = maker();
+        strategy->set_engine(this);
+        if (shard->index == 0) {
+            logger_.info("Adding strategy: " + strategy->get_name() + " (ID: " +
+                         std::to_string(strategy->get_id()) + ") on " +
+                         std::to_string(shards_.size()) + " shards");
+        }
+        strategy_registry_[strategy->get_id()].push_back(strategy.get());
+        shard->strategies.push_back(std::move(strategy));
+    }
+}
+
+void StrategyEngine::create_shards(size_t count) {
+    int first_cpu = StaticConfig::get_strategy_worker_first_cpu();
+    for (size_t i = 0; i < count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        shard->cpu = first_cpu + static_cast<int>(i);
+        // A thread plan entry overrides the consecutive default
+        if (const ThreadPlacement* placement = ThreadPlan::instance().find(thread_prefix_ + "worker." + std::to_string(i))) {
+            shard->cpu = placement->cpu;
+        }
+        shards_.push_back(std::move(shard));
+    }
+    logger_.info("Sharding symbols across " + std::to_string(count) + " strategy workers (CPUs " +
+                 std::to_string(first_cpu) + "-" + std::to_string(first_cpu + static_cast<int>(count) - 1) + ")");
+}
+
+StrategyEngine::Shard& StrategyEngine::shard_for(symbol_id_t symbol_id, const char* symbol) {
+    symbol_id_t id = SymbolTable::instance().resolve(symbol_id, symbol);
+    if (id == INVALID_SYMBOL_ID) id = 0;
+    return *shards_[id % shards_.size()];
+}
+
+void StrategyEngine::run_shard(Shard& shard) {
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "worker." + std::to_string(shard.index), shard.cpu)) {
+        logger_.warning("Failed to pin strategy worker " + std::to_string(shard.index) +
+                        " to CPU " + std::to_string(shard.cpu));
+    }
+    // The queues were allocated by the main thread; bring them to this node
+    ThreadPlan::move_to_local_node(&shard, sizeof(Shard));
+    tls_current_shard = &shard;
+    
+    // Each worker warms its own strategies on its own core
+    shard.warmup = warm_up(shard.strategies);
+    if (shards_warm_.fetch_add(1, std::memory_order_acq_rel) + 1 == shards_.size()) {
+        // Last one in reports for the engine: the slowest shard's numbers
+        WarmupReport combined;
+        combined.stable = true;
+        for (auto& other : shards_) {
+            const WarmupReport& report = other->warmup;
+            combined.rounds = std::max(combined.rounds, report.rounds);
+            combined.events += report.events;
+            combined.first_p99_ns = std::max(combined.first_p99_ns, report.first_p99_ns);
+            combined.p99_ns = std::max(combined.p99_ns, report.p99_ns);
+            combined.stable = combined.stable && report.stable;
+        }
+        finish_warmup(combined);
+    }
+    
+    MarketData data;
+    OrderExecution execution;
+    uint32_t idle_spins = 0;
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        bool worked = false;
+        apply_strategy_changes(shard.strategy_changes, shard.strategies);
+        
+        while (shard.market_data.try_dequeue(data)) {
+            worked = true;
+            HFT_METRICS_TIMER(hft::metrics::STRATEGY_PROCESS_LATENCY);
+            HFT_PMU_SCOPE("strategy_handle_market_data");
+            for (auto& strategy : shard.strategies) {
+                strategy->on_market_data(data);
+            }
+        }
+        
+        while (shard.executions.try_dequeue(execution)) {
+            worked = true;
+            for (auto& strategy : shard.strategies) {
+                strategy->on_execution(execution);
+            }
+        }
+        
+        if (worked) {
+            idle_spins = 0;
+        } else {
+            idle_backoff(idle_spins);
+        }
+    }
+    
+    tls_current_shard = nullptr;
+}
+
+void StrategyEngine::run_publisher() {
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "publisher")) {
+        logger_.warning("Failed to pin publisher thread to its planned CPU");
+    }
+    TradingSignal signal;
+    uint32_t idle_spins = 0;
+    
+    auto drain = [this, &signal]() {
+        bool sent = false;
+        for (auto& shard : shards_) {
+            while (shard->signals.try_dequeue(signal)) {
+                send_signal(signal);
+                sent = true;
+            }
+        }
+        if (sent) {
+            flush_signals();
+        }
+        return sent;
+    };
+    
+    while (publisher_running_.load(std::memory_order_relaxed)) {
+        if (drain()) {
+            idle_spins = 0;
+        } else {
+            idle_backoff(idle_spins);
+        }
+    }
+    drain();
+}
+
 void StrategyEngine::process_messages() {
+    if (StaticConfig::get_strategy_busy_poll()) {
+        process_messages_busy_poll();
+        return;
+    }
+    
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "processing")) {
+        logger_.warning("Failed to pin processing thread to its planned CPU");
+    }
     logger_.info("Strategy processing thread started");
+    if (shards_.empty()) {
+        finish_warmup(warm_up(strategies_));
+    }
     
-    // Set up polling for multiple sockets
+    // Set up polling for multiple sockets; a kill wakes the poll too
+    int kill_fd = kill_switch_->wake_fd(KillParty::STRATEGY);
+    // A multicast subscriber has a plain fd instead of a zmq socket
+    int market_data_fd = subscriber_->get_poll_fd();
     zmq::pollitem_t items[] = {
-        { *subscriber_, 0, ZMQ_POLLIN, 0 },
-        { *execution_sub_, 0, ZMQ_POLLIN, 0 }
+        { market_data_fd >= 0 ? nullptr : subscriber_->get_native_handle(), market_data_fd, ZMQ_POLLIN, 0 },
+        { execution_sub_->get_native_handle(), 0, ZMQ_POLLIN, 0 },
+        { nullptr, kill_fd, ZMQ_POLLIN, 0 }
     };
     
     auto last_stats_time = std::chrono::steady_clock::now();
-    const auto stats_interval = std::chrono::seconds(30);
     
     while (running_.load()) {
         try {
+            apply_strategy_changes(strategy_changes_, strategies_);
+            
             // Poll with timeout
-            zmq::poll(&items[0], 2, std::chrono::milliseconds(100));
+            zmq::poll(&items[0], kill_fd >= 0 ? 3 : 2, std::chrono::milliseconds(100));
+            if (items[2].revents & ZMQ_POLLIN) {
+                kill_switch_->drain_wake(KillParty::STRATEGY);
+            }
+            check_kill_switch();
             
             // Handle market data
             if (items[0].revents & ZMQ_POLLIN) {
-                zmq::message_t message;
-                if (subscriber_->recv(message, zmq::recv_flags::dontwait)) {
-                    if (message.size() == sizeof(MarketData)) {
-                        MarketData data;
-                        std::memcpy(&data, message.data(), sizeof(MarketData));
-                        handle_market_data(data);
-                    }
+                MarketDataFrame frame;
+                size_t size = sizeof(frame);
+                if (subscriber_->receive(&frame, size, true)) {
+                    for_each_quote(&frame, size, [this](const MarketData& data) { handle_market_data(data); });
                 }
             }
             
             // Handle executions
             if (items[1].revents & ZMQ_POLLIN) {
-                zmq::message_t message;
-                if (execution_sub_->recv(message, zmq::recv_flags::dontwait)) {
-                    if (message.size() == sizeof(OrderExecution)) {
-                        OrderExecution execution;
-                        std::memcpy(&execution, message.data(), sizeof(OrderExecution));
-                        handle_execution(execution);
-                    }
+                OrderExecution execution;
+                size_t size = sizeof(execution);
+                if (execution_sub_->receive(&execution, size, true) && size == sizeof(OrderExecution)) {
+                    handle_execution(execution);
                 }
             }
             
             // Log statistics periodically
-            auto now = std::chrono::steady_clock::now();
-            if (now - last_stats_time >= stats_interval) {
-                log_statistics();
-                last_stats_time = now;
+            maybe_log_statistics(last_stats_time);
+            
+        } catch (const zmq::error_t& e) {
+            if (e.num() != EINTR) {
+                logger_.error("Message processing error: " + std::string(e.what()));
+            }
+        }
+    }
+    
+    logger_.info("Strategy processing thread stopped");
+}
+
+void StrategyEngine::process_messages_busy_poll() {
+    const ThreadPlacement* placement = ThreadPlan::instance().find(thread_prefix_ + "processing");
+    int cpu = placement ? placement->cpu : StaticConfig::get_strategy_busy_poll_cpu();
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "processing", cpu)) {
+        logger_.warning("Failed to pin busy-poll thread to CPU " + std::to_string(cpu));
+    }
+    logger_.info("Strategy processing thread started (busy-poll on CPU " + std::to_string(cpu) + ")");
+    if (shards_.empty()) {
+        finish_warmup(warm_up(strategies_));
+    }
+    
+    // Reused across iterations
+    MarketDataFrame market_data;
+    OrderExecution execution;
+    
+    auto last_stats_time = std::chrono::steady_clock::now();
+    uint32_t iterations = 0;
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        try {
+            bool received = false;
+            check_kill_switch();
+            apply_strategy_changes(strategy_changes_, strategies_);
+            
+            size_t size = sizeof(market_data);
+            if (subscriber_->receive(&market_data, size, true)) {
+                received = true;
+                for_each_quote(&market_data, size, [this](const MarketData& data) { handle_market_data(data); });
+            }
+            
+            size = sizeof(execution);
+            if (execution_sub_->receive(&execution, size, true)) {
+                received = true;
+                if (size == sizeof(OrderExecution)) {
+                    handle_execution(execution);
+                }
+            }
+            
+            if (!received) {
+                CPUAffinity::cpu_pause();
+            }
+            
+            // Only read the clock every 64K iterations
+            if ((++iterations & 0xFFFF) == 0) {
+                maybe_log_statistics(last_stats_time);
             }
             
         } catch (const zmq::error_t& e) {
@@ -288,39 +621,401 @@ void StrategyEngine::process_messages() {
     logger_.info("Strategy processing thread stopped");
 }
 
+ReplayReport StrategyEngine::replay_capture(const CaptureReader& capture) {
+    ReplayReport report;
+    if (!shards_.empty()) {
+        logger_.error("Replay runs strategies on the calling thread; set strategy.worker_threads=0");
+        return report;
+    }
+    report.dropped_at_capture = capture.dropped();
+    report.captured_span_ns = capture.span_ns();
+    int market_data = capture.channel("market_data");
+    int executions = capture.channel("executions");
+    int control = capture.channel("control");
+    
+    auto start = std::chrono::steady_clock::now();
+    capture.for_each([&](const CapturedMessage& message) {
+        // Copied out: mapped records are only 8-byte aligned
+        if (message.channel == market_data && message.size <= sizeof(MarketDataFrame)) {
+            MarketDataFrame frame;
+            std::memcpy(&frame, message.data, message.size);
+            for_each_quote(&frame, message.size, [this](const MarketData& data) { handle_market_data(data); });
+        } else if (message.channel == executions && message.size == sizeof(OrderExecution)) {
+            OrderExecution execution;
+            std::memcpy(&execution, message.data, sizeof(execution));
+            handle_execution(execution);
+        } else if (message.channel == control && message.size == sizeof(ControlCommand)) {
+            ControlCommand command;
+            std::memcpy(&command, message.data, sizeof(command));
+            std::string target(command.target_service, strnlen(command.target_service, sizeof(command.target_service)));
+            if (target == "StrategyEngine" || target == "all") {
+                handle_control_command(command);
+            }
+            apply_strategy_changes(strategy_changes_, strategies_);
+        } else {
+            report.skipped++;
+            return;
+        }
+        report.messages++;
+    });
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    return report;
+}
+
+void StrategyEngine::maybe_log_statistics(std::chrono::steady_clock::time_point& last_stats_time) {
+    static constexpr auto stats_interval = std::chrono::seconds(30);
+    
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_stats_time >= stats_interval) {
+        log_statistics();
+        last_stats_time = now;
+    }
+}
+
+WarmupReport StrategyEngine::warm_up(std::vector<std::unique_ptr<Strategy>>& strategies) {
+    std::vector<symbol_id_t> symbols = warmup::universe();
+    if (!StaticConfig::get_warmup_enabled() || symbols.empty() || strategies.empty()) {
+        return {};
+    }
+    
+    // Built up front so only the strategies are timed; the walk repeats every 8 steps
+    std::vector<MarketData> ticks;
+    for (uint64_t i = 0; i < symbols.size() * 8; ++i) {
+        ticks.push_back(warmup::synthetic_tick(symbols[i % symbols.size()], i / symbols.size()));
+    }
+    
+    tls_warming_up = true;
+    WarmupReport report = run_warmup(WarmupOptions::from_config(), [&](uint64_t i) {
+        const MarketData& data = ticks[i % ticks.size()];
+        for (auto& strategy : strategies) {
+            strategy->on_market_data(data);
+        }
+    });
+    tls_warming_up = false;
+    
+    for (auto& strategy : strategies) {
+        strategy->reset_state();
+    }
+    return report;
+}
+
+void StrategyEngine::finish_warmup(const WarmupReport& report) {
+    warmup::publish(report);
+    if (report.rounds > 0) {
+        logger_.info("Warmup " + report.describe());
+    }
+}
+
 void StrategyEngine::handle_market_data(const MarketData& data) {
+    HFT_NO_ALLOC_SCOPE("StrategyEngine::handle_market_data");
+    if (!shards_.empty()) {
+        // Block rather than drop: a lost tick would corrupt the shard's symbol state
+        Shard& shard = shard_for(data.symbol_id, data.symbol);
+        while (!shard.market_data.try_enqueue(data)) {
+            if (!running_.load(std::memory_order_relaxed)) return;
+            shard_queue_full_++;
+            CPUAffinity::cpu_pause();
+        }
+        market_data_processed_++;
+        HFT_METRICS_COUNTER(hft::metrics::MARKET_DATA_MESSAGES);
+        return;
+    }
+    
     HFT_METRICS_TIMER(hft::metrics::STRATEGY_PROCESS_LATENCY);
+    HFT_PMU_SCOPE("strategy_handle_market_data");
     // Forward to all strategies
     for (auto& strategy : strategies_) {
         strategy->on_market_data(data);
     }
+    flush_signals();
     
     market_data_processed_++;
     HFT_METRICS_COUNTER(hft::metrics::MARKET_DATA_MESSAGES);
 }
 
+void StrategyEngine::process_control_messages() {
+    if (!ThreadPlan::instance().pin_current_thread(thread_prefix_ + "control")) {
+        logger_.warning("Failed to pin control thread to its planned CPU");
+    }
+    
+    while (running_.load()) {
+        try {
+            ControlCommand command;
+            size_t size = sizeof(command);
+            if (control_sub_->receive(&command, size, true) && size == sizeof(ControlCommand)) {
+                std::string target(command.target_service, strnlen(command.target_service, sizeof(command.target_service)));
+                if (target == "StrategyEngine" || target == "all") {
+                    handle_control_command(command);
+                }
+            }
+            
+            std::this_thread::sleep_for(std::chrono::milliseconds(StaticConfig::get_control_poll_interval_ms()));
+            
+        } catch (const std::exception& e) {
+            logger_.error("Control message processing error: " + std::string(e.what()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+}
+
+void StrategyEngine::handle_control_command(const ControlCommand& command) {
+    std::string spec(command.parameters, strnlen(command.parameters, sizeof(command.parameters)));
+    std::string error;
+    
+    switch (command.action) {
+        case ControlAction::LOAD_STRATEGY:
+            if (!load_strategy(spec, error)) {
+                logger_.error("Strategy load rejected (" + spec + "): " + error);
+            }
+            break;
+            
+        case ControlAction::UNLOAD_STRATEGY:
+            if (!unload_strategy(spec, error)) {
+                logger_.error("Strategy unload rejected (" + spec + "): " + error);
+            }
+            break;
+            
+        case ControlAction::UPDATE_STRATEGY_PARAMETERS:
+            if (!update_strategy_parameters(spec, error)) {
+                logger_.error("Strategy parameters rejected (" + spec + "): " + error);
+            }
+            break;
+            
+        case ControlAction::UPDATE_CONFIG:
+            config_reloader_.request_reload();
+            break;
+            
+        default:
+            // Trading state commands are for the other services
+            break;
+    }
+}
+
+namespace {
+
+// Parses the spec and takes its "id" out of it
+bool take_strategy_id(const std::string& spec, ParameterAssignments& assignments, uint64_t& id, std::string& error) {
+    if (!parse_parameter_assignments(spec, assignments, error)) {
+        return false;
+    }
+    std::string value;
+    if (!take_assignment(assignments, "id", value)) {
+        error = "missing id";
+        return false;
+    }
+    char* end = nullptr;
+    id = std::strtoull(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0' || id == 0) {
+        error = "invalid id " + value;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool StrategyEngine::load_strategy(const std::string& spec, std::string& error) {
+    ParameterAssignments assignments;
+    uint64_t id;
+    if (!take_strategy_id(spec, assignments, id, error)) {
+        return false;
+    }
+    std::string type_name;
+    StrategyType type;
+    if (!take_assignment(assignments, "type", type_name) ||
+        !StrategyFactory::strategy_type_from_string(type_name, type)) {
+        error = "type must be MarketMaking, StatArb or EnhancedMomentum";
+        return false;
+    }
+    if (strategy_registry_.count(id)) {
+        error = "strategy " + std::to_string(id) + " is already loaded";
+        return false;
+    }
+    
+    // Built and configured here, off the strategy threads; one per shard
+    std::vector<std::unique_ptr<Strategy>> instances(std::max<size_t>(shards_.size(), 1));
+    for (auto& instance : instances) {
+        auto strategy = StrategyFactory::create_strategy(type, id);
+        if (!strategy || !strategy->initialize()) {
+            error = "failed to create " + type_name;
+            return false;
+        }
+        instance = std::make_unique<OrderBookStrategyAdapter>(std::move(strategy));
+        if (!assignments.empty() && !instance->stage_parameters(assignments, error)) {
+            return false;
+        }
+        instance->set_engine(this);
+    }
+    
+    std::vector<Strategy*>& registered = strategy_registry_[id];
+    for (size_t i = 0; i < instances.size(); ++i) {
+        StrategyChangeQueue& queue = shards_.empty() ? strategy_changes_ : shards_[i]->strategy_changes;
+        Strategy* strategy = instances[i].release();
+        if (!send_strategy_change(queue, StrategyChange{strategy, 0})) {
+            delete strategy;
+            continue;
+        }
+        registered.push_back(strategy);
+    }
+    
+    logger_.info("Loaded strategy " + type_name + " (ID: " + std::to_string(id) + ")");
+    return true;
+}
+
+bool StrategyEngine::unload_strategy(const std::string& spec, std::string& error) {
+    ParameterAssignments assignments;
+    uint64_t id;
+    if (!take_strategy_id(spec, assignments, id, error)) {
+        return false;
+    }
+    auto it = strategy_registry_.find(id);
+    if (it == strategy_registry_.end()) {
+        error = "no strategy " + std::to_string(id);
+        return false;
+    }
+    
+    // Forgotten here first: nothing stages into an instance once its owner may free it
+    strategy_registry_.erase(it);
+    if (shards_.empty()) {
+        send_strategy_change(strategy_changes_, StrategyChange{nullptr, id});
+    } else {
+        for (auto& shard : shards_) {
+            send_strategy_change(shard->strategy_changes, StrategyChange{nullptr, id});
+        }
+    }
+    
+    logger_.info("Unloaded strategy " + std::to_string(id));
+    return true;
+}
+
+bool StrategyEngine::update_strategy_parameters(const std::string& spec, std::string& error) {
+    ParameterAssignments assignments;
+    uint64_t id;
+    if (!take_strategy_id(spec, assignments, id, error)) {
+        return false;
+    }
+    auto it = strategy_registry_.find(id);
+    if (it == strategy_registry_.end()) {
+        error = "no strategy " + std::to_string(id);
+        return false;
+    }
+    if (assignments.empty()) {
+        error = "no parameters given";
+        return false;
+    }
+    
+    // Validation does not depend on the instance, so shards accept or reject together
+    for (Strategy* strategy : it->second) {
+        if (!strategy->stage_parameters(assignments, error)) {
+            return false;
+        }
+    }
+    
+    logger_.info("Staged parameters for strategy " + std::to_string(id) + ": " + spec);
+    return true;
+}
+
+bool StrategyEngine::send_strategy_change(StrategyChangeQueue& queue, const StrategyChange& change) {
+    // The owner drains between messages; a full queue only waits out a burst of commands
+    while (!queue.try_enqueue(change)) {
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void StrategyEngine::apply_strategy_changes(StrategyChangeQueue& queue,
+                                            std::vector<std::unique_ptr<Strategy>>& strategies) {
+    StrategyChange change;
+    while (queue.try_dequeue(change)) {
+        if (change.add) {
+            strategies.emplace_back(change.add);
+        } else {
+            // Freed on this thread; unloads are rare enough not to hand it back
+            strategies.erase(std::remove_if(strategies.begin(), strategies.end(),
+                                            [&change](const auto& strategy) {
+                                                return strategy->get_id() == change.remove_id;
+                                            }),
+                             strategies.end());
+        }
+    }
+}
+
 void StrategyEngine::handle_execution(const OrderExecution& execution) {
+    if (!shards_.empty()) {
+        Shard& shard = shard_for(execution.symbol_id, execution.symbol);
+        while (!shard.executions.try_enqueue(execution)) {
+            if (!running_.load(std::memory_order_relaxed)) return;
+            shard_queue_full_++;
+            CPUAffinity::cpu_pause();
+        }
+        return;
+    }
+    
     // Forward to all strategies
     for (auto& strategy : strategies_) {
         strategy->on_execution(execution);
     }
+    flush_signals();
 }
 
 void StrategyEngine::publish_signal(const TradingSignal& signal) {
+    if (tls_warming_up) return;
+    
+    // From a shard worker: hand off to the publisher thread, which owns the socket
+    if (auto* shard = static_cast<Shard*>(tls_current_shard)) {
+        while (!shard->signals.try_enqueue(signal)) {
+            if (!publisher_running_.load(std::memory_order_relaxed)) return;
+            shard_queue_full_++;
+            CPUAffinity::cpu_pause();
+        }
+        return;
+    }
+    
+    send_signal(signal);
+}
+
+void StrategyEngine::send_signal(const TradingSignal& signal) {
+    // Checked here, on the one thread that publishes, so nothing gets out
+    // after the word flips, sharded or not
+    if (kill_switch_->halted()) [[unlikely]] {
+        signals_killed_++;
+        return;
+    }
     HFT_METRICS_TIMER(hft::metrics::STRATEGY_PUBLISH_LATENCY);
     
-    try {
-        zmq::message_t message(sizeof(TradingSignal));
-        std::memcpy(message.data(), &signal, sizeof(TradingSignal));
-        
-        signal_pub_->send(message, zmq::send_flags::dontwait);
+    if (signal_channel_) {
+        // Fast path: staged here, published by flush_signals() once per tick or drain
+        while (!signal_channel_->try_stage(signal)) {
+            signal_channel_->publish();
+            if (!running_.load(std::memory_order_relaxed)) return;
+            signal_channel_full_++;
+            CPUAffinity::cpu_pause();
+        }
         signals_generated_++;
         HFT_METRICS_COUNTER(hft::metrics::SIGNALS_GENERATED);
-        
-    } catch (const zmq::error_t& e) {
-        if (e.num() != EAGAIN) {
-            logger_.error("Failed to publish signal: " + std::string(e.what()));
-        }
+        return;
+    }
+    
+    // PUB never blocks: a subscriber at its high water mark just misses it
+    signal_pub_->publish(&signal, sizeof(TradingSignal));
+    signals_generated_++;
+    HFT_METRICS_COUNTER(hft::metrics::SIGNALS_GENERATED);
+}
+
+void StrategyEngine::handle_kill_switch(uint64_t word) {
+    kill_word_ = word;
+    if (KillSwitch::halted(word)) {
+        kill_switch_->acknowledge(KillParty::STRATEGY, word);
+        logger_.error("Kill switch: signals stopped");
+    } else {
+        logger_.warning("Kill switch reset; signals resume");
+    }
+}
+
+void StrategyEngine::flush_signals() {
+    if (signal_channel_) {
+        signal_channel_->publish();
     }
 }
 
@@ -330,6 +1025,16 @@ void StrategyEngine::log_statistics() {
     
     std::string stats = "Processed " + std::to_string(data_count) + 
                        " market data messages, generated " + std::to_string(signal_count) + " signals";
+    if (!shards_.empty()) {
+        stats += " across " + std::to_string(shards_.size()) + " shards (" +
+                 std::to_string(shard_queue_full_.load()) + " full-queue retries)";
+    }
+    if (signal_channel_) {
+        stats += ", in-process gateway channel (" + std::to_string(signal_channel_full_.load()) + " full retries)";
+    }
+    if (signals_killed_.load() > 0) {
+        stats += ", " + std::to_string(signals_killed_.load()) + " dropped by the kill switch";
+    }
     logger_.info(stats);
 }
 
@@ -3,11 +3,21 @@
 #include "../common/message_types.h"
 #include "../common/logging.h"
 #include "../common/metrics_publisher.h"
-#include <zmq.hpp>
+#include "../common/config_reloader.h"
+#include "../common/message_capture.h"
+#include "../common/cpu_affinity.h"
+#include "../common/warmup.h"
+#include "../common/spsc_channel.h"
+#include "../common/kill_switch.h"
+#include "../common/zmq_transport.h"
+#include "strategy_parameters.h"
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <functional>
+#include <memory_resource>
 #include <unordered_map>
+#include <vector>
 
 namespace hft {
 
@@ -31,6 +41,18 @@ public:
     // Get strategy ID
     virtual uint64_t get_id() const = 0;
     
+    // Forget per-symbol state (called after the warmup replay)
+    virtual void reset_state() {}
+    
+    // Runtime retuning from the engine's control thread; the strategy applies
+    // a staged set on its own thread before its next tick. False with a
+    // reason if the strategy has no such parameters or rejects the values.
+    virtual bool stage_parameters(const ParameterAssignments& assignments, std::string& error) {
+        (void)assignments;
+        error = get_name() + " has no runtime parameters";
+        return false;
+    }
+    
     // Set engine reference for signal publishing
     void set_engine(StrategyEngine* engine) { engine_ = engine; }
 
@@ -42,7 +64,7 @@ protected:
 };
 
 // Simple momentum strategy for testing
-class MomentumStrategy : public Strategy {
+class MomentumStrategy final : public Strategy {
 public:
     explicit MomentumStrategy(uint64_t strategy_id);
     
@@ -50,15 +72,43 @@ public:
     void on_execution(const OrderExecution& execution) override;
     std::string get_name() const override { return "MomentumStrategy"; }
     uint64_t get_id() const override { return strategy_id_; }
+    void reset_state() override;
 
 private:
     uint64_t strategy_id_;
-    std::unordered_map<std::string, double> last_prices_;
-    std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_signal_time_;
+    
+    // Per-symbol state indexed by symbol_id_t (0.0 / epoch = not seen yet),
+    // in the hot arena
+    std::pmr::vector<double> last_prices_;
+    std::pmr::vector<std::chrono::steady_clock::time_point> last_signal_time_;
     
     Logger logger_;
 };
 
+class OrderBookStrategy;
+
+// Runs a StrategyFactory strategy (enhanced_strategies.h) in the engine:
+// signals go through the engine's publisher and staged parameters are
+// applied before each tick. Order book strategies only see books for
+// symbols whose OrderBookUpdates reach them; the engine forwards quotes.
+class OrderBookStrategyAdapter final : public Strategy {
+public:
+    explicit OrderBookStrategyAdapter(std::unique_ptr<OrderBookStrategy> strategy);
+    ~OrderBookStrategyAdapter() override;
+    
+    void on_market_data(const MarketData& data) override;
+    void on_execution(const OrderExecution& execution) override;
+    std::string get_name() const override;
+    uint64_t get_id() const override;
+    bool stage_parameters(const ParameterAssignments& assignments, std::string& error) override;
+
+private:
+    std::unique_ptr<OrderBookStrategy> strategy_;
+};
+
+// Builds one strategy instance; a sharded engine calls it once per worker
+using StrategyMaker = std::function<std::unique_ptr<Strategy>()>;
+
 class StrategyEngine {
 public:
     StrategyEngine();
@@ -76,37 +126,162 @@ public:
     // Check if engine is running
     bool is_running() const;
     
-    // Add a strategy to the engine
+    // Add a strategy to the engine (single-threaded mode only: one instance
+    // cannot be split across symbol shards)
     void add_strategy(std::unique_ptr<Strategy> strategy);
     
+    // Add a strategy by factory; works in both modes, one instance per shard
+    void add_strategy_factory(const StrategyMaker& maker);
+    
+    // Worker threads from strategy.worker_threads (0 = single-threaded)
+    size_t get_shard_count() const { return shards_.size(); }
+    
     // Publish trading signal (public for Strategy access)
     void publish_signal(const TradingSignal& signal);
+    
+    // Fast path: hand signals to an OrderGateway in this process instead of
+    // publishing them over ZMQ. Set before start().
+    void set_signal_channel(SignalChannel* channel) { signal_channel_ = channel; }
+    
+    // Prepended to this engine's thread plan names ("processing", "worker.<n>",
+    // "publisher") when it shares a process and plan with other services.
+    // Set before initialize().
+    void set_thread_prefix(const std::string& prefix) { thread_prefix_ = prefix; }
+    
+    // Runtime strategy management, as driven by control commands. Call from
+    // one thread (the control thread once started). Loading builds the
+    // instances here and hands them to the thread(s) running strategies;
+    // parameters are staged for those threads to pick up between ticks.
+    // "type=<StrategyFactory name> id=<n> [param=value ...]"
+    bool load_strategy(const std::string& spec, std::string& error);
+    // "id=<n>"
+    bool unload_strategy(const std::string& spec, std::string& error);
+    // "id=<n> param=value ..."
+    bool update_strategy_parameters(const std::string& spec, std::string& error);
+    
+    // After initialize(), instead of start(): feeds a capture of this
+    // engine's input (market data, executions, control commands) through the
+    // same handlers on the calling thread, as fast as possible, in the order
+    // it was received. Single-threaded mode only.
+    ReplayReport replay_capture(const CaptureReader& capture);
 
 private:
-    // ZeroMQ context and sockets
-    std::unique_ptr<zmq::context_t> context_;
-    std::unique_ptr<zmq::socket_t> subscriber_;     // Market data subscription
-    std::unique_ptr<zmq::socket_t> execution_sub_;  // Order execution subscription  
-    std::unique_ptr<zmq::socket_t> signal_pub_;     // Trading signal publisher
+    // Transports on the process ZeroMQ context
+    std::unique_ptr<IMessageSubscriber> subscriber_;     // Market data subscription
+    std::unique_ptr<IMessageSubscriber> execution_sub_;  // Order execution subscription
+    std::unique_ptr<IMessagePublisher> signal_pub_;      // Trading signal publisher
+    std::unique_ptr<MessageCapture> capture_;            // Tap on every subscriber (capture.enabled)
     
     // Processing control
     std::atomic<bool> running_;
     std::unique_ptr<std::thread> processing_thread_;
+    ConfigReloader config_reloader_;     // Strategy parameters retune without a restart
+    
+    // Control commands (strategy load/unload/parameters)
+    std::unique_ptr<IMessageSubscriber> control_sub_;
+    std::unique_ptr<std::thread> control_thread_;
     
     // Strategies
     std::vector<std::unique_ptr<Strategy>> strategies_;
     
+    // Runtime loads and unloads travel to the thread that owns a strategy
+    // list on a queue it drains between messages, so the lists are only ever
+    // touched by that thread. Loaded instances are passed as raw pointers
+    // the owner adopts.
+    struct StrategyChange {
+        Strategy* add;          // nullptr: remove remove_id
+        uint64_t remove_id;
+    };
+    static constexpr size_t STRATEGY_CHANGE_QUEUE_SIZE = 64;
+    using StrategyChangeQueue = SPSCQueue<StrategyChange, STRATEGY_CHANGE_QUEUE_SIZE>;
+    StrategyChangeQueue strategy_changes_;
+    
+    // Instances by strategy id (one per shard when sharded), for staging
+    // parameters; written before start() and then only by the control thread
+    std::unordered_map<uint64_t, std::vector<Strategy*>> strategy_registry_;
+    
+    // Symbol-sharded mode: symbol_id % shard count picks the worker, so each
+    // symbol is handled by one thread, in arrival order, by strategy
+    // instances only that thread touches. The receive thread is the only
+    // producer of a shard's inbound queues; the worker is the only producer
+    // of its signal queue, which the publisher thread drains onto signal_pub_.
+    static constexpr size_t SHARD_MARKET_DATA_QUEUE_SIZE = 4096;
+    static constexpr size_t SHARD_EXECUTION_QUEUE_SIZE = 1024;
+    static constexpr size_t SHARD_SIGNAL_QUEUE_SIZE = 1024;
+    
+    struct Shard {
+        size_t index = 0;
+        int cpu = -1;
+        std::vector<std::unique_ptr<Strategy>> strategies;
+        SPSCQueue<MarketData, SHARD_MARKET_DATA_QUEUE_SIZE> market_data;
+        SPSCQueue<OrderExecution, SHARD_EXECUTION_QUEUE_SIZE> executions;
+        SPSCQueue<TradingSignal, SHARD_SIGNAL_QUEUE_SIZE> signals;
+        StrategyChangeQueue strategy_changes;
+        std::thread thread;
+        WarmupReport warmup;        // Read by the last shard to finish warming up
+    };
+    
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<std::thread> publisher_thread_;
+    std::atomic<bool> publisher_running_;
+    std::atomic<uint64_t> shard_queue_full_;   // Enqueue retries due to a full queue
+    std::atomic<size_t> shards_warm_;
+    std::atomic<uint64_t> signal_channel_full_;  // Stage retries on a full gateway channel
+    
     // Statistics
     std::atomic<uint64_t> market_data_processed_;
     std::atomic<uint64_t> signals_generated_;
+    std::atomic<uint64_t> signals_killed_;      // Dropped while the kill switch is on
+    
+    // Emergency stop: send_signal() drops everything while it is on; the
+    // receive loop acknowledges each new word (kill_word_ is its own)
+    KillSwitch* kill_switch_ = &KillSwitch::instance();
+    uint64_t kill_word_ = 0;
+    
+    // Single producer: the receive thread, or the publisher thread when sharded
+    SignalChannel* signal_channel_;
+    std::string thread_prefix_;
     
     // Main processing loop
     void process_messages();
     
+    // Busy-poll variant: pinned, spins on recv(dontwait), hands strategies
+    // a reference into the received frame instead of a copy
+    void process_messages_busy_poll();
+    
+    void maybe_log_statistics(std::chrono::steady_clock::time_point& last_stats_time);
+    // One load per receive loop iteration
+    void check_kill_switch() {
+        uint64_t word = kill_switch_->word();
+        if (word != kill_word_) [[unlikely]] handle_kill_switch(word);
+    }
+    void handle_kill_switch(uint64_t word);
+    
+    // Control commands
+    void process_control_messages();
+    void handle_control_command(const ControlCommand& command);
+    bool send_strategy_change(StrategyChangeQueue& queue, const StrategyChange& change);
+    // Owner thread: adopts or removes strategies queued for `strategies`
+    void apply_strategy_changes(StrategyChangeQueue& queue, std::vector<std::unique_ptr<Strategy>>& strategies);
+    
+    // Replays synthetic ticks for the configured symbols through the
+    // strategies on the calling thread, signals dropped, then resets them
+    WarmupReport warm_up(std::vector<std::unique_ptr<Strategy>>& strategies);
+    void finish_warmup(const WarmupReport& report);
+    
     // Message handlers
     void handle_market_data(const MarketData& data);
     void handle_execution(const OrderExecution& execution);
     
+    // Sharded mode
+    void create_shards(size_t count);
+    Shard& shard_for(symbol_id_t symbol_id, const char* symbol);
+    void run_shard(Shard& shard);
+    void run_publisher();
+    void send_signal(const TradingSignal& signal);
+    // Makes staged fast-path signals visible to the gateway
+    void flush_signals();
+    
     // Performance monitoring
     void log_statistics();
     
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace hft {
+
+// Latest-value mailbox between one writer thread and one reader thread
+// (triple buffer). The writer fills its own buffer and swaps it with the
+// shared middle one; the reader swaps the middle one for its own only when
+// the writer has marked it fresh. Neither side waits or locks, the reader's
+// check is a single load when nothing changed, and a reader that falls
+// behind simply gets the newest set.
+template <typename T>
+class ParameterSlot {
+    static_assert(std::is_trivially_copyable_v<T>, "parameter sets are copied between buffers");
+
+public:
+    explicit ParameterSlot(const T& initial = T{}) {
+        for (auto& buffer : buffers_) buffer.value = initial;
+    }
+    ParameterSlot(const ParameterSlot&) = delete;
+    ParameterSlot& operator=(const ParameterSlot&) = delete;
+
+    // Writer
+    void publish(const T& value) {
+        buffers_[writer_.index].value = value;
+        uint8_t previous = middle_.exchange(writer_.index | FRESH, std::memory_order_acq_rel);
+        writer_.index = previous & INDEX;
+        ++writer_.published;
+    }
+
+    // Reader: copies the newest set into `out` if one arrived since the last take
+    bool take(T& out) {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t previous = middle_.exchange(reader_.index, std::memory_order_acq_rel);
+        reader_.index = previous & INDEX;
+        out = buffers_[reader_.index].value;
+        return true;
+    }
+
+    // Writer: sets published so far
+    uint64_t published() const { return writer_.published; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    struct alignas(64) Buffer {
+        T value;
+    };
+    struct alignas(64) Side {
+        uint8_t index;
+        uint64_t published = 0;
+    };
+
+    Buffer buffers_[3];
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    Side writer_{0};
+    Side reader_{2};
+};
+
+// One "key=value" of a runtime parameter update
+struct ParameterAssignment {
+    std::string key;
+    std::string value;
+};
+using ParameterAssignments = std::vector<ParameterAssignment>;
+
+// Splits "key=value" pairs separated by spaces, commas, semicolons or '&'
+// (so a query string parses too)
+inline bool parse_parameter_assignments(std::string_view text, ParameterAssignments& out, std::string& error) {
+    out.clear();
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find_first_of(" \t\r\n,;&", pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view token = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (token.empty()) continue;
+
+        size_t eq = token.find('=');
+        if (eq == 0 || eq == std::string_view::npos || eq + 1 == token.size()) {
+            error = "expected key=value, got '" + std::string(token) + "'";
+            return false;
+        }
+        out.push_back({std::string(token.substr(0, eq)), std::string(token.substr(eq + 1))});
+    }
+    return true;
+}
+
+// Removes `key` from the list into `value`; false if absent
+inline bool take_assignment(ParameterAssignments& assignments, const std::string& key, std::string& value) {
+    for (auto it = assignments.begin(); it != assignments.end(); ++it) {
+        if (it->key == key) {
+            value = std::move(it->value);
+            assignments.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// A finite number, or true/false for flags
+inline bool parse_parameter_value(const std::string& text, double& value) {
+    if (text == "true") { value = 1.0; return true; }
+    if (text == "false") { value = 0.0; return true; }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0' && std::isfinite(value);
+}
+
+inline uint32_t to_count(double value) {
+    return value <= 0.0 ? 0 : static_cast<uint32_t>(std::lround(value));
+}
+
+// A named strategy parameter, shared by the parameter sweep and runtime updates
+template <typename Params>
+struct ParameterField {
+    const char* name;
+    void (*apply)(Params&, double);
+    bool runtime = true;    // False for sizes fixed once per-symbol state exists
+};
+
+// A strategy's parameter set as the control thread sees it. stage() applies
+// assignments on top of the last staged set, validates the result and
+// publishes it; the strategy thread picks it up with apply() between ticks.
+template <typename Params>
+class TunableParameters {
+public:
+    using Validator = bool (*)(const Params&, std::string& error);
+
+    TunableParameters(const std::vector<ParameterField<Params>>& fields, Validator validate)
+        : fields_(fields), validate_(validate) {}
+
+    // Before the strategy runs: later updates start from these values
+    void reset(const Params& params) { staged_ = params; }
+
+    // Control thread
+    bool stage(const ParameterAssignments& assignments, std::string& error) {
+        Params next = staged_;
+        for (const auto& assignment : assignments) {
+            const ParameterField<Params>* field = find(assignment.key);
+            if (!field) {
+                error = "unknown parameter " + assignment.key;
+                return false;
+            }
+            if (!field->runtime) {
+                error = assignment.key + " is fixed while the strategy is loaded";
+                return false;
+            }
+            double value;
+            if (!parse_parameter_value(assignment.value, value)) {
+                error = "invalid value for " + assignment.key + ": " + assignment.value;
+                return false;
+            }
+            field->apply(next, value);
+        }
+        if (!validate_(next, error)) {
+            return false;
+        }
+        staged_ = next;
+        slot_.publish(next);
+        return true;
+    }
+
+    // Strategy thread: true if `live` was replaced
+    bool apply(Params& live) { return slot_.take(live); }
+
+    uint64_t updates() const { return slot_.published(); }
+
+private:
+    const ParameterField<Params>* find(const std::string& name) const {
+        for (const auto& field : fields_) {
+            if (name == field.name) return &field;
+        }
+        return nullptr;
+    }
+
+    const std::vector<ParameterField<Params>>& fields_;
+    Validator validate_;
+    Params staged_{};
+    ParameterSlot<Params> slot_;
+};
+
+} // namespace hft
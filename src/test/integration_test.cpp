@@ -137,7 +137,7 @@ private:
                         
                         std::string symbol(data.symbol);
                         symbol_counts_[symbol]++;
-                        last_prices_[symbol] = data.last_price;
+                        last_prices_[symbol] = to_double_price(data.last_price);
                         
                         market_data_received_++;
                         
@@ -175,7 +175,7 @@ private:
                         std::string action = (signal.action == SignalAction::BUY) ? "BUY" : "SELL";
                         
                         logger_.info("Signal: " + action + " " + std::to_string(signal.quantity) + 
-                                   " " + symbol + " @ " + std::to_string(signal.price));
+                                   " " + symbol + " @ " + std::to_string(to_double_price(signal.price)));
                     }
                 }
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -205,7 +205,7 @@ private:
                         std::string symbol(execution.symbol);
                         logger_.info("Execution: " + symbol + " " + 
                                    std::to_string(execution.fill_quantity) + 
-                                   " @ " + std::to_string(execution.fill_price));
+                                   " @ " + std::to_string(to_double_price(execution.fill_price)));
                     }
                 }
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
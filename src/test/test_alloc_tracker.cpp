@@ -0,0 +1,171 @@
+#include "../common/alloc_tracker.h"
+#include "../common/metrics_collector.h"
+#include <cassert>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft;
+
+namespace {
+
+// Stored so the compiler cannot drop an allocation nobody reads
+void* volatile g_sink = nullptr;
+
+void allocate(size_t size) {
+    g_sink = std::malloc(size);
+    std::free(g_sink);
+}
+
+void allocate_with_new() {
+    auto* value = new uint64_t(42);
+    g_sink = value;
+    delete value;
+}
+
+__attribute__((noinline)) uint64_t guarded_arithmetic(uint64_t value) {
+    HFT_NO_ALLOC_SCOPE("test_guarded_arithmetic");
+    for (int i = 0; i < 100; ++i) {
+        value = value * 6364136223846793005ULL + 1;
+    }
+    return value;
+}
+
+} // namespace
+
+void test_counts_per_thread() {
+    std::cout << "Testing per-thread allocation counts..." << std::endl;
+    static_assert(AllocTracker::enabled());
+
+    AllocTracker::Counts before = AllocTracker::current_thread();
+    allocate(100);
+    allocate_with_new();
+    AllocTracker::Counts after = AllocTracker::current_thread();
+    assert(after.allocations - before.allocations == 2);
+    assert(after.frees - before.frees == 2);
+    assert(after.bytes - before.bytes == 100 + sizeof(uint64_t));
+    assert(after.violations == before.violations);
+
+    // Another thread's allocations are its own, but count for the process
+    AllocTracker::Counts process_before = AllocTracker::process();
+    AllocTracker::Counts worker;
+    std::thread thread([&worker] {
+        for (int i = 0; i < 1000; ++i) allocate(16);
+        worker = AllocTracker::current_thread();
+    });
+    thread.join();
+    assert(worker.allocations >= 1000);
+    AllocTracker::Counts mine = AllocTracker::current_thread();
+    assert(AllocTracker::process().allocations - process_before.allocations >= 1000);
+    assert(mine.allocations - after.allocations < 1000);
+
+    std::cout << "✓ Per-thread count test passed" << std::endl;
+}
+
+void test_guard_records_violations() {
+    std::cout << "Testing NoAllocGuard violations..." << std::endl;
+
+    AllocTracker::set_action(AllocTracker::Action::RECORD);
+    uint64_t violations = AllocTracker::current_thread().violations;
+
+    // Allocation-free work inside a guard is fine
+    assert(guarded_arithmetic(1) != 0);
+    assert(AllocTracker::current_thread().violations == violations);
+
+    {
+        HFT_NO_ALLOC_SCOPE("test_outer");
+        {
+            HFT_NO_ALLOC_SCOPE("test_inner");
+            allocate(32);
+        }
+        allocate(32);   // Still inside the outer guard
+    }
+    assert(AllocTracker::current_thread().violations == violations + 2);
+
+    allocate(32);       // Outside every guard
+    assert(AllocTracker::current_thread().violations == violations + 2);
+
+    AllocTracker::set_action(AllocTracker::Action::IGNORE);
+    {
+        HFT_NO_ALLOC_SCOPE("test_ignored");
+        allocate(32);
+    }
+    assert(AllocTracker::current_thread().violations == violations + 2);
+    AllocTracker::set_action(AllocTracker::Action::RECORD);
+
+    std::cout << "✓ NoAllocGuard violation test passed" << std::endl;
+}
+
+void test_guard_aborts() {
+    std::cout << "Testing NoAllocGuard abort..." << std::endl;
+
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        AllocTracker::set_action(AllocTracker::Action::ABORT);
+        HFT_NO_ALLOC_SCOPE("test_abort");
+        allocate(64);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+
+    std::cout << "✓ NoAllocGuard abort test passed" << std::endl;
+}
+
+void test_parse_action() {
+    std::cout << "Testing profiler.alloc_guard values..." << std::endl;
+
+    assert(AllocTracker::parse_action("off") == AllocTracker::Action::IGNORE);
+    assert(AllocTracker::parse_action("record") == AllocTracker::Action::RECORD);
+    assert(AllocTracker::parse_action("abort") == AllocTracker::Action::ABORT);
+    assert(AllocTracker::parse_action("bogus") == AllocTracker::Action::RECORD);
+
+    std::cout << "✓ Action parsing test passed" << std::endl;
+}
+
+void test_publishes_thread_gauges() {
+    std::cout << "Testing per-thread allocation gauges..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    collector.clear();
+    collector.initialize();
+    pthread_setname_np(pthread_self(), "alloc_test");
+    allocate(8);
+    AllocTracker::publish_metrics();
+    collector.shutdown();
+
+    auto stats = collector.get_statistics();
+    assert(stats.count("thread.alloc_test.allocations_total") == 1);
+    assert(stats.count("thread.alloc_test.frees_total") == 1);
+    assert(stats.count("thread.alloc_test.allocated_bytes_total") == 1);
+    assert(stats.count("thread.alloc_test.alloc_guard_violations_total") == 1);
+    assert(stats.at("thread.alloc_test.allocations_total").sum > 0);
+
+    std::cout << "✓ Allocation gauge test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Allocation Tracker Unit Tests" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    try {
+        test_counts_per_thread();
+        test_guard_records_violations();
+        test_guard_aborts();
+        test_parse_action();
+        test_publishes_thread_gauges();
+
+        std::cout << "\n✅ All allocation tracker tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,335 @@
+#include "../order_gateway/alpaca_client.h"
+#include <json/json.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+// Plain-HTTP stand-in for the broker: keep-alive connections, each served
+// by its own thread, with every order answered after a fixed delay
+class FakeBroker {
+public:
+    explicit FakeBroker(std::chrono::milliseconds order_delay) : order_delay_(order_delay) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int yes = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        [[maybe_unused]] int result = ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        assert(result == 0);
+        result = ::listen(listen_fd_, 64);
+        assert(result == 0);
+        socklen_t length = sizeof(address);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~FakeBroker() {
+        running_.store(false);
+        acceptor_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& thread : connections_) {
+            thread.join();
+        }
+        ::close(listen_fd_);
+    }
+
+    std::string base_url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    int connections() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<int>(connections_.size());
+    }
+    int requests(const std::string& route) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_[route];
+    }
+    int max_concurrent_orders() const { return max_concurrent_.load(); }
+
+private:
+    std::chrono::milliseconds order_delay_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{true};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::vector<std::thread> connections_;
+    std::map<std::string, int> requests_;     // "METHOD path" -> count
+    std::atomic<int> concurrent_{0};
+    std::atomic<int> max_concurrent_{0};
+    std::atomic<int> next_order_{1};
+
+    // Waits for fd to be readable, giving up when the broker stops
+    bool wait_readable(int fd) {
+        pollfd entry{fd, POLLIN, 0};
+        while (running_.load()) {
+            if (::poll(&entry, 1, 20) > 0) return true;
+        }
+        return false;
+    }
+
+    void accept_loop() {
+        while (wait_readable(listen_fd_)) {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) continue;
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t head_end;
+            while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!wait_readable(fd)) { ::close(fd); return; }
+                ssize_t count = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (count <= 0) { ::close(fd); return; }
+                buffer.append(chunk, static_cast<size_t>(count));
+            }
+            std::string head = buffer.substr(0, head_end);
+            size_t body_length = 0;
+            std::string lower = head;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            size_t field = lower.find("content-length:");
+            if (field != std::string::npos) {
+                body_length = std::stoul(head.substr(field + 15));
+            }
+            while (buffer.size() < head_end + 4 + body_length) {
+                if (!wait_readable(fd)) { ::close(fd); return; }
+                ssize_t count = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (count <= 0) { ::close(fd); return; }
+                buffer.append(chunk, static_cast<size_t>(count));
+            }
+            std::string body = buffer.substr(head_end + 4, body_length);
+            buffer.erase(0, head_end + 4 + body_length);
+
+            std::istringstream request_line(head);
+            std::string method, path;
+            request_line >> method >> path;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_[method + " " + path]++;
+            }
+            std::string reply = respond(method, path, body);
+            ::send(fd, reply.data(), reply.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    std::string respond(const std::string& method, const std::string& path, const std::string& body) {
+        int status = 200;
+        Json::Value reply;
+        if (method == "GET" && path == "/v2/account") {
+            reply["id"] = "test-account";
+        } else if (method == "GET" && path == "/v2/clock") {
+            reply["is_open"] = true;
+        } else if (method == "DELETE" && path == "/v2/orders") {
+            status = 207;
+            reply = Json::Value(Json::arrayValue);
+        } else if (path.rfind("/v2/orders", 0) == 0) {
+            int now = ++concurrent_;
+            int seen = max_concurrent_.load();
+            while (now > seen && !max_concurrent_.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(order_delay_);
+            --concurrent_;
+
+            Json::Value order;
+            std::istringstream in(body);
+            Json::CharReaderBuilder builder;
+            std::string errors;
+            Json::parseFromStream(builder, in, &order, &errors);
+            if (order["symbol"].asString() == "DENY") {
+                status = 403;
+                reply["message"] = "insufficient buying power";
+            } else {
+                // A replace (PATCH /v2/orders/<id>) answers with the new order
+                reply["id"] = method == "PATCH" ? path.substr(11) + "-replaced"
+                                                : "broker-" + std::to_string(next_order_++);
+                reply["symbol"] = order["symbol"].asString();
+                reply["status"] = "filled";
+                reply["side"] = order["side"].asString();
+                reply["qty"] = std::to_string(order["qty"].asDouble());
+                reply["filled_qty"] = std::to_string(order["qty"].asDouble());
+                reply["filled_avg_price"] = order.isMember("limit_price") ? std::to_string(order["limit_price"].asDouble())
+                                                                          : "100.0";
+            }
+        } else {
+            status = 404;
+            reply["message"] = "not found";
+        }
+        std::string text = Json::writeString(Json::StreamWriterBuilder(), reply);
+        return "HTTP/1.1 " + std::to_string(status) + " X\r\nContent-Type: application/json\r\nContent-Length: " +
+               std::to_string(text.size()) + "\r\n\r\n" + text;
+    }
+};
+
+// Polls until count completions have run or the deadline passes
+std::map<uint64_t, AlpacaOrderResponse> wait_for_completions(AlpacaClient& client, size_t count) {
+    std::map<uint64_t, AlpacaOrderResponse> completed;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (completed.size() < count && std::chrono::steady_clock::now() < deadline) {
+        client.poll_completions([&completed](uint64_t order_id, const AlpacaOrderResponse& response) {
+            completed[order_id] = response;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return completed;
+}
+
+template<typename Predicate>
+bool wait_until(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+const char* const SYMBOLS[] = {"AAPL", "MSFT", "GOOGL", "AMZN"};
+
+} // namespace
+
+void test_requires_connection() {
+    std::cout << "Testing async entry before connecting..." << std::endl;
+
+    AlpacaClient client;
+    [[maybe_unused]] bool ok = client.submit_order_async(1, "AAPL", SignalAction::BUY, OrderType::MARKET, 10, 0.0);
+    assert(!ok);
+    ok = client.start_async(4);
+    assert(!ok);        // Not connected
+    assert(client.inflight_orders() == 0);
+    [[maybe_unused]] size_t drained = client.poll_completions([](uint64_t, const AlpacaOrderResponse&) { assert(false); });
+    assert(drained == 0);
+
+    std::cout << "✓ Unconnected async entry test passed" << std::endl;
+}
+
+void test_concurrent_orders() {
+    std::cout << "Testing concurrent orders over pooled connections..." << std::endl;
+
+    constexpr auto delay = std::chrono::milliseconds(200);
+    FakeBroker broker(delay);
+    AlpacaClient client;
+    [[maybe_unused]] bool ok = client.initialize("key", "secret", broker.base_url());
+    assert(ok);
+    [[maybe_unused]] int account_connections = broker.connections();     // initialize()'s own request
+    ok = client.start_async(4);
+    assert(ok);
+
+    // The pool's connections are opened before any order needs them
+    ok = wait_until([&broker] { return broker.requests("GET /v2/clock") == 4; });
+    assert(ok);
+    std::vector<int> connections;
+
+    for (int round = 0; round < 2; ++round) {
+        // Submitting never waits on the broker
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < 4; ++i) {
+            uint64_t order_id = round * 4 + i + 1;
+            ok = client.submit_order_async(order_id, SYMBOLS[i], SignalAction::BUY, OrderType::LIMIT,
+                                           10.0 * (i + 1), 100.0 + i);
+            assert(ok);
+        }
+        [[maybe_unused]] auto submitted = std::chrono::steady_clock::now() - start;
+        assert(submitted < delay / 4);
+        assert(client.inflight_orders() == 4);
+
+        // Four orders side by side take about one broker delay, not four
+        auto completed = wait_for_completions(client, 4);
+        [[maybe_unused]] auto elapsed = std::chrono::steady_clock::now() - start;
+        assert(completed.size() == 4);
+        assert(elapsed < delay * 3);
+        for (uint64_t i = 0; i < 4; ++i) {
+            [[maybe_unused]] const AlpacaOrderResponse& response = completed.at(round * 4 + i + 1);
+            assert(response.is_success() && response.is_filled());
+            assert(response.symbol == SYMBOLS[i]);
+            assert(response.fill_price == 100.0 + i);
+            assert(response.filled_qty == 10.0 * (i + 1));
+        }
+        assert(client.inflight_orders() == 0);
+        connections.push_back(broker.connections());
+    }
+    assert(broker.max_concurrent_orders() == 4);
+
+    // Kept alive: no more than the pool's connections, reused by the second round
+    assert(broker.requests("POST /v2/orders") == 8);
+    assert(connections[0] - account_connections <= 4);
+    assert(connections[1] == connections[0]);
+
+    client.stop_async();
+    std::cout << "✓ Concurrent order test passed" << std::endl;
+}
+
+void test_replace_cancel_and_reject() {
+    std::cout << "Testing async replace, cancel-all and rejection..." << std::endl;
+
+    FakeBroker broker(std::chrono::milliseconds(1));
+    AlpacaClient client;
+    [[maybe_unused]] bool ok = client.initialize("key", "secret", broker.base_url());
+    assert(ok);
+    ok = client.start_async(2);
+    assert(ok);
+
+    ok = client.submit_order_async(1, "DENY", SignalAction::SELL, OrderType::MARKET, 5, 0.0);
+    assert(ok);
+    ok = client.replace_order_async(2, "broker-7", 20, 101.5);
+    assert(ok);
+    ok = client.cancel_all_async();
+    assert(ok);
+
+    auto completed = wait_for_completions(client, 3);
+    assert(completed.size() == 3);
+    assert(completed.at(1).error_message == "insufficient buying power");
+    assert(completed.at(2).is_success());
+    assert(completed.at(2).order_id == "broker-7-replaced");
+    assert(completed.at(2).fill_price == 101.5);
+    assert(completed.at(0).is_success() && completed.at(0).order_id.empty());
+    assert(broker.requests("PATCH /v2/orders/broker-7") == 1);
+    assert(broker.requests("DELETE /v2/orders") == 1);
+
+    // Stopped: nothing more is accepted
+    client.stop_async();
+    ok = client.submit_order_async(3, "AAPL", SignalAction::BUY, OrderType::MARKET, 1, 0.0);
+    assert(!ok);
+
+    std::cout << "✓ Replace, cancel-all and rejection test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Alpaca Async Order Entry Unit Tests" << std::endl;
+    std::cout << "===========================================" << std::endl;
+
+    try {
+        test_requires_connection();
+        test_concurrent_orders();
+        test_replace_cancel_and_reject();
+
+        std::cout << "\n✅ All Alpaca async order entry tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,158 @@
+#include "../market_data_handler/alpaca_decoder.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+static bool decode(AlpacaDecoder& decoder, const std::string& frame, std::vector<AlpacaRecord>& batch) {
+    batch.clear();
+    return decoder.decode(frame.data(), frame.size(), batch);
+}
+
+void test_quotes_and_trades() {
+    std::cout << "Testing quote and trade frames..." << std::endl;
+
+    AlpacaDecoder decoder;
+    std::vector<AlpacaRecord> batch;
+    std::string frame =
+        R"([{"T":"q","S":"AAPL","bx":"U","bp":123.5,"bs":1,"ax":"Q","ap":123.55,"as":2,"c":["R"],"z":"C",)"
+        R"("t":"2021-02-22T15:51:44.208234521Z"},)"
+        R"( {"T":"t","i":52983525029461,"S":"MSFT","x":"V","p":236.105,"s":100,"c":["@","I"],"z":"C",)"
+        R"("t":"2021-02-22T15:51:44.5Z"}])";
+    [[maybe_unused]] bool ok = decode(decoder, frame, batch);
+    assert(ok);
+    assert(batch.size() == 2);
+
+    [[maybe_unused]] const AlpacaRecord& quote = batch[0];
+    assert(quote.type == AlpacaRecordType::QUOTE);
+    assert(std::strcmp(quote.symbol, "AAPL") == 0 && quote.symbol_length == 4);
+    assert(quote.bid_price == to_fixed_price(123.5) && quote.ask_price == to_fixed_price(123.55));
+    assert(quote.bid_size == 1 && quote.ask_size == 2);
+    assert(quote.timestamp_ns == 1614009104208234521ULL);
+
+    [[maybe_unused]] const AlpacaRecord& trade = batch[1];
+    assert(trade.type == AlpacaRecordType::TRADE);
+    assert(std::strcmp(trade.symbol, "MSFT") == 0);
+    assert(trade.price == to_fixed_price(236.105) && trade.size == 100);
+    assert(trade.timestamp_ns == 1614009104500000000ULL);
+
+    std::cout << "✓ Quote and trade test passed" << std::endl;
+}
+
+void test_bars_and_status() {
+    std::cout << "Testing bars and status messages..." << std::endl;
+
+    AlpacaDecoder decoder;
+    std::vector<AlpacaRecord> batch;
+    // A bar's "c" is its close, not a conditions list
+    [[maybe_unused]] bool ok = decode(decoder, R"([{"T":"b","S":"SPY","o":388.985,"h":389.13,"l":388.975,)"
+                                               R"("c":389.12,"v":49378,"t":"2021-02-22T19:15:00Z","n":461,)"
+                                               R"("vw":389.062639}])", batch);
+    assert(ok);
+    assert(batch.size() == 1 && batch[0].type == AlpacaRecordType::BAR);
+    assert(batch[0].price == to_fixed_price(389.12) && batch[0].size == 49378);
+    assert(batch[0].timestamp_ns == 1614021300000000000ULL);
+
+    // Status text points into the frame, so the frames outlive the checks
+    std::string authenticated = R"([{"T":"success","msg":"authenticated"}])";
+    ok = decode(decoder, authenticated, batch);
+    assert(ok);
+    assert(batch.size() == 1 && batch[0].type == AlpacaRecordType::STATUS);
+    assert(batch[0].kind == "success" && batch[0].text == "authenticated");
+    std::string error = R"({"T":"error","code":402,"msg":"auth \"failed\""})";
+    ok = decode(decoder, error, batch);
+    assert(ok);
+    assert(batch[0].kind == "error" && batch[0].text == R"(auth \"failed\")");
+    std::string subscription = R"([{"T":"subscription","trades":["AAPL"],"quotes":[],"bars":[]}])";
+    ok = decode(decoder, subscription, batch);
+    assert(ok);
+    assert(batch[0].kind == "subscription" && batch[0].text.empty());
+
+    std::cout << "✓ Bar and status test passed" << std::endl;
+}
+
+void test_numbers() {
+    std::cout << "Testing price and size parsing..." << std::endl;
+
+    AlpacaDecoder decoder;
+    std::vector<AlpacaRecord> batch;
+    [[maybe_unused]] auto trade_price = [&](const std::string& price) {
+        [[maybe_unused]] bool decoded = decode(decoder, R"({"T":"t","S":"X","p":)" + price + R"(,"s":1})", batch);
+        assert(decoded);
+        return batch[0].price;
+    };
+    assert(trade_price("100") == 100 * PRICE_SCALE);
+    assert(trade_price("0.0001") == 1);
+    assert(trade_price("12.34564") == to_fixed_price(12.3456));
+    assert(trade_price("12.34565") == to_fixed_price(12.3457));
+    assert(trade_price("9.99999") == 10 * PRICE_SCALE);
+    assert(trade_price("1.5e2") == 150 * PRICE_SCALE);
+
+    // Fractional sizes keep whole shares
+    [[maybe_unused]] bool ok = decode(decoder, R"({"T":"t","S":"X","p":1,"s":12.75})", batch);
+    assert(ok);
+    assert(batch[0].size == 12);
+
+    assert(parse_alpaca_timestamp("1970-01-01T00:00:00Z") == 0);
+    assert(parse_alpaca_timestamp("2024-02-29T12:00:00.000000001Z") == 1709208000000000001ULL);
+    assert(parse_alpaca_timestamp("2024-02-29 12:00:00Z") == 0);
+    assert(parse_alpaca_timestamp("2024-02-29T12:00:00+00:00") == 0);
+
+    std::cout << "✓ Number parsing test passed" << std::endl;
+}
+
+void test_malformed_frames() {
+    std::cout << "Testing malformed frames..." << std::endl;
+
+    AlpacaDecoder decoder;
+    std::vector<AlpacaRecord> batch;
+    [[maybe_unused]] bool ok = decode(decoder, "[]", batch);
+    assert(ok && batch.empty());
+    ok = decode(decoder, "", batch);
+    assert(!ok);
+    ok = decode(decoder, "not json", batch);
+    assert(!ok);
+    ok = decode(decoder, R"([{"T":"q","S":"AAPL","bp":})", batch);
+    assert(!ok);
+    ok = decode(decoder, R"([{"T":"q","S":"AAPL"}] trailing)", batch);
+    assert(!ok);
+
+    // Good messages before a fault survive it
+    ok = decode(decoder, R"([{"T":"t","S":"A","p":1,"s":1},{"T":"t","S":"B","p":)", batch);
+    assert(!ok);
+    assert(batch.size() == 1 && std::strcmp(batch[0].symbol, "A") == 0);
+
+    // Unknown members of any shape are skipped
+    ok = decode(decoder, R"([{"T":"t","S":"A","extra":{"nested":[1,{"x":null}],"flag":true},"p":2,"s":3}])", batch);
+    assert(ok);
+    assert(batch.size() == 1 && batch[0].price == 2 * PRICE_SCALE && batch[0].size == 3);
+
+    // Symbols that do not fit are dropped, not truncated
+    ok = decode(decoder, R"([{"T":"t","S":"ABCDEFGHIJKLMNOPQ","p":1,"s":1},{"T":"t","p":1,"s":1}])", batch);
+    assert(ok);
+    assert(batch.empty() && decoder.skipped() == 2);
+
+    std::cout << "✓ Malformed frame test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Alpaca Decoder Unit Tests" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try {
+        test_quotes_and_trades();
+        test_bars_and_status();
+        test_numbers();
+        test_malformed_frames();
+
+        std::cout << "\n✅ All Alpaca decoder tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
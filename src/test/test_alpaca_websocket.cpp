@@ -91,9 +91,9 @@ private:
         // Log every 10th message to avoid spam
         if (messages_received_.load() % 10 == 1) {
             std::cout << "   📈 Market Data: " << data.symbol 
-                      << " bid=" << data.bid_price 
-                      << " ask=" << data.ask_price 
-                      << " last=" << data.last_price << std::endl;
+                      << " bid=" << to_double_price(data.bid_price) 
+                      << " ask=" << to_double_price(data.ask_price) 
+                      << " last=" << to_double_price(data.last_price) << std::endl;
         }
     }
     
@@ -2,13 +2,22 @@
 #include "../backtesting/historical_data_player.h"
 #include "../backtesting/fill_simulator.h"
 #include "../backtesting/data_downloader.h"
+#include "../backtesting/tick_store.h"
+#include "../backtesting/backtest_engine.h"
+#include "../backtesting/backtest_analytics.h"
+#include "../backtesting/parameter_sweep.h"
+#include "../backtesting/bar_screen.h"
 #include "../common/static_config.h"
 #include "../common/logging.h"
+#include <algorithm>
 #include <fstream>
 #include <thread>
 #include <chrono>
 #include <filesystem>
 #include <cmath>
+#include <map>
+#include <random>
+#include <tuple>
 
 class BacktestingFrameworkTest : public ::testing::Test {
 protected:
@@ -130,9 +139,9 @@ TEST_F(BacktestingFrameworkTest, FillSimulatorBasicFunctionality) {
     hft::MarketData market_data{};
     market_data.header = hft::MessageFactory::create_header(hft::MessageType::MARKET_DATA, sizeof(hft::MarketData));
     strncpy(market_data.symbol, "TESTSTOCK", sizeof(market_data.symbol) - 1);
-    market_data.bid_price = 149.99;
-    market_data.ask_price = 150.01;
-    market_data.last_price = 150.00;
+    market_data.bid_price = hft::to_fixed_price(149.99);
+    market_data.ask_price = hft::to_fixed_price(150.01);
+    market_data.last_price = hft::to_fixed_price(150.00);
     market_data.bid_size = 1000;
     market_data.ask_size = 1000;
     
@@ -164,6 +173,65 @@ TEST_F(BacktestingFrameworkTest, FillSimulatorBasicFunctionality) {
     EXPECT_GT(simulator.get_total_fills(), 0);
 }
 
+TEST_F(BacktestingFrameworkTest, FillSimulatorQueuePosition) {
+    hft::FillSimulator simulator;
+    hft::FillConfig config;
+    config.model = hft::FillModel::QUEUE_POSITION;
+    config.random_seed = 1;
+    config.log_orders = false;
+    ASSERT_TRUE(simulator.initialize(config));
+    
+    hft::SimulationClock clock;
+    clock.reset(hft::timestamp_t(1000000));
+    simulator.set_clock(&clock);
+    
+    std::vector<hft::OrderExecution> fills;
+    simulator.set_fill_callback([&fills](const hft::OrderExecution& execution) { fills.push_back(execution); });
+    
+    auto book = [&simulator](hft::BookSide side, hft::BookUpdateType type, double price, uint32_t size) {
+        simulator.update_order_book(hft::OrderBookFactory::create_level_update(
+            "QUEUE", side, type, hft::to_fixed_price(price), size));
+    };
+    auto trade = [&simulator](double price, uint32_t size) {
+        simulator.update_market_state(hft::MessageFactory::create_market_data(
+            "QUEUE", 100.00, 100.02, 400, 300, price, size));
+    };
+    
+    book(hft::BookSide::BID, hft::BookUpdateType::ADD, 100.00, 500);
+    book(hft::BookSide::ASK, hft::BookUpdateType::ADD, 100.02, 300);
+    trade(100.01, 0);
+    
+    // Joins the back of the bid: the 500 displayed is ahead of it
+    simulator.submit_order(1, "QUEUE", hft::SignalAction::BUY, hft::OrderType::LIMIT, 100.00, 200);
+    EXPECT_EQ(simulator.get_queue_ahead(1), 500);
+    
+    // Cancels without a print are assumed to come from behind
+    book(hft::BookSide::BID, hft::BookUpdateType::UPDATE, 100.00, 400);
+    EXPECT_EQ(simulator.get_queue_ahead(1), 400);
+    
+    trade(100.00, 300);
+    simulator.process_pending_fills();
+    EXPECT_EQ(simulator.get_queue_ahead(1), 100);
+    EXPECT_TRUE(fills.empty());
+    
+    // 100 clears the queue ahead, the other 150 fills us
+    trade(100.00, 250);
+    simulator.process_pending_fills();
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].exec_type, hft::ExecutionType::PARTIAL_FILL);
+    EXPECT_EQ(fills[0].fill_quantity, 150);
+    EXPECT_EQ(fills[0].fill_price, hft::to_fixed_price(100.00));
+    EXPECT_EQ(fills[0].remaining_quantity, 50);
+    
+    // A print below the bid trades through the whole level
+    trade(99.99, 10);
+    simulator.process_pending_fills();
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[1].exec_type, hft::ExecutionType::FILL);
+    EXPECT_EQ(fills[1].fill_quantity, 50);
+    EXPECT_FALSE(simulator.has_pending_orders());
+}
+
 TEST_F(BacktestingFrameworkTest, DataDownloaderValidation) {
     hft::DataDownloader downloader;
     EXPECT_TRUE(downloader.initialize());
@@ -190,6 +258,731 @@ TEST_F(BacktestingFrameworkTest, DataDownloaderValidation) {
     EXPECT_GT(validation_result.total_points, 0);
 }
 
+TEST_F(BacktestingFrameworkTest, StreamingValidationFindsProblemsInParallel) {
+    // Minute bars: a gap of two, a duplicate, a row out of order, a crossed quote, a bad line
+    std::string flawed = test_data_dir_ + "/flawed.csv";
+    {
+        std::ofstream file(flawed);
+        file << "timestamp,symbol,open,high,low,close,volume,bid,ask\n";
+        uint64_t base = 1672756200000;      // 2023-01-03 14:30 UTC
+        file << base << ",AAPL,130,131,129,130.5,100,130.4,130.6\n";
+        file << base + 60000 << ",AAPL,130,131,129,130.5,100,130.4,130.6\n";
+        file << base + 4 * 60000 << ",AAPL,130,131,129,130.5,100,130.4,130.6\n";
+        file << base + 4 * 60000 << ",AAPL,130,131,129,130.5,100,130.4,130.6\n";
+        file << base + 2 * 60000 << ",AAPL,130,131,129,130.5,100,130.4,130.6\n";
+        file << base + 5 * 60000 << ",AAPL,130,131,129,130.5,100,130.7,130.6\n";
+        file << base << ",MSFT,250,251,249,250.5,100,250.4,250.6\n";
+        file << "garbage,line\n";
+        file << base + 24ULL * 60 * 60 * 1000 << ",MSFT,250,251,249,250.5,100,250.4,250.6\n";
+    }
+    
+    hft::DataDownloader downloader;
+    auto results = downloader.validate_data_files({test_csv_file_, flawed, test_data_dir_ + "/missing.csv"}, 2);
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_TRUE(results[0].valid);
+    EXPECT_EQ(results[0].missing_points, 0);
+    
+    const hft::ValidationResult& result = results[1];
+    EXPECT_FALSE(result.valid);
+    EXPECT_EQ(result.total_points, 8);
+    EXPECT_EQ(result.duplicate_points, 1);
+    EXPECT_EQ(result.out_of_order_points, 1);
+    EXPECT_EQ(result.crossed_quotes, 1);
+    EXPECT_EQ(result.malformed_rows, 1);
+    EXPECT_EQ(result.missing_points, 2);       // The overnight MSFT step is not a gap
+    EXPECT_EQ(result.time_range, "2023-01-03 to 2023-01-04");
+    EXPECT_NE(result.error_message.find("Crossed"), std::string::npos);
+    
+    EXPECT_FALSE(results[2].valid);
+    EXPECT_FALSE(results[2].error_message.empty());
+}
+
+TEST_F(BacktestingFrameworkTest, MergeStreamsFilesIntoTickStore) {
+    // A second symbol, written newest first, and a row duplicating the first file
+    std::string other = test_data_dir_ + "/other.csv";
+    {
+        std::ofstream file(other);
+        file << "timestamp,symbol,open,high,low,close,volume,bid,ask\n";
+        for (int i = 49; i >= 0; --i) {
+            file << 1640995200000ULL + i * 2000 << ",OTHER,10,11,9,10.5,50,10.4,10.6\n";
+        }
+        file << 1640995200000ULL << ",TESTSTOCK,1,1,1,1,1,1,1\n";
+    }
+    
+    hft::DataDownloader downloader;
+    std::string tick_file = test_data_dir_ + "/merged.tick";
+    ASSERT_TRUE(downloader.merge_data_files({test_csv_file_, other}, tick_file, 2));
+    EXPECT_FALSE(std::filesystem::exists(tick_file + ".parts"));
+    
+    hft::TickStoreReader reader;
+    ASSERT_TRUE(reader.open(tick_file));
+    ASSERT_EQ(reader.size(), 150);
+    for (size_t i = 1; i < reader.size(); ++i) {
+        EXPECT_LE(reader.record(i - 1).timestamp, reader.record(i).timestamp);
+    }
+    const hft::TickStoreSymbol* other_symbol = reader.find_symbol("OTHER");
+    ASSERT_NE(other_symbol, nullptr);
+    EXPECT_EQ(other_symbol->postings_count, 50);
+    const hft::TickStoreSymbol* test_symbol = reader.find_symbol("TESTSTOCK");
+    ASSERT_NE(test_symbol, nullptr);
+    EXPECT_EQ(test_symbol->postings_count, 100);
+    EXPECT_NEAR(reader.to_data_point(reader.record(reader.postings(*test_symbol)[0])).last_price, 150.0, 1e-4);
+    
+    // CSV out is the same merge, streamed back as rows
+    std::string csv_file = test_data_dir_ + "/merged.csv";
+    ASSERT_TRUE(downloader.merge_data_files({other, test_csv_file_}, csv_file));
+    auto validation = downloader.validate_data_file(csv_file);
+    EXPECT_TRUE(validation.valid);
+    EXPECT_EQ(validation.total_points, 150);
+    EXPECT_EQ(validation.duplicate_points, 0);
+    EXPECT_EQ(validation.out_of_order_points, 0);
+    EXPECT_FALSE(std::filesystem::exists(csv_file + ".tick"));
+}
+
+TEST_F(BacktestingFrameworkTest, TickStoreConversionAndSeek) {
+    hft::DataDownloader downloader;
+    std::string tick_file = test_data_dir_ + "/test_data.tick";
+    ASSERT_TRUE(downloader.convert_data_format(test_csv_file_, tick_file, "csv", "tick"));
+    ASSERT_TRUE(hft::TickStoreReader::is_tick_store(tick_file));
+    EXPECT_FALSE(hft::TickStoreReader::is_tick_store(test_csv_file_));
+    
+    hft::TickStoreReader reader;
+    ASSERT_TRUE(reader.open(tick_file));
+    ASSERT_EQ(reader.size(), 100);
+    EXPECT_EQ(reader.header()->symbol_count, 1);
+    EXPECT_EQ(reader.header()->first_timestamp, 1640995200000ULL);
+    
+    // Prices survive the fixed-point round trip
+    hft::HistoricalDataPoint first = reader.to_data_point(reader.record(0));
+    EXPECT_STREQ(first.symbol, "TESTSTOCK");
+    EXPECT_NEAR(first.last_price, 150.0, 1e-4);
+    EXPECT_NEAR(first.bid_price, 149.99, 1e-4);
+    EXPECT_EQ(first.total_volume, 1000);
+    
+    // Time and per-symbol seeks are binary searches over the index
+    EXPECT_EQ(reader.lower_bound(1640995205000), 5);
+    EXPECT_EQ(reader.upper_bound(1640995210000), 11);
+    const hft::TickStoreSymbol* symbol = reader.find_symbol("TESTSTOCK");
+    ASSERT_NE(symbol, nullptr);
+    EXPECT_EQ(symbol->postings_count, 100);
+    EXPECT_EQ(reader.symbol_lower_bound(*symbol, 1640995250000), 50);
+    EXPECT_EQ(reader.find_symbol("MISSING"), nullptr);
+    
+    // The player streams the mapped file instead of parsing it
+    hft::HistoricalDataPlayer player;
+    ASSERT_TRUE(player.load_data_file(tick_file));
+    EXPECT_TRUE(player.is_memory_mapped());
+    EXPECT_EQ(player.get_total_data_points(), 100);
+    EXPECT_TRUE(player.set_symbol_filter("TESTSTOCK"));
+    EXPECT_FALSE(player.set_symbol_filter("MISSING"));
+}
+
+TEST_F(BacktestingFrameworkTest, TickRunsResumeAndMerge) {
+    auto record_at = [](uint64_t timestamp, double price) {
+        hft::TickRecord record{};
+        record.timestamp = timestamp;
+        record.last_price = hft::to_fixed_price(price);
+        record.total_volume = 100;
+        return record;
+    };
+    uint64_t base = 1640995200000;
+    std::string msft_early = test_data_dir_ + "/MSFT_a.run";
+    std::string msft_late = test_data_dir_ + "/MSFT_b.run";
+    std::string aapl = test_data_dir_ + "/AAPL.run";
+    
+    // Two chunks of one symbol, one of which overlaps the other by a record
+    hft::TickRunWriter run;
+    ASSERT_TRUE(run.open(msft_early, "MSFT"));
+    for (int i = 0; i < 5; ++i) ASSERT_TRUE(run.append(record_at(base + i * 60000, 300.0 + i)));
+    ASSERT_TRUE(run.close());
+    ASSERT_TRUE(run.open(msft_late, "MSFT"));
+    for (int i = 4; i < 8; ++i) ASSERT_TRUE(run.append(record_at(base + i * 60000, 300.0 + i)));
+    ASSERT_TRUE(run.close());
+    
+    // A run killed mid-record reopens at its last whole record
+    ASSERT_TRUE(run.open(aapl, "AAPL"));
+    for (int i = 0; i < 3; ++i) ASSERT_TRUE(run.append(record_at(base + i * 60000, 150.0 + i)));
+    ASSERT_TRUE(run.close());
+    std::filesystem::resize_file(aapl, std::filesystem::file_size(aapl) - 10);
+    ASSERT_TRUE(run.open(aapl, "AAPL"));
+    EXPECT_EQ(run.records(), 2);
+    EXPECT_EQ(run.last_timestamp(), base + 60000);
+    ASSERT_TRUE(run.append(record_at(base + 2 * 60000, 152.0)));
+    ASSERT_TRUE(run.close());
+    EXPECT_FALSE(run.open(aapl, "MSFT"));
+    
+    std::string tick_file = test_data_dir_ + "/merged.tick";
+    ASSERT_TRUE(hft::TickStoreWriter::merge(tick_file, {msft_late, aapl, msft_early}));
+    hft::TickStoreReader reader;
+    ASSERT_TRUE(reader.open(tick_file));
+    ASSERT_EQ(reader.size(), 11);
+    EXPECT_EQ(reader.header()->first_timestamp, base);
+    EXPECT_EQ(reader.header()->last_timestamp, base + 7 * 60000);
+    
+    // Time order, ties broken by symbol name
+    for (size_t i = 1; i < reader.size(); ++i) {
+        EXPECT_LE(reader.record(i - 1).timestamp, reader.record(i).timestamp);
+    }
+    EXPECT_STREQ(reader.symbol_name(reader.record(0).symbol_index), "AAPL");
+    EXPECT_STREQ(reader.symbol_name(reader.record(1).symbol_index), "MSFT");
+    
+    const hft::TickStoreSymbol* msft = reader.find_symbol("MSFT");
+    ASSERT_NE(msft, nullptr);
+    EXPECT_EQ(msft->postings_count, 8);
+    EXPECT_EQ(msft->last_timestamp, base + 7 * 60000);
+    const uint64_t* postings = reader.postings(*msft);
+    for (size_t i = 0; i < msft->postings_count; ++i) {
+        EXPECT_NEAR(reader.to_data_point(reader.record(postings[i])).last_price, 300.0 + i, 1e-4);
+    }
+    const hft::TickStoreSymbol* apple = reader.find_symbol("AAPL");
+    ASSERT_NE(apple, nullptr);
+    EXPECT_EQ(apple->postings_count, 3);
+    EXPECT_EQ(reader.symbol_lower_bound(*apple, base + 60000), 1);
+}
+
+TEST_F(BacktestingFrameworkTest, BulkDownloadChunksAndPages) {
+    uint64_t start = 1672531200000;     // 2023-01-01
+    uint64_t end = start + 25ULL * 24 * 60 * 60 * 1000;
+    auto chunks = hft::DataDownloader::plan_chunks({"AAPL", "MSFT"}, hft::TimeInterval::MINUTE_1,
+                                                   start, end, 0, "parts");
+    ASSERT_EQ(chunks.size(), 6);
+    EXPECT_EQ(chunks[0].symbol, "AAPL");
+    EXPECT_EQ(chunks[0].start_ms, start);
+    EXPECT_EQ(chunks[2].end_ms, end);
+    EXPECT_EQ(chunks[1].start_ms, chunks[0].end_ms);
+    EXPECT_EQ(chunks[3].run_path, "parts/MSFT_1min_20230101");
+    EXPECT_EQ(hft::DataDownloader::plan_chunks({"AAPL"}, hft::TimeInterval::DAY_1, start, end, 0, "parts").size(), 1);
+    
+    // Alpaca bars pages decode straight into a run
+    std::string run_file = test_data_dir_ + "/AAPL.run";
+    hft::TickRunWriter run;
+    ASSERT_TRUE(run.open(run_file, "AAPL"));
+    std::string token;
+    std::string page =
+        R"({"bars":[{"t":"2023-01-03T14:30:00Z","o":130.28,"h":130.9,"l":130.1,"c":130.5,"v":1200,"n":40,"vw":130.4},)"
+        R"({"t":"2023-01-03T14:31:00Z","o":130.5,"h":130.6,"l":130.2,"c":130.25,"v":800}],)"
+        R"("symbol":"AAPL","next_page_token":"QUFQTHxNfDE2NzI3NTYyNjAwMDAwMDAwMDA="})";
+    EXPECT_EQ(hft::DataDownloader::decode_alpaca_bars(page, run, token), 2);
+    EXPECT_EQ(token, "QUFQTHxNfDE2NzI3NTYyNjAwMDAwMDAwMDA=");
+    EXPECT_EQ(hft::DataDownloader::decode_alpaca_bars(R"({"bars":null,"symbol":"AAPL","next_page_token":null})", run, token), 0);
+    EXPECT_TRUE(token.empty());
+    EXPECT_EQ(hft::DataDownloader::decode_alpaca_bars(R"({"message":"forbidden"})", run, token), -1);
+    EXPECT_EQ(hft::DataDownloader::decode_alpaca_bars("not json", run, token), -1);
+    EXPECT_EQ(run.last_timestamp(), 1672756260000ULL);
+    ASSERT_TRUE(run.close());
+    
+    std::string tick_file = test_data_dir_ + "/AAPL.tick";
+    ASSERT_TRUE(hft::TickStoreWriter::merge(tick_file, {run_file}));
+    hft::TickStoreReader reader;
+    ASSERT_TRUE(reader.open(tick_file));
+    ASSERT_EQ(reader.size(), 2);
+    hft::HistoricalDataPoint first = reader.to_data_point(reader.record(0));
+    EXPECT_EQ(first.timestamp, 1672756200000ULL);
+    EXPECT_NEAR(first.open_price, 130.28, 1e-4);
+    EXPECT_NEAR(first.last_price, 130.5, 1e-4);
+    EXPECT_NEAR(first.bid_price, 130.5 * 0.999, 1e-3);
+    EXPECT_EQ(first.total_volume, 1200);
+}
+
+// Emits one market order per tick so the run exercises signal -> fill routing
+class EveryTickStrategy : public hft::OrderBookStrategy {
+public:
+    explicit EveryTickStrategy(uint64_t strategy_id = 7) : OrderBookStrategy(strategy_id, "EveryTick") {}
+    
+    bool initialize() override { return true; }
+    void on_market_data(const hft::MarketData& data) override {
+        emit_signal(hft::MessageFactory::create_trading_signal(
+            data.symbol, hft::SignalAction::BUY, hft::OrderType::MARKET, 0.0, 10, strategy_id_, 1.0));
+    }
+    void on_order_book_update(const hft::OrderBookUpdate&) override { book_updates++; }
+    void on_execution(const hft::OrderExecution& execution) override {
+        fill_times.push_back(execution.header.timestamp.count());
+    }
+    bool stage_parameters(const hft::ParameterAssignments&, std::string& error) override {
+        error = "EveryTick has no parameters";
+        return false;
+    }
+    bool apply_staged_parameters() override { return false; }
+
+    const hft::OrderBookManager& view() const { return books(); }
+    
+    uint64_t book_updates = 0;
+    std::vector<int64_t> fill_times;
+};
+
+TEST_F(BacktestingFrameworkTest, EventDrivenEngineIsDeterministic) {
+    auto run_once = [this](std::vector<int64_t>& fill_times) {
+        hft::FillConfig config;
+        config.model = hft::FillModel::LATENCY_AWARE;
+        config.random_seed = 42;
+        config.log_orders = false;
+        
+        hft::BacktestEngine engine;
+        EXPECT_TRUE(engine.initialize(config));
+        EXPECT_TRUE(engine.load_data_file(test_csv_file_));
+        auto strategy = std::make_unique<EveryTickStrategy>();
+        EveryTickStrategy* raw = strategy.get();
+        engine.add_strategy(std::move(strategy));
+        
+        hft::BacktestStats stats = engine.run();
+        EXPECT_EQ(stats.ticks, 100);
+        EXPECT_EQ(stats.orders, 100);
+        EXPECT_EQ(stats.fills, 100);
+        EXPECT_GT(raw->book_updates, 0);
+        
+        // Logical time comes from the data, not the wall clock
+        EXPECT_EQ(stats.first_tick_time.count(), 1640995200000LL * 1000000);
+        EXPECT_EQ(stats.last_tick_time.count(), 1640995299000LL * 1000000);
+        fill_times = raw->fill_times;
+    };
+    
+    std::vector<int64_t> first_run, second_run;
+    run_once(first_run);
+    run_once(second_run);
+    ASSERT_EQ(first_run.size(), 100);
+    EXPECT_EQ(first_run, second_run);
+    EXPECT_GE(first_run.front(), 1640995200000LL * 1000000);
+}
+
+TEST_F(BacktestingFrameworkTest, RepeatedRunsStartFromScratch) {
+    hft::FillConfig config;
+    config.model = hft::FillModel::LATENCY_AWARE;
+    config.random_seed = 42;
+    config.log_orders = false;
+    
+    hft::BacktestEngine engine;
+    ASSERT_TRUE(engine.initialize(config));
+    ASSERT_TRUE(engine.load_data_file(test_csv_file_));
+    auto strategy = std::make_unique<EveryTickStrategy>();
+    EveryTickStrategy* raw = strategy.get();
+    engine.add_strategy(std::move(strategy));
+    hft::TickSeries ticks = engine.decode_ticks();
+    
+    hft::BacktestStats first = engine.run(ticks);
+    uint64_t first_updates = raw->book_updates;
+    hft::BacktestStats second = engine.run(ticks);
+    
+    // Same books, orders and fills as a fresh engine, not a continuation
+    EXPECT_EQ(raw->book_updates, 2 * first_updates);
+    EXPECT_EQ(second.orders, first.orders);
+    EXPECT_EQ(second.fills, first.fills);
+    EXPECT_DOUBLE_EQ(second.commission, first.commission);
+    EXPECT_DOUBLE_EQ(second.net_pnl, first.net_pnl);
+    EXPECT_EQ(engine.fill_simulator().get_total_fills(), second.fills);
+    ASSERT_EQ(raw->fill_times.size(), 2 * first.fills);
+    EXPECT_TRUE(std::equal(raw->fill_times.begin(), raw->fill_times.begin() + first.fills,
+                           raw->fill_times.begin() + first.fills));
+}
+
+TEST_F(BacktestingFrameworkTest, FillSimulatorDrawsAreKeyedByOrder) {
+    // Random123's known-answer vectors for Philox4x32-10
+    using Counter = hft::Philox4x32::Counter;
+    EXPECT_EQ(hft::Philox4x32::generate({0, 0, 0, 0}, {0, 0}),
+              (Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(hft::Philox4x32::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Counter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(hft::Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+    // Each order's latency, slippage and partial fills are its own: the
+    // same IDs fill identically whatever else is submitted around them
+    auto simulate = [](const std::vector<uint64_t>& order_ids) {
+        hft::FillSimulator simulator;
+        hft::FillConfig config;
+        config.model = hft::FillModel::PARTIAL_FILLS;
+        config.partial_fill_probability = 0.5;
+        config.random_seed = 11;
+        config.log_orders = false;
+        EXPECT_TRUE(simulator.initialize(config));
+        hft::SimulationClock clock;
+        clock.reset(hft::timestamp_t(1000000000));
+        simulator.set_clock(&clock);
+
+        std::map<uint64_t, std::vector<std::tuple<int64_t, int64_t, uint32_t>>> fills;
+        simulator.set_fill_callback([&fills](const hft::OrderExecution& execution) {
+            fills[execution.order_id].emplace_back(execution.header.timestamp.count(), execution.fill_price,
+                                                   execution.fill_quantity);
+        });
+        auto quote = hft::MessageFactory::create_market_data("KEYED", 100.00, 100.02, 500, 500, 100.01, 0);
+        simulator.update_market_state(quote);
+        for (uint64_t id : order_ids) {
+            simulator.submit_order(id, "KEYED", id % 2 ? hft::SignalAction::BUY : hft::SignalAction::SELL,
+                                   hft::OrderType::MARKET, 0.0, 100);
+        }
+        for (int step = 1; step <= 20; ++step) {
+            clock.advance_to(hft::timestamp_t(1000000000 + step * 100000000LL));
+            simulator.process_pending_fills();
+            simulator.update_market_state(quote);
+        }
+        return fills;
+    };
+
+    auto alone = simulate({1, 2, 3, 4, 5, 6, 7, 8});
+    auto mixed = simulate({8, 50, 7, 6, 51, 5, 4, 3, 52, 2, 1});
+    ASSERT_EQ(alone.size(), 8);
+    bool partial = false;
+    for (const auto& [id, order_fills] : alone) {
+        EXPECT_EQ(order_fills, mixed[id]) << "order " << id;
+        partial = partial || order_fills.size() > 1;
+    }
+    EXPECT_TRUE(partial);
+
+    // Engines on any number of threads reproduce a single run bit for bit
+    hft::BacktestEngine loader;
+    ASSERT_TRUE(loader.load_data_file(test_csv_file_));
+    hft::TickSeries ticks = loader.decode_ticks();
+    auto run = [&ticks]() {
+        hft::FillConfig config;
+        config.model = hft::FillModel::PARTIAL_FILLS;
+        config.random_seed = 5;
+        config.log_orders = false;
+        hft::BacktestEngine engine;
+        EXPECT_TRUE(engine.initialize(config));
+        engine.add_strategy(std::make_unique<EveryTickStrategy>());
+        return engine.run(ticks);
+    };
+    hft::BacktestStats expected = run();
+    std::vector<hft::BacktestStats> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+        threads.emplace_back([&result, &run]() { result = run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& result : results) {
+        EXPECT_EQ(result.fills, expected.fills);
+        EXPECT_EQ(result.filled_quantity, expected.filled_quantity);
+        EXPECT_EQ(result.net_pnl, expected.net_pnl);
+    }
+}
+
+TEST_F(BacktestingFrameworkTest, StreamingAnalyticsTrackEquityAndAttribution) {
+    // Buy 100 at 10, sell half at 12 above the 11 mark, then the mid drops to 9
+    hft::BacktestAnalytics analytics;
+    analytics.on_mark("AAA", 10.0, 0);
+    analytics.on_order(100);
+    analytics.on_fill("AAA", 100, 10.0, 1.0);
+    analytics.on_mark("AAA", 11.0, 1000000000);
+    analytics.on_order(100);
+    analytics.on_fill("AAA", -50, 12.0, 1.0);
+    analytics.on_mark("AAA", 9.0, 2000000000);
+    analytics.finish(2000000000);
+
+    const hft::AnalyticsSummary& summary = analytics.summary();
+    EXPECT_DOUBLE_EQ(summary.final_equity, 48.0);
+    EXPECT_DOUBLE_EQ(summary.peak_equity, 148.0);
+    EXPECT_DOUBLE_EQ(summary.max_drawdown, 100.0);
+    EXPECT_DOUBLE_EQ(summary.fill_rate, 0.75);
+    EXPECT_DOUBLE_EQ(summary.traded_notional, 1600.0);
+    EXPECT_EQ(summary.samples, 3);
+    EXPECT_GT(summary.sharpe, 0.0);
+    EXPECT_GT(summary.sortino, summary.sharpe);
+
+    const hft::EquityCurve& curve = analytics.curve();
+    ASSERT_EQ(curve.size(), 3);
+    EXPECT_EQ(curve.equity, std::vector<double>({0.0, 99.0, 48.0}));
+    EXPECT_DOUBLE_EQ(curve.drawdown.back(), 100.0);
+    EXPECT_DOUBLE_EQ(curve.gross_exposure.back(), 450.0);
+
+    hft::SymbolAttribution table = analytics.attribution();
+    ASSERT_EQ(table.size(), 1);
+    EXPECT_EQ(table.position[0], 50);
+    EXPECT_DOUBLE_EQ(table.realized_pnl[0], 100.0);
+    EXPECT_DOUBLE_EQ(table.unrealized_pnl[0], -50.0);
+    EXPECT_DOUBLE_EQ(table.commission[0], 2.0);
+
+    // In the engine: same P&L as its stats, with or without the curve
+    auto run = [this](bool record_curve) {
+        hft::FillConfig config;
+        config.random_seed = 3;
+        config.log_orders = false;
+        config.commission_per_share = 0.01;
+        hft::BacktestEngine engine;
+        EXPECT_TRUE(engine.initialize(config));
+        EXPECT_TRUE(engine.load_data_file(test_csv_file_));
+        hft::AnalyticsConfig analytics_config;
+        analytics_config.sample_interval_ms = 5000;
+        analytics_config.record_curve = record_curve;
+        engine.set_analytics_config(analytics_config);
+        engine.add_strategy(std::make_unique<EveryTickStrategy>());
+        hft::BacktestStats stats = engine.run();
+
+        const hft::BacktestAnalytics& result = engine.analytics();
+        EXPECT_NEAR(result.summary().final_equity, stats.net_pnl, 1e-6);
+        EXPECT_EQ(result.summary().filled_quantity, stats.filled_quantity);
+        EXPECT_EQ(result.summary().ordered_quantity, 1000);
+        EXPECT_EQ(result.curve().size(), record_curve ? result.summary().samples : 0);
+
+        hft::SymbolAttribution symbols = result.attribution();
+        EXPECT_EQ(symbols.size(), 1);
+        double attributed = 0.0;
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            attributed += symbols.realized_pnl[i] + symbols.unrealized_pnl[i] - symbols.commission[i];
+        }
+        EXPECT_NEAR(attributed, stats.net_pnl, 1e-6);
+        return result.summary();
+    };
+    hft::AnalyticsSummary with_curve = run(true);
+    hft::AnalyticsSummary without_curve = run(false);
+    EXPECT_GE(with_curve.samples, 20);
+    EXPECT_DOUBLE_EQ(with_curve.sharpe, without_curve.sharpe);
+    EXPECT_DOUBLE_EQ(with_curve.max_drawdown, without_curve.max_drawdown);
+
+    std::string curve_file = test_data_dir_ + "/equity.csv";
+    hft::BacktestAnalytics written;
+    written.on_mark("AAA", 10.0, 0);
+    written.finish(0);
+    ASSERT_TRUE(written.write_curve_csv(curve_file));
+    std::ifstream file(curve_file);
+    std::string header;
+    std::getline(file, header);
+    EXPECT_EQ(header, "time_ns,equity,drawdown,gross_exposure");
+}
+
+TEST_F(BacktestingFrameworkTest, ParameterSweepRanksGridAcrossThreads) {
+    hft::ParameterRange range;
+    EXPECT_FALSE(hft::ParameterSweep::parse_range("signal_size", range));
+    EXPECT_FALSE(hft::ParameterSweep::parse_range("signal_size=1:x", range));
+    ASSERT_TRUE(hft::ParameterSweep::parse_range("signal_size=100:300:100", range));
+    EXPECT_EQ(range.grid_values(), std::vector<double>({100.0, 200.0, 300.0}));
+    
+    hft::SweepConfig config;
+    config.strategy = hft::StrategyType::STAT_ARB;
+    config.fill_config.random_seed = 7;
+    config.fill_config.log_orders = false;
+    config.ranges.push_back(range);
+    ASSERT_TRUE(hft::ParameterSweep::parse_range("imbalance_threshold=0.1:0.3:0.1", range));
+    config.ranges.push_back(range);
+    
+    hft::ParameterSweep sweep;
+    ASSERT_TRUE(sweep.load_data_file(test_csv_file_));
+    EXPECT_EQ(sweep.tick_count(), 100);
+    
+    config.threads = 4;
+    std::vector<hft::SweepTrial> parallel = sweep.run(config);
+    ASSERT_EQ(parallel.size(), 9);
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        EXPECT_TRUE(parallel[i].completed);
+        EXPECT_EQ(parallel[i].stats.ticks, 100);
+        if (i > 0) {
+            EXPECT_GE(parallel[i - 1].stats.net_pnl, parallel[i].stats.net_pnl);
+        }
+    }
+    
+    // Trials are independent, so the thread count can't change the ranking
+    config.threads = 1;
+    std::vector<hft::SweepTrial> serial = sweep.run(config);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(serial[i].trial_id, parallel[i].trial_id);
+        EXPECT_DOUBLE_EQ(serial[i].stats.net_pnl, parallel[i].stats.net_pnl);
+    }
+    
+    config.ranges.push_back({"not_a_parameter", 1.0, 1.0, 0.0});
+    EXPECT_TRUE(sweep.run(config).empty());
+}
+
+TEST_F(BacktestingFrameworkTest, BarScreenMatchesEngineSignals) {
+    // Two symbols of minute bars on a random walk, so quotes move most bars
+    std::string bars_file = test_data_dir_ + "/bars.csv";
+    {
+        std::ofstream file(bars_file);
+        file << "timestamp,symbol,open,high,low,close,volume,bid,ask\n";
+        std::mt19937 rng(5);
+        std::normal_distribution<double> step(0.0, 0.05);
+        double price[2] = {150.0, 40.0};
+        const char* names[2] = {"BARSA", "BARSB"};
+        for (int i = 0; i < 400; ++i) {
+            for (int s = 0; s < 2; ++s) {
+                price[s] = std::round((price[s] + step(rng)) * 100.0) / 100.0;
+                double spread = 0.01 * (1 + i % 3);
+                file << 1640995200000ULL + i * 60000ULL << "," << names[s] << ","
+                     << price[s] << "," << price[s] + 0.05 << "," << price[s] - 0.05 << "," << price[s] << ","
+                     << 1000 + 10 * (i % 7) << "," << price[s] - spread << "," << price[s] + spread << "\n";
+            }
+        }
+    }
+    hft::BacktestEngine loader;
+    ASSERT_TRUE(loader.load_data_file(bars_file));
+    auto ticks = std::make_shared<const hft::TickSeries>(loader.decode_ticks());
+    ASSERT_EQ(ticks->size(), 800);
+    
+    hft::BarScreen screen;
+    screen.set_ticks(ticks);
+    EXPECT_FALSE(hft::BarScreen::supports(hft::StrategyType::MARKET_MAKING));
+    
+    struct Case {
+        hft::StrategyType type;
+        hft::ParameterValues values;
+    };
+    std::vector<Case> cases = {
+        {hft::StrategyType::ENHANCED_MOMENTUM, {{"momentum_threshold", 0.0005}, {"flow_threshold", 0.1}, {"momentum_window", 5}}},
+        {hft::StrategyType::ENHANCED_MOMENTUM, {{"momentum_threshold", 0.001}, {"flow_threshold", 0.2},
+                                                {"momentum_window", 12}, {"max_signal_multiplier", 2.0}}},
+        {hft::StrategyType::STAT_ARB, {{"price_threshold", 0.5}, {"imbalance_threshold", 0.2},
+                                       {"lookback_periods", 10}, {"min_signal_interval_ms", 120000}}},
+        {hft::StrategyType::STAT_ARB, {{"price_threshold", 1.0}, {"imbalance_threshold", 0.5},
+                                       {"lookback_periods", 20}, {"min_signal_interval_ms", 0}}},
+    };
+    
+    // Same signals, orders and fills as the engine; only prices differ,
+    // since the engine randomizes spreads and slippage
+    for (hft::FillModel model : {hft::FillModel::IMMEDIATE, hft::FillModel::REALISTIC_SLIPPAGE}) {
+        hft::FillConfig config;
+        config.model = model;
+        config.random_seed = 9;
+        config.log_orders = false;
+        config.commission_per_share = 0.005;
+        config.minimum_commission = 1.0;
+        for (const auto& c : cases) {
+            auto scored = screen.score(c.type, {c.values}, config);
+            ASSERT_EQ(scored.size(), 1);
+            ASSERT_TRUE(scored[0].completed);
+            
+            hft::BacktestEngine engine;
+            ASSERT_TRUE(engine.initialize(config));
+            engine.add_strategy(hft::ParameterSweep::create_strategy(c.type, 1, c.values));
+            hft::BacktestStats expected = engine.run(*ticks);
+            
+            const hft::BacktestStats& stats = scored[0].stats;
+            EXPECT_GT(expected.orders, 0);
+            EXPECT_EQ(stats.ticks, expected.ticks);
+            EXPECT_EQ(stats.orders, expected.orders);
+            EXPECT_EQ(stats.fills, expected.fills);
+            EXPECT_EQ(stats.filled_quantity, expected.filled_quantity);
+            EXPECT_NEAR(stats.commission, expected.commission, 1e-6);
+            EXPECT_TRUE(std::isfinite(stats.net_pnl));
+        }
+    }
+    
+    // A set scores the same alone as in a lane beside thousands of others
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> threshold(0.0, 2.0);
+    std::uniform_int_distribution<int> window(2, 30);
+    std::vector<hft::ParameterValues> sets;
+    for (int i = 0; i < 3000; ++i) {
+        sets.push_back({{"price_threshold", threshold(rng)}, {"imbalance_threshold", threshold(rng) / 2},
+                        {"lookback_periods", double(window(rng))}});
+    }
+    sets.push_back({{"lookback_periods", 0.0}});
+    sets.push_back({{"not_a_parameter", 1.0}});
+    hft::FillConfig config;
+    config.log_orders = false;
+    auto scored = screen.score(hft::StrategyType::STAT_ARB, sets, config, 4);
+    ASSERT_EQ(scored.size(), sets.size());
+    EXPECT_FALSE(scored[3000].completed);
+    EXPECT_FALSE(scored[3001].completed);
+    for (size_t i : {0, 1, 2, 777, 2999}) {
+        auto alone = screen.score(hft::StrategyType::STAT_ARB, {sets[i]}, config);
+        ASSERT_TRUE(scored[i].completed);
+        EXPECT_EQ(scored[i].stats.orders, alone[0].stats.orders);
+        EXPECT_DOUBLE_EQ(scored[i].stats.net_pnl, alone[0].stats.net_pnl);
+    }
+    
+    // Screened sweep: only the screen's best go through the engine
+    hft::SweepConfig sweep_config;
+    sweep_config.strategy = hft::StrategyType::STAT_ARB;
+    sweep_config.fill_config = config;
+    sweep_config.screen_top = 3;
+    hft::ParameterRange range;
+    ASSERT_TRUE(hft::ParameterSweep::parse_range("price_threshold=0.25:1.5:0.25", range));
+    sweep_config.ranges.push_back(range);
+    ASSERT_TRUE(hft::ParameterSweep::parse_range("lookback_periods=10:20:10", range));
+    sweep_config.ranges.push_back(range);
+    
+    hft::ParameterSweep sweep;
+    sweep.set_ticks(ticks);
+    std::vector<hft::SweepTrial> results = sweep.run(sweep_config);
+    ASSERT_EQ(results.size(), 3);
+    
+    std::vector<hft::ParameterValues> grid;
+    for (double p = 0.25; p <= 1.5 + 1e-9; p += 0.25) {
+        for (double lookback : {10.0, 20.0}) {
+            grid.push_back({{"price_threshold", p}, {"lookback_periods", lookback}});
+        }
+    }
+    auto grid_scores = screen.score(hft::StrategyType::STAT_ARB, grid, config);
+    std::vector<double> screen_pnl;
+    for (const auto& score : grid_scores) screen_pnl.push_back(score.stats.net_pnl);
+    std::sort(screen_pnl.rbegin(), screen_pnl.rend());
+    for (const auto& trial : results) {
+        EXPECT_TRUE(trial.completed && trial.screened);
+        EXPECT_DOUBLE_EQ(trial.screen.net_pnl, grid_scores[trial.trial_id].stats.net_pnl);
+        EXPECT_GE(trial.screen.net_pnl, screen_pnl[2]);
+    }
+}
+
+TEST_F(BacktestingFrameworkTest, StaticStrategySetMatchesVirtualDispatch) {
+    hft::FillConfig config;
+    config.model = hft::FillModel::LATENCY_AWARE;
+    config.random_seed = 11;
+    config.log_orders = false;
+
+    hft::BacktestEngine loader;
+    ASSERT_TRUE(loader.load_data_file(test_csv_file_));
+    hft::TickSeries ticks = loader.decode_ticks();
+
+    hft::BacktestEngine virtual_engine;
+    ASSERT_TRUE(virtual_engine.initialize(config));
+    virtual_engine.add_strategy(std::make_unique<EveryTickStrategy>());
+    virtual_engine.add_strategy(std::make_unique<hft::StatArbStrategy>(2));
+    hft::BacktestStats expected = virtual_engine.run(ticks);
+
+    hft::StaticStrategySet<EveryTickStrategy, hft::StatArbStrategy> strategies(7, 2);
+    hft::BacktestEngine static_engine;
+    ASSERT_TRUE(static_engine.initialize(config));
+    hft::BacktestStats stats = static_engine.run(strategies, ticks);
+
+    EXPECT_EQ(stats.ticks, expected.ticks);
+    EXPECT_EQ(stats.signals, expected.signals);
+    EXPECT_EQ(stats.fills, expected.fills);
+    EXPECT_DOUBLE_EQ(stats.net_pnl, expected.net_pnl);
+    EXPECT_GT(strategies.get<EveryTickStrategy>().book_updates, 0);
+    EXPECT_EQ(strategies.get<0>().fill_times.size(), 100);
+}
+
+TEST_F(BacktestingFrameworkTest, StrategiesShareEngineBooks) {
+    hft::FillConfig config;
+    config.random_seed = 3;
+    config.log_orders = false;
+
+    hft::BacktestEngine loader;
+    ASSERT_TRUE(loader.load_data_file(test_csv_file_));
+    hft::TickSeries ticks = loader.decode_ticks();
+
+    // Signals from a StatArb strategy that keeps its own books
+    hft::BacktestEngine solo_engine;
+    ASSERT_TRUE(solo_engine.initialize(config));
+    solo_engine.add_strategy(std::make_unique<hft::StatArbStrategy>(2));
+    hft::BacktestStats solo = solo_engine.run(ticks);
+
+    hft::BacktestEngine engine;
+    ASSERT_TRUE(engine.initialize(config));
+    auto first = std::make_unique<EveryTickStrategy>(7);
+    auto second = std::make_unique<EveryTickStrategy>(8);
+    EveryTickStrategy* a = first.get();
+    EveryTickStrategy* b = second.get();
+    EXPECT_FALSE(a->uses_shared_books());
+    engine.add_strategy(std::move(first));
+    engine.add_strategy(std::move(second));
+    engine.add_strategy(std::make_unique<hft::StatArbStrategy>(2));
+    hft::BacktestStats stats = engine.run(ticks);
+
+    // Both read the engine's books, which neither strategy updated itself
+    EXPECT_TRUE(a->uses_shared_books());
+    EXPECT_EQ(&a->view(), &engine.order_books());
+    EXPECT_EQ(&b->view(), &engine.order_books());
+    EXPECT_EQ(engine.order_books().get_book_count(), 1);
+    const hft::IOrderBook* book = engine.order_books().get_book(std::string("TESTSTOCK"));
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->get_last_sequence(), a->book_updates);
+    EXPECT_GT(book->get_best_bid(), 0.0);
+
+    // StatArb sees the same book it would have built on its own
+    EXPECT_EQ(stats.signals - 2 * stats.ticks, solo.signals);
+}
+
 TEST_F(BacktestingFrameworkTest, IntegratedBacktestingWorkflow) {
     // This test simulates a complete backtesting workflow
     
@@ -234,9 +1027,9 @@ TEST_F(BacktestingFrameworkTest, IntegratedBacktestingWorkflow) {
         hft::MarketData test_market{};
         test_market.header = hft::MessageFactory::create_header(hft::MessageType::MARKET_DATA, sizeof(hft::MarketData));
         strncpy(test_market.symbol, "TESTSTOCK", sizeof(test_market.symbol) - 1);
-        test_market.bid_price = 150.00 + i * 0.01;
-        test_market.ask_price = 150.02 + i * 0.01;
-        test_market.last_price = 150.01 + i * 0.01;
+        test_market.bid_price = hft::to_fixed_price(150.00 + i * 0.01);
+        test_market.ask_price = hft::to_fixed_price(150.02 + i * 0.01);
+        test_market.last_price = hft::to_fixed_price(150.01 + i * 0.01);
         test_market.bid_size = 1000;
         test_market.ask_size = 1000;
         
@@ -244,7 +1037,7 @@ TEST_F(BacktestingFrameworkTest, IntegratedBacktestingWorkflow) {
         
         // Submit buy order
         simulator.submit_order(i + 1, "TESTSTOCK", hft::SignalAction::BUY, 
-                              hft::OrderType::MARKET, test_market.ask_price, 50);
+                              hft::OrderType::MARKET, hft::to_double_price(test_market.ask_price), 50);
         
         // Process fills
         simulator.process_pending_fills();
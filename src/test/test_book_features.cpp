@@ -0,0 +1,204 @@
+#include "../common/book_features.h"
+#include "../common/book_replay.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+[[maybe_unused]] bool close(double expected, double actual) {
+    return std::abs(expected - actual) <= 1e-9 * std::max(1.0, std::abs(expected));
+}
+
+std::vector<const BookKernels*> available_kernels() {
+    std::vector<const BookKernels*> kernels{&scalar_book_kernels()};
+    if (avx2_book_kernels()) kernels.push_back(avx2_book_kernels());
+    if (avx512_book_kernels()) kernels.push_back(avx512_book_kernels());
+    return kernels;
+}
+
+} // namespace
+
+void test_kernels_match_scalar() {
+    std::cout << "Testing vector kernels against scalar..." << std::endl;
+
+    const BookKernels& scalar = scalar_book_kernels();
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> lots(0, 50);
+
+    // Lengths that exercise full vectors and every tail
+    for (size_t n : {1, 3, 4, 7, 8, 9, 15, 16, 17, 33}) {
+        std::vector<double> price(n), size(n), other(n);
+        for (size_t i = 0; i < n; ++i) {
+            price[i] = 500.0 - 0.01 * static_cast<double>(i);
+            size[i] = lots(rng) * 100.0;
+            other[i] = lots(rng) * 100.0;
+        }
+        std::vector<double> depth(n), notional(n), other_depth(n), other_notional(n), imbalance(n);
+        scalar.accumulate(price.data(), size.data(), depth.data(), notional.data(), n);
+        scalar.accumulate(price.data(), other.data(), other_depth.data(), other_notional.data(), n);
+        scalar.imbalance(depth.data(), other_depth.data(), imbalance.data(), n);
+
+        for (const BookKernels* kernels : available_kernels()) {
+            std::vector<double> d(n), v(n), imb(n);
+            kernels->accumulate(price.data(), size.data(), d.data(), v.data(), n);
+            kernels->imbalance(depth.data(), other_depth.data(), imb.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                assert(d[i] == depth[i]);   // Whole share counts sum exactly
+                assert(close(notional[i], v[i]));
+                assert(imb[i] == imbalance[i]);
+            }
+            for ([[maybe_unused]] double target : {0.0, 1.0, depth[n - 1] / 2, depth[n - 1], depth[n - 1] + 1}) {
+                assert(kernels->first_reaching(depth.data(), n, target) ==
+                       scalar.first_reaching(depth.data(), n, target));
+            }
+        }
+    }
+
+    // Empty levels on both sides give 0, not NaN
+    double zeros[16] = {};
+    for (const BookKernels* kernels : available_kernels()) {
+        double out[16];
+        kernels->imbalance(zeros, zeros, out, 16);
+        for ([[maybe_unused]] double value : out) assert(value == 0.0);
+    }
+
+    std::cout << "  active kernels: " << active_book_kernels().name << std::endl;
+    std::cout << "✓ Kernel test passed" << std::endl;
+}
+
+void test_features_match_book_queries() {
+    std::cout << "Testing features against book queries..." << std::endl;
+
+    for (size_t depth : {3, 10, 60}) {
+        BookStreamConfig config;
+        config.depth = depth;
+        config.updates = 5000;
+        config.seed = depth;
+        BookStream stream = generate_book_stream(config);
+
+        OrderBook map_book(config.symbol);
+        LadderOrderBook ladder_book(config.symbol, config.tick_size, 8192);
+        for (size_t i = 0; i < stream.updates.size(); ++i) {
+            map_book.apply_update(stream.updates[i]);
+            ladder_book.apply_update(stream.updates[i]);
+            if (i < stream.seed_updates || i % 7 != 0) continue;
+
+            for (const IOrderBook* book : {static_cast<const IOrderBook*>(&map_book),
+                                           static_cast<const IOrderBook*>(&ladder_book)}) {
+                const BookFeatures& f = book->features();
+                assert(f.version == book->get_version());
+                assert(f.mid == book->get_mid_price());
+                assert(f.spread == book->get_spread());
+                assert(f.best_bid == book->get_best_bid() && f.best_ask == book->get_best_ask());
+
+                for ([[maybe_unused]] size_t levels : {1, 5, 16}) {
+                    assert(f.depth(BookSide::BID, levels) == book->get_total_size(BookSide::BID, levels));
+                    assert(f.depth(BookSide::ASK, levels) == book->get_total_size(BookSide::ASK, levels));
+                }
+                for (BookSide side : {BookSide::BID, BookSide::ASK}) {
+                    for (uint32_t shares : {1u, 100u, 1000u, 5000u, 1000000u}) {
+                        if (!f.covers(side, shares)) continue;
+                        assert(close(book->get_volume_weighted_price(side, shares), f.vwap(side, shares)));
+                    }
+                }
+
+                [[maybe_unused]] double bid = book->get_bid_size_at_level(0);
+                [[maybe_unused]] double ask = book->get_ask_size_at_level(0);
+                assert(f.depth_imbalance(1) == (bid - ask) / (bid + ask));
+                assert(close((f.best_bid * ask + f.best_ask * bid) / (bid + ask), f.microprice));
+                assert(f.microprice >= f.best_bid && f.microprice <= f.best_ask);
+            }
+        }
+    }
+
+    std::cout << "✓ Feature consistency test passed" << std::endl;
+}
+
+void test_features_cached_per_version() {
+    std::cout << "Testing feature cache invalidation..." << std::endl;
+
+    OrderBook book("CACHE");
+    [[maybe_unused]] const BookFeatures& empty = book.features();
+    assert(empty.bid_levels == 0 && empty.mid == 0.0 && empty.microprice == 0.0);
+    assert(book.get_bid_ask_imbalance() == 0.0);
+
+    book.apply_update(OrderBookFactory::create_level_update("CACHE", BookSide::BID, BookUpdateType::ADD,
+                                                            to_fixed_price(100.00), 300, 1));
+    book.apply_update(OrderBookFactory::create_level_update("CACHE", BookSide::ASK, BookUpdateType::ADD,
+                                                            to_fixed_price(100.02), 100, 2));
+    [[maybe_unused]] const BookFeatures* first = &book.features();
+    assert(first->version == 2 && first->bid_levels == 1 && first->ask_levels == 1);
+    assert(std::abs(first->mid - 100.01) < 1e-9);
+    assert(std::abs(first->microprice - 100.015) < 1e-9);   // Leans toward the thin ask
+    assert(book.get_bid_ask_imbalance() == 0.5);
+
+    // Same object, refreshed only after a change
+    assert(&book.features() == first && book.features().version == 2);
+    book.apply_update(OrderBookFactory::create_level_update("CACHE", BookSide::ASK, BookUpdateType::ADD,
+                                                            to_fixed_price(100.03), 500, 3));
+    assert(&book.features() == first && first->version == 3);
+    assert(first->ask_levels == 2 && first->depth(BookSide::ASK, 2) == 600.0);
+    assert(std::abs(first->vwap(BookSide::ASK, 200) - 100.025) < 1e-9);
+    assert(std::abs(book.get_market_impact(BookSide::ASK, 200) - (100.025 - 100.02) / 100.02) < 1e-12);
+
+    // Rejected updates leave the version alone
+    book.apply_update(OrderBookFactory::create_level_update("CACHE", BookSide::ASK, BookUpdateType::DELETE,
+                                                            to_fixed_price(100.03), 0, 3));
+    assert(book.get_version() == 3 && first->ask_levels == 2);
+
+    [[maybe_unused]] bool applied = book.apply_snapshot({OrderBookLevel(to_fixed_price(99.00), 100, 1)}, {}, 10);
+    assert(applied);
+    assert(book.features().version == 4 && first->ask_levels == 0 && first->mid == 0.0);
+
+    std::cout << "✓ Cache test passed" << std::endl;
+}
+
+void test_deep_orders_fall_back_to_book() {
+    std::cout << "Testing orders deeper than the cached levels..." << std::endl;
+
+    OrderBook book("DEEP");
+    uint64_t sequence = 0;
+    for (size_t i = 0; i < 40; ++i) {
+        book.apply_update(OrderBookFactory::create_level_update(
+            "DEEP", BookSide::ASK, BookUpdateType::ADD, to_fixed_price(50.00) + static_cast<price_t>(i) * DEFAULT_TICK,
+            100, ++sequence));
+    }
+    book.apply_update(OrderBookFactory::create_level_update("DEEP", BookSide::BID, BookUpdateType::ADD,
+                                                            to_fixed_price(49.99), 100, ++sequence));
+
+    [[maybe_unused]] const BookFeatures& f = book.features();
+    assert(f.ask_levels == BookFeatures::LEVELS && f.ask_truncated && !f.bid_truncated);
+    assert(f.covers(BookSide::ASK, 1600) && !f.covers(BookSide::ASK, 1601));
+    assert(f.covers(BookSide::BID, 1000000));   // Nothing beyond what was captured
+
+    // Past the cached levels get_market_impact walks the whole book
+    [[maybe_unused]] double vwap = book.get_volume_weighted_price(BookSide::ASK, 3000);
+    assert(std::abs(book.get_market_impact(BookSide::ASK, 3000) - (vwap - 50.00) / 50.00) < 1e-12);
+    assert(f.vwap(BookSide::ASK, 3000) < vwap);
+
+    std::cout << "✓ Fallback test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Book Features Unit Tests" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try {
+        test_kernels_match_scalar();
+        test_features_match_book_queries();
+        test_features_cached_per_version();
+        test_deep_orders_fall_back_to_book();
+
+        std::cout << "\n✅ All book features tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,182 @@
+#include "../common/static_config.h"
+#include "../common/config_reloader.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace hft;
+
+namespace {
+
+std::string temp_config_path() {
+    return "/tmp/hft_test_config_" + std::to_string(getpid()) + ".conf";
+}
+
+void write_config(const std::string& path, int quantity, double notional, const std::string& extra = "") {
+    std::ofstream out(path, std::ios::trunc);
+    out << "# test config\n";
+    out << "risk.max_order_quantity=" << quantity << "\n";
+    out << "risk.max_order_notional=" << notional << "\n";
+    out << "logger.endpoint=tcp://localhost:" << (6000 + quantity % 1000) << "\n";
+    out << extra;
+}
+
+} // namespace
+
+void test_defaults_before_load() {
+    std::cout << "Testing compile-time defaults..." << std::endl;
+
+    assert(StaticConfig::get_config_generation() == 0);
+    assert(StaticConfig::get_max_order_quantity() == StaticConfig::MAX_ORDER_QUANTITY);
+    assert(std::string(StaticConfig::get_logger_endpoint()) == StaticConfig::LOGGER_ENDPOINT);
+    assert(StaticConfig::validate_config());
+
+    std::cout << "✓ Defaults test passed" << std::endl;
+}
+
+void test_load_publishes_snapshot() {
+    std::cout << "Testing load publishes a new snapshot..." << std::endl;
+
+    std::string path = temp_config_path();
+    write_config(path, 300, 30000.0, "strategy.momentum.threshold=0.002\n");
+
+    StaticConfig::Snapshot before;
+    uint64_t generation = StaticConfig::get_config_generation();
+    [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+    assert(loaded);
+    assert(StaticConfig::get_config_generation() == generation + 1);
+    assert(StaticConfig::get_max_order_quantity() == 300);
+    assert(StaticConfig::get_momentum_threshold() == 0.002);
+    assert(std::string(StaticConfig::get_logger_endpoint()) == "tcp://localhost:6300");
+    assert(StaticConfig::runtime().source_path == path);
+
+    // A guard taken earlier still sees the load it started in
+    assert(before->generation == generation);
+    assert(before->max_order_quantity == StaticConfig::MAX_ORDER_QUANTITY);
+
+    // Keys absent from the next file keep their values; endpoints stay valid
+    write_config(path, 400, 40000.0);
+    loaded = StaticConfig::load_from_file(path.c_str());
+    assert(loaded);
+    assert(StaticConfig::get_momentum_threshold() == 0.002);
+    assert(std::string(StaticConfig::get_logger_endpoint()) == "tcp://localhost:6400");
+    assert(StaticConfig::get_retired_config_count() >= 1);
+
+    // A reload reads the same file again, not the default one
+    write_config(path, 450, 45000.0);
+    loaded = StaticConfig::reload();
+    assert(loaded);
+    assert(StaticConfig::get_max_order_quantity() == 450);
+    assert(StaticConfig::runtime().source_path == path);
+
+    std::remove(path.c_str());
+    std::cout << "✓ Snapshot publish test passed" << std::endl;
+}
+
+void test_invalid_file_keeps_current() {
+    std::cout << "Testing invalid file is rejected..." << std::endl;
+
+    std::string path = temp_config_path();
+    write_config(path, 500, 50000.0, "risk.max_daily_loss=-1\n");
+
+    uint64_t generation = StaticConfig::get_config_generation();
+    int quantity = StaticConfig::get_max_order_quantity();
+    [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+    assert(!loaded);
+    assert(StaticConfig::get_config_generation() == generation);
+    assert(StaticConfig::get_max_order_quantity() == quantity);
+    assert(StaticConfig::get_max_daily_loss() > 0.0);
+
+    std::remove(path.c_str());
+    std::cout << "✓ Invalid file test passed" << std::endl;
+}
+
+void test_readers_never_tear() {
+    std::cout << "Testing concurrent readers during reloads..." << std::endl;
+
+    // Every file keeps notional == quantity * 100; a torn read would break it
+    std::string path = temp_config_path();
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                StaticConfig::Snapshot config;
+                assert(config->max_order_notional == config->max_order_quantity * 100.0);
+                StaticConfig::Snapshot nested;
+                assert(nested->generation == config->generation);
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (int i = 1; i <= 200; ++i) {
+        write_config(path, i, i * 100.0);
+        [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+        assert(loaded);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    assert(reads.load() > 0);
+    assert(StaticConfig::get_max_order_quantity() == 200);
+
+    std::remove(path.c_str());
+    std::cout << "✓ Concurrent reader test passed" << std::endl;
+}
+
+void test_reloader_on_request() {
+    std::cout << "Testing ConfigReloader..." << std::endl;
+
+    std::string path = temp_config_path();
+    write_config(path, 250, 25000.0, "timing.config_reload_check_ms=0\n");
+    [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+    assert(loaded);
+
+    std::atomic<uint64_t> reloaded_generation{0};
+    ConfigReloader reloader;
+    reloader.start([&](uint64_t generation) { reloaded_generation.store(generation); });
+
+    write_config(path, 260, 26000.0, "timing.config_reload_check_ms=0\n");
+    uint64_t expected = StaticConfig::get_config_generation() + 1;
+    reloader.request_reload();
+    for (int i = 0; i < 500 && reloaded_generation.load() != expected; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    assert(reloaded_generation.load() == expected);
+    assert(StaticConfig::get_max_order_quantity() == 260);
+    assert(reloader.get_reloads() == 1 && reloader.get_failed_reloads() == 0);
+    reloader.stop();
+
+    std::remove(path.c_str());
+    std::cout << "✓ ConfigReloader test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Static Config Unit Tests" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    try {
+        test_defaults_before_load();
+        test_load_publishes_snapshot();
+        test_invalid_file_keeps_current();
+        test_readers_never_tear();
+        test_reloader_on_request();
+
+        std::cout << "\n✅ All static config tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
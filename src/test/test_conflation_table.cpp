@@ -0,0 +1,106 @@
+#include "../common/conflation_table.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+// Every field derives from the write number, so a torn read is detectable
+struct Quote {
+    uint64_t sequence;
+    uint64_t bid;
+    uint64_t ask;
+    uint64_t check;
+};
+
+static Quote make_quote(uint64_t n) {
+    return Quote{n, n * 3, n * 3 + 1, n ^ 0x5a5a5a5a5a5a5a5aull};
+}
+
+void test_latest_value() {
+    std::cout << "Testing latest-value slots..." << std::endl;
+
+    ConflationTable<Quote, 16> table;
+    Quote quote{};
+    [[maybe_unused]] bool ok = table.read(3, quote);
+    assert(!ok);
+    assert(table.used() == 0);
+
+    table.write(3, make_quote(1));
+    table.write(3, make_quote(2));
+    table.write(1, make_quote(7));
+    ok = table.write(16, make_quote(9));
+    assert(!ok);
+
+    uint64_t version = 0;
+    ok = table.read(3, quote, &version);
+    assert(ok);
+    assert(quote.sequence == 2 && version == 2);
+    assert(table.used() == 4);
+    assert(table.get_updates() == 3);
+
+    // Conflated: one visit per symbol, not per write
+    std::vector<symbol_id_t> visited;
+    [[maybe_unused]] size_t count = table.for_each([&](symbol_id_t id, const Quote&, uint64_t) { visited.push_back(id); });
+    assert(count == 2);
+    assert(visited == (std::vector<symbol_id_t>{1, 3}));
+
+    std::cout << "✓ Latest-value test passed" << std::endl;
+}
+
+void test_concurrent_reads_are_consistent() {
+    std::cout << "Testing reads racing the writer..." << std::endl;
+
+    ConflationTable<Quote, 4> table;
+    std::atomic<bool> done{false};
+    const uint64_t writes = 200000;
+
+    std::thread writer([&] {
+        for (uint64_t n = 1; n <= writes; ++n) {
+            table.write(static_cast<symbol_id_t>(n % 4), make_quote(n));
+        }
+        done = true;
+    });
+
+    uint64_t reads = 0;
+    [[maybe_unused]] uint64_t last_seen[4] = {};
+    while (!done.load() || reads < 1000) {
+        for (symbol_id_t id = 0; id < 4; ++id) {
+            Quote quote;
+            if (!table.read(id, quote)) continue;
+            [[maybe_unused]] const Quote expected = make_quote(quote.sequence);
+            assert(quote.bid == expected.bid && quote.ask == expected.ask && quote.check == expected.check);
+            assert(quote.sequence % 4 == id);
+            assert(quote.sequence >= last_seen[id]);    // Never goes back in time
+            last_seen[id] = quote.sequence;
+            reads++;
+        }
+    }
+    writer.join();
+
+    Quote quote;
+    [[maybe_unused]] bool ok = table.read(0, quote);
+    assert(ok && quote.sequence == writes);
+    assert(table.get_updates() == writes);
+
+    std::cout << "✓ Concurrent read test passed (" << reads << " reads)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Conflation Table Unit Tests" << std::endl;
+    std::cout << "===================================" << std::endl;
+
+    try {
+        test_latest_value();
+        test_concurrent_reads_are_consistent();
+
+        std::cout << "\n✅ All conflation table tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,138 @@
+#include "../common/cpu_topology.h"
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace hft;
+namespace fs = std::filesystem;
+
+static void write_file(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << text << "\n";
+}
+
+// Two sockets, one NUMA node each, two cores per socket with two threads
+// per core: cpuN and cpuN+4 are siblings. CPUs 2-3 and 6-7 are isolated.
+static fs::path make_fake_sysfs() {
+    fs::path root = fs::temp_directory_path() / ("hft_sysfs_" + std::to_string(getpid()));
+    fs::remove_all(root);
+    write_file(root / "cpu/online", "0-7");
+    write_file(root / "cpu/isolated", "2-3,6-7");
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        int core = cpu % 4;
+        fs::path topology = root / ("cpu/cpu" + std::to_string(cpu)) / "topology";
+        write_file(topology / "core_id", std::to_string(core % 2));
+        write_file(topology / "physical_package_id", std::to_string(core / 2));
+        write_file(topology / "thread_siblings_list", std::to_string(core) + "," + std::to_string(core + 4));
+    }
+    write_file(root / "node/node0/cpulist", "0-1,4-5");
+    write_file(root / "node/node1/cpulist", "2-3,6-7");
+    return root;
+}
+
+void test_parse_cpu_list() {
+    std::cout << "Testing cpulist parsing..." << std::endl;
+
+    assert(parse_cpu_list("0-3,8,10-11") == (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    assert(parse_cpu_list("5, 1") == (std::vector<int>{1, 5}));
+    assert(parse_cpu_list("").empty());
+    assert(parse_cpu_list("3-1").empty());
+    assert(parse_cpu_list("a-b").empty());
+
+    std::cout << "✓ cpulist test passed" << std::endl;
+}
+
+void test_load_topology(const fs::path& root) {
+    std::cout << "Testing topology discovery..." << std::endl;
+
+    CpuTopology topology;
+    [[maybe_unused]] bool loaded = topology.load(root.string());
+    assert(loaded);
+    assert(topology.cpus().size() == 8);
+    assert(topology.socket_count() == 2);
+    assert(topology.node_count() == 2);
+    assert(topology.node_of(6) == 1);
+    assert(topology.node_of(4) == 0);
+    assert(topology.cpus_on_node(1) == (std::vector<int>{2, 3, 6, 7}));
+    assert(topology.isolated_cpus() == (std::vector<int>{2, 3, 6, 7}));
+    assert(topology.share_core(1, 5));
+    assert(!topology.share_core(1, 2));
+    assert(topology.cpu(9) == nullptr);
+
+    CpuTopology missing;
+    loaded = missing.load((root / "nonexistent").string());
+    assert(!loaded);
+
+    std::cout << "✓ Topology test passed (" << topology.describe() << ")" << std::endl;
+}
+
+void test_thread_plan(const fs::path& root) {
+    std::cout << "Testing thread plan validation..." << std::endl;
+
+    CpuTopology topology;
+    [[maybe_unused]] bool loaded = topology.load(root.string());
+    assert(loaded);
+
+    std::unordered_map<std::string, std::string> entries = {
+        {"market_data_handler.feed_rx", "2:hot"},
+        {"market_data_handler.zmq_io", "0"},
+        {"strategy_engine.processing", "3:hot"},
+        {"strategy_engine.worker.0", "6:hot"},      // Sibling of feed_rx on CPU 2
+        {"strategy_engine.metrics", "4"},           // Not hot, siblings are fine
+    };
+
+    ThreadPlan plan;
+    [[maybe_unused]] bool configured = plan.configure("strategy_engine", entries, topology);
+    assert(!configured);
+    assert(plan.errors().size() == 1);
+    assert(plan.errors()[0].find("worker.0") != std::string::npos);
+
+    const ThreadPlacement* processing = plan.find("processing");
+    assert(processing && processing->cpu == 3 && processing->hot && processing->numa_node == 1);
+    assert(plan.find("metrics") && plan.find("metrics")->numa_node == 0);
+    assert(plan.find("worker.0") == nullptr);
+    assert(plan.find("feed_rx") == nullptr);        // Another service's thread
+
+    ThreadPlan md_plan;
+    configured = md_plan.configure("market_data_handler", entries, topology);
+    assert(!configured);
+    assert(md_plan.find("feed_rx") && md_plan.find("zmq_io"));
+    assert((md_plan.threads_with_prefix("") == std::vector<std::string>{"feed_rx", "zmq_io"}));
+    assert((plan.threads_with_prefix("m") == std::vector<std::string>{"metrics"}));
+
+    ThreadPlan bad;
+    configured = bad.configure("order_gateway", {{"order_gateway.processing", "12:hot"},
+                                                 {"order_gateway.control", "1:warm"},
+                                                 {"nodot", "1"}}, topology);
+    assert(!configured);
+    assert(bad.errors().size() == 3);
+    assert(bad.find("processing") == nullptr);
+
+    std::cout << "✓ Thread plan test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running CPU Topology Unit Tests" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    fs::path root = make_fake_sysfs();
+    try {
+        test_parse_cpu_list();
+        test_load_topology(root);
+        test_thread_plan(root);
+
+        fs::remove_all(root);
+        std::cout << "\n✅ All CPU topology tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        fs::remove_all(root);
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,273 @@
+#include "../websocket_bridge/dashboard_codec.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace hft;
+using namespace hft::dashboard;
+
+static MarketData make_tick(const char* symbol, price_t bid, price_t ask, uint32_t size, uint64_t timestamp) {
+    MarketData data{};
+    data.header.type = MessageType::MARKET_DATA;
+    std::strncpy(data.symbol, symbol, sizeof(data.symbol) - 1);
+    data.bid_price = bid;
+    data.ask_price = ask;
+    data.bid_size = size;
+    data.ask_size = size;
+    data.last_price = bid;
+    data.last_size = 100;
+    data.exchange_timestamp = timestamp;
+    return data;
+}
+
+static void deliver(DashboardDecoder& decoder, const std::vector<std::string>& frames) {
+    for (const std::string& frame : frames) {
+        [[maybe_unused]] bool decoded = decoder.decode(frame);
+        assert(decoded);
+    }
+}
+
+static void assert_quote(const DashboardDecoder& decoder, symbol_id_t id, const MarketData& expected) {
+    dashboard::QuoteRecord quote;
+    [[maybe_unused]] bool found = decoder.get_quote(id, quote);
+    assert(found);
+    [[maybe_unused]] dashboard::QuoteRecord want = to_quote(id, expected);
+    assert(std::memcmp(&quote, &want, sizeof(quote)) == 0);
+}
+
+void test_varints() {
+    std::cout << "Testing varint encoding..." << std::endl;
+
+    const uint64_t values[] = {0, 1, 127, 128, 300, 1ull << 35, ~0ull};
+    std::string buffer;
+    for (uint64_t value : values) put_varint(buffer, value);
+    assert(buffer.size() == 1 + 1 + 1 + 2 + 2 + 6 + 10);
+
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(buffer.data());
+    const uint8_t* end = pos + buffer.size();
+    for ([[maybe_unused]] uint64_t value : values) {
+        uint64_t decoded;
+        [[maybe_unused]] bool ok = get_varint(pos, end, decoded);
+        assert(ok && decoded == value);
+    }
+    assert(pos == end);
+
+    // Truncated input
+    std::string truncated("\x80\x80", 2);
+    pos = reinterpret_cast<const uint8_t*>(truncated.data());
+    uint64_t decoded;
+    [[maybe_unused]] bool ok = get_varint(pos, pos + truncated.size(), decoded);
+    assert(!ok);
+
+    std::cout << "✓ Varint test passed" << std::endl;
+}
+
+void test_delta_round_trip() {
+    std::cout << "Testing delta frames round trip..." << std::endl;
+
+    DashboardEncoder encoder;
+    DashboardDecoder decoder;
+    std::vector<std::string> frames;
+
+    // Joining before any data still syncs
+    encoder.snapshot(1, frames);
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+
+    MarketData aapl = make_tick("AAPL", 1500000, 1500100, 200, 1000);
+    MarketData msft = make_tick("MSFT", 3000000, 3000500, 300, 1001);
+    MarketData tsla = make_tick("TSLA", 2500000, 2499000, 50, 1002);     // Crossed: negative deltas later
+    encoder.update(0, aapl);
+    encoder.update(5, msft);
+    encoder.update(2, tsla);
+    encoder.update(0, aapl);        // Repeated updates conflate
+
+    frames.clear();
+    encoder.flush(2, false, frames);
+    assert(frames.size() == 2);     // Symbols, then one delta frame
+    assert(!is_quote_frame(frames[0]) && is_quote_frame(frames[1]));
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+    assert(*decoder.get_symbol(5) == "MSFT");
+    assert_quote(decoder, 0, aapl);
+    assert_quote(decoder, 2, tsla);
+    assert_quote(decoder, 5, msft);
+    assert(encoder.get_delta_records() == 3);
+
+    // One small change: header plus a few bytes, against 48 for a full record
+    tsla.bid_price -= 100;
+    tsla.exchange_timestamp += 5;
+    encoder.update(2, tsla);
+    frames.clear();
+    encoder.flush(3, false, frames);
+    assert(frames.size() == 1);
+    assert(frames[0].size() < sizeof(FrameHeader) + 8);
+    deliver(decoder, frames);
+    assert_quote(decoder, 2, tsla);
+    assert_quote(decoder, 0, aapl);
+
+    // Nothing changed: nothing to send
+    frames.clear();
+    encoder.flush(4, false, frames);
+    assert(frames.empty());
+
+    std::cout << "✓ Delta round trip test passed" << std::endl;
+}
+
+void test_gap_recovery() {
+    std::cout << "Testing resync after a skipped frame..." << std::endl;
+
+    DashboardEncoder encoder;
+    DashboardDecoder decoder;
+    std::vector<std::string> frames;
+    encoder.snapshot(0, frames);
+
+    MarketData tick = make_tick("IBM", 1400000, 1400100, 10, 1);
+    encoder.update(0, tick);
+    encoder.flush(1, false, frames);
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+
+    // The client's queue was full for one delta frame
+    tick.bid_price += 100;
+    encoder.update(0, tick);
+    frames.clear();
+    encoder.flush(2, false, frames);
+    assert(frames.size() == 1);
+
+    tick.ask_price += 100;
+    encoder.update(0, tick);
+    frames.clear();
+    encoder.flush(3, false, frames);
+    deliver(decoder, frames);
+    assert(!decoder.is_synced());
+    assert(decoder.get_dropped_frames() == 1);
+
+    // A keyframe restores it
+    tick.last_size = 7;
+    encoder.update(0, tick);
+    frames.clear();
+    encoder.flush(4, true, frames);
+    assert(frames.size() == 1);
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+    assert_quote(decoder, 0, tick);
+
+    // And deltas apply again
+    tick.bid_size = 99;
+    encoder.update(0, tick);
+    frames.clear();
+    encoder.flush(5, false, frames);
+    deliver(decoder, frames);
+    assert_quote(decoder, 0, tick);
+    assert(encoder.get_keyframes() == 1);
+
+    std::cout << "✓ Gap recovery test passed" << std::endl;
+}
+
+void test_late_join_snapshot() {
+    std::cout << "Testing snapshot for a late joiner..." << std::endl;
+
+    DashboardEncoder encoder;
+    std::vector<std::string> frames;
+    const size_t symbols = 2500;    // Keyframes span three frames
+    std::vector<MarketData> ticks;
+    for (size_t i = 0; i < symbols; ++i) {
+        std::string name = "S" + std::to_string(i);
+        ticks.push_back(make_tick(name.c_str(), 100000 + i, 100100 + i, 10, i));
+        encoder.update(static_cast<symbol_id_t>(i), ticks.back());
+    }
+    encoder.flush(1, false, frames);
+    assert(encoder.symbol_count() == symbols);
+
+    DashboardDecoder decoder;
+    frames.clear();
+    encoder.snapshot(2, frames);
+    assert(frames.size() == 3 + 3);
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+    assert(*decoder.get_symbol(2499) == "S2499");
+    assert_quote(decoder, 1234, ticks[1234]);
+
+    // The next broadcast carries on from the snapshot
+    ticks[7].bid_price -= 50;
+    encoder.update(7, ticks[7]);
+    frames.clear();
+    encoder.flush(3, false, frames);
+    deliver(decoder, frames);
+    assert(decoder.is_synced());
+    assert_quote(decoder, 7, ticks[7]);
+
+    // A keyframe missing its first part doesn't sync
+    DashboardDecoder partial;
+    frames.clear();
+    encoder.flush(4, true, frames);
+    assert(frames.size() == 3);
+    [[maybe_unused]] bool ok = partial.decode(frames[1]);
+    assert(ok);
+    ok = partial.decode(frames[2]);
+    assert(ok);
+    assert(!partial.is_synced());
+
+    std::cout << "✓ Late join test passed" << std::endl;
+}
+
+void test_executions() {
+    std::cout << "Testing execution frames..." << std::endl;
+
+    DashboardEncoder encoder;
+    DashboardDecoder decoder;
+    std::vector<std::string> frames;
+
+    OrderExecution execution{};
+    execution.order_id = 42;
+    execution.symbol_id = 3;
+    execution.exec_type = ExecutionType::PARTIAL_FILL;
+    execution.fill_price = 1500000;
+    execution.fill_quantity = 100;
+    execution.remaining_quantity = 50;
+    execution.commission = 0.35;
+    encoder.add_execution(execution);
+    execution.order_id = 43;
+    encoder.add_execution(execution);
+
+    encoder.flush(1, false, frames);
+    assert(frames.size() == 1);
+    assert(frames[0].size() == sizeof(FrameHeader) + 2 * sizeof(ExecutionRecord));
+    assert(!is_quote_frame(frames[0]));     // Must reach every client
+    deliver(decoder, frames);
+    assert(decoder.executions().size() == 2);
+    assert(decoder.executions()[1].order_id == 43);
+    assert(decoder.executions()[0].exec_type == static_cast<uint8_t>(ExecutionType::PARTIAL_FILL));
+    assert(decoder.executions()[0].commission == 0.35);
+
+    // Malformed frames are rejected
+    [[maybe_unused]] bool ok = decoder.decode(frames[0].substr(0, frames[0].size() - 1));
+    assert(!ok);
+    ok = decoder.decode("short");
+    assert(!ok);
+
+    std::cout << "✓ Execution test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Dashboard Codec Unit Tests" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    try {
+        test_varints();
+        test_delta_round_trip();
+        test_gap_recovery();
+        test_late_join_snapshot();
+        test_executions();
+
+        std::cout << "\n✅ All dashboard codec tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,219 @@
+#include "../common/event_loop.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+template<typename Predicate>
+static bool wait_for(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (predicate()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+// Records into a shared log; the loop thread is the only writer while it runs
+struct Log {
+    std::mutex mutex;
+    std::vector<std::string> entries;
+    void add(const std::string& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back(entry);
+    }
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+};
+
+Task sleeper(EventLoop& loop, Log& log, std::string name, int delay_ms) {
+    co_await loop.sleep_for(std::chrono::milliseconds(delay_ms));
+    log.add(name);
+}
+
+void test_timers() {
+    std::cout << "Testing timers..." << std::endl;
+
+    EventLoop loop("test");
+    Log log;
+    // Spawned before start: they run once it starts
+    loop.spawn(sleeper(loop, log, "slow", 60));
+    loop.spawn(sleeper(loop, log, "fast", 10));
+    loop.spawn(sleeper(loop, log, "now", 0));
+    auto started = std::chrono::steady_clock::now();
+    loop.start("test_loop");
+
+    [[maybe_unused]] bool ok = wait_for([&] { return log.size() == 3; });
+    assert(ok);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    assert(elapsed >= std::chrono::milliseconds(60));
+    assert(log.entries[0] == "now" && log.entries[1] == "fast" && log.entries[2] == "slow");
+    ok = wait_for([&] { return loop.get_task_count() == 0; });
+    assert(ok);
+
+    // Idle: only the three deadlines and the spawn woke it
+    uint64_t wakeups = loop.get_wakeups();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(loop.get_wakeups() == wakeups);
+    loop.stop();
+
+    std::cout << "✓ Timer test passed (" << wakeups << " wakeups)" << std::endl;
+}
+
+Task reader(EventLoop& loop, int fd, Log& log) {
+    for (;;) {
+        co_await loop.readable(fd);
+        char buffer[64];
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            co_return;
+        }
+        log.add(std::string(buffer, static_cast<size_t>(n)));
+    }
+}
+
+void test_readable() {
+    std::cout << "Testing fd readiness..." << std::endl;
+
+    int fds[2];
+    [[maybe_unused]] int piped = pipe(fds);
+    assert(piped == 0);
+    EventLoop loop("test");
+    Log log;
+    loop.start("test_loop");
+    loop.spawn(reader(loop, fds[0], log));
+
+    [[maybe_unused]] bool ok = wait_for([&] { return loop.get_task_count() == 1; });
+    assert(ok);
+    [[maybe_unused]] ssize_t written = write(fds[1], "abc", 3);
+    assert(written == 3);
+    ok = wait_for([&] { return log.size() == 1; });
+    assert(ok);
+    written = write(fds[1], "de", 2);
+    assert(written == 2);
+    ok = wait_for([&] { return log.size() == 2; });
+    assert(ok);
+    assert(log.entries[0] == "abc" && log.entries[1] == "de");
+
+    // EOF ends the task
+    close(fds[1]);
+    ok = wait_for([&] { return loop.get_task_count() == 0; });
+    assert(ok);
+    loop.stop();
+    close(fds[0]);
+
+    std::cout << "✓ Readiness test passed" << std::endl;
+}
+
+struct Guard {
+    std::atomic<int>& destroyed;
+    ~Guard() { destroyed.fetch_add(1); }
+};
+
+Task parked(EventLoop& loop, int fd, std::atomic<int>& destroyed) {
+    Guard guard{destroyed};
+    co_await loop.readable(fd);
+}
+
+Task napping(EventLoop& loop, std::atomic<int>& destroyed) {
+    Guard guard{destroyed};
+    co_await loop.sleep_for(std::chrono::hours(1));
+}
+
+Task holding(EventLoop& loop, [[maybe_unused]] std::shared_ptr<int> token) {
+    co_await loop.sleep_for(std::chrono::hours(1));
+}
+
+Task failing(EventLoop& loop) {
+    co_await loop.yield();
+    throw std::runtime_error("expected test failure");
+}
+
+void test_stop_and_failures() {
+    std::cout << "Testing stop with suspended tasks..." << std::endl;
+
+    int fds[2];
+    [[maybe_unused]] int piped = pipe(fds);
+    assert(piped == 0);
+    std::atomic<int> destroyed{0};
+    std::atomic<int> posted{0};
+    auto token = std::make_shared<int>(0);
+    {
+        EventLoop loop("test");
+        loop.start("test_loop");
+        loop.spawn(parked(loop, fds[0], destroyed));
+        loop.spawn(napping(loop, destroyed));
+        loop.spawn(failing(loop));
+        loop.post([&] { posted.fetch_add(1); });
+        [[maybe_unused]] bool ok = wait_for([&] { return posted.load() == 1 && loop.get_task_count() == 2; });
+        assert(ok);
+        assert(destroyed.load() == 0);
+
+        loop.stop();
+        assert(destroyed.load() == 2);
+        assert(loop.get_task_count() == 0);
+
+        // Never started: the frame (holding its copy of the argument) is
+        // freed by the destructor
+        loop.spawn(holding(loop, token));
+        assert(token.use_count() == 2);
+    }
+    assert(token.use_count() == 1);
+    close(fds[0]);
+    close(fds[1]);
+
+    std::cout << "✓ Stop test passed" << std::endl;
+}
+
+Task counter(EventLoop& loop, std::atomic<uint64_t>& count, uint64_t limit) {
+    while (count.load() < limit) {
+        count.fetch_add(1);
+        co_await loop.yield();
+    }
+}
+
+void test_yield_interleaves() {
+    std::cout << "Testing yield..." << std::endl;
+
+    EventLoop loop("test");
+    std::atomic<uint64_t> a{0};
+    std::atomic<uint64_t> b{0};
+    loop.spawn(counter(loop, a, 1000));
+    loop.spawn(counter(loop, b, 1000));
+    loop.start("test_loop");
+    [[maybe_unused]] bool ok = wait_for([&] { return a.load() == 1000 && b.load() == 1000; });
+    assert(ok);
+    loop.stop();
+
+    std::cout << "✓ Yield test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Event Loop Unit Tests" << std::endl;
+    std::cout << "=============================" << std::endl;
+
+    try {
+        test_timers();
+        test_readable();
+        test_stop_and_failures();
+        test_yield_interleaves();
+
+        std::cout << "\n✅ All event loop tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
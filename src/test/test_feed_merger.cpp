@@ -0,0 +1,161 @@
+#include "../market_data_handler/feed_merger.h"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+static MarketData quote(uint64_t exchange_timestamp, uint32_t size = 0) {
+    MarketData data{};
+    data.exchange_timestamp = exchange_timestamp;
+    data.last_size = size;
+    return data;
+}
+
+static std::vector<uint64_t> poll(FeedMerger& merger, uint64_t now_ns) {
+    std::vector<uint64_t> out;
+    merger.poll(now_ns, [&](const MarketData& data) { out.push_back(data.exchange_timestamp); });
+    return out;
+}
+
+void test_merges_in_timestamp_order() {
+    std::cout << "Testing timestamp order across inputs..." << std::endl;
+
+    FeedMerger merger(3, 1000);
+    for (size_t i = 0; i < 3; ++i) merger.set_live(i, true);
+    for (uint64_t t : {10, 40, 70}) merger.channel(0).try_push(quote(t));
+    for (uint64_t t : {20, 50}) merger.channel(1).try_push(quote(t));
+    for (uint64_t t : {30, 60, 80}) merger.channel(2).try_push(quote(t));
+
+    // Input 1 runs dry after 50; 60 and later wait for it
+    std::vector<uint64_t> merged = poll(merger, 0);
+    assert((merged == std::vector<uint64_t>{10, 20, 30, 40, 50}));
+    merger.channel(1).try_push(quote(65));
+    merged = poll(merger, 10);
+    assert((merged == std::vector<uint64_t>{60, 65}));
+
+    // Inputs 0 and 2 have one quote left each; the window lets them go
+    merged = poll(merger, 2000);
+    assert((merged == std::vector<uint64_t>{70, 80}));
+    assert(merger.late() == 0);
+
+    std::cout << "✓ Timestamp order test passed" << std::endl;
+}
+
+void test_window_and_down_inputs() {
+    std::cout << "Testing the merge window and down inputs..." << std::endl;
+
+    FeedMerger merger(2, 1000);
+    merger.set_live(0, true);
+    merger.set_live(1, true);
+    merger.channel(0).try_push(quote(100));
+
+    // A quiet live input holds the quote until the window runs out
+    std::vector<uint64_t> merged = poll(merger, 5000);
+    assert(merged.empty());
+    merged = poll(merger, 5999);
+    assert(merged.empty());
+    merged = poll(merger, 6000);
+    assert((merged == std::vector<uint64_t>{100}));
+
+    // Something older arriving after that goes out late, and is counted
+    merger.channel(1).try_push(quote(90));
+    merged = poll(merger, 6001);
+    assert(merged.empty());
+    merged = poll(merger, 7001);
+    assert((merged == std::vector<uint64_t>{90}));
+    assert(merger.late() == 1);
+
+    // A down input is not waited for at all
+    merger.set_live(1, false);
+    merger.channel(0).try_push(quote(200));
+    merged = poll(merger, 7002);
+    assert((merged == std::vector<uint64_t>{200}));
+
+    // What a dropped connection queued before going down still merges in
+    merger.channel(1).try_push(quote(250));
+    merger.channel(0).try_push(quote(300));
+    merged = poll(merger, 7003);
+    assert((merged == std::vector<uint64_t>{250, 300}));
+
+    // Equal times keep input order; a missing exchange time goes out first
+    merger.set_live(0, false);
+    merger.channel(1).try_push(quote(400, 1));
+    merger.channel(0).try_push(quote(400, 0));
+    std::vector<uint32_t> sizes;
+    merger.poll(7004, [&](const MarketData& data) { sizes.push_back(data.last_size); });
+    assert((sizes == std::vector<uint32_t>{0, 1}));
+    merger.channel(1).try_push(quote(0));
+    merged = poll(merger, 7005);
+    assert((merged == std::vector<uint64_t>{0}));
+    assert(merger.late() == 1);
+
+    std::cout << "✓ Window and down input test passed" << std::endl;
+}
+
+void test_concurrent_producers() {
+    std::cout << "Testing concurrent producers..." << std::endl;
+
+    constexpr size_t INPUTS = 4;
+    constexpr uint64_t PER_INPUT = 100000;
+    FeedMerger merger(INPUTS, 0);
+    for (size_t i = 0; i < INPUTS; ++i) merger.set_live(i, true);
+
+    // Input i carries timestamps i, i + INPUTS, ...; each producer publishes
+    // in small frames like a websocket thread
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < INPUTS; ++i) {
+        producers.emplace_back([&merger, i]() {
+            FeedMerger::Channel& channel = merger.channel(i);
+            for (uint64_t n = 0; n < PER_INPUT; ++n) {
+                while (!channel.try_stage(quote(1 + i + n * INPUTS))) {
+                    channel.publish();
+                    std::this_thread::yield();
+                }
+                if (n % 8 == 7) channel.publish();
+            }
+            channel.publish();
+            merger.set_live(i, false);
+        });
+    }
+
+    uint64_t received = 0;
+    uint64_t previous = 0;
+    bool ordered_per_input[INPUTS] = {true, true, true, true};
+    uint64_t last_per_input[INPUTS] = {};
+    while (received < INPUTS * PER_INPUT) {
+        merger.poll(0, [&](const MarketData& data) {
+            size_t input = (data.exchange_timestamp - 1) % INPUTS;
+            if (data.exchange_timestamp <= last_per_input[input]) ordered_per_input[input] = false;
+            last_per_input[input] = data.exchange_timestamp;
+            previous = data.exchange_timestamp;
+            received++;
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    assert(received == INPUTS * PER_INPUT);
+    for ([[maybe_unused]] bool ordered : ordered_per_input) assert(ordered);
+    assert(previous > 0);
+
+    std::cout << "✓ Concurrent producer test passed (" << merger.late() << " merged late with no window)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Feed Merger Unit Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        test_merges_in_timestamp_order();
+        test_window_and_down_inputs();
+        test_concurrent_producers();
+
+        std::cout << "\n✅ All feed merger tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
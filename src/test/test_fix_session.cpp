@@ -0,0 +1,516 @@
+#include "../order_gateway/fix_session.h"
+#include <arpa/inet.h>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static fix::MessageTemplate broker_message(std::string_view msg_type, uint64_t seq) {
+    fix::MessageTemplate message("FIX.4.4", msg_type);
+    message.add(fix::SENDER_COMP_ID, "BROKER");
+    message.add(fix::TARGET_COMP_ID, "HFT");
+    message.add(fix::MSG_SEQ_NUM, seq);
+    message.add(fix::SENDING_TIME, "20260101-00:00:00.000");
+    return message;
+}
+
+// The acceptor side of the session, over loopback
+class Counterparty {
+public:
+    Counterparty() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        bool ok = ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), length) == 0 &&
+                  ::listen(listen_fd_, 1) == 0 &&
+                  ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) == 0;
+        assert(ok);
+        port_ = ntohs(address.sin_port);
+    }
+
+    ~Counterparty() {
+        drop();
+        ::close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+    bool connected() const { return fd_ >= 0; }
+    uint64_t next_seq = 1;
+
+    void pump() {
+        if (fd_ < 0) {
+            fd_ = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK);
+            return;
+        }
+        char chunk[4096];
+        ssize_t received;
+        while ((received = ::recv(fd_, chunk, sizeof(chunk), 0)) > 0) {
+            buffer_.append(chunk, static_cast<size_t>(received));
+        }
+        ptrdiff_t length;
+        while ((length = fix::frame(buffer_.data(), buffer_.size())) > 0) {
+            received_.push_back(buffer_.substr(0, static_cast<size_t>(length)));
+            buffer_.erase(0, static_cast<size_t>(length));
+        }
+        assert(length == 0);
+    }
+
+    void send(fix::MessageTemplate& message) {
+        bool ok = message.finish();
+        assert(ok);
+        ok = ::send(fd_, message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size());
+        assert(ok);
+    }
+
+    // The latest message of the type received so far, or false
+    bool last(std::string_view msg_type, fix::Message& message, std::string* raw = nullptr) const {
+        for (auto it = received_.rbegin(); it != received_.rend(); ++it) {
+            bool ok = fix::parse(it->data(), it->size(), message);
+            assert(ok);
+            if (message.msg_type == msg_type) {
+                if (raw) *raw = *it;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t count(std::string_view msg_type) const {
+        size_t n = 0;
+        fix::Message message;
+        for (const std::string& raw : received_) {
+            fix::parse(raw.data(), raw.size(), message);
+            n += message.msg_type == msg_type;
+        }
+        return n;
+    }
+
+    void drop() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        buffer_.clear();
+        received_.clear();
+    }
+
+private:
+    int listen_fd_ = -1;
+    int fd_ = -1;
+    int port_ = 0;
+    std::string buffer_;
+    std::deque<std::string> received_;
+};
+
+// Polls both sides until done() or two seconds pass
+template <typename Done>
+static bool pump(FixSession& session, Counterparty& broker, Done done, int64_t skew_ns = 0) {
+    int64_t deadline = now_ns() + 2000000000LL;
+    while (now_ns() < deadline) {
+        session.poll(now_ns() + skew_ns);
+        broker.pump();
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+void test_codec() {
+    std::cout << "Testing FIX field encoding..." << std::endl;
+
+    char text[32];
+    [[maybe_unused]] bool ok = fix::write_digits(text, 5, 42);
+    assert(ok && std::string(text, 5) == "00042");
+    ok = fix::write_digits(text, 2, 420);
+    assert(!ok);
+
+    ok = fix::write_price(text, to_fixed_price(150.25));
+    assert(ok);
+    assert(std::string(text, fix::PRICE_WIDTH) == "0000150.2500");
+    ok = fix::write_price(text, -1);
+    assert(!ok);
+    price_t price = 0;
+    ok = fix::parse_price("0000150.2500", price);
+    assert(ok && price == to_fixed_price(150.25));
+    ok = fix::parse_price("99.5", price);
+    assert(ok && price == to_fixed_price(99.5));
+    ok = fix::parse_price("7", price);
+    assert(ok && price == to_fixed_price(7.0));
+    ok = fix::parse_price("1.234567", price);
+    assert(ok && price == 12345);
+    ok = fix::parse_price("-0.01", price);
+    assert(ok && price == -100);
+    ok = fix::parse_price("1.2x", price);
+    assert(!ok);
+    ok = fix::parse_price("", price);
+    assert(!ok);
+
+    fix::write_cl_ord_id(text, 123456789, 7);
+    assert(std::string(text, fix::CL_ORD_ID_WIDTH) == "0000000123456789-0007");
+    uint64_t order_id = 0;
+    uint16_t revision = 0;
+    ok = fix::parse_cl_ord_id(std::string_view(text, fix::CL_ORD_ID_WIDTH), order_id, revision);
+    assert(ok);
+    assert(order_id == 123456789 && revision == 7);
+    ok = fix::parse_cl_ord_id("123", order_id, revision);
+    assert(!ok);
+    ok = fix::parse_cl_ord_id("123-abc", order_id, revision);
+    assert(!ok);
+
+    fix::TimestampCache timestamps;
+    assert(std::string(timestamps.format(0), fix::TIMESTAMP_WIDTH) == "19700101-00:00:00.000");
+    assert(std::string(timestamps.format(1500000000), fix::TIMESTAMP_WIDTH) == "19700101-00:00:01.500");
+    assert(std::string(timestamps.format(1501000000), fix::TIMESTAMP_WIDTH) == "19700101-00:00:01.501");
+    assert(std::string(timestamps.format(86400000000000LL), fix::TIMESTAMP_WIDTH) == "19700102-00:00:00.000");
+
+    std::cout << "✓ Field encoding test passed" << std::endl;
+}
+
+void test_template() {
+    std::cout << "Testing message templates..." << std::endl;
+
+    fix::MessageTemplate order("FIX.4.4", fix::NEW_ORDER_SINGLE);
+    int seq = order.add_slot(fix::MSG_SEQ_NUM, fix::SEQ_NUM_WIDTH);
+    order.add(fix::SYMBOL, "AAPL");
+    int quantity = order.add_slot(fix::ORDER_QTY, fix::QUANTITY_WIDTH);
+    int price = order.add_slot(fix::PRICE, fix::PRICE_WIDTH);
+    [[maybe_unused]] bool ok = order.finish();
+    assert(ok);
+    assert(std::string(order.data(), 10) == "8=FIX.4.4\x01");
+    assert(fix::frame(order.data(), order.size()) == static_cast<ptrdiff_t>(order.size()));
+
+    // Patching keeps the length and a valid checksum
+    size_t size = order.size();
+    ok = order.set_digits(seq, 42);
+    assert(ok);
+    ok = order.set_digits(quantity, 100);
+    assert(ok);
+    ok = order.set_price(price, to_fixed_price(150.25));
+    assert(ok);
+    assert(order.size() == size);
+    assert(fix::frame(order.data(), order.size()) == static_cast<ptrdiff_t>(size));
+    ok = order.set_digits(seq, 1000000000);
+    assert(!ok);
+
+    // Same bytes as a message built with the values in place
+    fix::MessageTemplate built("FIX.4.4", fix::NEW_ORDER_SINGLE);
+    built.add(fix::MSG_SEQ_NUM, "000000042");
+    built.add(fix::SYMBOL, "AAPL");
+    built.add(fix::ORDER_QTY, "0000000100");
+    built.add(fix::PRICE, "0000150.2500");
+    ok = built.finish();
+    assert(ok);
+    assert(std::string(order.data(), order.size()) == std::string(built.data(), built.size()));
+
+    fix::Message message;
+    ok = fix::parse(order.data(), order.size(), message);
+    assert(ok);
+    assert(message.msg_type == fix::NEW_ORDER_SINGLE && message.seq_num == 42 && message.symbol == "AAPL");
+
+    // Incomplete, then garbled
+    for (size_t i = 0; i < size; ++i) {
+        assert(fix::frame(order.data(), i) == 0);
+    }
+    std::string garbled(order.data(), order.size());
+    garbled[20] ^= 1;
+    assert(fix::frame(garbled.data(), garbled.size()) == -1);
+    assert(fix::frame("9=12\x01", 5) == -1);
+    assert(fix::frame("8=FIX.4.4\x01" "9=99999999\x01", 21) == -1);
+
+    std::cout << "✓ Message template test passed" << std::endl;
+}
+
+void test_decode() {
+    std::cout << "Testing execution report decoding..." << std::endl;
+
+    fix::MessageTemplate report = broker_message(fix::EXECUTION_REPORT, 9);
+    report.add(fix::CL_ORD_ID, "0000000000000042-0001");
+    report.add(fix::ORDER_ID, "BRK-7");
+    report.add(fix::EXEC_TYPE, "F");
+    report.add(fix::ORD_STATUS, "1");
+    report.add(fix::SYMBOL, "MSFT");
+    report.add(fix::LAST_PX, "410.1");
+    report.add(fix::LAST_QTY, "30");
+    report.add(fix::LEAVES_QTY, "70.000");
+    [[maybe_unused]] bool ok = report.finish();
+    assert(ok);
+
+    fix::Message message;
+    ok = fix::parse(report.data(), report.size(), message);
+    assert(ok);
+    fix::ExecutionReport decoded;
+    ok = fix::decode_execution_report(message, decoded);
+    assert(ok);
+    assert(decoded.order_id == 42 && decoded.revision == 1 && !decoded.cancel_reject);
+    assert(decoded.broker_order_id == "BRK-7");
+    assert(decoded.execution.exec_type == ExecutionType::PARTIAL_FILL);
+    assert(decoded.execution.fill_price == to_fixed_price(410.1));
+    assert(decoded.execution.fill_quantity == 30 && decoded.execution.remaining_quantity == 70);
+    assert(std::string(decoded.execution.symbol) == "MSFT");
+
+    fix::MessageTemplate reject = broker_message(fix::ORDER_CANCEL_REJECT, 10);
+    reject.add(fix::CL_ORD_ID, "0000000000000042-0002");
+    reject.add(fix::TEXT, "too late");
+    ok = reject.finish();
+    assert(ok);
+    ok = fix::parse(reject.data(), reject.size(), message);
+    assert(ok);
+    ok = fix::decode_execution_report(message, decoded);
+    assert(ok);
+    assert(decoded.cancel_reject && decoded.revision == 2 && decoded.text == "too late");
+
+    // Not ours, and not a report
+    fix::MessageTemplate foreign = broker_message(fix::EXECUTION_REPORT, 11);
+    foreign.add(fix::CL_ORD_ID, "manual-order");
+    ok = foreign.finish();
+    assert(ok);
+    ok = fix::parse(foreign.data(), foreign.size(), message);
+    assert(ok);
+    ok = fix::decode_execution_report(message, decoded);
+    assert(!ok);
+    fix::MessageTemplate heartbeat = broker_message(fix::HEARTBEAT, 12);
+    ok = heartbeat.finish();
+    assert(ok);
+    ok = fix::parse(heartbeat.data(), heartbeat.size(), message);
+    assert(ok);
+    ok = fix::decode_execution_report(message, decoded);
+    assert(!ok);
+
+    std::cout << "✓ Decode test passed" << std::endl;
+}
+
+void test_session() {
+    std::cout << "Testing session over loopback..." << std::endl;
+
+    Counterparty broker;
+    FixSessionConfig config;
+    config.host = "127.0.0.1";
+    config.port = broker.port();
+    config.sender_comp_id = "HFT";
+    config.target_comp_id = "BROKER";
+    config.heartbeat_interval_seconds = 1;
+    config.reconnect_interval_seconds = 60;      // One connection per session below
+    config.sequence_file = "/tmp/test_fix_session_" + std::to_string(getpid()) + ".seq";
+    ::unlink(config.sequence_file.c_str());
+
+    uint64_t saved_outgoing = 0;
+    uint64_t saved_incoming = 0;
+    {
+        FixSession session(config);
+        std::vector<fix::ExecutionReport> reports;
+        std::deque<std::string> broker_ids;
+        session.set_report_handler([&](const fix::ExecutionReport& report) {
+            broker_ids.emplace_back(report.broker_order_id);
+            reports.push_back(report);
+        });
+        [[maybe_unused]] bool ok = session.start();
+        assert(ok);
+
+        // Logon
+        fix::Message message;
+        ok = pump(session, broker, [&] { return broker.last(fix::LOGON, message); });
+        assert(ok);
+        assert(message.seq_num == 1 && message.sender_comp_id == "HFT" && message.target_comp_id == "BROKER");
+        assert(!session.is_logged_on());
+        fix::MessageTemplate logon = broker_message(fix::LOGON, broker.next_seq++);
+        logon.add(fix::HEART_BT_INT, "1");
+        broker.send(logon);
+        ok = pump(session, broker, [&] { return session.is_logged_on(); });
+        assert(ok);
+
+        // NewOrderSingle, filled in part
+        Order order;
+        order.order_id = 42;
+        std::strcpy(order.symbol, "AAPL");
+        order.symbol_id = 3;
+        order.action = SignalAction::BUY;
+        order.type = OrderType::LIMIT;
+        order.quantity = 100;
+        order.price = to_fixed_price(150.25);
+        ok = session.send_new_order(order);
+        assert(ok);
+        std::string raw;
+        ok = pump(session, broker, [&] { return broker.last(fix::NEW_ORDER_SINGLE, message, &raw); });
+        assert(ok);
+        assert(message.seq_num == 2 && message.cl_ord_id == "0000000000000042-0000" && message.symbol == "AAPL");
+        assert(raw.find("\x01" "54=1\x01") != std::string::npos);
+        assert(raw.find("\x01" "38=0000000100\x01") != std::string::npos);
+        assert(raw.find("\x01" "44=0000150.2500\x01") != std::string::npos);
+
+        fix::MessageTemplate fill = broker_message(fix::EXECUTION_REPORT, broker.next_seq++);
+        fill.add(fix::CL_ORD_ID, "0000000000000042-0000");
+        fill.add(fix::ORDER_ID, "BRK-1");
+        fill.add(fix::EXEC_TYPE, "F");
+        fill.add(fix::SYMBOL, "AAPL");
+        fill.add(fix::LAST_PX, "150.25");
+        fill.add(fix::LAST_QTY, "40");
+        fill.add(fix::LEAVES_QTY, "60");
+        broker.send(fill);
+        ok = pump(session, broker, [&] { return !reports.empty(); });
+        assert(ok);
+        assert(reports[0].order_id == 42 && reports[0].exec_type == fix::EXEC_TRADE);
+        assert(broker_ids[0] == "BRK-1");
+        assert(reports[0].execution.fill_quantity == 40 && reports[0].execution.remaining_quantity == 60);
+
+        // Replace: new ClOrdID, the old one as OrigClOrdID; market orders
+        // carry no price
+        order.revision = 1;
+        order.price = to_fixed_price(150.30);
+        ok = session.send_replace(order);
+        assert(ok);
+        ok = pump(session, broker, [&] { return broker.last(fix::ORDER_CANCEL_REPLACE_REQUEST, message, &raw); });
+        assert(ok);
+        assert(message.cl_ord_id == "0000000000000042-0001" && message.orig_cl_ord_id == "0000000000000042-0000");
+        assert(raw.find("\x01" "44=0000150.3000\x01") != std::string::npos);
+        Order market = order;
+        market.order_id = 43;
+        market.type = OrderType::MARKET;
+        market.revision = 0;
+        ok = session.send_new_order(market);
+        assert(ok);
+        ok = pump(session, broker, [&] {
+            return broker.last(fix::NEW_ORDER_SINGLE, message, &raw) && message.cl_ord_id == "0000000000000043-0000";
+        });
+        assert(ok);
+        assert(raw.find("\x01" "44=") == std::string::npos);
+
+        // Mass cancel: every order at once, under a ClOrdID no order has
+        ok = session.send_mass_cancel();
+        assert(ok);
+        ok = pump(session, broker, [&] { return broker.last(fix::ORDER_MASS_CANCEL_REQUEST, message, &raw); });
+        assert(ok);
+        assert(message.cl_ord_id == "0000000000000000-0001");
+        assert(raw.find("\x01" "530=7\x01") != std::string::npos);
+        assert(raw.find("\x01" "60=") != std::string::npos);
+
+        // TestRequest: a heartbeat with its ID
+        fix::MessageTemplate test_request = broker_message(fix::TEST_REQUEST, broker.next_seq++);
+        test_request.add(fix::TEST_REQ_ID, "PING");
+        broker.send(test_request);
+        ok = pump(session, broker, [&] { return broker.last(fix::HEARTBEAT, message); });
+        assert(ok);
+        assert(message.test_req_id == "PING");
+
+        // ResendRequest: a gap fill over everything, orders included
+        uint64_t next_outgoing = session.next_outgoing_seq();
+        fix::MessageTemplate resend = broker_message(fix::RESEND_REQUEST, broker.next_seq++);
+        resend.add(fix::BEGIN_SEQ_NO, uint64_t{2});
+        resend.add(fix::END_SEQ_NO, uint64_t{0});
+        broker.send(resend);
+        ok = pump(session, broker, [&] { return broker.last(fix::SEQUENCE_RESET, message); });
+        assert(ok);
+        assert(message.seq_num == 2 && message.gap_fill && message.poss_dup && message.new_seq_no == next_outgoing);
+        assert(session.next_outgoing_seq() == next_outgoing && session.gap_fills_sent() == 1);
+        assert(broker.count(fix::NEW_ORDER_SINGLE) == 2);
+
+        // Inbound gap: one ResendRequest, however many messages follow it
+        uint64_t expected = session.next_incoming_seq();
+        assert(expected == broker.next_seq);
+        for (uint64_t seq = expected + 2; seq < expected + 5; ++seq) {
+            fix::MessageTemplate heartbeat = broker_message(fix::HEARTBEAT, seq);
+            broker.send(heartbeat);
+        }
+        ok = pump(session, broker, [&] { return broker.last(fix::RESEND_REQUEST, message); });
+        assert(ok);
+        assert(message.begin_seq_no == expected && message.end_seq_no == 0);
+        int64_t settle = now_ns() + 50000000;
+        pump(session, broker, [&] { return now_ns() > settle; });
+        assert(session.resend_requests_sent() == 1 && broker.count(fix::RESEND_REQUEST) == 1);
+        assert(session.next_incoming_seq() == expected);
+        fix::MessageTemplate gap_fill = broker_message(fix::SEQUENCE_RESET, expected);
+        gap_fill.add(fix::POSS_DUP_FLAG, "Y");
+        gap_fill.add(fix::GAP_FILL_FLAG, "Y");
+        gap_fill.add(fix::NEW_SEQ_NO, expected + 5);
+        broker.send(gap_fill);
+        broker.next_seq = expected + 5;
+        ok = pump(session, broker, [&] { return session.next_incoming_seq() == expected + 5; });
+        assert(ok);
+
+        // Silent for a heartbeat and a fifth: a heartbeat and a TestRequest
+        size_t heartbeats = broker.count(fix::HEARTBEAT);
+        ok = pump(session, broker, [&] { return broker.count(fix::TEST_REQUEST) == 1; }, 1300000000LL);
+        assert(ok);
+        assert(broker.count(fix::HEARTBEAT) == heartbeats + 1);
+        assert(session.is_logged_on());
+
+        saved_outgoing = session.next_outgoing_seq();
+        saved_incoming = session.next_incoming_seq();
+        broker.drop();
+        ok = pump(session, broker, [&] { return !session.is_logged_on(); });
+        assert(ok);
+        assert(session.state() == FixSession::State::DISCONNECTED || session.state() == FixSession::State::CONNECTING);
+        ok = session.send_new_order(order);
+        assert(!ok);
+        session.stop();
+    }
+
+    // Sequence numbers survive the process
+    broker.drop();
+    {
+        FixSession session(config);
+        [[maybe_unused]] bool ok = session.start();
+        assert(ok);
+        assert(session.next_outgoing_seq() == saved_outgoing && session.next_incoming_seq() == saved_incoming);
+
+        fix::Message message;
+        ok = pump(session, broker, [&] { return broker.last(fix::LOGON, message); });
+        assert(ok);
+        assert(message.seq_num == saved_outgoing);
+
+        // A reply numbered below what is expected, not a duplicate: logout
+        fix::MessageTemplate logon = broker_message(fix::LOGON, 1);
+        logon.add(fix::HEART_BT_INT, "1");
+        broker.send(logon);
+        ok = pump(session, broker, [&] { return broker.last(fix::LOGOUT, message); });
+        assert(ok);
+        assert(message.text.find("too low") != std::string_view::npos);
+        assert(!session.is_logged_on());
+        session.stop();
+    }
+    ::unlink(config.sequence_file.c_str());
+
+    // Nothing to connect to until start() succeeds
+    FixSessionConfig incomplete = config;
+    incomplete.target_comp_id.clear();
+    assert(incomplete.validate().find("target_comp_id") != std::string::npos);
+    FixSession idle(incomplete);
+    [[maybe_unused]] bool started = idle.start();
+    assert(!started);
+    idle.poll(now_ns());
+    assert(idle.state() == FixSession::State::DISCONNECTED);
+
+    std::cout << "✓ Session test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FIX Session Unit Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        test_codec();
+        test_template();
+        test_decode();
+        test_session();
+
+        std::cout << "\n✅ All FIX session tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
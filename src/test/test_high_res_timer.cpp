@@ -0,0 +1,126 @@
+#include "../common/high_res_timer.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <time.h>
+
+using namespace hft;
+
+static uint64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t distance(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+void test_calibration() {
+    std::cout << "Testing calibration and conversions..." << std::endl;
+
+    HighResTimer::initialize();
+#ifdef __x86_64__
+    uint64_t frequency = HighResTimer::get_tsc_frequency();
+    assert(frequency > 100000000ULL);
+
+    // One second of ticks is one second
+    assert(distance(HighResTimer::ticks_to_nanoseconds(frequency), 1000000000ULL) < 10);
+    assert(distance(HighResTimer::nanoseconds_to_ticks(1000000000ULL), frequency) < 10);
+#endif
+
+    // Round trip at a realistic uptime, where a plain 64-bit multiply overflows
+    uint64_t ns = 3ULL * 24 * 3600 * 1000000000ULL;
+    assert(distance(HighResTimer::ticks_to_nanoseconds(HighResTimer::nanoseconds_to_ticks(ns)), ns) < 1000);
+
+    // Against the OS over a short sleep
+    auto steady_start = std::chrono::steady_clock::now();
+    auto start = HighResTimer::get_ticks_start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto end = HighResTimer::get_ticks_end();
+    uint64_t steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - steady_start).count();
+    uint64_t measured = HighResTimer::ticks_to_nanoseconds(end - start);
+    assert(end > start);
+    assert(measured <= steady_ns + 100000);
+    assert(measured + 2000000 >= steady_ns);
+
+    std::cout << "✓ Calibration test passed" << std::endl;
+}
+
+void test_wall_clock() {
+    std::cout << "Testing TSC to wall clock mapping..." << std::endl;
+
+    uint64_t before = realtime_ns();
+    uint64_t wall = HighResTimer::get_wall_nanoseconds();
+    uint64_t after = realtime_ns();
+    assert(wall + 100000 >= before && wall <= after + 100000);
+
+    // Readings either side of the anchor
+    auto ticks = HighResTimer::get_ticks();
+    HighResTimer::recalibrate();
+    uint64_t earlier = HighResTimer::ticks_to_wall_nanoseconds(ticks);
+    uint64_t later = HighResTimer::get_wall_nanoseconds();
+    assert(later >= earlier);
+    assert(later - earlier < 50000000);
+    assert(distance(later, realtime_ns()) < 100000);
+
+    std::cout << "✓ Wall clock test passed" << std::endl;
+}
+
+void test_recalibration_keeps_timeline() {
+    std::cout << "Testing get_nanoseconds() across a recalibration..." << std::endl;
+
+    // The rate moves a little on every recalibration; the timeline must not
+    auto steady_start = std::chrono::steady_clock::now();
+    uint64_t start = HighResTimer::get_nanoseconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    HighResTimer::recalibrate();
+    uint64_t middle = HighResTimer::get_nanoseconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    HighResTimer::recalibrate();
+    uint64_t end = HighResTimer::get_nanoseconds();
+    uint64_t steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - steady_start).count();
+
+    assert(middle > start && end > middle);
+    assert(end - start <= steady_ns + 100000);
+    assert(end - start + 2000000 >= steady_ns);
+    assert(distance(HighResTimer::ticks_to_steady_nanoseconds(HighResTimer::get_ticks()),
+                    HighResTimer::get_nanoseconds()) < 100000);
+
+    std::cout << "✓ Recalibration test passed" << std::endl;
+}
+
+void test_tsc_sync() {
+    std::cout << "Testing cross-core TSC check..." << std::endl;
+
+    TscSyncResult result = HighResTimer::check_tsc_sync(4);
+    assert(result.cpus_checked <= 4);
+    if (result.cpus_checked > 0) {
+        assert(result.worst_cpu >= 0);
+        std::cout << "  max skew " << result.max_skew_ns << " ns over " << result.cpus_checked << " CPUs" << std::endl;
+    }
+
+    std::cout << "✓ TSC sync test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running High Resolution Timer Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    try {
+        test_calibration();
+        test_wall_clock();
+        test_recalibration_keeps_timeline();
+        test_tsc_sync();
+
+        std::cout << "\n✅ All high resolution timer tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,361 @@
+#include "../common/http_server.h"
+#include <arpa/inet.h>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft;
+
+static int connect_to(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    [[maybe_unused]] int connected = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    assert(connected == 0);
+    return fd;
+}
+
+static void send_all(int fd, const std::string& data) {
+    [[maybe_unused]] ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    assert(sent == static_cast<ssize_t>(data.size()));
+}
+
+// Reads until the buffer holds at least `bytes`, or the peer stops sending
+static std::string read_at_least(int fd, std::string& buffer, size_t bytes) {
+    char chunk[4096];
+    while (buffer.size() < bytes) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return buffer;
+}
+
+// Pops one complete HTTP response (head + Content-Length body) from buffer
+static std::string read_response(int fd, std::string& buffer) {
+    for (;;) {
+        size_t head_end = buffer.find("\r\n\r\n");
+        if (head_end != std::string::npos) {
+            size_t length = 0;
+            size_t pos = buffer.find("Content-Length: ");
+            if (pos != std::string::npos && pos < head_end) {
+                length = std::stoul(buffer.substr(pos + 16));
+            }
+            size_t total = head_end + 4 + length;
+            read_at_least(fd, buffer, total);
+            std::string response = buffer.substr(0, total);
+            buffer.erase(0, total);
+            return response;
+        }
+        size_t before = buffer.size();
+        read_at_least(fd, buffer, before + 1);
+        if (buffer.size() == before) return "";
+    }
+}
+
+static std::string client_frame(const std::string& payload, uint8_t opcode = 0x1) {
+    const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string frame;
+    frame.push_back(static_cast<char>(0x80 | opcode));
+    frame.push_back(static_cast<char>(0x80 | payload.size()));     // Short payloads only
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < payload.size(); ++i) frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    return frame;
+}
+
+template<typename Predicate>
+static bool wait_for(Predicate predicate) {
+    for (int i = 0; i < 200; ++i) {
+        if (predicate()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+void test_websocket_accept_key() {
+    std::cout << "Testing WebSocket handshake key..." << std::endl;
+
+    // Example from RFC 6455 section 1.3
+    assert(websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ==") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+
+    std::string frame = websocket_frame(std::string(300, 'x'));
+    assert(static_cast<uint8_t>(frame[0]) == 0x81);
+    assert(static_cast<uint8_t>(frame[1]) == 126);
+    assert(frame.size() == 4 + 300);
+
+    HttpRequest request;
+    request.query = "service=a&metric=b.c&tier=&servicex=d";
+    assert(request.query_parameter("service") == "a");
+    assert(request.query_parameter("metric") == "b.c");
+    assert(request.query_parameter("tier").empty());
+    assert(request.query_parameter("since").empty());
+
+    std::cout << "✓ Handshake key test passed" << std::endl;
+}
+
+void test_keep_alive_pipelining() {
+    std::cout << "Testing persistent pipelined requests..." << std::endl;
+
+    HttpServer server("test");
+    server.set_request_handler([](const HttpRequest& request) {
+        if (request.path == "/echo") {
+            return HttpResponse::json("{\"body\":\"" + request.body + "\",\"key\":\"" + request.header("X-Key") + "\"}");
+        }
+        return HttpResponse::text("Endpoint not found", 404, "Not Found");
+    });
+    [[maybe_unused]] bool ok = server.listen("127.0.0.1", 0);
+    assert(ok);
+    server.start();
+
+    int fd = connect_to(server.port());
+    send_all(fd, "POST /echo?x=1 HTTP/1.1\r\nx-key: abc\r\nContent-Length: 5\r\n\r\nhello"
+                 "GET /missing HTTP/1.1\r\n\r\n");
+
+    std::string buffer;
+    std::string first = read_response(fd, buffer);
+    assert(first.find("HTTP/1.1 200 OK") == 0);
+    assert(first.find("{\"body\":\"hello\",\"key\":\"abc\"}") != std::string::npos);
+    assert(first.find("Connection: keep-alive") != std::string::npos);
+    std::string second = read_response(fd, buffer);
+    assert(second.find("HTTP/1.1 404 Not Found") == 0);
+
+    // Same connection still usable; Connection: close ends it
+    send_all(fd, "GET /echo HTTP/1.1\r\nConnection: close\r\n\r\n");
+    std::string third = read_response(fd, buffer);
+    assert(third.find("Connection: close") != std::string::npos);
+    char byte;
+    [[maybe_unused]] ssize_t closed = recv(fd, &byte, 1, 0);
+    assert(closed == 0);
+    close(fd);
+
+    assert(server.get_requests_served() == 3);
+    ok = wait_for([&] { return server.get_connection_count() == 0; });
+    assert(ok);
+
+    // A Content-Length that would wrap the size check is refused, not awaited
+    fd = connect_to(server.port());
+    buffer.clear();
+    send_all(fd, "POST /echo HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\n");
+    std::string refused = read_response(fd, buffer);
+    assert(refused.find("HTTP/1.1 413") == 0);
+    close(fd);
+    server.stop();
+
+    std::cout << "✓ Keep-alive test passed" << std::endl;
+}
+
+void test_websocket_broadcast() {
+    std::cout << "Testing WebSocket upgrade and broadcast..." << std::endl;
+
+    HttpServer server("test");
+    std::mutex received_mutex;
+    std::string received;
+    server.set_websocket_path("/ws");
+    server.set_websocket_handler([&](HttpServer::connection_id_t, const std::string& message) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received = message;
+    });
+    [[maybe_unused]] bool ok = server.listen("127.0.0.1", 0);
+    assert(ok);
+    server.start();
+
+    int clients[3];
+    std::string buffers[3];
+    for (int i = 0; i < 3; ++i) {
+        clients[i] = connect_to(server.port());
+        send_all(clients[i], "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                             "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+        std::string head = read_response(clients[i], buffers[i]);
+        assert(head.find("HTTP/1.1 101 Switching Protocols") == 0);
+        assert(head.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") != std::string::npos);
+    }
+    ok = wait_for([&] { return server.get_websocket_client_count() == 3; });
+    assert(ok);
+
+    server.broadcast("{\"tick\":1}");
+    std::string expected = websocket_frame("{\"tick\":1}");
+    for (int i = 0; i < 3; ++i) {
+        read_at_least(clients[i], buffers[i], expected.size());
+        assert(buffers[i] == expected);
+        buffers[i].clear();
+    }
+
+    // Client messages are unmasked and delivered; pings are answered
+    send_all(clients[0], client_frame("subscribe"));
+    ok = wait_for([&] {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        return received == "subscribe";
+    });
+    assert(ok);
+    send_all(clients[0], client_frame("hb", 0x9));
+    read_at_least(clients[0], buffers[0], 4);
+    assert(buffers[0] == websocket_frame("hb", 0xA));
+
+    // Close handshake
+    send_all(clients[1], client_frame("", 0x8));
+    buffers[1].clear();
+    read_at_least(clients[1], buffers[1], 2);
+    assert(static_cast<uint8_t>(buffers[1][0]) == 0x88);
+    ok = wait_for([&] { return server.get_websocket_client_count() == 2; });
+    assert(ok);
+
+    for (int fd : clients) close(fd);
+    server.stop();
+
+    std::cout << "✓ WebSocket broadcast test passed" << std::endl;
+}
+
+void test_subprotocol_negotiation() {
+    std::cout << "Testing WebSocket subprotocol negotiation..." << std::endl;
+
+    HttpServer server("test");
+    std::mutex opened_mutex;
+    std::string opened;
+    server.set_websocket_path("/ws");
+    server.set_websocket_protocols({"test.binary"});
+    server.set_websocket_open_handler([&](HttpServer::connection_id_t client, const std::string& protocol) {
+        {
+            std::lock_guard<std::mutex> lock(opened_mutex);
+            opened += "[" + protocol + "]";
+        }
+        if (protocol == "test.binary") {
+            [[maybe_unused]] bool sent = server.send(client, "hello", true);
+            assert(sent);
+        }
+    });
+    [[maybe_unused]] bool ok = server.listen("127.0.0.1", 0);
+    assert(ok);
+    server.start();
+
+    const std::string upgrade = "GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n";
+    int plain = connect_to(server.port());
+    int binary = connect_to(server.port());
+    std::string plain_buffer;
+    std::string binary_buffer;
+
+    send_all(plain, upgrade + "Sec-WebSocket-Protocol: other\r\n\r\n");
+    std::string head = read_response(plain, plain_buffer);
+    assert(head.find("101") != std::string::npos);
+    assert(head.find("Sec-WebSocket-Protocol") == std::string::npos);
+
+    send_all(binary, upgrade + "Sec-WebSocket-Protocol: other, test.binary\r\n\r\n");
+    head = read_response(binary, binary_buffer);
+    assert(head.find("Sec-WebSocket-Protocol: test.binary\r\n") != std::string::npos);
+
+    // The open handler's frame comes straight after the handshake
+    std::string hello = websocket_frame("hello", 0x2);
+    read_at_least(binary, binary_buffer, hello.size());
+    assert(binary_buffer == hello);
+    binary_buffer.clear();
+    ok = wait_for([&] { return server.get_websocket_client_count("test.binary") == 1; });
+    assert(ok);
+    assert(server.get_websocket_client_count("") == 1);
+    {
+        std::lock_guard<std::mutex> lock(opened_mutex);
+        assert(opened == "[][test.binary]");
+    }
+
+    // Broadcasts only reach their own subprotocol
+    server.broadcast("{\"json\":1}");
+    server.broadcast("bin", "test.binary", true);
+    server.broadcast("ignored", "unknown");
+    std::string json = websocket_frame("{\"json\":1}");
+    std::string bin = websocket_frame("bin", 0x2);
+    read_at_least(plain, plain_buffer, json.size());
+    read_at_least(binary, binary_buffer, bin.size());
+    assert(plain_buffer == json);
+    assert(binary_buffer == bin);
+
+    close(plain);
+    close(binary);
+    ok = wait_for([&] { return server.get_websocket_client_count("test.binary") == 0; });
+    assert(ok);
+    server.stop();
+
+    std::cout << "✓ Subprotocol test passed" << std::endl;
+}
+
+void test_slow_client_backpressure() {
+    std::cout << "Testing backpressure on a slow client..." << std::endl;
+
+    HttpServer server("test");
+    server.set_websocket_path("/ws");
+    server.set_send_queue_limit(64 * 1024);
+    [[maybe_unused]] bool ok = server.listen("127.0.0.1", 0);
+    assert(ok);
+    server.start();
+
+    // Never reads after the handshake
+    int fd = connect_to(server.port());
+    int rcvbuf = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    send_all(fd, "GET /ws HTTP/1.1\r\nUpgrade: websocket\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n");
+    std::string buffer;
+    std::string response = read_response(fd, buffer);
+    assert(response.find("101") != std::string::npos);
+    ok = wait_for([&] { return server.get_websocket_client_count() == 1; });
+    assert(ok);
+
+    const std::string payload(32 * 1024, 'x');
+    for (int i = 0; i < 200; ++i) {
+        server.broadcast(payload);
+    }
+    ok = wait_for([&] { return server.get_broadcasts() == 200; });
+    assert(ok);
+
+    // The kernel buffers some, the queue holds about the limit, the rest is skipped
+    assert(server.get_broadcasts_skipped() > 0);
+    assert(server.get_websocket_client_count() == 1);
+
+    // Events are never skipped: they queue past the limit, then the client is dropped
+    [[maybe_unused]] uint64_t skipped = server.get_broadcasts_skipped();
+    server.broadcast(payload, "", false, HttpServer::Delivery::EVERY);
+    ok = wait_for([&] { return server.get_broadcasts() == 201; });
+    assert(ok);
+    assert(server.get_broadcasts_skipped() == skipped);
+    assert(server.get_slow_clients_dropped() == 0);
+    for (int i = 0; i < 8; ++i) {
+        server.broadcast(payload, "", false, HttpServer::Delivery::EVERY);
+    }
+    ok = wait_for([&] { return server.get_slow_clients_dropped() == 1; });
+    assert(ok);
+    assert(server.get_broadcasts_skipped() == skipped);
+
+    close(fd);
+    ok = wait_for([&] { return server.get_websocket_client_count() == 0; });
+    assert(ok);
+    server.stop();
+
+    std::cout << "✓ Backpressure test passed (" << server.get_broadcasts_skipped() << " skipped)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running HTTP Server Unit Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        test_websocket_accept_key();
+        test_keep_alive_pipelining();
+        test_websocket_broadcast();
+        test_subprotocol_negotiation();
+        test_slow_client_backpressure();
+
+        std::cout << "\n✅ All HTTP server tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+#include "../common/hugepage_arena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+void test_bump_allocation() {
+    std::cout << "Testing bump allocation..." << std::endl;
+
+    HugePageArena arena(1 << 20, HugePageSize::NONE);
+    assert(arena.capacity() == (1 << 20));
+    assert(arena.used() == 0);
+
+    void* a = arena.allocate(10, 1);
+    void* b = arena.allocate(64, 64);
+    assert(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+    assert(static_cast<uint8_t*>(b) >= static_cast<uint8_t*>(a) + 10);
+    assert(arena.used() >= 74);
+
+    // Monotonic: freeing doesn't hand the bytes out again
+    size_t used = arena.used();
+    arena.deallocate(b, 64, 64);
+    assert(arena.used() == used);
+    assert(arena.get_overflow_count() == 0);
+
+    std::cout << "✓ Bump allocation test passed" << std::endl;
+}
+
+void test_overflow_goes_upstream() {
+    std::cout << "Testing overflow to the upstream resource..." << std::endl;
+
+    HugePageArena arena(4096, HugePageSize::NONE);
+    void* inside = arena.allocate(4000, 8);
+    void* outside = arena.allocate(4000, 8);
+    assert(inside && outside);
+    assert(arena.get_overflow_count() == 1);
+    assert(arena.get_overflow_bytes() == 4000);
+    arena.deallocate(outside, 4000, 8);     // Returned to the heap, not the arena
+
+    std::cout << "✓ Overflow test passed (" << arena.describe() << ")" << std::endl;
+}
+
+void test_hugepage_fallback() {
+    std::cout << "Testing hugepage request fallback..." << std::endl;
+
+    // Works whether or not the host has hugepages reserved
+    HugePageArena arena(4 << 20, HugePageSize::HUGE_1GB);
+    assert(arena.capacity() == (4 << 20));
+    std::pmr::vector<uint64_t> values(1024, 7, &arena);
+    assert(values[1023] == 7);
+    assert(arena.used() >= 1024 * sizeof(uint64_t));
+    assert(arena.get_overflow_count() == 0);
+
+    std::cout << "✓ Fallback test passed (" << arena.describe() << ")" << std::endl;
+}
+
+void test_concurrent_allocation() {
+    std::cout << "Testing concurrent allocation..." << std::endl;
+
+    constexpr size_t THREADS = 4;
+    constexpr size_t PER_THREAD = 1000;
+    HugePageArena arena(THREADS * PER_THREAD * 64, HugePageSize::NONE);
+
+    std::vector<std::vector<uint8_t*>> blocks(THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < PER_THREAD; ++i) {
+                auto* block = static_cast<uint8_t*>(arena.allocate(64, 64));
+                std::fill(block, block + 64, static_cast<uint8_t>(t));
+                blocks[t].push_back(block);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // No two threads were handed the same bytes
+    for (size_t t = 0; t < THREADS; ++t) {
+        for (uint8_t* block : blocks[t]) {
+            for (size_t i = 0; i < 64; ++i) assert(block[i] == t);
+        }
+    }
+    assert(arena.get_overflow_count() == 0);
+
+    std::cout << "✓ Concurrent allocation test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Hugepage Arena Unit Tests" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try {
+        test_bump_allocation();
+        test_overflow_goes_upstream();
+        test_hugepage_fallback();
+        test_concurrent_allocation();
+
+        std::cout << "\n✅ All hugepage arena tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
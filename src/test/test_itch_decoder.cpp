@@ -0,0 +1,390 @@
+#include "../market_data_handler/itch_decoder.h"
+#include "../common/order_book.h"
+#include "../common/static_config.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+// Builds ITCH 5.0 messages (big-endian, type byte first)
+class ItchWriter {
+public:
+    std::vector<uint8_t> stream;    // Length-prefixed, as in NASDAQ's files
+
+    void stock_directory(uint16_t locate, const char* stock) {
+        begin('R', 39, locate);
+        put_stock(11, stock);
+    }
+
+    void add(uint16_t locate, uint64_t ref, char side, uint32_t shares, const char* stock, uint32_t price) {
+        begin('A', 36, locate);
+        put64(11, ref);
+        message_[19] = static_cast<uint8_t>(side);
+        put32(20, shares);
+        put_stock(24, stock);
+        put32(32, price);
+    }
+
+    void executed(uint16_t locate, uint64_t ref, uint32_t shares) {
+        begin('E', 31, locate);
+        put64(11, ref);
+        put32(19, shares);
+        put64(23, ++match_);
+    }
+
+    void executed_with_price(uint16_t locate, uint64_t ref, uint32_t shares, bool printable, uint32_t price) {
+        begin('C', 36, locate);
+        put64(11, ref);
+        put32(19, shares);
+        put64(23, ++match_);
+        message_[31] = printable ? 'Y' : 'N';
+        put32(32, price);
+    }
+
+    void cancel(uint16_t locate, uint64_t ref, uint32_t shares) {
+        begin('X', 23, locate);
+        put64(11, ref);
+        put32(19, shares);
+    }
+
+    void remove(uint16_t locate, uint64_t ref) {
+        begin('D', 19, locate);
+        put64(11, ref);
+    }
+
+    void replace(uint16_t locate, uint64_t ref, uint64_t new_ref, uint32_t shares, uint32_t price) {
+        begin('U', 35, locate);
+        put64(11, ref);
+        put64(19, new_ref);
+        put32(27, shares);
+        put32(31, price);
+    }
+
+    void system_event() {
+        begin('S', 12, 0);
+        message_[11] = 'O';
+    }
+
+private:
+    uint8_t* message_ = nullptr;
+    uint64_t timestamp_ = 34200ULL * 1000000000ULL;     // 09:30
+    uint64_t match_ = 0;
+
+    void begin(char type, uint16_t length, uint16_t locate) {
+        size_t offset = stream.size();
+        stream.resize(offset + 2 + length, 0);
+        stream[offset] = static_cast<uint8_t>(length >> 8);
+        stream[offset + 1] = static_cast<uint8_t>(length);
+        message_ = stream.data() + offset + 2;
+        message_[0] = static_cast<uint8_t>(type);
+        put16(1, locate);
+        timestamp_ += 1000;
+        for (int i = 0; i < 6; ++i) {
+            message_[5 + i] = static_cast<uint8_t>(timestamp_ >> (8 * (5 - i)));
+        }
+    }
+
+    void put16(size_t at, uint16_t v) {
+        message_[at] = static_cast<uint8_t>(v >> 8);
+        message_[at + 1] = static_cast<uint8_t>(v);
+    }
+    void put32(size_t at, uint32_t v) {
+        for (int i = 0; i < 4; ++i) message_[at + i] = static_cast<uint8_t>(v >> (8 * (3 - i)));
+    }
+    void put64(size_t at, uint64_t v) {
+        for (int i = 0; i < 8; ++i) message_[at + i] = static_cast<uint8_t>(v >> (8 * (7 - i)));
+    }
+    void put_stock(size_t at, const char* stock) {
+        std::memset(message_ + at, ' ', 8);
+        std::memcpy(message_ + at, stock, std::strlen(stock));
+    }
+};
+
+void test_book_building() {
+    std::cout << "Testing order-level book building..." << std::endl;
+
+    ItchWriter feed;
+    feed.stock_directory(7, "AAPL");
+    feed.add(7, 1, 'B', 100, "AAPL", 1500000);     // 150.00
+    feed.add(7, 2, 'B', 200, "AAPL", 1500000);
+    feed.add(7, 3, 'B', 300, "AAPL", 1499900);     // 149.99
+    feed.add(7, 4, 'S', 150, "AAPL", 1500100);     // 150.01
+    feed.add(7, 5, 'S', 250, "AAPL", 1500200);
+
+    ItchDecoder decoder(1024);
+    OrderBookManager books;
+    std::vector<OrderBookUpdate> updates;
+    std::vector<ItchTrade> trades;
+    decoder.set_book_update_callback([&](const OrderBookUpdate& update) {
+        updates.push_back(update);
+        books.process_update(update);
+    });
+    decoder.set_trade_callback([&](const ItchTrade& trade) { trades.push_back(trade); });
+
+    [[maybe_unused]] size_t consumed = decoder.decode_stream(feed.stream.data(), feed.stream.size());
+    assert(consumed == feed.stream.size());
+    assert(decoder.messages_decoded() == 6);
+    assert(decoder.live_orders() == 5);
+    assert(updates.size() == 5);
+    assert(updates[0].update_type == BookUpdateType::ADD);
+    assert(updates[1].update_type == BookUpdateType::UPDATE);     // Second order at 150.00
+    assert(updates[1].level.size == 300 && updates[1].level.order_count == 2);
+    assert(std::string(updates[0].symbol) == "AAPL");
+
+    [[maybe_unused]] IOrderBook* book = books.get_book("AAPL");
+    assert(book);
+    assert(book->get_best_bid_fixed() == to_fixed_price(150.00));
+    assert(book->get_best_ask_fixed() == to_fixed_price(150.01));
+    assert(book->get_bid_size_at_level(0) == 300);
+    assert(book->get_bid_size_at_level(1) == 300);
+    assert(book->get_book_depth(BookSide::ASK) == 2);
+
+    // Partial execution, partial cancel, then the rest of the top bid goes
+    feed.stream.clear();
+    feed.executed(7, 1, 40);
+    feed.cancel(7, 2, 50);
+    feed.executed_with_price(7, 1, 60, true, 1500050);
+    feed.remove(7, 2);
+    decoder.decode_stream(feed.stream.data(), feed.stream.size());
+
+    assert(trades.size() == 2);
+    assert(trades[0].price == to_fixed_price(150.00) && trades[0].shares == 40);
+    assert(trades[1].price == to_fixed_price(150.005) && trades[1].shares == 60);
+    assert(updates.back().update_type == BookUpdateType::DELETE);
+    assert(book->get_best_bid_fixed() == to_fixed_price(149.99));
+    assert(book->get_bid_size_at_level(0) == 300);
+    assert(decoder.live_orders() == 3);
+
+    // Replace moves the ask to a new price under a new reference
+    feed.stream.clear();
+    feed.replace(7, 4, 40, 500, 1500000);
+    decoder.decode_stream(feed.stream.data(), feed.stream.size());
+    assert(book->get_best_ask_fixed() == to_fixed_price(150.00));
+    assert(book->get_ask_size_at_level(0) == 500);
+    assert(book->get_book_depth(BookSide::ASK) == 2);
+    assert(decoder.live_orders() == 3);
+
+    // The old reference is gone
+    feed.stream.clear();
+    feed.remove(7, 4);
+    decoder.decode_stream(feed.stream.data(), feed.stream.size());
+    assert(decoder.missing_orders() == 1);
+
+    // Sequence numbers keep increasing, so books accept every update
+    for (size_t i = 1; i < updates.size(); ++i) {
+        assert(updates[i].sequence_number > updates[i - 1].sequence_number);
+    }
+
+    std::cout << "✓ Book building test passed" << std::endl;
+}
+
+void test_framing_and_filter() {
+    std::cout << "Testing framing, unknown types and symbol filter..." << std::endl;
+
+    ItchWriter feed;
+    feed.system_event();
+    feed.stock_directory(1, "MSFT");
+    feed.stock_directory(2, "ZZZZ");
+    feed.add(1, 10, 'B', 100, "MSFT", 4000000);
+    feed.add(2, 11, 'B', 100, "ZZZZ", 100000);
+    feed.remove(2, 11);
+
+    ItchDecoder decoder(64);
+    decoder.set_symbol_filter({"MSFT"});
+    size_t updates = 0;
+    decoder.set_book_update_callback([&]([[maybe_unused]] const OrderBookUpdate& update) {
+        assert(std::string(update.symbol) == "MSFT");
+        updates++;
+    });
+
+    // MoldUDP64: session, sequence number, message count, then the blocks
+    std::vector<uint8_t> packet(20, 0);
+    std::memcpy(packet.data(), "SESSION001", 10);
+    packet[19] = 6;
+    packet.insert(packet.end(), feed.stream.begin(), feed.stream.end());
+    [[maybe_unused]] bool ok = decoder.decode_moldudp64(packet.data(), packet.size());
+    assert(ok && updates == 1);
+    assert(decoder.live_orders() == 1);
+    assert(decoder.missing_orders() == 0);      // Filtered stock isn't looked up
+
+    // Count that doesn't match the blocks is rejected untouched
+    packet[19] = 7;
+    ok = decoder.decode_moldudp64(packet.data(), packet.size());
+    assert(!ok);
+    assert(decoder.messages_decoded() == 6);
+
+    // Partial trailing message is left for the next call
+    ItchDecoder partial(64);
+    [[maybe_unused]] size_t consumed = partial.decode_stream(feed.stream.data(), feed.stream.size() - 3);
+    assert(consumed == feed.stream.size() - (2 + 19));
+    assert(partial.messages_decoded() == 5);
+
+    uint8_t unknown[12] = {'Z'};
+    ok = decoder.decode_message(unknown, sizeof(unknown));
+    assert(!ok);
+    assert(decoder.unknown_messages() == 1);
+    uint8_t truncated[10] = {'A'};
+    ok = decoder.decode_message(truncated, sizeof(truncated));
+    assert(!ok);
+    assert(decoder.malformed_messages() == 1);
+
+    std::cout << "✓ Framing and filter test passed" << std::endl;
+}
+
+void test_table_capacity() {
+    std::cout << "Testing order table capacity..." << std::endl;
+
+    ItchWriter feed;
+    for (uint64_t ref = 1; ref <= 20; ++ref) {
+        feed.add(3, ref, 'S', 10, "TSLA", 2000000 + static_cast<uint32_t>(ref) * 100);
+    }
+    ItchDecoder decoder(16);
+    decoder.decode_stream(feed.stream.data(), feed.stream.size());
+    assert(decoder.live_orders() == 16);
+    assert(decoder.orders_dropped() == 4);
+
+    // Deleting frees room again, and every level goes with its only order
+    feed.stream.clear();
+    for (uint64_t ref = 1; ref <= 16; ++ref) {
+        feed.remove(3, ref);
+    }
+    feed.add(3, 100, 'S', 10, "TSLA", 2000000);
+    decoder.decode_stream(feed.stream.data(), feed.stream.size());
+    assert(decoder.live_orders() == 1);
+
+    std::cout << "✓ Capacity test passed" << std::endl;
+}
+
+// Synthetic session: adds around a drifting mid, then a day-like mix of
+// executions, cancels, deletes and replaces against live orders
+static std::vector<uint8_t> make_session(size_t messages) {
+    ItchWriter feed;
+    const char* stocks[] = {"AAPL", "MSFT", "TSLA", "AMZN", "NVDA", "META", "GOOG", "SPY"};
+    for (uint16_t i = 0; i < 8; ++i) {
+        feed.stock_directory(i + 1, stocks[i]);
+    }
+
+    std::mt19937_64 rng(42);
+    std::vector<std::pair<uint64_t, uint16_t>> live;
+    uint64_t next_ref = 1;
+    for (size_t n = 0; n < messages; ++n) {
+        uint64_t roll = rng() % 100;
+        if (live.size() < 1000 || roll < 45) {
+            uint16_t locate = static_cast<uint16_t>(1 + rng() % 8);
+            bool buy = rng() & 1;
+            uint32_t price = 1000000 + static_cast<uint32_t>(rng() % 200) * 100 + (buy ? 0 : 20000);
+            feed.add(locate, next_ref, buy ? 'B' : 'S', 100 * (1 + rng() % 5), stocks[locate - 1], price);
+            live.emplace_back(next_ref++, locate);
+            continue;
+        }
+        size_t pick = rng() % live.size();
+        auto [ref, locate] = live[pick];
+        if (roll < 55) {
+            feed.executed(locate, ref, 100);
+        } else if (roll < 65) {
+            feed.cancel(locate, ref, 100);
+        } else if (roll < 90) {
+            feed.remove(locate, ref);
+            live[pick] = live.back();
+            live.pop_back();
+        } else {
+            feed.replace(locate, ref, next_ref, 200, 1000000 + static_cast<uint32_t>(rng() % 200) * 100);
+            live[pick] = {next_ref++, locate};
+        }
+    }
+    return feed.stream;
+}
+
+static void report_throughput(const char* label, const ItchDecoder& decoder, double seconds) {
+    std::cout << "  " << label << ": " << decoder.messages_decoded() << " messages in " << seconds << " s = "
+              << static_cast<uint64_t>(decoder.messages_decoded() / seconds) << " msgs/sec ("
+              << decoder.book_updates() << " level updates, " << decoder.live_orders() << " live orders at end)"
+              << std::endl;
+}
+
+void test_decode_throughput() {
+    std::cout << "Testing decode throughput..." << std::endl;
+
+    std::vector<uint8_t> session = make_session(2000000);
+    ItchDecoder decoder(1 << 20);
+    uint64_t updates = 0;
+    decoder.set_book_update_callback([&](const OrderBookUpdate&) { updates++; });
+
+    auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] size_t consumed = decoder.decode_stream(session.data(), session.size());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    assert(consumed == session.size());
+    assert(decoder.malformed_messages() == 0 && decoder.unknown_messages() == 0);
+    assert(updates == decoder.book_updates());
+    report_throughput("Synthetic session", decoder, seconds);
+    assert(decoder.messages_decoded() / seconds > 1000000);      // Generous floor; debug builds included
+
+    std::cout << "✓ Throughput test passed" << std::endl;
+}
+
+// Full-day benchmark: test_itch_decoder <file>, e.g. NASDAQ's
+// 01302019.NASDAQ_ITCH50 (length-prefixed messages, uncompressed)
+void benchmark_file(const char* path) {
+    std::cout << "Benchmarking " << path << "..." << std::endl;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return;
+    }
+
+    ItchDecoder decoder(StaticConfig::ITCH_MAX_ORDERS * 2);     // All symbols, no filter
+    uint64_t updates = 0;
+    decoder.set_book_update_callback([&](const OrderBookUpdate&) { updates++; });
+
+    // Chunked reads; a message split across chunks carries over
+    std::vector<uint8_t> buffer(64 << 20);
+    size_t carried = 0;
+    double decode_seconds = 0;
+    while (file) {
+        file.read(reinterpret_cast<char*>(buffer.data() + carried), static_cast<std::streamsize>(buffer.size() - carried));
+        size_t available = carried + static_cast<size_t>(file.gcount());
+        if (available == 0) break;
+
+        auto start = std::chrono::steady_clock::now();
+        size_t consumed = decoder.decode_stream(buffer.data(), available);
+        decode_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        carried = available - consumed;
+        std::memmove(buffer.data(), buffer.data() + consumed, carried);
+    }
+
+    report_throughput("File", decoder, decode_seconds);
+    std::cout << "  trades=" << decoder.trades() << ", missing_orders=" << decoder.missing_orders()
+              << ", orders_dropped=" << decoder.orders_dropped() << ", unknown=" << decoder.unknown_messages()
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "Running ITCH Decoder Tests" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    try {
+        test_book_building();
+        test_framing_and_filter();
+        test_table_capacity();
+        test_decode_throughput();
+        if (argc > 1) {
+            benchmark_file(argv[1]);
+        }
+
+        std::cout << "\n✅ All ITCH decoder tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,167 @@
+#include "../common/kill_switch.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft;
+
+static bool readable(int fd) {
+    pollfd entry{fd, POLLIN, 0};
+    return ::poll(&entry, 1, 0) > 0;
+}
+
+void test_words() {
+    std::cout << "Testing trigger and reset words..." << std::endl;
+
+    KillSwitch& kill = KillSwitch::instance();
+    [[maybe_unused]] uint64_t start = kill.word();
+    assert(!kill.halted());
+
+    [[maybe_unused]] int64_t before = KillSwitch::now();
+    [[maybe_unused]] uint64_t halted = kill.trigger();
+    assert(kill.word() == halted && kill.halted() && KillSwitch::halted(halted));
+    assert(kill.triggered_ns() >= before);
+
+    // Each trigger is a new word, halted or not, so no party misses one
+    [[maybe_unused]] uint64_t again = kill.trigger();
+    assert(again != halted && KillSwitch::halted(again));
+    [[maybe_unused]] uint64_t reset = kill.reset();
+    assert(!kill.halted() && !KillSwitch::halted(reset));
+    assert(reset != start && reset > again);
+
+    std::cout << "✓ Word test passed" << std::endl;
+}
+
+void test_acknowledgements() {
+    std::cout << "Testing acknowledgements..." << std::endl;
+
+    KillSwitch& kill = KillSwitch::instance();
+    uint64_t word = kill.trigger();
+    assert(kill.ack_latency_ns(KillParty::GATEWAY, word) == -1);
+
+    // Bounded: nobody answers, the wait gives up at the timeout
+    auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] int64_t timed_out = kill.wait_for_ack(KillParty::GATEWAY, word, std::chrono::milliseconds(20));
+    assert(timed_out == -1);
+    [[maybe_unused]] auto waited = std::chrono::steady_clock::now() - start;
+    assert(waited >= std::chrono::milliseconds(20) && waited < std::chrono::seconds(1));
+
+    std::thread gateway([&] {
+        while (kill.word() != word) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        kill.acknowledge(KillParty::GATEWAY, word);
+    });
+    [[maybe_unused]] int64_t latency = kill.wait_for_ack(KillParty::GATEWAY, word, std::chrono::seconds(5));
+    gateway.join();
+    assert(latency >= 2000000 && latency < 5000000000LL);
+    assert(kill.ack_latency_ns(KillParty::GATEWAY, word) == latency);
+
+    // An acknowledgement is for one word only
+    assert(kill.ack_latency_ns(KillParty::STRATEGY, word) == -1);
+    uint64_t next = kill.trigger();
+    assert(kill.ack_latency_ns(KillParty::GATEWAY, next) == -1);
+    kill.acknowledge(KillParty::STRATEGY, next, kill.triggered_ns() + 1500);
+    assert(kill.ack_latency_ns(KillParty::STRATEGY, next) == 1500);
+    kill.reset();
+
+    std::cout << "✓ Acknowledgement test passed" << std::endl;
+}
+
+void test_wake_socket() {
+    std::cout << "Testing the wake socket..." << std::endl;
+
+    KillSwitch& kill = KillSwitch::instance();
+    int fd = kill.wake_fd(KillParty::STRATEGY);
+    assert(fd >= 0);
+    assert(kill.wake_fd(KillParty::STRATEGY) == fd);
+    kill.drain_wake(KillParty::STRATEGY);
+    [[maybe_unused]] bool woken = readable(fd);
+    assert(!woken);
+
+    kill.trigger();
+    woken = readable(fd);
+    assert(woken);
+    kill.drain_wake(KillParty::STRATEGY);
+    woken = readable(fd);
+    assert(!woken);
+
+    // Resets wake the loops too, to resume
+    kill.reset();
+    woken = readable(fd);
+    assert(woken);
+    kill.drain_wake(KillParty::STRATEGY);
+
+    std::cout << "✓ Wake socket test passed" << std::endl;
+}
+
+void test_across_processes(const std::string& name) {
+    std::cout << "Testing a kill across processes..." << std::endl;
+
+    KillSwitch& kill = KillSwitch::instance();
+    assert(kill.is_shared());
+    uint64_t start = kill.word();
+
+    pid_t child = ::fork();
+    assert(child >= 0);
+    if (child == 0) {
+        // The gateway's loop: one load per iteration, acknowledge what changed
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            uint64_t word = kill.word();
+            if (word != start && KillSwitch::halted(word)) {
+                kill.acknowledge(KillParty::GATEWAY, word);
+                ::_exit(0);
+            }
+        }
+        ::_exit(1);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t word = kill.trigger();
+    int64_t latency = kill.wait_for_ack(KillParty::GATEWAY, word, std::chrono::seconds(5));
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(latency >= 0 && latency < 5000000000LL);
+    std::cout << "  gateway acknowledged in " << latency << "ns" << std::endl;
+    kill.reset();
+    ::shm_unlink(("/" + name).c_str());
+
+    std::cout << "✓ Cross-process test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Kill Switch Unit Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        // A kill raised before the segment is mapped carries over to it
+        std::string name = "hft_kill_switch_test_" + std::to_string(::getpid());
+        KillSwitch& kill = KillSwitch::instance();
+        kill.trigger();
+        bool shared = kill.open(name);
+        assert(kill.halted());
+        kill.reset();
+
+        test_words();
+        test_acknowledgements();
+        test_wake_socket();
+        if (shared) {
+            test_across_processes(name);
+        } else {
+            std::cout << "(no /dev/shm: cross-process test skipped)" << std::endl;
+        }
+
+        std::cout << "\n✅ All kill switch tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
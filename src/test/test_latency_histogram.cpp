@@ -0,0 +1,97 @@
+#include "../common/latency_histogram.h"
+#include "../common/metrics_collector.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+static bool within_resolution(uint64_t actual, uint64_t expected) {
+    double error = std::abs(static_cast<double>(actual) - static_cast<double>(expected));
+    return error <= static_cast<double>(expected) / histogram::SUB_BUCKETS + 1.0;
+}
+
+void test_bucket_layout() {
+    std::cout << "Testing log-linear bucket layout..." << std::endl;
+
+    // Small values are exact; buckets tile the range with no gaps
+    for (uint64_t v = 0; v < histogram::SUB_BUCKETS; ++v) {
+        assert(histogram::bucket_index(v) == v);
+    }
+    for (size_t i = 1; i < histogram::BUCKET_COUNT; ++i) {
+        assert(histogram::bucket_lower_bound(i) == histogram::bucket_upper_bound(i - 1) + 1);
+        assert(histogram::bucket_index(histogram::bucket_lower_bound(i)) == i);
+        assert(histogram::bucket_index(histogram::bucket_upper_bound(i)) == i);
+    }
+    assert(histogram::bucket_index(UINT64_MAX) == histogram::BUCKET_COUNT - 1);
+
+    std::cout << "✓ Bucket layout test passed" << std::endl;
+}
+
+void test_percentiles() {
+    std::cout << "Testing histogram percentiles..." << std::endl;
+
+    LatencyHistogram hist;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        hist.record(v);
+    }
+
+    HistogramSnapshot snapshot;
+    snapshot.add(hist);
+    assert(snapshot.total == 100000);
+    assert(snapshot.min_value == 1 && snapshot.max_value == 100000);
+    assert(within_resolution(snapshot.percentile(0.50), 50000));
+    assert(within_resolution(snapshot.percentile(0.99), 99000));
+    assert(within_resolution(snapshot.percentile(0.999), 99900));
+    assert(within_resolution(snapshot.percentile(0.9999), 99990));
+    assert(snapshot.percentile(1.0) == 100000);
+    assert(snapshot.count_at_or_below(63) == 63);
+
+    std::cout << "✓ Percentile test passed" << std::endl;
+}
+
+void test_collector_merge() {
+    std::cout << "Testing per-thread histogram merge..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    collector.clear();
+
+    // Each thread records into its own histogram; get_statistics merges them
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&collector, t] {
+            for (uint64_t i = 0; i < 25000; ++i) {
+                collector.record_latency("test.merge_latency_ns", t * 25000 + i + 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = collector.get_statistics();
+    const MetricStats& merged = stats.at("test.merge_latency_ns");
+    assert(merged.type == MetricType::LATENCY);
+    assert(merged.count == 100000);
+    assert(merged.min_value == 1 && merged.max_value == 100000);
+    assert(within_resolution(merged.p50, 50000));
+    assert(within_resolution(merged.p9999, 99990));
+
+    collector.clear();
+    assert(collector.get_statistics().at("test.merge_latency_ns").count == 0);
+
+    std::cout << "✓ Per-thread merge test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running latency histogram tests..." << std::endl;
+
+    test_bucket_layout();
+    test_percentiles();
+    test_collector_merge();
+
+    std::cout << "All latency histogram tests passed!" << std::endl;
+    return 0;
+}
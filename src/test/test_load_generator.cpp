@@ -0,0 +1,159 @@
+#include "../market_data_handler/load_generator.h"
+#include "../common/static_config.h"
+#include "../common/symbol_table.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace hft;
+
+static std::vector<std::string> synthetic_symbols(size_t count) {
+    std::vector<std::string> symbols = {"AAPL", "MSFT"};
+    for (size_t i = 0; symbols.size() < count; ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "LT%05zu", i);
+        symbols.push_back(name);
+    }
+    return symbols;
+}
+
+void test_normal_draws() {
+    std::cout << "Testing Ziggurat normal draws..." << std::endl;
+
+    BlockRandom random(7);
+    std::vector<double> draws(1 << 20);
+    random.fill_normal(draws.data(), draws.size());
+
+    double sum = 0.0, sum_sq = 0.0, sum_4 = 0.0;
+    size_t beyond_3 = 0;
+    for (double x : draws) {
+        sum += x;
+        sum_sq += x * x;
+        sum_4 += x * x * x * x;
+        if (std::fabs(x) > 3.0) beyond_3++;
+    }
+    double n = static_cast<double>(draws.size());
+    double mean = sum / n;
+    double variance = sum_sq / n - mean * mean;
+    double kurtosis = sum_4 / n / (variance * variance);
+    assert(std::fabs(mean) < 0.005);
+    assert(std::fabs(variance - 1.0) < 0.01);
+    assert(std::fabs(kurtosis - 3.0) < 0.05);
+    // P(|Z| > 3) = 0.0027; the tail code is what produces these
+    assert(std::fabs(beyond_3 / n - 0.0027) < 0.0005);
+
+    // Same seed, same stream; odd lengths take the tail path of fill()
+    BlockRandom a(42), b(42);
+    std::vector<uint64_t> x(13), y(13);
+    a.fill(x.data(), x.size());
+    b.fill(y.data(), y.size());
+    assert(x == y);
+
+    std::cout << "✓ Normal draw test passed" << std::endl;
+}
+
+void test_rate_profiles() {
+    std::cout << "Testing rate profiles..." << std::endl;
+
+    LoadProfile profile;
+    assert(parse_load_profile("open", profile) && profile == LoadProfile::OPEN);
+    assert(parse_load_profile("bursts", profile) && profile == LoadProfile::BURSTS);
+    assert(!parse_load_profile("pre-market", profile));
+
+    assert(load_rate_multiplier(LoadProfile::FLAT, 123456789) == 1.0);
+    assert(std::fabs(load_rate_multiplier(LoadProfile::OPEN, 0) - 5.0) < 1e-9);
+    assert(load_rate_multiplier(LoadProfile::OPEN, 60'000'000'000ULL) < 5.0);
+    assert(load_rate_multiplier(LoadProfile::OPEN, 3'600'000'000'000ULL) < 1.001);
+    assert(load_rate_multiplier(LoadProfile::BURSTS, 5'010'000'000ULL) == 10.0);
+    assert(load_rate_multiplier(LoadProfile::BURSTS, 5'500'000'000ULL) == 1.0);
+
+    std::cout << "✓ Rate profile test passed" << std::endl;
+}
+
+void test_pacing_and_quotes() {
+    std::cout << "Testing pacing and generated quotes..." << std::endl;
+
+    auto symbols = synthetic_symbols(10000);
+    SymbolTable::instance().preload(symbols);
+    LoadGenerator generator(symbols, 1'000'000.0, LoadProfile::FLAT, 1);
+    assert(generator.symbol_count() == 10000);
+
+    // 1ms steps over one simulated second: the rate, to within one quote
+    std::vector<MarketData> quotes(4096);
+    std::vector<uint64_t> hits(symbols.size());
+    size_t total = 0;
+    for (uint64_t ms = 1; ms <= 1000; ++ms) {
+        size_t n = generator.generate(ms * 1'000'000, quotes.data(), quotes.size());
+        for (size_t i = 0; i < n; ++i) {
+            const MarketData& q = quotes[i];
+            assert(q.bid_price > 0 && q.bid_price <= q.last_price && q.last_price <= q.ask_price);
+            assert(q.bid_size >= 1 && q.ask_size >= 1 && q.last_size >= 1);
+            assert(q.symbol_id == SymbolTable::instance().find(q.symbol));
+            assert(SymbolTable::instance().is_preloaded(q.symbol_id));
+            hits[q.symbol_id - SymbolTable::instance().find(symbols[0].c_str())]++;
+        }
+        total += n;
+    }
+    assert(total >= 999'999 && total <= 1'000'000);
+    assert(generator.generated() == total && generator.shortfall() == 0);
+
+    // Activity is skewed towards the front of the list, but reaches the end
+    uint64_t front = 0, back = 0;
+    for (size_t i = 0; i < 1000; ++i) front += hits[i];
+    for (size_t i = 9000; i < 10000; ++i) back += hits[i];
+    assert(front > 5 * back && back > 0);
+
+    // Prices stay positive however far the walk goes
+    for (size_t i = 0; i < generator.symbol_count(); ++i) {
+        assert(generator.mid(i) > 0.0);
+    }
+
+    // A consumer that stops calling loses the backlog past 10ms, counted
+    size_t n = generator.generate(1'500'000'000, quotes.data(), quotes.size());
+    assert(n == quotes.size());
+    assert(generator.shortfall() >= 490'000 - 10'000 - 1);
+
+    std::cout << "✓ Pacing and quote test passed" << std::endl;
+}
+
+void test_throughput() {
+    std::cout << "Testing generation throughput..." << std::endl;
+
+    auto symbols = synthetic_symbols(10000);
+    LoadGenerator generator(symbols, 1e9, LoadProfile::FLAT, 3);
+    std::vector<MarketData> quotes(4096);
+
+    // Ask for far more than can be made, so the loop measures generation
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t step = 1; step <= 500; ++step) {
+        total += generator.generate(step * 1'000'000, quotes.data(), quotes.size());
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = total / elapsed;
+    assert(total == 500 * quotes.size());
+
+    std::cout << "✓ Throughput test passed (" << static_cast<uint64_t>(rate) << " quotes/s)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Load Generator Unit Tests" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try {
+        test_normal_draws();
+        test_rate_profiles();
+        test_pacing_and_quotes();
+        test_throughput();
+
+        std::cout << "\n✅ All load generator tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
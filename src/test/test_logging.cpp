@@ -1,9 +1,12 @@
 #include "../common/logging.h"
 #include "../common/static_config.h"
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 using namespace hft;
 
@@ -94,6 +97,141 @@ void test_performance_logging() {
     std::cout << "✓ Logging performance test passed" << std::endl;
 }
 
+void test_binary_record_rendering() {
+    std::cout << "Testing binary record encoding..." << std::endl;
+    
+    std::string symbol = "AAPL";
+    size_t size = binlog::entry_size(symbol, 100u, 150.25, -3, 'x', true, "tail");
+    std::vector<char> record(size);
+    binlog::encode_entry(record.data(), size, 0, LogLevel::INFO, 0, 0, 0, symbol, 100u, 150.25, -3, 'x', true, "tail");
+    
+    std::string message;
+    const char* args = record.data() + sizeof(binlog::RecordHeader);
+    size_t args_size = size - sizeof(binlog::RecordHeader);
+    [[maybe_unused]] bool rendered = binlog::render_message(message, "{} {} @ {} ({}) {} {}", args, args_size);
+    assert(rendered);
+    assert(message == "AAPL 100 @ 150.250000 (-3) x true tail");
+    
+    // Truncated argument bytes are reported, never read past
+    message.clear();
+    rendered = binlog::render_message(message, "{} {} @ {}", args, args_size - 18);
+    assert(!rendered);
+    
+    // Extremes render in full, the same as std::to_string
+    size = binlog::entry_size(-1e300, INT64_MIN, UINT64_MAX);
+    record.resize(size);
+    binlog::encode_entry(record.data(), size, 0, LogLevel::INFO, 0, 0, 0, -1e300, INT64_MIN, UINT64_MAX);
+    message.clear();
+    rendered = binlog::render_message(message, "{} {} {}", record.data() + sizeof(binlog::RecordHeader),
+                                      size - sizeof(binlog::RecordHeader));
+    assert(rendered);
+    assert(message == std::to_string(-1e300) + " " + std::to_string(INT64_MIN) + " " + std::to_string(UINT64_MAX));
+    
+    std::cout << "✓ Binary record encoding test passed" << std::endl;
+}
+
+void test_thread_ring_wraparound() {
+    std::cout << "Testing per-thread ring wraparound..." << std::endl;
+    
+    binlog::ThreadRing ring;
+    const size_t record_size = 1000;     // Doesn't divide the capacity evenly
+    uint64_t written = 0, read = 0;
+    
+    for (int round = 0; round < 2000; ++round) {
+        while (char* out = ring.reserve(record_size)) {
+            uint16_t size = record_size;
+            std::memcpy(out, &size, sizeof(size));
+            std::memcpy(out + sizeof(size), &written, sizeof(written));
+            ring.commit();
+            written++;
+        }
+        // Drain about half, so producer and consumer both cross the end
+        size_t budget = 100;
+        ring.drain([&](const char* record, size_t size) {
+            if (budget == 0) return false;
+            budget--;
+            uint64_t sequence;
+            std::memcpy(&sequence, record + sizeof(uint16_t), sizeof(sequence));
+            assert(size == record_size && sequence == read);
+            read++;
+            return true;
+        });
+    }
+    ring.drain([&](const char*, size_t) { read++; return true; });
+    assert(read == written && ring.empty());
+    
+    std::cout << "✓ Ring wraparound test passed (" << written << " records)" << std::endl;
+}
+
+void test_log_decoder() {
+    std::cout << "Testing offline decoder..." << std::endl;
+    
+    // What a process sends: definitions ahead of the entries that use them
+    std::vector<char> batch(sizeof(binlog::BatchHeader));
+    auto append_definition = [&](binlog::RecordKind kind, uint32_t format_id, uint16_t component_id,
+                                 const std::string& text) {
+        binlog::RecordHeader header{static_cast<uint16_t>(sizeof(header) + text.size()), kind,
+                                    LogLevel::INFO, component_id, 0, format_id, 0};
+        const char* bytes = reinterpret_cast<const char*>(&header);
+        batch.insert(batch.end(), bytes, bytes + sizeof(header));
+        batch.insert(batch.end(), text.begin(), text.end());
+    };
+    auto append_entry = [&](uint32_t format_id, uint16_t component_id, uint32_t quantity) {
+        size_t size = binlog::entry_size(quantity);
+        size_t offset = batch.size();
+        batch.resize(offset + size);
+        binlog::encode_entry(batch.data() + offset, size, component_id, LogLevel::WARNING, 0, format_id,
+                             1700000000123000000LL, quantity);
+    };
+    append_definition(binlog::RecordKind::FORMAT, 5, 0, "Filled {} shares");
+    append_definition(binlog::RecordKind::COMPONENT, 0, 2, "OrderGateway");
+    append_entry(5, 2, 300);
+    append_entry(9, 2, 7);      // Definition not seen yet
+    
+    binlog::BatchHeader header{binlog::BATCH_MAGIC, 42, 1, static_cast<uint32_t>(batch.size() - sizeof(header)), 3};
+    std::memcpy(batch.data(), &header, sizeof(header));
+    
+    binlog::LogDecoder decoder;
+    std::string text;
+    assert(decoder.decode_batch(batch.data(), batch.size(), text));
+    assert(decoder.entries_decoded() == 2 && decoder.dropped_reported() == 3);
+    assert(text.find("] [WARN]  OrderGateway: Filled 300 shares\n") != std::string::npos);
+    assert(text.find("OrderGateway: <format 9> 7\n") != std::string::npos);
+    
+    header.magic = 0;
+    std::memcpy(batch.data(), &header, sizeof(header));
+    assert(!decoder.decode_batch(batch.data(), batch.size(), text));
+    
+    std::cout << "✓ Decoder test passed" << std::endl;
+}
+
+void test_deferred_format_latency() {
+    std::cout << "Measuring deferred-format log call latency..." << std::endl;
+    
+    Logger logger("DeferredLatencyTest", StaticConfig::get_logger_endpoint());
+    logger.set_console_output(false);
+    
+    // Start from an empty ring and stay under its capacity, so nothing is dropped
+    Logger::flush();
+    const int iterations = 2000;
+    const char* symbol = "MSFT";
+    uint64_t dropped_before = binlog::dropped_records();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        HFT_LOGF(logger, LogLevel::INFO, "Signal {} qty={} px={}", symbol, i, 410.5 + i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    assert(binlog::dropped_records() == dropped_before);
+    
+    // Filtered calls cost one compare
+    logger.set_log_level(LogLevel::WARNING);
+    HFT_LOGF(logger, LogLevel::INFO, "Never recorded {}", 1);
+    Logger::flush();
+    
+    std::cout << "  " << ns / iterations << " ns per call" << std::endl;
+    std::cout << "✓ Deferred-format latency measurement done" << std::endl;
+}
+
 int main() {
     std::cout << "Running Logging Unit Tests" << std::endl;
     std::cout << "=========================" << std::endl;
@@ -107,6 +245,10 @@ int main() {
         test_global_logger();
         test_message_factory_log_creation();
         test_performance_logging();
+        test_binary_record_rendering();
+        test_thread_ring_wraparound();
+        test_log_decoder();
+        test_deferred_format_latency();
         
         std::cout << "\n✅ All logging tests passed!" << std::endl;
         return 0;
@@ -1,7 +1,10 @@
 #include "../common/message_types.h"
+#include "../common/fixed_format.h"
+#include "../common/binary_log.h"
 #include <cassert>
 #include <iostream>
 #include <cstring>
+#include <vector>
 
 using namespace hft;
 
@@ -18,6 +21,27 @@ void test_message_header_creation() {
     std::cout << "✓ Message header creation test passed" << std::endl;
 }
 
+void test_tsc_header_creation() {
+    std::cout << "Testing TSC-stamped header creation..." << std::endl;
+    
+    auto before = std::chrono::duration_cast<timestamp_t>(
+        std::chrono::system_clock::now().time_since_epoch());
+    auto first = MessageFactory::create_header_tsc(MessageType::ORDER_EXECUTION, 64);
+    auto second = MessageFactory::create_header(MessageType::ORDER_EXECUTION, 64);
+    
+    assert(first.type == MessageType::ORDER_EXECUTION);
+    assert(first.payload_size == 64);
+    assert(second.sequence_number == first.sequence_number + 1);
+    // Same wall clock as create_header, to well within validation slack
+    assert(std::chrono::abs(first.timestamp - before) < std::chrono::seconds(1));
+    
+    Message msg;
+    msg.log_message = MessageFactory::create_log_message(LogLevel::INFO, "test", "tsc");
+    assert(MessageFactory::validate_message(msg));
+    
+    std::cout << "✓ TSC header creation test passed" << std::endl;
+}
+
 void test_market_data_creation() {
     std::cout << "Testing market data message creation..." << std::endl;
     
@@ -27,11 +51,11 @@ void test_market_data_creation() {
     
     assert(data.header.type == MessageType::MARKET_DATA);
     assert(std::strcmp(data.symbol, "AAPL") == 0);
-    assert(data.bid_price == 150.0);
-    assert(data.ask_price == 150.5);
+    assert(data.bid_price == to_fixed_price(150.0));
+    assert(data.ask_price == to_fixed_price(150.5));
     assert(data.bid_size == 1000);
     assert(data.ask_size == 800);
-    assert(data.last_price == 150.25);
+    assert(data.last_price == to_fixed_price(150.25));
     assert(data.last_size == 500);
     
     std::cout << "✓ Market data creation test passed" << std::endl;
@@ -48,7 +72,7 @@ void test_trading_signal_creation() {
     assert(std::strcmp(signal.symbol, "GOOGL") == 0);
     assert(signal.action == SignalAction::BUY);
     assert(signal.order_type == OrderType::LIMIT);
-    assert(signal.price == 2800.0);
+    assert(signal.price == to_fixed_price(2800.0));
     assert(signal.quantity == 100);
     assert(signal.strategy_id == 1001);
     assert(signal.confidence == 0.85);
@@ -110,12 +134,53 @@ void test_message_to_string() {
     std::cout << "✓ Message to string test passed" << std::endl;
 }
 
+void test_format_message() {
+    std::cout << "Testing fixed-buffer message formatting..." << std::endl;
+    
+    Message msg;
+    msg.trading_signal = MessageFactory::create_trading_signal(
+        std::string_view("NFLXXX", 4), SignalAction::BUY, OrderType::LIMIT, 450.25, 300, 7, 0.5);
+    assert(std::strcmp(msg.trading_signal.symbol, "NFLX") == 0);
+    
+    char buffer[256];
+    size_t length = MessageFactory::format_message(msg, buffer, sizeof(buffer));
+    std::string_view text(buffer, length);
+    assert(length == std::strlen(buffer));
+    assert(text == MessageFactory::message_to_string(msg));
+    assert(text.find("TRADING_SIGNAL: NFLX") != std::string_view::npos);
+    assert(text.find("price=450.2500 qty=300 conf=0.5000]") != std::string_view::npos);
+    
+    // Cut to the buffer, still terminated
+    char small[16];
+    assert(MessageFactory::format_message(msg, small, sizeof(small)) == sizeof(small) - 1);
+    assert(text.substr(0, sizeof(small) - 1) == small);
+    
+    // An unterminated wire field is read only up to its size
+    Message log;
+    log.log_message = MessageFactory::create_log_message(LogLevel::WARNING, "gw", "x");
+    std::memset(log.log_message.message, 'a', sizeof(log.log_message.message));
+    length = MessageFactory::format_message(log, buffer, sizeof(buffer));
+    assert(length == sizeof(buffer) - 1);
+    
+    FixedWriter out(small, sizeof(small));
+    out << "n=" << -42 << ' ' << 1.5;
+    assert(out.view() == "n=-42 1.5000" && !out.truncated());
+    out << 123456789;   // A number is written whole or not at all
+    assert(out.view() == "n=-42 1.5000" && out.truncated());
+    
+    static_assert(binlog::count_placeholders("Filled {} {} @ {}") == 3);
+    static_assert(binlog::count_placeholders("no arguments") == 0);
+    
+    std::cout << "✓ Fixed-buffer formatting test passed" << std::endl;
+}
+
 void test_message_sizes() {
     std::cout << "Testing message sizes for performance..." << std::endl;
     
     // Verify message sizes are reasonable for performance
     std::cout << "MessageHeader size: " << sizeof(MessageHeader) << " bytes" << std::endl;
     std::cout << "MarketData size: " << sizeof(MarketData) << " bytes" << std::endl;
+    std::cout << "QuoteRecord size: " << sizeof(QuoteRecord) << " bytes" << std::endl;
     std::cout << "TradingSignal size: " << sizeof(TradingSignal) << " bytes" << std::endl;
     std::cout << "OrderExecution size: " << sizeof(OrderExecution) << " bytes" << std::endl;
     std::cout << "LogMessage size: " << sizeof(LogMessage) << " bytes" << std::endl;
@@ -128,18 +193,108 @@ void test_message_sizes() {
     std::cout << "✓ Message sizes test passed" << std::endl;
 }
 
+void test_trace_propagation() {
+    std::cout << "Testing trace context propagation..." << std::endl;
+    
+    auto data = MessageFactory::create_market_data("AAPL", 150.0, 150.05, 100, 200, 150.02, 50);
+    assert(data.trace.trace_id == data.header.sequence_number);
+    assert(data.trace.has(TraceStage::FEED_RECEIVE));
+    assert(!data.trace.has(TraceStage::FEED_PUBLISH));
+    data.trace.stamp(TraceStage::FEED_PUBLISH);
+    
+    // Signals start empty and inherit the originating tick's stamps
+    auto signal = MessageFactory::create_trading_signal("AAPL", SignalAction::BUY, OrderType::LIMIT, 150.0, 100, 1);
+    assert(!signal.trace.has(TraceStage::FEED_RECEIVE));
+    signal.trace = data.trace;
+    signal.trace.stamp(TraceStage::STRATEGY_DECISION);
+    assert(signal.trace.trace_id == data.trace.trace_id);
+    assert(signal.trace.tsc[0] == data.trace.tsc[0]);
+    assert(signal.trace.tsc[static_cast<size_t>(TraceStage::STRATEGY_DECISION)] >= data.trace.tsc[0]);
+    
+    // Missing stages report no elapsed time
+    assert(signal.trace.elapsed_ns(TraceStage::FEED_RECEIVE, TraceStage::GATEWAY_ACK) == 0);
+    
+    std::cout << "✓ Trace context propagation test passed" << std::endl;
+}
+
+void test_market_data_batch() {
+    std::cout << "Testing market data batch round trip..." << std::endl;
+    
+    // One record per cache line, starting on a line boundary
+    static_assert(sizeof(QuoteRecord) == 64 && alignof(QuoteRecord) == 64);
+    static_assert(offsetof(MarketDataBatch, records) % 64 == 0);
+    assert(sizeof(QuoteRecord) <= sizeof(MarketData) * 6 / 10);
+    
+    MarketDataBatch batch;
+    MessageFactory::begin_market_data_batch(batch);
+    assert(batch.header.type == MessageType::MARKET_DATA_BATCH);
+    assert(batch.count == 0);
+    
+    std::vector<MarketData> sent;
+    for (size_t i = 0; i < MarketDataBatch::MAX_RECORDS; ++i) {
+        auto data = MessageFactory::create_market_data(i % 2 ? "MSFT" : "AAPL", 100.0 + i, 100.05 + i,
+                                                       100 + i, 200 + i, 100.02 + i, 10 + i);
+        data.exchange_timestamp = 1000 + i;
+        sent.push_back(data);
+        assert(MessageFactory::append_quote(batch, data));
+    }
+    assert(batch.full());
+    assert(!MessageFactory::append_quote(batch, sent[0]));
+    assert(batch.wire_size() <= sizeof(MarketDataBatch));
+    assert(batch.trace.trace_id == sent[0].trace.trace_id);
+    
+    // Consumers see each quote back as the MarketData the feed produced
+    MarketDataFrame frame;
+    std::memcpy(&frame, &batch, batch.wire_size());
+    size_t index = 0;
+    size_t quotes = for_each_quote(&frame, batch.wire_size(), [&](const MarketData& data) {
+        const MarketData& expected = sent[index++];
+        assert(data.header.type == MessageType::MARKET_DATA);
+        assert(data.header.sequence_number == expected.header.sequence_number);
+        assert(std::strcmp(data.symbol, expected.symbol) == 0);
+        assert(data.bid_price == expected.bid_price && data.ask_price == expected.ask_price);
+        assert(data.bid_size == expected.bid_size && data.ask_size == expected.ask_size);
+        assert(data.last_price == expected.last_price && data.last_size == expected.last_size);
+        assert(data.exchange_timestamp == expected.exchange_timestamp);
+        assert(data.trace.trace_id == expected.header.sequence_number);
+    });
+    assert(quotes == MarketDataBatch::MAX_RECORDS && index == quotes);
+    
+    // Partial batches go out short; sizes that disagree with the count are rejected
+    MessageFactory::begin_market_data_batch(batch);
+    MessageFactory::append_quote(batch, sent[0]);
+    MessageFactory::append_quote(batch, sent[1]);
+    assert(batch.wire_size() < sizeof(MarketDataBatch));
+    assert(for_each_quote(&batch, batch.wire_size(), [](const MarketData&) {}) == 2);
+    assert(for_each_quote(&batch, batch.wire_size() - 1, [](const MarketData&) {}) == 0);
+    
+    // Records name their symbol through the shared table
+    assert(std::strcmp(MessageFactory::unpack_quote(batch, 1).symbol, "MSFT") == 0);
+    
+    // Single messages pass straight through
+    assert(for_each_quote(&sent[0], sizeof(MarketData), [](const MarketData&) {}) == 1);
+    auto signal = MessageFactory::create_trading_signal("AAPL", SignalAction::BUY, OrderType::LIMIT, 150.0, 100, 1);
+    assert(for_each_quote(&signal, sizeof(signal), [](const MarketData&) {}) == 0);
+    
+    std::cout << "✓ Market data batch test passed" << std::endl;
+}
+
 int main() {
     std::cout << "Running Message Types Unit Tests" << std::endl;
     std::cout << "================================" << std::endl;
     
     try {
         test_message_header_creation();
+        test_tsc_header_creation();
         test_market_data_creation();
         test_trading_signal_creation();
         test_log_message_creation();
         test_message_validation();
         test_message_to_string();
+        test_format_message();
         test_message_sizes();
+        test_trace_propagation();
+        test_market_data_batch();
         
         std::cout << "\n✅ All message types tests passed!" << std::endl;
         return 0;
@@ -0,0 +1,139 @@
+#include "../common/metrics_collector.h"
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+
+void test_ring_buffer() {
+    std::cout << "Testing ring buffer wrap and batch pop..." << std::endl;
+
+    auto ring = std::make_unique<MetricsRingBuffer<8>>();
+    MetricEntry batch[8];
+
+    // Several laps so the indices wrap the mask
+    uint64_t next = 0;
+    for (int lap = 0; lap < 5; ++lap) {
+        uint64_t pushed = next;
+        while (ring->push(MetricEntry(1, next, MetricType::COUNTER))) {
+            ++next;
+        }
+        assert(next - pushed == 8);
+        assert(ring->full());
+
+        size_t count = ring->pop_batch(batch, 5);
+        assert(count == 5);
+        for (size_t i = 0; i < count; ++i) {
+            assert(batch[i].value == pushed + i);
+        }
+        assert(ring->size() == 3);
+
+        // The rest, in order
+        MetricEntry entry;
+        uint64_t expected = batch[4].value + 1;
+        while (ring->pop(entry)) {
+            assert(entry.value == expected++);
+        }
+        assert(ring->empty());
+        assert(expected == next);
+    }
+
+    std::cout << "✓ Ring buffer test passed" << std::endl;
+}
+
+void test_registration() {
+    std::cout << "Testing metric ID registration..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    metric_id_t a = collector.register_metric("test.registry_a", MetricType::COUNTER);
+    metric_id_t b = collector.register_metric("test.registry_b", MetricType::GAUGE);
+    assert(a != b && a != INVALID_METRIC_ID && b != INVALID_METRIC_ID);
+
+    // Same label, same ID, whichever pointer it arrives through
+    std::string copy = "test.registry_a";
+    [[maybe_unused]] metric_id_t again = collector.register_metric(copy.c_str(), MetricType::COUNTER);
+    assert(again == a);
+    assert(collector.metric_name(b) == "test.registry_b");
+    assert(collector.metric_name(INVALID_METRIC_ID).empty());
+
+    // The first registration's type sticks
+    assert(collector.metric_type(a) == MetricType::COUNTER);
+    assert(collector.metric_type(b) == MetricType::GAUGE);
+    again = collector.register_metric("test.registry_b", MetricType::LATENCY);
+    assert(again == b && collector.metric_type(b) == MetricType::GAUGE);
+
+    // One registration per macro call site
+    size_t before = collector.metric_count();
+    for (int i = 0; i < 3; ++i) {
+        assert(HFT_METRIC_ID("test.registry_macro", MetricType::COUNTER) ==
+               HFT_METRIC_ID("test.registry_macro", MetricType::COUNTER));
+    }
+    assert(collector.metric_count() == before + 1);
+
+    std::cout << "✓ Registration test passed" << std::endl;
+}
+
+void test_recording_and_thread_reuse() {
+    std::cout << "Testing recording, drain and buffer reuse..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    collector.clear();
+    collector.initialize();
+
+    metric_id_t counter = collector.register_metric("test.collector_events", MetricType::COUNTER);
+    metric_id_t timer = collector.register_metric("test.collector_timer_ns", MetricType::LATENCY);
+
+    // Threads run one after another, so each exit hands its ring to the next
+    const int rounds = 4;
+    const int per_thread = 1000;
+    for (int t = 0; t < rounds; ++t) {
+        std::thread worker([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                collector.increment_counter(counter);
+            }
+            HFT_METRICS_GAUGE("test.collector_gauge", 100 + t);
+            collector.start_timer(timer);
+            collector.end_timer(timer);
+            collector.end_timer(timer);     // Not started again: ignored
+            HFT_METRICS_COUNTER("test.collector_events");
+        });
+        worker.join();
+    }
+
+    // Label form on this thread shares the ID
+    collector.increment_counter("test.collector_events");
+
+    collector.shutdown();       // Final drain
+
+    auto stats = collector.get_statistics();
+    assert(stats.at("test.collector_events").count == rounds * (per_thread + 1) + 1);
+    assert(stats.at("test.collector_gauge").recent_values.size() == rounds);
+    assert(stats.at("test.collector_gauge").sum == 100 + rounds - 1);
+    assert(stats.at("test.collector_timer_ns").count == rounds);
+    assert(collector.get_dropped_entries() == 0);
+
+    collector.clear();
+    assert(collector.get_statistics().count("test.collector_events") == 0);
+
+    std::cout << "✓ Recording test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Metrics Collector Unit Tests" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    try {
+        test_ring_buffer();
+        test_registration();
+        test_recording_and_thread_reuse();
+
+        std::cout << "\n✅ All metrics collector tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,182 @@
+#include "../common/metrics_aggregator.h"
+#include "../common/metrics_publisher.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace hft;
+
+using StatsMap = std::unordered_map<std::string, MetricStats>;
+
+static void set_metric(StatsMap& stats, const std::string& name, MetricType type, uint64_t value) {
+    MetricStats& entry = stats[name];
+    entry.name = name;
+    entry.type = type;
+    switch (type) {
+        case MetricType::LATENCY: entry.p99 = value; break;
+        case MetricType::HISTOGRAM: entry.p95 = value; break;
+        case MetricType::COUNTER: entry.count = value; break;
+        case MetricType::GAUGE: entry.recent_values = {value}; break;
+    }
+}
+
+static size_t message_size(size_t definitions, size_t values) {
+    return sizeof(MetricsMessage) + definitions * sizeof(MetricDefinition) + values * sizeof(MetricValue);
+}
+
+static uint64_t metric_value(const MetricsAggregator& aggregator, const std::string& key) {
+    auto metrics = aggregator.get_all_metrics();
+    auto it = metrics.find(key);
+    assert(it != metrics.end());
+    return it->second.p99;
+}
+
+void test_delta_publishing() {
+    std::cout << "Testing definitions once, changed values only..." << std::endl;
+
+    MetricsEncoder encoder("strategy_engine", 1);
+    StatsMap stats;
+    set_metric(stats, "process_latency", MetricType::LATENCY, 500);
+    set_metric(stats, "signals_generated", MetricType::COUNTER, 3);
+    set_metric(stats, "positions_open", MetricType::GAUGE, 2);
+
+    // First message defines everything
+    size_t size = encoder.encode(stats, 1000, false);
+    assert(size == message_size(3, 3));
+    MetricsMessage header;
+    std::memcpy(&header, encoder.data(), sizeof(header));
+    assert(header.magic == METRICS_MAGIC && header.sequence == 1 && header.flags == 0);
+
+    MetricsAggregator aggregator;
+    [[maybe_unused]] bool accepted = aggregator.process_metrics_message(encoder.data(), size, 1000);
+    assert(accepted);
+    assert(metric_value(aggregator, "strategy_engine.process_latency") == 500);
+    assert(metric_value(aggregator, "strategy_engine.signals_generated") == 3);
+    assert(aggregator.get_online_services().size() == 1);
+
+    // Nothing changed: a header-only heartbeat
+    size = encoder.encode(stats, 2000, false);
+    assert(size == message_size(0, 0));
+    accepted = aggregator.process_metrics_message(encoder.data(), size, 2000);
+    assert(accepted);
+
+    // One changed value, one new metric
+    set_metric(stats, "positions_open", MetricType::GAUGE, 5);
+    set_metric(stats, "orders_submitted", MetricType::COUNTER, 1);
+    size = encoder.encode(stats, 3000, false);
+    assert(size == message_size(1, 2));
+    accepted = aggregator.process_metrics_message(encoder.data(), size, 3000);
+    assert(accepted);
+    assert(metric_value(aggregator, "strategy_engine.positions_open") == 5);
+    assert(metric_value(aggregator, "strategy_engine.orders_submitted") == 1);
+    assert(metric_value(aggregator, "strategy_engine.process_latency") == 500);
+
+    auto service = aggregator.get_service_metrics("strategy_engine");
+    assert(service["positions_open"].p99 == 5);
+    assert(service["positions_open"].service_name == "strategy_engine");
+
+    // Full snapshot repeats everything
+    size = encoder.encode(stats, 4000, true);
+    assert(size == message_size(4, 4));
+    accepted = aggregator.process_metrics_message(encoder.data(), size, 4000);
+    assert(accepted);
+    assert(aggregator.get_sequence_gaps() == 0);
+    assert(aggregator.get_messages_processed() == 4);
+
+    std::cout << "✓ Delta publishing test passed" << std::endl;
+}
+
+void test_late_subscriber_and_restart() {
+    std::cout << "Testing late subscriber and publisher restart..." << std::endl;
+
+    MetricsEncoder encoder("order_gateway", 7);
+    StatsMap stats;
+    set_metric(stats, "submit_latency", MetricType::LATENCY, 900);
+    encoder.encode(stats, 1, false);    // Never seen by the aggregator
+
+    MetricsAggregator aggregator;
+    set_metric(stats, "submit_latency", MetricType::LATENCY, 950);
+    size_t size = encoder.encode(stats, 2, false);
+    [[maybe_unused]] bool accepted = aggregator.process_metrics_message(encoder.data(), size, 2);
+    assert(accepted);
+    assert(aggregator.get_undefined_values() == 1);
+    assert(aggregator.get_all_metrics().count("order_gateway.submit_latency") == 0);
+
+    // The next full message fills it in
+    size = encoder.encode(stats, 3, true);
+    accepted = aggregator.process_metrics_message(encoder.data(), size, 3);
+    assert(accepted);
+    assert(metric_value(aggregator, "order_gateway.submit_latency") == 950);
+
+    // A skipped message is counted
+    set_metric(stats, "submit_latency", MetricType::LATENCY, 800);
+    encoder.encode(stats, 4, false);
+    set_metric(stats, "submit_latency", MetricType::LATENCY, 700);
+    size = encoder.encode(stats, 5, false);
+    accepted = aggregator.process_metrics_message(encoder.data(), size, 5);
+    assert(accepted);
+    assert(aggregator.get_sequence_gaps() == 1);
+    assert(metric_value(aggregator, "order_gateway.submit_latency") == 700);
+
+    // Restarted service: new session, IDs reassigned to different metrics
+    MetricsEncoder restarted("order_gateway", 8);
+    StatsMap fresh;
+    set_metric(fresh, "orders_filled", MetricType::COUNTER, 2);
+    size = restarted.encode(fresh, 6, false);
+    accepted = aggregator.process_metrics_message(restarted.data(), size, 6);
+    assert(accepted);
+    auto metrics = aggregator.get_all_metrics();
+    assert(metrics.count("order_gateway.submit_latency") == 0);
+    assert(metrics["order_gateway.orders_filled"].p99 == 2);
+    assert(aggregator.get_sequence_gaps() == 1);
+
+    // Malformed input is rejected
+    accepted = aggregator.process_metrics_message(restarted.data(), size - 1, 7);
+    assert(!accepted);
+    accepted = aggregator.process_metrics_message(restarted.data(), 4, 7);
+    assert(!accepted);
+    assert(aggregator.get_rejected_messages() == 2);
+
+    std::cout << "✓ Late subscriber test passed" << std::endl;
+}
+
+void test_metric_capacity() {
+    std::cout << "Testing metric ID capacity..." << std::endl;
+
+    MetricsEncoder encoder("market_data_handler", 1);
+    StatsMap stats;
+    for (size_t i = 0; i < MAX_METRICS_PER_SERVICE + 10; ++i) {
+        set_metric(stats, "metric_" + std::to_string(i), MetricType::GAUGE, i);
+    }
+    size_t size = encoder.encode(stats, 1, true);
+    assert(encoder.metric_count() == MAX_METRICS_PER_SERVICE);
+    assert(encoder.get_dropped_metrics() == 10);
+    assert(size == message_size(MAX_METRICS_PER_SERVICE, MAX_METRICS_PER_SERVICE));
+
+    MetricsAggregator aggregator;
+    [[maybe_unused]] bool accepted = aggregator.process_metrics_message(encoder.data(), size, 1);
+    assert(accepted);
+    assert(aggregator.get_service_metrics("market_data_handler").size() >= MAX_METRICS_PER_SERVICE);
+
+    std::cout << "✓ Capacity test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Metrics Wire Format Unit Tests" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try {
+        test_delta_publishing();
+        test_late_subscriber_and_restart();
+        test_metric_capacity();
+
+        std::cout << "\n✅ All metrics wire format tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
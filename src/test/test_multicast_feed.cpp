@@ -0,0 +1,345 @@
+#include "../market_data_handler/feed_arbitrator.h"
+#include "../market_data_handler/multicast_feed.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+static void put_be(uint8_t* at, uint64_t value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        at[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+static uint64_t get_be(const uint8_t* at, int width) {
+    uint64_t value = 0;
+    for (int i = 0; i < width; ++i) value = (value << 8) | at[i];
+    return value;
+}
+
+// MoldUDP64 packet carrying the given message blocks
+static std::vector<uint8_t> mold(uint64_t sequence, const std::vector<std::vector<uint8_t>>& messages,
+                                 const char* session = "SESSION001") {
+    std::vector<uint8_t> packet(FeedArbitrator::HEADER_SIZE);
+    std::memcpy(packet.data(), session, 10);
+    put_be(packet.data() + 10, sequence, 8);
+    put_be(packet.data() + 18, messages.size(), 2);
+    for (const auto& message : messages) {
+        size_t offset = packet.size();
+        packet.resize(offset + 2 + message.size());
+        put_be(packet.data() + offset, message.size(), 2);
+        std::memcpy(packet.data() + offset + 2, message.data(), message.size());
+    }
+    return packet;
+}
+
+// Message whose first byte says which sequence it is
+static std::vector<uint8_t> tagged(uint64_t sequence) {
+    return std::vector<uint8_t>(8, static_cast<uint8_t>(sequence));
+}
+
+static std::vector<uint8_t> mold_range(uint64_t sequence, size_t count) {
+    std::vector<std::vector<uint8_t>> messages;
+    for (size_t i = 0; i < count; ++i) messages.push_back(tagged(sequence + i));
+    return mold(sequence, messages);
+}
+
+struct Delivered {
+    uint64_t sequence;
+    uint16_t count;
+    std::vector<uint8_t> first_message;
+};
+
+static void record_into(FeedArbitrator& arbitrator, std::vector<Delivered>& out) {
+    arbitrator.set_deliver_callback([&out](const uint8_t* packet, size_t len, uint64_t) {
+        assert(len >= FeedArbitrator::HEADER_SIZE);
+        Delivered d{get_be(packet + 10, 8), static_cast<uint16_t>(get_be(packet + 18, 2)), {}};
+        if (d.count > 0) {
+            size_t length = get_be(packet + 20, 2);
+            d.first_message.assign(packet + 22, packet + 22 + length);
+        }
+        out.push_back(d);
+    });
+}
+
+static bool send(FeedArbitrator& arbitrator, uint8_t line, const std::vector<uint8_t>& packet, uint64_t now_ns = 0) {
+    return arbitrator.on_packet(line, packet.data(), packet.size(), 0, now_ns);
+}
+
+void test_duplicates_and_fill() {
+    std::cout << "Testing A/B duplicates and gap fill from the other line..." << std::endl;
+
+    FeedArbitrator arbitrator(8, 200000);
+    std::vector<Delivered> delivered;
+    record_into(arbitrator, delivered);
+
+    // Both lines clean: B's copies are dropped
+    [[maybe_unused]] bool ok = send(arbitrator, 0, mold_range(1, 2));
+    assert(ok);
+    ok = send(arbitrator, 1, mold_range(1, 2));
+    assert(ok);
+    ok = send(arbitrator, 1, mold_range(3, 1));      // B wins this one
+    assert(ok);
+    ok = send(arbitrator, 0, mold_range(3, 1));
+    assert(ok);
+    assert(delivered.size() == 2);
+    assert(arbitrator.duplicates(0) == 1 && arbitrator.duplicates(1) == 1);
+    assert(arbitrator.packets_won(0) == 1 && arbitrator.packets_won(1) == 1);
+
+    // A drops 4; 5 and 6 wait until B supplies 4
+    ok = send(arbitrator, 0, mold_range(5, 1), 1000);
+    assert(ok);
+    ok = send(arbitrator, 0, mold_range(6, 1), 2000);
+    assert(ok);
+    assert(delivered.size() == 2);
+    ok = send(arbitrator, 1, mold_range(4, 1), 3000);
+    assert(ok);
+    assert(delivered.size() == 5);
+    assert(delivered[2].sequence == 4 && delivered[3].sequence == 5 && delivered[4].sequence == 6);
+    ok = send(arbitrator, 1, mold_range(5, 1), 4000);        // Late copies of held packets
+    assert(ok);
+    ok = send(arbitrator, 1, mold_range(6, 1), 4000);
+    assert(ok);
+    assert(delivered.size() == 5);
+    assert(arbitrator.gaps() == 0 && arbitrator.messages_lost() == 0);
+    assert(arbitrator.next_sequence() == 7);
+
+    // Not MoldUDP64
+    uint8_t runt[4] = {};
+    ok = arbitrator.on_packet(0, runt, sizeof(runt), 0, 0);
+    assert(!ok);
+
+    std::cout << "✓ Duplicate and fill test passed" << std::endl;
+}
+
+void test_gap_timeout() {
+    std::cout << "Testing gap timeout, heartbeats and hold overflow..." << std::endl;
+
+    FeedArbitrator arbitrator(2, 200000);
+    std::vector<Delivered> delivered;
+    record_into(arbitrator, delivered);
+    uint64_t gap_first = 0, gap_count = 0;
+    arbitrator.set_gap_callback([&](uint64_t first, uint64_t count) {
+        gap_first = first;
+        gap_count = count;
+    });
+
+    // Neither line has 2: 3 is released once the timeout passes
+    send(arbitrator, 0, mold_range(1, 1), 0);
+    send(arbitrator, 0, mold_range(3, 1), 10000);
+    arbitrator.poll(100000);
+    assert(delivered.size() == 1);
+    arbitrator.poll(10000 + 200000);
+    assert(delivered.size() == 2 && delivered[1].sequence == 3);
+    assert(arbitrator.gaps() == 1 && arbitrator.messages_lost() == 1);
+    assert(gap_first == 2 && gap_count == 1);
+
+    // A heartbeat announcing sequence 8 reveals 4..7 as missing
+    send(arbitrator, 0, mold(8, {}), 300000);
+    arbitrator.poll(300000 + 200000);
+    assert(arbitrator.gaps() == 2 && arbitrator.messages_lost() == 5);
+    assert(arbitrator.next_sequence() == 8);
+
+    // Two hold slots: the third early packet forces the gap
+    send(arbitrator, 0, mold_range(10, 1), 600000);
+    send(arbitrator, 0, mold_range(11, 1), 600000);
+    assert(delivered.size() == 2);
+    send(arbitrator, 0, mold_range(12, 1), 600000);
+    assert(arbitrator.hold_overflows() == 1);
+    assert(delivered.size() == 5 && delivered[4].sequence == 12);
+    assert(arbitrator.messages_lost() == 7);
+
+    // A new session starts over
+    std::vector<uint8_t> next_session = mold(1, {tagged(1)}, "SESSION002");
+    send(arbitrator, 0, next_session, 700000);
+    assert(arbitrator.session_changes() == 1);
+    assert(delivered.size() == 6 && arbitrator.next_sequence() == 2);
+
+    std::cout << "✓ Gap timeout test passed" << std::endl;
+}
+
+void test_overlap_trim() {
+    std::cout << "Testing trimming of partially delivered packets..." << std::endl;
+
+    FeedArbitrator arbitrator(4, 200000);
+    std::vector<Delivered> delivered;
+    record_into(arbitrator, delivered);
+
+    send(arbitrator, 0, mold_range(1, 3));          // 1..3
+    send(arbitrator, 1, mold_range(2, 3));          // 2..4: only 4 is new
+    assert(delivered.size() == 2);
+    assert(delivered[1].sequence == 4 && delivered[1].count == 1);
+    assert(delivered[1].first_message == tagged(4));
+    assert(arbitrator.next_sequence() == 5);
+
+    std::cout << "✓ Overlap trim test passed" << std::endl;
+}
+
+void test_socket_source() {
+    std::cout << "Testing socket RX source over loopback..." << std::endl;
+
+    SocketRxSource source(16);
+    [[maybe_unused]] bool ok = source.open({{"127.0.0.1", 0}, {"127.0.0.1", 0}}, "0.0.0.0");
+    assert(ok);
+    uint16_t ports[2] = {source.bound_port(0), source.bound_port(1)};
+    assert(ports[0] != 0 && ports[1] != 0 && ports[0] != ports[1]);
+
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(sender >= 0);
+    for (int i = 0; i < 6; ++i) {
+        struct sockaddr_in to{};
+        to.sin_family = AF_INET;
+        to.sin_port = htons(ports[i % 2]);
+        to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        uint8_t payload[32];
+        std::memset(payload, i, sizeof(payload));
+        assert(sendto(sender, payload, sizeof(payload), 0, reinterpret_cast<struct sockaddr*>(&to), sizeof(to)) ==
+               static_cast<ssize_t>(sizeof(payload)));
+    }
+    close(sender);
+
+    FeedPacket batch[16];
+    int seen[2] = {0, 0};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (seen[0] + seen[1] < 6 && std::chrono::steady_clock::now() < deadline) {
+        size_t count = source.poll(batch, 16);
+        for (size_t i = 0; i < count; ++i) {
+            assert(batch[i].length == 32);
+            assert(batch[i].line == batch[i].payload[0] % 2);
+            assert(batch[i].timestamp_ns > 0);
+            seen[batch[i].line]++;
+        }
+    }
+    assert(seen[0] == 3 && seen[1] == 3);
+
+    std::cout << "✓ Socket source test passed" << std::endl;
+}
+
+// Replays prepared packets as if received
+class ScriptedRxSource : public FeedRxSource {
+public:
+    struct Entry {
+        uint8_t line;
+        std::vector<uint8_t> payload;
+    };
+    std::deque<Entry> pending;
+
+    bool open(const std::vector<FeedLineConfig>&, const std::string&) override { return true; }
+    const char* name() const override { return "scripted"; }
+
+    size_t poll(FeedPacket* out, size_t max) override {
+        current_.clear();
+        while (!pending.empty() && current_.size() < std::min<size_t>(max, 4)) {
+            current_.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+        for (size_t i = 0; i < current_.size(); ++i) {
+            out[i] = FeedPacket{current_[i].payload.data(), static_cast<uint32_t>(current_[i].payload.size()),
+                                current_[i].line, 1, HighResTimer::get_ticks()};
+        }
+        return current_.size();
+    }
+
+private:
+    std::vector<Entry> current_;
+};
+
+static std::vector<uint8_t> itch_message(char type, uint16_t length, uint16_t locate) {
+    std::vector<uint8_t> message(length, 0);
+    message[0] = static_cast<uint8_t>(type);
+    put_be(message.data() + 1, locate, 2);
+    return message;
+}
+
+static void put_stock(std::vector<uint8_t>& message, size_t at, const char* stock) {
+    std::memset(message.data() + at, ' ', 8);
+    std::memcpy(message.data() + at, stock, std::strlen(stock));
+}
+
+void test_feed_end_to_end() {
+    std::cout << "Testing A/B feed into the ITCH parser..." << std::endl;
+
+    // Stock directory, then bids stepping up so every add changes the top
+    std::vector<std::vector<uint8_t>> packets;
+    std::vector<uint8_t> directory = itch_message('R', 39, 1);
+    put_stock(directory, 11, "AAPL");
+    packets.push_back(mold(1, {directory}));
+    const int adds = 20;
+    for (int i = 0; i < adds; ++i) {
+        std::vector<uint8_t> add = itch_message('A', 36, 1);
+        put_be(add.data() + 11, 1000 + i, 8);
+        add[19] = 'B';
+        put_be(add.data() + 20, 100, 4);
+        put_stock(add, 24, "AAPL");
+        put_be(add.data() + 32, 1500000 + i * 100, 4);
+        packets.push_back(mold(2 + i, {add}));
+    }
+
+    // Each line misses packets the other has, and B runs a packet behind
+    auto source = std::make_unique<ScriptedRxSource>();
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (i % 5 != 3) source->pending.push_back({0, packets[i]});
+        if (i > 0 && (i - 1) % 7 != 2) source->pending.push_back({1, packets[i - 1]});
+    }
+    source->pending.push_back({1, packets.back()});
+
+    MulticastFeed feed(FeedFormat::NASDAQ_ITCH_5_0);
+    std::atomic<int> quotes{0};
+    std::atomic<int64_t> last_bid{0};
+    feed.set_data_callback([&](const MarketData& data) {
+        quotes++;
+        last_bid = data.bid_price;
+    });
+    [[maybe_unused]] bool ok = feed.initialize(std::move(source), {{"233.0.0.1", 1}, {"233.0.0.2", 1}}, "0.0.0.0");
+    assert(ok);
+    feed.start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (feed.get_packets_delivered() < packets.size() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    feed.stop();
+
+    std::cout << "  A=" << feed.get_packets_received(0) << " B=" << feed.get_packets_received(1)
+              << " delivered=" << feed.get_packets_delivered() << " duplicates=" << feed.get_duplicates()
+              << " quotes=" << quotes.load() << std::endl;
+    assert(feed.get_packets_delivered() == packets.size());
+    assert(feed.get_gaps() == 0 && feed.get_messages_lost() == 0);
+    assert(feed.get_duplicates() > 0);
+    assert(quotes.load() == adds);
+    assert(last_bid.load() == static_cast<int64_t>(to_fixed_price(150.0 + (adds - 1) * 0.01)));
+    assert(feed.get_parse_errors() == 0);
+
+    std::cout << "✓ End-to-end feed test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Multicast Feed Tests" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    try {
+        test_duplicates_and_fill();
+        test_gap_timeout();
+        test_overlap_trim();
+        test_socket_source();
+        test_feed_end_to_end();
+
+        std::cout << "\n✅ All multicast feed tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
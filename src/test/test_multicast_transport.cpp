@@ -0,0 +1,549 @@
+#include "../common/multicast_transport.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+static int next_port = 31700 + static_cast<int>(getpid() % 200) * 4;
+
+static TransportConfig loopback_config(const std::string& endpoint, size_t ring = 64) {
+    TransportConfig config(TransportType::RELIABLE_MULTICAST, TransportPattern::PUBLISH_SUBSCRIBE, endpoint);
+    config.multicast_interface = "127.0.0.1";
+    config.retransmit_ring = ring;
+    config.heartbeat_interval_ms = 20;
+    config.receive_timeout_ms = 500;
+    return config;
+}
+
+static std::string next_endpoint() {
+    return "rmcast://239.255.17.1:" + std::to_string(next_port++);
+}
+
+// Waits up to timeout_ms for the next message; receive() in non-blocking mode
+static bool receive_within(RmcastSubscriber& subscriber, std::string& message, int timeout_ms = 500) {
+    char buffer[rmcast::MAX_PAYLOAD];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        size_t size = sizeof(buffer);
+        if (subscriber.receive(buffer, size, true)) {
+            message.assign(buffer, size);
+            return true;
+        }
+        pollfd entry{subscriber.get_poll_fd(), POLLIN, 0};
+        poll(&entry, 1, 5);
+    }
+    return false;
+}
+
+// A publisher driven by hand, so tests choose what gets lost
+class FakePublisher {
+public:
+    FakePublisher(const std::string& endpoint, uint64_t session) : session_(session) {
+        [[maybe_unused]] bool ok = rmcast::parse_endpoint(endpoint, group_);
+        assert(ok);
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        in_addr loopback{};
+        loopback.s_addr = htonl(INADDR_LOOPBACK);
+        [[maybe_unused]] int rc = bind(fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+        assert(rc == 0);
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+    }
+    ~FakePublisher() { close(fd_); }
+
+    void send(rmcast::PacketType type, uint64_t sequence, const std::string& payload = "",
+              uint32_t count = 0, const sockaddr_in* to = nullptr) {
+        char packet[rmcast::MAX_DATAGRAM];
+        rmcast::PacketHeader header{rmcast::MAGIC, type, 0, session_, sequence,
+                                    payload.empty() ? count : static_cast<uint32_t>(payload.size()), 0};
+        std::memcpy(packet, &header, sizeof(header));
+        std::memcpy(packet + sizeof(header), payload.data(), payload.size());
+        const sockaddr_in& target = to ? *to : group_;
+        sendto(fd_, packet, sizeof(header) + payload.size(), 0,
+               reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    }
+
+    // The next NAK, and where to answer it
+    bool next_nak(rmcast::PacketHeader& nak, sockaddr_in& from, int timeout_ms = 500) {
+        pollfd entry{fd_, POLLIN, 0};
+        if (poll(&entry, 1, timeout_ms) <= 0) return false;
+        socklen_t length = sizeof(from);
+        ssize_t received = recvfrom(fd_, &nak, sizeof(nak), 0, reinterpret_cast<sockaddr*>(&from), &length);
+        return received == sizeof(nak) && nak.type == rmcast::PacketType::NAK;
+    }
+
+    void set_session(uint64_t session) { session_ = session; }
+
+private:
+    int fd_;
+    uint64_t session_;
+    sockaddr_in group_{};
+};
+
+// True if this host delivers loopback multicast at all; containers often don't
+static bool multicast_available() {
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    if (!subscriber.initialize(loopback_config(endpoint)) || !subscriber.connect(endpoint)) return false;
+    FakePublisher publisher(endpoint, 1);
+    publisher.send(rmcast::PacketType::DATA, 1, "probe");
+    std::string message;
+    return receive_within(subscriber, message, 200);
+}
+
+void test_parse_endpoint() {
+    std::cout << "Testing endpoint parsing..." << std::endl;
+
+    sockaddr_in group{};
+    [[maybe_unused]] bool ok = rmcast::parse_endpoint("rmcast://239.192.0.1:31001", group);
+    assert(ok);
+    assert(ntohs(group.sin_port) == 31001);
+    assert(ntohl(group.sin_addr.s_addr) == 0xEFC00001);
+
+    // Unicast address, no port, bad port, wrong scheme
+    ok = rmcast::parse_endpoint("rmcast://10.0.0.1:31001", group);
+    assert(!ok);
+    ok = rmcast::parse_endpoint("rmcast://239.192.0.1", group);
+    assert(!ok);
+    ok = rmcast::parse_endpoint("rmcast://239.192.0.1:70000", group);
+    assert(!ok);
+    ok = rmcast::parse_endpoint("rmcast://239.192.0.1:port", group);
+    assert(!ok);
+    ok = rmcast::parse_endpoint("udp://239.192.0.1:31001", group);
+    assert(!ok);
+
+    RmcastPublisher publisher;
+    ok = publisher.initialize(loopback_config("rmcast://10.0.0.1:1"));
+    assert(ok);
+    ok = publisher.bind("rmcast://10.0.0.1:1");
+    assert(!ok);
+
+    std::cout << "✓ Endpoint parsing test passed" << std::endl;
+}
+
+void test_in_order_delivery() {
+    std::cout << "Testing in-order delivery..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    RmcastPublisher publisher;
+    ok = publisher.initialize(loopback_config(endpoint)) && publisher.bind(endpoint);
+    assert(ok);
+    assert(publisher.get_type() == TransportType::RELIABLE_MULTICAST);
+
+    for (int i = 0; i < 50; ++i) {
+        std::string message = "quote " + std::to_string(i);
+        ok = publisher.publish(message.data(), message.size());
+        assert(ok);
+    }
+    // Over the datagram limit
+    std::string too_big(rmcast::MAX_PAYLOAD + 1, 'x');
+    ok = publisher.publish(too_big.data(), too_big.size());
+    assert(!ok);
+    assert(publisher.last_sequence() == 50);
+
+    for (int i = 0; i < 50; ++i) {
+        std::string message;
+        ok = receive_within(subscriber, message);
+        assert(ok);
+        assert(message == "quote " + std::to_string(i));
+    }
+    assert(subscriber.get_messages_received() == 50);
+    assert(subscriber.stats().sessions == 1);
+    assert(subscriber.stats().lost == 0);
+
+    // Blocking receive honours receive_timeout_ms
+    char buffer[64];
+    size_t size = sizeof(buffer);
+    [[maybe_unused]] auto start = std::chrono::steady_clock::now();
+    ok = subscriber.receive(buffer, size, false);
+    assert(!ok);
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(450));
+
+    std::cout << "✓ In-order delivery test passed" << std::endl;
+}
+
+void test_gap_recovery() {
+    std::cout << "Testing gap recovery..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 7);
+
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    publisher.send(rmcast::PacketType::DATA, 4, "four");     // 2 and 3 lost
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+    ok = receive_within(subscriber, message, 20);
+    assert(!ok);
+
+    // One NAK for the whole run
+    rmcast::PacketHeader nak;
+    sockaddr_in from{};
+    ok = publisher.next_nak(nak, from);
+    assert(ok);
+    assert(nak.session == 7 && nak.sequence == 2 && nak.count == 2);
+
+    // Retransmits go to the receiver's own address, not the group
+    publisher.send(rmcast::PacketType::RETRANSMIT, 3, "three", 0, &from);
+    publisher.send(rmcast::PacketType::RETRANSMIT, 2, "two", 0, &from);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "two");
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "three");
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "four");
+
+    // A repeat is dropped
+    publisher.send(rmcast::PacketType::DATA, 4, "four");
+    ok = receive_within(subscriber, message, 50);
+    assert(!ok);
+
+    [[maybe_unused]] auto stats = subscriber.stats();
+    assert(stats.gaps == 1 && stats.recovered == 2 && stats.lost == 0 && stats.duplicates == 1);
+
+    std::cout << "✓ Gap recovery test passed" << std::endl;
+}
+
+void test_unavailable_and_unanswered() {
+    std::cout << "Testing unrecoverable gaps..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 9);
+
+    // The publisher no longer has 2-3: skipped at once
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    publisher.send(rmcast::PacketType::DATA, 4, "four");
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+    ok = receive_within(subscriber, message, 20);
+    assert(!ok);
+    rmcast::PacketHeader nak;
+    sockaddr_in from{};
+    ok = publisher.next_nak(nak, from);
+    assert(ok && nak.sequence == 2);
+    publisher.send(rmcast::PacketType::UNAVAILABLE, 2, "", 2, &from);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "four");
+    assert(subscriber.stats().lost == 2);
+
+    // Nobody answers for 5: given up after MAX_NAK_ATTEMPTS
+    publisher.send(rmcast::PacketType::DATA, 6, "six");
+    [[maybe_unused]] auto start = std::chrono::steady_clock::now();
+    ok = receive_within(subscriber, message, 1000);
+    assert(ok && message == "six");
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(80));
+    [[maybe_unused]] auto stats = subscriber.stats();
+    assert(stats.lost == 3 && stats.naks_sent == 1 + rmcast::MAX_NAK_ATTEMPTS);
+
+    std::cout << "✓ Unrecoverable gap test passed" << std::endl;
+}
+
+void test_window_overrun() {
+    std::cout << "Testing a jump past the reorder window..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint, 16)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 11);
+
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+
+    // 2 missing, 3 held; 19 needs 3's slot. 2 is given up, 3 is kept and 19
+    // waits for a NAK once 3 has been delivered
+    publisher.send(rmcast::PacketType::DATA, 3, "three");
+    publisher.send(rmcast::PacketType::DATA, 19, "nineteen");
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "three");
+    [[maybe_unused]] auto stats = subscriber.stats();
+    assert(stats.lost == 1 && stats.deferred == 1);
+    ok = receive_within(subscriber, message, 20);
+    assert(!ok);
+
+    rmcast::PacketHeader nak;
+    sockaddr_in from{};
+    do {
+        ok = publisher.next_nak(nak, from);     // 2 may have been NAKed before 19 arrived
+    } while (ok && nak.sequence != 4);
+    assert(ok);
+    publisher.send(rmcast::PacketType::UNAVAILABLE, 4, "", 15, &from);
+    publisher.send(rmcast::PacketType::RETRANSMIT, 19, "nineteen", 0, &from);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "nineteen");
+    assert(subscriber.stats().lost == 16);
+
+    std::cout << "✓ Window overrun test passed" << std::endl;
+}
+
+void test_renak_wakes_poll() {
+    std::cout << "Testing re-NAK wakeups on the poll fd..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 13);
+
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    publisher.send(rmcast::PacketType::DATA, 3, "three");
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+    char buffer[rmcast::MAX_PAYLOAD];
+    size_t size = sizeof(buffer);
+    ok = subscriber.receive(buffer, size, true);      // Notices the gap and NAKs it
+    assert(!ok);
+    rmcast::PacketHeader nak;
+    sockaddr_in from{};
+    ok = publisher.next_nak(nak, from);
+    assert(ok && nak.sequence == 2);
+
+    // No datagrams and no heartbeats: the fd alone brings the caller back
+    pollfd entry{subscriber.get_poll_fd(), POLLIN, 0};
+    auto start = std::chrono::steady_clock::now();
+    [[maybe_unused]] int ready = poll(&entry, 1, 500);
+    assert(ready == 1);
+    [[maybe_unused]] auto waited = std::chrono::steady_clock::now() - start;
+    assert(waited >= std::chrono::milliseconds(10) && waited < std::chrono::milliseconds(200));
+    size = sizeof(buffer);
+    ok = subscriber.receive(buffer, size, true);
+    assert(!ok);
+    ok = publisher.next_nak(nak, from, 50);
+    assert(ok && nak.sequence == 2);
+    ready = poll(&entry, 1, 0);
+    assert(ready == 0);         // Reading cleared the wakeup
+
+    // Recovered: the timer is disarmed
+    publisher.send(rmcast::PacketType::RETRANSMIT, 2, "two", 0, &from);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "two");
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "three");
+    ready = poll(&entry, 1, 100);
+    assert(ready == 0);
+
+    std::cout << "✓ Re-NAK wakeup test passed" << std::endl;
+}
+
+void test_heartbeat_and_restart() {
+    std::cout << "Testing heartbeats and publisher restarts..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 11);
+
+    // The last message is lost; the heartbeat gives it away
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+    publisher.send(rmcast::PacketType::HEARTBEAT, 2);
+    ok = receive_within(subscriber, message, 20);
+    assert(!ok);
+    rmcast::PacketHeader nak;
+    sockaddr_in from{};
+    ok = publisher.next_nak(nak, from);
+    assert(ok && nak.sequence == 2 && nak.count == 1);
+    publisher.send(rmcast::PacketType::RETRANSMIT, 2, "two", 0, &from);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "two");
+
+    // Restarted: new session, numbering from 1 again
+    publisher.set_session(12);
+    publisher.send(rmcast::PacketType::DATA, 1, "again");
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "again");
+    // The old session's late retransmits are ignored
+    publisher.set_session(11);
+    publisher.send(rmcast::PacketType::RETRANSMIT, 2, "stale", 0, &from);
+    ok = receive_within(subscriber, message, 50);
+    assert(!ok);
+    assert(subscriber.stats().sessions == 2);
+
+    std::cout << "✓ Heartbeat and restart test passed" << std::endl;
+}
+
+void test_publisher_repairs() {
+    std::cout << "Testing publisher repairs..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastPublisher publisher;
+    [[maybe_unused]] bool ok = publisher.initialize(loopback_config(endpoint, 16)) && publisher.bind(endpoint);
+    assert(ok);
+
+    // Listen on the group to learn the publisher's repair address
+    RmcastSubscriber listener;
+    ok = listener.initialize(loopback_config(endpoint)) && listener.connect(endpoint);
+    assert(ok);
+    for (int i = 1; i <= 40; ++i) {
+        std::string message = "m" + std::to_string(i);
+        publisher.publish(message.data(), message.size());
+    }
+
+    int group_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in group{};
+    ok = rmcast::parse_endpoint(endpoint, group);
+    assert(ok);
+    int one = 1;
+    setsockopt(group_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(group_fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    [[maybe_unused]] int rc = bind(group_fd, reinterpret_cast<sockaddr*>(&group), sizeof(group));
+    assert(rc == 0);
+    ip_mreq membership{};
+    membership.imr_multiaddr = group.sin_addr;
+    membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    rc = setsockopt(group_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership));
+    assert(rc == 0);
+
+    // Nothing published for a while: a heartbeat carries the last sequence
+    char packet[rmcast::MAX_DATAGRAM];
+    sockaddr_in source{};
+    socklen_t length = sizeof(source);
+    pollfd entry{group_fd, POLLIN, 0};
+    [[maybe_unused]] int ready = poll(&entry, 1, 500);
+    assert(ready == 1);
+    [[maybe_unused]] ssize_t bytes = recvfrom(group_fd, packet, sizeof(packet), 0,
+                                              reinterpret_cast<sockaddr*>(&source), &length);
+    assert(bytes >= 32);
+    rmcast::PacketHeader header;
+    std::memcpy(&header, packet, sizeof(header));
+    assert(header.type == rmcast::PacketType::HEARTBEAT);
+    assert(header.session == publisher.session() && header.sequence == 40);
+
+    // 20-29: 20-24 left the 16-slot ring, 25-29 are still in it
+    int nak_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    rmcast::PacketHeader nak{rmcast::MAGIC, rmcast::PacketType::NAK, 0, publisher.session(), 20, 10, 0};
+    sendto(nak_fd, &nak, sizeof(nak), 0, reinterpret_cast<sockaddr*>(&source), sizeof(source));
+
+    std::vector<rmcast::PacketHeader> answers;
+    entry.fd = nak_fd;
+    while (poll(&entry, 1, 200) == 1) {
+        [[maybe_unused]] ssize_t received = recv(nak_fd, packet, sizeof(packet), 0);
+        assert(received >= 32);
+        std::memcpy(&header, packet, sizeof(header));
+        answers.push_back(header);
+        if (header.type == rmcast::PacketType::RETRANSMIT) {
+            assert(std::string(packet + 32, header.count) == "m" + std::to_string(header.sequence));
+        }
+    }
+    assert(answers.size() == 6);
+    assert(answers[0].type == rmcast::PacketType::UNAVAILABLE);
+    assert(answers[0].sequence == 20 && answers[0].count == 5);
+    for (size_t i = 1; i < answers.size(); ++i) {
+        assert(answers[i].type == rmcast::PacketType::RETRANSMIT && answers[i].sequence == 24 + i);
+    }
+
+    [[maybe_unused]] auto stats = publisher.stats();
+    assert(stats.naks_received == 1 && stats.retransmitted == 5 && stats.unavailable == 5);
+
+    close(nak_fd);
+    close(group_fd);
+    std::cout << "✓ Publisher repair test passed" << std::endl;
+}
+
+void test_poll_fd_and_async() {
+    std::cout << "Testing the poll fd and async receive..." << std::endl;
+
+    std::string endpoint = next_endpoint();
+    RmcastSubscriber subscriber;
+    [[maybe_unused]] bool ok = subscriber.initialize(loopback_config(endpoint)) && subscriber.connect(endpoint);
+    assert(ok);
+    FakePublisher publisher(endpoint, 21);
+    pollfd entry{subscriber.get_poll_fd(), POLLIN, 0};
+    assert(entry.fd >= 0);
+    [[maybe_unused]] int ready = poll(&entry, 1, 0);
+    assert(ready == 0);
+
+    publisher.send(rmcast::PacketType::DATA, 1, "one");
+    ready = poll(&entry, 1, 500);
+    assert(ready == 1);
+    std::string message;
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "one");
+    ready = poll(&entry, 1, 0);
+    assert(ready == 0);
+
+    // Out of order: delivering 2 drains the socket with 3 held in the
+    // window, and the fd stays readable for it
+    publisher.send(rmcast::PacketType::DATA, 3, "three");
+    publisher.send(rmcast::PacketType::DATA, 2, "two");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "two");
+    ready = poll(&entry, 1, 0);
+    assert(ready == 1);
+    ok = receive_within(subscriber, message);
+    assert(ok && message == "three");
+    ready = poll(&entry, 1, 0);
+    assert(ready == 0);
+
+    std::atomic<int> delivered{0};
+    subscriber.set_receive_callback([&delivered](const void*, size_t) { delivered++; });
+    subscriber.start_async_receive();
+    for (uint64_t sequence = 4; sequence <= 13; ++sequence) {
+        publisher.send(rmcast::PacketType::DATA, sequence, "x");
+    }
+    for (int i = 0; i < 100 && delivered.load() < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    subscriber.stop_async_receive();
+    assert(delivered.load() == 10);
+
+    std::cout << "✓ Poll fd and async test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Multicast Transport Unit Tests" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try {
+        test_parse_endpoint();
+
+        if (!multicast_available()) {
+            std::cout << "\n⚠️  Loopback multicast unavailable here; skipping the delivery tests" << std::endl;
+            return 0;
+        }
+        test_in_order_delivery();
+        test_gap_recovery();
+        test_unavailable_and_unanswered();
+        test_window_overrun();
+        test_renak_wakes_poll();
+        test_heartbeat_and_restart();
+        test_publisher_repairs();
+        test_poll_fd_and_async();
+
+        std::cout << "\n✅ All multicast transport tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,231 @@
+#include "../common/order_book.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+using namespace hft;
+
+static bool near(double a, double b) {
+    return std::abs(a - b) < 1e-9;
+}
+
+static void apply_both(OrderBook& map_book, LadderOrderBook& ladder_book,
+                       BookSide side, BookUpdateType type, double price,
+                       uint32_t size, uint64_t seq) {
+    auto update = OrderBookFactory::create_level_update("AAPL", side, type, to_fixed_price(price), size, seq);
+    map_book.apply_update(update);
+    ladder_book.apply_update(update);
+}
+
+void test_ladder_top_of_book() {
+    std::cout << "Testing ladder top of book..." << std::endl;
+    
+    LadderOrderBook book("AAPL", to_fixed_price(0.01), 1024);
+    uint64_t seq = 1;
+    
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::BID, BookUpdateType::ADD, to_fixed_price(150.00), 100, seq++));
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::BID, BookUpdateType::ADD, to_fixed_price(150.02), 200, seq++));
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::ASK, BookUpdateType::ADD, to_fixed_price(150.05), 300, seq++));
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::ASK, BookUpdateType::ADD, to_fixed_price(150.04), 400, seq++));
+    
+    assert(near(book.get_best_bid(), 150.02));
+    assert(near(book.get_best_ask(), 150.04));
+    assert(book.get_book_depth(BookSide::BID) == 2);
+    assert(book.get_bid_size_at_level(1) == 100);
+    assert(book.get_ask_size_at_level(1) == 300);
+    
+    // Removing the best level moves the cursor to the next populated tick
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::BID, BookUpdateType::DELETE, to_fixed_price(150.02), 0, seq++));
+    assert(near(book.get_best_bid(), 150.00));
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::ASK, BookUpdateType::UPDATE, to_fixed_price(150.04), 0, seq++));
+    assert(near(book.get_best_ask(), 150.05));
+    
+    // Prices outside the window are dropped
+    book.apply_update(OrderBookFactory::create_level_update("AAPL", BookSide::ASK, BookUpdateType::ADD, to_fixed_price(500.00), 10, seq++));
+    assert(book.get_out_of_range_count() == 1);
+    assert(book.get_book_depth(BookSide::ASK) == 1);
+    
+    std::cout << "✓ Ladder top of book test passed" << std::endl;
+}
+
+void test_ladder_matches_map_book() {
+    std::cout << "Testing ladder against map book..." << std::endl;
+    
+    OrderBook map_book("AAPL");
+    LadderOrderBook ladder_book("AAPL", to_fixed_price(0.01), 4096);
+    uint64_t seq = 1;
+    
+    for (int i = 0; i < 10; ++i) {
+        apply_both(map_book, ladder_book, BookSide::BID, BookUpdateType::ADD, 99.99 - i * 0.01, 100 + i * 10, seq++);
+        apply_both(map_book, ladder_book, BookSide::ASK, BookUpdateType::ADD, 100.01 + i * 0.01, 150 + i * 5, seq++);
+    }
+    apply_both(map_book, ladder_book, BookSide::BID, BookUpdateType::UPDATE, to_fixed_price(99.97), 0, seq++);
+    apply_both(map_book, ladder_book, BookSide::ASK, BookUpdateType::DELETE, to_fixed_price(100.01), 0, seq++);
+    
+    assert(near(map_book.get_best_bid(), ladder_book.get_best_bid()));
+    assert(near(map_book.get_best_ask(), ladder_book.get_best_ask()));
+    assert(map_book.get_book_depth(BookSide::BID) == ladder_book.get_book_depth(BookSide::BID));
+    assert(map_book.get_book_depth(BookSide::ASK) == ladder_book.get_book_depth(BookSide::ASK));
+    for (size_t level = 0; level < 10; ++level) {
+        assert(map_book.get_bid_size_at_level(level) == ladder_book.get_bid_size_at_level(level));
+        assert(map_book.get_ask_size_at_level(level) == ladder_book.get_ask_size_at_level(level));
+    }
+    assert(map_book.get_total_size(BookSide::ASK, 5) == ladder_book.get_total_size(BookSide::ASK, 5));
+    assert(near(map_book.get_volume_weighted_price(BookSide::ASK, 500),
+                ladder_book.get_volume_weighted_price(BookSide::ASK, 500)));
+    assert(near(map_book.get_bid_ask_imbalance(), ladder_book.get_bid_ask_imbalance()));
+    
+    std::cout << "✓ Ladder/map equivalence test passed" << std::endl;
+}
+
+void test_manager_implementation_choice() {
+    std::cout << "Testing per-symbol implementation choice..." << std::endl;
+    
+    OrderBookManager manager;
+    manager.add_symbol("AAPL", BookImplementation::LADDER);
+    manager.add_symbol("MSFT");
+    
+    assert(manager.get_book("AAPL")->implementation() == BookImplementation::LADDER);
+    assert(manager.get_book("MSFT")->implementation() == BookImplementation::MAP);
+    
+    manager.set_default_implementation(BookImplementation::LADDER);
+    manager.process_update(OrderBookFactory::create_level_update("TSLA", BookSide::BID, BookUpdateType::ADD, to_fixed_price(200.0), 50, 1));
+    assert(manager.get_book("TSLA")->implementation() == BookImplementation::LADDER);
+    assert(near(manager.get_book("TSLA")->get_best_bid(), 200.0));
+    
+    std::cout << "✓ Implementation choice test passed" << std::endl;
+}
+
+void test_symbol_id_lookup() {
+    std::cout << "Testing symbol ID book lookup..." << std::endl;
+    
+    OrderBookManager manager(BookImplementation::LADDER);
+    auto update = OrderBookFactory::create_level_update("NVDA", BookSide::ASK, BookUpdateType::ADD,
+                                                        to_fixed_price(900.10), 25, 1);
+    symbol_id_t id = update.symbol_id;
+    assert(id != INVALID_SYMBOL_ID);
+    assert(std::string(SymbolTable::instance().name(id)) == "NVDA");
+    assert(SymbolTable::instance().intern("NVDA") == id);
+    
+    manager.process_update(update);
+    assert(manager.get_book(id) == manager.get_book("NVDA"));
+    assert(near(manager.get_book(id)->get_best_ask(), 900.10));
+    
+    // A stale wire ID falls back to the symbol name
+    update.symbol_id = id + 1000;
+    update.sequence_number = 2;
+    update.level.size = 50;
+    update.update_type = BookUpdateType::UPDATE;
+    manager.process_update(update);
+    assert(manager.get_book(id)->get_ask_size_at_level(0) == 50);
+    
+    std::cout << "✓ Symbol ID lookup test passed" << std::endl;
+}
+
+void test_gap_snapshot_recovery() {
+    std::cout << "Testing gap detection and snapshot recovery..." << std::endl;
+    
+    LadderOrderBook book("AAPL", to_fixed_price(0.01), 1024);
+    auto level = [](BookSide side, BookUpdateType type, double price, uint32_t size, uint64_t seq) {
+        return OrderBookFactory::create_level_update("AAPL", side, type, to_fixed_price(price), size, seq);
+    };
+    
+    book.apply_update(level(BookSide::BID, BookUpdateType::ADD, 100.00, 100, 1));
+    book.apply_update(level(BookSide::ASK, BookUpdateType::ADD, 100.02, 100, 2));
+    book.apply_update(level(BookSide::ASK, BookUpdateType::ADD, 100.02, 100, 2));
+    assert(book.get_duplicate_updates() == 1);
+    assert(!book.is_stale() && book.is_valid());
+    
+    // 3 and 4 are lost; 5 and 6 are held back
+    book.apply_update(level(BookSide::BID, BookUpdateType::UPDATE, 100.00, 300, 5));
+    book.apply_update(level(BookSide::ASK, BookUpdateType::DELETE, 100.02, 0, 6));
+    assert(book.is_stale() && !book.is_valid());
+    assert(book.get_gap_count() == 1);
+    assert(book.get_missed_updates() == 2);
+    assert(book.get_buffered_count() == 2);
+    assert(book.get_bid_size_at_level(0) == 100);
+    
+    // Snapshot as of 4: update 5 and 6 are replayed on top of it
+    std::vector<OrderBookLevel> bids{OrderBookLevel(to_fixed_price(100.00), 200, 2)};
+    std::vector<OrderBookLevel> asks{OrderBookLevel(to_fixed_price(100.02), 50, 1),
+                                     OrderBookLevel(to_fixed_price(100.03), 70, 1)};
+    [[maybe_unused]] bool applied = book.apply_snapshot(bids, asks, 4);
+    assert(applied);
+    assert(!book.is_stale() && book.is_valid());
+    assert(book.get_last_sequence() == 6);
+    assert(book.get_bid_size_at_level(0) == 300);
+    assert(near(book.get_best_ask(), 100.03));
+    assert(book.get_recovery_count() == 1);
+    assert(book.get_total_recovery_ns() >= book.get_last_recovery_ns());
+    
+    // A snapshot older than the live book is refused
+    applied = book.apply_snapshot(bids, asks, 3);
+    assert(!applied);
+    assert(book.get_bid_size_at_level(0) == 300);
+    
+    // A late update closes the gap without a snapshot
+    book.apply_update(level(BookSide::BID, BookUpdateType::ADD, 99.99, 10, 8));
+    assert(book.is_stale());
+    book.apply_update(level(BookSide::BID, BookUpdateType::ADD, 99.98, 20, 7));
+    assert(!book.is_stale());
+    assert(book.get_last_sequence() == 8);
+    assert(book.get_book_depth(BookSide::BID) == 3);
+    assert(book.get_recovery_count() == 2);
+    
+    std::cout << "✓ Gap recovery test passed" << std::endl;
+}
+
+void test_manager_gap_callback() {
+    std::cout << "Testing manager gap callback..." << std::endl;
+    
+    OrderBookManager manager;
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+    manager.set_gap_callback([&gaps](IOrderBook&, uint64_t expected, uint64_t received) {
+        gaps.emplace_back(expected, received);
+    });
+    
+    for (uint64_t seq : {1, 2, 5, 6}) {
+        manager.process_update(OrderBookFactory::create_level_update("AMZN", BookSide::BID, BookUpdateType::ADD,
+                                                                 to_fixed_price(180.0 + seq), 10, seq));
+    }
+    manager.process_update(OrderBookFactory::create_level_update("META", BookSide::BID, BookUpdateType::ADD,
+                                                             to_fixed_price(500.0), 10, 1));
+    
+    // Reported once, when the book turned stale
+    assert(gaps.size() == 1);
+    assert(gaps[0].first == 3 && gaps[0].second == 5);
+    assert(manager.get_stale_symbols() == std::vector<std::string>{"AMZN"});
+    assert(manager.get_total_gaps() == 1);
+    
+    // A snapshot without a sequence is taken as current
+    [[maybe_unused]] bool applied =
+        manager.get_book("AMZN")->apply_snapshot({OrderBookLevel(to_fixed_price(186.0), 10, 1)}, {});
+    assert(applied);
+    assert(manager.get_stale_symbols().empty());
+    assert(manager.get_book("AMZN")->get_last_sequence() == 6);
+    assert(manager.get_book("AMZN")->get_book_depth(BookSide::BID) == 1);
+    
+    std::cout << "✓ Manager gap callback test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Order Book Unit Tests" << std::endl;
+    std::cout << "=============================" << std::endl;
+    
+    try {
+        test_ladder_top_of_book();
+        test_ladder_matches_map_book();
+        test_manager_implementation_choice();
+        test_symbol_id_lookup();
+        test_gap_snapshot_recovery();
+        test_manager_gap_callback();
+        
+        std::cout << "\n✅ All order book tests passed!" << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,128 @@
+#include "../order_gateway/order_table.h"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace hft;
+
+static Order make_order(uint64_t id) {
+    TradingSignal signal = MessageFactory::create_trading_signal(
+        "AAPL", SignalAction::BUY, OrderType::LIMIT, 150.0, 100, 1);
+    return Order(id, signal);
+}
+
+void test_insert_find_erase() {
+    std::cout << "Testing order pool and ID index..." << std::endl;
+
+    OrderTable table(4);
+    assert(table.capacity() == 4 && table.size() == 0);
+
+    for (uint64_t id = 1; id <= 4; ++id) {
+        Order* order = table.insert(make_order(id));
+        assert(order && order->order_id == id);
+        assert(std::string(order->symbol) == "AAPL");
+    }
+    assert(table.full());
+    [[maybe_unused]] Order* inserted = table.insert(make_order(5));
+    assert(inserted == nullptr);        // Pool exhausted
+    assert(table.find(3)->quantity == 100);
+
+    [[maybe_unused]] bool erased = table.erase(2);
+    assert(erased);
+    erased = table.erase(2);
+    assert(!erased);
+    assert(table.find(2) == nullptr);
+    inserted = table.insert(make_order(1));
+    assert(inserted == nullptr);        // Duplicate ID
+    inserted = table.insert(make_order(5));
+    assert(inserted != nullptr);        // Freed slot reused
+    assert(table.size() == 4);
+
+    std::cout << "✓ Insert/find/erase test passed" << std::endl;
+}
+
+void test_broker_index() {
+    std::cout << "Testing broker order ID index..." << std::endl;
+
+    OrderTable table(16);
+    Order* first = table.insert(make_order(10));
+    Order* second = table.insert(make_order(11));
+    [[maybe_unused]] bool linked = table.set_broker_id(*first, "b0d1c3a2-0000-4000-8000-000000000001");
+    assert(linked);
+    linked = table.set_broker_id(*second, "b0d1c3a2-0000-4000-8000-000000000002");
+    assert(linked);
+    linked = table.set_broker_id(*second, "");
+    assert(!linked);
+    linked = table.set_broker_id(*second, std::string(Order::BROKER_ID_LENGTH, 'x').c_str());
+    assert(!linked);
+
+    assert(table.find_by_broker_id("b0d1c3a2-0000-4000-8000-000000000001") == first);
+    assert(table.find_by_broker_id("b0d1c3a2-0000-4000-8000-000000000002") == second);
+    assert(table.find_by_broker_id("unknown") == nullptr);
+
+    // Re-acked with a new broker ID: the old one stops resolving
+    linked = table.set_broker_id(*first, "replacement");
+    assert(linked);
+    assert(table.find_by_broker_id("b0d1c3a2-0000-4000-8000-000000000001") == nullptr);
+    assert(table.find_by_broker_id("replacement") == first);
+
+    table.erase(10);
+    assert(table.find_by_broker_id("replacement") == nullptr);
+    assert(table.find_by_broker_id("b0d1c3a2-0000-4000-8000-000000000002") == second);
+
+    std::cout << "✓ Broker index test passed" << std::endl;
+}
+
+void test_churn_against_map() {
+    std::cout << "Testing random churn against unordered_map..." << std::endl;
+
+    // Heavy insert/erase traffic exercises backward-shift deletion
+    const size_t capacity = 512;
+    OrderTable table(capacity);
+    std::unordered_map<uint64_t, std::string> reference;
+    std::mt19937_64 rng(3);
+    uint64_t next_id = 1;
+
+    for (int step = 0; step < 200000; ++step) {
+        bool add = reference.empty() || (reference.size() < capacity && rng() % 2 == 0);
+        if (add) {
+            uint64_t id = next_id++;
+            Order* order = table.insert(make_order(id));
+            assert(order);
+            std::string broker_id = "broker-" + std::to_string(id);
+            [[maybe_unused]] bool linked = table.set_broker_id(*order, broker_id.c_str());
+            assert(linked);
+            reference.emplace(id, broker_id);
+        } else {
+            auto it = reference.begin();
+            std::advance(it, rng() % reference.size());
+            [[maybe_unused]] bool erased = table.erase(it->first);
+            assert(erased);
+            reference.erase(it);
+        }
+
+        if (step % 1000 == 0) {
+            assert(table.size() == reference.size());
+            for (const auto& [id, broker_id] : reference) {
+                Order* order = table.find(id);
+                assert(order && order->order_id == id);
+                assert(table.find_by_broker_id(broker_id.c_str()) == order);
+            }
+        }
+    }
+
+    std::cout << "✓ Churn test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running order table tests..." << std::endl;
+
+    test_insert_find_erase();
+    test_broker_index();
+    test_churn_against_map();
+
+    std::cout << "All order table tests passed!" << std::endl;
+    return 0;
+}
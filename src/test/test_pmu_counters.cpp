@@ -0,0 +1,120 @@
+#include "../common/pmu_counters.h"
+#include "../common/metrics_collector.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+using namespace hft;
+
+namespace {
+
+__attribute__((noinline)) uint64_t spin(uint64_t iterations) {
+    uint64_t value = 1;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        __asm__ volatile("" : "+r"(value));
+    }
+    return value;
+}
+
+void probed_region(uint64_t iterations) {
+    HFT_PMU_SCOPE("test_region");
+    spin(iterations);
+}
+
+} // namespace
+
+void test_disabled_probe_registers_nothing() {
+    std::cout << "Testing disabled probes..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    PmuCounters::set_enabled(false);
+    size_t before = collector.metric_count();
+    probed_region(1000);
+    assert(collector.metric_count() == before);
+
+    // A null region is a no-op scope
+    { PmuScope scope(nullptr); }
+
+    std::cout << "✓ Disabled probe test passed" << std::endl;
+}
+
+void test_region_names() {
+    std::cout << "Testing region metric names..." << std::endl;
+
+    auto& collector = MetricsCollector::instance();
+    PmuRegion region("test_names");
+    assert(collector.metric_name(region.ids[PmuCounters::CYCLES]) == "pmu.test_names.cycles");
+    assert(collector.metric_name(region.ids[PmuCounters::INSTRUCTIONS]) == "pmu.test_names.instructions");
+    assert(collector.metric_name(region.ids[PmuCounters::LLC_MISSES]) == "pmu.test_names.llc_misses");
+    assert(collector.metric_name(region.ids[PmuCounters::BRANCH_MISSES]) == "pmu.test_names.branch_misses");
+
+    // Same name, same IDs
+    PmuRegion again("test_names");
+    assert(again.ids[PmuCounters::CYCLES] == region.ids[PmuCounters::CYCLES]);
+
+    std::cout << "✓ Region name test passed" << std::endl;
+}
+
+void test_enabled_probe_records_counts() {
+    std::cout << "Testing enabled probes..." << std::endl;
+
+    PmuCounters* counters = PmuCounters::for_current_thread();
+    if (!counters) {
+        // Containers and most VMs expose no PMU; the probe must stay inert
+        PmuCounters::set_enabled(true);
+        probed_region(1000);
+        PmuCounters::set_enabled(false);
+        std::cout << "✓ Enabled probe test skipped (no hardware counters here)" << std::endl;
+        return;
+    }
+    assert(counters == PmuCounters::for_current_thread());
+    assert(counters->available(PmuCounters::CYCLES));
+
+    // Totals only grow
+    PmuCounters::Reading first, second;
+    assert(counters->read(first));
+    spin(10000);
+    assert(counters->read(second));
+    assert(second[PmuCounters::CYCLES] > first[PmuCounters::CYCLES]);
+
+    auto& collector = MetricsCollector::instance();
+    collector.clear();
+    collector.initialize();
+    PmuCounters::set_enabled(true);
+    const uint64_t iterations = 100000;
+    for (int i = 0; i < 10; ++i) {
+        probed_region(iterations);
+    }
+    PmuCounters::set_enabled(false);
+    collector.shutdown();
+
+    auto stats = collector.get_statistics();
+    assert(stats.at("pmu.test_region.cycles").count == 10);
+    assert(stats.at("pmu.test_region.cycles").min_value > 0);
+    if (counters->available(PmuCounters::INSTRUCTIONS)) {
+        // At least one instruction per iteration of the loop
+        assert(stats.at("pmu.test_region.instructions").min_value >= iterations);
+    }
+
+    std::cout << "✓ Enabled probe test passed (" << (counters->uses_rdpmc() ? "rdpmc" : "read()") << ", "
+              << stats.at("pmu.test_region.cycles").mean << " cycles per region)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running PMU Counter Unit Tests" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        test_disabled_probe_registers_nothing();
+        test_region_names();
+        test_enabled_probe_records_counts();
+
+        std::cout << "\n✅ All PMU counter tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,256 @@
+#include "../position_risk_service/portfolio_risk.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace hft;
+
+static bool near(double a, double b, double tolerance = 1e-6) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+static SymbolRiskConfig symbol_config(const std::string& value) {
+    SymbolRiskConfig config;
+    std::string error;
+    bool ok = SymbolRiskConfig::parse("X", value, config, error);
+    assert(ok);
+    return config;
+}
+
+void test_parse() {
+    std::cout << "Testing symbol risk config parsing..." << std::endl;
+
+    SymbolRiskConfig config = symbol_config("tech:1.2:0.015:250000");
+    assert(config.sector == "tech" && config.beta == 1.2);
+    assert(config.daily_volatility == 0.015 && config.max_position_value == 250000.0);
+
+    config = symbol_config("rates:-0.3");
+    assert(config.sector == "rates" && config.beta == -0.3 && config.daily_volatility == 0.0);
+
+    config = symbol_config("");
+    assert(config.sector.empty() && config.beta == 1.0);
+
+    std::string error;
+    assert(!SymbolRiskConfig::parse("X", "tech:abc", config, error));
+    assert(error.find("risk.symbol.X") != std::string::npos);
+    assert(!SymbolRiskConfig::parse("X", "tech:1:-0.1", config, error));
+    assert(!SymbolRiskConfig::parse("X", "tech:1:0.1:5:6", config, error));
+
+    std::cout << "✓ Parse test passed" << std::endl;
+}
+
+void test_exposure_and_var() {
+    std::cout << "Testing exposure and VaR..." << std::endl;
+
+    PortfolioRisk risk(16);
+    assert(risk.configure_symbol(0, symbol_config("tech:1.5:0.02")));
+    assert(risk.configure_symbol(1, symbol_config("rates:-0.5:0.01")));
+    PortfolioLimits limits;
+    limits.factor_daily_volatility = 0.01;
+    limits.var_z = 2.0;
+    risk.set_limits(limits);
+    assert(risk.sector_count() == 3);
+
+    risk.update(0, 100, 100.0);     // +10,000
+    risk.update(1, -50, 80.0);      // -4,000
+    risk.update(2, 10, 50.0);       // +500, no sector, default vol 0.02
+    assert(near(risk.gross_exposure(), 14500.0));
+    assert(near(risk.net_exposure(), 6500.0));
+    assert(near(risk.beta_exposure(), 1.5 * 10000 + -0.5 * -4000 + 500));
+    assert(near(risk.sector_exposure("tech"), 10000.0));
+    assert(near(risk.sector_exposure("rates"), -4000.0));
+    assert(risk.sector_exposure("energy") == 0.0);
+
+    double factor = 0.01 * 17500.0;
+    double idiosyncratic = 200.0 * 200.0 + 40.0 * 40.0 + 10.0 * 10.0;
+    assert(near(risk.value_at_risk(), 2.0 * std::sqrt(factor * factor + idiosyncratic)));
+
+    // Tick: a new mark with the same quantity; 0 keeps the mark
+    risk.update(0, 100, 110.0);
+    assert(near(risk.net_exposure(), 7500.0));
+    risk.update(0, 50, 0.0);
+    assert(near(risk.sector_exposure("tech"), 5500.0));
+
+    // Flat again
+    risk.update(0, 0, 0.0);
+    risk.update(1, 0, 0.0);
+    risk.update(2, 0, 0.0);
+    assert(near(risk.gross_exposure(), 0.0) && near(risk.value_at_risk(), 0.0));
+
+    std::cout << "✓ Exposure and VaR test passed" << std::endl;
+}
+
+void test_incremental_matches_recompute() {
+    std::cout << "Testing incremental sums against a full recompute..." << std::endl;
+
+    const size_t symbols = 5000;
+    PortfolioRisk risk(symbols);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> beta(-1.0, 2.0);
+    std::uniform_real_distribution<double> price(5.0, 500.0);
+    std::uniform_int_distribution<int> quantity(-1000, 1000);
+    const char* sectors[] = {"tech", "energy", "health", "rates", ""};
+    for (symbol_id_t id = 0; id < symbols; ++id) {
+        SymbolRiskConfig config;
+        config.sector = sectors[id % 5];
+        config.beta = beta(random);
+        config.daily_volatility = id % 3 == 0 ? 0.0 : 0.03;
+        risk.configure_symbol(id, config);
+    }
+    risk.set_limits(PortfolioLimits{});
+
+    for (int i = 0; i < 200000; ++i) {
+        symbol_id_t id = static_cast<symbol_id_t>(random() % symbols);
+        risk.update(id, quantity(random), i % 3 == 0 ? 0.0 : price(random));
+    }
+    double gross = risk.gross_exposure();
+    double net = risk.net_exposure();
+    double beta_exposure = risk.beta_exposure();
+    double var = risk.value_at_risk();
+    double tech = risk.sector_exposure("tech");
+
+    risk.recompute();
+    assert(near(risk.gross_exposure(), gross, 1e-9));
+    assert(near(risk.net_exposure(), net, 1e-6));
+    assert(near(risk.beta_exposure(), beta_exposure, 1e-6));
+    assert(near(risk.value_at_risk(), var, 1e-6));
+    assert(near(risk.sector_exposure("tech"), tech, 1e-6));
+
+    std::cout << "✓ Incremental test passed" << std::endl;
+}
+
+void test_checks() {
+    std::cout << "Testing order checks..." << std::endl;
+
+    PortfolioRisk risk(64);
+    risk.configure_symbol(0, symbol_config("tech:1:0.02"));
+    risk.configure_symbol(1, symbol_config("tech:1:0.02:5000"));
+    risk.configure_symbol(2, symbol_config("rates:1:0.02"));
+    PortfolioLimits limits;
+    limits.max_position_value = 20000.0;
+    limits.max_gross_exposure = 60000.0;
+    limits.max_net_exposure = 30000.0;
+    limits.max_sector_exposure = 22000.0;
+    risk.set_limits(limits);
+
+    risk.update(0, 150, 100.0);     // tech 15,000
+    risk.update(2, -100, 100.0);    // rates -10,000
+    risk.update(3, 50, 100.0);      // no sector, 5,000
+
+    auto check = [&](symbol_id_t id, int32_t quantity, double price = 0.0) {
+        return risk.check(CandidateOrder{id, quantity, price});
+    };
+    assert(check(0, 10) == PortfolioCheck::OK);
+    // Symbol 0 at 21,000 > 20,000
+    assert(check(0, 60) == PortfolioCheck::POSITION_LIMIT);
+    // Symbol 1's own limit, at the order's price (no mark yet)
+    assert(check(1, 40, 100.0) == PortfolioCheck::OK);
+    assert(check(1, 60, 100.0) == PortfolioCheck::POSITION_LIMIT);
+    // Tech at 22,500 > 22,000 with each symbol inside its limit
+    assert(check(1, 45, 100.0) == PortfolioCheck::OK);
+    risk.update(1, 45, 100.0);      // tech 19,500
+    assert(check(0, 30) == PortfolioCheck::SECTOR_EXPOSURE);
+    assert(check(3, 160) == PortfolioCheck::POSITION_LIMIT);
+    // Net 14,500 + 16,000 = 30,500 > 30,000, outside any sector
+    assert(check(4, 160, 100.0) == PortfolioCheck::NET_EXPOSURE);
+    assert(check(4, -160, 100.0) == PortfolioCheck::OK);
+    // Gross 60,500 > 60,000 once filled
+    risk.update(4, -160, 100.0);
+    risk.update(6, -100, 100.0);
+    assert(risk.breached());
+    assert(check(5, 10, 10.0) == PortfolioCheck::GROSS_EXPOSURE);
+    // Reducing what is over the limit goes through
+    assert(check(4, 10) == PortfolioCheck::OK);
+    assert(check(0, -150) == PortfolioCheck::OK);
+    risk.update(4, 0, 0.0);
+    risk.update(6, 0, 0.0);
+    assert(!risk.breached());
+
+    // VaR: a limit just above the current VaR admits reductions only
+    limits.max_value_at_risk = risk.value_at_risk() * 1.0001;
+    risk.set_limits(limits);
+    assert(!risk.breached());
+    assert(check(0, 20) == PortfolioCheck::VALUE_AT_RISK);
+    assert(check(0, -20) == PortfolioCheck::OK);
+    // A short in a positive-beta name hedges the factor
+    assert(check(5, -20, 100.0) == PortfolioCheck::OK);
+
+    assert(check(INVALID_SYMBOL_ID, 10) == PortfolioCheck::UNKNOWN_SYMBOL);
+    assert(check(1000, 10) == PortfolioCheck::UNKNOWN_SYMBOL);
+    assert(std::string(to_string(PortfolioCheck::SECTOR_EXPOSURE)) == "SECTOR_EXPOSURE");
+
+    std::cout << "✓ Order check test passed" << std::endl;
+}
+
+void test_batch() {
+    std::cout << "Testing batch evaluation..." << std::endl;
+
+    const size_t symbols = 5000;
+    PortfolioRisk risk(symbols);
+    std::mt19937 random(11);
+    for (symbol_id_t id = 0; id < symbols; ++id) {
+        SymbolRiskConfig config;
+        config.sector = id % 2 ? "odd" : "even";
+        config.beta = 0.5 + (id % 7) * 0.2;
+        risk.configure_symbol(id, config);
+    }
+    PortfolioLimits limits;
+    limits.max_position_value = 50000.0;
+    limits.max_gross_exposure = 50000000.0;
+    limits.max_net_exposure = 1000000.0;
+    limits.max_sector_exposure = 800000.0;
+    limits.max_value_at_risk = 150000.0;
+    risk.set_limits(limits);
+    for (symbol_id_t id = 0; id < symbols; ++id) {
+        risk.update(id, static_cast<double>(random() % 400) - 200.0, 20.0 + id % 100);
+    }
+
+    // Every size around the lane and batch boundaries, each order checked
+    // against the same portfolio as on its own
+    std::vector<CandidateOrder> orders;
+    for (size_t i = 0; i < 1000; ++i) {
+        CandidateOrder order;
+        order.symbol_id = i % 97 == 0 ? INVALID_SYMBOL_ID : static_cast<symbol_id_t>(random() % symbols);
+        order.quantity = static_cast<int32_t>(random() % 6000) - 3000;
+        order.price = i % 2 ? 0.0 : 50.0;
+        orders.push_back(order);
+    }
+    size_t outcomes[7] = {};
+    for (size_t count : {size_t{1}, size_t{3}, size_t{63}, size_t{64}, size_t{65}, size_t{1000}}) {
+        std::vector<PortfolioCheck> results(count);
+        risk.evaluate(orders.data(), count, results.data());
+        for (size_t i = 0; i < count; ++i) {
+            assert(results[i] == risk.check(orders[i]));
+            if (count == 1000) outcomes[static_cast<size_t>(results[i])]++;
+        }
+    }
+    // The mix above exercises more than one outcome
+    assert(outcomes[static_cast<size_t>(PortfolioCheck::OK)] > 0);
+    assert(outcomes[static_cast<size_t>(PortfolioCheck::POSITION_LIMIT)] > 0);
+    assert(outcomes[static_cast<size_t>(PortfolioCheck::UNKNOWN_SYMBOL)] > 0);
+    risk.evaluate(orders.data(), 0, nullptr);
+
+    std::cout << "✓ Batch test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Portfolio Risk Unit Tests" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try {
+        test_parse();
+        test_exposure_and_var();
+        test_incremental_matches_recompute();
+        test_checks();
+        test_batch();
+
+        std::cout << "\n✅ All portfolio risk tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
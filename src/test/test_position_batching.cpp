@@ -0,0 +1,200 @@
+#include "../position_risk_service/position_risk_service.h"
+#include "../common/fixed_format.h"
+#include "../common/message_capture.h"
+#include "../common/static_config.h"
+#include "../common/zmq_transport.h"
+#include <zmq.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+std::string g_directory;
+
+OrderExecution make_fill(const std::string& symbol, uint32_t quantity, double price) {
+    OrderExecution execution{};
+    execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION,
+                                                     sizeof(OrderExecution) - sizeof(MessageHeader));
+    copy_field(execution.symbol, symbol);
+    execution.symbol_id = SymbolTable::instance().intern(execution.symbol);
+    execution.exec_type = ExecutionType::FILL;
+    execution.fill_price = to_fixed_price(price);
+    execution.fill_quantity = quantity;
+    return execution;
+}
+
+MarketData make_tick(const std::string& symbol, double last) {
+    return MessageFactory::create_market_data(symbol, last - 0.01, last + 0.01, 100, 100, last, 100);
+}
+
+// Records what add() is given as a capture, in order, and reads it back.
+// Capture files are named by service and second, so each needs its own name.
+class CaptureBuilder {
+public:
+    explicit CaptureBuilder(const std::string& name) : capture_(g_directory, name) {
+        executions_ = capture_.channel("executions");
+        market_data_ = capture_.channel("market_data");
+        [[maybe_unused]] bool ok = capture_.start();
+        assert(ok);
+    }
+
+    CaptureBuilder& add(const OrderExecution& execution) {
+        [[maybe_unused]] bool ok = capture_.record(executions_, &execution, sizeof(execution));
+        assert(ok);
+        return *this;
+    }
+
+    CaptureBuilder& add(const MarketData& data) {
+        [[maybe_unused]] bool ok = capture_.record(market_data_, &data, sizeof(data));
+        assert(ok);
+        return *this;
+    }
+
+    void read(CaptureReader& reader) {
+        capture_.stop();
+        [[maybe_unused]] bool ok = reader.open(capture_.path());
+        assert(ok);
+    }
+
+private:
+    MessageCapture capture_;
+    uint8_t executions_;
+    uint8_t market_data_;
+};
+
+// One multipart message off the positions stream; empty if none came
+std::vector<PositionUpdate> receive_batch(zmq::socket_t& socket) {
+    std::vector<PositionUpdate> batch;
+    zmq::message_t message;
+    while (socket.recv(message, zmq::recv_flags::none)) {
+        assert(message.size() == sizeof(PositionUpdate));
+        PositionUpdate update;
+        std::memcpy(&update, message.data(), sizeof(update));
+        batch.push_back(update);
+        if (!message.more()) break;
+    }
+    return batch;
+}
+
+bool near(double a, double b) {
+    return std::abs(a - b) < 1e-6;
+}
+
+} // namespace
+
+void test_batched_updates() {
+    std::cout << "Testing incremental marks and batched PositionUpdates..." << std::endl;
+
+    PositionRiskService service;
+    [[maybe_unused]] bool ok = service.initialize();
+    assert(ok);
+
+    zmq::socket_t subscriber(process_zmq_context(), zmq::socket_type::sub);
+    subscriber.set(zmq::sockopt::subscribe, "");
+    subscriber.set(zmq::sockopt::rcvtimeo, 200);
+    subscriber.connect(zmq_data_endpoint(StaticConfig::get_positions_endpoint()));
+
+    // PUB/SUB drops everything sent before the subscription lands; each
+    // replay ends with a forced flush of the probe's position
+    CaptureReader probe;
+    CaptureBuilder("probe").add(make_fill("PROBE", 1, 5.0)).read(probe);
+    bool subscribed = false;
+    for (int attempt = 0; attempt < 50 && !subscribed; ++attempt) {
+        service.replay_capture(probe);
+        subscribed = !receive_batch(subscriber).empty();
+    }
+    assert(subscribed);
+    while (!receive_batch(subscriber).empty()) {}
+
+    // Fills and ticks for two symbols, ticks for one never traded; the
+    // publish interval is far away, so all of it goes out in the final flush
+    CaptureReader reader;
+    CaptureBuilder("batch")
+        .add(make_fill("BATCHA", 100, 10.0))
+        .add(make_tick("BATCHD", 30.0))
+        .add(make_fill("BATCHB", 50, 20.0))
+        .add(make_tick("BATCHA", 11.0))
+        .add(make_tick("BATCHB", 19.0))
+        .add(make_tick("BATCHA", 12.0))
+        .add(make_tick("BATCHD", 31.0))
+        .read(reader);
+    ReplayReport report = service.replay_capture(reader);
+    assert(report.messages == 7 && report.skipped == 0);
+
+    std::vector<PositionUpdate> batch = receive_batch(subscriber);
+    assert(batch.size() == 2);      // One part per re-marked symbol, each once
+    assert(std::string(batch[0].symbol) == "BATCHA");
+    assert(batch[0].position == 100);
+    assert(near(batch[0].average_price, 10.0));
+    assert(near(batch[0].unrealized_pnl, 200.0));
+    assert(near(batch[0].market_value, 1200.0));
+    assert(std::string(batch[1].symbol) == "BATCHB");
+    assert(batch[1].position == 50);
+    assert(near(batch[1].unrealized_pnl, -50.0));
+    assert(near(batch[1].market_value, 950.0));
+    batch = receive_batch(subscriber);
+    assert(batch.empty());
+
+    // Ticks for symbols without a position publish nothing
+    CaptureReader untraded;
+    CaptureBuilder("untraded").add(make_tick("BATCHD", 32.0)).add(make_tick("BATCHE", 1.0)).read(untraded);
+    report = service.replay_capture(untraded);
+    assert(report.messages == 2);
+    batch = receive_batch(subscriber);
+    assert(batch.empty());
+
+    // Only the symbol that ticked is re-marked and sent
+    CaptureReader one_tick;
+    CaptureBuilder("one_tick").add(make_tick("BATCHB", 21.0)).read(one_tick);
+    service.replay_capture(one_tick);
+    batch = receive_batch(subscriber);
+    assert(batch.size() == 1 && std::string(batch[0].symbol) == "BATCHB");
+    assert(near(batch[0].unrealized_pnl, 50.0));
+    assert(near(batch[0].market_value, 1050.0));
+
+    subscriber.close();
+    std::cout << "✓ Batched PositionUpdate test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Position Batching Unit Tests" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    g_directory = "/tmp/hft_test_position_batching_" + std::to_string(getpid());
+    std::filesystem::create_directories(g_directory);
+    std::string path = g_directory + "/test.conf";
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "zmq.endpoint_scheme=inproc\n";
+        out << "journal.enabled=false\n";
+        out << "warmup.enabled=false\n";
+        out << "capture.enabled=false\n";
+        out << "risk.position_publish_interval_ms=600000\n";
+    }
+
+    try {
+        [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+        assert(loaded);
+
+        test_batched_updates();
+
+        std::filesystem::remove_all(g_directory);
+        std::cout << "\n✅ All position batching tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::filesystem::remove_all(g_directory);
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,198 @@
+#include "../common/pre_trade_risk.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace hft;
+
+static constexpr int64_t SECOND_NS = 1000000000LL;
+
+static RiskLimits test_limits() {
+    RiskLimits limits;
+    limits.max_order_quantity = 500;
+    limits.max_order_notional = 20000.0;
+    limits.max_position = 1000;
+    limits.price_band_ratio = 0.05;
+    return limits;
+}
+
+void test_order_limits() {
+    std::cout << "Testing size, notional and price band checks..." << std::endl;
+
+    PreTradeRisk risk;
+    risk.set_default_limits(test_limits());
+    const symbol_id_t id = 3;
+    const price_t px = to_fixed_price(20.0);
+
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 0, 0) == RiskCheckResult::INVALID_ORDER);
+    assert(risk.check(id, SignalAction::CANCEL, OrderType::LIMIT, px, 10, 0) == RiskCheckResult::INVALID_ORDER);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 501, 0) == RiskCheckResult::ORDER_SIZE);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(50.0), 500, 0) ==
+           RiskCheckResult::ORDER_NOTIONAL);
+
+    // No reference yet: market orders can't be valued, bands can't apply
+    assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 100, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(30.0), 100, 0) ==
+           RiskCheckResult::PASSED);
+
+    risk.set_reference_price(id, px);
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, to_fixed_price(21.5), 10, 0) ==
+           RiskCheckResult::PRICE_BAND);
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, to_fixed_price(20.9), 10, 0) ==
+           RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 500, 0) == RiskCheckResult::PASSED);
+
+    risk.set_halted(true);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 10, 0) == RiskCheckResult::HALTED);
+
+    std::cout << "✓ Order limit test passed" << std::endl;
+}
+
+void test_position_tracking() {
+    std::cout << "Testing position limit with working orders..." << std::endl;
+
+    PreTradeRisk risk;
+    risk.set_default_limits(test_limits());
+    const symbol_id_t id = 1;
+    const price_t px = to_fixed_price(10.0);
+
+    // Working orders count against the limit before they fill
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 1, 0) == RiskCheckResult::POSITION_LIMIT);
+    assert(risk.get_working_quantity(id, SignalAction::BUY) == 1000);
+
+    risk.on_fill(id, SignalAction::BUY, 500);
+    risk.on_order_closed(id, SignalAction::BUY, 500);
+    assert(risk.get_position(id) == 500);
+    assert(risk.get_working_quantity(id, SignalAction::BUY) == 0);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, px, 1, 0) == RiskCheckResult::POSITION_LIMIT);
+
+    // Selling down from long has room for the whole long plus the limit short
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, px, 500, 0) == RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::SELL, OrderType::LIMIT, px, 1, 0) == RiskCheckResult::POSITION_LIMIT);
+
+    std::cout << "✓ Position tracking test passed" << std::endl;
+}
+
+void test_rate_limit() {
+    std::cout << "Testing order rate throttle..." << std::endl;
+
+    PreTradeRisk risk;
+    RiskLimits limits;
+    limits.max_orders_per_second = 10;
+    risk.set_default_limits(limits);
+    const symbol_id_t id = 0;
+    const int64_t start = 5 * SECOND_NS;
+
+    // A full second's budget as a burst, then nothing until time passes
+    for (int i = 0; i < 10; ++i) {
+        assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 1, start) == RiskCheckResult::PASSED);
+    }
+    assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 1, start) == RiskCheckResult::RATE_LIMIT);
+    assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 1, start + SECOND_NS / 10) ==
+           RiskCheckResult::PASSED);
+    assert(risk.check(id, SignalAction::BUY, OrderType::MARKET, 0, 1, start + SECOND_NS / 10) ==
+           RiskCheckResult::RATE_LIMIT);
+
+    // Other symbols have their own budget
+    assert(risk.check(id + 1, SignalAction::BUY, OrderType::MARKET, 0, 1, start) == RiskCheckResult::PASSED);
+
+    std::cout << "✓ Rate limit test passed" << std::endl;
+}
+
+void test_reset_order_state() {
+    std::cout << "Testing order state reset..." << std::endl;
+
+    PreTradeRisk risk;
+    RiskLimits limits = test_limits();
+    limits.max_orders_per_second = 1;
+    risk.set_default_limits(limits);
+    risk.set_reference_price(0, to_fixed_price(100.0));
+    const int64_t now = 5 * SECOND_NS;
+
+    assert(risk.check(0, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.0), 100, now) == RiskCheckResult::PASSED);
+    risk.on_fill(0, SignalAction::BUY, 60);
+    assert(risk.check(0, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.0), 100, now) == RiskCheckResult::RATE_LIMIT);
+
+    // Position, working and rate history go; limits and reference price stay
+    risk.reset_order_state();
+    assert(risk.get_position(0) == 0);
+    assert(risk.get_working_quantity(0, SignalAction::BUY) == 0);
+    assert(risk.check(0, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.0), 100, now) == RiskCheckResult::PASSED);
+    assert(risk.get_limits(0).max_order_quantity == 500);
+    assert(risk.check(0, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(200.0), 1, now + SECOND_NS) ==
+           RiskCheckResult::PRICE_BAND);
+
+    std::cout << "✓ Order state reset test passed" << std::endl;
+}
+
+void test_limit_updates() {
+    std::cout << "Testing limit updates from the risk service..." << std::endl;
+
+    PreTradeRisk risk;
+    risk.set_default_limits(test_limits());
+    symbol_id_t id = SymbolTable::instance().intern("RISKTEST");
+
+    RiskLimitUpdate update{};
+    update.header = MessageFactory::create_header(MessageType::RISK_LIMIT_UPDATE,
+                                                 sizeof(RiskLimitUpdate) - sizeof(MessageHeader));
+    std::strncpy(update.symbol, "RISKTEST", sizeof(update.symbol) - 1);
+    update.symbol_id = id;
+    update.max_order_quantity = 50;
+    update.reference_price = to_fixed_price(100.0);
+    risk.apply(update);
+    assert(risk.get_limits(id).max_order_quantity == 50);
+    assert(risk.get_limits(id + 1).max_order_quantity == 500);
+    assert(risk.check(id, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.0), 51, 0) ==
+           RiskCheckResult::ORDER_SIZE);
+
+    update.symbol_id = INVALID_SYMBOL_ID;
+    update.halted = 1;
+    risk.apply(update);
+    assert(risk.is_halted());
+    assert(risk.get_limits(id + 1).max_order_quantity == 50);
+
+    std::cout << "✓ Limit update test passed" << std::endl;
+}
+
+void test_check_latency() {
+    std::cout << "Measuring check latency..." << std::endl;
+
+    PreTradeRisk risk;
+    RiskLimits limits = test_limits();
+    limits.max_position = 0;
+    risk.set_default_limits(limits);
+    risk.set_reference_price(2, to_fixed_price(10.0));
+
+    const int iterations = 1000000;
+    uint64_t passed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        passed += risk.check(2, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(10.0), 100, i) ==
+                  RiskCheckResult::PASSED;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    assert(passed == static_cast<uint64_t>(iterations));
+
+    std::cout << "  " << ns / iterations << " ns per check" << std::endl;
+    std::cout << "✓ Latency measurement done" << std::endl;
+}
+
+int main() {
+    std::cout << "Running pre-trade risk tests..." << std::endl;
+
+    test_order_limits();
+    test_position_tracking();
+    test_rate_limit();
+    test_reset_order_state();
+    test_limit_updates();
+    test_check_latency();
+
+    std::cout << "All pre-trade risk tests passed!" << std::endl;
+    return 0;
+}
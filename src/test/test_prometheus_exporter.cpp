@@ -0,0 +1,124 @@
+#include "../common/prometheus_exporter.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using namespace hft;
+
+using StatsMap = std::unordered_map<std::string, MetricStats>;
+
+static MetricStats make_stats(const std::string& name, MetricType type, uint64_t value) {
+    MetricStats stats;
+    stats.name = name;
+    stats.type = type;
+    if (type == MetricType::LATENCY || type == MetricType::HISTOGRAM) {
+        stats.histogram.record(value);
+        stats.histogram.record(value * 2);
+        stats.calculate_percentiles();
+    } else {
+        stats.count = 1;
+        stats.sum = value;
+        stats.min_value = value;
+        stats.max_value = value;
+    }
+    return stats;
+}
+
+static bool contains(const std::string& text, const std::string& line) {
+    return text.find(line) != std::string::npos;
+}
+
+void test_writer_formatting() {
+    std::cout << "Testing number formatting..." << std::endl;
+
+    std::string buffer;
+    PrometheusWriter writer(buffer);
+    writer << "a " << uint64_t(18446744073709551615ull) << " " << int64_t(-42) << " " << 1.5 << " " << 0.25
+           << " " << 1728912345.678 << "\n";
+    assert(buffer == "a 18446744073709551615 -42 1.5 0.25 1728912345.678\n");
+
+    std::cout << "✓ Formatting test passed" << std::endl;
+}
+
+void test_exposition_text() {
+    std::cout << "Testing exposition output..." << std::endl;
+
+    StatsMap stats;
+    stats["orders.submitted"] = make_stats("orders.submitted", MetricType::COUNTER, 5);
+    stats["md.parse_ns"] = make_stats("md.parse_ns", MetricType::LATENCY, 400);
+    stats["md.total_latency_ns"] = make_stats("md.total_latency_ns", MetricType::LATENCY, 300);
+    stats["trading.positions_open"] = make_stats("trading.positions_open", MetricType::GAUGE, 3);
+
+    PrometheusExporter exporter;
+    const std::string& text = exporter.render(stats);
+    assert(contains(text, "# TYPE hft_orders_submitted_total counter\nhft_orders_submitted_total 5\n"));
+    assert(contains(text, "hft_md_parse_ns_nanoseconds_bucket{le=\"250\"} 0\n"));
+    assert(contains(text, "hft_md_parse_ns_nanoseconds_bucket{le=\"1000\"} 2\n"));
+    assert(contains(text, "hft_md_parse_ns_nanoseconds_count 2\n"));
+    assert(contains(text, "hft_md_total_latency_ns_histogram_count 2\n"));
+    assert(contains(text, "hft_trading_positions_open 3\n"));
+    assert(contains(text, "hft_component_status{component=\"strategy_engine\"} 1\n"));
+    // Handled metrics only appear in their HFT-specific form
+    assert(!contains(text, "hft_md_total_latency_ns_nanoseconds"));
+    assert(!contains(text, "hft_trading_positions_open_min"));
+
+    // The one-shot path renders the same families
+    std::string once = PrometheusExporter::export_metrics(&stats);
+    assert(contains(once, "hft_orders_submitted_total 5\n"));
+    assert(contains(once, "hft_md_total_latency_ns_histogram_count 2\n"));
+
+    std::cout << "✓ Exposition test passed" << std::endl;
+}
+
+void test_incremental_render() {
+    std::cout << "Testing incremental re-rendering..." << std::endl;
+
+    StatsMap stats;
+    for (int i = 0; i < 50; ++i) {
+        std::string name = "svc.metric_" + std::to_string(i);
+        stats[name] = make_stats(name, i % 2 ? MetricType::COUNTER : MetricType::LATENCY, 100 + i);
+    }
+
+    PrometheusExporter exporter;
+    exporter.render(stats);
+    assert(exporter.get_families_rendered() == 50);
+
+    // Unchanged values: every family comes from the cache
+    std::string first = exporter.render(stats);
+    assert(exporter.get_families_rendered() == 50);
+    assert(exporter.get_families_reused() == 50);
+
+    // One change re-renders one family
+    stats["svc.metric_7"].sum = 999;
+    const std::string& second = exporter.render(stats);
+    assert(exporter.get_families_rendered() == 51);
+    assert(contains(second, "hft_svc_metric_7_total 999\n"));
+    assert(!contains(first, "hft_svc_metric_7_total 999\n"));
+
+    // A metric that went away is dropped from the output
+    stats.erase("svc.metric_8");
+    const std::string& third = exporter.render(stats);
+    assert(!contains(third, "hft_svc_metric_8_"));
+    assert(contains(third, "hft_svc_metric_9_total"));
+
+    std::cout << "✓ Incremental render test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Prometheus Exporter Unit Tests" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try {
+        test_writer_formatting();
+        test_exposition_text();
+        test_incremental_render();
+
+        std::cout << "\n✅ All Prometheus exporter tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,222 @@
+#include "../order_gateway/quote_coalescer.h"
+#include "../order_gateway/order_table.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace hft;
+
+static constexpr int64_t MS = 1000000;
+
+static TradingSignal make_quote(SignalAction side, double price, uint32_t quantity, uint64_t strategy_id = 7) {
+    return MessageFactory::create_quote_signal(SymbolTable::instance().intern("AAPL"), side, price, quantity, strategy_id);
+}
+
+void test_quote_signal() {
+    std::cout << "Testing quote signals become orders on their side..." << std::endl;
+
+    TradingSignal quote = make_quote(SignalAction::SELL, 150.25, 200);
+    assert(quote.action == SignalAction::MODIFY && quote.side == SignalAction::SELL);
+    assert(quote.order_type == OrderType::LIMIT);
+    TradingSignal plain = MessageFactory::create_trading_signal("AAPL", SignalAction::SELL, OrderType::LIMIT, 150.0, 1, 7);
+    assert(plain.side == SignalAction::SELL);
+
+    Order order(42, quote);
+    assert(order.action == SignalAction::SELL && order.quote && order.strategy_id == 7);
+    assert(!Order(43, plain).quote);
+
+    std::cout << "✓ Quote signal test passed" << std::endl;
+}
+
+void test_token_bucket() {
+    std::cout << "Testing venue token bucket..." << std::endl;
+
+    TokenBucket bucket;
+    assert(!bucket.enabled());
+    int granted = 0;
+    for (int i = 0; i < 1000; ++i) granted += bucket.try_acquire(0);
+    assert(granted == 1000);        // Off: unlimited
+
+    // 200/minute with a burst of 10
+    bucket.configure(200.0 / 60.0, 10);
+    bucket.reset();
+    int64_t now = 1000 * MS;
+    granted = 0;
+    for (int i = 0; i < 10; ++i) granted += bucket.try_acquire(now);
+    assert(granted == 10);
+    [[maybe_unused]] bool acquired = bucket.try_acquire(now);
+    assert(!acquired);
+    assert(bucket.ready_at_ns() == now + 300 * MS);
+    acquired = bucket.try_acquire(now + 299 * MS);
+    assert(!acquired);
+    acquired = bucket.try_acquire(now + 300 * MS);
+    assert(acquired);
+
+    // Idle time refills up to the burst, no further
+    now += 60000 * MS;
+    granted = 0;
+    while (bucket.try_acquire(now)) granted++;
+    assert(granted == 10);
+
+    std::cout << "✓ Token bucket test passed" << std::endl;
+}
+
+void test_coalesce_while_in_flight() {
+    std::cout << "Testing quotes collapse while a replace is unacked..." << std::endl;
+
+    QuoteCoalescer quotes(16);
+    QuoteSlot* slot = nullptr;
+
+    // First quote places an order
+    [[maybe_unused]] auto decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.00, 100), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    assert(slot->order_id == 0);
+    quotes.on_sent(*slot, 1);
+
+    // Three more before the ack: only the newest survives
+    QuoteSlot* same = nullptr;
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.01, 100), 0, same);
+    assert(decision == QuoteCoalescer::Decision::HELD);
+    assert(same == slot);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.02, 100), 0, same);
+    assert(decision == QuoteCoalescer::Decision::HELD);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.03, 300), 0, same);
+    assert(decision == QuoteCoalescer::Decision::HELD);
+    assert(quotes.coalesced() == 2);
+
+    // The other side and other strategies have their own slots
+    QuoteSlot* ask = nullptr;
+    decision = quotes.on_quote(make_quote(SignalAction::SELL, 100.10, 100), 0, ask);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    assert(ask != slot);
+    QuoteSlot* other = nullptr;
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 99.00, 100, 8), 0, other);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    assert(other != slot && quotes.size() == 3);
+
+    // Nothing goes until the ack; then one replace with the latest quote
+    std::vector<TradingSignal> sent;
+    auto send = [&](QuoteSlot& s) {
+        sent.push_back(s.latest);
+        quotes.on_sent(s, s.order_id);
+    };
+    [[maybe_unused]] size_t released = quotes.release(0, send);
+    assert(released == 0);
+    quotes.on_ack(*slot, to_fixed_price(100.00), 100);
+    released = quotes.release(0, send);
+    assert(released == 1);
+    assert(sent.size() == 1 && sent[0].price == to_fixed_price(100.03) && sent[0].quantity == 300);
+    assert(slot->order_id == 1 && slot->in_flight);
+
+    // Acked at the latest: an identical quote is dropped
+    quotes.on_ack(*slot, sent[0].price, sent[0].quantity);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.03, 300), 0, same);
+    assert(decision == QuoteCoalescer::Decision::UNCHANGED);
+    assert(!quotes.has_releases());
+
+    // Once the order is gone the next quote places a new one
+    quotes.on_closed(*slot);
+    assert(slot->order_id == 0);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.03, 300), 0, same);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+
+    std::cout << "✓ In-flight coalescing test passed" << std::endl;
+}
+
+void test_rate_limited_release() {
+    std::cout << "Testing quotes wait for venue tokens..." << std::endl;
+
+    QuoteCoalescer quotes(16);
+    quotes.venue_limit().configure(10.0, 2);     // 100ms apart after a burst of 2
+    QuoteSlot* bid = nullptr;
+    QuoteSlot* ask = nullptr;
+    QuoteSlot* slot = nullptr;
+
+    [[maybe_unused]] auto decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.00, 100), 0, bid);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    decision = quotes.on_quote(make_quote(SignalAction::SELL, 100.10, 100), 0, ask);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    quotes.on_sent(*bid, 1);
+    quotes.on_sent(*ask, 2);
+    quotes.on_ack(*bid, to_fixed_price(100.00), 100);
+    quotes.on_ack(*ask, to_fixed_price(100.10), 100);
+
+    // Out of tokens: requotes on both sides are held, and keep collapsing
+    for (int i = 1; i <= 5; ++i) {
+        decision = quotes.on_quote(make_quote(SignalAction::BUY, 100.00 + i * 0.01, 100), MS, slot);
+        assert(decision == QuoteCoalescer::Decision::HELD);
+        decision = quotes.on_quote(make_quote(SignalAction::SELL, 100.10 + i * 0.01, 100), MS, slot);
+        assert(decision == QuoteCoalescer::Decision::HELD);
+    }
+    assert(quotes.throttled() == 10 && quotes.coalesced() == 8);
+
+    std::vector<uint64_t> order_ids;
+    auto send = [&](QuoteSlot& s) {
+        order_ids.push_back(s.order_id);
+        assert(s.latest.price == to_fixed_price(s.side == SignalAction::BUY ? 100.05 : 100.15));
+        quotes.on_sent(s, s.order_id);
+    };
+    [[maybe_unused]] size_t released = quotes.release(50 * MS, send);
+    assert(released == 0);
+    released = quotes.release(100 * MS, send);
+    assert(released == 1);
+    released = quotes.release(150 * MS, send);
+    assert(released == 0);
+    released = quotes.release(200 * MS, send);
+    assert(released == 1);
+    assert(order_ids.size() == 2 && order_ids[0] != order_ids[1]);
+    assert(!quotes.has_releases());
+    assert(quotes.sent() == 4);
+
+    std::cout << "✓ Rate-limited release test passed" << std::endl;
+}
+
+void test_slots_and_recovery() {
+    std::cout << "Testing slot capacity and journal adoption..." << std::endl;
+
+    QuoteCoalescer quotes(2);
+    QuoteSlot* slot = nullptr;
+    [[maybe_unused]] auto decision = quotes.on_quote(make_quote(SignalAction::BUY, 1.0, 1, 1), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 1.0, 1, 2), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    decision = quotes.on_quote(make_quote(SignalAction::BUY, 1.0, 1, 3), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::FULL);
+    TradingSignal bad = make_quote(SignalAction::MODIFY, 1.0, 1, 1);
+    decision = quotes.on_quote(bad, 0, slot);
+    assert(decision == QuoteCoalescer::Decision::FULL);
+
+    // A recovered working order is replaced, not duplicated
+    QuoteCoalescer recovered(16);
+    symbol_id_t aapl = SymbolTable::instance().intern("AAPL");
+    QuoteSlot* adopted = recovered.adopt(7, aapl, SignalAction::SELL, 99, to_fixed_price(101.0), 100);
+    assert(adopted && recovered.find(7, aapl, SignalAction::SELL) == adopted);
+    assert(recovered.find(7, aapl, SignalAction::BUY) == nullptr);
+    decision = recovered.on_quote(make_quote(SignalAction::SELL, 101.0, 100), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::UNCHANGED);
+    decision = recovered.on_quote(make_quote(SignalAction::SELL, 101.5, 100), 0, slot);
+    assert(decision == QuoteCoalescer::Decision::SEND);
+    assert(slot == adopted && slot->order_id == 99);
+
+    std::cout << "✓ Slot and recovery test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Quote Coalescer Unit Tests" << std::endl;
+    std::cout << "==================================" << std::endl;
+
+    try {
+        test_quote_signal();
+        test_token_bucket();
+        test_coalesce_while_in_flight();
+        test_rate_limited_release();
+        test_slots_and_recovery();
+
+        std::cout << "\n✅ All quote coalescer tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,95 @@
+#include "../common/rolling_window.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using namespace hft;
+
+static bool near(double a, double b, double tolerance = 1e-9) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+void test_window_contents() {
+    std::cout << "Testing rolling window eviction..." << std::endl;
+
+    RollingWindow window(3);
+    assert(window.empty() && !window.full());
+    window.push(1.0);
+    window.push(2.0);
+    window.push(3.0);
+    assert(window.full() && window.size() == 3);
+    window.push(4.0);
+    assert(window.size() == 3);
+    assert(window.front() == 2.0 && window.back() == 4.0 && window[1] == 3.0);
+    assert(near(window.sum(), 9.0) && near(window.mean(), 3.0));
+    assert(window.min() == 2.0 && window.max() == 4.0);
+
+    window.reset(0);
+    assert(window.capacity() == 1 && window.empty());
+
+    std::cout << "✓ Eviction test passed" << std::endl;
+}
+
+void test_against_brute_force() {
+    std::cout << "Testing incremental stats against recomputation..." << std::endl;
+
+    const size_t capacity = 20;
+    RollingWindow window(capacity);
+    std::deque<double> reference;
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> dist(100.0, 5.0);
+
+    // Long enough to cross several resyncs
+    for (size_t i = 0; i < capacity * 3000; ++i) {
+        double value = dist(rng);
+        window.push(value);
+        reference.push_back(value);
+        if (reference.size() > capacity) reference.pop_front();
+
+        if (i % 97 != 0 || reference.size() < 2) continue;
+        double mean = std::accumulate(reference.begin(), reference.end(), 0.0) / reference.size();
+        double m2 = 0.0;
+        for (double v : reference) m2 += (v - mean) * (v - mean);
+        assert(near(window.mean(), mean));
+        assert(near(window.variance(), m2 / reference.size(), 1e-6));
+        assert(window.min() == *std::min_element(reference.begin(), reference.end()));
+        assert(window.max() == *std::max_element(reference.begin(), reference.end()));
+        assert(near(window.z_score(value), (value - mean) / std::sqrt(m2 / reference.size()), 1e-6));
+    }
+
+    std::cout << "✓ Brute force comparison passed" << std::endl;
+}
+
+void test_ewma() {
+    std::cout << "Testing EWMA..." << std::endl;
+
+    RollingWindow window(2, 0.5);
+    window.push(10.0);
+    assert(window.ewma() == 10.0);
+    window.push(20.0);
+    assert(near(window.ewma(), 15.0));
+    window.push(20.0);
+    assert(near(window.ewma(), 17.5));
+
+    // Flat series has no spread, so no z-score
+    RollingWindow flat(4);
+    for (int i = 0; i < 4; ++i) flat.push(5.0);
+    assert(flat.variance() == 0.0 && flat.z_score(6.0) == 0.0);
+
+    std::cout << "✓ EWMA test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running rolling window tests..." << std::endl;
+
+    test_window_contents();
+    test_against_brute_force();
+    test_ewma();
+
+    std::cout << "All rolling window tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include "../common/sampling_profiler.h"
+#include "../common/high_res_timer.h"
+#include "../common/static_config.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace hft;
+
+// Exported (the test links with ENABLE_EXPORTS) so dladdr can name it
+__attribute__((noinline)) uint64_t spin_for_profile(const std::atomic<bool>& done) {
+    uint64_t value = 1;
+    while (!done.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 1000; ++i) {
+            value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+    }
+    return value;
+}
+
+namespace {
+
+std::string profile_directory() {
+    return "/tmp/hft_test_profiles_" + std::to_string(getpid());
+}
+
+void load_profiler_config(int max_seconds) {
+    std::string path = "/tmp/hft_test_profiler_" + std::to_string(getpid()) + ".conf";
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "profiler.directory=" << profile_directory() << "\n";
+        out << "profiler.max_seconds=" << max_seconds << "\n";
+    }
+    [[maybe_unused]] bool ok = StaticConfig::load_from_file(path.c_str());
+    assert(ok);
+    std::remove(path.c_str());
+}
+
+void wait_inactive(SamplingProfiler& profiler) {
+    for (int i = 0; i < 1000 && profiler.active(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(!profiler.active());
+}
+
+} // namespace
+
+void test_parse_options() {
+    std::cout << "Testing profile option parsing..." << std::endl;
+
+    SamplingProfiler::Options options;
+    std::string error;
+    [[maybe_unused]] bool ok = SamplingProfiler::parse_options("", options, error);
+    assert(ok);
+    assert(options.seconds == 10 && options.hz == 999);
+
+    ok = SamplingProfiler::parse_options("seconds=3 hz=200", options, error);
+    assert(ok);
+    assert(options.seconds == 3 && options.hz == 200);
+    ok = SamplingProfiler::parse_options("hz=97&seconds=1", options, error);
+    assert(ok);
+    assert(options.seconds == 1 && options.hz == 97);
+
+    SamplingProfiler::Options rejected;
+    ok = SamplingProfiler::parse_options("seconds=0", rejected, error);
+    assert(!ok);
+    ok = SamplingProfiler::parse_options("hz=20000", rejected, error);
+    assert(!ok);
+    ok = SamplingProfiler::parse_options("hz=fast", rejected, error);
+    assert(!ok);
+    ok = SamplingProfiler::parse_options("depth=10", rejected, error);
+    assert(!ok);
+    ok = SamplingProfiler::parse_options("seconds", rejected, error);
+    assert(!ok);
+    assert(!error.empty());
+
+    std::cout << "✓ Option parsing test passed" << std::endl;
+}
+
+void test_window_writes_folded_stacks() {
+    std::cout << "Testing a profile window over a busy thread..." << std::endl;
+
+    load_profiler_config(1);
+    std::atomic<bool> done{false};
+    std::thread busy([&] { spin_for_profile(done); });
+
+    SamplingProfiler& profiler = SamplingProfiler::instance();
+    SamplingProfiler::Options options;
+    options.hz = 500;
+    options.seconds = 30;   // Capped to profiler.max_seconds
+    std::string error;
+    uint64_t started = HighResTimer::get_ticks();
+    [[maybe_unused]] bool ok = profiler.start("TestService", options, error);
+    assert(ok);
+    assert(profiler.active());
+
+    // Only one window at a time
+    ok = profiler.start("TestService", options, error);
+    assert(!ok);
+    assert(!error.empty());
+
+    wait_inactive(profiler);
+    uint64_t finished = HighResTimer::get_ticks();
+    done.store(true);
+    busy.join();
+
+    std::string base = profiler.last_output();
+    assert(base.rfind(profile_directory() + "/TestService-", 0) == 0);
+
+    std::ifstream folded(base + ".folded");
+    assert(folded.good());
+    uint64_t total = 0;
+    uint64_t busy_samples = 0;
+    std::string line;
+    while (std::getline(folded, line)) {
+        size_t space = line.rfind(' ');
+        assert(space != std::string::npos);
+        uint64_t count = std::stoull(line.substr(space + 1));
+        total += count;
+        if (line.find("spin_for_profile") != std::string::npos) busy_samples += count;
+    }
+    assert(total > 0);
+    assert(busy_samples > 0);
+
+    // Sample stamps come from the same clock as everything else
+    std::ifstream samples(base + ".samples");
+    ok = static_cast<bool>(std::getline(samples, line));
+    assert(ok && line[0] == '#');
+    ok = static_cast<bool>(std::getline(samples, line));
+    assert(ok);
+    std::istringstream fields(line);
+    uint64_t tsc = 0;
+    fields >> tsc;
+    assert(tsc >= started && tsc <= finished);
+
+    std::cout << "✓ Window test passed (" << total << " samples, " << busy_samples << " in the busy loop)" << std::endl;
+}
+
+void test_stop_closes_window_early() {
+    std::cout << "Testing stop() closes a window early..." << std::endl;
+
+    load_profiler_config(60);
+    SamplingProfiler& profiler = SamplingProfiler::instance();
+    SamplingProfiler::Options options;
+    options.seconds = 60;
+    std::string error;
+
+    auto begin = std::chrono::steady_clock::now();
+    [[maybe_unused]] bool ok = profiler.start("TestService", options, error);
+    assert(ok);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    profiler.stop();
+    assert(!profiler.active());
+    assert(std::chrono::steady_clock::now() - begin < std::chrono::seconds(5));
+    assert(std::filesystem::exists(profiler.last_output() + ".folded"));
+
+    std::filesystem::remove_all(profile_directory());
+    std::cout << "✓ Early stop test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Sampling Profiler Unit Tests" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    try {
+        HighResTimer::initialize();
+        test_parse_options();
+        test_window_writes_folded_stacks();
+        test_stop_closes_window_early();
+
+        std::cout << "\n✅ All sampling profiler tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
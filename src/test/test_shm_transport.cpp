@@ -0,0 +1,300 @@
+#include "../common/shm_transport.h"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace hft;
+
+static std::string test_endpoint(const char* name) {
+    return "shm://test_" + std::string(name) + "_" + std::to_string(::getpid());
+}
+
+// Mappings of the endpoint's segment in this process
+[[maybe_unused]] static int count_mappings(const std::string& endpoint) {
+    std::string name = "hft_" + endpoint.substr(6);
+    std::ifstream maps("/proc/self/maps");
+    int count = 0;
+    for (std::string line; std::getline(maps, line);) {
+        if (line.find(name) != std::string::npos) ++count;
+    }
+    return count;
+}
+
+static TransportConfig make_config(const std::string& endpoint, size_t ring_size, int timeout_ms = 1000) {
+    TransportConfig config(TransportType::SHARED_MEMORY, TransportPattern::PUBLISH_SUBSCRIBE, endpoint);
+    config.buffer_size = ring_size;
+    config.slow_consumer_timeout_ms = timeout_ms;
+    return config;
+}
+
+void test_roundtrip_and_wrap() {
+    std::cout << "Testing shm roundtrip across ring wrap..." << std::endl;
+
+    std::string endpoint = test_endpoint("wrap");
+    auto config = make_config(endpoint, 4096);
+
+    ShmPublisher producer;
+    ShmSubscriber consumer_a;
+    ShmSubscriber consumer_b;
+    [[maybe_unused]] bool ok = producer.initialize(config) && producer.bind(endpoint);
+    assert(ok);
+    ok = consumer_a.initialize(config) && consumer_a.connect(endpoint);
+    assert(ok);
+    ok = consumer_b.initialize(config) && consumer_b.connect(endpoint);
+    assert(ok);
+
+    // 100-byte messages do not divide the ring, so records hit the padding path
+    char out[100];
+    char in[256];
+    for (uint32_t i = 0; i < 500; ++i) {
+        std::memset(out, static_cast<int>(i & 0xFF), sizeof(out));
+        ok = producer.publish(out, sizeof(out));
+        assert(ok);
+
+        for (ShmSubscriber* consumer : {&consumer_a, &consumer_b}) {
+            size_t size = sizeof(in);
+            ok = consumer->receive(in, size, true);
+            assert(ok);
+            assert(size == sizeof(out));
+            assert(std::memcmp(in, out, size) == 0);
+        }
+    }
+
+    size_t size = sizeof(in);
+    ok = consumer_a.receive(in, size, true);
+    assert(!ok);
+    assert(consumer_a.get_messages_received() == 500);
+
+    consumer_a.close();
+    consumer_b.close();
+    producer.close();
+    ShmTransport::unlink_segment(endpoint);
+
+    std::cout << "✓ Shm roundtrip test passed" << std::endl;
+}
+
+void test_topic_filter() {
+    std::cout << "Testing shm topic filter..." << std::endl;
+
+    std::string endpoint = test_endpoint("topic");
+    auto config = make_config(endpoint, 4096);
+
+    ShmPublisher producer;
+    ShmSubscriber consumer;
+    [[maybe_unused]] bool ok = producer.initialize(config) && producer.bind(endpoint);
+    assert(ok);
+    ok = consumer.initialize(config) && consumer.connect(endpoint);
+    assert(ok);
+    ok = consumer.subscribe("AAPL");
+    assert(ok);
+
+    int value = 42;
+    int other = 7;
+    ok = producer.publish("MSFT", &other, sizeof(other));
+    assert(ok);
+    ok = producer.publish("AAPL", &value, sizeof(value));
+    assert(ok);
+
+    int received = 0;
+    size_t size = sizeof(received);
+    ok = consumer.receive(&received, size, true);
+    assert(ok);
+    assert(size == sizeof(int) && received == 42);
+
+    size = sizeof(received);
+    ok = consumer.receive(&received, size, true);
+    assert(!ok);
+
+    consumer.close();
+    producer.close();
+    ShmTransport::unlink_segment(endpoint);
+
+    std::cout << "✓ Shm topic filter test passed" << std::endl;
+}
+
+void test_slow_consumer_eviction() {
+    std::cout << "Testing shm slow consumer eviction..." << std::endl;
+
+    std::string endpoint = test_endpoint("slow");
+    auto config = make_config(endpoint, 4096, 0);  // Any stalled consumer counts as slow
+
+    ShmPublisher producer;
+    ShmSubscriber stalled;
+    [[maybe_unused]] bool ok = producer.initialize(config) && producer.bind(endpoint);
+    assert(ok);
+    ok = stalled.initialize(config) && stalled.connect(endpoint);
+    assert(ok);
+
+    // The stalled consumer never reads; the producer must evict it rather than stop
+    char out[200] = {};
+    for (int i = 0; i < 100; ++i) {
+        ok = producer.publish(out, sizeof(out));
+        assert(ok);
+    }
+    assert(producer.get_slow_consumer_evictions() == 1);
+
+    char in[256];
+    size_t size = sizeof(in);
+    ok = stalled.receive(in, size, true);
+    assert(!ok);
+    assert(stalled.was_evicted());
+    assert(!stalled.is_connected());
+
+    // Reconnecting takes a fresh slot and replaces the old mapping
+    ok = stalled.connect(endpoint);
+    assert(ok && stalled.is_connected());
+    assert(count_mappings(endpoint) == 2);      // The producer's and the consumer's
+    ok = producer.publish(out, sizeof(out));
+    assert(ok);
+    size = sizeof(in);
+    ok = stalled.receive(in, size, true);
+    assert(ok && size == sizeof(out));
+    assert(producer.get_consumer_info().size() == 1);
+
+    stalled.close();
+    producer.close();
+    ShmTransport::unlink_segment(endpoint);
+
+    std::cout << "✓ Shm slow consumer eviction test passed" << std::endl;
+}
+
+void test_concurrent_claims() {
+    std::cout << "Testing shm concurrent consumer claims..." << std::endl;
+
+    std::string endpoint = test_endpoint("claim");
+    auto config = make_config(endpoint, 4096);
+
+    ShmPublisher producer;
+    [[maybe_unused]] bool ok = producer.initialize(config) && producer.bind(endpoint);
+    assert(ok);
+
+    // Every child races for a slot at once, then holds it until told to go
+    constexpr int CHILDREN = 8;
+    int start_pipe[2];
+    int ready_pipe[2];
+    int done_pipe[2];
+    [[maybe_unused]] int piped = ::pipe(start_pipe) | ::pipe(ready_pipe) | ::pipe(done_pipe);
+    assert(piped == 0);
+
+    pid_t children[CHILDREN];
+    for (int i = 0; i < CHILDREN; ++i) {
+        children[i] = ::fork();
+        if (children[i] == 0) {
+            ::close(start_pipe[1]);
+            ::close(done_pipe[1]);
+            char go = 0;
+            (void)!::read(start_pipe[0], &go, 1);
+            ShmSubscriber consumer;
+            bool joined = consumer.initialize(config) && consumer.connect(endpoint);
+            char ready = joined ? 1 : 0;
+            (void)!::write(ready_pipe[1], &ready, 1);
+            (void)!::read(done_pipe[0], &go, 1);
+            _exit(joined ? 0 : 1);
+        }
+    }
+    ::close(start_pipe[0]);
+    ::close(done_pipe[0]);
+    ::close(start_pipe[1]);     // EOF releases every child at once
+
+    for (int i = 0; i < CHILDREN; ++i) {
+        char ready = 0;
+        [[maybe_unused]] ssize_t got = ::read(ready_pipe[0], &ready, 1);
+        assert(got == 1 && ready == 1);
+    }
+
+    // One live slot per child, each still naming its own claimant
+    auto info = producer.get_consumer_info();
+    assert(info.size() == CHILDREN);
+    for (int i = 0; i < CHILDREN; ++i) {
+        [[maybe_unused]] int owned = 0;
+        for (const auto& slot : info) {
+            if (slot.pid == children[i] && slot.state == shm::SLOT_ACTIVE) ++owned;
+        }
+        assert(owned == 1);
+    }
+
+    ::close(done_pipe[1]);
+    for (int i = 0; i < CHILDREN; ++i) {
+        int status = 0;
+        ::waitpid(children[i], &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    ::close(ready_pipe[0]);
+    ::close(ready_pipe[1]);
+    producer.close();
+    ShmTransport::unlink_segment(endpoint);
+
+    std::cout << "✓ Shm concurrent claim test passed" << std::endl;
+}
+
+void test_cross_process() {
+    std::cout << "Testing shm cross-process delivery..." << std::endl;
+
+    std::string endpoint = test_endpoint("fork");
+    auto config = make_config(endpoint, 64 * 1024);
+
+    ShmPublisher producer;
+    [[maybe_unused]] bool bound = producer.initialize(config) && producer.bind(endpoint);
+    assert(bound);
+
+    int ready_pipe[2];
+    [[maybe_unused]] int piped = ::pipe(ready_pipe);
+    assert(piped == 0);
+
+    constexpr uint64_t COUNT = 20000;
+    pid_t child = ::fork();
+    if (child == 0) {
+        ShmSubscriber consumer;
+        bool ok = consumer.initialize(config) && consumer.connect(endpoint);
+        char ready = ok ? 1 : 0;
+        (void)!::write(ready_pipe[1], &ready, 1);
+        if (!ok) _exit(2);
+
+        // Blocking receive; sequence must arrive complete and in order
+        for (uint64_t expected = 0; expected < COUNT; ++expected) {
+            uint64_t value = 0;
+            size_t size = sizeof(value);
+            if (!consumer.receive(&value, size, false) || value != expected) _exit(1);
+        }
+        _exit(0);
+    }
+
+    char ready = 0;
+    [[maybe_unused]] ssize_t got = ::read(ready_pipe[0], &ready, 1);
+    assert(got == 1 && ready == 1);
+
+    for (uint64_t i = 0; i < COUNT; ++i) {
+        while (!producer.publish(&i, sizeof(i))) {
+        }
+    }
+
+    int status = 0;
+    [[maybe_unused]] pid_t reaped = ::waitpid(child, &status, 0);
+    assert(reaped == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(producer.get_slow_consumer_evictions() == 0);
+
+    ::close(ready_pipe[0]);
+    ::close(ready_pipe[1]);
+    producer.close();
+    ShmTransport::unlink_segment(endpoint);
+
+    std::cout << "✓ Shm cross-process test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running shared-memory transport tests..." << std::endl;
+
+    test_roundtrip_and_wrap();
+    test_topic_filter();
+    test_slow_consumer_eviction();
+    test_concurrent_claims();
+    test_cross_process();
+
+    std::cout << "All shared-memory transport tests passed!" << std::endl;
+    return 0;
+}
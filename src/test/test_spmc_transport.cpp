@@ -0,0 +1,244 @@
+#include "../common/spmc_transport.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+using namespace hft;
+
+using Ring = SPMCTransport<1024 * 1024>;
+
+static std::unique_ptr<Ring> make_producer(SlowConsumerPolicy policy) {
+    TransportConfig config(TransportType::SPMC_RING, TransportPattern::PUBLISH_SUBSCRIBE, "bind:inproc://test");
+    config.slow_consumer_policy = policy;
+    auto ring = std::make_unique<Ring>();
+    [[maybe_unused]] bool ok = ring->initialize(config);
+    assert(ok);
+    return ring;
+}
+
+static void publish_sequence(Ring& ring, uint64_t first, uint64_t count, size_t payload_size = 1000) {
+    char payload[4096] = {};
+    for (uint64_t i = first; i < first + count; ++i) {
+        std::memcpy(payload, &i, sizeof(i));
+        [[maybe_unused]] bool ok = ring.send(payload, payload_size, true);
+        assert(ok);
+    }
+}
+
+void test_batch_drain() {
+    std::cout << "Testing SPMC batched drain..." << std::endl;
+
+    auto ring = make_producer(SlowConsumerPolicy::BLOCK);
+    uint32_t consumer = ring->register_consumer();
+    assert(consumer != UINT32_MAX);
+
+    publish_sequence(*ring, 0, 100, 64);
+
+    MessageSpan spans[64];
+    size_t count = ring->read_batch(consumer, spans, 64);
+    assert(count == 64);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = 0;
+        std::memcpy(&value, spans[i].data, sizeof(value));
+        assert(value == i && spans[i].size == 64);
+    }
+
+    // Nothing moves until the batch is released
+    [[maybe_unused]] size_t batch = ring->read_batch(consumer, spans, 64);
+    assert(batch == 64);
+    [[maybe_unused]] bool ok = ring->release_batch(consumer);
+    assert(ok);
+    batch = ring->read_batch(consumer, spans, 64);
+    assert(batch == 36);
+    assert(spans[0].sequence == 64);
+    ok = ring->release_batch(consumer);
+    assert(ok);
+    batch = ring->read_batch(consumer, spans, 64);
+    assert(batch == 0);
+    assert(ring->get_messages_received() == 100);
+
+    std::cout << "✓ SPMC batched drain test passed" << std::endl;
+}
+
+void test_block_on_slowest() {
+    std::cout << "Testing SPMC block-on-slowest policy..." << std::endl;
+
+    auto ring = make_producer(SlowConsumerPolicy::BLOCK);
+    uint32_t fast = ring->register_consumer();
+    uint32_t slow = ring->register_consumer();
+
+    char payload[1000] = {};
+    size_t sent = 0;
+    while (ring->send(payload, sizeof(payload), true)) {
+        ++sent;
+    }
+    assert(sent > 0);
+
+    // Draining only the fast consumer frees nothing
+    MessageSpan spans[256];
+    [[maybe_unused]] bool ok = false;
+    while (ring->read_batch(fast, spans, 256) > 0) {
+        ok = ring->release_batch(fast);
+        assert(ok);
+    }
+    ok = ring->send(payload, sizeof(payload), true);
+    assert(!ok);
+
+    // Once the slowest consumer catches up the producer can continue
+    while (ring->read_batch(slow, spans, 256) > 0) {
+        ok = ring->release_batch(slow);
+        assert(ok);
+    }
+    ok = ring->send(payload, sizeof(payload), true);
+    assert(ok);
+    assert(ring->get_lapped_messages(slow) == 0);
+
+    std::cout << "✓ SPMC block-on-slowest test passed" << std::endl;
+}
+
+void test_overwrite_lap_detection() {
+    std::cout << "Testing SPMC overwrite lap detection..." << std::endl;
+
+    auto ring = make_producer(SlowConsumerPolicy::OVERWRITE);
+    uint32_t laggard = ring->register_consumer();
+
+    MessageSpan span;
+    publish_sequence(*ring, 0, 1);
+    [[maybe_unused]] size_t batch = ring->read_batch(laggard, &span, 1);
+    assert(batch == 1);
+    [[maybe_unused]] bool ok = ring->release_batch(laggard);
+    assert(ok);
+
+    // Producer never waits: 3000 x ~1KB laps the 1MB ring several times
+    publish_sequence(*ring, 1, 3000);
+
+    // The laggard resyncs to the head, then counts exactly what it missed
+    batch = ring->read_batch(laggard, &span, 1);
+    assert(batch == 0);
+    assert(ring->get_lap_events(laggard) == 1);
+    publish_sequence(*ring, 3001, 1);
+    batch = ring->read_batch(laggard, &span, 1);
+    assert(batch == 1);
+    assert(span.sequence == 3001);
+    assert(ring->get_lapped_messages(laggard) == 3000);
+
+    uint64_t value = 0;
+    std::memcpy(&value, span.data, sizeof(value));
+    assert(value == 3001);
+    ok = ring->release_batch(laggard);
+    assert(ok);
+
+    // A batch the producer overwrites while it is held fails validation
+    MessageSpan spans[8];
+    publish_sequence(*ring, 3002, 8);
+    batch = ring->read_batch(laggard, spans, 8);
+    assert(batch == 8);
+    publish_sequence(*ring, 3010, 2000);
+    ok = ring->release_batch(laggard);
+    assert(!ok);
+    assert(ring->get_lap_events(laggard) == 2);
+
+    std::cout << "✓ SPMC overwrite lap detection test passed" << std::endl;
+}
+
+void test_topic_routing() {
+    std::cout << "Testing SPMC topic routing..." << std::endl;
+
+    auto ring = make_producer(SlowConsumerPolicy::OVERWRITE);
+    uint32_t all = ring->register_consumer();
+    uint32_t filtered = ring->register_consumer();
+
+    topic_id_t aapl = SymbolTable::instance().intern("AAPL");
+    topic_id_t msft = SymbolTable::instance().intern("MSFT");
+    topic_id_t goog = SymbolTable::instance().intern("GOOG");
+    [[maybe_unused]] bool ok = ring->subscribe_topic(filtered, aapl);
+    assert(ok);
+    ok = ring->subscribe_topic(filtered, goog);
+    assert(ok);
+
+    topic_id_t topics[] = {aapl, msft, goog, msft, NO_TOPIC, aapl};
+    for (uint64_t i = 0; i < 6; ++i) {
+        ok = ring->send_topic(topics[i], &i, sizeof(i), true);
+        assert(ok);
+    }
+
+    MessageSpan spans[8];
+    [[maybe_unused]] size_t batch = ring->read_batch(all, spans, 8);
+    assert(batch == 6);
+    ok = ring->release_batch(all);
+    assert(ok);
+
+    // Only AAPL/GOOG records come back; payloads are the original bytes
+    size_t count = ring->read_batch(filtered, spans, 8);
+    assert(count == 3);
+    uint64_t expected_values[] = {0, 2, 5};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = 0;
+        std::memcpy(&value, spans[i].data, sizeof(value));
+        assert(value == expected_values[i]);
+        assert(spans[i].topic_id == topics[value]);
+    }
+    ok = ring->release_batch(filtered);
+    assert(ok);
+
+    // Skipped records are not mistaken for lapped ones
+    for (uint64_t i = 0; i < 4; ++i) {
+        ok = ring->send_topic(msft, &i, sizeof(i), true);
+        assert(ok);
+    }
+    batch = ring->read_batch(filtered, spans, 8);
+    assert(batch == 0);
+    ok = ring->send_topic(aapl, &count, sizeof(count), true);
+    assert(ok);
+    batch = ring->read_batch(filtered, spans, 8);
+    assert(batch == 1);
+    ok = ring->release_batch(filtered);
+    assert(ok);
+    assert(ring->get_lapped_messages(filtered) == 0);
+
+    std::cout << "✓ SPMC topic routing test passed" << std::endl;
+}
+
+void test_subscriber_topic_filter() {
+    std::cout << "Testing SPMC subscriber topic filter..." << std::endl;
+
+    TransportConfig config(TransportType::SPMC_RING, TransportPattern::PUSH_PULL, "inproc://topics");
+    auto ring = std::make_unique<SPMCSubscriber<1024 * 1024>>();
+    [[maybe_unused]] bool ok = ring->initialize(config);
+    assert(ok);
+    ok = ring->subscribe("AAPL");
+    assert(ok);
+
+    int aapl = 1;
+    int msft = 2;
+    ok = ring->send_topic(SymbolTable::instance().intern("MSFT"), &msft, sizeof(msft), true);
+    assert(ok);
+    ok = ring->send_topic(SymbolTable::instance().intern("AAPL"), &aapl, sizeof(aapl), true);
+    assert(ok);
+
+    int received = 0;
+    size_t size = sizeof(received);
+    ok = ring->receive(&received, size, true);
+    assert(ok);
+    assert(size == sizeof(int) && received == 1);
+
+    size = sizeof(received);
+    ok = ring->receive(&received, size, true);
+    assert(!ok);
+
+    std::cout << "✓ SPMC subscriber topic filter test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running SPMC transport tests..." << std::endl;
+
+    test_batch_drain();
+    test_block_on_slowest();
+    test_overwrite_lap_detection();
+    test_topic_routing();
+    test_subscriber_topic_filter();
+
+    std::cout << "All SPMC transport tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "../common/startup_timeline.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+using namespace hft;
+
+static const StartupPhase* find_phase(const std::vector<StartupPhase>& phases, const std::string& name) {
+    for (const auto& phase : phases) {
+        if (phase.name == name) return &phase;
+    }
+    return nullptr;
+}
+
+void test_sequential_phases() {
+    std::cout << "Testing sequential phases..." << std::endl;
+
+    StartupTimeline& startup = StartupTimeline::instance();
+    assert(startup.run("config", [] { return true; }));
+    assert(!startup.run("broken", [] { return false; }));
+    // An exception fails the phase instead of escaping
+    assert(!startup.run("throws", []() -> bool { throw std::runtime_error("no file"); }));
+
+    auto phases = startup.phases();
+    const StartupPhase* config = find_phase(phases, "config");
+    assert(config && config->ok && config->group == 0);
+    assert(!find_phase(phases, "broken")->ok);
+    assert(!find_phase(phases, "throws")->ok);
+
+    std::cout << "✓ Sequential phase test passed" << std::endl;
+}
+
+void test_parallel_steps() {
+    std::cout << "Testing parallel steps..." << std::endl;
+
+    StartupTimeline& startup = StartupTimeline::instance();
+    const auto step_time = std::chrono::milliseconds(60);
+    auto slow = [step_time] { std::this_thread::sleep_for(step_time); return true; };
+
+    // Three 60ms steps side by side take about 60ms, not 180ms
+    int64_t start = startup.now_ns();
+    assert(startup.run_parallel({{"broker", slow}, {"transports", slow}, {"journal", slow}}));
+    int64_t elapsed = startup.now_ns() - start;
+    assert(elapsed >= 60000000 && elapsed < 150000000);
+
+    auto phases = startup.phases();
+    const StartupPhase* broker = find_phase(phases, "broker");
+    const StartupPhase* journal = find_phase(phases, "journal");
+    assert(broker && journal && broker->group != 0 && broker->group == journal->group);
+    assert(broker->duration_ns >= 60000000 && journal->duration_ns >= 60000000);
+
+    // One failure fails the group; the others still run to the end
+    bool other_ran = false;
+    assert(!startup.run_parallel({{"fails", [] { return false; }},
+                                  {"runs", [&other_ran] { other_ran = true; return true; }}}));
+    assert(other_ran);
+    phases = startup.phases();
+    assert(find_phase(phases, "fails")->group != broker->group);
+    assert(startup.run_parallel({}));
+
+    std::cout << "✓ Parallel step test passed" << std::endl;
+}
+
+void test_ready() {
+    std::cout << "Testing the ready mark..." << std::endl;
+
+    StartupTimeline& startup = StartupTimeline::instance();
+    assert(!startup.is_ready() && startup.ready_ns() == -1);
+    assert(startup.describe().find("not ready") != std::string::npos);
+
+    int64_t start = startup.now_ns();
+    startup.record("warmup", start, start + 5000000);
+    startup.ready("Test Service");
+    int64_t ready = startup.ready_ns();
+    assert(startup.is_ready() && ready >= start);
+    // Only the first call counts
+    startup.ready("Test Service");
+    assert(startup.ready_ns() == ready);
+
+    std::string timeline = startup.describe();
+    assert(timeline.find("trading-ready in") != std::string::npos);
+    assert(timeline.find("| broker") != std::string::npos);
+    assert(timeline.find("broken (failed)") != std::string::npos);
+    assert(find_phase(startup.phases(), "warmup")->duration_ns == 5000000);
+
+    std::cout << "✓ Ready test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Startup Timeline Unit Tests" << std::endl;
+    std::cout << "===================================" << std::endl;
+
+    try {
+        test_sequential_phases();
+        test_parallel_steps();
+        test_ready();
+
+        std::cout << "\n✅ All startup timeline tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
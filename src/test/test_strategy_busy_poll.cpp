@@ -0,0 +1,223 @@
+#include "../strategy_engine/strategy_engine.h"
+#include "../common/static_config.h"
+#include "../common/zmq_transport.h"
+#include <sched.h>
+#include <sys/mman.h>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+constexpr uint64_t RECORDER_ID = 4343;
+constexpr uint32_t TICKS = 2000;
+constexpr uint64_t EXECUTIONS = 50;
+
+int g_busy_poll_cpu = 0;
+
+// What the processing thread saw, and where it ran
+struct Journal {
+    std::mutex mutex;
+    std::vector<uint32_t> ticks;
+    std::vector<uint64_t> executions;
+    std::thread::id thread;
+    bool off_cpu = false;
+
+    size_t tick_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ticks.size();
+    }
+    size_t execution_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return executions.size();
+    }
+};
+
+class RecordingStrategy final : public Strategy {
+public:
+    explicit RecordingStrategy(Journal& journal) : journal_(journal) {}
+
+    void on_market_data(const MarketData& data) override {
+        std::lock_guard<std::mutex> lock(journal_.mutex);
+        journal_.ticks.push_back(data.last_size);
+        note_thread();
+    }
+    void on_execution(const OrderExecution& execution) override {
+        std::lock_guard<std::mutex> lock(journal_.mutex);
+        journal_.executions.push_back(execution.order_id);
+        note_thread();
+    }
+    std::string get_name() const override { return "RecordingStrategy"; }
+    uint64_t get_id() const override { return RECORDER_ID; }
+
+private:
+    Journal& journal_;
+
+    // Caller holds the journal's mutex
+    void note_thread() {
+        journal_.thread = std::this_thread::get_id();
+        if (sched_getcpu() != g_busy_poll_cpu) journal_.off_cpu = true;
+    }
+};
+
+template<typename Predicate>
+bool wait_until(Predicate predicate, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+OrderExecution make_execution(uint64_t order_id) {
+    OrderExecution execution{};
+    execution.header = MessageFactory::create_header(MessageType::ORDER_EXECUTION,
+                                                     sizeof(OrderExecution) - sizeof(MessageHeader));
+    execution.order_id = order_id;
+    execution.exec_type = ExecutionType::FILL;
+    execution.fill_quantity = 1;
+    return execution;
+}
+
+} // namespace
+
+void test_busy_poll_delivery() {
+    std::cout << "Testing the busy-poll receive loop..." << std::endl;
+
+    Journal journal;
+    StrategyEngine engine;
+    [[maybe_unused]] bool ok = engine.initialize();
+    assert(ok);
+    assert(engine.get_shard_count() == 0);
+    engine.add_strategy(std::make_unique<RecordingStrategy>(journal));
+    engine.start();
+
+    // Same process context and inproc endpoints as the engine's subscriptions
+    auto market_data = TransportFactory::open_publisher(
+        zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
+    auto executions = TransportFactory::open_publisher(
+        zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_executions_endpoint())));
+
+    // PUB/SUB drops everything sent before the subscription lands; probes
+    // carry sequence 0 and execution ID 0
+    MarketData probe = MessageFactory::create_market_data("BUSY", 10.0, 10.01, 100, 100, 10.0, 0);
+    OrderExecution execution_probe = make_execution(0);
+    ok = wait_until([&] {
+        market_data->publish(&probe, sizeof(probe));
+        executions->publish(&execution_probe, sizeof(execution_probe));
+        return journal.tick_count() > 0 && journal.execution_count() > 0;
+    }, std::chrono::seconds(5));
+    assert(ok);
+
+    // Both sockets are drained on every pass, so neither starves the other
+    for (uint32_t sequence = 1; sequence <= TICKS; ++sequence) {
+        MarketData data = MessageFactory::create_market_data("BUSY", 10.0, 10.01, 100, 100, 10.0, sequence);
+        market_data->publish(&data, sizeof(data));
+        if (sequence % (TICKS / EXECUTIONS) == 0) {
+            OrderExecution execution = make_execution(sequence / (TICKS / EXECUTIONS));
+            executions->publish(&execution, sizeof(execution));
+        }
+    }
+    ok = wait_until([&] {
+        std::lock_guard<std::mutex> lock(journal.mutex);
+        return !journal.ticks.empty() && journal.ticks.back() == TICKS &&
+               !journal.executions.empty() && journal.executions.back() == EXECUTIONS;
+    }, std::chrono::seconds(10));
+    assert(ok);
+
+    {
+        // In order, on the pinned processing thread
+        std::lock_guard<std::mutex> lock(journal.mutex);
+        std::vector<uint32_t> ticks;
+        for (uint32_t tick : journal.ticks) {
+            if (tick != 0) ticks.push_back(tick);
+        }
+        assert(ticks.size() == TICKS);
+        for (uint32_t i = 0; i < TICKS; ++i) {
+            assert(ticks[i] == i + 1);
+        }
+        std::vector<uint64_t> order_ids;
+        for (uint64_t order_id : journal.executions) {
+            if (order_id != 0) order_ids.push_back(order_id);
+        }
+        assert(order_ids.size() == EXECUTIONS);
+        for (uint64_t i = 0; i < EXECUTIONS; ++i) {
+            assert(order_ids[i] == i + 1);
+        }
+        assert(journal.thread != std::this_thread::get_id());
+        assert(!journal.off_cpu);
+    }
+
+    // Nothing left to receive: the loop is spinning when stop() comes
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto stopped = std::async(std::launch::async, [&engine] { engine.stop(); });
+    ok = stopped.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    assert(ok);
+    assert(!engine.is_running());
+
+    // Stopped means stopped: later messages reach no strategy
+    [[maybe_unused]] size_t ticks_seen = journal.tick_count();
+    for (int i = 0; i < 10; ++i) {
+        market_data->publish(&probe, sizeof(probe));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(journal.tick_count() == ticks_seen);
+
+    std::cout << "✓ Busy-poll test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Strategy Busy-Poll Unit Tests" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    // Pin to the last CPU this process may use, so sched_getcpu() proves the pin
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) g_busy_poll_cpu = cpu;
+    }
+
+    std::string path = "/tmp/hft_test_busy_poll_" + std::to_string(getpid()) + ".conf";
+    std::string kill_switch_name = "hft_test_busy_poll_" + std::to_string(getpid());
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "strategy.busy_poll=true\n";
+        out << "strategy.busy_poll_cpu=" << g_busy_poll_cpu << "\n";
+        out << "strategy.worker_threads=0\n";
+        out << "warmup.enabled=false\n";
+        out << "capture.enabled=false\n";
+        out << "zmq.endpoint_scheme=inproc\n";
+        out << "zmq.send_hwm=100000\n";
+        out << "zmq.recv_hwm=100000\n";
+        out << "kill_switch.name=" << kill_switch_name << "\n";
+    }
+
+    try {
+        [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+        assert(loaded);
+
+        test_busy_poll_delivery();
+
+        std::remove(path.c_str());
+        ::shm_unlink(("/" + kill_switch_name).c_str());
+        std::cout << "\n✅ All strategy busy-poll tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::remove(path.c_str());
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
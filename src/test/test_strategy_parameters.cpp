@@ -0,0 +1,246 @@
+#include "../strategy_engine/enhanced_strategies.h"
+#include "../strategy_engine/strategy_parameters.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace hft;
+
+namespace {
+
+// Implements only the lifecycle; the tuning hooks keep their defaults
+class FixedStrategy final : public OrderBookStrategy {
+public:
+    FixedStrategy() : OrderBookStrategy(2003, "FixedStrategy") {}
+    bool initialize() override { return true; }
+    void on_market_data(const MarketData&) override {}
+    void on_order_book_update(const OrderBookUpdate&) override {}
+    void on_execution(const OrderExecution&) override {}
+};
+
+} // namespace
+
+void test_parse_assignments() {
+    std::cout << "Testing parameter assignment parsing..." << std::endl;
+
+    ParameterAssignments assignments;
+    std::string error;
+    [[maybe_unused]] bool ok =
+        parse_parameter_assignments("id=7 spread_threshold=0.002,max_inventory=800&flag=true", assignments, error);
+    assert(ok);
+    assert(assignments.size() == 4);
+    assert(assignments[1].key == "spread_threshold" && assignments[1].value == "0.002");
+
+    std::string value;
+    ok = take_assignment(assignments, "id", value);
+    assert(ok && value == "7");
+    ok = take_assignment(assignments, "id", value);
+    assert(assignments.size() == 3 && !ok);
+
+    double number;
+    ok = parse_parameter_value("0.002", number);
+    assert(ok && number == 0.002);
+    ok = parse_parameter_value("true", number);
+    assert(ok && number == 1.0);
+    ok = parse_parameter_value("12abc", number);
+    assert(!ok);
+    ok = parse_parameter_value("nan", number);
+    assert(!ok);
+
+    ok = parse_parameter_assignments("", assignments, error);
+    assert(ok && assignments.empty());
+    ok = parse_parameter_assignments("spread_threshold", assignments, error);
+    assert(!ok);
+    ok = parse_parameter_assignments("=1", assignments, error);
+    assert(!ok);
+    ok = parse_parameter_assignments("max_inventory=", assignments, error);
+    assert(!ok);
+
+    std::cout << "✓ Parsing test passed" << std::endl;
+}
+
+void test_slot_latest_value() {
+    std::cout << "Testing parameter slot hands over the newest set..." << std::endl;
+
+    ParameterSlot<int> slot(1);
+    int value = 0;
+    [[maybe_unused]] bool ok = slot.take(value);
+    assert(!ok && value == 0);
+
+    slot.publish(2);
+    slot.publish(3);
+    ok = slot.take(value);
+    assert(ok && value == 3);    // 2 was superseded before the reader looked
+    ok = slot.take(value);
+    assert(!ok && value == 3);
+
+    slot.publish(4);
+    ok = slot.take(value);
+    assert(ok && value == 4);
+    assert(slot.published() == 3);
+
+    std::cout << "✓ Latest value test passed" << std::endl;
+}
+
+void test_slot_concurrent() {
+    std::cout << "Testing parameter slot across threads..." << std::endl;
+
+    // A torn or stale buffer would break the pairing or the ordering
+    struct Pair {
+        uint64_t a;
+        uint64_t b;
+    };
+    ParameterSlot<Pair> slot(Pair{0, 0});
+    std::atomic<bool> done{false};
+    uint64_t taken = 0;
+
+    std::thread reader([&] {
+        Pair seen{0, 0};
+        uint64_t last = 0;
+        for (;;) {
+            bool finished = done.load(std::memory_order_acquire);
+            if (slot.take(seen)) {
+                assert(seen.b == seen.a * 2);
+                assert(seen.a > last);
+                last = seen.a;
+                ++taken;
+            } else if (finished) {
+                break;
+            }
+        }
+        assert(last == 200000);
+    });
+
+    for (uint64_t i = 1; i <= 200000; ++i) {
+        slot.publish(Pair{i, i * 2});
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    assert(taken > 0);
+
+    std::cout << "✓ Concurrent slot test passed" << std::endl;
+}
+
+void test_staged_parameters() {
+    std::cout << "Testing staged strategy parameters..." << std::endl;
+
+    MarketMakingStrategy strategy(2001);
+    ParameterAssignments assignments;
+    std::string error;
+
+    // Nothing changes until the strategy thread applies it
+    [[maybe_unused]] bool ok = parse_parameter_assignments("spread_threshold=0.002 max_quote_size=800", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(ok);
+    assert(strategy.get_parameters().spread_threshold == 0.001);
+    ok = strategy.apply_staged_parameters();
+    assert(ok);
+    assert(strategy.get_parameters().spread_threshold == 0.002);
+    assert(strategy.get_parameters().max_quote_size == 800);
+    ok = strategy.apply_staged_parameters();
+    assert(!ok);
+
+    // Updates build on the last staged set
+    ok = parse_parameter_assignments("microprice_fair_value=true", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(ok);
+    ok = strategy.apply_staged_parameters();
+    assert(ok);
+    assert(strategy.get_parameters().microprice_fair_value);
+    assert(strategy.get_parameters().max_quote_size == 800);
+
+    // Rejected sets are never published
+    ok = parse_parameter_assignments("min_quote_size=900", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(!ok);
+    ok = parse_parameter_assignments("no_such_parameter=1", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(!ok);
+    ok = parse_parameter_assignments("quote_size_ratio=abc", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(!ok);
+    ok = strategy.apply_staged_parameters();
+    assert(!ok);
+    assert(strategy.get_parameters().min_quote_size == 100);
+
+    // set_parameters() resets the base later updates start from
+    MarketMakingStrategy::Parameters params;
+    params.max_inventory = 50.0;
+    strategy.set_parameters(params);
+    ok = parse_parameter_assignments("inventory_skew_factor=0.25", assignments, error);
+    assert(ok);
+    ok = strategy.stage_parameters(assignments, error);
+    assert(ok);
+    ok = strategy.apply_staged_parameters();
+    assert(ok);
+    assert(strategy.get_parameters().max_inventory == 50.0);
+    assert(strategy.get_parameters().max_quote_size == 500);
+
+    // Window sizes are fixed once a strategy keeps per-symbol history
+    StatArbStrategy stat_arb(2002);
+    ok = parse_parameter_assignments("lookback_periods=40", assignments, error);
+    assert(ok);
+    ok = stat_arb.stage_parameters(assignments, error);
+    assert(!ok);
+    ok = parse_parameter_assignments("imbalance_levels=5 signal_size=300", assignments, error);
+    assert(ok);
+    ok = stat_arb.stage_parameters(assignments, error);
+    assert(ok);
+    ok = stat_arb.apply_staged_parameters();
+    assert(ok);
+    assert(stat_arb.get_parameters().imbalance_levels == 5 && stat_arb.get_parameters().signal_size == 300);
+
+    // A strategy without runtime parameters refuses every update
+    FixedStrategy fixed;
+    error.clear();
+    ok = fixed.stage_parameters(assignments, error);
+    assert(!ok && !error.empty());
+    ok = fixed.apply_staged_parameters();
+    assert(!ok);
+
+    std::cout << "✓ Staged parameters test passed" << std::endl;
+}
+
+void test_strategy_type_names() {
+    std::cout << "Testing strategy type names..." << std::endl;
+
+    [[maybe_unused]] bool ok = false;
+    for (StrategyType type : {StrategyType::MARKET_MAKING, StrategyType::STAT_ARB, StrategyType::ENHANCED_MOMENTUM}) {
+        StrategyType parsed;
+        ok = StrategyFactory::strategy_type_from_string(StrategyFactory::strategy_type_to_string(type), parsed);
+        assert(ok);
+        assert(parsed == type);
+    }
+    StrategyType parsed;
+    ok = StrategyFactory::strategy_type_from_string("Unknown", parsed);
+    assert(!ok);
+
+    std::cout << "✓ Type name test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Strategy Parameter Unit Tests" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    try {
+        test_parse_assignments();
+        test_slot_latest_value();
+        test_slot_concurrent();
+        test_staged_parameters();
+        test_strategy_type_names();
+
+        std::cout << "\n✅ All strategy parameter tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
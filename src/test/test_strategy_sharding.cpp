@@ -0,0 +1,212 @@
+#include "../strategy_engine/strategy_engine.h"
+#include "../common/static_config.h"
+#include "../common/spsc_channel.h"
+#include "../common/zmq_transport.h"
+#include <sys/mman.h>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace hft;
+
+namespace {
+
+constexpr uint64_t RECORDER_ID = 4242;
+constexpr int SYMBOLS = 8;
+constexpr uint32_t TICKS_PER_SYMBOL = 200;
+
+struct Tick {
+    symbol_id_t symbol_id;
+    uint32_t sequence;
+    std::thread::id thread;
+};
+
+// Shared by every shard's instance, which the engine itself never does;
+// only here so the test can see who handled what
+struct Journal {
+    std::mutex mutex;
+    std::vector<Tick> ticks;
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ticks.size();
+    }
+};
+
+// Records each tick and echoes it back as a signal carrying the sequence
+class RecordingStrategy final : public Strategy {
+public:
+    explicit RecordingStrategy(Journal& journal) : journal_(journal) {}
+
+    void on_market_data(const MarketData& data) override {
+        {
+            std::lock_guard<std::mutex> lock(journal_.mutex);
+            journal_.ticks.push_back({data.symbol_id, data.last_size, std::this_thread::get_id()});
+        }
+        publish_signal(MessageFactory::create_trading_signal(
+            data.symbol_id, SignalAction::BUY, OrderType::LIMIT, 1.0, data.last_size, RECORDER_ID));
+    }
+    void on_execution(const OrderExecution&) override {}
+    std::string get_name() const override { return "RecordingStrategy"; }
+    uint64_t get_id() const override { return RECORDER_ID; }
+
+private:
+    Journal& journal_;
+};
+
+std::string symbol_name(int index) {
+    return "SHRD" + std::to_string(index);
+}
+
+template<typename Predicate>
+bool wait_until(Predicate predicate, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+void test_sharded_ordering() {
+    std::cout << "Testing symbol-sharded strategy workers..." << std::endl;
+
+    auto channel = std::make_unique<SignalChannel>();
+    Journal journal;
+    StrategyEngine engine;
+    engine.set_signal_channel(channel.get());
+    [[maybe_unused]] bool ok = engine.initialize();
+    assert(ok);
+    assert(engine.get_shard_count() == 2);
+    engine.add_strategy_factory([&journal] { return std::make_unique<RecordingStrategy>(journal); });
+    engine.start();
+
+    // Same process context and inproc endpoints as the engine's subscription
+    auto publisher = TransportFactory::open_publisher(
+        zmq_publisher_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
+
+    // PUB/SUB drops everything sent before the subscription lands
+    MarketData probe = MessageFactory::create_market_data("PROBE", 10.0, 10.01, 100, 100, 10.0, 0);
+    ok = wait_until([&] {
+        publisher->publish(&probe, sizeof(probe));
+        return journal.size() > 0;
+    }, std::chrono::seconds(5));
+    assert(ok);
+
+    // Interleaved across symbols; each symbol's ticks are numbered 1..N
+    for (uint32_t sequence = 1; sequence <= TICKS_PER_SYMBOL; ++sequence) {
+        for (int i = 0; i < SYMBOLS; ++i) {
+            MarketData data = MessageFactory::create_market_data(
+                symbol_name(i), 10.0 + i, 10.01 + i, 100, 100, 10.0 + i, sequence);
+            publisher->publish(&data, sizeof(data));
+        }
+    }
+
+    std::map<symbol_id_t, std::vector<uint32_t>> signals;
+    size_t signal_count = 0;
+    symbol_id_t probe_id = probe.symbol_id;
+    ok = wait_until([&] {
+        channel->drain([&](const TradingSignal& signal) {
+            if (signal.strategy_id != RECORDER_ID || signal.symbol_id == probe_id) return;
+            signals[signal.symbol_id].push_back(signal.quantity);
+            signal_count++;
+        });
+        return signal_count == SYMBOLS * TICKS_PER_SYMBOL;
+    }, std::chrono::seconds(10));
+    assert(ok);
+    engine.stop();
+
+    // Every symbol stays on one worker, in arrival order; both workers are used
+    std::map<symbol_id_t, std::vector<uint32_t>> sequences;
+    std::map<symbol_id_t, std::set<std::thread::id>> threads;
+    std::set<std::thread::id> workers;
+    for (const Tick& tick : journal.ticks) {
+        assert(tick.thread != std::this_thread::get_id());
+        if (tick.symbol_id == probe_id) continue;
+        sequences[tick.symbol_id].push_back(tick.sequence);
+        threads[tick.symbol_id].insert(tick.thread);
+        workers.insert(tick.thread);
+    }
+    assert(sequences.size() == SYMBOLS);
+    assert(workers.size() == 2);
+    for ([[maybe_unused]] const auto& [symbol_id, seen] : sequences) {
+        assert(threads[symbol_id].size() == 1);
+        assert(seen.size() == TICKS_PER_SYMBOL);
+        for (uint32_t i = 0; i < TICKS_PER_SYMBOL; ++i) {
+            assert(seen[i] == i + 1);
+        }
+    }
+
+    // Merged through the one publisher without reordering any symbol
+    assert(signals.size() == SYMBOLS);
+    for ([[maybe_unused]] const auto& [symbol_id, quantities] : signals) {
+        assert(quantities == sequences[symbol_id]);
+    }
+
+    std::cout << "✓ Sharded worker test passed" << std::endl;
+}
+
+void test_add_strategy_needs_factory() {
+    std::cout << "Testing add_strategy on a sharded engine..." << std::endl;
+
+    // One instance cannot be split across shards, so it is refused
+    Journal journal;
+    StrategyEngine engine;
+    [[maybe_unused]] bool ok = engine.initialize();
+    assert(ok);
+    assert(engine.get_shard_count() == 2);
+    engine.add_strategy(std::make_unique<RecordingStrategy>(journal));
+    std::string error;
+    ok = engine.update_strategy_parameters("id=" + std::to_string(RECORDER_ID) + " x=1", error);
+    assert(!ok && error == "no strategy " + std::to_string(RECORDER_ID));
+
+    std::cout << "✓ add_strategy refusal test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Strategy Sharding Unit Tests" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    std::string path = "/tmp/hft_test_sharding_" + std::to_string(getpid()) + ".conf";
+    std::string kill_switch_name = "hft_test_sharding_" + std::to_string(getpid());
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "strategy.worker_threads=2\n";
+        out << "strategy.worker_first_cpu=0\n";
+        out << "warmup.enabled=false\n";
+        out << "capture.enabled=false\n";
+        out << "zmq.endpoint_scheme=inproc\n";
+        out << "zmq.send_hwm=100000\n";
+        out << "zmq.recv_hwm=100000\n";
+        out << "kill_switch.name=" << kill_switch_name << "\n";
+    }
+
+    try {
+        [[maybe_unused]] bool loaded = StaticConfig::load_from_file(path.c_str());
+        assert(loaded);
+
+        test_sharded_ordering();
+        test_add_strategy_needs_factory();
+
+        std::remove(path.c_str());
+        ::shm_unlink(("/" + kill_switch_name).c_str());
+        std::cout << "\n✅ All strategy sharding tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::remove(path.c_str());
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,212 @@
+#include "../order_gateway/venue_router.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+using namespace hft;
+
+static VenueConfig venue(const std::string& name, const std::string& value) {
+    VenueConfig config;
+    std::string error;
+    [[maybe_unused]] bool ok = VenueConfig::parse(name, value, config, error);
+    assert(ok);
+    return config;
+}
+
+void test_parse() {
+    std::cout << "Testing venue config parsing..." << std::endl;
+
+    VenueConfig config = venue("lit", "simulated:0.003:0.002");
+    assert(config.name == "lit");
+    assert(config.kind == VenueKind::SIMULATED);
+    assert(config.taker_fee == to_fixed_price(0.003));
+    assert(config.maker_rebate == to_fixed_price(0.002));
+
+    config = venue("broker", "alpaca");
+    assert(config.kind == VenueKind::ALPACA);
+    assert(config.taker_fee == 0 && config.maker_rebate == 0);
+
+    config = venue("dark", "simulated:0.001");
+    assert(config.taker_fee == to_fixed_price(0.001) && config.maker_rebate == 0);
+
+    std::string error;
+    [[maybe_unused]] bool parsed = VenueConfig::parse("x", "nasdaq", config, error);
+    assert(!parsed);
+    assert(error.find("unknown kind") != std::string::npos);
+    parsed = VenueConfig::parse("x", "simulated:abc", config, error);
+    assert(!parsed);
+    parsed = VenueConfig::parse("x", "simulated:-0.1", config, error);
+    assert(!parsed);
+    parsed = VenueConfig::parse("x", "simulated:0.001:5", config, error);
+    assert(!parsed);
+    parsed = VenueConfig::parse("x", "simulated:", config, error);
+    assert(!parsed);
+
+    std::cout << "✓ Parse test passed" << std::endl;
+}
+
+void test_fees_and_quotes() {
+    std::cout << "Testing fee and quote scoring..." << std::endl;
+
+    // cheap: low taker fee, no rebate; maker: high fee, big rebate
+    VenueRouter router;
+    uint8_t cheap = router.add_venue(venue("cheap", "simulated:0.001:0"));
+    uint8_t maker = router.add_venue(venue("maker", "simulated:0.003:0.002"));
+    router.reserve_quotes(16);
+    router.refresh_scores();
+
+    const symbol_id_t symbol = 3;
+    int64_t now = 1000000000;
+    router.on_quote(cheap, symbol, to_fixed_price(100.00), to_fixed_price(100.01), now);
+    router.on_quote(maker, symbol, to_fixed_price(100.00), to_fixed_price(100.01), now);
+
+    // Marketable: the lower taker fee wins
+    [[maybe_unused]] uint8_t chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, now);
+    assert(chosen == cheap);
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.05), now);
+    assert(chosen == cheap);
+    // Resting: the rebate wins
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(99.90), now);
+    assert(chosen == maker);
+    chosen = router.route(symbol, SignalAction::SELL, OrderType::LIMIT, to_fixed_price(100.10), now);
+    assert(chosen == maker);
+
+    // A worse touch costs more than the fee saved: the better-priced venue wins
+    router.on_quote(cheap, symbol, to_fixed_price(99.99), to_fixed_price(100.02), now);
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, now);
+    assert(chosen == maker);
+    chosen = router.route(symbol, SignalAction::SELL, OrderType::MARKET, 0, now);
+    assert(chosen == maker);
+
+    // A limit between the two asks crosses on maker only: it goes there for
+    // the fill, not to cheap to rest
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::LIMIT, to_fixed_price(100.01), now);
+    assert(chosen == maker);
+
+    assert(router.routed(cheap) == 2 && router.routed(maker) == 5);
+
+    std::cout << "✓ Fee and quote test passed" << std::endl;
+}
+
+void test_stale_and_disabled() {
+    std::cout << "Testing stale quotes and disabled venues..." << std::endl;
+
+    VenueRouter router;
+    uint8_t a = router.add_venue(venue("a", "simulated:0.001"));
+    uint8_t b = router.add_venue(venue("b", "simulated:0.002"));
+    router.reserve_quotes(16);
+    router.set_quote_max_age(1000);
+    router.refresh_scores();
+
+    const symbol_id_t symbol = 1;
+    router.on_quote(a, symbol, to_fixed_price(50.00), to_fixed_price(50.01), 1);
+    router.on_quote(b, symbol, to_fixed_price(50.00), to_fixed_price(50.01), 5000);
+
+    // a's quote is stale at 5500: a marketable order goes where there is a price
+    [[maybe_unused]] uint8_t chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, 5500);
+    assert(chosen == b);
+    // Both fresh: a's lower fee wins
+    router.on_quote(a, symbol, to_fixed_price(50.00), to_fixed_price(50.01), 5000);
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, 5500);
+    assert(chosen == a);
+    // No quotes at all (or a symbol without a row): fees alone decide
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, 100000);
+    assert(chosen == a);
+    chosen = router.route(999, SignalAction::BUY, OrderType::MARKET, 0, 5500);
+    assert(chosen == a);
+
+    router.set_enabled(a, false);
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, 5500);
+    assert(chosen == b);
+    router.set_enabled(b, false);
+    chosen = router.route(symbol, SignalAction::BUY, OrderType::MARKET, 0, 5500);
+    assert(chosen == VenueRouter::NO_VENUE);
+
+    // Full
+    VenueRouter full;
+    [[maybe_unused]] uint8_t added = 0;
+    for (size_t i = 0; i < VenueRouter::MAX_VENUES; ++i) {
+        added = full.add_venue(venue("v" + std::to_string(i), "simulated"));
+        assert(added == i);
+    }
+    added = full.add_venue(venue("extra", "simulated"));
+    assert(added == VenueRouter::NO_VENUE);
+    assert(full.venue_count() == VenueRouter::MAX_VENUES);
+
+    std::cout << "✓ Stale and disabled test passed" << std::endl;
+}
+
+void test_latency_feedback() {
+    std::cout << "Testing ack latency feedback..." << std::endl;
+
+    // Same fees; fast acks in 1ms, slow in 20ms
+    VenueRouter router;
+    uint8_t slow = router.add_venue(venue("slow", "simulated:0.001"));
+    uint8_t fast = router.add_venue(venue("fast", "simulated:0.001"));
+    router.set_latency_cost(0.0001);
+    router.refresh_scores();
+
+    // No acks yet: tie, first venue
+    [[maybe_unused]] uint8_t chosen = router.route(0, SignalAction::BUY, OrderType::MARKET, 0, 0);
+    assert(chosen == slow);
+
+    for (int i = 0; i < 100; ++i) {
+        router.on_ack(slow, 20000000);
+        router.on_ack(fast, 1000000);
+    }
+    // Scores only move on refresh
+    chosen = router.route(0, SignalAction::BUY, OrderType::MARKET, 0, 0);
+    assert(chosen == slow);
+    router.refresh_scores();
+    assert(router.expected_latency_ns(slow) > router.expected_latency_ns(fast));
+    assert(router.base_cost(slow) > router.base_cost(fast));
+    chosen = router.route(0, SignalAction::BUY, OrderType::MARKET, 0, 0);
+    assert(chosen == fast);
+
+    // The estimate blends windows: one fast window halves the slow venue's gap
+    uint64_t before = router.expected_latency_ns(slow);
+    for (int i = 0; i < 100; ++i) {
+        router.on_ack(slow, 1000000);
+    }
+    router.refresh_scores();
+    uint64_t after = router.expected_latency_ns(slow);
+    assert(after < before && after > 1000000);
+
+    // An empty window keeps the estimate
+    router.refresh_scores();
+    assert(router.expected_latency_ns(slow) == after);
+
+    // A bigger latency penalty does not beat a lower fee once latencies match
+    VenueRouter fees;
+    uint8_t pricey = fees.add_venue(venue("pricey", "simulated:0.005"));
+    uint8_t thrifty = fees.add_venue(venue("thrifty", "simulated:0.001"));
+    fees.set_latency_cost(0.01);
+    for (int i = 0; i < 10; ++i) {
+        fees.on_ack(pricey, 2000000);
+        fees.on_ack(thrifty, 2000000);
+    }
+    fees.refresh_scores();
+    chosen = fees.route(0, SignalAction::BUY, OrderType::MARKET, 0, 0);
+    assert(chosen == thrifty);
+
+    std::cout << "✓ Latency feedback test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Venue Router Unit Tests" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    try {
+        test_parse();
+        test_fees_and_quotes();
+        test_stale_and_disabled();
+        test_latency_feedback();
+
+        std::cout << "\n✅ All venue router tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,132 @@
+#include "../common/warmup.h"
+#include "../common/symbol_table.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace hft;
+
+static WarmupOptions test_options() {
+    WarmupOptions options;
+    options.round_events = 100;
+    options.max_rounds = 10;
+    options.stable_rounds = 2;
+    options.tolerance = 0.10;
+    return options;
+}
+
+// One round of `events` samples all at `latency_ns`
+static bool feed_round(WarmupTracker& tracker, uint64_t latency_ns, size_t events = 100) {
+    for (size_t i = 0; i < events; ++i) tracker.record(latency_ns);
+    return tracker.end_round();
+}
+
+void test_stabilizes() {
+    std::cout << "Testing p99 stabilization..." << std::endl;
+
+    WarmupTracker tracker(test_options());
+    assert(!feed_round(tracker, 10000));   // Cold
+    assert(!feed_round(tracker, 2000));    // Still falling
+    assert(!feed_round(tracker, 1000));
+    assert(!feed_round(tracker, 1050));    // Within 10%, once
+    assert(feed_round(tracker, 1000));     // ... twice: warm
+
+    const WarmupReport& report = tracker.report();
+    assert(report.stable);
+    assert(report.rounds == 5);
+    assert(report.events == 500);
+    assert(report.first_p99_ns > report.p99_ns);
+
+    std::cout << "✓ Stabilization test passed (" << report.describe() << ")" << std::endl;
+}
+
+void test_spike_restarts_count() {
+    std::cout << "Testing a spike resets the stable run..." << std::endl;
+
+    WarmupTracker tracker(test_options());
+    feed_round(tracker, 1000);
+    assert(!feed_round(tracker, 1000));    // One stable round
+    assert(!feed_round(tracker, 5000));    // Spike
+    assert(!feed_round(tracker, 1000));    // Back down, but not yet stable
+    assert(!feed_round(tracker, 1000));
+    assert(feed_round(tracker, 1000));
+    assert(tracker.report().stable);
+
+    std::cout << "✓ Spike test passed" << std::endl;
+}
+
+void test_gives_up_after_max_rounds() {
+    std::cout << "Testing max_rounds cap..." << std::endl;
+
+    WarmupTracker tracker(test_options());
+    bool done = false;
+    for (size_t round = 0; round < 10; ++round) {
+        assert(!done);
+        done = feed_round(tracker, round % 2 ? 1000 : 3000);   // Never settles
+    }
+    assert(done);
+    assert(!tracker.report().stable);
+    assert(tracker.report().rounds == 10);
+
+    std::cout << "✓ Max rounds test passed" << std::endl;
+}
+
+void test_run_warmup() {
+    std::cout << "Testing run_warmup drives the step..." << std::endl;
+
+    WarmupOptions options = test_options();
+    options.max_rounds = 20;
+    std::vector<uint64_t> seen;
+    WarmupReport report = run_warmup(options, [&](uint64_t i) { seen.push_back(i); });
+
+    assert(report.rounds >= 1 && report.rounds <= 20);
+    assert(seen.size() == report.events);
+    assert(seen.size() == report.rounds * options.round_events);
+    for (size_t i = 0; i < seen.size(); ++i) assert(seen[i] == i);
+
+    std::cout << "✓ run_warmup test passed (" << report.describe() << ")" << std::endl;
+}
+
+void test_synthetic_messages() {
+    std::cout << "Testing synthetic messages..." << std::endl;
+
+    symbol_id_t id = SymbolTable::instance().intern("WARM");
+    MarketData up = warmup::synthetic_tick(id, 1);
+    MarketData base = warmup::synthetic_tick(id, 0);
+    assert(up.symbol_id == id);
+    assert(std::string(up.symbol) == "WARM");
+    assert(up.bid_price < up.ask_price);
+    assert(up.last_price > base.last_price);
+    assert(warmup::synthetic_tick(id, 8).last_price == base.last_price);   // Walk repeats
+
+    TradingSignal buy = warmup::synthetic_signal(id, 0);
+    TradingSignal sell = warmup::synthetic_signal(id, 1);
+    assert(buy.action == SignalAction::BUY && sell.action == SignalAction::SELL);
+    assert(buy.symbol_id == id && buy.quantity > 0);
+
+    OrderExecution fill = warmup::synthetic_execution(id, 0);
+    assert(fill.symbol_id == id && fill.exec_type == ExecutionType::FILL && fill.fill_quantity > 0);
+
+    std::cout << "✓ Synthetic message test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Warmup Unit Tests" << std::endl;
+    std::cout << "=========================" << std::endl;
+
+    try {
+        test_stabilizes();
+        test_spike_restarts_count();
+        test_gives_up_after_max_rounds();
+        test_run_warmup();
+        test_synthetic_messages();
+
+        std::cout << "\n✅ All warmup tests passed!" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,378 @@
+#include "dashboard_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace hft {
+namespace dashboard {
+
+static_assert(std::endian::native == std::endian::little, "Records are written as in memory");
+
+namespace {
+
+template<typename T>
+void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+std::string begin_frame(FrameKind kind, uint8_t flags, uint16_t count, uint32_t sequence, uint64_t timestamp_ns,
+                        size_t record_bytes) {
+    FrameHeader header{kind, flags, count, sequence, timestamp_ns};
+    std::string frame;
+    frame.reserve(sizeof(FrameHeader) + record_bytes);
+    append(frame, header);
+    return frame;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Differences wrap rather than overflow, both ends agree on the result
+int64_t wrapping_sub(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+int64_t wrapping_add(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+// Fields as signed values, in DeltaField bit order
+constexpr int DELTA_FIELDS = 7;
+
+void fields(const QuoteRecord& quote, int64_t (&out)[DELTA_FIELDS]) {
+    out[0] = quote.bid_price;
+    out[1] = quote.ask_price;
+    out[2] = quote.bid_size;
+    out[3] = quote.ask_size;
+    out[4] = quote.last_price;
+    out[5] = quote.last_size;
+    out[6] = static_cast<int64_t>(quote.exchange_timestamp);
+}
+
+void set_fields(QuoteRecord& quote, const int64_t (&in)[DELTA_FIELDS]) {
+    quote.bid_price = in[0];
+    quote.ask_price = in[1];
+    quote.bid_size = static_cast<uint32_t>(in[2]);
+    quote.ask_size = static_cast<uint32_t>(in[3]);
+    quote.last_price = in[4];
+    quote.last_size = static_cast<uint32_t>(in[5]);
+    quote.exchange_timestamp = static_cast<uint64_t>(in[6]);
+}
+
+} // namespace
+
+QuoteRecord to_quote(symbol_id_t id, const MarketData& data) {
+    QuoteRecord quote;
+    quote.symbol_id = id;
+    quote.bid_price = data.bid_price;
+    quote.ask_price = data.ask_price;
+    quote.bid_size = data.bid_size;
+    quote.ask_size = data.ask_size;
+    quote.last_price = data.last_price;
+    quote.last_size = data.last_size;
+    quote.exchange_timestamp = data.exchange_timestamp;
+    return quote;
+}
+
+ExecutionRecord to_execution(const OrderExecution& execution) {
+    ExecutionRecord record{};
+    record.order_id = execution.order_id;
+    record.symbol_id = execution.symbol_id;
+    record.exec_type = static_cast<uint8_t>(execution.exec_type);
+    record.fill_price = execution.fill_price;
+    record.fill_quantity = execution.fill_quantity;
+    record.remaining_quantity = execution.remaining_quantity;
+    record.commission = execution.commission;
+    return record;
+}
+
+bool is_quote_frame(const std::string& frame) {
+    if (frame.empty()) return false;
+    auto kind = static_cast<FrameKind>(frame[0]);     // FrameHeader::kind
+    return kind == FrameKind::QUOTES || kind == FrameKind::QUOTE_DELTAS;
+}
+
+void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool get_varint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DashboardEncoder::update(symbol_id_t id, const MarketData& data) {
+    if (id >= state_.size()) {
+        size_t size = std::max<size_t>(id + 1, state_.size() * 2);
+        sent_.resize(size, QuoteRecord{});
+        pending_.resize(size);
+        symbols_.resize(size, SymbolRecord{});
+        state_.resize(size, UNSEEN);
+    }
+
+    pending_[id] = to_quote(id, data);
+    if (state_[id] == UNSEEN) {
+        symbols_[id].symbol_id = id;
+        std::memcpy(symbols_[id].symbol, data.symbol, sizeof(symbols_[id].symbol));
+        symbols_[id].symbol[sizeof(symbols_[id].symbol) - 1] = '\0';
+        sent_[id].symbol_id = id;
+        new_symbols_.push_back(id);
+    }
+    if (state_[id] != DIRTY) {
+        state_[id] = DIRTY;
+        dirty_.push_back(id);
+    }
+}
+
+void DashboardEncoder::add_execution(const OrderExecution& execution) {
+    executions_.push_back(to_execution(execution));
+}
+
+void DashboardEncoder::flush(uint64_t timestamp_ns, bool keyframe, std::vector<std::string>& frames) {
+    if (!new_symbols_.empty()) {
+        encode_symbols(new_symbols_, timestamp_ns, frames);
+        std::vector<symbol_id_t> merged;
+        merged.reserve(known_.size() + new_symbols_.size());
+        std::sort(new_symbols_.begin(), new_symbols_.end());
+        std::merge(known_.begin(), known_.end(), new_symbols_.begin(), new_symbols_.end(), std::back_inserter(merged));
+        known_.swap(merged);
+        new_symbols_.clear();
+    }
+
+    if (keyframe && !known_.empty()) {
+        for (symbol_id_t id : dirty_) {
+            sent_[id] = pending_[id];
+            state_[id] = CLEAN;
+        }
+        dirty_.clear();
+        sequence_ += encode_keyframe(sequence_ + 1, timestamp_ns, frames);
+        keyframes_++;
+    } else if (!dirty_.empty()) {
+        encode_deltas(timestamp_ns, frames);
+    }
+
+    for (size_t i = 0; i < executions_.size(); i += MAX_RECORDS_PER_FRAME) {
+        size_t count = std::min(MAX_RECORDS_PER_FRAME, executions_.size() - i);
+        std::string frame = begin_frame(FrameKind::EXECUTIONS, 0, static_cast<uint16_t>(count), ++execution_sequence_,
+                                        timestamp_ns, count * sizeof(ExecutionRecord));
+        frame.append(reinterpret_cast<const char*>(&executions_[i]), count * sizeof(ExecutionRecord));
+        frames.push_back(std::move(frame));
+    }
+    executions_.clear();
+}
+
+void DashboardEncoder::snapshot(uint64_t timestamp_ns, std::vector<std::string>& frames) const {
+    encode_symbols(known_, timestamp_ns, frames);
+    // Parts count up to the current sequence, so the next delta follows on
+    uint32_t parts = static_cast<uint32_t>(std::max<size_t>(1, (known_.size() + MAX_RECORDS_PER_FRAME - 1) /
+                                                                   MAX_RECORDS_PER_FRAME));
+    encode_keyframe(sequence_ - parts + 1, timestamp_ns, frames);
+}
+
+void DashboardEncoder::encode_symbols(const std::vector<symbol_id_t>& ids, uint64_t timestamp_ns,
+                                      std::vector<std::string>& frames) const {
+    for (size_t i = 0; i < ids.size(); i += MAX_RECORDS_PER_FRAME) {
+        size_t count = std::min(MAX_RECORDS_PER_FRAME, ids.size() - i);
+        std::string frame = begin_frame(FrameKind::SYMBOLS, 0, static_cast<uint16_t>(count), 0, timestamp_ns,
+                                        count * sizeof(SymbolRecord));
+        for (size_t j = i; j < i + count; ++j) {
+            append(frame, symbols_[ids[j]]);
+        }
+        frames.push_back(std::move(frame));
+    }
+}
+
+uint32_t DashboardEncoder::encode_keyframe(uint32_t first_sequence, uint64_t timestamp_ns,
+                                           std::vector<std::string>& frames) const {
+    uint32_t parts = 0;
+    size_t i = 0;
+    do {
+        size_t count = std::min(MAX_RECORDS_PER_FRAME, known_.size() - i);
+        uint8_t flags = (i == 0 ? FLAG_FIRST : 0) | (i + count == known_.size() ? FLAG_LAST : 0);
+        std::string frame = begin_frame(FrameKind::QUOTES, flags, static_cast<uint16_t>(count), first_sequence + parts,
+                                        timestamp_ns, count * sizeof(QuoteRecord));
+        for (size_t j = i; j < i + count; ++j) {
+            append(frame, sent_[known_[j]]);
+        }
+        frames.push_back(std::move(frame));
+        parts++;
+        i += count;
+    } while (i < known_.size());
+    return parts;
+}
+
+void DashboardEncoder::encode_deltas(uint64_t timestamp_ns, std::vector<std::string>& frames) {
+    std::sort(dirty_.begin(), dirty_.end());
+
+    for (size_t i = 0; i < dirty_.size(); i += MAX_RECORDS_PER_FRAME) {
+        size_t count = std::min(MAX_RECORDS_PER_FRAME, dirty_.size() - i);
+        std::string frame = begin_frame(FrameKind::QUOTE_DELTAS, 0, static_cast<uint16_t>(count), ++sequence_,
+                                        timestamp_ns, count * 8);
+        symbol_id_t previous = 0;
+        for (size_t j = i; j < i + count; ++j) {
+            symbol_id_t id = dirty_[j];
+            int64_t before[DELTA_FIELDS];
+            int64_t after[DELTA_FIELDS];
+            fields(sent_[id], before);
+            fields(pending_[id], after);
+
+            uint8_t mask = 0;
+            for (int f = 0; f < DELTA_FIELDS; ++f) {
+                if (after[f] != before[f]) mask |= static_cast<uint8_t>(1 << f);
+            }
+            put_varint(frame, id - previous);
+            frame.push_back(static_cast<char>(mask));
+            for (int f = 0; f < DELTA_FIELDS; ++f) {
+                if (mask & (1 << f)) put_varint(frame, zigzag(wrapping_sub(after[f], before[f])));
+            }
+
+            previous = id;
+            sent_[id] = pending_[id];
+            state_[id] = CLEAN;
+        }
+        delta_records_ += count;
+        frames.push_back(std::move(frame));
+    }
+    dirty_.clear();
+}
+
+QuoteRecord& DashboardDecoder::quote(symbol_id_t id) {
+    if (id >= quotes_.size()) {
+        quotes_.resize(id + 1, QuoteRecord{});
+        have_.resize(id + 1, 0);
+    }
+    have_[id] = 1;
+    quotes_[id].symbol_id = id;
+    return quotes_[id];
+}
+
+bool DashboardDecoder::get_quote(symbol_id_t id, QuoteRecord& out) const {
+    if (id >= have_.size() || !have_[id]) {
+        return false;
+    }
+    out = quotes_[id];
+    return true;
+}
+
+const std::string* DashboardDecoder::get_symbol(symbol_id_t id) const {
+    return id < symbols_.size() && !symbols_[id].empty() ? &symbols_[id] : nullptr;
+}
+
+bool DashboardDecoder::decode(const std::string& frame) {
+    if (frame.size() < sizeof(FrameHeader)) {
+        return false;
+    }
+    FrameHeader header;
+    std::memcpy(&header, frame.data(), sizeof(header));
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(frame.data()) + sizeof(header);
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(frame.data()) + frame.size();
+    size_t payload = frame.size() - sizeof(header);
+
+    switch (header.kind) {
+        case FrameKind::SYMBOLS: {
+            if (payload != header.count * sizeof(SymbolRecord)) return false;
+            for (uint16_t i = 0; i < header.count; ++i) {
+                SymbolRecord record;
+                std::memcpy(&record, pos + i * sizeof(record), sizeof(record));
+                if (record.symbol_id >= symbols_.size()) symbols_.resize(record.symbol_id + 1);
+                symbols_[record.symbol_id].assign(record.symbol, strnlen(record.symbol, sizeof(record.symbol)));
+            }
+            return true;
+        }
+
+        case FrameKind::EXECUTIONS: {
+            if (payload != header.count * sizeof(ExecutionRecord)) return false;
+            if (have_execution_sequence_ && header.sequence != last_execution_sequence_ + 1) {
+                missed_execution_frames_ += header.sequence - last_execution_sequence_ - 1;
+            }
+            have_execution_sequence_ = true;
+            last_execution_sequence_ = header.sequence;
+            for (uint16_t i = 0; i < header.count; ++i) {
+                ExecutionRecord record;
+                std::memcpy(&record, pos + i * sizeof(record), sizeof(record));
+                executions_.push_back(record);
+            }
+            return true;
+        }
+
+        case FrameKind::QUOTES:
+        case FrameKind::QUOTE_DELTAS:
+            break;
+
+        default:
+            return false;
+    }
+
+    // Quote stream: any hole means deltas no longer line up
+    bool contiguous = have_sequence_ && header.sequence == last_sequence_ + 1;
+    if (!contiguous) {
+        synced_ = false;
+    }
+    have_sequence_ = true;
+    last_sequence_ = header.sequence;
+
+    if (header.kind == FrameKind::QUOTES) {
+        if (payload != header.count * sizeof(QuoteRecord)) return false;
+        in_keyframe_ = (header.flags & FLAG_FIRST) || (in_keyframe_ && contiguous);
+        for (uint16_t i = 0; i < header.count; ++i) {
+            QuoteRecord record;
+            std::memcpy(&record, pos + i * sizeof(record), sizeof(record));
+            quote(record.symbol_id) = record;
+        }
+        if ((header.flags & FLAG_LAST) && in_keyframe_) {
+            synced_ = true;
+            in_keyframe_ = false;
+        }
+        return true;
+    }
+
+    if (!synced_) {
+        dropped_frames_++;
+        return true;
+    }
+    symbol_id_t id = 0;
+    for (uint16_t i = 0; i < header.count; ++i) {
+        uint64_t gap;
+        if (!get_varint(pos, end, gap) || pos >= end) {
+            synced_ = false;
+            return false;
+        }
+        id += static_cast<symbol_id_t>(gap);
+        uint8_t mask = *pos++;
+
+        QuoteRecord& record = quote(id);
+        int64_t values[DELTA_FIELDS];
+        fields(record, values);
+        for (int f = 0; f < DELTA_FIELDS; ++f) {
+            if (!(mask & (1 << f))) continue;
+            uint64_t diff;
+            if (!get_varint(pos, end, diff)) {
+                synced_ = false;
+                return false;
+            }
+            values[f] = wrapping_add(values[f], unzigzag(diff));
+        }
+        set_fields(record, values);
+    }
+    return pos == end;
+}
+
+} // namespace dashboard
+} // namespace hft
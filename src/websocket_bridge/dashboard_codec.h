@@ -0,0 +1,182 @@
+#pragma once
+
+#include "../common/message_types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace dashboard {
+
+// Binary dashboard stream, negotiated as the "hft.binary.v1" WebSocket
+// subprotocol (clients that don't ask for it keep getting JSON). Each binary
+// message is a FrameHeader followed by count records of one kind, all
+// little-endian:
+//
+//   SYMBOLS       SymbolRecord, sent before the first quote of a new ID
+//   QUOTES        QuoteRecord, absolute values (keyframes)
+//   QUOTE_DELTAS  per symbol: varint ID gap from the previous record in the
+//                 frame, a field mask byte, then a zigzag varint difference
+//                 for each masked field against the symbol's previous value
+//                 (zeros for a symbol not seen before)
+//   EXECUTIONS    ExecutionRecord
+//
+// Quote frames share one sequence number stream. A delta frame only applies
+// on top of the frame before it, so a client that misses one (its send queue
+// was over the limit) drops deltas until the next keyframe. A keyframe may
+// span several frames, marked FLAG_FIRST and FLAG_LAST. Execution frames are
+// numbered separately.
+
+static constexpr const char* SUBPROTOCOL = "hft.binary.v1";
+static constexpr size_t MAX_RECORDS_PER_FRAME = 1024;
+
+enum class FrameKind : uint8_t {
+    SYMBOLS = 1,
+    QUOTES = 2,
+    QUOTE_DELTAS = 3,
+    EXECUTIONS = 4
+};
+
+static constexpr uint8_t FLAG_FIRST = 1;    // First frame of a keyframe
+static constexpr uint8_t FLAG_LAST = 2;     // Last frame of a keyframe
+
+struct FrameHeader {
+    FrameKind kind;
+    uint8_t flags;
+    uint16_t count;
+    uint32_t sequence;
+    uint64_t timestamp_ns;
+} __attribute__((packed));
+
+struct SymbolRecord {
+    uint32_t symbol_id;
+    char symbol[16];
+} __attribute__((packed));
+
+struct QuoteRecord {
+    uint32_t symbol_id;
+    int64_t bid_price;          // Fixed-point, see fixed_price.h
+    int64_t ask_price;
+    uint32_t bid_size;
+    uint32_t ask_size;
+    int64_t last_price;
+    uint32_t last_size;
+    uint64_t exchange_timestamp;
+} __attribute__((packed));
+
+struct ExecutionRecord {
+    uint64_t order_id;
+    uint32_t symbol_id;
+    uint8_t exec_type;          // ExecutionType
+    uint8_t padding[3];
+    int64_t fill_price;
+    uint32_t fill_quantity;
+    uint32_t remaining_quantity;
+    double commission;
+} __attribute__((packed));
+
+static_assert(sizeof(FrameHeader) == 16 && sizeof(SymbolRecord) == 20 &&
+              sizeof(QuoteRecord) == 48 && sizeof(ExecutionRecord) == 40, "Wire layout");
+
+// Delta field mask bits, in encoding order
+enum DeltaField : uint8_t {
+    BID_PRICE = 1 << 0,
+    ASK_PRICE = 1 << 1,
+    BID_SIZE = 1 << 2,
+    ASK_SIZE = 1 << 3,
+    LAST_PRICE = 1 << 4,
+    LAST_SIZE = 1 << 5,
+    EXCHANGE_TIMESTAMP = 1 << 6
+};
+
+QuoteRecord to_quote(symbol_id_t id, const MarketData& data);
+ExecutionRecord to_execution(const OrderExecution& execution);
+
+// QUOTES or QUOTE_DELTAS: a client that misses one resyncs at the next
+// keyframe. Symbol and execution frames have no such fallback.
+bool is_quote_frame(const std::string& frame);
+
+// LEB128 varints; decode returns false on truncated input
+void put_varint(std::string& out, uint64_t value);
+bool get_varint(const uint8_t*& pos, const uint8_t* end, uint64_t& value);
+
+// Server side. Collects the latest quote per symbol between flushes and
+// encodes what changed since the previous flush. Single-threaded (the
+// bridge calls it from the reactor timer).
+class DashboardEncoder {
+public:
+    void update(symbol_id_t id, const MarketData& data);
+    void add_execution(const OrderExecution& execution);
+
+    // Appends the frames to broadcast: new symbols, then quote deltas (or a
+    // keyframe of every symbol), then executions. Nothing if nothing changed.
+    void flush(uint64_t timestamp_ns, bool keyframe, std::vector<std::string>& frames);
+
+    // Frames that bring a new client up to the last flush: every symbol and
+    // a keyframe numbered to end at the current sequence
+    void snapshot(uint64_t timestamp_ns, std::vector<std::string>& frames) const;
+
+    uint32_t sequence() const { return sequence_; }
+    size_t symbol_count() const { return known_.size(); }
+    uint64_t get_delta_records() const { return delta_records_; }
+    uint64_t get_keyframes() const { return keyframes_; }
+
+private:
+    enum State : uint8_t { UNSEEN = 0, CLEAN, DIRTY };
+
+    // By symbol ID
+    std::vector<QuoteRecord> sent_;         // What clients have
+    std::vector<QuoteRecord> pending_;      // Latest value since the last flush
+    std::vector<SymbolRecord> symbols_;
+    std::vector<uint8_t> state_;
+
+    std::vector<symbol_id_t> known_;        // Flushed at least once, ascending
+    std::vector<symbol_id_t> dirty_;
+    std::vector<symbol_id_t> new_symbols_;
+    std::vector<ExecutionRecord> executions_;
+    uint32_t sequence_ = 0;
+    uint32_t execution_sequence_ = 0;
+    uint64_t delta_records_ = 0;
+    uint64_t keyframes_ = 0;
+
+    void encode_symbols(const std::vector<symbol_id_t>& ids, uint64_t timestamp_ns,
+                        std::vector<std::string>& frames) const;
+    // Returns the number of frames appended (at least one)
+    uint32_t encode_keyframe(uint32_t first_sequence, uint64_t timestamp_ns, std::vector<std::string>& frames) const;
+    void encode_deltas(uint64_t timestamp_ns, std::vector<std::string>& frames);
+};
+
+// Reference client, used by the tests and as documentation for the
+// dashboard's JavaScript decoder
+class DashboardDecoder {
+public:
+    // false if the frame is malformed
+    bool decode(const std::string& frame);
+
+    bool is_synced() const { return synced_; }
+    bool get_quote(symbol_id_t id, QuoteRecord& out) const;
+    const std::string* get_symbol(symbol_id_t id) const;
+    const std::vector<ExecutionRecord>& executions() const { return executions_; }
+    uint64_t get_dropped_frames() const { return dropped_frames_; }     // Deltas ignored while out of sync
+    uint64_t get_missed_execution_frames() const { return missed_execution_frames_; }
+
+private:
+    std::vector<QuoteRecord> quotes_;
+    std::vector<uint8_t> have_;
+    std::vector<std::string> symbols_;
+    std::vector<ExecutionRecord> executions_;
+    bool synced_ = false;
+    bool in_keyframe_ = false;
+    bool have_sequence_ = false;
+    uint32_t last_sequence_ = 0;
+    bool have_execution_sequence_ = false;
+    uint32_t last_execution_sequence_ = 0;
+    uint64_t dropped_frames_ = 0;
+    uint64_t missed_execution_frames_ = 0;
+
+    QuoteRecord& quote(symbol_id_t id);
+};
+
+} // namespace dashboard
+} // namespace hft
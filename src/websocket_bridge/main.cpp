@@ -1,6 +1,9 @@
 #include "websocket_bridge.h"
 #include "../common/hft_metrics.h"
+#include "../common/static_config.h"
+#include "../common/cpu_topology.h"
 #include <iostream>
+#include <string>
 #include <thread>
 #include <chrono>
 #include <signal.h>
@@ -12,10 +15,14 @@ void signal_handler(int signal) {
     g_running = false;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "HFT WebSocket Bridge v2.0" << std::endl;
     std::cout << "=========================" << std::endl;
     
+    std::string config_file = (argc > 1) ? argv[1] : "config/hft_config.conf";
+    hft::StaticConfig::load_from_file(config_file.c_str());
+    hft::ThreadPlan::instance().configure("websocket_bridge");
+    
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
@@ -3,7 +3,14 @@
 #include "../common/static_config.h"
 #include "../common/prometheus_exporter.h"
 #include "../common/metrics_aggregator.h"
-#include <zmq.hpp>
+#include "../common/conflation_table.h"
+#include "../common/symbol_table.h"
+#include "../common/http_server.h"
+#include "../common/cpu_topology.h"
+#include "../common/zmq_transport.h"
+#include "../common/event_loop.h"
+#include "dashboard_codec.h"
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <iostream>
@@ -12,18 +19,11 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
-#include <condition_variable>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <errno.h>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <map>
-#include <queue>
-#include <future>
+#include <unordered_map>
 
 namespace hft {
 
@@ -32,25 +32,10 @@ public:
     WebSocketBridge() 
         : running_(false)
         , logger_("WebSocketBridge", StaticConfig::get_logger_endpoint())
-        , context_(1)
-        , zmq_subscriber_(context_, ZMQ_SUB)
-        , execution_subscriber_(context_, ZMQ_SUB)
-        , control_publisher_(context_, ZMQ_PUB)
-        , server_socket_(-1)
-        , port_(8080)
-        , metrics_aggregator_("tcp://localhost:5560") {
-        
-        // Subscribe to all market data messages
-        zmq_subscriber_.setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        zmq_subscriber_.setsockopt(ZMQ_RCVTIMEO, 1000); // 1 second timeout
-        
-        // Subscribe to all execution messages
-        execution_subscriber_.setsockopt(ZMQ_SUBSCRIBE, "", 0);
-        execution_subscriber_.setsockopt(ZMQ_RCVTIMEO, 1000); // 1 second timeout
-        
-        // Control publisher setup
-        int linger = 0;
-        control_publisher_.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+        , http_server_("WebSocketBridge")
+        , port_(StaticConfig::get_websocket_port())
+        , metrics_aggregator_("tcp://localhost:5560")
+        , io_loop_("WebSocketBridge") {
     }
     
     ~WebSocketBridge() {
@@ -59,6 +44,10 @@ public:
     
     bool initialize() {
         try {
+            // Quote records carry only the symbol ID; assign IDs in config
+            // order so they agree with the feed handler
+            SymbolTable::instance().preload(StaticConfig::get_symbols());
+            
             // Initialize metrics aggregator
             if (!metrics_aggregator_.initialize()) {
                 logger_.error("Failed to initialize metrics aggregator");
@@ -66,79 +55,60 @@ public:
             }
             
             // Connect to ZMQ message bus
-            std::string zmq_endpoint = StaticConfig::get_market_data_endpoint();
-            zmq_subscriber_.connect(zmq_endpoint);
-            logger_.info("Connected to market data endpoint: " + zmq_endpoint);
+            zmq_subscriber_ = TransportFactory::open_subscriber(
+                zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_market_data_endpoint())));
+            logger_.info("Connected to market data endpoint: " + zmq_subscriber_->get_endpoint());
             
             // Connect to executions endpoint
-            std::string exec_endpoint = StaticConfig::get_executions_endpoint();
-            execution_subscriber_.connect(exec_endpoint);
-            logger_.info("Connected to executions endpoint: " + exec_endpoint);
+            execution_subscriber_ = TransportFactory::open_subscriber(
+                zmq_subscriber_config(zmq_data_endpoint(StaticConfig::get_executions_endpoint())));
+            logger_.info("Connected to executions endpoint: " + execution_subscriber_->get_endpoint());
             
             // Bind control publisher - using port 5570 for control commands
-            control_publisher_.bind("tcp://*:5570");
+            control_publisher_ = TransportFactory::open_publisher(zmq_publisher_config("tcp://*:5570"));
             logger_.info("Control publisher bound to tcp://*:5570");
             
-            // Create HTTP server socket
-            server_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-            if (server_socket_ < 0) {
-                logger_.error("Failed to create server socket");
-                return false;
-            }
-            
-            // Set socket options for robust binding
-            int opt = 1;
-            if (setsockopt(server_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-                logger_.warning("Failed to set SO_REUSEADDR");
-            }
-            
-            // Enable SO_REUSEPORT for better port reuse (Linux-specific)
-            #ifdef SO_REUSEPORT
-            if (setsockopt(server_socket_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
-                logger_.warning("SO_REUSEPORT not supported, continuing without it");
-            }
-            #endif
-            
-            // Bind to port with retry logic
-            sockaddr_in server_addr{};
-            server_addr.sin_family = AF_INET;
-            server_addr.sin_addr.s_addr = INADDR_ANY;
-            server_addr.sin_port = htons(port_);
-            
-            int bind_attempts = 3;
+            // HTTP and WebSocket clients share one epoll thread
+            http_server_.set_max_connections(static_cast<size_t>(StaticConfig::get_http_max_connections()));
+            http_server_.set_send_queue_limit(static_cast<size_t>(StaticConfig::get_http_send_queue_limit_kb()) * 1024);
+            http_server_.set_request_handler([this](const HttpRequest& request) { return route_request(request); });
+            http_server_.set_websocket_path("/ws");
+            http_server_.set_websocket_protocols({dashboard::SUBPROTOCOL});
+            http_server_.set_websocket_open_handler([this](HttpServer::connection_id_t client, const std::string& protocol) {
+                on_websocket_open(client, protocol);
+            });
+            http_server_.set_timer(std::chrono::milliseconds(StaticConfig::get_websocket_broadcast_interval_ms()),
+                                   [this] { broadcast_market_data(); });
+            
+            // A restart can find the port still held by the previous
+            // instance on its way out: retry briefly until it lets go
+            // rather than sleeping whole seconds between attempts
+            const auto bind_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+            int bind_attempts = 0;
             bool bind_success = false;
             
-            for (int attempt = 1; attempt <= bind_attempts; ++attempt) {
-                if (bind(server_socket_, (struct sockaddr*)&server_addr, sizeof(server_addr)) == 0) {
+            while (true) {
+                ++bind_attempts;
+                if (http_server_.listen("0.0.0.0", static_cast<uint16_t>(port_))) {
                     bind_success = true;
                     break;
                 }
-                
-                int bind_errno = errno;
-                if (attempt < bind_attempts) {
-                    logger_.warning("Bind attempt " + std::to_string(attempt) + " failed (errno: " + 
-                                  std::to_string(bind_errno) + "), retrying in " + 
-                                  std::to_string(attempt) + " seconds...");
-                    std::this_thread::sleep_for(std::chrono::seconds(attempt));
-                } else {
+                if (std::chrono::steady_clock::now() >= bind_deadline) {
                     logger_.error("Failed to bind to port " + std::to_string(port_) + 
-                                " after " + std::to_string(bind_attempts) + " attempts (errno: " + 
-                                std::to_string(bind_errno) + ")");
+                                " after " + std::to_string(bind_attempts) + " attempts");
+                    break;
                 }
+                if (bind_attempts == 1) {
+                    logger_.warning("Port " + std::to_string(port_) + " busy, retrying for up to 3 seconds...");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
             
             if (!bind_success) {
-                close(server_socket_);
-                return false;
-            }
-            
-            if (listen(server_socket_, 10) < 0) {
-                logger_.error("Failed to listen on socket");
-                close(server_socket_);
                 return false;
             }
             
-            logger_.info("WebSocket bridge listening on port " + std::to_string(port_));
+            logger_.info("WebSocket bridge listening on port " + std::to_string(port_) + " (WebSocket on /ws)");
             return true;
             
         } catch (const std::exception& e) {
@@ -150,59 +120,26 @@ public:
     void start() {
         running_ = true;
         
-        // Start metrics aggregator
-        metrics_aggregator_.start();
-        
-        // Start worker threads for client handling
-        for (size_t i = 0; i < MAX_WORKER_THREADS; ++i) {
-            worker_threads_.emplace_back(&WebSocketBridge::worker_thread, this);
-        }
-        
-        // Start ZMQ message processing thread
-        zmq_thread_ = std::make_unique<std::thread>(&WebSocketBridge::zmq_message_loop, this);
-        
-        // Start execution processing thread
-        execution_thread_ = std::make_unique<std::thread>(&WebSocketBridge::execution_message_loop, this);
+        // Metrics, market data and executions share one loop thread
+        metrics_aggregator_.start(&io_loop_);
+        io_loop_.spawn(market_data_task());
+        io_loop_.spawn(execution_task());
+        io_loop_.start("processing");
         
-        // Start HTTP server thread
-        server_thread_ = std::make_unique<std::thread>(&WebSocketBridge::server_loop, this);
+        // Start the HTTP/WebSocket reactor
+        http_server_.start();
         
-        logger_.info("WebSocket bridge started with " + std::to_string(MAX_WORKER_THREADS) + " worker threads");
+        logger_.info("WebSocket bridge started");
     }
     
     void stop() {
         running_ = false;
         
-        // Stop metrics aggregator
+        // The loop goes first: the aggregator's task runs on it
+        io_loop_.stop();
         metrics_aggregator_.stop();
         
-        // Notify all worker threads to shutdown
-        client_queue_cv_.notify_all();
-        
-        if (server_socket_ >= 0) {
-            close(server_socket_);
-            server_socket_ = -1;
-        }
-        
-        if (zmq_thread_ && zmq_thread_->joinable()) {
-            zmq_thread_->join();
-        }
-        
-        if (execution_thread_ && execution_thread_->joinable()) {
-            execution_thread_->join();
-        }
-        
-        if (server_thread_ && server_thread_->joinable()) {
-            server_thread_->join();
-        }
-        
-        // Join all worker threads
-        for (auto& worker : worker_threads_) {
-            if (worker.joinable()) {
-                worker.join();
-            }
-        }
-        worker_threads_.clear();
+        http_server_.stop();
         
         logger_.info("WebSocket bridge stopped");
     }
@@ -214,45 +151,64 @@ bool is_running() const {
 private:
     std::atomic<bool> running_;
     Logger logger_;
-    zmq::context_t context_;
-    zmq::socket_t zmq_subscriber_;
-    zmq::socket_t execution_subscriber_;
-    zmq::socket_t control_publisher_;
-    int server_socket_;
+    std::unique_ptr<IMessageSubscriber> zmq_subscriber_;
+    std::unique_ptr<IMessageSubscriber> execution_subscriber_;
+    std::unique_ptr<IMessagePublisher> control_publisher_;
+    HttpServer http_server_;
     int port_;
     MetricsAggregator metrics_aggregator_;
+    // Scrapes run on the reactor thread; each exporter keeps its rendered text
+    PrometheusExporter metrics_exporter_;
+    std::unordered_map<std::string, PrometheusExporter> service_exporters_;
+    
+    EventLoop io_loop_;
     
-    std::unique_ptr<std::thread> zmq_thread_;
-    std::unique_ptr<std::thread> execution_thread_;
-    std::unique_ptr<std::thread> server_thread_;
+    // Latest quote per symbol, written by the loop thread and read per refresh
+    ConflationTable<MarketData> latest_market_data_;
+    uint64_t broadcast_updates_ = 0;    // Table updates at the last broadcast (reactor thread)
     
-    // Thread-safe message buffers
+    // Binary dashboard stream (reactor thread, except the execution queue)
+    dashboard::DashboardEncoder binary_encoder_;
+    std::vector<uint64_t> binary_versions_;     // Table slot version last fed to the encoder
+    uint64_t binary_flushes_ = 0;
+    std::vector<OrderExecution> pending_executions_;     // Guarded by execution_mutex_
+    
+    // Thread-safe message buffers (messages other than market data)
     std::mutex message_mutex_;
     std::vector<std::string> message_buffer_;
     std::mutex execution_mutex_;
     std::vector<std::string> execution_buffer_;
     static const size_t MAX_MESSAGES = 1000;
     static const size_t MAX_EXECUTIONS = 500;
+    static constexpr size_t MAX_DRAIN_PER_WAKEUP = 4096;
     
-    // Thread pool for client handling
-    static constexpr size_t MAX_WORKER_THREADS = 2;
-    static constexpr size_t MAX_PENDING_CONNECTIONS = 100;
-    std::vector<std::thread> worker_threads_;
-    std::queue<int> pending_clients_;
-    std::mutex client_queue_mutex_;
-    std::condition_variable client_queue_cv_;
-    std::atomic<size_t> active_connections_{0};
-    
-    void zmq_message_loop() {
-        logger_.info("ZMQ message processing thread started");
+    Task market_data_task() {
+        logger_.info("Market data task started");
+        void* socket = zmq_subscriber_->get_native_handle();
         
         while (running_) {
+            co_await io_loop_.zmq_readable(socket);
+            bool more = true;
             try {
-                zmq::message_t msg;
-                auto result = zmq_subscriber_.recv(msg, zmq::recv_flags::dontwait);
-                
-                if (result) {
-                    std::string data(static_cast<char*>(msg.data()), msg.size());
+                // Drain what is queued, then wait: ticks only overwrite their
+                // symbol's slot, formatting happens per HTTP refresh
+                for (size_t drained = 0; drained < MAX_DRAIN_PER_WAKEUP; ++drained) {
+                    MarketDataFrame frame;
+                    size_t size = sizeof(frame);
+                    if (!zmq_subscriber_->receive(&frame, size, true)) {
+                        more = false;
+                        break;
+                    }
+                    
+                    size_t quotes = for_each_quote(&frame, size, [this](const MarketData& data) {
+                        symbol_id_t id = SymbolTable::instance().resolve(data.symbol_id, data.symbol);
+                        latest_market_data_.write(id, data);
+                    });
+                    if (quotes > 0) {
+                        continue;
+                    }
+                    
+                    std::string data(reinterpret_cast<const char*>(&frame), size);
                     
                     // Format as JSON for web clients
                     std::string json_msg = format_as_json(data);
@@ -269,30 +225,32 @@ private:
                     }
                 }
                 
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
-                
             } catch (const std::exception& e) {
                 logger_.error("ZMQ message processing error: " + std::string(e.what()));
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                more = false;
+            }
+            if (more) {
+                // A full drain: let the execution and metrics tasks in
+                co_await io_loop_.yield();
             }
         }
-        
-        logger_.info("ZMQ message processing thread stopped");
     }
     
-    void execution_message_loop() {
-        logger_.info("Execution message processing thread started");
+    Task execution_task() {
+        logger_.info("Execution task started");
+        void* socket = execution_subscriber_->get_native_handle();
         
         while (running_) {
+            co_await io_loop_.zmq_readable(socket);
             try {
-                zmq::message_t msg;
-                auto result = execution_subscriber_.recv(msg, zmq::recv_flags::dontwait);
-                
-                if (result) {
-                    if (msg.size() == sizeof(OrderExecution)) {
-                        OrderExecution execution;
-                        std::memcpy(&execution, msg.data(), sizeof(OrderExecution));
-                        
+                for (;;) {
+                    OrderExecution execution;
+                    size_t size = sizeof(execution);
+                    if (!execution_subscriber_->receive(&execution, size, true)) {
+                        break;
+                    }
+                    if (size == sizeof(OrderExecution)) {
+
                         // Format as JSON for web clients
                         std::string json_exec = format_execution_as_json(execution);
                         
@@ -305,282 +263,198 @@ private:
                             if (execution_buffer_.size() > MAX_EXECUTIONS) {
                                 execution_buffer_.erase(execution_buffer_.begin());
                             }
+                            // Batched into the next binary flush
+                            if (http_server_.get_websocket_client_count(dashboard::SUBPROTOCOL) > 0 &&
+                                pending_executions_.size() < MAX_EXECUTIONS) {
+                                pending_executions_.push_back(execution);
+                            }
+                        }
+                        
+                        // JSON clients get executions as they happen, not conflated
+                        if (http_server_.get_websocket_client_count("") > 0) {
+                            http_server_.broadcast("{\"type\":\"execution\",\"execution\":" + json_exec + "}", "",
+                                                   false, HttpServer::Delivery::EVERY);
                         }
                     }
                 }
                 
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
-                
             } catch (const std::exception& e) {
                 logger_.error("Execution message processing error: " + std::string(e.what()));
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
         }
+    }
+    
+    HttpResponse route_request(const HttpRequest& request) {
+        const std::string& method = request.method;
+        const std::string& path = request.path;
+        logger_.debug("Received HTTP request for path: " + path);
+        
+        // Handle CORS preflight OPTIONS requests
+        if (method == "OPTIONS") {
+            return build_cors_preflight_response();
+        } else if (method == "POST" && path == "/api/control/start") {
+            logger_.info("Received start control command");
+            return handle_control_command(ControlAction::START_TRADING);
+        } else if (method == "POST" && path == "/api/control/stop") {
+            logger_.info("Received stop control command");
+            return handle_control_command(ControlAction::STOP_TRADING);
+        } else if (path == "/metrics") {
+            // Prometheus metrics endpoint - all services
+            return build_metrics_response();
+        } else if (path == "/metrics/market_data") {
+            // Market Data Handler specific metrics
+            return build_service_metrics_response("MarketDataHandler");
+        } else if (path == "/metrics/strategy_engine") {
+            // Strategy Engine specific metrics
+            return build_service_metrics_response("StrategyEngine");
+        } else if (path == "/metrics/order_gateway") {
+            // Order Gateway specific metrics
+            return build_service_metrics_response("OrderGateway");
+        } else if (path == "/metrics/position_service") {
+            // Position & Risk Service specific metrics
+            return build_service_metrics_response("PositionRiskService");
+        } else if (path == "/api/executions") {
+            // Recent executions endpoint
+            return build_executions_response();
+        } else if (path == "/api/history") {
+            // ?service=<name>&metric=<name>[&tier=1s|10s|1m][&since=<unix s>]
+            return build_history_response(request);
+        }
         
-        logger_.info("Execution message processing thread stopped");
+        // Default: return current messages
+        return build_http_response();
     }
     
-    void server_loop() {
-        logger_.info("HTTP server thread started");
+    // Reactor timer: serialize the conflated table once and fan it out
+    void broadcast_market_data() {
+        broadcast_binary_market_data();
         
-        while (running_) {
-            sockaddr_in client_addr{};
-            socklen_t client_len = sizeof(client_addr);
-            
-            int client_socket = accept(server_socket_, (struct sockaddr*)&client_addr, &client_len);
-            if (client_socket < 0) {
-                if (running_) {
-                    logger_.warning("Failed to accept client connection");
-                }
-                continue;
-            }
-            
-            // Check connection limit
-            if (active_connections_.load() >= MAX_PENDING_CONNECTIONS) {
-                logger_.warning("Connection limit reached, rejecting client");
-                close(client_socket);
-                continue;
-            }
-            
-            // Queue client for worker thread handling
-            {
-                std::lock_guard<std::mutex> lock(client_queue_mutex_);
-                pending_clients_.push(client_socket);
-            }
-            client_queue_cv_.notify_one();
-            active_connections_++;
+        uint64_t updates = latest_market_data_.get_updates();
+        if (http_server_.get_websocket_client_count("") == 0 || updates == broadcast_updates_) {
+            return;
         }
+        broadcast_updates_ = updates;
         
-        logger_.info("HTTP server thread stopped");
+        std::ostringstream json;
+        json << "{\"type\":\"market_data\",\"market_data\":[";
+        bool first = true;
+        latest_market_data_.for_each([&](symbol_id_t, const MarketData& data, uint64_t version) {
+            if (!first) json << ",";
+            first = false;
+            json << format_market_data_as_json(data, version);
+        });
+        json << "],\"timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() << "}";
+        
+        http_server_.broadcast(json.str());
     }
     
-    void worker_thread() {
-        while (running_) {
-            int client_socket = -1;
-            
-            // Wait for client to process
-            {
-                std::unique_lock<std::mutex> lock(client_queue_mutex_);
-                client_queue_cv_.wait(lock, [this] { 
-                    return !pending_clients_.empty() || !running_; 
-                });
-                
-                if (!running_) break;
-                
-                if (!pending_clients_.empty()) {
-                    client_socket = pending_clients_.front();
-                    pending_clients_.pop();
-                }
+    // The encoder tracks the table even without binary clients, so a client
+    // that connects gets a current snapshot and the deltas that follow it
+    void broadcast_binary_market_data() {
+        latest_market_data_.for_each([&](symbol_id_t id, const MarketData& data, uint64_t version) {
+            if (id >= binary_versions_.size()) {
+                binary_versions_.resize(latest_market_data_.used(), 0);
             }
-            
-            if (client_socket >= 0) {
-                handle_client(client_socket);
-                close(client_socket);
-                active_connections_--;
+            if (binary_versions_[id] != version) {
+                binary_versions_[id] = version;
+                binary_encoder_.update(id, data);
+            }
+        });
+        {
+            std::lock_guard<std::mutex> lock(execution_mutex_);
+            for (const OrderExecution& execution : pending_executions_) {
+                binary_encoder_.add_execution(execution);
             }
+            pending_executions_.clear();
+        }
+        
+        // Periodic keyframes resync clients that skipped a frame under backpressure
+        int keyframe_interval = std::max(1, StaticConfig::get_websocket_binary_keyframe_interval());
+        bool keyframe = ++binary_flushes_ % static_cast<uint64_t>(keyframe_interval) == 0;
+        std::vector<std::string> frames;
+        binary_encoder_.flush(now_ns(), keyframe, frames);
+        if (http_server_.get_websocket_client_count(dashboard::SUBPROTOCOL) == 0) {
+            return;
+        }
+        for (const std::string& frame : frames) {
+            http_server_.broadcast(frame, dashboard::SUBPROTOCOL, true,
+                                   dashboard::is_quote_frame(frame) ? HttpServer::Delivery::LATEST
+                                                                    : HttpServer::Delivery::EVERY);
         }
     }
     
-    void handle_client(int client_socket) {
-        // Set client socket timeouts for both send and receive
-        struct timeval timeout;
-        timeout.tv_sec = 5;  // 5 second timeout
-        timeout.tv_usec = 0;
-        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-        setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-        
-        char buffer[1024] = {0};
-        ssize_t bytes_read = read(client_socket, buffer, sizeof(buffer) - 1);
-        
-        if (bytes_read > 0) {
-            std::string request(buffer, bytes_read);
-            
-            // Parse request method and path
-            std::string method, path;
-            parse_request(request, method, path);
-            
-            // Debug logging
-            logger_.debug("Received HTTP request for path: " + path);
-            
-            std::string response;
-            try {
-                // Handle CORS preflight OPTIONS requests
-                if (method == "OPTIONS") {
-                    logger_.info("Received CORS preflight request for path: " + path);
-                    response = build_cors_preflight_response();
-                } else if (method == "POST" && path == "/api/control/start") {
-                    logger_.info("Received start control command");
-                    response = handle_control_command(ControlAction::START_TRADING);
-                } else if (method == "POST" && path == "/api/control/stop") {
-                    logger_.info("Received stop control command");
-                    response = handle_control_command(ControlAction::STOP_TRADING);
-                } else if (path == "/metrics") {
-                    // Prometheus metrics endpoint - all services
-                    logger_.info("Building aggregated metrics response");
-                    response = build_metrics_response();
-                    logger_.debug("Metrics response size: " + std::to_string(response.length()));
-                } else if (path == "/metrics/market_data") {
-                    // Market Data Handler specific metrics
-                    logger_.info("Building market data metrics response");
-                    response = build_service_metrics_response("MarketDataHandler");
-                } else if (path == "/metrics/strategy_engine") {
-                    // Strategy Engine specific metrics
-                    logger_.info("Building strategy engine metrics response");
-                    response = build_service_metrics_response("StrategyEngine");
-                } else if (path == "/metrics/order_gateway") {
-                    // Order Gateway specific metrics
-                    logger_.info("Building order gateway metrics response");
-                    response = build_service_metrics_response("OrderGateway");
-                } else if (path == "/metrics/position_service") {
-                    // Position & Risk Service specific metrics
-                    logger_.info("Building position service metrics response");
-                    response = build_service_metrics_response("PositionRiskService");
-                } else if (path == "/api/executions") {
-                    // Recent executions endpoint
-                    logger_.info("Building executions response");
-                    response = build_executions_response();
-                } else {
-                    // Default: return current messages
-                    logger_.info("Building default HTTP response");
-                    response = build_http_response();
-                }
-                
-                if (!response.empty()) {
-                    // Send response in chunks to handle large responses
-                    const char* data = response.c_str();
-                    size_t total_size = response.length();
-                    size_t sent_total = 0;
-                    
-                    while (sent_total < total_size) {
-                        ssize_t sent = send(client_socket, data + sent_total, 
-                                          total_size - sent_total, MSG_NOSIGNAL);
-                        if (sent <= 0) {
-                            logger_.warning("Failed to send data to client, sent: " + 
-                                          std::to_string(sent_total) + "/" + std::to_string(total_size));
-                            break;
-                        }
-                        sent_total += sent;
-                    }
-                    
-                    if (sent_total == total_size) {
-                        logger_.info("Successfully sent " + std::to_string(sent_total) + " bytes to client");
-                    }
-                } else {
-                    logger_.warning("Generated empty response for path: " + path);
-                    // Send a simple error response
-                    std::string error_response = "HTTP/1.1 500 Internal Server Error\r\n"
-                                               "Access-Control-Allow-Origin: *\r\n"
-                                               "Content-Length: 0\r\n\r\n";
-                    send(client_socket, error_response.c_str(), error_response.length(), MSG_NOSIGNAL);
-                }
-                
-            } catch (const std::exception& e) {
-                logger_.error("Exception in handle_client: " + std::string(e.what()));
-                std::string error_response = "HTTP/1.1 500 Internal Server Error\r\n"
-                                           "Access-Control-Allow-Origin: *\r\n"
-                                           "Content-Length: 0\r\n\r\n";
-                send(client_socket, error_response.c_str(), error_response.length(), MSG_NOSIGNAL);
+    void on_websocket_open(HttpServer::connection_id_t client, const std::string& protocol) {
+        if (protocol != dashboard::SUBPROTOCOL) {
+            return;
+        }
+        std::vector<std::string> frames;
+        binary_encoder_.snapshot(now_ns(), frames);
+        for (const std::string& frame : frames) {
+            if (!http_server_.send(client, frame, true)) {
+                break;
             }
-            
-        } else {
-            logger_.warning("No bytes read from client socket, errno: " + std::to_string(errno));
         }
     }
     
-    void parse_request(const std::string& request, std::string& method, std::string& path) {
-        std::istringstream stream(request);
-        std::string version;
-        stream >> method >> path >> version;
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
     }
     
-    std::string build_metrics_response() {
+    HttpResponse build_metrics_response() {
         try {
             // Get aggregated metrics from all services
-            logger_.info("Getting aggregated metrics...");
             auto aggregated_metrics = metrics_aggregator_.get_all_metrics();
-            logger_.info("Got " + std::to_string(aggregated_metrics.size()) + " metrics, exporting...");
-            
-            std::string metrics_data = PrometheusExporter::export_metrics(&aggregated_metrics);
-            logger_.info("Exported metrics data, size: " + std::to_string(metrics_data.length()));
+            logger_.debug("Got " + std::to_string(aggregated_metrics.size()) + " metrics, exporting...");
             
-            std::ostringstream response;
-            response << "HTTP/1.1 200 OK\r\n";
-            response << "Content-Type: " << PrometheusExporter::get_content_type() << "\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << metrics_data.length() << "\r\n";
-            response << "\r\n";
-            response << metrics_data;
-            
-            return response.str();
+            HttpResponse response;
+            response.content_type = PrometheusExporter::get_content_type();
+            response.body = metrics_exporter_.render(aggregated_metrics);
+            return response;
             
         } catch (const std::exception& e) {
             logger_.error("Exception in build_metrics_response: " + std::string(e.what()));
             
             // Return a minimal valid response
-            std::string error_data = "# Error generating metrics\n";
-            std::ostringstream response;
-            response << "HTTP/1.1 200 OK\r\n";
-            response << "Content-Type: text/plain\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << error_data.length() << "\r\n";
-            response << "\r\n";
-            response << error_data;
-            
-            return response.str();
+            return HttpResponse::text("# Error generating metrics\n");
         }
     }
     
-    std::string build_service_metrics_response(const std::string& service_name) {
+    HttpResponse build_service_metrics_response(const std::string& service_name) {
         try {
             // Get metrics for specific service
-            logger_.info("Getting metrics for service: " + service_name);
             auto service_metrics = metrics_aggregator_.get_service_metrics(service_name);
-            logger_.info("Got " + std::to_string(service_metrics.size()) + " metrics for " + service_name + ", exporting...");
-            
-            std::string metrics_data = PrometheusExporter::export_metrics(&service_metrics);
-            logger_.info("Exported service metrics data, size: " + std::to_string(metrics_data.length()));
-            
-            std::ostringstream response;
-            response << "HTTP/1.1 200 OK\r\n";
-            response << "Content-Type: " << PrometheusExporter::get_content_type() << "\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << metrics_data.length() << "\r\n";
-            response << "\r\n";
-            response << metrics_data;
-            
-            return response.str();
+            logger_.debug("Got " + std::to_string(service_metrics.size()) + " metrics for " + service_name + ", exporting...");
+            
+            HttpResponse response;
+            response.content_type = PrometheusExporter::get_content_type();
+            if (service_exporters_.count(service_name) || service_exporters_.size() < MetricsAggregator::MAX_SERVICES) {
+                response.body = service_exporters_[service_name].render(service_metrics);
+            } else {
+                response.body = PrometheusExporter::export_metrics(&service_metrics);
+            }
+            return response;
             
         } catch (const std::exception& e) {
             logger_.error("Exception in build_service_metrics_response for " + service_name + ": " + std::string(e.what()));
             
             // Return a minimal valid response
-            std::string error_data = "# Error generating metrics for " + service_name + "\n";
-            std::ostringstream response;
-            response << "HTTP/1.1 200 OK\r\n";
-            response << "Content-Type: text/plain\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << error_data.length() << "\r\n";
-            response << "\r\n";
-            response << error_data;
-            
-            return response.str();
+            return HttpResponse::text("# Error generating metrics for " + service_name + "\n");
         }
     }
     
-    std::string build_cors_preflight_response() {
-        std::ostringstream response;
-        response << "HTTP/1.1 200 OK\r\n";
-        response << "Access-Control-Allow-Origin: *\r\n";
-        response << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
-        response << "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n";
-        response << "Access-Control-Max-Age: 86400\r\n";
-        response << "Content-Length: 0\r\n";
-        response << "\r\n";
-        
-        return response.str();
+    HttpResponse build_cors_preflight_response() {
+        HttpResponse response;
+        response.headers = {
+            {"Access-Control-Allow-Methods", "GET, POST, OPTIONS"},
+            {"Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With"},
+            {"Access-Control-Max-Age", "86400"},
+        };
+        return response;
     }
     
-    std::string build_http_response() {
+    HttpResponse build_http_response() {
         // Get current messages
         std::vector<std::string> messages;
         {
@@ -590,7 +464,17 @@ private:
         
         // Build JSON response
         std::ostringstream json;
-        json << "{\"messages\":[";
+        json << "{\"market_data\":[";
+        
+        // One entry per symbol, whatever the tick rate
+        bool first = true;
+        latest_market_data_.for_each([&](symbol_id_t, const MarketData& data, uint64_t version) {
+            if (!first) json << ",";
+            first = false;
+            json << format_market_data_as_json(data, version);
+        });
+        
+        json << "],\"messages\":[";
         
         for (size_t i = 0; i < messages.size(); ++i) {
             if (i > 0) json << ",";
@@ -600,18 +484,22 @@ private:
         json << "],\"timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count() << "}";
         
-        std::string body = json.str();
-        
-        // Build HTTP response
-        std::ostringstream response;
-        response << "HTTP/1.1 200 OK\r\n";
-        response << "Content-Type: application/json\r\n";
-        response << "Access-Control-Allow-Origin: *\r\n";
-        response << "Content-Length: " << body.length() << "\r\n";
-        response << "\r\n";
-        response << body;
-        
-        return response.str();
+        return HttpResponse::json(json.str());
+    }
+    
+    std::string format_market_data_as_json(const MarketData& data, uint64_t version) {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(4);
+        json << "{\"symbol\":\"" << std::string(data.symbol, strnlen(data.symbol, sizeof(data.symbol))) << "\""
+             << ",\"bid_price\":" << to_double_price(data.bid_price)
+             << ",\"ask_price\":" << to_double_price(data.ask_price)
+             << ",\"bid_size\":" << data.bid_size
+             << ",\"ask_size\":" << data.ask_size
+             << ",\"last_price\":" << to_double_price(data.last_price)
+             << ",\"last_size\":" << data.last_size
+             << ",\"exchange_timestamp\":" << data.exchange_timestamp
+             << ",\"updates\":" << version << "}";
+        return json.str();
     }
     
     std::string format_as_json(const std::string& raw_data) {
@@ -635,7 +523,7 @@ private:
         return json.str();
     }
     
-    std::string build_executions_response() {
+    HttpResponse build_executions_response() {
         // Get current executions
         std::vector<std::string> executions;
         {
@@ -655,21 +543,40 @@ private:
         json << "],\"timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count() << "}";
         
-        std::string body = json.str();
-        
-        // Build HTTP response
-        std::ostringstream response;
-        response << "HTTP/1.1 200 OK\r\n";
-        response << "Content-Type: application/json\r\n";
-        response << "Access-Control-Allow-Origin: *\r\n";
-        response << "Content-Length: " << body.length() << "\r\n";
-        response << "\r\n";
-        response << body;
+        return HttpResponse::json(json.str());
+    }
+    
+    // Points are [time_s, last, min, max], oldest first
+    HttpResponse build_history_response(const HttpRequest& request) {
+        std::string service = request.query_parameter("service");
+        std::string metric = request.query_parameter("metric");
+        std::string tier_name = request.query_parameter("tier");
+        MetricHistory::Tier tier = MetricHistory::SECONDS;
+        if (tier_name == "10s") {
+            tier = MetricHistory::TEN_SECONDS;
+        } else if (tier_name == "1m") {
+            tier = MetricHistory::MINUTES;
+        } else if (!tier_name.empty() && tier_name != "1s") {
+            return HttpResponse::json("{\"error\":\"tier must be 1s, 10s or 1m\"}", 400, "Bad Request");
+        }
+        if (service.empty() || metric.empty()) {
+            return HttpResponse::json("{\"error\":\"service and metric are required\"}", 400, "Bad Request");
+        }
+        uint32_t since_s = static_cast<uint32_t>(std::strtoul(request.query_parameter("since").c_str(), nullptr, 10));
         
-        return response.str();
+        auto points = metrics_aggregator_.get_metric_history(service, metric, tier, since_s);
+        std::ostringstream json;
+        json << "{\"service\":\"" << service << "\",\"metric\":\"" << metric << "\",\"tier\":\""
+             << (tier_name.empty() ? "1s" : tier_name) << "\",\"points\":[";
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (i > 0) json << ",";
+            json << "[" << points[i].time_s << "," << points[i].last << "," << points[i].min << "," << points[i].max << "]";
+        }
+        json << "]}";
+        return HttpResponse::json(json.str());
     }
     
-    std::string handle_control_command(ControlAction action) {
+    HttpResponse handle_control_command(ControlAction action) {
         try {
             // Create control command message
             ControlCommand command{};
@@ -680,39 +587,17 @@ private:
             std::strncpy(command.parameters, "{}", sizeof(command.parameters) - 1);
             
             // Publish control command
-            zmq::message_t message(sizeof(ControlCommand));
-            std::memcpy(message.data(), &command, sizeof(ControlCommand));
-            control_publisher_.send(message, zmq::send_flags::dontwait);
+            control_publisher_->publish(&command, sizeof(ControlCommand));
             
             logger_.info("Control command sent: " + std::to_string(static_cast<int>(action)));
             
-            // Build success response
-            std::string body = "{\"success\":true,\"message\":\"Command executed\"}";
-            
-            std::ostringstream response;
-            response << "HTTP/1.1 200 OK\r\n";
-            response << "Content-Type: application/json\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << body.length() << "\r\n";
-            response << "\r\n";
-            response << body;
-            
-            return response.str();
+            return HttpResponse::json("{\"success\":true,\"message\":\"Command executed\"}");
             
         } catch (const std::exception& e) {
             logger_.error("Control command failed: " + std::string(e.what()));
             
-            std::string body = "{\"success\":false,\"message\":\"" + std::string(e.what()) + "\"}";
-            
-            std::ostringstream response;
-            response << "HTTP/1.1 500 Internal Server Error\r\n";
-            response << "Content-Type: application/json\r\n";
-            response << "Access-Control-Allow-Origin: *\r\n";
-            response << "Content-Length: " << body.length() << "\r\n";
-            response << "\r\n";
-            response << body;
-            
-            return response.str();
+            return HttpResponse::json("{\"success\":false,\"message\":\"" + std::string(e.what()) + "\"}",
+                                      500, "Internal Server Error");
         }
     }
     
@@ -740,7 +625,7 @@ private:
         json << "\"type\":\"" << exec_type_str << "\",";
         json << "\"action\":\"" << (execution.fill_quantity > 0 ? "BUY" : "SELL") << "\",";
         json << "\"quantity\":" << execution.fill_quantity << ",";
-        json << "\"price\":" << std::fixed << std::setprecision(2) << execution.fill_price << ",";
+        json << "\"price\":" << std::fixed << std::setprecision(2) << to_double_price(execution.fill_price) << ",";
         json << "\"commission\":" << std::fixed << std::setprecision(4) << execution.commission << ",";
         json << "\"timestamp\":\"" << std::setfill('0') << std::setw(2) << tm.tm_hour << ":"
              << std::setfill('0') << std::setw(2) << tm.tm_min << ":"
@@ -775,4 +660,4 @@ void stop_websocket_bridge() {
 
 bool is_websocket_bridge_running() {
     return g_bridge && g_bridge->is_running();
-}
\ No newline at end of file
+}